@@ -161,7 +161,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::deep_copy() const {
                            aggtype,
                            arg == nullptr ? nullptr : arg->deep_copy(),
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> CaseExpr::deep_copy() const {
@@ -201,7 +201,7 @@ std::shared_ptr<Analyzer::Expr> OffsetInFragment::deep_copy() const {
 
 std::shared_ptr<Analyzer::Expr> WindowFunction::deep_copy() const {
   return makeExpr<WindowFunction>(
-      type_info, kind_, args_, partition_keys_, order_keys_, collation_);
+      type_info, kind_, args_, partition_keys_, order_keys_, collation_, rows_frame_);
 }
 
 ExpressionPtr ArrayExpr::deep_copy() const {
@@ -1881,7 +1881,7 @@ std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_with_child_targetlist(
                            aggtype,
                            arg ? arg->rewrite_with_child_targetlist(tlist) : nullptr,
                            is_distinct,
-                           error_rate);
+                           arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> AggExpr::rewrite_agg_to_var(
@@ -2267,6 +2267,10 @@ bool AggExpr::operator==(const Expr& rhs) const {
   if (aggtype != rhs_ae.get_aggtype() || is_distinct != rhs_ae.get_is_distinct()) {
     return false;
   }
+  if (arg1 != rhs_ae.get_arg1() &&
+      (!arg1 || !rhs_ae.get_arg1() || !(*arg1 == *rhs_ae.get_arg1()))) {
+    return false;
+  }
   if (arg.get() == rhs_ae.get_arg()) {
     return true;
   }
@@ -2344,7 +2348,8 @@ bool WindowFunction::operator==(const Expr& rhs) const {
   }
   if (kind_ != rhs_window->kind_ || args_.size() != rhs_window->args_.size() ||
       partition_keys_.size() != rhs_window->partition_keys_.size() ||
-      order_keys_.size() != rhs_window->order_keys_.size()) {
+      order_keys_.size() != rhs_window->order_keys_.size() ||
+      !(rows_frame_ == rhs_window->rows_frame_)) {
     return false;
   }
   return expr_list_match(args_, rhs_window->args_) &&
@@ -2662,6 +2667,9 @@ std::string AggExpr::toString() const {
     case kSAMPLE:
       agg = "SAMPLE";
       break;
+    case kAPPROX_QUANTILE:
+      agg = "APPROX_PERCENTILE";
+      break;
   }
   std::string str{"(" + agg};
   if (is_distinct) {
@@ -2672,6 +2680,9 @@ std::string AggExpr::toString() const {
   } else {
     str += "*";
   }
+  if (arg1) {
+    str += arg1->toString();
+  }
   return str + ") ";
 }
 
@@ -2719,9 +2730,20 @@ std::string WindowFunction::toString() const {
   for (const auto& arg : args_) {
     result += " " + arg->toString();
   }
+  if (rows_frame_) {
+    result += " " + rows_frame_->toString();
+  }
   return result + ") ";
 }
 
+std::string WindowRowsFrame::toString() const {
+  const auto bound_to_string = [](const std::optional<int64_t>& offset) {
+    return offset ? std::to_string(*offset) : std::string("UNBOUNDED");
+  };
+  return "ROWS(" + bound_to_string(start_offset) + ", " + bound_to_string(end_offset) +
+         ")";
+}
+
 std::string ArrayExpr::toString() const {
   std::string str{"ARRAY["};
 
@@ -2775,6 +2797,9 @@ std::string GeoBinOper::toString() const {
     case Geo_namespace::GeoBase::GeoOp::kBUFFER:
       fn = "ST_Buffer";
       break;
+    case Geo_namespace::GeoBase::GeoOp::kSIMPLIFY:
+      fn = "ST_Simplify";
+      break;
     default:
       fn = "Geo_UNKNOWN";
       break;
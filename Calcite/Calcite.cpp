@@ -22,6 +22,7 @@
  */
 
 #include "Calcite.h"
+#include "CalcitePlanCache.h"
 #include "Catalog/Catalog.h"
 #include "Logger/Logger.h"
 #include "Shared/SystemParameters.h"
@@ -307,6 +308,7 @@ void Calcite::init(const int db_port,
   LOG(INFO) << "Creating Calcite Handler,  Calcite Port is " << calcite_port
             << " base data dir is " << data_dir;
   connMgr_ = std::make_shared<ThriftClientConnection>();
+  plan_cache_ = std::make_unique<CalcitePlanCache>();
   if (calcite_port < 0) {
     CHECK(false) << "JNI mode no longer supported.";
   }
@@ -341,6 +343,7 @@ Calcite::Calcite(const SystemParameters& system_parameters,
 }
 
 void Calcite::updateMetadata(std::string catalog, std::string table) {
+  plan_cache_->invalidate(catalog);
   if (server_available_) {
     auto ms = measure<>::execution([&]() {
       auto clientP = getClient(remote_calcite_port_);
@@ -398,13 +401,36 @@ TPlanResult Calcite::process(
     const bool is_view_optimize,
     const bool check_privileges,
     const std::string& calcite_session_id) {
-  TPlanResult result = processImpl(query_state_proxy,
-                                   std::move(sql_string),
-                                   filter_push_down_info,
-                                   legacy_syntax,
-                                   is_explain,
-                                   is_view_optimize,
-                                   calcite_session_id);
+  const auto plan_query = [&](const std::string& sql) {
+    return processImpl(query_state_proxy,
+                       sql,
+                       filter_push_down_info,
+                       legacy_syntax,
+                       is_explain,
+                       is_view_optimize,
+                       calcite_session_id);
+  };
+  TPlanResult result;
+  if (g_enable_calcite_plan_cache && filter_push_down_info.empty() && !is_explain) {
+    // Calcite plans as its own user, the privileges of the user of the session are
+    // checked below on every plan, cached or not
+    const auto& session_info = *query_state_proxy.getQueryState().getConstSessionInfo();
+    const auto& catalog = session_info.getCatalog().getCurrentDB().dbName;
+    const auto query = CalcitePlanCache::parameterize(
+        sql_string,
+        catalog + '\0' + std::to_string(plan_cache_->getCatalogVersion(catalog)) + '\0' +
+            (legacy_syntax ? "legacy " : "") + (is_view_optimize ? "view_optimize" : "") +
+            '\0');
+    if (auto cached_plan = plan_cache_->get(query)) {
+      LOG(INFO) << "Reusing the Calcite plan of a query of the same shape";
+      result = std::move(*cached_plan);
+    } else {
+      result = plan_query(sql_string);
+      plan_cache_->put(query, result, plan_query);
+    }
+  } else {
+    result = plan_query(sql_string);
+  }
   if (check_privileges && !is_explain) {
     checkAccessedObjectsPrivileges(query_state_proxy, result);
   }
@@ -612,6 +638,7 @@ std::string Calcite::getRuntimeExtensionFunctionWhitelist() {
 void Calcite::setRuntimeExtensionFunctions(
     const std::vector<TUserDefinedFunction>& udfs,
     const std::vector<TUserDefinedTableFunction>& udtfs) {
+  plan_cache_->clear();
   if (server_available_) {
     auto clientP = getClient(remote_calcite_port_);
     clientP.first->setRuntimeExtensionFunctions(udfs, udtfs);
@@ -28,6 +28,7 @@
 
 #include <thrift/transport/TTransport.h>
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -39,6 +40,7 @@ constexpr char const* kCalciteUserName = "calcite";
 constexpr char const* kCalciteUserPassword = "HyperInteractive";
 }  // namespace
 
+class CalcitePlanCache;
 class CalciteServerClient;
 
 namespace Catalog_Namespace {
@@ -135,4 +137,5 @@ class Calcite final {
   std::string ssl_ca_file_;
   std::string db_config_file_;
   std::once_flag shutdown_once_flag_;
+  std::unique_ptr<CalcitePlanCache> plan_cache_;
 };
@@ -0,0 +1,358 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Calcite/CalcitePlanCache.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "Logger/Logger.h"
+
+bool g_enable_calcite_plan_cache{false};
+size_t g_calcite_plan_cache_size{1024};
+
+namespace {
+
+bool is_digit(const char c) {
+  return std::isdigit(static_cast<unsigned char>(c));
+}
+
+bool is_word_char(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// The characters of the string literals whose JSON form in the plan is the same
+bool is_plain_string_char(const char c) {
+  return c >= ' ' && c <= '~' && c != '"' && c != '\\';
+}
+
+// The words after which a literal isn't a value of the query: the string of a typed
+// literal is converted by Calcite, and integers set e.g. the row count of a sort or
+// are the ordinals of GROUP BY / ORDER BY
+bool is_literal_of_syntax(const std::string& last_word) {
+  return last_word == "DATE" || last_word == "TIME" || last_word == "TIMESTAMP" ||
+         last_word == "INTERVAL" || last_word == "LIMIT" || last_word == "OFFSET" ||
+         last_word == "FIRST" || last_word == "NEXT" || last_word == "TOP" ||
+         last_word == "BY";
+}
+
+// The placeholder of a string literal, which keeps its punctuation, e.g. the
+// wildcards of a LIKE pattern
+std::string get_string_shape(const std::string& str) {
+  std::string shape = str;
+  for (auto& c : shape) {
+    if (std::islower(static_cast<unsigned char>(c))) {
+      c = 'a';
+    } else if (std::isupper(static_cast<unsigned char>(c))) {
+      c = 'A';
+    } else if (is_digit(c)) {
+      c = '0';
+    }
+  }
+  return shape;
+}
+
+// Rotates the letters and digits of literal by shift, which keeps its shape
+std::string rotate_literal(const std::string& literal, const int shift) {
+  std::string rotated = literal;
+  for (auto& c : rotated) {
+    if (std::islower(static_cast<unsigned char>(c))) {
+      c = 'a' + (c - 'a' + shift) % 26;
+    } else if (std::isupper(static_cast<unsigned char>(c))) {
+      c = 'A' + (c - 'A' + shift) % 26;
+    } else if (is_digit(c)) {
+      c = '0' + (c - '0' + shift) % 10;
+    }
+  }
+  return rotated;
+}
+
+const std::string kLiteralKey{"\"literal\""};
+
+}  // namespace
+
+CalcitePlanCache::ParameterizedQuery CalcitePlanCache::parameterize(
+    const std::string& sql,
+    const std::string& key_prefix) {
+  ParameterizedQuery query{key_prefix, sql, {}};
+  auto& key = query.key;
+  std::string last_word;
+  const size_t n = sql.size();
+  size_t i = 0;
+  while (i < n) {
+    const char c = sql[i];
+    if (c == '\'') {
+      bool is_plain = true;
+      size_t j = i + 1;
+      for (; j < n; ++j) {
+        if (sql[j] == '\'') {
+          if (j + 1 < n && sql[j + 1] == '\'') {
+            is_plain = false;
+            ++j;
+            continue;
+          }
+          break;
+        }
+        is_plain = is_plain && is_plain_string_char(sql[j]);
+      }
+      if (j >= n) {
+        key.append(sql, i, std::string::npos);
+        break;
+      }
+      const size_t length = j - i - 1;
+      if (is_plain && length > 0 && !is_literal_of_syntax(last_word)) {
+        query.literals.emplace_back(i + 1, length);
+        key += "'\x01S" + get_string_shape(sql.substr(i + 1, length)) + "'";
+      } else {
+        key.append(sql, i, j + 1 - i);
+      }
+      i = j + 1;
+      continue;
+    }
+    if (c == '"') {
+      // quoted identifiers are kept as they are
+      const auto end = sql.find('"', i + 1);
+      const size_t j = end == std::string::npos ? n : end + 1;
+      key.append(sql, i, j - i);
+      i = j;
+      continue;
+    }
+    const bool is_comment = (c == '-' && i + 1 < n && sql[i + 1] == '-') ||
+                            (c == '/' && i + 1 < n && sql[i + 1] == '*');
+    if (is_comment || std::isspace(static_cast<unsigned char>(c))) {
+      // the comments and the runs of whitespace are a single space in the key
+      if (is_comment) {
+        const auto end = c == '-' ? sql.find('\n', i) : sql.find("*/", i + 2);
+        i = end == std::string::npos ? n : end + (c == '-' ? 0 : 2);
+      } else {
+        ++i;
+      }
+      if (key.size() > key_prefix.size() && key.back() != ' ') {
+        key += ' ';
+      }
+      continue;
+    }
+    if (is_word_char(c) && !is_digit(c)) {
+      size_t j = i;
+      while (j < n && is_word_char(sql[j])) {
+        ++j;
+      }
+      last_word = sql.substr(i, j - i);
+      std::transform(last_word.begin(), last_word.end(), last_word.begin(), ::toupper);
+      key.append(sql, i, j - i);
+      i = j;
+      continue;
+    }
+    if (is_digit(c)) {
+      size_t j = i;
+      while (j < n && is_digit(sql[j])) {
+        ++j;
+      }
+      const size_t int_digits = j - i;
+      std::string shape = std::to_string(int_digits);
+      bool is_literal = !(int_digits > 1 && c == '0');
+      if (j < n && sql[j] == '.') {
+        const size_t frac_begin = ++j;
+        while (j < n && is_digit(sql[j])) {
+          ++j;
+        }
+        is_literal = is_literal && j > frac_begin;
+        shape += "." + std::to_string(j - frac_begin);
+      }
+      // e.g. exponents and the suffixes of identifiers
+      is_literal = is_literal && !(j < n && (is_word_char(sql[j]) || sql[j] == '.')) &&
+                   !is_literal_of_syntax(last_word);
+      if (is_literal) {
+        query.literals.emplace_back(i, j - i);
+        key += "\x01N" + shape;
+      } else {
+        key.append(sql, i, j - i);
+      }
+      i = j;
+      continue;
+    }
+    key += c;
+    ++i;
+  }
+  while (key.size() > key_prefix.size() && (key.back() == ' ' || key.back() == ';')) {
+    key.pop_back();
+  }
+  return query;
+}
+
+std::optional<TPlanResult> CalcitePlanCache::get(const ParameterizedQuery& query) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto entry = cache_.get(query.key);
+  if (!entry || !entry->plan) {
+    return std::nullopt;
+  }
+  auto plan = *entry->plan;
+  CHECK_EQ(entry->literal_offsets.size(), query.literals.size());
+  for (size_t i = 0; i < query.literals.size(); ++i) {
+    const auto& [offset, length] = query.literals[i];
+    for (const auto plan_offset : entry->literal_offsets[i]) {
+      // the literals of the same key have the same length
+      plan.plan_result.replace(plan_offset, length, query.sql, offset, length);
+    }
+  }
+  plan.execution_time_ms = 0;
+  return plan;
+}
+
+void CalcitePlanCache::put(const ParameterizedQuery& query,
+                           const TPlanResult& plan,
+                           const PlanQuery& plan_query) {
+  if (query.literals.empty()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.put(query.key, Entry{plan, {}});
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_.get(query.key)) {
+      return;
+    }
+  }
+  Entry entry;
+  const auto literal_offsets = findLiterals(query, plan.plan_result);
+  const auto probe_literals =
+      literal_offsets ? makeProbeLiterals(query) : std::nullopt;
+  if (probe_literals) {
+    auto probe_sql = query.sql;
+    auto expected_probe_plan = plan.plan_result;
+    for (size_t i = 0; i < query.literals.size(); ++i) {
+      const auto& [offset, length] = query.literals[i];
+      probe_sql.replace(offset, length, (*probe_literals)[i]);
+      for (const auto plan_offset : (*literal_offsets)[i]) {
+        expected_probe_plan.replace(plan_offset, length, (*probe_literals)[i]);
+      }
+    }
+    try {
+      if (plan_query(probe_sql).plan_result == expected_probe_plan) {
+        entry.plan = plan;
+        entry.literal_offsets = *literal_offsets;
+      }
+    } catch (const std::exception& e) {
+      VLOG(1) << "Could not plan the probe of the query: " << e.what();
+    }
+  }
+  if (!entry.plan) {
+    VLOG(1) << "Not caching the plans of the query, they depend on its literals";
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.put(query.key, std::move(entry));
+}
+
+void CalcitePlanCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+}
+
+uint64_t CalcitePlanCache::getCatalogVersion(const std::string& catalog) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return catalog_versions_[catalog];
+}
+
+void CalcitePlanCache::invalidate(const std::string& catalog) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the keys of the entries of catalog have the previous version, LRU evicts them
+  ++catalog_versions_[catalog];
+}
+
+std::optional<std::vector<std::string>> CalcitePlanCache::makeProbeLiterals(
+    const ParameterizedQuery& query) {
+  std::vector<std::string> literals;
+  for (const auto& [offset, length] : query.literals) {
+    literals.push_back(query.sql.substr(offset, length));
+  }
+  auto sorted_literals = literals;
+  std::sort(sorted_literals.begin(), sorted_literals.end());
+  if (std::adjacent_find(sorted_literals.begin(), sorted_literals.end()) !=
+      sorted_literals.end()) {
+    // the positions of the same value in the plan can't be told apart
+    return std::nullopt;
+  }
+  std::vector<std::string> probe_literals;
+  for (const auto& literal : literals) {
+    const auto is_taken = [&literals, &probe_literals](const std::string& candidate) {
+      return std::find(literals.begin(), literals.end(), candidate) != literals.end() ||
+             std::find(probe_literals.begin(), probe_literals.end(), candidate) !=
+                 probe_literals.end();
+    };
+    std::optional<std::string> probe_literal;
+    for (int shift = 1; shift < 10 && !probe_literal; ++shift) {
+      auto candidate = rotate_literal(literal, shift);
+      const bool has_leading_zero =
+          candidate.size() > 1 && candidate[0] == '0' && is_digit(candidate[1]);
+      if (!has_leading_zero && !is_taken(candidate)) {
+        probe_literal = candidate;
+      }
+    }
+    if (!probe_literal) {
+      return std::nullopt;
+    }
+    probe_literals.push_back(*probe_literal);
+  }
+  return probe_literals;
+}
+
+std::optional<std::vector<std::vector<size_t>>> CalcitePlanCache::findLiterals(
+    const ParameterizedQuery& query,
+    const std::string& plan_result) {
+  std::vector<std::vector<size_t>> literal_offsets(query.literals.size());
+  const size_t n = plan_result.size();
+  for (auto pos = plan_result.find(kLiteralKey); pos != std::string::npos;
+       pos = plan_result.find(kLiteralKey, pos + 1)) {
+    size_t j = pos + kLiteralKey.size();
+    while (j < n && std::isspace(static_cast<unsigned char>(plan_result[j]))) {
+      ++j;
+    }
+    if (j >= n || plan_result[j] != ':') {
+      continue;
+    }
+    ++j;
+    while (j < n && std::isspace(static_cast<unsigned char>(plan_result[j]))) {
+      ++j;
+    }
+    const bool is_string = j < n && plan_result[j] == '"';
+    // Calcite folds the minus of negative numbers into the literal
+    if (j < n && (is_string || plan_result[j] == '-')) {
+      ++j;
+    }
+    size_t end = j;
+    if (is_string) {
+      end = std::min(plan_result.find('"', j), n);
+    } else {
+      while (end < n && (is_digit(plan_result[end]) || plan_result[end] == '.')) {
+        ++end;
+      }
+    }
+    for (size_t i = 0; i < query.literals.size(); ++i) {
+      const auto& [offset, length] = query.literals[i];
+      const bool is_string_literal = offset > 0 && query.sql[offset - 1] == '\'';
+      if (is_string_literal == is_string && end - j == length &&
+          plan_result.compare(j, length, query.sql, offset, length) == 0) {
+        literal_offsets[i].push_back(j);
+      }
+    }
+  }
+  for (const auto& offsets : literal_offsets) {
+    if (offsets.empty()) {
+      return std::nullopt;
+    }
+  }
+  return literal_offsets;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CalcitePlanCache.h
+ * @brief   Cache of the Calcite plans of the queries, by their literal-free form
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "StringDictionary/LruCache.hpp"
+#include "gen-cpp/calciteserver_types.h"
+
+extern bool g_enable_calcite_plan_cache;
+extern size_t g_calcite_plan_cache_size;
+
+/**
+ * Maps the queries, with their numeric and string literals replaced by placeholders of
+ * the same length, to a plan whose literals are rebound to those of each query. Queries
+ * differing only in the constants of their filters share the plan of the first one,
+ * instead of going through Calcite again.
+ *
+ * A query shape is only cached once the plan of the same query with other literals,
+ * the probe, is found to differ from the first plan exactly where the literals are.
+ * This rules out the plans which depend on the values of the literals, e.g. after
+ * folding constants or resolving GROUP BY ordinals.
+ *
+ * The keys are normalized: comments and runs of whitespace become a single space. They
+ * include the version of the schema of the database, which each DDL statement bumps.
+ */
+class CalcitePlanCache {
+ public:
+  struct ParameterizedQuery {
+    std::string key;                                  // the query without its literals
+    std::string sql;                                  // the query
+    std::vector<std::pair<size_t, size_t>> literals;  // offsets and lengths in sql
+  };
+
+  using PlanQuery = std::function<TPlanResult(const std::string& sql)>;
+
+  // key_prefix holds what the plans depend on besides the query, e.g. the database
+  static ParameterizedQuery parameterize(const std::string& sql,
+                                         const std::string& key_prefix);
+
+  // The plan of query, from the plan of a cached query of the same shape, if any
+  std::optional<TPlanResult> get(const ParameterizedQuery& query);
+
+  // Caches plan as the plan of query, unless plan_query gives a plan for the probe
+  // which doesn't match it
+  void put(const ParameterizedQuery& query,
+           const TPlanResult& plan,
+           const PlanQuery& plan_query);
+
+  void clear();
+
+  uint64_t getCatalogVersion(const std::string& catalog);
+
+  // Drops the plans of the queries of catalog, after a change to its schema
+  void invalidate(const std::string& catalog);
+
+ private:
+  struct Entry {
+    std::optional<TPlanResult> plan;  // none when the plans depend on the literals
+    std::vector<std::vector<size_t>> literal_offsets;  // in plan->plan_result
+  };
+
+  static std::optional<std::vector<std::string>> makeProbeLiterals(
+      const ParameterizedQuery& query);
+
+  static std::optional<std::vector<std::vector<size_t>>> findLiterals(
+      const ParameterizedQuery& query,
+      const std::string& plan_result);
+
+  std::mutex mutex_;
+  LruCache<std::string, Entry> cache_{g_calcite_plan_cache_size};
+  std::unordered_map<std::string, uint64_t> catalog_versions_;
+};
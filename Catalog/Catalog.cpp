@@ -25,7 +25,9 @@
 #include "Catalog.h"
 #include "SysCatalog.h"
 
+#include <fcntl.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <boost/algorithm/string/predicate.hpp>
@@ -38,11 +40,14 @@
 #include <cstring>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <list>
 #include <memory>
 #include <random>
 #include <regex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 #if BOOST_VERSION >= 106600
 #include <boost/uuid/detail/sha1.hpp>
 #else
@@ -53,6 +58,7 @@
 #include <rapidjson/ostreamwrapper.h>
 #include <rapidjson/writer.h>
 
+#include "QueryEngine/DateTimeUtils.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/TableOptimizer.h"
 
@@ -60,7 +66,9 @@
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
 #include "Fragmenter/Fragmenter.h"
+#include "Fragmenter/InsertWal.h"
 #include "Fragmenter/SortedOrderFragmenter.h"
+#include "Fragmenter/TimePartition.h"
 #include "LockMgr/LockMgr.h"
 #include "MigrationMgr/MigrationMgr.h"
 #include "Parser/ParserNode.h"
@@ -70,6 +78,7 @@
 #include "Shared/StringTransform.h"
 #include "Shared/TimeGM.h"
 #include "Shared/measure.h"
+#include "Shared/thread_count.h"
 #include "StringDictionary/StringDictionaryClient.h"
 
 #include "MapDRelease.h"
@@ -88,11 +97,20 @@ using std::vector;
 
 int g_test_against_columnId_gap{0};
 bool g_enable_fsi{false};
+size_t g_sort_column_interval_seconds{600};
+size_t g_vacuum_interval_seconds{600};
+double g_vacuum_min_deleted_fraction{0.25};
+size_t g_fragment_merge_interval_seconds{600};
+double g_fragment_merge_max_fill_fraction{0.5};
 extern bool g_cache_string_hash;
+extern bool g_enable_insert_wal;
 
 // Serialize temp tables to a json file in the Catalogs directory for Calcite parsing
 // under unit testing.
 bool g_serialize_temp_tables{false};
+float g_dictionary_compaction_min_dead_fraction{0.25};
+bool g_prewarm_pinned_tables{true};
+bool g_preload_catalogs{false};
 
 namespace Catalog_Namespace {
 
@@ -103,7 +121,10 @@ const int MAPD_TEMP_DICT_START_ID =
     1073741824;  // 2^30, give room for over a billion non-temp dictionaries
 
 const std::string Catalog::physicalTableNameTag_("_shard_#");
+std::mutex Catalog::mapd_cat_map_mutex_;
 std::map<std::string, std::shared_ptr<Catalog>> Catalog::mapd_cat_map_;
+std::map<std::string, std::shared_future<std::shared_ptr<Catalog>>>
+    Catalog::loading_cat_map_;
 
 thread_local bool Catalog::thread_holds_read_lock = false;
 
@@ -182,9 +203,35 @@ Catalog::Catalog(const string& basePath,
   if (!is_new_db) {
     CheckAndExecuteMigrationsPostBuildMaps();
   }
+  loadColumnStatistics();
   if (g_serialize_temp_tables) {
     boost::filesystem::remove(table_json_filepath(basePath_, currentDB_.dbName));
   }
+  if (g_enable_insert_wal && dataMgr_) {
+    insertWal_ = std::make_unique<Fragmenter_Namespace::InsertWal>(
+        basePath_ + "/mapd_data/insert_wal_" + std::to_string(currentDB_.dbId));
+    // inserts logged after the last checkpoint of their table, e.g. before a crash
+    replayInsertWal({});
+    insertWal_->removeCheckpointedSegments(getInsertWalTableEpochs(), true);
+  }
+  if (dataMgr_) {
+    for (const auto td : getAllTableMetadata()) {
+      try {
+        if (!td->pinnedCpuColumnIds.empty()) {
+          setResidentColumns(
+              td, td->pinnedCpuColumnIds, Data_Namespace::MemoryLevel::CPU_LEVEL);
+        }
+        if (!td->pinnedGpuColumnIds.empty() && dataMgr_->gpusPresent()) {
+          setResidentColumns(
+              td, td->pinnedGpuColumnIds, Data_Namespace::MemoryLevel::GPU_LEVEL);
+        }
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Could not pin the columns of table " << td->tableName << ": "
+                     << e.what();
+      }
+    }
+  }
+  invalidateMetadataSnapshot();
 }
 
 Catalog::~Catalog() {
@@ -261,6 +308,35 @@ void Catalog::updateTableDescriptorSchema() {
       string queryString("ALTER TABLE mapd_tables ADD storage_type TEXT DEFAULT ''");
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("extent_size")) == cols.end()) {
+      sqliteConnector_.query("ALTER TABLE mapd_tables ADD extent_size BIGINT DEFAULT 0");
+    }
+    if (std::find(cols.begin(), cols.end(), std::string("chunk_compression")) ==
+        cols.end()) {
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD chunk_compression TEXT DEFAULT ''");
+    }
+    if (std::find(cols.begin(), cols.end(), std::string("bloom_filter_columns")) ==
+        cols.end()) {
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD bloom_filter_columns TEXT DEFAULT ''");
+    }
+    if (std::find(cols.begin(), cols.end(), std::string("partition_column_id")) ==
+        cols.end()) {
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD partition_column_id INTEGER DEFAULT 0");
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD partition_interval BIGINT DEFAULT 0");
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD partition_retention INTEGER DEFAULT 0");
+    }
+    if (std::find(cols.begin(), cols.end(), std::string("pinned_cpu_columns")) ==
+        cols.end()) {
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD pinned_cpu_columns TEXT DEFAULT ''");
+      sqliteConnector_.query(
+          "ALTER TABLE mapd_tables ADD pinned_gpu_columns TEXT DEFAULT ''");
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -683,6 +759,229 @@ const std::string Catalog::getForeignTableSchema(bool if_not_exists) {
          "FOREIGN KEY(server_id) REFERENCES omnisci_foreign_servers(id))";
 }
 
+const std::string Catalog::getTableStreamSchema(bool if_not_exists) {
+  return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
+         "omnisci_table_streams(tableid integer primary key, source text, " +
+         "options text)";
+}
+
+const std::string Catalog::getTableStreamOffsetSchema(bool if_not_exists) {
+  return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
+         "omnisci_table_stream_offsets(tableid integer, topic text, " +
+         "partition_id integer, epoch integer, next_offset bigint, " +
+         "primary key(tableid, topic, partition_id, epoch))";
+}
+
+void Catalog::updateTableStreamSchema() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query(getTableStreamSchema(true));
+    sqliteConnector_.query(getTableStreamOffsetSchema(true));
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+}
+
+void Catalog::addTableStream(const TableStream& stream) {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query_with_text_params(
+      "INSERT OR REPLACE INTO omnisci_table_streams (tableid, source, options) VALUES "
+      "(?, ?, ?)",
+      std::vector<std::string>{
+          std::to_string(stream.tableId), stream.source, stream.options});
+}
+
+void Catalog::removeTableStream(const int tableId) {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query_with_text_param(
+        "DELETE FROM omnisci_table_streams WHERE tableid = ?", std::to_string(tableId));
+    sqliteConnector_.query_with_text_param(
+        "DELETE FROM omnisci_table_stream_offsets WHERE tableid = ?",
+        std::to_string(tableId));
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+}
+
+std::vector<TableStream> Catalog::getTableStreams() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("SELECT tableid, source, options FROM omnisci_table_streams");
+  std::vector<TableStream> streams;
+  for (size_t r = 0; r < sqliteConnector_.getNumRows(); ++r) {
+    streams.push_back({sqliteConnector_.getData<int>(r, 0),
+                       sqliteConnector_.getData<std::string>(r, 1),
+                       sqliteConnector_.getData<std::string>(r, 2)});
+  }
+  return streams;
+}
+
+void Catalog::recordTableStreamOffsets(const int tableId,
+                                       const int epoch,
+                                       const TableStreamOffsets& offsets) {
+  cat_sqlite_lock sqlite_lock(this);
+  const auto table_id_str = std::to_string(tableId);
+  const auto epoch_str = std::to_string(epoch);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    // offsets at or after epoch are left from commits whose checkpoint never happened,
+    // and only the newest ones before it are needed should this checkpoint fail too
+    sqliteConnector_.query_with_text_params(
+        "DELETE FROM omnisci_table_stream_offsets WHERE tableid = ? AND (epoch >= ? OR "
+        "epoch < (SELECT MAX(epoch) FROM omnisci_table_stream_offsets WHERE tableid = ? "
+        "AND epoch < ?))",
+        std::vector<std::string>{table_id_str, epoch_str, table_id_str, epoch_str});
+    for (const auto& [topic_partition, next_offset] : offsets) {
+      sqliteConnector_.query_with_text_params(
+          "INSERT INTO omnisci_table_stream_offsets (tableid, topic, partition_id, "
+          "epoch, next_offset) VALUES (?, ?, ?, ?, ?)",
+          std::vector<std::string>{table_id_str,
+                                   topic_partition.first,
+                                   std::to_string(topic_partition.second),
+                                   epoch_str,
+                                   std::to_string(next_offset)});
+    }
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+}
+
+namespace {
+
+std::string join_statistics_values(const std::vector<int64_t>& values) {
+  std::string joined;
+  for (const auto value : values) {
+    joined += (joined.empty() ? "" : ",") + std::to_string(value);
+  }
+  return joined;
+}
+
+std::vector<int64_t> split_statistics_values(const std::string& joined) {
+  std::vector<int64_t> values;
+  if (!joined.empty()) {
+    for (const auto& value : split(joined, ",")) {
+      values.push_back(std::stoll(value));
+    }
+  }
+  return values;
+}
+
+}  // namespace
+
+const std::string Catalog::getColumnStatisticsSchema(bool if_not_exists) {
+  return "CREATE TABLE " + (if_not_exists ? std::string{"IF NOT EXISTS "} : "") +
+         "omnisci_column_statistics(tableid integer, columnid integer, " +
+         "row_count bigint, null_count bigint, ndv bigint, histogram text, " +
+         "most_common_values text, primary key(tableid, columnid))";
+}
+
+void Catalog::updateColumnStatisticsSchema() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query(getColumnStatisticsSchema(true));
+}
+
+void Catalog::loadColumnStatistics() {
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query(
+      "SELECT tableid, columnid, row_count, null_count, ndv, histogram, "
+      "most_common_values FROM omnisci_column_statistics");
+  std::lock_guard<std::mutex> statistics_lock(column_statistics_mutex_);
+  columnStatistics_.clear();
+  for (size_t r = 0; r < sqliteConnector_.getNumRows(); ++r) {
+    ColumnStatistics statistics;
+    statistics.rowCount = sqliteConnector_.getData<int64_t>(r, 2);
+    statistics.nullCount = sqliteConnector_.getData<int64_t>(r, 3);
+    statistics.ndv = sqliteConnector_.getData<int64_t>(r, 4);
+    statistics.histogramBounds =
+        split_statistics_values(sqliteConnector_.getData<std::string>(r, 5));
+    // the most common values and their counts alternate
+    const auto most_common_values =
+        split_statistics_values(sqliteConnector_.getData<std::string>(r, 6));
+    for (size_t i = 0; i + 1 < most_common_values.size(); i += 2) {
+      statistics.mostCommonValues.emplace_back(most_common_values[i],
+                                               most_common_values[i + 1]);
+    }
+    columnStatistics_[{sqliteConnector_.getData<int>(r, 0),
+                       sqliteConnector_.getData<int>(r, 1)}] = std::move(statistics);
+  }
+}
+
+void Catalog::setColumnStatistics(const TableDescriptor* td,
+                                  const std::map<int, ColumnStatistics>& statistics) {
+  CHECK(td);
+  if (!table_is_temporary(td)) {
+    cat_sqlite_lock sqlite_lock(this);
+    sqliteConnector_.query("BEGIN TRANSACTION");
+    try {
+      for (const auto& [column_id, column_statistics] : statistics) {
+        std::vector<int64_t> most_common_values;
+        for (const auto& [value, count] : column_statistics.mostCommonValues) {
+          most_common_values.push_back(value);
+          most_common_values.push_back(count);
+        }
+        sqliteConnector_.query_with_text_params(
+            "INSERT OR REPLACE INTO omnisci_column_statistics (tableid, columnid, "
+            "row_count, null_count, ndv, histogram, most_common_values) VALUES (?, ?, "
+            "?, ?, ?, ?, ?)",
+            std::vector<std::string>{
+                std::to_string(td->tableId),
+                std::to_string(column_id),
+                std::to_string(column_statistics.rowCount),
+                std::to_string(column_statistics.nullCount),
+                std::to_string(column_statistics.ndv),
+                join_statistics_values(column_statistics.histogramBounds),
+                join_statistics_values(most_common_values)});
+      }
+    } catch (std::exception& e) {
+      sqliteConnector_.query("ROLLBACK TRANSACTION");
+      throw;
+    }
+    sqliteConnector_.query("END TRANSACTION");
+  }
+  std::lock_guard<std::mutex> statistics_lock(column_statistics_mutex_);
+  for (const auto& [column_id, column_statistics] : statistics) {
+    columnStatistics_[{td->tableId, column_id}] = column_statistics;
+  }
+}
+
+std::optional<ColumnStatistics> Catalog::getColumnStatistics(const int tableId,
+                                                             const int columnId) const {
+  std::lock_guard<std::mutex> statistics_lock(column_statistics_mutex_);
+  const auto it = columnStatistics_.find({tableId, columnId});
+  if (it == columnStatistics_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+TableStreamOffsets Catalog::getTableStreamOffsets(const int tableId) {
+  // a checkpoint at epoch makes epoch + 1 the current epoch, also after a restart
+  const auto current_epoch = getTableEpoch(currentDB_.dbId, tableId);
+  cat_sqlite_lock sqlite_lock(this);
+  const auto table_id_str = std::to_string(tableId);
+  const auto epoch_str = std::to_string(current_epoch);
+  sqliteConnector_.query_with_text_params(
+      "SELECT topic, partition_id, next_offset FROM omnisci_table_stream_offsets WHERE "
+      "tableid = ? AND epoch = (SELECT MAX(epoch) FROM omnisci_table_stream_offsets "
+      "WHERE tableid = ? AND epoch < ?)",
+      std::vector<std::string>{table_id_str, table_id_str, epoch_str});
+  TableStreamOffsets offsets;
+  for (size_t r = 0; r < sqliteConnector_.getNumRows(); ++r) {
+    offsets[{sqliteConnector_.getData<std::string>(r, 0),
+             sqliteConnector_.getData<int32_t>(r, 1)}] =
+        sqliteConnector_.getData<int64_t>(r, 2);
+  }
+  return offsets;
+}
+
 void Catalog::recordOwnershipOfObjectsInObjectPermissions() {
   cat_sqlite_lock sqlite_lock(this);
   sqliteConnector_.query("BEGIN TRANSACTION");
@@ -899,6 +1198,8 @@ void Catalog::CheckAndExecuteMigrations() {
   updateDeletedColumnIndicator();
   updateFrontendViewsToDashboards();
   recordOwnershipOfObjectsInObjectPermissions();
+  updateTableStreamSchema();
+  updateColumnStatisticsSchema();
 
   if (g_enable_fsi) {
     createFsiSchemasAndDefaultServers();
@@ -949,7 +1250,9 @@ void Catalog::buildMaps() {
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, "
       "max_chunk_size, frag_page_size, "
       "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, "
-      "sort_column_id, storage_type "
+      "sort_column_id, storage_type, extent_size, chunk_compression, "
+      "bloom_filter_columns, partition_column_id, partition_interval, "
+      "partition_retention, pinned_cpu_columns, pinned_gpu_columns "
       "from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
@@ -992,6 +1295,36 @@ void Catalog::buildMaps() {
     td->userId = sqliteConnector_.getData<int>(r, 15);
     td->sortedColumnId =
         sqliteConnector_.isNull(r, 16) ? 0 : sqliteConnector_.getData<int>(r, 16);
+    td->extentSize =
+        sqliteConnector_.isNull(r, 18) ? 0 : sqliteConnector_.getData<int64_t>(r, 18);
+    td->chunkCompression =
+        sqliteConnector_.isNull(r, 19) ? "" : sqliteConnector_.getData<string>(r, 19);
+    const auto bloom_filter_columns =
+        sqliteConnector_.isNull(r, 20) ? "" : sqliteConnector_.getData<string>(r, 20);
+    if (!bloom_filter_columns.empty()) {
+      for (const auto& column_id : split(bloom_filter_columns, ",")) {
+        td->bloomFilterColumnIds.push_back(std::stoi(column_id));
+      }
+    }
+    td->partitionColumnId =
+        sqliteConnector_.isNull(r, 21) ? 0 : sqliteConnector_.getData<int>(r, 21);
+    td->partitionInterval =
+        sqliteConnector_.isNull(r, 22) ? 0 : sqliteConnector_.getData<int64_t>(r, 22);
+    td->partitionRetention =
+        sqliteConnector_.isNull(r, 23) ? 0 : sqliteConnector_.getData<int>(r, 23);
+    const auto get_column_ids = [this, r](const size_t col) {
+      std::vector<int> column_ids;
+      const auto column_ids_str =
+          sqliteConnector_.isNull(r, col) ? "" : sqliteConnector_.getData<string>(r, col);
+      if (!column_ids_str.empty()) {
+        for (const auto& column_id : split(column_ids_str, ",")) {
+          column_ids.push_back(std::stoi(column_id));
+        }
+      }
+      return column_ids;
+    };
+    td->pinnedCpuColumnIds = get_column_ids(24);
+    td->pinnedGpuColumnIds = get_column_ids(25);
     if (!td->isView) {
       td->fragmenter = nullptr;
     }
@@ -1132,6 +1465,10 @@ void Catalog::buildMaps() {
       physicalTableIt->second.push_back(physical_tb_id);
     }
   }
+
+  if (dataMgr_) {
+    recoverDictionaryCompactions();
+  }
 }
 
 void Catalog::addTableToMap(const TableDescriptor* td,
@@ -1375,6 +1712,28 @@ void Catalog::instantiateFragmenter(TableDescriptor* td) const {
     getAllColumnMetadataForTableImpl(td, columnDescs, true, false, true);
     Chunk::translateColumnDescriptorsToChunkVec(columnDescs, chunkVec);
     ChunkKey chunkKeyPrefix = {currentDB_.dbId, td->tableId};
+    if (td->extentSize > 0 && td->storageType.empty() &&
+        td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
+      // before the fragmenter loads the table, so that the FileMgr has it for new pages
+      dataMgr_->setTableExtentSize(currentDB_.dbId, td->tableId, td->extentSize);
+    }
+    Fragmenter_Namespace::TimePartitioning partitioning;
+    if (table_is_partitioned(td)) {
+      const auto partition_cd = std::find_if(
+          columnDescs.begin(), columnDescs.end(), [td](const ColumnDescriptor* cd) {
+            return cd->columnId == td->partitionColumnId;
+          });
+      CHECK(partition_cd != columnDescs.end());
+      const auto& partition_ti = (*partition_cd)->columnType;
+      partitioning.columnId = td->partitionColumnId;
+      // high precision timestamps count fractions of seconds
+      const int64_t scale =
+          partition_ti.is_timestamp()
+              ? DateTimeUtils::get_timestamp_precision_scale(partition_ti.get_dimension())
+              : 1;
+      partitioning.width = td->partitionInterval * scale;
+      partitioning.retention = td->partitionRetention;
+    }
     if (td->sortedColumnId > 0) {
       td->fragmenter = std::make_shared<SortedOrderFragmenter>(chunkKeyPrefix,
                                                                chunkVec,
@@ -1386,7 +1745,8 @@ void Catalog::instantiateFragmenter(TableDescriptor* td) const {
                                                                td->maxChunkSize,
                                                                td->fragPageSize,
                                                                td->maxRows,
-                                                               td->persistenceLevel);
+                                                               td->persistenceLevel,
+                                                               partitioning);
     } else {
       td->fragmenter = std::make_shared<InsertOrderFragmenter>(chunkKeyPrefix,
                                                                chunkVec,
@@ -1399,17 +1759,71 @@ void Catalog::instantiateFragmenter(TableDescriptor* td) const {
                                                                td->fragPageSize,
                                                                td->maxRows,
                                                                td->persistenceLevel,
-                                                               !td->storageType.empty());
+                                                               !td->storageType.empty(),
+                                                               partitioning);
     }
   });
   LOG(INFO) << "Instantiating Fragmenter for table " << td->tableName << " took "
             << time_ms << "ms";
 }
 
+namespace {
+
+std::atomic<uint64_t> next_metadata_version{1};
+
+}  // namespace
+
+void Catalog::invalidateMetadataSnapshot() const {
+  metadata_version_ = next_metadata_version++;
+}
+
+const Catalog::MetadataSnapshot* Catalog::getMetadataSnapshot() const {
+  struct CachedSnapshot {
+    uint64_t version{0};
+    std::shared_ptr<const MetadataSnapshot> snapshot;
+  };
+  // by thread, so that the lookups don't share any cache line but the version's
+  thread_local std::unordered_map<const Catalog*, CachedSnapshot> cached_snapshots;
+  const auto version = metadata_version_.load();
+  if (version == 0 || thread_holding_write_lock == std::this_thread::get_id()) {
+    return nullptr;
+  }
+  auto& cached = cached_snapshots[this];
+  if (cached.version != version) {
+    cat_read_lock read_lock(this);
+    std::lock_guard<std::mutex> snapshot_lock(metadata_snapshot_mutex_);
+    // the version can't change while the read lock is held
+    const auto current_version = metadata_version_.load();
+    if (metadata_snapshot_version_ != current_version) {
+      metadata_snapshot_ = std::make_shared<const MetadataSnapshot>(
+          MetadataSnapshot{tableDescriptorMap_,
+                           tableDescriptorMapById_,
+                           columnDescriptorMap_,
+                           columnDescriptorMapById_});
+      metadata_snapshot_version_ = current_version;
+    }
+    cached.version = current_version;
+    cached.snapshot = metadata_snapshot_;
+  }
+  return cached.snapshot.get();
+}
+
 const TableDescriptor* Catalog::getMetadataForTable(const string& tableName,
                                                     const bool populateFragmenter) const {
   // we give option not to populate fragmenter (default true/yes) as it can be heavy for
   // pure metadata calls
+  if (const auto snapshot = getMetadataSnapshot()) {
+    const auto table_it = snapshot->tables_by_name.find(to_upper(tableName));
+    if (table_it == snapshot->tables_by_name.end()) {
+      return nullptr;
+    }
+    TableDescriptor* td = table_it->second;
+    std::unique_lock<std::mutex> td_lock(*td->mutex_.get());
+    if (!populateFragmenter || td->fragmenter || td->isView) {
+      return td;
+    }
+    // instantiating the fragmenter reads the catalog under its lock
+  }
   cat_read_lock read_lock(this);
   auto tableDescIt = tableDescriptorMap_.find(to_upper(tableName));
   if (tableDescIt == tableDescriptorMap_.end()) {  // check to make sure table exists
@@ -1442,6 +1856,20 @@ const TableDescriptor* Catalog::getMetadataForTableImpl(
 
 const TableDescriptor* Catalog::getMetadataForTable(int tableId,
                                                     bool populateFragmenter) const {
+  if (const auto snapshot = getMetadataSnapshot()) {
+    const auto table_it = snapshot->tables_by_id.find(tableId);
+    if (table_it == snapshot->tables_by_id.end()) {
+      return nullptr;
+    }
+    TableDescriptor* td = table_it->second;
+    if (!populateFragmenter) {
+      return td;
+    }
+    std::unique_lock<std::mutex> td_lock(*td->mutex_.get());
+    if (td->fragmenter || td->isView) {
+      return td;
+    }
+  }
   cat_read_lock read_lock(this);
   return getMetadataForTableImpl(tableId, populateFragmenter);
 }
@@ -1493,9 +1921,12 @@ const std::vector<LeafHostInfo>& Catalog::getStringDictionaryHosts() const {
 
 const ColumnDescriptor* Catalog::getMetadataForColumn(int tableId,
                                                       const string& columnName) const {
-  cat_read_lock read_lock(this);
-
   ColumnKey columnKey(tableId, to_upper(columnName));
+  if (const auto snapshot = getMetadataSnapshot()) {
+    const auto column_it = snapshot->columns_by_name.find(columnKey);
+    return column_it == snapshot->columns_by_name.end() ? nullptr : column_it->second;
+  }
+  cat_read_lock read_lock(this);
   auto colDescIt = columnDescriptorMap_.find(columnKey);
   if (colDescIt ==
       columnDescriptorMap_.end()) {  // need to check to make sure column exists for table
@@ -1505,6 +1936,10 @@ const ColumnDescriptor* Catalog::getMetadataForColumn(int tableId,
 }
 
 const ColumnDescriptor* Catalog::getMetadataForColumn(int table_id, int column_id) const {
+  if (const auto snapshot = getMetadataSnapshot()) {
+    const auto column_it = snapshot->columns_by_id.find(ColumnIdKey(table_id, column_id));
+    return column_it == snapshot->columns_by_id.end() ? nullptr : column_it->second;
+  }
   cat_read_lock read_lock(this);
   return getMetadataForColumnUnlocked(table_id, column_id);
 }
@@ -1907,6 +2342,13 @@ void Catalog::dropColumn(const TableDescriptor& td, const ColumnDescriptor& cd)
   sqliteConnector_.query_with_text_params(
       "UPDATE mapd_tables SET ncolumns = ncolumns - 1 WHERE tableid = ?",
       std::vector<std::string>{std::to_string(td.tableId)});
+  sqliteConnector_.query_with_text_params(
+      "DELETE FROM omnisci_column_statistics where tableid = ? and columnid = ?",
+      std::vector<std::string>{std::to_string(td.tableId), std::to_string(cd.columnId)});
+  {
+    std::lock_guard<std::mutex> statistics_lock(column_statistics_mutex_);
+    columnStatistics_.erase({td.tableId, cd.columnId});
+  }
 
   ColumnDescriptorMap::iterator columnDescIt =
       columnDescriptorMap_.find(ColumnKey(cd.tableId, to_upper(cd.columnName)));
@@ -2178,7 +2620,7 @@ void Catalog::createTable(
   if (td.persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL) {
     try {
       sqliteConnector_.query_with_text_params(
-          R"(INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, sort_column_id, storage_type, key_metainfo) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))",
+          R"(INSERT INTO mapd_tables (name, userid, ncolumns, isview, fragments, frag_type, max_frag_rows, max_chunk_size, frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, sort_column_id, storage_type, key_metainfo, extent_size, chunk_compression, bloom_filter_columns, partition_column_id, partition_interval, partition_retention) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?))",
           std::vector<std::string>{td.tableName,
                                    std::to_string(td.userId),
                                    std::to_string(td.nColumns),
@@ -2195,7 +2637,13 @@ void Catalog::createTable(
                                    std::to_string(td.nShards),
                                    std::to_string(td.sortedColumnId),
                                    td.storageType,
-                                   td.keyMetainfo});
+                                   td.keyMetainfo,
+                                   std::to_string(td.extentSize),
+                                   td.chunkCompression,
+                                   join(td.bloomFilterColumnIds, ","),
+                                   std::to_string(td.partitionColumnId),
+                                   std::to_string(td.partitionInterval),
+                                   std::to_string(td.partitionRetention)});
 
       // now get the auto generated tableid
       sqliteConnector_.query_with_text_param(
@@ -2719,6 +3167,25 @@ void Catalog::setTableEpoch(const int db_id, const int table_id, int new_epoch)
   cat_read_lock read_lock(this);
   LOG(INFO) << "Set table epoch db:" << db_id << " Table ID  " << table_id
             << " back to new epoch " << new_epoch;
+  // rolling back to the current epoch, as after a failed insert, loses the inserts
+  // logged since the last checkpoint, so those are applied again. Rolling back further
+  // discards them.
+  std::set<int> replayTableIds;
+  if (insertWal_) {
+    std::vector<int> tableIds{table_id};
+    const auto physicalTableIt = logicalToPhysicalTableMapById_.find(table_id);
+    if (physicalTableIt != logicalToPhysicalTableMapById_.end()) {
+      tableIds.insert(
+          tableIds.end(), physicalTableIt->second.begin(), physicalTableIt->second.end());
+    }
+    for (const auto tableId : tableIds) {
+      if (new_epoch >= static_cast<int>(dataMgr_->getTableEpoch(db_id, tableId))) {
+        replayTableIds.insert(tableId);
+      } else {
+        insertWal_->resetTable(tableId);
+      }
+    }
+  }
   removeChunks(table_id);
   dataMgr_->setTableEpoch(db_id, table_id, new_epoch);
 
@@ -2737,6 +3204,44 @@ void Catalog::setTableEpoch(const int db_id, const int table_id, int new_epoch)
       dataMgr_->setTableEpoch(db_id, physical_tb_id, new_epoch);
     }
   }
+  if (!replayTableIds.empty()) {
+    replayInsertWal(replayTableIds);
+  }
+}
+
+void Catalog::replayInsertWal(const std::set<int>& tableIds) {
+  CHECK(insertWal_);
+  std::set<int> replayedTableIds;
+  insertWal_->replay(
+      [this, &replayedTableIds](const int tableId,
+                                const int epoch,
+                                Fragmenter_Namespace::InsertData& insertData) {
+        const auto td = getMetadataForTable(tableId);
+        // inserts at a checkpointed epoch are in the data files already
+        if (!td || !td->fragmenter ||
+            static_cast<int>(dataMgr_->getTableEpoch(currentDB_.dbId, tableId)) > epoch) {
+          return;
+        }
+        insertData.databaseId = currentDB_.dbId;
+        td->fragmenter->insertDataNoCheckpoint(insertData);
+        replayedTableIds.insert(tableId);
+      },
+      tableIds);
+  for (const auto tableId : replayedTableIds) {
+    dataMgr_->checkpoint(currentDB_.dbId, tableId);
+  }
+  if (!replayedTableIds.empty()) {
+    LOG(INFO) << "Replayed logged inserts into " << replayedTableIds.size()
+              << " tables of database " << currentDB_.dbName;
+  }
+}
+
+std::function<int(const int)> Catalog::getInsertWalTableEpochs() const {
+  return [this](const int tableId) {
+    return getMetadataForTable(tableId, false)
+               ? static_cast<int>(dataMgr_->getTableEpoch(currentDB_.dbId, tableId))
+               : -1;
+  };
 }
 
 const ColumnDescriptor* Catalog::getDeletedColumn(const TableDescriptor* td) const {
@@ -3033,6 +3538,9 @@ void Catalog::doTruncateTable(const TableDescriptor* td) {
   dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::CPU_LEVEL);
   dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::GPU_LEVEL);
 
+  if (insertWal_) {
+    insertWal_->resetTable(tableId);
+  }
   dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
 
   std::unique_ptr<StringDictionaryClient> client;
@@ -3192,6 +3700,18 @@ void Catalog::executeDropTableSqliteQueries(const TableDescriptor* td) {
     sqliteConnector_.query_with_text_param(
         "DELETE FROM omnisci_foreign_tables WHERE table_id = ?", std::to_string(tableId));
   }
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM omnisci_table_streams WHERE tableid = ?", std::to_string(tableId));
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM omnisci_table_stream_offsets WHERE tableid = ?",
+      std::to_string(tableId));
+  sqliteConnector_.query_with_text_param(
+      "DELETE FROM omnisci_column_statistics WHERE tableid = ?", std::to_string(tableId));
+  std::lock_guard<std::mutex> statistics_lock(column_statistics_mutex_);
+  for (auto it = columnStatistics_.lower_bound({tableId, 0});
+       it != columnStatistics_.end() && it->first.first == tableId;) {
+    it = columnStatistics_.erase(it);
+  }
 }
 
 void Catalog::renamePhysicalTable(const TableDescriptor* td, const string& newTableName) {
@@ -3260,6 +3780,267 @@ void Catalog::renameTable(const TableDescriptor* td, const string& newTableName)
   }
 }
 
+void Catalog::reencodeColumn(const TableDescriptor* td,
+                             const ColumnDescriptor* cd,
+                             const SQLTypeInfo& newType) {
+  cat_write_lock write_lock(this);
+  cat_sqlite_lock sqlite_lock(this);
+  // the logical table has descriptors of its own if it is sharded
+  auto tds = getPhysicalTablesDescriptors(td);
+  if (tds.front() != td) {
+    tds.push_back(td);
+  }
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    for (const auto tdx : tds) {
+      sqliteConnector_.query_with_text_params(
+          "UPDATE mapd_columns SET compression = ?, comp_param = ?, size = ? WHERE "
+          "tableid = ? AND columnid = ?",
+          std::vector<std::string>{std::to_string(newType.get_compression()),
+                                   std::to_string(newType.get_comp_param()),
+                                   std::to_string(newType.get_size()),
+                                   std::to_string(tdx->tableId),
+                                   std::to_string(cd->columnId)});
+    }
+    for (const auto tdx : tds) {
+      const auto columnDescIt =
+          columnDescriptorMapById_.find(ColumnIdKey(tdx->tableId, cd->columnId));
+      CHECK(columnDescIt != columnDescriptorMapById_.end());
+      ColumnDescriptor* changeCd = columnDescIt->second;
+      if (tdx->fragmenter) {
+        tdx->fragmenter->reencodeColumn(changeCd, newType);
+      }
+      changeCd->columnType = newType;
+    }
+    checkpoint(td->tableId);
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+  calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
+}
+
+namespace {
+
+// A dictionary is compacted into the folder with this suffix, which replaces the
+// dictionary's once the chunks were remapped
+const std::string kCompactDictionarySuffix{".compact"};
+// The folder of the dictionary being replaced
+const std::string kOldDictionarySuffix{".old"};
+// The epochs of the physical tables before their chunks were remapped, in the folder
+// of the compacted dictionary. The remapping happened if they were checkpointed since.
+const std::string kCompactionEpochsFile{"compaction_epochs"};
+
+// Strings moved to the compacted dictionary at a time
+constexpr size_t kCompactionBatchSize{1 << 20};
+
+void sync_path(const std::string& path, const bool is_directory) {
+  const int fd = ::open(path.c_str(), is_directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+  const bool ok = fd >= 0 && ::fsync(fd) == 0;
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (!ok) {
+    throw std::runtime_error("Failed to sync " + path + ": " + strerror(errno));
+  }
+}
+
+void write_compaction_epochs(const std::string& compact_path,
+                             const std::vector<std::pair<int, size_t>>& epochs) {
+  const auto path = compact_path + "/" + kCompactionEpochsFile;
+  {
+    std::ofstream epochs_file(path);
+    for (const auto& [table_id, epoch] : epochs) {
+      epochs_file << table_id << " " << epoch << "\n";
+    }
+    if (!epochs_file.good()) {
+      throw std::runtime_error("Failed to write " + path);
+    }
+  }
+  sync_path(path, false);
+  sync_path(compact_path, true);
+}
+
+std::vector<std::pair<int, size_t>> read_compaction_epochs(
+    const std::string& compact_path) {
+  std::vector<std::pair<int, size_t>> epochs;
+  std::ifstream epochs_file(compact_path + "/" + kCompactionEpochsFile);
+  int table_id;
+  size_t epoch;
+  while (epochs_file >> table_id >> epoch) {
+    epochs.emplace_back(table_id, epoch);
+  }
+  return epochs;
+}
+
+// Replaces the dictionary in folder path by its compacted one, also when an earlier
+// replacement was interrupted after moving the old folder away
+void swap_in_compacted_dictionary(const std::string& path) {
+  const auto old_path = path + kOldDictionarySuffix;
+  if (boost::filesystem::exists(path)) {
+    boost::filesystem::remove_all(old_path);
+    boost::filesystem::rename(path, old_path);
+  }
+  boost::filesystem::rename(path + kCompactDictionarySuffix, path);
+  sync_path(boost::filesystem::path(path).parent_path().string(), true);
+  boost::filesystem::remove(path + "/" + kCompactionEpochsFile);
+  boost::filesystem::remove_all(old_path);
+}
+
+}  // namespace
+
+size_t Catalog::compactDictionary(const TableDescriptor* td, const int dictId) {
+  cat_write_lock write_lock(this);
+  if (!string_dict_hosts_.empty() || td->persistenceLevel != Data_Namespace::DISK_LEVEL) {
+    throw std::runtime_error("Only dictionaries stored locally can be compacted.");
+  }
+  auto dictDescIt = dictDescriptorMapByRef_.find(DictRef(currentDB_.dbId, dictId));
+  CHECK(dictDescIt != dictDescriptorMapByRef_.end());
+  auto& dd = dictDescIt->second;
+  const auto tds = getPhysicalTablesDescriptors(td);
+  // the columns of the physical tables of td which use the dictionary, with their tables
+  std::vector<std::pair<const TableDescriptor*, const ColumnDescriptor*>> columns;
+  for (const auto cd : get_dictionary_columns(dictId, *this)) {
+    const auto tdIt = std::find_if(tds.begin(), tds.end(), [cd](const auto tdx) {
+      return tdx->tableId == cd->tableId;
+    });
+    if (tdIt == tds.end() && cd->tableId != td->tableId) {
+      throw std::runtime_error("Dictionary " + dd->dictName +
+                               " is shared with another table and cannot be compacted.");
+    }
+    if (!cd->columnType.is_dict_encoded_string()) {
+      throw std::runtime_error("Dictionary " + dd->dictName +
+                               " encodes an array and cannot be compacted.");
+    }
+    if (tdIt != tds.end()) {
+      columns.emplace_back(*tdIt, cd);
+    }
+  }
+
+  // the chunks have all ids, and the insert log none the remapping would miss
+  checkpoint(td->tableId);
+  std::vector<std::pair<int, size_t>> epochs;
+  for (const auto tdx : tds) {
+    CHECK(tdx->fragmenter);
+    epochs.emplace_back(tdx->tableId,
+                        dataMgr_->getTableEpoch(currentDB_.dbId, tdx->tableId));
+  }
+  auto old_dict = getMetadataForDictUnlocked(dictId, true)->stringDict;
+  CHECK(old_dict);
+  const size_t num_ids = old_dict->storageEntryCount();
+  std::vector<bool> is_used(num_ids, false);
+  for (const auto& [tdx, cd] : columns) {
+    tdx->fragmenter->markUsedStringIds(cd, is_used);
+  }
+  const size_t num_used = std::count(is_used.begin(), is_used.end(), true);
+  const size_t num_removed = num_ids - num_used;
+  if (num_removed == 0 ||
+      num_removed < g_dictionary_compaction_min_dead_fraction * num_ids) {
+    return 0;
+  }
+
+  const auto& path = dd->dictFolderPath;
+  const auto compact_path = path + kCompactDictionarySuffix;
+  boost::filesystem::remove_all(compact_path);
+  boost::filesystem::create_directory(compact_path);
+  // the strings keep their order, so the new id of a string is its rank
+  std::vector<int32_t> new_ids(num_ids, -1);
+  try {
+    StringDictionary compact_dict(compact_path, false, false, g_cache_string_hash);
+    std::vector<std::string> strings;
+    std::vector<int32_t> string_ids;
+    int32_t num_added{0};
+    auto add_strings = [&]() {
+      string_ids.resize(strings.size());
+      compact_dict.getOrAddBulk(strings, string_ids.data());
+      for (const auto string_id : string_ids) {
+        CHECK_EQ(string_id, num_added++);
+      }
+      strings.clear();
+    };
+    for (size_t id = 0; id < num_ids; ++id) {
+      if (is_used[id]) {
+        new_ids[id] = num_added + static_cast<int32_t>(strings.size());
+        strings.push_back(old_dict->getString(id));
+        if (strings.size() == kCompactionBatchSize) {
+          add_strings();
+        }
+      }
+    }
+    add_strings();
+    if (!compact_dict.checkpoint()) {
+      throw std::runtime_error("Failed to checkpoint the compacted dictionary " +
+                               dd->dictName);
+    }
+  } catch (...) {
+    boost::filesystem::remove_all(compact_path);
+    throw;
+  }
+
+  // from here on a restart keeps the compacted dictionary if the remapping was
+  // checkpointed, see recoverDictionaryCompactions()
+  write_compaction_epochs(compact_path, epochs);
+  try {
+    for (const auto& [tdx, cd] : columns) {
+      tdx->fragmenter->remapStringIds(cd, new_ids);
+    }
+    checkpoint(td->tableId);
+  } catch (...) {
+    // back to the chunks of the old ids
+    setTableEpoch(currentDB_.dbId, td->tableId, epochs.front().second);
+    boost::filesystem::remove_all(compact_path);
+    throw;
+  }
+  {
+    std::lock_guard string_dict_lock(*dd->string_dict_mutex);
+    // the old dictionary is done with its files before they are removed
+    old_dict.reset();
+    dd->stringDict.reset();
+    swap_in_compacted_dictionary(path);
+  }
+  LOG(INFO) << "Compacted dictionary " << dd->dictName << " of table " << td->tableName
+            << " from " << num_ids << " to " << num_used << " strings";
+  return num_removed;
+}
+
+void Catalog::recoverDictionaryCompactions() {
+  for (const auto& [dict_ref, dd] : dictDescriptorMapByRef_) {
+    const auto& path = dd->dictFolderPath;
+    const auto compact_path = path + kCompactDictionarySuffix;
+    if (boost::filesystem::exists(compact_path)) {
+      // without its epochs the compacted dictionary was not complete
+      const auto epochs = read_compaction_epochs(compact_path);
+      bool remapped = !epochs.empty() && !boost::filesystem::exists(path);
+      if (!epochs.empty() && !remapped) {
+        std::vector<std::pair<int, size_t>> checkpointed;
+        for (const auto& [table_id, epoch] : epochs) {
+          if (dataMgr_->getTableEpoch(currentDB_.dbId, table_id) > epoch) {
+            checkpointed.emplace_back(table_id, epoch);
+          }
+        }
+        remapped = checkpointed.size() == epochs.size();
+        if (!remapped) {
+          // the shards checkpointed first go back to the old ids of the others
+          for (const auto& [table_id, epoch] : checkpointed) {
+            dataMgr_->setTableEpoch(currentDB_.dbId, table_id, epoch);
+          }
+        }
+      }
+      if (remapped) {
+        LOG(INFO) << "Completing the compaction of dictionary " << dd->dictName;
+        swap_in_compacted_dictionary(path);
+      } else {
+        LOG(INFO) << "Discarding an incomplete compaction of dictionary "
+                  << dd->dictName;
+        boost::filesystem::remove_all(compact_path);
+      }
+    }
+    boost::filesystem::remove(path + "/" + kCompactionEpochsFile);
+    boost::filesystem::remove_all(path + kOldDictionarySuffix);
+  }
+}
+
 void Catalog::renameColumn(const TableDescriptor* td,
                            const ColumnDescriptor* cd,
                            const string& newColumnName) {
@@ -3648,7 +4429,15 @@ void Catalog::eraseTablePhysicalData(const TableDescriptor* td) {
   }
   if (!td->isView) {
     INJECT_TIMER(Remove_Table);
+    if (insertWal_) {
+      insertWal_->resetTable(tableId);
+    }
     dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
+    // the chunks of the columns pinned on the table go with it
+    dataMgr_->setResidentColumns(
+        currentDB_.dbId, {tableId}, {}, Data_Namespace::MemoryLevel::CPU_LEVEL, 0);
+    dataMgr_->setResidentColumns(
+        currentDB_.dbId, {tableId}, {}, Data_Namespace::MemoryLevel::GPU_LEVEL, 0);
   }
   calciteMgr_->updateMetadata(currentDB_.dbName, td->tableName);
   {
@@ -3665,10 +4454,12 @@ std::string Catalog::generatePhysicalTableName(const std::string& logicalTableNa
 }
 
 void Catalog::set(const std::string& dbName, std::shared_ptr<Catalog> cat) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   mapd_cat_map_[dbName] = cat;
 }
 
 std::shared_ptr<Catalog> Catalog::get(const std::string& dbName) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   auto cat_it = mapd_cat_map_.find(dbName);
   if (cat_it != mapd_cat_map_.end()) {
     return cat_it->second;
@@ -3677,6 +4468,7 @@ std::shared_ptr<Catalog> Catalog::get(const std::string& dbName) {
 }
 
 std::shared_ptr<Catalog> Catalog::get(const int32_t db_id) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   for (const auto& entry : mapd_cat_map_) {
     if (entry.second->currentDB_.dbId == db_id) {
       return entry.second;
@@ -3691,19 +4483,45 @@ std::shared_ptr<Catalog> Catalog::get(const string& basePath,
                                       const std::vector<LeafHostInfo>& string_dict_hosts,
                                       std::shared_ptr<Calcite> calcite,
                                       bool is_new_db) {
-  auto cat = Catalog::get(curDB.dbName);
-
-  if (cat) {
-    return cat;
-  } else {
+  std::promise<std::shared_ptr<Catalog>> loaded_cat;
+  {
+    std::unique_lock<std::mutex> lock(mapd_cat_map_mutex_);
+    const auto cat_it = mapd_cat_map_.find(curDB.dbName);
+    if (cat_it != mapd_cat_map_.end()) {
+      return cat_it->second;
+    }
+    const auto loading_cat_it = loading_cat_map_.find(curDB.dbName);
+    if (loading_cat_it != loading_cat_map_.end()) {
+      auto loading_cat = loading_cat_it->second;
+      lock.unlock();
+      return loading_cat.get();
+    }
+    loading_cat_map_.emplace(curDB.dbName, loaded_cat.get_future().share());
+  }
+  // built outside of the lock, the catalogs of the other databases load meanwhile
+  std::shared_ptr<Catalog> cat;
+  try {
     cat = std::make_shared<Catalog>(
         basePath, curDB, dataMgr, string_dict_hosts, calcite, is_new_db);
-    Catalog::set(curDB.dbName, cat);
-    return cat;
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
+      loading_cat_map_.erase(curDB.dbName);
+    }
+    loaded_cat.set_exception(std::current_exception());
+    throw;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
+    mapd_cat_map_[curDB.dbName] = cat;
+    loading_cat_map_.erase(curDB.dbName);
   }
+  loaded_cat.set_value(cat);
+  return cat;
 }
 
 void Catalog::remove(const std::string& dbName) {
+  std::lock_guard<std::mutex> lock(mapd_cat_map_mutex_);
   mapd_cat_map_.erase(dbName);
 }
 
@@ -3717,39 +4535,326 @@ void Catalog::vacuumDeletedRows(const int logicalTableId) const {
 }
 
 void Catalog::vacuumDeletedRows(const TableDescriptor* td) const {
+  for (const auto fragment_id : getFragmentsToVacuum(td, 0)) {
+    vacuumFragment(td, fragment_id);
+  }
+}
+
+std::vector<int> Catalog::getFragmentsToVacuum(const TableDescriptor* td,
+                                               const double minDeletedFraction) const {
   // "if not a table that supports delete return nullptr,  nothing more to do"
   const ColumnDescriptor* cd = getDeletedColumn(td);
   if (nullptr == cd) {
-    return;
+    return {};
   }
   // vacuum chunks which show sign of deleted rows in metadata
   ChunkKey chunkKeyPrefix = {currentDB_.dbId, td->tableId, cd->columnId};
   ChunkMetadataVector chunkMetadataVec;
   dataMgr_->getChunkMetadataVecForKeyPrefix(chunkMetadataVec, chunkKeyPrefix);
-  for (auto cm : chunkMetadataVec) {
+  std::vector<int> fragment_ids;
+  for (const auto& cm : chunkMetadataVec) {
     // "delete has occured"
-    if (cm.second->chunkStats.max.tinyintval == 1) {
-      UpdelRoll updel_roll;
-      updel_roll.catalog = this;
-      updel_roll.logicalTableId = getLogicalTableId(td->tableId);
-      updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
-      const auto cd = getMetadataForColumn(td->tableId, cm.first[2]);
+    if (cm.second->chunkStats.max.tinyintval != 1) {
+      continue;
+    }
+    if (minDeletedFraction > 0) {
       const auto chunk = Chunk_NS::Chunk::getChunk(cd,
                                                    &getDataMgr(),
                                                    cm.first,
-                                                   updel_roll.memoryLevel,
+                                                   Data_Namespace::CPU_LEVEL,
                                                    0,
                                                    cm.second->numBytes,
                                                    cm.second->numElements);
-      td->fragmenter->compactRows(this,
-                                  td,
-                                  cm.first[3],
-                                  td->fragmenter->getVacuumOffsets(chunk),
-                                  updel_roll.memoryLevel,
-                                  updel_roll);
+      const auto num_deleted = td->fragmenter->getVacuumOffsets(chunk).size();
+      if (num_deleted < minDeletedFraction * cm.second->numElements) {
+        continue;
+      }
+    }
+    fragment_ids.push_back(cm.first[3]);
+  }
+  return fragment_ids;
+}
+
+bool Catalog::vacuumFragment(const TableDescriptor* td, const int fragmentId) const {
+  const ColumnDescriptor* cd = getDeletedColumn(td);
+  if (nullptr == cd) {
+    return false;
+  }
+  // the fragment may have been vacuumed or dropped since it was picked
+  ChunkKey chunkKey = {currentDB_.dbId, td->tableId, cd->columnId, fragmentId};
+  ChunkMetadataVector chunkMetadataVec;
+  dataMgr_->getChunkMetadataVecForKeyPrefix(chunkMetadataVec, chunkKey);
+  if (chunkMetadataVec.empty() ||
+      chunkMetadataVec.front().second->chunkStats.max.tinyintval != 1) {
+    return false;
+  }
+  const auto& chunkMetadata = chunkMetadataVec.front().second;
+  UpdelRoll updel_roll;
+  updel_roll.catalog = this;
+  updel_roll.logicalTableId = getLogicalTableId(td->tableId);
+  updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
+  const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                               &getDataMgr(),
+                                               chunkKey,
+                                               updel_roll.memoryLevel,
+                                               0,
+                                               chunkMetadata->numBytes,
+                                               chunkMetadata->numElements);
+  td->fragmenter->compactRows(this,
+                              td,
+                              fragmentId,
+                              td->fragmenter->getVacuumOffsets(chunk),
+                              updel_roll.memoryLevel,
+                              updel_roll);
+  updel_roll.commitUpdate();
+  return true;
+}
+
+size_t Catalog::mergeSmallFragments(const int logicalTableId) const {
+  const auto td = getMetadataForTable(logicalTableId);
+  const auto shards = getPhysicalTablesDescriptors(td);
+  size_t num_fragments_dropped{0};
+  for (const auto shard : shards) {
+    num_fragments_dropped += mergeSmallFragments(shard);
+  }
+  return num_fragments_dropped;
+}
+
+size_t Catalog::mergeSmallFragments(const TableDescriptor* td) const {
+  // the moved rows of a partitioned table only fill fragments of their own partition
+  if (td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL ||
+      !getDeletedColumn(td) || table_is_partitioned(td)) {
+    return 0;
+  }
+  const auto fragments = td->fragmenter->getFragmentsForQuery().fragments;
+  const double max_num_tuples = g_fragment_merge_max_fill_fraction * td->maxFragRows;
+  std::vector<int> fragment_ids;
+  // the last fragment takes the inserts, and the merged rows
+  for (size_t i = 0; i + 1 < fragments.size(); ++i) {
+    if (fragments[i].getPhysicalNumTuples() < max_num_tuples) {
+      fragment_ids.push_back(fragments[i].fragmentId);
+    }
+  }
+  if (fragment_ids.size() < 2) {
+    return 0;
+  }
+  // the moved rows are deleted where they were until the emptied fragments are dropped,
+  // so that a crash in between neither loses nor duplicates them
+  UpdelRoll updel_roll;
+  updel_roll.catalog = this;
+  updel_roll.logicalTableId = getLogicalTableId(td->tableId);
+  updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
+  size_t num_rows_moved{0};
+  try {
+    for (const auto fragment_id : fragment_ids) {
+      num_rows_moved += td->fragmenter->moveFragmentRows(
+          this, td, fragment_id, updel_roll.memoryLevel, updel_roll);
+    }
+  } catch (...) {
+    updel_roll.cancelUpdate();
+    throw;
+  }
+  updel_roll.commitUpdate();
+  const auto num_fragments_dropped = td->fragmenter->dropFragments(fragment_ids);
+  checkpoint(updel_roll.logicalTableId);
+  VLOG(1) << "Merged " << num_fragments_dropped << " fragments of table "
+          << td->tableName << ", moving " << num_rows_moved << " rows";
+  return num_fragments_dropped;
+}
+
+bool Catalog::sortFragmentRows(const int logicalTableId) const {
+  const auto td = getMetadataForTable(logicalTableId);
+  const auto shards = getPhysicalTablesDescriptors(td);
+  bool sorted_rows{false};
+  for (const auto shard : shards) {
+    sorted_rows = sortFragmentRows(shard) || sorted_rows;
+  }
+  return sorted_rows;
+}
+
+bool Catalog::sortFragmentRows(const TableDescriptor* td) const {
+  if (td->sortedColumnId <= 0) {
+    return false;
+  }
+  const auto sort_cd = getMetadataForColumn(td->tableId, td->sortedColumnId);
+  if (!sort_cd || !(sort_cd->columnType.is_integer() || sort_cd->columnType.is_time())) {
+    return false;
+  }
+  std::vector<int> fragment_ids;
+  for (const auto& fragment : td->fragmenter->getFragmentsForQuery().fragments) {
+    fragment_ids.push_back(fragment.fragmentId);
+  }
+  bool sorted_rows{false};
+  for (const auto fragment_id : fragment_ids) {
+    UpdelRoll updel_roll;
+    updel_roll.catalog = this;
+    updel_roll.logicalTableId = getLogicalTableId(td->tableId);
+    updel_roll.memoryLevel = Data_Namespace::MemoryLevel::CPU_LEVEL;
+    if (td->fragmenter->sortRows(
+            this, td, fragment_id, sort_cd, updel_roll.memoryLevel, updel_roll)) {
       updel_roll.commitUpdate();
+      sorted_rows = true;
+    }
+  }
+  return sorted_rows;
+}
+
+void Catalog::setResidentColumns(const TableDescriptor* td,
+                                 const std::vector<int>& columnIds,
+                                 const Data_Namespace::MemoryLevel memoryLevel) const {
+  std::set<int> resident_column_ids;
+  for (const auto column_id : columnIds) {
+    const auto cd = getMetadataForColumn(td->tableId, column_id);
+    if (!cd) {
+      continue;  // dropped since it was pinned
+    }
+    resident_column_ids.insert(column_id);
+    // the chunks of a geo column are those of its physical columns
+    for (int i = 1; i <= cd->columnType.get_physical_cols(); ++i) {
+      resident_column_ids.insert(column_id + i);
+    }
+  }
+  std::vector<int> physical_table_ids;
+  size_t num_bytes{0};
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    physical_table_ids.push_back(physical_td->tableId);
+    if (resident_column_ids.empty()) {
+      continue;
+    }
+    const auto fragmenter = getMetadataForTable(physical_td->tableId)->fragmenter;
+    CHECK(fragmenter);
+    for (const auto& fragment : fragmenter->getFragmentsForQuery().fragments) {
+      for (const auto& [column_id, chunk_metadata] :
+           fragment.getChunkMetadataMapPhysical()) {
+        if (resident_column_ids.count(column_id)) {
+          num_bytes += chunk_metadata->numBytes;
+        }
+      }
+    }
+  }
+  dataMgr_->setResidentColumns(
+      currentDB_.dbId, physical_table_ids, resident_column_ids, memoryLevel, num_bytes);
+}
+
+void Catalog::setPinnedColumns(const TableDescriptor* td,
+                               const std::vector<int>& cpuColumnIds,
+                               const std::vector<int>& gpuColumnIds) {
+  setResidentColumns(td, cpuColumnIds, Data_Namespace::MemoryLevel::CPU_LEVEL);
+  try {
+    setResidentColumns(td, gpuColumnIds, Data_Namespace::MemoryLevel::GPU_LEVEL);
+  } catch (...) {
+    setResidentColumns(
+        td, td->pinnedCpuColumnIds, Data_Namespace::MemoryLevel::CPU_LEVEL);
+    throw;
+  }
+
+  cat_write_lock write_lock(this);
+  cat_sqlite_lock sqlite_lock(this);
+  sqliteConnector_.query("BEGIN TRANSACTION");
+  try {
+    sqliteConnector_.query_with_text_params(
+        "UPDATE mapd_tables SET pinned_cpu_columns = ?, pinned_gpu_columns = ? WHERE "
+        "tableid = ?",
+        std::vector<std::string>{join(cpuColumnIds, ","),
+                                 join(gpuColumnIds, ","),
+                                 std::to_string(td->tableId)});
+  } catch (std::exception& e) {
+    sqliteConnector_.query("ROLLBACK TRANSACTION");
+    throw;
+  }
+  sqliteConnector_.query("END TRANSACTION");
+  const auto tableDescIt = tableDescriptorMapById_.find(td->tableId);
+  CHECK(tableDescIt != tableDescriptorMapById_.end());
+  tableDescIt->second->pinnedCpuColumnIds = cpuColumnIds;
+  tableDescIt->second->pinnedGpuColumnIds = gpuColumnIds;
+}
+
+size_t Catalog::prewarmTable(const TableDescriptor* td,
+                             const std::vector<int>& columnIds,
+                             const Data_Namespace::MemoryLevel memoryLevel) const {
+  CHECK(memoryLevel == Data_Namespace::MemoryLevel::CPU_LEVEL ||
+        memoryLevel == Data_Namespace::MemoryLevel::GPU_LEVEL);
+  if (static_cast<size_t>(memoryLevel) >= dataMgr_->levelSizes_.size()) {
+    throw std::runtime_error("Unable to prewarm GPU memory: No GPUs detected");
+  }
+  std::vector<const ColumnDescriptor*> cds;
+  for (const auto column_id : columnIds) {
+    const auto cd = getMetadataForColumn(td->tableId, column_id);
+    if (!cd) {
+      continue;
+    }
+    if (cd->columnType.get_physical_cols() == 0) {
+      cds.push_back(cd);
+    }
+    for (int i = 1; i <= cd->columnType.get_physical_cols(); ++i) {
+      cds.push_back(getMetadataForColumn(td->tableId, column_id + i));
+      CHECK(cds.back());
     }
   }
+
+  struct ChunkToLoad {
+    const ColumnDescriptor* cd;
+    ChunkKey chunk_key;
+    size_t num_bytes;
+    size_t num_elements;
+  };
+  // by device for the GPUs, the kernels read the chunks of a fragment on its device
+  const bool is_gpu = memoryLevel == Data_Namespace::MemoryLevel::GPU_LEVEL;
+  const size_t worker_count = is_gpu ? dataMgr_->levelSizes_[memoryLevel] : cpu_threads();
+  std::vector<std::vector<ChunkToLoad>> chunks_by_worker(worker_count);
+  size_t fragment_count{0};
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    const auto fragmenter = getMetadataForTable(physical_td->tableId)->fragmenter;
+    CHECK(fragmenter);
+    for (const auto& fragment : fragmenter->getFragmentsForQuery().fragments) {
+      const size_t worker_idx =
+          is_gpu ? fragment.deviceIds[static_cast<int>(memoryLevel)]
+                 : fragment_count % worker_count;
+      CHECK_LT(worker_idx, worker_count);
+      ++fragment_count;
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+      for (const auto cd : cds) {
+        const auto chunk_metadata_it = chunk_metadata_map.find(cd->columnId);
+        if (chunk_metadata_it == chunk_metadata_map.end()) {
+          continue;
+        }
+        chunks_by_worker[worker_idx].push_back(
+            {cd,
+             {currentDB_.dbId, physical_td->tableId, cd->columnId, fragment.fragmentId},
+             chunk_metadata_it->second->numBytes,
+             chunk_metadata_it->second->numElements});
+      }
+    }
+  }
+
+  const auto load_chunks = [this, memoryLevel](const std::vector<ChunkToLoad>& chunks,
+                                               const int device_id) {
+    for (const auto& chunk : chunks) {
+      // unpinned right away, the chunk stays in the pool until evicted
+      Chunk_NS::Chunk::getChunk(chunk.cd,
+                                dataMgr_.get(),
+                                chunk.chunk_key,
+                                memoryLevel,
+                                device_id,
+                                chunk.num_bytes,
+                                chunk.num_elements);
+    }
+    return chunks.size();
+  };
+  std::vector<std::future<size_t>> loads;
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+    if (!chunks_by_worker[worker_idx].empty()) {
+      loads.push_back(std::async(std::launch::async,
+                                 load_chunks,
+                                 std::cref(chunks_by_worker[worker_idx]),
+                                 is_gpu ? static_cast<int>(worker_idx) : 0));
+    }
+  }
+  size_t chunk_count{0};
+  for (auto& load : loads) {
+    chunk_count += load.get();
+  }
+  return chunk_count;
 }
 
 void Catalog::buildForeignServerMap() {
@@ -3892,6 +4997,36 @@ std::vector<std::string> Catalog::getTableDictDirectories(
 // returns table schema in a string
 // NOTE(sy): Might be able to replace dumpSchema() later with
 //           dumpCreateTable() after a deeper review of the TableArchiver code.
+std::string Catalog::dumpBloomFilterOption(const TableDescriptor* td) const {
+  std::vector<std::string> column_names;
+  for (const auto column_id : td->bloomFilterColumnIds) {
+    // dropped columns are not removed from the option
+    const auto cd = getMetadataForColumn(td->tableId, column_id);
+    if (cd) {
+      column_names.push_back(cd->columnName);
+    }
+  }
+  return column_names.empty() ? ""
+                              : "BLOOM_FILTER='" + join(column_names, ",") + "'";
+}
+
+void Catalog::dumpPartitionOptions(const TableDescriptor* td,
+                                   std::vector<std::string>& with_options) const {
+  if (!table_is_partitioned(td)) {
+    return;
+  }
+  const auto partition_cd = getMetadataForColumn(td->tableId, td->partitionColumnId);
+  CHECK(partition_cd);
+  with_options.push_back("PARTITION_COLUMN='" + partition_cd->columnName + "'");
+  with_options.push_back(
+      "PARTITION_INTERVAL='" +
+      Fragmenter_Namespace::get_partition_interval_name(td->partitionInterval) + "'");
+  if (td->partitionRetention > 0) {
+    with_options.push_back("PARTITION_RETENTION=" +
+                           std::to_string(td->partitionRetention));
+  }
+}
+
 std::string Catalog::dumpSchema(const TableDescriptor* td) const {
   cat_read_lock read_lock(this);
 
@@ -3964,6 +5099,17 @@ std::string Catalog::dumpSchema(const TableDescriptor* td) const {
   with_options.push_back("FRAGMENT_SIZE=" + std::to_string(td->maxFragRows));
   with_options.push_back("MAX_CHUNK_SIZE=" + std::to_string(td->maxChunkSize));
   with_options.push_back("PAGE_SIZE=" + std::to_string(td->fragPageSize));
+  if (td->extentSize > 0) {
+    with_options.push_back("EXTENT_SIZE=" + std::to_string(td->extentSize));
+  }
+  if (!td->chunkCompression.empty()) {
+    with_options.push_back("COMPRESSION='" + td->chunkCompression + "'");
+  }
+  const auto bloom_filter_option = dumpBloomFilterOption(td);
+  if (!bloom_filter_option.empty()) {
+    with_options.push_back(bloom_filter_option);
+  }
+  dumpPartitionOptions(td, with_options);
   with_options.push_back("MAX_ROWS=" + std::to_string(td->maxRows));
   with_options.emplace_back(td->hasDeletedCol ? "VACUUM='DELAYED'"
                                               : "VACUUM='IMMEDIATE'");
@@ -4146,6 +5292,17 @@ std::string Catalog::dumpCreateTable(const TableDescriptor* td,
   if (dump_defaults || td->fragPageSize != DEFAULT_PAGE_SIZE) {
     with_options.push_back("PAGE_SIZE=" + std::to_string(td->fragPageSize));
   }
+  if (td->extentSize > 0) {
+    with_options.push_back("EXTENT_SIZE=" + std::to_string(td->extentSize));
+  }
+  if (!td->chunkCompression.empty()) {
+    with_options.push_back("COMPRESSION='" + td->chunkCompression + "'");
+  }
+  const auto bloom_filter_option = dumpBloomFilterOption(td);
+  if (!bloom_filter_option.empty()) {
+    with_options.push_back(bloom_filter_option);
+  }
+  dumpPartitionOptions(td, with_options);
   if (dump_defaults || td->maxRows != DEFAULT_MAX_ROWS) {
     with_options.push_back("MAX_ROWS=" + std::to_string(td->maxRows));
   }
@@ -31,10 +31,15 @@
 #include <atomic>
 #include <cstdint>
 #include <ctime>
+#include <functional>
+#include <future>
 #include <limits>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -68,6 +73,10 @@ class SharedDictionaryDef;
 
 class TableArchiver;
 
+namespace Fragmenter_Namespace {
+class InsertWal;
+}  // namespace Fragmenter_Namespace
+
 // SPI means Sequential Positional Index which is equivalent to the input index in a
 // RexInput node
 #define SPIMAP_MAGIC1 (std::numeric_limits<unsigned>::max() / 4)
@@ -77,6 +86,26 @@ class TableArchiver;
 
 namespace Catalog_Namespace {
 
+/// A stream ingested into a table by the server, see import_export::StreamIngestor
+struct TableStream {
+  int tableId;
+  std::string source;   // kafka://brokers/topics
+  std::string options;  // the copy params of the stream, as JSON
+};
+
+/// By topic and partition, the offset of the next message a stream consumes
+using TableStreamOffsets = std::map<std::pair<std::string, int32_t>, int64_t>;
+
+/// The statistics ANALYZE TABLE collects for a column, whose values are in the units of
+/// the chunk stats (the dictionary ids for strings)
+struct ColumnStatistics {
+  int64_t rowCount{0};  // of the table when it was analyzed, nulls included
+  int64_t nullCount{0};
+  int64_t ndv{0};  // of the non null values, estimated unless the table was small
+  std::vector<int64_t> histogramBounds;  // equi-depth, from the min to the max value
+  std::vector<std::pair<int64_t, int64_t>> mostCommonValues;  // with their row counts
+};
+
 /**
  * @type Catalog
  * @brief class for a per-database catalog.  also includes metadata for the
@@ -124,6 +153,21 @@ class Catalog final {
   void dropTable(const TableDescriptor* td);
   void truncateTable(const TableDescriptor* td);
   void renameTable(const TableDescriptor* td, const std::string& newTableName);
+  /**
+   * Changes integer column cd of table td to the narrower fixed encoding newType and
+   * rewrites the column's chunks in it. All values of the column fit newType.
+   */
+  void reencodeColumn(const TableDescriptor* td,
+                      const ColumnDescriptor* cd,
+                      const SQLTypeInfo& newType);
+  /**
+   * Rebuilds dictionary dictId with only the strings the chunks of table td still
+   * reference, in the order of their ids, and remaps the ids of the chunks of its
+   * columns, which are the only ones using the dictionary. The dictionary is left as
+   * is unless at least g_dictionary_compaction_min_dead_fraction of its strings are
+   * unreferenced. Returns the number of strings removed.
+   */
+  size_t compactDictionary(const TableDescriptor* td, const int dictId);
   void renameColumn(const TableDescriptor* td,
                     const ColumnDescriptor* cd,
                     const std::string& newColumnName);
@@ -221,7 +265,36 @@ class Catalog final {
 
   int32_t getTableEpoch(const int32_t db_id, const int32_t table_id) const;
   void setTableEpoch(const int db_id, const int table_id, const int new_epoch);
+  /// Log that makes inserts durable without a checkpoint each, nullptr if disabled
+  Fragmenter_Namespace::InsertWal* getInsertWal() const { return insertWal_.get(); }
+  /// Current epoch of a physical table, or -1 if it was dropped, as InsertWal expects
+  std::function<int(const int)> getInsertWalTableEpochs() const;
   int getDatabaseId() const { return currentDB_.dbId; }
+
+  /// Persists the stream of a table, replacing the previous one, so it resumes on startup
+  void addTableStream(const TableStream& stream);
+  void removeTableStream(const int tableId);
+  std::vector<TableStream> getTableStreams();
+  /**
+   * Records the offsets the stream into logical table tableId consumed up to, together
+   * with the rows it loaded at epoch, the current epoch of the table. They become the
+   * offsets getTableStreamOffsets() returns once the table is checkpointed at epoch.
+   */
+  void recordTableStreamOffsets(const int tableId,
+                                const int epoch,
+                                const TableStreamOffsets& offsets);
+  /// The offsets recorded at the newest checkpointed epoch of tableId, empty if none
+  TableStreamOffsets getTableStreamOffsets(const int tableId);
+  static const std::string getTableStreamSchema(bool if_not_exists = false);
+  /// Replaces the statistics of the columns of logical table td found in statistics
+  void setColumnStatistics(const TableDescriptor* td,
+                           const std::map<int, ColumnStatistics>& statistics);
+  /// The statistics last collected for a column by ANALYZE TABLE, if any
+  std::optional<ColumnStatistics> getColumnStatistics(const int tableId,
+                                                      const int columnId) const;
+  static const std::string getColumnStatisticsSchema(bool if_not_exists = false);
+  static const std::string getTableStreamOffsetSchema(bool if_not_exists = false);
+
   SqliteConnector& getSqliteConnector() { return sqliteConnector_; }
   void roll(const bool forward);
   DictRef addDictionary(ColumnDescriptor& cd);
@@ -253,12 +326,61 @@ class Catalog final {
   void eraseTablePhysicalData(const TableDescriptor* td);
   void vacuumDeletedRows(const TableDescriptor* td) const;
   void vacuumDeletedRows(const int logicalTableId) const;
+  /**
+   * The fragments of physical table td with deleted rows, at least minDeletedFraction
+   * of their rows. The caller holds the table's data read lock.
+   */
+  std::vector<int> getFragmentsToVacuum(const TableDescriptor* td,
+                                        const double minDeletedFraction) const;
+  /**
+   * Removes the deleted rows of a fragment of physical table td and checkpoints the
+   * table, so that the compacted fragment replaces the old one at the next epoch.
+   * Returns false if the fragment has no deleted rows (any more). The caller holds the
+   * table's data write lock.
+   */
+  bool vacuumFragment(const TableDescriptor* td, const int fragmentId) const;
+  /**
+   * Merges the fragments of physical table td, but the last one, holding fewer rows
+   * than g_fragment_merge_max_fill_fraction of its fragment size: their rows are
+   * appended to the end of the table and the emptied fragments are dropped. Returns
+   * the number of fragments dropped. Tables with a PARTITION_COLUMN are left alone.
+   * The caller holds the table's data write lock.
+   */
+  size_t mergeSmallFragments(const TableDescriptor* td) const;
+  size_t mergeSmallFragments(const int logicalTableId) const;
+  /**
+   * Reorders the rows of each fragment of a table with an integer or time SORT_COLUMN
+   * by its values. Returns whether any fragment had to be reordered.
+   */
+  bool sortFragmentRows(const TableDescriptor* td) const;
+  bool sortFragmentRows(const int logicalTableId) const;
+  /**
+   * Persists the columns of the table pinned in the CPU and in the GPU memory, empty for
+   * none, and exempts their chunks from the eviction of the buffer pools. Throws if the
+   * pinned columns would take more than the max-resident-buffer-pool-fraction of a pool.
+   */
+  void setPinnedColumns(const TableDescriptor* td,
+                        const std::vector<int>& cpuColumnIds,
+                        const std::vector<int>& gpuColumnIds);
+  /**
+   * Loads the chunks of columnIds of the table into the memoryLevel buffer pools, those
+   * of the GPUs, or of groups of fragments for the CPU, in parallel. Returns the number
+   * of chunks loaded. The caller holds the table's data read lock.
+   */
+  size_t prewarmTable(const TableDescriptor* td,
+                      const std::vector<int>& columnIds,
+                      const Data_Namespace::MemoryLevel memoryLevel) const;
   void setForReload(const int32_t tableId);
 
   std::vector<std::string> getTableDataDirectories(const TableDescriptor* td) const;
   std::vector<std::string> getTableDictDirectories(const TableDescriptor* td) const;
   std::string getColumnDictDirectory(const ColumnDescriptor* cd) const;
   std::string dumpSchema(const TableDescriptor* td) const;
+  /// The BLOOM_FILTER option of the table, empty if there is none
+  std::string dumpBloomFilterOption(const TableDescriptor* td) const;
+  /// Appends the PARTITION_ options of the table to with_options
+  void dumpPartitionOptions(const TableDescriptor* td,
+                            std::vector<std::string>& with_options) const;
   std::string dumpCreateTable(const TableDescriptor* td,
                               bool multiline_formatting = true,
                               bool dump_defaults = false) const;
@@ -406,10 +528,16 @@ class Catalog final {
   void updateFrontendViewsToDashboards();
   void createFsiSchemasAndDefaultServers();
   void dropFsiSchemasAndTables();
+  void updateTableStreamSchema();
+  void updateColumnStatisticsSchema();
+  void loadColumnStatistics();
   void recordOwnershipOfObjectsInObjectPermissions();
   void checkDateInDaysColumnMigration();
   void createDashboardSystemRoles();
   void buildMaps();
+  void recoverDictionaryCompactions();
+  /// Applies the logged inserts into tableIds, all tables if empty, and checkpoints them
+  void replayInsertWal(const std::set<int>& tableIds);
   void addTableToMap(const TableDescriptor* td,
                      const std::list<ColumnDescriptor>& columns,
                      const std::list<DictDescriptor>& dicts);
@@ -437,6 +565,10 @@ class Catalog final {
   void doTruncateTable(const TableDescriptor* td);
   void renamePhysicalTable(const TableDescriptor* td, const std::string& newTableName);
   void instantiateFragmenter(TableDescriptor* td) const;
+  /// Exempts the chunks of columnIds of the table from the eviction at memoryLevel
+  void setResidentColumns(const TableDescriptor* td,
+                          const std::vector<int>& columnIds,
+                          const Data_Namespace::MemoryLevel memoryLevel) const;
   void getAllColumnMetadataForTableImpl(const TableDescriptor* td,
                                         std::list<const ColumnDescriptor*>& colDescs,
                                         const bool fetchSystemColumns,
@@ -472,6 +604,7 @@ class Catalog final {
   SqliteConnector sqliteConnector_;
   DBMetadata currentDB_;
   std::shared_ptr<Data_Namespace::DataMgr> dataMgr_;
+  std::unique_ptr<Fragmenter_Namespace::InsertWal> insertWal_;
 
   const std::vector<LeafHostInfo> string_dict_hosts_;
   std::shared_ptr<Calcite> calciteMgr_;
@@ -491,7 +624,35 @@ class Catalog final {
   ColumnDescriptorsForRoll columnDescriptorsForRoll;
 
  private:
+  // An immutable copy of the maps of the tables and the columns, which the
+  // getMetadataForTable() and getMetadataForColumn() lookups read without the catalog
+  // lock
+  struct MetadataSnapshot {
+    TableDescriptorMap tables_by_name;
+    TableDescriptorMapById tables_by_id;
+    ColumnDescriptorMap columns_by_name;
+    ColumnDescriptorMapById columns_by_id;
+  };
+  // The snapshot of the current version of the maps, nullptr if the lookup has to take
+  // the catalog lock instead, i.e. during the construction of the catalog or while the
+  // calling thread holds the write lock. Valid until the next call of the thread.
+  const MetadataSnapshot* getMetadataSnapshot() const;
+
+  // 0 until the maps are built, then unique over all the catalogs and their versions
+  mutable std::atomic<uint64_t> metadata_version_{0};
+  mutable std::mutex metadata_snapshot_mutex_;
+  mutable std::shared_ptr<const MetadataSnapshot> metadata_snapshot_;
+  mutable uint64_t metadata_snapshot_version_{0};
+
+  static std::mutex mapd_cat_map_mutex_;
   static std::map<std::string, std::shared_ptr<Catalog>> mapd_cat_map_;
+  // the catalogs under construction, the other threads getting one wait for it, e.g.
+  // the sessions logging in while --preload-catalogs loads the catalogs in parallel
+  static std::map<std::string, std::shared_future<std::shared_ptr<Catalog>>>
+      loading_cat_map_;
+  // by table and column id, also those of the temporary tables which aren't persisted
+  mutable std::mutex column_statistics_mutex_;
+  std::map<std::pair<int, int>, ColumnStatistics> columnStatistics_;
   DeletedColumnPerTableMap deletedColumnPerTable_;
   void adjustAlteredTableFiles(
       const std::string& temp_data_dir,
@@ -515,6 +676,10 @@ class Catalog final {
       bool if_not_exists);
 
  public:
+  // Makes the metadata lookups rebuild their snapshot, the write lock calls it before
+  // any change of the maps
+  void invalidateMetadataSnapshot() const;
+
   mutable std::mutex sqliteMutex_;
   mutable mapd_shared_mutex sharedMutex_;
   mutable std::atomic<std::thread::id> thread_holding_sqlite_lock;
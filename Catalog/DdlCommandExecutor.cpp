@@ -583,6 +583,11 @@ void CreateForeignTableCommand::setColumnDetails(std::list<ColumnDescriptor>& co
     ddl_utils::validate_non_reserved_keyword(column_name);
     ddl_utils::set_column_descriptor(
         column_name, cd, &sql_type, data_type["notNull"].GetBool(), encoding.get());
+    if (cd.columnType.get_compression() == kENCODING_DIFF) {
+      // the wrappers load chunks in batches that need not share a reference value
+      throw std::runtime_error(column_name +
+                               ": Diff encoding is not supported for foreign tables.");
+    }
     columns.emplace_back(cd);
   }
 }
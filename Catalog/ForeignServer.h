@@ -42,11 +42,14 @@ struct DataWrapperType {
 struct ForeignServer : public OptionsContainer {
   static constexpr std::string_view STORAGE_TYPE_KEY = "STORAGE_TYPE";
   static constexpr std::string_view BASE_PATH_KEY = "BASE_PATH";
+  static constexpr std::string_view CACHE_WARM_UP_KEY = "CACHE_WARM_UP";
   static constexpr std::string_view LOCAL_FILE_STORAGE_TYPE = "LOCAL_FILE";
   static constexpr std::array<std::string_view, 1> supported_storage_types{
       LOCAL_FILE_STORAGE_TYPE};
-  static constexpr std::array<std::string_view, 2> all_option_keys{STORAGE_TYPE_KEY,
-                                                                   BASE_PATH_KEY};
+  static constexpr std::array<std::string_view, 3> all_option_keys{
+      STORAGE_TYPE_KEY,
+      BASE_PATH_KEY,
+      CACHE_WARM_UP_KEY};
 
   int32_t id;
   std::string name;
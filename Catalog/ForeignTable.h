@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include "ForeignServer.h"
 
 #include "OptionsContainer.h"
@@ -24,6 +26,33 @@
 namespace foreign_storage {
 struct ForeignTable : public TableDescriptor, public OptionsContainer {
   const ForeignServer* foreign_server;
-  static constexpr std::array<char const*, 1> supported_options{"FRAGMENT_SIZE"};
+  static constexpr std::array<char const*, 2> supported_options{"FRAGMENT_SIZE",
+                                                                "CACHE_WARM_UP"};
+  static constexpr char const* UPDATE_MODE_KEY = "UPDATE_MODE";
+  static constexpr char const* APPEND_UPDATE_MODE = "APPEND";
+  static constexpr char const* CACHE_WARM_UP_KEY = "CACHE_WARM_UP";
+
+  // Whether refreshes only add the data appended to the source since the last refresh
+  bool isAppendMode() const {
+    auto update_mode_it = options.find(UPDATE_MODE_KEY);
+    return update_mode_it != options.end() &&
+           boost::iequals(update_mode_it->second, APPEND_UPDATE_MODE);
+  }
+
+  // Whether the disk cache is warmed up with the most used chunks of the table after a
+  // restart or a refresh. Tables which do not set the option take it from their server.
+  bool isCacheWarmUpEnabled() const {
+    auto warm_up_it = options.find(CACHE_WARM_UP_KEY);
+    if (warm_up_it != options.end()) {
+      return boost::iequals(warm_up_it->second, "TRUE");
+    }
+    if (foreign_server) {
+      auto server_warm_up_it =
+          foreign_server->options.find(ForeignServer::CACHE_WARM_UP_KEY);
+      return server_warm_up_it != foreign_server->options.end() &&
+             boost::iequals(server_warm_up_it->second, "TRUE");
+    }
+    return false;
+  }
 };
 }  // namespace foreign_storage
@@ -17,10 +17,14 @@
 #ifndef RW_LOCKS_H
 #define RW_LOCKS_H
 
+#include <type_traits>
+
 #include "../Shared/mapd_shared_mutex.h"
 
 namespace Catalog_Namespace {
 
+class Catalog;
+
 /*
  *  The locking sequence for the locks below is as follows:
  *
@@ -116,6 +120,9 @@ class write_lock {
       lock = mapd_unique_lock<mapd_shared_mutex>(cat->sharedMutex_);
       cat->thread_holding_write_lock = tid;
       holds_lock = true;
+      if constexpr (std::is_same_v<inner_type, Catalog>) {
+        cat->invalidateMetadataSnapshot();
+      }
     }
   }
 
@@ -204,3 +204,22 @@ void validate_shared_dictionary(
                              *table_name + "." + shared_dict_def->get_column());
   }
 }
+
+std::vector<const ColumnDescriptor*> get_dictionary_columns(
+    const int dict_id,
+    const Catalog_Namespace::Catalog& catalog) {
+  std::vector<const ColumnDescriptor*> dict_columns;
+  for (const auto td : catalog.getAllTableMetadata()) {
+    if (td->isView) {
+      continue;
+    }
+    for (const auto cd :
+         catalog.getAllColumnMetadataForTable(td->tableId, false, false, false)) {
+      const auto& ti = cd->columnType;
+      if (ti.get_compression() == kENCODING_DICT && ti.get_comp_param() == dict_id) {
+        dict_columns.push_back(cd);
+      }
+    }
+  }
+  return dict_columns;
+}
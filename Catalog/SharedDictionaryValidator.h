@@ -38,4 +38,10 @@ void validate_shared_dictionary_order(
     const Parser::SharedDictionaryDef* shared_dict_def,
     const std::vector<Parser::SharedDictionaryDef>& shared_dict_defs,
     const std::list<ColumnDescriptor>& columns);
+
+// The columns, of any table, whose strings or string arrays are encoded by dictionary
+// dict_id, which is more than one column if the dictionary is shared.
+std::vector<const ColumnDescriptor*> get_dictionary_columns(
+    const int dict_id,
+    const Catalog_Namespace::Catalog& catalog);
 #endif  // SHARED_DICTIONARY_VALIDATOR_H
@@ -751,6 +751,9 @@ std::shared_ptr<Catalog> SysCatalog::login(std::string& dbname,
   }
   Catalog_Namespace::DBMetadata db_meta;
   getMetadataWithDefaultDB(dbname, username, db_meta, user_meta);
+  // as in switchDatabase(), the catalog may be under construction by another thread,
+  // whose migrations of the database take the system catalog locks
+  write_lock.unlock();
   return Catalog::get(
       basePath_, db_meta, dataMgr_, string_dict_hosts_, calciteMgr_, false);
 }
@@ -1071,6 +1074,10 @@ void SysCatalog::createDatabase(const string& name, int owner) {
         "frag_page_size integer, "
         "max_rows bigint, partitions text, shard_column_id integer, shard integer, "
         "sort_column_id integer default 0, storage_type text default '',"
+        "extent_size bigint default 0, chunk_compression text default '', "
+        "bloom_filter_columns text default '', "
+        "partition_column_id integer default 0, partition_interval bigint default 0, "
+        "partition_retention integer default 0, "
         "num_shards integer, key_metainfo TEXT, version_num "
         "BIGINT DEFAULT 1) ");
     dbConn->query(
@@ -1105,6 +1112,9 @@ void SysCatalog::createDatabase(const string& name, int owner) {
     dbConn->query_with_text_params(
         "INSERT INTO mapd_record_ownership_marker (dummy) VALUES (?1)",
         std::vector<std::string>{std::to_string(owner)});
+    dbConn->query(Catalog::getTableStreamSchema());
+    dbConn->query(Catalog::getTableStreamOffsetSchema());
+    dbConn->query(Catalog::getColumnStatisticsSchema());
 
     if (g_enable_fsi) {
       dbConn->query(Catalog::getForeignServerSchema());
@@ -1152,10 +1162,11 @@ void SysCatalog::createDatabase(const string& name, int owner) {
 }
 
 void SysCatalog::dropDatabase(const DBMetadata& db) {
-  sys_write_lock write_lock(this);
-  sys_sqlite_lock sqlite_lock(this);
+  // before the locks, see login()
   auto cat =
       Catalog::get(basePath_, db, dataMgr_, string_dict_hosts_, calciteMgr_, false);
+  sys_write_lock write_lock(this);
+  sys_sqlite_lock sqlite_lock(this);
   sqliteConnector_->query("BEGIN TRANSACTION");
   try {
     // remove this database ID from any users that have it set as their default database
@@ -53,6 +53,7 @@ struct TableDescriptor {
   int32_t maxFragRows;     // max number of rows per fragment
   int64_t maxChunkSize;    // max number of rows per fragment
   int32_t fragPageSize;    // page size
+  int64_t extentSize;      // bytes of pages a chunk reserves contiguously, 0 for one page
   int64_t maxRows;         // max number of rows in the table
   std::string partitions;  // distributed partition scheme
   std::string
@@ -72,6 +73,13 @@ struct TableDescriptor {
   // RexInput node
   std::vector<int> columnIdBySpi_;  // spi = 1,2,3,...
   std::string storageType;          // foreign/local storage
+  std::string chunkCompression;     // codec of the chunk pages on disk, empty for none
+  std::vector<int> bloomFilterColumnIds;  // columns whose chunks get a Bloom filter
+  int partitionColumnId;       // TIMESTAMP or DATE column partitioning the fragments
+  int64_t partitionInterval;   // seconds per partition
+  int32_t partitionRetention;  // number of newest partitions kept, 0 for all
+  std::vector<int> pinnedCpuColumnIds;  // columns kept resident in the CPU buffer pool
+  std::vector<int> pinnedGpuColumnIds;  // columns kept resident in the GPU buffer pools
 
   // write mutex, only to be used inside catalog package
   std::shared_ptr<std::mutex> mutex_;
@@ -79,16 +87,24 @@ struct TableDescriptor {
   TableDescriptor()
       : tableId(-1)
       , shard(-1)
+      , extentSize(0)
       , nShards(0)
       , shardedColumnId(0)
       , sortedColumnId(0)
       , persistenceLevel(Data_Namespace::MemoryLevel::DISK_LEVEL)
       , hasDeletedCol(true)
+      , partitionColumnId(0)
+      , partitionInterval(0)
+      , partitionRetention(0)
       , mutex_(std::make_shared<std::mutex>()) {}
 
   virtual ~TableDescriptor() = default;
 };
 
+inline bool table_is_partitioned(const TableDescriptor* td) {
+  return td->partitionColumnId > 0;
+}
+
 inline bool table_is_replicated(const TableDescriptor* td) {
   return td->partitions == "REPLICATED";
 }
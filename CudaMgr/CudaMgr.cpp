@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <boost/stacktrace.hpp>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
 
@@ -60,6 +61,7 @@ CudaMgr::CudaMgr(const int num_gpus, const int start_gpu)
     CHECK_EQ(start_gpu_, 0);
   }
   fillDeviceProperties();
+  transfer_stats_.resize(device_count_);
   initDeviceGroup();
   createDeviceContexts();
   printDeviceProperties();
@@ -85,6 +87,14 @@ CudaMgr::~CudaMgr() {
     std::lock_guard<std::mutex> gpu_lock(device_cleanup_mutex_);
 
     synchronizeDevices();
+    for (size_t d = 0; d < device_streams_.size(); ++d) {
+      setContext(d);
+      for (auto stream : device_streams_[d]) {
+        if (stream) {
+          checkError(cuStreamDestroy(stream));
+        }
+      }
+    }
     for (int d = 0; d < device_count_; ++d) {
       checkError(cuCtxDestroy(device_contexts_[d]));
     }
@@ -111,8 +121,15 @@ void CudaMgr::copyHostToDevice(int8_t* device_ptr,
                                const size_t num_bytes,
                                const int device_num) {
   setContext(device_num);
+  const auto copy_start = std::chrono::steady_clock::now();
   checkError(
       cuMemcpyHtoD(reinterpret_cast<CUdeviceptr>(device_ptr), host_ptr, num_bytes));
+  recordTransfer(device_num,
+                 num_bytes,
+                 std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - copy_start)
+                     .count(),
+                 /*host_to_device=*/true);
 }
 
 void CudaMgr::copyDeviceToHost(int8_t* host_ptr,
@@ -120,8 +137,31 @@ void CudaMgr::copyDeviceToHost(int8_t* host_ptr,
                                const size_t num_bytes,
                                const int device_num) {
   setContext(device_num);
+  const auto copy_start = std::chrono::steady_clock::now();
   checkError(
       cuMemcpyDtoH(host_ptr, reinterpret_cast<const CUdeviceptr>(device_ptr), num_bytes));
+  recordTransfer(device_num,
+                 num_bytes,
+                 std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - copy_start)
+                     .count(),
+                 /*host_to_device=*/false);
+}
+
+void CudaMgr::recordTransfer(const int device_num,
+                             const size_t num_bytes,
+                             const size_t elapsed_micros,
+                             const bool host_to_device) const {
+  std::lock_guard<std::mutex> stats_lock(transfer_stats_mutex_);
+  CHECK_LT(static_cast<size_t>(device_num), transfer_stats_.size());
+  auto& stats = transfer_stats_[device_num];
+  if (host_to_device) {
+    stats.host_to_device_bytes += num_bytes;
+    stats.host_to_device_micros += elapsed_micros;
+  } else {
+    stats.device_to_host_bytes += num_bytes;
+    stats.device_to_host_micros += elapsed_micros;
+  }
 }
 
 void CudaMgr::copyDeviceToDevice(int8_t* dest_ptr,
@@ -359,6 +399,23 @@ void CudaMgr::createDeviceContexts() {
   }
 }
 
+CUstream CudaMgr::getStream(const int device_num, const size_t stream_idx) {
+  std::lock_guard<std::mutex> streams_lock(streams_mutex_);
+  CHECK_LT(device_num, device_count_);
+  if (device_streams_.empty()) {
+    device_streams_.resize(device_count_);
+  }
+  auto& streams = device_streams_[device_num];
+  if (stream_idx >= streams.size()) {
+    streams.resize(stream_idx + 1, nullptr);
+  }
+  if (!streams[stream_idx]) {
+    setContext(device_num);
+    checkError(cuStreamCreate(&streams[stream_idx], CU_STREAM_NON_BLOCKING));
+  }
+  return streams[stream_idx];
+}
+
 void CudaMgr::setContext(const int device_num) const {
   // deviceNum is the device number relative to startGpu (realDeviceNum - startGpu_)
   CHECK_LT(device_num, device_count_);
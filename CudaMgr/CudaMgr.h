@@ -77,6 +77,28 @@ struct DeviceProperties {
   int numCore;
 };
 
+/**
+ * Cumulative host/device copy statistics for a single device, used to report the
+ * achieved PCIe bandwidth.
+ */
+struct TransferStats {
+  size_t host_to_device_bytes{0};
+  size_t host_to_device_micros{0};
+  size_t device_to_host_bytes{0};
+  size_t device_to_host_micros{0};
+
+  double getHostToDeviceBandwidthGBs() const {
+    return host_to_device_micros
+               ? static_cast<double>(host_to_device_bytes) / host_to_device_micros / 1e3
+               : 0;
+  }
+  double getDeviceToHostBandwidthGBs() const {
+    return device_to_host_micros
+               ? static_cast<double>(device_to_host_bytes) / device_to_host_micros / 1e3
+               : 0;
+  }
+};
+
 class CudaMgr {
  public:
   CudaMgr(const int num_gpus, const int start_gpu = 0);
@@ -101,6 +123,13 @@ class CudaMgr {
                           const int dest_device_num,
                           const int src_device_num);
 
+  TransferStats getTransferStats(const int device_num) const {
+    std::lock_guard<std::mutex> stats_lock(transfer_stats_mutex_);
+    return static_cast<size_t>(device_num) < transfer_stats_.size()
+               ? transfer_stats_[device_num]
+               : TransferStats{};
+  }
+
   int8_t* allocatePinnedHostMem(const size_t num_bytes);
   int8_t* allocateDeviceMem(const size_t num_bytes, const int device_num);
   void freePinnedHostMem(int8_t* host_ptr);
@@ -213,6 +242,11 @@ class CudaMgr {
                          const int device_id) const;
   void unloadGpuModuleData(CUmodule* module, const int device_id) const;
 
+  // The non-blocking stream stream_idx of the device, created on first use. The kernels
+  // launched on different streams of a device may run concurrently, neither waits for
+  // the work of the default stream.
+  CUstream getStream(const int device_num, const size_t stream_idx);
+
   struct CudaMemoryUsage {
     size_t free;   // available GPU RAM memory on active card in bytes
     size_t total;  // total GPU RAM memory on active card in bytes
@@ -229,6 +263,10 @@ class CudaMgr {
   size_t computeMinSharedMemoryPerBlockForAllDevices() const;
   size_t computeMinNumMPsForAllDevices() const;
   void checkError(CUresult cu_result) const;
+  void recordTransfer(const int device_num,
+                      const size_t num_bytes,
+                      const size_t elapsed_micros,
+                      const bool host_to_device) const;
 
   int gpu_driver_version_;
 #endif
@@ -242,6 +280,12 @@ class CudaMgr {
   std::vector<CUcontext> device_contexts_;
 
   mutable std::mutex device_cleanup_mutex_;
+
+  std::mutex streams_mutex_;
+  std::vector<std::vector<CUstream>> device_streams_;
+
+  mutable std::mutex transfer_stats_mutex_;
+  mutable std::vector<TransferStats> transfer_stats_;
 };
 
 }  // Namespace CudaMgr_Namespace
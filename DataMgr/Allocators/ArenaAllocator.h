@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "DataMgr/Allocators/HostBufferPool.h"
 #include "DataMgr/DataMgr.h"
 #include "Shared/checked_alloc.h"
 
@@ -40,6 +41,33 @@ class SysAllocator {
   friend bool operator!=(Self const&, Self const&) noexcept { return false; }
 };
 
+/**
+ * SysAllocator giving the blocks back to the HostBufferPool on deallocation, for the
+ * arenas of the queries
+ */
+template <class T>
+class PooledSysAllocator {
+ public:
+  using Self = PooledSysAllocator;
+  using value_type = T;
+
+  constexpr PooledSysAllocator() = default;
+
+  constexpr PooledSysAllocator(PooledSysAllocator const&) = default;
+
+  template <class U>
+  constexpr PooledSysAllocator(const PooledSysAllocator<U>&) noexcept {}
+
+  [[nodiscard]] T* allocate(size_t count) {
+    return HostBufferPool::instance().allocate(count);
+  }
+
+  void deallocate(T* p, size_t /* count */) { HostBufferPool::instance().free(p); }
+
+  friend bool operator==(Self const&, Self const&) noexcept { return true; }
+  friend bool operator!=(Self const&, Self const&) noexcept { return false; }
+};
+
 #ifdef HAVE_FOLLY
 
 #include <folly/Memory.h>
@@ -48,18 +76,20 @@ class SysAllocator {
 constexpr size_t kArenaBlockOverhead = folly::Arena<::SysAllocator<void>>::kBlockOverhead;
 
 /**
- * Arena allocator using checked_malloc with default allocation size 2GB. Note that the
- * allocator only frees memory on destruction.
+ * Arena allocator using checked_malloc, or the HostBufferPool, with default allocation
+ * size 2GB. Note that the allocator only frees memory on destruction.
  */
-class Arena : public folly::Arena<::SysAllocator<void>> {
+template <class ALLOCATOR>
+class ArenaImpl : public folly::Arena<ALLOCATOR> {
  public:
-  explicit Arena(size_t min_block_size = static_cast<size_t>(1UL << 32) + kBlockOverhead,
-                 size_t size_limit = kNoSizeLimit,
-                 size_t max_align = kDefaultMaxAlign)
-      : folly::Arena<SysAllocator<void>>({}, min_block_size, size_limit, max_align) {}
+  explicit ArenaImpl(
+      size_t min_block_size = static_cast<size_t>(1UL << 32) + kArenaBlockOverhead,
+      size_t size_limit = folly::Arena<ALLOCATOR>::kNoSizeLimit,
+      size_t max_align = folly::Arena<ALLOCATOR>::kDefaultMaxAlign)
+      : folly::Arena<ALLOCATOR>({}, min_block_size, size_limit, max_align) {}
 
   void* allocateAndZero(const size_t size) {
-    auto ret = allocate(size);
+    auto ret = this->allocate(size);
     std::memset(ret, 0, size);
     return ret;
   }
@@ -72,6 +102,13 @@ struct folly::ArenaAllocatorTraits<::SysAllocator<void>> {
   }
 };
 
+template <>
+struct folly::ArenaAllocatorTraits<::PooledSysAllocator<void>> {
+  static size_t goodSize(const ::PooledSysAllocator<void>& /* alloc */, size_t size) {
+    return folly::goodMallocSize(size);
+  }
+};
+
 #else
 
 constexpr size_t kArenaBlockOverhead = 0;
@@ -81,11 +118,12 @@ constexpr size_t kArenaBlockOverhead = 0;
  * freeing. For development and testing only, where folly is not available. Not for
  * production use.
  */
-class Arena {
+template <class ALLOCATOR>
+class ArenaImpl {
  public:
-  explicit Arena(size_t min_block_size = 1UL << 32, size_t size_limit = 0) {}
+  explicit ArenaImpl(size_t min_block_size = 1UL << 32, size_t size_limit = 0) {}
 
-  ~Arena() {
+  ~ArenaImpl() {
     for (auto ptr : allocations_) {
       allocator_.deallocate(ptr, 0);
     }
@@ -104,8 +142,12 @@ class Arena {
   }
 
  private:
-  SysAllocator<void> allocator_;
+  ALLOCATOR allocator_;
   std::vector<void*> allocations_;
 };
 
 #endif
+
+using Arena = ArenaImpl<SysAllocator<void>>;
+// for the output and scratch buffers of the queries
+using PooledArena = ArenaImpl<PooledSysAllocator<void>>;
@@ -36,6 +36,17 @@ CudaAllocator::~CudaAllocator() {
   for (auto& buffer_ptr : owned_buffers_) {
     data_mgr_->free(buffer_ptr);
   }
+  if (usage_tracker_) {
+    usage_tracker_->free(usage_category_, tracked_bytes_);
+  }
+}
+
+void CudaAllocator::setUsageTracker(
+    std::shared_ptr<DeviceMemoryUsageTracker> usage_tracker,
+    const DeviceMemoryCategory category) {
+  CHECK(!usage_tracker_);
+  usage_tracker_ = usage_tracker;
+  usage_category_ = category;
 }
 
 Data_Namespace::AbstractBuffer* CudaAllocator::allocGpuAbstractBuffer(
@@ -58,6 +69,10 @@ int8_t* CudaAllocator::alloc(const size_t num_bytes) {
   CHECK(data_mgr_);
   owned_buffers_.emplace_back(
       CudaAllocator::allocGpuAbstractBuffer(data_mgr_, num_bytes, device_id_));
+  if (usage_tracker_) {
+    usage_tracker_->allocate(usage_category_, num_bytes);
+    tracked_bytes_ += num_bytes;
+  }
   return owned_buffers_.back()->getMemoryPtr();
 }
 
@@ -24,6 +24,8 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <vector>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -32,6 +34,7 @@
 #endif
 
 #include "DataMgr/Allocators/DeviceAllocator.h"
+#include "DataMgr/Allocators/DeviceMemoryUsageTracker.h"
 
 namespace Data_Namespace {
 class AbstractBuffer;
@@ -54,6 +57,13 @@ class CudaAllocator : public DeviceAllocator {
   static void freeGpuAbstractBuffer(Data_Namespace::DataMgr* data_mgr,
                                     Data_Namespace::AbstractBuffer* ab);
 
+  /**
+   * Accounts all subsequent allocations of this allocator to the given category of the
+   * query's device memory usage, until the allocator releases them.
+   */
+  void setUsageTracker(std::shared_ptr<DeviceMemoryUsageTracker> usage_tracker,
+                       const DeviceMemoryCategory category);
+
   int8_t* alloc(const size_t num_bytes) override;
 
   void free(Data_Namespace::AbstractBuffer* ab) const override;
@@ -77,4 +87,8 @@ class CudaAllocator : public DeviceAllocator {
 
   Data_Namespace::DataMgr* data_mgr_;
   int device_id_;
+
+  std::shared_ptr<DeviceMemoryUsageTracker> usage_tracker_;
+  DeviceMemoryCategory usage_category_{DeviceMemoryCategory::Scratch};
+  size_t tracked_bytes_{0};
 };
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    DeviceMemoryUsageTracker.h
+ * @brief   Accounts for the device memory held by a single query, by purpose
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+#include "Logger/Logger.h"
+
+enum class DeviceMemoryCategory {
+  InputChunks = 0,  // table chunks fetched into the GPU buffer pool
+  OutputBuffers,    // group by / projection output buffers
+  HashTables,       // join hash tables
+  Scratch,          // everything else, e.g. linearized columns and kernel parameters
+  Count
+};
+
+/**
+ * Peak device memory used by a query, summed over all devices.
+ */
+struct DeviceMemoryUsage {
+  std::array<size_t, static_cast<size_t>(DeviceMemoryCategory::Count)> peak_bytes{};
+  size_t peak_total_bytes{0};
+
+  size_t getPeakBytes(const DeviceMemoryCategory category) const {
+    return peak_bytes[static_cast<size_t>(category)];
+  }
+};
+
+class DeviceMemoryUsageTracker {
+ public:
+  void allocate(const DeviceMemoryCategory category, const size_t num_bytes) {
+    const auto idx = static_cast<size_t>(category);
+    CHECK_LT(idx, current_bytes_.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_bytes_[idx] += num_bytes;
+    current_total_bytes_ += num_bytes;
+    usage_.peak_bytes[idx] = std::max(usage_.peak_bytes[idx], current_bytes_[idx]);
+    usage_.peak_total_bytes = std::max(usage_.peak_total_bytes, current_total_bytes_);
+  }
+
+  void free(const DeviceMemoryCategory category, const size_t num_bytes) {
+    const auto idx = static_cast<size_t>(category);
+    CHECK_LT(idx, current_bytes_.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_GE(current_bytes_[idx], num_bytes);
+    current_bytes_[idx] -= num_bytes;
+    current_total_bytes_ -= num_bytes;
+  }
+
+  DeviceMemoryUsage getUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usage_;
+  }
+
+ private:
+  std::array<size_t, static_cast<size_t>(DeviceMemoryCategory::Count)> current_bytes_{};
+  size_t current_total_bytes_{0};
+  DeviceMemoryUsage usage_;
+
+  mutable std::mutex mutex_;
+};
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/Allocators/GpuScratchPool.h"
+
+#include <algorithm>
+
+#include "DataMgr/Allocators/CudaAllocator.h"
+#include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/DataMgr.h"
+#include "Logger/Logger.h"
+
+bool g_enable_gpu_scratch_pool{false};
+size_t g_gpu_scratch_pool_bytes{size_t(1) << 30};  // 1GB
+
+namespace {
+
+size_t get_size_class(const size_t num_bytes) {
+  size_t size_class = GpuScratchPool::kMinSizeClass;
+  while (size_class < num_bytes) {
+    size_class <<= 1;
+  }
+  return size_class;
+}
+
+}  // namespace
+
+GpuScratchPool& GpuScratchPool::instance() {
+  static GpuScratchPool pool;
+  return pool;
+}
+
+Data_Namespace::AbstractBuffer* GpuScratchPool::allocate(
+    Data_Namespace::DataMgr* data_mgr,
+    const size_t num_bytes,
+    const int device_id) {
+  CHECK(data_mgr);
+  if (!g_enable_gpu_scratch_pool) {
+    return CudaAllocator::allocGpuAbstractBuffer(data_mgr, num_bytes, device_id);
+  }
+  const auto size_class = get_size_class(num_bytes);
+  bool is_pooled{false};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& device_pool = getDevicePool(data_mgr, device_id);
+    is_pooled = size_class <= device_pool.max_bytes;
+    auto it = device_pool.free_buffers.find(size_class);
+    if (is_pooled && it != device_pool.free_buffers.end() && !it->second.empty()) {
+      auto ab = it->second.back();
+      it->second.pop_back();
+      device_pool.bytes -= size_class;
+      stats_.bytes -= size_class;
+      ++stats_.hits;
+      allocated_sizes_.emplace(ab, size_class);
+      return ab;
+    }
+    stats_.misses += is_pooled;
+  }
+  if (!is_pooled) {
+    // wouldn't be kept anyway, no point in rounding it up
+    return CudaAllocator::allocGpuAbstractBuffer(data_mgr, num_bytes, device_id);
+  }
+  Data_Namespace::AbstractBuffer* ab{nullptr};
+  try {
+    ab = CudaAllocator::allocGpuAbstractBuffer(data_mgr, size_class, device_id);
+  } catch (const OutOfMemory&) {
+    std::vector<Data_Namespace::AbstractBuffer*> released_buffers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      released_buffers = releaseDevicePool(getDevicePool(data_mgr, device_id));
+      stats_.releases += !released_buffers.empty();
+    }
+    if (released_buffers.empty()) {
+      throw;
+    }
+    VLOG(1) << "Give " << released_buffers.size()
+            << " pooled scratch buffers back to the GPU buffer pool of device #"
+            << device_id << " for an allocation of " << size_class << " bytes";
+    for (auto released_ab : released_buffers) {
+      data_mgr->free(released_ab);
+    }
+    ab = CudaAllocator::allocGpuAbstractBuffer(data_mgr, size_class, device_id);
+  }
+  CHECK(ab);
+  std::lock_guard<std::mutex> lock(mutex_);
+  allocated_sizes_.emplace(ab, size_class);
+  return ab;
+}
+
+void GpuScratchPool::free(Data_Namespace::DataMgr* data_mgr,
+                          Data_Namespace::AbstractBuffer* ab) {
+  CHECK(data_mgr);
+  CHECK(ab);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = allocated_sizes_.find(ab);
+    if (it != allocated_sizes_.end()) {
+      const auto size_class = it->second;
+      allocated_sizes_.erase(it);
+      auto& device_pool = getDevicePool(data_mgr, ab->getDeviceId());
+      if (g_enable_gpu_scratch_pool &&
+          device_pool.bytes + size_class <= device_pool.max_bytes) {
+        device_pool.free_buffers[size_class].push_back(ab);
+        device_pool.bytes += size_class;
+        stats_.bytes += size_class;
+        return;
+      }
+    }
+  }
+  data_mgr->free(ab);
+}
+
+void GpuScratchPool::clear() {
+  std::vector<std::pair<Data_Namespace::DataMgr*, Data_Namespace::AbstractBuffer*>>
+      buffers_to_free;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    VLOG(1) << "Free " << stats_.bytes << " bytes of pooled GPU scratch buffers, "
+            << stats_.hits << " hits, " << stats_.misses << " misses, "
+            << stats_.releases << " releases on out of memory";
+    for (auto& [device_key, device_pool] : device_pools_) {
+      for (auto ab : releaseDevicePool(device_pool)) {
+        buffers_to_free.emplace_back(std::get<0>(device_key), ab);
+      }
+    }
+    CHECK_EQ(stats_.bytes, size_t(0));
+  }
+  for (auto& [data_mgr, ab] : buffers_to_free) {
+    data_mgr->free(ab);
+  }
+}
+
+size_t GpuScratchPool::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t buffer_count{0};
+  for (const auto& [device_key, device_pool] : device_pools_) {
+    for (const auto& [size_class, buffers] : device_pool.free_buffers) {
+      buffer_count += buffers.size();
+    }
+  }
+  return buffer_count;
+}
+
+GpuScratchPool::Stats GpuScratchPool::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+GpuScratchPool::DevicePool& GpuScratchPool::getDevicePool(
+    Data_Namespace::DataMgr* data_mgr,
+    const int device_id) {
+  const DeviceKey device_key{data_mgr, device_id};
+  auto it = device_pools_.find(device_key);
+  if (it == device_pools_.end()) {
+    DevicePool device_pool;
+    const auto buffer_pool_bytes =
+        data_mgr->getBufferPoolMaxSize(Data_Namespace::GPU_LEVEL, device_id);
+    device_pool.max_bytes =
+        std::min(g_gpu_scratch_pool_bytes,
+                 static_cast<size_t>(buffer_pool_bytes * kMaxBufferPoolFraction));
+    it = device_pools_.emplace(device_key, std::move(device_pool)).first;
+  }
+  return it->second;
+}
+
+std::vector<Data_Namespace::AbstractBuffer*> GpuScratchPool::releaseDevicePool(
+    DevicePool& device_pool) {
+  std::vector<Data_Namespace::AbstractBuffer*> buffers;
+  for (auto& [size_class, free_buffers] : device_pool.free_buffers) {
+    buffers.insert(buffers.end(), free_buffers.begin(), free_buffers.end());
+  }
+  device_pool.free_buffers.clear();
+  stats_.bytes -= device_pool.bytes;
+  device_pool.bytes = 0;
+  return buffers;
+}
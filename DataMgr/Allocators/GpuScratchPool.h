@@ -0,0 +1,104 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    GpuScratchPool.h
+ * @brief   Byte bounded pool of the GPU scratch buffers of the sorts and the kernels
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+extern bool g_enable_gpu_scratch_pool;
+extern size_t g_gpu_scratch_pool_bytes;
+
+namespace Data_Namespace {
+class AbstractBuffer;
+class DataMgr;
+}  // namespace Data_Namespace
+
+/**
+ * Keeps the GPU buffers the ThrustAllocators allocate for the thrust algorithms and the
+ * scratch memory of the kernels once they are given back, by device and by their size
+ * rounded up to a power of two of at least kMinSizeClass. The next allocation of the same
+ * size class on the device gets one back instead of going through the GPU buffer pool of
+ * the DataMgr, which dominates the small sorts. The kernels and thrust all run on the
+ * default stream of the context of the device, so a reused buffer is only touched after
+ * the work of its former owner.
+ *
+ * The pooled buffers stay allocated from the GPU buffer pool, their bytes count against
+ * it: a device keeps at most g_gpu_scratch_pool_bytes, and no more than
+ * kMaxBufferPoolFraction of its buffer pool, of free buffers. When the buffer pool runs
+ * out of memory for an allocation, the free buffers of the device are given back to it
+ * and the allocation retried.
+ */
+class GpuScratchPool {
+ public:
+  static constexpr size_t kMinSizeClass{size_t(1) << 12};  // 4KB
+  static constexpr double kMaxBufferPoolFraction{0.25};
+
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t releases{0};  // of the free buffers of a device, on out of memory
+    size_t bytes{0};       // of the free buffers, over all the devices
+  };
+
+  static GpuScratchPool& instance();
+
+  //! A buffer of at least num_bytes on device_id, allocated unless a free one is pooled
+  Data_Namespace::AbstractBuffer* allocate(Data_Namespace::DataMgr* data_mgr,
+                                           const size_t num_bytes,
+                                           const int device_id);
+
+  //! Takes back a buffer of allocate(), or frees one which wasn't
+  void free(Data_Namespace::DataMgr* data_mgr, Data_Namespace::AbstractBuffer* ab);
+
+  //! Frees the free buffers of all the devices
+  void clear();
+
+  size_t size() const;
+
+  Stats getStats() const;
+
+ private:
+  using DeviceKey = std::tuple<Data_Namespace::DataMgr*, int>;
+
+  struct DevicePool {
+    size_t max_bytes{0};
+    size_t bytes{0};
+    // by size class
+    std::unordered_map<size_t, std::vector<Data_Namespace::AbstractBuffer*>> free_buffers;
+  };
+
+  DevicePool& getDevicePool(Data_Namespace::DataMgr* data_mgr, const int device_id);
+
+  // the buffers to free are returned, for the caller to free outside of the lock
+  std::vector<Data_Namespace::AbstractBuffer*> releaseDevicePool(DevicePool& device_pool);
+
+  mutable std::mutex mutex_;
+  std::map<DeviceKey, DevicePool> device_pools_;
+  // the size classes of the buffers which are in use
+  std::unordered_map<Data_Namespace::AbstractBuffer*, size_t> allocated_sizes_;
+  Stats stats_;
+};
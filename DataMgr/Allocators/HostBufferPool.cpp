@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/Allocators/HostBufferPool.h"
+
+#include <cstdlib>
+
+#include "Logger/Logger.h"
+#include "Shared/checked_alloc.h"
+
+bool g_enable_host_buffer_pool{false};
+size_t g_host_buffer_pool_bytes{size_t(16) << 30};  // 16GB
+
+HostBufferPool& HostBufferPool::instance() {
+  static HostBufferPool pool;
+  return pool;
+}
+
+void* HostBufferPool::allocate(const size_t num_bytes) {
+  if (!g_enable_host_buffer_pool || num_bytes < kBlockGranularity) {
+    return checked_malloc(num_bytes);
+  }
+  const auto size_class =
+      (num_bytes + kBlockGranularity - 1) / kBlockGranularity * kBlockGranularity;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_blocks_.find(size_class);
+    if (it != free_blocks_.end() && !it->second.empty()) {
+      auto ptr = it->second.back();
+      it->second.pop_back();
+      stats_.bytes -= size_class;
+      ++stats_.hits;
+      allocated_sizes_.emplace(ptr, size_class);
+      return ptr;
+    }
+    ++stats_.misses;
+  }
+  auto ptr = checked_malloc(size_class);
+  std::lock_guard<std::mutex> lock(mutex_);
+  allocated_sizes_.emplace(ptr, size_class);
+  return ptr;
+}
+
+void HostBufferPool::free(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = allocated_sizes_.find(ptr);
+    if (it != allocated_sizes_.end()) {
+      const auto size_class = it->second;
+      allocated_sizes_.erase(it);
+      if (g_enable_host_buffer_pool &&
+          stats_.bytes + size_class <= g_host_buffer_pool_bytes) {
+        free_blocks_[size_class].push_back(ptr);
+        stats_.bytes += size_class;
+        return;
+      }
+    }
+  }
+  ::free(ptr);
+}
+
+void HostBufferPool::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  VLOG(1) << "Free " << stats_.bytes << " bytes of pooled host blocks, " << stats_.hits
+          << " hits, " << stats_.misses << " misses";
+  for (auto& [size_class, blocks] : free_blocks_) {
+    for (auto ptr : blocks) {
+      ::free(ptr);
+    }
+  }
+  free_blocks_.clear();
+  stats_.bytes = 0;
+}
+
+size_t HostBufferPool::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t block_count{0};
+  for (const auto& [size_class, blocks] : free_blocks_) {
+    block_count += blocks.size();
+  }
+  return block_count;
+}
+
+HostBufferPool::Stats HostBufferPool::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    HostBufferPool.h
+ * @brief   Byte bounded pool of the large host blocks freed by the arenas of the queries
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+extern bool g_enable_host_buffer_pool;
+extern size_t g_host_buffer_pool_bytes;
+
+/**
+ * Keeps the blocks the arenas of the queries allocate their output and scratch buffers
+ * from once the queries are done with them, by their size rounded up to a multiple of
+ * kBlockGranularity. The next query allocating a block of the same size class gets one
+ * back, its pages already mapped, instead of faulting in new zeroed ones: the dashboards
+ * run the same queries, with the same buffer sizes, over and over. The blocks below
+ * kBlockGranularity, which malloc serves from its own free lists, aren't pooled. Beyond
+ * g_host_buffer_pool_bytes of free blocks, the blocks given back are freed.
+ */
+class HostBufferPool {
+ public:
+  static constexpr size_t kBlockGranularity{size_t(1) << 21};  // 2MB
+
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    size_t bytes{0};  // of the free blocks
+  };
+
+  static HostBufferPool& instance();
+
+  //! A block of at least num_bytes, checked_malloc'ed unless a free one is available
+  void* allocate(const size_t num_bytes);
+
+  //! Takes back a block of allocate(), or frees one which wasn't
+  void free(void* ptr);
+
+  //! Frees the free blocks
+  void clear();
+
+  size_t size() const;
+
+  Stats getStats() const;
+
+ private:
+  mutable std::mutex mutex_;
+  // by their address, the size classes of the blocks which are in use
+  std::unordered_map<void*, size_t> allocated_sizes_;
+  // by size class
+  std::unordered_map<size_t, std::vector<void*>> free_blocks_;
+  Stats stats_;
+};
@@ -23,6 +23,7 @@
 
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/Allocators/CudaAllocator.h"
+#include "DataMgr/Allocators/GpuScratchPool.h"
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
 
@@ -38,7 +39,7 @@ int8_t* ThrustAllocator::allocate(std::ptrdiff_t num_bytes) {
   }
 #endif  // HAVE_CUDA
   Data_Namespace::AbstractBuffer* ab =
-      CudaAllocator::allocGpuAbstractBuffer(data_mgr_, num_bytes, device_id_);
+      GpuScratchPool::instance().allocate(data_mgr_, num_bytes, device_id_);
   int8_t* raw_ptr = reinterpret_cast<int8_t*>(ab->getMemoryPtr());
   CHECK(!raw_to_ab_ptr_.count(raw_ptr));
   raw_to_ab_ptr_.insert(std::make_pair(raw_ptr, ab));
@@ -55,7 +56,7 @@ void ThrustAllocator::deallocate(int8_t* ptr, size_t num_bytes) {
 #endif  // HAVE_CUDA
   PtrMapperType::iterator ab_it = raw_to_ab_ptr_.find(ptr);
   CHECK(ab_it != raw_to_ab_ptr_.end());
-  data_mgr_->free(ab_it->second);
+  GpuScratchPool::instance().free(data_mgr_, ab_it->second);
   raw_to_ab_ptr_.erase(ab_it);
 }
 
@@ -70,14 +71,14 @@ int8_t* ThrustAllocator::allocateScopedBuffer(std::ptrdiff_t num_bytes) {
   }
 #endif  // HAVE_CUDA
   Data_Namespace::AbstractBuffer* ab =
-      CudaAllocator::allocGpuAbstractBuffer(data_mgr_, num_bytes, device_id_);
+      GpuScratchPool::instance().allocate(data_mgr_, num_bytes, device_id_);
   scoped_buffers_.push_back(ab);
   return reinterpret_cast<int8_t*>(ab->getMemoryPtr());
 }
 
 ThrustAllocator::~ThrustAllocator() {
   for (auto ab : scoped_buffers_) {
-    data_mgr_->free(ab);
+    GpuScratchPool::instance().free(data_mgr_, ab);
   }
 #ifdef HAVE_CUDA
   for (auto ptr : default_alloc_scoped_buffers_) {
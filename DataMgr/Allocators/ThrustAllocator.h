@@ -19,7 +19,7 @@
  * @author  Minggang Yu <miyu@mapd.com>
  * @brief   Allocate GPU memory using GpuBuffers via DataMgr. Unlike the CudaAllocator,
  * these buffers are destroyed and memory is released when the parent object goes out of
- * scope.
+ * scope, back to the GpuScratchPool when it's enabled.
  *
  */
 
@@ -35,6 +35,7 @@
 #include "AbstractBuffer.h"
 #include "ChunkMetadata.h"
 #include "Encoder.h"
+#include "ValueStats.h"
 
 using Data_Namespace::AbstractBuffer;
 
@@ -284,22 +285,11 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.boolval = true;
           elem_max.boolval = false;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const bool* bool_array = (bool*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(bool); i++) {
-          if ((int8_t)bool_array[i] == NULL_BOOLEAN) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.boolval = std::min(elem_min.boolval, bool_array[i]);
-            elem_max.boolval = std::max(elem_max.boolval, bool_array[i]);
-          } else {
-            elem_min.boolval = bool_array[i];
-            elem_max.boolval = bool_array[i];
-            initialized = true;
-          }
-        }
+        int8_t bool_min = elem_min.boolval;
+        int8_t bool_max = elem_max.boolval;
+        update_elem_stats<int8_t>(array, NULL_BOOLEAN, bool_min, bool_max);
+        elem_min.boolval = bool_min;
+        elem_max.boolval = bool_max;
         break;
       }
       case kINT: {
@@ -307,22 +297,7 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.intval = 1;
           elem_max.intval = 0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const int32_t* int_array = (int32_t*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(int32_t); i++) {
-          if (int_array[i] == NULL_INT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.intval = std::min(elem_min.intval, int_array[i]);
-            elem_max.intval = std::max(elem_max.intval, int_array[i]);
-          } else {
-            elem_min.intval = int_array[i];
-            elem_max.intval = int_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<int32_t>(array, NULL_INT, elem_min.intval, elem_max.intval);
         break;
       }
       case kSMALLINT: {
@@ -330,22 +305,8 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.smallintval = 1;
           elem_max.smallintval = 0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const int16_t* int_array = (int16_t*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(int16_t); i++) {
-          if (int_array[i] == NULL_SMALLINT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.smallintval = std::min(elem_min.smallintval, int_array[i]);
-            elem_max.smallintval = std::max(elem_max.smallintval, int_array[i]);
-          } else {
-            elem_min.smallintval = int_array[i];
-            elem_max.smallintval = int_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<int16_t>(
+            array, NULL_SMALLINT, elem_min.smallintval, elem_max.smallintval);
         break;
       }
       case kTINYINT: {
@@ -353,47 +314,22 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.tinyintval = 1;
           elem_max.tinyintval = 0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const int8_t* int_array = (int8_t*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(int8_t); i++) {
-          if (int_array[i] == NULL_TINYINT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.tinyintval = std::min(elem_min.tinyintval, int_array[i]);
-            elem_max.tinyintval = std::max(elem_max.tinyintval, int_array[i]);
-          } else {
-            elem_min.tinyintval = int_array[i];
-            elem_max.tinyintval = int_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<int8_t>(
+            array, NULL_TINYINT, elem_min.tinyintval, elem_max.tinyintval);
         break;
       }
       case kBIGINT:
       case kNUMERIC:
-      case kDECIMAL: {
+      case kDECIMAL:
+      case kTIME:
+      case kTIMESTAMP:
+      case kDATE: {
         if (!initialized) {
           elem_min.bigintval = 1;
           elem_max.bigintval = 0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const int64_t* int_array = (int64_t*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(int64_t); i++) {
-          if (int_array[i] == NULL_BIGINT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.bigintval = std::min(elem_min.bigintval, int_array[i]);
-            elem_max.bigintval = std::max(elem_max.bigintval, int_array[i]);
-          } else {
-            elem_min.bigintval = int_array[i];
-            elem_max.bigintval = int_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<int64_t>(
+            array, NULL_BIGINT, elem_min.bigintval, elem_max.bigintval);
         break;
       }
       case kFLOAT: {
@@ -401,22 +337,7 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.floatval = 1.0;
           elem_max.floatval = 0.0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const float* flt_array = (float*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(float); i++) {
-          if (flt_array[i] == NULL_FLOAT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.floatval = std::min(elem_min.floatval, flt_array[i]);
-            elem_max.floatval = std::max(elem_max.floatval, flt_array[i]);
-          } else {
-            elem_min.floatval = flt_array[i];
-            elem_max.floatval = flt_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<float>(array, NULL_FLOAT, elem_min.floatval, elem_max.floatval);
         break;
       }
       case kDOUBLE: {
@@ -424,47 +345,8 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.doubleval = 1.0;
           elem_max.doubleval = 0.0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const double* dbl_array = (double*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(double); i++) {
-          if (dbl_array[i] == NULL_DOUBLE) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.doubleval = std::min(elem_min.doubleval, dbl_array[i]);
-            elem_max.doubleval = std::max(elem_max.doubleval, dbl_array[i]);
-          } else {
-            elem_min.doubleval = dbl_array[i];
-            elem_max.doubleval = dbl_array[i];
-            initialized = true;
-          }
-        }
-        break;
-      }
-      case kTIME:
-      case kTIMESTAMP:
-      case kDATE: {
-        if (!initialized) {
-          elem_min.bigintval = 1;
-          elem_max.bigintval = 0;
-        }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const auto tm_array = reinterpret_cast<int64_t*>(array.pointer);
-        for (size_t i = 0; i < array.length / sizeof(int64_t); i++) {
-          if (tm_array[i] == NULL_BIGINT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.bigintval = std::min(elem_min.bigintval, tm_array[i]);
-            elem_max.bigintval = std::max(elem_max.bigintval, tm_array[i]);
-          } else {
-            elem_min.bigintval = tm_array[i];
-            elem_max.bigintval = tm_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<double>(
+            array, NULL_DOUBLE, elem_min.doubleval, elem_max.doubleval);
         break;
       }
       case kCHAR:
@@ -475,22 +357,7 @@ class ArrayNoneEncoder : public Encoder {
           elem_min.intval = 1;
           elem_max.intval = 0;
         }
-        if (array.is_null || array.length == 0) {
-          break;
-        }
-        const int32_t* int_array = (int32_t*)array.pointer;
-        for (size_t i = 0; i < array.length / sizeof(int32_t); i++) {
-          if (int_array[i] == NULL_INT) {
-            has_nulls = true;
-          } else if (initialized) {
-            elem_min.intval = std::min(elem_min.intval, int_array[i]);
-            elem_max.intval = std::max(elem_max.intval, int_array[i]);
-          } else {
-            elem_min.intval = int_array[i];
-            elem_max.intval = int_array[i];
-            initialized = true;
-          }
-        }
+        update_elem_stats<int32_t>(array, NULL_INT, elem_min.intval, elem_max.intval);
         break;
       }
       default:
@@ -498,6 +365,32 @@ class ArrayNoneEncoder : public Encoder {
     }
   };
 
+  template <typename T>
+  void update_elem_stats(const ArrayDatum& array,
+                         const T null_value,
+                         T& elem_min_val,
+                         T& elem_max_val) {
+    if (array.is_null || array.length == 0) {
+      return;
+    }
+    const auto stats = value_stats::compute(
+        reinterpret_cast<const T*>(array.pointer), array.length / sizeof(T), null_value);
+    if (stats.has_nulls) {
+      has_nulls = true;
+    }
+    if (!stats.hasValues()) {
+      return;
+    }
+    if (initialized) {
+      elem_min_val = std::min(elem_min_val, stats.min);
+      elem_max_val = std::max(elem_max_val, stats.max);
+    } else {
+      elem_min_val = stats.min;
+      elem_max_val = stats.max;
+      initialized = true;
+    }
+  }
+
 };  // class ArrayNoneEncoder
 
 #endif  // ARRAY_NONE_ENCODER_H
@@ -31,6 +31,8 @@
 
 using namespace std;
 
+double g_buffer_pool_compaction_threshold{0};
+
 namespace Buffer_Namespace {
 
 std::string BufferMgr::keyToString(const ChunkKey& key) {
@@ -59,7 +61,11 @@ BufferMgr::BufferMgr(const int device_id,
     , allocations_capped_(false)
     , parent_mgr_(parent_mgr)
     , max_buffer_id_(0)
-    , buffer_epoch_(0) {
+    , buffer_epoch_(0)
+    , eviction_policy_(std::make_unique<LruEvictionPolicy>())
+    , num_hits_(0)
+    , num_misses_(0)
+    , num_evictions_(0) {
   CHECK(max_buffer_pool_size_ > 0);
   CHECK(page_size_ > 0);
   // TODO change checks on run-time configurable slab size variables to exceptions
@@ -164,6 +170,7 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
     num_pages += evict_it->num_pages;
     if (evict_it->mem_status == USED && evict_it->chunk_key.size() > 0) {
       chunk_index_.erase(evict_it->chunk_key);
+      ++num_evictions_;
     }
     evict_it = slab_segments_[slab_num].erase(
         evict_it);  // erase operations returns next iterator - safe if we ever move
@@ -216,11 +223,12 @@ BufferList::iterator BufferMgr::reserveBuffer(
   }
   // If we're here then we couldn't keep buffer in existing slot
   // need to find new segment, copy data over, and then delete old
-  auto new_seg_it = findFreeBuffer(num_bytes);
+  auto new_seg_it = findFreeBuffer(num_bytes, getNumaNode(seg_it->chunk_key));
 
   // Below should be in copy constructor for BufferSeg?
   new_seg_it->buffer = seg_it->buffer;
   new_seg_it->chunk_key = seg_it->chunk_key;
+  new_seg_it->prev_touched = seg_it->prev_touched;
   int8_t* old_mem = new_seg_it->buffer->mem_;
   new_seg_it->buffer->mem_ =
       slabs_[new_seg_it->slab_num] + new_seg_it->start_page * page_size_;
@@ -255,6 +263,7 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
       buffer_it->num_pages = num_pages_requested;
       buffer_it->mem_status = USED;
       buffer_it->last_touched = buffer_epoch_++;
+      buffer_it->prev_touched = 0;
       buffer_it->slab_num = slab_num;
       if (excess_pages > 0) {
         BufferSeg free_seg(
@@ -272,7 +281,7 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
   return slab_segments_[slab_num].end();
 }
 
-BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
+BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes, const int numa_node) {
   size_t num_pages_requested = (num_bytes + page_size_ - 1) / page_size_;
   if (num_pages_requested > max_num_pages_per_slab_) {
     throw TooBigForSlab(num_bytes);
@@ -281,6 +290,9 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   size_t num_slabs = slab_segments_.size();
 
   for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+    if (numa_node >= 0 && getSlabNumaNode(slab_num) != numa_node) {
+      continue;
+    }
     auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
     if (seg_it != slab_segments_[slab_num].end()) {
       return seg_it;
@@ -299,7 +311,7 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
           current_max_slab_page_size_) {  // don't try to allocate if the
                                           // new slab won't be big enough
         auto alloc_ms = measure<>::execution(
-            [&]() { addSlab(current_max_slab_page_size_ * page_size_); });
+            [&]() { addSlab(current_max_slab_page_size_ * page_size_, numa_node); });
         LOG(INFO) << "ALLOCATION slab of " << current_max_slab_page_size_ << " pages ("
                   << current_max_slab_page_size_ * page_size_ << "B) created in "
                   << alloc_ms << " ms " << getStringMgrType() << ":" << device_id_;
@@ -342,6 +354,42 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
     throw FailedToCreateFirstSlab(num_bytes);
   }
 
+  // Remote memory is still preferable to evicting
+  if (numa_node >= 0) {
+    for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+      if (getSlabNumaNode(slab_num) == numa_node) {
+        continue;
+      }
+      auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
+      if (seg_it != slab_segments_[slab_num].end()) {
+        return seg_it;
+      }
+    }
+  }
+
+  // Before evicting, see whether compacting fragmented slabs frees a large enough run
+  if (g_buffer_pool_compaction_threshold > 0 &&
+      computeFragmentationRatio() > g_buffer_pool_compaction_threshold) {
+    for (size_t slab_num = 0; slab_num != num_slabs; ++slab_num) {
+      size_t free_pages = 0;
+      for (const auto& segment : slab_segments_[slab_num]) {
+        if (segment.mem_status == FREE) {
+          free_pages += segment.num_pages;
+        }
+      }
+      if (free_pages < num_pages_requested) {
+        continue;
+      }
+      auto compact_ms = measure<>::execution([&]() { compactSlab(slab_num); });
+      LOG(INFO) << "ALLOCATION compacted slab " << slab_num << " in " << compact_ms
+                << " ms " << getStringMgrType() << ":" << device_id_;
+      auto seg_it = findFreeBufferInSlab(slab_num, num_pages_requested);
+      if (seg_it != slab_segments_[slab_num].end()) {
+        return seg_it;
+      }
+    }
+  }
+
   // If here then we can't add a slab - so we need to evict
 
   size_t min_score = std::numeric_limits<size_t>::max();
@@ -351,6 +399,7 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   BufferList::iterator best_eviction_start = slab_segments_[0].end();
   int best_eviction_start_slab = -1;
   int slab_num = 0;
+  std::lock_guard<std::mutex> resident_columns_lock(resident_columns_mutex_);
 
   for (auto slab_it = slab_segments_.begin(); slab_it != slab_segments_.end();
        ++slab_it, ++slab_num) {
@@ -369,8 +418,9 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
       for (; evict_it != slab_segments_[slab_num].end(); ++evict_it) {
         // pinCount should never go up - only down because we have
         // global lock on buffer pool and pin count only increments
-        // on getChunk
-        if (evict_it->mem_status == USED && evict_it->buffer->getPinCount() > 0) {
+        // on getChunk. The chunks of the resident columns stay put like pinned ones.
+        if (evict_it->mem_status == USED &&
+            (evict_it->buffer->getPinCount() > 0 || isResident(evict_it->chunk_key))) {
           break;
         }
         page_count += evict_it->num_pages;
@@ -382,7 +432,7 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
           // chunk score was larger than one large chunk so it always would evict a large
           // chunk so under memory pressure a query would evict its own current chunks and
           // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evict_it->last_touched));
+          score = std::max(score, eviction_policy_->getEvictionScore(*evict_it));
         }
         if (page_count >= num_pages_requested) {
           solution_found = true;
@@ -724,6 +774,8 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
     buffer_it->second->buffer->pin();
     sized_segs_lock.unlock();
 
+    ++num_hits_;
+    buffer_it->second->prev_touched = buffer_it->second->last_touched;
     buffer_it->second->last_touched = buffer_epoch_++;  // race
 
     if (buffer_it->second->buffer->size() < num_bytes) {
@@ -732,6 +784,7 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
     }
     return buffer_it->second->buffer;
   } else {  // If wasn't in pool then we need to fetch it
+    ++num_misses_;
     sized_segs_lock.unlock();
     // createChunk pins for us
     AbstractBuffer* buffer = createBuffer(key, page_size_, num_bytes);
@@ -758,6 +811,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   chunk_index_lock.unlock();
   AbstractBuffer* buffer;
   if (!found_buffer) {
+    ++num_misses_;
     sized_segs_lock.unlock();
     CHECK(parent_mgr_ != 0);
     buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
@@ -767,8 +821,11 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
       LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
     }
   } else {
+    ++num_hits_;
     buffer = buffer_it->second->buffer;
     buffer->pin();
+    buffer_it->second->prev_touched = buffer_it->second->last_touched;
+    buffer_it->second->last_touched = buffer_epoch_++;
     if (num_bytes > buffer->size()) {
       try {
         parent_mgr_->fetchBuffer(key, buffer, num_bytes);
@@ -887,6 +944,111 @@ const std::vector<BufferList>& BufferMgr::getSlabSegments() {
   return slab_segments_;
 }
 
+void BufferMgr::setEvictionPolicy(std::unique_ptr<EvictionPolicy> eviction_policy) {
+  CHECK(eviction_policy);
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+  eviction_policy_ = std::move(eviction_policy);
+}
+
+size_t BufferMgr::compact() {
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+  size_t num_pages_moved = 0;
+  for (size_t slab_num = 0; slab_num < slab_segments_.size(); ++slab_num) {
+    num_pages_moved += compactSlab(slab_num);
+  }
+  LOG(INFO) << "Compacted " << slab_segments_.size() << " slabs, moved "
+            << num_pages_moved << " pages " << getStringMgrType() << ":" << device_id_;
+  return num_pages_moved;
+}
+
+size_t BufferMgr::compactSlab(const size_t slab_num) {
+  CHECK_LT(slab_num, slab_segments_.size());
+  auto& segments = slab_segments_[slab_num];
+  size_t num_slab_pages = 0;
+  for (const auto& segment : segments) {
+    num_slab_pages += segment.num_pages;
+  }
+  size_t next_page = 0;
+  size_t num_pages_moved = 0;
+  for (auto seg_it = segments.begin(); seg_it != segments.end();) {
+    if (seg_it->mem_status == FREE) {
+      seg_it = segments.erase(seg_it);
+      continue;
+    }
+    const auto start_page = static_cast<size_t>(seg_it->start_page);
+    CHECK_GE(start_page, next_page);
+    if (start_page > next_page) {
+      if (seg_it->buffer && seg_it->buffer->getPinCount() < 1) {
+        // Segments are visited in page order, so the move only ever overlaps memory of
+        // the segment itself
+        int8_t* dst = slabs_[slab_num] + next_page * page_size_;
+        moveMemory(dst,
+                   slabs_[slab_num] + start_page * page_size_,
+                   seg_it->num_pages * page_size_);
+        seg_it->buffer->mem_ = dst;
+        seg_it->start_page = next_page;
+        num_pages_moved += seg_it->num_pages;
+      } else {
+        // pinned buffers stay in place, keep the gap in front of them
+        segments.insert(seg_it, BufferSeg(next_page, start_page - next_page, FREE));
+      }
+    }
+    next_page = seg_it->start_page + seg_it->num_pages;
+    ++seg_it;
+  }
+  if (next_page < num_slab_pages) {
+    segments.push_back(BufferSeg(next_page, num_slab_pages - next_page, FREE));
+  }
+  return num_pages_moved;
+}
+
+double BufferMgr::getFragmentationRatio() {
+  std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
+  return computeFragmentationRatio();
+}
+
+double BufferMgr::computeFragmentationRatio() const {
+  size_t total_free_pages = 0;
+  size_t max_free_pages = 0;
+  for (const auto& segments : slab_segments_) {
+    for (const auto& segment : segments) {
+      if (segment.mem_status == FREE) {
+        total_free_pages += segment.num_pages;
+        max_free_pages = std::max(max_free_pages, segment.num_pages);
+      }
+    }
+  }
+  return total_free_pages
+             ? 1.0 - static_cast<double>(max_free_pages) / total_free_pages
+             : 0.0;
+}
+
+std::string BufferMgr::getEvictionPolicyName() const {
+  CHECK(eviction_policy_);
+  return eviction_policy_->getName();
+}
+
+void BufferMgr::setResidentColumns(const int db_id,
+                                   const int tb_id,
+                                   const std::set<int>& column_ids) {
+  std::lock_guard<std::mutex> resident_columns_lock(resident_columns_mutex_);
+  if (column_ids.empty()) {
+    resident_columns_.erase({db_id, tb_id});
+  } else {
+    resident_columns_[{db_id, tb_id}] = column_ids;
+  }
+}
+
+bool BufferMgr::isResident(const ChunkKey& chunk_key) const {
+  if (resident_columns_.empty() || chunk_key.size() < 3) {
+    return false;
+  }
+  const auto it = resident_columns_.find({chunk_key[0], chunk_key[1]});
+  return it != resident_columns_.end() && it->second.count(chunk_key[2]);
+}
+
 void BufferMgr::removeTableRelatedDS(const int db_id, const int table_id) {
   UNREACHABLE();
 }
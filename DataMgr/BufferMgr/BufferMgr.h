@@ -26,16 +26,20 @@
 
 #define BOOST_STACKTRACE_GNU_SOURCE_NOT_REQUIRED 1
 
+#include <atomic>
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <set>
 
 #include <boost/stacktrace.hpp>
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/BufferMgr/BufferSeg.h"
+#include "DataMgr/BufferMgr/EvictionPolicy.h"
 #include "Shared/types.h"
 
 class OutOfMemory : public std::runtime_error {
@@ -127,6 +131,32 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   bool isAllocationCapped() override;
   const std::vector<BufferList>& getSlabSegments();
 
+  /// Replaces the policy used to pick which unpinned buffers to evict (LRU by default).
+  void setEvictionPolicy(std::unique_ptr<EvictionPolicy> eviction_policy);
+  std::string getEvictionPolicyName() const;
+
+  /// Exempts the chunks of column_ids of table tb_id of database db_id from eviction,
+  /// replacing the columns set for the table before. No columns releases the table.
+  void setResidentColumns(const int db_id,
+                          const int tb_id,
+                          const std::set<int>& column_ids);
+
+  /// Buffer pool lookups that found the chunk resident / had to fetch it from the parent
+  size_t getNumHits() const { return num_hits_; }
+  size_t getNumMisses() const { return num_misses_; }
+  /// Number of chunks evicted from the pool to make room for others
+  size_t getNumEvictions() const { return num_evictions_; }
+
+  /**
+   * @brief Moves unpinned buffers towards the start of their slab so that the free pages
+   * of each slab coalesce into a single segment at its end.
+   *
+   * @return The number of pages moved.
+   */
+  size_t compact();
+  /// 1 - (largest free segment / total free pages), 0 if free memory is contiguous
+  double getFragmentationRatio();
+
   /// Creates a chunk with the specified key and page size.
   AbstractBuffer* createBuffer(const ChunkKey& key,
                                const size_t page_size = 0,
@@ -190,7 +220,18 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   BufferList::iterator findFreeBufferInSlab(const size_t slab_num,
                                             const size_t num_pages_requested);
   int getBufferId();
-  virtual void addSlab(const size_t slab_size) = 0;
+  size_t compactSlab(const size_t slab_num);
+  double computeFragmentationRatio() const;
+  /// Whether the chunk belongs to a resident column, resident_columns_mutex_ held
+  bool isResident(const ChunkKey& chunk_key) const;
+  /// Copies num_bytes from src to dst within this device; dst < src and may overlap
+  virtual void moveMemory(int8_t* dst, int8_t* src, const size_t num_bytes) = 0;
+  /// Allocates a new slab, placing its memory on numa_node when that is not -1
+  virtual void addSlab(const size_t slab_size, const int numa_node) = 0;
+  /// NUMA node the chunk should be placed on, or -1 if the manager is not NUMA aware
+  virtual int getNumaNode(const ChunkKey& chunk_key) const { return -1; }
+  /// NUMA node the slab's memory is bound to, or -1 if the manager is not NUMA aware
+  virtual int getSlabNumaNode(const size_t slab_num) const { return -1; }
   virtual void freeAllMem() = 0;
   virtual void allocateBuffer(BufferList::iterator seg_it,
                               const size_t page_size,
@@ -200,8 +241,11 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   std::mutex unsized_segs_mutex_;
   std::mutex buffer_id_mutex_;
   std::mutex global_mutex_;
+  std::mutex resident_columns_mutex_;
 
   std::map<ChunkKey, BufferList::iterator> chunk_index_;
+  // the resident columns of the tables, by database and table id
+  std::map<std::pair<int, int>, std::set<int>> resident_columns_;
   size_t max_buffer_pool_num_pages_;  // max number of pages for buffer pool
   size_t num_pages_allocated_;
   size_t min_num_pages_per_slab_;
@@ -214,6 +258,11 @@ class BufferMgr : public AbstractBufferMgr {  // implements
 
   BufferList unsized_segs_;
 
+  std::unique_ptr<EvictionPolicy> eviction_policy_;
+  std::atomic<size_t> num_hits_;
+  std::atomic<size_t> num_misses_;
+  std::atomic<size_t> num_evictions_;
+
   BufferList::iterator evict(BufferList::iterator& evict_start,
                              const size_t num_pages_requested,
                              const int slab_num);
@@ -225,12 +274,15 @@ class BufferMgr : public AbstractBufferMgr {  // implements
    * non-pinned but used buffers as needed to have enough space for the
    * buffer
    *
+   * Free space in slabs on numa_node is preferred, followed by a new slab on that
+   * node, before free space on other nodes is used.
+   *
    * @return An iterator to the reserved buffer. We guarantee that this
    * buffer won't be evicted by PINNING it - caller should change this to
    * USED if applicable
    *
    */
-  BufferList::iterator findFreeBuffer(size_t num_bytes);
+  BufferList::iterator findFreeBuffer(size_t num_bytes, const int numa_node);
 };
 
 }  // namespace Buffer_Namespace
@@ -19,18 +19,55 @@
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/Allocators/ArenaAllocator.h"
 #include "DataMgr/BufferMgr/CpuBufferMgr/CpuBuffer.h"
+#include "Shared/numa.h"
+
+#include <cstring>
 
 namespace Buffer_Namespace {
 
-void CpuBufferMgr::addSlab(const size_t slab_size) {
+void CpuBufferMgr::moveMemory(int8_t* dst, int8_t* src, const size_t num_bytes) {
+  memmove(dst, src, num_bytes);
+}
+
+void CpuBufferMgr::addSlab(const size_t slab_size, const int numa_node) {
   CHECK(allocator_);
+  int slab_node = -1;
+  if (num_numa_nodes_ > 1) {
+    // buffers without a fragment (e.g. query scratch space) are spread round robin
+    slab_node = numa_node >= 0 ? numa_node : slabs_.size() % num_numa_nodes_;
+  }
   slabs_.resize(slabs_.size() + 1);
-  try {
-    slabs_.back() = reinterpret_cast<int8_t*>(allocator_->allocate(slab_size));
-  } catch (std::bad_alloc&) {
-    slabs_.resize(slabs_.size() - 1);
-    throw FailedToCreateSlab(slab_size);
+  if (use_pinned_slabs_) {
+    CHECK(cuda_mgr_);
+    try {
+      slabs_.back() = cuda_mgr_->allocatePinnedHostMem(slab_size);
+    } catch (std::runtime_error& e) {
+      LOG(WARNING) << "Failed to allocate pinned CPU slab of " << slab_size
+                   << " bytes: " << e.what();
+      slabs_.resize(slabs_.size() - 1);
+      throw FailedToCreateSlab(slab_size);
+    }
+    pinned_slabs_.push_back(slabs_.back());
+    if (slab_node >= 0 && !numa::bind_to_node(slabs_.back(), slab_size, slab_node)) {
+      LOG(WARNING) << "Failed to bind pinned CPU slab to NUMA node " << slab_node;
+    }
+  } else if (slab_node >= 0) {
+    slabs_.back() =
+        reinterpret_cast<int8_t*>(numa::allocate_on_node(slab_size, slab_node));
+    if (!slabs_.back()) {
+      slabs_.resize(slabs_.size() - 1);
+      throw FailedToCreateSlab(slab_size);
+    }
+    numa_slabs_.emplace_back(slabs_.back(), slab_size);
+  } else {
+    try {
+      slabs_.back() = reinterpret_cast<int8_t*>(allocator_->allocate(slab_size));
+    } catch (std::bad_alloc&) {
+      slabs_.resize(slabs_.size() - 1);
+      throw FailedToCreateSlab(slab_size);
+    }
   }
+  slab_numa_nodes_.push_back(slab_node);
   slab_segments_.resize(slab_segments_.size() + 1);
   slab_segments_[slab_segments_.size() - 1].push_back(
       BufferSeg(0, slab_size / page_size_));
@@ -39,6 +76,40 @@ void CpuBufferMgr::addSlab(const size_t slab_size) {
 void CpuBufferMgr::freeAllMem() {
   CHECK(allocator_);
   allocator_.reset(new Arena(max_slab_size_ + kArenaBlockOverhead));
+  freePinnedSlabs();
+  freeNumaSlabs();
+  slab_numa_nodes_.clear();
+}
+
+void CpuBufferMgr::freeNumaSlabs() {
+  for (const auto& [slab, slab_size] : numa_slabs_) {
+    numa::free_on_node(slab, slab_size);
+  }
+  numa_slabs_.clear();
+}
+
+int CpuBufferMgr::getNumaNode(const ChunkKey& chunk_key) const {
+  // keys of scratch buffers created through alloc() start with -1
+  if (num_numa_nodes_ < 2 || chunk_key.size() <= CHUNK_KEY_FRAGMENT_IDX ||
+      chunk_key[0] < 0) {
+    return -1;
+  }
+  return numa::get_node_for_fragment(chunk_key[CHUNK_KEY_FRAGMENT_IDX], num_numa_nodes_);
+}
+
+int CpuBufferMgr::getSlabNumaNode(const size_t slab_num) const {
+  return slab_num < slab_numa_nodes_.size() ? slab_numa_nodes_[slab_num] : -1;
+}
+
+void CpuBufferMgr::freePinnedSlabs() {
+  if (pinned_slabs_.empty()) {
+    return;
+  }
+  CHECK(cuda_mgr_);
+  for (auto slab : pinned_slabs_) {
+    cuda_mgr_->freePinnedHostMem(slab);
+  }
+  pinned_slabs_.clear();
 }
 
 void CpuBufferMgr::allocateBuffer(BufferList::iterator seg_it,
@@ -34,7 +34,9 @@ class CpuBufferMgr : public BufferMgr {
                const size_t min_slab_size,
                const size_t max_slab_size,
                const size_t page_size,
-               AbstractBufferMgr* parent_mgr = nullptr)
+               AbstractBufferMgr* parent_mgr = nullptr,
+               const bool use_pinned_slabs = false,
+               const size_t num_numa_nodes = 1)
       : BufferMgr(device_id,
                   max_buffer_pool_size,
                   min_slab_size,
@@ -42,24 +44,45 @@ class CpuBufferMgr : public BufferMgr {
                   page_size,
                   parent_mgr)
       , cuda_mgr_(cuda_mgr)
+      , use_pinned_slabs_(use_pinned_slabs && cuda_mgr)
+      , num_numa_nodes_(std::max(num_numa_nodes, size_t(1)))
       , allocator_(std::make_unique<Arena>(/*min_block_size=*/max_slab_size +
                                            kArenaBlockOverhead)) {}
 
   ~CpuBufferMgr() {
-    /* the destruction of the allocator automatically frees all memory */
+    /* the destruction of the allocator automatically frees all arena memory */
+    freePinnedSlabs();
+    freeNumaSlabs();
   }
 
+  bool usesPinnedSlabs() const { return use_pinned_slabs_; }
+  size_t getNumNumaNodes() const { return num_numa_nodes_; }
+
   inline MgrType getMgrType() override { return CPU_MGR; }
   inline std::string getStringMgrType() override { return ToString(CPU_MGR); }
 
  private:
-  void addSlab(const size_t slab_size) override;
+  void moveMemory(int8_t* dst, int8_t* src, const size_t num_bytes) override;
+  void addSlab(const size_t slab_size, const int numa_node) override;
   void freeAllMem() override;
   void allocateBuffer(BufferList::iterator segment_iter,
                       const size_t page_size,
                       const size_t initial_size) override;
+  void freePinnedSlabs();
+  void freeNumaSlabs();
+  int getNumaNode(const ChunkKey& chunk_key) const override;
+  int getSlabNumaNode(const size_t slab_num) const override;
 
   CudaMgr_Namespace::CudaMgr* cuda_mgr_;
+  // Slabs are page-locked through the CUDA driver so host to device copies of chunks can
+  // DMA directly from the buffer pool instead of going through a pageable bounce buffer.
+  const bool use_pinned_slabs_;
+  std::vector<int8_t*> pinned_slabs_;
+  // With more than one node, slabs are bound to a node and chunks are placed on the node
+  // of their fragment so that kernels pinned to that node scan local memory.
+  const size_t num_numa_nodes_;
+  std::vector<int> slab_numa_nodes_;  // indexed by slab number
+  std::vector<std::pair<int8_t*, size_t>> numa_slabs_;
   std::unique_ptr<Arena> allocator_;
 };
 
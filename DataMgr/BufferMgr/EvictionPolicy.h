@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "DataMgr/BufferMgr/BufferSeg.h"
+
+namespace Buffer_Namespace {
+
+/**
+ * Ranks used segments for eviction. BufferMgr evicts the contiguous run of unpinned
+ * segments whose highest score is the lowest, so a policy only has to map a segment's
+ * access history to a number: lower means colder.
+ */
+class EvictionPolicy {
+ public:
+  virtual ~EvictionPolicy() = default;
+
+  virtual size_t getEvictionScore(const BufferSeg& seg) const = 0;
+
+  virtual std::string getName() const = 0;
+};
+
+/**
+ * Least recently touched segments are evicted first.
+ */
+class LruEvictionPolicy : public EvictionPolicy {
+ public:
+  size_t getEvictionScore(const BufferSeg& seg) const override {
+    return seg.last_touched;
+  }
+
+  std::string getName() const override { return "lru"; }
+};
+
+/**
+ * LRU-2: segments are ranked by their second most recent touch, so chunks brought in by
+ * a single large scan (touched once) are evicted before the working set that is reused
+ * across queries. Ties, including all once-touched segments, fall back to LRU order.
+ */
+class Lru2EvictionPolicy : public EvictionPolicy {
+ public:
+  size_t getEvictionScore(const BufferSeg& seg) const override {
+    return (static_cast<size_t>(seg.prev_touched) << 32) | seg.last_touched;
+  }
+
+  std::string getName() const override { return "lru2"; }
+};
+
+inline std::unique_ptr<EvictionPolicy> makeEvictionPolicy(const std::string& name) {
+  if (name == "lru") {
+    return std::make_unique<LruEvictionPolicy>();
+  }
+  if (name == "lru2") {
+    return std::make_unique<Lru2EvictionPolicy>();
+  }
+  throw std::runtime_error("Unknown buffer pool eviction policy '" + name +
+                           "'. Supported policies are: lru, lru2.");
+}
+
+}  // namespace Buffer_Namespace
@@ -20,6 +20,8 @@
 #include "DataMgr/BufferMgr/GpuCudaBufferMgr/GpuCudaBuffer.h"
 #include "Logger/Logger.h"
 
+#include <algorithm>
+
 namespace Buffer_Namespace {
 
 GpuCudaBufferMgr::GpuCudaBufferMgr(const int device_id,
@@ -53,7 +55,21 @@ GpuCudaBufferMgr::~GpuCudaBufferMgr() {
   }
 }
 
-void GpuCudaBufferMgr::addSlab(const size_t slab_size) {
+void GpuCudaBufferMgr::moveMemory(int8_t* dst, int8_t* src, const size_t num_bytes) {
+  CHECK_LT(dst, src);
+  // device to device copies must not overlap, so move in steps no larger than the
+  // distance between source and destination
+  const size_t step = src - dst;
+  for (size_t offset = 0; offset < num_bytes; offset += step) {
+    cuda_mgr_->copyDeviceToDevice(dst + offset,
+                                  src + offset,
+                                  std::min(step, num_bytes - offset),
+                                  device_id_,
+                                  device_id_);
+  }
+}
+
+void GpuCudaBufferMgr::addSlab(const size_t slab_size, const int /* numa_node */) {
   slabs_.resize(slabs_.size() + 1);
   try {
     slabs_.back() = cuda_mgr_->allocateDeviceMem(slab_size, device_id_);
@@ -38,7 +38,8 @@ class GpuCudaBufferMgr : public BufferMgr {
   ~GpuCudaBufferMgr() override;
 
  private:
-  void addSlab(const size_t slab_size) override;
+  void moveMemory(int8_t* dst, int8_t* src, const size_t num_bytes) override;
+  void addSlab(const size_t slab_size, const int numa_node) override;
   void freeAllMem() override;
   void allocateBuffer(BufferList::iterator seg_it,
                       const size_t page_size,
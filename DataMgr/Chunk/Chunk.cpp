@@ -21,8 +21,15 @@
 
 #include "DataMgr/Chunk/Chunk.h"
 #include "DataMgr/ArrayNoneEncoder.h"
+#include "DataMgr/DiffEncoder.h"
 #include "DataMgr/FixedLengthArrayNoneEncoder.h"
 #include "DataMgr/StringNoneEncoder.h"
+#include "Shared/DateConverters.h"
+#include "Shared/geo_compression_runtime.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
 
 namespace Chunk_NS {
 std::shared_ptr<Chunk> Chunk::getChunk(const ColumnDescriptor* cd,
@@ -125,6 +132,448 @@ void Chunk::createChunkBuffer(DataMgr* data_mgr,
   }
 }
 
+namespace {
+
+template <typename T>
+size_t get_num_elems_in_diff_range(Encoder* encoder,
+                                   const int encoded_size,
+                                   const int8_t* src_data,
+                                   const size_t num_elems) {
+  switch (encoded_size) {
+    case 1: {
+      auto diff_encoder = dynamic_cast<DiffEncoder<T, int8_t>*>(encoder);
+      CHECK(diff_encoder);
+      return diff_encoder->getNumElemsInRange(src_data, num_elems);
+    }
+    case 2: {
+      auto diff_encoder = dynamic_cast<DiffEncoder<T, int16_t>*>(encoder);
+      CHECK(diff_encoder);
+      return diff_encoder->getNumElemsInRange(src_data, num_elems);
+    }
+    case 4: {
+      auto diff_encoder = dynamic_cast<DiffEncoder<T, int32_t>*>(encoder);
+      CHECK(diff_encoder);
+      return diff_encoder->getNumElemsInRange(src_data, num_elems);
+    }
+    default:
+      CHECK(false);
+      return 0;
+  }
+}
+
+}  // namespace
+
+size_t Chunk::getNumElemsInEncodingRange(const DataBlockPtr& src_data,
+                                         const size_t num_elems) {
+  const auto& ti = column_desc_->columnType;
+  CHECK_EQ(kENCODING_DIFF, ti.get_compression());
+  switch (ti.get_logical_size()) {
+    case 2:
+      return get_num_elems_in_diff_range<int16_t>(
+          buffer_->encoder.get(), ti.get_size(), src_data.numbersPtr, num_elems);
+    case 4:
+      return get_num_elems_in_diff_range<int32_t>(
+          buffer_->encoder.get(), ti.get_size(), src_data.numbersPtr, num_elems);
+    case 8:
+      return get_num_elems_in_diff_range<int64_t>(
+          buffer_->encoder.get(), ti.get_size(), src_data.numbersPtr, num_elems);
+    default:
+      CHECK(false);
+      return 0;
+  }
+}
+
+namespace {
+
+// The values of an integer or time chunk held in CPU memory, as stored: value * scale +
+// reference is in the units of the chunk stats. Nulls are stored as the minimum of the
+// stored type for every encoding used here.
+struct StoredValues {
+  const int8_t* data;
+  size_t width;
+  int64_t reference;
+  int64_t scale;
+};
+
+std::optional<StoredValues> get_stored_values(const SQLTypeInfo& ti,
+                                              Data_Namespace::AbstractBuffer* buffer) {
+  if (!(ti.is_integer() || ti.is_time()) || !buffer ||
+      buffer->getType() != Data_Namespace::CPU_LEVEL) {
+    return std::nullopt;
+  }
+  const auto data = buffer->getMemoryPtr();
+  const size_t width = ti.get_size();
+  switch (ti.get_compression()) {
+    case kENCODING_NONE:
+    case kENCODING_FIXED:
+      return StoredValues{data, width, 0, 1};
+    case kENCODING_DATE_IN_DAYS:
+      return StoredValues{data, width, 0, kSecsPerDay};
+    case kENCODING_DIFF: {
+      if (buffer->size() < kDiffEncodingHeaderSize) {
+        return std::nullopt;
+      }
+      const auto reference = *reinterpret_cast<const int64_t*>(data);
+      return StoredValues{data + kDiffEncodingHeaderSize, width, reference, 1};
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+template <typename V>
+std::shared_ptr<ChunkBlockStats> build_block_stats(const V* data,
+                                                   const size_t rows_per_block,
+                                                   const size_t num_elems,
+                                                   const int64_t reference,
+                                                   const int64_t scale) {
+  auto block_stats = std::make_shared<ChunkBlockStats>();
+  block_stats->rowsPerBlock = rows_per_block;
+  block_stats->numElements = num_elems;
+  block_stats->sorted = std::is_sorted(data, data + num_elems);
+  const auto num_blocks = (num_elems + rows_per_block - 1) / rows_per_block;
+  block_stats->min.resize(num_blocks, std::numeric_limits<int64_t>::max());
+  block_stats->max.resize(num_blocks, std::numeric_limits<int64_t>::min());
+  block_stats->hasNulls.resize(num_blocks, false);
+  for (size_t block = 0; block < num_blocks; ++block) {
+    const auto end = std::min(num_elems, (block + 1) * rows_per_block);
+    V min = std::numeric_limits<V>::max();
+    V max = std::numeric_limits<V>::min();
+    bool has_nulls{false};
+    for (size_t i = block * rows_per_block; i < end; ++i) {
+      if (data[i] == std::numeric_limits<V>::min()) {
+        has_nulls = true;
+        continue;
+      }
+      min = std::min(min, data[i]);
+      max = std::max(max, data[i]);
+    }
+    block_stats->hasNulls[block] = has_nulls;
+    if (min <= max) {
+      block_stats->min[block] = static_cast<int64_t>(min) * scale + reference;
+      block_stats->max[block] = static_cast<int64_t>(max) * scale + reference;
+    }
+  }
+  return block_stats;
+}
+
+template <typename V>
+std::pair<size_t, size_t> get_sorted_row_range(const V* data,
+                                               const size_t num_elems,
+                                               const int64_t reference,
+                                               const int64_t scale,
+                                               const SQLOps optype,
+                                               const int64_t value) {
+  const auto end = data + num_elems;
+  // the nulls are the smallest values, so they come first
+  const auto non_null = std::upper_bound(data, end, std::numeric_limits<V>::min());
+  const auto lower = std::partition_point(non_null, end, [&](const V stored) {
+    return static_cast<int64_t>(stored) * scale + reference < value;
+  });
+  const auto upper = std::partition_point(lower, end, [&](const V stored) {
+    return static_cast<int64_t>(stored) * scale + reference <= value;
+  });
+  const size_t non_null_row = non_null - data;
+  const size_t lower_row = lower - data;
+  const size_t upper_row = upper - data;
+  switch (optype) {
+    case kEQ:
+      return {lower_row, upper_row};
+    case kGE:
+      return {lower_row, num_elems};
+    case kGT:
+      return {upper_row, num_elems};
+    case kLE:
+      return {non_null_row, upper_row};
+    case kLT:
+      return {non_null_row, lower_row};
+    default:
+      return {0, num_elems};
+  }
+}
+
+template <typename V>
+void decode_stored_values(const V* data,
+                          const size_t begin,
+                          const size_t end,
+                          const int64_t reference,
+                          const int64_t scale,
+                          int64_t* decoded) {
+  for (size_t i = begin; i < end; ++i) {
+    decoded[i - begin] = data[i] == std::numeric_limits<V>::min()
+                             ? std::numeric_limits<int64_t>::min()
+                             : static_cast<int64_t>(data[i]) * scale + reference;
+  }
+}
+
+}  // namespace
+
+bool Chunk::decodeValues(const size_t begin,
+                         const size_t end,
+                         std::vector<int64_t>& values) const {
+  CHECK_LE(begin, end);
+  const auto& ti = column_desc_->columnType;
+  auto stored = get_stored_values(ti, buffer_);
+  if (!stored && buffer_ && buffer_->getType() == Data_Namespace::CPU_LEVEL &&
+      ((ti.is_decimal() && (ti.get_compression() == kENCODING_NONE ||
+                            ti.get_compression() == kENCODING_FIXED)) ||
+       (ti.is_dict_encoded_string() && ti.get_size() == sizeof(int32_t)))) {
+    // the nulls of these are the minimum of the stored type too
+    stored = StoredValues{
+        buffer_->getMemoryPtr(), static_cast<size_t>(ti.get_size()), 0, 1};
+  }
+  if (!stored ||
+      stored->data + end * stored->width > buffer_->getMemoryPtr() + buffer_->size()) {
+    return false;
+  }
+  values.resize(end - begin);
+  switch (stored->width) {
+    case 1:
+      decode_stored_values(
+          stored->data, begin, end, stored->reference, stored->scale, values.data());
+      break;
+    case 2:
+      decode_stored_values(reinterpret_cast<const int16_t*>(stored->data),
+                           begin,
+                           end,
+                           stored->reference,
+                           stored->scale,
+                           values.data());
+      break;
+    case 4:
+      decode_stored_values(reinterpret_cast<const int32_t*>(stored->data),
+                           begin,
+                           end,
+                           stored->reference,
+                           stored->scale,
+                           values.data());
+      break;
+    case 8:
+      decode_stored_values(reinterpret_cast<const int64_t*>(stored->data),
+                           begin,
+                           end,
+                           stored->reference,
+                           stored->scale,
+                           values.data());
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+std::shared_ptr<const ChunkBlockStats> Chunk::getBlockStats(
+    const std::shared_ptr<ChunkMetadata>& chunk_metadata,
+    const size_t rows_per_block) const {
+  CHECK_GT(rows_per_block, size_t(0));
+  auto block_stats = std::atomic_load(&chunk_metadata->blockStats);
+  if (block_stats && block_stats->rowsPerBlock == rows_per_block &&
+      block_stats->numElements == chunk_metadata->numElements) {
+    return block_stats;
+  }
+  const auto values = get_stored_values(column_desc_->columnType, buffer_);
+  if (!values) {
+    return nullptr;
+  }
+  const auto num_elems = chunk_metadata->numElements;
+  switch (values->width) {
+    case 1:
+      block_stats = build_block_stats(
+          values->data, rows_per_block, num_elems, values->reference, values->scale);
+      break;
+    case 2:
+      block_stats = build_block_stats(reinterpret_cast<const int16_t*>(values->data),
+                                      rows_per_block,
+                                      num_elems,
+                                      values->reference,
+                                      values->scale);
+      break;
+    case 4:
+      block_stats = build_block_stats(reinterpret_cast<const int32_t*>(values->data),
+                                      rows_per_block,
+                                      num_elems,
+                                      values->reference,
+                                      values->scale);
+      break;
+    case 8:
+      block_stats = build_block_stats(reinterpret_cast<const int64_t*>(values->data),
+                                      rows_per_block,
+                                      num_elems,
+                                      values->reference,
+                                      values->scale);
+      break;
+    default:
+      return nullptr;
+  }
+  std::atomic_store(&chunk_metadata->blockStats, block_stats);
+  return block_stats;
+}
+
+std::shared_ptr<const ChunkBlockBounds> Chunk::getBlockBounds(
+    const std::shared_ptr<ChunkMetadata>& chunk_metadata,
+    const size_t rows_per_block) const {
+  CHECK_GT(rows_per_block, size_t(0));
+  auto block_bounds = std::atomic_load(&chunk_metadata->blockBounds);
+  if (block_bounds && block_bounds->rowsPerBlock == rows_per_block &&
+      block_bounds->numElements == chunk_metadata->numElements) {
+    return block_bounds;
+  }
+  // the coords of a point are the only fixed length arrays among the physical columns,
+  // two doubles or two 32 bit integers for the compressed longitudes and latitudes
+  const auto& ti = column_desc_->columnType;
+  const auto num_elems = chunk_metadata->numElements;
+  if (!column_desc_->isGeoPhyCol || !ti.is_fixlen_array() ||
+      (ti.get_size() != 2 * sizeof(double) && ti.get_size() != 2 * sizeof(int32_t)) ||
+      !buffer_ || buffer_->getType() != Data_Namespace::CPU_LEVEL ||
+      buffer_->size() < num_elems * ti.get_size()) {
+    return nullptr;
+  }
+  const bool compressed = ti.get_size() == 2 * sizeof(int32_t);
+  const auto data = buffer_->getMemoryPtr();
+  auto new_block_bounds = std::make_shared<ChunkBlockBounds>();
+  new_block_bounds->rowsPerBlock = rows_per_block;
+  new_block_bounds->numElements = num_elems;
+  const auto num_blocks = (num_elems + rows_per_block - 1) / rows_per_block;
+  new_block_bounds->xMin.resize(num_blocks, std::numeric_limits<double>::max());
+  new_block_bounds->yMin.resize(num_blocks, std::numeric_limits<double>::max());
+  new_block_bounds->xMax.resize(num_blocks, std::numeric_limits<double>::lowest());
+  new_block_bounds->yMax.resize(num_blocks, std::numeric_limits<double>::lowest());
+  for (size_t i = 0; i < num_elems; ++i) {
+    double x;
+    double y;
+    if (compressed) {
+      const auto coords = reinterpret_cast<const int32_t*>(data) + 2 * i;
+      if (Geo_namespace::is_null_point_longitude_geoint32(coords[0])) {
+        continue;
+      }
+      x = Geo_namespace::decompress_longitude_coord_geoint32(coords[0]);
+      y = Geo_namespace::decompress_lattitude_coord_geoint32(coords[1]);
+    } else {
+      const auto coords = reinterpret_cast<const double*>(data) + 2 * i;
+      if (coords[0] == NULL_ARRAY_DOUBLE) {
+        continue;
+      }
+      x = coords[0];
+      y = coords[1];
+    }
+    const auto block = i / rows_per_block;
+    new_block_bounds->xMin[block] = std::min(new_block_bounds->xMin[block], x);
+    new_block_bounds->yMin[block] = std::min(new_block_bounds->yMin[block], y);
+    new_block_bounds->xMax[block] = std::max(new_block_bounds->xMax[block], x);
+    new_block_bounds->yMax[block] = std::max(new_block_bounds->yMax[block], y);
+  }
+  block_bounds = new_block_bounds;
+  std::atomic_store(&chunk_metadata->blockBounds, block_bounds);
+  return block_bounds;
+}
+
+std::pair<size_t, size_t> Chunk::getSortedRowRange(const size_t num_elems,
+                                                   const SQLOps optype,
+                                                   const int64_t value) const {
+  const auto values = get_stored_values(column_desc_->columnType, buffer_);
+  CHECK(values);
+  switch (values->width) {
+    case 1:
+      return get_sorted_row_range(
+          values->data, num_elems, values->reference, values->scale, optype, value);
+    case 2:
+      return get_sorted_row_range(reinterpret_cast<const int16_t*>(values->data),
+                                  num_elems,
+                                  values->reference,
+                                  values->scale,
+                                  optype,
+                                  value);
+    case 4:
+      return get_sorted_row_range(reinterpret_cast<const int32_t*>(values->data),
+                                  num_elems,
+                                  values->reference,
+                                  values->scale,
+                                  optype,
+                                  value);
+    case 8:
+      return get_sorted_row_range(reinterpret_cast<const int64_t*>(values->data),
+                                  num_elems,
+                                  values->reference,
+                                  values->scale,
+                                  optype,
+                                  value);
+    default:
+      CHECK(false);
+      return {0, num_elems};
+  }
+}
+
+namespace {
+
+template <typename T>
+void add_to_bloom_filter(ChunkBloomFilter& bloom_filter,
+                         const T* data,
+                         const size_t num_elems,
+                         const bool is_date_in_days) {
+  for (size_t i = 0; i < num_elems; ++i) {
+    // the days stored for a date are compared in seconds, as in the chunk stats
+    bloom_filter.add(is_date_in_days ? DateConverters::get_epoch_seconds_from_days(
+                                           DateConverters::get_epoch_days_from_seconds(
+                                               static_cast<int64_t>(data[i])))
+                                     : static_cast<int64_t>(data[i]));
+  }
+}
+
+}  // namespace
+
+void Chunk::addToBloomFilter(ChunkBloomFilter& bloom_filter,
+                             const DataBlockPtr& src_data,
+                             const size_t num_elems) const {
+  const auto& ti = column_desc_->columnType;
+  CHECK(ChunkBloomFilter::supportsType(ti));
+  const auto data = src_data.numbersPtr;
+  const bool is_date_in_days = ti.get_compression() == kENCODING_DATE_IN_DAYS;
+  if (ti.is_dict_encoded_string()) {
+    // string ids are inserted in the width of the chunk, unsigned if narrow
+    switch (ti.get_size()) {
+      case 1:
+        add_to_bloom_filter(
+            bloom_filter, reinterpret_cast<const uint8_t*>(data), num_elems, false);
+        return;
+      case 2:
+        add_to_bloom_filter(
+            bloom_filter, reinterpret_cast<const uint16_t*>(data), num_elems, false);
+        return;
+      case 4:
+        add_to_bloom_filter(
+            bloom_filter, reinterpret_cast<const int32_t*>(data), num_elems, false);
+        return;
+      default:
+        CHECK(false);
+    }
+  }
+  switch (ti.get_logical_size()) {
+    case 1:
+      add_to_bloom_filter(bloom_filter, data, num_elems, is_date_in_days);
+      return;
+    case 2:
+      add_to_bloom_filter(bloom_filter,
+                          reinterpret_cast<const int16_t*>(data),
+                          num_elems,
+                          is_date_in_days);
+      return;
+    case 4:
+      add_to_bloom_filter(bloom_filter,
+                          reinterpret_cast<const int32_t*>(data),
+                          num_elems,
+                          is_date_in_days);
+      return;
+    case 8:
+      add_to_bloom_filter(bloom_filter,
+                          reinterpret_cast<const int64_t*>(data),
+                          num_elems,
+                          is_date_in_days);
+      return;
+    default:
+      CHECK(false);
+  }
+}
+
 size_t Chunk::getNumElemsForBytesInsertData(const DataBlockPtr& src_data,
                                             const size_t num_elems,
                                             const size_t start_idx,
@@ -29,6 +29,7 @@
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/ChunkMetadata.h"
 #include "DataMgr/DataMgr.h"
+#include "Shared/sqldefs.h"
 #include "Shared/sqltypes.h"
 #include "Utils/ChunkIter.h"
 
@@ -70,6 +71,56 @@ class Chunk {
                                        const size_t byte_limit,
                                        const bool replicating = false);
 
+  /**
+   * Number of the next num_elems values of src_data which fit the encoding range of the
+   * chunk, for encodings whose chunks can hold a limited range of values only (DIFF).
+   */
+  size_t getNumElemsInEncodingRange(const DataBlockPtr& src_data, const size_t num_elems);
+
+  /**
+   * Block zone maps of an integer or time chunk held in CPU memory, built from its data
+   * and cached in chunk_metadata on first use. Returns nullptr for other types.
+   */
+  std::shared_ptr<const ChunkBlockStats> getBlockStats(
+      const std::shared_ptr<ChunkMetadata>& chunk_metadata,
+      const size_t rows_per_block) const;
+
+  /**
+   * Decodes the values of rows [begin, end) of an integer, decimal, time or 32 bit
+   * dictionary encoded string chunk held in CPU memory into values, in the units of the
+   * chunk stats with the nulls as the minimum of int64_t. Returns false for the other
+   * chunks.
+   */
+  bool decodeValues(const size_t begin,
+                    const size_t end,
+                    std::vector<int64_t>& values) const;
+
+  /**
+   * Block bounding boxes of the coords chunk of a POINT column held in CPU memory, built
+   * from its data and cached in chunk_metadata on first use. Returns nullptr for other
+   * chunks.
+   */
+  std::shared_ptr<const ChunkBlockBounds> getBlockBounds(
+      const std::shared_ptr<ChunkMetadata>& chunk_metadata,
+      const size_t rows_per_block) const;
+
+  /**
+   * Rows among the first num_elems of a chunk whose block stats are sorted that can
+   * compare with value as optype requires, found by binary search. value is in the
+   * units of the chunk stats.
+   */
+  std::pair<size_t, size_t> getSortedRowRange(const size_t num_elems,
+                                              const SQLOps optype,
+                                              const int64_t value) const;
+
+  /**
+   * Adds num_elems values to be appended from src_data to bloom_filter, in the units of
+   * the chunk stats. Call before appendData(), which moves src_data forward.
+   */
+  void addToBloomFilter(ChunkBloomFilter& bloom_filter,
+                        const DataBlockPtr& src_data,
+                        const size_t num_elems) const;
+
   std::shared_ptr<ChunkMetadata> appendData(DataBlockPtr& srcData,
                                             const size_t numAppendElems,
                                             const size_t startIdx,
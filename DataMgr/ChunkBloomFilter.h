@@ -0,0 +1,141 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkBloomFilter.h
+ * @brief   Bloom filter of the values of a chunk, for skipping fragments on equality
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Shared/sqltypes.h"
+
+/**
+ * Bloom filter of the values appended to an integer, time or dictionary encoded string
+ * chunk, in the units of the chunk stats (string ids for strings). The chunk's final
+ * size is not known while rows are appended, so the filter is a sequence of segments,
+ * each sized for at least twice the values of the one before. Values are added to the
+ * last segment only.
+ *
+ * Every append to a chunk extends the filter of the chunk's previous metadata into a
+ * new filter that shares the segments. Bits are only ever set, with relaxed atomic
+ * updates, so the filter of the previous metadata stays valid for its rows while the
+ * append sets bits in a shared segment. Appends to a chunk are serialized by its
+ * fragmenter.
+ */
+class ChunkBloomFilter {
+ public:
+  /**
+   * Returns a filter holding the values of filter, or an empty one if filter is null,
+   * whose last segment takes num_values more values at bits_per_value bits each.
+   */
+  static std::shared_ptr<ChunkBloomFilter> extend(
+      const std::shared_ptr<const ChunkBloomFilter>& filter,
+      const size_t num_values,
+      const size_t bits_per_value) {
+    auto extended = filter ? std::make_shared<ChunkBloomFilter>(*filter)
+                           : std::make_shared<ChunkBloomFilter>();
+    auto& segments = extended->segments_;
+    if (segments.empty() ||
+        segments.back()->capacity - segments.back()->numValues < num_values) {
+      const size_t min_capacity =
+          segments.empty() ? kMinSegmentCapacity : 2 * segments.back()->capacity;
+      segments.push_back(std::make_shared<Segment>(std::max(num_values, min_capacity),
+                                                   std::max(bits_per_value, size_t(1))));
+    }
+    return extended;
+  }
+
+  /// Whether chunks of type ti can have a Bloom filter
+  static bool supportsType(const SQLTypeInfo& ti) {
+    return ti.is_integer() || ti.is_time() || ti.is_dict_encoded_string();
+  }
+
+  void add(const int64_t value) {
+    auto& segment = *segments_.back();
+    const auto hash = mix(value);
+    for (size_t i = 0; i < segment.numHashes; ++i) {
+      const auto bit = probe(hash, i, segment.bits.size() * 64);
+      segment.bits[bit / 64].fetch_or(uint64_t(1) << (bit % 64),
+                                      std::memory_order_relaxed);
+    }
+    ++segment.numValues;
+  }
+
+  bool mayContain(const int64_t value) const {
+    const auto hash = mix(value);
+    for (const auto& segment : segments_) {
+      bool all_set{true};
+      for (size_t i = 0; i < segment->numHashes && all_set; ++i) {
+        const auto bit = probe(hash, i, segment->bits.size() * 64);
+        all_set = segment->bits[bit / 64].load(std::memory_order_relaxed) &
+                  (uint64_t(1) << (bit % 64));
+      }
+      if (all_set) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t getNumBytes() const {
+    size_t num_bytes{0};
+    for (const auto& segment : segments_) {
+      num_bytes += segment->bits.size() * sizeof(uint64_t);
+    }
+    return num_bytes;
+  }
+
+ private:
+  struct Segment {
+    Segment(const size_t capacity, const size_t bits_per_value)
+        : bits((capacity * bits_per_value + 63) / 64)
+        , numHashes(std::max(
+              size_t(1),
+              static_cast<size_t>(std::lround(bits_per_value * std::log(2.0)))))
+        , capacity(capacity) {}
+
+    std::vector<std::atomic<uint64_t>> bits;
+    const size_t numHashes;
+    const size_t capacity;
+    size_t numValues{0};  // only accessed by appends
+  };
+
+  static constexpr size_t kMinSegmentCapacity{4096};
+
+  static uint64_t mix(const int64_t value) {
+    // the splitmix64 finalizer
+    auto hash = static_cast<uint64_t>(value);
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+  }
+
+  // double hashing, with an odd step so that the probes of a value differ
+  static uint64_t probe(const uint64_t hash, const size_t i, const uint64_t num_bits) {
+    return (hash + i * ((hash >> 32) | 1)) % num_bits;
+  }
+
+  std::vector<std::shared_ptr<Segment>> segments_;
+};
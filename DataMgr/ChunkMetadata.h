@@ -17,7 +17,10 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+#include <vector>
 #include "../Shared/sqltypes.h"
+#include "DataMgr/ChunkBloomFilter.h"
 #include "Shared/types.h"
 
 #include "Logger/Logger.h"
@@ -28,11 +31,47 @@ struct ChunkStats {
   bool has_nulls;
 };
 
+/**
+ * Zone maps of the blocks of rowsPerBlock consecutive rows of an integer or time chunk,
+ * in the units of the chunk stats. A block without any non-null value has min > max.
+ */
+struct ChunkBlockStats {
+  size_t rowsPerBlock;
+  size_t numElements;
+  bool sorted;  // the stored values do not decrease, with the nulls first
+  std::vector<int64_t> min;
+  std::vector<int64_t> max;
+  std::vector<bool> hasNulls;
+};
+
+/**
+ * Bounding boxes of the points of the blocks of rowsPerBlock consecutive rows of the
+ * coords chunk of a POINT column, decompressed. A block without any non-null point has
+ * xMin > xMax.
+ */
+struct ChunkBlockBounds {
+  size_t rowsPerBlock;
+  size_t numElements;
+  std::vector<double> xMin;
+  std::vector<double> yMin;
+  std::vector<double> xMax;
+  std::vector<double> yMax;
+};
+
 struct ChunkMetadata {
   SQLTypeInfo sqlType;
   size_t numBytes;
   size_t numElements;
   ChunkStats chunkStats;
+  // Built on demand from the chunk data by Chunk::getBlockStats() and dropped whenever
+  // the metadata is refilled from the encoder. Accessed with std::atomic_load/store.
+  std::shared_ptr<const ChunkBlockStats> blockStats;
+  // The same for the coords chunks of the POINT columns, by Chunk::getBlockBounds().
+  std::shared_ptr<const ChunkBlockBounds> blockBounds;
+  // Built by the fragmenter while appending to the chunks of the columns of a table's
+  // BLOOM_FILTER option, lost like blockStats when the metadata is refilled and not
+  // restored on startup. Accessed with std::atomic_load/store.
+  std::shared_ptr<const ChunkBloomFilter> bloomFilter;
 
   std::string dump() {
     return "numBytes: " + to_string(numBytes) + " numElements " + to_string(numElements) +
@@ -25,6 +25,7 @@
 #include "CudaMgr/CudaMgr.h"
 #include "FileMgr/GlobalFileMgr.h"
 #include "PersistentStorageMgr/PersistentStorageMgr.h"
+#include "Shared/numa.h"
 
 #ifdef __APPLE__
 #include <sys/sysctl.h>
@@ -44,6 +45,8 @@ using namespace File_Namespace;
 
 extern bool g_enable_fsi;
 
+bool g_enable_mmap_cpu_chunks{false};
+
 namespace Data_Namespace {
 
 DataMgr::DataMgr(const string& dataDir,
@@ -71,9 +74,12 @@ DataMgr::DataMgr(const string& dataDir,
 
   populateMgrs(system_parameters, numReaderThreads, cache_config);
   createTopLevelMetadata();
+  metrics_collector_id_ = metrics::Registry::instance().addCollector(
+      [this](std::vector<metrics::Sample>& samples) { collectMetrics(samples); });
 }
 
 DataMgr::~DataMgr() {
+  metrics::Registry::instance().removeCollector(metrics_collector_id_);
   int numLevels = bufferMgrs_.size();
   for (int level = numLevels - 1; level >= 0; --level) {
     for (size_t device = 0; device < bufferMgrs_[level].size(); device++) {
@@ -173,10 +179,24 @@ void DataMgr::resetPersistentStorage(const DiskCacheConfig& cache_config,
   createTopLevelMetadata();
 }
 
+namespace {
+
+void setEvictionPolicy(AbstractBufferMgr* buffer_mgr, const std::string& policy_name) {
+  auto casted_buffer_mgr = dynamic_cast<Buffer_Namespace::BufferMgr*>(buffer_mgr);
+  CHECK(casted_buffer_mgr);
+  casted_buffer_mgr->setEvictionPolicy(Buffer_Namespace::makeEvictionPolicy(policy_name));
+  LOG(INFO) << "Using " << policy_name << " eviction policy for "
+            << casted_buffer_mgr->getStringMgrType() << ":"
+            << casted_buffer_mgr->getDeviceId() << " buffer pool";
+}
+
+}  // namespace
+
 void DataMgr::populateMgrs(const SystemParameters& system_parameters,
                            const size_t userSpecifiedNumReaderThreads,
                            const DiskCacheConfig& cache_config) {
   // no need for locking, as this is only called in the constructor
+  maxResidentBufferPoolFraction_ = system_parameters.max_resident_buffer_pool_fraction;
   bufferMgrs_.resize(2);
   if (g_enable_fsi) {
     bufferMgrs_[0].push_back(
@@ -203,17 +223,30 @@ void DataMgr::populateMgrs(const SystemParameters& system_parameters,
   LOG(INFO) << "Max CPU Slab Size is " << (float)maxCpuSlabSize / (1024 * 1024) << "MB";
   LOG(INFO) << "Max memory pool size for CPU is " << (float)cpuBufferSize / (1024 * 1024)
             << "MB";
+  const size_t num_numa_nodes =
+      system_parameters.numa_aware_cpu_buffer_pool ? numa::get_num_nodes() : 1;
+  if (system_parameters.numa_aware_cpu_buffer_pool) {
+    LOG(INFO) << "CPU buffer pool slabs will be placed across " << num_numa_nodes
+              << " NUMA node(s)";
+  }
   if (hasGpus_) {
     LOG(INFO) << "Reserved GPU memory is " << (float)reservedGpuMem_ / (1024 * 1024)
               << "MB includes render buffer allocation";
     bufferMgrs_.resize(3);
-    bufferMgrs_[1].push_back(new CpuBufferMgr(0,
-                                              cpuBufferSize,
-                                              cudaMgr_.get(),
-                                              minCpuSlabSize,
-                                              maxCpuSlabSize,
-                                              page_size,
-                                              bufferMgrs_[0][0]));
+    if (system_parameters.pinned_cpu_buffer_pool) {
+      LOG(INFO) << "CPU buffer pool slabs will be allocated as pinned host memory";
+    }
+    bufferMgrs_[1].push_back(
+        new CpuBufferMgr(0,
+                         cpuBufferSize,
+                         cudaMgr_.get(),
+                         minCpuSlabSize,
+                         maxCpuSlabSize,
+                         page_size,
+                         bufferMgrs_[0][0],
+                         /*use_pinned_slabs=*/system_parameters.pinned_cpu_buffer_pool,
+                         num_numa_nodes));
+    setEvictionPolicy(bufferMgrs_[1][0], system_parameters.cpu_buffer_eviction_policy);
     levelSizes_.push_back(1);
     int numGpus = cudaMgr_->getDeviceCount();
     for (int gpuNum = 0; gpuNum < numGpus; ++gpuNum) {
@@ -240,6 +273,8 @@ void DataMgr::populateMgrs(const SystemParameters& system_parameters,
                                                     maxGpuSlabSize,
                                                     page_size,
                                                     bufferMgrs_[1][0]));
+      setEvictionPolicy(bufferMgrs_[2][gpuNum],
+                        system_parameters.gpu_buffer_eviction_policy);
     }
     levelSizes_.push_back(numGpus);
   } else {
@@ -249,7 +284,10 @@ void DataMgr::populateMgrs(const SystemParameters& system_parameters,
                                               minCpuSlabSize,
                                               maxCpuSlabSize,
                                               page_size,
-                                              bufferMgrs_[0][0]));
+                                              bufferMgrs_[0][0],
+                                              /*use_pinned_slabs=*/false,
+                                              num_numa_nodes));
+    setEvictionPolicy(bufferMgrs_[1][0], system_parameters.cpu_buffer_eviction_policy);
     levelSizes_.push_back(1);
   }
 }
@@ -305,6 +343,63 @@ void DataMgr::createTopLevelMetadata()
   }
 }
 
+namespace {
+
+void setTransferStats(MemoryInfo& mi, const CudaMgr_Namespace::TransferStats& stats) {
+  mi.hostToDeviceBytes = stats.host_to_device_bytes;
+  mi.hostToDeviceBandwidthGBs = stats.getHostToDeviceBandwidthGBs();
+  mi.deviceToHostBytes = stats.device_to_host_bytes;
+  mi.deviceToHostBandwidthGBs = stats.getDeviceToHostBandwidthGBs();
+}
+
+void setCacheStats(MemoryInfo& mi, Buffer_Namespace::BufferMgr& buffer_mgr) {
+  mi.evictionPolicy = buffer_mgr.getEvictionPolicyName();
+  mi.numHits = buffer_mgr.getNumHits();
+  mi.numMisses = buffer_mgr.getNumMisses();
+  mi.numEvictions = buffer_mgr.getNumEvictions();
+  mi.fragmentationRatio = buffer_mgr.getFragmentationRatio();
+}
+
+}  // namespace
+
+void DataMgr::collectMetrics(std::vector<metrics::Sample>& samples) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  for (const auto level : {MemoryLevel::CPU_LEVEL, MemoryLevel::GPU_LEVEL}) {
+    if (static_cast<size_t>(level) >= bufferMgrs_.size()) {
+      continue;
+    }
+    for (size_t device = 0; device < bufferMgrs_[level].size(); ++device) {
+      const auto buffer_mgr = dynamic_cast<BufferMgr*>(bufferMgrs_[level][device]);
+      if (!buffer_mgr) {
+        continue;
+      }
+      const metrics::Labels labels{
+          {"level", level == MemoryLevel::CPU_LEVEL ? "cpu" : "gpu"},
+          {"device", std::to_string(device)}};
+      samples.push_back({"omnisci_buffer_pool_hits_total",
+                         "The fetches of chunks already in the buffer pool",
+                         "counter",
+                         labels,
+                         static_cast<double>(buffer_mgr->getNumHits())});
+      samples.push_back({"omnisci_buffer_pool_misses_total",
+                         "The fetches of chunks not in the buffer pool",
+                         "counter",
+                         labels,
+                         static_cast<double>(buffer_mgr->getNumMisses())});
+      samples.push_back({"omnisci_buffer_pool_evictions_total",
+                         "The chunks evicted from the buffer pool",
+                         "counter",
+                         labels,
+                         static_cast<double>(buffer_mgr->getNumEvictions())});
+      samples.push_back({"omnisci_buffer_pool_allocated_bytes",
+                         "The bytes of the slabs of the buffer pool",
+                         "gauge",
+                         labels,
+                         static_cast<double>(buffer_mgr->getAllocated())});
+    }
+  }
+}
+
 std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
   std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
 
@@ -319,6 +414,19 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
     mi.maxNumPages = cpu_buffer->getMaxSize() / mi.pageSize;
     mi.isAllocationCapped = cpu_buffer->isAllocationCapped();
     mi.numPageAllocated = cpu_buffer->getAllocated() / mi.pageSize;
+    mi.isPinned = cpu_buffer->usesPinnedSlabs();
+    setCacheStats(mi, *cpu_buffer);
+    if (hasGpus_) {
+      CudaMgr_Namespace::TransferStats total_stats;
+      for (int gpuNum = 0; gpuNum < cudaMgr_->getDeviceCount(); ++gpuNum) {
+        const auto device_stats = cudaMgr_->getTransferStats(gpuNum);
+        total_stats.host_to_device_bytes += device_stats.host_to_device_bytes;
+        total_stats.host_to_device_micros += device_stats.host_to_device_micros;
+        total_stats.device_to_host_bytes += device_stats.device_to_host_bytes;
+        total_stats.device_to_host_micros += device_stats.device_to_host_micros;
+      }
+      setTransferStats(mi, total_stats);
+    }
 
     const auto& slab_segments = cpu_buffer->getSlabSegments();
     for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -347,6 +455,8 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
       mi.maxNumPages = gpu_buffer->getMaxSize() / mi.pageSize;
       mi.isAllocationCapped = gpu_buffer->isAllocationCapped();
       mi.numPageAllocated = gpu_buffer->getAllocated() / mi.pageSize;
+      setTransferStats(mi, cudaMgr_->getTransferStats(gpuNum));
+      setCacheStats(mi, *gpu_buffer);
 
       const auto& slab_segments = gpu_buffer->getSlabSegments();
       for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -403,6 +513,79 @@ void DataMgr::clearMemory(const MemoryLevel memLevel) {
   }
 }
 
+void DataMgr::compactMemory(const MemoryLevel memLevel) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+
+  if (memLevel == MemoryLevel::GPU_LEVEL && !cudaMgr_) {
+    throw std::runtime_error("Unable to compact GPU memory: No GPUs detected");
+  }
+  for (auto buffer_mgr : bufferMgrs_[memLevel]) {
+    auto casted_buffer_mgr = dynamic_cast<Buffer_Namespace::BufferMgr*>(buffer_mgr);
+    CHECK(casted_buffer_mgr);
+    casted_buffer_mgr->compact();
+  }
+}
+
+void DataMgr::setResidentColumns(const int db_id,
+                                 const std::vector<int>& tb_ids,
+                                 const std::set<int>& column_ids,
+                                 const MemoryLevel memLevel,
+                                 const size_t num_bytes) {
+  CHECK(memLevel == MemoryLevel::CPU_LEVEL || memLevel == MemoryLevel::GPU_LEVEL);
+  CHECK(!tb_ids.empty());
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  if (memLevel == MemoryLevel::GPU_LEVEL && !cudaMgr_) {
+    if (column_ids.empty()) {
+      return;
+    }
+    throw std::runtime_error("Unable to pin columns in GPU memory: No GPUs detected");
+  }
+
+  auto& table_bytes = residentTableBytes_[memLevel];
+  const auto table_key = std::make_pair(db_id, tb_ids.front());
+  if (column_ids.empty()) {
+    table_bytes.erase(table_key);
+  } else {
+    size_t resident_bytes{num_bytes};
+    for (const auto& [other_table_key, other_num_bytes] : table_bytes) {
+      if (other_table_key != table_key) {
+        resident_bytes += other_num_bytes;
+      }
+    }
+    size_t pool_bytes{0};
+    for (auto buffer_mgr : bufferMgrs_[memLevel]) {
+      pool_bytes += buffer_mgr->getMaxSize();
+    }
+    const auto max_resident_bytes =
+        static_cast<size_t>(pool_bytes * maxResidentBufferPoolFraction_);
+    if (resident_bytes > max_resident_bytes) {
+      throw std::runtime_error(
+          "Unable to pin columns in " +
+          std::string(memLevel == MemoryLevel::GPU_LEVEL ? "GPU" : "CPU") +
+          " memory: the pinned columns would take " + std::to_string(resident_bytes) +
+          " bytes of the " + std::to_string(max_resident_bytes) +
+          " allowed by max-resident-buffer-pool-fraction");
+    }
+    table_bytes[table_key] = num_bytes;
+  }
+  for (auto buffer_mgr : bufferMgrs_[memLevel]) {
+    auto casted_buffer_mgr = dynamic_cast<Buffer_Namespace::BufferMgr*>(buffer_mgr);
+    CHECK(casted_buffer_mgr);
+    for (const auto tb_id : tb_ids) {
+      casted_buffer_mgr->setResidentColumns(db_id, tb_id, column_ids);
+    }
+  }
+}
+
+size_t DataMgr::getCpuNumaNodeCount() const {
+  CHECK_GT(bufferMgrs_.size(), size_t(MemoryLevel::CPU_LEVEL));
+  CHECK(!bufferMgrs_[MemoryLevel::CPU_LEVEL].empty());
+  auto cpu_buffer_mgr =
+      dynamic_cast<const CpuBufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpu_buffer_mgr);
+  return cpu_buffer_mgr->getNumNumaNodes();
+}
+
 bool DataMgr::isBufferOnDevice(const ChunkKey& key,
                                const MemoryLevel memLevel,
                                const int deviceId) {
@@ -410,6 +593,26 @@ bool DataMgr::isBufferOnDevice(const ChunkKey& key,
   return bufferMgrs_[memLevel][deviceId]->isBufferOnDevice(key);
 }
 
+size_t DataMgr::getBufferPoolMaxSize(const MemoryLevel memLevel, const int deviceId) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  CHECK_LT(deviceId, levelSizes_[memLevel]);
+  return bufferMgrs_[memLevel][deviceId]->getMaxSize();
+}
+
+const int8_t* DataMgr::getMappedChunkData(const ChunkKey& key, const size_t numBytes) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  if (bufferMgrs_[MemoryLevel::CPU_LEVEL][0]->isBufferOnDevice(key)) {
+    // a resident copy may hold changes that have not been checkpointed yet
+    return nullptr;
+  }
+  auto file_mgr =
+      dynamic_cast<File_Namespace::FileMgr*>(getGlobalFileMgr()->getFileMgr(key));
+  if (!file_mgr) {
+    return nullptr;
+  }
+  return file_mgr->getMappedChunkData(key, numBytes);
+}
+
 void DataMgr::getChunkMetadataVec(ChunkMetadataVector& chunkMetadataVec) {
   // Can we always assume this will just be at the disklevel bc we just
   // started?
@@ -540,6 +743,34 @@ size_t DataMgr::getTableEpoch(const int db_id, const int tb_id) {
   return gfm->getTableEpoch(db_id, tb_id);
 }
 
+void DataMgr::setTableExtentSize(const int db_id,
+                                 const int tb_id,
+                                 const size_t extent_size) {
+  getGlobalFileMgr()->setTableExtentSize(db_id, tb_id, extent_size);
+}
+
+size_t DataMgr::compactTableFiles(const int db_id,
+                                  const int tb_id,
+                                  const double min_free_fraction) {
+  return getGlobalFileMgr()->compactTableFiles(db_id, tb_id, min_free_fraction);
+}
+
+size_t DataMgr::spillTableColdChunks(const int db_id,
+                                     const int tb_id,
+                                     const size_t min_epoch_age) {
+  return getGlobalFileMgr()->spillTableColdChunks(db_id, tb_id, min_epoch_age);
+}
+
+size_t DataMgr::compressTableChunks(const int db_id,
+                                    const int tb_id,
+                                    const size_t min_epoch_age) {
+  return getGlobalFileMgr()->compressTableChunks(db_id, tb_id, min_epoch_age);
+}
+
+File_Namespace::FileIoStats DataMgr::getTableIoStats(const int db_id, const int tb_id) {
+  return getGlobalFileMgr()->getTableIoStats(db_id, tb_id);
+}
+
 GlobalFileMgr* DataMgr::getGlobalFileMgr() const {
   GlobalFileMgr* global_file_mgr;
   if (g_enable_fsi) {
@@ -21,6 +21,7 @@
 #ifndef DATAMGR_H
 #define DATAMGR_H
 
+#include "../Shared/Metrics.h"
 #include "../Shared/SystemParameters.h"
 #include "../Shared/mapd_shared_mutex.h"
 #include "AbstractBuffer.h"
@@ -33,6 +34,7 @@
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -40,6 +42,7 @@
 namespace File_Namespace {
 class FileBuffer;
 class GlobalFileMgr;
+struct FileIoStats;
 }  // namespace File_Namespace
 
 namespace CudaMgr_Namespace {
@@ -62,6 +65,16 @@ struct MemoryInfo {
   size_t maxNumPages;
   size_t numPageAllocated;
   bool isAllocationCapped;
+  bool isPinned{false};
+  size_t hostToDeviceBytes{0};  // cumulative bytes copied to the device(s) so far
+  double hostToDeviceBandwidthGBs{0};
+  size_t deviceToHostBytes{0};
+  double deviceToHostBandwidthGBs{0};
+  std::string evictionPolicy;
+  size_t numHits{0};
+  size_t numMisses{0};
+  size_t numEvictions{0};
+  double fragmentationRatio{0};
   std::vector<MemoryData> nodeMemoryData;
 };
 
@@ -191,9 +204,31 @@ class DataMgr {
   bool isBufferOnDevice(const ChunkKey& key,
                         const MemoryLevel memLevel,
                         const int deviceId);
+  //! The size in bytes the buffer pool of deviceId at memLevel can grow to
+  size_t getBufferPoolMaxSize(const MemoryLevel memLevel, const int deviceId);
+  /**
+   * Returns a zero-copy pointer to the first numBytes of a chunk in the memory mapped
+   * data files, or nullptr if the chunk is already resident in the CPU buffer pool or
+   * cannot be mapped (see FileBuffer::getMappedData()). The pointer stays valid for as
+   * long as the table's FileMgr is open and the chunk is not modified.
+   */
+  const int8_t* getMappedChunkData(const ChunkKey& key, const size_t numBytes);
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
   std::string dumpLevel(const MemoryLevel memLevel);
   void clearMemory(const MemoryLevel memLevel);
+  void compactMemory(const MemoryLevel memLevel);
+  /**
+   * Keeps the chunks of column_ids of the physical tables tb_ids of a table resident in
+   * the memLevel buffer pools: the pools don't evict them for other chunks. Replaces the
+   * columns set for the table before, no columns releases it. num_bytes are the bytes of
+   * the chunks; throws if the resident bytes of the level would exceed the
+   * max_resident_buffer_pool_fraction of its pools.
+   */
+  void setResidentColumns(const int db_id,
+                          const std::vector<int>& tb_ids,
+                          const std::set<int>& column_ids,
+                          const MemoryLevel memLevel,
+                          const size_t num_bytes);
 
   const std::map<ChunkKey, File_Namespace::FileBuffer*>& getChunkMap();
   void checkpoint(const int db_id,
@@ -205,8 +240,21 @@ class DataMgr {
   void removeTableRelatedDS(const int db_id, const int tb_id);
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  void setTableExtentSize(const int db_id, const int tb_id, const size_t extent_size);
+  size_t compactTableFiles(const int db_id,
+                           const int tb_id,
+                           const double min_free_fraction);
+  size_t spillTableColdChunks(const int db_id,
+                              const int tb_id,
+                              const size_t min_epoch_age);
+  size_t compressTableChunks(const int db_id,
+                             const int tb_id,
+                             const size_t min_epoch_age);
+  File_Namespace::FileIoStats getTableIoStats(const int db_id, const int tb_id);
 
   CudaMgr_Namespace::CudaMgr* getCudaMgr() const { return cudaMgr_.get(); }
+  /// Number of NUMA nodes the CPU buffer pool places chunks on, 1 if not NUMA aware
+  size_t getCpuNumaNodeCount() const;
   File_Namespace::GlobalFileMgr* getGlobalFileMgr() const;
 
   // database_id, table_id, column_id, fragment_id
@@ -237,6 +285,8 @@ class DataMgr {
   void convertDB(const std::string basePath);
   void checkpoint();  // checkpoint for whole DB, called from convertDB proc only
   void createTopLevelMetadata() const;
+  //! The hits, misses and evictions of the buffer pools, read at scrape time
+  void collectMetrics(std::vector<metrics::Sample>& samples);
 
   std::vector<std::vector<AbstractBufferMgr*>> bufferMgrs_;
   std::unique_ptr<CudaMgr_Namespace::CudaMgr> cudaMgr_;
@@ -244,6 +294,10 @@ class DataMgr {
   bool hasGpus_;
   size_t reservedGpuMem_;
   std::mutex buffer_access_mutex_;
+  size_t metrics_collector_id_;
+  double maxResidentBufferPoolFraction_;
+  // the resident bytes of each level, by database and first physical table id
+  std::map<MemoryLevel, std::map<std::pair<int, int>, size_t>> residentTableBytes_;
 };
 
 std::ostream& operator<<(std::ostream& os, const DataMgr::SystemMemoryUsage&);
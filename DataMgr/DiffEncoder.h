@@ -0,0 +1,384 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    DiffEncoder.h
+ * @brief   Frame of reference encoding of integer, decimal and time columns
+ *
+ * A chunk of a column with ENCODING DIFF(n) starts with an int64_t reference value,
+ * followed by one n bit signed offset from it per row. The smallest n bit value is the
+ * null sentinel. The reference is chosen by the first append to the chunk and never
+ * changes afterwards, so the chunk stays append only; the fragmenter starts a new
+ * fragment for rows which do not fit the range of the current one.
+ */
+
+#ifndef DIFF_ENCODER_H
+#define DIFF_ENCODER_H
+
+#include "Logger/Logger.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "AbstractBuffer.h"
+#include "Encoder.h"
+
+#include <Shared/DatumFetchers.h>
+
+constexpr size_t kDiffEncodingHeaderSize{sizeof(int64_t)};
+
+template <typename T, typename V>
+void diff_decode_values(const int8_t* chunk_data, const size_t num_elems, T* dst) {
+  if (num_elems == 0) {
+    return;  // the chunk may not even have a reference yet
+  }
+  int64_t reference;
+  std::memcpy(&reference, chunk_data, sizeof(reference));
+  const V* offsets = reinterpret_cast<const V*>(chunk_data + kDiffEncodingHeaderSize);
+  for (size_t i = 0; i < num_elems; ++i) {
+    dst[i] = offsets[i] == std::numeric_limits<V>::min()
+                 ? inline_int_null_value<T>()
+                 : static_cast<T>(reference + offsets[i]);
+  }
+}
+
+/**
+ * Decodes the first num_elems rows of the data of a chunk with offsets of encoded_size
+ * bytes into dst. Nulls are decoded as the null sentinel of T.
+ */
+template <typename T>
+void diff_decode_chunk(const int8_t* chunk_data,
+                       const int encoded_size,
+                       const size_t num_elems,
+                       T* dst) {
+  switch (encoded_size) {
+    case 1:
+      diff_decode_values<T, int8_t>(chunk_data, num_elems, dst);
+      break;
+    case 2:
+      diff_decode_values<T, int16_t>(chunk_data, num_elems, dst);
+      break;
+    case 4:
+      diff_decode_values<T, int32_t>(chunk_data, num_elems, dst);
+      break;
+    default:
+      CHECK(false) << "Unexpected Diff encoding width " << encoded_size;
+  }
+}
+
+/**
+ * Decodes a chunk of a DIFF column of type ti into values of its logical width, which
+ * is what the column looks like everywhere outside of the generated code.
+ */
+inline void diff_decode_chunk_to_logical(const int8_t* chunk_data,
+                                         const SQLTypeInfo& ti,
+                                         const size_t num_elems,
+                                         int8_t* dst) {
+  CHECK_EQ(ti.get_compression(), kENCODING_DIFF);
+  switch (ti.get_logical_size()) {
+    case 2:
+      diff_decode_chunk(
+          chunk_data, ti.get_size(), num_elems, reinterpret_cast<int16_t*>(dst));
+      break;
+    case 4:
+      diff_decode_chunk(
+          chunk_data, ti.get_size(), num_elems, reinterpret_cast<int32_t*>(dst));
+      break;
+    case 8:
+      diff_decode_chunk(
+          chunk_data, ti.get_size(), num_elems, reinterpret_cast<int64_t*>(dst));
+      break;
+    default:
+      CHECK(false) << "Unexpected logical width " << ti.get_logical_size()
+                   << " of a Diff encoded column";
+  }
+}
+
+template <typename T, typename V>
+class DiffEncoder : public Encoder {
+ public:
+  DiffEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : Encoder(buffer)
+      , dataMin(std::numeric_limits<T>::max())
+      , dataMax(std::numeric_limits<T>::min())
+      , has_nulls(false)
+      , reference_(0)
+      , has_reference_(false) {}
+
+  std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
+                                            const size_t num_elems_to_append,
+                                            const SQLTypeInfo& ti,
+                                            const bool replicating = false,
+                                            const int64_t offset = -1) override {
+    CHECK(offset == -1 || offset == 0);
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    if (offset == 0) {
+      // the chunk is rewritten from scratch and gets a new reference
+      has_reference_ = false;
+    } else {
+      loadReference();
+    }
+    const bool write_header = !has_reference_;
+    if (write_header) {
+      setReference(unencoded_data, replicating ? 1 : num_elems_to_append);
+    }
+    auto encoded_data = std::make_unique<V[]>(num_elems_to_append);
+    for (size_t i = 0; i < num_elems_to_append; ++i) {
+      size_t ri = replicating ? 0 : i;
+      encoded_data.get()[i] = encodeDataAndUpdateStats(unencoded_data[ri]);
+    }
+
+    const auto encoded_bytes = num_elems_to_append * sizeof(V);
+    if (offset == -1) {
+      num_elems_ += num_elems_to_append;
+      if (write_header) {
+        buffer_->append(reinterpret_cast<int8_t*>(&reference_), sizeof(reference_));
+      }
+      buffer_->append(reinterpret_cast<int8_t*>(encoded_data.get()), encoded_bytes);
+      if (!replicating) {
+        src_data += num_elems_to_append * sizeof(T);
+      }
+    } else {
+      num_elems_ = num_elems_to_append;
+      CHECK(!replicating);
+      buffer_->write(reinterpret_cast<int8_t*>(&reference_), sizeof(reference_), 0);
+      buffer_->write(reinterpret_cast<int8_t*>(encoded_data.get()),
+                     encoded_bytes,
+                     kDiffEncodingHeaderSize);
+    }
+
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    getMetadata(chunk_metadata);
+    return chunk_metadata;
+  }
+
+  /**
+   * Number of the num_elems values at src_data, a prefix of them, which can be appended
+   * to the chunk. That is the values within the range of its reference, or the longest
+   * prefix whose range fits the offsets if the chunk is empty, which is at least one.
+   */
+  size_t getNumElemsInRange(const int8_t* src_data, const size_t num_elems) {
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    if (num_elems == 0) {
+      return 0;
+    }
+    loadReference();
+    if (has_reference_) {
+      size_t i = 0;
+      while (i < num_elems && isInRange(unencoded_data[i])) {
+        ++i;
+      }
+      return i;
+    }
+    bool has_values = false;
+    T min{0};
+    T max{0};
+    size_t i = 0;
+    for (; i < num_elems; ++i) {
+      const auto data = unencoded_data[i];
+      if (data == inline_int_null_value<T>()) {
+        continue;
+      }
+      const auto new_min = has_values ? std::min(min, data) : data;
+      const auto new_max = has_values ? std::max(max, data) : data;
+      if (!isSpanInRange(new_min, new_max)) {
+        break;
+      }
+      has_values = true;
+      min = new_min;
+      max = new_max;
+    }
+    return std::max(i, size_t(1));
+  }
+
+  void getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) override {
+    Encoder::getMetadata(chunkMetadata);
+    chunkMetadata->fillChunkStats(dataMin, dataMax, has_nulls);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>(ti, 0, 0, ChunkStats{});
+    chunk_metadata->fillChunkStats(dataMin, dataMax, has_nulls);
+    return chunk_metadata;
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    for (size_t i = 0; i < num_elements; ++i) {
+      updateStats(static_cast<int64_t>(unencoded_data[i]),
+                  unencoded_data[i] == inline_int_null_value<T>());
+    }
+  }
+
+  void updateStats(const std::vector<std::string>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  void updateStats(const std::vector<ArrayDatum>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void reduceStats(const Encoder& that) override {
+    const auto that_typed = static_cast<const DiffEncoder<T, V>&>(that);
+    if (that_typed.has_nulls) {
+      has_nulls = true;
+    }
+    dataMin = std::min(dataMin, that_typed.dataMin);
+    dataMax = std::max(dataMax, that_typed.dataMax);
+  }
+
+  void copyMetadata(const Encoder* copyFromEncoder) override {
+    num_elems_ = copyFromEncoder->getNumElems();
+    auto castedEncoder = reinterpret_cast<const DiffEncoder<T, V>*>(copyFromEncoder);
+    dataMin = castedEncoder->dataMin;
+    dataMax = castedEncoder->dataMax;
+    has_nulls = castedEncoder->has_nulls;
+  }
+
+  void writeMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fwrite((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&dataMin, sizeof(T), 1, f);
+    fwrite((int8_t*)&dataMax, sizeof(T), 1, f);
+    fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
+  }
+
+  void readMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fread((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fread((int8_t*)&dataMin, 1, sizeof(T), f);
+    fread((int8_t*)&dataMax, 1, sizeof(T), f);
+    fread((int8_t*)&has_nulls, 1, sizeof(bool), f);
+  }
+
+  bool resetChunkStats(const ChunkStats& stats) override {
+    const auto new_min = DatumFetcher::getDatumVal<T>(stats.min);
+    const auto new_max = DatumFetcher::getDatumVal<T>(stats.max);
+
+    if (dataMin == new_min && dataMax == new_max && has_nulls == stats.has_nulls) {
+      return false;
+    }
+
+    dataMin = new_min;
+    dataMax = new_max;
+    has_nulls = stats.has_nulls;
+    return true;
+  }
+
+  T dataMin;
+  T dataMax;
+  bool has_nulls;
+
+ private:
+  // offsets are symmetric around the reference, the smallest V is the null sentinel
+  static constexpr uint64_t kMaxOffset = std::numeric_limits<V>::max();
+
+  static uint64_t distance(const int64_t a, const int64_t b) {
+    return a >= b ? static_cast<uint64_t>(a) - static_cast<uint64_t>(b)
+                  : static_cast<uint64_t>(b) - static_cast<uint64_t>(a);
+  }
+
+  static bool isSpanInRange(const T min, const T max) {
+    return distance(max, min) <= 2 * kMaxOffset;
+  }
+
+  bool isInRange(const T data) const {
+    return data == inline_int_null_value<T>() ||
+           distance(data, reference_) <= kMaxOffset;
+  }
+
+  void loadReference() {
+    if (!has_reference_ && buffer_->size() >= kDiffEncodingHeaderSize) {
+      buffer_->read(reinterpret_cast<int8_t*>(&reference_), sizeof(reference_));
+      has_reference_ = true;
+    }
+  }
+
+  // the reference is the middle of the range of the values, zero if they are all null
+  void setReference(const T* unencoded_data, const size_t num_elems) {
+    bool has_values = false;
+    T min{0};
+    T max{0};
+    for (size_t i = 0; i < num_elems; ++i) {
+      const auto data = unencoded_data[i];
+      if (data == inline_int_null_value<T>()) {
+        continue;
+      }
+      min = has_values ? std::min(min, data) : data;
+      max = has_values ? std::max(max, data) : data;
+      has_values = true;
+    }
+    if (!isSpanInRange(min, max)) {
+      throw std::runtime_error("Diff encoding overflow: values from " +
+                               std::to_string(min) + " to " + std::to_string(max) +
+                               " exceed the range of " + std::to_string(sizeof(V) * 8) +
+                               " bit offsets");
+    }
+    reference_ = static_cast<int64_t>(min) + static_cast<int64_t>(distance(max, min) / 2);
+    has_reference_ = true;
+  }
+
+  V encodeDataAndUpdateStats(const T& unencoded_data) {
+    if (unencoded_data == inline_int_null_value<T>()) {
+      has_nulls = true;
+      return std::numeric_limits<V>::min();
+    }
+    if (!isInRange(unencoded_data)) {
+      throw std::runtime_error("Diff encoding overflow: value " +
+                               std::to_string(unencoded_data) +
+                               " is too far from the chunk's reference value " +
+                               std::to_string(reference_));
+    }
+    decimal_overflow_validator_.validate(unencoded_data);
+    dataMax = std::max(dataMax, unencoded_data);
+    dataMin = std::min(dataMin, unencoded_data);
+    return static_cast<V>(static_cast<int64_t>(unencoded_data) - reference_);
+  }
+
+  int64_t reference_;
+  bool has_reference_;
+};  // DiffEncoder
+
+#endif  // DIFF_ENCODER_H
@@ -17,6 +17,7 @@
 #include "Encoder.h"
 #include "ArrayNoneEncoder.h"
 #include "DateDaysEncoder.h"
+#include "DiffEncoder.h"
 #include "FixedLengthArrayNoneEncoder.h"
 #include "FixedLengthEncoder.h"
 #include "Logger/Logger.h"
@@ -171,6 +172,61 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
       }  // switch (sqlType)
       break;
     }  // Case: kENCODING_FIXED
+    case kENCODING_DIFF: {
+      switch (sqlType.get_type()) {
+        case kSMALLINT: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int16_t, int8_t>(buffer);
+              break;
+            default:
+              return 0;
+              break;
+          }
+          break;
+        }
+        case kINT: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int32_t, int8_t>(buffer);
+              break;
+            case 16:
+              return new DiffEncoder<int32_t, int16_t>(buffer);
+              break;
+            default:
+              return 0;
+              break;
+          }
+          break;
+        }
+        case kBIGINT:
+        case kNUMERIC:
+        case kDECIMAL:
+        case kTIME:
+        case kTIMESTAMP: {
+          switch (sqlType.get_comp_param()) {
+            case 8:
+              return new DiffEncoder<int64_t, int8_t>(buffer);
+              break;
+            case 16:
+              return new DiffEncoder<int64_t, int16_t>(buffer);
+              break;
+            case 32:
+              return new DiffEncoder<int64_t, int32_t>(buffer);
+              break;
+            default:
+              return 0;
+              break;
+          }
+          break;
+        }
+        default: {
+          return 0;
+          break;
+        }
+      }  // switch (sqlType)
+      break;
+    }  // Case: kENCODING_DIFF
     case kENCODING_DICT: {
       if (sqlType.get_type() == kARRAY) {
         CHECK(IS_STRING(sqlType.get_subtype()));
@@ -228,4 +284,10 @@ void Encoder::getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) {
   chunkMetadata->sqlType = buffer_->sql_type;
   chunkMetadata->numBytes = buffer_->size();
   chunkMetadata->numElements = num_elems_;
+  // the data may have changed in place
+  std::atomic_store(&chunkMetadata->blockStats, std::shared_ptr<const ChunkBlockStats>());
+  std::atomic_store(&chunkMetadata->blockBounds,
+                    std::shared_ptr<const ChunkBlockBounds>());
+  std::atomic_store(&chunkMetadata->bloomFilter,
+                    std::shared_ptr<const ChunkBloomFilter>());
 }
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/FileMgr/ColdStorage.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#ifdef HAVE_AWS_S3
+#include "DataMgr/FileMgr/S3ColdStorage.h"
+#endif  // HAVE_AWS_S3
+
+namespace File_Namespace {
+
+namespace {
+
+std::string errno_message(const std::string& what, const std::string& path) {
+  return what + " '" + path + "': " + std::strerror(errno);
+}
+
+void sync_path(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0 || ::fsync(fd) != 0) {
+    const auto message = errno_message("Could not sync", path);
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw std::runtime_error(message);
+  }
+  ::close(fd);
+}
+
+}  // namespace
+
+LocalColdStorage::LocalColdStorage(const std::string& basePath) : basePath_(basePath) {
+  boost::filesystem::create_directories(basePath_);
+  if (!boost::filesystem::is_directory(basePath_)) {
+    throw std::runtime_error("Cold storage path '" + basePath_ +
+                             "' is not a directory.");
+  }
+}
+
+void LocalColdStorage::putObject(const std::string& key,
+                                 const int8_t* data,
+                                 const size_t numBytes) {
+  const auto path = boost::filesystem::path(basePath_) / key;
+  boost::filesystem::create_directories(path.parent_path());
+  // written aside and renamed, so a crash never leaves a truncated object behind
+  const auto tmpPath = path.string() + ".tmp";
+  const int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(errno_message("Could not create", tmpPath));
+  }
+  size_t bytesWritten = 0;
+  while (bytesWritten < numBytes) {
+    const auto ret = ::write(fd, data + bytesWritten, numBytes - bytesWritten);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      const auto message = errno_message("Could not write", tmpPath);
+      ::close(fd);
+      throw std::runtime_error(message);
+    }
+    bytesWritten += ret;
+  }
+  if (::fsync(fd) != 0) {
+    const auto message = errno_message("Could not sync", tmpPath);
+    ::close(fd);
+    throw std::runtime_error(message);
+  }
+  ::close(fd);
+  if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error(errno_message("Could not rename", tmpPath));
+  }
+  sync_path(path.parent_path().string());
+}
+
+void LocalColdStorage::getObject(const std::string& key,
+                                 int8_t* dst,
+                                 const size_t numBytes,
+                                 const size_t offset) {
+  const auto path = (boost::filesystem::path(basePath_) / key).string();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(errno_message("Could not open", path));
+  }
+  size_t bytesRead = 0;
+  while (bytesRead < numBytes) {
+    const auto ret =
+        ::pread(fd, dst + bytesRead, numBytes - bytesRead, offset + bytesRead);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      ::close(fd);
+      throw std::runtime_error("Could not read " + std::to_string(numBytes) +
+                               " bytes at offset " + std::to_string(offset) + " of '" +
+                               path + "'");
+    }
+    bytesRead += ret;
+  }
+  ::close(fd);
+}
+
+void LocalColdStorage::removeObjects(const std::string& keyPrefix) {
+  // only the directory the prefix points into has to be searched
+  const auto dirEnd = keyPrefix.rfind('/');
+  const auto dir = boost::filesystem::path(basePath_) /
+                   (dirEnd == std::string::npos ? "" : keyPrefix.substr(0, dirEnd));
+  if (!boost::filesystem::is_directory(dir)) {
+    return;
+  }
+  const auto namePrefix =
+      dirEnd == std::string::npos ? keyPrefix : keyPrefix.substr(dirEnd + 1);
+  std::vector<boost::filesystem::path> paths;
+  for (const auto& entry : boost::filesystem::directory_iterator(dir)) {
+    if (boost::starts_with(entry.path().filename().string(), namePrefix)) {
+      paths.push_back(entry.path());
+    }
+  }
+  for (const auto& path : paths) {
+    boost::filesystem::remove_all(path);
+  }
+  if (namePrefix.empty()) {
+    boost::filesystem::remove(dir);
+  }
+}
+
+std::unique_ptr<ColdStorage> makeColdStorage(const std::string& url) {
+  if (boost::istarts_with(url, "s3://")) {
+#ifdef HAVE_AWS_S3
+    return std::make_unique<S3ColdStorage>(url);
+#else
+    throw std::runtime_error("AWS S3 support not available");
+#endif  // HAVE_AWS_S3
+  }
+  return std::make_unique<LocalColdStorage>(url);
+}
+
+}  // namespace File_Namespace
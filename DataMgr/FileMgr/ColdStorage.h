@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ColdStorage.h
+ * @brief   Object store the FileMgr spills cold chunks to
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace File_Namespace {
+
+/**
+ * Flat key/value store for the data of chunks moved out of the FileMgr data files. Keys
+ * are '/' separated paths. All methods throw std::runtime_error on failure.
+ */
+class ColdStorage {
+ public:
+  virtual ~ColdStorage() = default;
+
+  /// Stores the object durably, replacing any previous object with the same key
+  virtual void putObject(const std::string& key,
+                         const int8_t* data,
+                         const size_t numBytes) = 0;
+
+  /// Reads numBytes of the object starting at offset
+  virtual void getObject(const std::string& key,
+                         int8_t* dst,
+                         const size_t numBytes,
+                         const size_t offset) = 0;
+
+  /// Removes every object whose key starts with keyPrefix
+  virtual void removeObjects(const std::string& keyPrefix) = 0;
+
+  virtual std::string getUrl() const = 0;
+};
+
+/**
+ * Stores objects as files below a local directory, e.g. on an HDD mount.
+ */
+class LocalColdStorage : public ColdStorage {
+ public:
+  LocalColdStorage(const std::string& basePath);
+
+  void putObject(const std::string& key,
+                 const int8_t* data,
+                 const size_t numBytes) override;
+
+  void getObject(const std::string& key,
+                 int8_t* dst,
+                 const size_t numBytes,
+                 const size_t offset) override;
+
+  void removeObjects(const std::string& keyPrefix) override;
+
+  std::string getUrl() const override { return basePath_; }
+
+ private:
+  std::string basePath_;
+};
+
+/**
+ * Returns the store for url: an S3 bucket for "s3://bucket/prefix", a local directory
+ * otherwise.
+ */
+std::unique_ptr<ColdStorage> makeColdStorage(const std::string& url);
+
+}  // namespace File_Namespace
@@ -22,21 +22,107 @@
 
 #include "DataMgr/FileMgr/FileBuffer.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <future>
 #include <map>
+#include <stdexcept>
 #include <thread>
 
 #include "DataMgr/FileMgr/FileMgr.h"
+#include "Shared/Compressor.h"
 #include "Shared/File.h"
+#include "Shared/Metrics.h"
 #include "Shared/checked_alloc.h"
 
 #define METADATA_PAGE_SIZE 4096
 
+bool g_enable_direct_io_reads{false};
+size_t g_direct_io_queue_depth{8};
+
 using namespace std;
 
 namespace File_Namespace {
 size_t FileBuffer::headerBufferOffset_ = 32;
 
+namespace {
+
+// the reads and writes of the chunks, cold storage and compressed pages included
+struct IoMetrics {
+  metrics::Counter& read_bytes;
+  metrics::Counter& written_bytes;
+  metrics::Histogram& read_seconds;
+  metrics::Histogram& write_seconds;
+};
+
+// The offsets of a varlen index are 32 bits, the deltas wrap around so that the null
+// arrays, with negative offsets, and any trailing bytes are restored as they were.
+void encode_offset_deltas(int8_t* const data, const size_t numBytes) {
+  const size_t numOffsets = numBytes / sizeof(uint32_t);
+  uint32_t previous{0};
+  for (size_t i = 0; i < numOffsets; ++i) {
+    uint32_t offset;
+    std::memcpy(&offset, data + i * sizeof(uint32_t), sizeof(uint32_t));
+    const uint32_t delta = offset - previous;
+    std::memcpy(data + i * sizeof(uint32_t), &delta, sizeof(uint32_t));
+    previous = offset;
+  }
+}
+
+void decode_offset_deltas(int8_t* const data, const size_t numBytes) {
+  const size_t numOffsets = numBytes / sizeof(uint32_t);
+  uint32_t offset{0};
+  for (size_t i = 0; i < numOffsets; ++i) {
+    uint32_t delta;
+    std::memcpy(&delta, data + i * sizeof(uint32_t), sizeof(uint32_t));
+    offset += delta;
+    std::memcpy(data + i * sizeof(uint32_t), &offset, sizeof(uint32_t));
+  }
+}
+
+IoMetrics& io_metrics() {
+  auto& registry = metrics::Registry::instance();
+  static IoMetrics io_metrics{
+      registry.counter("omnisci_file_mgr_read_bytes_total",
+                       "The bytes read from the chunks of the files"),
+      registry.counter("omnisci_file_mgr_written_bytes_total",
+                       "The bytes written or appended to the chunks of the files"),
+      registry.histogram("omnisci_file_mgr_read_seconds",
+                         "The reads from the chunks of the files",
+                         metrics::latency_buckets()),
+      registry.histogram("omnisci_file_mgr_write_seconds",
+                         "The writes and appends to the chunks of the files",
+                         metrics::latency_buckets())};
+  return io_metrics;
+}
+
+// Upper bound on a single coalesced read, also the size of each reader's staging buffer
+constexpr size_t kMaxCoalescedReadBytes{64 * 1024 * 1024};
+
+struct CoalescedReadRun {
+  FileInfo* file_info;
+  size_t first_file_page;     // page number of the run within the file
+  size_t first_logical_page;  // index of the run's first page within the read
+  size_t num_pages;
+};
+
+// data points at the start of the data portion of the page
+void verify_page_data(FileInfo* file_info,
+                      const FileBuffer* buffer,
+                      const size_t page_num,
+                      const int8_t* data,
+                      const size_t num_bytes) {
+  if (buffer->reservedHeaderSize() == FileInfo::kPageHeaderSize &&
+      !file_info->verifyPageData(page_num, data, num_bytes)) {
+    throw std::runtime_error("Checksum mismatch in page " + std::to_string(page_num) +
+                             " of data file " + std::to_string(file_info->fileId) +
+                             "." + std::to_string(file_info->pageSize) +
+                             ", the file is corrupt.");
+  }
+}
+
+}  // namespace
+
 FileBuffer::FileBuffer(FileMgr* fm,
                        const size_t pageSize,
                        const ChunkKey& chunkKey,
@@ -99,6 +185,33 @@ FileBuffer::FileBuffer(FileMgr* fm,
   for (auto vecIt = headerStartIt; vecIt != headerEndIt; ++vecIt) {
     int curPageId = vecIt->pageId;
 
+    // A version with the same epoch as the previous one is a second copy of it, left
+    // behind when the FileMgr was interrupted while compacting its data files
+    MultiPage* prevVersions = nullptr;
+    if (curPageId == -1) {
+      prevVersions = &metadataPages_;
+    } else if (curPageId == lastPageId) {
+      prevVersions = &multiPages_.back();
+    }
+    if (prevVersions && !prevVersions->epochs.empty() &&
+        prevVersions->epochs.back() == vecIt->versionEpoch) {
+      // keep the copy that matches its checksum, the other one may be torn
+      auto& prevPage = prevVersions->pageVersions.back();
+      auto prevFileInfo = fm_->getFileInfoForFileId(prevPage.fileId);
+      auto curFileInfo = fm_->getFileInfoForFileId(vecIt->page.fileId);
+      if (!prevFileInfo->verifyStoredPage(prevPage.pageNum) &&
+          curFileInfo->verifyStoredPage(vecIt->page.pageNum)) {
+        prevFileInfo->freePageImmediate(prevPage.pageNum);
+        prevPage = vecIt->page;
+        if (curPageId == -1) {
+          readMetadata(prevPage);
+        }
+      } else {
+        curFileInfo->freePageImmediate(vecIt->page.pageNum);
+      }
+      continue;
+    }
+
     // We only want to read last metadata page
     if (curPageId == -1) {  // stats page
       metadataPages_.epochs.push_back(vecIt->versionEpoch);
@@ -129,16 +242,24 @@ FileBuffer::FileBuffer(FileMgr* fm,
       pageDataSize_ = pageSize_ - reservedHeaderSize_;
     }
   }
+  // data pages are only ever freed all at once, by spillToColdStorage()
+  isCold_ = multiPages_.empty() && size_ > 0;
   // auto lastHeaderIt = std::prev(headerEndIt);
   // size_ = lastHeaderIt->chunkSize;
 }
 
 FileBuffer::~FileBuffer() {
-  // need to free pages
-  // NOP
+  // pages in use stay allocated on disk, only the unused reservation is handed back
+  releaseReservedPages();
 }
 
 void FileBuffer::reserve(const size_t numBytes) {
+  if (isCold_) {
+    restoreFromColdStorage();
+  }
+  if (compressedSize_ > 0) {
+    decompressPages();
+  }
   size_t numPagesRequested = (numBytes + pageSize_ - 1) / pageSize_;
   size_t numCurrentPages = multiPages_.size();
   int epoch = fm_->epoch();
@@ -171,6 +292,7 @@ void FileBuffer::freeMetadataPages() {
 }
 
 void FileBuffer::freeChunkPages() {
+  releaseReservedPages();
   for (auto multiPageIt = multiPages_.begin(); multiPageIt != multiPages_.end();
        ++multiPageIt) {
     for (auto pageIt = multiPageIt->pageVersions.begin();
@@ -180,6 +302,7 @@ void FileBuffer::freeChunkPages() {
       fileInfo->freePage(pageIt->pageNum);
     }
   }
+  multiPages_.clear();
 }
 
 void FileBuffer::freePages() {
@@ -223,12 +346,16 @@ static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS)
               fileBuffer->reservedHeaderSize(),
           min(fileBuffer->pageDataSize() - threadDS.t_startPageOffset, bytesLeft),
           curPtr);
+      if (threadDS.t_startPageOffset == 0) {
+        verify_page_data(fileInfo, fileBuffer, page.pageNum, curPtr, bytesRead);
+      }
       isFirstPage = false;
     } else {
       bytesRead = fileInfo->read(
           page.pageNum * fileBuffer->pageSize() + fileBuffer->reservedHeaderSize(),
           min(fileBuffer->pageDataSize(), bytesLeft),
           curPtr);
+      verify_page_data(fileInfo, fileBuffer, page.pageNum, curPtr, bytesRead);
     }
     curPtr += bytesRead;
     bytesLeft -= bytesRead;
@@ -239,6 +366,119 @@ static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS)
   return (totalBytesRead);
 }
 
+bool FileBuffer::readCoalesced(int8_t* const dst,
+                               const size_t numBytes,
+                               const size_t offset,
+                               const bool directIo) {
+  if ((directIo && pageSize_ % FileInfo::kDirectIoAlignment) ||
+      pageSize_ > kMaxCoalescedReadBytes) {
+    return false;
+  }
+  const size_t startPage = offset / pageDataSize_;
+  const size_t startPageOffset = offset % pageDataSize_;
+  const size_t numPagesToRead =
+      (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
+  CHECK(startPage + numPagesToRead <= multiPages_.size());
+
+  // Coalesce logical pages whose current versions are adjacent in the same file
+  const size_t max_pages_per_run = kMaxCoalescedReadBytes / pageSize_;
+  std::vector<CoalescedReadRun> runs;
+  for (size_t i = 0; i < numPagesToRead; ++i) {
+    const auto page = multiPages_[startPage + i].current();
+    if (!runs.empty()) {
+      auto& last_run = runs.back();
+      if (last_run.file_info->fileId == page.fileId &&
+          last_run.first_file_page + last_run.num_pages == page.pageNum &&
+          last_run.num_pages < max_pages_per_run) {
+        ++last_run.num_pages;
+        continue;
+      }
+    }
+    FileInfo* file_info = fm_->getFileInfoForFileId(page.fileId);
+    CHECK(file_info);
+    runs.push_back({file_info, page.pageNum, i, 1});
+  }
+
+  size_t max_run_pages = 0;
+  for (const auto& run : runs) {
+    max_run_pages = std::max(max_run_pages, run.num_pages);
+  }
+
+  // Each reader keeps one coalesced read in flight; queue depth bounds the readers
+  const size_t num_readers =
+      std::max(size_t(1), std::min(g_direct_io_queue_depth, runs.size()));
+  const auto read_runs = [&](const size_t reader_idx) {
+    int8_t* staging = nullptr;
+    if (posix_memalign(reinterpret_cast<void**>(&staging),
+                       FileInfo::kDirectIoAlignment,
+                       max_run_pages * pageSize_)) {
+      return false;
+    }
+    // released on checksum mismatches too
+    std::unique_ptr<int8_t, decltype(&::free)> staging_owner(staging, &::free);
+    bool success = true;
+    for (size_t run_idx = reader_idx; success && run_idx < runs.size();
+         run_idx += num_readers) {
+      const auto& run = runs[run_idx];
+      const size_t run_offset = run.first_file_page * pageSize_;
+      const size_t run_size = run.num_pages * pageSize_;
+      if (directIo ? !run.file_info->readDirect(run_offset, run_size, staging)
+                   : run.file_info->read(run_offset, run_size, staging) != run_size) {
+        success = false;
+        continue;
+      }
+      // Strip the page headers while copying the data portion of each page out
+      for (size_t i = 0; i < run.num_pages; ++i) {
+        verify_page_data(run.file_info,
+                         this,
+                         run.first_file_page + i,
+                         staging + i * pageSize_ + reservedHeaderSize_,
+                         pageDataSize_);
+        const size_t logical_page = run.first_logical_page + i;
+        const size_t page_offset = logical_page == 0 ? startPageOffset : 0;
+        const size_t dst_offset =
+            logical_page == 0 ? 0
+                              : pageDataSize_ - startPageOffset +
+                                    (logical_page - 1) * pageDataSize_;
+        const size_t num_page_bytes =
+            std::min(pageDataSize_ - page_offset, numBytes - dst_offset);
+        memcpy(dst + dst_offset,
+               staging + i * pageSize_ + reservedHeaderSize_ + page_offset,
+               num_page_bytes);
+      }
+    }
+    return success;
+  };
+
+  if (num_readers == 1) {
+    return read_runs(0);
+  }
+  std::vector<std::future<bool>> readers;
+  for (size_t reader_idx = 0; reader_idx < num_readers; ++reader_idx) {
+    readers.push_back(std::async(std::launch::async, read_runs, reader_idx));
+  }
+  bool success = true;
+  for (auto& reader : readers) {
+    success = reader.get() && success;
+  }
+  return success;
+}
+
+const int8_t* FileBuffer::getMappedData(const size_t numBytes) {
+  if (is_dirty_ || multiPages_.empty() || compressedSize_ > 0 ||
+      numBytes > pageDataSize_ || numBytes > size_) {
+    return nullptr;
+  }
+  const auto page = multiPages_[0].current();
+  auto file_info = fm_->getFileInfoForFileId(page.fileId);
+  CHECK(file_info);
+  const auto mapping = file_info->getReadOnlyMapping();
+  if (!mapping) {
+    return nullptr;
+  }
+  return mapping + page.pageNum * pageSize_ + reservedHeaderSize_;
+}
+
 void FileBuffer::read(int8_t* const dst,
                       const size_t numBytes,
                       const size_t offset,
@@ -247,6 +487,64 @@ void FileBuffer::read(int8_t* const dst,
   if (dstBufferType != CPU_LEVEL) {
     LOG(FATAL) << "Unsupported Buffer type";
   }
+  auto& io = io_metrics();
+  io.read_bytes.add(numBytes);
+  metrics::ScopedTimer read_timer(io.read_seconds);
+  if (isCold_) {
+    CHECK_LE(offset + numBytes, size_);
+    fm_->readColdChunkData(chunkKey_, dst, numBytes, offset);
+    return;
+  }
+  if (compressedSize_ > 0) {
+    readDecompressed(dst, numBytes, offset);
+    return;
+  }
+  readPages(dst, numBytes, offset);
+}
+
+void FileBuffer::readDecompressed(int8_t* const dst,
+                                  const size_t numBytes,
+                                  const size_t offset) {
+  CHECK_LE(offset + numBytes, size_);
+  if (numBytes == 0) {
+    return;
+  }
+  std::vector<int8_t> compressed(compressedSize_);
+  readPages(compressed.data(), compressedSize_, 0);
+  auto compressor = BloscCompressor::getCompressor();
+  if (offset == 0 && numBytes == size_) {
+    compressor->decompress(reinterpret_cast<const uint8_t*>(compressed.data()),
+                           reinterpret_cast<uint8_t*>(dst),
+                           size_);
+    if (compressedDeltas_) {
+      decode_offset_deltas(dst, size_);
+    }
+    return;
+  }
+  std::vector<int8_t> data(size_);
+  compressor->decompress(reinterpret_cast<const uint8_t*>(compressed.data()),
+                         reinterpret_cast<uint8_t*>(data.data()),
+                         size_);
+  if (compressedDeltas_) {
+    // the offsets before the range are needed too
+    decode_offset_deltas(data.data(), offset + numBytes);
+  }
+  std::memcpy(dst, data.data() + offset, numBytes);
+}
+
+void FileBuffer::readPages(int8_t* const dst,
+                           const size_t numBytes,
+                           const size_t offset) {
+  if (numBytes > 0) {
+    if (g_enable_direct_io_reads && readCoalesced(dst, numBytes, offset, true)) {
+      return;
+    }
+    // pages reserved in extents are mostly adjacent, read each run in one call
+    if (fm_->getNumPagesPerExtent(pageSize_) > 1 &&
+        readCoalesced(dst, numBytes, offset, false)) {
+      return;
+    }
+  }
 
   // variable declarations
   size_t startPage = offset / pageDataSize_;
@@ -362,8 +660,121 @@ void FileBuffer::copyPage(Page& srcPage,
   free(buffer);
 }
 
+Page FileBuffer::requestDataPage() {
+  const auto pagesPerExtent = fm_->getNumPagesPerExtent(pageSize_);
+  if (pagesPerExtent == 1) {
+    return fm_->requestFreePage(pageSize_, false);
+  }
+  if (reservedPages_.empty()) {
+    fm_->requestFreeExtent(pageSize_, pagesPerExtent, reservedPages_);
+  }
+  const auto page = reservedPages_.front();
+  reservedPages_.pop_front();
+  return page;
+}
+
+void FileBuffer::releaseReservedPages() {
+  for (const auto& page : reservedPages_) {
+    fm_->getFileInfoForFileId(page.fileId)->releaseUnusedPage(page.pageNum);
+  }
+  reservedPages_.clear();
+}
+
+size_t FileBuffer::spillToColdStorage(const int maxEpoch) {
+  if (is_dirty_ || isCold_ || multiPages_.empty() || size_ == 0 ||
+      metadataPages_.epochs.empty() || metadataPages_.epochs.back() > maxEpoch) {
+    return 0;
+  }
+  for (const auto& multiPage : multiPages_) {
+    if (multiPage.epochs.size() != 1 || multiPage.epochs.front() > maxEpoch) {
+      return 0;
+    }
+  }
+  std::vector<int8_t> data(size_);
+  read(data.data(), size_);
+  // the object must be durable before the pages are gone; if the pages are freed but
+  // not checkpointed, reopening the FileMgr restores them and the object is unused
+  fm_->getColdStorage()->putObject(fm_->getColdStorageKey(chunkKey_), data.data(), size_);
+  freeChunkPages();
+  isCold_ = true;
+  if (compressedSize_ > 0) {
+    // the object holds the plain data, the next checkpoint records that
+    compressedSize_ = 0;
+    compressedDeltas_ = false;
+    setDirty();
+  }
+  return size_;
+}
+
+void FileBuffer::restoreFromColdStorage() {
+  CHECK(isCold_);
+  std::vector<int8_t> data(size_);
+  read(data.data(), size_);
+  // the object is kept, a rollback past this write makes the buffer cold again
+  isCold_ = false;
+  size_ = 0;
+  write(data.data(), data.size(), 0);
+}
+
+size_t FileBuffer::compressPages(const int maxEpoch) {
+  if (is_dirty_ || isCold_ || compressedSize_ > 0 || multiPages_.empty() || size_ == 0 ||
+      metadataPages_.epochs.empty() || metadataPages_.epochs.back() > maxEpoch) {
+    return 0;
+  }
+  for (const auto& multiPage : multiPages_) {
+    if (multiPage.epochs.size() != 1 || multiPage.epochs.front() > maxEpoch) {
+      return 0;
+    }
+  }
+  std::vector<int8_t> data(size_);
+  read(data.data(), size_);
+  const bool compressDeltas = isVarLenIndexKey(chunkKey_);
+  if (compressDeltas) {
+    encode_offset_deltas(data.data(), size_);
+  }
+  auto compressor = BloscCompressor::getCompressor();
+  std::vector<int8_t> compressed(compressor->getScratchSpaceSize(size_));
+  int64_t compressedSize{0};
+  try {
+    compressedSize = compressor->compress(reinterpret_cast<const uint8_t*>(data.data()),
+                                          size_,
+                                          reinterpret_cast<uint8_t*>(compressed.data()),
+                                          compressed.size(),
+                                          0);
+  } catch (const CompressionFailedError& e) {
+    LOG(WARNING) << "Could not compress chunk " << showChunk(chunkKey_) << ": "
+                 << e.what();
+    return 0;
+  }
+  const size_t numPages = (compressedSize + pageDataSize_ - 1) / pageDataSize_;
+  if (compressedSize <= 0 || numPages >= multiPages_.size()) {
+    return 0;
+  }
+  const size_t numPagesFreed = multiPages_.size() - numPages;
+  const auto logicalSize = size_;
+  // as for cold storage, the old pages come back if the table is not checkpointed
+  freeChunkPages();
+  size_ = 0;
+  append(compressed.data(), compressedSize);
+  size_ = logicalSize;
+  compressedSize_ = compressedSize;
+  compressedDeltas_ = compressDeltas;
+  return numPagesFreed * pageSize_;
+}
+
+void FileBuffer::decompressPages() {
+  CHECK_GT(compressedSize_, size_t(0));
+  std::vector<int8_t> data(size_);
+  read(data.data(), size_);
+  freeChunkPages();
+  compressedSize_ = 0;
+  compressedDeltas_ = false;
+  size_ = 0;
+  write(data.data(), data.size(), 0);
+}
+
 Page FileBuffer::addNewMultiPage(const int epoch) {
-  Page page = fm_->requestFreePage(pageSize_, false);
+  Page page = requestDataPage();
   MultiPage multiPage(pageSize_);
   multiPage.epochs.push_back(epoch);
   multiPage.pageVersions.push_back(page);
@@ -399,7 +810,14 @@ void FileBuffer::readMetadata(const Page& page) {
                                        // encodingType, encodingBits all as int
   fread((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   int version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  // add backward compatibility code here
+  CHECK(version == METADATA_VERSION || version == METADATA_VERSION_COMPRESSED ||
+        version == METADATA_VERSION_COMPRESSED_DELTAS);
+  compressedSize_ = 0;
+  compressedDeltas_ = version == METADATA_VERSION_COMPRESSED_DELTAS;
+  if (version != METADATA_VERSION) {
+    fread((int8_t*)&compressedSize_, sizeof(size_t), 1, f);
+  }
   has_encoder = static_cast<bool>(typeData[1]);
   if (has_encoder) {
     sql_type.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -426,7 +844,10 @@ void FileBuffer::writeMetadata(const int epoch) {
   fwrite((int8_t*)&size_, sizeof(size_t), 1, f);
   vector<int> typeData(NUM_METADATA);  // assumes we will encode hasEncoder, bufferType,
                                        // encodingType, encodingBits all as int
-  typeData[0] = METADATA_VERSION;
+  // buffers with plain pages keep the original layout
+  typeData[0] = compressedSize_ == 0 ? METADATA_VERSION
+                : compressedDeltas_    ? METADATA_VERSION_COMPRESSED_DELTAS
+                                       : METADATA_VERSION_COMPRESSED;
   typeData[1] = static_cast<int>(has_encoder);
   if (has_encoder) {
     typeData[2] = static_cast<int>(sql_type.get_type());
@@ -439,13 +860,32 @@ void FileBuffer::writeMetadata(const int epoch) {
     typeData[9] = sql_type.get_size();
   }
   fwrite((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
+  if (compressedSize_ > 0) {
+    fwrite((int8_t*)&compressedSize_, sizeof(size_t), 1, f);
+  }
   if (has_encoder) {  // redundant
     encoder->writeMetadata(f);
   }
+  fm_->getFileInfoForFileId(page.fileId)->markPageChecksumStale(page.pageNum);
   metadataPages_.epochs.push_back(epoch);
   metadataPages_.pageVersions.push_back(page);
 }
 
+void FileBuffer::setDirty() {
+  AbstractBuffer::setDirty();
+  fm_->markChunkDirty(chunkKey_);
+}
+
+void FileBuffer::setUpdated() {
+  AbstractBuffer::setUpdated();
+  fm_->markChunkDirty(chunkKey_);
+}
+
+void FileBuffer::setAppended() {
+  AbstractBuffer::setAppended();
+  fm_->markChunkDirty(chunkKey_);
+}
+
 /*
 void FileBuffer::checkpoint() {
     if (is_appended_) {
@@ -462,8 +902,16 @@ void FileBuffer::append(int8_t* src,
                         const size_t numBytes,
                         const MemoryLevel srcBufferType,
                         const int deviceId) {
-  is_dirty_ = true;
-  is_appended_ = true;
+  auto& io = io_metrics();
+  io.written_bytes.add(numBytes);
+  metrics::ScopedTimer write_timer(io.write_seconds);
+  if (isCold_) {
+    restoreFromColdStorage();
+  }
+  if (compressedSize_ > 0) {
+    decompressPages();
+  }
+  setAppended();
 
   size_t startPage = size_ / pageDataSize_;
   size_t startPageOffset = size_ % pageDataSize_;
@@ -511,7 +959,16 @@ void FileBuffer::write(int8_t* src,
   if (srcBufferType != CPU_LEVEL) {
     LOG(FATAL) << "Unsupported Buffer type";
   }
-  is_dirty_ = true;
+  auto& io = io_metrics();
+  io.written_bytes.add(numBytes);
+  metrics::ScopedTimer write_timer(io.write_seconds);
+  if (isCold_) {
+    restoreFromColdStorage();
+  }
+  if (compressedSize_ > 0) {
+    decompressPages();
+  }
+  setDirty();
   if (offset < size_) {
     is_updated_ = true;
   }
@@ -550,7 +1007,7 @@ void FileBuffer::write(int8_t* src,
                          // can't overwrite it also need to copy if we are on first or
                          // last page
       Page lastPage = multiPages_[pageNum].current();
-      page = fm_->requestFreePage(pageSize_, false);
+      page = requestDataPage();
       multiPages_[pageNum].epochs.push_back(epoch);
       multiPages_[pageNum].pageVersions.push_back(page);
       if (pageNum == startPage && startPageOffset > 0) {
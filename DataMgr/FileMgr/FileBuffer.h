@@ -25,6 +25,7 @@
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/FileMgr/Page.h"
 
+#include <deque>
 #include <iostream>
 #include <stdexcept>
 
@@ -34,6 +35,9 @@ using namespace Data_Namespace;
 
 #define NUM_METADATA 10
 #define METADATA_VERSION 0
+#define METADATA_VERSION_COMPRESSED 1  // followed by the compressed size of the data
+// as above, for the offsets of a varlen index chunk compressed as their deltas
+#define METADATA_VERSION_COMPRESSED_DELTAS 2
 
 namespace File_Namespace {
 
@@ -150,6 +154,43 @@ class FileBuffer : public AbstractBuffer {
   /// flush/checkpoint.
   bool isDirty() const override { return is_dirty_; }
 
+  /// The setters also register the chunk with the FileMgr's dirty set, so that
+  /// checkpoint only has to visit modified chunks.
+  void setDirty() override;
+  void setUpdated() override;
+  void setAppended() override;
+
+  /**
+   * Returns a pointer to the first numBytes of the buffer inside the read-only mapping of
+   * its data file, or nullptr if the buffer has unflushed changes or the bytes are not
+   * contiguous on disk. Since every page starts with a header, only buffers whose data
+   * fits in their first page qualify.
+   */
+  const int8_t* getMappedData(const size_t numBytes);
+
+  /// True if the data of the buffer lives in cold storage, only its metadata is local
+  bool isCold() const { return isCold_; }
+
+  /**
+   * Moves the data of the buffer to cold storage and frees its data pages, if the buffer
+   * is not dirty and none of its pages or metadata was written after maxEpoch. Pages
+   * that were rewritten keep older versions for rollback, such buffers stay local.
+   * Returns the number of bytes moved.
+   */
+  size_t spillToColdStorage(const int maxEpoch);
+
+  /// True if the data pages of the buffer hold its data compressed
+  bool isCompressed() const { return compressedSize_ > 0; }
+
+  /**
+   * Rewrites the data of the buffer compressed into new pages and frees the old ones, if
+   * the buffer qualifies as for spillToColdStorage() and compression saves at least a
+   * page. The offsets of the index chunks of the varlen columns are compressed as their
+   * deltas, the lengths of the values, which take far less space than the offsets.
+   * Returns the number of bytes of pages freed.
+   */
+  size_t compressPages(const int maxEpoch);
+
  private:
   // FileBuffer(const FileBuffer&);      // private copy constructor
   // FileBuffer& operator=(const FileBuffer&); // private overloaded assignment operator
@@ -165,16 +206,36 @@ class FileBuffer : public AbstractBuffer {
   void writeMetadata(const int epoch);
   void readMetadata(const Page& page);
   void calcHeaderBuffer();
+  /// Reads adjacent pages in coalesced runs, through O_DIRECT if requested. Returns
+  /// false if unavailable for this buffer, in which case the pages are read one by one.
+  bool readCoalesced(int8_t* const dst,
+                     const size_t numBytes,
+                     const size_t offset,
+                     const bool directIo);
+  /// Next free page for chunk data, taken from the reserved extent if extents are used
+  Page requestDataPage();
+  void releaseReservedPages();
+  /// Writes the data of a cold buffer back into local pages before it is modified
+  void restoreFromColdStorage();
+  /// Reads numBytes of the data pages starting at offset, as stored
+  void readPages(int8_t* const dst, const size_t numBytes, const size_t offset);
+  void readDecompressed(int8_t* const dst, const size_t numBytes, const size_t offset);
+  /// Writes the data of a compressed buffer back uncompressed before it is modified
+  void decompressPages();
 
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available
                  // files
   static size_t headerBufferOffset_;
   MultiPage metadataPages_;
   std::vector<MultiPage> multiPages_;
+  std::deque<Page> reservedPages_;  /// free pages of the current extent, in file order
   size_t pageSize_;
   size_t pageDataSize_;
   size_t reservedHeaderSize_;  // lets make this a constant now for simplicity - 128 bytes
   ChunkKey chunkKey_;
+  bool isCold_{false};
+  size_t compressedSize_{0};  /// bytes of compressed data in the pages, 0 if plain
+  bool compressedDeltas_{false};  /// the compressed data is the deltas of the offsets
 };
 
 }  // namespace File_Namespace
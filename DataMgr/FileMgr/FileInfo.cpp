@@ -15,8 +15,13 @@
  */
 
 #include "FileInfo.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <chrono>
 #include <iostream>
+#include <string>
 #include "../../Shared/File.h"
+#include "../../Shared/crc32c.h"
 #include "FileMgr.h"
 #include "Page.h"
 
@@ -38,6 +43,15 @@ FileInfo::FileInfo(FileMgr* fileMgr,
 }
 
 FileInfo::~FileInfo() {
+  if (mappedData_) {
+    munmap(mappedData_, size());
+  }
+  if (directFd_ >= 0) {
+    ::close(directFd_);
+  }
+  if (checksumFile_) {
+    close(checksumFile_);
+  }
   // close file, if applicable
   if (f) {
     close(f);
@@ -58,14 +72,309 @@ void FileInfo::initNewFile() {
 
 size_t FileInfo::write(const size_t offset, const size_t size, int8_t* buf) {
   std::lock_guard<std::mutex> lock(readWriteMutex_);
-  return File_Namespace::write(f, offset, size, buf);
+  markDirty();
+  const auto bytesWritten = File_Namespace::write(f, offset, size, buf);
+  if (checksumFile_) {
+    updatePageChecksums(offset, size, buf);
+  }
+  return bytesWritten;
 }
 
 size_t FileInfo::read(const size_t offset, const size_t size, int8_t* buf) {
   std::lock_guard<std::mutex> lock(readWriteMutex_);
+  // reads of consecutive pages skip the header of the next page
+  recordRead(offset,
+             size,
+             offset >= lastReadEnd_ && offset <= lastReadEnd_ + kPageHeaderSize);
+  lastReadEnd_ = offset + size;
   return File_Namespace::read(f, offset, size, buf);
 }
 
+void FileInfo::recordRead(const size_t offset, const size_t size, const bool sequential) {
+  if (size == 0) {
+    return;
+  }
+  bytesRead_ += size;
+  pagesRead_ += (offset + size - 1) / pageSize - offset / pageSize + 1;
+  if (sequential) {
+    ++readAheadHits_;
+  }
+}
+
+void FileInfo::updatePageChecksums(const size_t offset,
+                                   const size_t size,
+                                   const int8_t* buf) {
+  std::lock_guard<std::mutex> lock(checksumMutex_);
+  const size_t writeEnd = offset + size;
+  for (size_t pageNum = offset / pageSize; pageNum * pageSize < writeEnd; ++pageNum) {
+    const size_t dataStart = pageNum * pageSize + kPageHeaderSize;
+    const size_t start = std::max(offset, dataStart);
+    const size_t end = std::min(writeEnd, (pageNum + 1) * pageSize);
+    if (start >= end) {
+      continue;  // header only
+    }
+    CHECK_LT(pageNum, pageChecksums_.size());
+    auto& checksum = pageChecksums_[pageNum];
+    const auto data = buf + (start - offset);
+    const size_t startInPage = start - dataStart;
+    const size_t numBytes = end - start;
+    const auto staleIt = staleChecksums_.find(pageNum);
+    if (startInPage == 0) {
+      checksum.crc = crc32c::value(data, numBytes);
+      checksum.length = numBytes;
+      if (staleIt != staleChecksums_.end()) {
+        staleChecksums_.erase(staleIt);
+      }
+    } else if (staleIt == staleChecksums_.end() && checksum.length > 0 &&
+               startInPage == checksum.length) {
+      // appends continue the checksum of the page prefix
+      checksum.crc = crc32c::extend(checksum.crc, data, numBytes);
+      checksum.length += numBytes;
+    } else {
+      // recomputed from the file by syncToDisk()
+      auto& coveredLength = staleChecksums_[pageNum];
+      coveredLength = std::max(
+          coveredLength, std::max<size_t>(checksum.length, startInPage + numBytes));
+    }
+    unsavedChecksums_.insert(pageNum);
+  }
+}
+
+void FileInfo::openChecksumFile(const std::string& path, const bool isNewFile) {
+  CHECK(!checksumFile_);
+  std::vector<PageChecksum> checksums(numPages);
+  if (!isNewFile) {
+    checksumFile_ = fopen(path.c_str(), "r+b");
+  }
+  if (checksumFile_) {
+    const auto numRead =
+        fread(checksums.data(), sizeof(PageChecksum), checksums.size(), checksumFile_);
+    for (size_t pageNum = numRead; pageNum < checksums.size(); ++pageNum) {
+      checksums[pageNum] = PageChecksum{};
+    }
+    for (auto& checksum : checksums) {
+      if (checksum.length > pageSize - kPageHeaderSize) {
+        checksum = PageChecksum{};
+      }
+    }
+  } else {
+    checksumFile_ = fopen(path.c_str(), "w+b");
+    if (!checksumFile_) {
+      LOG(FATAL) << "Error trying to create file '" << path
+                 << "', the error was: " << std::strerror(errno);
+    }
+  }
+  std::lock_guard<std::mutex> lock(checksumMutex_);
+  pageChecksums_ = std::move(checksums);
+}
+
+bool FileInfo::verifyPageData(const size_t pageNum,
+                              const int8_t* data,
+                              const size_t numBytes) {
+  PageChecksum checksum;
+  {
+    std::lock_guard<std::mutex> lock(checksumMutex_);
+    if (!checksumFile_ || staleChecksums_.count(pageNum)) {
+      return true;
+    }
+    CHECK_LT(pageNum, pageChecksums_.size());
+    checksum = pageChecksums_[pageNum];
+  }
+  if (checksum.length == 0 || numBytes < checksum.length ||
+      crc32c::value(data, checksum.length) == checksum.crc) {
+    return true;
+  }
+  ++checksumFailures_;
+  LOG(ERROR) << "Checksum mismatch in page " << pageNum << " of file " << fileId << "."
+             << pageSize;
+  return false;
+}
+
+bool FileInfo::verifyStoredPage(const size_t pageNum) {
+  if (!checksumFile_) {
+    return true;
+  }
+  std::vector<int8_t> data(pageSize - kPageHeaderSize);
+  {
+    std::lock_guard<std::mutex> lock(readWriteMutex_);
+    File_Namespace::read(
+        f, pageNum * pageSize + kPageHeaderSize, data.size(), data.data());
+  }
+  return verifyPageData(pageNum, data.data(), data.size());
+}
+
+void FileInfo::invalidatePageChecksum(const size_t pageNum) {
+  std::lock_guard<std::mutex> lock(checksumMutex_);
+  if (!checksumFile_) {
+    return;
+  }
+  CHECK_LT(pageNum, pageChecksums_.size());
+  staleChecksums_.erase(pageNum);
+  pageChecksums_[pageNum] = PageChecksum{};
+  unsavedChecksums_.insert(pageNum);
+}
+
+void FileInfo::markPageChecksumStale(const size_t pageNum) {
+  std::lock_guard<std::mutex> lock(checksumMutex_);
+  if (!checksumFile_) {
+    return;
+  }
+  CHECK_LT(pageNum, pageChecksums_.size());
+  staleChecksums_[pageNum] = pageSize - kPageHeaderSize;
+  unsavedChecksums_.insert(pageNum);
+}
+
+void FileInfo::copyPageChecksum(const size_t pageNum,
+                                FileInfo& src,
+                                const size_t srcPageNum) {
+  PageChecksum checksum;
+  {
+    std::lock_guard<std::mutex> lock(src.checksumMutex_);
+    if (src.checksumFile_ && !src.staleChecksums_.count(srcPageNum)) {
+      checksum = src.pageChecksums_[srcPageNum];
+    }
+  }
+  std::lock_guard<std::mutex> lock(checksumMutex_);
+  if (!checksumFile_) {
+    return;
+  }
+  CHECK_LT(pageNum, pageChecksums_.size());
+  staleChecksums_.erase(pageNum);
+  pageChecksums_[pageNum] = checksum;
+  unsavedChecksums_.insert(pageNum);
+}
+
+int FileInfo::syncToDisk() {
+  const auto startTime = std::chrono::steady_clock::now();
+  // cleared first so that writes racing with the sync mark the file again
+  isDirty_ = false;
+  std::vector<std::pair<size_t, PageChecksum>> checksums;
+  {
+    std::lock_guard<std::mutex> lock(readWriteMutex_);
+    std::lock_guard<std::mutex> checksumLock(checksumMutex_);
+    std::vector<int8_t> data;
+    for (const auto& [pageNum, coveredLength] : staleChecksums_) {
+      data.resize(coveredLength);
+      File_Namespace::read(
+          f, pageNum * pageSize + kPageHeaderSize, coveredLength, data.data());
+      pageChecksums_[pageNum] = {crc32c::value(data.data(), coveredLength),
+                                 static_cast<uint32_t>(coveredLength)};
+    }
+    staleChecksums_.clear();
+    for (const auto pageNum : unsavedChecksums_) {
+      checksums.emplace_back(pageNum, pageChecksums_[pageNum]);
+    }
+    unsavedChecksums_.clear();
+  }
+  if (fflush(f) != 0) {
+    LOG(FATAL) << "Error trying to flush changes to disk, the error was: "
+               << std::strerror(errno);
+  }
+#ifdef __APPLE__
+  int ret = fcntl(fileno(f), 51);
+#else
+  int ret = fsync(fileno(f));
+#endif
+  // written after the data they describe is durable, so a crash can only leave a
+  // checksum that covers a prefix of what is in the file
+  if (ret == 0 && !checksums.empty()) {
+    for (auto& [pageNum, checksum] : checksums) {
+      File_Namespace::write(checksumFile_,
+                            pageNum * sizeof(PageChecksum),
+                            sizeof(PageChecksum),
+                            reinterpret_cast<int8_t*>(&checksum));
+    }
+    if (fflush(checksumFile_) != 0) {
+      LOG(FATAL) << "Error trying to flush changes to disk, the error was: "
+                 << std::strerror(errno);
+    }
+#ifdef __APPLE__
+    ret = fcntl(fileno(checksumFile_), 51);
+#else
+    ret = fsync(fileno(checksumFile_));
+#endif
+  }
+  ++numSyncs_;
+  syncMicros_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - startTime)
+                     .count();
+  return ret;
+}
+
+FileIoStats FileInfo::getIoStats() const {
+  FileIoStats stats;
+  stats.bytesRead = bytesRead_;
+  stats.pagesRead = pagesRead_;
+  stats.readAheadHits = readAheadHits_;
+  stats.numSyncs = numSyncs_;
+  stats.syncMicros = syncMicros_;
+  stats.checksumFailures = checksumFailures_;
+  return stats;
+}
+
+bool FileInfo::readDirect(const size_t offset, const size_t size, int8_t* buf) {
+#if defined(__linux__) && defined(O_DIRECT)
+  CHECK_EQ(offset % kDirectIoAlignment, size_t(0));
+  CHECK_EQ(size % kDirectIoAlignment, size_t(0));
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(directFdMutex_);
+    if (directFd_ < 0 && !directFdFailed_) {
+      // reopen through procfs, the FileInfo does not keep the path of its file
+      const auto fd_path = "/proc/self/fd/" + std::to_string(fileno(f));
+      directFd_ = ::open(fd_path.c_str(), O_RDONLY | O_DIRECT);
+      if (directFd_ < 0) {
+        LOG(WARNING) << "Direct I/O is not available for file " << fileId
+                     << ", falling back to buffered reads: " << std::strerror(errno);
+        directFdFailed_ = true;
+      }
+    }
+    fd = directFd_;
+  }
+  if (fd < 0) {
+    return false;
+  }
+  recordRead(offset, size, false);
+  {
+    // writes still buffered in the stdio stream are invisible to the direct descriptor
+    std::lock_guard<std::mutex> lock(readWriteMutex_);
+    if (fflush(f) != 0) {
+      return false;
+    }
+  }
+  size_t bytes_read = 0;
+  while (bytes_read < size) {
+    const auto ret = pread(fd, buf + bytes_read, size - bytes_read, offset + bytes_read);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    bytes_read += ret;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+const int8_t* FileInfo::getReadOnlyMapping() {
+  std::lock_guard<std::mutex> lock(mappingMutex_);
+  if (!mappedData_ && !mappingFailed_) {
+    auto ptr = mmap(nullptr, size(), PROT_READ, MAP_SHARED, fileno(f), 0);
+    if (ptr == MAP_FAILED) {
+      LOG(WARNING) << "Unable to map file " << fileId
+                   << ", chunks will be copied into the buffer pool: "
+                   << std::strerror(errno);
+      mappingFailed_ = true;
+    } else {
+      mappedData_ = static_cast<int8_t*>(ptr);
+    }
+  }
+  return mappedData_;
+}
+
 void FileInfo::openExistingFile(std::vector<HeaderInfo>& headerVec,
                                 const int fileMgrEpoch) {
   // HeaderInfo is defined in Page.h
@@ -200,6 +509,8 @@ static void sighandler(int sig) {
 #endif
 
 void FileInfo::freePage(int pageId) {
+  markDirty();
+  fileMgr->invalidateChunkIndexSnapshot();
 #define RESILIENT_PAGE_HEADER
 #ifdef RESILIENT_PAGE_HEADER
   int epoch_freed_page[2] = {DELETE_CONTINGENT, fileMgr->epoch()};
@@ -223,6 +534,19 @@ void FileInfo::freePage(int pageId) {
 #endif
 }
 
+void FileInfo::freePageImmediate(int pageId) {
+  markDirty();
+  fileMgr->invalidateChunkIndexSnapshot();
+  int zeroVal = 0;
+  {
+    std::lock_guard<std::mutex> lock(readWriteMutex_);
+    File_Namespace::write(
+        f, pageId * pageSize, sizeof(int), reinterpret_cast<int8_t*>(&zeroVal));
+  }
+  std::lock_guard<std::mutex> lock(freePagesMutex_);
+  freePages.insert(pageId);
+}
+
 int FileInfo::getFreePage() {
   // returns -1 if there is no free page
   std::lock_guard<std::mutex> lock(freePagesMutex_);
@@ -232,9 +556,39 @@ int FileInfo::getFreePage() {
   auto pageIt = freePages.begin();
   int pageNum = *pageIt;
   freePages.erase(pageIt);
+  // whatever the page held before is no longer described by its checksum
+  invalidatePageChecksum(pageNum);
   return pageNum;
 }
 
+bool FileInfo::getFreePageRun(const size_t numPages, std::deque<Page>& pages) {
+  CHECK_GT(numPages, size_t(0));
+  std::lock_guard<std::mutex> lock(freePagesMutex_);
+  auto runStartIt = freePages.begin();
+  size_t runLength = 0;
+  for (auto pageIt = freePages.begin(); pageIt != freePages.end(); ++pageIt) {
+    if (runLength == 0 || *pageIt != *std::prev(pageIt) + 1) {
+      runStartIt = pageIt;
+      runLength = 0;
+    }
+    if (++runLength == numPages) {
+      const auto runEndIt = std::next(pageIt);
+      for (auto runIt = runStartIt; runIt != runEndIt; ++runIt) {
+        pages.emplace_back(fileId, *runIt);
+        invalidatePageChecksum(*runIt);
+      }
+      freePages.erase(runStartIt, runEndIt);
+      return true;
+    }
+  }
+  return false;
+}
+
+void FileInfo::releaseUnusedPage(const size_t pageNum) {
+  std::lock_guard<std::mutex> lock(freePagesMutex_);
+  CHECK(freePages.insert(pageNum).second);
+}
+
 void FileInfo::print(bool pagesummary) {
   std::cout << "File: " << fileId << std::endl;
   std::cout << "Size: " << size() << std::endl;
@@ -18,10 +18,15 @@
 #define FILEINFO_H
 
 #include <fcntl.h>
+#include <atomic>
+#include <limits>
 #include <cstdio>
 #include <cstring>
+#include <deque>
+#include <map>
 #include <mutex>
 #include <set>
+#include <string>
 #include <vector>
 #include "../../Shared/types.h"
 #include "Logger/Logger.h"
@@ -47,6 +52,27 @@ struct Page;
  */
 #define DELETE_CONTINGENT (-1)
 
+/// Read and sync counters of a data file, summed over all files of a table by FileMgr
+struct FileIoStats {
+  size_t bytesRead{0};
+  size_t pagesRead{0};
+  /// reads that started where the previous read of the same file ended
+  size_t readAheadHits{0};
+  size_t numSyncs{0};
+  size_t syncMicros{0};
+  size_t checksumFailures{0};
+
+  FileIoStats& operator+=(const FileIoStats& other) {
+    bytesRead += other.bytesRead;
+    pagesRead += other.pagesRead;
+    readAheadHits += other.readAheadHits;
+    numSyncs += other.numSyncs;
+    syncMicros += other.syncMicros;
+    checksumFailures += other.checksumFailures;
+    return *this;
+  }
+};
+
 class FileMgr;
 struct FileInfo {
   FileMgr* fileMgr;
@@ -59,6 +85,39 @@ struct FileInfo {
   std::set<size_t> freePages;  /// set of page numbers of free pages
   std::mutex freePagesMutex_;
   std::mutex readWriteMutex_;
+  /// true if the file may have unsynced writes; new and reopened files start out dirty
+  std::atomic<bool> isDirty_{true};
+  int directFd_{-1};  /// lazily opened O_DIRECT descriptor used by readDirect()
+  bool directFdFailed_{false};
+  std::mutex directFdMutex_;
+  int8_t* mappedData_{nullptr};  /// lazily created read-only mapping of the whole file
+  bool mappingFailed_{false};
+  std::mutex mappingMutex_;
+
+  /**
+   * CRC32C of the data portion of a page, i.e. the bytes following its header. Only the
+   * first length bytes are covered: appends extend a page in place, and covering only
+   * what was written keeps a checkpointed checksum valid for the checkpointed prefix.
+   */
+  struct PageChecksum {
+    uint32_t crc{0};
+    uint32_t length{0};  /// 0 if the checksum is unknown
+  };
+  FILE* checksumFile_{nullptr};  /// one PageChecksum per page, see openChecksumFile()
+  std::vector<PageChecksum> pageChecksums_;
+  /// pages written out of order since the last sync, with the data length to cover
+  std::map<size_t, size_t> staleChecksums_;
+  /// pages whose checksum changed since the last sync
+  std::set<size_t> unsavedChecksums_;
+  std::mutex checksumMutex_;
+
+  size_t lastReadEnd_{std::numeric_limits<size_t>::max()};  /// guarded by readWriteMutex_
+  std::atomic<size_t> bytesRead_{0};
+  std::atomic<size_t> pagesRead_{0};
+  std::atomic<size_t> readAheadHits_{0};
+  std::atomic<size_t> numSyncs_{0};
+  std::atomic<size_t> syncMicros_{0};
+  std::atomic<size_t> checksumFailures_{0};
 
   /// Constructor
   FileInfo(FileMgr* fileMgr,
@@ -77,9 +136,65 @@ struct FileInfo {
 
   void freePageDeferred(int pageId);
   void freePage(int pageId);
+  /// Clears the page header and returns the page to the free list right away, only for
+  /// pages whose contents are not needed to roll back to an earlier epoch
+  void freePageImmediate(int pageId);
   int getFreePage();
+  /// Takes the first run of numPages adjacent free pages, returns false if there is none
+  bool getFreePageRun(const size_t numPages, std::deque<Page>& pages);
+  /// Returns a page that was handed out but never written back to the free list
+  void releaseUnusedPage(const size_t pageNum);
   size_t write(const size_t offset, const size_t size, int8_t* buf);
   size_t read(const size_t offset, const size_t size, int8_t* buf);
+  /**
+   * Reads size bytes at offset through a separate O_DIRECT descriptor, bypassing the OS
+   * page cache. offset, size and buf must be aligned to kDirectIoAlignment. Returns
+   * false if direct I/O is unavailable for this file or the read failed, in which case
+   * callers should fall back to read().
+   */
+  bool readDirect(const size_t offset, const size_t size, int8_t* buf);
+
+  static constexpr size_t kDirectIoAlignment{4096};
+
+  /// Bytes reserved for the header at the start of every page, see
+  /// FileBuffer::calcHeaderBuffer(). Page checksums cover the rest of the page.
+  static constexpr size_t kPageHeaderSize{32};
+
+  /**
+   * Opens the file holding the page checksums of this file, or creates it if the data
+   * file is new or has none. Checksums are only maintained and verified once it is open.
+   * Entries missing from an existing file are treated as unknown.
+   */
+  void openChecksumFile(const std::string& path, const bool isNewFile);
+
+  /**
+   * Checks numBytes of page data as read from the start of the data portion of page
+   * pageNum. Returns false, and counts a checksum failure, only if the bytes cover the
+   * page's checksummed prefix and do not match it.
+   */
+  bool verifyPageData(const size_t pageNum, const int8_t* data, const size_t numBytes);
+
+  /// Reads page pageNum back from the file and verifies it, see verifyPageData()
+  bool verifyStoredPage(const size_t pageNum);
+
+  /// Forgets the checksum of a page that is about to be reused
+  void invalidatePageChecksum(const size_t pageNum);
+
+  /// Has the next syncToDisk() recompute the checksum of a page whose data was written
+  /// to the file directly rather than through write()
+  void markPageChecksumStale(const size_t pageNum);
+
+  /// Gives page pageNum the checksum of a verbatim copy of page srcPageNum of src
+  void copyPageChecksum(const size_t pageNum, FileInfo& src, const size_t srcPageNum);
+
+  FileIoStats getIoStats() const;
+
+  /**
+   * Returns a read-only, shared mapping of the whole file, created on first use and kept
+   * until the FileInfo is destroyed, or nullptr if the file cannot be mapped. Only pages
+   * that have been checkpointed are guaranteed to be visible through the mapping.
+   */
+  const int8_t* getReadOnlyMapping();
 
   void openExistingFile(std::vector<HeaderInfo>& headerVec, const int fileMgrEpoch);
   /// Prints a summary of the file to stdout
@@ -88,17 +203,12 @@ struct FileInfo {
   /// Returns the number of bytes used by the file
   inline size_t size() { return pageSize * numPages; }
 
-  inline int syncToDisk() {
-    if (fflush(f) != 0) {
-      LOG(FATAL) << "Error trying to flush changes to disk, the error was: "
-                 << std::strerror(errno);
-    }
-#ifdef __APPLE__
-    return fcntl(fileno(f), 51);
-#else
-    return fsync(fileno(f));
-#endif
-  }
+  inline void markDirty() { isDirty_ = true; }
+  inline bool isDirty() const { return isDirty_; }
+
+  /// Flushes and fsyncs the file, then the checksums of the pages written since the
+  /// last sync. Returns 0 on success.
+  int syncToDisk();
 
   /// Returns the number of free bytes available
   inline size_t available() { return freePages.size() * pageSize; }
@@ -111,6 +221,10 @@ struct FileInfo {
 
   /// Returns the amount of used bytes; size() - available()
   inline size_t used() { return size() - available(); }
+
+ private:
+  void updatePageChecksums(const size_t offset, const size_t size, const int8_t* buf);
+  void recordRead(const size_t offset, const size_t size, const bool sequential);
 };
 }  // namespace File_Namespace
 
@@ -31,6 +31,7 @@
 #include <utility>
 #include <vector>
 
+#include <boost/crc.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/system/error_code.hpp>
@@ -42,11 +43,70 @@
 
 #define EPOCH_FILENAME "epoch"
 #define DB_META_FILENAME "dbmeta"
+#define CHUNK_INDEX_SNAPSHOT_FILENAME "chunk_index"
+#define PAGE_CHECKSUM_FILE_EXT ".crc"
+
+bool g_enable_chunk_index_snapshot{false};
+size_t g_file_compaction_interval_seconds{0};
+double g_file_compaction_min_free_fraction{0.5};
+int g_file_compaction_io_priority{7};
+size_t g_chunk_compression_min_epoch_age{10};
+size_t g_chunk_compression_interval_seconds{600};
+bool g_enable_page_checksums{true};
 
 using namespace std;
 
 namespace File_Namespace {
 
+namespace {
+
+constexpr int32_t kChunkIndexSnapshotMagic{0x43494458};  // "CIDX"
+constexpr int32_t kChunkIndexSnapshotVersion{1};
+
+template <typename T>
+void append_pod(std::vector<int8_t>& buffer, const T value) {
+  const auto bytes = reinterpret_cast<const int8_t*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+// Bounds checked reader over a snapshot read into memory
+class SnapshotReader {
+ public:
+  SnapshotReader(const std::vector<int8_t>& buffer, const size_t size)
+      : buffer_(buffer), size_(size) {}
+
+  template <typename T>
+  bool read(T& value) {
+    if (offset_ + sizeof(T) > size_) {
+      return false;
+    }
+    memcpy(&value, buffer_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  bool atEnd() const { return offset_ == size_; }
+
+ private:
+  const std::vector<int8_t>& buffer_;
+  const size_t size_;
+  size_t offset_{0};
+};
+
+void sync_directory(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(WARNING) << "Could not open directory " << path << " to sync it";
+    return;
+  }
+  if (fsync(fd) != 0) {
+    LOG(WARNING) << "Could not sync directory " << path;
+  }
+  ::close(fd);
+}
+
+}  // namespace
+
 bool headerCompare(const HeaderInfo& firstElem, const HeaderInfo& secondElem) {
   // HeaderInfo.first is a pair of Chunk key with a vector containing
   // pageId and version
@@ -145,7 +205,8 @@ void FileMgr::init(const size_t num_reader_threads) {
       LOG(FATAL) << "Specified path '" << fileMgrBasePath_
                  << "' for table data is not a directory.";
     }
-    if (epoch_ != -1) {  // if opening at previous epoch
+    const bool opening_at_previous_epoch = epoch_ != -1;
+    if (opening_at_previous_epoch) {
       int epochCopy = epoch_;
       openEpochFile(EPOCH_FILENAME);
       epoch_ = epochCopy;
@@ -161,7 +222,7 @@ void FileMgr::init(const size_t num_reader_threads) {
     int fileCount = 0;
     int threadCount = std::thread::hardware_concurrency();
     std::vector<HeaderInfo> headerVec;
-    std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
+    std::vector<DataFileDescriptor> data_files;
     for (boost::filesystem::directory_iterator fileIt(path); fileIt != endItr; ++fileIt) {
       if (boost::filesystem::is_regular_file(fileIt->status())) {
         // note that boost::filesystem leaves preceding dot on
@@ -193,28 +254,50 @@ void FileMgr::init(const size_t num_reader_threads) {
           VLOG(4) << "File id: " << fileId << " Page size: " << pageSize
                   << " Num pages: " << numPages;
 
-          file_futures.emplace_back(std::async(
-              std::launch::async, [filePath, fileId, pageSize, numPages, this] {
-                std::vector<HeaderInfo> tempHeaderVec;
-                openExistingFile(filePath, fileId, pageSize, numPages, tempHeaderVec);
-                return tempHeaderVec;
-              }));
-          fileCount++;
-          if (fileCount % threadCount == 0) {
-            processFileFutures(file_futures, headerVec);
-          }
+          data_files.push_back({fileId, pageSize, numPages, filePath});
         }
       }
     }
 
-    if (file_futures.size() > 0) {
-      processFileFutures(file_futures, headerVec);
+    // The snapshot describes the files as of the last checkpoint, so it cannot be used
+    // to open the table at an older epoch.
+    const bool loaded_from_snapshot = !opening_at_previous_epoch &&
+                                      g_enable_chunk_index_snapshot &&
+                                      loadChunkIndexSnapshot(data_files, headerVec);
+    if (!loaded_from_snapshot) {
+      // The header scan below rewrites headers of pages that were never checkpointed,
+      // after which an older snapshot would no longer describe the files.
+      removeChunkIndexSnapshot();
+      std::vector<std::future<std::vector<HeaderInfo>>> file_futures;
+      for (const auto& data_file : data_files) {
+        file_futures.emplace_back(std::async(std::launch::async, [data_file, this] {
+          std::vector<HeaderInfo> tempHeaderVec;
+          openExistingFile(data_file.path,
+                           data_file.fileId,
+                           data_file.pageSize,
+                           data_file.numPages,
+                           tempHeaderVec);
+          return tempHeaderVec;
+        }));
+        fileCount++;
+        if (fileCount % threadCount == 0) {
+          processFileFutures(file_futures, headerVec);
+        }
+      }
+
+      if (file_futures.size() > 0) {
+        processFileFutures(file_futures, headerVec);
+      }
+    } else {
+      fileCount = data_files.size();
     }
     int64_t queue_time_ms = timer_stop(clock_begin);
 
-    LOG(INFO) << "Completed Reading table's file metadata, Elapsed time : "
-              << queue_time_ms << "ms Epoch: " << epoch_ << " files read: " << fileCount
-              << " table location: '" << fileMgrBasePath_ << "'";
+    LOG(INFO) << "Completed Reading table's file metadata"
+              << (loaded_from_snapshot ? " from chunk index snapshot" : "")
+              << ", Elapsed time : " << queue_time_ms << "ms Epoch: " << epoch_
+              << " files read: " << fileCount << " table location: '"
+              << fileMgrBasePath_ << "'";
 
     /* Sort headerVec so that all HeaderInfos
      * from a chunk will be grouped together
@@ -461,7 +544,7 @@ void FileMgr::init(const std::string dataPathToConvertFrom) {
 
 void FileMgr::closeRemovePhysical() {
   for (auto file_info : files_) {
-    if (file_info->f) {
+    if (file_info && file_info->f) {
       close(file_info->f);
       file_info->f = nullptr;
     }
@@ -588,17 +671,29 @@ void FileMgr::writeAndSyncDBMetaToDisk() {
   }
 }
 
+void FileMgr::markChunkDirty(const ChunkKey& key) {
+  std::lock_guard<std::mutex> lock(dirtyChunksMutex_);
+  dirtyChunks_.insert(key);
+}
+
+size_t FileMgr::getNumDirtyChunks() const {
+  std::lock_guard<std::mutex> lock(dirtyChunksMutex_);
+  return dirtyChunks_.size();
+}
+
 void FileMgr::checkpoint() {
   VLOG(2) << "Checkpointing epoch: " << epoch_;
   mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
-  for (auto chunkIt = chunkIndex_.begin(); chunkIt != chunkIndex_.end(); ++chunkIt) {
-    /*
-    for (auto vecIt = chunkIt->first.begin(); vecIt != chunkIt->first.end(); ++vecIt) {
-        std::cout << *vecIt << ",";
-    }
-    cout << "Is dirty: " << chunkIt->second->isDirty_ << endl;
-    */
-    if (chunkIt->second->is_dirty_) {
+  std::set<ChunkKey> dirty_chunks;
+  {
+    std::lock_guard<std::mutex> lock(dirtyChunksMutex_);
+    dirty_chunks.swap(dirtyChunks_);
+  }
+  // Only chunks written since the last checkpoint need new metadata; chunks deleted in
+  // the meantime are no longer in the index.
+  for (const auto& key : dirty_chunks) {
+    auto chunkIt = chunkIndex_.find(key);
+    if (chunkIt != chunkIndex_.end() && chunkIt->second->is_dirty_) {
       chunkIt->second->writeMetadata(epoch_);
       chunkIt->second->clearDirtyBits();
     }
@@ -606,12 +701,30 @@ void FileMgr::checkpoint() {
   chunkIndexWriteLock.unlock();
 
   mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
-  for (auto fileIt = files_.begin(); fileIt != files_.end(); ++fileIt) {
-    int status = (*fileIt)->syncToDisk();
-    if (status != 0) {
-      LOG(FATAL) << "Could not sync file to disk";
+  std::vector<FileInfo*> dirty_files;
+  for (auto file_info : files_) {
+    if (file_info && file_info->isDirty()) {
+      dirty_files.push_back(file_info);
     }
   }
+  // Each file is flushed and fsynced exactly once, spread across the reader threads.
+  const size_t num_sync_threads =
+      std::max(size_t(1), std::min(num_reader_threads_, dirty_files.size()));
+  std::vector<std::future<void>> sync_futures;
+  for (size_t thread_idx = 0; thread_idx < num_sync_threads; ++thread_idx) {
+    sync_futures.emplace_back(
+        std::async(std::launch::async, [&dirty_files, thread_idx, num_sync_threads] {
+          for (size_t i = thread_idx; i < dirty_files.size(); i += num_sync_threads) {
+            if (dirty_files[i]->syncToDisk() != 0) {
+              LOG(FATAL) << "Could not sync file to disk";
+            }
+          }
+        }));
+  }
+  for (auto& sync_future : sync_futures) {
+    sync_future.get();
+  }
+  read_lock.unlock();
 
   writeAndSyncEpochToDisk();
 
@@ -620,6 +733,453 @@ void FileMgr::checkpoint() {
     free_page.first->freePageDeferred(free_page.second);
   }
   free_pages.clear();
+  freePagesWriteLock.unlock();
+
+  if (g_enable_chunk_index_snapshot) {
+    writeChunkIndexSnapshot();
+  }
+}
+
+size_t FileMgr::compactDataFiles(const double minFreeFraction) {
+  mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
+  if (getNumDirtyChunks() > 0) {
+    return 0;
+  }
+  {
+    // pages freed since the last checkpoint are still needed for rollback
+    mapd_shared_lock<mapd_shared_mutex> freePagesReadLock(mutex_free_page);
+    if (!free_pages.empty()) {
+      return 0;
+    }
+  }
+  std::lock_guard<std::mutex> pageLock(getPageMutex_);
+  std::map<int, std::vector<Page*>> pageRefsByFileId;
+  for (auto& [chunkKey, fileBuffer] : chunkIndex_) {
+    fileBuffer->releaseReservedPages();
+    for (auto& page : fileBuffer->metadataPages_.pageVersions) {
+      pageRefsByFileId[page.fileId].push_back(&page);
+    }
+    for (auto& multiPage : fileBuffer->multiPages_) {
+      for (auto& page : multiPage.pageVersions) {
+        pageRefsByFileId[page.fileId].push_back(&page);
+      }
+    }
+  }
+
+  std::map<size_t, std::vector<FileInfo*>> filesByPageSize;
+  for (const auto& [pageSize, fileId] : fileIndex_) {
+    filesByPageSize[pageSize].push_back(files_[fileId]);
+  }
+  size_t numBytesRemoved = 0;
+  for (auto& [pageSize, files] : filesByPageSize) {
+    size_t numPages = 0;
+    size_t numUsedPages = 0;
+    for (const auto fileInfo : files) {
+      numPages += fileInfo->numPages;
+      numUsedPages += fileInfo->numPages - fileInfo->numFreePages();
+    }
+    if (files.size() < 2 || numPages - numUsedPages < minFreeFraction * numPages) {
+      continue;
+    }
+    // Keep the fullest files that can hold every used page, and drain the others
+    std::sort(files.begin(), files.end(), [](FileInfo* lhs, FileInfo* rhs) {
+      const auto lhsUsed = lhs->numPages - lhs->numFreePages();
+      const auto rhsUsed = rhs->numPages - rhs->numFreePages();
+      return lhsUsed != rhsUsed ? lhsUsed > rhsUsed : lhs->fileId < rhs->fileId;
+    });
+    std::vector<FileInfo*> targetFiles;
+    std::vector<FileInfo*> sourceFiles;
+    size_t targetCapacity = 0;
+    for (const auto fileInfo : files) {
+      const auto numUsed = fileInfo->numPages - fileInfo->numFreePages();
+      if (targetCapacity < numUsedPages ||
+          pageRefsByFileId[fileInfo->fileId].size() != numUsed) {
+        // files with pages no chunk refers to are left alone rather than lose them
+        targetFiles.push_back(fileInfo);
+        targetCapacity += fileInfo->numPages;
+      } else {
+        sourceFiles.push_back(fileInfo);
+      }
+    }
+    if (sourceFiles.empty()) {
+      continue;
+    }
+    invalidateChunkIndexSnapshot();
+
+    std::vector<int8_t> pageBuffer(pageSize);
+    auto targetIt = targetFiles.begin();
+    for (const auto sourceFile : sourceFiles) {
+      for (auto pageRef : pageRefsByFileId[sourceFile->fileId]) {
+        int targetPageNum = -1;
+        while (targetIt != targetFiles.end() &&
+               (targetPageNum = (*targetIt)->getFreePage()) == -1) {
+          ++targetIt;
+        }
+        CHECK(targetIt != targetFiles.end());
+        sourceFile->read(pageRef->pageNum * pageSize, pageSize, pageBuffer.data());
+        (*targetIt)->write(targetPageNum * pageSize, pageSize, pageBuffer.data());
+        (*targetIt)->copyPageChecksum(targetPageNum, *sourceFile, pageRef->pageNum);
+        *pageRef = Page((*targetIt)->fileId, targetPageNum);
+      }
+    }
+    for (const auto targetFile : targetFiles) {
+      if (targetFile->isDirty() && targetFile->syncToDisk() != 0) {
+        LOG(FATAL) << "Could not sync file to disk";
+      }
+    }
+    for (const auto sourceFile : sourceFiles) {
+      numBytesRemoved += sourceFile->size();
+      removeFile(sourceFile);
+    }
+  }
+  if (numBytesRemoved > 0) {
+    sync_directory(fileMgrBasePath_);
+    LOG(INFO) << "Compacted data files of table (" << fileMgrKey_.first << ", "
+              << fileMgrKey_.second << "), removed " << numBytesRemoved << " bytes";
+  }
+  return numBytesRemoved;
+}
+
+FileIoStats FileMgr::getIoStats() const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
+  auto stats = removedFilesIoStats_;
+  for (const auto fileInfo : files_) {
+    if (fileInfo) {
+      stats += fileInfo->getIoStats();
+    }
+  }
+  return stats;
+}
+
+size_t FileMgr::spillColdChunks(const size_t minEpochAge) {
+  if (!getColdStorage()) {
+    return 0;
+  }
+  mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
+  if (static_cast<size_t>(epoch_) <= minEpochAge) {
+    return 0;
+  }
+  const int maxEpoch = epoch_ - static_cast<int>(minEpochAge);
+  size_t numBytesSpilled = 0;
+  size_t numChunksSpilled = 0;
+  for (auto& [chunkKey, fileBuffer] : chunkIndex_) {
+    const auto numBytes = fileBuffer->spillToColdStorage(maxEpoch);
+    if (numBytes > 0) {
+      numBytesSpilled += numBytes;
+      ++numChunksSpilled;
+    }
+  }
+  if (numChunksSpilled > 0) {
+    LOG(INFO) << "Moved " << numChunksSpilled << " chunks (" << numBytesSpilled
+              << " bytes) of table (" << fileMgrKey_.first << ", " << fileMgrKey_.second
+              << ") to " << getColdStorage()->getUrl();
+  }
+  return numBytesSpilled;
+}
+
+size_t FileMgr::compressChunks(const size_t minEpochAge) {
+  mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(chunkIndexMutex_);
+  if (static_cast<size_t>(epoch_) <= minEpochAge) {
+    return 0;
+  }
+  const int maxEpoch = epoch_ - static_cast<int>(minEpochAge);
+  size_t numBytesFreed = 0;
+  size_t numChunksCompressed = 0;
+  for (auto& [chunkKey, fileBuffer] : chunkIndex_) {
+    const auto numBytes = fileBuffer->compressPages(maxEpoch);
+    if (numBytes > 0) {
+      numBytesFreed += numBytes;
+      ++numChunksCompressed;
+    }
+  }
+  if (numChunksCompressed > 0) {
+    LOG(INFO) << "Compressed " << numChunksCompressed << " chunks of table ("
+              << fileMgrKey_.first << ", " << fileMgrKey_.second << "), freeing "
+              << numBytesFreed << " bytes of pages";
+  }
+  return numBytesFreed;
+}
+
+ColdStorage* FileMgr::getColdStorage() const {
+  return gfm_->getColdStorage();
+}
+
+std::string FileMgr::getColdStorageKeyPrefix(const std::pair<int, int>& fileMgrKey) {
+  return "table_" + std::to_string(fileMgrKey.first) + "_" +
+         std::to_string(fileMgrKey.second) + "/";
+}
+
+std::string FileMgr::getColdStorageKey(const ChunkKey& key) const {
+  CHECK_GT(key.size(), size_t(2));
+  std::string objectKey = getColdStorageKeyPrefix(fileMgrKey_) + "chunk";
+  for (size_t i = 2; i < key.size(); ++i) {
+    objectKey += "_" + std::to_string(key[i]);
+  }
+  return objectKey;
+}
+
+void FileMgr::readColdChunkData(const ChunkKey& key,
+                                int8_t* dst,
+                                const size_t numBytes,
+                                const size_t offset) const {
+  auto coldStorage = getColdStorage();
+  if (!coldStorage) {
+    throw std::runtime_error("Data of chunk " + showChunk(key) +
+                             " was moved to cold storage, but no cold storage url is "
+                             "configured.");
+  }
+  coldStorage->getObject(getColdStorageKey(key), dst, numBytes, offset);
+}
+
+void FileMgr::writeChunkIndexSnapshot() {
+  // Any page allocated or freed from here on makes the snapshot stale
+  const auto page_layout_version = pageLayoutVersion_.load();
+  const int checkpointed_epoch = epoch_ - 1;  // writeAndSyncEpochToDisk() bumped epoch_
+
+  std::vector<int8_t> buffer;
+  append_pod(buffer, kChunkIndexSnapshotMagic);
+  append_pod(buffer, kChunkIndexSnapshotVersion);
+  append_pod(buffer, static_cast<int32_t>(checkpointed_epoch));
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(files_rw_mutex_);
+    // files removed by compactDataFiles() leave holes in files_
+    append_pod(buffer,
+               static_cast<uint64_t>(std::count_if(
+                   files_.begin(), files_.end(), [](FileInfo* f) { return f; })));
+    for (const auto file_info : files_) {
+      if (!file_info) {
+        continue;
+      }
+      append_pod(buffer, static_cast<int32_t>(file_info->fileId));
+      append_pod(buffer, static_cast<uint64_t>(file_info->pageSize));
+      append_pod(buffer, static_cast<uint64_t>(file_info->numPages));
+    }
+  }
+  {
+    mapd_shared_lock<mapd_shared_mutex> chunk_index_read_lock(chunkIndexMutex_);
+    std::vector<HeaderInfo> headers;
+    for (const auto& [chunk_key, file_buffer] : chunkIndex_) {
+      const auto& metadata_pages = file_buffer->metadataPages_;
+      for (size_t i = 0; i < metadata_pages.pageVersions.size(); ++i) {
+        headers.emplace_back(
+            chunk_key, -1, metadata_pages.epochs[i], metadata_pages.pageVersions[i]);
+      }
+      for (size_t page_id = 0; page_id < file_buffer->multiPages_.size(); ++page_id) {
+        const auto& multi_page = file_buffer->multiPages_[page_id];
+        for (size_t i = 0; i < multi_page.pageVersions.size(); ++i) {
+          headers.emplace_back(chunk_key,
+                               static_cast<int>(page_id),
+                               multi_page.epochs[i],
+                               multi_page.pageVersions[i]);
+        }
+      }
+    }
+    append_pod(buffer, static_cast<uint64_t>(headers.size()));
+    for (const auto& header : headers) {
+      if (header.versionEpoch > checkpointed_epoch) {
+        // written after the checkpoint, the startup scan would reclaim this page
+        return;
+      }
+      append_pod(buffer, static_cast<uint32_t>(header.chunkKey.size()));
+      for (const auto key_elem : header.chunkKey) {
+        append_pod(buffer, static_cast<int32_t>(key_elem));
+      }
+      append_pod(buffer, static_cast<int32_t>(header.pageId));
+      append_pod(buffer, static_cast<int32_t>(header.versionEpoch));
+      append_pod(buffer, static_cast<int32_t>(header.page.fileId));
+      append_pod(buffer, static_cast<uint64_t>(header.page.pageNum));
+    }
+  }
+  boost::crc_32_type crc;
+  crc.process_bytes(buffer.data(), buffer.size());
+  append_pod(buffer, static_cast<uint32_t>(crc.checksum()));
+
+  // Written to a temporary file and renamed, so a crash never leaves a partial snapshot
+  const std::string snapshot_path =
+      fileMgrBasePath_ + "/" + CHUNK_INDEX_SNAPSHOT_FILENAME;
+  const std::string temp_path = snapshot_path + ".tmp";
+  FILE* f = fopen(temp_path.c_str(), "wb");
+  if (!f) {
+    LOG(WARNING) << "Could not create chunk index snapshot " << temp_path;
+    return;
+  }
+  const bool written = fwrite(buffer.data(), 1, buffer.size(), f) == buffer.size() &&
+                       fflush(f) == 0 && fsync(fileno(f)) == 0;
+  fclose(f);
+  boost::system::error_code ec;
+  if (!written) {
+    LOG(WARNING) << "Could not write chunk index snapshot " << temp_path;
+    boost::filesystem::remove(temp_path, ec);
+    return;
+  }
+
+  std::lock_guard<std::mutex> snapshot_lock(chunkIndexSnapshotMutex_);
+  // Set before the version check: a concurrent page allocation either bumped the
+  // version already, or will see the flag and remove the snapshot once we are done.
+  chunkIndexSnapshotValid_ = true;
+  if (pageLayoutVersion_ != page_layout_version ||
+      rename(temp_path.c_str(), snapshot_path.c_str()) != 0) {
+    chunkIndexSnapshotValid_ = false;
+    boost::filesystem::remove(temp_path, ec);
+    return;
+  }
+  sync_directory(fileMgrBasePath_);
+}
+
+bool FileMgr::loadChunkIndexSnapshot(const std::vector<DataFileDescriptor>& data_files,
+                                     std::vector<HeaderInfo>& headerVec) {
+  const std::string snapshot_path =
+      fileMgrBasePath_ + "/" + CHUNK_INDEX_SNAPSHOT_FILENAME;
+  boost::system::error_code ec;
+  const auto snapshot_size = boost::filesystem::file_size(snapshot_path, ec);
+  if (ec || snapshot_size < sizeof(uint32_t)) {
+    return false;
+  }
+  std::vector<int8_t> buffer(snapshot_size);
+  {
+    FILE* f = fopen(snapshot_path.c_str(), "rb");
+    if (!f) {
+      return false;
+    }
+    const bool read_ok = fread(buffer.data(), 1, buffer.size(), f) == buffer.size();
+    fclose(f);
+    if (!read_ok) {
+      return false;
+    }
+  }
+  const size_t payload_size = snapshot_size - sizeof(uint32_t);
+  uint32_t stored_checksum;
+  memcpy(&stored_checksum, buffer.data() + payload_size, sizeof(uint32_t));
+  boost::crc_32_type crc;
+  crc.process_bytes(buffer.data(), payload_size);
+  if (crc.checksum() != stored_checksum) {
+    LOG(WARNING) << "Chunk index snapshot " << snapshot_path
+                 << " is corrupt, scanning page headers instead";
+    return false;
+  }
+
+  SnapshotReader reader(buffer, payload_size);
+  int32_t magic, version, snapshot_epoch;
+  if (!reader.read(magic) || magic != kChunkIndexSnapshotMagic ||
+      !reader.read(version) || version != kChunkIndexSnapshotVersion ||
+      !reader.read(snapshot_epoch)) {
+    return false;
+  }
+  if (snapshot_epoch != epoch_ - 1) {
+    VLOG(1) << "Chunk index snapshot " << snapshot_path << " is from epoch "
+            << snapshot_epoch << ", table is at epoch " << epoch_ - 1;
+    return false;
+  }
+
+  // The files on disk must be exactly the ones the snapshot was taken of
+  std::map<int, const DataFileDescriptor*> files_by_id;
+  for (const auto& data_file : data_files) {
+    files_by_id.emplace(data_file.fileId, &data_file);
+  }
+  uint64_t num_files;
+  if (!reader.read(num_files) || num_files != files_by_id.size()) {
+    return false;
+  }
+  for (uint64_t i = 0; i < num_files; ++i) {
+    int32_t file_id;
+    uint64_t page_size, num_pages;
+    if (!reader.read(file_id) || !reader.read(page_size) || !reader.read(num_pages)) {
+      return false;
+    }
+    const auto it = files_by_id.find(file_id);
+    if (it == files_by_id.end() || it->second->pageSize != page_size ||
+        it->second->numPages != num_pages) {
+      return false;
+    }
+  }
+
+  std::map<int, std::vector<bool>> used_pages;
+  for (const auto& [file_id, data_file] : files_by_id) {
+    used_pages[file_id].resize(data_file->numPages, false);
+  }
+  uint64_t num_headers;
+  if (!reader.read(num_headers)) {
+    return false;
+  }
+  std::vector<HeaderInfo> snapshot_headers;
+  snapshot_headers.reserve(num_headers);
+  for (uint64_t i = 0; i < num_headers; ++i) {
+    uint32_t key_size;
+    if (!reader.read(key_size)) {
+      return false;
+    }
+    ChunkKey chunk_key(key_size);
+    for (auto& key_elem : chunk_key) {
+      int32_t value;
+      if (!reader.read(value)) {
+        return false;
+      }
+      key_elem = value;
+    }
+    int32_t page_id, version_epoch, file_id;
+    uint64_t page_num;
+    if (!reader.read(page_id) || !reader.read(version_epoch) || !reader.read(file_id) ||
+        !reader.read(page_num)) {
+      return false;
+    }
+    auto used_it = used_pages.find(file_id);
+    if (used_it == used_pages.end() || page_num >= used_it->second.size()) {
+      return false;
+    }
+    used_it->second[page_num] = true;
+    snapshot_headers.emplace_back(
+        chunk_key, page_id, version_epoch, Page(file_id, page_num));
+  }
+  if (!reader.atEnd()) {
+    return false;
+  }
+
+  for (const auto& [file_id, data_file] : files_by_id) {
+    FILE* f = open(data_file->path);
+    FileInfo* fInfo = new FileInfo(this,
+                                   file_id,
+                                   f,
+                                   data_file->pageSize,
+                                   data_file->numPages,
+                                   false);  // false means don't init file
+    const auto& used = used_pages[file_id];
+    for (size_t page_num = 0; page_num < used.size(); ++page_num) {
+      if (!used[page_num]) {
+        fInfo->freePages.insert(page_num);
+      }
+    }
+    openChecksumFile(fInfo, false);
+    mapd_unique_lock<mapd_shared_mutex> write_lock(files_rw_mutex_);
+    if (file_id >= static_cast<int>(files_.size())) {
+      files_.resize(file_id + 1);
+    }
+    files_[file_id] = fInfo;
+    fileIndex_.insert(std::pair<size_t, int>(data_file->pageSize, file_id));
+  }
+  headerVec.insert(headerVec.end(), snapshot_headers.begin(), snapshot_headers.end());
+  chunkIndexSnapshotValid_ = true;
+  return true;
+}
+
+void FileMgr::invalidateChunkIndexSnapshot() {
+  ++pageLayoutVersion_;
+  if (!chunkIndexSnapshotValid_) {
+    return;
+  }
+  std::lock_guard<std::mutex> snapshot_lock(chunkIndexSnapshotMutex_);
+  if (chunkIndexSnapshotValid_.exchange(false)) {
+    removeChunkIndexSnapshot();
+  }
+}
+
+void FileMgr::removeChunkIndexSnapshot() {
+  const std::string snapshot_path =
+      fileMgrBasePath_ + "/" + CHUNK_INDEX_SNAPSHOT_FILENAME;
+  boost::system::error_code ec;
+  if (boost::filesystem::remove(snapshot_path, ec)) {
+    // the removal has to be durable before headers start changing
+    sync_directory(fileMgrBasePath_);
+  }
 }
 
 AbstractBuffer* FileMgr::createBuffer(const ChunkKey& key,
@@ -708,6 +1268,15 @@ AbstractBuffer* FileMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
   return chunkIt->second;
 }
 
+const int8_t* FileMgr::getMappedChunkData(const ChunkKey& key, const size_t numBytes) {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  auto chunkIt = chunkIndex_.find(key);
+  if (chunkIt == chunkIndex_.end()) {
+    return nullptr;
+  }
+  return chunkIt->second->getMappedData(numBytes);
+}
+
 void FileMgr::fetchBuffer(const ChunkKey& key,
                           AbstractBuffer* destBuffer,
                           const size_t numBytes) {
@@ -822,6 +1391,7 @@ void FileMgr::free(AbstractBuffer* buffer) {
 
 Page FileMgr::requestFreePage(size_t pageSize, const bool isMetadata) {
   std::lock_guard<std::mutex> lock(getPageMutex_);
+  invalidateChunkIndexSnapshot();
 
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   int pageNum = -1;
@@ -833,12 +1403,7 @@ Page FileMgr::requestFreePage(size_t pageSize, const bool isMetadata) {
     }
   }
   // if here then we need to add a file
-  FileInfo* fileInfo;
-  if (isMetadata) {
-    fileInfo = createFile(pageSize, MAX_FILE_N_METADATA_PAGES);
-  } else {
-    fileInfo = createFile(pageSize, MAX_FILE_N_PAGES);
-  }
+  FileInfo* fileInfo = createFile(pageSize, getNumPagesPerFile(pageSize, isMetadata));
   pageNum = fileInfo->getFreePage();
   CHECK(pageNum != -1);
   return (Page(fileInfo->fileId, pageNum));
@@ -851,6 +1416,7 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
   // not used currently
   // @todo add method to FileInfo to get more than one page
   std::lock_guard<std::mutex> lock(getPageMutex_);
+  invalidateChunkIndexSnapshot();
   auto candidateFiles = fileIndex_.equal_range(pageSize);
   size_t numPagesNeeded = numPagesRequested;
   for (auto fileIt = candidateFiles.first; fileIt != candidateFiles.second; ++fileIt) {
@@ -868,12 +1434,7 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
     }
   }
   while (numPagesNeeded > 0) {
-    FileInfo* fileInfo;
-    if (isMetadata) {
-      fileInfo = createFile(pageSize, MAX_FILE_N_METADATA_PAGES);
-    } else {
-      fileInfo = createFile(pageSize, MAX_FILE_N_PAGES);
-    }
+    FileInfo* fileInfo = createFile(pageSize, getNumPagesPerFile(pageSize, isMetadata));
     int pageNum;
     do {
       pageNum = fileInfo->getFreePage();
@@ -889,6 +1450,35 @@ void FileMgr::requestFreePages(size_t numPagesRequested,
   CHECK(pages.size() == numPagesRequested);
 }
 
+void FileMgr::requestFreeExtent(const size_t pageSize,
+                                const size_t numPages,
+                                std::deque<Page>& pages) {
+  std::lock_guard<std::mutex> lock(getPageMutex_);
+  invalidateChunkIndexSnapshot();
+  auto candidateFiles = fileIndex_.equal_range(pageSize);
+  for (auto fileIt = candidateFiles.first; fileIt != candidateFiles.second; ++fileIt) {
+    if (files_[fileIt->second]->getFreePageRun(numPages, pages)) {
+      return;
+    }
+  }
+  FileInfo* fileInfo = createFile(pageSize, getNumPagesPerFile(pageSize, false));
+  CHECK(fileInfo->getFreePageRun(numPages, pages));
+}
+
+size_t FileMgr::getNumPagesPerExtent(const size_t pageSize) const {
+  CHECK_GT(pageSize, size_t(0));
+  return std::max(extentSize_ / pageSize, size_t(1));
+}
+
+size_t FileMgr::getNumPagesPerFile(const size_t pageSize, const bool isMetadata) const {
+  if (isMetadata) {
+    return MAX_FILE_N_METADATA_PAGES;
+  }
+  // round up so that extents never straddle two files
+  const auto pagesPerExtent = getNumPagesPerExtent(pageSize);
+  return (MAX_FILE_N_PAGES + pagesPerExtent - 1) / pagesPerExtent * pagesPerExtent;
+}
+
 FileInfo* FileMgr::openExistingFile(const std::string& path,
                                     const int fileId,
                                     const size_t pageSize,
@@ -897,6 +1487,7 @@ FileInfo* FileMgr::openExistingFile(const std::string& path,
   FILE* f = open(path);
   FileInfo* fInfo = new FileInfo(
       this, fileId, f, pageSize, numPages, false);  // false means don't init file
+  openChecksumFile(fInfo, false);
 
   fInfo->openExistingFile(headerVec, epoch_);
   mapd_unique_lock<mapd_shared_mutex> write_lock(files_rw_mutex_);
@@ -927,6 +1518,7 @@ FileInfo* FileMgr::createFile(const size_t pageSize, const size_t numPages) {
   FileInfo* fInfo =
       new FileInfo(this, fileId, f, pageSize, numPages, true);  // true means init file
   CHECK(fInfo);
+  openChecksumFile(fInfo, true);
 
   mapd_unique_lock<mapd_shared_mutex> write_lock(files_rw_mutex_);
   // update file manager data structures
@@ -937,6 +1529,48 @@ FileInfo* FileMgr::createFile(const size_t pageSize, const size_t numPages) {
   return fInfo;
 }
 
+void FileMgr::openChecksumFile(FileInfo* fileInfo, const bool isNewFile) {
+  if (g_enable_page_checksums) {
+    fileInfo->openChecksumFile(getChecksumFilePath(fileInfo->fileId, fileInfo->pageSize),
+                               isNewFile);
+  }
+}
+
+std::string FileMgr::getChecksumFilePath(const int fileId, const size_t pageSize) const {
+  return fileMgrBasePath_ + "/" + std::to_string(fileId) + "." +
+         std::to_string(pageSize) + PAGE_CHECKSUM_FILE_EXT;
+}
+
+void FileMgr::removeFile(FileInfo* fileInfo) {
+  const auto path = fileMgrBasePath_ + "/" + std::to_string(fileInfo->fileId) + "." +
+                    std::to_string(fileInfo->pageSize) + std::string(MAPD_FILE_EXT);
+  // removed first, a data file without checksums is still readable
+  const auto checksumPath = getChecksumFilePath(fileInfo->fileId, fileInfo->pageSize);
+  {
+    mapd_unique_lock<mapd_shared_mutex> write_lock(files_rw_mutex_);
+    auto candidateFiles = fileIndex_.equal_range(fileInfo->pageSize);
+    for (auto fileIt = candidateFiles.first; fileIt != candidateFiles.second; ++fileIt) {
+      if (fileIt->second == fileInfo->fileId) {
+        fileIndex_.erase(fileIt);
+        break;
+      }
+    }
+    files_[fileInfo->fileId] = nullptr;
+    removedFilesIoStats_ += fileInfo->getIoStats();
+  }
+  delete fileInfo;
+  boost::system::error_code ec;
+  boost::filesystem::remove(checksumPath, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not remove checksum file " << checksumPath << ": "
+                 << ec.message();
+  }
+  boost::filesystem::remove(path, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not remove data file " << path << ": " << ec.message();
+  }
+}
+
 FILE* FileMgr::getFileForFileId(const int fileId) {
   CHECK(fileId >= 0 && static_cast<size_t>(fileId) < files_.size());
   return files_[fileId]->f;
@@ -964,9 +1598,8 @@ void FileMgr::getChunkMetadataVec(ChunkMetadataVector& chunkMetadataVec) {
 
 void FileMgr::getChunkMetadataVecForKeyPrefix(ChunkMetadataVector& chunkMetadataVec,
                                               const ChunkKey& keyPrefix) {
-  mapd_unique_lock<mapd_shared_mutex> chunkIndexWriteLock(
-      chunkIndexMutex_);  // is this guarding the right structure?  it look slike we oly
-                          // read here for chunk
+  // only reads the index, concurrent lookups must not serialize on it
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
   auto chunkIt = chunkIndex_.lower_bound(keyPrefix);
   if (chunkIt == chunkIndex_.end()) {
     return;  // throw?
@@ -25,15 +25,18 @@
 
 #pragma once
 
+#include <atomic>
 #include <future>
 #include <iostream>
 #include <map>
 #include <mutex>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/AbstractBufferMgr.h"
+#include "DataMgr/FileMgr/ColdStorage.h"
 #include "DataMgr/FileMgr/FileBuffer.h"
 #include "DataMgr/FileMgr/FileInfo.h"
 #include "DataMgr/FileMgr/Page.h"
@@ -78,6 +81,14 @@ using Chunk = FileBuffer;
  */
 using ChunkKeyToChunkMap = std::map<ChunkKey, FileBuffer*>;
 
+/// A data file found in the table directory at startup
+struct DataFileDescriptor {
+  int fileId;
+  size_t pageSize;
+  size_t numPages;
+  std::string path;
+};
+
 /**
  * @class   FileMgr
  * @brief
@@ -127,6 +138,9 @@ class FileMgr : public AbstractBufferMgr {  // implements
                    AbstractBuffer* destBuffer,
                    const size_t numBytes) override;
 
+  /// Zero-copy access to a checkpointed chunk, see FileBuffer::getMappedData()
+  const int8_t* getMappedChunkData(const ChunkKey& key, const size_t numBytes);
+
   /**
    * @brief Puts the contents of d into the Chunk with the given key.
    * @param key - Unique identifier for a Chunk.
@@ -154,6 +168,19 @@ class FileMgr : public AbstractBufferMgr {  // implements
 
   inline FileInfo* getFileInfoForFileId(const int fileId) { return files_[fileId]; }
 
+  /// Records a chunk as modified so the next checkpoint writes out its metadata
+  void markChunkDirty(const ChunkKey& key);
+  size_t getNumDirtyChunks() const;
+
+  /**
+   * @brief Removes the chunk index snapshot once page headers on disk diverge from it.
+   *
+   * Called before any page is allocated or freed; only the first call after the
+   * snapshot was written or loaded touches the file system.
+   */
+  void invalidateChunkIndexSnapshot();
+  bool hasValidChunkIndexSnapshot() const { return chunkIndexSnapshotValid_; }
+
   void init(const size_t num_reader_threads);
   void init(const std::string dataPathToConvertFrom);
 
@@ -182,16 +209,86 @@ class FileMgr : public AbstractBufferMgr {  // implements
                         std::vector<Page>& pages,
                         const bool isMetadata);
 
+  /**
+   * @brief Obtains numPages adjacent free data pages of the given size.
+   *
+   * Takes the first long enough run of free pages from the existing files and creates a
+   * new file if there is none, so that the pages of an extent can be read in one I/O.
+   */
+  void requestFreeExtent(const size_t pageSize,
+                         const size_t numPages,
+                         std::deque<Page>& pages);
+
+  /**
+   * Sets how many bytes of data pages a chunk reserves contiguously at a time, 0 for one
+   * page at a time. Data files are sized to hold a whole number of extents.
+   */
+  void setExtentSize(const size_t extentSize) { extentSize_ = extentSize; }
+  size_t getNumPagesPerExtent(const size_t pageSize) const;
+
   void getChunkMetadataVec(ChunkMetadataVector& chunkMetadataVec) override;
   void getChunkMetadataVecForKeyPrefix(ChunkMetadataVector& chunkMetadataVec,
                                        const ChunkKey& keyPrefix) override;
 
   /**
-   * @brief Fsyncs data files, writes out epoch and
-   * fsyncs that
+   * @brief Writes metadata for the chunks modified since the last checkpoint, fsyncs
+   * the data files they touched in parallel, then writes out epoch and fsyncs that
    */
 
   void checkpoint() override;
+
+  /**
+   * @brief Moves the pages out of sparsely used data files, then deletes those files.
+   *
+   * Runs for each page size with at least minFreeFraction of its pages free. Every page
+   * version, including those kept for rollback, is copied together with its header and
+   * epoch into free pages of the densest files. Those files are synced before the
+   * drained ones are removed, and duplicates left by a crash in between are dropped on
+   * the next start. Skipped while there are uncheckpointed changes. Callers must hold
+   * the table's data write lock.
+   *
+   * @return The number of bytes of data files removed.
+   */
+  size_t compactDataFiles(const double minFreeFraction);
+
+  /**
+   * @brief Moves the data of chunks not written in the last minEpochAge epochs to the
+   * cold storage of the GlobalFileMgr, see FileBuffer::spillToColdStorage().
+   *
+   * The metadata of those chunks stays local and their data is read back from cold
+   * storage on access. The freed pages are reused after the next checkpoint. Callers
+   * must hold the table's data write lock.
+   *
+   * @return The number of bytes of chunk data moved.
+   */
+  size_t spillColdChunks(const size_t minEpochAge);
+
+  /**
+   * @brief Rewrites the data of chunks not written in the last minEpochAge epochs into
+   * fewer pages, compressed, see FileBuffer::compressPages().
+   *
+   * Reads decompress the whole chunk, the first write decompresses its pages again. The
+   * freed pages are reused after the next checkpoint. Callers must hold the table's data
+   * write lock.
+   *
+   * @return The number of bytes of pages freed.
+   */
+  size_t compressChunks(const size_t minEpochAge);
+
+  /// Read, sync and checksum counters summed over the data files of the table
+  FileIoStats getIoStats() const;
+
+  /// Cold storage of the GlobalFileMgr, nullptr if none is configured
+  ColdStorage* getColdStorage() const;
+  /// Key of the cold storage object holding the data of a chunk of this table
+  std::string getColdStorageKey(const ChunkKey& key) const;
+  /// Common prefix of the keys of a table's cold storage objects
+  static std::string getColdStorageKeyPrefix(const std::pair<int, int>& fileMgrKey);
+  void readColdChunkData(const ChunkKey& key,
+                         int8_t* dst,
+                         const size_t numBytes,
+                         const size_t offset) const;
+
   void checkpoint(const int db_id, const int tb_id) override {
     LOG(FATAL) << "Operation not supported, api checkpoint() should be used instead";
   }
@@ -240,8 +337,11 @@ class FileMgr : public AbstractBufferMgr {  // implements
                                   /// this FileMgr
   std::vector<FileInfo*> files_;  /// A vector of files accessible via a file identifier.
   PageSizeFileMMap fileIndex_;    /// Maps page sizes to FileInfo objects.
+  FileIoStats removedFilesIoStats_;  /// I/O of files removed by compaction, guarded by
+                                     /// files_rw_mutex_
   size_t num_reader_threads_;     /// number of threads used when loading data
   size_t defaultPageSize_;
+  std::atomic<size_t> extentSize_{0};  /// bytes of data pages reserved per chunk at once
   unsigned nextFileId_;  /// the index of the next file id
   int epoch_;            /// the current epoch (time of last checkpoint)
   FILE* epochFile_ = nullptr;
@@ -256,6 +356,28 @@ class FileMgr : public AbstractBufferMgr {  // implements
   mutable mapd_shared_mutex mutex_free_page;
   std::vector<std::pair<FileInfo*, int>> free_pages;
 
+  mutable std::mutex dirtyChunksMutex_;
+  std::set<ChunkKey> dirtyChunks_;  /// chunks written since the last checkpoint
+
+  std::mutex chunkIndexSnapshotMutex_;
+  std::atomic<bool> chunkIndexSnapshotValid_{false};  /// snapshot matches the files
+  std::atomic<uint64_t> pageLayoutVersion_{0};  /// bumped on every page alloc / free
+
+  /**
+   * @brief Persists the page headers of all chunks together with the file layout and
+   * checkpointed epoch, so that the next startup can rebuild the chunk index without
+   * scanning every page of every file.
+   */
+  void writeChunkIndexSnapshot();
+  /**
+   * @brief Opens the data files and fills headerVec from the snapshot. Returns false,
+   * without opening anything, if the snapshot is missing, corrupt or does not match the
+   * epoch and data files on disk.
+   */
+  bool loadChunkIndexSnapshot(const std::vector<DataFileDescriptor>& data_files,
+                              std::vector<HeaderInfo>& headerVec);
+  void removeChunkIndexSnapshot();
+
   /**
    * @brief Adds a file to the file manager repository.
    *
@@ -273,6 +395,12 @@ class FileMgr : public AbstractBufferMgr {  // implements
    */
 
   FileInfo* createFile(const size_t pageSize, const size_t numPages);
+  /// Closes and deletes a data file none of whose pages are referenced anymore
+  void removeFile(FileInfo* fileInfo);
+  /// Opens the page checksums of a data file, unless --enable-page-checksums is off
+  void openChecksumFile(FileInfo* fileInfo, const bool isNewFile);
+  std::string getChecksumFilePath(const int fileId, const size_t pageSize) const;
+  size_t getNumPagesPerFile(const size_t pageSize, const bool isMetadata) const;
   FileInfo* openExistingFile(const std::string& path,
                              const int fileId,
                              const size_t pageSize,
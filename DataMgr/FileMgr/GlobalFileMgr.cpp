@@ -37,6 +37,10 @@
 
 using namespace std;
 
+std::string g_cold_storage_url;
+size_t g_cold_storage_min_epoch_age{100};
+size_t g_cold_storage_interval_seconds{3600};
+
 namespace File_Namespace {
 
 GlobalFileMgr::GlobalFileMgr(const int deviceId,
@@ -71,6 +75,10 @@ void GlobalFileMgr::init() {
       LOG(FATAL) << "Could not create data directory";
     }
   }
+  if (!g_cold_storage_url.empty()) {
+    coldStorage_ = makeColdStorage(g_cold_storage_url);
+    LOG(INFO) << "Moving cold chunks to " << coldStorage_->getUrl();
+  }
 }
 
 void GlobalFileMgr::checkpoint() {
@@ -167,6 +175,10 @@ AbstractBufferMgr* GlobalFileMgr::getFileMgr(const int db_id, const int tb_id) {
     } else {
       auto s = std::make_shared<FileMgr>(
           0, this, file_mgr_key, num_reader_threads_, epoch_, defaultPageSize_);
+      const auto extent_size_it = tableExtentSizes_.find(file_mgr_key);
+      if (extent_size_it != tableExtentSizes_.end()) {
+        s->setExtentSize(extent_size_it->second);
+      }
       CHECK(ownedFileMgrs_.insert(std::make_pair(file_mgr_key, s)).second);
       CHECK(allFileMgrs_.insert(std::make_pair(file_mgr_key, s.get())).second);
       return s.get();
@@ -209,6 +221,16 @@ void GlobalFileMgr::removeTableRelatedDS(const int db_id, const int tb_id) {
   // remove table related in-memory DS only if directory was removed successfully
 
   deleteFileMgr(db_id, tb_id);
+  tableExtentSizes_.erase(std::make_pair(db_id, tb_id));
+  if (coldStorage_) {
+    try {
+      coldStorage_->removeObjects(
+          FileMgr::getColdStorageKeyPrefix(std::make_pair(db_id, tb_id)));
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Could not remove cold storage objects of table (" << db_id << ", "
+                   << tb_id << "): " << e.what();
+    }
+  }
 }
 
 void GlobalFileMgr::setTableEpoch(const int db_id,
@@ -228,6 +250,47 @@ void GlobalFileMgr::setTableEpoch(const int db_id,
   deleteFileMgr(db_id, tb_id);
 }
 
+void GlobalFileMgr::setTableExtentSize(const int db_id,
+                                       const int tb_id,
+                                       const size_t extent_size) {
+  mapd_unique_lock<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
+  const auto file_mgr_key = std::make_pair(db_id, tb_id);
+  tableExtentSizes_[file_mgr_key] = extent_size;
+  if (auto fm = dynamic_cast<FileMgr*>(findFileMgr(db_id, tb_id))) {
+    fm->setExtentSize(extent_size);
+  }
+}
+
+size_t GlobalFileMgr::compactTableFiles(const int db_id,
+                                        const int tb_id,
+                                        const double min_free_fraction) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  auto fm = dynamic_cast<FileMgr*>(findFileMgr(db_id, tb_id));
+  return fm ? fm->compactDataFiles(min_free_fraction) : 0;
+}
+
+size_t GlobalFileMgr::spillTableColdChunks(const int db_id,
+                                           const int tb_id,
+                                           const size_t min_epoch_age) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  auto fm = dynamic_cast<FileMgr*>(findFileMgr(db_id, tb_id));
+  return fm ? fm->spillColdChunks(min_epoch_age) : 0;
+}
+
+size_t GlobalFileMgr::compressTableChunks(const int db_id,
+                                          const int tb_id,
+                                          const size_t min_epoch_age) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  auto fm = dynamic_cast<FileMgr*>(findFileMgr(db_id, tb_id));
+  return fm ? fm->compressChunks(min_epoch_age) : 0;
+}
+
+FileIoStats GlobalFileMgr::getTableIoStats(const int db_id, const int tb_id) {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(fileMgrs_mutex_);
+  auto fm = dynamic_cast<FileMgr*>(findFileMgr(db_id, tb_id));
+  return fm ? fm->getIoStats() : FileIoStats{};
+}
+
 size_t GlobalFileMgr::getTableEpoch(const int db_id, const int tb_id) {
   auto fm = dynamic_cast<FileMgr*>(getFileMgr(db_id, tb_id));
   CHECK(fm);
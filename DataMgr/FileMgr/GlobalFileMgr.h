@@ -162,6 +162,32 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
   void removeTableRelatedDS(const int db_id, const int tb_id) override;
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  /// Extent size of the table's data pages, kept across FileMgr reopens, see
+  /// FileMgr::setExtentSize()
+  void setTableExtentSize(const int db_id, const int tb_id, const size_t extent_size);
+  /// Compacts the data files of the table if its FileMgr is open, see
+  /// FileMgr::compactDataFiles(). Returns the number of bytes removed.
+  size_t compactTableFiles(const int db_id,
+                           const int tb_id,
+                           const double min_free_fraction);
+  /// Moves cold chunks of the table to cold storage if its FileMgr is open, see
+  /// FileMgr::spillColdChunks(). Returns the number of bytes moved.
+  size_t spillTableColdChunks(const int db_id,
+                              const int tb_id,
+                              const size_t min_epoch_age);
+  /// Compresses the pages of unmodified chunks of the table if its FileMgr is open, see
+  /// FileMgr::compressChunks(). Returns the number of bytes of pages freed.
+  size_t compressTableChunks(const int db_id,
+                             const int tb_id,
+                             const size_t min_epoch_age);
+  /// I/O counters of the table since its FileMgr was opened, zero if it is not open
+  FileIoStats getTableIoStats(const int db_id, const int tb_id);
+
+  /// Set from --cold-storage-url by init(), replaced by tests
+  void setColdStorage(std::unique_ptr<ColdStorage> cold_storage) {
+    coldStorage_ = std::move(cold_storage);
+  }
+  ColdStorage* getColdStorage() const { return coldStorage_.get(); }
 
  private:
   std::string basePath_;       /// The OS file system path containing the files.
@@ -184,6 +210,8 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
 
   std::map<std::pair<int, int>, std::shared_ptr<AbstractBufferMgr>> ownedFileMgrs_;
   std::map<std::pair<int, int>, AbstractBufferMgr*> allFileMgrs_;
+  std::map<std::pair<int, int>, size_t> tableExtentSizes_;
+  std::unique_ptr<ColdStorage> coldStorage_;
 
   mapd_shared_mutex fileMgrs_mutex_;
 };
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/FileMgr/S3ColdStorage.h"
+
+#include <aws/core/auth/AWSCredentialsProvider.h>
+#include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/GetObjectRequest.h>
+#include <aws/s3/model/ListObjectsV2Request.h>
+#include <aws/s3/model/PutObjectRequest.h>
+#include <boost/filesystem.hpp>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "Logger/Logger.h"
+
+namespace File_Namespace {
+
+namespace {
+
+std::string get_env(const char* name) {
+  const char* env = getenv(name);
+  return env ? env : "";
+}
+
+Aws::Client::ClientConfiguration get_s3_config() {
+  Aws::Client::ClientConfiguration s3_config;
+  const auto region = get_env("AWS_REGION");
+  s3_config.region = region.size() ? region : Aws::Region::US_EAST_1;
+  s3_config.endpointOverride = get_env("AWS_ENDPOINT");
+
+  // same trust store lookup as S3Archive::init_for_read()
+  std::list<std::string> v_known_ca_paths({
+      "/etc/ssl/certs/ca-certificates.crt",
+      "/etc/pki/tls/certs/ca-bundle.crt",
+      "/usr/share/ssl/certs/ca-bundle.crt",
+      "/usr/local/share/certs/ca-root.crt",
+      "/etc/ssl/cert.pem",
+      "/etc/ssl/ca-bundle.pem",
+  });
+  char* env;
+  if (nullptr != (env = getenv("SSL_CERT_DIR"))) {
+    s3_config.caPath = env;
+  }
+  if (nullptr != (env = getenv("SSL_CERT_FILE"))) {
+    v_known_ca_paths.push_front(env);
+  }
+  for (const auto& known_ca_path : v_known_ca_paths) {
+    if (boost::filesystem::exists(known_ca_path)) {
+      s3_config.caFile = known_ca_path;
+      break;
+    }
+  }
+  return s3_config;
+}
+
+template <typename OUTCOME>
+void check_outcome(const OUTCOME& outcome,
+                   const std::string& what,
+                   const std::string& url) {
+  if (!outcome.IsSuccess()) {
+    throw std::runtime_error("failed to " + what + " of s3 url '" + url +
+                             "': " + outcome.GetError().GetExceptionName() + ": " +
+                             outcome.GetError().GetMessage());
+  }
+}
+
+}  // namespace
+
+S3ColdStorage::S3ColdStorage(const std::string& url) : url_(url) {
+  // s3://bucket/prefix
+  const auto path = url.substr(std::string("s3://").size());
+  const auto bucket_end = path.find('/');
+  bucket_ = path.substr(0, bucket_end);
+  if (bucket_.empty()) {
+    throw std::runtime_error("Cold storage url '" + url + "' names no bucket.");
+  }
+  if (bucket_end != std::string::npos) {
+    prefix_ = path.substr(bucket_end + 1);
+    if (prefix_.size() && prefix_.back() != '/') {
+      prefix_.push_back('/');
+    }
+  }
+
+  const auto access_key = get_env("AWS_ACCESS_KEY_ID");
+  const auto secret_key = get_env("AWS_SECRET_ACCESS_KEY");
+  if (!access_key.empty() && !secret_key.empty()) {
+    s3_client_.reset(new Aws::S3::S3Client(
+        Aws::Auth::AWSCredentials(access_key, secret_key), get_s3_config()));
+  } else {
+    s3_client_.reset(new Aws::S3::S3Client(
+        std::make_shared<Aws::Auth::DefaultAWSCredentialsProviderChain>(),
+        get_s3_config()));
+  }
+}
+
+void S3ColdStorage::putObject(const std::string& key,
+                              const int8_t* data,
+                              const size_t numBytes) {
+  Aws::S3::Model::PutObjectRequest request;
+  request.WithBucket(bucket_).WithKey(getObjectKey(key));
+  auto body = std::make_shared<std::stringstream>(
+      std::string(reinterpret_cast<const char*>(data), numBytes));
+  request.SetBody(body);
+  request.SetContentLength(numBytes);
+  check_outcome(s3_client_->PutObject(request), "put object '" + key + "'", url_);
+}
+
+void S3ColdStorage::getObject(const std::string& key,
+                              int8_t* dst,
+                              const size_t numBytes,
+                              const size_t offset) {
+  if (numBytes == 0) {
+    return;
+  }
+  Aws::S3::Model::GetObjectRequest request;
+  request.WithBucket(bucket_).WithKey(getObjectKey(key));
+  request.SetRange("bytes=" + std::to_string(offset) + "-" +
+                   std::to_string(offset + numBytes - 1));
+  auto outcome = s3_client_->GetObject(request);
+  check_outcome(outcome, "get object '" + key + "'", url_);
+  auto& body = outcome.GetResult().GetBody();
+  body.read(reinterpret_cast<char*>(dst), numBytes);
+  if (static_cast<size_t>(body.gcount()) != numBytes) {
+    throw std::runtime_error("short read of object '" + key + "' of s3 url '" + url_ +
+                             "'");
+  }
+}
+
+void S3ColdStorage::removeObjects(const std::string& keyPrefix) {
+  Aws::S3::Model::ListObjectsV2Request list_request;
+  list_request.WithBucket(bucket_).WithPrefix(getObjectKey(keyPrefix));
+  std::vector<std::string> object_keys;
+  while (true) {
+    auto list_outcome = s3_client_->ListObjectsV2(list_request);
+    check_outcome(list_outcome, "list objects '" + keyPrefix + "'", url_);
+    for (const auto& object : list_outcome.GetResult().GetContents()) {
+      object_keys.emplace_back(object.GetKey().c_str());
+    }
+    if (!list_outcome.GetResult().GetIsTruncated()) {
+      break;
+    }
+    list_request.SetContinuationToken(
+        list_outcome.GetResult().GetNextContinuationToken());
+  }
+  for (const auto& object_key : object_keys) {
+    Aws::S3::Model::DeleteObjectRequest delete_request;
+    delete_request.WithBucket(bucket_).WithKey(object_key);
+    check_outcome(s3_client_->DeleteObject(delete_request),
+                  "delete object '" + object_key + "'",
+                  url_);
+  }
+  VLOG(1) << "Removed " << object_keys.size() << " objects below " << url_ << keyPrefix;
+}
+
+}  // namespace File_Namespace
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <aws/core/Aws.h>
+#include <aws/s3/S3Client.h>
+
+#include "DataMgr/FileMgr/ColdStorage.h"
+
+namespace File_Namespace {
+
+/**
+ * Stores objects below the prefix of an "s3://bucket/prefix" url. Like S3Archive, the
+ * region, endpoint and credentials come from the AWS_REGION, AWS_ENDPOINT,
+ * AWS_ACCESS_KEY_ID and AWS_SECRET_ACCESS_KEY environment variables, and the AWS API is
+ * expected to be initialized by the server.
+ */
+class S3ColdStorage : public ColdStorage {
+ public:
+  S3ColdStorage(const std::string& url);
+
+  void putObject(const std::string& key,
+                 const int8_t* data,
+                 const size_t numBytes) override;
+
+  void getObject(const std::string& key,
+                 int8_t* dst,
+                 const size_t numBytes,
+                 const size_t offset) override;
+
+  void removeObjects(const std::string& keyPrefix) override;
+
+  std::string getUrl() const override { return url_; }
+
+ private:
+  std::string getObjectKey(const std::string& key) const { return prefix_ + key; }
+
+  std::string url_;
+  std::string bucket_;
+  std::string prefix_;  // empty or ending in '/'
+  std::unique_ptr<Aws::S3::S3Client> s3_client_;
+};
+
+}  // namespace File_Namespace
@@ -23,6 +23,7 @@
 #include <stdexcept>
 #include "AbstractBuffer.h"
 #include "Encoder.h"
+#include "ValueStats.h"
 
 #include <Shared/DatumFetchers.h>
 #include <tbb/parallel_for.h>
@@ -45,9 +46,14 @@ class FixedLengthEncoder : public Encoder {
                                             const int64_t offset = -1) override {
     T* unencoded_data = reinterpret_cast<T*>(src_data);
     auto encoded_data = std::make_unique<V[]>(num_elems_to_append);
-    for (size_t i = 0; i < num_elems_to_append; ++i) {
-      size_t ri = replicating ? 0 : i;
-      encoded_data.get()[i] = encodeDataAndUpdateStats(unencoded_data[ri]);
+    if (replicating) {
+      if (num_elems_to_append) {
+        std::fill(encoded_data.get(),
+                  encoded_data.get() + num_elems_to_append,
+                  encodeDataAndUpdateStats(unencoded_data[0]));
+      }
+    } else {
+      encodeDataAndUpdateStats(unencoded_data, encoded_data.get(), num_elems_to_append);
     }
 
     // assume always CPU_BUFFER?
@@ -107,9 +113,14 @@ class FixedLengthEncoder : public Encoder {
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
     const T* unencoded_data = reinterpret_cast<const T*>(src_data);
-    for (size_t i = 0; i < num_elements; ++i) {
-      encodeDataAndUpdateStats(unencoded_data[i]);
+    const auto stats = computeStats(unencoded_data, num_elements);
+    if (!fitsEncoding(stats)) {
+      for (size_t i = 0; i < num_elements; ++i) {
+        encodeDataAndUpdateStats(unencoded_data[i]);
+      }
+      return;
     }
+    addStats(stats);
   }
 
   void updateStats(const std::vector<std::string>* const src_data,
@@ -178,6 +189,48 @@ class FixedLengthEncoder : public Encoder {
   bool has_nulls;
 
  private:
+  value_stats::ValueStats<T> computeStats(const T* unencoded_data,
+                                          const size_t num_elems) const {
+    return value_stats::compute(
+        unencoded_data, num_elems, static_cast<T>(std::numeric_limits<V>::min()));
+  }
+
+  static bool fitsEncoding(const value_stats::ValueStats<T>& stats) {
+    return !stats.hasValues() || (stats.min >= std::numeric_limits<V>::min() &&
+                                  stats.max <= std::numeric_limits<V>::max());
+  }
+
+  void addStats(const value_stats::ValueStats<T>& stats) {
+    if (stats.has_nulls) {
+      has_nulls = true;
+    }
+    if (stats.hasValues()) {
+      // the bounds of the decimals are exceeded by the min or the max if by any value
+      decimal_overflow_validator_.validate(stats.min);
+      decimal_overflow_validator_.validate(stats.max);
+      dataMin = std::min(dataMin, stats.min);
+      dataMax = std::max(dataMax, stats.max);
+    }
+  }
+
+  // The values which don't fit in V are logged one by one, they're left to the scalar
+  // loop. The others are encoded by a plain cast, which vectorizes.
+  void encodeDataAndUpdateStats(const T* unencoded_data,
+                                V* encoded_data,
+                                const size_t num_elems) {
+    const auto stats = computeStats(unencoded_data, num_elems);
+    if (!fitsEncoding(stats)) {
+      for (size_t i = 0; i < num_elems; ++i) {
+        encoded_data[i] = encodeDataAndUpdateStats(unencoded_data[i]);
+      }
+      return;
+    }
+    for (size_t i = 0; i < num_elems; ++i) {
+      encoded_data[i] = static_cast<V>(unencoded_data[i]);
+    }
+    addStats(stats);
+  }
+
   V encodeDataAndUpdateStats(const T& unencoded_data) {
     V encoded_data = static_cast<V>(unencoded_data);
     if (unencoded_data != encoded_data) {
@@ -19,6 +19,7 @@
 #include <arrow/api.h>
 #include <arrow/csv/reader.h>
 #include <arrow/io/file.h>
+#include <arrow/ipc/feather.h>
 #include <arrow/util/bit_util.h>
 #include <arrow/util/decimal.h>
 #include <tbb/parallel_for.h>
@@ -41,10 +42,8 @@ struct Frag {
   int last_chunk_size;     // number of elements in the last chunk
 };
 
-class ArrowCsvForeignStorage : public PersistentForeignStorageInterface {
+class ArrowForeignStorageBase : public PersistentForeignStorageInterface {
  public:
-  ArrowCsvForeignStorage() {}
-
   void append(const std::vector<ForeignStorageColumnBuffer>& column_buffers) override;
 
   void read(const ChunkKey& chunk_key,
@@ -56,14 +55,15 @@ class ArrowCsvForeignStorage : public PersistentForeignStorageInterface {
                     const std::string& type,
                     TableDescriptor& td,
                     std::list<ColumnDescriptor>& cols) override;
-  void registerTable(Catalog_Namespace::Catalog* catalog,
-                     std::pair<int, int> table_key,
-                     const std::string& type,
-                     const TableDescriptor& td,
-                     const std::list<ColumnDescriptor>& cols,
-                     Data_Namespace::AbstractBufferMgr* mgr) override;
 
-  std::string getType() const override;
+  // Registers the columns of table as the ones of cols, in the same order
+  void registerArrowTable(Catalog_Namespace::Catalog* catalog,
+                          std::pair<int, int> table_key,
+                          const std::string& type,
+                          const TableDescriptor& td,
+                          const std::list<ColumnDescriptor>& cols,
+                          Data_Namespace::AbstractBufferMgr* mgr,
+                          const arrow::Table& table);
 
   struct ArrowFragment {
     int64_t offset;
@@ -80,6 +80,16 @@ class ArrowCsvForeignStorage : public PersistentForeignStorageInterface {
                                      ChunkKey key,
                                      Data_Namespace::AbstractBufferMgr* mgr);
 
+  void createDictionaryEncodedColumnFromArrowDictionary(
+      StringDictionary* dict,
+      const ColumnDescriptor& c,
+      std::vector<ArrowFragment>& col,
+      arrow::ChunkedArray* arr_col_chunked_array,
+      tbb::task_group& tg,
+      const std::vector<Frag>& fragments,
+      ChunkKey key,
+      Data_Namespace::AbstractBufferMgr* mgr);
+
   template <typename T, typename ChunkType>
   void createDecimalColumn(const ColumnDescriptor& c,
                            std::vector<ArrowFragment>& col,
@@ -92,12 +102,48 @@ class ArrowCsvForeignStorage : public PersistentForeignStorageInterface {
   std::map<std::array<int, 3>, std::vector<ArrowFragment>> m_columns;
 };
 
+class ArrowCsvForeignStorage : public ArrowForeignStorageBase {
+ public:
+  ArrowCsvForeignStorage() {}
+
+  void registerTable(Catalog_Namespace::Catalog* catalog,
+                     std::pair<int, int> table_key,
+                     const std::string& type,
+                     const TableDescriptor& td,
+                     const std::list<ColumnDescriptor>& cols,
+                     Data_Namespace::AbstractBufferMgr* mgr) override;
+
+  std::string getType() const override;
+};
+
+// Tables backed by an Arrow IPC or Feather file, which is memory mapped. The buffers of
+// the file are used as they are, except for the values of nullable fixed width columns,
+// which are copied to replace nulls by sentinel values.
+class ArrowFileForeignStorage : public ArrowForeignStorageBase {
+ public:
+  ArrowFileForeignStorage() {}
+
+  void registerTable(Catalog_Namespace::Catalog* catalog,
+                     std::pair<int, int> table_key,
+                     const std::string& type,
+                     const TableDescriptor& td,
+                     const std::list<ColumnDescriptor>& cols,
+                     Data_Namespace::AbstractBufferMgr* mgr) override;
+
+  std::string getType() const override;
+};
+
 void registerArrowCsvForeignStorage(void) {
   ForeignStorageInterface::registerPersistentStorageInterface(
       std::make_unique<ArrowCsvForeignStorage>());
 }
 
-void ArrowCsvForeignStorage::append(
+void registerArrowFileForeignStorage(void) {
+  ForeignStorageInterface::registerPersistentStorageInterface(
+      std::make_unique<ArrowFileForeignStorage>());
+}
+
+void ArrowForeignStorageBase::append(
     const std::vector<ForeignStorageColumnBuffer>& column_buffers) {
   CHECK(false);
 }
@@ -139,10 +185,10 @@ void generateSentinelValues(int8_t* data, const SQLTypeInfo& columnType, size_t
   }
 }
 
-void ArrowCsvForeignStorage::read(const ChunkKey& chunk_key,
-                                  const SQLTypeInfo& sql_type,
-                                  int8_t* dest,
-                                  const size_t numBytes) {
+void ArrowForeignStorageBase::read(const ChunkKey& chunk_key,
+                                   const SQLTypeInfo& sql_type,
+                                   int8_t* dest,
+                                   const size_t numBytes) {
   std::array<int, 3> col_key{chunk_key[0], chunk_key[1], chunk_key[2]};
   auto& frag = m_columns.at(col_key).at(chunk_key[3]);
 
@@ -294,10 +340,10 @@ static std::shared_ptr<arrow::DataType> getArrowImportType(const SQLTypeInfo typ
   return nullptr;
 }
 
-void ArrowCsvForeignStorage::prepareTable(const int db_id,
-                                          const std::string& type,
-                                          TableDescriptor& td,
-                                          std::list<ColumnDescriptor>& cols) {
+void ArrowForeignStorageBase::prepareTable(const int db_id,
+                                           const std::string& type,
+                                           TableDescriptor& td,
+                                           std::list<ColumnDescriptor>& cols) {
   td.hasDeletedCol = false;
 }
 
@@ -314,7 +360,7 @@ void generateNullValues(const std::vector<Frag>& fragments,
                         arrow::ChunkedArray* arr_col_chunked_array,
                         const SQLTypeInfo& columnType);
 
-void ArrowCsvForeignStorage::createDictionaryEncodedColumn(
+void ArrowForeignStorageBase::createDictionaryEncodedColumn(
     StringDictionary* dict,
     const ColumnDescriptor& c,
     std::vector<ArrowFragment>& col,
@@ -423,8 +469,145 @@ void ArrowCsvForeignStorage::createDictionaryEncodedColumn(
   });
 }
 
+template <typename IndexArrayType>
+void translateTypedIndices(const arrow::Array& indices,
+                           const std::vector<int32_t>& ids,
+                           int32_t* dest) {
+  const auto& index_array = static_cast<const IndexArrayType&>(indices);
+  for (int64_t i = 0; i < index_array.length(); i++) {
+    dest[i] = index_array.IsNull(i) ? inline_int_null_value<int32_t>()
+                                    : ids[index_array.Value(i)];
+  }
+}
+
+// The string ids of the Arrow dictionary indices, nulls for null indices
+void translateIndices(const arrow::Array& indices,
+                      const std::vector<int32_t>& ids,
+                      int32_t* dest) {
+  switch (indices.type_id()) {
+    case arrow::Type::INT8:
+      translateTypedIndices<arrow::Int8Array>(indices, ids, dest);
+      break;
+    case arrow::Type::INT16:
+      translateTypedIndices<arrow::Int16Array>(indices, ids, dest);
+      break;
+    case arrow::Type::INT32:
+      translateTypedIndices<arrow::Int32Array>(indices, ids, dest);
+      break;
+    case arrow::Type::INT64:
+      translateTypedIndices<arrow::Int64Array>(indices, ids, dest);
+      break;
+    default:
+      throw std::runtime_error("Unsupported Arrow dictionary index type " +
+                               indices.type()->ToString());
+  }
+}
+
+// The strings of the Arrow dictionaries only are encoded. The Arrow indices of a chunk
+// are used as they are when they are the ids of their strings already, as for the
+// first dictionary of a new string dictionary, and translated otherwise.
+void ArrowForeignStorageBase::createDictionaryEncodedColumnFromArrowDictionary(
+    StringDictionary* dict,
+    const ColumnDescriptor& c,
+    std::vector<ArrowFragment>& col,
+    arrow::ChunkedArray* arr_col_chunked_array,
+    tbb::task_group& tg,
+    const std::vector<Frag>& fragments,
+    ChunkKey key,
+    Data_Namespace::AbstractBufferMgr* mgr) {
+  tg.run([dict, &c, &col, arr_col_chunked_array, &tg, &fragments, k = key, mgr]() {
+    auto key = k;
+    auto full_time = measure<>::execution([&]() {
+      const int num_chunks = arr_col_chunked_array->num_chunks();
+      auto id_chunks =
+          std::make_shared<std::vector<std::shared_ptr<arrow::ArrayData>>>(num_chunks);
+      std::shared_ptr<arrow::Array> dictionary;
+      std::vector<int32_t> ids;
+      bool are_indices_ids{false};
+      int num_adopted_chunks{0};
+      for (int i = 0; i < num_chunks; i++) {
+        auto dictionary_array = std::static_pointer_cast<arrow::DictionaryArray>(
+            arr_col_chunked_array->chunk(i));
+        // the batches of an Arrow file usually share their dictionary
+        if (dictionary_array->dictionary() != dictionary) {
+          dictionary = dictionary_array->dictionary();
+          auto string_array = std::static_pointer_cast<arrow::StringArray>(dictionary);
+          std::vector<std::string_view> strings(string_array->length());
+          for (int64_t j = 0; j < string_array->length(); j++) {
+            auto view = string_array->GetView(j);
+            strings[j] = std::string_view(view.data(), view.length());
+          }
+          ids.resize(strings.size());
+          dict->getOrAddBulk(strings, ids.data());
+          are_indices_ids = true;
+          for (size_t j = 0; j < ids.size() && are_indices_ids; j++) {
+            are_indices_ids = ids[j] == static_cast<int32_t>(j);
+          }
+        }
+        auto indices = dictionary_array->indices();
+        if (are_indices_ids && indices->type_id() == arrow::Type::INT32 &&
+            indices->null_count() == 0) {
+          (*id_chunks)[i] = indices->data();
+          num_adopted_chunks++;
+          continue;
+        }
+        std::shared_ptr<arrow::Buffer> ids_buf;
+        ARROW_ASSIGN_OR_THROW(ids_buf,
+                              arrow::AllocateBuffer(indices->length() * sizeof(int32_t)));
+        translateIndices(
+            *indices, ids, reinterpret_cast<int32_t*>(ids_buf->mutable_data()));
+        (*id_chunks)[i] =
+            std::make_shared<arrow::Int32Array>(indices->length(), ids_buf)->data();
+      }
+
+      VLOG(1) << "FSI dictionary for column adopted from Arrow for "
+              << num_adopted_chunks << " of " << num_chunks
+              << " chunks, unique_count: " << dict->storageEntryCount();
+
+      for (size_t f = 0; f < fragments.size(); f++) {
+        tg.run([k = key,
+                f,
+                &col,
+                mgr,
+                &c,
+                id_chunks,
+                arr_col_chunked_array,
+                &fragments]() {
+          auto key = k;
+          key[3] = f;
+          auto& frag = col[f];
+          frag.chunks.resize(fragments[f].last_chunk - fragments[f].first_chunk + 1);
+          frag.offset = 0;
+          auto b = mgr->createBuffer(key);
+          b->sql_type = c.columnType;
+          b->encoder.reset(Encoder::Create(b, c.columnType));
+          b->has_encoder = true;
+          for (int i = fragments[f].first_chunk, e = fragments[f].last_chunk; i <= e;
+               i++) {
+            const auto& id_chunk = (*id_chunks)[i];
+            int size, offset;
+            getSizeAndOffset(
+                fragments[f], arr_col_chunked_array->chunk(i), i, size, offset);
+            auto id_array = std::make_shared<arrow::Int32Array>(
+                size, id_chunk->buffers[1], nullptr, 0, id_chunk->offset + offset);
+            frag.chunks[i - fragments[f].first_chunk] = id_array->data();
+            frag.sz += size;
+            b->encoder->updateStats(
+                reinterpret_cast<const int8_t*>(id_array->raw_values()), size);
+          }
+
+          b->setSize(frag.sz * b->sql_type.get_size());
+          b->encoder->setNumElems(frag.sz);
+        });
+      }
+    });
+    VLOG(1) << "FSI: createDictionaryEncodedColumnFromArrowDictionary time: "
+            << full_time << "ms" << std::endl;
+  });
+}
+
 template <typename T, typename ChunkType>
-void ArrowCsvForeignStorage::createDecimalColumn(
+void ArrowForeignStorageBase::createDecimalColumn(
     const ColumnDescriptor& c,
     std::vector<ArrowFragment>& col,
     arrow::ChunkedArray* arr_col_chunked_array,
@@ -581,7 +764,105 @@ void ArrowCsvForeignStorage::registerTable(Catalog_Namespace::Catalog* catalog,
 
   VLOG(1) << "Read Arrow CSV file " << info << " in " << time << "ms";
 
-  arrow::Table& table = *arrowTable.get();
+  registerArrowTable(catalog, table_key, info, td, cols, mgr, *arrowTable);
+}
+
+namespace {
+
+void validateArrowFileColumnType(const ColumnDescriptor& c,
+                                 const arrow::DataType& type,
+                                 const std::string& file_path) {
+  if (c.columnType.is_dict_encoded_string() && type.id() == arrow::Type::DICTIONARY) {
+    const auto& dictionary_type = static_cast<const arrow::DictionaryType&>(type);
+    if (dictionary_type.value_type()->id() == arrow::Type::STRING) {
+      return;
+    }
+  } else if (type.Equals(*getArrowImportType(c.columnType))) {
+    return;
+  }
+  throw std::runtime_error("Type " + type.ToString() + " of column " + c.columnName +
+                           " in Arrow file " + file_path + " does not match type " +
+                           c.columnType.get_type_name() + " of the table column.");
+}
+
+// The values of the chunks with nulls are copied so that they can be replaced by
+// sentinel values, which the memory mapped buffers of the file cannot.
+std::shared_ptr<arrow::ChunkedArray> copyNullableValues(
+    const std::shared_ptr<arrow::ChunkedArray>& column) {
+  arrow::ArrayVector chunks;
+  for (const auto& chunk : column->chunks()) {
+    if (chunk->null_count() == 0 || chunk->null_count() == chunk->length()) {
+      chunks.push_back(chunk);
+      continue;
+    }
+    auto data = chunk->data()->Copy();
+    const auto& values = data->buffers[1];
+    std::shared_ptr<arrow::Buffer> values_copy;
+    ARROW_ASSIGN_OR_THROW(values_copy, arrow::AllocateBuffer(values->size()));
+    std::memcpy(values_copy->mutable_data(), values->data(), values->size());
+    data->buffers[1] = values_copy;
+    chunks.push_back(arrow::MakeArray(data));
+  }
+  return std::make_shared<arrow::ChunkedArray>(chunks, column->type());
+}
+
+}  // namespace
+
+void ArrowFileForeignStorage::registerTable(Catalog_Namespace::Catalog* catalog,
+                                            std::pair<int, int> table_key,
+                                            const std::string& info,
+                                            const TableDescriptor& td,
+                                            const std::list<ColumnDescriptor>& cols,
+                                            Data_Namespace::AbstractBufferMgr* mgr) {
+  std::shared_ptr<arrow::io::MemoryMappedFile> file;
+  ARROW_ASSIGN_OR_THROW(
+      file, arrow::io::MemoryMappedFile::Open(info, arrow::io::FileMode::READ));
+  // Feather version 2 files are Arrow IPC files, which the Feather reader reads too.
+  std::shared_ptr<arrow::ipc::feather::Reader> reader;
+  ARROW_ASSIGN_OR_THROW(reader, arrow::ipc::feather::Reader::Open(file));
+  std::shared_ptr<arrow::Table> file_table;
+  auto time =
+      measure<>::execution([&]() { ARROW_THROW_NOT_OK(reader->Read(&file_table)); });
+
+  VLOG(1) << "Mapped Arrow file " << info << " in " << time << "ms";
+
+  // The columns of the file are matched to the ones of the table by name.
+  arrow::FieldVector fields;
+  arrow::ChunkedArrayVector columns;
+  for (auto& c : cols) {
+    if (c.isSystemCol) {
+      continue;  // must be processed by base interface implementation
+    }
+    auto column = file_table->GetColumnByName(c.columnName);
+    if (!column) {
+      throw std::runtime_error("Column " + c.columnName + " not found in Arrow file " +
+                               info + ".");
+    }
+    validateArrowFileColumnType(c, *column->type(), info);
+    const auto ctype = c.columnType.get_type();
+    if (!c.columnType.is_string() && ctype != kDECIMAL && ctype != kNUMERIC) {
+      column = copyNullableValues(column);
+    }
+    fields.push_back(arrow::field(c.columnName, column->type()));
+    columns.push_back(column);
+  }
+
+  registerArrowTable(catalog,
+                     table_key,
+                     info,
+                     td,
+                     cols,
+                     mgr,
+                     *arrow::Table::Make(arrow::schema(fields), columns));
+}
+
+void ArrowForeignStorageBase::registerArrowTable(Catalog_Namespace::Catalog* catalog,
+                                                 std::pair<int, int> table_key,
+                                                 const std::string& info,
+                                                 const TableDescriptor& td,
+                                                 const std::list<ColumnDescriptor>& cols,
+                                                 Data_Namespace::AbstractBufferMgr* mgr,
+                                                 const arrow::Table& table) {
   int cln = 0, num_cols = table.num_columns();
   int arr_frags = table.column(0)->num_chunks();
   arrow::ChunkedArray* c0p = table.column(0).get();
@@ -645,8 +926,13 @@ void ArrowCsvForeignStorage::registerTable(Catalog_Namespace::Catalog* catalog,
       auto dictDesc = const_cast<DictDescriptor*>(
           catalog->getMetadataForDict(c.columnType.get_comp_param()));
       StringDictionary* dict = dictDesc->stringDict.get();
-      createDictionaryEncodedColumn(
-          dict, c, col, arr_col_chunked_array, tg, fragments, key, mgr);
+      if (arr_col_chunked_array->type()->id() == arrow::Type::DICTIONARY) {
+        createDictionaryEncodedColumnFromArrowDictionary(
+            dict, c, col, arr_col_chunked_array, tg, fragments, key, mgr);
+      } else {
+        createDictionaryEncodedColumn(
+            dict, c, col, arr_col_chunked_array, tg, fragments, key, mgr);
+      }
     } else if (ctype == kDECIMAL || ctype == kNUMERIC) {
       tg.run([this, &c, &col, arr_col_chunked_array, &tg, &fragments, key, mgr]() {
         switch (c.columnType.get_size()) {
@@ -835,6 +1121,12 @@ void generateNullValues(const std::vector<Frag>& fragments,
   }
 }
 
+std::string ArrowFileForeignStorage::getType() const {
+  LOG(INFO) << "Arrow file backed temporary tables has been activated. Create table "
+               "`with (storage_type='ARROW:path/to/file.arrow');`\n";
+  return "ARROW";
+}
+
 std::string ArrowCsvForeignStorage::getType() const {
   LOG(INFO) << "CSV backed temporary tables has been activated. Create table `with "
                "(storage_type='CSV:path/to/file.csv');`\n";
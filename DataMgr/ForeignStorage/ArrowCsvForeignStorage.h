@@ -17,3 +17,4 @@
 #pragma once
 
 void registerArrowCsvForeignStorage(void);
+void registerArrowFileForeignStorage(void);
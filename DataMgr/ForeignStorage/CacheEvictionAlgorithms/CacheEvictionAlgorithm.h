@@ -39,6 +39,8 @@ class CacheEvictionAlgorithm {
  public:
   virtual ~CacheEvictionAlgorithm() {}
   virtual const ChunkKey evictNextChunk() = 0;
+  // Returns the chunk evictNextChunk() would evict, without evicting it.
+  virtual const ChunkKey& peekNextChunk() const = 0;
   virtual void touchChunk(const ChunkKey&) = 0;
   virtual void removeChunk(const ChunkKey&) = 0;
 };
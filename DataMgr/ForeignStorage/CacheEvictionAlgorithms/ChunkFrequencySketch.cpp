@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChunkFrequencySketch.h"
+
+#include <algorithm>
+
+constexpr size_t ChunkFrequencySketch::kNumRows;
+constexpr uint8_t ChunkFrequencySketch::kMaxCount;
+
+ChunkFrequencySketch::ChunkFrequencySketch(const size_t counters_per_row) {
+  size_t row_size = 1;
+  while (row_size < counters_per_row) {
+    row_size *= 2;
+  }
+  for (auto& row : counters_) {
+    row.resize(row_size, 0);
+  }
+  row_mask_ = row_size - 1;
+  // As suggested by the TinyLFU paper, ten times the number of counters of a row.
+  sample_size_ = 10 * row_size;
+}
+
+void ChunkFrequencySketch::increment(const ChunkKey& chunk_key) {
+  const auto indexes = getIndexes(chunk_key);
+  for (size_t row = 0; row < kNumRows; ++row) {
+    auto& counter = counters_[row][indexes[row]];
+    if (counter < kMaxCount) {
+      ++counter;
+    }
+  }
+  if (++num_accesses_ >= sample_size_) {
+    halve();
+  }
+}
+
+size_t ChunkFrequencySketch::estimate(const ChunkKey& chunk_key) const {
+  const auto indexes = getIndexes(chunk_key);
+  uint8_t count = kMaxCount;
+  for (size_t row = 0; row < kNumRows; ++row) {
+    count = std::min(count, counters_[row][indexes[row]]);
+  }
+  return count;
+}
+
+std::array<size_t, ChunkFrequencySketch::kNumRows> ChunkFrequencySketch::getIndexes(
+    const ChunkKey& chunk_key) const {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const auto key_part : chunk_key) {
+    hash = (hash ^ static_cast<uint32_t>(key_part)) * 0x100000001b3ULL;
+  }
+  // The splitmix64 finalizer, then double hashing for the rows.
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  const uint64_t step = (hash >> 32) | 1;
+  std::array<size_t, kNumRows> indexes;
+  for (size_t row = 0; row < kNumRows; ++row) {
+    indexes[row] = (hash + row * step) & row_mask_;
+  }
+  return indexes;
+}
+
+void ChunkFrequencySketch::halve() {
+  for (auto& row : counters_) {
+    for (auto& counter : row) {
+      counter /= 2;
+    }
+  }
+  num_accesses_ /= 2;
+}
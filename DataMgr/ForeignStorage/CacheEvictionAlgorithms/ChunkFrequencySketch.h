@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file	ChunkFrequencySketch.h
+ *
+ * This file includes the class specification for the frequency sketch used by the
+ * admission filter of the Foreign Storage Interface (FSI) cache.  It estimates how often
+ * every chunk was accessed recently, in the manner of TinyLFU (Einziger et al., "TinyLFU:
+ * A Highly Efficient Cache Admission Policy", 2017): a count-min sketch of small
+ * saturating counters which are all halved once enough accesses were counted, so that
+ * old accesses fade out.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "DataMgr/AbstractBufferMgr.h"
+
+class ChunkFrequencySketch {
+ public:
+  static constexpr uint8_t kMaxCount{15};
+
+  // counters_per_row is rounded up to a power of two
+  explicit ChunkFrequencySketch(const size_t counters_per_row = size_t(1) << 16);
+
+  void increment(const ChunkKey&);
+  // Estimated number of recent accesses of the chunk, never less than the actual one
+  // since the last halving.
+  size_t estimate(const ChunkKey&) const;
+
+ private:
+  static constexpr size_t kNumRows{4};
+
+  std::array<size_t, kNumRows> getIndexes(const ChunkKey&) const;
+  void halve();
+
+  std::array<std::vector<uint8_t>, kNumRows> counters_;
+  size_t row_mask_;
+  size_t sample_size_;  // accesses counted between two halvings
+  size_t num_accesses_{0};
+};
@@ -35,6 +35,13 @@ const ChunkKey LRUEvictionAlgorithm::evictNextChunk() {
   return ret;
 }
 
+const ChunkKey& LRUEvictionAlgorithm::peekNextChunk() const {
+  if (cache_items_list_.empty()) {
+    throw NoEntryFoundException();
+  }
+  return cache_items_list_.back();
+}
+
 void LRUEvictionAlgorithm::touchChunk(const ChunkKey& key) {
   auto it = cache_items_map_.find(key);
   cache_items_list_.emplace_front(key);
@@ -40,6 +40,8 @@ class LRUEvictionAlgorithm : public CacheEvictionAlgorithm {
   ~LRUEvictionAlgorithm() override {}
   // Returns the next chunk to evict.
   const ChunkKey evictNextChunk() override;
+  // Returns the next chunk to evict without evicting it.
+  const ChunkKey& peekNextChunk() const override;
   // Update the algorithm knowing that this chunk was recently touched by the system.
   void touchChunk(const ChunkKey&) override;
   // Removes a chunk from the eviction queue if present.
@@ -262,59 +262,141 @@ void CsvDataWrapper::populateChunkBuffers(
 }
 
 /**
- * Data structure containing data and metadata gotten from parsing a set of file regions.
+ * Data structure used to hold the objects shared by the threads which load the chunks
+ * of a fragment: a thread reading the file regions of the fragment in order, threads
+ * parsing the regions read, and the thread appending the parsed regions to the chunks
+ * in order. The request pool bounds the number of regions read ahead of the append.
  */
-struct ParseFileRegionResult {
-  size_t file_offset;
-  size_t row_count;
-  std::map<int, DataBlockPtr> column_id_to_data_blocks_map;
+struct ChunkLoadMultiThreadingParams {
+  std::mutex mutex;
+  std::queue<csv_file_buffer_parser::ParseBufferRequest> request_pool;
+  std::condition_variable request_pool_condition;
+  // regions read and not parsed yet, with their indexes in the file regions
+  std::queue<std::pair<size_t, csv_file_buffer_parser::ParseBufferRequest>>
+      pending_requests;
+  std::condition_variable pending_requests_condition;
+  bool reading_finished{false};
+  // regions parsed and not appended yet, by index in the file regions
+  std::map<size_t,
+           std::pair<csv_file_buffer_parser::ParseBufferRequest,
+                     csv_file_buffer_parser::ParseBufferResult>>
+      parsed_requests;
+  std::condition_variable parsed_requests_condition;
+  std::exception_ptr error;
+};
 
-  bool operator<(const ParseFileRegionResult& other) const {
-    return file_offset < other.file_offset;
+/**
+ * Records the first error of the threads loading chunks and wakes them all up to stop.
+ */
+void set_chunk_load_error(ChunkLoadMultiThreadingParams& multi_threading_params,
+                          std::exception_ptr error) {
+  {
+    std::lock_guard<std::mutex> lock(multi_threading_params.mutex);
+    if (!multi_threading_params.error) {
+      multi_threading_params.error = error;
+    }
   }
-};
+  multi_threading_params.request_pool_condition.notify_all();
+  multi_threading_params.pending_requests_condition.notify_all();
+  multi_threading_params.parsed_requests_condition.notify_all();
+}
 
 /**
- * Parses a set of file regions given a handle to the file and range of indexes
- * for the file regions to be parsed.
+ * Reads the file regions of a fragment in order, each into a request from the request
+ * pool, and queues the requests for the parsing threads.
  */
-ParseFileRegionResult parse_file_regions(
-    const FileRegions& file_regions,
-    const size_t start_index,
-    const size_t end_index,
-    CsvReader& csv_reader,
-    std::mutex& file_access_mutex,
-    csv_file_buffer_parser::ParseBufferRequest& parse_file_request,
-    const std::map<int, Chunk_NS::Chunk>& column_id_to_chunk_map) {
-  ParseFileRegionResult load_file_region_result{};
-  load_file_region_result.file_offset = file_regions[start_index].first_row_file_offset;
-  load_file_region_result.row_count = 0;
-
-  csv_file_buffer_parser::ParseBufferResult result;
-  for (size_t i = start_index; i <= end_index; i++) {
-    CHECK(file_regions[i].region_size <= parse_file_request.buffer_size);
-    size_t read_size;
-    {
-      std::lock_guard<std::mutex> lock(file_access_mutex);
-      read_size = csv_reader.readRegion(parse_file_request.buffer.get(),
-                                        file_regions[i].first_row_file_offset,
-                                        file_regions[i].region_size);
+void read_file_regions(const FileRegions& file_regions,
+                       CsvReader& csv_reader,
+                       std::mutex& file_access_mutex,
+                       ChunkLoadMultiThreadingParams& multi_threading_params) {
+  try {
+    for (size_t i = 0; i < file_regions.size(); i++) {
+      std::optional<csv_file_buffer_parser::ParseBufferRequest> request;
+      {
+        std::unique_lock<std::mutex> lock(multi_threading_params.mutex);
+        multi_threading_params.request_pool_condition.wait(
+            lock, [&multi_threading_params] {
+              return !multi_threading_params.request_pool.empty() ||
+                     multi_threading_params.error;
+            });
+        if (multi_threading_params.error) {
+          return;
+        }
+        request.emplace(std::move(multi_threading_params.request_pool.front()));
+        multi_threading_params.request_pool.pop();
+      }
+
+      const auto& file_region = file_regions[i];
+      CHECK(file_region.region_size <= request->buffer_size);
+      size_t read_size;
+      {
+        std::lock_guard<std::mutex> lock(file_access_mutex);
+        read_size = csv_reader.readRegion(request->buffer.get(),
+                                          file_region.first_row_file_offset,
+                                          file_region.region_size);
+      }
+      CHECK_EQ(file_region.region_size, read_size);
+      request->begin_pos = 0;
+      request->end_pos = file_region.region_size;
+      request->first_row_index = file_region.first_row_index;
+      request->file_offset = file_region.first_row_file_offset;
+      request->process_row_count = file_region.row_count;
+
+      {
+        std::lock_guard<std::mutex> lock(multi_threading_params.mutex);
+        multi_threading_params.pending_requests.emplace(i, std::move(*request));
+      }
+      multi_threading_params.pending_requests_condition.notify_one();
     }
+  } catch (...) {
+    set_chunk_load_error(multi_threading_params, std::current_exception());
+  }
+  {
+    std::lock_guard<std::mutex> lock(multi_threading_params.mutex);
+    multi_threading_params.reading_finished = true;
+  }
+  multi_threading_params.pending_requests_condition.notify_all();
+}
 
-    CHECK_EQ(file_regions[i].region_size, read_size);
-    parse_file_request.begin_pos = 0;
-    parse_file_request.end_pos = file_regions[i].region_size;
-    parse_file_request.first_row_index = file_regions[i].first_row_index;
-    parse_file_request.file_offset = file_regions[i].first_row_file_offset;
-    parse_file_request.process_row_count = file_regions[i].row_count;
+/**
+ * Parses the file regions queued by read_file_regions() until all regions are read.
+ */
+void parse_file_regions(const FileRegions& file_regions,
+                        ChunkLoadMultiThreadingParams& multi_threading_params) {
+  try {
+    while (true) {
+      std::optional<std::pair<size_t, csv_file_buffer_parser::ParseBufferRequest>>
+          pending_request;
+      {
+        std::unique_lock<std::mutex> lock(multi_threading_params.mutex);
+        multi_threading_params.pending_requests_condition.wait(
+            lock, [&multi_threading_params] {
+              return !multi_threading_params.pending_requests.empty() ||
+                     multi_threading_params.reading_finished ||
+                     multi_threading_params.error;
+            });
+        if (multi_threading_params.error ||
+            multi_threading_params.pending_requests.empty()) {
+          return;
+        }
+        pending_request.emplace(
+            std::move(multi_threading_params.pending_requests.front()));
+        multi_threading_params.pending_requests.pop();
+      }
 
-    result = parse_buffer(parse_file_request);
-    CHECK_EQ(file_regions[i].row_count, result.row_count);
-    load_file_region_result.row_count += result.row_count;
+      auto& [region_index, request] = *pending_request;
+      auto result = parse_buffer(request);
+      CHECK_EQ(file_regions[region_index].row_count, result.row_count);
+      {
+        std::lock_guard<std::mutex> lock(multi_threading_params.mutex);
+        multi_threading_params.parsed_requests.emplace(
+            region_index, std::make_pair(std::move(request), std::move(result)));
+      }
+      multi_threading_params.parsed_requests_condition.notify_all();
+    }
+  } catch (...) {
+    set_chunk_load_error(multi_threading_params, std::current_exception());
   }
-  load_file_region_result.column_id_to_data_blocks_map =
-      result.column_id_to_data_blocks_map;
-  return load_file_region_result;
 }
 
 /**
@@ -409,16 +491,12 @@ void CsvDataWrapper::populateChunks(
   CHECK(catalog);
   auto columns = catalog->getAllColumnMetadataForTableUnlocked(
       foreign_table_->tableId, false, false, true);
-  const int batch_size = (file_regions.size() + thread_count - 1) / thread_count;
-
-  std::vector<csv_file_buffer_parser::ParseBufferRequest> parse_file_requests{};
-  parse_file_requests.reserve(thread_count);
-  std::vector<std::future<ParseFileRegionResult>> futures{};
 
-  for (size_t i = 0; i < file_regions.size(); i += batch_size) {
-    parse_file_requests.emplace_back();
-    csv_file_buffer_parser::ParseBufferRequest& parse_file_request =
-        parse_file_requests.back();
+  // Two requests per parsing thread keep the threads busy while the append waits for
+  // the next region in order.
+  ChunkLoadMultiThreadingParams multi_threading_params;
+  for (size_t i = 0; i < 2 * thread_count; i++) {
+    csv_file_buffer_parser::ParseBufferRequest parse_file_request;
     parse_file_request.buffer = std::make_unique<char[]>(buffer_size);
     parse_file_request.buffer_size = buffer_size;
     parse_file_request.buffer_alloc_size = buffer_size;
@@ -426,32 +504,68 @@ void CsvDataWrapper::populateChunks(
     parse_file_request.columns = columns;
     parse_file_request.catalog = catalog;
     initialize_import_buffers(columns, catalog, parse_file_request.import_buffers);
+    multi_threading_params.request_pool.emplace(std::move(parse_file_request));
+  }
 
-    auto start_index = i;
-    auto end_index =
-        std::min<size_t>(start_index + batch_size - 1, file_regions.size() - 1);
-    futures.emplace_back(std::async(std::launch::async,
-                                    parse_file_regions,
-                                    std::ref(file_regions),
-                                    start_index,
-                                    end_index,
-                                    std::ref((*csv_reader_)),
-                                    std::ref(file_access_mutex_),
-                                    std::ref(parse_file_request),
-                                    std::ref(column_id_to_chunk_map)));
-  }
-
-  std::set<ParseFileRegionResult> load_file_region_results{};
-  for (auto& future : futures) {
-    future.wait();
-    load_file_region_results.emplace(future.get());
+  auto read_future = std::async(std::launch::async,
+                                read_file_regions,
+                                std::ref(file_regions),
+                                std::ref(*csv_reader_),
+                                std::ref(file_access_mutex_),
+                                std::ref(multi_threading_params));
+  std::vector<std::future<void>> parse_futures{};
+  for (size_t i = 0; i < thread_count; i++) {
+    parse_futures.emplace_back(std::async(std::launch::async,
+                                          parse_file_regions,
+                                          std::ref(file_regions),
+                                          std::ref(multi_threading_params)));
   }
 
-  for (auto result : load_file_region_results) {
-    for (auto& [column_id, chunk] : column_id_to_chunk_map) {
-      chunk.appendData(
-          result.column_id_to_data_blocks_map[column_id], result.row_count, 0);
+  try {
+    for (size_t i = 0; i < file_regions.size(); i++) {
+      std::optional<std::pair<csv_file_buffer_parser::ParseBufferRequest,
+                              csv_file_buffer_parser::ParseBufferResult>>
+          parsed_request;
+      {
+        std::unique_lock<std::mutex> lock(multi_threading_params.mutex);
+        auto& parsed_requests = multi_threading_params.parsed_requests;
+        multi_threading_params.parsed_requests_condition.wait(
+            lock, [&multi_threading_params, &parsed_requests, i] {
+              return parsed_requests.find(i) != parsed_requests.end() ||
+                     multi_threading_params.error;
+            });
+        if (multi_threading_params.error) {
+          break;
+        }
+        auto it = parsed_requests.find(i);
+        parsed_request.emplace(std::move(it->second));
+        parsed_requests.erase(it);
+      }
+
+      auto& [request, result] = *parsed_request;
+      for (auto& [column_id, chunk] : column_id_to_chunk_map) {
+        chunk.appendData(
+            result.column_id_to_data_blocks_map[column_id], result.row_count, 0);
+      }
+      for (const auto& import_buffer : request.import_buffers) {
+        import_buffer->clear();
+      }
+      {
+        std::lock_guard<std::mutex> lock(multi_threading_params.mutex);
+        multi_threading_params.request_pool.emplace(std::move(request));
+      }
+      multi_threading_params.request_pool_condition.notify_one();
     }
+  } catch (...) {
+    set_chunk_load_error(multi_threading_params, std::current_exception());
+  }
+
+  read_future.wait();
+  for (auto& future : parse_futures) {
+    future.wait();
+  }
+  if (multi_threading_params.error) {
+    std::rethrow_exception(multi_threading_params.error);
   }
 }
 
@@ -836,9 +950,7 @@ void CsvDataWrapper::populateChunkMetadata(ChunkMetadataVector& chunk_metadata_v
   auto timer = DEBUG_TIMER(__func__);
   chunk_metadata_map_.clear();
 
-  auto update_mode_it = foreign_table_->options.find("UPDATE_MODE");
-  bool append_mode = (update_mode_it != foreign_table_->options.end()) &&
-                     boost::iequals(update_mode_it->second, "APPEND");
+  const bool append_mode = foreign_table_->isAppendMode();
 
   const auto copy_params = validateAndGetCopyParams();
   const auto file_path = getFilePath();
@@ -69,7 +69,9 @@ class CsvDataWrapper : public ForeignDataWrapper {
 
   /**
    * Populates provided chunks with appropriate data by parsing all file regions
-   * containing chunk data.
+   * containing chunk data. One thread reads the regions in order, a number of threads
+   * parse them concurrently, and the parsed regions are appended to the chunks in
+   * order on the calling thread.
    *
    * @param column_id_to_chunk_map - map of column id to chunks to be populated
    * @param fragment_id - fragment id of given chunks
@@ -23,10 +23,23 @@
 #include "ForeignStorageCache.h"
 #include "Shared/measure.h"
 
+#include <fstream>
+#include <sstream>
+
 namespace foreign_storage {
 using read_lock = mapd_shared_lock<mapd_shared_mutex>;
 using write_lock = mapd_unique_lock<mapd_shared_mutex>;
 
+namespace {
+// The access counts are stored as one line per chunk, the count followed by the key.
+constexpr char const* kAccessCountsFileName = "access_counts";
+// Access counts kept per entry of the cache before they are all halved
+constexpr size_t kAccessCountsPerEntry{4};
+// Accesses after which the counts are saved, in case the server does not shut down
+// cleanly
+constexpr size_t kAccessCountsSavePeriod{4096};
+}  // namespace
+
 template <typename Func, typename T>
 static void iterateOverMatchingPrefix(Func func,
                                       T& chunk_collection,
@@ -42,11 +55,19 @@ static void iterateOverMatchingPrefix(Func func,
 
 ForeignStorageCache::ForeignStorageCache(const std::string& cache_dir,
                                          const size_t num_reader_threads,
-                                         const size_t limit)
-    : entry_limit_(limit) {
+                                         const size_t limit,
+                                         const size_t size_limit)
+    : entry_limit_(limit), size_limit_(size_limit) {
   validatePath(cache_dir);
   global_file_mgr_ =
       std::make_unique<File_Namespace::GlobalFileMgr>(0, cache_dir, num_reader_threads);
+  access_counts_path_ =
+      (boost::filesystem::path(cache_dir) / kAccessCountsFileName).string();
+  loadAccessCounts();
+}
+
+ForeignStorageCache::~ForeignStorageCache() {
+  saveAccessCounts();
 }
 
 void ForeignStorageCache::cacheTableChunks(const std::vector<ChunkKey>& chunk_keys) {
@@ -55,33 +76,69 @@ void ForeignStorageCache::cacheTableChunks(const std::vector<ChunkKey>& chunk_ke
   CHECK(!chunk_keys.empty());
   auto db_id = chunk_keys[0][CHUNK_KEY_DB_IDX];
   auto table_id = chunk_keys[0][CHUNK_KEY_TABLE_IDX];
+  std::vector<size_t> chunk_sizes;
+  size_t num_bytes = 0;
   for (const auto& chunk_key : chunk_keys) {
     CHECK_EQ(db_id, chunk_key[CHUNK_KEY_DB_IDX]);
     CHECK_EQ(table_id, chunk_key[CHUNK_KEY_TABLE_IDX]);
     CHECK(global_file_mgr_->isBufferOnDevice(chunk_key));
 
-    if (isCacheFull()) {
+    // A chunk cached again replaces its previous version.
+    auto chunk_it = cached_chunks_.find(chunk_key);
+    if (chunk_it != cached_chunks_.end()) {
+      eviction_alg_->removeChunk(chunk_key);
+      num_cached_bytes_ -= chunk_it->second;
+      cached_chunks_.erase(chunk_it);
+    }
+    chunk_sizes.emplace_back(global_file_mgr_->getBuffer(chunk_key)->size());
+    num_bytes += chunk_sizes.back();
+  }
+
+  if (admitChunks(chunk_keys, num_bytes)) {
+    while (!hasRoomFor(chunk_keys.size(), num_bytes)) {
       evictChunkByAlg();
     }
-    eviction_alg_->touchChunk(chunk_key);
-    cached_chunks_.emplace(chunk_key);
+    for (size_t i = 0; i < chunk_keys.size(); ++i) {
+      eviction_alg_->touchChunk(chunk_keys[i]);
+      cached_chunks_.emplace(chunk_keys[i], chunk_sizes[i]);
+    }
+    num_cached_bytes_ += num_bytes;
+  } else {
+    for (const auto& chunk_key : chunk_keys) {
+      static_cast<File_Namespace::FileBuffer*>(global_file_mgr_->getBuffer(chunk_key))
+          ->freeChunkPages();
+    }
+    num_rejections_ += chunk_keys.size();
   }
   global_file_mgr_->checkpoint(db_id, table_id);
+  VLOG(1) << dumpStats();
 }
 
 AbstractBuffer* ForeignStorageCache::getCachedChunkIfExists(const ChunkKey& chunk_key) {
   auto timer = DEBUG_TIMER(__func__);
+  {
+    std::lock_guard<std::mutex> sketch_lock(frequency_sketch_mutex_);
+    frequency_sketch_.increment(chunk_key);
+    incrementAccessCount(chunk_key);
+  }
   {
     read_lock lock(chunks_mutex_);
     if (cached_chunks_.find(chunk_key) == cached_chunks_.end()) {
+      ++num_misses_;
       return nullptr;
     }
   }
+  ++num_hits_;
   write_lock lock(chunks_mutex_);
   eviction_alg_->touchChunk(chunk_key);
   return global_file_mgr_->getBuffer(chunk_key);
 }
 
+bool ForeignStorageCache::isChunkCached(const ChunkKey& chunk_key) {
+  read_lock lock(chunks_mutex_);
+  return (cached_chunks_.find(chunk_key) != cached_chunks_.end());
+}
+
 bool ForeignStorageCache::isMetadataCached(const ChunkKey& chunk_key) {
   auto timer = DEBUG_TIMER(__func__);
   read_lock lock(metadata_mutex_);
@@ -96,8 +153,11 @@ bool ForeignStorageCache::recoverCacheForTable(ChunkMetadataVector& meta_vec,
   for (auto& [chunk_key, metadata] : meta_vec) {
     cached_metadata_.emplace(chunk_key);
     // If a filebuffer has no pages, then it only has cached metadata and no cached chunk.
-    if (global_file_mgr_->getBuffer(chunk_key)->pageCount() > 0) {
-      cached_chunks_.emplace(chunk_key);
+    auto buffer = global_file_mgr_->getBuffer(chunk_key);
+    if (buffer->pageCount() > 0) {
+      eviction_alg_->touchChunk(chunk_key);
+      cached_chunks_.emplace(chunk_key, buffer->size());
+      num_cached_bytes_ += buffer->size();
     }
   }
   return (meta_vec.size() > 0);
@@ -206,7 +266,8 @@ void ForeignStorageCache::clearForTablePrefix(const ChunkKey& chunk_prefix) {
     // We won't delete the buffers here because metadata delete will do that for us later.
     auto end_it = cached_chunks_.upper_bound(static_cast<const ChunkKey>(upper_prefix));
     for (auto chunk_it = cached_chunks_.lower_bound(chunk_prefix); chunk_it != end_it;) {
-      eviction_alg_->removeChunk(*chunk_it);
+      eviction_alg_->removeChunk(chunk_it->first);
+      num_cached_bytes_ -= chunk_it->second;
       chunk_it = cached_chunks_.erase(chunk_it);
     }
   }
@@ -227,9 +288,10 @@ void ForeignStorageCache::clear() {
   {
     write_lock w_lock(chunks_mutex_);
     for (auto chunk_it = cached_chunks_.begin(); chunk_it != cached_chunks_.end();) {
-      eviction_alg_->removeChunk(*chunk_it);
+      eviction_alg_->removeChunk(chunk_it->first);
       chunk_it = cached_chunks_.erase(chunk_it);
     }
+    num_cached_bytes_ = 0;
   }
   {
     write_lock w_lock(metadata_mutex_);
@@ -255,12 +317,24 @@ void ForeignStorageCache::setLimit(size_t limit) {
   global_file_mgr_->checkpoint();
 }
 
+void ForeignStorageCache::setSizeLimit(size_t size_limit) {
+  auto timer = DEBUG_TIMER(__func__);
+  write_lock w_lock(chunks_mutex_);
+  size_limit_ = size_limit;
+  while (size_limit_ > 0 && num_cached_bytes_ > size_limit_) {
+    evictChunkByAlg();
+  }
+  global_file_mgr_->checkpoint();
+}
+
 std::vector<ChunkKey> ForeignStorageCache::getCachedChunksForKeyPrefix(
     const ChunkKey& chunk_prefix) {
   read_lock r_lock(chunks_mutex_);
   std::vector<ChunkKey> ret_vec;
   iterateOverMatchingPrefix(
-      [&ret_vec](auto chunk) { ret_vec.push_back(chunk); }, cached_chunks_, chunk_prefix);
+      [&ret_vec](const auto& chunk) { ret_vec.push_back(chunk.first); },
+      cached_chunks_,
+      chunk_prefix);
   return ret_vec;
 }
 
@@ -283,6 +357,54 @@ std::map<ChunkKey, AbstractBuffer*> ForeignStorageCache::getChunkBuffersForCachi
   return chunk_buffer_map;
 }
 
+std::vector<ChunkKey> ForeignStorageCache::getChunksToWarmUp(const ChunkKey& table_key) {
+  CHECK(isTableKey(table_key));
+  auto timer = DEBUG_TIMER(__func__);
+  std::vector<std::pair<size_t, ChunkKey>> candidates;
+  {
+    std::lock_guard<std::mutex> sketch_lock(frequency_sketch_mutex_);
+    iterateOverMatchingPrefix(
+        [&candidates](const auto& access_count) {
+          if (!isVarLenKey(access_count.first) || isVarLenDataKey(access_count.first)) {
+            candidates.emplace_back(access_count.second, access_count.first);
+          }
+        },
+        access_counts_,
+        table_key);
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+
+  std::vector<ChunkKey> chunk_keys;
+  read_lock meta_lock(metadata_mutex_);
+  read_lock chunk_lock(chunks_mutex_);
+  size_t num_chunks = cached_chunks_.size();
+  size_t num_bytes = num_cached_bytes_;
+  for (const auto& [count, chunk_key] : candidates) {
+    if (cached_chunks_.find(chunk_key) != cached_chunks_.end() ||
+        cached_metadata_.find(chunk_key) == cached_metadata_.end()) {
+      continue;
+    }
+    // The size of a chunk whose metadata only is cached is the one of its metadata.
+    const size_t chunk_num_chunks = isVarLenKey(chunk_key) ? 2 : 1;
+    const size_t chunk_num_bytes = global_file_mgr_->getBuffer(chunk_key)->size();
+    if (num_chunks + chunk_num_chunks > entry_limit_ ||
+        (size_limit_ > 0 && num_bytes + chunk_num_bytes > size_limit_)) {
+      break;
+    }
+    num_chunks += chunk_num_chunks;
+    num_bytes += chunk_num_bytes;
+    chunk_keys.emplace_back(chunk_key);
+  }
+  return chunk_keys;
+}
+
+void ForeignStorageCache::saveAccessCounts() {
+  std::lock_guard<std::mutex> sketch_lock(frequency_sketch_mutex_);
+  writeAccessCounts();
+}
+
 // Private functions.  Locks should be acquired in the public interface before calling
 // these functions.
 // This function assumes the chunk has been erased from the eviction algorithm already.
@@ -291,24 +413,56 @@ void ForeignStorageCache::eraseChunk(const ChunkKey& chunk_key) {
   File_Namespace::FileBuffer* file_buffer =
       static_cast<File_Namespace::FileBuffer*>(global_file_mgr_->getBuffer(chunk_key));
   file_buffer->freeChunkPages();
-  cached_chunks_.erase(chunk_key);
+  auto chunk_it = cached_chunks_.find(chunk_key);
+  if (chunk_it != cached_chunks_.end()) {
+    num_cached_bytes_ -= chunk_it->second;
+    cached_chunks_.erase(chunk_it);
+  }
 }
 
 void ForeignStorageCache::evictChunkByAlg() {
   auto timer = DEBUG_TIMER(__func__);
   eraseChunk(eviction_alg_->evictNextChunk());
+  ++num_evictions_;
 }
 
-bool ForeignStorageCache::isCacheFull() const {
-  auto timer = DEBUG_TIMER(__func__);
-  return (cached_chunks_.size() >= entry_limit_);
+bool ForeignStorageCache::hasRoomFor(const size_t num_chunks,
+                                     const size_t num_bytes) const {
+  return cached_chunks_.size() + num_chunks <= entry_limit_ &&
+         (size_limit_ == 0 || num_cached_bytes_ + num_bytes <= size_limit_);
+}
+
+// TinyLFU admission: chunks which would evict others are only admitted if they were
+// accessed at least as often as the next victim, ties going to the newer chunks so
+// that the cache still behaves as an LRU one for chunks used equally often.
+bool ForeignStorageCache::admitChunks(const std::vector<ChunkKey>& chunk_keys,
+                                      const size_t num_bytes) {
+  if (chunk_keys.size() > entry_limit_ || (size_limit_ > 0 && num_bytes > size_limit_)) {
+    return false;
+  }
+  if (hasRoomFor(chunk_keys.size(), num_bytes)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> sketch_lock(frequency_sketch_mutex_);
+  // The chunks of a fragment are used together, e.g. the data and index chunks of a
+  // variable length column, so they are admitted as one.
+  size_t frequency = 0;
+  for (const auto& chunk_key : chunk_keys) {
+    frequency = std::max(frequency, frequency_sketch_.estimate(chunk_key));
+  }
+  return frequency >= frequency_sketch_.estimate(eviction_alg_->peekNextChunk());
+}
+
+ForeignStorageCache::Stats ForeignStorageCache::getStats() const {
+  return {num_hits_, num_misses_, num_evictions_, num_rejections_};
 }
 
 std::string ForeignStorageCache::dumpCachedChunkEntries() const {
   auto timer = DEBUG_TIMER(__func__);
   std::string ret_string = "Cached chunks:\n";
-  for (const auto& chunk_key : cached_chunks_) {
-    ret_string += "  " + showChunk(chunk_key) + "\n";
+  for (const auto& [chunk_key, num_bytes] : cached_chunks_) {
+    ret_string += "  " + showChunk(chunk_key) + " (" + std::to_string(num_bytes) +
+                  " bytes)\n";
   }
   return ret_string;
 }
@@ -326,6 +480,83 @@ std::string ForeignStorageCache::dumpEvictionQueue() const {
   return ((LRUEvictionAlgorithm*)eviction_alg_.get())->dumpEvictionQueue();
 }
 
+std::string ForeignStorageCache::dumpStats() const {
+  const auto stats = getStats();
+  const size_t num_lookups = stats.num_hits + stats.num_misses;
+  return "Disk cache: " + std::to_string(cached_chunks_.size()) + " chunks, " +
+         std::to_string(num_cached_bytes_) + " bytes, " + std::to_string(stats.num_hits) +
+         " hits, " + std::to_string(stats.num_misses) + " misses, hit ratio " +
+         std::to_string(num_lookups ? double(stats.num_hits) / num_lookups : 0.0) + ", " +
+         std::to_string(stats.num_evictions) + " evictions, " +
+         std::to_string(stats.num_rejections) + " rejected chunks";
+}
+
+void ForeignStorageCache::incrementAccessCount(const ChunkKey& chunk_key) {
+  ++access_counts_[chunk_key];
+  if (access_counts_.size() > kAccessCountsPerEntry * std::max(entry_limit_, size_t(1))) {
+    for (auto count_it = access_counts_.begin(); count_it != access_counts_.end();) {
+      count_it->second /= 2;
+      count_it = count_it->second ? std::next(count_it) : access_counts_.erase(count_it);
+    }
+  }
+  if (++num_accesses_since_save_ >= kAccessCountsSavePeriod) {
+    writeAccessCounts();
+  }
+}
+
+void ForeignStorageCache::loadAccessCounts() {
+  std::ifstream access_counts_file(access_counts_path_);
+  std::string line;
+  while (std::getline(access_counts_file, line)) {
+    std::istringstream line_stream(line);
+    size_t count{0};
+    ChunkKey chunk_key;
+    int key_part;
+    line_stream >> count;
+    while (line_stream >> key_part) {
+      chunk_key.emplace_back(key_part);
+    }
+    // Lines which are not a count and a chunk key are skipped.
+    if (!line_stream.eof() || count == 0 || chunk_key.size() < 4) {
+      continue;
+    }
+    access_counts_[chunk_key] = count;
+    // The sketch does not count further than kMaxCount anyway.
+    for (size_t i = 0; i < std::min(count, size_t(ChunkFrequencySketch::kMaxCount));
+         ++i) {
+      frequency_sketch_.increment(chunk_key);
+    }
+  }
+}
+
+void ForeignStorageCache::writeAccessCounts() {
+  num_accesses_since_save_ = 0;
+  // The counts are written to a temporary file first, so that a crash while writing
+  // does not lose the counts of the previous save.
+  const std::string tmp_path = access_counts_path_ + ".tmp";
+  {
+    std::ofstream access_counts_file(tmp_path, std::ios::trunc);
+    for (const auto& [chunk_key, count] : access_counts_) {
+      access_counts_file << count;
+      for (const auto key_part : chunk_key) {
+        access_counts_file << ' ' << key_part;
+      }
+      access_counts_file << '\n';
+    }
+    if (!access_counts_file) {
+      LOG(WARNING) << "Could not write the access counts of the disk cache to "
+                   << tmp_path;
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path, access_counts_path_, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not write the access counts of the disk cache to "
+                 << access_counts_path_ << ": " << ec.message();
+  }
+}
+
 void ForeignStorageCache::validatePath(const std::string& base_path) {
   // check if base_path already exists, and if not create one
   boost::filesystem::path path(base_path);
@@ -26,24 +26,35 @@
 #pragma once
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
 #include "../Shared/mapd_shared_mutex.h"
 #include "CacheEvictionAlgorithms/CacheEvictionAlgorithm.h"
+#include "CacheEvictionAlgorithms/ChunkFrequencySketch.h"
 #include "CacheEvictionAlgorithms/LRUEvictionAlgorithm.h"
 #include "DataMgr/AbstractBufferMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "ForeignDataWrapper.h"
 
 struct DiskCacheConfig {
+  static constexpr size_t kDefaultSizeLimit{size_t(20) << 30};
+
   std::string path;
   bool is_enabled = false;
   size_t entry_limit = 1024;
   size_t num_reader_threads = 0;
+  size_t size_limit = kDefaultSizeLimit;  // in bytes, 0 for no limit
   DiskCacheConfig() {}
   DiskCacheConfig(std::string p,
                   bool enabled = true,
                   size_t limit = 1024,
-                  size_t readers = 0)
-      : path(p), is_enabled(enabled), entry_limit(limit), num_reader_threads(readers) {}
+                  size_t readers = 0,
+                  size_t size = kDefaultSizeLimit)
+      : path(p)
+      , is_enabled(enabled)
+      , entry_limit(limit)
+      , num_reader_threads(readers)
+      , size_limit(size) {}
 };
 
 using namespace Data_Namespace;
@@ -52,9 +63,20 @@ namespace foreign_storage {
 
 class ForeignStorageCache {
  public:
+  struct Stats {
+    size_t num_hits;
+    size_t num_misses;
+    size_t num_evictions;
+    // Chunks not cached because the filter found them less used than the chunks they
+    // would have evicted, or because they do not fit in the cache.
+    size_t num_rejections;
+  };
+
   ForeignStorageCache(const std::string& cache_dir,
                       const size_t num_reader_threads,
-                      const size_t limit);
+                      const size_t limit,
+                      const size_t size_limit = 0);
+  ~ForeignStorageCache();
 
   /**
    * Caches the chunks for the given chunk keys. Chunk buffers
@@ -62,11 +84,17 @@ class ForeignStorageCache {
    * populated before calling this method. This method also
    * expects all provided chunk keys to be for the same table.
    *
+   * When chunks have to be evicted to make room, the chunks are only cached if one of
+   * them was accessed at least as often recently as the next chunk to evict, so that a
+   * single large scan does not evict the chunks in regular use. Otherwise their buffers
+   * are freed, and only their metadata stays cached.
+   *
    * @param chunk_keys - keys of chunks to be cached
    */
   void cacheTableChunks(const std::vector<ChunkKey>& chunk_keys);
 
   AbstractBuffer* getCachedChunkIfExists(const ChunkKey&);
+  bool isChunkCached(const ChunkKey&);
   bool isMetadataCached(const ChunkKey&);
   void cacheMetadataVec(const ChunkMetadataVector&);
   void getCachedMetadataVecForKeyPrefix(ChunkMetadataVector&, const ChunkKey&);
@@ -74,31 +102,53 @@ class ForeignStorageCache {
   void clearForTablePrefix(const ChunkKey&);
   void clear();
   void setLimit(size_t limit);
+  void setSizeLimit(size_t size_limit);
   std::vector<ChunkKey> getCachedChunksForKeyPrefix(const ChunkKey&);
   bool recoverCacheForTable(ChunkMetadataVector&, const ChunkKey&);
   std::map<ChunkKey, AbstractBuffer*> getChunkBuffersForCaching(
       const std::vector<ChunkKey>& chunk_keys);
 
+  /**
+   * Returns the keys of the chunks of a table which are not cached but whose metadata
+   * is, most accessed first, counting the accesses of previous runs. Only as many are
+   * returned as can be cached without evicting other chunks. Index chunks of variable
+   * length columns are left out, since they are cached along with their data chunks.
+   *
+   * @param table_key - key of the table to warm the cache up for
+   */
+  std::vector<ChunkKey> getChunksToWarmUp(const ChunkKey& table_key);
+
+  // Writes the access counts of the chunks to the cache directory, from which the next
+  // run reads them back.
+  void saveAccessCounts();
+
   // Exists for testing purposes.
   size_t getLimit() const { return entry_limit_; }
+  size_t getSizeLimit() const { return size_limit_; }
   size_t getNumCachedChunks() const { return cached_chunks_.size(); }
+  size_t getNumCachedBytes() const { return num_cached_bytes_; }
   size_t getNumCachedMetadata() const { return cached_metadata_.size(); }
+  Stats getStats() const;
 
   // Useful for debugging.
   std::string dumpCachedChunkEntries() const;
   std::string dumpCachedMetadataEntries() const;
   std::string dumpEvictionQueue() const;
+  std::string dumpStats() const;
 
   File_Namespace::GlobalFileMgr* getGlobalFileMgr() { return global_file_mgr_.get(); }
 
  private:
   // These methods are private and assume locks are already acquired when called.
-  std::set<ChunkKey>::iterator eraseChunk(const std::set<ChunkKey>::iterator&);
   void eraseChunk(const ChunkKey&);
   void evictThenEraseChunk(const ChunkKey&);
   void evictChunkByAlg();
-  bool isCacheFull() const;
+  bool hasRoomFor(const size_t num_chunks, const size_t num_bytes) const;
+  bool admitChunks(const std::vector<ChunkKey>& chunk_keys, const size_t num_bytes);
   void validatePath(const std::string&);
+  void loadAccessCounts();
+  void writeAccessCounts();
+  void incrementAccessCount(const ChunkKey&);
 
   // We can swap out different eviction algorithms here.
   std::unique_ptr<CacheEvictionAlgorithm> eviction_alg_ =
@@ -107,15 +157,35 @@ class ForeignStorageCache {
   // Underlying storage is handled by a GlobalFileMgr unique to the cache.
   std::unique_ptr<File_Namespace::GlobalFileMgr> global_file_mgr_;
 
-  // Keeps tracks of which Chunks/ChunkMetadata are cached.
-  std::set<ChunkKey> cached_chunks_;
+  // Keeps tracks of which Chunks/ChunkMetadata are cached, and the size of the chunks.
+  std::map<ChunkKey, size_t> cached_chunks_;
   std::set<ChunkKey> cached_metadata_;
+  size_t num_cached_bytes_{0};
 
   // Separate mutexes for chunks/metadata.
   mapd_shared_mutex chunks_mutex_;
   mapd_shared_mutex metadata_mutex_;
 
+  // Accesses of chunks, cached or not, for the admission of chunks into the cache.
+  // Misses are counted under a read lock of chunks_mutex_, hence the mutex of its own.
+  ChunkFrequencySketch frequency_sketch_;
+  mutable std::mutex frequency_sketch_mutex_;
+
+  // Accesses of every chunk, cached or not, in this and previous runs, for the warm-up
+  // of the cache. The counts are halved whenever the map outgrows the cache, so that it
+  // stays bounded and old accesses fade out. Guarded by frequency_sketch_mutex_.
+  std::map<ChunkKey, size_t> access_counts_;
+  size_t num_accesses_since_save_{0};
+  std::string access_counts_path_;
+
+  std::atomic<size_t> num_hits_{0};
+  std::atomic<size_t> num_misses_{0};
+  std::atomic<size_t> num_evictions_{0};
+  std::atomic<size_t> num_rejections_{0};
+
   // Maximum number of Chunks that can be in the cache before eviction.
   size_t entry_limit_;
+  // Maximum number of bytes of Chunks in the cache before eviction, 0 for no limit.
+  size_t size_limit_;
 };  // ForeignStorageCache
 }  // namespace foreign_storage
@@ -17,17 +17,59 @@
 
 #include "ForeignStorageMgr.h"
 
+#include <algorithm>
+#include <set>
+
 #include "Catalog/ForeignTable.h"
 #include "CsvDataWrapper.h"
 #include "ForeignTableSchema.h"
 #include "ParquetDataWrapper.h"
 
 namespace foreign_storage {
+namespace {
+const ForeignTable* get_foreign_table(const ChunkKey& table_key) {
+  auto catalog = Catalog_Namespace::Catalog::get(table_key[CHUNK_KEY_DB_IDX]);
+  CHECK(catalog);
+  auto foreign_table = dynamic_cast<const ForeignTable*>(
+      catalog->getMetadataForTableImpl(table_key[CHUNK_KEY_TABLE_IDX], false));
+  CHECK(foreign_table);
+  return foreign_table;
+}
+
+bool is_append_mode(const ChunkKey& table_key) {
+  return get_foreign_table(table_key)->isAppendMode();
+}
+
+// Fragments with a chunk whose metadata is new or differs from the old one
+std::set<int> get_changed_fragment_ids(const ChunkMetadataVector& old_metadata_vec,
+                                       const ChunkMetadataVector& metadata_vec) {
+  std::map<ChunkKey, std::shared_ptr<ChunkMetadata>> old_metadata_map(
+      old_metadata_vec.begin(), old_metadata_vec.end());
+  std::set<int> changed_fragment_ids;
+  for (const auto& [chunk_key, metadata] : metadata_vec) {
+    auto old_metadata_it = old_metadata_map.find(chunk_key);
+    if (old_metadata_it == old_metadata_map.end() ||
+        !(*old_metadata_it->second == *metadata)) {
+      changed_fragment_ids.emplace(chunk_key[CHUNK_KEY_FRAGMENT_IDX]);
+    }
+  }
+  return changed_fragment_ids;
+}
+}  // namespace
+
 ForeignStorageMgr::ForeignStorageMgr(ForeignStorageCache* fsc)
     : AbstractBufferMgr(0), data_wrapper_map_({}), foreign_storage_cache_(fsc) {
   is_cache_enabled_ = (foreign_storage_cache_ != nullptr);
 }
 
+ForeignStorageMgr::~ForeignStorageMgr() {
+  stop_warm_up_ = true;
+  std::lock_guard warm_up_lock(warm_up_mutex_);
+  for (auto& future : warm_up_futures_) {
+    future.wait();
+  }
+}
+
 AbstractBuffer* ForeignStorageMgr::getBuffer(const ChunkKey& chunk_key,
                                              const size_t num_bytes) {
   UNREACHABLE();
@@ -38,6 +80,7 @@ void ForeignStorageMgr::fetchBuffer(const ChunkKey& chunk_key,
                                     AbstractBuffer* destination_buffer,
                                     const size_t num_bytes) {
   CHECK(!destination_buffer->isDirty());
+  std::shared_lock cache_population_lock(cache_population_mutex_);
   bool cached = true;
   // This code is inlined from getBuffer() because we need to know if we had a cache hit
   // to know if we need to write back to the cache later.
@@ -178,6 +221,7 @@ void ForeignStorageMgr::getChunkMetadataVecForKeyPrefix(
     if (data_wrapper_map_.find(keyPrefix) == data_wrapper_map_.end()) {
       if (foreign_storage_cache_->recoverCacheForTable(chunk_metadata, keyPrefix)) {
         // If we recovered table data from disk then no need to create data wrappers yet.
+        warmUpCacheIfEnabled(keyPrefix);
         return;
       }
     }
@@ -187,10 +231,12 @@ void ForeignStorageMgr::getChunkMetadataVecForKeyPrefix(
 
   if (is_cache_enabled_) {
     foreign_storage_cache_->cacheMetadataVec(chunk_metadata);
+    warmUpCacheIfEnabled(keyPrefix);
   }
 }
 
 void ForeignStorageMgr::removeTableRelatedDS(const int db_id, const int table_id) {
+  std::lock_guard cache_population_lock(cache_population_mutex_);
   {
     std::lock_guard data_wrapper_lock(data_wrapper_mutex_);
     data_wrapper_map_.erase({db_id, table_id});
@@ -264,12 +310,18 @@ ForeignStorageCache* ForeignStorageMgr::getForeignStorageCache() const {
 
 void ForeignStorageMgr::refreshTables(const std::vector<ChunkKey>& table_keys,
                                       const bool evict_cached_entries) {
-  clearTempChunkBufferMap(table_keys);
-  if (evict_cached_entries) {
-    evictTablesFromCache(table_keys);
-  } else {
+  {
+    std::lock_guard cache_population_lock(cache_population_mutex_);
+    clearTempChunkBufferMap(table_keys);
+    if (evict_cached_entries) {
+      evictTablesFromCache(table_keys);
+      return;
+    }
     refreshTablesInCache(table_keys);
   }
+  for (const auto& table_key : table_keys) {
+    warmUpCacheIfEnabled(table_key);
+  }
 }
 
 void ForeignStorageMgr::refreshTablesInCache(const std::vector<ChunkKey>& table_keys) {
@@ -281,12 +333,43 @@ void ForeignStorageMgr::refreshTablesInCache(const std::vector<ChunkKey>& table_
     // Get a list of which chunks were cached for a table.
     std::vector<ChunkKey> old_chunk_keys =
         foreign_storage_cache_->getCachedChunksForKeyPrefix(table_key);
-    foreign_storage_cache_->clearForTablePrefix(table_key);
 
-    // Refresh metadata.
-    ChunkMetadataVector metadata_vec;
-    getDataWrapper(table_key)->populateChunkMetadata(metadata_vec);
-    foreign_storage_cache_->cacheMetadataVec(metadata_vec);
+    if (is_append_mode(table_key)) {
+      // Rows are only appended, so only the last fragment and new ones change. The
+      // chunks of the other fragments stay cached, and only the changed ones are
+      // evicted by caching their new metadata, then re-cached below.
+      ChunkMetadataVector old_metadata_vec;
+      foreign_storage_cache_->getCachedMetadataVecForKeyPrefix(old_metadata_vec,
+                                                               table_key);
+      ChunkMetadataVector metadata_vec;
+      getDataWrapper(table_key)->populateChunkMetadata(metadata_vec);
+      const auto changed_fragment_ids =
+          get_changed_fragment_ids(old_metadata_vec, metadata_vec);
+      ChunkMetadataVector changed_metadata_vec;
+      for (const auto& [chunk_key, metadata] : metadata_vec) {
+        if (changed_fragment_ids.count(chunk_key[CHUNK_KEY_FRAGMENT_IDX])) {
+          changed_metadata_vec.emplace_back(chunk_key, metadata);
+        }
+      }
+      if (!changed_metadata_vec.empty()) {
+        foreign_storage_cache_->cacheMetadataVec(changed_metadata_vec);
+      }
+      old_chunk_keys.erase(
+          std::remove_if(old_chunk_keys.begin(),
+                         old_chunk_keys.end(),
+                         [&changed_fragment_ids](const ChunkKey& chunk_key) {
+                           return !changed_fragment_ids.count(
+                               chunk_key[CHUNK_KEY_FRAGMENT_IDX]);
+                         }),
+          old_chunk_keys.end());
+    } else {
+      foreign_storage_cache_->clearForTablePrefix(table_key);
+
+      // Refresh metadata.
+      ChunkMetadataVector metadata_vec;
+      getDataWrapper(table_key)->populateChunkMetadata(metadata_vec);
+      foreign_storage_cache_->cacheMetadataVec(metadata_vec);
+    }
 
     // Iterate through previously cached chunks and re-cache them. Caching is
     // done one fragment at a time, for all applicable chunks in the fragment.
@@ -355,6 +438,54 @@ void ForeignStorageMgr::clearTempChunkBufferMapEntriesForTable(const int db_id,
   temp_chunk_buffer_map_.erase(start_it, end_it);
 }
 
+void ForeignStorageMgr::warmUpCacheIfEnabled(const ChunkKey& table_key) {
+  if (!is_cache_enabled_ || !get_foreign_table(table_key)->isCacheWarmUpEnabled()) {
+    return;
+  }
+  std::lock_guard warm_up_lock(warm_up_mutex_);
+  warm_up_futures_.erase(
+      std::remove_if(warm_up_futures_.begin(),
+                     warm_up_futures_.end(),
+                     [](const auto& future) {
+                       return future.wait_for(std::chrono::seconds(0)) ==
+                              std::future_status::ready;
+                     }),
+      warm_up_futures_.end());
+  warm_up_futures_.emplace_back(
+      std::async(std::launch::async, &ForeignStorageMgr::warmUpCache, this, table_key));
+}
+
+// Fetches the most accessed chunks of a table into the cache, as the queries of the
+// previous run fetched them, one logical column of a fragment at a time.
+void ForeignStorageMgr::warmUpCache(const ChunkKey& table_key) {
+  size_t num_cached_chunks{0};
+  try {
+    for (const auto& chunk_key : foreign_storage_cache_->getChunksToWarmUp(table_key)) {
+      if (stop_warm_up_) {
+        break;
+      }
+      std::lock_guard cache_population_lock(cache_population_mutex_);
+      // Queries may have fetched the chunk since, or the table may have been dropped.
+      if (foreign_storage_cache_->isChunkCached(chunk_key) ||
+          !foreign_storage_cache_->isMetadataCached(chunk_key)) {
+        continue;
+      }
+      std::vector<ChunkKey> chunk_keys;
+      std::map<ChunkKey, AbstractBuffer*> optional_buffers;
+      auto required_buffers = getChunkBuffersToPopulate(chunk_key, nullptr, chunk_keys);
+      populateBuffersFromOptionallyCreatedWrapper(
+          chunk_key, required_buffers, optional_buffers);
+      foreign_storage_cache_->cacheTableChunks(chunk_keys);
+      num_cached_chunks += chunk_keys.size();
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Warm-up of the disk cache for table " << showChunk(table_key)
+                 << " failed: " << e.what();
+  }
+  VLOG(1) << "Warmed up the disk cache with " << num_cached_chunks
+          << " chunks of table " << showChunk(table_key);
+}
+
 void ForeignStorageMgr::populateBuffersFromOptionallyCreatedWrapper(
     const ChunkKey& chunk_key,
     std::map<ChunkKey, AbstractBuffer*>& required_buffers,
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <future>
 #include <shared_mutex>
 
 #include "DataMgr/AbstractBufferMgr.h"
@@ -29,6 +31,7 @@ namespace foreign_storage {
 class ForeignStorageMgr : public AbstractBufferMgr {
  public:
   ForeignStorageMgr(ForeignStorageCache* fsc = nullptr);
+  ~ForeignStorageMgr() override;
 
   AbstractBuffer* createBuffer(const ChunkKey& chunk_key,
                                const size_t page_size,
@@ -89,6 +92,8 @@ class ForeignStorageMgr : public AbstractBufferMgr {
   void evictTablesFromCache(const std::vector<ChunkKey>& table_keys);
   void clearTempChunkBufferMap(const std::vector<ChunkKey>& table_keys);
   void clearTempChunkBufferMapEntriesForTable(const int db_id, const int table_id);
+  void warmUpCacheIfEnabled(const ChunkKey& table_key);
+  void warmUpCache(const ChunkKey& table_key);
 
   std::shared_mutex data_wrapper_mutex_;
 
@@ -101,5 +106,14 @@ class ForeignStorageMgr : public AbstractBufferMgr {
 
   ForeignStorageCache* foreign_storage_cache_;
   bool is_cache_enabled_;
+
+  // Chunks are fetched into the cache under a shared lock, and by the warm-up of the
+  // cache, refreshes and drops of tables under an exclusive one, so that the warm-up
+  // running in the background never populates a chunk at the same time as another.
+  std::shared_mutex cache_population_mutex_;
+
+  std::mutex warm_up_mutex_;
+  std::vector<std::future<void>> warm_up_futures_;
+  std::atomic<bool> stop_warm_up_{false};
 };
 }  // namespace foreign_storage
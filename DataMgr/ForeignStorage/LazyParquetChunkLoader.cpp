@@ -16,11 +16,17 @@
 
 #include "LazyParquetChunkLoader.h"
 
+#include <algorithm>
+#include <future>
+
 #include <arrow/api.h>
 #include <arrow/io/api.h>
 #include <parquet/arrow/reader.h>
+#include <parquet/column_page.h>
 #include <parquet/column_scanner.h>
+#include <parquet/encoding.h>
 #include <parquet/exception.h>
+#include <parquet/metadata.h>
 #include <parquet/platform.h>
 #include <parquet/types.h>
 
@@ -32,6 +38,8 @@
 #include "ParquetTimeEncoder.h"
 #include "ParquetTimestampEncoder.h"
 
+extern size_t g_bloom_filter_bits_per_value;
+
 namespace foreign_storage {
 
 namespace {
@@ -320,55 +328,191 @@ void resize_values_buffer(const ColumnDescriptor* omnisci_column,
   values.resize(values_size);
 }
 
-std::shared_ptr<ChunkMetadata> append_row_groups(
-    const Interval<RowGroupType>& row_group_interval,
-    const int logical_column_index,
-    const ColumnDescriptor* column_descriptor,
-    const parquet::ColumnDescriptor* parquet_column_descriptor,
-    Chunk_NS::Chunk& chunk,
-    parquet::ParquetFileReader* reader,
-    StringDictionary* string_dictionary) {
-  std::shared_ptr<ChunkMetadata> chunk_metadata;
-  // `def_levels` and `rep_levels` below are used to store the read definition
-  // and repetition levels of the Dremel encoding implemented by the Parquet
-  // format
-  std::vector<int16_t> def_levels(LazyParquetChunkLoader::batch_reader_num_elements);
-  std::vector<int16_t> rep_levels(LazyParquetChunkLoader::batch_reader_num_elements);
-  std::vector<int8_t> values;
-  resize_values_buffer(column_descriptor, parquet_column_descriptor, values);
-  auto encoder = create_parquet_encoder(column_descriptor,
-                                        parquet_column_descriptor,
-                                        chunk,
-                                        string_dictionary,
-                                        chunk_metadata);
-  CHECK(encoder.get());
-  int64_t values_read = 0;
-  for (int row_group_index = row_group_interval.start;
-       row_group_index <= row_group_interval.end;
-       ++row_group_index) {
+/**
+ * Decodes a column of a row group with encoder, a batch at a time
+ */
+class RowGroupDecoder {
+ public:
+  RowGroupDecoder(const ColumnDescriptor* column_descriptor,
+                  const parquet::ColumnDescriptor* parquet_column_descriptor,
+                  std::shared_ptr<ParquetEncoder> encoder)
+      : parquet_column_descriptor_(parquet_column_descriptor)
+      , encoder_(std::move(encoder))
+      , def_levels_(LazyParquetChunkLoader::batch_reader_num_elements)
+      , rep_levels_(LazyParquetChunkLoader::batch_reader_num_elements) {
+    CHECK(encoder_.get());
+    resize_values_buffer(column_descriptor, parquet_column_descriptor, values_);
+  }
+
+  void decode(parquet::ParquetFileReader* reader,
+              const int row_group_index,
+              const int logical_column_index) {
     auto group_reader = reader->RowGroup(row_group_index);
     std::shared_ptr<parquet::ColumnReader> col_reader =
         group_reader->Column(logical_column_index);
     if (col_reader->descr()->max_repetition_level() > 0) {
       throw std::runtime_error("Nested schema detected in column '" +
-                               parquet_column_descriptor->name() +
+                               parquet_column_descriptor_->name() +
                                "'. Only flat schemas are supported.");
     }
 
+    int64_t values_read = 0;
     while (col_reader->HasNext()) {
       int64_t levels_read =
           parquet::ScanAllValues(LazyParquetChunkLoader::batch_reader_num_elements,
-                                 def_levels.data(),
-                                 rep_levels.data(),
-                                 reinterpret_cast<uint8_t*>(values.data()),
+                                 def_levels_.data(),
+                                 rep_levels_.data(),
+                                 reinterpret_cast<uint8_t*>(values_.data()),
                                  &values_read,
                                  col_reader.get());
-      encoder->appendData(def_levels.data(), values_read, levels_read, values.data());
+      encoder_->appendData(def_levels_.data(), values_read, levels_read, values_.data());
     }
   }
+
+ private:
+  const parquet::ColumnDescriptor* parquet_column_descriptor_;
+  std::shared_ptr<ParquetEncoder> encoder_;
+  // `def_levels_` and `rep_levels_` below are used to store the read definition
+  // and repetition levels of the Dremel encoding implemented by the Parquet
+  // format
+  std::vector<int16_t> def_levels_;
+  std::vector<int16_t> rep_levels_;
+  std::vector<int8_t> values_;
+};
+
+std::shared_ptr<ChunkMetadata> append_row_groups(
+    const Interval<RowGroupType>& row_group_interval,
+    const int logical_column_index,
+    const ColumnDescriptor* column_descriptor,
+    const parquet::ColumnDescriptor* parquet_column_descriptor,
+    Chunk_NS::Chunk& chunk,
+    parquet::ParquetFileReader* reader,
+    StringDictionary* string_dictionary) {
+  std::shared_ptr<ChunkMetadata> chunk_metadata;
+  RowGroupDecoder decoder(column_descriptor,
+                          parquet_column_descriptor,
+                          create_parquet_encoder(column_descriptor,
+                                                 parquet_column_descriptor,
+                                                 chunk,
+                                                 string_dictionary,
+                                                 chunk_metadata));
+  for (int row_group_index = row_group_interval.start;
+       row_group_index <= row_group_interval.end;
+       ++row_group_index) {
+    decoder.decode(reader, row_group_index, logical_column_index);
+  }
   return chunk_metadata;
 }
 
+/**
+ * Decodes the row groups of a column of fixed length values on num_threads threads. The
+ * values of a row group start at an offset of the chunk buffer known from the row
+ * counts of the row groups before it, so every thread decodes its row groups through a
+ * reader of its own right into their parts of the buffer.
+ */
+void append_row_groups_in_parallel(const Interval<RowGroupType>& row_group_interval,
+                                   const int logical_column_index,
+                                   const ColumnDescriptor* column_descriptor,
+                                   Chunk_NS::Chunk& chunk,
+                                   parquet::ParquetFileReader* reader,
+                                   const std::string& file_name,
+                                   const size_t num_threads) {
+  CHECK(!column_descriptor->columnType.is_varlen());
+  auto buffer = chunk.getBuffer();
+  const size_t value_size = column_descriptor->columnType.get_size();
+  const auto file_metadata = reader->metadata();
+  const int num_row_groups = row_group_interval.end - row_group_interval.start + 1;
+  std::vector<size_t> offsets{buffer->size()};
+  for (int i = 0; i < num_row_groups; ++i) {
+    const auto row_group_metadata = file_metadata->RowGroup(row_group_interval.start + i);
+    offsets.push_back(offsets.back() + row_group_metadata->num_rows() * value_size);
+  }
+  if (buffer->reservedSize() < offsets.back()) {
+    buffer->reserve(offsets.back() - buffer->size());
+  }
+  int8_t* memory = buffer->getMemoryPtr();
+
+  std::vector<std::future<void>> decode_threads;
+  for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+    decode_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      std::unique_ptr<parquet::arrow::FileReader> thread_reader;
+      open_parquet_table(file_name, thread_reader);
+      const auto parquet_column_descriptor =
+          get_column_descriptor(thread_reader, logical_column_index);
+      std::shared_ptr<ChunkMetadata> chunk_metadata;  // only used by strings
+      auto encoder = std::dynamic_pointer_cast<ParquetInPlaceEncoder>(
+          create_parquet_encoder(column_descriptor,
+                                 parquet_column_descriptor,
+                                 chunk,
+                                 nullptr,
+                                 chunk_metadata));
+      CHECK(encoder);
+      RowGroupDecoder decoder(column_descriptor, parquet_column_descriptor, encoder);
+      for (int i = thread_idx; i < num_row_groups; i += num_threads) {
+        encoder->setDestination(memory + offsets[i]);
+        decoder.decode(thread_reader->parquet_reader(),
+                       row_group_interval.start + i,
+                       logical_column_index);
+        CHECK_EQ(encoder->getDestination(), memory + offsets[i + 1]);
+      }
+    }));
+  }
+  for (auto& decode_thread : decode_threads) {
+    decode_thread.wait();
+  }
+  for (auto& decode_thread : decode_threads) {
+    decode_thread.get();
+  }
+  buffer->setSize(offsets.back());
+}
+
+bool is_dictionary_encoding(const parquet::Encoding::type encoding) {
+  return encoding == parquet::Encoding::PLAIN_DICTIONARY ||
+         encoding == parquet::Encoding::RLE_DICTIONARY;
+}
+
+// Whether all values of a column chunk are in its dictionary page. The page encoding
+// stats tell exactly, and without them the chunk must not list any encoding other than
+// the dictionary ones and those of the levels, which rules out a fallback to PLAIN.
+bool is_dictionary_encoded(const parquet::ColumnChunkMetaData& column_chunk) {
+  if (!column_chunk.has_dictionary_page()) {
+    return false;
+  }
+  const auto& encoding_stats = column_chunk.encoding_stats();
+  if (!encoding_stats.empty()) {
+    return std::all_of(
+        encoding_stats.begin(), encoding_stats.end(), [](const auto& page_stats) {
+          return page_stats.page_type == parquet::PageType::DICTIONARY_PAGE ||
+                 is_dictionary_encoding(page_stats.encoding);
+        });
+  }
+  const auto encodings = column_chunk.encodings();
+  return std::all_of(encodings.begin(), encodings.end(), [](const auto encoding) {
+    return is_dictionary_encoding(encoding) || encoding == parquet::Encoding::RLE ||
+           encoding == parquet::Encoding::BIT_PACKED;
+  });
+}
+
+template <typename DType>
+void decode_dictionary_page(const parquet::DictionaryPage& dictionary_page,
+                            const parquet::ColumnDescriptor* parquet_column,
+                            const bool is_unsigned,
+                            std::vector<int64_t>& values) {
+  using T = typename DType::c_type;
+  auto decoder =
+      parquet::MakeTypedDecoder<DType>(parquet::Encoding::PLAIN, parquet_column);
+  decoder->SetData(
+      dictionary_page.num_values(), dictionary_page.data(), dictionary_page.size());
+  std::vector<T> dictionary(dictionary_page.num_values());
+  const auto num_decoded = decoder->Decode(dictionary.data(), dictionary.size());
+  CHECK_EQ(static_cast<size_t>(num_decoded), dictionary.size());
+  for (const auto value : dictionary) {
+    // unsigned values are stored in the signed type of their size
+    values.push_back(is_unsigned ? static_cast<int64_t>(std::make_unsigned_t<T>(value))
+                                 : static_cast<int64_t>(value));
+  }
+}
+
 bool validate_decimal_mapping(const ColumnDescriptor* omnisci_column,
                               const parquet::ColumnDescriptor* parquet_column) {
   if (auto decimal_logical_column = dynamic_cast<const parquet::DecimalLogicalType*>(
@@ -546,6 +690,57 @@ bool LazyParquetChunkLoader::isColumnMappingSupported(
   return false;
 }
 
+std::shared_ptr<ChunkBloomFilter> LazyParquetChunkLoader::loadDictionaryBloomFilter(
+    parquet::ParquetFileReader* reader,
+    const Interval<RowGroupType>& row_group_interval,
+    const int parquet_column_index,
+    const ColumnDescriptor* omnisci_column) {
+  const auto file_metadata = reader->metadata();
+  const auto parquet_column = file_metadata->schema()->Column(parquet_column_index);
+  // the values of the chunk stats of integers are the ones stored in the file
+  if (!omnisci_column->columnType.is_integer() ||
+      !isColumnMappingSupported(omnisci_column, parquet_column) ||
+      (parquet_column->physical_type() != parquet::Type::INT32 &&
+       parquet_column->physical_type() != parquet::Type::INT64)) {
+    return nullptr;
+  }
+  const auto int_logical_column =
+      dynamic_cast<const parquet::IntLogicalType*>(parquet_column->logical_type().get());
+  const bool is_unsigned = int_logical_column && !int_logical_column->is_signed();
+
+  std::vector<int64_t> values;
+  for (int row_group_index = row_group_interval.start;
+       row_group_index <= row_group_interval.end;
+       ++row_group_index) {
+    const auto column_chunk =
+        file_metadata->RowGroup(row_group_index)->ColumnChunk(parquet_column_index);
+    if (!is_dictionary_encoded(*column_chunk)) {
+      return nullptr;
+    }
+    auto page_reader =
+        reader->RowGroup(row_group_index)->GetColumnPageReader(parquet_column_index);
+    const auto page = page_reader->NextPage();
+    if (!page || page->type() != parquet::PageType::DICTIONARY_PAGE) {
+      return nullptr;
+    }
+    const auto& dictionary_page = static_cast<const parquet::DictionaryPage&>(*page);
+    if (parquet_column->physical_type() == parquet::Type::INT32) {
+      decode_dictionary_page<parquet::Int32Type>(
+          dictionary_page, parquet_column, is_unsigned, values);
+    } else {
+      decode_dictionary_page<parquet::Int64Type>(
+          dictionary_page, parquet_column, is_unsigned, values);
+    }
+  }
+
+  auto bloom_filter =
+      ChunkBloomFilter::extend(nullptr, values.size(), g_bloom_filter_bits_per_value);
+  for (const auto value : values) {
+    bloom_filter->add(value);
+  }
+  return bloom_filter;
+}
+
 LazyParquetChunkLoader::LazyParquetChunkLoader(const std::string& file_name)
     : file_name_(file_name) {}
 
@@ -553,7 +748,8 @@ std::shared_ptr<ChunkMetadata> LazyParquetChunkLoader::loadChunk(
     const Interval<RowGroupType>& row_group_interval,
     const int parquet_column_index,
     Chunk_NS::Chunk& chunk,
-    StringDictionary* string_dictionary) {
+    StringDictionary* string_dictionary,
+    const size_t max_num_threads) {
   std::unique_ptr<parquet::arrow::FileReader> reader;
   open_parquet_table(file_name_, reader);
 
@@ -568,6 +764,20 @@ std::shared_ptr<ChunkMetadata> LazyParquetChunkLoader::loadChunk(
 
   auto parquet_column_descriptor = get_column_descriptor(reader, parquet_column_index);
 
+  const size_t num_threads = std::min(
+      max_num_threads,
+      static_cast<size_t>(row_group_interval.end - row_group_interval.start + 1));
+  if (num_threads > 1 && !column_descriptor->columnType.is_string()) {
+    append_row_groups_in_parallel(row_group_interval,
+                                  parquet_column_index,
+                                  column_descriptor,
+                                  chunk,
+                                  reader->parquet_reader(),
+                                  file_name_,
+                                  num_threads);
+    return {};
+  }
+
   auto metadata = append_row_groups(row_group_interval,
                                     parquet_column_index,
                                     column_descriptor,
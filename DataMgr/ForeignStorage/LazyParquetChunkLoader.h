@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <parquet/file_reader.h>
 #include <parquet/schema.h>
 
 #include "DataMgr/Chunk/Chunk.h"
+#include "DataMgr/ChunkBloomFilter.h"
 #include "ImportExport/Importer.h"
 #include "Interval.h"
 
@@ -45,6 +47,8 @@ class LazyParquetChunkLoader {
    * @param chunk - the chunk to load
    * @param string_dictionary - a string dictionary for the column corresponding to the
    * column, if applicable
+   * @param max_num_threads - the number of threads which may decode row groups of the
+   * column in parallel; string columns are always decoded on the calling thread
    *
    * @return An empty ChunkMetadata pointer when no metadata update is
    * applicable, otherwise a ChunkMetadata pointer with which to update the
@@ -57,7 +61,8 @@ class LazyParquetChunkLoader {
       const Interval<RowGroupType>& row_group_interval,
       const int parquet_column_index,
       Chunk_NS::Chunk& chunk,
-      StringDictionary* string_dictionary = nullptr);
+      StringDictionary* string_dictionary = nullptr,
+      const size_t max_num_threads = 1);
 
   /**
    * Determine if a Parquet to OmniSci column mapping is supported.
@@ -71,6 +76,25 @@ class LazyParquetChunkLoader {
   static bool isColumnMappingSupported(const ColumnDescriptor* omnisci_column,
                                        const parquet::ColumnDescriptor* parquet_column);
 
+  /**
+   * Build a Bloom filter of the values of an integer column in a number of row groups
+   * from the dictionary pages of its column chunks, without decoding any data page.
+   *
+   * @param reader - the reader of the parquet file
+   * @param row_group_interval - an inclusive interval [start,end] of the row groups
+   * @param parquet_column_index - the logical column index in the parquet file
+   * @param omnisci_column - the column descriptor of the OmniSci column
+   *
+   * @return A filter of the values in the units of the chunk stats, or an empty pointer
+   * if the column is not an integer column or a column chunk has data pages which are
+   * not dictionary encoded
+   */
+  static std::shared_ptr<ChunkBloomFilter> loadDictionaryBloomFilter(
+      parquet::ParquetFileReader* reader,
+      const Interval<RowGroupType>& row_group_interval,
+      const int parquet_column_index,
+      const ColumnDescriptor* omnisci_column);
+
  private:
   std::string file_name_;
 };
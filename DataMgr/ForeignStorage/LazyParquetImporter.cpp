@@ -483,7 +483,8 @@ void LazyParquetImporter::partialImport(const Interval<RowGroupType>& row_group_
 
   // Check which row groups and columns to import
   auto row_groups_to_import_interval =
-      metadata_scan ? Interval<RowGroupType>{0, num_row_groups - 1} : row_group_interval;
+      metadata_scan ? Interval<RowGroupType>{row_group_interval.start, num_row_groups - 1}
+                    : row_group_interval;
   auto columns_to_import_interval =
       metadata_scan
           ? Interval<ColumnType>{schema_.getLogicalAndPhysicalColumns().front()->columnId,
@@ -56,8 +56,8 @@ class LazyParquetImporter : public import_export::Importer {
    * read
    * @param column_interval - [start,end] inclusive interval specifying range of
    * columns to read
-   * @param metadata_scan - if true, a scan is performed over the entire Parquet file to
-   * load metadata
+   * @param metadata_scan - if true, a scan is performed over the Parquet file, from the
+   * start of row_group_interval to the last row group, to load metadata
    */
   void partialImport(const Interval<RowGroupType>& row_group_interval,
                      const Interval<ColumnType>& column_interval,
@@ -65,8 +65,13 @@ class LazyParquetImporter : public import_export::Importer {
 
   /**
    * Scan the parquet file, importing only the metadata
+   *
+   * @param first_row_group - row group to start the scan from, the ones before it being
+   * already scanned
    */
-  void metadataScan() { partialImport({0, 0}, {0, 0}, true); }
+  void metadataScan(const RowGroupType first_row_group = 0) {
+    partialImport({first_row_group, first_row_group}, {0, 0}, true);
+  }
 
  private:
   RowGroupMetadataVector& row_group_metadata_vec_;
@@ -18,13 +18,19 @@
 #include "LazyParquetChunkLoader.h"
 #include "ParquetShared.h"
 
+#include <future>
 #include <regex>
 
 #include <boost/filesystem.hpp>
 
 #include "ImportExport/Importer.h"
+#include "Shared/thread_count.h"
+
+extern size_t g_bloom_filter_bits_per_value;
 #include "Utils/DdlUtils.h"
 
+bool g_enable_parquet_dictionary_bloom_filters{true};
+
 namespace foreign_storage {
 
 namespace {
@@ -46,6 +52,7 @@ ParquetDataWrapper::ParquetDataWrapper(const int db_id, const ForeignTable* fore
     , last_fragment_index_(0)
     , last_fragment_row_count_(0)
     , last_row_group_(0)
+    , num_row_groups_(0)
     , schema_(std::make_unique<ForeignTableSchema>(db_id, foreign_table)) {}
 
 ParquetDataWrapper::ParquetDataWrapper(const ForeignTable* foreign_table)
@@ -78,6 +85,7 @@ void ParquetDataWrapper::resetParquetMetadata() {
   last_row_group_ = 0;
   last_fragment_index_ = 0;
   last_fragment_row_count_ = 0;
+  num_row_groups_ = 0;
 }
 
 std::list<const ColumnDescriptor*> ParquetDataWrapper::getColumnsToInitialize(
@@ -159,19 +167,74 @@ void ParquetDataWrapper::updateFragmentMap(int fragment_index, int row_group) {
   fragment_to_row_group_interval_map_[fragment_index] = {row_group, -1};
 }
 
-void ParquetDataWrapper::fetchChunkMetadata() {
+void ParquetDataWrapper::fetchChunkMetadata(const bool append) {
   auto catalog = Catalog_Namespace::Catalog::get(db_id_);
   CHECK(catalog);
 
-  resetParquetMetadata();
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  open_parquet_table(getFilePath(), reader);
+  const int num_row_groups = reader->parquet_reader()->metadata()->num_row_groups();
+  const int first_fragment_index = append ? last_fragment_index_ : 0;
+  if (append) {
+    // The row groups scanned before are assumed to be unchanged.
+    if (num_row_groups < num_row_groups_) {
+      throw std::runtime_error{
+          "Refresh of foreign table created with APPEND update mode failed as file "
+          "reduced in size: \"" +
+          boost::filesystem::path(getFilePath()).filename().string() + "\"."};
+    }
+    if (num_row_groups == num_row_groups_) {
+      return;
+    }
+  } else {
+    resetParquetMetadata();
+  }
   LazyParquetImporter::RowGroupMetadataVector metadata_vector;
   LazyParquetImporter importer(getMetadataLoader(*catalog, metadata_vector),
                                getFilePath(),
                                validateAndGetCopyParams(),
                                metadata_vector,
                                *schema_);
-  importer.metadataScan();
+  importer.metadataScan(num_row_groups_);
+  num_row_groups_ = num_row_groups;
   finalizeFragmentMap();
+  if (g_enable_parquet_dictionary_bloom_filters && g_bloom_filter_bits_per_value) {
+    loadDictionaryBloomFilters(first_fragment_index);
+  }
+}
+
+void ParquetDataWrapper::loadDictionaryBloomFilters(const int first_fragment_index) {
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  open_parquet_table(getFilePath(), reader);
+  for (const auto column : schema_->getLogicalColumns()) {
+    if (!column->columnType.is_integer()) {
+      continue;
+    }
+    const auto parquet_column_index = schema_->getParquetColumnIndex(column->columnId);
+    for (auto fragment_it =
+             fragment_to_row_group_interval_map_.lower_bound(first_fragment_index);
+         fragment_it != fragment_to_row_group_interval_map_.end();
+         ++fragment_it) {
+      const auto& [fragment_id, row_group_interval] = *fragment_it;
+      const ChunkKey chunk_key{
+          db_id_, foreign_table_->tableId, column->columnId, fragment_id};
+      const auto metadata_it = chunk_metadata_map_.find(chunk_key);
+      if (metadata_it == chunk_metadata_map_.end()) {
+        continue;
+      }
+      auto bloom_filter = LazyParquetChunkLoader::loadDictionaryBloomFilter(
+          reader->parquet_reader(),
+          {row_group_interval.start_row_group_index,
+           row_group_interval.end_row_group_index},
+          parquet_column_index,
+          column);
+      if (!bloom_filter) {
+        break;  // the column is not dictionary encoded in the file
+      }
+      std::atomic_store(&metadata_it->second->bloomFilter,
+                        std::shared_ptr<const ChunkBloomFilter>(std::move(bloom_filter)));
+    }
+  }
 }
 
 std::string ParquetDataWrapper::getFilePath() {
@@ -402,8 +465,12 @@ bool ParquetDataWrapper::moveToNextFragment(size_t new_rows_count) {
 
 void ParquetDataWrapper::populateChunkMetadata(
     ChunkMetadataVector& chunk_metadata_vector) {
-  chunk_metadata_map_.clear();
-  fetchChunkMetadata();
+  // In APPEND mode, the metadata of the fragments scanned before is only extended.
+  const bool append = foreign_table_->isAppendMode() && num_row_groups_ > 0;
+  if (!append) {
+    chunk_metadata_map_.clear();
+  }
+  fetchChunkMetadata(append);
   for (const auto& [chunk_key, chunk_metadata] : chunk_metadata_map_) {
     chunk_metadata_vector.emplace_back(chunk_key, chunk_metadata);
   }
@@ -413,6 +480,7 @@ void ParquetDataWrapper::loadBuffersUsingLazyParquetChunkLoader(
     const int logical_column_id,
     const int fragment_id,
     const size_t physical_byte_size,
+    const size_t num_threads,
     std::map<ChunkKey, AbstractBuffer*>& required_buffers) {
   auto catalog = Catalog_Namespace::Catalog::get(db_id_);
   CHECK(catalog);
@@ -458,7 +526,8 @@ void ParquetDataWrapper::loadBuffersUsingLazyParquetChunkLoader(
       {row_group_interval.start_row_group_index, row_group_interval.end_row_group_index},
       parquet_column_index,
       chunk,
-      string_dictionary);
+      string_dictionary,
+      num_threads);
 
   if (logical_column->columnType
           .is_dict_encoded_string()) {  // update metadata for dictionary encoded strings
@@ -515,18 +584,49 @@ void ParquetDataWrapper::populateChunkBuffers(
     logical_column_ids.emplace(column_id);
   }
 
+  std::vector<std::pair<int, size_t>> lazily_loaded_columns;
   for (const auto column_id : logical_column_ids) {
     const ColumnDescriptor* column_descriptor = schema_->getColumnDescriptor(column_id);
     auto parquet_column_index = schema_->getParquetColumnIndex(column_id);
     if (LazyParquetChunkLoader::isColumnMappingSupported(
             column_descriptor, get_column_descriptor(reader, parquet_column_index))) {
-      auto physical_byte_size = get_physical_type_byte_size(reader, parquet_column_index);
-      loadBuffersUsingLazyParquetChunkLoader(
-          column_id, fragment_id, physical_byte_size, required_buffers);
+      lazily_loaded_columns.emplace_back(
+          column_id, get_physical_type_byte_size(reader, parquet_column_index));
     } else {
       loadBuffersUsingLazyParquetImporter(column_id, fragment_id, required_buffers);
     }
   }
+
+  // The columns are decoded in parallel, and the threads left over decode row groups
+  // of a column in parallel. The chunks of the columns and the maps they are looked up
+  // in are not modified while the threads run.
+  if (lazily_loaded_columns.empty()) {
+    return;
+  }
+  const size_t num_threads = std::max(cpu_threads(), 1);
+  const size_t num_column_threads = std::min(num_threads, lazily_loaded_columns.size());
+  const size_t num_row_group_threads =
+      std::max(num_threads / num_column_threads, size_t(1));
+  std::vector<std::future<void>> load_threads;
+  for (size_t thread_idx = 0; thread_idx < num_column_threads; ++thread_idx) {
+    load_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      for (size_t i = thread_idx; i < lazily_loaded_columns.size();
+           i += num_column_threads) {
+        const auto [column_id, physical_byte_size] = lazily_loaded_columns[i];
+        loadBuffersUsingLazyParquetChunkLoader(column_id,
+                                               fragment_id,
+                                               physical_byte_size,
+                                               num_row_group_threads,
+                                               required_buffers);
+      }
+    }));
+  }
+  for (auto& load_thread : load_threads) {
+    load_thread.wait();
+  }
+  for (auto& load_thread : load_threads) {
+    load_thread.get();
+  }
 }
 
 }  // namespace foreign_storage
@@ -52,7 +52,21 @@ class ParquetDataWrapper : public ForeignDataWrapper {
                               std::map<ChunkKey, AbstractBuffer*>& required_buffers,
                               const bool reserve_buffers_and_set_stats = false,
                               const size_t physical_byte_size = 0);
-  void fetchChunkMetadata();
+  /**
+   * Scans the metadata of the row groups of the file into fragments. With append set,
+   * only the row groups added to the file since the last scan are scanned, filling the
+   * last fragment of that scan and then new ones.
+   */
+  void fetchChunkMetadata(const bool append = false);
+  /**
+   * Sets the Bloom filters of the chunk metadata of the integer columns from the
+   * dictionary pages of the file, so that fragments are skipped on equality
+   * predicates which their min and max values do not rule out.
+   *
+   * @param first_fragment_index - fragment to start from, the filters of the fragments
+   * before it being set already
+   */
+  void loadDictionaryBloomFilters(const int first_fragment_index = 0);
   void loadBuffersUsingLazyParquetImporter(
       const int logical_column_id,
       const int fragment_id,
@@ -61,6 +75,7 @@ class ParquetDataWrapper : public ForeignDataWrapper {
       const int logical_column_id,
       const int fragment_id,
       const size_t physical_byte_size,
+      const size_t num_threads,
       std::map<ChunkKey, AbstractBuffer*>& required_buffers);
 
   void validateFilePath();
@@ -126,11 +141,14 @@ class ParquetDataWrapper : public ForeignDataWrapper {
   int last_fragment_index_;
   size_t last_fragment_row_count_;
   int last_row_group_;
+  // Number of row groups of the file covered by the fragments.
+  int num_row_groups_;
   std::unique_ptr<ForeignTableSchema> schema_;
 
-  static constexpr std::array<char const*, 4> supported_options_{"BASE_PATH",
+  static constexpr std::array<char const*, 5> supported_options_{"BASE_PATH",
                                                                  "FILE_PATH",
                                                                  "ARRAY_DELIMITER",
-                                                                 "ARRAY_MARKER"};
+                                                                 "ARRAY_MARKER",
+                                                                 "UPDATE_MODE"};
 };
 }  // namespace foreign_storage
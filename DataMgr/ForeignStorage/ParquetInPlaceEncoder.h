@@ -18,6 +18,8 @@
 
 #include "ParquetEncoder.h"
 
+#include <cstring>
+
 #include <parquet/schema.h>
 #include <parquet/types.h>
 
@@ -101,10 +103,28 @@ class ParquetInPlaceEncoder : public ParquetEncoder {
       }
     }
 
-    buffer_->append(values, levels_read * omnisci_data_type_byte_size_);
+    appendValues(values, levels_read * omnisci_data_type_byte_size_);
   }
 
+  /**
+   * Makes the encoder write the values it appends to destination, which has room for
+   * all of them, and on from there, instead of appending them to the buffer. This lets
+   * row groups of a chunk be decoded concurrently, each into its own part of the buffer.
+   */
+  void setDestination(int8_t* destination) { destination_ = destination; }
+
+  int8_t* getDestination() const { return destination_; }
+
  protected:
+  void appendValues(int8_t* values, const size_t num_bytes) {
+    if (destination_) {
+      memcpy(destination_, values, num_bytes);
+      destination_ += num_bytes;
+    } else {
+      buffer_->append(values, num_bytes);
+    }
+  }
+
   virtual void setNull(int8_t* omnisci_data_bytes) = 0;
   virtual void copy(const int8_t* omnisci_data_bytes_source,
                     int8_t* omnisci_data_bytes_destination) = 0;
@@ -136,6 +156,7 @@ class ParquetInPlaceEncoder : public ParquetEncoder {
   }
 
   const size_t parquet_data_type_byte_size_;
+  int8_t* destination_{nullptr};
 };
 
 template <typename V, typename T>
@@ -173,7 +194,7 @@ class TypedParquetInPlaceEncoder : public ParquetInPlaceEncoder {
                         values + i * omnisci_data_type_byte_size_);
         }
       }
-      buffer_->append(values, levels_read * omnisci_data_type_byte_size_);
+      appendValues(values, levels_read * omnisci_data_type_byte_size_);
     } else {
       ParquetInPlaceEncoder::appendData(def_levels, values_read, levels_read, values);
     }
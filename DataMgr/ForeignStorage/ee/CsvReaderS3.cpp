@@ -13,6 +13,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <cstring>
+
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/ListObjectsV2Request.h>
@@ -28,6 +31,8 @@ namespace {
 Aws::Client::ClientConfiguration get_s3_config(const ForeignServer* server_options) {
   Aws::Client::ClientConfiguration s3_config;
   s3_config.region = server_options->options.find(ForeignServer::AWS_REGION_KEY)->second;
+  // enough connections for the parts of a read and of the prefetch after it
+  s3_config.maxConnections = 2 * CsvReaderS3::kMaxConcurrentParts;
 
   // Find SSL certificate trust store to connect to S3
   std::list<std::string> v_known_ca_paths({
@@ -79,6 +84,9 @@ std::shared_ptr<Aws::Auth::AWSCredentialsProvider> get_credentials() {
 
 }  // namespace
 
+constexpr size_t CsvReaderS3::kRangePartSize;
+constexpr size_t CsvReaderS3::kMaxConcurrentParts;
+
 CsvReaderS3::CsvReaderS3(const std::string& obj_key,
                          size_t file_size,
                          const import_export::CopyParams& copy_params,
@@ -101,9 +109,62 @@ CsvReaderS3::CsvReaderS3(const std::string& obj_key,
 }
 
 size_t CsvReaderS3::read(void* buffer, size_t max_size) {
-  size_t byte_start = header_offset_ + current_offset_;
-  size_t byte_end = byte_start + max_size;
-  auto object_request = create_request(bucket_name_, obj_key_, byte_start, byte_end);
+  const size_t size =
+      std::min(max_size, file_size_ - std::min(current_offset_, file_size_));
+  size_t read_bytes = 0;
+  if (prefetch_ && prefetch_->offset == current_offset_) {
+    read_bytes = std::min(size, prefetch_->num_bytes.get());
+    memcpy(buffer, prefetch_->data.get(), read_bytes);
+  }
+  // a prefetch of another range is waited for and dropped
+  prefetch_.reset();
+  if (read_bytes < size) {
+    read_bytes += readRange(static_cast<char*>(buffer) + read_bytes,
+                            current_offset_ + read_bytes,
+                            size - read_bytes);
+  }
+
+  current_offset_ += read_bytes;
+  if (current_offset_ >= file_size_) {
+    scan_finished_ = true;
+  } else if (read_bytes == size) {
+    prefetch(current_offset_, std::min(size, file_size_ - current_offset_));
+  }
+  return read_bytes;
+}
+
+size_t CsvReaderS3::readRange(char* buffer,
+                              const size_t offset,
+                              const size_t size) const {
+  const size_t part_size =
+      std::max(kRangePartSize, (size + kMaxConcurrentParts - 1) / kMaxConcurrentParts);
+  if (size <= part_size) {
+    return getRange(buffer, offset, size);
+  }
+  std::vector<std::future<size_t>> parts;
+  for (size_t part_offset = 0; part_offset < size; part_offset += part_size) {
+    parts.emplace_back(std::async(std::launch::async,
+                                  &CsvReaderS3::getRange,
+                                  this,
+                                  buffer + part_offset,
+                                  offset + part_offset,
+                                  std::min(part_size, size - part_offset)));
+  }
+  for (auto& part : parts) {
+    part.wait();
+  }
+  size_t read_bytes = 0;
+  for (auto& part : parts) {
+    read_bytes += part.get();
+  }
+  return read_bytes;
+}
+
+size_t CsvReaderS3::getRange(char* buffer, const size_t offset, const size_t size) const {
+  CHECK_GT(size, size_t(0));
+  const size_t byte_start = header_offset_ + offset;
+  auto object_request =
+      create_request(bucket_name_, obj_key_, byte_start, byte_start + size - 1);
   auto get_object_outcome = s3_client_->GetObject(object_request);
 
   if (!get_object_outcome.IsSuccess()) {
@@ -112,14 +173,16 @@ size_t CsvReaderS3::read(void* buffer, size_t max_size) {
                              "': " + get_object_outcome.GetError().GetExceptionName() +
                              ": " + get_object_outcome.GetError().GetMessage());
   }
-  get_object_outcome.GetResult().GetBody().read(static_cast<char*>(buffer), max_size);
+  get_object_outcome.GetResult().GetBody().read(buffer, size);
+  return get_object_outcome.GetResult().GetBody().gcount();
+}
 
-  size_t read_bytes = get_object_outcome.GetResult().GetBody().gcount();
-  current_offset_ += read_bytes;
-  if (current_offset_ + header_offset_ >= file_size_) {
-    scan_finished_ = true;
-  }
-  return read_bytes;
+void CsvReaderS3::prefetch(const size_t offset, const size_t size) {
+  CHECK(!prefetch_);
+  auto data = std::make_unique<char[]>(size);
+  auto num_bytes = std::async(
+      std::launch::async, &CsvReaderS3::readRange, this, data.get(), offset, size);
+  prefetch_ = Prefetch{offset, std::move(data), std::move(num_bytes)};
 }
 
 void CsvReaderS3::skipHeader() {
@@ -16,6 +16,10 @@
 
 #pragma once
 
+#include <future>
+#include <memory>
+#include <optional>
+
 #include <aws/core/Aws.h>
 #include <aws/s3/S3Client.h>
 
@@ -31,8 +35,17 @@ class MultiS3Reader : public MultiFileReader {
                 const ForeignServer* server_options);
 };
 
+/**
+ * Reads an S3 object with ranged GETs. A read of more than kRangePartSize bytes is split
+ * into up to kMaxConcurrentParts ranges fetched concurrently over the connections of
+ * the client, and every read starts prefetching the range of the same size right after
+ * it, which the next sequential read() or readRegion() takes over.
+ */
 class CsvReaderS3 : public CsvReader {
  public:
+  static constexpr size_t kRangePartSize{1 << 21};
+  static constexpr size_t kMaxConcurrentParts{16};
+
   CsvReaderS3(const std::string& obj_key,
               size_t file_size,
               const import_export::CopyParams& copy_params,
@@ -52,6 +65,12 @@ class CsvReaderS3 : public CsvReader {
 
  private:
   void skipHeader();
+
+  // Reads size bytes from offset of the data of the object into buffer
+  size_t readRange(char* buffer, const size_t offset, const size_t size) const;
+  size_t getRange(char* buffer, const size_t offset, const size_t size) const;
+  void prefetch(const size_t offset, const size_t size);
+
   size_t file_size_;
   // We've reached the end of the file
   bool scan_finished_;
@@ -63,6 +82,15 @@ class CsvReaderS3 : public CsvReader {
 
   size_t current_offset_;
   size_t header_offset_;
+
+  struct Prefetch {
+    size_t offset;
+    std::unique_ptr<char[]> data;
+    std::future<size_t> num_bytes;
+  };
+  // declared last, so that it is destroyed first, waiting for a fetch in progress
+  // while the client it uses still exists
+  std::optional<Prefetch> prefetch_;
 };
 
 }  // namespace foreign_storage
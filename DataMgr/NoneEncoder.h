@@ -19,6 +19,7 @@
 
 #include "AbstractBuffer.h"
 #include "Encoder.h"
+#include "ValueStats.h"
 
 #include <Shared/DatumFetchers.h>
 
@@ -49,14 +50,12 @@ class NoneEncoder : public Encoder {
     T* unencodedData = reinterpret_cast<T*>(src_data);
     std::vector<T> encoded_data;
     if (replicating) {
-      encoded_data.resize(num_elems_to_append);
-    }
-    for (size_t i = 0; i < num_elems_to_append; ++i) {
-      size_t ri = replicating ? 0 : i;
-      T data = validateDataAndUpdateStats(unencodedData[ri]);
-      if (replicating) {
-        encoded_data[i] = data;
+      if (num_elems_to_append) {
+        encoded_data.assign(num_elems_to_append,
+                            validateDataAndUpdateStats(unencodedData[0]));
       }
+    } else {
+      updateStats(src_data, num_elems_to_append);
     }
     if (offset == -1) {
       num_elems_ += num_elems_to_append;
@@ -113,9 +112,18 @@ class NoneEncoder : public Encoder {
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
-    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
-    for (size_t i = 0; i < num_elements; ++i) {
-      validateDataAndUpdateStats(unencoded_data[i]);
+    const auto stats = value_stats::compute(reinterpret_cast<const T*>(src_data),
+                                            num_elements,
+                                            none_encoded_null_value<T>());
+    if (stats.has_nulls) {
+      has_nulls = true;
+    }
+    if (stats.hasValues()) {
+      // the bounds of the decimals are exceeded by the min or the max if by any value
+      decimal_overflow_validator_.validate(stats.min);
+      decimal_overflow_validator_.validate(stats.max);
+      dataMin = std::min(dataMin, stats.min);
+      dataMax = std::max(dataMax, stats.max);
     }
   }
 
@@ -66,6 +66,8 @@ class PersistentStorageMgr : public AbstractBufferMgr {
   bool isForeignStorage(const ChunkKey& chunk_key);
 
   std::unique_ptr<File_Namespace::GlobalFileMgr> global_file_mgr_;
-  std::unique_ptr<foreign_storage::ForeignStorageMgr> foreign_storage_mgr_;
+  // Declared before the foreign storage manager, which warms the cache up in the
+  // background until it is destroyed.
   std::unique_ptr<foreign_storage::ForeignStorageCache> disk_cache_;
+  std::unique_ptr<foreign_storage::ForeignStorageMgr> foreign_storage_mgr_;
 };
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ValueStats.h
+ * @brief   Min, max and nulls of the fixed width values appended to the encoders
+ */
+
+#pragma once
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace value_stats {
+
+// appends of at least this many values are split over the TBB worker threads
+constexpr size_t kParallelMinValues{size_t(1) << 21};
+
+template <typename T>
+struct ValueStats {
+  T min{std::numeric_limits<T>::max()};
+  T max{std::numeric_limits<T>::lowest()};
+  bool has_nulls{false};
+
+  // false when all the values were nulls
+  bool hasValues() const { return min <= max; }
+
+  void reduce(const ValueStats& that) {
+    min = that.min < min ? that.min : min;
+    max = that.max > max ? that.max : max;
+    has_nulls = has_nulls || that.has_nulls;
+  }
+};
+
+namespace detail {
+
+// Branchless for the loop vectorizer: a null takes the identity of the min and the max
+// instead, selected with a mask for the integers since the vectorizer doesn't turn the
+// select of a constant into a blend. The NaNs never replace either like with std::min
+// and std::max. The floating point min and max only vectorize with -ffast-math, as they
+// can't be reassociated otherwise.
+template <typename T>
+__attribute__((always_inline)) inline ValueStats<T>
+compute_kernel(const T* values, const size_t num_values, const T null_value) {
+  constexpr T kMinIdentity = std::numeric_limits<T>::max();
+  constexpr T kMaxIdentity = std::numeric_limits<T>::lowest();
+  T min = kMinIdentity;
+  T max = kMaxIdentity;
+  if constexpr (std::is_integral_v<T>) {
+    T has_nulls = 0;
+    for (size_t i = 0; i < num_values; ++i) {
+      const T value = values[i];
+      const T null_mask = -static_cast<T>(value == null_value);
+      has_nulls |= null_mask;
+      const T min_value = (value & ~null_mask) | (kMinIdentity & null_mask);
+      const T max_value = (value & ~null_mask) | (kMaxIdentity & null_mask);
+      min = min_value < min ? min_value : min;
+      max = max_value > max ? max_value : max;
+    }
+    return {min, max, has_nulls != 0};
+  } else {
+    bool has_nulls = false;
+    for (size_t i = 0; i < num_values; ++i) {
+      const T value = values[i];
+      const bool is_null = value == null_value;
+      has_nulls |= is_null;
+      const T min_value = is_null ? kMinIdentity : value;
+      const T max_value = is_null ? kMaxIdentity : value;
+      min = min_value < min ? min_value : min;
+      max = max_value > max ? max_value : max;
+    }
+    return {min, max, has_nulls};
+  }
+}
+
+#if defined(__x86_64__)
+inline bool cpu_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+// 32 bytes of values at a time, 4 to 32 of them depending on the width of T
+template <typename T>
+__attribute__((target("avx2"))) ValueStats<T> compute_avx2(const T* values,
+                                                           const size_t num_values,
+                                                           const T null_value) {
+  return compute_kernel(values, num_values, null_value);
+}
+#endif
+
+template <typename T>
+ValueStats<T> compute_serial(const T* values,
+                             const size_t num_values,
+                             const T null_value) {
+#if defined(__x86_64__)
+  if (cpu_has_avx2()) {
+    return compute_avx2(values, num_values, null_value);
+  }
+#endif
+  return compute_kernel(values, num_values, null_value);
+}
+
+}  // namespace detail
+
+//! The min and the max of the values other than null_value, and whether there are any
+template <typename T>
+ValueStats<T> compute(const T* values, const size_t num_values, const T null_value) {
+  if (num_values < kParallelMinValues) {
+    return detail::compute_serial(values, num_values, null_value);
+  }
+  return tbb::parallel_reduce(
+      tbb::blocked_range<size_t>(0, num_values, kParallelMinValues / 4),
+      ValueStats<T>{},
+      [values, null_value](const tbb::blocked_range<size_t>& range,
+                           ValueStats<T> stats) {
+        stats.reduce(detail::compute_serial(
+            values + range.begin(), range.end() - range.begin(), null_value));
+        return stats;
+      },
+      [](ValueStats<T> lhs, const ValueStats<T>& rhs) {
+        lhs.reduce(rhs);
+        return lhs;
+      });
+}
+
+}  // namespace value_stats
@@ -19,8 +19,12 @@
 #include <boost/variant.hpp>
 #include <iostream>
 #include "Catalog/Catalog.h"
+#include "ImportExport/Importer.h"
 #include "Logger/Logger.h"
+#include "QueryEngine/ArrowResultSet.h"
+#include "QueryEngine/ColumnarResults.h"
 #include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/Execute.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Shared/mapdpath.h"
@@ -81,9 +85,41 @@ class CursorImpl : public Cursor {
     return ColumnType::Unknown;
   }
 
+  std::shared_ptr<arrow::RecordBatchReader> getArrowRecordBatchReader(
+      size_t entries_per_batch) {
+    std::vector<std::string> col_names;
+    for (size_t i = 0; i < getColCount(); ++i) {
+      col_names.push_back("col_" + std::to_string(i));
+    }
+    ArrowResultSetConverter converter(result_set_,
+                                      data_mgr_.lock(),
+                                      ExecutorDeviceType::CPU,
+                                      0,
+                                      col_names,
+                                      -1);
+    return converter.getArrowBatchReader(entries_per_batch);
+  }
+
+  const int8_t* getColumnBuffer(uint32_t col_num) {
+    if (col_num >= getColCount()) {
+      return nullptr;
+    }
+    std::call_once(columnar_results_flag_, [this] {
+      try {
+        columnar_results_.reset(rows_to_columnar_results(
+            result_set_->getRowSetMemOwner(), result_set_, getColCount()));
+      } catch (const ColumnarConversionNotSupported& e) {
+        LOG(INFO) << "Columnar buffers of the results not available: " << e.what();
+      }
+    });
+    return columnar_results_ ? columnar_results_->getColumnBuffers()[col_num] : nullptr;
+  }
+
  private:
   std::shared_ptr<ResultSet> result_set_;
   std::weak_ptr<Data_Namespace::DataMgr> data_mgr_;
+  std::once_flag columnar_results_flag_;
+  std::unique_ptr<const ColumnarResults> columnar_results_;
 };
 
 /**
@@ -119,6 +155,59 @@ class DBEngineImpl : public DBEngine {
     return nullptr;
   }
 
+  void importArrowTable(const std::string& table_name,
+                        std::shared_ptr<arrow::Table>& table) {
+    if (query_runner_ == nullptr) {
+      return;
+    }
+    const auto catalog = query_runner_->getCatalog();
+    const auto td = catalog->getMetadataForTable(table_name);
+    if (!td) {
+      throw std::runtime_error("Table " + table_name + " does not exist.");
+    }
+    auto loader = query_runner_->getLoader(td);
+    const auto col_descs = loader->get_column_descs();
+    for (const auto cd : col_descs) {
+      if (cd->columnType.is_geometry()) {
+        throw std::runtime_error("Arrow imports into the geo columns of " + table_name +
+                                 " are not supported.");
+      }
+    }
+    if (col_descs.size() != static_cast<size_t>(table->num_columns())) {
+      throw std::runtime_error("The Arrow table has " +
+                               std::to_string(table->num_columns()) +
+                               " columns, the table " + table_name + " has " +
+                               std::to_string(col_descs.size()) + ".");
+    }
+    std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+    for (const auto cd : col_descs) {
+      import_buffers.push_back(std::make_unique<import_export::TypedImportBuffer>(
+          cd, loader->getStringDict(cd)));
+    }
+    import_export::BadRowsTracker bad_rows_tracker;
+    bad_rows_tracker.nerrors = 0;
+    bad_rows_tracker.file_name = table_name;
+    bad_rows_tracker.row_group = 0;
+    bad_rows_tracker.importer = nullptr;
+    size_t col_idx{0};
+    for (const auto cd : col_descs) {
+      auto& import_buffer = import_buffers[col_idx];
+      import_buffer->import_buffers = &import_buffers;
+      import_buffer->col_idx = col_idx + 1;
+      for (const auto& chunk : table->column(col_idx)->chunks()) {
+        import_buffer->add_arrow_values(
+            cd, *chunk, false, {0, chunk->length()}, &bad_rows_tracker);
+      }
+      ++col_idx;
+    }
+    if (!bad_rows_tracker.rows.empty()) {
+      throw std::runtime_error(std::to_string(bad_rows_tracker.rows.size()) +
+                               " rows of the Arrow table can't be imported into " +
+                               table_name + ".");
+    }
+    loader->load(import_buffers, table->num_rows());
+  }
+
   DBEngineImpl(const std::string& base_path)
       : base_path_(base_path), query_runner_(nullptr) {
     if (!boost::filesystem::exists(base_path_)) {
@@ -194,6 +283,12 @@ Cursor* DBEngine::executeDML(std::string query) {
   return engine->executeDML(query);
 }
 
+void DBEngine::importArrowTable(std::string table_name,
+                                std::shared_ptr<arrow::Table>& table) {
+  DBEngineImpl* engine = getImpl(this);
+  engine->importArrowTable(table_name, table);
+}
+
 /********************************************* Row methods */
 
 Row::Row() {}
@@ -262,4 +357,15 @@ int Cursor::getColType(uint32_t col_num) {
   CursorImpl* cursor = getImpl(this);
   return (int)cursor->getColType(col_num);
 }
+
+std::shared_ptr<arrow::RecordBatchReader> Cursor::getArrowRecordBatchReader(
+    size_t entries_per_batch) {
+  CursorImpl* cursor = getImpl(this);
+  return cursor->getArrowRecordBatchReader(entries_per_batch);
+}
+
+const int8_t* Cursor::getColumnBuffer(uint32_t col_num) {
+  CursorImpl* cursor = getImpl(this);
+  return cursor->getColumnBuffer(col_num);
+}
 }  // namespace EmbeddedDatabase
@@ -23,6 +23,11 @@
 #include <vector>
 #include "QueryEngine/TargetValue.h"
 
+namespace arrow {
+class RecordBatchReader;
+class Table;
+}  // namespace arrow
+
 namespace EmbeddedDatabase {
 
 class Row {
@@ -43,6 +48,16 @@ class Cursor {
   size_t getRowCount();
   Row getNextRow();
   int getColType(uint32_t col_num);
+  /// The rows as Arrow record batches of up to entries_per_batch entries, converted as
+  /// they are read
+  std::shared_ptr<arrow::RecordBatchReader> getArrowRecordBatchReader(
+      size_t entries_per_batch);
+  /// The values of the column col_num in the logical type of the column, one per row of
+  /// the results and the dictionary encoded strings as their ids. The buffers point into
+  /// the results when they are columnar already and are copied from them once by
+  /// parallel threads otherwise; they live as long as the cursor. Null for the columns of
+  /// none encoded strings and of arrays.
+  const int8_t* getColumnBuffer(uint32_t col_num);
 };
 
 class DBEngine {
@@ -50,6 +65,9 @@ class DBEngine {
   void reset();
   void executeDDL(std::string query);
   Cursor* executeDML(std::string query);
+  /// Appends the rows of table to the table table_name, whose columns it must have in
+  /// order. The Arrow arrays are read in place by the encoders of the columns.
+  void importArrowTable(std::string table_name, std::shared_ptr<arrow::Table>& table);
   static DBEngine* create(std::string path);
 
  protected:
@@ -178,6 +178,25 @@ class AbstractFragmenter {
                             const Data_Namespace::MemoryLevel memory_level,
                             UpdelRoll& updel_roll) = 0;
 
+  /**
+   * Updates the rows at frag_offsets[0, num_rows) of column cd to the values of
+   * rhs_type in the columnar buffer rhs_values, whose slots take rhs_width bytes each,
+   * without converting them row by row. Returns false, leaving the column untouched,
+   * if the values need a conversion, in which case the caller falls back to
+   * updateColumn.
+   */
+  virtual bool updateColumnFromColumnar(const Catalog_Namespace::Catalog* catalog,
+                                        const TableDescriptor* td,
+                                        const ColumnDescriptor* cd,
+                                        const int fragment_id,
+                                        const int64_t* frag_offsets,
+                                        const int8_t* rhs_values,
+                                        const size_t rhs_width,
+                                        const size_t num_rows,
+                                        const SQLTypeInfo& rhs_type,
+                                        const Data_Namespace::MemoryLevel memory_level,
+                                        UpdelRoll& updel_roll) = 0;
+
   virtual void updateColumnMetadata(const ColumnDescriptor* cd,
                                     FragmentInfo& fragment,
                                     std::shared_ptr<Chunk_NS::Chunk> chunk,
@@ -200,14 +219,67 @@ class AbstractFragmenter {
                            const Data_Namespace::MemoryLevel memoryLevel,
                            UpdelRoll& updelRoll) = 0;
 
+  /**
+   * Reorders the rows of a fragment by the values of integer or time column sortCd,
+   * nulls first, keeping the order of rows with equal values. Returns false, changing
+   * nothing, if the rows are sorted already or the table has varlen array columns.
+   */
+  virtual bool sortRows(const Catalog_Namespace::Catalog* catalog,
+                        const TableDescriptor* td,
+                        const int fragmentId,
+                        const ColumnDescriptor* sortCd,
+                        const Data_Namespace::MemoryLevel memoryLevel,
+                        UpdelRoll& updelRoll) = 0;
+
+  /**
+   * Appends the rows of a fragment which are not deleted to the end of the table and
+   * marks them deleted in the fragment, as an UPDATE of a varlen column moves rows.
+   * The table has a deleted column. Returns the number of rows moved.
+   */
+  virtual size_t moveFragmentRows(const Catalog_Namespace::Catalog* catalog,
+                                  const TableDescriptor* td,
+                                  const int fragmentId,
+                                  const Data_Namespace::MemoryLevel memoryLevel,
+                                  UpdelRoll& updelRoll) = 0;
+
   virtual const std::vector<uint64_t> getVacuumOffsets(
       const std::shared_ptr<Chunk_NS::Chunk>& chunk) = 0;
 
   virtual void dropColumns(const std::vector<int>& columnIds) = 0;
 
+  /**
+   * Rewrites the chunks of integer column cd in the narrower fixed encoding newType,
+   * whose range all of its values fit. The caller updates the column's type and
+   * checkpoints the table.
+   */
+  virtual void reencodeColumn(const ColumnDescriptor* cd, const SQLTypeInfo& newType) = 0;
+
+  /**
+   * Sets isUsed[id] for the ids of the strings in the chunks of dictionary encoded
+   * string column cd, which isUsed has an entry for each id of the dictionary.
+   */
+  virtual void markUsedStringIds(const ColumnDescriptor* cd,
+                                 std::vector<bool>& isUsed) = 0;
+
+  /**
+   * Replaces every string id in the chunks of dictionary encoded string column cd by
+   * newIds[id], which is at most the id, after the column's dictionary was compacted.
+   * The caller checkpoints the table.
+   */
+  virtual void remapStringIds(const ColumnDescriptor* cd,
+                              const std::vector<int32_t>& newIds) = 0;
+
   //! Iterates through chunk metadata to return whether any rows have been deleted.
   virtual bool hasDeletedRows(const int delete_column_id) = 0;
 
+  /**
+   * Drops the fragments with the given ids and their chunks, as for a DELETE that
+   * removes all of their rows. The last fragment, which takes the inserts, is kept.
+   * The caller holds the table's data write lock and checkpoints the table. Returns the
+   * number of fragments dropped.
+   */
+  virtual size_t dropFragments(const std::vector<int>& fragmentIds) = 0;
+
   /**
    * @brief Updates the metadata for a column chunk
    *
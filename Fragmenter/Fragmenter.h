@@ -21,10 +21,12 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <optional>
 #include "../Catalog/ColumnDescriptor.h"
 #include "../DataMgr/ChunkMetadata.h"
 #include "../Shared/mapd_shared_mutex.h"
 #include "../Shared/types.h"
+#include "TimePartition.h"
 
 namespace Data_Namespace {
 class AbstractBuffer;
@@ -82,6 +84,7 @@ class FragmentInfo {
       , shadowNumTuples(0)
       , physicalTableId(-1)
       , shard(-1)
+      , contentsVersion(0)
       , resultSet(nullptr)
       , numTuples(0)
       , synthesizedNumTuplesIsValid(false)
@@ -120,7 +123,13 @@ class FragmentInfo {
   std::vector<int> deviceIds;
   int physicalTableId;
   int shard;
+  // changes whenever the rows the fragments of the table already have change, i.e. with
+  // anything but appends: the results of a fragment with the same number of tuples and
+  // contents version are the same
+  uint64_t contentsVersion;
   ChunkMetadataMap shadowChunkMetadataMap;
+  // the partition of all rows of the fragment if the table has a PARTITION_COLUMN
+  std::optional<TimePartition> partition;
   mutable ResultSet* resultSet;
   mutable std::shared_ptr<std::mutex> resultSetMutex;
 
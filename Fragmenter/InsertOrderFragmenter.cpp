@@ -17,19 +17,25 @@
 #include "Fragmenter/InsertOrderFragmenter.h"
 
 #include <algorithm>
+#include <atomic>
 #include <boost/lexical_cast.hpp>
 #include <cassert>
 #include <cmath>
+#include <future>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <thread>
 #include <type_traits>
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/DataMgr.h"
+#include "Fragmenter/InsertWal.h"
+#include "Fragmenter/SortedOrderFragmenter.h"
 #include "LockMgr/LockMgr.h"
 #include "Logger/Logger.h"
+#include "Shared/InlineNullValues.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/thread_count.h"
 
@@ -41,11 +47,27 @@ using Data_Namespace::AbstractBuffer;
 using Data_Namespace::DataMgr;
 
 bool g_use_table_device_offset{true};
+size_t g_bloom_filter_bits_per_value{10};
+bool g_enable_parallel_column_appends{true};
+extern size_t g_insert_wal_checkpoint_bytes;
 
 using namespace std;
 
 namespace Fragmenter_Namespace {
 
+namespace {
+
+// the values an insert appends to the chunks of a fragment from which a thread per column
+// pays off
+constexpr size_t kMinParallelAppendValues{1 << 16};
+
+uint64_t next_contents_version() {
+  static std::atomic<uint64_t> contents_version{0};
+  return ++contents_version;
+}
+
+}  // namespace
+
 InsertOrderFragmenter::InsertOrderFragmenter(
     const vector<int> chunkKeyPrefix,
     vector<Chunk>& chunkVec,
@@ -58,7 +80,8 @@ InsertOrderFragmenter::InsertOrderFragmenter(
     const size_t pageSize,
     const size_t maxRows,
     const Data_Namespace::MemoryLevel defaultInsertLevel,
-    const bool uses_foreign_storage)
+    const bool uses_foreign_storage,
+    const TimePartitioning& partitioning)
     : chunkKeyPrefix_(chunkKeyPrefix)
     , dataMgr_(dataMgr)
     , catalog_(catalog)
@@ -71,10 +94,12 @@ InsertOrderFragmenter::InsertOrderFragmenter(
     , maxChunkSize_(maxChunkSize)
     , maxRows_(maxRows)
     , fragmenterType_("insert_order")
+    , contentsVersion_(next_contents_version())
     , defaultInsertLevel_(defaultInsertLevel)
     , uses_foreign_storage_(uses_foreign_storage)
     , hasMaterializedRowId_(false)
-    , mutex_access_inmem_states(new std::mutex) {
+    , mutex_access_inmem_states(new std::mutex)
+    , partitioning_(partitioning) {
   // Note that Fragmenter is not passed virtual columns and so should only
   // find row id column if it is non virtual
 
@@ -107,6 +132,44 @@ int compute_device_for_fragment(const int table_id,
   }
 }
 
+/**
+ * Returns the partition of every row of insert_data, after reordering its rows, if
+ * needed, so that the rows of each partition are consecutive and the partitions are in
+ * order.
+ */
+std::vector<int64_t> sort_rows_by_partition(const TimePartitioning& partitioning,
+                                            const std::map<int, Chunk>& column_map,
+                                            InsertData& insert_data) {
+  const auto partition_column_it = std::find(insert_data.columnIds.begin(),
+                                             insert_data.columnIds.end(),
+                                             partitioning.columnId);
+  CHECK(partition_column_it != insert_data.columnIds.end());
+  // the values of time columns are inserted as 64 bit integers
+  const auto values = reinterpret_cast<const int64_t*>(
+      insert_data.data[std::distance(insert_data.columnIds.begin(), partition_column_it)]
+          .numbersPtr);
+  std::vector<int64_t> keys(insert_data.numRows);
+  for (size_t i = 0; i < insert_data.numRows; ++i) {
+    keys[i] = partitioning.getKey(values[i]);
+  }
+  if (std::is_sorted(keys.begin(), keys.end())) {
+    return keys;
+  }
+  // stable, so that rows sorted on a SORT_COLUMN stay sorted within their partition
+  std::vector<size_t> indexes(insert_data.numRows);
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::stable_sort(indexes.begin(), indexes.end(), [&keys](const auto a, const auto b) {
+    return keys[a] < keys[b];
+  });
+  for (size_t i = 0; i < insert_data.columnIds.size(); ++i) {
+    const auto column_it = column_map.find(insert_data.columnIds[i]);
+    CHECK(column_it != column_map.end());
+    shuffleByIndexes(column_it->second.getColumnDesc(), indexes, insert_data.data[i]);
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
 }  // namespace
 
 void InsertOrderFragmenter::getChunkMetadata() {
@@ -162,6 +225,19 @@ void InsertOrderFragmenter::getChunkMetadata() {
       CHECK(fragmentInfoVec_.back().get());
       fragmentInfoVec_.back().get()->setChunkMetadata(cur_column_id, chunk_itr->second);
     }
+    if (partitioning_.enabled()) {
+      // all values of a fragment are in its partition
+      for (auto& fragment : fragmentInfoVec_) {
+        const auto& chunk_metadata_map = fragment->getChunkMetadataMapPhysical();
+        const auto chunk_metadata_it = chunk_metadata_map.find(partitioning_.columnId);
+        CHECK(chunk_metadata_it != chunk_metadata_map.end());
+        const auto& chunk_stats = chunk_metadata_it->second->chunkStats;
+        fragment->partition = partitioning_.getPartition(
+            chunk_stats.min.bigintval > chunk_stats.max.bigintval
+                ? TimePartition::kNullKey
+                : partitioning_.getKey(chunk_stats.min.bigintval));
+      }
+    }
   }
 
   ssize_t maxFixedColSize = 0;
@@ -212,6 +288,8 @@ void InsertOrderFragmenter::dropFragmentsToSize(const size_t maxRows) {
     size_t preNumTuples = numTuples_;
     vector<int> dropFragIds;
     size_t targetRows = maxRows * DROP_FRAGMENT_FACTOR;
+    mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+    invalidateQueryInfoSnapshot();
     while (numTuples_ > targetRows) {
       CHECK_GT(fragmentInfoVec_.size(), size_t(0));
       size_t numFragTuples = fragmentInfoVec_[0]->getPhysicalNumTuples();
@@ -220,13 +298,74 @@ void InsertOrderFragmenter::dropFragmentsToSize(const size_t maxRows) {
       CHECK_GE(numTuples_, numFragTuples);
       numTuples_ -= numFragTuples;
     }
+    writeLock.unlock();
     deleteFragments(dropFragIds);
     LOG(INFO) << "dropFragmentsToSize, numTuples pre: " << preNumTuples
               << " post: " << numTuples_ << " maxRows: " << maxRows;
   }
 }
 
+void InsertOrderFragmenter::dropExpiredPartitions() {
+  // not safe to call from outside insertData, like dropFragmentsToSize
+  if (partitioning_.retention == 0) {
+    return;
+  }
+  std::optional<int64_t> newestKey;
+  for (const auto& fragment : fragmentInfoVec_) {
+    CHECK(fragment->partition);
+    if (!fragment->partition->isNull()) {
+      newestKey = std::max(newestKey.value_or(fragment->partition->key),
+                           fragment->partition->key);
+    }
+  }
+  if (!newestKey) {
+    return;
+  }
+  const int64_t oldestKeptKey =
+      *newestKey - static_cast<int64_t>(partitioning_.retention) + 1;
+  vector<int> dropFragIds;
+  mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateQueryInfoSnapshot();
+  // the last fragment holds the insert buffers
+  for (auto fragmentIt = fragmentInfoVec_.begin();
+       std::next(fragmentIt) != fragmentInfoVec_.end();) {
+    const auto& partition = *(*fragmentIt)->partition;
+    if (partition.isNull() || partition.key >= oldestKeptKey) {
+      ++fragmentIt;
+      continue;
+    }
+    const size_t numFragTuples = (*fragmentIt)->getPhysicalNumTuples();
+    CHECK_GE(numTuples_, numFragTuples);
+    numTuples_ -= numFragTuples;
+    dropFragIds.push_back((*fragmentIt)->fragmentId);
+    fragmentIt = fragmentInfoVec_.erase(fragmentIt);
+  }
+  writeLock.unlock();
+  if (!dropFragIds.empty()) {
+    deleteFragments(dropFragIds);
+    LOG(INFO) << "dropExpiredPartitions, dropped " << dropFragIds.size()
+              << " fragments of the partitions before " << oldestKeptKey;
+  }
+}
+
 void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
+  // The queries starting from now don't see the fragments anymore, but those running
+  // may have pinned them with the table data read lock. Instead of waiting for them
+  // with the write lock, and stalling the queries coming next behind it, the chunks are
+  // deleted once the table isn't read, which the next inserts check again.
+  {
+    std::lock_guard<std::mutex> dropped_fragments_lock(droppedFragmentsMutex_);
+    droppedFragmentIds_.insert(
+        droppedFragmentIds_.end(), dropFragIds.begin(), dropFragIds.end());
+  }
+  deleteDroppedFragments();
+}
+
+void InsertOrderFragmenter::deleteDroppedFragments() {
+  std::lock_guard<std::mutex> dropped_fragments_lock(droppedFragmentsMutex_);
+  if (droppedFragmentIds_.empty()) {
+    return;
+  }
   // Fix a verified loophole on sharded logical table which is locked using logical
   // tableId while it's its physical tables that can come here when fragments overflow
   // during COPY. Locks on a logical table and its physical tables never intersect, which
@@ -244,10 +383,20 @@ void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
   // need to keep lock seq as TableLock >> fragmentInfoMutex_ or
   // SELECT and COPY may enter a deadlock
   const auto delete_lock =
-      lockmgr::TableDataLockMgr::getWriteLockForTable(chunkKeyPrefix);
+      lockmgr::TableDataLockMgr::tryWriteLockForTable(chunkKeyPrefix);
+  if (!delete_lock.ownsLock()) {
+    VLOG(1) << "Deferred the deletion of " << droppedFragmentIds_.size()
+            << " dropped fragments of table " << physicalTableId_
+            << " until no query reads it";
+    return;
+  }
 
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  deleteFragmentChunks(droppedFragmentIds_);
+  droppedFragmentIds_.clear();
+}
 
+void InsertOrderFragmenter::deleteFragmentChunks(const vector<int>& dropFragIds) {
   for (const auto fragId : dropFragIds) {
     for (const auto& col : columnMap_) {
       int colId = col.first;
@@ -259,12 +408,43 @@ void InsertOrderFragmenter::deleteFragments(const vector<int>& dropFragIds) {
   }
 }
 
+size_t InsertOrderFragmenter::dropFragments(const std::vector<int>& fragmentIds) {
+  mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+  mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  vector<int> dropFragIds;
+  for (const auto fragmentId : fragmentIds) {
+    if (fragmentInfoVec_.size() < 2) {
+      break;
+    }
+    // the last fragment holds the insert buffers
+    const auto lastFragmentIt = std::prev(fragmentInfoVec_.end());
+    const auto fragmentIt = std::find_if(
+        fragmentInfoVec_.begin(), lastFragmentIt, [fragmentId](const auto& fragment) {
+          return fragment->fragmentId == fragmentId;
+        });
+    if (fragmentIt == lastFragmentIt) {
+      continue;
+    }
+    const size_t numFragTuples = (*fragmentIt)->getPhysicalNumTuples();
+    CHECK_GE(numTuples_, numFragTuples);
+    numTuples_ -= numFragTuples;
+    fragmentInfoVec_.erase(fragmentIt);
+    dropFragIds.push_back(fragmentId);
+  }
+  if (!dropFragIds.empty()) {
+    invalidateQueryInfoSnapshot();
+    deleteFragmentChunks(dropFragIds);
+  }
+  return dropFragIds.size();
+}
+
 void InsertOrderFragmenter::updateColumnChunkMetadata(
     const ColumnDescriptor* cd,
     const int fragment_id,
     const std::shared_ptr<ChunkMetadata> metadata) {
   // synchronize concurrent accesses to fragmentInfoVec_
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
 
   CHECK(metadata.get());
   auto fragment_info = getFragmentInfo(fragment_id);
@@ -277,6 +457,7 @@ void InsertOrderFragmenter::updateChunkStats(
     std::unordered_map</*fragment_id*/ int, ChunkStats>& stats_map) {
   // synchronize concurrent accesses to fragmentInfoVec_
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
   /**
    * WARNING: This method is entirely unlocked. Higher level locks are expected to prevent
    * any table read or write during a chunk metadata update, since we need to modify
@@ -375,6 +556,13 @@ FragmentInfo* InsertOrderFragmenter::getFragmentInfo(const int fragment_id) cons
 void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
   // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
   try {
+    auto insertWal = catalog_->getInsertWal();
+    if (insertWal && defaultInsertLevel_ == Data_Namespace::DISK_LEVEL &&
+        !insertDataStruct.replicate_count) {
+      insertDataLogged(insertDataStruct, *insertWal);
+      return;
+    }
+
     mapd_unique_lock<mapd_shared_mutex> insertLock(
         insertMutex_);  // prevent two threads from trying to insert into the same table
                         // simultaneously
@@ -400,6 +588,30 @@ void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
   }
 }
 
+void InsertOrderFragmenter::insertDataLogged(InsertData& insertDataStruct,
+                                             InsertWal& insertWal) {
+  std::vector<int8_t> record;
+  {
+    mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+    // logged before insertDataImpl, which appends the delete column to the struct
+    std::vector<SQLTypeInfo> columnTypes;
+    for (const auto columnId : insertDataStruct.columnIds) {
+      const auto cd = catalog_->getMetadataForColumn(physicalTableId_, columnId);
+      CHECK(cd);
+      columnTypes.push_back(cd->columnType);
+    }
+    const int epoch = dataMgr_->getTableEpoch(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+    record = InsertWal::serializeInsert(
+        chunkKeyPrefix_[1], epoch, insertDataStruct, columnTypes);
+    insertDataImpl(insertDataStruct);
+  }
+  // concurrent inserts into the database share the write and sync of the log, the
+  // checkpoint is left to the background unless much was logged at this epoch
+  if (insertWal.commit(std::move(record)) >= g_insert_wal_checkpoint_bytes) {
+    dataMgr_->checkpoint(chunkKeyPrefix_[0], chunkKeyPrefix_[1]);
+  }
+}
+
 void InsertOrderFragmenter::insertDataNoCheckpoint(InsertData& insertDataStruct) {
   // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
   mapd_unique_lock<mapd_shared_mutex> insertLock(
@@ -411,6 +623,7 @@ void InsertOrderFragmenter::insertDataNoCheckpoint(InsertData& insertDataStruct)
 void InsertOrderFragmenter::replicateData(const InsertData& insertDataStruct) {
   // synchronize concurrent accesses to fragmentInfoVec_
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
   size_t numRowsLeft = insertDataStruct.numRows;
   for (auto const& fragmentInfo : fragmentInfoVec_) {
     fragmentInfo->shadowChunkMetadataMap = fragmentInfo->getChunkMetadataMapPhysical();
@@ -490,6 +703,7 @@ void InsertOrderFragmenter::dropColumns(const std::vector<int>& columnIds) {
   mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
   // synchronize concurrent accesses to fragmentInfoVec_
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
   for (auto const& fragmentInfo : fragmentInfoVec_) {
     fragmentInfo->shadowChunkMetadataMap = fragmentInfo->getChunkMetadataMapPhysical();
   }
@@ -516,6 +730,267 @@ void InsertOrderFragmenter::dropColumns(const std::vector<int>& columnIds) {
   }
 }
 
+namespace {
+
+// nulls are stored as the minimum of the stored type, with and without fixed encoding
+template <typename S, typename D>
+void narrow_values(const int8_t* src, int8_t* dst, const size_t num_elems) {
+  const auto src_values = reinterpret_cast<const S*>(src);
+  auto dst_values = reinterpret_cast<D*>(dst);
+  for (size_t i = 0; i < num_elems; ++i) {
+    dst_values[i] = src_values[i] == std::numeric_limits<S>::min()
+                        ? std::numeric_limits<D>::min()
+                        : static_cast<D>(src_values[i]);
+  }
+}
+
+template <typename S>
+void narrow_values(const int8_t* src,
+                   int8_t* dst,
+                   const size_t dst_width,
+                   const size_t num_elems) {
+  switch (dst_width) {
+    case 1:
+      narrow_values<S, int8_t>(src, dst, num_elems);
+      break;
+    case 2:
+      narrow_values<S, int16_t>(src, dst, num_elems);
+      break;
+    case 4:
+      narrow_values<S, int32_t>(src, dst, num_elems);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+void narrow_values(const int8_t* src,
+                   const size_t src_width,
+                   int8_t* dst,
+                   const size_t dst_width,
+                   const size_t num_elems) {
+  CHECK_LT(dst_width, src_width);
+  switch (src_width) {
+    case 2:
+      narrow_values<int16_t>(src, dst, dst_width, num_elems);
+      break;
+    case 4:
+      narrow_values<int32_t>(src, dst, dst_width, num_elems);
+      break;
+    case 8:
+      narrow_values<int64_t>(src, dst, dst_width, num_elems);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+// string ids are stored in the width of the chunk, unsigned if narrow
+template <typename T>
+void mark_string_ids(const int8_t* data,
+                     const size_t num_elems,
+                     std::vector<bool>& is_used) {
+  const auto ids = reinterpret_cast<const T*>(data);
+  for (size_t i = 0; i < num_elems; ++i) {
+    if (ids[i] != inline_int_null_value<T>()) {
+      CHECK_LT(static_cast<size_t>(ids[i]), is_used.size());
+      is_used[ids[i]] = true;
+    }
+  }
+}
+
+void mark_string_ids(const int8_t* data,
+                     const size_t width,
+                     const size_t num_elems,
+                     std::vector<bool>& is_used) {
+  switch (width) {
+    case 1:
+      mark_string_ids<uint8_t>(data, num_elems, is_used);
+      break;
+    case 2:
+      mark_string_ids<uint16_t>(data, num_elems, is_used);
+      break;
+    case 4:
+      mark_string_ids<int32_t>(data, num_elems, is_used);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+template <typename T>
+void remap_string_ids(int8_t* data,
+                      const size_t num_elems,
+                      const std::vector<int32_t>& new_ids) {
+  auto ids = reinterpret_cast<T*>(data);
+  for (size_t i = 0; i < num_elems; ++i) {
+    if (ids[i] != inline_int_null_value<T>()) {
+      CHECK_LT(static_cast<size_t>(ids[i]), new_ids.size());
+      const auto new_id = new_ids[ids[i]];
+      CHECK_GE(new_id, 0);
+      CHECK_LE(new_id, static_cast<int32_t>(ids[i]));
+      ids[i] = static_cast<T>(new_id);
+    }
+  }
+}
+
+void remap_string_ids(int8_t* data,
+                      const size_t width,
+                      const size_t num_elems,
+                      const std::vector<int32_t>& new_ids) {
+  switch (width) {
+    case 1:
+      remap_string_ids<uint8_t>(data, num_elems, new_ids);
+      break;
+    case 2:
+      remap_string_ids<uint16_t>(data, num_elems, new_ids);
+      break;
+    case 4:
+      remap_string_ids<int32_t>(data, num_elems, new_ids);
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+}  // namespace
+
+void InsertOrderFragmenter::reencodeColumn(const ColumnDescriptor* cd,
+                                           const SQLTypeInfo& new_type) {
+  CHECK(cd->columnType.is_integer());
+  CHECK_EQ(new_type.get_compression(), kENCODING_FIXED);
+  // prevent concurrent inserts into the chunks being rewritten
+  mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+  mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
+  auto column_prefix = chunkKeyPrefix_;
+  column_prefix.push_back(cd->columnId);
+  // the copies of the chunks in the buffer pools have the old width
+  dataMgr_->deleteChunksWithPrefix(column_prefix, Data_Namespace::CPU_LEVEL);
+  if (dataMgr_->gpusPresent()) {
+    dataMgr_->deleteChunksWithPrefix(column_prefix, Data_Namespace::GPU_LEVEL);
+  }
+  const size_t old_width = cd->columnType.get_size();
+  const size_t new_width = new_type.get_size();
+  for (const auto& fragmentInfo : fragmentInfoVec_) {
+    auto chunkMetadataMap = fragmentInfo->getChunkMetadataMapPhysical();
+    const auto chunk_meta_it = chunkMetadataMap.find(cd->columnId);
+    CHECK(chunk_meta_it != chunkMetadataMap.end());
+    const auto old_metadata = chunk_meta_it->second;
+    auto chunk_key = column_prefix;
+    chunk_key.push_back(fragmentInfo->fragmentId);
+    auto buffer = dataMgr_->getChunkBuffer(
+        chunk_key, Data_Namespace::DISK_LEVEL, 0, old_metadata->numBytes);
+    const auto num_elems = old_metadata->numElements;
+    CHECK_EQ(old_metadata->numBytes, num_elems * old_width);
+    std::vector<int8_t> old_data(old_metadata->numBytes);
+    std::vector<int8_t> new_data(num_elems * new_width);
+    if (num_elems) {
+      buffer->read(old_data.data(), old_data.size());
+      narrow_values(old_data.data(), old_width, new_data.data(), new_width, num_elems);
+    }
+    buffer->initEncoder(new_type);
+    if (num_elems) {
+      buffer->write(new_data.data(), new_data.size(), 0);
+    }
+    buffer->setSize(new_data.size());
+    buffer->encoder->setNumElems(num_elems);
+    buffer->encoder->resetChunkStats(old_metadata->chunkStats);
+    auto new_metadata = std::make_shared<ChunkMetadata>();
+    buffer->encoder->getMetadata(new_metadata);
+    // the values stay the same
+    std::atomic_store(&new_metadata->bloomFilter,
+                      std::atomic_load(&old_metadata->bloomFilter));
+    chunkMetadataMap[cd->columnId] = new_metadata;
+    fragmentInfo->shadowChunkMetadataMap = chunkMetadataMap;
+    fragmentInfo->setChunkMetadataMap(chunkMetadataMap);
+  }
+}
+
+void InsertOrderFragmenter::markUsedStringIds(const ColumnDescriptor* cd,
+                                              std::vector<bool>& is_used) {
+  CHECK(cd->columnType.is_dict_encoded_string());
+  mapd_shared_lock<mapd_shared_mutex> readLock(fragmentInfoMutex_);
+  auto column_prefix = chunkKeyPrefix_;
+  column_prefix.push_back(cd->columnId);
+  const size_t width = cd->columnType.get_size();
+  std::vector<int8_t> data;
+  for (const auto& fragmentInfo : fragmentInfoVec_) {
+    const auto& chunkMetadataMap = fragmentInfo->getChunkMetadataMapPhysical();
+    const auto chunk_meta_it = chunkMetadataMap.find(cd->columnId);
+    CHECK(chunk_meta_it != chunkMetadataMap.end());
+    const auto& metadata = chunk_meta_it->second;
+    if (!metadata->numElements) {
+      continue;
+    }
+    CHECK_EQ(metadata->numBytes, metadata->numElements * width);
+    auto chunk_key = column_prefix;
+    chunk_key.push_back(fragmentInfo->fragmentId);
+    auto buffer = dataMgr_->getChunkBuffer(
+        chunk_key, Data_Namespace::DISK_LEVEL, 0, metadata->numBytes);
+    data.resize(metadata->numBytes);
+    buffer->read(data.data(), data.size());
+    mark_string_ids(data.data(), width, metadata->numElements, is_used);
+  }
+}
+
+void InsertOrderFragmenter::remapStringIds(const ColumnDescriptor* cd,
+                                           const std::vector<int32_t>& new_ids) {
+  CHECK(cd->columnType.is_dict_encoded_string());
+  // prevent concurrent inserts into the chunks being rewritten
+  mapd_unique_lock<mapd_shared_mutex> insertLock(insertMutex_);
+  mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
+  auto column_prefix = chunkKeyPrefix_;
+  column_prefix.push_back(cd->columnId);
+  // the copies of the chunks in the buffer pools have the old ids
+  dataMgr_->deleteChunksWithPrefix(column_prefix, Data_Namespace::CPU_LEVEL);
+  if (dataMgr_->gpusPresent()) {
+    dataMgr_->deleteChunksWithPrefix(column_prefix, Data_Namespace::GPU_LEVEL);
+  }
+  const auto chunk_it = columnMap_.find(cd->columnId);
+  CHECK(chunk_it != columnMap_.end());
+  const size_t width = cd->columnType.get_size();
+  std::vector<int8_t> data;
+  for (const auto& fragmentInfo : fragmentInfoVec_) {
+    auto chunkMetadataMap = fragmentInfo->getChunkMetadataMapPhysical();
+    const auto chunk_meta_it = chunkMetadataMap.find(cd->columnId);
+    CHECK(chunk_meta_it != chunkMetadataMap.end());
+    const auto old_metadata = chunk_meta_it->second;
+    const auto num_elems = old_metadata->numElements;
+    if (!num_elems) {
+      continue;
+    }
+    CHECK_EQ(old_metadata->numBytes, num_elems * width);
+    auto chunk_key = column_prefix;
+    chunk_key.push_back(fragmentInfo->fragmentId);
+    auto buffer = dataMgr_->getChunkBuffer(
+        chunk_key, Data_Namespace::DISK_LEVEL, 0, old_metadata->numBytes);
+    data.resize(old_metadata->numBytes);
+    buffer->read(data.data(), data.size());
+    remap_string_ids(data.data(), width, num_elems, new_ids);
+    buffer->initEncoder(cd->columnType);
+    buffer->write(data.data(), data.size(), 0);
+    buffer->setSize(data.size());
+    buffer->encoder->updateStats(data.data(), num_elems);
+    buffer->encoder->setNumElems(num_elems);
+    auto new_metadata = std::make_shared<ChunkMetadata>();
+    buffer->encoder->getMetadata(new_metadata);
+    // the filter holds the old ids, so it is rebuilt from the new ones
+    if (g_bloom_filter_bits_per_value > 0 &&
+        std::atomic_load(&old_metadata->bloomFilter)) {
+      auto bloomFilter =
+          ChunkBloomFilter::extend(nullptr, num_elems, g_bloom_filter_bits_per_value);
+      chunk_it->second.addToBloomFilter(
+          *bloomFilter, DataBlockPtr{data.data()}, num_elems);
+      new_metadata->bloomFilter = bloomFilter;
+    }
+    chunkMetadataMap[cd->columnId] = new_metadata;
+    fragmentInfo->shadowChunkMetadataMap = chunkMetadataMap;
+    fragmentInfo->setChunkMetadataMap(chunkMetadataMap);
+  }
+}
+
 bool InsertOrderFragmenter::hasDeletedRows(const int delete_column_id) {
   mapd_shared_lock<mapd_shared_mutex> read_lock(fragmentInfoMutex_);
 
@@ -563,10 +1038,38 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
     return;
   }
 
+  // the partition of every row, which only goes to a fragment of its partition
+  std::vector<int64_t> partitionKeys;
+  if (partitioning_.enabled()) {
+    partitionKeys = sort_rows_by_partition(partitioning_, columnMap_, insertDataStruct);
+  }
+
   std::unordered_map<int, int> inverseInsertDataColIdMap;
+  // insert id and column id of the columns whose chunks can only hold a range of values
+  std::vector<std::pair<size_t, int>> rangeLimitedColumns;
   for (size_t insertId = 0; insertId < insertDataStruct.columnIds.size(); ++insertId) {
-    inverseInsertDataColIdMap.insert(
-        std::make_pair(insertDataStruct.columnIds[insertId], insertId));
+    const auto columnId = insertDataStruct.columnIds[insertId];
+    inverseInsertDataColIdMap.insert(std::make_pair(columnId, insertId));
+    const auto colMapIt = columnMap_.find(columnId);
+    CHECK(colMapIt != columnMap_.end());
+    if (colMapIt->second.getColumnDesc()->columnType.get_compression() ==
+        kENCODING_DIFF) {
+      rangeLimitedColumns.emplace_back(insertId, columnId);
+    }
+  }
+
+  // insert ids of the columns of the table's BLOOM_FILTER option
+  std::vector<bool> bloomFilterColumns(insertDataStruct.columnIds.size(), false);
+  if (g_bloom_filter_bits_per_value > 0) {
+    const auto td = catalog_->getMetadataForTable(physicalTableId_);
+    CHECK(td);
+    for (size_t insertId = 0; insertId < insertDataStruct.columnIds.size(); ++insertId) {
+      bloomFilterColumns[insertId] =
+          std::find(td->bloomFilterColumnIds.begin(),
+                    td->bloomFilterColumnIds.end(),
+                    insertDataStruct.columnIds[insertId]) !=
+          td->bloomFilterColumnIds.end();
+    }
   }
 
   size_t numRowsLeft = insertDataStruct.numRows;
@@ -577,11 +1080,37 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   if (numRowsLeft <= 0) {
     return;
   }
+  auto limitRowsToEncodingRanges = [&](size_t& numRowsToInsert) {
+    for (const auto& rangeLimitedColumn : rangeLimitedColumns) {
+      auto& chunk = columnMap_.find(rangeLimitedColumn.second)->second;
+      numRowsToInsert = std::min(
+          numRowsToInsert,
+          chunk.getNumElemsInEncodingRange(dataCopy[rangeLimitedColumn.first],
+                                           numRowsToInsert));
+    }
+  };
+  auto nextRowsPartition = [&]() -> std::optional<TimePartition> {
+    if (partitionKeys.empty()) {
+      return std::nullopt;
+    }
+    return partitioning_.getPartition(partitionKeys[numRowsInserted]);
+  };
+  auto limitRowsToPartition = [&](size_t& numRowsToInsert) {
+    if (!partitionKeys.empty()) {
+      const auto partitionEnd = std::upper_bound(partitionKeys.begin() + numRowsInserted,
+                                                 partitionKeys.end(),
+                                                 partitionKeys[numRowsInserted]);
+      numRowsToInsert =
+          std::min(numRowsToInsert,
+                   static_cast<size_t>(partitionEnd - partitionKeys.begin()) -
+                       numRowsInserted);
+    }
+  };
 
   FragmentInfo* currentFragment{nullptr};
 
   if (fragmentInfoVec_.empty()) {  // if no fragments exist for table
-    currentFragment = createNewFragment(defaultInsertLevel_);
+    currentFragment = createNewFragment(defaultInsertLevel_, nextRowsPartition());
   } else {
     currentFragment = fragmentInfoVec_.back().get();
   }
@@ -610,10 +1139,15 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
                                                              bytesLeft));
         }
       }
+      limitRowsToEncodingRanges(numRowsToInsert);
+      limitRowsToPartition(numRowsToInsert);
     }
+    const bool otherPartition =
+        !partitionKeys.empty() &&
+        currentFragment->partition->key != partitionKeys[numRowsInserted];
 
-    if (rowsLeftInCurrentFragment == 0 || numRowsToInsert == 0) {
-      currentFragment = createNewFragment(defaultInsertLevel_);
+    if (rowsLeftInCurrentFragment == 0 || numRowsToInsert == 0 || otherPartition) {
+      currentFragment = createNewFragment(defaultInsertLevel_, nextRowsPartition());
       if (numRowsInserted == 0) {
         startFragment++;
       }
@@ -636,22 +1170,82 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
                                                              bytesLeft));
         }
       }
+      // the chunks of the new fragment are empty and take at least one row
+      limitRowsToEncodingRanges(numRowsToInsert);
+      limitRowsToPartition(numRowsToInsert);
     }
 
     CHECK_GT(numRowsToInsert, size_t(0));  // would put us into an endless loop as we'd
                                            // never be able to insert anything
 
-    // for each column, append the data in the appropriate insert buffer
-    for (size_t i = 0; i < insertDataStruct.columnIds.size(); ++i) {
+    // for each column, append the data in the appropriate insert buffer; the chunks of
+    // the columns are independent, only the metadata map of the fragment is shared and
+    // it is updated once all the columns are appended
+    const size_t numColumns = insertDataStruct.columnIds.size();
+    std::vector<std::shared_ptr<ChunkMetadata>> appendedChunkMetadata(numColumns);
+    auto appendColumn = [&](const size_t i) {
       int columnId = insertDataStruct.columnIds[i];
       auto colMapIt = columnMap_.find(columnId);
       CHECK(colMapIt != columnMap_.end());
-      currentFragment->shadowChunkMetadataMap[columnId] =
+      std::shared_ptr<ChunkBloomFilter> bloomFilter;
+      if (bloomFilterColumns[i]) {
+        const auto& chunkMetadataMap = currentFragment->shadowChunkMetadataMap;
+        const auto chunkMetadataIt = chunkMetadataMap.find(columnId);
+        const bool emptyChunk = chunkMetadataIt == chunkMetadataMap.end() ||
+                                chunkMetadataIt->second->numElements == 0;
+        // the filter of a chunk which lost it, e.g. to an update, cannot be rebuilt from
+        // the rows appended now
+        const auto previousFilter =
+            emptyChunk ? nullptr
+                       : std::atomic_load(&chunkMetadataIt->second->bloomFilter);
+        if (emptyChunk || previousFilter) {
+          bloomFilter = ChunkBloomFilter::extend(
+              previousFilter, numRowsToInsert, g_bloom_filter_bits_per_value);
+          colMapIt->second.addToBloomFilter(*bloomFilter, dataCopy[i], numRowsToInsert);
+        }
+      }
+      appendedChunkMetadata[i] =
           colMapIt->second.appendData(dataCopy[i], numRowsToInsert, numRowsInserted);
+      if (bloomFilter) {
+        appendedChunkMetadata[i]->bloomFilter = bloomFilter;
+      }
       auto varLenColInfoIt = varLenColInfo_.find(columnId);
       if (varLenColInfoIt != varLenColInfo_.end()) {
         varLenColInfoIt->second = colMapIt->second.getBuffer()->size();
       }
+    };
+    const size_t numWorkers =
+        g_enable_parallel_column_appends &&
+                defaultInsertLevel_ == Data_Namespace::CPU_LEVEL &&
+                numColumns * numRowsToInsert >= kMinParallelAppendValues
+            ? std::min(numColumns, static_cast<size_t>(cpu_threads()))
+            : 1;
+    if (numWorkers > 1) {
+      // the workers take the next column when done with one, the widths of the
+      // columns and the costs of their encoders differ
+      std::atomic<size_t> nextColumn{0};
+      std::vector<std::future<void>> workers;
+      for (size_t w = 0; w < numWorkers; ++w) {
+        workers.push_back(std::async(std::launch::async, [&] {
+          for (size_t i = nextColumn++; i < numColumns; i = nextColumn++) {
+            appendColumn(i);
+          }
+        }));
+      }
+      for (auto& worker : workers) {
+        worker.wait();
+      }
+      for (auto& worker : workers) {
+        worker.get();
+      }
+    } else {
+      for (size_t i = 0; i < numColumns; ++i) {
+        appendColumn(i);
+      }
+    }
+    for (size_t i = 0; i < numColumns; ++i) {
+      currentFragment->shadowChunkMetadataMap[insertDataStruct.columnIds[i]] =
+          appendedChunkMetadata[i];
     }
     if (hasMaterializedRowId_) {
       size_t startId = maxFragmentRows_ * currentFragment->fragmentId +
@@ -678,6 +1272,7 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
     // has locked fragmentInfoMutex_ while SELECT waits for fragmentInfoMutex_ and
     // COPY_FROM waits for TableWriteLock
     mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+    invalidateQueryInfoSnapshot();
     for (auto partIt = fragmentInfoVec_.begin() + startFragment;
          partIt != fragmentInfoVec_.end();
          ++partIt) {
@@ -688,10 +1283,15 @@ void InsertOrderFragmenter::insertDataImpl(InsertData& insertDataStruct) {
   }
   numTuples_ += insertDataStruct.numRows;
   dropFragmentsToSize(maxRows_);
+  if (partitioning_.enabled()) {
+    dropExpiredPartitions();
+  }
+  deleteDroppedFragments();
 }
 
 FragmentInfo* InsertOrderFragmenter::createNewFragment(
-    const Data_Namespace::MemoryLevel memoryLevel) {
+    const Data_Namespace::MemoryLevel memoryLevel,
+    const std::optional<TimePartition>& partition) {
   // also sets the new fragment as the insertBuffer for each column
 
   maxFragmentId_++;
@@ -705,6 +1305,7 @@ FragmentInfo* InsertOrderFragmenter::createNewFragment(
   }
   newFragmentInfo->physicalTableId = physicalTableId_;
   newFragmentInfo->shard = shard_;
+  newFragmentInfo->partition = partition;
 
   for (map<int, Chunk>::iterator colMapIt = columnMap_.begin();
        colMapIt != columnMap_.end();
@@ -722,12 +1323,34 @@ FragmentInfo* InsertOrderFragmenter::createNewFragment(
   }
 
   mapd_lock_guard<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateQueryInfoSnapshot();
   fragmentInfoVec_.push_back(std::move(newFragmentInfo));
   return fragmentInfoVec_.back().get();
 }
 
+void InsertOrderFragmenter::invalidateQueryInfoSnapshot() {
+  std::atomic_store(&queryInfoSnapshot_, std::shared_ptr<const TableInfo>());
+}
+
+void InsertOrderFragmenter::invalidateContents() {
+  contentsVersion_ = next_contents_version();
+  invalidateQueryInfoSnapshot();
+}
+
 TableInfo InsertOrderFragmenter::getFragmentsForQuery() {
+  // queries share the snapshot without locking, fragmentInfoMutex_ is only taken to
+  // rebuild it after the fragments changed
+  if (const auto snapshot = std::atomic_load(&queryInfoSnapshot_)) {
+    return *snapshot;
+  }
   mapd_shared_lock<mapd_shared_mutex> readLock(fragmentInfoMutex_);
+  auto snapshot = std::make_shared<const TableInfo>(buildQueryInfo());
+  // published before unlocking, so that a writer coming next resets it
+  std::atomic_store(&queryInfoSnapshot_, snapshot);
+  return *snapshot;
+}
+
+TableInfo InsertOrderFragmenter::buildQueryInfo() const {
   TableInfo queryInfo;
   queryInfo.chunkKeyPrefix = chunkKeyPrefix_;
   // right now we don't test predicate, so just return (copy of) all fragments
@@ -743,17 +1366,18 @@ TableInfo InsertOrderFragmenter::getFragmentsForQuery() {
     emptyFragmentInfo.deviceIds.resize(dataMgr_->levelSizes_.size());
     emptyFragmentInfo.physicalTableId = physicalTableId_;
     emptyFragmentInfo.shard = shard_;
+    emptyFragmentInfo.contentsVersion = contentsVersion_;
     queryInfo.fragments.push_back(emptyFragmentInfo);
   } else {
     fragmentsExist = true;
     std::for_each(
         fragmentInfoVec_.begin(),
         fragmentInfoVec_.end(),
-        [&queryInfo](const auto& fragment_owned_ptr) {
+        [this, &queryInfo](const auto& fragment_owned_ptr) {
           queryInfo.fragments.emplace_back(*fragment_owned_ptr);  // makes a copy
+          queryInfo.fragments.back().contentsVersion = contentsVersion_;
         });
   }
-  readLock.unlock();
   queryInfo.setPhysicalNumTuples(0);
   auto partIt = queryInfo.fragments.begin();
   if (fragmentsExist) {
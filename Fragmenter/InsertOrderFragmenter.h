@@ -22,6 +22,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -42,6 +43,8 @@ class DataMgr;
 
 namespace Fragmenter_Namespace {
 
+class InsertWal;
+
 /**
  * @type InsertOrderFragmenter
  * @brief	The InsertOrderFragmenter is a child class of
@@ -65,7 +68,8 @@ class InsertOrderFragmenter : public AbstractFragmenter {
       const size_t pageSize = DEFAULT_PAGE_SIZE /*default 1MB*/,
       const size_t maxRows = DEFAULT_MAX_ROWS,
       const Data_Namespace::MemoryLevel defaultInsertLevel = Data_Namespace::DISK_LEVEL,
-      const bool uses_foreign_storage = false);
+      const bool uses_foreign_storage = false,
+      const TimePartitioning& partitioning = {});
 
   ~InsertOrderFragmenter() override;
   /**
@@ -153,6 +157,18 @@ class InsertOrderFragmenter : public AbstractFragmenter {
                     const Data_Namespace::MemoryLevel memory_level,
                     UpdelRoll& updel_roll) override;
 
+  bool updateColumnFromColumnar(const Catalog_Namespace::Catalog* catalog,
+                                const TableDescriptor* td,
+                                const ColumnDescriptor* cd,
+                                const int fragment_id,
+                                const int64_t* frag_offsets,
+                                const int8_t* rhs_values,
+                                const size_t rhs_width,
+                                const size_t num_rows,
+                                const SQLTypeInfo& rhs_type,
+                                const Data_Namespace::MemoryLevel memory_level,
+                                UpdelRoll& updel_roll) override;
+
   void updateColumnMetadata(const ColumnDescriptor* cd,
                             FragmentInfo& fragment,
                             std::shared_ptr<Chunk_NS::Chunk> chunk,
@@ -175,6 +191,19 @@ class InsertOrderFragmenter : public AbstractFragmenter {
                    const Data_Namespace::MemoryLevel memory_level,
                    UpdelRoll& updel_roll) override;
 
+  bool sortRows(const Catalog_Namespace::Catalog* catalog,
+                const TableDescriptor* td,
+                const int fragment_id,
+                const ColumnDescriptor* sort_cd,
+                const Data_Namespace::MemoryLevel memory_level,
+                UpdelRoll& updel_roll) override;
+
+  size_t moveFragmentRows(const Catalog_Namespace::Catalog* catalog,
+                          const TableDescriptor* td,
+                          const int fragment_id,
+                          const Data_Namespace::MemoryLevel memory_level,
+                          UpdelRoll& updel_roll) override;
+
   const std::vector<uint64_t> getVacuumOffsets(
       const std::shared_ptr<Chunk_NS::Chunk>& chunk) override;
 
@@ -184,8 +213,17 @@ class InsertOrderFragmenter : public AbstractFragmenter {
 
   void dropColumns(const std::vector<int>& columnIds) override;
 
+  void reencodeColumn(const ColumnDescriptor* cd, const SQLTypeInfo& new_type) override;
+
+  void markUsedStringIds(const ColumnDescriptor* cd, std::vector<bool>& is_used) override;
+
+  void remapStringIds(const ColumnDescriptor* cd,
+                      const std::vector<int32_t>& new_ids) override;
+
   bool hasDeletedRows(const int delete_column_id) override;
 
+  size_t dropFragments(const std::vector<int>& fragmentIds) override;
+
  protected:
   std::vector<int> chunkKeyPrefix_;
   std::map<int, Chunk_NS::Chunk>
@@ -207,15 +245,26 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   std::string fragmenterType_;
   mapd_shared_mutex
       fragmentInfoMutex_;  // to prevent read-write conflicts for fragmentInfoVec_
+  // immutable copy of the fragments handed out by getFragmentsForQuery(), swapped with
+  // std::atomic_load / std::atomic_store. Null after a writer changed the fragments.
+  std::shared_ptr<const TableInfo> queryInfoSnapshot_;
+  // unique across the fragmenters of the process, so that a table truncated or reloaded
+  // with a new fragmenter doesn't get the version of its former rows back
+  uint64_t contentsVersion_;
   mapd_shared_mutex
       insertMutex_;  // to prevent race conditions on insert - only one insert statement
                      // should be going to a table at a time
+  // the fragments out of fragmentInfoVec_ whose chunks the queries that were running
+  // when they were dropped may still read
+  std::vector<int> droppedFragmentIds_;
+  std::mutex droppedFragmentsMutex_;
   Data_Namespace::MemoryLevel defaultInsertLevel_;
   const bool uses_foreign_storage_;
   bool hasMaterializedRowId_;
   int rowIdColId_;
   std::unordered_map<int, size_t> varLenColInfo_;
   std::shared_ptr<std::mutex> mutex_access_inmem_states;
+  const TimePartitioning partitioning_;
 
   /**
    * @brief creates new fragment, calling createChunk()
@@ -226,13 +275,31 @@ class InsertOrderFragmenter : public AbstractFragmenter {
    */
 
   FragmentInfo* createNewFragment(
-      const Data_Namespace::MemoryLevel memory_level = Data_Namespace::DISK_LEVEL);
+      const Data_Namespace::MemoryLevel memory_level = Data_Namespace::DISK_LEVEL,
+      const std::optional<TimePartition>& partition = std::nullopt);
+  /// Deletes the chunks of the fragments dropped from fragmentInfoVec_ once no query
+  /// that may have pinned them runs anymore, see deleteDroppedFragments()
   void deleteFragments(const std::vector<int>& dropFragIds);
+  /// Deletes the chunks of the dropped fragments if the table data write lock is free,
+  /// i.e. no query reads the table, else leaves them to a next insert or drop
+  void deleteDroppedFragments();
+  /// Deletes the chunks of the fragments, with fragmentInfoMutex_ locked for writing
+  void deleteFragmentChunks(const std::vector<int>& dropFragIds);
 
   void getChunkMetadata();
+  /// Drops the fragments of the partitions older than the partitioning_.retention newest
+  void dropExpiredPartitions();
 
   void lockInsertCheckpointData(const InsertData& insertDataStruct);
   void insertDataImpl(InsertData& insertDataStruct);
+  /// Called with fragmentInfoMutex_ locked for writing whenever the fragments change
+  void invalidateQueryInfoSnapshot();
+  /// Like invalidateQueryInfoSnapshot(), for the changes of the rows the table already
+  /// has, which give the fragments a new contentsVersion
+  void invalidateContents();
+  TableInfo buildQueryInfo() const;
+  /// Applies the insert and makes it durable through the log instead of a checkpoint
+  void insertDataLogged(InsertData& insertDataStruct, InsertWal& insertWal);
   void replicateData(const InsertData& insertDataStruct);
 
   InsertOrderFragmenter(const InsertOrderFragmenter&);
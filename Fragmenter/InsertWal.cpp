@@ -0,0 +1,595 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Fragmenter/InsertWal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+
+#include "Logger/Logger.h"
+#include "Shared/checked_alloc.h"
+#include "Shared/crc32c.h"
+
+bool g_enable_insert_wal{false};
+size_t g_insert_wal_checkpoint_bytes{64 * 1024 * 1024};
+size_t g_insert_wal_checkpoint_interval_seconds{60};
+
+namespace Fragmenter_Namespace {
+
+namespace {
+
+/*
+ * A record is a uint32 payload size and the crc32c of the payload, followed by the
+ * payload. The payload starts with the record type, the table id and the epoch; an
+ * insert continues with the number of rows and columns and then, per column, its id,
+ * how its data is stored and the data.
+ */
+constexpr size_t kRecordHeaderSize{2 * sizeof(uint32_t)};
+constexpr size_t kPayloadHeaderSize{sizeof(uint8_t) + 2 * sizeof(int32_t)};
+
+enum class RecordType : uint8_t { Insert = 0, Reset = 1 };
+
+enum class ColumnKind : uint8_t { Numbers = 0, Strings = 1, Arrays = 2 };
+
+const std::string kSegmentExtension{".wal"};
+
+std::string errno_message(const std::string& what, const std::string& path) {
+  return what + " '" + path + "': " + std::strerror(errno);
+}
+
+void sync_path(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0 || ::fsync(fd) != 0) {
+    const auto message = errno_message("Could not sync", path);
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw std::runtime_error(message);
+  }
+  ::close(fd);
+}
+
+template <typename T>
+void append_pod(std::vector<int8_t>& buf, const T value) {
+  const auto bytes = reinterpret_cast<const int8_t*>(&value);
+  buf.insert(buf.end(), bytes, bytes + sizeof(T));
+}
+
+void append_bytes(std::vector<int8_t>& buf, const int8_t* data, const size_t numBytes) {
+  if (numBytes) {
+    buf.insert(buf.end(), data, data + numBytes);
+  }
+}
+
+ColumnKind get_column_kind(const SQLTypeInfo& type) {
+  if (type.is_geometry() ||
+      (type.is_string() && type.get_compression() == kENCODING_NONE)) {
+    return ColumnKind::Strings;
+  }
+  return type.is_array() ? ColumnKind::Arrays : ColumnKind::Numbers;
+}
+
+/// Bounds checked reads from a record payload
+class PayloadReader {
+ public:
+  PayloadReader(const std::vector<int8_t>& payload) : payload_(payload) {}
+
+  template <typename T>
+  T read() {
+    T value;
+    std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  const int8_t* readBytes(const size_t numBytes) {
+    if (numBytes > payload_.size() - offset_) {
+      throw std::runtime_error("Insert WAL record is truncated.");
+    }
+    const auto data = payload_.data() + offset_;
+    offset_ += numBytes;
+    return data;
+  }
+
+ private:
+  const std::vector<int8_t>& payload_;
+  size_t offset_{0};
+};
+
+/// An insert read back from the log, owning the column data insertData points to
+struct ReplayedInsert {
+  InsertData insertData;
+  std::list<std::vector<int8_t>> numbers;
+  std::list<std::vector<std::string>> strings;
+  std::list<std::vector<ArrayDatum>> arrays;
+};
+
+void deserialize_insert(PayloadReader& reader, ReplayedInsert& insert) {
+  auto& insertData = insert.insertData;
+  insertData.numRows = reader.read<uint64_t>();
+  const auto numColumns = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < numColumns; ++i) {
+    insertData.columnIds.push_back(reader.read<int32_t>());
+    DataBlockPtr dataBlock;
+    switch (static_cast<ColumnKind>(reader.read<uint8_t>())) {
+      case ColumnKind::Numbers: {
+        const auto width = reader.read<uint32_t>();
+        const auto numBytes = width * insertData.numRows;
+        const auto data = reader.readBytes(numBytes);
+        insert.numbers.emplace_back(data, data + numBytes);
+        dataBlock.numbersPtr = insert.numbers.back().data();
+        break;
+      }
+      case ColumnKind::Strings: {
+        insert.strings.emplace_back();
+        auto& strings = insert.strings.back();
+        strings.reserve(insertData.numRows);
+        for (size_t row = 0; row < insertData.numRows; ++row) {
+          const auto length = reader.read<uint32_t>();
+          const auto data = reinterpret_cast<const char*>(reader.readBytes(length));
+          strings.emplace_back(data, length);
+        }
+        dataBlock.stringsPtr = &strings;
+        break;
+      }
+      case ColumnKind::Arrays: {
+        insert.arrays.emplace_back();
+        auto& arrays = insert.arrays.back();
+        arrays.reserve(insertData.numRows);
+        for (size_t row = 0; row < insertData.numRows; ++row) {
+          const bool isNull = reader.read<uint8_t>();
+          const auto length = reader.read<uint64_t>();
+          const auto data = reader.readBytes(length);
+          int8_t* buf = nullptr;
+          if (length) {
+            buf = reinterpret_cast<int8_t*>(checked_malloc(length));
+            std::memcpy(buf, data, length);
+          }
+          arrays.emplace_back(length, buf, isNull);
+        }
+        dataBlock.arraysPtr = &arrays;
+        break;
+      }
+      default:
+        throw std::runtime_error("Insert WAL record has an unknown column kind.");
+    }
+    insertData.data.push_back(dataBlock);
+  }
+}
+
+std::vector<int8_t> make_record(const std::vector<int8_t>& payload) {
+  std::vector<int8_t> record;
+  record.reserve(kRecordHeaderSize + payload.size());
+  append_pod<uint32_t>(record, payload.size());
+  append_pod<uint32_t>(record, crc32c::value(payload.data(), payload.size()));
+  append_bytes(record, payload.data(), payload.size());
+  return record;
+}
+
+}  // namespace
+
+InsertWal::InsertWal(const std::string& path) : path_(path) {
+  boost::filesystem::create_directories(path_);
+  if (!boost::filesystem::is_directory(path_)) {
+    throw std::runtime_error("Insert WAL path '" + path_ + "' is not a directory.");
+  }
+  std::vector<uint64_t> seqNums;
+  for (const auto& entry : boost::filesystem::directory_iterator(path_)) {
+    const auto& filePath = entry.path();
+    const auto stem = filePath.stem().string();
+    if (filePath.extension() != kSegmentExtension || stem.empty() ||
+        !std::all_of(stem.begin(), stem.end(), ::isdigit)) {
+      continue;
+    }
+    seqNums.push_back(std::stoull(stem));
+  }
+  std::sort(seqNums.begin(), seqNums.end());
+
+  // recover which tables each segment holds inserts for; resets discard the inserts
+  // logged for a table in the segments before
+  for (const auto seqNum : seqNums) {
+    const auto segmentPath = getSegmentPath(seqNum);
+    segments_.push_back({seqNum, boost::filesystem::file_size(segmentPath), {}});
+    for (const auto& payload : readSegment(seqNum, segments_.back().size)) {
+      PayloadReader reader(payload);
+      const auto type = static_cast<RecordType>(reader.read<uint8_t>());
+      const auto tableId = reader.read<int32_t>();
+      const auto epoch = reader.read<int32_t>();
+      if (type == RecordType::Reset) {
+        for (auto& segment : segments_) {
+          segment.maxEpochByTable.erase(tableId);
+        }
+        continue;
+      }
+      auto& maxEpoch =
+          segments_.back().maxEpochByTable.emplace(tableId, epoch).first->second;
+      maxEpoch = std::max(maxEpoch, epoch);
+    }
+  }
+  // appends go to a new segment, never after a torn tail left by a crash
+  openSegment(seqNums.empty() ? 0 : seqNums.back() + 1);
+}
+
+InsertWal::~InsertWal() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+std::vector<int8_t> InsertWal::serializeInsert(
+    const int tableId,
+    const int epoch,
+    const InsertData& insertData,
+    const std::vector<SQLTypeInfo>& columnTypes) {
+  CHECK_EQ(insertData.columnIds.size(), columnTypes.size());
+  CHECK_EQ(insertData.columnIds.size(), insertData.data.size());
+  std::vector<int8_t> payload;
+  append_pod<uint8_t>(payload, static_cast<uint8_t>(RecordType::Insert));
+  append_pod<int32_t>(payload, tableId);
+  append_pod<int32_t>(payload, epoch);
+  append_pod<uint64_t>(payload, insertData.numRows);
+  append_pod<uint32_t>(payload, insertData.columnIds.size());
+  for (size_t i = 0; i < insertData.columnIds.size(); ++i) {
+    const auto& type = columnTypes[i];
+    const auto& dataBlock = insertData.data[i];
+    const auto kind = get_column_kind(type);
+    append_pod<int32_t>(payload, insertData.columnIds[i]);
+    append_pod<uint8_t>(payload, static_cast<uint8_t>(kind));
+    switch (kind) {
+      case ColumnKind::Numbers: {
+        // dictionary encoded strings are passed as ids of the encoded width
+        const uint32_t width =
+            type.is_string() ? type.get_size() : type.get_logical_size();
+        append_pod<uint32_t>(payload, width);
+        append_bytes(payload, dataBlock.numbersPtr, width * insertData.numRows);
+        break;
+      }
+      case ColumnKind::Strings: {
+        CHECK_EQ(dataBlock.stringsPtr->size(), insertData.numRows);
+        for (const auto& str : *dataBlock.stringsPtr) {
+          append_pod<uint32_t>(payload, str.size());
+          append_bytes(payload, reinterpret_cast<const int8_t*>(str.data()), str.size());
+        }
+        break;
+      }
+      case ColumnKind::Arrays: {
+        CHECK_EQ(dataBlock.arraysPtr->size(), insertData.numRows);
+        for (const auto& array : *dataBlock.arraysPtr) {
+          append_pod<uint8_t>(payload, array.is_null);
+          append_pod<uint64_t>(payload, array.pointer ? array.length : 0);
+          if (array.pointer) {
+            append_bytes(payload, array.pointer, array.length);
+          }
+        }
+        break;
+      }
+    }
+  }
+  return make_record(payload);
+}
+
+size_t InsertWal::commit(std::vector<int8_t>&& record) {
+  CHECK_GE(record.size(), kRecordHeaderSize + kPayloadHeaderSize);
+  PendingRecord pending;
+  pending.isReset = false;
+  std::memcpy(&pending.tableId,
+              record.data() + kRecordHeaderSize + sizeof(uint8_t),
+              sizeof(int32_t));
+  std::memcpy(&pending.epoch,
+              record.data() + kRecordHeaderSize + sizeof(uint8_t) + sizeof(int32_t),
+              sizeof(int32_t));
+  pending.size = record.size();
+  return append(std::move(record), pending);
+}
+
+void InsertWal::resetTable(const int tableId) {
+  std::vector<int8_t> payload;
+  append_pod<uint8_t>(payload, static_cast<uint8_t>(RecordType::Reset));
+  append_pod<int32_t>(payload, tableId);
+  append_pod<int32_t>(payload, 0);
+  auto record = make_record(payload);
+  PendingRecord pending{tableId, 0, true, record.size()};
+  append(std::move(record), pending);
+}
+
+size_t InsertWal::append(std::vector<int8_t>&& record, const PendingRecord& pending) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!error_.empty()) {
+    throw std::runtime_error(error_);
+  }
+  if (pendingData_.empty()) {
+    pendingData_ = std::move(record);
+  } else {
+    pendingData_.insert(pendingData_.end(), record.begin(), record.end());
+  }
+  pendingRecords_.push_back(pending);
+  appendedBytes_ += pending.size;
+  const auto recordEnd = appendedBytes_;
+
+  size_t tableBytes = 0;
+  if (pending.isReset) {
+    bytesByTable_.erase(pending.tableId);
+  } else {
+    auto& epochBytes = bytesByTable_[pending.tableId];
+    if (epochBytes.first != pending.epoch) {
+      epochBytes = {pending.epoch, 0};
+    }
+    epochBytes.second += pending.size;
+    tableBytes = epochBytes.second;
+  }
+
+  // the first appender to find no write in flight writes everything pending, which
+  // includes the records appended while the previous write was syncing
+  while (durableBytes_ < recordEnd) {
+    if (!error_.empty()) {
+      throw std::runtime_error(error_);
+    }
+    if (writing_) {
+      cv_.wait(lock);
+    } else {
+      writePending(lock);
+    }
+  }
+  return tableBytes;
+}
+
+void InsertWal::writePending(std::unique_lock<std::mutex>& lock) {
+  CHECK(!writing_);
+  writing_ = true;
+  std::vector<int8_t> data;
+  data.swap(pendingData_);
+  std::vector<PendingRecord> records;
+  records.swap(pendingRecords_);
+  const auto end = appendedBytes_;
+  const auto segmentPath = getSegmentPath(segments_.back().seqNum);
+  lock.unlock();
+
+  std::string error;
+  size_t bytesWritten = 0;
+  while (bytesWritten < data.size()) {
+    const auto ret = ::write(fd_, data.data() + bytesWritten, data.size() - bytesWritten);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      error = errno_message("Could not write", segmentPath);
+      break;
+    }
+    bytesWritten += ret;
+  }
+  if (error.empty() && ::fdatasync(fd_) != 0) {
+    error = errno_message("Could not sync", segmentPath);
+  }
+
+  lock.lock();
+  writing_ = false;
+  if (error.empty()) {
+    durableBytes_ = end;
+    auto& segment = segments_.back();
+    segment.size += data.size();
+    for (const auto& record : records) {
+      if (record.isReset) {
+        for (auto& s : segments_) {
+          s.maxEpochByTable.erase(record.tableId);
+        }
+        continue;
+      }
+      auto& maxEpoch =
+          segment.maxEpochByTable.emplace(record.tableId, record.epoch).first->second;
+      maxEpoch = std::max(maxEpoch, record.epoch);
+    }
+    if (segment.size >= kSegmentSize) {
+      try {
+        openSegment(segment.seqNum + 1);
+      } catch (const std::exception& e) {
+        error = e.what();
+      }
+    }
+  }
+  if (!error.empty()) {
+    LOG(ERROR) << "Insert WAL failed, further inserts are rejected: " << error;
+    error_ = error;
+  }
+  cv_.notify_all();
+}
+
+std::string InsertWal::getSegmentPath(const uint64_t seqNum) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llu", static_cast<unsigned long long>(seqNum));
+  return (boost::filesystem::path(path_) / (name + kSegmentExtension)).string();
+}
+
+void InsertWal::openSegment(const uint64_t seqNum) {
+  const auto segmentPath = getSegmentPath(seqNum);
+  const int fd =
+      ::open(segmentPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(errno_message("Could not create", segmentPath));
+  }
+  try {
+    // records synced into the segment must not be lost with its directory entry
+    sync_path(path_);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  fd_ = fd;
+  segments_.push_back({seqNum, 0, {}});
+}
+
+std::vector<std::vector<int8_t>> InsertWal::readSegment(const uint64_t seqNum,
+                                                        const size_t maxSize) const {
+  const auto segmentPath = getSegmentPath(seqNum);
+  std::ifstream in(segmentPath, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Could not open insert WAL segment '" + segmentPath + "'");
+  }
+  std::vector<std::vector<int8_t>> payloads;
+  size_t offset = 0;
+  while (offset + kRecordHeaderSize <= maxSize) {
+    uint32_t header[2];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) {
+      break;
+    }
+    const auto payloadSize = header[0];
+    if (payloadSize < kPayloadHeaderSize ||
+        offset + kRecordHeaderSize + payloadSize > maxSize) {
+      break;
+    }
+    std::vector<int8_t> payload(payloadSize);
+    if (!in.read(reinterpret_cast<char*>(payload.data()), payloadSize) ||
+        crc32c::value(payload.data(), payloadSize) != header[1]) {
+      break;
+    }
+    offset += kRecordHeaderSize + payloadSize;
+    payloads.push_back(std::move(payload));
+  }
+  if (offset < maxSize) {
+    LOG(WARNING) << "Ignoring " << maxSize - offset
+                 << " bytes of torn or corrupt records at the end of insert WAL segment '"
+                 << segmentPath << "'";
+  }
+  return payloads;
+}
+
+void InsertWal::replay(
+    const std::function<void(const int tableId, const int epoch, InsertData& insertData)>&
+        apply,
+    const std::set<int>& tableIds) {
+  std::vector<std::pair<uint64_t, size_t>> segmentSizes;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !writing_; });
+    for (const auto& segment : segments_) {
+      segmentSizes.emplace_back(segment.seqNum, segment.size);
+    }
+  }
+  const auto selected = [&tableIds](const int tableId) {
+    return tableIds.empty() || tableIds.count(tableId);
+  };
+
+  // the inserts of a table logged before its last reset are skipped
+  std::map<int, size_t> lastResetByTable;
+  size_t recordIdx = 0;
+  for (const auto& [seqNum, size] : segmentSizes) {
+    for (const auto& payload : readSegment(seqNum, size)) {
+      PayloadReader reader(payload);
+      const auto type = static_cast<RecordType>(reader.read<uint8_t>());
+      const auto tableId = reader.read<int32_t>();
+      if (type == RecordType::Reset && selected(tableId)) {
+        lastResetByTable[tableId] = recordIdx;
+      }
+      ++recordIdx;
+    }
+  }
+
+  recordIdx = 0;
+  size_t numReplayed = 0;
+  for (const auto& [seqNum, size] : segmentSizes) {
+    for (const auto& payload : readSegment(seqNum, size)) {
+      const auto idx = recordIdx++;
+      PayloadReader reader(payload);
+      const auto type = static_cast<RecordType>(reader.read<uint8_t>());
+      const auto tableId = reader.read<int32_t>();
+      const auto epoch = reader.read<int32_t>();
+      if (type != RecordType::Insert || !selected(tableId)) {
+        continue;
+      }
+      const auto lastReset = lastResetByTable.find(tableId);
+      if (lastReset != lastResetByTable.end() && idx < lastReset->second) {
+        continue;
+      }
+      ReplayedInsert insert;
+      insert.insertData.tableId = tableId;
+      deserialize_insert(reader, insert);
+      apply(tableId, epoch, insert.insertData);
+      ++numReplayed;
+    }
+  }
+  VLOG(1) << "Replayed " << numReplayed << " inserts from insert WAL '" << path_ << "'";
+}
+
+std::vector<int> InsertWal::getTablesToCheckpoint(
+    const std::function<int(const int tableId)>& getTableEpoch) const {
+  std::map<int, std::pair<int, size_t>> bytesByTable;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bytesByTable = bytesByTable_;
+  }
+  // getTableEpoch is called without mutex_ held, it may take catalog locks
+  std::vector<int> tableIds;
+  for (const auto& [tableId, epochBytes] : bytesByTable) {
+    if (getTableEpoch(tableId) == epochBytes.first) {
+      tableIds.push_back(tableId);
+    }
+  }
+  return tableIds;
+}
+
+void InsertWal::removeCheckpointedSegments(
+    const std::function<int(const int tableId)>& getTableEpoch,
+    const bool startNewSegment) {
+  std::vector<Segment> candidates;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !writing_; });
+    if (startNewSegment && error_.empty() && segments_.back().size) {
+      openSegment(segments_.back().seqNum + 1);
+    }
+    candidates.assign(segments_.begin(), std::prev(segments_.end()));
+  }
+
+  size_t numCheckpointed = 0;
+  for (const auto& segment : candidates) {
+    const bool checkpointed = std::all_of(
+        segment.maxEpochByTable.begin(),
+        segment.maxEpochByTable.end(),
+        [&getTableEpoch](const auto& tableEpoch) {
+          const auto epoch = getTableEpoch(tableEpoch.first);
+          return epoch < 0 || epoch > tableEpoch.second;
+        });
+    if (!checkpointed) {
+      break;
+    }
+    ++numCheckpointed;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < numCheckpointed && segments_.size() > 1 &&
+                     segments_.front().seqNum == candidates[i].seqNum;
+       ++i) {
+    boost::filesystem::remove(getSegmentPath(segments_.front().seqNum));
+    segments_.pop_front();
+  }
+}
+
+size_t InsertWal::getNumSegments() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return segments_.size();
+}
+
+}  // namespace Fragmenter_Namespace
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    InsertWal.h
+ * @brief   Write-ahead log of the inserts into the disk tables of a database
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Fragmenter/Fragmenter.h"
+#include "Shared/sqltypes.h"
+
+namespace Fragmenter_Namespace {
+
+/**
+ * Makes inserts durable without a checkpoint per statement. The fragmenter applies an
+ * insert as before, leaving its pages uncheckpointed, and logs it together with the
+ * epoch of the table it was applied at. Inserts logged concurrently, into any table of
+ * the database, share a single write and fdatasync of the log (group commit).
+ *
+ * Tables are checkpointed in the background, or once enough was logged for them. An
+ * insert whose epoch was checkpointed is in the data files, so on startup, and after a
+ * table was rolled back to its last checkpoint, only inserts logged at or after the
+ * table's current epoch are applied again. Truncating or dropping a table logs a reset
+ * that discards its earlier inserts.
+ *
+ * The log is a sequence of segment files. A segment is removed once every table it has
+ * inserts for was checkpointed past them. Methods throw std::runtime_error when the log
+ * cannot be written, after which all further appends fail.
+ */
+class InsertWal {
+ public:
+  /// Opens the log in directory path, creating it if needed
+  InsertWal(const std::string& path);
+  ~InsertWal();
+
+  /**
+   * Serializes an insert into physical table tableId, applied at epoch. columnTypes
+   * holds the type of each of insertData.columnIds.
+   */
+  static std::vector<int8_t> serializeInsert(const int tableId,
+                                             const int epoch,
+                                             const InsertData& insertData,
+                                             const std::vector<SQLTypeInfo>& columnTypes);
+
+  /**
+   * Appends a record returned by serializeInsert() and blocks until it is durable.
+   * Returns the number of bytes logged for the table at the record's epoch, including
+   * this record.
+   */
+  size_t commit(std::vector<int8_t>&& record);
+
+  /// Durably discards the inserts logged for the table so far
+  void resetTable(const int tableId);
+
+  /**
+   * Calls apply, in log order, for every insert logged since the last reset of its
+   * table, and only for tables in tableIds unless it is empty. The InsertData passed to
+   * apply owns its data until apply returns.
+   */
+  void replay(const std::function<void(const int tableId,
+                                       const int epoch,
+                                       InsertData& insertData)>& apply,
+              const std::set<int>& tableIds = {});
+
+  /// Tables with inserts logged at their current epoch, i.e. that need a checkpoint
+  std::vector<int> getTablesToCheckpoint(
+      const std::function<int(const int tableId)>& getTableEpoch) const;
+
+  /**
+   * Removes the oldest segments whose inserts were all checkpointed. getTableEpoch
+   * returns the current epoch of a table, or -1 if it does not exist anymore. Starts a
+   * new segment first if requested, so that the current one can be removed as well.
+   */
+  void removeCheckpointedSegments(
+      const std::function<int(const int tableId)>& getTableEpoch,
+      const bool startNewSegment = false);
+
+  /// Number of segment files currently on disk
+  size_t getNumSegments() const;
+
+  static constexpr size_t kSegmentSize{64 * 1024 * 1024};
+
+ private:
+  struct Segment {
+    uint64_t seqNum;
+    size_t size;
+    std::map<int, int> maxEpochByTable;  /// tables with inserts in the segment
+  };
+
+  /// Table, epoch and kind of a record appended but not yet written
+  struct PendingRecord {
+    int tableId;
+    int epoch;
+    bool isReset;
+    size_t size;
+  };
+
+  std::string getSegmentPath(const uint64_t seqNum) const;
+  void openSegment(const uint64_t seqNum);
+  size_t append(std::vector<int8_t>&& record, const PendingRecord& pending);
+  /// Writes and syncs the pending records, called with lock held and unlocks it meanwhile
+  void writePending(std::unique_lock<std::mutex>& lock);
+  /// Reads the valid records of a segment, stopping at a torn or corrupt tail
+  std::vector<std::vector<int8_t>> readSegment(const uint64_t seqNum,
+                                               const size_t maxSize) const;
+
+  const std::string path_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Segment> segments_;  /// oldest first, the last one is written to
+  int fd_{-1};
+  std::vector<int8_t> pendingData_;
+  std::vector<PendingRecord> pendingRecords_;
+  uint64_t appendedBytes_{0};
+  uint64_t durableBytes_{0};
+  bool writing_{false};
+  std::string error_;  /// set once a write failed
+  /// per table, the epoch of its last insert and the bytes logged at that epoch
+  std::map<int, std::pair<int, size_t>> bytesByTable_;
+};
+
+}  // namespace Fragmenter_Namespace
@@ -19,6 +19,11 @@
 
 namespace Fragmenter_Namespace {
 
+/// Reorders the values of column cd in data so that the i-th value is the indexes[i]-th
+void shuffleByIndexes(const ColumnDescriptor* cd,
+                      const std::vector<size_t>& indexes,
+                      DataBlockPtr& data);
+
 class SortedOrderFragmenter : public InsertOrderFragmenter {
  public:
   SortedOrderFragmenter(
@@ -32,7 +37,8 @@ class SortedOrderFragmenter : public InsertOrderFragmenter {
       const size_t maxChunkSize = DEFAULT_MAX_CHUNK_SIZE,
       const size_t pageSize = DEFAULT_PAGE_SIZE /*default 1MB*/,
       const size_t maxRows = DEFAULT_MAX_ROWS,
-      const Data_Namespace::MemoryLevel defaultInsertLevel = Data_Namespace::DISK_LEVEL)
+      const Data_Namespace::MemoryLevel defaultInsertLevel = Data_Namespace::DISK_LEVEL,
+      const TimePartitioning& partitioning = {})
       : InsertOrderFragmenter(chunkKeyPrefix,
                               chunkVec,
                               dataMgr,
@@ -43,7 +49,9 @@ class SortedOrderFragmenter : public InsertOrderFragmenter {
                               maxChunkSize,
                               pageSize,
                               maxRows,
-                              defaultInsertLevel) {}
+                              defaultInsertLevel,
+                              false,
+                              partitioning) {}
 
   ~SortedOrderFragmenter() override {}
   void insertData(InsertData& insertDataStruct) override {
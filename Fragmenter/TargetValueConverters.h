@@ -68,6 +68,16 @@ struct TargetValueConverter {
 
   virtual void convertToColumnarFormat(size_t row, const TargetValue* value) = 0;
 
+  //! Copies num_rows values of a column already in the layout of the converter, i.e.
+  //! the logical type of the target column or int32 ids for the dictionary encoded
+  //! strings, starting at row begin of column
+  virtual void convertColumnToColumnarFormat(const int8_t* column,
+                                             size_t begin,
+                                             size_t num_rows) {
+    throw std::runtime_error("Columnar conversion not supported for column " +
+                             column_descriptor_->columnName);
+  }
+
   virtual void finalizeDataBlocksForInsertData() {}
 
   virtual void addDataBlocksToInsertData(
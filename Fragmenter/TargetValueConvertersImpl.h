@@ -133,6 +133,14 @@ struct NumericValueConverter : public TargetValueConverter {
     convertToColumnarFormat(row, scalarValue);
   }
 
+  void convertColumnToColumnarFormat(const int8_t* column,
+                                     size_t begin,
+                                     size_t num_rows) override {
+    memcpy(column_data_.get(),
+           column + begin * sizeof(TARGET_TYPE),
+           num_rows * sizeof(TARGET_TYPE));
+  }
+
   void processArrayBuffer(
       std::unique_ptr<std::vector<std::pair<size_t, ElementsBufferColumnPtr>>>&
           array_buffer,
@@ -255,6 +263,14 @@ struct DictionaryValueConverter : public NumericValueConverter<int64_t, TARGET_T
     convertToColumnarFormat(row, scalarValue);
   }
 
+  // the null ids of the column are the buffer null sentinel already
+  void convertColumnToColumnarFormat(const int8_t* column,
+                                     size_t begin,
+                                     size_t num_rows) override {
+    const auto ids = reinterpret_cast<const int32_t*>(column) + begin;
+    std::copy(ids, ids + num_rows, column_buffer_->begin());
+  }
+
   inline int32_t convertTransientStringIdToPermanentId(int32_t& transient_string_id) {
     if (source_dict_proxy_) {
       auto str = source_dict_proxy_->getString(transient_string_id);
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TimePartition.h
+ * @brief   Range partitioning of the fragments of a table on a time column
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "Shared/sqltypes.h"
+
+namespace Fragmenter_Namespace {
+
+/**
+ * The range of values of a PARTITION_COLUMN which all rows of a fragment lie in. The
+ * rows with a null value have a partition of their own.
+ */
+struct TimePartition {
+  static constexpr int64_t kNullKey{std::numeric_limits<int64_t>::min()};
+
+  int columnId;
+  int64_t key;  // the index of the range from the epoch, kNullKey for nulls
+  int64_t firstValue;  // the range, in the units of the column
+  int64_t lastValue;
+
+  bool isNull() const { return key == kNullKey; }
+};
+
+/**
+ * How a table with a PARTITION_COLUMN splits its rows between fragments: every fragment
+ * only holds rows of one partition, and the partitions cover consecutive ranges of
+ * width values.
+ */
+struct TimePartitioning {
+  int columnId{0};      // 0 if the table is not partitioned
+  int64_t width{0};     // values of the column per partition
+  size_t retention{0};  // number of newest partitions kept, 0 for all
+
+  bool enabled() const { return columnId > 0; }
+
+  int64_t getKey(const int64_t value) const {
+    if (value == NULL_BIGINT) {
+      return TimePartition::kNullKey;
+    }
+    // rounds down for the values before the epoch
+    return value / width - (value % width < 0 ? 1 : 0);
+  }
+
+  TimePartition getPartition(const int64_t key) const {
+    if (key == TimePartition::kNullKey) {
+      return {columnId, key, NULL_BIGINT, NULL_BIGINT};
+    }
+    int64_t first_value;
+    int64_t last_value;
+    if (__builtin_mul_overflow(key, width, &first_value)) {
+      first_value = key < 0 ? std::numeric_limits<int64_t>::min() + 1
+                            : std::numeric_limits<int64_t>::max();
+    }
+    if (__builtin_add_overflow(first_value, width - 1, &last_value)) {
+      last_value = std::numeric_limits<int64_t>::max();
+    }
+    return {columnId, key, first_value, last_value};
+  }
+};
+
+// the values of the PARTITION_INTERVAL table option and their lengths in seconds
+constexpr std::array<std::pair<const char*, int64_t>, 3> kPartitionIntervals{
+    {{"HOUR", 3600}, {"DAY", 24 * 3600}, {"WEEK", 7 * 24 * 3600}}};
+
+/// Seconds per partition of the PARTITION_INTERVAL interval_upper, 0 if it is not one
+inline int64_t get_partition_interval_seconds(const std::string& interval_upper) {
+  for (const auto& interval : kPartitionIntervals) {
+    if (interval_upper == interval.first) {
+      return interval.second;
+    }
+  }
+  return 0;
+}
+
+inline std::string get_partition_interval_name(const int64_t seconds) {
+  for (const auto& interval : kPartitionIntervals) {
+    if (seconds == interval.second) {
+      return interval.first;
+    }
+  }
+  return std::to_string(seconds);
+}
+
+}  // namespace Fragmenter_Namespace
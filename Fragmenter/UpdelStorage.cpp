@@ -18,17 +18,21 @@
 #include <boost/variant/get.hpp>
 #include <limits>
 #include <mutex>
+#include <numeric>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "Catalog/Catalog.h"
 #include "DataMgr/DataMgr.h"
+#include "DataMgr/DiffEncoder.h"
 #include "DataMgr/FixedLengthArrayNoneEncoder.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/TargetValue.h"
 #include "Shared/DateConverters.h"
+#include "Shared/InlineNullValues.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/thread_count.h"
 #include "TargetValueConvertersFactories.h"
@@ -287,6 +291,43 @@ struct DateChunkConverter : public ChunkToInsertDataConverter {
   }
 };
 
+template <typename LOGICAL_DATA_TYPE>
+struct DiffChunkConverter : public ChunkToInsertDataConverter {
+  using ColumnDataPtr =
+      std::unique_ptr<LOGICAL_DATA_TYPE, CheckedMallocDeleter<LOGICAL_DATA_TYPE>>;
+
+  const Chunk_NS::Chunk* chunk_;
+  ColumnDataPtr column_data_;
+  const ColumnDescriptor* column_descriptor_;
+  std::vector<LOGICAL_DATA_TYPE> decoded_data_;
+
+  DiffChunkConverter(const size_t num_rows, const Chunk_NS::Chunk* chunk)
+      : chunk_(chunk), column_descriptor_(chunk->getColumnDesc()) {
+    column_data_ = ColumnDataPtr(reinterpret_cast<LOGICAL_DATA_TYPE*>(
+        checked_malloc(num_rows * sizeof(LOGICAL_DATA_TYPE))));
+    // the offsets are relative to the reference of the chunk, decode them all upfront
+    auto buffer = chunk->getBuffer();
+    decoded_data_.resize(buffer->encoder->getNumElems());
+    diff_decode_chunk(buffer->getMemoryPtr(),
+                      column_descriptor_->columnType.get_size(),
+                      decoded_data_.size(),
+                      decoded_data_.data());
+  }
+
+  ~DiffChunkConverter() override {}
+
+  void convertToColumnarFormat(size_t row, size_t indexInFragment) override {
+    column_data_.get()[row] = decoded_data_[indexInFragment];
+  }
+
+  void addDataBlocksToInsertData(Fragmenter_Namespace::InsertData& insertData) override {
+    DataBlockPtr dataBlock;
+    dataBlock.numbersPtr = reinterpret_cast<int8_t*>(column_data_.get());
+    insertData.data.push_back(dataBlock);
+    insertData.columnIds.push_back(column_descriptor_->columnId);
+  }
+};
+
 void InsertOrderFragmenter::updateColumns(
     const Catalog_Namespace::Catalog* catalog,
     const TableDescriptor* td,
@@ -342,6 +383,10 @@ void InsertOrderFragmenter::updateColumns(
 
       auto sourceDataMetaInfo = sourceMetaInfo[indexOfTargetColumn];
       auto targetDescriptor = columnDescriptors[indexOfTargetColumn];
+      if (targetDescriptor->columnType.get_compression() == kENCODING_DIFF) {
+        throw std::runtime_error("Updating Diff encoded column " +
+                                 targetDescriptor->columnName + " is not supported.");
+      }
 
       ConverterCreateParameter param{
           num_rows,
@@ -418,6 +463,22 @@ void InsertOrderFragmenter::updateColumns(
           CHECK(false);
         }
         chunkConverters.push_back(std::move(converter));
+      } else if (chunk_cd->columnType.get_compression() == kENCODING_DIFF) {
+        std::unique_ptr<ChunkToInsertDataConverter> converter;
+        const size_t logical_size = chunk_cd->columnType.get_logical_size();
+        if (logical_size == 8) {
+          converter =
+              std::make_unique<DiffChunkConverter<int64_t>>(num_rows, chunk.get());
+        } else if (logical_size == 4) {
+          converter =
+              std::make_unique<DiffChunkConverter<int32_t>>(num_rows, chunk.get());
+        } else if (logical_size == 2) {
+          converter =
+              std::make_unique<DiffChunkConverter<int16_t>>(num_rows, chunk.get());
+        } else {
+          CHECK(false);
+        }
+        chunkConverters.push_back(std::move(converter));
       } else {
         std::unique_ptr<ChunkToInsertDataConverter> converter;
         SQLTypeInfo logical_type = get_logical_type_info(chunk_cd->columnType);
@@ -599,6 +660,11 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
                                          const SQLTypeInfo& rhs_type,
                                          const Data_Namespace::MemoryLevel memory_level,
                                          UpdelRoll& updel_roll) {
+  if (cd->columnType.get_compression() == kENCODING_DIFF) {
+    // an updated value may not fit the range of the chunk
+    throw std::runtime_error("Updating Diff encoded column " + cd->columnName +
+                             " is not supported.");
+  }
   updel_roll.catalog = catalog;
   updel_roll.logicalTableId = catalog->getLogicalTableId(td->tableId);
   updel_roll.memoryLevel = memory_level;
@@ -921,6 +987,310 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
                        updel_roll);
 }
 
+namespace {
+
+template <typename T>
+T null_value() {
+  if constexpr (std::is_floating_point<T>::value) {
+    return inline_fp_null_value<T>();
+  } else {
+    return inline_int_null_value<T>();
+  }
+}
+
+// Whether the values of rhs_type in result set slots of rhs_width bytes are the values
+// of a chunk of lhs_type, up to truncating the slots, with lhs_dict_id the dictionary of
+// a string column
+bool is_columnar_update_possible(const SQLTypeInfo& lhs_type,
+                                 const int lhs_dict_id,
+                                 const SQLTypeInfo& rhs_type,
+                                 const size_t rhs_width) {
+  if (rhs_width < static_cast<size_t>(lhs_type.get_size()) ||
+      rhs_width > sizeof(int64_t)) {
+    return false;
+  }
+  if (lhs_type.is_string()) {
+    // ids of another or of the literal dictionary have to be translated
+    return lhs_type.get_compression() == kENCODING_DICT && lhs_dict_id > 0 &&
+           rhs_type.is_dict_encoded_string() &&
+           rhs_type.get_comp_param() == lhs_dict_id &&
+           (rhs_width == sizeof(int32_t) || rhs_width == sizeof(int64_t));
+  }
+  if (lhs_type.get_compression() != kENCODING_NONE ||
+      lhs_type.get_type() != rhs_type.get_type()) {
+    return false;
+  }
+  if (lhs_type.is_fp()) {
+    return rhs_width == sizeof(float) || rhs_width == sizeof(double);
+  }
+  return lhs_type.is_integer() || lhs_type.is_boolean() ||
+         (lhs_type.is_time() && lhs_type.get_dimension() == rhs_type.get_dimension());
+}
+
+// Whether a slot holds a transient string id, which is not in the column's dictionary
+template <typename SLOT_TYPE>
+bool has_transient_string_ids(const int8_t* slots, const size_t num_rows) {
+  const auto ids = reinterpret_cast<const SLOT_TYPE*>(slots);
+  return std::any_of(ids, ids + num_rows, [](const SLOT_TYPE id) {
+    return id < 0 && id != inline_int_null_value<SLOT_TYPE>();
+  });
+}
+
+// Copies the values of rows [begin, end) of a result set column of SLOT_TYPE slots to
+// the chunk data at their fragment offsets and tabulates their stats. A null is either
+// the null of the slots or that of T, as the query widens a narrower null or not
+// depending on the expression.
+template <typename T, typename SLOT_TYPE, typename STATS_TYPE>
+void copy_columnar_values(int8_t* chunk_data,
+                          const int8_t* slots,
+                          const int64_t* frag_offsets,
+                          const size_t begin,
+                          const size_t end,
+                          const ColumnDescriptor* cd,
+                          int8_t& has_null,
+                          STATS_TYPE& min,
+                          STATS_TYPE& max) {
+  auto data = reinterpret_cast<T*>(chunk_data);
+  const auto slot_values = reinterpret_cast<const SLOT_TYPE*>(slots);
+  const bool notnull = cd->columnType.get_notnull();
+  for (size_t r = begin; r < end; ++r) {
+    const auto slot_value = slot_values[r];
+    auto value = static_cast<T>(slot_value);
+    if (slot_value == null_value<SLOT_TYPE>() || value == null_value<T>()) {
+      if (notnull) {
+        throw std::runtime_error("NULL value on NOT NULL column '" + cd->columnName +
+                                 "'");
+      }
+      value = null_value<T>();
+      has_null = true;
+    } else {
+      min = std::min<STATS_TYPE>(min, value);
+      max = std::max<STATS_TYPE>(max, value);
+    }
+    data[frag_offsets[r]] = value;
+  }
+}
+
+template <typename T, typename STATS_TYPE>
+void copy_columnar_values(const size_t slot_width,
+                          int8_t* chunk_data,
+                          const int8_t* slots,
+                          const int64_t* frag_offsets,
+                          const size_t begin,
+                          const size_t end,
+                          const ColumnDescriptor* cd,
+                          int8_t& has_null,
+                          STATS_TYPE& min,
+                          STATS_TYPE& max) {
+  if constexpr (std::is_floating_point<T>::value) {
+    if (slot_width == sizeof(float)) {
+      copy_columnar_values<T, float>(
+          chunk_data, slots, frag_offsets, begin, end, cd, has_null, min, max);
+    } else {
+      CHECK_EQ(slot_width, sizeof(double));
+      copy_columnar_values<T, double>(
+          chunk_data, slots, frag_offsets, begin, end, cd, has_null, min, max);
+    }
+  } else {
+    switch (slot_width) {
+      case 1:
+        copy_columnar_values<T, int8_t>(
+            chunk_data, slots, frag_offsets, begin, end, cd, has_null, min, max);
+        break;
+      case 2:
+        copy_columnar_values<T, int16_t>(
+            chunk_data, slots, frag_offsets, begin, end, cd, has_null, min, max);
+        break;
+      case 4:
+        copy_columnar_values<T, int32_t>(
+            chunk_data, slots, frag_offsets, begin, end, cd, has_null, min, max);
+        break;
+      case 8:
+        copy_columnar_values<T, int64_t>(
+            chunk_data, slots, frag_offsets, begin, end, cd, has_null, min, max);
+        break;
+      default:
+        CHECK(false);
+    }
+  }
+}
+
+}  // namespace
+
+bool InsertOrderFragmenter::updateColumnFromColumnar(
+    const Catalog_Namespace::Catalog* catalog,
+    const TableDescriptor* td,
+    const ColumnDescriptor* cd,
+    const int fragment_id,
+    const int64_t* frag_offsets,
+    const int8_t* rhs_values,
+    const size_t rhs_width,
+    const size_t num_rows,
+    const SQLTypeInfo& rhs_type,
+    const Data_Namespace::MemoryLevel memory_level,
+    UpdelRoll& updel_roll) {
+  const auto& lhs_type = cd->columnType;
+  // the dictionary of a sharded string column is only set in the logical table
+  auto cdl = (shard_ < 0) ? cd
+                          : catalog->getMetadataForColumn(
+                                catalog->getLogicalTableId(td->tableId), cd->columnId);
+  CHECK(cdl);
+  if (!is_columnar_update_possible(
+          lhs_type, cdl->columnType.get_comp_param(), rhs_type, rhs_width)) {
+    return false;
+  }
+  if (lhs_type.is_string()) {
+    const bool has_transient_ids =
+        rhs_width == sizeof(int32_t)
+            ? has_transient_string_ids<int32_t>(rhs_values, num_rows)
+            : has_transient_string_ids<int64_t>(rhs_values, num_rows);
+    if (has_transient_ids) {
+      return false;
+    }
+  }
+  updel_roll.catalog = catalog;
+  updel_roll.logicalTableId = catalog->getLogicalTableId(td->tableId);
+  updel_roll.memoryLevel = memory_level;
+  if (0 == num_rows) {
+    return true;
+  }
+
+  auto fragment_ptr = getFragmentInfo(fragment_id);
+  auto& fragment = *fragment_ptr;
+  auto chunk_meta_it = fragment.getChunkMetadataMapPhysical().find(cd->columnId);
+  CHECK(chunk_meta_it != fragment.getChunkMetadataMapPhysical().end());
+  ChunkKey chunk_key{
+      catalog->getCurrentDB().dbId, td->tableId, cd->columnId, fragment.fragmentId};
+  auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                         &catalog->getDataMgr(),
+                                         chunk_key,
+                                         Data_Namespace::CPU_LEVEL,
+                                         0,
+                                         chunk_meta_it->second->numBytes,
+                                         chunk_meta_it->second->numElements);
+  auto dbuf = chunk->getBuffer();
+  auto dbuf_addr = dbuf->getMemoryPtr();
+  dbuf->setUpdated();
+  {
+    std::lock_guard<std::mutex> lck(updel_roll.mutex);
+    if (updel_roll.dirtyChunks.count(chunk.get()) == 0) {
+      updel_roll.dirtyChunks.emplace(chunk.get(), chunk);
+    }
+    updel_roll.dirtyChunkeys.insert(chunk_key);
+  }
+
+  const size_t ncore = cpu_threads();
+  std::vector<int8_t> has_null_per_thread(ncore, 0);
+  std::vector<double> max_double_per_thread(ncore, std::numeric_limits<double>::lowest());
+  std::vector<double> min_double_per_thread(ncore, std::numeric_limits<double>::max());
+  std::vector<int64_t> max_int64t_per_thread(ncore, std::numeric_limits<int64_t>::min());
+  std::vector<int64_t> min_int64t_per_thread(ncore, std::numeric_limits<int64_t>::max());
+
+  std::vector<std::future<void>> threads;
+  const auto segsz = (num_rows + ncore - 1) / ncore;
+  for (size_t rbegin = 0, c = 0; rbegin < num_rows; ++c, rbegin += segsz) {
+    threads.emplace_back(std::async(std::launch::async, [&, rbegin, c] {
+      const auto rend = std::min(rbegin + segsz, num_rows);
+      auto copy_int_values = [&](auto null) {
+        copy_columnar_values<decltype(null)>(rhs_width,
+                                             dbuf_addr,
+                                             rhs_values,
+                                             frag_offsets,
+                                             rbegin,
+                                             rend,
+                                             cd,
+                                             has_null_per_thread[c],
+                                             min_int64t_per_thread[c],
+                                             max_int64t_per_thread[c]);
+      };
+      if (lhs_type.get_type() == kFLOAT) {
+        copy_columnar_values<float>(rhs_width,
+                                    dbuf_addr,
+                                    rhs_values,
+                                    frag_offsets,
+                                    rbegin,
+                                    rend,
+                                    cd,
+                                    has_null_per_thread[c],
+                                    min_double_per_thread[c],
+                                    max_double_per_thread[c]);
+      } else if (lhs_type.get_type() == kDOUBLE) {
+        copy_columnar_values<double>(rhs_width,
+                                     dbuf_addr,
+                                     rhs_values,
+                                     frag_offsets,
+                                     rbegin,
+                                     rend,
+                                     cd,
+                                     has_null_per_thread[c],
+                                     min_double_per_thread[c],
+                                     max_double_per_thread[c]);
+      } else if (lhs_type.is_string()) {
+        // narrow string ids are unsigned
+        switch (lhs_type.get_size()) {
+          case 1:
+            copy_int_values(uint8_t());
+            break;
+          case 2:
+            copy_int_values(uint16_t());
+            break;
+          case 4:
+            copy_int_values(int32_t());
+            break;
+          default:
+            CHECK(false);
+        }
+      } else {
+        switch (lhs_type.get_size()) {
+          case 1:
+            copy_int_values(int8_t());
+            break;
+          case 2:
+            copy_int_values(int16_t());
+            break;
+          case 4:
+            copy_int_values(int32_t());
+            break;
+          case 8:
+            copy_int_values(int64_t());
+            break;
+          default:
+            CHECK(false);
+        }
+      }
+    }));
+  }
+  wait_cleanup_threads(threads);
+
+  bool has_null_per_chunk{false};
+  double max_double_per_chunk{std::numeric_limits<double>::lowest()};
+  double min_double_per_chunk{std::numeric_limits<double>::max()};
+  int64_t max_int64t_per_chunk{std::numeric_limits<int64_t>::min()};
+  int64_t min_int64t_per_chunk{std::numeric_limits<int64_t>::max()};
+  for (size_t c = 0; c < ncore; ++c) {
+    has_null_per_chunk = has_null_per_chunk || has_null_per_thread[c];
+    max_double_per_chunk =
+        std::max<double>(max_double_per_chunk, max_double_per_thread[c]);
+    min_double_per_chunk =
+        std::min<double>(min_double_per_chunk, min_double_per_thread[c]);
+    max_int64t_per_chunk =
+        std::max<int64_t>(max_int64t_per_chunk, max_int64t_per_thread[c]);
+    min_int64t_per_chunk =
+        std::min<int64_t>(min_int64t_per_chunk, min_int64t_per_thread[c]);
+  }
+  updateColumnMetadata(cd,
+                       fragment,
+                       chunk,
+                       has_null_per_chunk,
+                       max_double_per_chunk,
+                       min_double_per_chunk,
+                       max_int64t_per_chunk,
+                       min_int64t_per_chunk,
+                       cd->columnType,
+                       updel_roll);
+  return true;
+}
+
 void InsertOrderFragmenter::updateColumnMetadata(const ColumnDescriptor* cd,
                                                  FragmentInfo& fragment,
                                                  std::shared_ptr<Chunk_NS::Chunk> chunk,
@@ -981,6 +1351,7 @@ void InsertOrderFragmenter::updateMetadata(const Catalog_Namespace::Catalog* cat
                                            const MetaDataKey& key,
                                            UpdelRoll& updel_roll) {
   mapd_unique_lock<mapd_shared_mutex> writeLock(fragmentInfoMutex_);
+  invalidateContents();
   if (updel_roll.chunkMetadata.count(key)) {
     auto& fragmentInfo = *key.second;
     const auto& chunkMetadata = updel_roll.chunkMetadata[key];
@@ -1102,6 +1473,11 @@ auto InsertOrderFragmenter::vacuum_fixlen_rows(
   int64_t irow_of_blk_to_keep = 0;  // head of next row block to keep
   int64_t irow_of_blk_to_fill = 0;  // row offset to fit the kept block
   size_t nbytes_fix_data_to_keep = 0;
+  if (col_type.get_compression() == kENCODING_DIFF) {
+    // the reference stays, the offsets from it are moved
+    data_addr += kDiffEncodingHeaderSize;
+    nbytes_fix_data_to_keep = kDiffEncodingHeaderSize;
+  }
   auto nrows_to_vacuum = frag_offsets.size();
   auto nrows_in_fragment = fragment.getPhysicalNumTuples();
   for (size_t irow = 0; irow <= nrows_to_vacuum; irow++) {
@@ -1233,6 +1609,18 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
 
       set_chunk_metadata(catalog, fragment, chunk, nrows_to_keep, updel_roll);
 
+      if (col_type.get_compression() == kENCODING_DIFF) {
+        std::vector<int64_t> values(nrows_to_keep);
+        diff_decode_chunk(data_addr, col_type.get_size(), nrows_to_keep, values.data());
+        for (const auto value : values) {
+          if (value == inline_int_null_value<int64_t>()) {
+            has_null_per_thread[ci] = has_null_per_thread[ci] || !col_type.get_notnull();
+          } else {
+            set_minmax(min_int64t_per_thread[ci], max_int64t_per_thread[ci], value);
+          }
+        }
+        return;
+      }
       auto daddr = data_addr;
       auto element_size =
           col_type.is_fixlen_array() ? col_type.get_size() : get_element_size(col_type);
@@ -1306,6 +1694,235 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
   }
 }
 
+template <typename V>
+static void get_stored_sort_keys(const int8_t* data_addr,
+                                 const size_t nrows,
+                                 std::vector<int64_t>& keys) {
+  const auto values = reinterpret_cast<const V*>(data_addr);
+  for (size_t irow = 0; irow < nrows; ++irow) {
+    keys[irow] = values[irow];
+  }
+}
+
+// values of an integer or time chunk in the order of its rows, with the nulls smallest
+static std::vector<int64_t> get_sort_keys(const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                                          const size_t nrows) {
+  const auto& col_type = chunk->getColumnDesc()->columnType;
+  const auto data_addr = chunk->getBuffer()->getMemoryPtr();
+  std::vector<int64_t> keys(nrows);
+  if (col_type.get_compression() == kENCODING_DIFF) {
+    diff_decode_chunk(data_addr, col_type.get_size(), nrows, keys.data());
+    return keys;
+  }
+  // nulls are stored as the minimum of the stored type
+  switch (col_type.get_size()) {
+    case 1:
+      get_stored_sort_keys<int8_t>(data_addr, nrows, keys);
+      break;
+    case 2:
+      get_stored_sort_keys<int16_t>(data_addr, nrows, keys);
+      break;
+    case 4:
+      get_stored_sort_keys<int32_t>(data_addr, nrows, keys);
+      break;
+    case 8:
+      get_stored_sort_keys<int64_t>(data_addr, nrows, keys);
+      break;
+    default:
+      CHECK(false);
+  }
+  return keys;
+}
+
+static void sort_fixlen_rows(const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                             const std::vector<size_t>& permutation) {
+  const auto& col_type = chunk->getColumnDesc()->columnType;
+  auto data_addr = chunk->getBuffer()->getMemoryPtr();
+  if (col_type.get_compression() == kENCODING_DIFF) {
+    // the reference stays, the offsets from it are moved
+    data_addr += kDiffEncodingHeaderSize;
+  }
+  const size_t element_size =
+      col_type.is_fixlen_array() ? col_type.get_size() : get_element_size(col_type);
+  std::vector<int8_t> sorted_data(permutation.size() * element_size);
+  for (size_t irow = 0; irow < permutation.size(); ++irow) {
+    memcpy(&sorted_data[irow * element_size],
+           data_addr + permutation[irow] * element_size,
+           element_size);
+  }
+  memcpy(data_addr, sorted_data.data(), sorted_data.size());
+}
+
+static void sort_varlen_rows(const std::shared_ptr<Chunk_NS::Chunk>& chunk,
+                             const std::vector<size_t>& permutation) {
+  const auto data_addr = chunk->getBuffer()->getMemoryPtr();
+  const auto index_array = (StringOffsetT*)chunk->getIndexBuf()->getMemoryPtr();
+  std::vector<int8_t> sorted_data(chunk->getBuffer()->size());
+  std::vector<StringOffsetT> sorted_index(permutation.size() + 1);
+  size_t nbytes = 0;
+  for (size_t irow = 0; irow < permutation.size(); ++irow) {
+    const auto offset = index_array[permutation[irow]];
+    const size_t length = index_array[permutation[irow] + 1] - offset;
+    sorted_index[irow] = nbytes;
+    memcpy(&sorted_data[nbytes], data_addr + offset, length);
+    nbytes += length;
+  }
+  sorted_index[permutation.size()] = nbytes;
+  memcpy(data_addr, sorted_data.data(), nbytes);
+  memcpy(index_array, sorted_index.data(), sorted_index.size() * sizeof(StringOffsetT));
+}
+
+bool InsertOrderFragmenter::sortRows(const Catalog_Namespace::Catalog* catalog,
+                                     const TableDescriptor* td,
+                                     const int fragment_id,
+                                     const ColumnDescriptor* sort_cd,
+                                     const Data_Namespace::MemoryLevel memory_level,
+                                     UpdelRoll& updel_roll) {
+  CHECK(sort_cd->columnType.is_integer() || sort_cd->columnType.is_time());
+  auto fragment_ptr = getFragmentInfo(fragment_id);
+  auto& fragment = *fragment_ptr;
+  const auto nrows = fragment.getPhysicalNumTuples();
+  if (nrows < 2) {
+    return false;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+  const auto sort_meta_it = chunk_metadata_map.find(sort_cd->columnId);
+  CHECK(sort_meta_it != chunk_metadata_map.end());
+  // only the sort column is read if the rows are sorted already
+  const auto sort_chunk = Chunk_NS::Chunk::getChunk(
+      sort_cd,
+      &catalog_->getDataMgr(),
+      {catalog_->getCurrentDB().dbId, td->tableId, sort_cd->columnId, fragment_id},
+      memory_level,
+      0,
+      sort_meta_it->second->numBytes,
+      sort_meta_it->second->numElements);
+  const auto keys = get_sort_keys(sort_chunk, nrows);
+  if (std::is_sorted(keys.begin(), keys.end())) {
+    return false;
+  }
+  auto chunks = getChunksForAllColumns(td, fragment, memory_level);
+  for (const auto& chunk : chunks) {
+    const auto& col_type = chunk->getColumnDesc()->columnType;
+    // the offsets of varlen arrays encode their nulls, geo columns are made of them
+    if (col_type.is_geometry() ||
+        (col_type.is_varlen_indeed() && !col_type.is_string())) {
+      return false;
+    }
+  }
+  std::vector<size_t> permutation(nrows);
+  std::iota(permutation.begin(), permutation.end(), 0);
+  std::stable_sort(permutation.begin(), permutation.end(), [&keys](size_t a, size_t b) {
+    return keys[a] < keys[b];
+  });
+
+  std::vector<std::future<void>> threads;
+  for (const auto& chunk : chunks) {
+    threads.emplace_back(std::async(std::launch::async, [=, &permutation, &updel_roll] {
+      if (chunk->getColumnDesc()->columnType.is_varlen_indeed()) {
+        sort_varlen_rows(chunk, permutation);
+        chunk->getIndexBuf()->setUpdated();
+      } else {
+        sort_fixlen_rows(chunk, permutation);
+      }
+      chunk->getBuffer()->setUpdated();
+      set_chunk_metadata(catalog, fragment, chunk, nrows, updel_roll);
+    }));
+    if (threads.size() >= (size_t)cpu_threads()) {
+      wait_cleanup_threads(threads);
+    }
+  }
+  wait_cleanup_threads(threads);
+
+  // the chunk stats and Bloom filters hold for any order of the rows, the block zone
+  // maps do not
+  const auto key = std::make_pair(td, &fragment);
+  updel_roll.numTuples[key] = nrows;
+  for (const auto& chunk_metadata : updel_roll.chunkMetadata[key]) {
+    std::atomic_store(&chunk_metadata.second->blockStats,
+                      std::shared_ptr<const ChunkBlockStats>());
+  }
+  // copies on the GPUs are in the old order
+  for (const auto& chunk : chunks) {
+    updel_roll.dirtyChunkeys.insert({catalog->getCurrentDB().dbId,
+                                     td->tableId,
+                                     chunk->getColumnDesc()->columnId,
+                                     fragment_id});
+  }
+  return true;
+}
+
+namespace {
+
+// The rows of a fragment to move, as rows of their fragment offset only
+class FragmentOffsetsProvider : public RowDataProvider {
+ public:
+  explicit FragmentOffsetsProvider(std::vector<uint64_t> frag_offsets)
+      : frag_offsets_(std::move(frag_offsets)) {}
+
+  size_t const getRowCount() const override { return frag_offsets_.size(); }
+  size_t const getEntryCount() const override { return frag_offsets_.size(); }
+  StringDictionaryProxy* getLiteralDictionary() const override { return nullptr; }
+
+  std::vector<TargetValue> getEntryAt(const size_t index) const override {
+    return {ScalarTargetValue(static_cast<int64_t>(frag_offsets_[index]))};
+  }
+
+  std::vector<TargetValue> getTranslatedEntryAt(const size_t index) const override {
+    return getEntryAt(index);
+  }
+
+ private:
+  const std::vector<uint64_t> frag_offsets_;
+};
+
+}  // namespace
+
+size_t InsertOrderFragmenter::moveFragmentRows(
+    const Catalog_Namespace::Catalog* catalog,
+    const TableDescriptor* td,
+    const int fragment_id,
+    const Data_Namespace::MemoryLevel memory_level,
+    UpdelRoll& updel_roll) {
+  const auto deleted_cd = catalog->getDeletedColumn(td);
+  CHECK(deleted_cd);
+  auto fragment = getFragmentInfo(fragment_id);
+  CHECK(fragment);
+  auto chunk_meta_it = fragment->getChunkMetadataMapPhysical().find(deleted_cd->columnId);
+  CHECK(chunk_meta_it != fragment->getChunkMetadataMapPhysical().end());
+  const auto deleted_chunk =
+      Chunk_NS::Chunk::getChunk(deleted_cd,
+                                &catalog->getDataMgr(),
+                                {catalog->getCurrentDB().dbId,
+                                 td->tableId,
+                                 deleted_cd->columnId,
+                                 fragment_id},
+                                memory_level,
+                                0,
+                                chunk_meta_it->second->numBytes,
+                                chunk_meta_it->second->numElements);
+  const auto deleted = deleted_chunk->getBuffer()->getMemoryPtr();
+  std::vector<uint64_t> frag_offsets;
+  for (size_t r = 0; r < chunk_meta_it->second->numElements; ++r) {
+    if (!deleted[r]) {
+      frag_offsets.push_back(r);
+    }
+  }
+  const auto num_rows_moved = frag_offsets.size();
+  // an update of no column appends the rows unchanged and deletes them in place
+  updateColumns(catalog,
+                td,
+                fragment_id,
+                {},
+                {},
+                FragmentOffsetsProvider(std::move(frag_offsets)),
+                0,
+                memory_level,
+                updel_roll,
+                nullptr);
+  return num_rows_moved;
+}
+
 }  // namespace Fragmenter_Namespace
 
 void UpdelRoll::commitUpdate() {
@@ -68,6 +68,13 @@ struct CopyParams {
   size_t retry_wait;
   size_t batch_size;
   size_t buffer_size;
+  // params of kafka streams ingested by the server
+  // of COPY FROM kafka://, see StreamIngestor
+  std::string kafka_group_id;  // consumer group the committed offsets are reported to
+  bool kafka_from_latest = false;  // start uncommitted partitions at their end
+  size_t kafka_consumers = 0;      // 0 for one per partition, up to the cpu threads
+  size_t kafka_batch_ms = 100;     // longest a consumed row waits for its commit
+  size_t kafka_batch_rows = 1 << 20;  // rows a consumer buffers before it waits
   // geospatial params
   bool lonlat;
   EncodingType geo_coords_encoding;
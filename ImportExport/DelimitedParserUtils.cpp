@@ -22,12 +22,147 @@
 
 #include "ImportExport/DelimitedParserUtils.h"
 
+#include <array>
 #include <string_view>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 #include "Logger/Logger.h"
 #include "StringDictionary/StringDictionary.h"
 
 namespace {
+#if defined(__x86_64__)
+bool cpu_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+// Bit i is set if block[i] is one of bytes
+__attribute__((target("avx2"))) uint32_t find_bytes_avx2(const char* block,
+                                                        const char* bytes,
+                                                        const size_t num_bytes) {
+  const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  __m256i matches = _mm256_setzero_si256();
+  for (size_t i = 0; i < num_bytes; ++i) {
+    matches =
+        _mm256_or_si256(matches, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(bytes[i])));
+  }
+  return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+}
+#endif
+
+// Bit i is the parity of bits 0 to i of mask
+inline uint32_t prefix_xor(uint32_t mask) {
+  mask ^= mask << 1;
+  mask ^= mask << 2;
+  mask ^= mask << 4;
+  mask ^= mask << 8;
+  mask ^= mask << 16;
+  return mask;
+}
+
+/**
+ * Finds the next byte of a buffer which is one of a few structural bytes, such as
+ * delimiters and quotes. As in simdjson, the structural bytes of 32 byte blocks are
+ * found at once with AVX2 into a bit mask, which the later lookups in the block read.
+ * The bytes in between are skipped without looking at them one at a time.
+ */
+class StructuralByteScanner {
+ public:
+  static constexpr size_t kMaxNumBytes{8};
+  static constexpr ptrdiff_t kBlockSize{32};
+
+  StructuralByteScanner(const char* end) : end_(end) {
+#if defined(__x86_64__)
+    use_avx2_ = cpu_has_avx2();
+#endif
+  }
+
+  void addByte(const char byte) {
+    CHECK_LT(num_bytes_, kMaxNumBytes);
+    bytes_[num_bytes_++] = byte;
+  }
+
+  // The first structural byte at or after p, or the end of the buffer
+  const char* next(const char* p) {
+    while (true) {
+      if (block_ && p >= block_ && p < block_ + kBlockSize) {
+        const uint32_t mask = mask_ & (~uint32_t(0) << (p - block_));
+        if (mask) {
+          return block_ + __builtin_ctz(mask);
+        }
+        p = block_ + kBlockSize;
+      }
+      if (!use_avx2_ || end_ - p < kBlockSize) {
+        while (p < end_ && !isStructural(*p)) {
+          ++p;
+        }
+        return p;
+      }
+#if defined(__x86_64__)
+      block_ = p;
+      mask_ = find_bytes_avx2(p, bytes_.data(), num_bytes_);
+#endif
+    }
+  }
+
+ private:
+  bool isStructural(const char c) const {
+    for (size_t i = 0; i < num_bytes_; ++i) {
+      if (c == bytes_[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const char* end_;
+  std::array<char, kMaxNumBytes> bytes_;
+  size_t num_bytes_{0};
+  bool use_avx2_{false};
+  const char* block_{nullptr};
+  uint32_t mask_{0};
+};
+
+/**
+ * Runs the search of find_end() over the first whole 32 byte blocks of
+ * [current, buffer + size), and returns the end of the blocks. Quotes are tracked by
+ * the parity of the quotes before every byte, which only matches find_end() if quotes
+ * are escaped by doubling them, i.e. escape is the quote character.
+ */
+const char* find_end_in_blocks(const char* buffer,
+                               const size_t size,
+                               const char* current,
+                               const import_export::CopyParams& copy_params,
+                               unsigned int& num_rows_this_buffer,
+                               bool& in_quote,
+                               size_t& last_line_delim_pos) {
+#if defined(__x86_64__)
+  if (!cpu_has_avx2()) {
+    return current;
+  }
+  const char line_delim = copy_params.line_delim;
+  const char quote = copy_params.quote;
+  for (; buffer + size - current >= StructuralByteScanner::kBlockSize;
+       current += StructuralByteScanner::kBlockSize) {
+    uint32_t line_delim_mask = find_bytes_avx2(current, &line_delim, 1);
+    if (copy_params.quoted) {
+      const uint32_t quote_mask = find_bytes_avx2(current, &quote, 1);
+      const uint32_t quoted_mask = prefix_xor(quote_mask) ^ (in_quote ? ~0U : 0U);
+      line_delim_mask &= ~quoted_mask;
+      in_quote ^= __builtin_popcount(quote_mask) & 1;
+    }
+    if (line_delim_mask) {
+      num_rows_this_buffer += __builtin_popcount(line_delim_mask);
+      last_line_delim_pos = current - buffer + 31 - __builtin_clz(line_delim_mask);
+    }
+  }
+#endif
+  return current;
+}
+
 inline bool is_eol(const char& c, const import_export::CopyParams& copy_params) {
   return c == copy_params.line_delim || c == '\n' || c == '\r';
 }
@@ -85,6 +220,15 @@ size_t find_end(const char* buffer,
                 size_t offset) {
   size_t last_line_delim_pos = 0;
   const char* current = buffer + offset;
+  if (!copy_params.quoted || copy_params.escape == copy_params.quote) {
+    current = find_end_in_blocks(buffer,
+                                 size,
+                                 current,
+                                 copy_params,
+                                 num_rows_this_buffer,
+                                 in_quote,
+                                 last_line_delim_pos);
+  }
   if (copy_params.quoted) {
     while (current < buffer + size) {
       while (!in_quote && current < buffer + size) {
@@ -212,7 +356,22 @@ const char* get_row(const char* buf,
   bool has_escape = false;
   bool strip_quotes = false;
   try_single_thread = false;
+  // The bytes which are none of these are only part of fields, and are skipped.
+  StructuralByteScanner scanner(entire_buf_end);
+  scanner.addByte(copy_params.escape);
+  scanner.addByte(copy_params.quote);
+  scanner.addByte(copy_params.delimiter);
+  scanner.addByte(copy_params.line_delim);
+  scanner.addByte('\n');
+  scanner.addByte('\r');
+  if (is_array != nullptr) {
+    scanner.addByte(copy_params.array_begin);
+  }
   for (p = buf; p < entire_buf_end; ++p) {
+    p = scanner.next(p);
+    if (p == entire_buf_end) {
+      break;
+    }
     if (*p == copy_params.escape && p < entire_buf_end - 1 &&
         *(p + 1) == copy_params.quote) {
       p++;
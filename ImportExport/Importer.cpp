@@ -23,6 +23,7 @@
 #include "ImportExport/Importer.h"
 
 #include <arrow/api.h>
+#include <arrow/array/concatenate.h>
 #include <arrow/io/api.h>
 #include <gdal.h>
 #include <ogrsf_frmts.h>
@@ -31,6 +32,8 @@
 #include <boost/dynamic_bitset.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/variant.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
@@ -41,9 +44,12 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <queue>
+#include <random>
 #include <stack>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
@@ -57,7 +63,10 @@
 #include "ImportExport/GDAL.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/TypePunning.h"
+#include "Shared/ArrowUtil.h"
+#include "Shared/Metrics.h"
 #include "Shared/SqlTypesLayout.h"
+#include "Shared/StringTransform.h"
 #include "Shared/geo_compression.h"
 #include "Shared/geo_types.h"
 #include "Shared/geosupport.h"
@@ -74,6 +83,9 @@
 #include "gen-cpp/OmniSci.h"
 
 size_t g_archive_read_buf_size = 1 << 20;
+size_t g_import_read_ahead_buffers{2};
+size_t g_import_dict_encoder_threads{2};
+size_t g_detect_sample_blocks{16};
 
 inline auto get_filesize(const std::string& file_path) {
   boost::filesystem::path boost_file_path{file_path};
@@ -112,6 +124,12 @@ struct OGRSpatialReferenceDeleter {
 using OGRSpatialReferenceUqPtr =
     std::unique_ptr<OGRSpatialReference, OGRSpatialReferenceDeleter>;
 
+// std::atof() of str, which only copies str when the fast path cannot parse it
+double parse_double(const std::string_view str) {
+  double value;
+  return parse_double_fast(str, value) ? value : std::atof(std::string(str).c_str());
+}
+
 }  // namespace
 
 // For logging std::vector<std::string> row.
@@ -496,6 +514,20 @@ void TypedImportBuffer::addDictEncodedString(const std::vector<std::string>& str
   }
 }
 
+void TypedImportBuffer::encodeDictStrings() {
+  if (dict_encoded_) {
+    return;
+  }
+  const auto& ti = getTypeInfo();
+  if (ti.is_string() && ti.get_compression() == kENCODING_DICT) {
+    addDictEncodedString(*string_buffer_);
+  } else if (ti.get_type() == kARRAY && IS_STRING(ti.get_subtype())) {
+    CHECK_EQ(kENCODING_DICT, ti.get_compression());
+    addDictEncodedStringArray(*string_array_buffer_);
+  }
+  dict_encoded_ = true;
+}
+
 void TypedImportBuffer::add_value(const ColumnDescriptor* cd,
                                   const std::string_view val,
                                   const bool is_null,
@@ -587,7 +619,7 @@ void TypedImportBuffer::add_value(const ColumnDescriptor* cd,
     }
     case kFLOAT:
       if (!is_null && (val[0] == '.' || isdigit(val[0]) || val[0] == '-')) {
-        addFloat(static_cast<float>(std::atof(std::string(val).c_str())));
+        addFloat(static_cast<float>(parse_double(val)));
       } else {
         if (cd->columnType.get_notnull()) {
           throw std::runtime_error("NULL for column " + cd->columnName);
@@ -597,7 +629,7 @@ void TypedImportBuffer::add_value(const ColumnDescriptor* cd,
       break;
     case kDOUBLE:
       if (!is_null && (val[0] == '.' || isdigit(val[0]) || val[0] == '-')) {
-        addDouble(std::atof(std::string(val).c_str()));
+        addDouble(parse_double(val));
       } else {
         if (cd->columnType.get_notnull()) {
           throw std::runtime_error("NULL for column " + cd->columnName);
@@ -846,6 +878,51 @@ size_t TypedImportBuffer::convert_arrow_val_to_import_buffer(
   return buffer.size();
 }
 
+namespace {
+
+// Appends a slice of an Arrow array whose values are of the buffer's type with a single
+// copy, rather than converting them one at a time, then writes the nulls over. The
+// lowest value of a narrower integer type is its null sentinel, and a bad row as in the
+// conversion of ArrowValue<int64_t>.
+template <typename DATA_TYPE>
+size_t copy_fixed_width_arrow_values(const ColumnDescriptor* cd,
+                                     const Array& array,
+                                     std::vector<DATA_TYPE>& buffer,
+                                     const ArraySliceRange& slice_range,
+                                     BadRowsTracker* const bad_rows_tracker) {
+  CHECK_LE(slice_range.second, static_cast<size_t>(array.length()));
+  const auto values = array.data()->GetValues<DATA_TYPE>(1);
+  const size_t old_size = buffer.size();
+  buffer.insert(buffer.end(), values + slice_range.first, values + slice_range.second);
+  DATA_TYPE null_value;
+  if constexpr (std::is_floating_point<DATA_TYPE>::value) {
+    null_value = inline_fp_null_val(cd->columnType);
+  } else {
+    null_value = inline_fixed_encoding_null_val(cd->columnType);
+  }
+  constexpr bool check_null_sentinel =
+      std::is_integral<DATA_TYPE>::value && !std::is_same<DATA_TYPE, int64_t>::value;
+  if (!check_null_sentinel && array.null_count() == 0) {
+    return buffer.size();
+  }
+  for (size_t row = slice_range.first; row < slice_range.second; ++row) {
+    auto& value = buffer[old_size + row - slice_range.first];
+    if (array.IsNull(row)) {
+      value = null_value;
+    } else if (check_null_sentinel && value == std::numeric_limits<DATA_TYPE>::lowest()) {
+      if (!bad_rows_tracker) {
+        data_conversion_error<DATA_TYPE>(value, cd, bad_rows_tracker);
+      }
+      value = null_value;
+      std::unique_lock<std::mutex> lck(bad_rows_tracker->mutex);
+      bad_rows_tracker->rows.insert(row - slice_range.first);
+    }
+  }
+  return buffer.size();
+}
+
+}  // namespace
+
 size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
                                            const Array& col,
                                            const bool exact_type_match,
@@ -868,18 +945,30 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT8, "Expected int8 type");
       }
+      if (col.type_id() == Type::INT8) {
+        return copy_fixed_width_arrow_values(
+            cd, col, *tinyint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *tinyint_buffer_, slice_range, bad_rows_tracker);
     case kSMALLINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT16, "Expected int16 type");
       }
+      if (col.type_id() == Type::INT16) {
+        return copy_fixed_width_arrow_values(
+            cd, col, *smallint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *smallint_buffer_, slice_range, bad_rows_tracker);
     case kINT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT32, "Expected int32 type");
       }
+      if (col.type_id() == Type::INT32) {
+        return copy_fixed_width_arrow_values(
+            cd, col, *int_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *int_buffer_, slice_range, bad_rows_tracker);
     case kBIGINT:
@@ -888,18 +977,30 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::INT64, "Expected int64 type");
       }
+      if (type == kBIGINT && col.type_id() == Type::INT64) {
+        return copy_fixed_width_arrow_values(
+            cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *bigint_buffer_, slice_range, bad_rows_tracker);
     case kFLOAT:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::FLOAT, "Expected float type");
       }
+      if (col.type_id() == Type::FLOAT) {
+        return copy_fixed_width_arrow_values(
+            cd, col, *float_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *float_buffer_, slice_range, bad_rows_tracker);
     case kDOUBLE:
       if (exact_type_match) {
         arrow_throw_if(col.type_id() != Type::DOUBLE, "Expected double type");
       }
+      if (col.type_id() == Type::DOUBLE) {
+        return copy_fixed_width_arrow_values(
+            cd, col, *double_buffer_, slice_range, bad_rows_tracker);
+      }
       return convert_arrow_val_to_import_buffer(
           cd, col, *double_buffer_, slice_range, bad_rows_tracker);
     case kTEXT:
@@ -946,6 +1047,36 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
   }
 }
 
+namespace {
+
+// The values of a TColumn are all int64_t or double on the wire: they're copied at once
+// into a buffer of the same type, cast in a loop the compiler vectorizes into a narrower
+// one, and the nulls patched in after instead of checked value by value
+template <typename T, typename V>
+void append_columnar_values(std::vector<T>& buffer,
+                            const std::vector<V>& values,
+                            const std::vector<bool>& nulls,
+                            const T null_value) {
+  const size_t offset = buffer.size();
+  if constexpr (std::is_same_v<T, V>) {
+    buffer.insert(buffer.end(), values.begin(), values.end());
+  } else {
+    buffer.resize(offset + values.size());
+    T* out = buffer.data() + offset;
+    for (size_t i = 0; i < values.size(); ++i) {
+      out[i] = static_cast<T>(values[i]);
+    }
+  }
+  const size_t num_nulls = std::min(nulls.size(), values.size());
+  for (size_t i = 0; i < num_nulls; ++i) {
+    if (nulls[i]) {
+      buffer[offset + i] = null_value;
+    }
+  }
+}
+
+}  // namespace
+
 // this is exclusively used by load_table_binary_columnar
 size_t TypedImportBuffer::add_values(const ColumnDescriptor* cd, const TColumn& col) {
   size_t dataSize = 0;
@@ -959,88 +1090,54 @@ size_t TypedImportBuffer::add_values(const ColumnDescriptor* cd, const TColumn&
   switch (cd->columnType.get_type()) {
     case kBOOLEAN: {
       dataSize = col.data.int_col.size();
-      bool_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          bool_buffer_->push_back(inline_fixed_encoding_null_val(cd->columnType));
-        } else {
-          bool_buffer_->push_back((int8_t)col.data.int_col[i]);
-        }
-      }
+      append_columnar_values(*bool_buffer_,
+                             col.data.int_col,
+                             col.nulls,
+                             int8_t(inline_fixed_encoding_null_val(cd->columnType)));
       break;
     }
     case kTINYINT: {
       dataSize = col.data.int_col.size();
-      tinyint_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          tinyint_buffer_->push_back(inline_fixed_encoding_null_val(cd->columnType));
-        } else {
-          tinyint_buffer_->push_back((int8_t)col.data.int_col[i]);
-        }
-      }
+      append_columnar_values(*tinyint_buffer_,
+                             col.data.int_col,
+                             col.nulls,
+                             int8_t(inline_fixed_encoding_null_val(cd->columnType)));
       break;
     }
     case kSMALLINT: {
       dataSize = col.data.int_col.size();
-      smallint_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          smallint_buffer_->push_back(inline_fixed_encoding_null_val(cd->columnType));
-        } else {
-          smallint_buffer_->push_back((int16_t)col.data.int_col[i]);
-        }
-      }
+      append_columnar_values(*smallint_buffer_,
+                             col.data.int_col,
+                             col.nulls,
+                             int16_t(inline_fixed_encoding_null_val(cd->columnType)));
       break;
     }
     case kINT: {
       dataSize = col.data.int_col.size();
-      int_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          int_buffer_->push_back(inline_fixed_encoding_null_val(cd->columnType));
-        } else {
-          int_buffer_->push_back((int32_t)col.data.int_col[i]);
-        }
-      }
+      append_columnar_values(*int_buffer_,
+                             col.data.int_col,
+                             col.nulls,
+                             int32_t(inline_fixed_encoding_null_val(cd->columnType)));
       break;
     }
     case kBIGINT:
     case kNUMERIC:
     case kDECIMAL: {
       dataSize = col.data.int_col.size();
-      bigint_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          bigint_buffer_->push_back(inline_fixed_encoding_null_val(cd->columnType));
-        } else {
-          bigint_buffer_->push_back((int64_t)col.data.int_col[i]);
-        }
-      }
+      append_columnar_values(*bigint_buffer_,
+                             col.data.int_col,
+                             col.nulls,
+                             int64_t(inline_fixed_encoding_null_val(cd->columnType)));
       break;
     }
     case kFLOAT: {
       dataSize = col.data.real_col.size();
-      float_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          float_buffer_->push_back(NULL_FLOAT);
-        } else {
-          float_buffer_->push_back((float)col.data.real_col[i]);
-        }
-      }
+      append_columnar_values(*float_buffer_, col.data.real_col, col.nulls, NULL_FLOAT);
       break;
     }
     case kDOUBLE: {
       dataSize = col.data.real_col.size();
-      double_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          double_buffer_->push_back(NULL_DOUBLE);
-        } else {
-          double_buffer_->push_back((double)col.data.real_col[i]);
-        }
-      }
+      append_columnar_values(*double_buffer_, col.data.real_col, col.nulls, NULL_DOUBLE);
       break;
     }
     case kTEXT:
@@ -1062,14 +1159,10 @@ size_t TypedImportBuffer::add_values(const ColumnDescriptor* cd, const TColumn&
     case kTIMESTAMP:
     case kDATE: {
       dataSize = col.data.int_col.size();
-      bigint_buffer_->reserve(dataSize);
-      for (size_t i = 0; i < dataSize; i++) {
-        if (col.nulls[i]) {
-          bigint_buffer_->push_back(inline_fixed_encoding_null_val(cd->columnType));
-        } else {
-          bigint_buffer_->push_back(static_cast<int64_t>(col.data.int_col[i]));
-        }
-      }
+      append_columnar_values(*bigint_buffer_,
+                             col.data.int_col,
+                             col.nulls,
+                             int64_t(inline_fixed_encoding_null_val(cd->columnType)));
       break;
     }
     case kPOINT:
@@ -1419,6 +1512,39 @@ bool importGeoFromLonLat(double lon, double lat, std::vector<double>& coords) {
   return true;
 }
 
+template <typename T>
+void TypedImportBuffer::add_array_value(const ColumnDescriptor* cd,
+                                        const std::vector<T>& values,
+                                        const bool is_null,
+                                        const int64_t replicate_count) {
+  set_replicate_count(replicate_count);
+  CHECK(cd->columnType.is_array());
+  CHECK_EQ(sizeof(T), static_cast<size_t>(cd->columnType.get_elem_type().get_size()));
+  if (is_null) {
+    addArray(NullArray(cd->columnType));
+    return;
+  }
+  const size_t len = values.size() * sizeof(T);
+  auto buf = static_cast<int8_t*>(checked_malloc(len));
+  if (len) {
+    memcpy(buf, values.data(), len);
+  }
+  addArray(ArrayDatum(len, buf, false));
+}
+
+template void TypedImportBuffer::add_array_value(const ColumnDescriptor* cd,
+                                                 const std::vector<uint8_t>& values,
+                                                 const bool is_null,
+                                                 const int64_t replicate_count);
+template void TypedImportBuffer::add_array_value(const ColumnDescriptor* cd,
+                                                 const std::vector<int32_t>& values,
+                                                 const bool is_null,
+                                                 const int64_t replicate_count);
+template void TypedImportBuffer::add_array_value(const ColumnDescriptor* cd,
+                                                 const std::vector<double>& values,
+                                                 const bool is_null,
+                                                 const int64_t replicate_count);
+
 void Importer::set_geo_physical_import_buffer(
     const Catalog_Namespace::Catalog& catalog,
     const ColumnDescriptor* cd,
@@ -1451,65 +1577,34 @@ void Importer::set_geo_physical_import_buffer(
       is_null_geo = false;
     }
   }
-  TDatum tdd_coords;
   // Get the raw data representing [optionally compressed] non-NULL geo's coords.
   // One exception - NULL POINT geo: coords need to be processed to encode nullness
   // in a fixlen array, compressed and uncompressed.
+  std::vector<uint8_t> compressed_coords;
   if (!is_null_geo) {
-    std::vector<uint8_t> compressed_coords = geospatial::compress_coords(coords, col_ti);
-    tdd_coords.val.arr_val.reserve(compressed_coords.size());
-    for (auto cc : compressed_coords) {
-      tdd_coords.val.arr_val.emplace_back();
-      tdd_coords.val.arr_val.back().val.int_val = cc;
-    }
+    compressed_coords = geospatial::compress_coords(coords, col_ti);
   }
-  tdd_coords.is_null = is_null_geo;
-  import_buffers[col_idx++]->add_value(cd_coords, tdd_coords, false, replicate_count);
+  import_buffers[col_idx++]->add_array_value(
+      cd_coords, compressed_coords, is_null_geo, replicate_count);
 
   if (col_type == kPOLYGON || col_type == kMULTIPOLYGON) {
     // Create ring_sizes array value and add it to the physical column
     auto cd_ring_sizes = catalog.getMetadataForColumn(cd->tableId, ++columnId);
-    TDatum tdd_ring_sizes;
-    tdd_ring_sizes.val.arr_val.reserve(ring_sizes.size());
-    if (!is_null_geo) {
-      for (auto ring_size : ring_sizes) {
-        tdd_ring_sizes.val.arr_val.emplace_back();
-        tdd_ring_sizes.val.arr_val.back().val.int_val = ring_size;
-      }
-    }
-    tdd_ring_sizes.is_null = is_null_geo;
-    import_buffers[col_idx++]->add_value(
-        cd_ring_sizes, tdd_ring_sizes, false, replicate_count);
+    import_buffers[col_idx++]->add_array_value(
+        cd_ring_sizes, ring_sizes, is_null_geo, replicate_count);
   }
 
   if (col_type == kMULTIPOLYGON) {
     // Create poly_rings array value and add it to the physical column
     auto cd_poly_rings = catalog.getMetadataForColumn(cd->tableId, ++columnId);
-    TDatum tdd_poly_rings;
-    tdd_poly_rings.val.arr_val.reserve(poly_rings.size());
-    if (!is_null_geo) {
-      for (auto num_rings : poly_rings) {
-        tdd_poly_rings.val.arr_val.emplace_back();
-        tdd_poly_rings.val.arr_val.back().val.int_val = num_rings;
-      }
-    }
-    tdd_poly_rings.is_null = is_null_geo;
-    import_buffers[col_idx++]->add_value(
-        cd_poly_rings, tdd_poly_rings, false, replicate_count);
+    import_buffers[col_idx++]->add_array_value(
+        cd_poly_rings, poly_rings, is_null_geo, replicate_count);
   }
 
   if (col_type == kLINESTRING || col_type == kPOLYGON || col_type == kMULTIPOLYGON) {
     auto cd_bounds = catalog.getMetadataForColumn(cd->tableId, ++columnId);
-    TDatum tdd_bounds;
-    tdd_bounds.val.arr_val.reserve(bounds.size());
-    if (!is_null_geo) {
-      for (auto b : bounds) {
-        tdd_bounds.val.arr_val.emplace_back();
-        tdd_bounds.val.arr_val.back().val.real_val = b;
-      }
-    }
-    tdd_bounds.is_null = is_null_geo;
-    import_buffers[col_idx++]->add_value(cd_bounds, tdd_bounds, false, replicate_count);
+    import_buffers[col_idx++]->add_array_value(
+        cd_bounds, bounds, is_null_geo, replicate_count);
   }
 
   if (col_type == kPOLYGON || col_type == kMULTIPOLYGON) {
@@ -1794,6 +1889,62 @@ int64_t explode_collections_step2(
 
 }  // namespace
 
+namespace {
+
+/**
+ * Queue between two stages of an import. push() blocks while the queue is full and pop()
+ * while it is empty. Once the queue is closed, push() drops its item and returns false,
+ * and pop() returns the items left, then false.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(const size_t capacity)
+      : capacity_(std::max(capacity, size_t(1))) {}
+
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::queue<T> items_;
+  bool closed_{false};
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+}  // namespace
+
+// Parses the rows of a buffer into the import buffers of buffer set thread_id, which
+// importDelimited() encodes and loads later
 static ImportStatus import_thread_delimited(
     int thread_id,
     Importer* importer,
@@ -1808,7 +1959,6 @@ static ImportStatus import_thread_delimited(
   int64_t total_str_to_val_time_us = 0;
   CHECK(scratch_buffer);
   auto buffer = scratch_buffer.get();
-  auto load_ms = measure<>::execution([]() {});
   auto ms = measure<>::execution([&]() {
     const CopyParams& copy_params = importer->get_copy_params();
     const std::list<const ColumnDescriptor*>& col_descs = importer->get_column_descs();
@@ -2098,15 +2248,11 @@ static ImportStatus import_thread_delimited(
       }
       total_str_to_val_time_us += us;
     }  // end thread
-    if (import_status.rows_completed > 0) {
-      load_ms = measure<>::execution(
-          [&]() { importer->load(import_buffers, import_status.rows_completed); });
-    }
   });
   if (DEBUG_TIMING && import_status.rows_completed > 0) {
     LOG(INFO) << "Thread" << std::this_thread::get_id() << ":"
-              << import_status.rows_completed << " rows inserted in "
-              << (double)ms / 1000.0 << "sec, Insert Time: " << (double)load_ms / 1000.0
+              << import_status.rows_completed << " rows parsed in "
+              << (double)ms / 1000.0
               << "sec, get_row: " << (double)total_get_row_time_us / 1000000.0
               << "sec, str_to_val: " << (double)total_str_to_val_time_us / 1000000.0
               << "sec" << std::endl;
@@ -2261,38 +2407,20 @@ static ImportStatus import_thread_shapefile(
             // create coords array value and add it to the physical column
             ++cd_it;
             auto cd_coords = *cd_it;
-            std::vector<TDatum> td_coord_data;
+            std::vector<uint8_t> compressed_coords;
             if (!is_null_geo) {
-              std::vector<uint8_t> compressed_coords =
-                  geospatial::compress_coords(coords, col_ti);
-              for (auto cc : compressed_coords) {
-                TDatum td_byte;
-                td_byte.val.int_val = cc;
-                td_coord_data.push_back(td_byte);
-              }
+              compressed_coords = geospatial::compress_coords(coords, col_ti);
             }
-            TDatum tdd_coords;
-            tdd_coords.val.arr_val = td_coord_data;
-            tdd_coords.is_null = is_null_geo;
-            import_buffers[col_idx]->add_value(cd_coords, tdd_coords, false);
+            import_buffers[col_idx]->add_array_value(
+                cd_coords, compressed_coords, is_null_geo);
             ++col_idx;
 
             if (col_type == kPOLYGON || col_type == kMULTIPOLYGON) {
               // Create ring_sizes array value and add it to the physical column
               ++cd_it;
               auto cd_ring_sizes = *cd_it;
-              std::vector<TDatum> td_ring_sizes;
-              if (!is_null_geo) {
-                for (auto ring_size : ring_sizes) {
-                  TDatum td_ring_size;
-                  td_ring_size.val.int_val = ring_size;
-                  td_ring_sizes.push_back(td_ring_size);
-                }
-              }
-              TDatum tdd_ring_sizes;
-              tdd_ring_sizes.val.arr_val = td_ring_sizes;
-              tdd_ring_sizes.is_null = is_null_geo;
-              import_buffers[col_idx]->add_value(cd_ring_sizes, tdd_ring_sizes, false);
+              import_buffers[col_idx]->add_array_value(
+                  cd_ring_sizes, ring_sizes, is_null_geo);
               ++col_idx;
             }
 
@@ -2300,18 +2428,8 @@ static ImportStatus import_thread_shapefile(
               // Create poly_rings array value and add it to the physical column
               ++cd_it;
               auto cd_poly_rings = *cd_it;
-              std::vector<TDatum> td_poly_rings;
-              if (!is_null_geo) {
-                for (auto num_rings : poly_rings) {
-                  TDatum td_num_rings;
-                  td_num_rings.val.int_val = num_rings;
-                  td_poly_rings.push_back(td_num_rings);
-                }
-              }
-              TDatum tdd_poly_rings;
-              tdd_poly_rings.val.arr_val = td_poly_rings;
-              tdd_poly_rings.is_null = is_null_geo;
-              import_buffers[col_idx]->add_value(cd_poly_rings, tdd_poly_rings, false);
+              import_buffers[col_idx]->add_array_value(
+                  cd_poly_rings, poly_rings, is_null_geo);
               ++col_idx;
             }
 
@@ -2320,18 +2438,7 @@ static ImportStatus import_thread_shapefile(
               // Create bounds array value and add it to the physical column
               ++cd_it;
               auto cd_bounds = *cd_it;
-              std::vector<TDatum> td_bounds_data;
-              if (!is_null_geo) {
-                for (auto b : bounds) {
-                  TDatum td_double;
-                  td_double.val.real_val = b;
-                  td_bounds_data.push_back(td_double);
-                }
-              }
-              TDatum tdd_bounds;
-              tdd_bounds.val.arr_val = td_bounds_data;
-              tdd_bounds.is_null = is_null_geo;
-              import_buffers[col_idx]->add_value(cd_bounds, tdd_bounds, false);
+              import_buffers[col_idx]->add_array_value(cd_bounds, bounds, is_null_geo);
               ++col_idx;
             }
 
@@ -2486,15 +2593,34 @@ static ImportStatus import_thread_shapefile(
   return import_status;
 }
 
+namespace {
+
+// the rate of the counter is the rows per second of the imports
+void add_imported_rows(const size_t row_count) {
+  static auto& imported_rows = metrics::Registry::instance().counter(
+      "omnisci_import_rows_total", "The rows loaded into the tables by the imports");
+  imported_rows.add(row_count);
+}
+
+}  // namespace
+
 bool Loader::loadNoCheckpoint(
     const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
     size_t row_count) {
-  return loadImpl(import_buffers, row_count, false);
+  const auto loaded = loadImpl(import_buffers, row_count, false);
+  if (loaded) {
+    add_imported_rows(row_count);
+  }
+  return loaded;
 }
 
 bool Loader::load(const std::vector<std::unique_ptr<TypedImportBuffer>>& import_buffers,
                   size_t row_count) {
-  return loadImpl(import_buffers, row_count, true);
+  const auto loaded = loadImpl(import_buffers, row_count, true);
+  if (loaded) {
+    add_imported_rows(row_count);
+  }
+  return loaded;
 }
 
 namespace {
@@ -2577,7 +2703,7 @@ void Loader::distributeToShards(std::vector<OneShardBuffers>& all_shard_import_b
   CHECK(shard_col_ti.is_integer() ||
         (shard_col_ti.is_string() && shard_col_ti.get_compression() == kENCODING_DICT) ||
         shard_col_ti.is_time());
-  if (shard_col_ti.is_string()) {
+  if (shard_col_ti.is_string() && !shard_column_input_buffer->isDictEncoded()) {
     const auto payloads_ptr = shard_column_input_buffer->getStringBuffer();
     CHECK(payloads_ptr);
     shard_column_input_buffer->addDictEncodedString(*payloads_ptr);
@@ -2734,7 +2860,8 @@ std::vector<DataBlockPtr> Loader::get_data_block_pointers(
   // make all async calls to string dictionary here and then continue execution
   for (size_t buf_idx = 0; buf_idx < import_buffers.size(); buf_idx++) {
     if (import_buffers[buf_idx]->getTypeInfo().is_string() &&
-        import_buffers[buf_idx]->getTypeInfo().get_compression() != kENCODING_NONE) {
+        import_buffers[buf_idx]->getTypeInfo().get_compression() != kENCODING_NONE &&
+        !import_buffers[buf_idx]->isDictEncoded()) {
       auto string_payload_ptr = import_buffers[buf_idx]->getStringBuffer();
       CHECK_EQ(kENCODING_DICT, import_buffers[buf_idx]->getTypeInfo().get_compression());
 
@@ -2757,6 +2884,8 @@ std::vector<DataBlockPtr> Loader::get_data_block_pointers(
       auto string_payload_ptr = import_buffers[buf_idx]->getStringBuffer();
       if (import_buffers[buf_idx]->getTypeInfo().get_compression() == kENCODING_NONE) {
         p.stringsPtr = string_payload_ptr;
+      } else if (import_buffers[buf_idx]->isDictEncoded()) {
+        p.numbersPtr = import_buffers[buf_idx]->getStringDictBuffer();
       } else {
         // This condition means we have column which is ENCODED string. We already made
         // Async request to gain the encoded integer values above so we should skip this
@@ -2770,8 +2899,10 @@ std::vector<DataBlockPtr> Loader::get_data_block_pointers(
       CHECK(import_buffers[buf_idx]->getTypeInfo().get_type() == kARRAY);
       if (IS_STRING(import_buffers[buf_idx]->getTypeInfo().get_subtype())) {
         CHECK(import_buffers[buf_idx]->getTypeInfo().get_compression() == kENCODING_DICT);
-        import_buffers[buf_idx]->addDictEncodedStringArray(
-            *import_buffers[buf_idx]->getStringArrayBuffer());
+        if (!import_buffers[buf_idx]->isDictEncoded()) {
+          import_buffers[buf_idx]->addDictEncodedStringArray(
+              *import_buffers[buf_idx]->getStringArrayBuffer());
+        }
         p.arraysPtr = import_buffers[buf_idx]->getStringArrayDictBuffer();
       } else {
         p.arraysPtr = import_buffers[buf_idx]->getArrayBuffer();
@@ -2926,10 +3057,79 @@ ImportStatus Detector::importDelimited(const std::string& file_path,
 }
 
 void Detector::read_file() {
+  if (read_head_block()) {
+    return;
+  }
   // this becomes analogous to Importer::import()
   (void)DataStreamSink::archivePlumber();
 }
 
+namespace {
+
+constexpr size_t kDetectSampleBlockSize{1 << 20};
+
+// the first bytes libarchive recognizes the compressed and the archived files by
+bool has_archive_signature(const std::string& head) {
+  static const std::vector<std::string> signatures{
+      "\x1f\x8b",                       // gzip
+      "\x1f\x9d",                       // compress
+      "BZh",                            // bzip2
+      std::string("\xfd" "7zXZ\0", 6),  // xz
+      std::string("\x5d\0\0", 3),       // lzma
+      "\x28\xb5\x2f\xfd",               // zstd
+      "\x04\x22\x4d\x18",               // lz4
+      "PK\x03\x04",                     // zip
+      "7z\xbc\xaf\x27\x1c",             // 7z
+      "Rar!"};
+  for (const auto& signature : signatures) {
+    if (boost::starts_with(head, signature)) {
+      return true;
+    }
+  }
+  return head.size() > 262 && !head.compare(257, 5, "ustar");
+}
+
+}  // namespace
+
+// Reads the head of a large uncompressed local file and picks the offsets of the blocks
+// sampled over the rest of it, so the detection sees more than the first rows without
+// streaming the whole file. Returns false if the file is read through libarchive.
+bool Detector::read_head_block() {
+  if (!g_detect_sample_blocks || copy_params.file_type != FileType::DELIMITED) {
+    return false;
+  }
+  boost::system::error_code ec;
+  if (!boost::filesystem::is_regular_file(file_path, ec)) {
+    return false;
+  }
+  const auto file_size = boost::filesystem::file_size(file_path, ec);
+  if (ec || file_size < (g_detect_sample_blocks + 1) * kDetectSampleBlockSize) {
+    return false;
+  }
+  std::ifstream file(file_path.string(), std::ios::binary);
+  std::string head(kDetectSampleBlockSize, '\0');
+  if (!file.read(&head[0], head.size()) || has_archive_signature(head)) {
+    return false;
+  }
+  // the last line of the block is cut
+  const auto last_line_delim = head.rfind(copy_params.line_delim);
+  if (last_line_delim == std::string::npos) {
+    return false;
+  }
+  raw_data = head.substr(0, last_line_delim + 1);
+  // a block at a random offset of each of the equal strides of the rest of the file
+  std::mt19937_64 generator(file_size);
+  const size_t stride = (file_size - kDetectSampleBlockSize) / g_detect_sample_blocks;
+  CHECK_GE(stride, kDetectSampleBlockSize);
+  std::uniform_int_distribution<size_t> offset_in_stride(0,
+                                                         stride - kDetectSampleBlockSize);
+  for (size_t i = 0; i < g_detect_sample_blocks; ++i) {
+    sample_block_offsets.push_back(kDetectSampleBlockSize + i * stride +
+                                   offset_in_stride(generator));
+  }
+  return true;
+}
+
 void Detector::detect_row_delimiter() {
   if (copy_params.delimiter == '\0') {
     copy_params.delimiter = ',';
@@ -2963,7 +3163,88 @@ void Detector::split_raw_data() {
           p, buf_end, buf_end, copy_params, nullptr, row, tmp_buffers, try_single_thread);
       raw_rows.push_back(row);
     }
+    // the sampled blocks could start inside of a quoted line delimiter
+    sample_block_offsets.clear();
   }
+  split_sample_blocks();
+}
+
+// Parses the sampled blocks in waves of parallel reads, until a wave leaves the types of
+// the rows sampled so far unchanged.
+void Detector::split_sample_blocks() {
+  if (sample_block_offsets.empty() || raw_rows.size() < 2) {
+    return;
+  }
+  constexpr size_t kWaveCount{4};
+  const size_t wave_size = (sample_block_offsets.size() + kWaveCount - 1) / kWaveCount;
+  const auto num_cols = raw_rows.front().size();
+  auto sample_types =
+      find_best_sqltypes(raw_rows.begin() + 1, raw_rows.end(), copy_params);
+  for (size_t wave_begin = 0; wave_begin < sample_block_offsets.size();
+       wave_begin += wave_size) {
+    const auto wave_end = std::min(wave_begin + wave_size, sample_block_offsets.size());
+    std::vector<std::future<std::vector<std::vector<std::string>>>> block_rows;
+    for (size_t i = wave_begin; i < wave_end; ++i) {
+      block_rows.push_back(std::async(
+          std::launch::async,
+          [this, offset = sample_block_offsets[i], num_cols] {
+            return parse_sample_block(offset, num_cols);
+          }));
+    }
+    for (auto& rows : block_rows) {
+      for (auto& row : rows.get()) {
+        raw_rows.push_back(std::move(row));
+      }
+    }
+    auto wave_types =
+        find_best_sqltypes(raw_rows.begin() + 1, raw_rows.end(), copy_params);
+    if (wave_types == sample_types) {
+      VLOG(1) << "Detected the column types of " << file_path << " from "
+              << wave_end << " sampled blocks";
+      break;
+    }
+    sample_types = std::move(wave_types);
+  }
+}
+
+std::vector<std::vector<std::string>> Detector::parse_sample_block(
+    const size_t offset,
+    const size_t num_cols) const {
+  std::ifstream file(file_path.string(), std::ios::binary);
+  std::string block(kDetectSampleBlockSize, '\0');
+  file.seekg(offset);
+  file.read(&block[0], block.size());
+  block.resize(file.gcount());
+  // the rows between the first and the last line delimiters of the block are whole
+  const auto first_line_delim = block.find(copy_params.line_delim);
+  const auto last_line_delim = block.rfind(copy_params.line_delim);
+  if (first_line_delim == std::string::npos || first_line_delim == last_line_delim) {
+    return {};
+  }
+  const char* buf = block.data() + first_line_delim + 1;
+  const char* buf_end = block.data() + last_line_delim + 1;
+  std::vector<std::vector<std::string>> rows;
+  bool try_single_thread = false;
+  try {
+    for (const char* p = buf; p < buf_end; p++) {
+      std::vector<std::string> row;
+      std::vector<std::unique_ptr<char[]>> tmp_buffers;
+      p = import_export::delimited_parser::get_row(
+          p, buf_end, buf_end, copy_params, nullptr, row, tmp_buffers, try_single_thread);
+      if (try_single_thread) {
+        return {};
+      }
+      // a block which starts inside of a quoted field is split into rows of other sizes
+      if (row.size() == num_cols) {
+        rows.push_back(std::move(row));
+      }
+    }
+  } catch (const std::exception& e) {
+    VLOG(1) << "Skipped the block sampled at offset " << offset << " of " << file_path
+            << ": " << e.what();
+    return {};
+  }
+  return rows;
 }
 
 template <class T>
@@ -3335,20 +3616,21 @@ ImportStatus DataStreamSink::archivePlumber() {
 }
 
 #ifdef ENABLE_IMPORT_PARQUET
+// Opens a parquet file, and only reads its metadata
 inline auto open_parquet_table(const std::string& file_path,
                                std::shared_ptr<arrow::io::ReadableFile>& infile,
                                std::unique_ptr<parquet::arrow::FileReader>& reader,
-                               std::shared_ptr<arrow::Table>& table) {
+                               std::shared_ptr<arrow::Schema>& schema) {
   using namespace parquet::arrow;
   auto file_result = arrow::io::ReadableFile::Open(file_path);
   PARQUET_THROW_NOT_OK(file_result.status());
   infile = file_result.ValueOrDie();
 
   PARQUET_THROW_NOT_OK(OpenFile(infile, arrow::default_memory_pool(), &reader));
-  PARQUET_THROW_NOT_OK(reader->ReadTable(&table));
+  PARQUET_THROW_NOT_OK(reader->GetSchema(&schema));
   const auto num_row_groups = reader->num_row_groups();
-  const auto num_columns = table->num_columns();
-  const auto num_rows = table->num_rows();
+  const auto num_columns = schema->num_fields();
+  const auto num_rows = reader->parquet_reader()->metadata()->num_rows();
   LOG(INFO) << "File " << file_path << " has " << num_rows << " rows and " << num_columns
             << " columns in " << num_row_groups << " groups.";
   return std::make_tuple(num_row_groups, num_columns, num_rows);
@@ -3357,11 +3639,11 @@ inline auto open_parquet_table(const std::string& file_path,
 void Detector::import_local_parquet(const std::string& file_path) {
   std::shared_ptr<arrow::io::ReadableFile> infile;
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  std::shared_ptr<arrow::Table> table;
+  std::shared_ptr<arrow::Schema> schema;
   int num_row_groups, num_columns;
   int64_t num_rows;
   std::tie(num_row_groups, num_columns, num_rows) =
-      open_parquet_table(file_path, infile, reader, table);
+      open_parquet_table(file_path, infile, reader, schema);
   // make up header line if not yet
   if (0 == raw_data.size()) {
     copy_params.has_header = ImportHeaderRow::HAS_HEADER;
@@ -3375,7 +3657,7 @@ void Detector::import_local_parquet(const std::string& file_path) {
       if (c) {
         raw_data += copy_params.delimiter;
       }
-      raw_data += table->ColumnNames().at(c);
+      raw_data += schema->field(c)->name();
     }
     raw_data += copy_params.line_delim;
   }
@@ -3473,11 +3755,11 @@ auto TypedImportBuffer::del_values(const SQLTypes type,
 void Importer::import_local_parquet(const std::string& file_path) {
   std::shared_ptr<arrow::io::ReadableFile> infile;
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  std::shared_ptr<arrow::Table> table;
+  std::shared_ptr<arrow::Schema> schema;
   int num_row_groups, num_columns;
   int64_t nrow_in_file;
   std::tie(num_row_groups, num_columns, nrow_in_file) =
-      open_parquet_table(file_path, infile, reader, table);
+      open_parquet_table(file_path, infile, reader, schema);
   // column_list has no $deleted
   const auto& column_list = get_column_descs();
   // for now geo columns expect a wkt or wkb hex string
@@ -3492,13 +3774,22 @@ void Importer::import_local_parquet(const std::string& file_path) {
                      std::to_string(num_columns) + " columns in file vs " +
                      std::to_string(column_list.size() - num_physical_cols) +
                      " columns in table.");
-  // slice each group to import slower columns faster, eg. geo or string
+  // row groups are imported in parallel, each by a worker with its own file reader, and
+  // the threads left over slice the row groups to import slower columns faster, eg. geo
+  // or string
   max_threads = copy_params.threads ? copy_params.threads : cpu_threads();
-  const int num_slices = std::max<decltype(max_threads)>(max_threads, num_columns);
+  const int num_workers = std::max(std::min<int>(max_threads, num_row_groups), 1);
+  const int num_slices = std::max<int>(max_threads / num_workers, 1);
+  // the slices of worker w are import_buffers_vec[w * num_slices, (w + 1) * num_slices)
+  import_buffers_vec.resize(num_workers * num_slices);
+  // the dictionary encoding of strings does not have to wait for other loads, except for
+  // sharded tables, whose rows are encoded shard by shard when they are loaded
+  const bool encode_dict_strings = !loader->getTableDesc()->nShards;
   // init row estimate for this file
   const auto filesize = get_filesize(file_path);
   size_t nrow_completed{0};
   file_offsets.push_back(0);
+  const auto file_offset_idx = file_offsets.size() - 1;
   // map logic column index to physical column index
   auto get_physical_col_idx = [&cds](const int logic_col_idx) -> auto {
     int physical_col_idx = 0;
@@ -3507,16 +3798,23 @@ void Importer::import_local_parquet(const std::string& file_path) {
     }
     return physical_col_idx;
   };
-  // load a file = nested iteration of row groups, row slices and logical columns
-  auto ms_load_a_file = measure<>::execution([&]() {
-    for (int row_group = 0; row_group < num_row_groups && !load_failed; ++row_group) {
+  std::atomic<int> next_row_group{0};
+  std::atomic<bool> worker_failed{false};
+  auto import_row_groups = [&](const int worker) {
+    std::shared_ptr<arrow::io::ReadableFile> worker_infile;
+    std::unique_ptr<parquet::arrow::FileReader> worker_reader;
+    std::shared_ptr<arrow::Schema> worker_schema;
+    open_parquet_table(file_path, worker_infile, worker_reader, worker_schema);
+    auto worker_import_buffers_vec = import_buffers_vec.begin() + worker * num_slices;
+    for (int row_group = next_row_group++;
+         row_group < num_row_groups && !load_failed && !worker_failed;
+         row_group = next_row_group++) {
       // a sliced row group will be handled like a (logic) parquet file, with
       // a entirely clean set of bad_rows_tracker, import_buffers_vec, ... etc
-      import_buffers_vec.resize(num_slices);
       for (int slice = 0; slice < num_slices; slice++) {
-        import_buffers_vec[slice].clear();
+        worker_import_buffers_vec[slice].clear();
         for (const auto cd : cds) {
-          import_buffers_vec[slice].emplace_back(
+          worker_import_buffers_vec[slice].emplace_back(
               new TypedImportBuffer(cd, loader->getStringDict(cd)));
         }
       }
@@ -3542,25 +3840,37 @@ void Importer::import_local_parquet(const std::string& file_path) {
         const auto cd = cds[physical_col_idx];
         std::shared_ptr<arrow::ChunkedArray> array;
         PARQUET_THROW_NOT_OK(
-            reader->RowGroup(row_group)->Column(logic_col_idx)->Read(&array));
+            worker_reader->RowGroup(row_group)->Column(logic_col_idx)->Read(&array));
         const size_t array_size = array->length();
+        if (array_size == 0) {
+          continue;
+        }
+        // the slices are ranges of the rows of the whole row group
+        std::shared_ptr<arrow::Array> column_array;
+        if (array->num_chunks() == 1) {
+          column_array = array->chunk(0);
+        } else {
+          ARROW_ASSIGN_OR_THROW(column_array, arrow::Concatenate(array->chunks()));
+        }
         const size_t slice_size = (array_size + num_slices - 1) / num_slices;
+        auto import_slice = [&](const int slice) {
+          ArraySliceRange slice_range(
+              std::min<size_t>((slice + 0) * slice_size, array_size),
+              std::min<size_t>((slice + 1) * slice_size, array_size));
+          auto& bad_rows_tracker = bad_rows_trackers[slice];
+          auto& import_buffer = worker_import_buffers_vec[slice][physical_col_idx];
+          import_buffer->import_buffers = &worker_import_buffers_vec[slice];
+          import_buffer->col_idx = physical_col_idx + 1;
+          import_buffer->add_arrow_values(
+              cd, *column_array, false, slice_range, &bad_rows_tracker);
+        };
+        if (num_slices == 1) {
+          import_slice(0);
+          continue;
+        }
         ThreadController_NS::SimpleThreadController<void> thread_controller(num_slices);
         for (int slice = 0; slice < num_slices; ++slice) {
-          thread_controller.startThread([&, slice] {
-            const auto slice_offset = slice % num_slices;
-            ArraySliceRange slice_range(
-                std::min<size_t>((slice_offset + 0) * slice_size, array_size),
-                std::min<size_t>((slice_offset + 1) * slice_size, array_size));
-            auto& bad_rows_tracker = bad_rows_trackers[slice];
-            auto& import_buffer = import_buffers_vec[slice][physical_col_idx];
-            import_buffer->import_buffers = &import_buffers_vec[slice];
-            import_buffer->col_idx = physical_col_idx + 1;
-            for (auto chunk : array->chunks()) {
-              import_buffer->add_arrow_values(
-                  cd, *chunk, false, slice_range, &bad_rows_tracker);
-            }
-          });
+          thread_controller.startThread([&, slice] { import_slice(slice); });
         }
         thread_controller.finish();
       }
@@ -3572,14 +3882,19 @@ void Importer::import_local_parquet(const std::string& file_path) {
         const auto cd = cds[physical_col_idx];
         for (int slice = 0; slice < num_slices; ++slice) {
           auto& bad_rows_tracker = bad_rows_trackers[slice];
-          auto& import_buffer = import_buffers_vec[slice][physical_col_idx];
+          auto& import_buffer = worker_import_buffers_vec[slice][physical_col_idx];
           std::tie(nrow_in_slice_raw[slice], nrow_in_slice_successfully_loaded[slice]) =
               import_buffer->del_values(cd->columnType.get_type(), &bad_rows_tracker);
         }
       }
       // flush slices of this row group to chunks
       for (int slice = 0; slice < num_slices; ++slice) {
-        load(import_buffers_vec[slice], nrow_in_slice_successfully_loaded[slice]);
+        if (encode_dict_strings) {
+          for (auto& import_buffer : worker_import_buffers_vec[slice]) {
+            import_buffer->encodeDictStrings();
+          }
+        }
+        load(worker_import_buffers_vec[slice], nrow_in_slice_successfully_loaded[slice]);
       }
       // update import stats
       const auto nrow_original =
@@ -3603,7 +3918,7 @@ void Importer::import_local_parquet(const std::string& file_path) {
       // row estimate
       std::unique_lock<std::mutex> lock(file_offsets_mutex);
       nrow_completed += nrow_imported;
-      file_offsets.back() =
+      file_offsets[file_offset_idx] =
           nrow_in_file ? (float)filesize * nrow_completed / nrow_in_file : 0;
       // sum up current total file offsets
       const auto total_file_offset =
@@ -3618,6 +3933,27 @@ void Importer::import_local_parquet(const std::string& file_path) {
                 << total_file_offset;
       }
     }
+  };
+  // load a file = parallel iteration of row groups, nested iterations of logical
+  // columns and row slices
+  auto ms_load_a_file = measure<>::execution([&]() {
+    std::vector<std::future<void>> workers;
+    for (int worker = 0; worker < num_workers; ++worker) {
+      workers.push_back(std::async(std::launch::async, [&, worker] {
+        try {
+          import_row_groups(worker);
+        } catch (...) {
+          worker_failed = true;
+          throw;
+        }
+      }));
+    }
+    for (auto& worker : workers) {
+      worker.wait();
+    }
+    for (auto& worker : workers) {
+      worker.get();
+    }
   });
   LOG(INFO) << "Import " << nrow_in_file << " rows of parquet file " << file_path
             << " took " << (double)ms_load_a_file / 1000.0 << " secs";
@@ -3975,7 +4311,11 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
     alloc_size = file_size;
   }
 
-  for (size_t i = 0; i < max_threads; i++) {
+  // Rows are parsed into sets of import buffers. A parser takes a free set, and the set
+  // is free again once the writer has loaded it.
+  const size_t num_encoder_threads = std::max(g_import_dict_encoder_threads, size_t(1));
+  const size_t num_buffer_sets = max_threads + num_encoder_threads + 1;
+  for (size_t i = 0; i < num_buffer_sets; i++) {
     import_buffers_vec.emplace_back();
     for (const auto cd : loader->get_column_descs()) {
       import_buffers_vec[i].emplace_back(
@@ -3984,9 +4324,7 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
   }
 
   auto scratch_buffer = std::make_unique<char[]>(alloc_size);
-  size_t current_pos = 0;
-  size_t end_pos;
-  size_t begin_pos = 0;
+  std::atomic<size_t> current_pos{0};
 
   (void)fseek(p_file, current_pos, SEEK_SET);
   size_t size =
@@ -4011,135 +4349,211 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
                        loader->getTableDesc()->tableId};
   auto start_epoch = loader->getTableEpoch();
   {
-    std::list<std::future<ImportStatus>> threads;
-
-    // use a stack to track thread_ids which must not overlap among threads
-    // because thread_id is used to index import_buffers_vec[]
-    std::stack<size_t> stack_thread_ids;
-    for (size_t i = 0; i < max_threads; i++) {
-      stack_thread_ids.push(i);
-    }
-    // added for true row index on error
-    size_t first_row_index_this_buffer = 0;
-
-    while (size > 0) {
-      unsigned int num_rows_this_buffer = 0;
-      CHECK(scratch_buffer);
-      end_pos = delimited_parser::find_row_end_pos(alloc_size,
-                                                   scratch_buffer,
-                                                   size,
-                                                   copy_params,
-                                                   first_row_index_this_buffer,
-                                                   num_rows_this_buffer,
-                                                   p_file);
-
-      // unput residual
-      int nresidual = size - end_pos;
-      std::unique_ptr<char[]> unbuf;
-      if (nresidual > 0) {
-        unbuf = std::make_unique<char[]>(nresidual);
-        memcpy(unbuf.get(), scratch_buffer.get() + end_pos, nresidual);
+    // The import is a pipeline of stages connected by bounded queues, so that reading
+    // the file, parsing rows, dictionary encoding strings and writing fragments all run
+    // at the same time: a reader splits the file into buffers of whole rows, max_threads
+    // parsers fill sets of import buffers from them, encoders dictionary encode the
+    // strings of the sets, and this thread loads the sets, one at a time.
+    struct RowsBuffer {
+      std::unique_ptr<char[]> buffer;
+      size_t end_pos;
+      size_t first_row_index;
+    };
+    BoundedQueue<RowsBuffer> read_queue(g_import_read_ahead_buffers);
+    BoundedQueue<size_t> free_buffer_sets(num_buffer_sets);
+    for (size_t i = 0; i < num_buffer_sets; ++i) {
+      free_buffer_sets.push(i);
+    }
+    // the thread_id of a parsed import status is the index of its buffer set
+    BoundedQueue<ImportStatus> parsed_queue(num_buffer_sets);
+    BoundedQueue<ImportStatus> encoded_queue(num_buffer_sets);
+
+    std::atomic<bool> stop_pipeline{false};
+    std::mutex pipeline_error_mutex;
+    std::exception_ptr pipeline_error;
+    auto stop = [&]() {
+      stop_pipeline = true;
+      read_queue.close();
+      free_buffer_sets.close();
+      parsed_queue.close();
+      encoded_queue.close();
+    };
+    // runs a stage, and stops all of them on an exception, which is rethrown below
+    auto run_stage = [&](const auto& stage) {
+      try {
+        stage();
+      } catch (...) {
+        {
+          std::lock_guard<std::mutex> lock(pipeline_error_mutex);
+          if (!pipeline_error) {
+            pipeline_error = std::current_exception();
+          }
+        }
+        stop();
       }
+    };
+    std::atomic<size_t> num_running_parsers{max_threads};
+    std::atomic<size_t> num_running_encoders{num_encoder_threads};
+    // the rows of sharded tables are encoded shard by shard when they are loaded
+    const bool encode_dict_strings = !loader->getTableDesc()->nShards;
+
+    std::future<void> reader;
+    std::vector<std::future<void>> parsers;
+    std::vector<std::future<void>> encoders;
+    // unblocks the stages before their futures are joined on the way out
+    ScopeGuard stop_pipeline_on_exit = [&stop] { stop(); };
+
+    reader = std::async(std::launch::async, run_stage, [&]() {
+      ScopeGuard close_read_queue = [&read_queue] { read_queue.close(); };
+      // added for true row index on error
+      size_t first_row_index_this_buffer = 0;
+      while (size > 0 && !stop_pipeline) {
+        unsigned int num_rows_this_buffer = 0;
+        CHECK(scratch_buffer);
+        const auto end_pos =
+            delimited_parser::find_row_end_pos(alloc_size,
+                                               scratch_buffer,
+                                               size,
+                                               copy_params,
+                                               first_row_index_this_buffer,
+                                               num_rows_this_buffer,
+                                               p_file);
+
+        // unput residual
+        int nresidual = size - end_pos;
+        std::unique_ptr<char[]> unbuf;
+        if (nresidual > 0) {
+          unbuf = std::make_unique<char[]>(nresidual);
+          memcpy(unbuf.get(), scratch_buffer.get() + end_pos, nresidual);
+        }
 
-      // get a thread_id not in use
-      auto thread_id = stack_thread_ids.top();
-      stack_thread_ids.pop();
-      // LOG(INFO) << " stack_thread_ids.pop " << thread_id << std::endl;
-
-      threads.push_back(std::async(std::launch::async,
-                                   import_thread_delimited,
-                                   thread_id,
-                                   this,
-                                   std::move(scratch_buffer),
-                                   begin_pos,
-                                   end_pos,
-                                   end_pos,
-                                   columnIdToRenderGroupAnalyzerMap,
-                                   first_row_index_this_buffer));
-
-      first_row_index_this_buffer += num_rows_this_buffer;
-
-      current_pos += end_pos;
-      scratch_buffer = std::make_unique<char[]>(alloc_size);
-      CHECK(scratch_buffer);
-      memcpy(scratch_buffer.get(), unbuf.get(), nresidual);
-      size = nresidual +
-             fread(scratch_buffer.get() + nresidual, 1, alloc_size - nresidual, p_file);
-
-      begin_pos = 0;
-
-      while (threads.size() > 0) {
-        int nready = 0;
-        for (std::list<std::future<ImportStatus>>::iterator it = threads.begin();
-             it != threads.end();) {
-          auto& p = *it;
-          std::chrono::milliseconds span(
-              0);  //(std::distance(it, threads.end()) == 1? 1: 0);
-          if (p.wait_for(span) == std::future_status::ready) {
-            auto ret_import_status = p.get();
-            import_status += ret_import_status;
-            // sum up current total file offsets
-            size_t total_file_offset{0};
-            if (decompressed) {
-              std::unique_lock<std::mutex> lock(file_offsets_mutex);
-              for (const auto file_offset : file_offsets) {
-                total_file_offset += file_offset;
-              }
-            }
-            // estimate number of rows per current total file offset
-            if (decompressed ? total_file_offset : current_pos) {
-              import_status.rows_estimated =
-                  (decompressed ? (float)total_file_size / total_file_offset
-                                : (float)file_size / current_pos) *
-                  import_status.rows_completed;
-            }
-            VLOG(3) << "rows_completed " << import_status.rows_completed
-                    << ", rows_estimated " << import_status.rows_estimated
-                    << ", total_file_size " << total_file_size << ", total_file_offset "
-                    << total_file_offset;
-            set_import_status(import_id, import_status);
-            // recall thread_id for reuse
-            stack_thread_ids.push(ret_import_status.thread_id);
-            threads.erase(it++);
-            ++nready;
-          } else {
-            ++it;
+        if (!read_queue.push(
+                {std::move(scratch_buffer), end_pos, first_row_index_this_buffer})) {
+          break;
+        }
+        first_row_index_this_buffer += num_rows_this_buffer;
+
+        current_pos += end_pos;
+        scratch_buffer = std::make_unique<char[]>(alloc_size);
+        CHECK(scratch_buffer);
+        memcpy(scratch_buffer.get(), unbuf.get(), nresidual);
+        size = nresidual +
+               fread(scratch_buffer.get() + nresidual, 1, alloc_size - nresidual, p_file);
+      }
+    });
+
+    for (size_t i = 0; i < max_threads; ++i) {
+      parsers.push_back(std::async(std::launch::async, run_stage, [&]() {
+        ScopeGuard close_parsed_queue = [&] {
+          if (--num_running_parsers == 0) {
+            parsed_queue.close();
+          }
+        };
+        RowsBuffer rows_buffer;
+        size_t buffer_set;
+        while (!stop_pipeline && read_queue.pop(rows_buffer) &&
+               free_buffer_sets.pop(buffer_set)) {
+          if (!parsed_queue.push(
+                  import_thread_delimited(buffer_set,
+                                          this,
+                                          std::move(rows_buffer.buffer),
+                                          0,
+                                          rows_buffer.end_pos,
+                                          rows_buffer.end_pos,
+                                          columnIdToRenderGroupAnalyzerMap,
+                                          rows_buffer.first_row_index))) {
+            break;
           }
         }
+      }));
+    }
 
-        if (nready == 0) {
-          std::this_thread::yield();
+    for (size_t i = 0; i < num_encoder_threads; ++i) {
+      encoders.push_back(std::async(std::launch::async, run_stage, [&]() {
+        ScopeGuard close_encoded_queue = [&] {
+          if (--num_running_encoders == 0) {
+            encoded_queue.close();
+          }
+        };
+        ImportStatus parsed_import_status;
+        while (!stop_pipeline && parsed_queue.pop(parsed_import_status)) {
+          if (encode_dict_strings && parsed_import_status.rows_completed > 0) {
+            for (auto& import_buffer :
+                 import_buffers_vec[parsed_import_status.thread_id]) {
+              import_buffer->encodeDictStrings();
+            }
+          }
+          if (!encoded_queue.push(parsed_import_status)) {
+            break;
+          }
         }
+      }));
+    }
 
-        // on eof, wait all threads to finish
-        if (0 == size) {
-          continue;
+    int64_t total_load_ms = 0;
+    run_stage([&]() {
+      ImportStatus ret_import_status;
+      while (!stop_pipeline && encoded_queue.pop(ret_import_status)) {
+        if (ret_import_status.rows_completed > 0) {
+          total_load_ms += measure<>::execution([&]() {
+            load(import_buffers_vec[ret_import_status.thread_id],
+                 ret_import_status.rows_completed);
+          });
+        }
+        import_status += ret_import_status;
+        // sum up current total file offsets
+        size_t total_file_offset{0};
+        if (decompressed) {
+          std::unique_lock<std::mutex> lock(file_offsets_mutex);
+          for (const auto file_offset : file_offsets) {
+            total_file_offset += file_offset;
+          }
+        }
+        // estimate number of rows per current total file offset
+        const size_t read_pos = current_pos;
+        if (decompressed ? total_file_offset : read_pos) {
+          import_status.rows_estimated =
+              (decompressed ? (float)total_file_size / total_file_offset
+                            : (float)file_size / read_pos) *
+              import_status.rows_completed;
         }
+        VLOG(3) << "rows_completed " << import_status.rows_completed
+                << ", rows_estimated " << import_status.rows_estimated
+                << ", total_file_size " << total_file_size << ", total_file_offset "
+                << total_file_offset;
+        set_import_status(import_id, import_status);
+        free_buffer_sets.push(ret_import_status.thread_id);
 
-        // keep reading if any free thread slot
-        // this is one of the major difference from old threading model !!
-        if (threads.size() < max_threads) {
+        if (import_status.rows_rejected > copy_params.max_reject) {
+          load_truncated = true;
+          load_failed = true;
+          LOG(ERROR) << "Maximum rows rejected exceeded. Halting load";
+          break;
+        }
+        if (load_failed) {
+          load_truncated = true;
+          LOG(ERROR) << "A call to the Loader::load failed, Please review the logs for "
+                        "more details";
           break;
         }
       }
+    });
 
-      if (import_status.rows_rejected > copy_params.max_reject) {
-        load_truncated = true;
-        load_failed = true;
-        LOG(ERROR) << "Maximum rows rejected exceeded. Halting load";
-        break;
-      }
-      if (load_failed) {
-        load_truncated = true;
-        LOG(ERROR) << "A call to the Loader::load failed, Please review the logs for "
-                      "more details";
-        break;
-      }
+    // join the other stages, which are still running if the load was halted above
+    stop();
+    reader.wait();
+    for (auto& parser : parsers) {
+      parser.wait();
     }
-
-    // join dangling threads in case of LOG(ERROR) above
-    for (auto& p : threads) {
-      p.wait();
+    for (auto& encoder : encoders) {
+      encoder.wait();
+    }
+    if (DEBUG_TIMING) {
+      LOG(INFO) << "Loading the parsed rows took " << (double)total_load_ms / 1000.0
+                << " Seconds." << std::endl;
+    }
+    if (pipeline_error) {
+      std::rethrow_exception(pipeline_error);
     }
   }
 
@@ -4805,6 +5219,11 @@ ImportStatus Importer::importGDAL(
   }
 
 #if !DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
+  // the datasets the threads read from, by thread_id, opened by the first chunk of each
+  // and outliving the threads
+  std::vector<OGRDataSourceUqPtr> thread_datasets(max_threads);
+  std::vector<OGRLayer*> thread_layers(max_threads, nullptr);
+
   // threads
   std::list<std::future<ImportStatus>> threads;
 
@@ -4824,8 +5243,16 @@ ImportStatus Importer::importGDAL(
 
   static const size_t MAX_FEATURES_PER_CHUNK = 1000;
 
-  // make a features buffer for each thread
-  std::vector<FeaturePtrVector> features(max_threads);
+#if DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
+  const bool read_in_threads = false;
+#else
+  // the drivers which seek to a feature without reading the ones before it, e.g. the
+  // shapefiles, have the threads read their chunks of features too, each from a dataset
+  // of its own, the GDAL datasets can't be shared by threads
+  const bool read_in_threads = max_threads > 1 &&
+                               numFeatures > MAX_FEATURES_PER_CHUNK &&
+                               layer.TestCapability(OLCFastSetNextByIndex);
+#endif
 
   // for each feature...
   size_t firstFeatureThisChunk = 0;
@@ -4844,16 +5271,30 @@ ImportStatus Importer::importGDAL(
 #endif
 
     // fill features buffer for new thread
-    for (size_t i = 0; i < numFeaturesThisChunk; i++) {
-      features[thread_id].emplace_back(layer.GetNextFeature());
+    FeaturePtrVector features;
+    if (!read_in_threads) {
+      for (size_t i = 0; i < numFeaturesThisChunk; i++) {
+        features.emplace_back(layer.GetNextFeature());
+      }
+    }
+#if !DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
+    if (read_in_threads && !thread_layers[thread_id]) {
+      thread_datasets[thread_id].reset(openGDALDataset(file_path, copy_params));
+      if (thread_datasets[thread_id] == nullptr) {
+        throw std::runtime_error("openGDALDataset Error: Unable to open geo file " +
+                                 file_path);
+      }
+      thread_layers[thread_id] = &getLayerWithSpecifiedName(
+          copy_params.geo_layer_name, thread_datasets[thread_id], file_path);
     }
+#endif
 
 #if DISABLE_MULTI_THREADED_SHAPEFILE_IMPORT
     // call worker function directly
     auto ret_import_status = import_thread_shapefile(0,
                                                      this,
                                                      poGeographicSR.get(),
-                                                     std::move(features[thread_id]),
+                                                     features,
                                                      firstFeatureThisChunk,
                                                      numFeaturesThisChunk,
                                                      fieldNameToIndexMap,
@@ -4865,17 +5306,34 @@ ImportStatus Importer::importGDAL(
     set_import_status(import_id, import_status);
 #else
     // fire up that thread to import this geometry
-    threads.push_back(std::async(std::launch::async,
-                                 import_thread_shapefile,
-                                 thread_id,
-                                 this,
-                                 poGeographicSR.get(),
-                                 std::move(features[thread_id]),
-                                 firstFeatureThisChunk,
-                                 numFeaturesThisChunk,
-                                 fieldNameToIndexMap,
-                                 columnNameToSourceNameMap,
-                                 columnIdToRenderGroupAnalyzerMap));
+    threads.push_back(std::async(
+        std::launch::async,
+        [&,
+         thread_id,
+         firstFeatureThisChunk,
+         numFeaturesThisChunk,
+         features = std::move(features)]() mutable {
+          if (read_in_threads) {
+            auto thread_layer = thread_layers[thread_id];
+            if (thread_layer->SetNextByIndex(firstFeatureThisChunk) != OGRERR_NONE) {
+              throw std::runtime_error("Failed to seek to feature " +
+                                       std::to_string(firstFeatureThisChunk + 1) +
+                                       " of geo file " + file_path);
+            }
+            for (size_t i = 0; i < numFeaturesThisChunk; i++) {
+              features.emplace_back(thread_layer->GetNextFeature());
+            }
+          }
+          return import_thread_shapefile(thread_id,
+                                         this,
+                                         poGeographicSR.get(),
+                                         features,
+                                         firstFeatureThisChunk,
+                                         numFeaturesThisChunk,
+                                         fieldNameToIndexMap,
+                                         columnNameToSourceNameMap,
+                                         columnIdToRenderGroupAnalyzerMap);
+        }));
 
     // let the threads run
     while (threads.size() > 0) {
@@ -251,6 +251,12 @@ class TypedImportBuffer : boost::noncopyable {
 
   void addDictEncodedString(const std::vector<std::string>& string_vec);
 
+  /// Dictionary encodes the strings or string arrays added since the last clear(), so
+  /// that loading the buffer does not have to
+  void encodeDictStrings();
+
+  bool isDictEncoded() const { return dict_encoded_; }
+
   void addDictEncodedStringArray(
       const std::vector<std::vector<std::string>>& string_array_vec) {
     CHECK(string_dict_);
@@ -372,6 +378,7 @@ class TypedImportBuffer : boost::noncopyable {
   }
 
   void clear() {
+    dict_encoded_ = false;
     switch (column_desc_->columnType.get_type()) {
       case kBOOLEAN: {
         bool_buffer_->clear();
@@ -468,6 +475,15 @@ class TypedImportBuffer : boost::noncopyable {
                  const bool is_null,
                  const int64_t replicate_count = 0);
 
+  /// Adds an array of the elements of values, without a TDatum for each of them, e.g. for
+  /// the coords and the other physical columns of the geo columns, whose nulls are those
+  /// of the geo column
+  template <typename T>
+  void add_array_value(const ColumnDescriptor* cd,
+                       const std::vector<T>& values,
+                       const bool is_null,
+                       const int64_t replicate_count = 0);
+
   void pop_value();
 
   int64_t get_replicate_count() const { return replicate_count_; }
@@ -509,6 +525,7 @@ class TypedImportBuffer : boost::noncopyable {
   const ColumnDescriptor* column_desc_;
   StringDictionary* string_dict_;
   size_t replicate_count_ = 0;
+  bool dict_encoded_ = false;
 };
 
 class Loader {
@@ -674,8 +691,12 @@ class Detector : public DataStreamSink {
  private:
   void init();
   void read_file();
+  bool read_head_block();
   void detect_row_delimiter();
   void split_raw_data();
+  void split_sample_blocks();
+  std::vector<std::vector<std::string>> parse_sample_block(const size_t offset,
+                                                           const size_t num_cols) const;
   std::vector<SQLTypes> detect_column_types(const std::vector<std::string>& row);
   static bool more_restrictive_sqltype(const SQLTypes a, const SQLTypes b);
   void find_best_sqltypes();
@@ -698,6 +719,8 @@ class Detector : public DataStreamSink {
   ImportStatus importDelimited(const std::string& file_path,
                                const bool decompressed) override;
   std::string raw_data;
+  // the offsets of the blocks sampled besides the head of a large uncompressed file
+  std::vector<size_t> sample_block_offsets;
   boost::filesystem::path file_path;
   std::chrono::duration<double> timeout{1};
   std::string line1;
@@ -16,14 +16,29 @@
 
 #include <ImportExport/QueryExporterCSV.h>
 
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <boost/variant/get.hpp>
 
+#include <deque>
+#include <future>
+#include <sstream>
+
 #include <QueryEngine/GroupByAndAggregate.h>
 #include <QueryEngine/ResultSet.h>
 #include "Shared/misc.h"
+#include "Shared/thread_count.h"
 
 namespace import_export {
 
+namespace {
+
+// entries of the results formatted into one chunk of the file
+constexpr size_t kEntriesPerChunk{64 * 1024};
+
+}  // namespace
+
 QueryExporterCSV::QueryExporterCSV() : QueryExporter(FileType::kCSV) {}
 
 QueryExporterCSV::~QueryExporterCSV() {}
@@ -38,19 +53,26 @@ void QueryExporterCSV::beginExport(const std::string& file_path,
 
   // compression?
   auto actual_file_path{file_path};
-  if (file_compression != FileCompression::kNone) {
-    // @TODO(se) implement post-export compression
+  if (file_compression == FileCompression::kGZip) {
+    actual_file_path += ".gz";
+  } else if (file_compression != FileCompression::kNone) {
+    // @TODO(se) implement zip compression
     throw std::runtime_error("Compression not yet supported for this file type");
   }
 
   // open file
-  outfile_.open(actual_file_path);
+  outfile_.open(actual_file_path, std::ios_base::out | std::ios_base::binary);
   if (!outfile_) {
     throw std::runtime_error("Failed to create file '" + actual_file_path + "'");
   }
 
+  // keep these
+  copy_params_ = copy_params;
+  file_compression_ = file_compression;
+
   // write header?
   if (copy_params.has_header == import_export::ImportHeaderRow::HAS_HEADER) {
+    std::ostringstream header;
     bool not_first{false};
     int column_index = 0;
     for (auto const& column_info : column_infos) {
@@ -58,18 +80,16 @@ void QueryExporterCSV::beginExport(const std::string& file_path,
       auto column_name = safeColumnName(column_info.get_resname(), column_index + 1);
       // output to header line
       if (not_first) {
-        outfile_ << copy_params.delimiter;
+        header << copy_params.delimiter;
       } else {
         not_first = true;
       }
-      outfile_ << column_name;
+      header << column_name;
       column_index++;
     }
-    outfile_ << copy_params.line_delim;
+    header << copy_params.line_delim;
+    outfile_ << compressChunk(header.str());
   }
-
-  // keep these
-  copy_params_ = copy_params;
 }
 
 void QueryExporterCSV::exportResults(const std::vector<AggregatedResult>& query_results) {
@@ -77,125 +97,186 @@ void QueryExporterCSV::exportResults(const std::vector<AggregatedResult>& query_
     auto results = agg_result.rs;
     auto const& targets = agg_result.targets_meta;
 
-    while (true) {
-      auto const crt_row = results->getNextRow(true, true);
-      if (crt_row.empty()) {
-        break;
-      }
-      bool not_first = false;
-      for (size_t i = 0; i < results->colCount(); ++i) {
-        bool is_null{false};
-        auto const tv = crt_row[i];
-        auto const scalar_tv = boost::get<ScalarTargetValue>(&tv);
-        if (not_first) {
-          outfile_ << copy_params_.delimiter;
-        } else {
-          not_first = true;
+    if (!use_parallel_algorithms(*results)) {
+      // small or truncated results, which only iterate from the start
+      std::ostringstream chunk;
+      size_t row_count{0};
+      while (true) {
+        auto const crt_row = results->getNextRow(true, true);
+        if (crt_row.empty()) {
+          break;
         }
-        if (copy_params_.quoted) {
-          outfile_ << copy_params_.quote;
+        writeRow(chunk, crt_row, targets);
+        if (++row_count % kEntriesPerChunk == 0) {
+          outfile_ << compressChunk(chunk.str());
+          chunk.str("");
         }
-        auto const& ti = targets[i].get_type_info();
-        if (!scalar_tv) {
-          outfile_ << datum_to_string(crt_row[i], ti, " | ");
-          if (copy_params_.quoted) {
-            outfile_ << copy_params_.quote;
-          }
-          continue;
+      }
+      outfile_ << compressChunk(chunk.str());
+      continue;
+    }
+
+    // ranges of entries are formatted and compressed in parallel, and written in order,
+    // with up to one range per thread in memory
+    const auto entry_count = results->entryCount();
+    const auto max_chunks = static_cast<size_t>(cpu_threads());
+    auto format_chunk = [this, &results, &targets](const size_t start_entry,
+                                                   const size_t end_entry) {
+      std::ostringstream chunk;
+      for (size_t i = start_entry; i < end_entry; ++i) {
+        auto const crt_row = results->getRowAtWithTranslations(i, true);
+        if (!crt_row.empty()) {
+          writeRow(chunk, crt_row, targets);
         }
-        if (boost::get<int64_t>(scalar_tv)) {
-          auto int_val = *(boost::get<int64_t>(scalar_tv));
-          switch (ti.get_type()) {
-            case kBOOLEAN:
-              is_null = (int_val == NULL_BOOLEAN);
-              break;
-            case kTINYINT:
-              is_null = (int_val == NULL_TINYINT);
-              break;
-            case kSMALLINT:
-              is_null = (int_val == NULL_SMALLINT);
-              break;
-            case kINT:
-              is_null = (int_val == NULL_INT);
-              break;
-            case kBIGINT:
-              is_null = (int_val == NULL_BIGINT);
-              break;
-            case kTIME:
-            case kTIMESTAMP:
-            case kDATE:
-              is_null = (int_val == NULL_BIGINT);
-              break;
-            default:
-              is_null = false;
-          }
-          if (is_null) {
-            outfile_ << copy_params_.null_str;
-          } else if (ti.get_type() == kTIME) {
-            constexpr size_t buf_size = 9;
-            char buf[buf_size];
-            size_t const len = shared::formatHMS(buf, buf_size, int_val);
-            CHECK_EQ(8u, len);  // 8 == strlen("HH:MM:SS")
-            outfile_ << buf;
-          } else {
-            outfile_ << int_val;
-          }
-        } else if (boost::get<double>(scalar_tv)) {
-          auto real_val = *(boost::get<double>(scalar_tv));
-          if (ti.get_type() == kFLOAT) {
-            is_null = (real_val == NULL_FLOAT);
-          } else {
-            is_null = (real_val == NULL_DOUBLE);
-          }
-          if (is_null) {
-            outfile_ << copy_params_.null_str;
-          } else if (ti.get_type() == kNUMERIC) {
-            outfile_ << std::setprecision(ti.get_precision()) << real_val;
-          } else {
-            outfile_ << std::setprecision(std::numeric_limits<double>::digits10 + 1)
-                     << real_val;
-          }
-        } else if (boost::get<float>(scalar_tv)) {
-          CHECK_EQ(kFLOAT, ti.get_type());
-          auto real_val = *(boost::get<float>(scalar_tv));
-          if (real_val == NULL_FLOAT) {
-            outfile_ << copy_params_.null_str;
-          } else {
-            outfile_ << std::setprecision(std::numeric_limits<float>::digits10 + 1)
-                     << real_val;
-          }
+      }
+      return compressChunk(chunk.str());
+    };
+    std::deque<std::future<std::string>> chunks;
+    for (size_t start_entry = 0; start_entry < entry_count;
+         start_entry += kEntriesPerChunk) {
+      const auto end_entry = std::min(entry_count, start_entry + kEntriesPerChunk);
+      if (chunks.size() == max_chunks) {
+        outfile_ << chunks.front().get();
+        chunks.pop_front();
+      }
+      chunks.push_back(
+          std::async(std::launch::async, format_chunk, start_entry, end_entry));
+    }
+    for (auto& chunk : chunks) {
+      outfile_ << chunk.get();
+    }
+  }
+}
+
+void QueryExporterCSV::writeRow(std::ostream& out,
+                                const std::vector<TargetValue>& crt_row,
+                                const std::vector<TargetMetaInfo>& targets) const {
+  bool not_first = false;
+  for (size_t i = 0; i < crt_row.size(); ++i) {
+    bool is_null{false};
+    auto const tv = crt_row[i];
+    auto const scalar_tv = boost::get<ScalarTargetValue>(&tv);
+    if (not_first) {
+      out << copy_params_.delimiter;
+    } else {
+      not_first = true;
+    }
+    if (copy_params_.quoted) {
+      out << copy_params_.quote;
+    }
+    auto const& ti = targets[i].get_type_info();
+    if (!scalar_tv) {
+      out << datum_to_string(crt_row[i], ti, " | ");
+      if (copy_params_.quoted) {
+        out << copy_params_.quote;
+      }
+      continue;
+    }
+    if (boost::get<int64_t>(scalar_tv)) {
+      auto int_val = *(boost::get<int64_t>(scalar_tv));
+      switch (ti.get_type()) {
+        case kBOOLEAN:
+          is_null = (int_val == NULL_BOOLEAN);
+          break;
+        case kTINYINT:
+          is_null = (int_val == NULL_TINYINT);
+          break;
+        case kSMALLINT:
+          is_null = (int_val == NULL_SMALLINT);
+          break;
+        case kINT:
+          is_null = (int_val == NULL_INT);
+          break;
+        case kBIGINT:
+          is_null = (int_val == NULL_BIGINT);
+          break;
+        case kTIME:
+        case kTIMESTAMP:
+        case kDATE:
+          is_null = (int_val == NULL_BIGINT);
+          break;
+        default:
+          is_null = false;
+      }
+      if (is_null) {
+        out << copy_params_.null_str;
+      } else if (ti.get_type() == kTIME) {
+        constexpr size_t buf_size = 9;
+        char buf[buf_size];
+        size_t const len = shared::formatHMS(buf, buf_size, int_val);
+        CHECK_EQ(8u, len);  // 8 == strlen("HH:MM:SS")
+        out << buf;
+      } else {
+        out << int_val;
+      }
+    } else if (boost::get<double>(scalar_tv)) {
+      auto real_val = *(boost::get<double>(scalar_tv));
+      if (ti.get_type() == kFLOAT) {
+        is_null = (real_val == NULL_FLOAT);
+      } else {
+        is_null = (real_val == NULL_DOUBLE);
+      }
+      if (is_null) {
+        out << copy_params_.null_str;
+      } else if (ti.get_type() == kNUMERIC) {
+        out << std::setprecision(ti.get_precision()) << real_val;
+      } else {
+        out << std::setprecision(std::numeric_limits<double>::digits10 + 1)
+                 << real_val;
+      }
+    } else if (boost::get<float>(scalar_tv)) {
+      CHECK_EQ(kFLOAT, ti.get_type());
+      auto real_val = *(boost::get<float>(scalar_tv));
+      if (real_val == NULL_FLOAT) {
+        out << copy_params_.null_str;
+      } else {
+        out << std::setprecision(std::numeric_limits<float>::digits10 + 1)
+                 << real_val;
+      }
+    } else {
+      auto s = boost::get<NullableString>(scalar_tv);
+      is_null = !s || boost::get<void*>(s);
+      if (is_null) {
+        out << copy_params_.null_str;
+      } else {
+        auto s_notnull = boost::get<std::string>(s);
+        CHECK(s_notnull);
+        if (!copy_params_.quoted) {
+          out << *s_notnull;
         } else {
-          auto s = boost::get<NullableString>(scalar_tv);
-          is_null = !s || boost::get<void*>(s);
-          if (is_null) {
-            outfile_ << copy_params_.null_str;
+          size_t q = s_notnull->find(copy_params_.quote);
+          if (q == std::string::npos) {
+            out << *s_notnull;
           } else {
-            auto s_notnull = boost::get<std::string>(s);
-            CHECK(s_notnull);
-            if (!copy_params_.quoted) {
-              outfile_ << *s_notnull;
-            } else {
-              size_t q = s_notnull->find(copy_params_.quote);
-              if (q == std::string::npos) {
-                outfile_ << *s_notnull;
-              } else {
-                std::string str(*s_notnull);
-                while (q != std::string::npos) {
-                  str.insert(q, 1, copy_params_.escape);
-                  q = str.find(copy_params_.quote, q + 2);
-                }
-                outfile_ << str;
-              }
+            std::string str(*s_notnull);
+            while (q != std::string::npos) {
+              str.insert(q, 1, copy_params_.escape);
+              q = str.find(copy_params_.quote, q + 2);
             }
+            out << str;
           }
         }
-        if (copy_params_.quoted) {
-          outfile_ << copy_params_.quote;
-        }
       }
-      outfile_ << copy_params_.line_delim;
     }
+    if (copy_params_.quoted) {
+      out << copy_params_.quote;
+    }
+  }
+  out << copy_params_.line_delim;
+}
+
+std::string QueryExporterCSV::compressChunk(std::string chunk) const {
+  if (file_compression_ != FileCompression::kGZip || chunk.empty()) {
+    return chunk;
+  }
+  std::string compressed;
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(boost::iostreams::back_inserter(compressed));
+    out.write(chunk.data(), chunk.size());
   }
+  return compressed;
 }
 
 void QueryExporterCSV::endExport() {
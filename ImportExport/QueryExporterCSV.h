@@ -17,6 +17,9 @@
 #pragma once
 
 #include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include <ImportExport/QueryExporter.h>
 
@@ -37,8 +40,15 @@ class QueryExporterCSV : public QueryExporter {
   void endExport() final;
 
  private:
+  void writeRow(std::ostream& out,
+                const std::vector<TargetValue>& crt_row,
+                const std::vector<TargetMetaInfo>& targets) const;
+  // gzip members concatenate into a valid file, so chunks are compressed separately
+  std::string compressChunk(std::string chunk) const;
+
   std::ofstream outfile_;
   CopyParams copy_params_;
+  FileCompression file_compression_{FileCompression::kNone};
 };
 
 }  // namespace import_export
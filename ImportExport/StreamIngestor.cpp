@@ -0,0 +1,601 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ImportExport/StreamIngestor.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/regex.hpp>
+#include <chrono>
+#include <string_view>
+
+#include <librdkafka/rdkafkacpp.h>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "ImportExport/DelimitedParserUtils.h"
+#include "ImportExport/Importer.h"
+#include "LockMgr/LockMgr.h"
+#include "Logger/Logger.h"
+#include "Shared/mapd_shared_mutex.h"
+#include "Shared/scope.h"
+#include "Shared/thread_count.h"
+
+bool g_resume_table_streams{true};
+
+namespace import_export {
+
+namespace {
+
+// how long a consumer waits for a message before it checks whether to stop
+constexpr int kConsumeTimeoutMs{100};
+constexpr int kMetadataTimeoutMs{10000};
+
+}  // namespace
+
+StreamIngestor::Consumer::~Consumer() {
+  if (kafkaConsumer) {
+    kafkaConsumer->close();
+  }
+}
+
+StreamIngestor::StreamIngestor(Catalog_Namespace::Catalog& catalog,
+                               const TableDescriptor* td,
+                               const std::string& source,
+                               const CopyParams& copy_params)
+    : catalog_(catalog)
+    , tableId_(td->tableId)
+    , tableName_(td->tableName)
+    , source_(source)
+    , copy_params_(copy_params) {
+  if (td->isView || td->storageType == StorageType::FOREIGN_TABLE) {
+    throw std::runtime_error("Streams can only be ingested into tables, " +
+                             td->tableName + " is not one.");
+  }
+  std::tie(brokers_, topics_) = parseKafkaUrl(source_);
+  loader_ = std::make_unique<Loader>(catalog_, td);
+  for (const auto cd : loader_->get_column_descs()) {
+    if (cd->columnType.is_geometry()) {
+      throw std::runtime_error("Streams cannot be ingested into table " + td->tableName +
+                               ", which has the geo column " + cd->columnName + ".");
+    }
+  }
+  num_columns_ = loader_->get_column_descs().size();
+  is_array_.reset(new bool[num_columns_]);
+  size_t col_idx = 0;
+  for (const auto cd : loader_->get_column_descs()) {
+    is_array_[col_idx++] = cd->columnType.get_type() == kARRAY;
+  }
+  committedOffsets_ = catalog_.getTableStreamOffsets(tableId_);
+
+  // the partitions of the topics, as the brokers have them now
+  std::vector<TopicPartition> partitions;
+  {
+    const auto metadata_consumer = createKafkaConsumer();
+    ScopeGuard close_metadata_consumer = [&metadata_consumer] {
+      metadata_consumer->close();
+    };
+    for (const auto& topic : topics_) {
+      std::string errstr;
+      std::unique_ptr<RdKafka::Topic> kafka_topic(
+          RdKafka::Topic::create(metadata_consumer.get(), topic, nullptr, errstr));
+      if (!kafka_topic) {
+        throw std::runtime_error("Could not open Kafka topic " + topic + ": " + errstr);
+      }
+      RdKafka::Metadata* metadata_ptr{nullptr};
+      const auto err = metadata_consumer->metadata(
+          false, kafka_topic.get(), &metadata_ptr, kMetadataTimeoutMs);
+      std::unique_ptr<RdKafka::Metadata> metadata(metadata_ptr);
+      if (err != RdKafka::ERR_NO_ERROR) {
+        throw std::runtime_error("Could not get the partitions of Kafka topic " + topic +
+                                 ": " + RdKafka::err2str(err));
+      }
+      for (const auto topic_metadata : *metadata->topics()) {
+        if (topic_metadata->topic() != topic) {
+          continue;
+        }
+        if (topic_metadata->err() != RdKafka::ERR_NO_ERROR) {
+          throw std::runtime_error("Could not get the partitions of Kafka topic " +
+                                   topic + ": " +
+                                   RdKafka::err2str(topic_metadata->err()));
+        }
+        for (const auto partition_metadata : *topic_metadata->partitions()) {
+          partitions.emplace_back(topic, partition_metadata->id());
+        }
+      }
+    }
+  }
+  if (partitions.empty()) {
+    throw std::runtime_error("The Kafka topics of " + source_ + " have no partitions.");
+  }
+
+  const size_t max_consumers = copy_params_.kafka_consumers > 0
+                                   ? copy_params_.kafka_consumers
+                                   : static_cast<size_t>(cpu_threads());
+  consumers_.resize(std::min(partitions.size(), max_consumers));
+  for (auto& consumer : consumers_) {
+    consumer = std::make_unique<Consumer>();
+  }
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    consumers_[i % consumers_.size()]->partitions.push_back(partitions[i]);
+  }
+  for (auto& consumer : consumers_) {
+    consumer->kafkaConsumer = createKafkaConsumer();
+    std::vector<RdKafka::TopicPartition*> assignment;
+    ScopeGuard destroy_assignment = [&assignment] {
+      RdKafka::TopicPartition::destroy(assignment);
+    };
+    for (const auto& partition : consumer->partitions) {
+      const auto it = committedOffsets_.find(partition);
+      const int64_t offset =
+          it != committedOffsets_.end()
+              ? it->second
+              : (copy_params_.kafka_from_latest ? RdKafka::Topic::OFFSET_END
+                                                : RdKafka::Topic::OFFSET_BEGINNING);
+      assignment.push_back(
+          RdKafka::TopicPartition::create(partition.first, partition.second, offset));
+    }
+    const auto err = consumer->kafkaConsumer->assign(assignment);
+    if (err != RdKafka::ERR_NO_ERROR) {
+      throw std::runtime_error("Could not assign the partitions of " + source_ + ": " +
+                               RdKafka::err2str(err));
+    }
+    consumer->batch.buffers = createImportBuffers();
+    consumer->spare.buffers = createImportBuffers();
+  }
+
+  for (auto& consumer : consumers_) {
+    consumer->thread = std::thread(&StreamIngestor::consume, this, std::ref(*consumer));
+  }
+  commitThread_ = std::thread(&StreamIngestor::runCommits, this);
+  LOG(INFO) << "Ingesting " << partitions.size() << " partitions of " << source_
+            << " into table " << tableName_ << " with " << consumers_.size()
+            << " consumers";
+}
+
+StreamIngestor::~StreamIngestor() {
+  requestStop();
+  if (commitThread_.joinable()) {
+    commitThread_.join();
+  }
+  for (auto& consumer : consumers_) {
+    if (consumer->thread.joinable()) {
+      consumer->thread.join();
+    }
+  }
+}
+
+std::string StreamIngestor::getError() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return error_;
+}
+
+bool StreamIngestor::isKafkaUrl(const std::string& url) {
+  return boost::istarts_with(boost::trim_left_copy(url), "kafka://");
+}
+
+std::pair<std::string, std::vector<std::string>> StreamIngestor::parseKafkaUrl(
+    const std::string& url) {
+  static const boost::regex kafka_url_regex{R"(^\s*kafka://([^/]+)/(.+?)\s*$)",
+                                            boost::regex::perl | boost::regex::icase};
+  boost::smatch what;
+  if (!boost::regex_match(url, what, kafka_url_regex)) {
+    throw std::runtime_error("Invalid Kafka source " + url +
+                             ", expected kafka://<brokers>/<topics>.");
+  }
+  std::vector<std::string> topics;
+  boost::split(topics, what[2].str(), boost::is_any_of(","));
+  for (auto& topic : topics) {
+    boost::trim(topic);
+    if (topic.empty()) {
+      throw std::runtime_error("Invalid Kafka source " + url + ", a topic is empty.");
+    }
+  }
+  return {what[1].str(), topics};
+}
+
+std::string StreamIngestor::serializeCopyParams(const CopyParams& copy_params) {
+  rapidjson::Document document;
+  document.SetObject();
+  auto& allocator = document.GetAllocator();
+  const auto add_string = [&document, &allocator](const char* name,
+                                                  const std::string& value) {
+    document.AddMember(rapidjson::StringRef(name),
+                       rapidjson::Value().SetString(value.c_str(), allocator),
+                       allocator);
+  };
+  add_string("delimiter", std::string(1, copy_params.delimiter));
+  add_string("nulls", copy_params.null_str);
+  document.AddMember("quoted", copy_params.quoted, allocator);
+  add_string("quote", std::string(1, copy_params.quote));
+  add_string("escape", std::string(1, copy_params.escape));
+  add_string("line_delimiter", std::string(1, copy_params.line_delim));
+  add_string("array_delimiter", std::string(1, copy_params.array_delim));
+  add_string("array_marker",
+             std::string{copy_params.array_begin, copy_params.array_end});
+  add_string("kafka_group_id", copy_params.kafka_group_id);
+  document.AddMember("kafka_from_latest", copy_params.kafka_from_latest, allocator);
+  document.AddMember(
+      "kafka_consumers", static_cast<uint64_t>(copy_params.kafka_consumers), allocator);
+  document.AddMember(
+      "kafka_batch_ms", static_cast<uint64_t>(copy_params.kafka_batch_ms), allocator);
+  document.AddMember(
+      "kafka_batch_rows", static_cast<uint64_t>(copy_params.kafka_batch_rows), allocator);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  return buffer.GetString();
+}
+
+CopyParams StreamIngestor::deserializeCopyParams(const std::string& json) {
+  rapidjson::Document document;
+  if (document.Parse(json.c_str()).HasParseError() || !document.IsObject()) {
+    throw std::runtime_error("Invalid stream options " + json);
+  }
+  CopyParams copy_params;
+  const auto get_string = [&document, &json](const char* name,
+                                             const size_t size) -> std::string {
+    if (!document.HasMember(name) || !document[name].IsString() ||
+        (size && document[name].GetStringLength() != size)) {
+      throw std::runtime_error("Invalid stream options " + json);
+    }
+    return document[name].GetString();
+  };
+  const auto get_uint = [&document, &json](const char* name) -> size_t {
+    if (!document.HasMember(name) || !document[name].IsUint64()) {
+      throw std::runtime_error("Invalid stream options " + json);
+    }
+    return document[name].GetUint64();
+  };
+  const auto get_bool = [&document, &json](const char* name) -> bool {
+    if (!document.HasMember(name) || !document[name].IsBool()) {
+      throw std::runtime_error("Invalid stream options " + json);
+    }
+    return document[name].GetBool();
+  };
+  copy_params.delimiter = get_string("delimiter", 1)[0];
+  copy_params.null_str = get_string("nulls", 0);
+  copy_params.quoted = get_bool("quoted");
+  copy_params.quote = get_string("quote", 1)[0];
+  copy_params.escape = get_string("escape", 1)[0];
+  copy_params.line_delim = get_string("line_delimiter", 1)[0];
+  copy_params.array_delim = get_string("array_delimiter", 1)[0];
+  const auto array_marker = get_string("array_marker", 2);
+  copy_params.array_begin = array_marker[0];
+  copy_params.array_end = array_marker[1];
+  copy_params.kafka_group_id = get_string("kafka_group_id", 0);
+  copy_params.kafka_from_latest = get_bool("kafka_from_latest");
+  copy_params.kafka_consumers = get_uint("kafka_consumers");
+  copy_params.kafka_batch_ms = get_uint("kafka_batch_ms");
+  copy_params.kafka_batch_rows = get_uint("kafka_batch_rows");
+  return copy_params;
+}
+
+std::unique_ptr<RdKafka::KafkaConsumer> StreamIngestor::createKafkaConsumer() const {
+  std::unique_ptr<RdKafka::Conf> conf(RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
+  // partitions are assigned explicitly and their offsets kept in the catalog, the
+  // group only gets the offsets reported
+  const std::vector<std::pair<std::string, std::string>> settings{
+      {"metadata.broker.list", brokers_},
+      {"group.id",
+       copy_params_.kafka_group_id.empty() ? "omnisci_" + tableName_
+                                           : copy_params_.kafka_group_id},
+      {"enable.auto.commit", "false"},
+      {"enable.auto.offset.store", "false"},
+      {"enable.partition.eof", "false"}};
+  std::string errstr;
+  for (const auto& [name, value] : settings) {
+    if (conf->set(name, value, errstr) != RdKafka::Conf::CONF_OK) {
+      throw std::runtime_error("Invalid Kafka setting " + name + ": " + errstr);
+    }
+  }
+  std::unique_ptr<RdKafka::KafkaConsumer> consumer(
+      RdKafka::KafkaConsumer::create(conf.get(), errstr));
+  if (!consumer) {
+    throw std::runtime_error("Could not create a Kafka consumer for " + source_ + ": " +
+                             errstr);
+  }
+  return consumer;
+}
+
+StreamIngestor::ImportBuffers StreamIngestor::createImportBuffers() const {
+  ImportBuffers buffers;
+  for (const auto cd : loader_->get_column_descs()) {
+    buffers.emplace_back(
+        std::make_unique<TypedImportBuffer>(cd, loader_->getStringDict(cd)));
+  }
+  return buffers;
+}
+
+void StreamIngestor::consume(Consumer& consumer) {
+  while (!stop_) {
+    {
+      // the commit thread takes the batch within kafka_batch_ms
+      std::unique_lock<std::mutex> lock(consumer.mutex);
+      consumer.batchTaken.wait(lock, [this, &consumer] {
+        return stop_ || consumer.batch.numRows < copy_params_.kafka_batch_rows;
+      });
+    }
+    if (stop_) {
+      break;
+    }
+    std::unique_ptr<RdKafka::Message> message(
+        consumer.kafkaConsumer->consume(kConsumeTimeoutMs));
+    switch (message->err()) {
+      case RdKafka::ERR_NO_ERROR: {
+        std::lock_guard<std::mutex> lock(consumer.mutex);
+        consumer.batch.numRejected +=
+            parseMessage(static_cast<const char*>(message->payload()),
+                         message->len(),
+                         consumer.batch);
+        consumer.batch.nextOffsets[{message->topic_name(), message->partition()}] =
+            message->offset() + 1;
+        break;
+      }
+      case RdKafka::ERR__TIMED_OUT:
+      case RdKafka::ERR__PARTITION_EOF:
+        break;
+      case RdKafka::ERR__UNKNOWN_TOPIC:
+      case RdKafka::ERR__UNKNOWN_PARTITION:
+      case RdKafka::ERR_TOPIC_AUTHORIZATION_FAILED:
+      case RdKafka::ERR__FATAL:
+        fail("Consuming " + source_ + " failed: " + message->errstr());
+        return;
+      default:
+        // the client retries by itself, e.g. while the brokers are down
+        LOG(WARNING) << "Consuming " << source_ << " into table " << tableName_ << ": "
+                     << message->errstr();
+    }
+  }
+}
+
+size_t StreamIngestor::parseMessage(const char* payload,
+                                    const size_t size,
+                                    Batch& batch) const {
+  if (!payload || size == 0) {
+    return 0;
+  }
+  // get_row() expects every row to end with a line delimiter
+  std::string rows(payload, size);
+  if (rows.back() != copy_params_.line_delim) {
+    rows.push_back(copy_params_.line_delim);
+  }
+  const char* end = rows.data() + rows.size();
+  size_t num_rejected{0};
+  std::vector<std::string_view> row;
+  bool try_single_thread{false};
+  for (const char* p = rows.data(); p < end; ++p) {
+    row.clear();
+    std::vector<std::unique_ptr<char[]>> tmp_buffers;
+    p = delimited_parser::get_row(
+        p, end, end, copy_params_, is_array_.get(), row, tmp_buffers, try_single_thread);
+    if (row.size() != num_columns_) {
+      ++num_rejected;
+      continue;
+    }
+    size_t col_idx = 0;
+    try {
+      for (const auto cd : loader_->get_column_descs()) {
+        const auto field = row[col_idx];
+        // as COPY FROM has it, "NULL" and empty non-string fields are nulls too
+        const bool is_null = field == copy_params_.null_str || field == "NULL" ||
+                             (!cd->columnType.is_string() && field.empty());
+        batch.buffers[col_idx]->add_value(cd, field, is_null, copy_params_);
+        ++col_idx;
+      }
+      ++batch.numRows;
+    } catch (const std::exception&) {
+      for (size_t col_idx_to_pop = 0; col_idx_to_pop < col_idx; ++col_idx_to_pop) {
+        batch.buffers[col_idx_to_pop]->pop_value();
+      }
+      ++num_rejected;
+    }
+  }
+  return num_rejected;
+}
+
+void StreamIngestor::runCommits() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    stopped_.wait_for(lock,
+                      std::chrono::milliseconds(copy_params_.kafka_batch_ms),
+                      [this] { return stop_.load(); });
+    if (stop_) {
+      break;
+    }
+    lock.unlock();
+    try {
+      commit();
+    } catch (const std::exception& e) {
+      fail("Committing the rows of " + source_ + " failed: " + e.what());
+    }
+    lock.lock();
+  }
+}
+
+void StreamIngestor::commit() {
+  std::vector<Batch*> batches;
+  size_t num_rows{0};
+  size_t num_rejected{0};
+  for (auto& consumer : consumers_) {
+    {
+      std::lock_guard<std::mutex> lock(consumer->mutex);
+      if (consumer->batch.nextOffsets.empty()) {
+        continue;
+      }
+      std::swap(consumer->batch, consumer->spare);
+    }
+    consumer->batchTaken.notify_all();
+    batches.push_back(&consumer->spare);
+    num_rows += consumer->spare.numRows;
+    num_rejected += consumer->spare.numRejected;
+  }
+  if (batches.empty()) {
+    return;
+  }
+  // the batches become the spares of the consumers, also when the commit fails
+  ScopeGuard clear_batches = [&batches] {
+    for (auto batch : batches) {
+      for (auto& buffer : batch->buffers) {
+        buffer->clear();
+      }
+      batch->numRows = 0;
+      batch->numRejected = 0;
+      batch->nextOffsets.clear();
+    }
+  };
+
+  {
+    // as COPY FROM, prevents a concurrent truncate
+    const auto execute_read_lock = mapd_shared_lock<mapd_shared_mutex>(
+        *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
+            legacylockmgr::ExecutorOuterLock, true));
+    const auto td_with_lock =
+        lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+            catalog_, tableName_);
+    const auto td = td_with_lock();
+    if (td->tableId != tableId_ ||
+        catalog_.getAllColumnMetadataForTable(tableId_, false, false, true).size() !=
+            num_columns_) {
+      throw std::runtime_error("Table " + tableName_ +
+                               " changed, the stream has to be started again.");
+    }
+    const auto insert_data_lock =
+        lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog_, tableName_);
+    const auto start_epoch = loader_->getTableEpoch();
+    bool loaded{true};
+    for (const auto batch : batches) {
+      if (batch->numRows > 0) {
+        loaded = loader_->loadNoCheckpoint(batch->buffers, batch->numRows) && loaded;
+      }
+    }
+    if (!loaded) {
+      loader_->setTableEpoch(start_epoch);
+      throw std::runtime_error("Could not load the rows into table " + tableName_ + ".");
+    }
+    for (const auto batch : batches) {
+      for (const auto& [partition, next_offset] : batch->nextOffsets) {
+        committedOffsets_[partition] = next_offset;
+      }
+    }
+    // recorded first, so that the checkpoint makes the rows and offsets durable at once
+    catalog_.recordTableStreamOffsets(tableId_, start_epoch, committedOffsets_);
+    loader_->checkpoint();
+  }
+  VLOG(1) << "Committed " << num_rows << " rows of " << source_ << " into table "
+          << tableName_;
+  if (num_rejected > 0) {
+    LOG(WARNING) << "Rejected " << num_rejected << " rows of " << source_
+                 << " for table " << tableName_;
+  }
+
+  if (!copy_params_.kafka_group_id.empty()) {
+    for (auto& consumer : consumers_) {
+      std::vector<RdKafka::TopicPartition*> offsets;
+      for (const auto& partition : consumer->partitions) {
+        const auto it = committedOffsets_.find(partition);
+        if (it != committedOffsets_.end()) {
+          offsets.push_back(RdKafka::TopicPartition::create(
+              partition.first, partition.second, it->second));
+        }
+      }
+      if (!offsets.empty()) {
+        consumer->kafkaConsumer->commitAsync(offsets);
+      }
+      RdKafka::TopicPartition::destroy(offsets);
+    }
+  }
+}
+
+void StreamIngestor::requestStop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  stopped_.notify_all();
+  for (auto& consumer : consumers_) {
+    {
+      std::lock_guard<std::mutex> lock(consumer->mutex);
+    }
+    consumer->batchTaken.notify_all();
+  }
+}
+
+void StreamIngestor::fail(const std::string& error) {
+  LOG(ERROR) << "Stopped the stream into table " << tableName_ << ": " << error;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error_.empty()) {
+      error_ = error;
+    }
+  }
+  requestStop();
+}
+
+StreamIngestMgr& StreamIngestMgr::instance() {
+  static StreamIngestMgr stream_ingest_mgr;
+  return stream_ingest_mgr;
+}
+
+void StreamIngestMgr::startStream(Catalog_Namespace::Catalog& catalog,
+                                  const TableDescriptor* td,
+                                  const std::string& source,
+                                  const CopyParams& copy_params) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto key = std::make_pair(catalog.getDatabaseId(), td->tableId);
+  // stopped first, so that the new stream continues from the offsets it committed
+  streams_.erase(key);
+  auto stream = std::make_unique<StreamIngestor>(catalog, td, source, copy_params);
+  catalog.addTableStream(
+      {td->tableId, source, StreamIngestor::serializeCopyParams(copy_params)});
+  streams_[key] = std::move(stream);
+}
+
+bool StreamIngestMgr::stopStream(Catalog_Namespace::Catalog& catalog, const int tableId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  bool found = streams_.erase(std::make_pair(catalog.getDatabaseId(), tableId)) > 0;
+  for (const auto& stream : catalog.getTableStreams()) {
+    found = found || stream.tableId == tableId;
+  }
+  catalog.removeTableStream(tableId);
+  return found;
+}
+
+void StreamIngestMgr::resumeStreams(Catalog_Namespace::Catalog& catalog) {
+  for (const auto& stream : catalog.getTableStreams()) {
+    const auto td = catalog.getMetadataForTable(stream.tableId, false);
+    if (!td) {
+      catalog.removeTableStream(stream.tableId);
+      continue;
+    }
+    try {
+      startStream(catalog,
+                  td,
+                  stream.source,
+                  StreamIngestor::deserializeCopyParams(stream.options));
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Could not resume the stream of " << stream.source << " into table "
+                 << td->tableName << ": " << e.what();
+    }
+  }
+}
+
+void StreamIngestMgr::stopAll() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_.clear();
+}
+
+}  // namespace import_export
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    StreamIngestor.h
+ * @brief   Ingestion of Kafka topics into tables from within the server
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Catalog/Catalog.h"
+#include "ImportExport/CopyParams.h"
+
+namespace RdKafka {
+class KafkaConsumer;
+}  // namespace RdKafka
+
+namespace import_export {
+
+class Loader;
+class TypedImportBuffer;
+
+/**
+ * Ingests the delimited rows of the messages of Kafka topics into a table, as started by
+ * COPY <table> FROM 'kafka://<brokers>/<topics>'. A message holds one or more rows.
+ *
+ * The partitions of the topics are spread over consumer threads, which parse their
+ * messages into columnar buffers of their own. Every kafka_batch_ms, a commit thread
+ * takes the buffers of all consumers, which go on consuming into spare ones, loads them
+ * into the table and checkpoints the table once for all of them (group commit).
+ *
+ * Offsets are tracked by the server, not by Kafka: every commit records the offsets
+ * consumed up to in the catalog, with the epoch the rows were loaded at, before the
+ * checkpoint. A restarted stream continues from the offsets of the last checkpointed
+ * epoch, so every message is loaded exactly once. Commits hold the insert lock of the
+ * table, so that no other insert checkpoints the rows of a commit before its offsets
+ * are recorded. Offsets are also reported to kafka_group_id, if set, for monitoring.
+ *
+ * Partitions added to a topic while the stream runs are consumed after a restart.
+ */
+class StreamIngestor {
+ public:
+  /// Starts ingesting; throws std::runtime_error if the source is not valid
+  StreamIngestor(Catalog_Namespace::Catalog& catalog,
+                 const TableDescriptor* td,
+                 const std::string& source,
+                 const CopyParams& copy_params);
+  /// Stops ingesting. Consumed rows not committed yet are consumed again on a restart.
+  ~StreamIngestor();
+
+  const std::string& getSource() const { return source_; }
+  CopyParams getCopyParams() const { return copy_params_; }
+  /// Empty while running, the error that stopped the stream otherwise
+  std::string getError() const;
+
+  static bool isKafkaUrl(const std::string& url);
+  /// Splits kafka://<broker>[,<broker>...]/<topic>[,<topic>...] into brokers and topics
+  static std::pair<std::string, std::vector<std::string>> parseKafkaUrl(
+      const std::string& url);
+
+  static std::string serializeCopyParams(const CopyParams& copy_params);
+  static CopyParams deserializeCopyParams(const std::string& json);
+
+ private:
+  using ImportBuffers = std::vector<std::unique_ptr<TypedImportBuffer>>;
+  using TopicPartition = std::pair<std::string, int32_t>;
+
+  struct Batch {
+    ImportBuffers buffers;
+    size_t numRows{0};
+    size_t numRejected{0};
+    std::map<TopicPartition, int64_t> nextOffsets;  // after the rows of the batch
+  };
+
+  struct Consumer {
+    ~Consumer();
+
+    std::unique_ptr<RdKafka::KafkaConsumer> kafkaConsumer;
+    std::vector<TopicPartition> partitions;
+    std::mutex mutex;
+    std::condition_variable batchTaken;
+    Batch batch;  // consumed, guarded by mutex
+    Batch spare;  // of the commit thread
+    std::thread thread;
+  };
+
+  std::unique_ptr<RdKafka::KafkaConsumer> createKafkaConsumer() const;
+  ImportBuffers createImportBuffers() const;
+  void consume(Consumer& consumer);
+  /// Parses the rows of a message into batch, returns the number of rows rejected
+  size_t parseMessage(const char* payload, const size_t size, Batch& batch) const;
+  void runCommits();
+  void commit();
+  void requestStop();
+  void fail(const std::string& error);
+
+  Catalog_Namespace::Catalog& catalog_;
+  const int tableId_;
+  const std::string tableName_;
+  const std::string source_;
+  const CopyParams copy_params_;
+  std::string brokers_;
+  std::vector<std::string> topics_;
+  std::unique_ptr<Loader> loader_;
+  std::unique_ptr<bool[]> is_array_;
+  size_t num_columns_{0};
+
+  std::vector<std::unique_ptr<Consumer>> consumers_;
+  /// by the commit thread, the offsets of all partitions consumed from, committed or not
+  std::map<TopicPartition, int64_t> committedOffsets_;
+  std::thread commitThread_;
+
+  std::atomic<bool> stop_{false};
+  mutable std::mutex mutex_;
+  std::condition_variable stopped_;
+  std::string error_;
+};
+
+/**
+ * The streams ingested into the tables of all databases. A stream is persisted in the
+ * catalog of its table until it is stopped, and resumed when the server restarts.
+ */
+class StreamIngestMgr {
+ public:
+  static StreamIngestMgr& instance();
+
+  /// Starts ingesting source into td, replacing the stream td had, and persists it
+  void startStream(Catalog_Namespace::Catalog& catalog,
+                   const TableDescriptor* td,
+                   const std::string& source,
+                   const CopyParams& copy_params);
+  /// Stops the stream into tableId and forgets it, returns false if there was none
+  bool stopStream(Catalog_Namespace::Catalog& catalog, const int tableId);
+  /// Starts the streams persisted in catalog, logging those which cannot be started
+  void resumeStreams(Catalog_Namespace::Catalog& catalog);
+  /// Stops all streams, which stay persisted, for shutdown
+  void stopAll();
+
+ private:
+  StreamIngestMgr() = default;
+
+  std::mutex mutex_;
+  // by database and table id
+  std::map<std::pair<int, int>, std::unique_ptr<StreamIngestor>> streams_;
+};
+
+}  // namespace import_export
@@ -18,6 +18,7 @@
 
 #include <atomic>
 #include <map>
+#include <mutex>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -59,6 +60,11 @@ class TrackedRefLock {
  public:
   TrackedRefLock(MutexTracker* m) : mutex_(m), lock_(mutex_->acquire()) { CHECK(mutex_); }
 
+  TrackedRefLock(MutexTracker* m, std::try_to_lock_t)
+      : mutex_(m), lock_(mutex_->acquire(), std::try_to_lock) {
+    CHECK(mutex_);
+  }
+
   ~TrackedRefLock() {
     if (mutex_) {
       // This call only decrements the ref count. The actual unlock is done once the
@@ -75,6 +81,8 @@ class TrackedRefLock {
   TrackedRefLock(const TrackedRefLock&) = delete;
   TrackedRefLock& operator=(const TrackedRefLock&) = delete;
 
+  bool ownsLock() const { return lock_.owns_lock(); }
+
  private:
   MutexTracker* mutex_;
   LOCK lock_;
@@ -160,6 +168,11 @@ class TableLockMgrImpl {
     auto& table_lock_mgr = T::instance();
     return WriteLock(table_lock_mgr.getTableMutex(table_key));
   }
+  // Doesn't wait, the lock is only held if ownsLock()
+  static WriteLock tryWriteLockForTable(const ChunkKey table_key) {
+    auto& table_lock_mgr = T::instance();
+    return WriteLock(table_lock_mgr.getTableMutex(table_key), std::try_to_lock);
+  }
 
   static ReadLock getReadLockForTable(const Catalog_Namespace::Catalog& cat,
                                       const std::string& table_name) {
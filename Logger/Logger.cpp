@@ -147,6 +147,11 @@ void LogOptions::set_options() {
       "log-rotation-size",
       po::value<size_t>(&rotation_size_)->default_value(rotation_size_),
       "Maximum file size in bytes before new log files are started.");
+  options_->add_options()(
+      "log-async",
+      po::value<bool>(&async_)->default_value(async_)->implicit_value(true),
+      "Queue the log records for a background thread which formats them and writes "
+      "them to the log files, instead of each logging thread doing it.");
 }
 
 template <typename TAG>
@@ -261,6 +266,27 @@ std::once_flag g_fatal_func_flag;
 
 using ClogSync = sinks::synchronous_sink<sinks::text_ostream_backend>;
 using FileSync = sinks::synchronous_sink<sinks::text_file_backend>;
+// The records are pushed to a non-blocking queue, their formatting and the file writes
+// and rotations are done by the feeding thread of the sink.
+using FileAsync =
+    sinks::asynchronous_sink<sinks::text_file_backend, sinks::unbounded_fifo_queue>;
+
+// Stopped, and their queued records written, by shutdown().
+std::vector<boost::shared_ptr<FileAsync>> g_async_file_sinks;
+
+template <typename TAG>
+void add_file_sink(LogOptions const& log_opts,
+                   boost::filesystem::path const& full_log_dir,
+                   TAG const tag) {
+  boost::shared_ptr<boost::log::core> core = boost::log::core::get();
+  if (log_opts.async_) {
+    auto sink = make_sink<FileAsync>(log_opts, full_log_dir, tag);
+    core->add_sink(sink);
+    g_async_file_sinks.push_back(std::move(sink));
+  } else {
+    core->add_sink(make_sink<FileSync>(log_opts, full_log_dir, tag));
+  }
+}
 
 template <typename CONSOLE_SINK>
 boost::shared_ptr<CONSOLE_SINK> make_sink(LogOptions const& log_opts) {
@@ -289,14 +315,14 @@ void init(LogOptions const& log_opts) {
     Severity const min_sink_level = std::max(Severity::INFO, log_opts.severity_);
     for (int i = min_sink_level; i < Severity::_NSEVERITIES; ++i) {
       Severity const level = static_cast<Severity>(i);
-      core->add_sink(make_sink<FileSync>(log_opts, full_log_dir, level));
+      add_file_sink(log_opts, full_log_dir, level);
     }
     g_min_active_severity = std::min(g_min_active_severity, log_opts.severity_);
     if (log_dir_was_created) {
       LOG(INFO) << "Log directory(" << full_log_dir.native() << ") created.";
     }
     for (auto const channel : log_opts.channels_) {
-      core->add_sink(make_sink<FileSync>(log_opts, full_log_dir, channel));
+      add_file_sink(log_opts, full_log_dir, channel);
     }
     g_any_active_channels = !log_opts.channels_.empty();
   }
@@ -312,7 +338,14 @@ void set_once_fatal_func(FatalFunc fatal_func) {
 }
 
 void shutdown() {
-  boost::log::core::get()->remove_all_sinks();
+  boost::shared_ptr<boost::log::core> core = boost::log::core::get();
+  for (auto& sink : g_async_file_sinks) {
+    core->remove_sink(sink);
+    sink->stop();
+    sink->flush();
+  }
+  g_async_file_sinks.clear();
+  core->remove_all_sinks();
 }
 
 namespace {
@@ -406,6 +439,8 @@ Logger::~Logger() {
     }
   }
   if (!is_channel_ && static_cast<Severity>(enum_value_) == Severity::FATAL) {
+    // the queued records of the asynchronous sinks, this one included, are written first
+    boost::log::core::get()->flush();
     if (FatalFunc fatal_func = g_fatal_func.load()) {
       // set_once_fatal_func() prevents race condition.
       // Exceptions thrown by (*fatal_func)() are propagated here.
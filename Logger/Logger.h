@@ -123,6 +123,7 @@ class LogOptions {
   size_t min_free_space_{20 << 20};
   bool rotate_daily_{true};
   size_t rotation_size_{10 << 20};
+  bool async_{false};
 
   LogOptions(char const* argv0);
   boost::filesystem::path full_log_dir() const;
@@ -17,6 +17,9 @@
 #include "MapDServer.h"
 #include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
 #include "ThriftHandler/DBHandler.h"
+#ifdef ENABLE_ARROW_FLIGHT
+#include "ThriftHandler/FlightServer.h"
+#endif
 
 #ifdef HAVE_THRIFT_THREADFACTORY
 #include <thrift/concurrency/ThreadFactory.h>
@@ -33,9 +36,15 @@
 #include <thrift/transport/TSSLServerSocket.h>
 #include <thrift/transport/TSSLSocket.h>
 #include <thrift/transport/TServerSocket.h>
+#ifdef ENABLE_THRIFT_NONBLOCKING_SERVER
+#include <thrift/server/TNonblockingServer.h>
+#include <thrift/transport/TNonblockingSSLServerSocket.h>
+#include <thrift/transport/TNonblockingServerSocket.h>
+#endif
 
 #include "Archive/S3Archive.h"
 #include "Logger/Logger.h"
+#include "Shared/MetricsServer.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/file_delete.h"
 #include "Shared/mapd_shared_mutex.h"
@@ -49,8 +58,11 @@
 #include <boost/make_shared.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+#include <cerrno>
 #include <csignal>
 #include <cstdlib>
+#include <fstream>
 #include <sstream>
 #include <thread>
 #include <vector>
@@ -73,8 +85,8 @@ std::atomic<bool> g_running{true};
 std::atomic<int> g_saw_signal{-1};
 
 mapd_shared_mutex g_thrift_mutex;
-TThreadedServer* g_thrift_http_server{nullptr};
-TThreadedServer* g_thrift_buf_server{nullptr};
+TServer* g_thrift_http_server{nullptr};
+TServer* g_thrift_buf_server{nullptr};
 
 mapd::shared_ptr<DBHandler> g_warmup_handler =
     0;  // global "g_warmup_handler" needed to avoid circular dependency
@@ -157,10 +169,11 @@ void register_signal_handlers() {
   register_signal_handler(SIGPIPE, SIG_IGN);
 }
 
-void start_server(TThreadedServer& server, const int port) {
+void start_server(TServer& server, const int port) {
   try {
     server.serve();
-    if (errno != 0) {
+    // the event loops of the nonblocking server leave the EAGAIN of their sockets
+    if (errno != 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
       throw std::runtime_error(std::string("Thrift server exited: ") +
                                std::strerror(errno));
     }
@@ -169,6 +182,44 @@ void start_server(TThreadedServer& server, const int port) {
   }
 }
 
+#ifdef ENABLE_THRIFT_NONBLOCKING_SERVER
+// A binary server whose I/O threads multiplex the connections and hand the calls to a
+// bounded pool of worker threads, so that idle connections don't cost a thread each
+std::unique_ptr<TServer> make_nonblocking_server(
+    mapd::shared_ptr<TProcessor> processor,
+    mapd::shared_ptr<TSSLSocketFactory> ssl_socket_factory,
+    const int port,
+    const size_t num_io_threads,
+    const size_t num_worker_threads) {
+  mapd::shared_ptr<TNonblockingServerTransport> server_socket;
+  if (ssl_socket_factory) {
+    server_socket = mapd::shared_ptr<TNonblockingServerTransport>(
+        new TNonblockingSSLServerSocket(port, ssl_socket_factory));
+  } else {
+    server_socket = mapd::shared_ptr<TNonblockingServerTransport>(
+        new TNonblockingServerSocket(port));
+  }
+  const size_t worker_count =
+      num_worker_threads
+          ? num_worker_threads
+          : std::max(size_t(16), size_t(std::thread::hardware_concurrency()));
+  auto thread_manager = ThreadManager::newSimpleThreadManager(worker_count);
+#ifdef HAVE_THRIFT_THREADFACTORY
+  thread_manager->threadFactory(mapd::make_shared<ThreadFactory>());
+#else
+  thread_manager->threadFactory(mapd::make_shared<PlatformThreadFactory>());
+#endif
+  thread_manager->start();
+  mapd::shared_ptr<TProtocolFactory> protocol_factory(new TBinaryProtocolFactory());
+  auto server = std::make_unique<TNonblockingServer>(
+      processor, protocol_factory, server_socket, thread_manager);
+  server->setNumIOThreads(std::max(num_io_threads, size_t(1)));
+  LOG(INFO) << " Nonblocking Thrift server with " << server->getNumIOThreads()
+            << " I/O threads and " << worker_count << " worker threads";
+  return server;
+}
+#endif
+
 void releaseWarmupSession(TSessionId& sessionId, std::ifstream& query_file) {
   query_file.close();
   if (sessionId != g_warmup_handler->getInvalidSessionId()) {
@@ -252,6 +303,46 @@ void run_warmup_queries(mapd::shared_ptr<DBHandler> handler,
   }
 }
 
+#ifdef ENABLE_ARROW_FLIGHT
+std::string read_pem_file(const std::string& file_name) {
+  std::ifstream file(file_name);
+  if (!file) {
+    throw std::runtime_error("Could not read " + file_name);
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+std::unique_ptr<DBFlightServer> init_flight_server(
+    const CommandLineOptions& prog_config_opts) {
+  const auto& system_parameters = prog_config_opts.system_parameters;
+  const bool use_tls =
+      !system_parameters.ssl_cert_file.empty() && !system_parameters.ssl_key_file.empty();
+  arrow::flight::Location location;
+  const auto location_status =
+      use_tls ? arrow::flight::Location::ForGrpcTls(
+                    "0.0.0.0", prog_config_opts.flight_port, &location)
+              : arrow::flight::Location::ForGrpcTcp(
+                    "0.0.0.0", prog_config_opts.flight_port, &location);
+  if (!location_status.ok()) {
+    throw std::runtime_error(location_status.ToString());
+  }
+  arrow::flight::FlightServerOptions options(location);
+  if (use_tls) {
+    options.tls_certificates.push_back({read_pem_file(system_parameters.ssl_cert_file),
+                                        read_pem_file(system_parameters.ssl_key_file)});
+  }
+  auto flight_server = std::make_unique<DBFlightServer>(g_mapd_handler);
+  const auto init_status = flight_server->Init(options);
+  if (!init_status.ok()) {
+    throw std::runtime_error(init_status.ToString());
+  }
+  LOG(INFO) << "Arrow Flight server listening on port " << prog_config_opts.flight_port;
+  return flight_server;
+}
+#endif
+
 void heartbeat() {
   // Block all signals for this heartbeat thread, only.
   sigset_t set;
@@ -376,9 +467,9 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
 
   mapd::shared_ptr<TServerSocket> serverSocket;
   mapd::shared_ptr<TServerSocket> httpServerSocket;
+  mapd::shared_ptr<TSSLSocketFactory> sslSocketFactory;
   if (!prog_config_opts.system_parameters.ssl_cert_file.empty() &&
       !prog_config_opts.system_parameters.ssl_key_file.empty()) {
-    mapd::shared_ptr<TSSLSocketFactory> sslSocketFactory;
     sslSocketFactory =
         mapd::shared_ptr<TSSLSocketFactory>(new TSSLSocketFactory(SSLProtocol::SSLTLS));
     sslSocketFactory->loadCertificate(
@@ -418,18 +509,67 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
         new TBufferedTransportFactory());
     mapd::shared_ptr<TProtocolFactory> bufProtocolFactory(new TBinaryProtocolFactory());
 
-    mapd::shared_ptr<TServerTransport> bufServerTransport(serverSocket);
-    TThreadedServer bufServer(
-        processor, bufServerTransport, bufTransportFactory, bufProtocolFactory);
+    std::unique_ptr<TServer> bufServer;
+#ifdef ENABLE_THRIFT_NONBLOCKING_SERVER
+    if (prog_config_opts.nonblocking_thrift_server) {
+      bufServer =
+          make_nonblocking_server(processor,
+                                  sslSocketFactory,
+                                  prog_config_opts.system_parameters.omnisci_server_port,
+                                  prog_config_opts.num_thrift_io_threads,
+                                  prog_config_opts.num_thrift_worker_threads);
+    }
+#endif
+    if (!bufServer) {
+      mapd::shared_ptr<TServerTransport> bufServerTransport(serverSocket);
+      bufServer = std::make_unique<TThreadedServer>(
+          processor, bufServerTransport, bufTransportFactory, bufProtocolFactory);
+    }
     {
       mapd_lock_guard<mapd_shared_mutex> write_lock(g_thrift_mutex);
-      g_thrift_buf_server = &bufServer;
+      g_thrift_buf_server = bufServer.get();
     }
 
     std::thread bufThread(start_server,
-                          std::ref(bufServer),
+                          std::ref(*bufServer),
                           prog_config_opts.system_parameters.omnisci_server_port);
 
+#ifdef ENABLE_ARROW_FLIGHT
+    std::unique_ptr<DBFlightServer> flight_server;
+    std::thread flight_thread;
+    if (prog_config_opts.flight_port > 0) {
+      try {
+        flight_server = init_flight_server(prog_config_opts);
+        flight_thread = std::thread([&flight_server] {
+          const auto status = flight_server->Serve();
+          if (!status.ok()) {
+            LOG(ERROR) << "Arrow Flight server exited: " << status.ToString();
+          }
+        });
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Arrow Flight server disabled: " << e.what();
+      }
+    }
+    // stopped once the Thrift servers are
+    ScopeGuard flight_server_guard = [&flight_server, &flight_thread] {
+      if (flight_thread.joinable()) {
+        flight_server->Shutdown();
+        flight_thread.join();
+      }
+    };
+#endif
+
+    std::unique_ptr<metrics::HttpServer> metrics_server;
+    if (prog_config_opts.metrics_port > 0) {
+      try {
+        const auto metrics_port = prog_config_opts.metrics_port;
+        metrics_server = std::make_unique<metrics::HttpServer>(metrics_port);
+        LOG(INFO) << "Metrics endpoint listening on port " << metrics_port;
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Metrics endpoint disabled: " << e.what();
+      }
+    }
+
     // TEMPORARY
     auto warmup_queries = [&prog_config_opts]() {
       // run warm up queries if any exists
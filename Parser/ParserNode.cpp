@@ -36,6 +36,7 @@
 #include <cassert>
 #include <cmath>
 #include <limits>
+#include <optional>
 #include <random>
 #include <stdexcept>
 #include <type_traits>
@@ -45,15 +46,20 @@
 #include "Catalog/Catalog.h"
 #include "Catalog/DataframeTableDescriptor.h"
 #include "Catalog/SharedDictionaryValidator.h"
+#include "DataMgr/ChunkBloomFilter.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "Fragmenter/SortedOrderFragmenter.h"
 #include "Fragmenter/TargetValueConvertersFactories.h"
+#include "Fragmenter/TimePartition.h"
 #include "ImportExport/Importer.h"
+#include "ImportExport/StreamIngestor.h"
 #include "LockMgr/LockMgr.h"
 #include "QueryEngine/CalciteAdapter.h"
+#include "QueryEngine/ColumnarResults.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "QueryEngine/RelAlgExecutor.h"
+#include "QueryEngine/TableOptimizer.h"
 #include "ReservedKeywords.h"
 #include "Shared/StringTransform.h"
 #include "Shared/TimeGM.h"
@@ -69,6 +75,7 @@
 
 size_t g_leaf_count{0};
 bool g_test_drop_column_rollback{false};
+bool g_enable_columnar_ctas{true};
 extern bool g_enable_experimental_string_functions;
 extern bool g_enable_fsi;
 
@@ -2056,6 +2063,26 @@ decltype(auto) get_page_size_def(TableDescriptor& td,
   return get_property_value<IntLiteral>(p,
                                         [&td](const auto val) { td.fragPageSize = val; });
 }
+decltype(auto) get_extent_size_def(TableDescriptor& td,
+                                   const NameValueAssign* p,
+                                   const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<IntLiteral>(p, [&td](const auto val) {
+    if (val <= 0) {
+      throw std::runtime_error("EXTENT_SIZE must be a positive number.");
+    }
+    td.extentSize = val;
+  });
+}
+decltype(auto) get_compression_def(TableDescriptor& td,
+                                   const NameValueAssign* p,
+                                   const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<StringLiteral>(p, [&td](const auto compression_uc) {
+    if (compression_uc != "NONE" && compression_uc != "BLOSC") {
+      throw std::runtime_error("COMPRESSION must be NONE or BLOSC");
+    }
+    td.chunkCompression = compression_uc == "NONE" ? "" : compression_uc;
+  });
+}
 decltype(auto) get_max_rows_def(TableDescriptor& td,
                                 const NameValueAssign* p,
                                 const std::list<ColumnDescriptor>& columns) {
@@ -2124,15 +2151,105 @@ decltype(auto) get_sort_column_def(TableDescriptor& td,
   });
 }
 
+decltype(auto) get_bloom_filter_def(TableDescriptor& td,
+                                    const NameValueAssign* p,
+                                    const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<StringLiteral>(p, [&td, &columns](const auto columns_upper) {
+    td.bloomFilterColumnIds.clear();
+    for (const auto& column_name : split(columns_upper, ",")) {
+      const auto column_upper = strip(column_name);
+      const auto column_id = sort_column_index(column_upper, columns);
+      if (!column_id) {
+        throw std::runtime_error("Specified bloom filter column " + column_upper +
+                                 " doesn't exist");
+      }
+      const auto cd_it =
+          std::find_if(columns.begin(), columns.end(), [&](const auto& cd) {
+            return boost::to_upper_copy<std::string>(cd.columnName) == column_upper;
+          });
+      CHECK(cd_it != columns.end());
+      if (!ChunkBloomFilter::supportsType(cd_it->columnType)) {
+        throw std::runtime_error("Bloom filter column " + column_upper +
+                                 " must be an integer, time or dictionary encoded "
+                                 "string column");
+      }
+      td.bloomFilterColumnIds.push_back(column_id);
+    }
+  });
+}
+
+decltype(auto) get_partition_column_def(TableDescriptor& td,
+                                        const NameValueAssign* p,
+                                        const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<StringLiteral>(p, [&td, &columns](const auto column_upper) {
+    const auto cd_it = std::find_if(columns.begin(), columns.end(), [&](const auto& cd) {
+      return boost::to_upper_copy<std::string>(cd.columnName) == column_upper;
+    });
+    if (cd_it == columns.end()) {
+      throw std::runtime_error("Specified partition column " + column_upper +
+                               " doesn't exist");
+    }
+    if (!cd_it->columnType.is_timestamp() && cd_it->columnType.get_type() != kDATE) {
+      throw std::runtime_error("Partition column " + column_upper +
+                               " must be a TIMESTAMP or DATE column");
+    }
+    td.partitionColumnId = sort_column_index(column_upper, columns);
+  });
+}
+
+decltype(auto) get_partition_interval_def(TableDescriptor& td,
+                                          const NameValueAssign* p,
+                                          const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<StringLiteral>(p, [&td](const auto interval_uc) {
+    td.partitionInterval =
+        Fragmenter_Namespace::get_partition_interval_seconds(interval_uc);
+    if (!td.partitionInterval) {
+      throw std::runtime_error("PARTITION_INTERVAL must be HOUR, DAY or WEEK");
+    }
+  });
+}
+
+decltype(auto) get_partition_retention_def(TableDescriptor& td,
+                                           const NameValueAssign* p,
+                                           const std::list<ColumnDescriptor>& columns) {
+  return get_property_value<IntLiteral>(p, [&td](const auto val) {
+    if (val <= 0) {
+      throw std::runtime_error("PARTITION_RETENTION must be a positive number.");
+    }
+    td.partitionRetention = val;
+  });
+}
+
+// Checks the PARTITION_ options once they are all set, the interval defaults to a day
+void validate_partition_options(TableDescriptor& td) {
+  if (!table_is_partitioned(&td)) {
+    if (td.partitionInterval || td.partitionRetention) {
+      throw std::runtime_error(
+          "PARTITION_COLUMN needs to be specified with PARTITION_INTERVAL and "
+          "PARTITION_RETENTION.");
+    }
+    return;
+  }
+  if (!td.partitionInterval) {
+    td.partitionInterval = Fragmenter_Namespace::get_partition_interval_seconds("DAY");
+  }
+}
+
 static const std::map<const std::string, const TableDefFuncPtr> tableDefFuncMap = {
     {"fragment_size"s, get_frag_size_def},
     {"max_chunk_size"s, get_max_chunk_size_def},
     {"page_size"s, get_page_size_def},
+    {"extent_size"s, get_extent_size_def},
+    {"compression"s, get_compression_def},
     {"max_rows"s, get_max_rows_def},
     {"partitions"s, get_partions_def},
     {"shard_count"s, get_shard_count_def},
     {"vacuum"s, get_vacuum_def},
     {"sort_column"s, get_sort_column_def},
+    {"bloom_filter"s, get_bloom_filter_def},
+    {"partition_column"s, get_partition_column_def},
+    {"partition_interval"s, get_partition_interval_def},
+    {"partition_retention"s, get_partition_retention_def},
     {"storage_type"s, get_storage_type}};
 
 void get_table_definitions(TableDescriptor& td,
@@ -2142,8 +2259,9 @@ void get_table_definitions(TableDescriptor& td,
   if (it == tableDefFuncMap.end()) {
     throw std::runtime_error(
         "Invalid CREATE TABLE option " + *p->get_name() +
-        ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, MAX_ROWS, "
-        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, or STORAGE_TYPE.");
+        ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, EXTENT_SIZE, COMPRESSION, "
+        "MAX_ROWS, PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, BLOOM_FILTER, "
+        "PARTITION_COLUMN, PARTITION_INTERVAL, PARTITION_RETENTION, or STORAGE_TYPE.");
   }
   return it->second(td, p.get(), columns);
 }
@@ -2155,8 +2273,9 @@ void get_table_definitions_for_ctas(TableDescriptor& td,
   if (it == tableDefFuncMap.end()) {
     throw std::runtime_error(
         "Invalid CREATE TABLE AS option " + *p->get_name() +
-        ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, MAX_ROWS, "
-        "PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, STORAGE_TYPE or "
+        ". Should be FRAGMENT_SIZE, MAX_CHUNK_SIZE, PAGE_SIZE, EXTENT_SIZE, COMPRESSION, "
+        "MAX_ROWS, PARTITIONS, SHARD_COUNT, VACUUM, SORT_COLUMN, BLOOM_FILTER, "
+        "PARTITION_COLUMN, PARTITION_INTERVAL, PARTITION_RETENTION, STORAGE_TYPE or "
         "USE_SHARED_DICTIONARIES.");
   }
   return it->second(td, p.get(), columns);
@@ -2236,6 +2355,7 @@ void CreateTableStmt::executeDryRun(const Catalog_Namespace::SessionInfo& sessio
       get_table_definitions(td, p, columns);
     }
   }
+  validate_partition_options(td);
   if (td.shardedColumnId && !td.nShards) {
     throw std::runtime_error("SHARD_COUNT needs to be specified with SHARD_KEY.");
   }
@@ -2533,6 +2653,38 @@ std::list<ColumnDescriptor> LocalConnector::getColumnDescriptors(AggregatedResul
   return column_descriptors;
 }
 
+namespace {
+
+// Whether the values of a result column of type source_ti are in the layout of the
+// converter of target_cd already, so that the column can be copied as a whole
+bool is_columnar_copy_possible(const SQLTypeInfo& source_ti,
+                               const ColumnDescriptor* target_cd) {
+  const auto& target_ti = target_cd->columnType;
+  if (target_ti.is_array() || target_ti.is_geometry()) {
+    return false;
+  }
+  const auto source_logical_ti = get_logical_type_info(source_ti);
+  if (target_ti.is_string()) {
+    // the ids are translated to the target dictionary when the converter finalizes
+    return target_ti.get_compression() == kENCODING_DICT && source_ti.is_string() &&
+           source_logical_ti.get_compression() == kENCODING_DICT &&
+           source_logical_ti.get_size() == 4;
+  }
+  if (target_ti.get_compression() != kENCODING_NONE &&
+      target_ti.get_compression() != kENCODING_DATE_IN_DAYS) {
+    // the fixed encodings need the overflow checks of the row-wise conversion
+    return false;
+  }
+  const auto target_logical_ti = get_logical_type_info(target_ti);
+  return source_logical_ti.get_type() == target_logical_ti.get_type() &&
+         source_logical_ti.get_compression() == kENCODING_NONE &&
+         source_logical_ti.get_size() == target_logical_ti.get_size() &&
+         source_logical_ti.get_dimension() == target_logical_ti.get_dimension() &&
+         source_logical_ti.get_scale() == target_logical_ti.get_scale();
+}
+
+}  // namespace
+
 void InsertIntoTableAsSelectStmt::populateData(QueryStateProxy query_state_proxy,
                                                bool validate_table) {
   auto const session = query_state_proxy.getQueryState().getConstSessionInfo();
@@ -2766,6 +2918,35 @@ void InsertIntoTableAsSelectStmt::populateData(QueryStateProxy query_state_proxy
 
       std::atomic<size_t> row_idx{0};
 
+      // when every result column is in the layout of its target column the packages
+      // are copied column by column from a columnar copy of the results, rather than
+      // converted value by value
+      std::unique_ptr<ColumnarResults> columnar_rows;
+      if (g_enable_columnar_ctas && !result_rows->isTruncated()) {
+        std::vector<SQLTypeInfo> column_types;
+        for (size_t col_idx = 0; col_idx < target_column_descriptors.size(); ++col_idx) {
+          const auto& source_ti = res.targets_meta[col_idx].get_type_info();
+          if (!is_columnar_copy_possible(source_ti,
+                                         target_column_descriptors[col_idx])) {
+            column_types.clear();
+            break;
+          }
+          column_types.push_back(get_logical_type_info(source_ti));
+        }
+        if (!column_types.empty()) {
+          const auto columnarize_clock_begin = timer_start();
+          columnar_rows = std::make_unique<ColumnarResults>(
+              result_rows->getRowSetMemOwner(),
+              *result_rows,
+              column_types.size(),
+              column_types);
+          total_target_value_translate_time_ms += timer_stop(columnarize_clock_begin);
+          if (columnar_rows->size() != num_rows) {
+            columnar_rows.reset();
+          }
+        }
+      }
+
       auto convert_function = [&result_rows,
                                &value_converters,
                                &row_idx,
@@ -2872,7 +3053,13 @@ void InsertIntoTableAsSelectStmt::populateData(QueryStateProxy query_state_proxy
           }
 
           const auto translate_clock_begin = timer_start();
-          if (can_go_parallel) {
+          if (columnar_rows) {
+            const auto& column_buffers = columnar_rows->getColumnBuffers();
+            for (size_t col_idx = 0; col_idx < value_converters.size(); ++col_idx) {
+              value_converters[col_idx]->convertColumnToColumnarFormat(
+                  column_buffers[col_idx], start_row, num_rows_to_process);
+            }
+          } else if (can_go_parallel) {
             std::vector<std::future<void>> worker_threads;
             for (int i = 0; i < num_worker_threads; ++i) {
               worker_threads.push_back(
@@ -3053,6 +3240,7 @@ void CreateTableAsSelectStmt::execute(const Catalog_Namespace::SessionInfo& sess
         }
       }
     }
+    validate_partition_options(td);
 
     std::vector<SharedDictionaryDef> sharedDictionaryRefs;
 
@@ -3111,6 +3299,14 @@ void CreateTableAsSelectStmt::execute(const Catalog_Namespace::SessionInfo& sess
 void DropTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   auto& catalog = session.getCatalog();
 
+  // stopped before the locks are taken, as the commits of the stream take them too
+  if (const auto td = catalog.getMetadataForTable(*table, false)) {
+    if (session.checkDBAccessPrivileges(
+            DBObjectType::TableDBObjectType, AccessPrivileges::DROP_TABLE, *table)) {
+      import_export::StreamIngestMgr::instance().stopStream(catalog, td->tableId);
+    }
+  }
+
   // TODO(adb): the catalog should be handling this locking.
   const auto execute_write_lock = mapd_unique_lock<mapd_shared_mutex>(
       *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
@@ -3502,6 +3698,10 @@ void DropColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
         throw std::runtime_error("Dropping sharding column " + cd.columnName +
                                  " is not supported.");
       }
+      if (td->partitionColumnId == cd.columnId) {
+        throw std::runtime_error("Dropping partition column " + cd.columnName +
+                                 " is not supported.");
+      }
       catalog.dropColumn(*td, cd);
       columnIds.push_back(cd.columnId);
       for (int i = 0; i < cd.columnType.get_physical_cols(); i++) {
@@ -3535,6 +3735,188 @@ void DropColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   DeleteTriggeredCacheInvalidator::invalidateCaches();
 }
 
+namespace {
+
+// The columns of a PIN_CPU, PIN_GPU or COLUMNS option: ALL, NONE or a list of names
+std::vector<int> get_option_column_ids(const Catalog_Namespace::Catalog& catalog,
+                                       const TableDescriptor* td,
+                                       const NameValueAssign& option) {
+  const auto str_literal = dynamic_cast<const StringLiteral*>(option.get_value());
+  if (!str_literal) {
+    throw std::runtime_error(boost::to_upper_copy<std::string>(*option.get_name()) +
+                             " must be a string literal.");
+  }
+  const auto value = strip(*str_literal->get_stringval());
+  std::vector<int> column_ids;
+  if (boost::iequals(value, "ALL")) {
+    for (const auto cd :
+         catalog.getAllColumnMetadataForTable(td->tableId, false, false, false)) {
+      column_ids.push_back(cd->columnId);
+    }
+  } else if (!value.empty() && !boost::iequals(value, "NONE")) {
+    for (const auto& column_name : split(value, ",")) {
+      const auto cd = catalog.getMetadataForColumn(td->tableId, strip(column_name));
+      if (!cd || cd->isSystemCol || cd->isVirtualCol || cd->isGeoPhyCol) {
+        throw std::runtime_error("Column " + strip(column_name) + " does not exist.");
+      }
+      column_ids.push_back(cd->columnId);
+    }
+  }
+  return column_ids;
+}
+
+}  // namespace
+
+void AlterTableSetOptionsStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::WriteLock>::acquireTableDescriptor(
+          catalog, *table, true);
+  const auto td = td_with_lock();
+  if (!td) {
+    throw std::runtime_error("Table " + *table + " does not exist.");
+  }
+  if (td->isView) {
+    throw std::runtime_error("Setting the options of a view is not supported.");
+  }
+  if (table_is_temporary(td)) {
+    throw std::runtime_error(
+        "Pinning the columns of a temporary table is not supported.");
+  }
+
+  check_alter_table_privilege(session, td);
+
+  auto cpu_column_ids = td->pinnedCpuColumnIds;
+  auto gpu_column_ids = td->pinnedGpuColumnIds;
+  for (const auto& option : options) {
+    if (boost::iequals(*option->get_name(), "PIN_CPU")) {
+      cpu_column_ids = get_option_column_ids(catalog, td, *option);
+    } else if (boost::iequals(*option->get_name(), "PIN_GPU")) {
+      gpu_column_ids = get_option_column_ids(catalog, td, *option);
+    } else {
+      throw std::runtime_error("Invalid ALTER TABLE SET option " + *option->get_name() +
+                               ". Should be PIN_CPU or PIN_GPU.");
+    }
+  }
+  catalog.setPinnedColumns(td, cpu_column_ids, gpu_column_ids);
+}
+
+void PrewarmTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, *table, true);
+  const auto td = td_with_lock();
+  if (!td) {
+    throw std::runtime_error("Table " + *table + " does not exist.");
+  }
+  if (td->isView) {
+    throw std::runtime_error("PREWARM TABLE command is not supported on views.");
+  }
+
+  check_alter_table_privilege(session, td);
+
+  std::optional<Data_Namespace::MemoryLevel> memory_level;
+  std::optional<std::vector<int>> column_ids;
+  for (const auto& option : options) {
+    if (boost::iequals(*option->get_name(), "MEMORY_LEVEL")) {
+      const auto str_literal = dynamic_cast<const StringLiteral*>(option->get_value());
+      if (str_literal && boost::iequals(*str_literal->get_stringval(), "CPU")) {
+        memory_level = Data_Namespace::MemoryLevel::CPU_LEVEL;
+      } else if (str_literal && boost::iequals(*str_literal->get_stringval(), "GPU")) {
+        memory_level = Data_Namespace::MemoryLevel::GPU_LEVEL;
+      } else {
+        throw std::runtime_error("MEMORY_LEVEL must be 'CPU' or 'GPU'.");
+      }
+    } else if (boost::iequals(*option->get_name(), "COLUMNS")) {
+      column_ids = get_option_column_ids(catalog, td, *option);
+    } else {
+      throw std::runtime_error("Invalid PREWARM TABLE option " + *option->get_name() +
+                               ". Should be MEMORY_LEVEL or COLUMNS.");
+    }
+  }
+
+  std::vector<Data_Namespace::MemoryLevel> memory_levels;
+  if (memory_level) {
+    memory_levels.push_back(*memory_level);
+  } else {
+    if (!td->pinnedCpuColumnIds.empty()) {
+      memory_levels.push_back(Data_Namespace::MemoryLevel::CPU_LEVEL);
+    }
+    if (!td->pinnedGpuColumnIds.empty()) {
+      memory_levels.push_back(Data_Namespace::MemoryLevel::GPU_LEVEL);
+    }
+    if (memory_levels.empty()) {
+      memory_levels.push_back(Data_Namespace::MemoryLevel::CPU_LEVEL);
+    }
+  }
+
+  const auto data_lock = lockmgr::TableDataLockContainer<lockmgr::ReadLock>::acquire(
+      catalog.getDatabaseId(), td);
+  for (const auto level : memory_levels) {
+    auto level_column_ids = level == Data_Namespace::MemoryLevel::GPU_LEVEL
+                                ? td->pinnedGpuColumnIds
+                                : td->pinnedCpuColumnIds;
+    if (column_ids) {
+      level_column_ids = *column_ids;
+    }
+    if (level_column_ids.empty()) {
+      for (const auto cd :
+           catalog.getAllColumnMetadataForTable(td->tableId, false, false, false)) {
+        level_column_ids.push_back(cd->columnId);
+      }
+    }
+    const auto chunk_count = catalog.prewarmTable(td, level_column_ids, level);
+    LOG(INFO) << "Prewarmed " << chunk_count << " chunks of table " << td->tableName
+              << " in "
+              << (level == Data_Namespace::MemoryLevel::GPU_LEVEL ? "GPU" : "CPU")
+              << " memory";
+  }
+}
+
+void AnalyzeTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
+  auto& catalog = session.getCatalog();
+
+  const auto td_with_lock =
+      lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+          catalog, *table, true);
+  const auto td = td_with_lock();
+  if (!td) {
+    throw std::runtime_error("Table " + *table + " does not exist.");
+  }
+  if (td->isView) {
+    throw std::runtime_error("ANALYZE TABLE command is not supported on views.");
+  }
+
+  check_alter_table_privilege(session, td);
+
+  std::vector<int> column_ids;
+  for (const auto& option : options) {
+    if (boost::iequals(*option->get_name(), "COLUMNS")) {
+      column_ids = get_option_column_ids(catalog, td, *option);
+    } else {
+      throw std::runtime_error("Invalid ANALYZE TABLE option " + *option->get_name() +
+                               ". Should be COLUMNS.");
+    }
+  }
+  if (column_ids.empty()) {
+    for (const auto cd :
+         catalog.getAllColumnMetadataForTable(td->tableId, false, false, false)) {
+      column_ids.push_back(cd->columnId);
+    }
+  }
+
+  const auto data_lock = lockmgr::TableDataLockContainer<lockmgr::ReadLock>::acquire(
+      catalog.getDatabaseId(), td);
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+  const TableOptimizer optimizer(td, executor.get(), catalog);
+  const auto statistics = optimizer.computeColumnStatistics(column_ids);
+  catalog.setColumnStatistics(td, statistics);
+  LOG(INFO) << "Analyzed " << statistics.size() << " columns of table " << td->tableName;
+}
+
 void RenameColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   auto& catalog = session.getCatalog();
 
@@ -3571,9 +3953,11 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
                                 const TableDescriptor*,
                                 const std::string&,
                                 const import_export::CopyParams&)>& importer_factory) {
+  // a stream ingested by the server, which takes the locks for each commit of its own
+  const bool is_stream = import_export::StreamIngestor::isKafkaUrl(*file_pattern);
   boost::regex non_local_file_regex{R"(^\s*(s3|http|https)://.+)",
                                     boost::regex::extended | boost::regex::icase};
-  if (!boost::regex_match(*file_pattern, non_local_file_regex)) {
+  if (!is_stream && !boost::regex_match(*file_pattern, non_local_file_regex)) {
     ddl_utils::validate_allowed_file_path(
         *file_pattern, ddl_utils::DataTransferType::IMPORT, true);
   }
@@ -3584,9 +3968,13 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
   bool load_truncated = false;
 
   // Prevent simultaneous import / truncate (see TruncateTableStmt::execute)
-  const auto execute_read_lock = mapd_shared_lock<mapd_shared_mutex>(
+  auto execute_read_lock = mapd_shared_lock<mapd_shared_mutex>(
       *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
-          legacylockmgr::ExecutorOuterLock, true));
+          legacylockmgr::ExecutorOuterLock, true),
+      std::defer_lock);
+  if (!is_stream) {
+    execute_read_lock.lock();
+  }
 
   const TableDescriptor* td{nullptr};
   std::unique_ptr<lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>> td_with_lock;
@@ -3599,8 +3987,10 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
         lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
             catalog, *table));
     td = (*td_with_lock)();
-    insert_data_lock = std::make_unique<lockmgr::WriteLock>(
-        lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog, *table));
+    if (!is_stream) {
+      insert_data_lock = std::make_unique<lockmgr::WriteLock>(
+          lockmgr::InsertDataLockMgr::getWriteLockForTable(catalog, *table));
+    }
   } catch (const std::runtime_error& e) {
     // noop
     // TODO(adb): We're really only interested in whether the table exists or not.
@@ -3627,6 +4017,7 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
   // or a wildcard of file names;
   std::string file_path = *file_pattern;
   import_export::CopyParams copy_params;
+  bool stop_stream{false};
   if (!options.empty()) {
     for (auto& p : options) {
       if (boost::iequals(*p->get_name(), "max_reject")) {
@@ -3882,12 +4273,91 @@ void CopyTableStmt::execute(const Catalog_Namespace::SessionInfo& session,
           throw std::runtime_error("geo_explode_collections option must be a boolean.");
         }
         copy_params.geo_explode_collections = bool_from_string_literal(str_literal);
+      } else if (boost::istarts_with(*p->get_name(), "kafka_") && !is_stream) {
+        throw std::runtime_error(*p->get_name() +
+                                 " option is only supported for kafka:// sources.");
+      } else if (boost::iequals(*p->get_name(), "kafka_group_id")) {
+        const StringLiteral* str_literal =
+            dynamic_cast<const StringLiteral*>(p->get_value());
+        if (str_literal == nullptr) {
+          throw std::runtime_error("kafka_group_id option must be a string.");
+        }
+        copy_params.kafka_group_id = *str_literal->get_stringval();
+      } else if (boost::iequals(*p->get_name(), "kafka_offset_reset")) {
+        const StringLiteral* str_literal =
+            dynamic_cast<const StringLiteral*>(p->get_value());
+        if (str_literal == nullptr ||
+            !(boost::iequals(*str_literal->get_stringval(), "earliest") ||
+              boost::iequals(*str_literal->get_stringval(), "latest"))) {
+          throw std::runtime_error(
+              "kafka_offset_reset option must be 'earliest' or 'latest'.");
+        }
+        copy_params.kafka_from_latest =
+            boost::iequals(*str_literal->get_stringval(), "latest");
+      } else if (boost::iequals(*p->get_name(), "kafka_consumers")) {
+        const IntLiteral* int_literal = dynamic_cast<const IntLiteral*>(p->get_value());
+        if (int_literal == nullptr || int_literal->get_intval() <= 0) {
+          throw std::runtime_error("kafka_consumers option must be a positive integer.");
+        }
+        copy_params.kafka_consumers = int_literal->get_intval();
+      } else if (boost::iequals(*p->get_name(), "kafka_batch_ms")) {
+        const IntLiteral* int_literal = dynamic_cast<const IntLiteral*>(p->get_value());
+        if (int_literal == nullptr || int_literal->get_intval() <= 0) {
+          throw std::runtime_error("kafka_batch_ms option must be a positive integer.");
+        }
+        copy_params.kafka_batch_ms = int_literal->get_intval();
+      } else if (boost::iequals(*p->get_name(), "kafka_batch_rows")) {
+        const IntLiteral* int_literal = dynamic_cast<const IntLiteral*>(p->get_value());
+        if (int_literal == nullptr || int_literal->get_intval() <= 0) {
+          throw std::runtime_error("kafka_batch_rows option must be a positive integer.");
+        }
+        copy_params.kafka_batch_rows = int_literal->get_intval();
+      } else if (boost::iequals(*p->get_name(), "kafka_stream")) {
+        const StringLiteral* str_literal =
+            dynamic_cast<const StringLiteral*>(p->get_value());
+        if (str_literal == nullptr ||
+            !(boost::iequals(*str_literal->get_stringval(), "start") ||
+              boost::iequals(*str_literal->get_stringval(), "stop"))) {
+          throw std::runtime_error("kafka_stream option must be 'start' or 'stop'.");
+        }
+        stop_stream = boost::iequals(*str_literal->get_stringval(), "stop");
       } else {
         throw std::runtime_error("Invalid option for COPY: " + *p->get_name());
       }
     }
   }
 
+  if (is_stream) {
+    if (!td) {
+      throw std::runtime_error("Table '" + *table + "' must exist before COPY FROM");
+    }
+    if (g_cluster) {
+      throw std::runtime_error(
+          "COPY FROM kafka:// is not supported in distributed mode.");
+    }
+    // stopping a stream waits for its commit, which takes the schema lock too
+    const auto table_id = td->tableId;
+    td_with_lock.reset();
+    std::string tr;
+    if (stop_stream) {
+      if (!import_export::StreamIngestMgr::instance().stopStream(catalog, table_id)) {
+        throw std::runtime_error("Table '" + *table + "' has no stream to stop.");
+      }
+      tr = "Stopped the stream into table '" + *table + "'";
+    } else {
+      const auto td_stream = catalog.getMetadataForTable(table_id, false);
+      if (!td_stream) {
+        throw std::runtime_error("Table '" + *table + "' does not exist.");
+      }
+      import_export::StreamIngestMgr::instance().startStream(
+          catalog, td_stream, file_path, copy_params);
+      tr = "Started the stream of " + file_path + " into table '" + *table + "'";
+    }
+    return_message.reset(new std::string(tr));
+    LOG(INFO) << tr;
+    return;
+  }
+
   std::string tr;
   if (copy_params.file_type == import_export::FileType::POLYGON) {
     // geo import
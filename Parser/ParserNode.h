@@ -1186,6 +1186,24 @@ class OptimizeTableStmt : public DDLStmt {
     return false;
   }
 
+  bool shouldReencodeColumns() const {
+    for (const auto& e : options_) {
+      if (boost::iequals(*(e->get_name()), "REENCODE")) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool shouldCompactDictionaries() const {
+    for (const auto& e : options_) {
+      if (boost::iequals(*(e->get_name()), "COMPACT_DICTIONARIES")) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   void execute(const Catalog_Namespace::SessionInfo& session) override {
     // Should pass optimize params to the table optimizer
     CHECK(false);
@@ -1326,6 +1344,73 @@ class DropColumnStmt : public DDLStmt {
   std::list<std::unique_ptr<std::string>> columns;
 };
 
+/*
+ * @type AlterTableSetOptionsStmt
+ * @brief ALTER TABLE table SET (PIN_CPU = 'columns', PIN_GPU = 'columns'), the columns
+ * being ALL, NONE or a comma separated list of names
+ */
+class AlterTableSetOptionsStmt : public DDLStmt {
+ public:
+  AlterTableSetOptionsStmt(std::string* tab, std::list<NameValueAssign*>* o)
+      : table(tab) {
+    for (const auto e : *o) {
+      options.emplace_back(e);
+    }
+    delete o;
+  }
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> table;
+  std::list<std::unique_ptr<NameValueAssign>> options;
+};
+
+/*
+ * @type PrewarmTableStmt
+ * @brief PREWARM TABLE table [WITH (MEMORY_LEVEL = 'CPU' | 'GPU', COLUMNS = 'columns')]
+ * loads the chunks of the pinned columns of the table into their buffer pools, or those
+ * of the given columns and level. Tables without pinned columns default to all their
+ * columns in CPU memory.
+ */
+class PrewarmTableStmt : public DDLStmt {
+ public:
+  PrewarmTableStmt(std::string* tab, std::list<NameValueAssign*>* o) : table(tab) {
+    if (o) {
+      for (const auto e : *o) {
+        options.emplace_back(e);
+      }
+      delete o;
+    }
+  }
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> table;
+  std::list<std::unique_ptr<NameValueAssign>> options;
+};
+
+/*
+ * @type AnalyzeTableStmt
+ * @brief ANALYZE TABLE table [WITH (COLUMNS = 'columns')] collects the statistics of
+ * the columns of the table, or of the given ones, for the query planning.
+ */
+class AnalyzeTableStmt : public DDLStmt {
+ public:
+  AnalyzeTableStmt(std::string* tab, std::list<NameValueAssign*>* o) : table(tab) {
+    if (o) {
+      for (const auto e : *o) {
+        options.emplace_back(e);
+      }
+      delete o;
+    }
+  }
+  void execute(const Catalog_Namespace::SessionInfo& session) override;
+
+ private:
+  std::unique_ptr<std::string> table;
+  std::list<std::unique_ptr<NameValueAssign>> options;
+};
+
 /*
  * @type DumpTableStmt
  * @brief DUMP TABLE table TO archive_file_path
@@ -1345,7 +1430,7 @@ class DumpRestoreTableStmtBase : public DDLStmt {
     };
     std::unique_ptr<std::list<NameValueAssign*>, decltype(options_deleter)> options_ptr(
         options, options_deleter);
-    std::vector<std::string> allowed_compression_programs{"lz4", "gzip", "none"};
+    std::vector<std::string> allowed_compression_programs{"lz4", "gzip", "zstd", "none"};
     // specialize decompressor or break on osx bsdtar...
     if (options) {
       for (const auto option : *options) {
@@ -1362,6 +1447,7 @@ class DumpRestoreTableStmtBase : public DDLStmt {
               throw std::runtime_error("Compression program " + compression +
                                        " is not supported.");
             }
+            compression = lowercase_compression;
           } else {
             throw std::runtime_error("Compression option must be a string.");
           }
@@ -1381,14 +1467,24 @@ class DumpRestoreTableStmtBase : public DDLStmt {
     if (boost::iequals(compression, "none")) {
       compression.clear();
     } else {
-      std::map<std::string, std::string> decompression{{"lz4", "unlz4"},
-                                                       {"gzip", "gunzip"}};
-      const auto use_program = is_restore ? decompression[compression] : compression;
+      // tar runs the program with -d to decompress
+      std::map<std::string, std::string> decompression{
+          {"lz4", "unlz4"}, {"gzip", "gunzip"}, {"zstd", "zstd"}};
+      auto use_program = is_restore ? decompression[compression] : compression;
+      // pigz compresses the blocks of a gzip stream on all the cores
+      if (compression == "gzip" &&
+          !boost::process::search_path("pigz").string().empty()) {
+        use_program = "pigz";
+      }
       const auto prog_path = boost::process::search_path(use_program);
       if (prog_path.string().empty()) {
         throw std::runtime_error("Compression program " + use_program + " is not found.");
       }
-      compression = "--use-compress-program=" + use_program;
+      if (compression == "zstd" && !is_restore) {
+        // a compression thread per core
+        use_program += " -T0";
+      }
+      compression = "\"--use-compress-program=" + use_program + "\"";
     }
   }
   const std::string* getTable() const { return table.get(); }
@@ -26,6 +26,7 @@ static std::set<std::string> reserved_keywords{
     "ACCESS",
     "ADD",  // legacy
     "AMMSC",
+    "ANALYZE",
     "ARCHIVE",
     "ASC",
     "CONTINUE",
@@ -54,6 +55,7 @@ static std::set<std::string> reserved_keywords{
     "OPTION",
     "POINT",    // geo type
     "POLYGON",  // geo type
+    "PREWARM",
     "PRIVILEGES",
     "PUBLIC",
     "RENAME",
@@ -102,13 +102,13 @@ using namespace Parser;
 
 	/* literal keyword tokens */
 
-%token ADD ALL ALTER AMMSC ANY ARCHIVE ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
+%token ADD ALL ALTER AMMSC ANALYZE ANY ARCHIVE ARRAY AS ASC AUTHORIZATION BETWEEN BIGINT BOOLEAN BY
 %token CASE CAST CHAR_LENGTH CHARACTER CHECK CLOSE CLUSTER COLUMN COMMIT CONTINUE COPY CREATE CURRENT
 %token CURSOR DATABASE DATAFRAME DATE DATETIME DATE_TRUNC DECIMAL DECLARE DEFAULT DELETE DESC DICTIONARY DISTINCT DOUBLE DROP
 %token DUMP ELSE END EXISTS EXTRACT FETCH FIRST FLOAT FOR FOREIGN FOUND FROM
 %token GEOGRAPHY GEOMETRY GRANT GROUP HAVING IF ILIKE IN INSERT INTEGER INTO
 %token IS LANGUAGE LAST LENGTH LIKE LIMIT LINESTRING MOD MULTIPOLYGON NOW NULLX NUMERIC OF OFFSET ON OPEN OPTIMIZE
-%token OPTIMIZED OPTION ORDER PARAMETER POINT POLYGON PRECISION PRIMARY PRIVILEGES PROCEDURE
+%token OPTIMIZED OPTION ORDER PARAMETER POINT POLYGON PRECISION PREWARM PRIMARY PRIVILEGES PROCEDURE
 %token SERVER SMALLINT SOME TABLE TEMPORARY TEXT THEN TIME TIMESTAMP TINYINT TO TRUNCATE UNION
 %token PUBLIC REAL REFERENCES RENAME RESTORE REVOKE ROLE ROLLBACK SCHEMA SELECT SET SHARD SHARED SHOW
 %token UNIQUE UPDATE USER VALIDATE VALUES VIEW WHEN WHENEVER WHERE WITH WORK EDIT ACCESS DASHBOARD SQL EDITOR
@@ -140,6 +140,9 @@ sql:		/* schema {	$<nodeval>$ = $<nodeval>1; } */
 	| rename_column_statement { $<nodeval>$ = $<nodeval>1; }
 	| add_column_statement { $<nodeval>$ = $<nodeval>1; }
 	| drop_column_statement { $<nodeval>$ = $<nodeval>1; }
+	| alter_table_set_statement { $<nodeval>$ = $<nodeval>1; }
+	| prewarm_table_statement { $<nodeval>$ = $<nodeval>1; }
+	| analyze_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| copy_table_statement { $<nodeval>$ = $<nodeval>1; }
 	| create_database_statement { $<nodeval>$ = $<nodeval>1; }
 	| drop_database_statement { $<nodeval>$ = $<nodeval>1; }
@@ -350,6 +353,27 @@ drop_columns:
 drop_column:
 		DROP opt_column column { $<stringval>$ = $<stringval>3; }
 
+alter_table_set_statement:
+		ALTER TABLE table SET '(' name_eq_value_list ')'
+		{
+		   $<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new AlterTableSetOptionsStmt(($<stringval>3)->release(), reinterpret_cast<std::list<NameValueAssign*>*>(($<listval>6)->release())));
+		}
+		;
+
+prewarm_table_statement:
+		PREWARM TABLE table opt_with_option_list
+		{
+		   $<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new PrewarmTableStmt(($<stringval>3)->release(), reinterpret_cast<std::list<NameValueAssign*>*>(($<listval>4)->release())));
+		}
+		;
+
+analyze_table_statement:
+		ANALYZE TABLE table opt_with_option_list
+		{
+		   $<nodeval>$ = TrackedPtr<Node>::make(lexer.parsed_node_tokens_, new AnalyzeTableStmt(($<stringval>3)->release(), reinterpret_cast<std::list<NameValueAssign*>*>(($<listval>4)->release())));
+		}
+		;
+
 copy_table_statement:
 	COPY table FROM STRING opt_with_option_list
 	{
@@ -124,6 +124,8 @@ VARLEN_NOTNULL_ARRAY_AT(double)
 
 #undef VARLEN_NOTNULL_ARRAY_AT
 
+// The comparisons of all the elements are reduced without early exits, which lets the
+// loops over the elements vectorize
 #define ARRAY_ANY(type, needle_type, oper_name, oper)                    \
   extern "C" DEVICE bool array_any_##oper_name##_##type##_##needle_type( \
       int8_t* chunk_iter_,                                               \
@@ -135,13 +137,12 @@ VARLEN_NOTNULL_ARRAY_AT(double)
     bool is_end;                                                         \
     ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                \
     const size_t elem_count = ad.length / sizeof(type);                  \
+    bool found = false;                                                  \
     for (size_t i = 0; i < elem_count; ++i) {                            \
       const needle_type val = reinterpret_cast<type*>(ad.pointer)[i];    \
-      if (val != null_val && val oper needle) {                          \
-        return true;                                                     \
-      }                                                                  \
+      found |= (val != null_val) & (val oper needle);                    \
     }                                                                    \
-    return false;                                                        \
+    return found;                                                        \
   }
 
 #define ARRAY_ALL(type, needle_type, oper_name, oper)                    \
@@ -155,13 +156,12 @@ VARLEN_NOTNULL_ARRAY_AT(double)
     bool is_end;                                                         \
     ChunkIter_get_nth(chunk_iter, row_pos, &ad, &is_end);                \
     const size_t elem_count = ad.length / sizeof(type);                  \
+    bool all = true;                                                     \
     for (size_t i = 0; i < elem_count; ++i) {                            \
       const needle_type val = reinterpret_cast<type*>(ad.pointer)[i];    \
-      if (!(val != null_val && val oper needle)) {                       \
-        return false;                                                    \
-      }                                                                  \
+      all &= (val != null_val) & (val oper needle);                      \
     }                                                                    \
-    return true;                                                         \
+    return all;                                                          \
   }
 
 #define ARRAY_ALL_ANY_ALL_TYPES(oper_name, oper, needle_type) \
@@ -284,6 +284,24 @@ extern "C" DEVICE int8_t* array_buff(int8_t* chunk_iter_, const uint64_t row_pos
   return ad.pointer;
 }
 
+extern "C" DEVICE int8_t* varlen_array_buff(int8_t* chunk_iter_,
+                                            const uint64_t row_pos) {
+  ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
+  ArrayDatum ad;
+  bool is_end;
+  ChunkIter_get_nth_varlen(chunk_iter, row_pos, &ad, &is_end);
+  return ad.pointer;
+}
+
+extern "C" DEVICE int8_t* varlen_notnull_array_buff(int8_t* chunk_iter_,
+                                                    const uint64_t row_pos) {
+  ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);
+  ArrayDatum ad;
+  bool is_end;
+  ChunkIter_get_nth_varlen_notnull(chunk_iter, row_pos, &ad, &is_end);
+  return ad.pointer;
+}
+
 #ifndef __CUDACC__
 
 #include <set>
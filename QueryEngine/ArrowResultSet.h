@@ -186,6 +186,18 @@ class ArrowResultSetConverter {
 
   ArrowResult getArrowResult() const;
 
+  /// The results as a record batch in memory, without serializing it
+  std::shared_ptr<arrow::RecordBatch> convertToArrow() const;
+
+  /// The results as record batches of up to entries_per_batch entries of the result set,
+  /// each converted when it is read. There is at least one batch, which may be empty.
+  /// The dictionaries of the string columns are shared by all batches.
+  std::shared_ptr<arrow::RecordBatchReader> getArrowBatchReader(
+      const size_t entries_per_batch) const;
+
+  // entries of the result set per batch getArrowResult serializes
+  static constexpr size_t kEntriesPerBatch{1 << 20};
+
   // TODO(adb): Proper namespacing for this set of functionality. For now, make this
   // public and leverage the converter class as namespace
   struct ColumnBuilder {
@@ -193,6 +205,7 @@ class ArrowResultSetConverter {
     std::unique_ptr<arrow::ArrayBuilder> builder;
     SQLTypeInfo col_type;
     SQLTypes physical_type;
+    std::shared_ptr<arrow::Array> dictionary;  // of dictionary encoded strings
   };
 
  private:
@@ -201,10 +214,20 @@ class ArrowResultSetConverter {
                           const int32_t first_n)
       : results_(results), col_names_(col_names), top_n_(first_n) {}
 
-  std::shared_ptr<arrow::RecordBatch> convertToArrow() const;
+  std::shared_ptr<arrow::Schema> getArrowSchema() const;
+
+  /// The number of entries of the results converted, up to top_n_
+  size_t getEntryCount() const;
+
+  /// The strings of the dictionary encoded columns by column, null for other columns
+  std::vector<std::shared_ptr<arrow::Array>> getDictionaries() const;
 
+  /// Converts the entries [first_entry, end_entry) of the results
   std::shared_ptr<arrow::RecordBatch> getArrowBatch(
-      const std::shared_ptr<arrow::Schema>& schema) const;
+      const std::shared_ptr<arrow::Schema>& schema,
+      const std::vector<std::shared_ptr<arrow::Array>>& dictionaries,
+      const size_t first_entry,
+      const size_t end_entry) const;
 
   std::shared_ptr<arrow::Field> makeField(const std::string name,
                                           const SQLTypeInfo& target_type) const;
@@ -217,7 +240,8 @@ class ArrowResultSetConverter {
 
   void initializeColumnBuilder(ColumnBuilder& column_builder,
                                const SQLTypeInfo& col_type,
-                               const std::shared_ptr<arrow::Field>& field) const;
+                               const std::shared_ptr<arrow::Field>& field,
+                               const std::shared_ptr<arrow::Array>& dictionary) const;
 
   void append(ColumnBuilder& column_builder,
               const ValueArray& values,
@@ -22,10 +22,13 @@
 #include <sys/shm.h>
 #include <sys/types.h>
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <future>
+#include <map>
 #include <string>
 
 #include "arrow/api.h"
@@ -98,6 +101,21 @@ void create_or_append_value(const ScalarTargetValue& val_cty,
   values_ty->push_back(val_ty);
 }
 
+template <typename TYPE>
+bool is_valid_value(const TYPE value, const SQLTypeInfo& col_type) {
+  if (col_type.is_boolean()) {
+    return inline_int_null_val(col_type) != static_cast<int8_t>(value);
+  } else if (col_type.is_dict_encoded_string()) {
+    return inline_int_null_val(col_type) != static_cast<int32_t>(value);
+  } else if (col_type.is_integer() || col_type.is_time()) {
+    return inline_int_null_val(col_type) != static_cast<int64_t>(value);
+  } else if (col_type.is_fp()) {
+    return inline_fp_null_val(col_type) != static_cast<double>(value);
+  }
+  UNREACHABLE();
+  return false;
+}
+
 template <typename TYPE>
 void create_or_append_validity(const ScalarTargetValue& value,
                                const SQLTypeInfo& col_type,
@@ -109,18 +127,7 @@ void create_or_append_validity(const ScalarTargetValue& value,
   }
   auto pvalue = boost::get<TYPE>(&value);
   CHECK(pvalue);
-  bool is_valid = false;
-  if (col_type.is_boolean()) {
-    is_valid = inline_int_null_val(col_type) != static_cast<int8_t>(*pvalue);
-  } else if (col_type.is_dict_encoded_string()) {
-    is_valid = inline_int_null_val(col_type) != static_cast<int32_t>(*pvalue);
-  } else if (col_type.is_integer() || col_type.is_time()) {
-    is_valid = inline_int_null_val(col_type) != static_cast<int64_t>(*pvalue);
-  } else if (col_type.is_fp()) {
-    is_valid = inline_fp_null_val(col_type) != static_cast<double>(*pvalue);
-  } else {
-    UNREACHABLE();
-  }
+  const bool is_valid = is_valid_value(*pvalue, col_type);
 
   if (!null_bitmap) {
     null_bitmap = std::make_shared<std::vector<bool>>();
@@ -130,6 +137,34 @@ void create_or_append_validity(const ScalarTargetValue& value,
   null_bitmap->push_back(is_valid);
 }
 
+// Creates the values and the validity of the column col_idx of the entries in
+// [first_entry, end_entry) of results like the functions above do for each row, but from
+// the values of the column read straight from the storage. Returns the number of rows.
+template <typename TYPE, typename VALUE_TYPE>
+size_t create_column(const ResultSet& results,
+                     const size_t col_idx,
+                     const SQLTypeInfo& col_type,
+                     const size_t first_entry,
+                     const size_t end_entry,
+                     std::shared_ptr<ValueArray>& values,
+                     std::shared_ptr<std::vector<bool>>& null_bitmap) {
+  std::vector<VALUE_TYPE> column_values;
+  results.getColumnValues(col_idx, first_entry, end_entry, column_values);
+  if (column_values.empty()) {
+    return 0;
+  }
+  values = std::make_shared<ValueArray>(
+      std::vector<TYPE>(column_values.begin(), column_values.end()));
+  if (!col_type.get_notnull()) {
+    null_bitmap = std::make_shared<std::vector<bool>>();
+    null_bitmap->reserve(column_values.size());
+    for (const auto value : column_values) {
+      null_bitmap->push_back(is_valid_value(value, col_type));
+    }
+  }
+  return column_values.size();
+}
+
 std::pair<key_t, void*> get_shm(size_t shmsz) {
   if (!shmsz) {
     return std::make_pair(IPC_PRIVATE, nullptr);
@@ -196,10 +231,15 @@ key_t get_and_copy_to_shm(const std::shared_ptr<Buffer>& data) {
 //! upon deserialization, and will be automatically freed when they go out of scope.
 ArrowResult ArrowResultSetConverter::getArrowResult() const {
   auto timer = DEBUG_TIMER(__func__);
-  std::shared_ptr<arrow::RecordBatch> record_batch = convertToArrow();
 
   if (device_type_ == ExecutorDeviceType::CPU) {
-    auto timer = DEBUG_TIMER("serialize batch to shared memory");
+    auto timer = DEBUG_TIMER("serialize batches to shared memory");
+    // every batch is serialized as soon as it is converted, so that only one of them is
+    // in memory at once besides the serialized ones
+    const auto batch_reader = getArrowBatchReader(kEntriesPerBatch);
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    ARROW_THROW_NOT_OK(batch_reader->ReadNext(&record_batch));
+    CHECK(record_batch);
     std::shared_ptr<Buffer> serialized_records;
     std::shared_ptr<Buffer> serialized_schema;
     std::vector<char> schema_handle_buffer;
@@ -232,7 +272,16 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
         ipc::SerializeSchema(*record_batch->schema(), nullptr, default_memory_pool()));
     schema_size = serialized_schema->size();
 
-    ARROW_THROW_NOT_OK(ipc::GetRecordBatchSize(*record_batch, &records_size));
+    std::vector<std::shared_ptr<Buffer>> serialized_batches;
+    while (record_batch) {
+      std::shared_ptr<Buffer> serialized_batch;
+      ARROW_ASSIGN_OR_THROW(serialized_batch,
+                            ipc::SerializeRecordBatch(*record_batch, options));
+      records_size += serialized_batch->size();
+      serialized_batches.push_back(std::move(serialized_batch));
+      record_batch.reset();
+      ARROW_THROW_NOT_OK(batch_reader->ReadNext(&record_batch));
+    }
     total_size = schema_size + dict_size + records_size;
     std::tie(records_shm_key, serialized_records) = get_shm_buffer(total_size);
 
@@ -242,11 +291,14 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
     memcpy(serialized_records->mutable_data() + schema_size,
            serialized_dict->data(),
            (size_t)dict_size);
-
-    io::FixedSizeBufferWriter stream(
-        SliceMutableBuffer(serialized_records, schema_size + dict_size));
-    ARROW_THROW_NOT_OK(ipc::SerializeRecordBatch(
-        *record_batch, arrow::ipc::IpcWriteOptions::Defaults(), &stream));
+    int64_t records_offset = schema_size + dict_size;
+    for (auto& serialized_batch : serialized_batches) {
+      memcpy(serialized_records->mutable_data() + records_offset,
+             serialized_batch->data(),
+             (size_t)serialized_batch->size());
+      records_offset += serialized_batch->size();
+      serialized_batch.reset();
+    }
     memcpy(&record_handle_buffer[0],
            reinterpret_cast<const unsigned char*>(&records_shm_key),
            sizeof(key_t));
@@ -259,6 +311,8 @@ ArrowResult ArrowResultSetConverter::getArrowResult() const {
   }
 #ifdef HAVE_CUDA
   CHECK(device_type_ == ExecutorDeviceType::GPU);
+  // device buffers are serialized from a single batch
+  std::shared_ptr<arrow::RecordBatch> record_batch = convertToArrow();
 
   // Copy the schema to the schema handle
   auto out_stream_result = arrow::io::BufferOutputStream::Create(1024);
@@ -376,7 +430,72 @@ ArrowResultSetConverter::getSerializedArrowOutput(
   return {serialized_schema, serialized_records};
 }
 
+namespace {
+
+// Returns the batches next_batch converts, until it returns null
+class ArrowResultSetBatchReader : public arrow::RecordBatchReader {
+ public:
+  ArrowResultSetBatchReader(
+      std::shared_ptr<arrow::Schema> schema,
+      std::function<std::shared_ptr<arrow::RecordBatch>()> next_batch)
+      : schema_(std::move(schema)), next_batch_(std::move(next_batch)) {}
+
+  std::shared_ptr<arrow::Schema> schema() const override { return schema_; }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    try {
+      *batch = next_batch_();
+    } catch (const std::exception& e) {
+      return arrow::Status::Invalid(e.what());
+    }
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::shared_ptr<arrow::Schema> schema_;
+  std::function<std::shared_ptr<arrow::RecordBatch>()> next_batch_;
+};
+
+}  // namespace
+
+constexpr size_t ArrowResultSetConverter::kEntriesPerBatch;
+
 std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::convertToArrow() const {
+  return getArrowBatch(getArrowSchema(), getDictionaries(), 0, getEntryCount());
+}
+
+std::shared_ptr<arrow::RecordBatchReader> ArrowResultSetConverter::getArrowBatchReader(
+    const size_t entries_per_batch) const {
+  CHECK_GT(entries_per_batch, size_t(0));
+  const auto schema = getArrowSchema();
+  const auto dictionaries = getDictionaries();
+  const auto entry_count = getEntryCount();
+  // the reader converts with a copy of the converter, which shares the results
+  size_t start_entry = 0;
+  bool done = false;
+  return std::make_shared<ArrowResultSetBatchReader>(
+      schema,
+      [converter = *this,
+       schema,
+       dictionaries,
+       entry_count,
+       entries_per_batch,
+       start_entry,
+       done]() mutable -> std::shared_ptr<arrow::RecordBatch> {
+        if (done) {
+          return nullptr;
+        }
+        // an empty result is one empty batch
+        const auto end_entry = std::min(entry_count, start_entry + entries_per_batch);
+        auto batch =
+            converter.getArrowBatch(schema, dictionaries, start_entry, end_entry);
+        start_entry = end_entry;
+        done = start_entry >= entry_count;
+        return batch;
+      });
+}
+
+std::shared_ptr<arrow::Schema> ArrowResultSetConverter::getArrowSchema() const {
   const auto col_count = results_->colCount();
   std::vector<std::shared_ptr<arrow::Field>> fields;
   CHECK(col_names_.empty() || col_names_.size() == col_count);
@@ -384,16 +503,60 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::convertToArrow() co
     const auto ti = results_->getColType(i);
     fields.push_back(makeField(col_names_.empty() ? "" : col_names_[i], ti));
   }
-  return getArrowBatch(arrow::schema(fields));
+  return arrow::schema(fields);
+}
+
+size_t ArrowResultSetConverter::getEntryCount() const {
+  return top_n_ < 0 ? results_->entryCount()
+                    : std::min(size_t(top_n_), results_->entryCount());
+}
+
+std::vector<std::shared_ptr<arrow::Array>> ArrowResultSetConverter::getDictionaries()
+    const {
+  const auto col_count = results_->colCount();
+  // each dictionary is converted once, in parallel, for all the columns it encodes
+  std::map<int, std::future<std::shared_ptr<arrow::Array>>> arrays_by_dict_id;
+  for (size_t i = 0; i < col_count; ++i) {
+    const auto col_type = results_->getColType(i);
+    if (!col_type.is_dict_encoded_string()) {
+      continue;
+    }
+    const int dict_id = col_type.get_comp_param();
+    if (arrays_by_dict_id.count(dict_id)) {
+      continue;
+    }
+    arrays_by_dict_id.emplace(dict_id, std::async(std::launch::async, [this, dict_id] {
+      auto str_list = results_->getStringDictionaryPayloadCopy(dict_id);
+
+      arrow::StringBuilder str_array_builder;
+      ARROW_THROW_NOT_OK(str_array_builder.AppendValues(*str_list));
+      std::shared_ptr<arrow::Array> string_array;
+      ARROW_THROW_NOT_OK(str_array_builder.Finish(&string_array));
+      return string_array;
+    }));
+  }
+  std::map<int, std::shared_ptr<arrow::Array>> dictionaries_by_id;
+  for (auto& dict_future : arrays_by_dict_id) {
+    dictionaries_by_id.emplace(dict_future.first, dict_future.second.get());
+  }
+  std::vector<std::shared_ptr<arrow::Array>> dictionaries(col_count);
+  for (size_t i = 0; i < col_count; ++i) {
+    const auto col_type = results_->getColType(i);
+    if (col_type.is_dict_encoded_string()) {
+      dictionaries[i] = dictionaries_by_id.at(col_type.get_comp_param());
+    }
+  }
+  return dictionaries;
 }
 
 std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
-    const std::shared_ptr<arrow::Schema>& schema) const {
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::vector<std::shared_ptr<arrow::Array>>& dictionaries,
+    const size_t first_entry,
+    const size_t end_entry) const {
   std::vector<std::shared_ptr<arrow::Array>> result_columns;
 
-  const size_t entry_count = top_n_ < 0
-                                 ? results_->entryCount()
-                                 : std::min(size_t(top_n_), results_->entryCount());
+  const size_t entry_count = end_entry - first_entry;
   if (!entry_count) {
     return ARROW_RECORDBATCH_MAKE(schema, 0, result_columns);
   }
@@ -404,20 +567,125 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
 
   // Create array builders
   for (size_t i = 0; i < col_count; ++i) {
-    initializeColumnBuilder(builders[i], results_->getColType(i), schema->field(i));
+    initializeColumnBuilder(
+        builders[i], results_->getColType(i), schema->field(i), dictionaries[i]);
   }
 
-  // TODO(miyu): speed up for columnar buffers
+  // the columns read straight from the storage skip the TargetValues of the rows
+  bool read_columns = col_count > 0;
+  for (size_t i = 0; i < col_count && read_columns; ++i) {
+    switch (builders[i].physical_type) {
+      case kBOOLEAN:
+      case kTINYINT:
+      case kSMALLINT:
+      case kINT:
+      case kBIGINT:
+      case kFLOAT:
+      case kDOUBLE:
+      case kTIME:
+      case kTIMESTAMP:
+        read_columns = results_->isTypedColumnAccessPossible(i);
+        break;
+      default:
+        read_columns = false;
+    }
+  }
+  auto fetch_columns =
+      [&](std::vector<std::shared_ptr<ValueArray>>& value_seg,
+          std::vector<std::shared_ptr<std::vector<bool>>>& null_bitmap_seg,
+          const size_t start_entry,
+          const size_t end_entry) -> size_t {
+    size_t seg_row_count = 0;
+    const auto seg_first_entry = first_entry + start_entry;
+    const auto seg_end_entry = first_entry + end_entry;
+    for (size_t j = 0; j < col_count; ++j) {
+      const auto& column = builders[j];
+      switch (column.physical_type) {
+        case kBOOLEAN:
+          seg_row_count = create_column<bool, int64_t>(*results_,
+                                                       j,
+                                                       column.col_type,
+                                                       seg_first_entry,
+                                                       seg_end_entry,
+                                                       value_seg[j],
+                                                       null_bitmap_seg[j]);
+          break;
+        case kTINYINT:
+          seg_row_count = create_column<int8_t, int64_t>(*results_,
+                                                         j,
+                                                         column.col_type,
+                                                         seg_first_entry,
+                                                         seg_end_entry,
+                                                         value_seg[j],
+                                                         null_bitmap_seg[j]);
+          break;
+        case kSMALLINT:
+          seg_row_count = create_column<int16_t, int64_t>(*results_,
+                                                          j,
+                                                          column.col_type,
+                                                          seg_first_entry,
+                                                          seg_end_entry,
+                                                          value_seg[j],
+                                                          null_bitmap_seg[j]);
+          break;
+        case kINT:
+        case kTIME:
+          seg_row_count = create_column<int32_t, int64_t>(*results_,
+                                                          j,
+                                                          column.col_type,
+                                                          seg_first_entry,
+                                                          seg_end_entry,
+                                                          value_seg[j],
+                                                          null_bitmap_seg[j]);
+          break;
+        case kBIGINT:
+        case kTIMESTAMP:
+          seg_row_count = create_column<int64_t, int64_t>(*results_,
+                                                          j,
+                                                          column.col_type,
+                                                          seg_first_entry,
+                                                          seg_end_entry,
+                                                          value_seg[j],
+                                                          null_bitmap_seg[j]);
+          break;
+        case kFLOAT:
+          seg_row_count = create_column<float, float>(*results_,
+                                                      j,
+                                                      column.col_type,
+                                                      seg_first_entry,
+                                                      seg_end_entry,
+                                                      value_seg[j],
+                                                      null_bitmap_seg[j]);
+          break;
+        case kDOUBLE:
+          seg_row_count = create_column<double, double>(*results_,
+                                                        j,
+                                                        column.col_type,
+                                                        seg_first_entry,
+                                                        seg_end_entry,
+                                                        value_seg[j],
+                                                        null_bitmap_seg[j]);
+          break;
+        default:
+          UNREACHABLE();
+      }
+    }
+    return seg_row_count;
+  };
+
   auto fetch = [&](std::vector<std::shared_ptr<ValueArray>>& value_seg,
                    std::vector<std::shared_ptr<std::vector<bool>>>& null_bitmap_seg,
                    const size_t start_entry,
                    const size_t end_entry) -> size_t {
     CHECK_EQ(value_seg.size(), col_count);
     CHECK_EQ(null_bitmap_seg.size(), col_count);
+    if (read_columns) {
+      return fetch_columns(value_seg, null_bitmap_seg, start_entry, end_entry);
+    }
     const auto entry_count = end_entry - start_entry;
     size_t seg_row_count = 0;
     for (size_t i = start_entry; i < end_entry; ++i) {
-      auto row = results_->getRowAtNoTranslations(i);
+      auto row = results_->getRowAtNoTranslations(first_entry + i);
       if (row.empty()) {
         continue;
       }
@@ -501,16 +769,14 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
     return seg_row_count;
   };
 
-  std::vector<std::shared_ptr<ValueArray>> column_values(col_count, nullptr);
-  std::vector<std::shared_ptr<std::vector<bool>>> null_bitmaps(col_count, nullptr);
   const bool multithreaded = entry_count > 10000 && !results_->isTruncated();
+  const size_t cpu_count = multithreaded ? cpu_threads() : 1;
+  std::vector<std::vector<std::shared_ptr<ValueArray>>> column_value_segs(
+      cpu_count, std::vector<std::shared_ptr<ValueArray>>(col_count, nullptr));
+  std::vector<std::vector<std::shared_ptr<std::vector<bool>>>> null_bitmap_segs(
+      cpu_count, std::vector<std::shared_ptr<std::vector<bool>>>(col_count, nullptr));
   if (multithreaded) {
-    const size_t cpu_count = cpu_threads();
     std::vector<std::future<size_t>> child_threads;
-    std::vector<std::vector<std::shared_ptr<ValueArray>>> column_value_segs(
-        cpu_count, std::vector<std::shared_ptr<ValueArray>>(col_count, nullptr));
-    std::vector<std::vector<std::shared_ptr<std::vector<bool>>>> null_bitmap_segs(
-        cpu_count, std::vector<std::shared_ptr<std::vector<bool>>>(col_count, nullptr));
     const auto stride = (entry_count + cpu_count - 1) / cpu_count;
     for (size_t i = 0, start_entry = 0; start_entry < entry_count;
          ++i, start_entry += stride) {
@@ -525,23 +791,34 @@ std::shared_ptr<arrow::RecordBatch> ArrowResultSetConverter::getArrowBatch(
     for (auto& child : child_threads) {
       row_count += child.get();
     }
-    for (int i = 0; i < schema->num_fields(); ++i) {
+  } else {
+    row_count = fetch(column_value_segs[0], null_bitmap_segs[0], size_t(0), entry_count);
+  }
+
+  // the builders of the columns are independent, so the columns are appended to and
+  // finished in parallel too, each from the segments in order
+  result_columns.resize(col_count);
+  std::atomic<size_t> next_column{0};
+  auto build_columns = [&]() {
+    for (size_t i = next_column++; i < col_count; i = next_column++) {
       for (size_t j = 0; j < cpu_count; ++j) {
         if (!column_value_segs[j][i]) {
           continue;
         }
         append(builders[i], *column_value_segs[j][i], null_bitmap_segs[j][i]);
+        column_value_segs[j][i].reset();
+        null_bitmap_segs[j][i].reset();
       }
+      result_columns[i] = finishColumnBuilder(builders[i]);
     }
-  } else {
-    row_count = fetch(column_values, null_bitmaps, size_t(0), entry_count);
-    for (int i = 0; i < schema->num_fields(); ++i) {
-      append(builders[i], *column_values[i], null_bitmaps[i]);
-    }
+  };
+  std::vector<std::future<void>> column_threads;
+  for (size_t i = 1; i < std::min(cpu_count, col_count); ++i) {
+    column_threads.push_back(std::async(std::launch::async, build_columns));
   }
-
-  for (size_t i = 0; i < col_count; ++i) {
-    result_columns.push_back(finishColumnBuilder(builders[i]));
+  build_columns();
+  for (auto& child : column_threads) {
+    child.get();
   }
   return ARROW_RECORDBATCH_MAKE(schema, row_count, result_columns);
 }
@@ -658,7 +935,8 @@ void ArrowResultSet::deallocateArrowResultBuffer(
 void ArrowResultSetConverter::initializeColumnBuilder(
     ColumnBuilder& column_builder,
     const SQLTypeInfo& col_type,
-    const std::shared_ptr<arrow::Field>& field) const {
+    const std::shared_ptr<arrow::Field>& field,
+    const std::shared_ptr<arrow::Array>& dictionary) const {
   column_builder.field = field;
   column_builder.col_type = col_type;
   column_builder.physical_type = col_type.is_dict_encoded_string()
@@ -667,21 +945,10 @@ void ArrowResultSetConverter::initializeColumnBuilder(
 
   auto value_type = field->type();
   if (col_type.is_dict_encoded_string()) {
-    column_builder.builder.reset(new StringDictionary32Builder());
-    // add values to the builder
-    const int dict_id = col_type.get_comp_param();
-    auto str_list = results_->getStringDictionaryPayloadCopy(dict_id);
-
-    arrow::StringBuilder str_array_builder;
-    ARROW_THROW_NOT_OK(str_array_builder.AppendValues(*str_list));
-    std::shared_ptr<StringArray> string_array;
-    ARROW_THROW_NOT_OK(str_array_builder.Finish(&string_array));
-
-    auto dict_builder =
-        dynamic_cast<arrow::StringDictionary32Builder*>(column_builder.builder.get());
-    CHECK(dict_builder);
-
-    ARROW_THROW_NOT_OK(dict_builder->InsertMemoValues(*string_array));
+    // the ids are the indices of the strings in the dictionary, which all batches share
+    CHECK(dictionary);
+    column_builder.dictionary = dictionary;
+    column_builder.builder.reset(new Int32Builder());
   } else {
     ARROW_THROW_NOT_OK(
         arrow::MakeBuilder(default_memory_pool(), value_type, &column_builder.builder));
@@ -692,6 +959,10 @@ std::shared_ptr<arrow::Array> ArrowResultSetConverter::finishColumnBuilder(
     ColumnBuilder& column_builder) const {
   std::shared_ptr<Array> values;
   ARROW_THROW_NOT_OK(column_builder.builder->Finish(&values));
+  if (column_builder.dictionary) {
+    return std::make_shared<arrow::DictionaryArray>(
+        column_builder.field->type(), values, column_builder.dictionary);
+  }
   return values;
 }
 
@@ -701,9 +972,6 @@ template <typename BUILDER_TYPE, typename VALUE_ARRAY_TYPE>
 void appendToColumnBuilder(ArrowResultSetConverter::ColumnBuilder& column_builder,
                            const ValueArray& values,
                            const std::shared_ptr<std::vector<bool>>& is_valid) {
-  static_assert(!std::is_same<BUILDER_TYPE, arrow::StringDictionary32Builder>::value,
-                "Dictionary encoded string builder requires function specialization.");
-
   std::vector<VALUE_ARRAY_TYPE> vals = boost::get<std::vector<VALUE_ARRAY_TYPE>>(values);
 
   if (scale_epoch_values<BUILDER_TYPE>()) {
@@ -726,35 +994,6 @@ void appendToColumnBuilder(ArrowResultSetConverter::ColumnBuilder& column_builde
   }
 }
 
-template <>
-void appendToColumnBuilder<arrow::StringDictionary32Builder, int32_t>(
-    ArrowResultSetConverter::ColumnBuilder& column_builder,
-    const ValueArray& values,
-    const std::shared_ptr<std::vector<bool>>& is_valid) {
-  auto typed_builder =
-      dynamic_cast<arrow::StringDictionary32Builder*>(column_builder.builder.get());
-  CHECK(typed_builder);
-
-  std::vector<int32_t> vals = boost::get<std::vector<int32_t>>(values);
-
-  if (column_builder.field->nullable()) {
-    CHECK(is_valid.get());
-    // TODO(adb): Generate this instead of the boolean bitmap
-    std::vector<uint8_t> transformed_bitmap;
-    transformed_bitmap.reserve(is_valid->size());
-    std::for_each(
-        is_valid->begin(), is_valid->end(), [&transformed_bitmap](const bool is_valid) {
-          transformed_bitmap.push_back(is_valid ? 1 : 0);
-        });
-
-    ARROW_THROW_NOT_OK(typed_builder->AppendIndices(
-        vals.data(), static_cast<int64_t>(vals.size()), transformed_bitmap.data()));
-  } else {
-    ARROW_THROW_NOT_OK(
-        typed_builder->AppendIndices(vals.data(), static_cast<int64_t>(vals.size())));
-  }
-}
-
 }  // namespace
 
 void ArrowResultSetConverter::append(
@@ -764,8 +1003,7 @@ void ArrowResultSetConverter::append(
   if (column_builder.col_type.is_dict_encoded_string()) {
     CHECK_EQ(column_builder.physical_type,
              kINT);  // assume all dicts use none-encoded type for now
-    appendToColumnBuilder<StringDictionary32Builder, int32_t>(
-        column_builder, values, is_valid);
+    appendToColumnBuilder<Int32Builder, int32_t>(column_builder, values, is_valid);
     return;
   }
   switch (column_builder.physical_type) {
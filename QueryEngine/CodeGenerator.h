@@ -69,10 +69,12 @@ class CodeGenerator {
       const std::vector<llvm::Function*>& roots,
       const std::vector<llvm::Function*>& leaves);
 
+  // object_name names the object in the JitObjectCache, if any
   static ExecutionEngineWrapper generateNativeCPUCode(
       llvm::Function* func,
       const std::unordered_set<llvm::Function*>& live_funcs,
-      const CompilationOptions& co);
+      const CompilationOptions& co,
+      const std::string& object_name = "");
 
   static std::string generatePTX(const std::string& cuda_llir,
                                  llvm::TargetMachine* nvptx_target_machine,
@@ -96,12 +98,25 @@ class CodeGenerator {
       llvm::Function* wrapper_func,
       const std::unordered_set<llvm::Function*>& live_funcs,
       const CompilationOptions& co,
-      const GPUTarget& gpu_target);
-
-  static void link_udf_module(const std::unique_ptr<llvm::Module>& udf_module,
-                              llvm::Module& module,
-                              CgenState* cgen_state,
-                              llvm::Linker::Flags flags = llvm::Linker::Flags::None);
+      const GPUTarget& gpu_target,
+      const std::string& ptx_name = "");
+
+  // Optimizes the module of func and generates its PTX, ptx_name of the
+  // generateNativeGPUCode above names the PTX in the JitObjectCache, if any
+  static std::string lowerToPTX(llvm::Function* func,
+                                llvm::Function* wrapper_func,
+                                const std::unordered_set<llvm::Function*>& live_funcs,
+                                const CompilationOptions& co,
+                                const GPUTarget& gpu_target);
+
+  // Links the functions of udf_module into module, or only the UDFs whose upper case
+  // names without the suffix are in udf_names and the functions they use
+  static void link_udf_module(
+      const std::unique_ptr<llvm::Module>& udf_module,
+      llvm::Module& module,
+      CgenState* cgen_state,
+      llvm::Linker::Flags flags = llvm::Linker::Flags::None,
+      const std::unordered_set<std::string>* udf_names = nullptr);
 
   static bool prioritizeQuals(const RelAlgExecutionUnit& ra_exe_unit,
                               std::vector<Analyzer::Expr*>& primary_quals,
@@ -369,6 +384,12 @@ class CodeGenerator {
                                       const Analyzer::Expr*,
                                       const CompilationOptions&);
 
+  llvm::Value* codegenCmpDiffConst(const SQLOps,
+                                   const SQLQualifier,
+                                   const Analyzer::Expr*,
+                                   const Analyzer::Expr*,
+                                   const CompilationOptions&);
+
   llvm::Value* codegenOverlaps(const SQLOps,
                                const SQLQualifier,
                                const std::shared_ptr<Analyzer::Expr>,
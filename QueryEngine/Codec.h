@@ -53,16 +53,18 @@ class FixedWidthUnsigned : public Decoder {
   const size_t byte_width_;
 };
 
+// Offsets from the reference value of a chunk, see DataMgr/DiffEncoder.h
 class DiffFixedWidthInt : public Decoder {
  public:
-  DiffFixedWidthInt(const size_t byte_width, const int64_t baseline);
+  DiffFixedWidthInt(const size_t byte_width, const int64_t ret_null_val);
   llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
                                    llvm::Value* pos,
                                    llvm::Module* module) const override;
 
  private:
   const size_t byte_width_;
-  const int64_t baseline_;
+  const int32_t null_val_;
+  const int64_t ret_null_val_;
 };
 
 class FixedWidthReal : public Decoder {
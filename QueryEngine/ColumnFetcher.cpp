@@ -16,10 +16,78 @@
 
 #include "QueryEngine/ColumnFetcher.h"
 
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
 
+#include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/Execute.h"
 
+extern bool g_enable_mmap_cpu_chunks;
+
+bool g_enable_shared_columnar_fetches{true};
+
+namespace {
+
+// The min arena block size of a shared column, larger columns get a block of their own
+constexpr size_t kSharedColumnArenaBlockSize{1 << 20};
+
+// The columns which ColumnFetcher decodes or merges for the queries in flight, so that
+// the concurrent queries on a table convert each of its columns once. An entry lives as
+// long as a query holds it. The row counts in the keys keep the queries from sharing a
+// fragment which was appended to in between, and the other modifications wait for the
+// table data locks of the queries which hold the entries.
+class SharedColumnarResults {
+ public:
+  using Key = std::vector<int64_t>;
+  using Creator = std::function<std::unique_ptr<ColumnarResults>(
+      const std::shared_ptr<RowSetMemoryOwner>&)>;
+
+  static SharedColumnarResults& instance() {
+    static SharedColumnarResults shared_columnar_results;
+    return shared_columnar_results;
+  }
+
+  std::shared_ptr<const ColumnarResults> getOrCreate(const Key& key,
+                                                     const Creator& create) {
+    std::shared_ptr<Entry> entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& weak_entry = entries_[key];
+      entry = weak_entry.lock();
+      if (!entry) {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+          it = it->second.expired() && it->first != key ? entries_.erase(it)
+                                                        : std::next(it);
+        }
+        entry = std::make_shared<Entry>();
+        weak_entry = entry;
+      }
+    }
+    // the queries which want the column while it's created wait for it
+    std::call_once(entry->created, [&entry, &create] {
+      entry->row_set_mem_owner =
+          std::make_shared<RowSetMemoryOwner>(kSharedColumnArenaBlockSize);
+      entry->column = create(entry->row_set_mem_owner);
+    });
+    return std::shared_ptr<const ColumnarResults>(entry, entry->column.get());
+  }
+
+ private:
+  struct Entry {
+    std::once_flag created;
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner;
+    std::unique_ptr<const ColumnarResults> column;
+  };
+
+  std::mutex mutex_;
+  std::map<Key, std::weak_ptr<Entry>> entries_;
+};
+
+}  // namespace
+
 ColumnFetcher::ColumnFetcher(Executor* executor, const ColumnCacheMap& column_cache)
     : executor_(executor), columnarized_table_cache_(column_cache) {}
 
@@ -52,12 +120,16 @@ std::pair<const int8_t*, size_t> ColumnFetcher::getOneColumnFragment(
                        fragment.physicalTableId,
                        hash_col.get_column_id(),
                        fragment.fragmentId};
+    // the callers expect the logical type, DIFF encoded chunks are decoded on the CPU
+    const bool is_diff_encoded = cd->columnType.get_compression() == kENCODING_DIFF;
+    const auto chunk_mem_lvl =
+        is_diff_encoded ? Data_Namespace::CPU_LEVEL : effective_mem_lvl;
     const auto chunk = Chunk_NS::Chunk::getChunk(
         cd,
         &catalog.getDataMgr(),
         chunk_key,
-        effective_mem_lvl,
-        effective_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
+        chunk_mem_lvl,
+        chunk_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
         chunk_meta_it->second->numBytes,
         chunk_meta_it->second->numElements);
     chunks_owner.push_back(chunk);
@@ -65,6 +137,19 @@ std::pair<const int8_t*, size_t> ColumnFetcher::getOneColumnFragment(
     auto ab = chunk->getBuffer();
     CHECK(ab->getMemoryPtr());
     col_buff = reinterpret_cast<int8_t*>(ab->getMemoryPtr());
+    if (is_diff_encoded) {
+      const ColumnarResults decoded_column(executor->row_set_mem_owner_,
+                                           col_buff,
+                                           fragment.getNumTuples(),
+                                           cd->columnType);
+      col_buff = transferColumnIfNeeded(
+          &decoded_column,
+          0,
+          &catalog.getDataMgr(),
+          effective_mem_lvl,
+          effective_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
+          device_allocator);
+    }
   } else {  // temporary table
     const ColumnarResults* col_frag{nullptr};
     {
@@ -126,6 +211,9 @@ JoinColumn ColumnFetcher::makeJoinColumn(
   size_t num_elems = 0;
   size_t num_chunks = 0;
   for (auto& frag : fragments) {
+    if (Executor::isInterrupted()) {
+      throw QueryExecutionError(Executor::ERR_INTERRUPTED);
+    }
     auto [col_buff, elem_count] = getOneColumnFragment(
         executor,
         hash_col,
@@ -191,6 +279,21 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
   {
     ChunkKey chunk_key{
         cat.getCurrentDB().dbId, fragment.physicalTableId, col_id, fragment.fragmentId};
+    if (g_enable_mmap_cpu_chunks && memory_level == Data_Namespace::CPU_LEVEL &&
+        !is_varlen) {
+      // Full fragments no longer receive inserts and other modifications lock the table
+      // exclusively, so the mapped pages of their chunks stay stable during the query.
+      const auto td = cat.getMetadataForTable(fragment.physicalTableId);
+      CHECK(td);
+      if (td->storageType != StorageType::FOREIGN_TABLE &&
+          fragment.getPhysicalNumTuples() >= static_cast<size_t>(td->maxFragRows)) {
+        const auto mapped_data = cat.getDataMgr().getMappedChunkData(
+            chunk_key, chunk_meta_it->second->numBytes);
+        if (mapped_data) {
+          return mapped_data;
+        }
+      }
+    }
     std::unique_ptr<std::lock_guard<std::mutex>> varlen_chunk_lock;
     if (is_varlen) {
       varlen_chunk_lock.reset(new std::lock_guard<std::mutex>(varlen_chunk_mutex));
@@ -232,8 +335,27 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
   }
 }
 
-const int8_t* ColumnFetcher::getAllTableColumnFragments(
+void ColumnFetcher::prefetchTableColumnFragment(
     const int table_id,
+    const int frag_id,
+    const int col_id,
+    const std::map<int, const TableFragments*>& all_tables_fragments) const {
+  std::list<std::shared_ptr<Chunk_NS::Chunk>> chunk_holder;
+  std::list<ChunkIter> chunk_iter_holder;
+  getOneTableColumnFragment(table_id,
+                            frag_id,
+                            col_id,
+                            all_tables_fragments,
+                            chunk_holder,
+                            chunk_iter_holder,
+                            Data_Namespace::CPU_LEVEL,
+                            0,
+                            nullptr);
+}
+
+const int8_t* ColumnFetcher::getDecodedTableColumnFragment(
+    const int table_id,
+    const int frag_id,
     const int col_id,
     const std::map<int, const TableFragments*>& all_tables_fragments,
     const Data_Namespace::MemoryLevel memory_level,
@@ -241,27 +363,24 @@ const int8_t* ColumnFetcher::getAllTableColumnFragments(
     DeviceAllocator* device_allocator) const {
   const auto fragments_it = all_tables_fragments.find(table_id);
   CHECK(fragments_it != all_tables_fragments.end());
-  const auto fragments = fragments_it->second;
-  const auto frag_count = fragments->size();
-  std::vector<std::unique_ptr<ColumnarResults>> column_frags;
-  const ColumnarResults* table_column = nullptr;
-  const InputColDescriptor col_desc(col_id, table_id, int(0));
-  CHECK(col_desc.getScanDesc().getSourceType() == InputSourceType::TABLE);
+  const auto& fragment = (*fragments_it->second)[frag_id];
+  if (fragment.isEmptyPhysicalFragment()) {
+    return nullptr;
+  }
+  const ColumnarResults* fragment_column = nullptr;
   {
     std::lock_guard<std::mutex> columnar_conversion_guard(columnar_conversion_mutex_);
-    auto column_it = columnarized_scan_table_cache_.find(col_desc);
-    if (column_it == columnarized_scan_table_cache_.end()) {
-      for (size_t frag_id = 0; frag_id < frag_count; ++frag_id) {
-        std::list<std::shared_ptr<Chunk_NS::Chunk>> chunk_holder;
-        std::list<ChunkIter> chunk_iter_holder;
-        const auto& fragment = (*fragments)[frag_id];
-        if (fragment.isEmptyPhysicalFragment()) {
-          continue;
-        }
-        auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
-        CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+    const CacheKey cache_key{table_id, col_id, frag_id};
+    auto column_it = decoded_table_column_cache_.find(cache_key);
+    if (column_it == decoded_table_column_cache_.end()) {
+      std::list<std::shared_ptr<Chunk_NS::Chunk>> chunk_holder;
+      std::list<ChunkIter> chunk_iter_holder;
+      auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
+      CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+      CHECK_EQ(kENCODING_DIFF, chunk_meta_it->second->sqlType.get_compression());
+      auto decode = [&](const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner) {
         auto col_buffer = getOneTableColumnFragment(table_id,
-                                                    static_cast<int>(frag_id),
+                                                    frag_id,
                                                     col_id,
                                                     all_tables_fragments,
                                                     chunk_holder,
@@ -269,14 +388,58 @@ const int8_t* ColumnFetcher::getAllTableColumnFragments(
                                                     Data_Namespace::CPU_LEVEL,
                                                     int(0),
                                                     device_allocator);
-        column_frags.push_back(
-            std::make_unique<ColumnarResults>(executor_->row_set_mem_owner_,
-                                              col_buffer,
-                                              fragment.getNumTuples(),
-                                              chunk_meta_it->second->sqlType));
+        return std::make_unique<ColumnarResults>(row_set_mem_owner,
+                                                 col_buffer,
+                                                 fragment.getNumTuples(),
+                                                 chunk_meta_it->second->sqlType);
+      };
+      std::shared_ptr<const ColumnarResults> decoded_column;
+      if (g_enable_shared_columnar_fetches) {
+        const SharedColumnarResults::Key shared_key{
+            executor_->getCatalog()->getCurrentDB().dbId,
+            fragment.physicalTableId,
+            col_id,
+            fragment.fragmentId,
+            static_cast<int64_t>(fragment.getNumTuples())};
+        decoded_column =
+            SharedColumnarResults::instance().getOrCreate(shared_key, decode);
+      } else {
+        decoded_column = decode(executor_->row_set_mem_owner_);
       }
-      auto merged_results =
-          ColumnarResults::mergeResults(executor_->row_set_mem_owner_, column_frags);
+      column_it =
+          decoded_table_column_cache_.emplace(cache_key, std::move(decoded_column))
+              .first;
+    }
+    fragment_column = column_it->second.get();
+  }
+  return ColumnFetcher::transferColumnIfNeeded(fragment_column,
+                                               0,
+                                               &executor_->getCatalog()->getDataMgr(),
+                                               memory_level,
+                                               device_id,
+                                               device_allocator);
+}
+
+const int8_t* ColumnFetcher::getAllTableColumnFragments(
+    const int table_id,
+    const int col_id,
+    const std::map<int, const TableFragments*>& all_tables_fragments,
+    const Data_Namespace::MemoryLevel memory_level,
+    const int device_id,
+    DeviceAllocator* device_allocator) const {
+  const auto fragments_it = all_tables_fragments.find(table_id);
+  CHECK(fragments_it != all_tables_fragments.end());
+  std::vector<size_t> frag_ids(fragments_it->second->size());
+  std::iota(frag_ids.begin(), frag_ids.end(), size_t(0));
+  const ColumnarResults* table_column = nullptr;
+  const InputColDescriptor col_desc(col_id, table_id, int(0));
+  CHECK(col_desc.getScanDesc().getSourceType() == InputSourceType::TABLE);
+  {
+    std::lock_guard<std::mutex> columnar_conversion_guard(columnar_conversion_mutex_);
+    auto column_it = columnarized_scan_table_cache_.find(col_desc);
+    if (column_it == columnarized_scan_table_cache_.end()) {
+      auto merged_results = mergeTableColumnFragments(
+          table_id, col_id, frag_ids, all_tables_fragments, device_allocator);
       table_column = merged_results.get();
       columnarized_scan_table_cache_.emplace(col_desc, std::move(merged_results));
     } else {
@@ -291,6 +454,93 @@ const int8_t* ColumnFetcher::getAllTableColumnFragments(
                                                device_allocator);
 }
 
+const int8_t* ColumnFetcher::getTableColumnFragments(
+    const int table_id,
+    const int col_id,
+    const std::vector<size_t>& frag_ids,
+    const std::map<int, const TableFragments*>& all_tables_fragments,
+    const Data_Namespace::MemoryLevel memory_level,
+    const int device_id,
+    DeviceAllocator* device_allocator) const {
+  CacheKey cache_key{table_id, col_id};
+  cache_key.insert(cache_key.end(), frag_ids.begin(), frag_ids.end());
+  const ColumnarResults* table_column = nullptr;
+  {
+    std::lock_guard<std::mutex> columnar_conversion_guard(columnar_conversion_mutex_);
+    auto column_it = columnarized_partition_cache_.find(cache_key);
+    if (column_it == columnarized_partition_cache_.end()) {
+      auto merged_results = mergeTableColumnFragments(
+          table_id, col_id, frag_ids, all_tables_fragments, device_allocator);
+      table_column = merged_results.get();
+      columnarized_partition_cache_.emplace(cache_key, std::move(merged_results));
+    } else {
+      table_column = column_it->second.get();
+    }
+  }
+  return ColumnFetcher::transferColumnIfNeeded(table_column,
+                                               0,
+                                               &executor_->getCatalog()->getDataMgr(),
+                                               memory_level,
+                                               device_id,
+                                               device_allocator);
+}
+
+std::shared_ptr<const ColumnarResults> ColumnFetcher::mergeTableColumnFragments(
+    const int table_id,
+    const int col_id,
+    const std::vector<size_t>& frag_ids,
+    const std::map<int, const TableFragments*>& all_tables_fragments,
+    DeviceAllocator* device_allocator) const {
+  const auto fragments_it = all_tables_fragments.find(table_id);
+  CHECK(fragments_it != all_tables_fragments.end());
+  const auto fragments = fragments_it->second;
+  auto merge = [&](const std::shared_ptr<RowSetMemoryOwner>& row_set_mem_owner) {
+    std::vector<std::unique_ptr<ColumnarResults>> column_frags;
+    for (const auto frag_id : frag_ids) {
+      if (Executor::isInterrupted()) {
+        throw QueryExecutionError(Executor::ERR_INTERRUPTED);
+      }
+      std::list<std::shared_ptr<Chunk_NS::Chunk>> chunk_holder;
+      std::list<ChunkIter> chunk_iter_holder;
+      CHECK_LT(frag_id, fragments->size());
+      const auto& fragment = (*fragments)[frag_id];
+      if (fragment.isEmptyPhysicalFragment()) {
+        continue;
+      }
+      auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
+      CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+      auto col_buffer = getOneTableColumnFragment(table_id,
+                                                  static_cast<int>(frag_id),
+                                                  col_id,
+                                                  all_tables_fragments,
+                                                  chunk_holder,
+                                                  chunk_iter_holder,
+                                                  Data_Namespace::CPU_LEVEL,
+                                                  int(0),
+                                                  device_allocator);
+      column_frags.push_back(
+          std::make_unique<ColumnarResults>(row_set_mem_owner,
+                                            col_buffer,
+                                            fragment.getNumTuples(),
+                                            chunk_meta_it->second->sqlType));
+    }
+    return ColumnarResults::mergeResults(row_set_mem_owner, column_frags);
+  };
+  if (g_enable_shared_columnar_fetches) {
+    // the ids and the row counts of the fragments identify the version of the column
+    SharedColumnarResults::Key shared_key{
+        executor_->getCatalog()->getCurrentDB().dbId, table_id, col_id, -1};
+    for (const auto frag_id : frag_ids) {
+      const auto& fragment = (*fragments)[frag_id];
+      shared_key.push_back(fragment.physicalTableId);
+      shared_key.push_back(fragment.fragmentId);
+      shared_key.push_back(static_cast<int64_t>(fragment.getNumTuples()));
+    }
+    return SharedColumnarResults::instance().getOrCreate(shared_key, merge);
+  }
+  return merge(executor_->row_set_mem_owner_);
+}
+
 const int8_t* ColumnFetcher::getResultSetColumn(
     const InputColDescriptor* col_desc,
     const Data_Namespace::MemoryLevel memory_level,
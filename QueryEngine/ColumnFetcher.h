@@ -42,6 +42,8 @@ struct FetchResult {
   std::vector<std::vector<const int8_t*>> col_buffers;
   std::vector<std::vector<int64_t>> num_rows;
   std::vector<std::vector<uint64_t>> frag_offsets;
+  // parallel to col_buffers, empty unless some chunks are left to the results
+  std::vector<std::vector<DeferredColumnChunk>> deferred_chunks;
 };
 
 class ColumnFetcher {
@@ -82,6 +84,24 @@ class ColumnFetcher {
       const int device_id,
       DeviceAllocator* device_allocator) const;
 
+  // Loads the chunk into the CPU buffer pool and releases it right away.
+  void prefetchTableColumnFragment(
+      const int table_id,
+      const int frag_id,
+      const int col_id,
+      const std::map<int, const TableFragments*>& all_tables_fragments) const;
+
+  //! Like getOneTableColumnFragment(), for a DIFF encoded column which is decoded to
+  //! its logical type when first fetched.
+  const int8_t* getDecodedTableColumnFragment(
+      const int table_id,
+      const int frag_id,
+      const int col_id,
+      const std::map<int, const TableFragments*>& all_tables_fragments,
+      const Data_Namespace::MemoryLevel memory_level,
+      const int device_id,
+      DeviceAllocator* device_allocator) const;
+
   const int8_t* getAllTableColumnFragments(
       const int table_id,
       const int col_id,
@@ -90,12 +110,31 @@ class ColumnFetcher {
       const int device_id,
       DeviceAllocator* device_allocator) const;
 
+  //! Like getAllTableColumnFragments(), for the fragments frag_ids of the table only, in
+  //! their order: the fragments of a sharded inner table on a device.
+  const int8_t* getTableColumnFragments(
+      const int table_id,
+      const int col_id,
+      const std::vector<size_t>& frag_ids,
+      const std::map<int, const TableFragments*>& all_tables_fragments,
+      const Data_Namespace::MemoryLevel memory_level,
+      const int device_id,
+      DeviceAllocator* device_allocator) const;
+
   const int8_t* getResultSetColumn(const InputColDescriptor* col_desc,
                                    const Data_Namespace::MemoryLevel memory_level,
                                    const int device_id,
                                    DeviceAllocator* device_allocator) const;
 
  private:
+  // called with columnar_conversion_mutex_ held
+  std::shared_ptr<const ColumnarResults> mergeTableColumnFragments(
+      const int table_id,
+      const int col_id,
+      const std::vector<size_t>& frag_ids,
+      const std::map<int, const TableFragments*>& all_tables_fragments,
+      DeviceAllocator* device_allocator) const;
+
   static const int8_t* transferColumnIfNeeded(
       const ColumnarResults* columnar_results,
       const int col_id,
@@ -119,8 +158,15 @@ class ColumnFetcher {
       InputColDescriptor,
       std::unordered_map<CacheKey, std::unique_ptr<const ColumnarResults>>>
       columnarized_ref_table_cache_;
-  mutable std::unordered_map<InputColDescriptor, std::unique_ptr<const ColumnarResults>>
+  // shared with the concurrent queries which read the same columns, if enabled
+  mutable std::unordered_map<InputColDescriptor, std::shared_ptr<const ColumnarResults>>
       columnarized_scan_table_cache_;
+  // by table id, column id and the ids of the fragments
+  mutable std::unordered_map<CacheKey, std::shared_ptr<const ColumnarResults>>
+      columnarized_partition_cache_;
+  // by table id, column id and fragment id
+  mutable std::unordered_map<CacheKey, std::shared_ptr<const ColumnarResults>>
+      decoded_table_column_cache_;
 
   friend class QueryCompilationDescriptor;
   friend class TableFunctionExecutionContext;  // TODO(adb)
@@ -74,6 +74,8 @@ std::shared_ptr<Decoder> get_col_decoder(const Analyzer::ColumnVar* col_var) {
       return col_var->get_comp_param() == 16 ? std::make_shared<FixedWidthSmallDate>(2)
                                              : std::make_shared<FixedWidthSmallDate>(4);
     }
+    case kENCODING_DIFF:
+      return std::make_shared<DiffFixedWidthInt>(ti.get_size(), inline_int_null_val(ti));
     default:
       abort();
   }
@@ -113,6 +115,8 @@ std::vector<llvm::Value*> CodeGenerator::codegenColVar(const Analyzer::ColumnVar
   CHECK_LT(static_cast<size_t>(rte_idx), cgen_state_->frag_offsets_.size());
   const auto catalog = executor()->getCatalog();
   CHECK(catalog);
+  // the column as stored, if the generated code decodes its chunks itself
+  std::shared_ptr<Analyzer::ColumnVar> diff_col_var;
   if (col_var->get_table_id() > 0) {
     auto cd = get_column_descriptor(col_id, col_var->get_table_id(), *catalog);
     if (cd->isVirtualCol) {
@@ -120,6 +124,11 @@ std::vector<llvm::Value*> CodeGenerator::codegenColVar(const Analyzer::ColumnVar
       return {codegenRowId(col_var, co)};
     }
     auto col_ti = cd->columnType;
+    if (col_ti.get_compression() == kENCODING_DIFF &&
+        plan_state_->isDiffDecodedInCodegen(rte_idx)) {
+      diff_col_var = makeExpr<Analyzer::ColumnVar>(
+          col_ti, col_var->get_table_id(), col_id, rte_idx);
+    }
     if (col_ti.get_physical_coord_cols() > 0) {
       std::vector<llvm::Value*> cols;
       for (auto i = 0; i < col_ti.get_physical_coord_cols(); i++) {
@@ -214,11 +223,13 @@ std::vector<llvm::Value*> CodeGenerator::codegenColVar(const Analyzer::ColumnVar
   if (col_ti.is_array()) {
     return {col_byte_stream};
   }
+  const auto decoder_col_var = diff_col_var ? diff_col_var.get() : col_var;
   if (window_func_context) {
-    return {codegenFixedLengthColVarInWindow(col_var, col_byte_stream, pos_arg)};
+    return {
+        codegenFixedLengthColVarInWindow(decoder_col_var, col_byte_stream, pos_arg)};
   }
   const auto fixed_length_column_lv =
-      codegenFixedLengthColVar(col_var, col_byte_stream, pos_arg);
+      codegenFixedLengthColVar(decoder_col_var, col_byte_stream, pos_arg);
   auto it_ok = cgen_state_->fetch_cache_.insert(
       std::make_pair(local_col_id, std::vector<llvm::Value*>{fixed_length_column_lv}));
   CHECK(it_ok.second);
@@ -15,6 +15,7 @@
  */
 
 #include "ColumnarResults.h"
+#include "DataMgr/DiffEncoder.h"
 #include "Descriptors/RowSetMemoryOwner.h"
 #include "Shared/Intervals.h"
 #include "Shared/thread_count.h"
@@ -38,6 +39,20 @@ inline int64_t fixed_encoding_nullable_val(const int64_t val,
   return val;
 }
 
+// Whether the non-empty entries of rows are located and compacted into the columns
+// directly, reading each of their slots from the storage
+bool is_compacted_directly(const ResultSet& rows) {
+  switch (rows.getQueryDescriptionType()) {
+    case QueryDescriptionType::GroupByPerfectHash:
+    case QueryDescriptionType::GroupByBaselineHash:
+      return true;
+    case QueryDescriptionType::Projection:
+      return !rows.didOutputColumnar();
+    default:
+      return false;
+  }
+}
+
 }  // namespace
 
 ColumnarResults::ColumnarResults(std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
@@ -83,7 +98,9 @@ ColumnarResults::ColumnarResults(std::shared_ptr<RowSetMemoryOwner> row_set_mem_
                                  const SQLTypeInfo& target_type)
     : column_buffers_(1)
     , num_rows_(num_rows)
-    , target_types_{target_type}
+    , target_types_{target_type.get_compression() == kENCODING_DIFF
+                        ? get_logical_type_info(target_type)
+                        : target_type}
     , parallel_conversion_(false)
     , direct_columnar_conversion_(false) {
   auto timer = DEBUG_TIMER(__func__);
@@ -94,8 +111,13 @@ ColumnarResults::ColumnarResults(std::shared_ptr<RowSetMemoryOwner> row_set_mem_
   if (is_varlen) {
     throw ColumnarConversionNotSupported();
   }
-  const auto buf_size = num_rows * target_type.get_size();
+  const auto buf_size = num_rows * target_types_[0].get_size();
   column_buffers_[0] = reinterpret_cast<int8_t*>(row_set_mem_owner->allocate(buf_size));
+  if (target_type.get_compression() == kENCODING_DIFF) {
+    diff_decode_chunk_to_logical(
+        one_col_buffer, target_type, num_rows, column_buffers_[0]);
+    return;
+  }
   memcpy(((void*)column_buffers_[0]), one_col_buffer, buf_size);
 }
 
@@ -300,7 +322,11 @@ void ColumnarResults::materializeAllColumnsDirectly(const ResultSet& rows,
   CHECK(isDirectColumnarConversionPossible());
   switch (rows.getQueryDescriptionType()) {
     case QueryDescriptionType::Projection: {
-      materializeAllColumnsProjection(rows, num_columns);
+      if (rows.didOutputColumnar()) {
+        materializeAllColumnsProjection(rows, num_columns);
+      } else {
+        materializeAllColumnsGroupBy(rows, num_columns);
+      }
       break;
     }
     case QueryDescriptionType::GroupByPerfectHash:
@@ -450,16 +476,15 @@ void ColumnarResults::materializeAllLazyColumns(
 }
 
 /**
- * This function is to directly columnarize a result set for group by queries.
- * Its main difference with the traditional alternative is that it directly reads
- * non-empty entries from the result set, and then writes them into output column buffers,
- * rather than using the result set's iterators.
+ * This function is to directly columnarize a result set for group by queries and
+ * row-wise projections. Its main difference with the traditional alternative is that it
+ * directly reads non-empty entries from the result set, and then writes them into output
+ * column buffers, rather than using the result set's iterators.
  */
 void ColumnarResults::materializeAllColumnsGroupBy(const ResultSet& rows,
                                                    const size_t num_columns) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_directly(rows));
 
   const size_t num_threads = isParallelConversion() ? cpu_threads() : 1;
   const size_t entry_count = rows.entryCount();
@@ -497,8 +522,7 @@ void ColumnarResults::locateAndCountEntries(const ResultSet& rows,
                                             const size_t num_threads,
                                             const size_t size_per_thread) const {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_directly(rows));
   CHECK_EQ(num_threads, non_empty_per_thread.size());
   auto locate_and_count_func =
       [&rows, &bitmap, &non_empty_per_thread](
@@ -546,8 +570,7 @@ void ColumnarResults::compactAndCopyEntries(
     const size_t num_threads,
     const size_t size_per_thread) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_directly(rows));
   CHECK_EQ(num_threads, non_empty_per_thread.size());
 
   // compute the exclusive scan over all non-empty totals
@@ -555,6 +578,8 @@ void ColumnarResults::compactAndCopyEntries(
   std::partial_sum(non_empty_per_thread.begin(),
                    non_empty_per_thread.end(),
                    std::next(global_offsets.begin()));
+  // the columns hold the compacted entries only, e.g. for their transfers to the GPU
+  num_rows_ = global_offsets.back();
 
   const auto slot_idx_per_target_idx = rows.getSlotIndicesForTargetIndices();
   const auto [single_slot_targets_to_skip, num_single_slot_targets] =
@@ -604,8 +629,7 @@ void ColumnarResults::compactAndCopyEntriesWithTargetSkipping(
     const size_t num_threads,
     const size_t size_per_thread) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_directly(rows));
 
   const auto [write_functions, read_functions] =
       initAllConversionFunctions(rows, slot_idx_per_target_idx, targets_to_skip);
@@ -692,8 +716,7 @@ void ColumnarResults::compactAndCopyEntriesWithoutTargetSkipping(
     const size_t num_threads,
     const size_t size_per_thread) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_directly(rows));
 
   const auto [write_functions, read_functions] =
       initAllConversionFunctions(rows, slot_idx_per_target_idx);
@@ -758,8 +781,7 @@ std::vector<ColumnarResults::WriteFunction> ColumnarResults::initWriteFunctions(
     const ResultSet& rows,
     const std::vector<bool>& targets_to_skip) {
   CHECK(isDirectColumnarConversionPossible());
-  CHECK(rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-        rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash);
+  CHECK(is_compacted_directly(rows));
 
   std::vector<WriteFunction> result;
   result.reserve(target_types_.size());
@@ -996,6 +1018,12 @@ std::vector<ColumnarResults::ReadFunction> ColumnarResults::initReadFunctions(
         continue;
       }
     }
+    if (QUERY_TYPE == QueryDescriptionType::Projection &&
+        target_types_[target_idx].is_dict_encoded_string()) {
+      // the dictionary ids of the projections are in the low 32 bits of their slots
+      read_functions.emplace_back(read_int32_func<QUERY_TYPE, COLUMNAR_OUTPUT>);
+      continue;
+    }
     if (target_types_[target_idx].is_fp()) {
       switch (rows.getPaddedSlotWidthBytes(slot_idx_per_target_idx[target_idx])) {
         case 8:
@@ -1044,11 +1072,14 @@ ColumnarResults::initAllConversionFunctions(
     const ResultSet& rows,
     const std::vector<size_t>& slot_idx_per_target_idx,
     const std::vector<bool>& targets_to_skip) {
-  CHECK(isDirectColumnarConversionPossible() &&
-        (rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash ||
-         rows.getQueryDescriptionType() == QueryDescriptionType::GroupByBaselineHash));
+  CHECK(isDirectColumnarConversionPossible() && is_compacted_directly(rows));
 
   const auto write_functions = initWriteFunctions(rows, targets_to_skip);
+  if (rows.getQueryDescriptionType() == QueryDescriptionType::Projection) {
+    return std::make_tuple(std::move(write_functions),
+                           initReadFunctions<QueryDescriptionType::Projection, false>(
+                               rows, slot_idx_per_target_idx, targets_to_skip));
+  }
   if (rows.getQueryDescriptionType() == QueryDescriptionType::GroupByPerfectHash) {
     if (rows.didOutputColumnar()) {
       return std::make_tuple(
@@ -66,6 +66,7 @@ class ColumnarResults {
                   const std::vector<SQLTypeInfo>& target_types,
                   const bool is_parallel_execution_enforced = false);
 
+  // Copies a column fragment, decoding it to the logical type if it is DIFF encoded
   ColumnarResults(const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
                   const int8_t* one_col_buffer,
                   const size_t num_rows,
@@ -116,7 +117,8 @@ class ColumnarResults {
   void materializeAllColumnsThroughIteration(const ResultSet& rows,
                                              const size_t num_columns);
 
-  // Direct columnarization for group by queries (perfect hash or baseline hash)
+  // Direct columnarization for group by queries (perfect hash or baseline hash) and
+  // row-wise projections
   void materializeAllColumnsGroupBy(const ResultSet& rows, const size_t num_columns);
 
   // Direct columnarization for Projections (only output is columnar)
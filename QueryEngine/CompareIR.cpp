@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 
+#include "Codec.h"
 #include "CodeGenerator.h"
 #include "Execute.h"
+#include "WindowContext.h"
 
 #include <typeinfo>
 
@@ -224,6 +226,15 @@ llvm::Value* CodeGenerator::codegenCmp(const Analyzer::BinOper* bin_oper,
     }
   }
 
+  auto cmp_diff_const = codegenCmpDiffConst(optype, qualifier, lhs, rhs, co);
+  if (!cmp_diff_const) {
+    cmp_diff_const =
+        codegenCmpDiffConst(COMMUTE_COMPARISON(optype), qualifier, rhs, lhs, co);
+  }
+  if (cmp_diff_const) {
+    return cmp_diff_const;
+  }
+
   if (lhs_ti.is_decimal()) {
     auto cmp_decimal_const =
         codegenCmpDecimalConst(optype, qualifier, lhs, lhs_ti, rhs, co);
@@ -397,6 +408,93 @@ llvm::Value* CodeGenerator::codegenCmpDecimalConst(const SQLOps optype,
   return codegenCmp(optype, qualifier, {lhs_lv}, new_ti, new_rhs_lit.get(), co);
 }
 
+// Compares the offsets stored in a DIFF encoded chunk against the constant minus the
+// reference of the chunk, instead of decoding every value.
+llvm::Value* CodeGenerator::codegenCmpDiffConst(const SQLOps optype,
+                                                const SQLQualifier qualifier,
+                                                const Analyzer::Expr* lhs,
+                                                const Analyzer::Expr* rhs,
+                                                const CompilationOptions& co) {
+  AUTOMATIC_IR_METADATA(cgen_state_);
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(lhs);
+  const auto rhs_constant = dynamic_cast<const Analyzer::Constant*>(rhs);
+  if (!col_var || !rhs_constant || rhs_constant->get_is_null() || qualifier != kONE ||
+      col_var->get_table_id() <= 0 || col_var->get_rte_idx() > 0) {
+    return nullptr;
+  }
+  const auto& lhs_ti = col_var->get_type_info();
+  const auto& rhs_ti = rhs_constant->get_type_info();
+  if (lhs_ti.get_type() != rhs_ti.get_type() ||
+      lhs_ti.get_scale() != rhs_ti.get_scale() ||
+      (lhs_ti.is_timestamp() && lhs_ti.get_dimension() != rhs_ti.get_dimension())) {
+    return nullptr;
+  }
+  const auto cd = get_column_descriptor(
+      col_var->get_column_id(), col_var->get_table_id(), *executor()->getCatalog());
+  if (cd->isVirtualCol || cd->columnType.get_compression() != kENCODING_DIFF ||
+      !plan_state_->isDiffDecodedInCodegen(0)) {
+    return nullptr;
+  }
+  // leave the column to the regular path if it is fetched from anywhere else
+  if (WindowProjectNodeContext::getActiveWindowFunctionContext(executor()) ||
+      resolveGroupedColumnReference(col_var) || hashJoinLhs(col_var) ||
+      cgen_state_->fetch_cache_.count(plan_state_->getLocalColumnId(col_var, true))) {
+    return nullptr;
+  }
+  auto& ir_builder = cgen_state_->ir_builder_;
+  const auto i64_type = get_int_type(64, cgen_state_->context_);
+  const auto byte_stream = colByteStream(col_var, true, co.hoist_literals);
+  // the reference of the chunk, loop invariant
+  const auto reference = ir_builder.CreateLoad(
+      ir_builder.CreateBitCast(byte_stream, llvm::PointerType::get(i64_type, 0)));
+  reference->setMetadata(llvm::LLVMContext::MD_invariant_load,
+                         llvm::MDNode::get(cgen_state_->context_, {}));
+  const auto offset_width = cd->columnType.get_size();
+  const auto offsets_decoder = std::make_unique<FixedWidthInt>(offset_width);
+  const auto offset_lv = offsets_decoder->codegenDecode(
+      ir_builder.CreateGEP(byte_stream, cgen_state_->llInt(int64_t(sizeof(int64_t)))),
+      posArg(col_var),
+      cgen_state_->module_);
+  ir_builder.Insert(offset_lv);
+
+  const auto rhs_lv = cgen_state_->castToTypeIn(codegen(rhs, true, co).front(), 64);
+  const auto sub_with_overflow = ir_builder.CreateCall(
+      llvm::Intrinsic::getDeclaration(
+          cgen_state_->module_, llvm::Intrinsic::ssub_with_overflow, i64_type),
+      std::vector<llvm::Value*>{rhs_lv, reference});
+  // Clamp the difference to just outside of the range of the offsets, which compares
+  // the same for every offset and cannot be mistaken for the null offset.
+  const int64_t max_offset = (int64_t(1) << (8 * offset_width - 1)) - 1;
+  const auto below_offsets = cgen_state_->llInt(-max_offset - 2);
+  const auto above_offsets = cgen_state_->llInt(max_offset + 1);
+  auto rhs_offset_lv = ir_builder.CreateExtractValue(sub_with_overflow, 0);
+  rhs_offset_lv =
+      ir_builder.CreateSelect(ir_builder.CreateICmpSLT(rhs_offset_lv, below_offsets),
+                              below_offsets,
+                              rhs_offset_lv);
+  rhs_offset_lv =
+      ir_builder.CreateSelect(ir_builder.CreateICmpSGT(rhs_offset_lv, above_offsets),
+                              above_offsets,
+                              rhs_offset_lv);
+  rhs_offset_lv = ir_builder.CreateSelect(
+      ir_builder.CreateExtractValue(sub_with_overflow, 1),
+      ir_builder.CreateSelect(ir_builder.CreateICmpSLT(rhs_lv, cgen_state_->llInt(0L)),
+                              below_offsets,
+                              above_offsets),
+      rhs_offset_lv);
+
+  const auto null_check_suffix = get_null_check_suffix(lhs_ti, rhs_ti);
+  if (null_check_suffix.empty()) {
+    return ir_builder.CreateICmp(llvm_icmp_pred(optype), offset_lv, rhs_offset_lv);
+  }
+  return cgen_state_->emitCall(
+      icmp_name(optype) + "_int64_t_nullable_lhs",
+      {offset_lv,
+       rhs_offset_lv,
+       cgen_state_->llInt(-max_offset - 1),
+       cgen_state_->inlineIntNull(SQLTypeInfo(kBOOLEAN, false))});
+}
+
 llvm::Value* CodeGenerator::codegenCmp(const SQLOps optype,
                                        const SQLQualifier qualifier,
                                        std::vector<llvm::Value*> lhs_lvs,
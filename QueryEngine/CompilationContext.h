@@ -18,9 +18,13 @@
 
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
 
 class CompilationContext {
  public:
@@ -33,8 +37,10 @@ class ExecutionEngineWrapper {
  public:
   ExecutionEngineWrapper();
   ExecutionEngineWrapper(llvm::ExecutionEngine* execution_engine);
+  //! jit_label names the code of the engine in the perf map, see g_enable_jit_perf_map
   ExecutionEngineWrapper(llvm::ExecutionEngine* execution_engine,
-                         const CompilationOptions& co);
+                         const CompilationOptions& co,
+                         const std::string& jit_label = "");
 
   ExecutionEngineWrapper(const ExecutionEngineWrapper& other) = delete;
   ExecutionEngineWrapper(ExecutionEngineWrapper&& other) = default;
@@ -54,6 +60,8 @@ class ExecutionEngineWrapper {
   const llvm::ExecutionEngine* operator->() const { return execution_engine_.get(); }
 
  private:
+  // declared before the engine, which notifies it of its freed objects when destroyed
+  std::unique_ptr<llvm::JITEventListener> perf_map_listener_;
   std::unique_ptr<llvm::ExecutionEngine> execution_engine_;
   std::unique_ptr<llvm::JITEventListener> intel_jit_listener_;
 };
@@ -63,14 +71,36 @@ class CpuCompilationContext : public CompilationContext {
   CpuCompilationContext(ExecutionEngineWrapper&& execution_engine)
       : execution_engine_(std::move(execution_engine)) {}
 
+  // For code generated outside of the global LLVM context, e.g. in the background
+  CpuCompilationContext(ExecutionEngineWrapper&& execution_engine,
+                        std::unique_ptr<llvm::LLVMContext> context)
+      : context_(std::move(context)), execution_engine_(std::move(execution_engine)) {}
+
+  // For code still being generated, func() waits for it
+  CpuCompilationContext(
+      std::shared_future<std::shared_ptr<CpuCompilationContext>> pending_code)
+      : pending_code_(std::move(pending_code)) {}
+
   void setFunctionPointer(llvm::Function* function) {
     func_ = execution_engine_->getPointerToFunction(function);
     CHECK(func_);
   }
 
-  void* func() const { return func_; }
+  void* func() const {
+    if (pending_code_.valid()) {
+      std::call_once(pending_code_flag_, [this] {
+        generated_code_ = pending_code_.get();
+        func_ = generated_code_->func();
+      });
+    }
+    return func_;
+  }
 
  private:
-  void* func_{nullptr};
+  mutable void* func_{nullptr};
+  std::unique_ptr<llvm::LLVMContext> context_;  // outlives the module of the engine
   ExecutionEngineWrapper execution_engine_;
+  std::shared_future<std::shared_ptr<CpuCompilationContext>> pending_code_;
+  mutable std::once_flag pending_code_flag_;
+  mutable std::shared_ptr<CpuCompilationContext> generated_code_;
 };
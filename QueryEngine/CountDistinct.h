@@ -25,6 +25,7 @@
 #ifndef QUERYENGINE_COUNTDISTINCT_H
 #define QUERYENGINE_COUNTDISTINCT_H
 
+#include "CountDistinctHashSet.h"
 #include "Descriptors/CountDistinctDescriptor.h"
 #include "HyperLogLog.h"
 
@@ -93,8 +94,16 @@ inline int64_t count_distinct_set_size(
     }
     return bitmap_set_size(set_vals, count_distinct_desc.bitmapSizeBytes());
   }
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet) {
+    return reinterpret_cast<CountDistinctHashSet*>(set_handle)->size();
+  }
   CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
-  return reinterpret_cast<std::set<int64_t>*>(set_handle)->size();
+  const auto set = reinterpret_cast<std::set<int64_t>*>(set_handle);
+  if (count_distinct_desc.approximate) {
+    CHECK_GT(count_distinct_desc.bitmap_sz_bits, 0);
+    return hll_sparse_size(*set, count_distinct_desc.bitmap_sz_bits);
+  }
+  return set->size();
 }
 
 inline void count_distinct_set_union(
@@ -141,6 +150,12 @@ inline void count_distinct_set_union(
                                       : old_count_distinct_desc.bitmapPaddedSizeBytes();
       bitmap_set_union(new_set, old_set, bitmap_byte_sz);
     }
+  } else if (new_count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet) {
+    CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet);
+    auto old_set = reinterpret_cast<CountDistinctHashSet*>(old_set_handle);
+    auto new_set = reinterpret_cast<CountDistinctHashSet*>(new_set_handle);
+    new_set->merge(*old_set);
+    *old_set = *new_set;
   } else {
     CHECK(old_count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
     auto old_set = reinterpret_cast<std::set<int64_t>*>(old_set_handle);
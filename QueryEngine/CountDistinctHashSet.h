@@ -0,0 +1,127 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CountDistinctHashSet.h
+ * @brief   Open addressing hash set of the values of a COUNT(DISTINCT) group
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Linear probing set of 64-bit values, used by COUNT(DISTINCT) when the range of the
+ * argument is too large for a bitmap. It keeps the values in a flat array of at most
+ * half full slots, which is cheaper to fill and to merge than a tree of nodes.
+ */
+class CountDistinctHashSet {
+ public:
+  void insert(const int64_t val) {
+    if (val == kEmptySlot) {
+      has_empty_slot_val_ = true;
+      return;
+    }
+    if (2 * (value_count_ + 1) > slots_.size()) {
+      rehash(std::max(kMinSlots, 2 * slots_.size()));
+    }
+    insertNoGrow(val);
+  }
+
+  void merge(const CountDistinctHashSet& that) {
+    if (&that == this) {
+      return;
+    }
+    if (2 * (value_count_ + that.value_count_) > slots_.size()) {
+      rehash(std::max(kMinSlots, next_pow2(2 * (value_count_ + that.value_count_))));
+    }
+    for (const auto val : that.slots_) {
+      if (val != kEmptySlot) {
+        insertNoGrow(val);
+      }
+    }
+    has_empty_slot_val_ = has_empty_slot_val_ || that.has_empty_slot_val_;
+  }
+
+  size_t size() const { return value_count_ + (has_empty_slot_val_ ? 1 : 0); }
+
+  template <typename F>
+  void forEach(const F& func) const {
+    for (const auto val : slots_) {
+      if (val != kEmptySlot) {
+        func(val);
+      }
+    }
+    if (has_empty_slot_val_) {
+      func(kEmptySlot);
+    }
+  }
+
+ private:
+  static constexpr int64_t kEmptySlot{std::numeric_limits<int64_t>::min()};
+  static constexpr size_t kMinSlots{16};
+
+  static size_t next_pow2(const size_t n) {
+    size_t pow2{1};
+    while (pow2 < n) {
+      pow2 <<= 1;
+    }
+    return pow2;
+  }
+
+  size_t homeSlot(const int64_t val) const {
+    // Fibonacci hashing, the slot count is a power of 2
+    return (static_cast<uint64_t>(val) * 0x9E3779B97F4A7C15ULL) >> shift_;
+  }
+
+  void insertNoGrow(const int64_t val) {
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot = homeSlot(val);; slot = (slot + 1) & mask) {
+      if (slots_[slot] == val) {
+        return;
+      }
+      if (slots_[slot] == kEmptySlot) {
+        slots_[slot] = val;
+        ++value_count_;
+        return;
+      }
+    }
+  }
+
+  void rehash(const size_t new_slot_count) {
+    std::vector<int64_t> old_slots(new_slot_count, kEmptySlot);
+    old_slots.swap(slots_);
+    shift_ = 64;
+    for (size_t n = new_slot_count; n > 1; n >>= 1) {
+      --shift_;
+    }
+    value_count_ = 0;
+    for (const auto val : old_slots) {
+      if (val != kEmptySlot) {
+        insertNoGrow(val);
+      }
+    }
+  }
+
+  std::vector<int64_t> slots_;
+  size_t value_count_{0};  // the values in slots_
+  unsigned shift_{64};
+  bool has_empty_slot_val_{false};
+};
@@ -16,13 +16,66 @@
 
 #include "CodeGenerator.h"
 
+#include <limits>
+
 #include "DateTimeUtils.h"
 #include "Execute.h"
+#include "ExpressionRange.h"
 
 using namespace DateTimeUtils;
 
+bool g_enable_datetrunc_bucket_tables{true};
+
 namespace {
 
+// small enough for the table to stay in the L1 cache
+constexpr size_t kMaxDateTruncBuckets{1024};
+
+// The length of the longest bucket of the fields with calendar boundaries, zero for the
+// fields whose truncation is a single modulo
+int64_t get_max_calendar_bucket_secs(const DatetruncField field) {
+  switch (field) {
+    case dtMONTH:
+      return 31 * kSecsPerDay;
+    case dtQUARTER:
+      return 92 * kSecsPerDay;
+    case dtYEAR:
+      return 366 * kSecsPerDay;
+    case dtDECADE:
+      return 3653 * kSecsPerDay;
+    case dtCENTURY:
+      return 36525 * kSecsPerDay;
+    case dtMILLENNIUM:
+      return 365243 * kSecsPerDay;
+    default:
+      return 0;
+  }
+}
+
+// The starts of the buckets of field which cover arg_range followed by the end of the
+// last one, or nothing when the range isn't known or it covers too many buckets
+std::vector<uint64_t> get_datetrunc_bucket_starts(const DatetruncField field,
+                                                  const ExpressionRange& arg_range) {
+  const auto max_bucket_secs = get_max_calendar_bucket_secs(field);
+  if (!max_bucket_secs || arg_range.getType() != ExpressionRangeType::Integer ||
+      arg_range.getIntMax() < arg_range.getIntMin()) {
+    return {};
+  }
+  std::vector<uint64_t> bucket_starts;
+  int64_t bucket_start = DateTruncate(field, arg_range.getIntMin());
+  bucket_starts.push_back(bucket_start);
+  while (bucket_start <= arg_range.getIntMax()) {
+    if (bucket_starts.size() > kMaxDateTruncBuckets ||
+        bucket_start > std::numeric_limits<int64_t>::max() - max_bucket_secs) {
+      return {};
+    }
+    // a bucket is never longer than max_bucket_secs nor shorter than half of it
+    bucket_start = DateTruncate(field, bucket_start + max_bucket_secs);
+    bucket_starts.push_back(bucket_start);
+  }
+  return bucket_starts;
+}
+
 const char* get_extract_function_name(ExtractField field) {
   switch (field) {
     case kEPOCH:
@@ -239,9 +292,39 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::DatetruncExpr* datetrunc_exp
     nullcheck_codegen = std::make_unique<NullCheckCodegen>(
         cgen_state_, executor(), from_expr, datetrunc_expr_ti, "date_trunc_nullcheck");
   }
-  char const* const fname = datetrunc_fname_lookup.at(field);
-  auto ret = cgen_state_->emitExternalCall(
-      fname, get_int_type(64, cgen_state_->context_), {{from_expr}});
+  const auto i64_type = get_int_type(64, cgen_state_->context_);
+  const auto bucket_starts =
+      g_enable_datetrunc_bucket_tables && !cgen_state_->query_infos_.empty()
+          ? get_datetrunc_bucket_starts(
+                field,
+                getExpressionRange(datetrunc_expr->get_from_expr(),
+                                   cgen_state_->query_infos_,
+                                   executor()))
+          : std::vector<uint64_t>{};
+  llvm::Value* ret{nullptr};
+  if (!bucket_starts.empty()) {
+    // the group keys of the dashboards come from a search of the buckets of the range
+    // of the column computed here, without the calendar math for every row
+    auto bucket_starts_type = llvm::ArrayType::get(i64_type, bucket_starts.size());
+    auto bucket_starts_table = new llvm::GlobalVariable(
+        *cgen_state_->module_,
+        bucket_starts_type,
+        true,
+        llvm::GlobalValue::PrivateLinkage,
+        llvm::ConstantDataArray::get(cgen_state_->context_, bucket_starts),
+        "datetrunc_bucket_starts");
+    ret = cgen_state_->emitExternalCall(
+        "datetrunc_bucketed",
+        i64_type,
+        {from_expr,
+         cgen_state_->ir_builder_.CreateBitCast(bucket_starts_table,
+                                                llvm::PointerType::get(i64_type, 0)),
+         cgen_state_->llInt(static_cast<int32_t>(bucket_starts.size() - 1)),
+         cgen_state_->llInt(static_cast<int32_t>(field))});
+  } else {
+    char const* const fname = datetrunc_fname_lookup.at(field);
+    ret = cgen_state_->emitExternalCall(fname, i64_type, {{from_expr}});
+  }
   if (is_nullable) {
     ret = nullcheck_codegen->finalize(ll_int(NULL_BIGINT, cgen_state_->context_), ret);
   }
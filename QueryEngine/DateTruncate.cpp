@@ -211,7 +211,7 @@ extern "C" ALWAYS_INLINE DEVICE int64_t datetrunc_millennium(int64_t timeval) {
 /*
  * @brief support the SQL DATE_TRUNC function
  */
-int64_t DateTruncate(DatetruncField field, const int64_t timeval) {
+DEVICE int64_t DateTruncate(DatetruncField field, const int64_t timeval) {
   switch (field) {
     case dtNANOSECOND:
     case dtMICROSECOND:
@@ -249,6 +249,30 @@ int64_t DateTruncate(DatetruncField field, const int64_t timeval) {
   }
 }
 
+/*
+ * @brief DATE_TRUNC by a binary search of the bucket_count consecutive buckets of field
+ * which start at bucket_starts, the table the code generator computes over the range of
+ * the argument. The table ends with the end of the last bucket; the values outside of it,
+ * which the code compiled before the table grew can see, go through the calendar math.
+ */
+extern "C" DEVICE int64_t datetrunc_bucketed(const int64_t timeval,
+                                             const int64_t* bucket_starts,
+                                             const int32_t bucket_count,
+                                             const int32_t field) {
+  if (timeval < bucket_starts[0] || timeval >= bucket_starts[bucket_count]) {
+    return DateTruncate(static_cast<DatetruncField>(field), timeval);
+  }
+  // the same number of steps for every value, with a conditional move in each of them
+  const int64_t* bucket = bucket_starts;
+  int32_t count = bucket_count;
+  while (count > 1) {
+    const int32_t half = count / 2;
+    bucket = bucket[half] <= timeval ? bucket + half : bucket;
+    count -= half;
+  }
+  return *bucket;
+}
+
 // scale is 10^{3,6,9}
 extern "C" ALWAYS_INLINE DEVICE int64_t
 DateTruncateHighPrecisionToDate(const int64_t timeval, const int64_t scale) {
@@ -65,7 +65,12 @@ static_assert(dtSECOND + 1 == dtMILLISECOND, "Please keep these consecutive.");
 static_assert(dtMILLISECOND + 1 == dtMICROSECOND, "Please keep these consecutive.");
 static_assert(dtMICROSECOND + 1 == dtNANOSECOND, "Please keep these consecutive.");
 
-int64_t DateTruncate(DatetruncField field, const int64_t timeval);
+DEVICE int64_t DateTruncate(DatetruncField field, const int64_t timeval);
+
+extern "C" DEVICE int64_t datetrunc_bucketed(const int64_t timeval,
+                                             const int64_t* bucket_starts,
+                                             const int32_t bucket_count,
+                                             const int32_t field);
 
 extern "C" DEVICE int64_t DateTruncateHighPrecisionToDate(const int64_t timeval,
                                                           const int64_t scale);
@@ -93,12 +93,27 @@ SUFFIX(fixed_width_unsigned_decode_noinline)(const int8_t* byte_stream,
   return SUFFIX(fixed_width_unsigned_decode)(byte_stream, byte_width, pos);
 }
 
+// byte_stream is a whole chunk: the int64_t reference followed by the offsets from it
 extern "C" DEVICE ALWAYS_INLINE int64_t
 SUFFIX(diff_fixed_width_int_decode)(const int8_t* byte_stream,
                                     const int32_t byte_width,
-                                    const int64_t baseline,
+                                    const int32_t null_val,
+                                    const int64_t ret_null_val,
                                     const int64_t pos) {
-  return SUFFIX(fixed_width_int_decode)(byte_stream, byte_width, pos) + baseline;
+  const auto reference = *reinterpret_cast<const int64_t*>(byte_stream);
+  const auto val =
+      SUFFIX(fixed_width_int_decode)(byte_stream + sizeof(int64_t), byte_width, pos);
+  return val == null_val ? ret_null_val : val + reference;
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(diff_fixed_width_int_decode_noinline)(const int8_t* byte_stream,
+                                             const int32_t byte_width,
+                                             const int32_t null_val,
+                                             const int64_t ret_null_val,
+                                             const int64_t pos) {
+  return SUFFIX(diff_fixed_width_int_decode)(
+      byte_stream, byte_width, null_val, ret_null_val, pos);
 }
 
 extern "C" DEVICE ALWAYS_INLINE float SUFFIX(
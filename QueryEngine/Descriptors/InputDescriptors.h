@@ -20,14 +20,42 @@
 #include "../Catalog/TableDescriptor.h"
 #include "Logger/Logger.h"
 
+#include <cstdint>
 #include <memory>
 
 enum class InputSourceType { TABLE, RESULT };
 
+/**
+ * The fragments of a table TABLESAMPLE SYSTEM keeps: each of them with probability rate,
+ * by a hash of its id and of the REPEATABLE seed, so the same fragments are picked as
+ * long as the table doesn't change.
+ */
+struct FragmentSample {
+  double rate{1.};
+  int64_t seed{0};
+
+  bool isSampled() const { return rate < 1.; }
+
+  bool keepsFragment(const int fragment_id) const {
+    if (!isSampled()) {
+      return true;
+    }
+    // splitmix64 finalizer
+    uint64_t h = static_cast<uint64_t>(fragment_id) +
+                 static_cast<uint64_t>(seed) * 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return static_cast<double>(h >> 11) / static_cast<double>(uint64_t(1) << 53) < rate;
+  }
+};
+
 class InputDescriptor {
  public:
-  InputDescriptor(const int table_id, const int nest_level)
-      : table_id_(table_id), nest_level_(nest_level) {}
+  InputDescriptor(const int table_id,
+                  const int nest_level,
+                  const FragmentSample& fragment_sample = {})
+      : table_id_(table_id), nest_level_(nest_level), fragment_sample_(fragment_sample) {}
 
   bool operator==(const InputDescriptor& that) const {
     return table_id_ == that.table_id_ && nest_level_ == that.nest_level_;
@@ -37,6 +65,8 @@ class InputDescriptor {
 
   int getNestLevel() const { return nest_level_; }
 
+  const FragmentSample& getFragmentSample() const { return fragment_sample_; }
+
   InputSourceType getSourceType() const {
     return table_id_ > 0 ? InputSourceType::TABLE : InputSourceType::RESULT;
   }
@@ -44,11 +74,17 @@ class InputDescriptor {
  private:
   int table_id_;
   int nest_level_;
+  FragmentSample fragment_sample_;
 };
 
 inline std::ostream& operator<<(std::ostream& os, InputDescriptor const& id) {
-  return os << "InputDescriptor(table_id(" << id.getTableId() << "),nest_level("
-            << id.getNestLevel() << "))";
+  os << "InputDescriptor(table_id(" << id.getTableId() << "),nest_level("
+     << id.getNestLevel() << ")";
+  if (id.getFragmentSample().isSampled()) {
+    os << ",fragment_sample(" << id.getFragmentSample().rate << ","
+       << id.getFragmentSample().seed << ")";
+  }
+  return os << ")";
 }
 
 namespace std {
@@ -21,6 +21,8 @@
 #include "QueryEngine/Execute.h"
 #include "Shared/misc.h"
 
+extern bool g_enable_gpu_streaming;
+
 QueryFragmentDescriptor::QueryFragmentDescriptor(
     const RelAlgExecutionUnit& ra_exe_unit,
     const std::vector<InputTableInfo>& query_infos,
@@ -67,7 +69,9 @@ void QueryFragmentDescriptor::buildFragmentKernelMap(
     const ExecutorDeviceType& device_type,
     const bool enable_multifrag_kernels,
     const bool enable_inner_join_fragment_skipping,
+    const size_t sub_fragment_size,
     Executor* executor) {
+  sub_fragment_size_ = sub_fragment_size;
   // For joins, only consider the cardinality of the LHS
   // columns in the bytes per row count.
   std::set<int> lhs_table_ids;
@@ -145,9 +149,13 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
     }
 
     const auto& fragment = (*fragments)[i];
+    if (!table_desc.getFragmentSample().keepsFragment(fragment.fragmentId)) {
+      continue;
+    }
     const auto skip_frag = executor->skipFragment(
         table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
-    if (skip_frag.first) {
+    if (skip_frag.first ||
+        executor->skipFragmentInValues(table_desc, fragment, ra_exe_unit.quals)) {
       continue;
     }
     rowid_lookup_key_ = std::max(rowid_lookup_key_, skip_frag.second);
@@ -196,14 +204,25 @@ void QueryFragmentDescriptor::buildFragmentPerKernelForTable(
       }
     }
 
-    auto itr = execution_kernels_per_device_.find(device_id);
-    if (itr == execution_kernels_per_device_.end()) {
-      auto const pair = execution_kernels_per_device_.insert(std::make_pair(
-          device_id,
-          std::vector<ExecutionKernelDescriptor>{std::move(execution_kernel_desc)}));
-      CHECK(pair.second);
+    auto& device_kernels = execution_kernels_per_device_[device_id];
+    const auto num_physical_rows = fragment.getPhysicalNumTuples();
+    if (sub_fragment_size_ && device_type == ExecutorDeviceType::CPU &&
+        !table_desc_offset && ra_exe_unit.input_descs.size() == 1 &&
+        skip_frag.second < 0 && num_physical_rows > sub_fragment_size_) {
+      // Split the fragment into row range kernels so a table with few, large fragments
+      // can still use every CPU thread. The per-kernel results are reduced like those
+      // of regular per-fragment kernels.
+      for (size_t row_begin = 0; row_begin < num_physical_rows;
+           row_begin += sub_fragment_size_) {
+        const auto row_end = std::min(row_begin + sub_fragment_size_, num_physical_rows);
+        device_kernels.push_back(
+            ExecutionKernelDescriptor{device_id,
+                                      execution_kernel_desc.fragments,
+                                      std::nullopt,
+                                      FragmentRowRange{row_begin, row_end}});
+      }
     } else {
-      itr->second.emplace_back(std::move(execution_kernel_desc));
+      device_kernels.emplace_back(std::move(execution_kernel_desc));
     }
   }
 }
@@ -339,6 +358,9 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
     }
 
     const auto& fragment = (*outer_fragments)[outer_frag_id];
+    if (!outer_table_desc.getFragmentSample().keepsFragment(fragment.fragmentId)) {
+      continue;
+    }
     auto skip_frag = executor->skipFragment(outer_table_desc,
                                             fragment,
                                             ra_exe_unit.simple_quals,
@@ -349,15 +371,20 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
-    if (skip_frag.first) {
+    if (skip_frag.first ||
+        executor->skipFragmentInValues(outer_table_desc, fragment, ra_exe_unit.quals)) {
       continue;
     }
     const int device_id =
         fragment.shard == -1
             ? fragment.deviceIds[static_cast<int>(Data_Namespace::GPU_LEVEL)]
             : fragment.shard % device_count;
-    if (device_type == ExecutorDeviceType::GPU) {
-      checkDeviceMemoryUsage(fragment, device_id, num_bytes_for_row);
+    const bool starts_wave =
+        device_type == ExecutorDeviceType::GPU &&
+        checkDeviceMemoryUsage(fragment, device_id, num_bytes_for_row);
+    if (starts_wave) {
+      execution_kernels_per_device_[device_id].push_back(
+          ExecutionKernelDescriptor{device_id, FragmentsList{}, std::nullopt});
     }
     for (size_t j = 0; j < ra_exe_unit.input_descs.size(); ++j) {
       const auto table_id = ra_exe_unit.input_descs[j].getTableId();
@@ -380,10 +407,10 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
                 .second);
       }
 
-      // Multifrag kernels only have one execution kernel per device. Grab the execution
-      // kernel object and push back into its fragments list.
-      CHECK_EQ(execution_kernels_per_device_[device_id].size(), size_t(1));
-      auto& execution_kernel = execution_kernels_per_device_[device_id].front();
+      // Multifrag kernels only have one execution kernel per device, or one per wave of
+      // the GPU streaming mode. Grab the execution kernel object of the current wave and
+      // push back into its fragments list.
+      auto& execution_kernel = execution_kernels_per_device_[device_id].back();
 
       auto& kernel_frag_list = execution_kernel.fragments;
       if (kernel_frag_list.size() < j + 1) {
@@ -403,6 +430,63 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
   }
 }
 
+std::pair<size_t, size_t> QueryFragmentDescriptor::splitOffCpuKernels(
+    const double cpu_share) {
+  CHECK_EQ(selected_tables_fragments_.size(), size_t(1));
+  const auto table_id = selected_tables_fragments_.begin()->first;
+  const auto& fragments = *selected_tables_fragments_.begin()->second;
+  size_t total_rows{0};
+  for (const auto& device_itr : execution_kernels_per_device_) {
+    for (const auto& execution_kernel : device_itr.second) {
+      CHECK_EQ(execution_kernel.fragments.size(), size_t(1));
+      for (const auto frag_id : execution_kernel.fragments.front().fragment_ids) {
+        total_rows += fragments[frag_id].getNumTuples();
+      }
+    }
+  }
+
+  const auto cpu_rows_target = static_cast<size_t>(total_rows * cpu_share);
+  size_t cpu_rows{0};
+  bool split_finished = false;
+  while (!split_finished) {
+    split_finished = true;
+    for (auto& device_itr : execution_kernels_per_device_) {
+      auto& execution_kernels = device_itr.second;
+      if (execution_kernels.empty()) {
+        continue;
+      }
+      auto& frag_ids = execution_kernels.back().fragments.front().fragment_ids;
+      CHECK(!frag_ids.empty());
+      const auto& fragment = fragments[frag_ids.back()];
+      // stop at the first fragment which would overshoot the target by more than half
+      // of its rows
+      const auto fragment_rows = fragment.getNumTuples();
+      if (cpu_rows + fragment_rows / 2 >= cpu_rows_target) {
+        split_finished = true;
+        break;
+      }
+      split_finished = false;
+      cpu_rows += fragment_rows;
+      cpu_execution_kernels_.push_back(ExecutionKernelDescriptor{
+          fragment.deviceIds[static_cast<int>(Data_Namespace::CPU_LEVEL)],
+          {FragmentsPerTable{table_id, {frag_ids.back()}}},
+          frag_ids.size() == 1 ? execution_kernels.back().outer_tuple_count
+                               : std::nullopt});
+      frag_ids.pop_back();
+      if (frag_ids.empty()) {
+        execution_kernels.pop_back();
+      }
+    }
+  }
+  for (auto device_itr = execution_kernels_per_device_.begin();
+       device_itr != execution_kernels_per_device_.end();) {
+    device_itr = device_itr->second.empty()
+                     ? execution_kernels_per_device_.erase(device_itr)
+                     : std::next(device_itr);
+  }
+  return {total_rows - cpu_rows, cpu_rows};
+}
+
 namespace {
 
 bool is_sample_query(const RelAlgExecutionUnit& ra_exe_unit) {
@@ -437,25 +521,35 @@ bool QueryFragmentDescriptor::terminateDispatchMaybe(
   return false;
 }
 
-void QueryFragmentDescriptor::checkDeviceMemoryUsage(
+bool QueryFragmentDescriptor::checkDeviceMemoryUsage(
     const Fragmenter_Namespace::FragmentInfo& fragment,
     const int device_id,
     const size_t num_bytes_for_row) {
   if (g_cluster) {
     // Disabled in distributed mode for now
-    return;
+    return false;
   }
   CHECK_GE(device_id, 0);
   tuple_count_per_device_[device_id] += fragment.getNumTuples();
   const size_t gpu_bytes_limit =
       available_gpu_mem_bytes_[device_id] * gpu_input_mem_limit_percent_;
   if (tuple_count_per_device_[device_id] * num_bytes_for_row > gpu_bytes_limit) {
+    if (g_enable_gpu_streaming &&
+        fragment.getNumTuples() * num_bytes_for_row <= gpu_bytes_limit) {
+      // the fragments which don't fit with the former ones of the wave start the next
+      // one, the input chunks of each wave are released before the next one runs
+      VLOG(1) << "Starting a new wave of kernels on device " << device_id
+              << " at fragment " << fragment.fragmentId;
+      tuple_count_per_device_[device_id] = fragment.getNumTuples();
+      return true;
+    }
     LOG(WARNING) << "Not enough memory on device " << device_id
                  << " for input chunks totaling "
                  << tuple_count_per_device_[device_id] * num_bytes_for_row
                  << " bytes (available device memory: " << gpu_bytes_limit << " bytes)";
     throw QueryMustRunOnCpu();
   }
+  return false;
 }
 
 std::ostream& operator<<(std::ostream& os, FragmentsPerTable const& fragments_per_table) {
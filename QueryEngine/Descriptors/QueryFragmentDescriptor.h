@@ -30,6 +30,7 @@
 #include <ostream>
 #include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "DataMgr/ChunkMetadata.h"
@@ -57,11 +58,16 @@ struct FragmentsPerTable {
 using FragmentsList = std::vector<FragmentsPerTable>;
 using TableFragments = std::vector<Fragmenter_Namespace::FragmentInfo>;
 
+// Half-open range of physical row indices [first, second) within the outer fragment
+using FragmentRowRange = std::pair<size_t, size_t>;
+
 struct ExecutionKernelDescriptor {
   int device_id;
   FragmentsList fragments;
   std::optional<size_t> outer_tuple_count;  // only for fragments with an exact tuple
                                             // count available in metadata
+  std::optional<FragmentRowRange> outer_row_range{std::nullopt};  // set for sub-fragment
+                                                                  // kernels only
 };
 
 class QueryFragmentDescriptor {
@@ -83,20 +89,23 @@ class QueryFragmentDescriptor {
                               const ExecutorDeviceType& device_type,
                               const bool enable_multifrag_kernels,
                               const bool enable_inner_join_fragment_skipping,
+                              const size_t sub_fragment_size,
                               Executor* executor);
 
   /**
    * Dispatch multi-fragment kernels. Currently GPU only. Each GPU should have only one
-   * kernel, with multiple fragments in its fragments list.
+   * kernel, with multiple fragments in its fragments list, unless its inputs exceed its
+   * memory in the GPU streaming mode, which gives it a kernel for each wave of fragments.
    */
   template <typename DISPATCH_FCN>
   void assignFragsToMultiDispatch(DISPATCH_FCN f) const {
     for (const auto& device_itr : execution_kernels_per_device_) {
       const auto& execution_kernels = device_itr.second;
-      CHECK_EQ(execution_kernels.size(), size_t(1));
+      CHECK(!execution_kernels.empty());
 
-      const auto& fragments_list = execution_kernels.front().fragments;
-      f(device_itr.first, fragments_list, rowid_lookup_key_);
+      for (const auto& execution_kernel : execution_kernels) {
+        f(device_itr.first, execution_kernel.fragments, rowid_lookup_key_);
+      }
     }
   }
 
@@ -129,7 +138,10 @@ class QueryFragmentDescriptor {
         if (kernel_idx < device_itr.second.size()) {
           dispatch_finished = false;
           const auto& execution_kernel = device_itr.second[kernel_idx++];
-          f(device_itr.first, execution_kernel.fragments, rowid_lookup_key_);
+          f(device_itr.first,
+            execution_kernel.fragments,
+            rowid_lookup_key_,
+            execution_kernel.outer_row_range);
           if (terminateDispatchMaybe(tuple_count, ra_exe_unit, execution_kernel)) {
             return;
           }
@@ -138,6 +150,28 @@ class QueryFragmentDescriptor {
     }
   }
 
+  /**
+   * Moves about cpu_share of the outer rows of the GPU kernels of a single table query
+   * into kernels of one fragment each, which run on the CPU alongside the GPU kernels.
+   * The fragments are taken from the ends of the kernels of the devices in turn, so the
+   * GPUs keep balanced loads. Returns the outer rows left to the GPU kernels and the ones
+   * moved to the CPU kernels.
+   */
+  std::pair<size_t, size_t> splitOffCpuKernels(const double cpu_share);
+
+  /**
+   * Dispatch the CPU kernels split off the GPU kernels by `splitOffCpuKernels`.
+   */
+  template <typename DISPATCH_FCN>
+  void assignFragsToCpuDispatch(DISPATCH_FCN f) const {
+    for (const auto& execution_kernel : cpu_execution_kernels_) {
+      f(execution_kernel.device_id,
+        execution_kernel.fragments,
+        rowid_lookup_key_,
+        execution_kernel.outer_row_range);
+    }
+  }
+
   bool shouldCheckWorkUnitWatchdog() const {
     return rowid_lookup_key_ < 0 && !execution_kernels_per_device_.empty();
   }
@@ -146,10 +180,15 @@ class QueryFragmentDescriptor {
   std::vector<size_t> allowed_outer_fragment_indices_;
   size_t outer_fragments_size_ = 0;
   int64_t rowid_lookup_key_ = -1;
+  // when non-zero, large outer fragments of single table CPU queries are split into
+  // kernels covering at most this many rows each
+  size_t sub_fragment_size_ = 0;
 
   std::map<int, const TableFragments*> selected_tables_fragments_;
 
   std::map<int, std::vector<ExecutionKernelDescriptor>> execution_kernels_per_device_;
+  // the kernels of the hybrid queries which run on the CPU
+  std::vector<ExecutionKernelDescriptor> cpu_execution_kernels_;
 
   double gpu_input_mem_limit_percent_;
   std::map<size_t, size_t> tuple_count_per_device_;
@@ -193,7 +232,9 @@ class QueryFragmentDescriptor {
                               const RelAlgExecutionUnit& ra_exe_unit,
                               const ExecutionKernelDescriptor& kernel) const;
 
-  void checkDeviceMemoryUsage(const Fragmenter_Namespace::FragmentInfo& fragment,
+  // Returns true when the fragment starts a new wave of kernels on the device, which
+  // the GPU streaming mode runs once the inputs of the device exceed its memory
+  bool checkDeviceMemoryUsage(const Fragmenter_Namespace::FragmentInfo& fragment,
                               const int device_id,
                               const size_t num_cols);
 };
@@ -20,6 +20,7 @@
 #include "../ExpressionRewrite.h"
 #include "../GroupByAndAggregate.h"
 #include "../StreamingTopN.h"
+#include "../ThriftSerializers.h"
 #include "../UsedColumnsVisitor.h"
 #include "ColSlotContext.h"
 
@@ -540,6 +541,100 @@ QueryMemoryDescriptor::QueryMemoryDescriptor(const QueryDescriptionType query_de
     , use_streaming_top_n_(false)
     , force_4byte_float_(false) {}
 
+QueryMemoryDescriptor::QueryMemoryDescriptor(
+    const TResultSetBufferDescriptor& thrift_query_memory_descriptor)
+    : executor_(nullptr)
+    , allow_multifrag_(false)
+    , query_desc_type_(
+          ThriftSerializers::layout_from_thrift(thrift_query_memory_descriptor.layout))
+    , keyless_hash_(thrift_query_memory_descriptor.keyless)
+    , interleaved_bins_on_gpu_(false)
+    , idx_target_as_key_(thrift_query_memory_descriptor.idx_target_as_key)
+    , group_col_compact_width_(thrift_query_memory_descriptor.key_bytewidth)
+    , entry_count_(thrift_query_memory_descriptor.entry_count)
+    , min_val_(thrift_query_memory_descriptor.min_val)
+    , max_val_(thrift_query_memory_descriptor.max_val)
+    , bucket_(thrift_query_memory_descriptor.bucket)
+    , has_nulls_(false)
+    , sort_on_gpu_(false)
+    , output_columnar_(thrift_query_memory_descriptor.output_columnar)
+    , render_output_(false)
+    , must_use_baseline_sort_(false)
+    , is_table_function_(false)
+    , use_streaming_top_n_(false)
+    , force_4byte_float_(thrift_query_memory_descriptor.force_4byte_float) {
+  for (const auto group_col_width : thrift_query_memory_descriptor.group_col_widths) {
+    group_col_widths_.push_back(group_col_width);
+  }
+  for (const auto target_groupby_index :
+       thrift_query_memory_descriptor.target_groupby_indices) {
+    target_groupby_indices_.push_back(target_groupby_index);
+  }
+  for (const auto& thrift_count_distinct_descriptor :
+       thrift_query_memory_descriptor.count_distinct_descriptors) {
+    count_distinct_descriptors_.push_back(
+        ThriftSerializers::count_distinct_descriptor_from_thrift(
+            thrift_count_distinct_descriptor));
+  }
+  const auto& thrift_col_slot_context = thrift_query_memory_descriptor.col_slot_context;
+  for (const auto& slots_for_col : thrift_col_slot_context.col_to_slot_map) {
+    std::vector<std::tuple<int8_t, int8_t>> slot_sizes;
+    for (const auto slot_idx : slots_for_col) {
+      CHECK_LT(static_cast<size_t>(slot_idx),
+               thrift_col_slot_context.slot_sizes.size());
+      const auto& slot_size = thrift_col_slot_context.slot_sizes[slot_idx];
+      slot_sizes.emplace_back(slot_size.logical, slot_size.padded);
+    }
+    col_slot_context_.addColumn(slot_sizes);
+  }
+}
+
+TResultSetBufferDescriptor QueryMemoryDescriptor::toThrift(
+    const QueryMemoryDescriptor& query_mem_desc) {
+  TResultSetBufferDescriptor thrift_query_memory_descriptor;
+  thrift_query_memory_descriptor.layout =
+      ThriftSerializers::layout_to_thrift(query_mem_desc.query_desc_type_);
+  thrift_query_memory_descriptor.keyless = query_mem_desc.keyless_hash_;
+  thrift_query_memory_descriptor.entry_count = query_mem_desc.entry_count_;
+  thrift_query_memory_descriptor.idx_target_as_key = query_mem_desc.idx_target_as_key_;
+  thrift_query_memory_descriptor.min_val = query_mem_desc.min_val_;
+  thrift_query_memory_descriptor.max_val = query_mem_desc.max_val_;
+  thrift_query_memory_descriptor.bucket = query_mem_desc.bucket_;
+  for (const auto group_col_width : query_mem_desc.group_col_widths_) {
+    thrift_query_memory_descriptor.group_col_widths.push_back(group_col_width);
+  }
+  thrift_query_memory_descriptor.key_bytewidth = query_mem_desc.group_col_compact_width_;
+  const auto& col_slot_context = query_mem_desc.col_slot_context_;
+  auto& thrift_col_slot_context = thrift_query_memory_descriptor.col_slot_context;
+  for (size_t slot_idx = 0; slot_idx < col_slot_context.getSlotCount(); ++slot_idx) {
+    const auto& slot_size = col_slot_context.getSlotInfo(slot_idx);
+    TSlotSize thrift_slot_size;
+    thrift_slot_size.padded = slot_size.padded_size;
+    thrift_slot_size.logical = slot_size.logical_size;
+    thrift_col_slot_context.slot_sizes.push_back(thrift_slot_size);
+  }
+  for (size_t col_idx = 0; col_idx < col_slot_context.getColCount(); ++col_idx) {
+    std::vector<int32_t> slots_for_col;
+    for (const auto slot_idx : col_slot_context.getSlotsForCol(col_idx)) {
+      slots_for_col.push_back(slot_idx);
+    }
+    thrift_col_slot_context.col_to_slot_map.push_back(slots_for_col);
+  }
+  for (const auto target_groupby_index : query_mem_desc.target_groupby_indices_) {
+    thrift_query_memory_descriptor.target_groupby_indices.push_back(
+        target_groupby_index);
+  }
+  for (const auto& count_distinct_descriptor :
+       query_mem_desc.count_distinct_descriptors_) {
+    thrift_query_memory_descriptor.count_distinct_descriptors.push_back(
+        ThriftSerializers::count_distinct_descriptor_to_thrift(
+            count_distinct_descriptor));
+  }
+  thrift_query_memory_descriptor.force_4byte_float = query_mem_desc.force_4byte_float_;
+  thrift_query_memory_descriptor.output_columnar = query_mem_desc.output_columnar_;
+  return thrift_query_memory_descriptor;
+}
+
 bool QueryMemoryDescriptor::operator==(const QueryMemoryDescriptor& other) const {
   // Note that this method does not check ptr reference members (e.g. executor_) or
   // entry_count_
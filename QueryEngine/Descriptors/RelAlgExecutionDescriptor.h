@@ -58,6 +58,11 @@ class ExecutionResult {
     result_->setQueueTime(queue_time_ms);
   }
 
+  void setGpuMemoryUsage(const DeviceMemoryUsage& gpu_memory_usage) {
+    CHECK(result_);
+    result_->setGpuMemoryUsage(gpu_memory_usage);
+  }
+
  private:
   ResultSetPtr result_;
   std::vector<TargetMetaInfo> targets_meta_;
@@ -26,6 +26,9 @@
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/Allocators/ArenaAllocator.h"
+#include "DataMgr/Allocators/DeviceMemoryUsageTracker.h"
+#include "QueryEngine/CountDistinctHashSet.h"
+#include "QueryEngine/TDigest.h"
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
 #include "StringDictionary/StringDictionaryProxy.h"
@@ -40,7 +43,8 @@ class RowSetMemoryOwner : boost::noncopyable {
  public:
   RowSetMemoryOwner(const size_t arena_block_size)
       : arena_block_size_(arena_block_size)
-      , allocator_(std::make_unique<Arena>(arena_block_size)) {}
+      , allocator_(std::make_unique<PooledArena>(arena_block_size))
+      , gpu_memory_usage_(std::make_shared<DeviceMemoryUsageTracker>()) {}
 
   int8_t* allocate(const size_t num_bytes) {
     CHECK(allocator_);
@@ -70,6 +74,17 @@ class RowSetMemoryOwner : boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
+  void addCountDistinctHashSet(CountDistinctHashSet* count_distinct_hash_set) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    count_distinct_hash_sets_.push_back(count_distinct_hash_set);
+  }
+
+  TDigest* newTDigest(const double q) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    t_digests_.push_back(std::make_unique<TDigest>(q));
+    return t_digests_.back().get();
+  }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
@@ -147,6 +162,9 @@ class RowSetMemoryOwner : boost::noncopyable {
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
+    for (auto count_distinct_hash_set : count_distinct_hash_sets_) {
+      delete count_distinct_hash_set;
+    }
     for (auto group_by_buffer : group_by_buffers_) {
       free(group_by_buffer);
     }
@@ -162,6 +180,14 @@ class RowSetMemoryOwner : boost::noncopyable {
     }
   }
 
+  /**
+   * Tracks the GPU memory used by the query this owner belongs to. Allocators hold a
+   * reference, so releases after the owner is gone are still accounted.
+   */
+  std::shared_ptr<DeviceMemoryUsageTracker> getGpuMemoryUsageTracker() const {
+    return gpu_memory_usage_;
+  }
+
   std::shared_ptr<RowSetMemoryOwner> cloneStrDictDataOnly() {
     auto rtn = std::make_shared<RowSetMemoryOwner>(arena_block_size_);
     rtn->str_dict_proxy_owned_ = str_dict_proxy_owned_;
@@ -178,6 +204,8 @@ class RowSetMemoryOwner : boost::noncopyable {
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<CountDistinctHashSet*> count_distinct_hash_sets_;
+  std::vector<std::unique_ptr<TDigest>> t_digests_;
   std::vector<int64_t*> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
@@ -188,7 +216,8 @@ class RowSetMemoryOwner : boost::noncopyable {
   std::vector<Data_Namespace::AbstractBuffer*> varlen_input_buffers_;
 
   size_t arena_block_size_;  // for cloning
-  std::unique_ptr<Arena> allocator_;
+  std::unique_ptr<PooledArena> allocator_;
+  std::shared_ptr<DeviceMemoryUsageTracker> gpu_memory_usage_;
 
   mutable std::mutex state_mutex_;
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/DeviceCostModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+#include "Catalog/Catalog.h"
+#include "CudaMgr/CudaMgr.h"
+#include "DataMgr/DataMgr.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+#include "Shared/scope.h"
+
+bool g_enable_device_cost_model{false};
+
+namespace {
+
+constexpr size_t kCalibrationBytes{64 * 1024 * 1024};
+constexpr size_t kCalibrationRuns{5};
+
+double elapsed_seconds(const std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// The scan rate of each thread while all of them sum their own buffer, since the
+// threads of the CPU kernels share the memory bandwidth
+double measure_cpu_scan_rate(const size_t thread_count) {
+  const size_t values_per_thread = kCalibrationBytes / thread_count / sizeof(int64_t);
+  std::vector<std::vector<int64_t>> buffers(thread_count,
+                                            std::vector<int64_t>(values_per_thread, 1));
+  const auto begin = std::chrono::steady_clock::now();
+  std::vector<std::future<int64_t>> sums;
+  for (const auto& buffer : buffers) {
+    sums.push_back(std::async(std::launch::async, [&buffer] {
+      int64_t sum{0};
+      for (size_t run = 0; run < kCalibrationRuns; ++run) {
+        sum = std::accumulate(buffer.begin(), buffer.end(), sum);
+      }
+      return sum;
+    }));
+  }
+  int64_t total{0};
+  for (auto& sum : sums) {
+    total += sum.get();
+  }
+  const auto seconds = elapsed_seconds(begin);
+  CHECK_EQ(static_cast<size_t>(total),
+           values_per_thread * thread_count * kCalibrationRuns);
+  return values_per_thread * sizeof(int64_t) * kCalibrationRuns / seconds;
+}
+
+}  // namespace
+
+DeviceCostModel& DeviceCostModel::instance() {
+  static DeviceCostModel device_cost_model;
+  return device_cost_model;
+}
+
+void DeviceCostModel::calibrate(Data_Namespace::DataMgr& data_mgr) {
+  auto cuda_mgr = data_mgr.getCudaMgr();
+  if (!cuda_mgr || !cuda_mgr->getDeviceCount()) {
+    LOG(INFO) << "No GPUs to calibrate the device cost model for";
+    return;
+  }
+  Rates rates;
+  rates.cpu_thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+  rates.cpu_scan_bytes_per_sec = measure_cpu_scan_rate(rates.cpu_thread_count);
+
+  rates.gpu_count = cuda_mgr->getDeviceCount();
+  for (const auto& device_properties : cuda_mgr->getAllDeviceProperties()) {
+    rates.gpu_scan_bytes_per_sec += device_properties.memoryBandwidthGBs * 1e9;
+  }
+
+  auto host_ptr = cuda_mgr->allocatePinnedHostMem(kCalibrationBytes);
+  auto device_ptr = cuda_mgr->allocateDeviceMem(kCalibrationBytes, 0);
+  ScopeGuard free_calibration_buffers = [cuda_mgr, host_ptr, device_ptr] {
+    cuda_mgr->freeDeviceMem(device_ptr);
+    cuda_mgr->freePinnedHostMem(host_ptr);
+  };
+  std::fill(host_ptr, host_ptr + kCalibrationBytes, 1);
+  // the first copy pays for the setup of the device context
+  cuda_mgr->copyHostToDevice(device_ptr, host_ptr, kCalibrationBytes, 0);
+  auto begin = std::chrono::steady_clock::now();
+  for (size_t run = 0; run < kCalibrationRuns; ++run) {
+    cuda_mgr->copyHostToDevice(device_ptr, host_ptr, kCalibrationBytes, 0);
+  }
+  rates.pcie_bytes_per_sec =
+      kCalibrationBytes * kCalibrationRuns / elapsed_seconds(begin);
+
+  // a one byte memset is a kernel of the driver, its round trip is the launch latency
+  constexpr size_t kLaunchRuns{100};
+  begin = std::chrono::steady_clock::now();
+  for (size_t run = 0; run < kLaunchRuns; ++run) {
+    cuda_mgr->setDeviceMem(device_ptr, 0, 1, 0);
+    cuda_mgr->synchronizeDevices();
+  }
+  rates.kernel_launch_sec = elapsed_seconds(begin) / kLaunchRuns;
+
+  LOG(INFO) << "Device cost model calibrated: PCIe " << rates.pcie_bytes_per_sec / 1e9
+            << " GB/s, kernel launch " << rates.kernel_launch_sec * 1e6 << " us, "
+            << rates.gpu_count << " GPUs scanning " << rates.gpu_scan_bytes_per_sec / 1e9
+            << " GB/s, " << rates.cpu_thread_count << " CPU threads scanning "
+            << rates.cpu_scan_bytes_per_sec / 1e9 << " GB/s each";
+  std::lock_guard<std::mutex> lock(rates_mutex_);
+  rates_ = rates;
+}
+
+std::optional<DeviceCostModel::Rates> DeviceCostModel::getRates() const {
+  std::lock_guard<std::mutex> lock(rates_mutex_);
+  return rates_;
+}
+
+DeviceCostModel::InputBytes DeviceCostModel::getInputBytes(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& table_infos,
+    const Catalog_Namespace::Catalog& cat) {
+  std::unordered_map<int, const Fragmenter_Namespace::TableInfo*> table_info_by_id;
+  for (const auto& table_info : table_infos) {
+    table_info_by_id.emplace(table_info.table_id, &table_info.info);
+  }
+
+  auto& data_mgr = cat.getDataMgr();
+  const auto db_id = cat.getCurrentDB().dbId;
+  InputBytes input_bytes;
+  for (const auto& col_desc : ra_exe_unit.input_col_descs) {
+    const auto table_id = col_desc->getScanDesc().getTableId();
+    const auto table_info_it = table_info_by_id.find(table_id);
+    if (table_info_it == table_info_by_id.end()) {
+      continue;
+    }
+    for (const auto& fragment : table_info_it->second->fragments) {
+      if (table_id < 0) {
+        // the results of the former steps are in CPU memory, a slot for each value
+        input_bytes.total += fragment.getNumTuples() * sizeof(int64_t);
+        continue;
+      }
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+      const auto chunk_metadata_it = chunk_metadata_map.find(col_desc->getColId());
+      if (chunk_metadata_it == chunk_metadata_map.end()) {
+        continue;
+      }
+      const auto& chunk_metadata = chunk_metadata_it->second;
+      input_bytes.total += chunk_metadata->numBytes;
+      ChunkKey chunk_key{db_id, table_id, col_desc->getColId(), fragment.fragmentId};
+      if (chunk_metadata->sqlType.is_varlen_indeed()) {
+        chunk_key.push_back(1);
+      }
+      const auto device_id =
+          fragment.deviceIds[static_cast<int>(Data_Namespace::GPU_LEVEL)];
+      if (data_mgr.isBufferOnDevice(chunk_key, Data_Namespace::GPU_LEVEL, device_id)) {
+        input_bytes.gpu_resident += chunk_metadata->numBytes;
+      }
+    }
+  }
+  return input_bytes;
+}
+
+ExecutorDeviceType DeviceCostModel::chooseDeviceType(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& table_infos,
+    const Catalog_Namespace::Catalog& cat) const {
+  const auto rates = getRates();
+  if (!rates || table_infos.empty()) {
+    return ExecutorDeviceType::GPU;
+  }
+  const auto input_bytes = getInputBytes(ra_exe_unit, table_infos, cat);
+
+  // the CPU runs a kernel per outer fragment, the GPU a kernel per device
+  const auto outer_fragment_count = table_infos.front().info.fragments.size();
+  const auto cpu_threads = std::max(
+      std::min(rates->cpu_thread_count, outer_fragment_count), static_cast<size_t>(1));
+  const double cpu_seconds =
+      input_bytes.total / (rates->cpu_scan_bytes_per_sec * cpu_threads);
+  const double gpu_seconds =
+      rates->kernel_launch_sec * rates->gpu_count +
+      (input_bytes.total - input_bytes.gpu_resident) / rates->pcie_bytes_per_sec +
+      (rates->gpu_scan_bytes_per_sec > 0
+           ? input_bytes.total / rates->gpu_scan_bytes_per_sec
+           : 0);
+  VLOG(1) << "Estimated " << cpu_seconds * 1e3 << " ms on CPU and " << gpu_seconds * 1e3
+          << " ms on GPU for the " << input_bytes.total << " input bytes of the step, "
+          << input_bytes.gpu_resident << " of them in the GPU buffer pool";
+  return cpu_seconds < gpu_seconds ? ExecutorDeviceType::CPU : ExecutorDeviceType::GPU;
+}
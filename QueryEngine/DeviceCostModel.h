@@ -0,0 +1,88 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    DeviceCostModel.h
+ * @brief   Cost model of the CPU and the GPU execution of the query steps
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+
+extern bool g_enable_device_cost_model;
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+namespace Data_Namespace {
+class DataMgr;
+}
+
+struct InputTableInfo;
+struct RelAlgExecutionUnit;
+
+/**
+ * Picks the device of the steps of the GPU mode queries from the estimated costs of their
+ * scans. On the GPU a step pays a kernel launch per device, the PCIe transfers of the
+ * input chunks which aren't in the GPU buffer pool yet and the scan at the memory
+ * bandwidth of the devices; on the CPU it pays the scan with as many threads as it has
+ * fragments. The rates come from micro-benchmarks run at startup by calibrate(); until
+ * then every step stays on the GPU.
+ */
+class DeviceCostModel {
+ public:
+  struct Rates {
+    double pcie_bytes_per_sec{0};
+    double kernel_launch_sec{0};
+    double gpu_scan_bytes_per_sec{0};  // over all the devices
+    double cpu_scan_bytes_per_sec{0};  // per thread, with all the threads scanning
+    size_t gpu_count{0};
+    size_t cpu_thread_count{0};
+  };
+
+  struct InputBytes {
+    size_t total{0};
+    size_t gpu_resident{0};  // of the chunks in the GPU buffer pool already
+  };
+
+  static DeviceCostModel& instance();
+
+  //! Measures the rates of the CPU and of the GPUs of data_mgr
+  void calibrate(Data_Namespace::DataMgr& data_mgr);
+
+  std::optional<Rates> getRates() const;
+
+  //! The bytes of the input columns of ra_exe_unit, from the metadata of their fragments
+  static InputBytes getInputBytes(const RelAlgExecutionUnit& ra_exe_unit,
+                                  const std::vector<InputTableInfo>& table_infos,
+                                  const Catalog_Namespace::Catalog& cat);
+
+  //! The device ra_exe_unit is estimated to run faster on
+  ExecutorDeviceType chooseDeviceType(const RelAlgExecutionUnit& ra_exe_unit,
+                                      const std::vector<InputTableInfo>& table_infos,
+                                      const Catalog_Namespace::Catalog& cat) const;
+
+ private:
+  mutable std::mutex rates_mutex_;
+  std::optional<Rates> rates_;
+};
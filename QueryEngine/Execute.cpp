@@ -25,7 +25,9 @@
 #include "EquiJoinCondition.h"
 #include "ErrorHandling.h"
 #include "ExpressionRewrite.h"
+#include "ExecutorResourcePool.h"
 #include "ExternalCacheInvalidators.h"
+#include "FragmentResultCache.h"
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
 #include "JoinHashTable/BaselineJoinHashTable.h"
@@ -33,8 +35,10 @@
 #include "JsonAccessors.h"
 #include "OutputBufferInitialization.h"
 #include "QueryEngine/QueryDispatchQueue.h"
+#include "QueryEngine/QueryProfile.h"
 #include "QueryRewrite.h"
 #include "QueryTemplateGenerator.h"
+#include "ResultSetCache.h"
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 #include "SpeculativeTopN.h"
@@ -43,13 +47,18 @@
 #include "TableFunctions/TableFunctionExecutionContext.h"
 
 #include "CudaMgr/CudaMgr.h"
+#include "DataMgr/Allocators/GpuScratchPool.h"
+#include "DataMgr/Allocators/HostBufferPool.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
 #include "Parser/ParserNode.h"
+#include "Shared/Metrics.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/checked_alloc.h"
+#include "Shared/geo_compression_runtime.h"
 #include "Shared/measure.h"
 #include "Shared/misc.h"
+#include "Shared/numa.h"
 #include "Shared/scope.h"
 #include "Shared/shard_key.h"
 #include "Shared/sql_type_to_string.h"
@@ -59,27 +68,47 @@
 #include "StringDictionaryGenerations.h"
 
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <boost/algorithm/string.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
 #endif  // HAVE_CUDA
+#include <cmath>
+#include <cstring>
 #include <future>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <thread>
 
 bool g_enable_watchdog{false};
 bool g_enable_dynamic_watchdog{false};
 bool g_use_tbb_pool{false};
+bool g_use_work_stealing_pool{false};
 unsigned g_dynamic_watchdog_time_limit{10000};
 bool g_allow_cpu_retry{true};
 bool g_null_div_by_zero{false};
 unsigned g_trivial_loop_join_threshold{1000};
 bool g_from_table_reordering{true};
+bool g_from_table_reordering_filtered_counts{false};
 bool g_inner_join_fragment_skipping{true};
+bool g_enable_concurrent_query_execution{false};
+bool g_enable_cpu_sub_fragment_kernels{false};
+bool g_enable_hybrid_execution{false};
+bool g_enable_gpu_streaming{false};
+bool g_enable_block_zone_maps{true};
+bool g_enable_top_n_fragment_skipping{true};
+bool g_enable_count_from_chunk_metadata{true};
+size_t g_block_zone_map_rows{64 * 1024};
+bool g_enable_query_admission_control{false};
+std::string g_high_priority_users;
+std::string g_low_priority_users;
+bool g_enable_chunk_prefetch{false};
+bool g_enable_deferred_lazy_fetch{false};
+size_t g_cpu_sub_fragment_size{1000000};
 extern bool g_enable_smem_group_by;
 extern std::unique_ptr<llvm::Module> udf_gpu_module;
 extern std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -92,6 +121,13 @@ bool g_enable_overlaps_hashjoin{false};
 bool g_enable_hashjoin_many_to_many{false};
 bool g_cache_string_hash{true};
 size_t g_overlaps_max_table_size_bytes{1024 * 1024 * 1024};
+size_t g_overlaps_auto_tuner_sample_rows{1024 * 1024};
+size_t g_baseline_hash_join_partition_bytes{1024 * 1024};
+size_t g_join_hash_table_cache_bytes{4294967296};  // 4GB
+bool g_enable_parallel_join_hash_table_build{true};
+bool g_enable_join_hash_table_peer_copy{false};
+bool g_enable_partitioned_sharded_joins{false};
+bool g_enable_smem_join_hash_table{false};
 bool g_strip_join_covered_quals{false};
 size_t g_constrained_by_in_threshold{10};
 size_t g_big_group_threshold{20000};
@@ -119,10 +155,16 @@ bool g_enable_smem_grouped_non_count_agg{
 bool g_enable_smem_non_grouped_agg{
     true};  // enable optimizations for using GPU shared memory in implementation of
             // non-grouped aggregates
+bool g_enable_smem_baseline_group_by{
+    false};  // enable block-local baseline hash tables in GPU shared memory for the
+             // group-by operations, which spill to the global memory once full
+size_t g_gpu_streams_per_device{1};
+bool g_enable_group_by_buffer_spill{true};
 bool g_is_test_env{false};  // operating under a unit test environment. Currently only
                             // limits the allocation for the output buffer arena
 
 int const Executor::max_gpu_count;
+size_t const Executor::max_gpu_streams_per_device;
 
 const int32_t Executor::ERR_SINGLE_VALUE_FOUND_MULTIPLE_VALUES;
 
@@ -174,6 +216,10 @@ void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
       mapd_unique_lock<mapd_shared_mutex> flush_lock(
           execute_mutex_);  // Don't flush memory while queries are running
 
+      if (memory_level == Data_Namespace::MemoryLevel::GPU_LEVEL) {
+        // the pooled scratch buffers are still allocated from the GPU buffer pools
+        GpuScratchPool::instance().clear();
+      }
       Catalog_Namespace::SysCatalog::instance().getDataMgr().clearMemory(memory_level);
       if (memory_level == Data_Namespace::MemoryLevel::CPU_LEVEL) {
         // The hash table cache uses CPU memory not managed by the buffer manager. In the
@@ -181,6 +227,9 @@ void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
         // For now, assume the user wants to purge the hash table cache when they clear
         // CPU memory (currently used in ExecuteTest to lower memory pressure)
         JoinHashTableCacheInvalidator::invalidateCaches();
+        ResultSetCache::instance().clear();
+        FragmentResultCache::instance().clear();
+        HostBufferPool::instance().clear();
       }
       break;
     }
@@ -192,6 +241,18 @@ void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
   }
 }
 
+void Executor::compactMemory(const Data_Namespace::MemoryLevel memory_level) {
+  if (memory_level != Data_Namespace::MemoryLevel::CPU_LEVEL &&
+      memory_level != Data_Namespace::MemoryLevel::GPU_LEVEL) {
+    throw std::runtime_error(
+        "Compacting memory levels other than the CPU level or GPU level is not "
+        "supported.");
+  }
+  mapd_unique_lock<mapd_shared_mutex> compact_lock(
+      execute_mutex_);  // Don't move buffers while queries are running
+  Catalog_Namespace::SysCatalog::instance().getDataMgr().compactMemory(memory_level);
+}
+
 size_t Executor::getArenaBlockSize() {
   return g_is_test_env ? 100000000 : (1UL << 32) + kArenaBlockOverhead;
 }
@@ -335,7 +396,11 @@ std::vector<ColumnLazyFetchInfo> Executor::getColLazyFetchInfo(
         }
       } else {
         auto local_col_id = plan_state_->getLocalColumnId(col_var, false);
-        const auto& col_ti = col_var->get_type_info();
+        // the chunks of the outer table are not decoded when fetched
+        const auto& col_ti = cd && cd->columnType.get_compression() == kENCODING_DIFF &&
+                                     plan_state_->isDiffDecodedInCodegen(rte_idx)
+                                 ? cd->columnType
+                                 : col_var->get_type_info();
         col_lazy_fetch_info.emplace_back(ColumnLazyFetchInfo{true, local_col_id, col_ti});
       }
     }
@@ -919,17 +984,12 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
   if (query_mem_desc.getQueryDescriptionType() ==
           QueryDescriptionType::GroupByBaselineHash &&
       results_per_device.size() > 1) {
-    const auto total_entry_count = std::accumulate(
-        results_per_device.begin(),
-        results_per_device.end(),
-        size_t(0),
-        [](const size_t init, const std::pair<ResultSetPtr, std::vector<size_t>>& rs) {
-          const auto& r = rs.first;
-          return init + r->getQueryMemDesc().getEntryCount();
-        });
-    CHECK(total_entry_count);
+    std::vector<const ResultSetStorage*> storages;
+    for (const auto& result : results_per_device) {
+      storages.push_back(result.first->getStorage());
+    }
     auto query_mem_desc = first->getQueryMemDesc();
-    query_mem_desc.setEntryCount(total_entry_count);
+    query_mem_desc.setEntryCount(get_baseline_reduced_entry_count(storages));
     reduced_results = std::make_shared<ResultSet>(first->getTargetInfos(),
                                                   ExecutorDeviceType::CPU,
                                                   query_mem_desc,
@@ -957,10 +1017,11 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
   const auto reduction_code =
       get_reduction_code(results_per_device, &compilation_queue_time);
 
+  std::vector<const ResultSetStorage*> those;
   for (size_t i = 1; i < results_per_device.size(); ++i) {
-    reduced_results->getStorage()->reduce(
-        *(results_per_device[i].first->getStorage()), {}, reduction_code);
+    those.push_back(results_per_device[i].first->getStorage());
   }
+  reduced_results->getStorage()->reduce(those, reduction_code);
   reduced_results->addCompilationQueueTime(compilation_queue_time);
   return reduced_results;
 }
@@ -1165,6 +1226,8 @@ std::string join_type_to_string(const JoinType type) {
       return "INNER";
     case JoinType::LEFT:
       return "LEFT";
+    case JoinType::SEMI:
+      return "SEMI";
     case JoinType::INVALID:
       return "INVALID";
   }
@@ -1305,6 +1368,80 @@ RelAlgExecutionUnit replace_scan_limit(const RelAlgExecutionUnit& ra_exe_unit_in
           ra_exe_unit_in.query_state};
 }
 
+// Hybrid queries run part of their outer fragments in CPU kernels alongside their GPU
+// kernels. They are limited to single table queries, since the join hash tables and the
+// rest of the plan state are built for the devices of one type.
+bool is_hybrid_execution_candidate(const RelAlgExecutionUnit& ra_exe_unit,
+                                   const ExecutorDeviceType device_type,
+                                   const ExecutionOptions& eo,
+                                   const RenderInfo* render_info) {
+  return g_enable_hybrid_execution && device_type == ExecutorDeviceType::GPU &&
+         eo.executor_type == ExecutorType::Native && !eo.just_explain &&
+         !eo.just_validate && !render_info && ra_exe_unit.input_descs.size() == 1 &&
+         ra_exe_unit.join_quals.empty() && !ra_exe_unit.estimator &&
+         !ra_exe_unit.use_bump_allocator &&
+         ra_exe_unit.sort_info.algorithm != SortAlgorithm::StreamingTopN;
+}
+
+// The results of the CPU kernels of a hybrid query are reduced with the ones of its GPU
+// kernels, so both compilations have to lay out their output buffers alike.
+bool hybrid_memory_descriptors_match(const RelAlgExecutionUnit& ra_exe_unit,
+                                     const QueryMemoryDescriptor& cpu_query_mem_desc,
+                                     const QueryMemoryDescriptor& gpu_query_mem_desc) {
+  if (!(cpu_query_mem_desc == gpu_query_mem_desc) ||
+      cpu_query_mem_desc.getEntryCount() != gpu_query_mem_desc.getEntryCount() ||
+      gpu_query_mem_desc.hasInterleavedBinsOnGpu() || gpu_query_mem_desc.sortOnGpu()) {
+    return false;
+  }
+  // the count distinct bitmaps of the devices differ
+  return std::none_of(ra_exe_unit.target_exprs.begin(),
+                      ra_exe_unit.target_exprs.end(),
+                      [](const Analyzer::Expr* target_expr) {
+                        return is_distinct_target(
+                            get_target_info(target_expr, g_bigint_count));
+                      });
+}
+
+// The share of the outer rows of the hybrid queries which goes to their CPU kernels.
+// After each hybrid query it moves halfway to the share with which the CPU and the GPU
+// kernels of the query would have finished together at their measured throughputs.
+std::mutex hybrid_cpu_share_mutex;
+double hybrid_cpu_share{0.1};
+
+constexpr double kMinHybridCpuShare{0.01};
+constexpr double kMaxHybridCpuShare{0.9};
+
+double get_hybrid_cpu_share() {
+  std::lock_guard<std::mutex> lock(hybrid_cpu_share_mutex);
+  return hybrid_cpu_share;
+}
+
+void update_hybrid_cpu_share(SharedKernelContext& shared_context,
+                             const std::chrono::steady_clock::time_point kernels_begin) {
+  const auto get_throughput = [&shared_context, kernels_begin](
+                                  const ExecutorDeviceType device_type) -> double {
+    const auto stats = shared_context.getDeviceKernelStats(device_type);
+    if (!stats.outer_rows || !stats.last_finish_time) {
+      return 0;
+    }
+    const std::chrono::duration<double> elapsed =
+        *stats.last_finish_time - kernels_begin;
+    return elapsed.count() > 0 ? stats.outer_rows / elapsed.count() : 0;
+  };
+  const auto cpu_throughput = get_throughput(ExecutorDeviceType::CPU);
+  const auto gpu_throughput = get_throughput(ExecutorDeviceType::GPU);
+  if (cpu_throughput <= 0 || gpu_throughput <= 0) {
+    return;
+  }
+  const auto balanced_share = cpu_throughput / (cpu_throughput + gpu_throughput);
+  std::lock_guard<std::mutex> lock(hybrid_cpu_share_mutex);
+  hybrid_cpu_share = std::clamp((hybrid_cpu_share + balanced_share) / 2,
+                                kMinHybridCpuShare,
+                                kMaxHybridCpuShare);
+  VLOG(1) << "Hybrid execution throughput: " << cpu_throughput << " CPU rows/s, "
+          << gpu_throughput << " GPU rows/s, CPU share now " << hybrid_cpu_share;
+}
+
 }  // namespace
 
 ResultSetPtr Executor::executeWorkUnit(size_t& max_groups_buffer_entry_guess,
@@ -1393,12 +1530,47 @@ ResultSetPtr Executor::executeWorkUnitImpl(
     max_groups_buffer_entry_guess = compute_buffer_entry_guess(query_infos);
   }
 
+  // the times of the retries of the work unit add up, in microseconds for the sub
+  // millisecond buckets of the phase histograms
+  using std::chrono::microseconds;
+  int64_t compilation_us{0};
+  int64_t kernels_us{0};
+  int64_t reduction_us{0};
+  ScopeGuard add_work_unit_times = [this,
+                                     &eo,
+                                     &compilation_us,
+                                     &kernels_us,
+                                     &reduction_us] {
+    if (eo.just_explain) {
+      return;
+    }
+    static const auto phase_histogram = [](const std::string& phase) -> auto& {
+      return metrics::Registry::instance().histogram("omnisci_query_phase_seconds",
+                                                     "The phases of the work units",
+                                                     metrics::latency_buckets(),
+                                                     {{"phase", phase}});
+    };
+    static auto& compilation_histogram = phase_histogram("compilation");
+    static auto& kernels_histogram = phase_histogram("kernels");
+    static auto& reduction_histogram = phase_histogram("reduction");
+    compilation_histogram.observe(compilation_us / 1e6);
+    kernels_histogram.observe(kernels_us / 1e6);
+    reduction_histogram.observe(reduction_us / 1e6);
+    if (query_profile_) {
+      query_profile_->addWorkUnitTimes(
+          compilation_us / 1000, kernels_us / 1000, reduction_us / 1000);
+    }
+  };
+
   int8_t crt_min_byte_width{get_min_byte_width()};
   do {
     SharedKernelContext shared_context(query_infos);
     ColumnFetcher column_fetcher(this, column_cache);
     auto query_comp_desc_owned = std::make_unique<QueryCompilationDescriptor>();
     std::unique_ptr<QueryMemoryDescriptor> query_mem_desc_owned;
+    // the CPU compilation of the hybrid queries, for the CPU kernels
+    std::unique_ptr<QueryCompilationDescriptor> hybrid_cpu_comp_desc_owned;
+    std::unique_ptr<QueryMemoryDescriptor> hybrid_cpu_mem_desc_owned;
     if (eo.executor_type == ExecutorType::Native) {
       try {
         INJECT_TIMER(query_step_compilation);
@@ -1406,6 +1578,38 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
         compilation_queue_time_ms_ += timer_stop(clock_begin);
 
+        const auto compilation_clock_begin = timer_start();
+        if (is_hybrid_execution_candidate(ra_exe_unit, device_type, eo, render_info) &&
+            !GroupByAndAggregate::shard_count_for_top_groups(ra_exe_unit, cat)) {
+          // compiled ahead of the GPU code, which leaves the plan state to the GPU
+          // kernels
+          try {
+            hybrid_cpu_comp_desc_owned = std::make_unique<QueryCompilationDescriptor>();
+            hybrid_cpu_mem_desc_owned =
+                hybrid_cpu_comp_desc_owned->compile(max_groups_buffer_entry_guess,
+                                                    crt_min_byte_width,
+                                                    has_cardinality_estimation,
+                                                    ra_exe_unit,
+                                                    query_infos,
+                                                    column_fetcher,
+                                                    {ExecutorDeviceType::CPU,
+                                                     co.hoist_literals,
+                                                     co.opt_level,
+                                                     co.with_dynamic_watchdog,
+                                                     co.allow_lazy_fetch,
+                                                     co.filter_on_deleted_column,
+                                                     co.explain_type,
+                                                     co.register_intel_jit_listener},
+                                                    eo,
+                                                    render_info,
+                                                    this);
+          } catch (const std::exception& e) {
+            VLOG(1) << "Running the query on GPU only, its CPU compilation failed: "
+                    << e.what();
+            hybrid_cpu_comp_desc_owned.reset();
+            hybrid_cpu_mem_desc_owned.reset();
+          }
+        }
         query_mem_desc_owned =
             query_comp_desc_owned->compile(max_groups_buffer_entry_guess,
                                            crt_min_byte_width,
@@ -1425,6 +1629,16 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                            render_info,
                                            this);
         CHECK(query_mem_desc_owned);
+        if (hybrid_cpu_mem_desc_owned &&
+            !hybrid_memory_descriptors_match(
+                ra_exe_unit, *hybrid_cpu_mem_desc_owned, *query_mem_desc_owned)) {
+          VLOG(1) << "Running the query on GPU only, its CPU and GPU output buffers "
+                     "differ";
+          hybrid_cpu_comp_desc_owned.reset();
+          hybrid_cpu_mem_desc_owned.reset();
+        }
+        compilation_us += timer_stop<decltype(compilation_clock_begin), microseconds>(
+            compilation_clock_begin);
         crt_min_byte_width = query_comp_desc_owned->getMinByteWidth();
       } catch (CompilationRetryNoCompaction&) {
         crt_min_byte_width = MAX_BYTE_WIDTH_SUPPORTED;
@@ -1452,6 +1666,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
       const auto context_count =
           get_context_count(device_type, available_cpus, available_gpus.size());
       try {
+        const auto kernels_clock_begin = timer_start();
         auto kernels = createKernels(shared_context,
                                      ra_exe_unit,
                                      column_fetcher,
@@ -1462,10 +1677,16 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                                      context_count,
                                      *query_comp_desc_owned,
                                      *query_mem_desc_owned,
+                                     hybrid_cpu_comp_desc_owned.get(),
+                                     hybrid_cpu_mem_desc_owned.get(),
                                      render_info,
                                      available_gpus,
                                      available_cpus);
-        if (g_use_tbb_pool) {
+        if (g_use_work_stealing_pool) {
+          VLOG(1) << "Using work stealing thread pool for kernel dispatch.";
+          launchKernels<threadpool::WorkStealingThreadPool<void>>(shared_context,
+                                                                  std::move(kernels));
+        } else if (g_use_tbb_pool) {
 #ifdef HAVE_TBB
           VLOG(1) << "Using TBB thread pool for kernel dispatch.";
           launchKernels<threadpool::TbbThreadPool<void>>(shared_context,
@@ -1479,6 +1700,11 @@ ResultSetPtr Executor::executeWorkUnitImpl(
           launchKernels<threadpool::FuturesThreadPool<void>>(shared_context,
                                                              std::move(kernels));
         }
+        if (hybrid_cpu_comp_desc_owned) {
+          update_hybrid_cpu_share(shared_context, kernels_clock_begin);
+        }
+        kernels_us +=
+            timer_stop<decltype(kernels_clock_begin), microseconds>(kernels_clock_begin);
       } catch (QueryExecutionError& e) {
         if (eo.with_dynamic_watchdog && interrupted_.load() &&
             e.getErrorCode() == ERR_OUT_OF_TIME) {
@@ -1497,13 +1723,17 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         throw;
       }
     }
+    const auto reduction_clock_begin = timer_start();
     if (is_agg) {
       try {
-        return collectAllDeviceResults(shared_context,
-                                       ra_exe_unit,
-                                       *query_mem_desc_owned,
-                                       query_comp_desc_owned->getDeviceType(),
-                                       row_set_mem_owner);
+        auto results = collectAllDeviceResults(shared_context,
+                                               ra_exe_unit,
+                                               *query_mem_desc_owned,
+                                               query_comp_desc_owned->getDeviceType(),
+                                               row_set_mem_owner);
+        reduction_us += timer_stop<decltype(reduction_clock_begin), microseconds>(
+            reduction_clock_begin);
+        return results;
       } catch (ReductionRanOutOfSlots&) {
         throw QueryExecutionError(ERR_OUT_OF_SLOTS);
       } catch (OverflowOrUnderflow&) {
@@ -1511,7 +1741,10 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         continue;
       }
     }
-    return resultsUnion(shared_context, ra_exe_unit);
+    auto results = resultsUnion(shared_context, ra_exe_unit);
+    reduction_us +=
+        timer_stop<decltype(reduction_clock_begin), microseconds>(reduction_clock_begin);
+    return results;
 
   } while (static_cast<size_t>(crt_min_byte_width) <= sizeof(int64_t));
 
@@ -1676,6 +1909,12 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_buffer));
         continue;
       }
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet) {
+        auto count_distinct_hash_set = new CountDistinctHashSet();
+        row_set_mem_owner->addCountDistinctHashSet(count_distinct_hash_set);
+        entry.push_back(reinterpret_cast<int64_t>(count_distinct_hash_set));
+        continue;
+      }
       if (count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet) {
         auto count_distinct_set = new std::set<int64_t>();
         CHECK(row_set_mem_owner);
@@ -1685,7 +1924,8 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
       }
     }
     const bool float_argument_input = takes_float_argument(agg_info);
-    if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+    if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        agg_info.agg_kind == kAPPROX_QUANTILE) {
       entry.push_back(0);
     } else if (agg_info.agg_kind == kAVG) {
       entry.push_back(inline_null_val(agg_info.sql_type, float_argument_input));
@@ -1742,6 +1982,62 @@ ResultSetPtr build_row_for_empty_input(
   return rs;
 }
 
+// Whether the targets of ra_exe_unit only count the rows of a table or the values of its
+// columns, which the fragments whose rows all qualify have the numbers of from their
+// chunk metadata, see Executor::getCountsFromChunkMetadata()
+bool targets_count_rows(const RelAlgExecutionUnit& ra_exe_unit,
+                        const QueryMemoryDescriptor& query_mem_desc) {
+  if (query_mem_desc.getQueryDescriptionType() !=
+          QueryDescriptionType::NonGroupedAggregate ||
+      ra_exe_unit.input_descs.size() != 1 || !ra_exe_unit.quals.empty() ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.union_all ||
+      ra_exe_unit.estimator || ra_exe_unit.scan_limit) {
+    return false;
+  }
+  const auto& table_desc = ra_exe_unit.input_descs.front();
+  if (table_desc.getSourceType() != InputSourceType::TABLE ||
+      table_desc.getTableId() <= 0) {
+    return false;
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    if (!agg_expr || agg_expr->get_aggtype() != kCOUNT || agg_expr->get_is_distinct()) {
+      return false;
+    }
+    const auto arg = agg_expr->get_arg();
+    if (!arg) {
+      continue;  // COUNT(*)
+    }
+    const auto col = dynamic_cast<const Analyzer::ColumnVar*>(arg);
+    if (!col || col->get_table_id() != table_desc.getTableId() || col->get_rte_idx() ||
+        col->get_type_info().is_varlen() || col->get_type_info().is_geometry()) {
+      return false;
+    }
+  }
+  return !ra_exe_unit.target_exprs.empty();
+}
+
+// The result of a COUNT only kernel over a fragment, from the counts of its targets
+ResultSetPtr build_row_for_fragment_counts(
+    const std::vector<Analyzer::Expr*>& target_exprs,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const std::vector<int64_t>& counts) {
+  std::vector<TargetInfo> target_infos;
+  for (const auto target_expr : target_exprs) {
+    target_infos.push_back(get_target_info(target_expr, g_bigint_count));
+  }
+  const auto executor = query_mem_desc.getExecutor();
+  CHECK(executor);
+  auto rs = std::make_shared<ResultSet>(target_infos,
+                                        ExecutorDeviceType::CPU,
+                                        query_mem_desc,
+                                        executor->getRowSetMemoryOwner(),
+                                        executor);
+  rs->allocateStorage();
+  rs->fillOneEntry(counts);
+  return rs;
+}
+
 }  // namespace
 
 ResultSetPtr Executor::collectAllDeviceResults(
@@ -1752,29 +2048,34 @@ ResultSetPtr Executor::collectAllDeviceResults(
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner) {
   auto timer = DEBUG_TIMER(__func__);
   auto& result_per_device = shared_context.getFragmentResults();
+  ResultSetPtr result;
   if (result_per_device.empty() && query_mem_desc.getQueryDescriptionType() ==
                                        QueryDescriptionType::NonGroupedAggregate) {
-    return build_row_for_empty_input(
-        ra_exe_unit.target_exprs, query_mem_desc, device_type);
-  }
-  if (use_speculative_top_n(ra_exe_unit, query_mem_desc)) {
+    result =
+        build_row_for_empty_input(ra_exe_unit.target_exprs, query_mem_desc, device_type);
+  } else if (use_speculative_top_n(ra_exe_unit, query_mem_desc)) {
     try {
-      return reduceSpeculativeTopN(
+      result = reduceSpeculativeTopN(
           ra_exe_unit, result_per_device, row_set_mem_owner, query_mem_desc);
     } catch (const std::bad_alloc&) {
       throw SpeculativeTopNFailed("Failed during multi-device reduction.");
     }
+  } else {
+    const auto shard_count =
+        device_type == ExecutorDeviceType::GPU
+            ? GroupByAndAggregate::shard_count_for_top_groups(ra_exe_unit, *catalog_)
+            : 0;
+    if (shard_count && !result_per_device.empty()) {
+      result = collectAllDeviceShardedTopResults(shared_context, ra_exe_unit);
+    } else {
+      result = reduceMultiDeviceResults(
+          ra_exe_unit, result_per_device, row_set_mem_owner, query_mem_desc);
+    }
   }
-  const auto shard_count =
-      device_type == ExecutorDeviceType::GPU
-          ? GroupByAndAggregate::shard_count_for_top_groups(ra_exe_unit, *catalog_)
-          : 0;
-
-  if (shard_count && !result_per_device.empty()) {
-    return collectAllDeviceShardedTopResults(shared_context, ra_exe_unit);
+  if (result) {
+    result->finalizeApproxQuantiles();
   }
-  return reduceMultiDeviceResults(
-      ra_exe_unit, result_per_device, row_set_mem_owner, query_mem_desc);
+  return result;
 }
 
 namespace {
@@ -1944,6 +2245,8 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
     const size_t context_count,
     const QueryCompilationDescriptor& query_comp_desc,
     const QueryMemoryDescriptor& query_mem_desc,
+    const QueryCompilationDescriptor* hybrid_cpu_comp_desc,
+    const QueryMemoryDescriptor* hybrid_cpu_mem_desc,
     RenderInfo* render_info,
     std::unordered_set<int>& available_gpus,
     int& available_cpus) {
@@ -1968,17 +2271,38 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
   const auto device_count = deviceCount(device_type);
   CHECK_GT(device_count, 0);
 
+  // Sub-fragment kernels are limited to queries whose per-kernel results get reduced;
+  // projections keep one kernel per fragment to preserve the output row order.
+  const size_t sub_fragment_size =
+      g_enable_cpu_sub_fragment_kernels && device_type == ExecutorDeviceType::CPU &&
+              query_mem_desc.getQueryDescriptionType() != QueryDescriptionType::Projection
+          ? g_cpu_sub_fragment_size
+          : 0;
+
   fragment_descriptor.buildFragmentKernelMap(ra_exe_unit,
                                              shared_context.getFragOffsets(),
                                              device_count,
                                              device_type,
                                              use_multifrag_kernel,
                                              g_inner_join_fragment_skipping,
+                                             sub_fragment_size,
                                              this);
   if (eo.with_watchdog && fragment_descriptor.shouldCheckWorkUnitWatchdog()) {
     checkWorkUnitWatchdog(ra_exe_unit, table_infos, *catalog_, device_type, device_count);
   }
 
+  const bool use_hybrid_kernels = hybrid_cpu_comp_desc && !uses_lazy_fetch;
+  if (use_hybrid_kernels) {
+    CHECK(hybrid_cpu_mem_desc);
+    CHECK(device_type == ExecutorDeviceType::GPU);
+    const auto [gpu_rows, cpu_rows] =
+        fragment_descriptor.splitOffCpuKernels(get_hybrid_cpu_share());
+    VLOG(1) << "Hybrid execution moved " << cpu_rows << " of the "
+            << gpu_rows + cpu_rows << " outer rows to CPU kernels";
+    shared_context.addKernelRows(ExecutorDeviceType::GPU, gpu_rows);
+    shared_context.addKernelRows(ExecutorDeviceType::CPU, cpu_rows);
+  }
+
   if (use_multifrag_kernel) {
     VLOG(1) << "Creating multifrag execution kernels";
     VLOG(1) << query_mem_desc.toString();
@@ -2028,8 +2352,31 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
       }
     }
 
+    // the aggregates over the fragments which didn't change since a former run of the
+    // query are reduced from the cached results of its kernels
+    std::optional<std::string> fragment_result_cache_unit_key;
+    if (g_enable_fragment_result_cache && is_agg &&
+        device_type == ExecutorDeviceType::CPU &&
+        eo.executor_type == ExecutorType::Native && eo.outer_fragment_indices.empty() &&
+        !render_info) {
+      fragment_result_cache_unit_key =
+          FragmentResultCache::getUnitKey(*catalog_, ra_exe_unit, query_mem_desc);
+    }
+
+    // the COUNTs over the fragments whose rows all qualify are taken from their chunk
+    // metadata, without fetching their chunks
+    const bool count_from_chunk_metadata =
+        g_enable_count_from_chunk_metadata && device_type == ExecutorDeviceType::CPU &&
+        eo.executor_type == ExecutorType::Native && !render_info &&
+        targets_count_rows(ra_exe_unit, query_mem_desc);
+
     size_t frag_list_idx{0};
-    auto fragment_per_kernel_dispatch = [&ra_exe_unit,
+    auto fragment_per_kernel_dispatch = [this,
+                                         &shared_context,
+                                         &table_infos,
+                                         &fragment_result_cache_unit_key,
+                                         count_from_chunk_metadata,
+                                         &ra_exe_unit,
                                          &execution_kernels,
                                          &column_fetcher,
                                          &eo,
@@ -2037,14 +2384,57 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                          &device_type,
                                          &query_comp_desc,
                                          &query_mem_desc,
-                                         render_info](const int device_id,
-                                                      const FragmentsList& frag_list,
-                                                      const int64_t rowid_lookup_key) {
+                                         render_info](
+                                            const int device_id,
+                                            const FragmentsList& frag_list,
+                                            const int64_t rowid_lookup_key,
+                                            const std::optional<FragmentRowRange>&
+                                                outer_row_range) {
       if (!frag_list.size()) {
         return;
       }
       CHECK_GE(device_id, 0);
 
+      if (count_from_chunk_metadata && frag_list.size() == 1 &&
+          frag_list.front().fragment_ids.size() == 1) {
+        const auto& outer_tab_frag_ids = frag_list.front().fragment_ids;
+        const auto& fragment = table_infos.front().info.fragments[outer_tab_frag_ids[0]];
+        const auto num_rows = outer_row_range
+                                  ? outer_row_range->second - outer_row_range->first
+                                  : fragment.getNumTuples();
+        if (const auto counts =
+                getCountsFromChunkMetadata(ra_exe_unit, fragment, num_rows)) {
+          VLOG(2) << "Counting the rows of fragment " << fragment.fragmentId
+                  << " from its chunk metadata";
+          if (query_profile_) {
+            query_profile_->addChunkMetadataCount();
+          }
+          shared_context.addDeviceResults(
+              build_row_for_fragment_counts(
+                  ra_exe_unit.target_exprs, query_mem_desc, *counts),
+              outer_tab_frag_ids);
+          return;
+        }
+      }
+
+      std::optional<std::string> fragment_result_cache_key;
+      if (fragment_result_cache_unit_key && frag_list.size() == 1 &&
+          frag_list.front().fragment_ids.size() == 1) {
+        const auto& outer_tab_frag_ids = frag_list.front().fragment_ids;
+        const auto& fragment = table_infos.front().info.fragments[outer_tab_frag_ids[0]];
+        fragment_result_cache_key = FragmentResultCache::getKey(
+            *fragment_result_cache_unit_key, fragment, outer_row_range);
+        if (auto cached_rows = FragmentResultCache::instance().get(
+                *fragment_result_cache_key, fragment, this)) {
+          VLOG(2) << "Reusing the cached result of fragment " << fragment.fragmentId;
+          if (query_profile_) {
+            query_profile_->addFragmentResultCacheHit();
+          }
+          shared_context.addDeviceResults(std::move(cached_rows), outer_tab_frag_ids);
+          return;
+        }
+      }
+
       execution_kernels.emplace_back(
           std::make_unique<ExecutionKernel>(ra_exe_unit,
                                             device_type,
@@ -2056,7 +2446,9 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                             frag_list,
                                             ExecutorDispatchMode::KernelPerFragment,
                                             render_info,
-                                            rowid_lookup_key));
+                                            rowid_lookup_key,
+                                            outer_row_range,
+                                            fragment_result_cache_key));
       ++frag_list_idx;
     };
 
@@ -2064,6 +2456,33 @@ std::vector<std::unique_ptr<ExecutionKernel>> Executor::createKernels(
                                                     ra_exe_unit);
   }
 
+  if (use_hybrid_kernels) {
+    fragment_descriptor.assignFragsToCpuDispatch(
+        [&ra_exe_unit,
+         &execution_kernels,
+         &column_fetcher,
+         &eo,
+         hybrid_cpu_comp_desc,
+         hybrid_cpu_mem_desc](const int device_id,
+                              const FragmentsList& frag_list,
+                              const int64_t rowid_lookup_key,
+                              const std::optional<FragmentRowRange>& outer_row_range) {
+          execution_kernels.emplace_back(
+              std::make_unique<ExecutionKernel>(ra_exe_unit,
+                                                ExecutorDeviceType::CPU,
+                                                device_id,
+                                                eo,
+                                                column_fetcher,
+                                                *hybrid_cpu_comp_desc,
+                                                *hybrid_cpu_mem_desc,
+                                                frag_list,
+                                                ExecutorDispatchMode::KernelPerFragment,
+                                                nullptr,
+                                                rowid_lookup_key,
+                                                outer_row_range));
+        });
+  }
+
   return execution_kernels;
 }
 
@@ -2071,17 +2490,88 @@ template <typename THREAD_POOL>
 void Executor::launchKernels(SharedKernelContext& shared_context,
                              std::vector<std::unique_ptr<ExecutionKernel>>&& kernels) {
   auto clock_begin = timer_start();
-  std::lock_guard<std::mutex> kernel_lock(kernel_mutex_);
+  auto& resource_pool = getResourcePool();
+  ExecutorResourcePool::ResourceRequest resource_request;
+  resource_request.priority = query_priority_;
+  if (g_enable_concurrent_query_execution) {
+    // Only wait for the CPU slots and GPU devices this query actually runs on, so
+    // queries with disjoint resource needs can execute their kernels in parallel.
+    for (const auto& kernel : kernels) {
+      CHECK(kernel);
+      if (kernel->getDeviceType() == ExecutorDeviceType::GPU) {
+        resource_request.gpu_ids.insert(kernel->getDeviceId());
+      } else {
+        ++resource_request.cpu_slots;
+      }
+    }
+  }
+  if (g_enable_query_admission_control) {
+    CHECK(catalog_);
+    if (!resource_pool.hasMemoryBudgets()) {
+      auto& data_mgr = catalog_->getDataMgr();
+      const auto get_pool_size = [](const Data_Namespace::MemoryInfo& mem_info) {
+        return mem_info.maxNumPages * mem_info.pageSize;
+      };
+      const auto cpu_mem_infos = data_mgr.getMemoryInfo(Data_Namespace::CPU_LEVEL);
+      const size_t cpu_budget =
+          cpu_mem_infos.empty() ? size_t(0) : get_pool_size(cpu_mem_infos.front());
+      std::map<int, size_t> gpu_budgets;
+      if (data_mgr.gpusPresent()) {
+        const auto gpu_mem_infos = data_mgr.getMemoryInfo(Data_Namespace::GPU_LEVEL);
+        for (size_t device_id = 0; device_id < gpu_mem_infos.size(); ++device_id) {
+          gpu_budgets[device_id] = get_pool_size(gpu_mem_infos[device_id]);
+        }
+      }
+      resource_pool.setMemoryBudgets(cpu_budget, gpu_budgets);
+    }
+    resource_request.cpu_memory_bytes = estimateKernelMemoryFootprint(
+        shared_context, kernels, resource_request.gpu_memory_bytes);
+    if (resource_pool.exceedsGpuBudget(resource_request) && g_allow_cpu_retry) {
+      // Downgrade before any buffer is allocated, rather than failing with an out of
+      // memory error half way through the kernels.
+      LOG(INFO) << "Estimated GPU memory footprint exceeds the GPU buffer pool size, "
+                   "retrying the query on CPU.";
+      throw QueryMustRunOnCpu();
+    }
+  }
+  std::unique_ptr<ExecutorResourcePool::ResourceHandle> resource_handle;
+  if (g_enable_concurrent_query_execution || g_enable_query_admission_control) {
+    resource_handle = resource_pool.acquire(resource_request);
+  }
+  std::unique_lock<std::mutex> kernel_lock(kernel_mutex_, std::defer_lock);
+  if (!g_enable_concurrent_query_execution) {
+    kernel_lock.lock();
+  }
   kernel_queue_time_ms_ += timer_stop(clock_begin);
 
+  // When the CPU buffer pool places fragments on NUMA nodes, run each CPU kernel on the
+  // node holding its outer fragment so the scan reads local memory.
+  const size_t num_numa_nodes =
+      catalog_ ? catalog_->getDataMgr().getCpuNumaNodeCount() : size_t(1);
+  const auto get_kernel_numa_node = [num_numa_nodes](const ExecutionKernel& kernel) {
+    if (num_numa_nodes < 2 || kernel.getDeviceType() != ExecutorDeviceType::CPU) {
+      return -1;
+    }
+    for (const auto& fragments : kernel.getFragmentsList()) {
+      if (!fragments.fragment_ids.empty()) {
+        return numa::get_node_for_fragment(fragments.fragment_ids.front(),
+                                           num_numa_nodes);
+      }
+    }
+    return -1;
+  };
+
   THREAD_POOL thread_pool;
   VLOG(1) << "Launching " << kernels.size() << " kernels for query.";
   for (auto& kernel : kernels) {
     thread_pool.spawn(
-        [this, &shared_context, parent_thread_id = logger::thread_id()](
-            ExecutionKernel* kernel) {
+        [this,
+         &shared_context,
+         parent_thread_id = logger::thread_id(),
+         numa_node = get_kernel_numa_node(*kernel)](ExecutionKernel* kernel) {
           CHECK(kernel);
           DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+          numa::ScopedNodeAffinity node_affinity(numa_node);
           kernel->run(this, shared_context);
         },
         kernel.get());
@@ -2089,6 +2579,58 @@ void Executor::launchKernels(SharedKernelContext& shared_context,
   thread_pool.join();
 }
 
+size_t Executor::estimateKernelMemoryFootprint(
+    const SharedKernelContext& shared_context,
+    const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+    std::map<int, size_t>& gpu_bytes_per_device) const {
+  const auto& query_infos = shared_context.getQueryInfos();
+  std::unordered_map<int, const TableFragments*> fragments_per_table;
+  for (const auto& query_info : query_infos) {
+    fragments_per_table.emplace(query_info.table_id, &query_info.info.fragments);
+  }
+  std::unordered_map<int, size_t> bytes_per_row_per_table;
+  const auto get_bytes_per_row = [this, &bytes_per_row_per_table](const int table_id) {
+    auto it = bytes_per_row_per_table.find(table_id);
+    if (it == bytes_per_row_per_table.end()) {
+      it = bytes_per_row_per_table
+               .emplace(table_id, getNumBytesForFetchedRow({table_id}))
+               .first;
+    }
+    return it->second;
+  };
+
+  size_t cpu_bytes{0};
+  for (const auto& kernel : kernels) {
+    CHECK(kernel);
+    const auto device_type = kernel->getDeviceType();
+    size_t kernel_bytes =
+        kernel->getQueryMemoryDescriptor().getBufferSizeBytes(device_type);
+    for (const auto& fragments : kernel->getFragmentsList()) {
+      const auto table_fragments_it = fragments_per_table.find(fragments.table_id);
+      if (table_fragments_it == fragments_per_table.end()) {
+        continue;
+      }
+      const auto& table_fragments = *table_fragments_it->second;
+      const auto bytes_per_row = get_bytes_per_row(fragments.table_id);
+      for (const auto frag_id : fragments.fragment_ids) {
+        CHECK_LT(frag_id, table_fragments.size());
+        kernel_bytes += table_fragments[frag_id].getNumTuples() * bytes_per_row;
+      }
+    }
+    if (device_type == ExecutorDeviceType::GPU) {
+      // the kernels of a device run one at a time, and in the GPU streaming mode each
+      // one releases its input chunks for the next, so the device needs the memory of
+      // its largest kernel
+      auto& device_bytes = gpu_bytes_per_device[kernel->getDeviceId()];
+      device_bytes = g_enable_gpu_streaming ? std::max(device_bytes, kernel_bytes)
+                                            : device_bytes + kernel_bytes;
+    } else {
+      cpu_bytes += kernel_bytes;
+    }
+  }
+  return cpu_bytes;
+}
+
 std::vector<size_t> Executor::getTableFragmentIndices(
     const RelAlgExecutionUnit& ra_exe_unit,
     const ExecutorDeviceType device_type,
@@ -2145,9 +2687,13 @@ bool Executor::skipFragmentPair(
   CHECK(table_idx >= 0 &&
         static_cast<size_t>(table_idx) < ra_exe_unit.input_descs.size());
   const int inner_table_id = ra_exe_unit.input_descs[table_idx].getTableId();
-  // Both tables need to be sharded the same way.
+  // Both tables need to be sharded the same way. The kernels of the outer fragments of
+  // a shard run on the device of the shard, and join with all the inner fragments on it.
+  const auto device_count = deviceCount(device_type);
+  CHECK_GT(device_count, 0);
   if (outer_fragment_info.shard == -1 || inner_fragment_info.shard == -1 ||
-      outer_fragment_info.shard == inner_fragment_info.shard) {
+      outer_fragment_info.shard % device_count ==
+          inner_fragment_info.shard % device_count) {
     return false;
   }
   const Analyzer::BinOper* join_condition{nullptr};
@@ -2186,7 +2732,11 @@ bool Executor::skipFragmentPair(
     shard_count = get_shard_count(join_condition, this);
   }
   if (shard_count && !ra_exe_unit.join_quals.empty()) {
-    plan_state_->join_info_.sharded_range_table_indices_.emplace(table_idx);
+    if (one_shard_fragment_per_device(inner_table_id, this)) {
+      plan_state_->join_info_.sharded_range_table_indices_.emplace(table_idx);
+    } else {
+      plan_state_->join_info_.partitioned_table_indices_.emplace(table_idx);
+    }
   }
   return shard_count;
 }
@@ -2225,7 +2775,8 @@ Executor::getRowCountAndOffsetForAllFrags(
     const RelAlgExecutionUnit& ra_exe_unit,
     const CartesianProduct<std::vector<std::vector<size_t>>>& frag_ids_crossjoin,
     const std::vector<InputDescriptor>& input_descs,
-    const std::map<int, const TableFragments*>& all_tables_fragments) {
+    const std::map<int, const TableFragments*>& all_tables_fragments,
+    const FragmentsList& selected_fragments) {
   std::vector<std::vector<int64_t>> all_num_rows;
   std::vector<std::vector<uint64_t>> all_frag_offsets;
   const auto tab_id_to_frag_offsets =
@@ -2247,6 +2798,13 @@ Executor::getRowCountAndOffsetForAllFrags(
           plan_state_->join_info_.sharded_range_table_indices_.count(tab_idx)) {
         const auto& fragment = fragments[frag_id];
         num_rows.push_back(fragment.getNumTuples());
+      } else if (plan_state_->join_info_.partitioned_table_indices_.count(tab_idx)) {
+        CHECK_LT(tab_idx, selected_fragments.size());
+        size_t partition_row_count{0};
+        for (const auto partition_frag_id : selected_fragments[tab_idx].fragment_ids) {
+          partition_row_count += fragments[partition_frag_id].getNumTuples();
+        }
+        num_rows.push_back(partition_row_count);
       } else {
         size_t total_row_count{0};
         for (const auto& fragment : fragments) {
@@ -2268,6 +2826,31 @@ Executor::getRowCountAndOffsetForAllFrags(
   return {all_num_rows, all_frag_offsets};
 }
 
+// The lazily fetched fixed width columns of the projections over a single table, the
+// results fetch them for the fragments of their rows instead of the kernels.
+bool Executor::isDeferrableLazyFetchColumn(const ColumnDescriptor* cd,
+                                           const InputColDescriptor& col_desc,
+                                           const RelAlgExecutionUnit& ra_exe_unit) const {
+  if (!g_enable_deferred_lazy_fetch || !plan_state_->allow_lazy_fetch_ || !cd ||
+      ra_exe_unit.union_all || !ra_exe_unit.join_quals.empty() ||
+      ra_exe_unit.input_descs.size() != 1 ||
+      col_desc.getScanDesc().getSourceType() != InputSourceType::TABLE ||
+      col_desc.getScanDesc().getTableId() <= 0 ||
+      !plan_state_->columns_to_not_fetch_.count(
+          std::make_pair(col_desc.getScanDesc().getTableId(), col_desc.getColId()))) {
+    return false;
+  }
+  const auto& col_ti = cd->columnType;
+  if ((col_ti.is_string() && col_ti.get_compression() == kENCODING_NONE) ||
+      col_ti.is_array() || col_ti.is_geo() ||
+      col_ti.get_compression() == kENCODING_DIFF) {
+    return false;
+  }
+  const auto td = catalog_->getMetadataForTable(col_desc.getScanDesc().getTableId(),
+                                                /*populateFragmenter=*/false);
+  return td && td->storageType != StorageType::FOREIGN_TABLE;
+}
+
 // Only fetch columns of hash-joined inner fact table whose fetch are not deferred from
 // all the table fragments.
 bool Executor::needFetchAllFragments(const InputColDescriptor& inner_col_desc,
@@ -2323,10 +2906,13 @@ FetchResult Executor::fetchChunks(
   std::vector<std::vector<const int8_t*>> all_frag_col_buffers;
   std::vector<std::vector<int64_t>> all_num_rows;
   std::vector<std::vector<uint64_t>> all_frag_offsets;
+  std::vector<std::vector<DeferredColumnChunk>> all_deferred_chunks;
+  bool has_deferred_chunks{false};
 
   for (const auto& selected_frag_ids : frag_ids_crossjoin) {
     std::vector<const int8_t*> frag_col_buffers(
         plan_state_->global_to_local_col_ids_.size());
+    std::vector<DeferredColumnChunk> frag_deferred_chunks;
     for (const auto& col_id : col_global_ids) {
       // check whether the interrupt flag turns on (non kernel-time query interrupt)
       if ((g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) &&
@@ -2354,16 +2940,49 @@ FetchResult Executor::fetchChunks(
       }
       CHECK_LT(frag_id, fragments->size());
       auto memory_level_for_column = memory_level;
-      if (plan_state_->columns_to_fetch_.find(
-              std::make_pair(col_id->getScanDesc().getTableId(), col_id->getColId())) ==
-          plan_state_->columns_to_fetch_.end()) {
+      const bool read_by_kernel =
+          plan_state_->columns_to_fetch_.find(std::make_pair(
+              col_id->getScanDesc().getTableId(), col_id->getColId())) !=
+          plan_state_->columns_to_fetch_.end();
+      if (!read_by_kernel) {
         memory_level_for_column = Data_Namespace::CPU_LEVEL;
       }
+      if (!read_by_kernel && isDeferrableLazyFetchColumn(cd, *col_id, ra_exe_unit) &&
+          !(*fragments)[frag_id].isEmptyPhysicalFragment()) {
+        // only the rows which make it to the results read the column, e.g. past the
+        // filters and the LIMIT of a sort
+        const auto& fragment = (*fragments)[frag_id];
+        const auto chunk_meta_it = fragment.getChunkMetadataMap().find(cd->columnId);
+        CHECK(chunk_meta_it != fragment.getChunkMetadataMap().end());
+        frag_deferred_chunks.push_back(
+            {static_cast<int>(it->second),
+             cd,
+             {cat.getCurrentDB().dbId,
+              fragment.physicalTableId,
+              cd->columnId,
+              fragment.fragmentId},
+             chunk_meta_it->second->numBytes,
+             chunk_meta_it->second->numElements});
+        has_deferred_chunks = true;
+        continue;
+      }
       if (col_id->getScanDesc().getSourceType() == InputSourceType::RESULT) {
         frag_col_buffers[it->second] = column_fetcher.getResultSetColumn(
             col_id.get(), memory_level_for_column, device_id, device_allocator);
       } else {
-        if (needFetchAllFragments(*col_id, ra_exe_unit, selected_fragments)) {
+        const int nest_level = col_id->getScanDesc().getNestLevel();
+        if (plan_state_->join_info_.partitioned_table_indices_.count(nest_level)) {
+          // the inner fragments on the device, in the order the hash table was built
+          CHECK_LT(static_cast<size_t>(nest_level), selected_fragments.size());
+          frag_col_buffers[it->second] = column_fetcher.getTableColumnFragments(
+              table_id,
+              col_id->getColId(),
+              selected_fragments[nest_level].fragment_ids,
+              all_tables_fragments,
+              memory_level_for_column,
+              device_id,
+              device_allocator);
+        } else if (needFetchAllFragments(*col_id, ra_exe_unit, selected_fragments)) {
           frag_col_buffers[it->second] =
               column_fetcher.getAllTableColumnFragments(table_id,
                                                         col_id->getColId(),
@@ -2371,6 +2990,17 @@ FetchResult Executor::fetchChunks(
                                                         memory_level_for_column,
                                                         device_id,
                                                         device_allocator);
+        } else if (cd && cd->columnType.get_compression() == kENCODING_DIFF &&
+                   !plan_state_->isDiffDecodedInCodegen(
+                       col_id->getScanDesc().getNestLevel())) {
+          frag_col_buffers[it->second] =
+              column_fetcher.getDecodedTableColumnFragment(table_id,
+                                                           frag_id,
+                                                           col_id->getColId(),
+                                                           all_tables_fragments,
+                                                           memory_level_for_column,
+                                                           device_id,
+                                                           device_allocator);
         } else {
           frag_col_buffers[it->second] =
               column_fetcher.getOneTableColumnFragment(table_id,
@@ -2386,10 +3016,60 @@ FetchResult Executor::fetchChunks(
       }
     }
     all_frag_col_buffers.push_back(frag_col_buffers);
+    all_deferred_chunks.push_back(std::move(frag_deferred_chunks));
+  }
+  std::tie(all_num_rows, all_frag_offsets) =
+      getRowCountAndOffsetForAllFrags(ra_exe_unit,
+                                      frag_ids_crossjoin,
+                                      ra_exe_unit.input_descs,
+                                      all_tables_fragments,
+                                      selected_fragments);
+  if (!has_deferred_chunks) {
+    all_deferred_chunks.clear();
+  }
+  return {all_frag_col_buffers, all_num_rows, all_frag_offsets, all_deferred_chunks};
+}
+
+void Executor::prefetchChunksToCpu(
+    const ColumnFetcher& column_fetcher,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::map<int, const TableFragments*>& all_tables_fragments,
+    const FragmentsList& selected_fragments,
+    const Catalog_Namespace::Catalog& cat) {
+  auto timer = DEBUG_TIMER(__func__);
+  for (const auto& col_id : ra_exe_unit.input_col_descs) {
+    CHECK(col_id);
+    if (interrupted_.load()) {
+      return;
+    }
+    if (col_id->getScanDesc().getSourceType() == InputSourceType::RESULT) {
+      continue;
+    }
+    const auto cd = try_get_column_descriptor(col_id.get(), cat);
+    if (!cd || cd->isVirtualCol) {
+      continue;
+    }
+    if (needFetchAllFragments(*col_id, ra_exe_unit, selected_fragments)) {
+      continue;
+    }
+    const int table_id = col_id->getScanDesc().getTableId();
+    const auto fragments_it = all_tables_fragments.find(table_id);
+    if (fragments_it == all_tables_fragments.end()) {
+      continue;
+    }
+    for (const auto& fragments_per_table : selected_fragments) {
+      if (fragments_per_table.table_id != table_id) {
+        continue;
+      }
+      for (const auto frag_id : fragments_per_table.fragment_ids) {
+        CHECK_LT(frag_id, fragments_it->second->size());
+        column_fetcher.prefetchTableColumnFragment(table_id,
+                                                   static_cast<int>(frag_id),
+                                                   col_id->getColId(),
+                                                   all_tables_fragments);
+      }
+    }
   }
-  std::tie(all_num_rows, all_frag_offsets) = getRowCountAndOffsetForAllFrags(
-      ra_exe_unit, frag_ids_crossjoin, ra_exe_unit.input_descs, all_tables_fragments);
-  return {all_frag_col_buffers, all_num_rows, all_frag_offsets};
 }
 
 // fetchChunks() is written under the assumption that multiple inputs implies a JOIN.
@@ -2502,6 +3182,17 @@ FetchResult Executor::fetchUnionChunks(
                                                           memory_level_for_column,
                                                           device_id,
                                                           device_allocator);
+          } else if (cd && cd->columnType.get_compression() == kENCODING_DIFF &&
+                     !plan_state_->isDiffDecodedInCodegen(
+                         col_id->getScanDesc().getNestLevel())) {
+            frag_col_buffers[it->second] =
+                column_fetcher.getDecodedTableColumnFragment(table_id,
+                                                             frag_id,
+                                                             col_id->getColId(),
+                                                             all_tables_fragments,
+                                                             memory_level_for_column,
+                                                             device_id,
+                                                             device_allocator);
           } else {
             frag_col_buffers[it->second] =
                 column_fetcher.getOneTableColumnFragment(table_id,
@@ -2520,8 +3211,12 @@ FetchResult Executor::fetchUnionChunks(
     }
     std::vector<std::vector<int64_t>> num_rows;
     std::vector<std::vector<uint64_t>> frag_offsets;
-    std::tie(num_rows, frag_offsets) = getRowCountAndOffsetForAllFrags(
-        ra_exe_unit, frag_ids_crossjoin, ra_exe_unit.input_descs, all_tables_fragments);
+    std::tie(num_rows, frag_offsets) =
+        getRowCountAndOffsetForAllFrags(ra_exe_unit,
+                                        frag_ids_crossjoin,
+                                        ra_exe_unit.input_descs,
+                                        all_tables_fragments,
+                                        selected_fragments);
     all_num_rows.insert(all_num_rows.end(), num_rows.begin(), num_rows.end());
     all_frag_offsets.insert(
         all_frag_offsets.end(), frag_offsets.begin(), frag_offsets.end());
@@ -2772,9 +3467,11 @@ int32_t Executor::executePlanWithoutGroupBy(
       for (int i = 0; i < num_iterations; i++) {
         int64_t val1;
         const bool float_argument_input = takes_float_argument(agg_info);
-        if (is_distinct_target(agg_info)) {
+        if (is_distinct_target(agg_info) || agg_info.agg_kind == kAPPROX_QUANTILE) {
+          // the partial results of the fragments share the set or the t-digest
           CHECK(agg_info.agg_kind == kCOUNT ||
-                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT);
+                agg_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+                agg_info.agg_kind == kAPPROX_QUANTILE);
           val1 = out_vec[out_vec_idx][0];
           error_code = 0;
         } else {
@@ -3037,6 +3734,9 @@ void Executor::nukeOldState(const bool allow_lazy_fetch,
   cgen_state_.reset(new CgenState(query_infos, contains_left_deep_outer_join));
   plan_state_.reset(
       new PlanState(allow_lazy_fetch && !contains_left_deep_outer_join, this));
+  if (ra_exe_unit && ra_exe_unit->union_all) {
+    plan_state_->allow_diff_decode_in_codegen_ = false;
+  }
 }
 
 void Executor::preloadFragOffsets(const std::vector<InputDescriptor>& input_descs,
@@ -3099,6 +3799,40 @@ int8_t Executor::warpSize() const {
   return dev_props.front().warpSize;
 }
 
+size_t Executor::acquireGpuStream(const int device_id) {
+  CHECK_LT(device_id, max_gpu_count);
+  // The dynamic watchdog and the runtime interrupt keep their state in the globals of
+  // the kernel module and track one running module per device, those kernels still run
+  // one at a time.
+  const size_t stream_count =
+      g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt
+          ? 1
+          : std::min(std::max(g_gpu_streams_per_device, size_t(1)),
+                     max_gpu_streams_per_device);
+  std::unique_lock<std::mutex> lock(gpu_exec_mutex_[device_id]);
+  auto& busy_streams = gpu_busy_streams_[device_id];
+  size_t stream_idx{0};
+  gpu_exec_cv_[device_id].wait(lock, [&busy_streams, &stream_idx, stream_count] {
+    for (stream_idx = 0; stream_idx < stream_count; ++stream_idx) {
+      if (!(busy_streams & (1u << stream_idx))) {
+        return true;
+      }
+    }
+    return false;
+  });
+  busy_streams |= 1u << stream_idx;
+  return stream_idx;
+}
+
+void Executor::releaseGpuStream(const int device_id, const size_t stream_idx) {
+  {
+    std::lock_guard<std::mutex> lock(gpu_exec_mutex_[device_id]);
+    CHECK(gpu_busy_streams_[device_id] & (1u << stream_idx));
+    gpu_busy_streams_[device_id] &= ~(1u << stream_idx);
+  }
+  gpu_exec_cv_[device_id].notify_all();
+}
+
 unsigned Executor::gridSize() const {
   CHECK(catalog_);
   const auto cuda_mgr = catalog_->getDataMgr().getCudaMgr();
@@ -3250,6 +3984,296 @@ std::tuple<bool, int64_t, int64_t> get_hpt_overflow_underflow_safe_scaled_values
   return std::make_tuple(true, upscaled_chunk_min, upscaled_chunk_max);
 }
 
+// Whether no value in [min, max] compares with rhs_val as optype requires.
+bool stats_rule_out(const SQLOps optype,
+                    const int64_t min,
+                    const int64_t max,
+                    const int64_t rhs_val) {
+  switch (optype) {
+    case kGE:
+      return max < rhs_val;
+    case kGT:
+      return max <= rhs_val;
+    case kLE:
+      return min > rhs_val;
+    case kLT:
+      return min >= rhs_val;
+    case kEQ:
+      return min > rhs_val || max < rhs_val;
+    default:
+      return false;
+  }
+}
+
+// Whether every value in [min, max] compares with rhs_val as optype requires.
+bool stats_rule_in(const SQLOps optype,
+                   const int64_t min,
+                   const int64_t max,
+                   const int64_t rhs_val) {
+  switch (optype) {
+    case kGE:
+      return min >= rhs_val;
+    case kGT:
+      return min > rhs_val;
+    case kLE:
+      return max <= rhs_val;
+    case kLT:
+      return max < rhs_val;
+    case kEQ:
+      return min == rhs_val && max == rhs_val;
+    default:
+      return false;
+  }
+}
+
+// The value of constant in the units of the Bloom filters of a column of type col_ti,
+// the id of the string for dictionary encoded strings. Empty if no row can be equal to
+// the constant, i.e. it is null or a string missing from the dictionary.
+std::optional<int64_t> get_bloom_filter_value(const Analyzer::Constant* constant,
+                                              const SQLTypeInfo& col_ti,
+                                              const Catalog_Namespace::Catalog& cat,
+                                              Executor* executor) {
+  if (constant->get_is_null()) {
+    return std::nullopt;
+  }
+  const auto& const_ti = constant->get_type_info();
+  if (col_ti.is_dict_encoded_string()) {
+    CHECK(const_ti.is_string());
+    const auto dd = cat.getMetadataForDict(col_ti.get_comp_param(), true);
+    CHECK(dd && dd->stringDict);
+    const auto string_id =
+        dd->stringDict->getIdOfString(*constant->get_constval().stringval);
+    if (string_id < 0) {
+      return std::nullopt;
+    }
+    return string_id;
+  }
+  CodeGenerator code_generator(executor);
+  return code_generator.codegenIntConst(constant)->getSExtValue();
+}
+
+// Whether the Bloom filter of the chunk of col in fragment rules out all of values
+bool bloom_filter_rules_out(const Analyzer::ColumnVar* col,
+                            const Fragmenter_Namespace::FragmentInfo& fragment,
+                            const std::vector<const Analyzer::Constant*>& values,
+                            const Catalog_Namespace::Catalog& cat,
+                            Executor* executor) {
+  const auto& col_ti = col->get_type_info();
+  if (!ChunkBloomFilter::supportsType(col_ti)) {
+    return false;
+  }
+  for (const auto value : values) {
+    const auto& value_ti = value->get_type_info();
+    const bool same_units =
+        col_ti.is_dict_encoded_string()
+            ? value_ti.is_string()
+            : (col_ti.is_integer() && value_ti.is_integer()) ||
+                  (col_ti.get_type() == value_ti.get_type() &&
+                   col_ti.get_dimension() == value_ti.get_dimension());
+    if (!same_units) {
+      return false;
+    }
+  }
+  const auto chunk_meta_it = fragment.getChunkMetadataMap().find(col->get_column_id());
+  if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
+    return false;
+  }
+  const auto bloom_filter = std::atomic_load(&chunk_meta_it->second->bloomFilter);
+  if (!bloom_filter) {
+    return false;
+  }
+  for (const auto value : values) {
+    const auto filter_value = get_bloom_filter_value(value, col_ti, cat, executor);
+    if (filter_value && bloom_filter->mayContain(*filter_value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the widest range of join keys whose values are looked up in the Bloom filters of the
+// outer fragments
+constexpr uint64_t kMaxJoinKeysBloomFilterProbes{1024};
+
+// Whether the PARTITION_COLUMN range of fragment rules out the comparison of col with
+// rhs_const, from the bounds of the partition alone
+bool partition_rules_out(const Analyzer::ColumnVar* col,
+                         const SQLOps optype,
+                         const Analyzer::Constant* rhs_const,
+                         const Fragmenter_Namespace::FragmentInfo& fragment,
+                         Executor* executor) {
+  const auto& partition = fragment.partition;
+  if (!partition || partition->columnId != col->get_column_id() ||
+      rhs_const->get_is_null()) {
+    return false;
+  }
+  const auto& col_ti = col->get_type_info();
+  const auto& rhs_ti = rhs_const->get_type_info();
+  if (col_ti.get_type() != rhs_ti.get_type() ||
+      col_ti.get_dimension() != rhs_ti.get_dimension()) {
+    return false;
+  }
+  if (optype != kEQ && optype != kLT && optype != kLE && optype != kGT &&
+      optype != kGE) {
+    return false;
+  }
+  if (partition->isNull()) {
+    // no row compares with a non null constant
+    return true;
+  }
+  CodeGenerator code_generator(executor);
+  const auto rhs_val = code_generator.codegenIntConst(rhs_const)->getSExtValue();
+  return stats_rule_out(optype, partition->firstValue, partition->lastValue, rhs_val);
+}
+
+// The box the points of point_col must be in for a qual to pass.
+struct PointFilterBox {
+  const Analyzer::ColumnVar* point_col;
+  double x_min;
+  double y_min;
+  double x_max;
+  double y_max;
+};
+
+std::optional<int32_t> get_int_geo_arg(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null() ||
+      constant->get_type_info().get_type() != kINT) {
+    return std::nullopt;
+  }
+  return constant->get_constval().intval;
+}
+
+// The coordinates of a constant point, given as its coords compressed as compression
+// says.
+std::optional<std::pair<double, double>> get_constant_point(const Analyzer::Expr* expr,
+                                                            const int32_t compression) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null() ||
+      !constant->get_type_info().is_fixlen_array() ||
+      constant->get_type_info().get_subtype() != kTINYINT) {
+    return std::nullopt;
+  }
+  std::vector<int8_t> coords;
+  for (const auto& value : constant->get_value_list()) {
+    const auto byte = dynamic_cast<const Analyzer::Constant*>(value.get());
+    if (!byte) {
+      return std::nullopt;
+    }
+    coords.push_back(byte->get_constval().tinyintval);
+  }
+  if (compression == COMPRESSION_GEOINT32 && coords.size() == 2 * sizeof(int32_t)) {
+    int32_t compressed[2];
+    std::memcpy(compressed, coords.data(), sizeof(compressed));
+    return std::make_pair(
+        Geo_namespace::decompress_longitude_coord_geoint32(compressed[0]),
+        Geo_namespace::decompress_lattitude_coord_geoint32(compressed[1]));
+  }
+  if (compression == COMPRESSION_NONE && coords.size() == 2 * sizeof(double)) {
+    double uncompressed[2];
+    std::memcpy(uncompressed, coords.data(), sizeof(uncompressed));
+    return std::make_pair(uncompressed[0], uncompressed[1]);
+  }
+  return std::nullopt;
+}
+
+// The box of the points within the distance of the constant point of a cartesian
+// `ST_Distance(pt, p) < d` or ST_DWithin filter, or within the bounds of the constant
+// polygon of ST_Contains or ST_Intersects, for the POINT column pt of the table. Points
+// transformed to another SRID are left alone.
+std::optional<PointFilterBox> get_point_filter_box(const Analyzer::Expr* qual,
+                                                   const int table_id) {
+  const auto is_table_point = [table_id](const Analyzer::Expr* expr) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr);
+    return col_var && col_var->get_table_id() == table_id && !col_var->get_rte_idx() &&
+           col_var->get_type_info().get_type() == kPOINT;
+  };
+  // the compressions and input SRIDs of both geo arguments, then the output SRID
+  const auto untransformed_geo_args = [](const Analyzer::FunctionOper* func) {
+    const auto arity = func->getArity();
+    const auto input_srid0 = get_int_geo_arg(func->getArg(arity - 4));
+    const auto input_srid1 = get_int_geo_arg(func->getArg(arity - 2));
+    const auto output_srid = get_int_geo_arg(func->getArg(arity - 1));
+    return input_srid0 && input_srid1 && output_srid && *input_srid0 == *output_srid &&
+           *input_srid1 == *output_srid;
+  };
+  const auto func = dynamic_cast<const Analyzer::FunctionOper*>(qual);
+  if (func && func->getArity() >= 7 &&
+      (func->getName() == "ST_Contains_Polygon_Point" ||
+       func->getName() == "ST_Contains_MultiPolygon_Point" ||
+       func->getName() == "ST_Intersects_Polygon_Point" ||
+       func->getName() == "ST_Intersects_MultiPolygon_Point")) {
+    const auto arity = func->getArity();
+    const auto point_arg = func->getArg(arity - 6);
+    const auto bounds = dynamic_cast<const Analyzer::Constant*>(func->getArg(arity - 7));
+    if (!is_table_point(point_arg) || !bounds || bounds->get_is_null() ||
+        !bounds->get_type_info().is_array() ||
+        bounds->get_type_info().get_subtype() != kDOUBLE ||
+        bounds->get_value_list().size() != 4 || !untransformed_geo_args(func)) {
+      return std::nullopt;
+    }
+    std::vector<double> box;
+    for (const auto& value : bounds->get_value_list()) {
+      const auto bound = dynamic_cast<const Analyzer::Constant*>(value.get());
+      if (!bound) {
+        return std::nullopt;
+      }
+      box.push_back(bound->get_constval().doubleval);
+    }
+    return PointFilterBox{dynamic_cast<const Analyzer::ColumnVar*>(point_arg),
+                          box[0],
+                          box[1],
+                          box[2],
+                          box[3]};
+  }
+  const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual);
+  if (!bin_oper) {
+    return std::nullopt;
+  }
+  const auto optype = bin_oper->get_optype();
+  auto distance_func =
+      dynamic_cast<const Analyzer::FunctionOper*>(bin_oper->get_left_operand());
+  auto distance = dynamic_cast<const Analyzer::Constant*>(bin_oper->get_right_operand());
+  bool bounds_distance = optype == kLT || optype == kLE;
+  if (!distance_func) {
+    distance_func =
+        dynamic_cast<const Analyzer::FunctionOper*>(bin_oper->get_right_operand());
+    distance = dynamic_cast<const Analyzer::Constant*>(bin_oper->get_left_operand());
+    bounds_distance = optype == kGT || optype == kGE;
+  }
+  if (!bounds_distance || !distance_func || !distance || distance->get_is_null() ||
+      distance->get_type_info().get_type() != kDOUBLE ||
+      distance_func->getArity() != 7 || !untransformed_geo_args(distance_func)) {
+    return std::nullopt;
+  }
+  const bool squared = distance_func->getName() == "ST_Distance_Point_Point_Squared";
+  if (!squared && distance_func->getName() != "ST_Distance_Point_Point") {
+    return std::nullopt;
+  }
+  const auto compression0 = get_int_geo_arg(distance_func->getArg(2));
+  const auto compression1 = get_int_geo_arg(distance_func->getArg(4));
+  if (!compression0 || !compression1) {
+    return std::nullopt;
+  }
+  const bool point_first = is_table_point(distance_func->getArg(0));
+  if (!point_first && !is_table_point(distance_func->getArg(1))) {
+    return std::nullopt;
+  }
+  const auto center = get_constant_point(distance_func->getArg(point_first ? 1 : 0),
+                                         point_first ? *compression1 : *compression0);
+  const auto max_distance = distance->get_constval().doubleval;
+  if (!center || max_distance < 0) {
+    return std::nullopt;
+  }
+  const auto radius = squared ? std::sqrt(max_distance) : max_distance;
+  const auto point_arg = distance_func->getArg(point_first ? 0 : 1);
+  return PointFilterBox{dynamic_cast<const Analyzer::ColumnVar*>(point_arg),
+                        center->first - radius,
+                        center->second - radius,
+                        center->first + radius,
+                        center->second + radius};
+}
+
 }  // namespace
 
 std::pair<bool, int64_t> Executor::skipFragment(
@@ -3288,6 +4312,16 @@ std::pair<bool, int64_t> Executor::skipFragment(
       // is this possible?
       return {false, -1};
     }
+    // before any chunk metadata of the fragment is looked at
+    if (lhs == lhs_col &&
+        partition_rules_out(
+            lhs_col, comp_expr->get_optype(), rhs_const, fragment, this)) {
+      return {true, -1};
+    }
+    if (comp_expr->get_optype() == kEQ && lhs == lhs_col &&
+        bloom_filter_rules_out(lhs_col, fragment, {rhs_const}, *catalog_, this)) {
+      return {true, -1};
+    }
     if (!lhs->get_type_info().is_integer() && !lhs->get_type_info().is_time()) {
       continue;
     }
@@ -3343,39 +4377,353 @@ std::pair<bool, int64_t> Executor::skipFragment(
     CodeGenerator code_generator(this);
     const auto rhs_val = code_generator.codegenIntConst(rhs_const)->getSExtValue();
 
-    switch (comp_expr->get_optype()) {
-      case kGE:
-        if (chunk_max < rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kGT:
-        if (chunk_max <= rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kLE:
-        if (chunk_min > rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kLT:
-        if (chunk_min >= rhs_val) {
-          return {true, -1};
-        }
+    if (stats_rule_out(comp_expr->get_optype(), chunk_min, chunk_max, rhs_val)) {
+      return {true, -1};
+    }
+    if (comp_expr->get_optype() == kEQ && is_rowid) {
+      return {false, rhs_val - start_rowid};
+    }
+  }
+  return {false, -1};
+}
+
+bool Executor::skipFragmentInValues(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& quals) {
+  for (const auto& qual : quals) {
+    const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual.get());
+    if (!in_values) {
+      continue;
+    }
+    const auto col = dynamic_cast<const Analyzer::ColumnVar*>(in_values->get_arg());
+    if (!col || col->get_table_id() != table_desc.getTableId() || col->get_rte_idx()) {
+      continue;
+    }
+    std::vector<const Analyzer::Constant*> values;
+    for (const auto& value_expr : in_values->get_value_list()) {
+      const auto value = dynamic_cast<const Analyzer::Constant*>(value_expr.get());
+      if (!value) {
         break;
-      case kEQ:
-        if (chunk_min > rhs_val || chunk_max < rhs_val) {
-          return {true, -1};
-        } else if (is_rowid) {
-          return {false, rhs_val - start_rowid};
+      }
+      values.push_back(value);
+    }
+    if (values.size() == in_values->get_value_list().size() &&
+        bloom_filter_rules_out(col, fragment, values, *catalog_, this)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Executor::skipFragmentJoinKeys(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals) {
+  if (!plan_state_) {
+    return false;
+  }
+  for (const auto& hash_table : plan_state_->join_info_.join_hash_tables_) {
+    const auto perfect_hash_table = dynamic_cast<const JoinHashTable*>(hash_table.get());
+    if (!perfect_hash_table) {
+      continue;
+    }
+    const auto qual = perfect_hash_table->getQual();
+    if (qual->get_optype() != kEQ ||
+        std::none_of(join_quals.begin(), join_quals.end(), [qual](const auto& join_qual) {
+          return *join_qual == *qual;
+        })) {
+      continue;
+    }
+    const auto& key_range = perfect_hash_table->getKeyRange();
+    const auto lhs_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(qual->get_left_operand());
+    const auto rhs_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(qual->get_right_operand());
+    if (!lhs_col || !rhs_col || key_range.getType() != ExpressionRangeType::Integer) {
+      continue;
+    }
+    const auto outer_col = lhs_col->get_rte_idx() ? rhs_col : lhs_col;
+    const auto inner_col = lhs_col->get_rte_idx() ? lhs_col : rhs_col;
+    const auto& col_ti = outer_col->get_type_info();
+    // the keys are in the units of the outer column
+    if (outer_col->get_table_id() != table_desc.getTableId() ||
+        outer_col->get_rte_idx() || !inner_col->get_rte_idx() || !col_ti.is_integer() ||
+        col_ti.get_type() != inner_col->get_type_info().get_type()) {
+      continue;
+    }
+    const auto chunk_meta_it =
+        fragment.getChunkMetadataMap().find(outer_col->get_column_id());
+    if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
+      continue;
+    }
+    // nulls match no key of an inner join on equality
+    const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+    const auto first_value =
+        std::max(key_range.getIntMin(), extract_min_stat(chunk_stats, col_ti));
+    const auto last_value =
+        std::min(key_range.getIntMax(), extract_max_stat(chunk_stats, col_ti));
+    if (first_value > last_value) {
+      return true;
+    }
+    const auto bloom_filter = std::atomic_load(&chunk_meta_it->second->bloomFilter);
+    const auto last_offset = static_cast<uint64_t>(last_value) - first_value;
+    if (!bloom_filter || last_offset >= kMaxJoinKeysBloomFilterProbes) {
+      continue;
+    }
+    bool may_match{false};
+    for (uint64_t offset = 0; offset <= last_offset && !may_match; ++offset) {
+      may_match = bloom_filter->mayContain(first_value + static_cast<int64_t>(offset));
+    }
+    if (!may_match) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Executor::allFragmentRowsQualify(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals) {
+  const int table_id = table_desc.getTableId();
+  if (simple_quals.empty() || fragment.getNumTuples() == 0) {
+    return false;
+  }
+  for (const auto& simple_qual : simple_quals) {
+    const auto comp_expr =
+        std::dynamic_pointer_cast<const Analyzer::BinOper>(simple_qual);
+    if (!comp_expr) {
+      return false;
+    }
+    // a cast of the column could change the order of its values
+    const auto lhs_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(comp_expr->get_left_operand());
+    const auto rhs_const =
+        dynamic_cast<const Analyzer::Constant*>(comp_expr->get_right_operand());
+    if (!lhs_col || lhs_col->get_table_id() != table_id || lhs_col->get_rte_idx() ||
+        !rhs_const || rhs_const->get_is_null()) {
+      return false;
+    }
+    const auto& col_ti = lhs_col->get_type_info();
+    if ((!col_ti.is_integer() && !col_ti.is_time()) ||
+        (col_ti.is_timestamp() &&
+         col_ti.get_dimension() != rhs_const->get_type_info().get_dimension())) {
+      return false;
+    }
+    const auto chunk_meta_it =
+        fragment.getChunkMetadataMapPhysical().find(lhs_col->get_column_id());
+    if (chunk_meta_it == fragment.getChunkMetadataMapPhysical().end()) {
+      return false;  // e.g. rowid
+    }
+    // a null satisfies no comparison
+    const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+    if (chunk_stats.has_nulls) {
+      return false;
+    }
+    const auto chunk_min = extract_min_stat(chunk_stats, col_ti);
+    const auto chunk_max = extract_max_stat(chunk_stats, col_ti);
+    CodeGenerator code_generator(this);
+    const auto rhs_val = code_generator.codegenIntConst(rhs_const)->getSExtValue();
+    if (chunk_min > chunk_max ||
+        !stats_rule_in(comp_expr->get_optype(), chunk_min, chunk_max, rhs_val)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<std::vector<int64_t>> Executor::getCountsFromChunkMetadata(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const size_t num_rows) {
+  const auto& table_desc = ra_exe_unit.input_descs.front();
+  if (!ra_exe_unit.simple_quals.empty() &&
+      !allFragmentRowsQualify(table_desc, fragment, ra_exe_unit.simple_quals)) {
+    return std::nullopt;
+  }
+  const auto td = catalog_->getMetadataForTable(table_desc.getTableId());
+  CHECK(td);
+  if (td->storageType == StorageType::FOREIGN_TABLE) {
+    return std::nullopt;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+  if (td->hasDeletedCol) {
+    // the stats of the deleted column only grow, a false max means no row was deleted
+    const auto deleted_cd = catalog_->getDeletedColumn(td);
+    CHECK(deleted_cd);
+    const auto chunk_meta_it = chunk_metadata_map.find(deleted_cd->columnId);
+    if (chunk_meta_it == chunk_metadata_map.end() ||
+        extract_max_stat(chunk_meta_it->second->chunkStats, deleted_cd->columnType)) {
+      return std::nullopt;
+    }
+  }
+  std::vector<int64_t> counts;
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+    CHECK(agg_expr);
+    if (const auto col = dynamic_cast<const Analyzer::ColumnVar*>(agg_expr->get_arg())) {
+      const auto chunk_meta_it = chunk_metadata_map.find(col->get_column_id());
+      if (chunk_meta_it == chunk_metadata_map.end() ||
+          chunk_meta_it->second->chunkStats.has_nulls) {
+        return std::nullopt;
+      }
+    }
+    counts.push_back(num_rows);
+  }
+  return counts;
+}
+
+FragmentRowRange Executor::getQualifyingRowRange(
+    const InputDescriptor& table_desc,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& quals,
+    const FragmentRowRange& row_range) {
+  const auto rows_per_block = g_block_zone_map_rows;
+  const int table_id = table_desc.getTableId();
+  if (table_id <= 0 || !rows_per_block || row_range.first >= row_range.second) {
+    return row_range;
+  }
+  const auto first_block = row_range.first / rows_per_block;
+  const auto end_block = (row_range.second + rows_per_block - 1) / rows_per_block;
+  std::vector<bool> qualifying_blocks(end_block - first_block, true);
+  bool ruled_out_blocks{false};
+  // rows found by binary search in the chunks that are sorted
+  auto sorted_row_range = row_range;
+  for (const auto& qual : quals) {
+    if (const auto point_box = get_point_filter_box(qual.get(), table_id)) {
+      // the coords column follows its POINT column
+      const int coords_col_id = point_box->point_col->get_column_id() + 1;
+      const auto chunk_meta_it =
+          fragment.getChunkMetadataMapPhysical().find(coords_col_id);
+      if (chunk_meta_it == fragment.getChunkMetadataMapPhysical().end()) {
+        continue;
+      }
+      const auto cd = get_column_descriptor(coords_col_id, table_id, *catalog_);
+      const ChunkKey chunk_key{
+          catalog_->getCurrentDB().dbId, table_id, coords_col_id, fragment.fragmentId};
+      const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                   &catalog_->getDataMgr(),
+                                                   chunk_key,
+                                                   Data_Namespace::CPU_LEVEL,
+                                                   0,
+                                                   chunk_meta_it->second->numBytes,
+                                                   chunk_meta_it->second->numElements);
+      const auto block_bounds =
+          chunk->getBlockBounds(chunk_meta_it->second, rows_per_block);
+      if (!block_bounds) {
+        continue;
+      }
+      // the filters compare the same decompressed coordinates, the tolerance only covers
+      // the bounds of the polygons, computed before their coords were compressed
+      const auto tolerance =
+          TOLERANCE_GEOINT32 * (1 + std::max({std::abs(point_box->x_min),
+                                              std::abs(point_box->y_min),
+                                              std::abs(point_box->x_max),
+                                              std::abs(point_box->y_max)}));
+      const auto num_blocks = std::min(end_block, block_bounds->xMin.size());
+      for (auto block = first_block; block < num_blocks; ++block) {
+        if (block_bounds->xMin[block] > point_box->x_max + tolerance ||
+            block_bounds->xMax[block] < point_box->x_min - tolerance ||
+            block_bounds->yMin[block] > point_box->y_max + tolerance ||
+            block_bounds->yMax[block] < point_box->y_min - tolerance) {
+          qualifying_blocks[block - first_block] = false;
+          ruled_out_blocks = true;
         }
-        break;
-      default:
-        break;
+      }
+      continue;
+    }
+    const auto comp_expr = std::dynamic_pointer_cast<const Analyzer::BinOper>(qual);
+    if (!comp_expr) {
+      continue;
+    }
+    const auto lhs = comp_expr->get_left_operand();
+    auto lhs_col = dynamic_cast<const Analyzer::ColumnVar*>(lhs);
+    if (!lhs_col) {
+      // a simple cast allowed through normalize_simple_predicate, as in skipFragment()
+      const auto lhs_uexpr = dynamic_cast<const Analyzer::UOper*>(lhs);
+      if (lhs_uexpr && lhs_uexpr->get_optype() == kCAST) {
+        lhs_col = dynamic_cast<const Analyzer::ColumnVar*>(lhs_uexpr->get_operand());
+      }
+    }
+    const auto rhs_const =
+        dynamic_cast<const Analyzer::Constant*>(comp_expr->get_right_operand());
+    if (!lhs_col || lhs_col->get_table_id() != table_id || lhs_col->get_rte_idx() ||
+        !rhs_const || rhs_const->get_is_null()) {
+      continue;
+    }
+    if (!lhs->get_type_info().is_integer() && !lhs->get_type_info().is_time()) {
+      continue;
+    }
+    if (lhs->get_type_info().is_timestamp() &&
+        lhs_col->get_type_info().get_dimension() !=
+            rhs_const->get_type_info().get_dimension()) {
+      continue;
+    }
+    const int col_id = lhs_col->get_column_id();
+    const auto chunk_meta_it = fragment.getChunkMetadataMapPhysical().find(col_id);
+    if (chunk_meta_it == fragment.getChunkMetadataMapPhysical().end()) {
+      continue;
+    }
+    const auto cd = get_column_descriptor(col_id, table_id, *catalog_);
+    if (cd->isVirtualCol) {
+      continue;
+    }
+    const ChunkKey chunk_key{
+        catalog_->getCurrentDB().dbId, table_id, col_id, fragment.fragmentId};
+    const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                 &catalog_->getDataMgr(),
+                                                 chunk_key,
+                                                 Data_Namespace::CPU_LEVEL,
+                                                 0,
+                                                 chunk_meta_it->second->numBytes,
+                                                 chunk_meta_it->second->numElements);
+    const auto block_stats = chunk->getBlockStats(chunk_meta_it->second, rows_per_block);
+    if (!block_stats) {
+      continue;
+    }
+    CodeGenerator code_generator(this);
+    const auto rhs_val = code_generator.codegenIntConst(rhs_const)->getSExtValue();
+    if (block_stats->sorted) {
+      const auto rows = chunk->getSortedRowRange(
+          block_stats->numElements, comp_expr->get_optype(), rhs_val);
+      sorted_row_range.first = std::max(sorted_row_range.first, rows.first);
+      sorted_row_range.second = std::min(sorted_row_range.second, rows.second);
+    }
+    const auto num_blocks = std::min(end_block, block_stats->min.size());
+    for (auto block = first_block; block < num_blocks; ++block) {
+      if (stats_rule_out(comp_expr->get_optype(),
+                         block_stats->min[block],
+                         block_stats->max[block],
+                         rhs_val)) {
+        qualifying_blocks[block - first_block] = false;
+        ruled_out_blocks = true;
+      }
     }
   }
-  return {false, -1};
+  if (sorted_row_range.first >= sorted_row_range.second) {
+    return {row_range.first, row_range.first};
+  }
+  if (!ruled_out_blocks) {
+    return sorted_row_range;
+  }
+  const auto first_it =
+      std::find(qualifying_blocks.begin(), qualifying_blocks.end(), true);
+  if (first_it == qualifying_blocks.end()) {
+    return {row_range.first, row_range.first};
+  }
+  const auto last_it =
+      std::find(qualifying_blocks.rbegin(), qualifying_blocks.rend(), true);
+  const auto begin_block = first_block + (first_it - qualifying_blocks.begin());
+  const auto last_block = first_block + (qualifying_blocks.rend() - last_it) - 1;
+  const auto first_row =
+      std::max(sorted_row_range.first, begin_block * rows_per_block);
+  const auto end_row =
+      std::min(sorted_row_range.second, (last_block + 1) * rows_per_block);
+  if (first_row >= end_row) {
+    return {row_range.first, row_range.first};
+  }
+  return {first_row, end_row};
 }
 
 /*
@@ -3429,7 +4777,8 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
       skip_frag.second = temp_skip_frag.second;
       return skip_frag;
     } else {
-      skip_frag.first = skip_frag.first || temp_skip_frag.first;
+      skip_frag.first = skip_frag.first || temp_skip_frag.first ||
+                        skipFragmentJoinKeys(table_desc, fragment, inner_join.quals);
     }
   }
   return skip_frag;
@@ -3562,6 +4911,11 @@ bool Executor::checkIsQuerySessionInterrupted(
   return flag_it != queries_interrupt_flag_.end() && flag_it->second;
 }
 
+bool Executor::isInterrupted() {
+  return (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) &&
+         interrupted_.load();
+}
+
 void Executor::enableRuntimeQueryInterrupt(const unsigned interrupt_freq) const {
   // The only one scenario that we intentionally call this function is
   // to allow runtime query interrupt in QueryRunner for test cases.
@@ -3608,5 +4962,29 @@ std::atomic<bool> Executor::interrupted_{false};
 std::mutex Executor::compilation_mutex_;
 std::mutex Executor::kernel_mutex_;
 
+ExecutorResourcePool& Executor::getResourcePool() {
+  static ExecutorResourcePool resource_pool(cpu_threads());
+  return resource_pool;
+}
+
+QueryPriority get_query_priority(const std::string& user_name) {
+  const auto is_listed = [&user_name](const std::string& user_names) {
+    std::vector<std::string> listed_users;
+    boost::split(listed_users, user_names, boost::is_any_of(","));
+    return std::any_of(
+        listed_users.begin(), listed_users.end(), [&user_name](auto& listed_user) {
+          boost::trim(listed_user);
+          return listed_user == user_name;
+        });
+  };
+  if (!user_name.empty() && is_listed(g_high_priority_users)) {
+    return QueryPriority::HIGH;
+  }
+  if (!user_name.empty() && is_listed(g_low_priority_users)) {
+    return QueryPriority::LOW;
+  }
+  return QueryPriority::NORMAL;
+}
+
 mapd_shared_mutex Executor::recycler_mutex_;
 std::unordered_map<std::string, size_t> Executor::cardinality_cache_;
@@ -31,6 +31,7 @@
 #include "LoopControlFlow/JoinLoop.h"
 #include "NvidiaKernel.h"
 #include "PlanState.h"
+#include "QueryPriority.h"
 #include "RelAlgExecutionUnit.h"
 #include "RelAlgTranslator.h"
 #include "StringDictionaryGenerations.h"
@@ -64,6 +65,7 @@
 #include <cstdlib>
 #include <deque>
 #include <functional>
+#include <future>
 #include <limits>
 #include <map>
 #include <mutex>
@@ -84,6 +86,8 @@ extern void read_rt_udf_cpu_module(const std::string& udf_ir);
 extern bool is_rt_udf_module_present(bool cpu_only = false);
 
 class ColumnFetcher;
+class ExecutorResourcePool;
+class QueryProfile;
 
 class WatchdogException : public std::runtime_error {
  public:
@@ -323,6 +327,7 @@ class Executor {
   }
 
   static void clearMemory(const Data_Namespace::MemoryLevel memory_level);
+  static void compactMemory(const Data_Namespace::MemoryLevel memory_level);
 
   static size_t getArenaBlockSize();
 
@@ -367,6 +372,9 @@ class Executor {
   void interrupt(const std::string& query_session = "",
                  const std::string& interrupt_session = "");
   void resetInterrupt();
+  // Whether the running query was interrupted, checked between the chunk fetches, the
+  // reductions, the sorts and the steps, outside of the kernels
+  static bool isInterrupted();
 
   // only for testing usage
   void enableRuntimeQueryInterrupt(const unsigned interrupt_freq) const;
@@ -374,6 +382,11 @@ class Executor {
   static const size_t high_scan_limit{32000000};
 
   int8_t warpSize() const;
+  // Waits for a free stream slot of device_id and takes it. The kernels of the executor
+  // which hold the other slots of the device run concurrently on their own streams.
+  // Slot 0 is the default stream.
+  size_t acquireGpuStream(const int device_id);
+  void releaseGpuStream(const int device_id, const size_t stream_idx);
   unsigned gridSize() const;
   unsigned numBlocksPerMP() const;
   unsigned blockSize() const;
@@ -449,6 +462,10 @@ class Executor {
                              const RelAlgExecutionUnit& ra_exe_unit,
                              const FragmentsList& selected_fragments) const;
 
+  bool isDeferrableLazyFetchColumn(const ColumnDescriptor* cd,
+                                   const InputColDescriptor& col_desc,
+                                   const RelAlgExecutionUnit& ra_exe_unit) const;
+
   using PerFragmentCallBack =
       std::function<void(ResultSetPtr, const Fragmenter_Namespace::FragmentInfo&)>;
 
@@ -509,6 +526,8 @@ class Executor {
       const size_t context_count,
       const QueryCompilationDescriptor& query_comp_desc,
       const QueryMemoryDescriptor& query_mem_desc,
+      const QueryCompilationDescriptor* hybrid_cpu_comp_desc,
+      const QueryMemoryDescriptor* hybrid_cpu_mem_desc,
       RenderInfo* render_info,
       std::unordered_set<int>& available_gpus,
       int& available_cpus);
@@ -521,6 +540,15 @@ class Executor {
   void launchKernels(SharedKernelContext& shared_context,
                      std::vector<std::unique_ptr<ExecutionKernel>>&& kernels);
 
+  /**
+   * Upper bound on the buffer pool memory the kernels will use for their input columns
+   * and output buffers, per memory level and device. Used for query admission control.
+   */
+  size_t estimateKernelMemoryFootprint(
+      const SharedKernelContext& shared_context,
+      const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+      std::map<int, size_t>& gpu_bytes_per_device) const;
+
   std::vector<size_t> getTableFragmentIndices(
       const RelAlgExecutionUnit& ra_exe_unit,
       const ExecutorDeviceType device_type,
@@ -549,6 +577,17 @@ class Executor {
                           std::list<std::shared_ptr<Chunk_NS::Chunk>>&,
                           DeviceAllocator* device_allocator);
 
+  /**
+   * Loads the input chunks of the selected fragments into the CPU buffer pool without
+   * holding on to them, so a later fetchChunks() call for a GPU kernel only has to copy
+   * them to the device.
+   */
+  void prefetchChunksToCpu(const ColumnFetcher&,
+                           const RelAlgExecutionUnit& ra_exe_unit,
+                           const std::map<int, const TableFragments*>&,
+                           const FragmentsList& selected_fragments,
+                           const Catalog_Namespace::Catalog&);
+
   FetchResult fetchUnionChunks(const ColumnFetcher&,
                                const RelAlgExecutionUnit& ra_exe_unit,
                                const int device_id,
@@ -565,7 +604,8 @@ class Executor {
       const RelAlgExecutionUnit& ra_exe_unit,
       const CartesianProduct<std::vector<std::vector<size_t>>>& frag_ids_crossjoin,
       const std::vector<InputDescriptor>& input_descs,
-      const std::map<int, const TableFragments*>& all_tables_fragments);
+      const std::map<int, const TableFragments*>& all_tables_fragments,
+      const FragmentsList& selected_fragments);
 
   void buildSelectedFragsMapping(
       std::vector<std::vector<size_t>>& selected_fragments_crossjoin,
@@ -686,18 +726,39 @@ class Executor {
   llvm::BasicBlock* codegenSkipDeletedOuterTableRow(
       const RelAlgExecutionUnit& ra_exe_unit,
       const CompilationOptions& co);
+  struct JoinHashTableOrError {
+    std::shared_ptr<JoinHashTableInterface> hash_table;
+    std::string fail_reason;
+  };
+  using JoinHashTablesByQual =
+      std::unordered_map<const Analyzer::BinOper*, JoinHashTableOrError>;
+
   std::vector<JoinLoop> buildJoinLoops(RelAlgExecutionUnit& ra_exe_unit,
                                        const CompilationOptions& co,
                                        const ExecutionOptions& eo,
                                        const std::vector<InputTableInfo>& query_infos,
                                        ColumnCacheMap& column_cache);
+  // Generates the join hash tables argument of the row function at the start of the
+  // query function, with a small perfect hash table copied to the shared memory of the
+  // GPU blocks if possible.
+  llvm::Value* codegenJoinHashTablesArg(llvm::Function* query_func,
+                                        const CompilationOptions& co,
+                                        const GpuSharedMemoryContext& gpu_smem_context);
   // Create a callback which generates code which returns true iff the row on the given
   // level is deleted.
   std::function<llvm::Value*(const std::vector<llvm::Value*>&, llvm::Value*)>
   buildIsDeletedCb(const RelAlgExecutionUnit& ra_exe_unit,
                    const size_t level_idx,
                    const CompilationOptions& co);
-  // Builds a join hash table for the provided conditions on the current level.
+  // Builds the hash tables of the first equijoin qualifiers of the inner join levels
+  // concurrently, if there are several of them.
+  JoinHashTablesByQual buildInnerJoinHashTables(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const CompilationOptions& co,
+      const std::vector<InputTableInfo>& query_infos,
+      ColumnCacheMap& column_cache);
+  // Builds a join hash table for the provided conditions on the current level, unless
+  // it is in `prebuilt_hash_tables`.
   // Returns null iff on failure and provides the reasons in `fail_reasons`.
   std::shared_ptr<JoinHashTableInterface> buildCurrentLevelHashTable(
       const JoinCondition& current_level_join_conditions,
@@ -705,6 +766,7 @@ class Executor {
       const CompilationOptions& co,
       const std::vector<InputTableInfo>& query_infos,
       ColumnCacheMap& column_cache,
+      const JoinHashTablesByQual& prebuilt_hash_tables,
       std::vector<std::string>& fail_reasons);
   llvm::Value* addJoinLoopIterator(const std::vector<llvm::Value*>& prev_iters,
                                    const size_t level_idx);
@@ -730,11 +792,6 @@ class Executor {
   void preloadFragOffsets(const std::vector<InputDescriptor>& input_descs,
                           const std::vector<InputTableInfo>& query_infos);
 
-  struct JoinHashTableOrError {
-    std::shared_ptr<JoinHashTableInterface> hash_table;
-    std::string fail_reason;
-  };
-
   JoinHashTableOrError buildHashTableForQualifier(
       const std::shared_ptr<Analyzer::BinOper>& qual_bin_oper,
       const std::vector<InputTableInfo>& query_infos,
@@ -789,6 +846,55 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  /**
+   * Whether the Bloom filters of the fragment's chunks rule out all values of an IN
+   * predicate among the top level quals.
+   */
+  bool skipFragmentInValues(const InputDescriptor& table_desc,
+                            const Fragmenter_Namespace::FragmentInfo& fragment,
+                            const std::list<std::shared_ptr<Analyzer::Expr>>& quals);
+
+  /**
+   * Whether the keys of the perfect hash table of one of the equi-join quals of an
+   * inner join rule out all values of the outer column in the fragment, from its chunk
+   * stats or, for narrow key ranges, its Bloom filter.
+   */
+  bool skipFragmentJoinKeys(const InputDescriptor& table_desc,
+                            const Fragmenter_Namespace::FragmentInfo& fragment,
+                            const std::list<std::shared_ptr<Analyzer::Expr>>& join_quals);
+
+  /**
+   * Whether the chunk stats of the fragment show that every row satisfies all of the
+   * simple quals, which must all compare a column of the table without nulls with a
+   * constant. A DELETE drops such fragments instead of marking their rows.
+   */
+  bool allFragmentRowsQualify(
+      const InputDescriptor& table_desc,
+      const Fragmenter_Namespace::FragmentInfo& fragment,
+      const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals);
+
+  /**
+   * The values of the COUNT targets of ra_exe_unit over num_rows rows of fragment, from
+   * its chunk metadata alone. None unless all the rows of the fragment qualify, none of
+   * them was deleted and the counted columns have no nulls.
+   */
+  std::optional<std::vector<int64_t>> getCountsFromChunkMetadata(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const Fragmenter_Namespace::FragmentInfo& fragment,
+      const size_t num_rows);
+
+  /**
+   * Narrows row_range of a fragment to the blocks between the first and the last one
+   * whose zone maps, or point bounding boxes for the distance and containment filters
+   * of the POINT columns, do not rule out all of the quals, and to the rows a binary
+   * search finds for quals on a sorted chunk. The range is empty if no row can match.
+   */
+  FragmentRowRange getQualifyingRowRange(
+      const InputDescriptor& table_desc,
+      const Fragmenter_Namespace::FragmentInfo& fragment,
+      const std::list<std::shared_ptr<Analyzer::Expr>>& quals,
+      const FragmentRowRange& row_range);
+
   std::pair<bool, int64_t> skipFragmentInnerJoins(
       const InputDescriptor& table_desc,
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -842,6 +948,10 @@ class Executor {
   std::shared_ptr<CompilationContext> getCodeFromCache(const CodeCacheKey&,
                                                        const CodeCache&);
 
+  // Replaces the quickly compiled code of key in cpu_code_cache_ by its optimized
+  // version, once the background compilation is done
+  void swapInOptimizedCpuCode(const CodeCacheKey& key);
+
   std::vector<int8_t> serializeLiterals(
       const std::unordered_map<int, CgenState::LiteralValues>& literals,
       const int device_id);
@@ -873,7 +983,11 @@ class Executor {
   std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
 
   static const int max_gpu_count{16};
+  static const size_t max_gpu_streams_per_device{32};
+  // the stream slots of the devices held by the running GPU kernels
   std::mutex gpu_exec_mutex_[max_gpu_count];
+  std::condition_variable gpu_exec_cv_[max_gpu_count];
+  uint32_t gpu_busy_streams_[max_gpu_count]{};
 
   static std::mutex gpu_active_modules_mutex_;
   static uint32_t gpu_active_modules_device_mask_;
@@ -887,6 +1001,11 @@ class Executor {
 
   CodeCache cpu_code_cache_;
   CodeCache gpu_code_cache_;
+  // the background compilations of the code of tiered CPU queries, by cache key
+  std::unordered_map<CodeCacheKey,
+                     std::future<CodeCacheValWithModule>,
+                     boost::hash<CodeCacheKey>>
+      optimizing_cpu_code_;
 
   static const size_t baseline_threshold{
       1000000};  // if a perfect hash needs more entries, use baseline
@@ -905,6 +1024,11 @@ class Executor {
   int64_t kernel_queue_time_ms_ = 0;
   int64_t compilation_queue_time_ms_ = 0;
 
+  // Set by the RelAlgExecutor for the queries run by EXPLAIN ANALYZE
+  QueryProfile* query_profile_{nullptr};
+  // Set by the RelAlgExecutor from the user of the session of the query
+  QueryPriority query_priority_{QueryPriority::NORMAL};
+
   // Singleton instance used for an execution unit which is a project with window
   // functions.
   std::unique_ptr<WindowProjectNodeContext> window_project_node_context_owned_;
@@ -953,6 +1077,10 @@ class Executor {
   static std::mutex compilation_mutex_;
   static std::mutex kernel_mutex_;
 
+  // Hands out CPU slots and GPU devices to kernels of concurrently running queries when
+  // concurrent query execution is enabled, in place of kernel_mutex_
+  static ExecutorResourcePool& getResourcePool();
+
   friend class BaselineJoinHashTable;
   friend class CodeGenerator;
   friend class ColumnFetcher;
@@ -16,6 +16,8 @@
 
 #include "QueryEngine/ExecutionKernel.h"
 
+#include <algorithm>
+#include <future>
 #include <mutex>
 #include <vector>
 
@@ -24,7 +26,18 @@
 #include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExternalExecutor.h"
+#include "QueryEngine/FragmentResultCache.h"
+#include "QueryEngine/InterpretedExecutor.h"
+#include "QueryEngine/QueryProfile.h"
 #include "QueryEngine/SerializeToSql.h"
+#include "Shared/measure.h"
+#include "Shared/scope.h"
+
+extern bool g_enable_chunk_prefetch;
+extern bool g_enable_gpu_streaming;
+extern bool g_enable_block_zone_maps;
+extern bool g_enable_top_n_fragment_skipping;
+extern bool g_enable_group_by_buffer_spill;
 
 namespace {
 
@@ -58,6 +71,120 @@ bool need_to_hold_chunk(const Chunk_NS::Chunk* chunk,
   return false;
 }
 
+// A CPU kernel stops at the first row which finds its baseline hash buffer full, before
+// the row updates any aggregate. When the row is the only one of its iteration, i.e.
+// there's a single input table and a single fragment, the kernel can go on from it with
+// a fresh buffer while the groups of the full one are reduced with the other results.
+bool can_spill_group_by_buffer(const RelAlgExecutionUnit& ra_exe_unit,
+                               const QueryMemoryDescriptor& query_mem_desc,
+                               const ExecutorDeviceType device_type,
+                               const FetchResult& fetch_result,
+                               const bool do_render) {
+  return g_enable_group_by_buffer_spill && device_type == ExecutorDeviceType::CPU &&
+         query_mem_desc.getQueryDescriptionType() ==
+             QueryDescriptionType::GroupByBaselineHash &&
+         ra_exe_unit.input_descs.size() == size_t(1) && ra_exe_unit.join_quals.empty() &&
+         fetch_result.col_buffers.size() == size_t(1) && !do_render;
+}
+
+// The order entry column of a CPU streaming top n projection over a single table, by
+// whose chunk metadata the kernels skip the fragments which can't reach the top n rows
+// of the kernels done
+const Analyzer::ColumnVar* get_top_n_threshold_column(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor& query_mem_desc,
+    const ExecutorDeviceType device_type,
+    const ExecutorDispatchMode kernel_dispatch_mode) {
+  if (!g_enable_top_n_fragment_skipping || device_type != ExecutorDeviceType::CPU ||
+      kernel_dispatch_mode != ExecutorDispatchMode::KernelPerFragment ||
+      !query_mem_desc.useStreamingTopN() || ra_exe_unit.union_all ||
+      ra_exe_unit.input_descs.size() != 1) {
+    return nullptr;
+  }
+  CHECK_EQ(ra_exe_unit.sort_info.order_entries.size(), size_t(1));
+  const auto& order_entry = ra_exe_unit.sort_info.order_entries.front();
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(
+      ra_exe_unit.target_exprs[order_entry.tle_no - 1]);
+  if (!col_var || col_var->get_rte_idx() ||
+      col_var->get_table_id() != ra_exe_unit.input_descs.front().getTableId()) {
+    return nullptr;
+  }
+  // the chunk statistics of the dates are in days, their values in seconds
+  const auto& col_ti = col_var->get_type_info();
+  if (!col_ti.is_integer() && !(col_ti.is_time() && col_ti.get_type() != kDATE)) {
+    return nullptr;
+  }
+  return col_var;
+}
+
+// The qual of the rows at least as good as the top n threshold, null aside
+std::shared_ptr<Analyzer::Expr> make_top_n_threshold_qual(
+    const Analyzer::ColumnVar* col_var,
+    const bool is_desc,
+    const int64_t threshold) {
+  const auto& col_ti = col_var->get_type_info();
+  Datum d;
+  switch (col_ti.get_type()) {
+    case kTINYINT:
+      d.tinyintval = threshold;
+      break;
+    case kSMALLINT:
+      d.smallintval = threshold;
+      break;
+    case kINT:
+      d.intval = threshold;
+      break;
+    default:
+      d.bigintval = threshold;
+  }
+  return makeExpr<Analyzer::BinOper>(kBOOLEAN,
+                                     is_desc ? kGE : kLE,
+                                     kONE,
+                                     col_var->deep_copy(),
+                                     makeExpr<Analyzer::Constant>(col_ti, false, d));
+}
+
+bool fragment_may_have_nulls(const Fragmenter_Namespace::FragmentInfo& fragment,
+                             const Analyzer::ColumnVar* col_var) {
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+  return chunk_meta_it == chunk_metadata_map.end() ||
+         chunk_meta_it->second->chunkStats.has_nulls;
+}
+
+// Tightens the top n threshold to the worst order entry value of the rows of a kernel,
+// if they fill its heap with values which aren't null
+void update_top_n_threshold(SharedKernelContext& shared_context,
+                            const ResultSet& rows,
+                            const RelAlgExecutionUnit& ra_exe_unit,
+                            const Analyzer::ColumnVar* col_var) {
+  const auto& order_entry = ra_exe_unit.sort_info.order_entries.front();
+  const size_t n = ra_exe_unit.sort_info.offset + ra_exe_unit.sort_info.limit;
+  const auto null_val = inline_int_null_val(col_var->get_type_info());
+  std::optional<int64_t> worst;
+  size_t row_count{0};
+  for (size_t i = 0; i < rows.entryCount(); ++i) {
+    if (rows.isRowAtEmpty(i)) {
+      continue;
+    }
+    const auto tv = rows.getRowAt(i, order_entry.tle_no - 1, false, false);
+    const auto scalar_tv = boost::get<ScalarTargetValue>(&tv);
+    CHECK(scalar_tv);
+    const auto val = boost::get<int64_t>(scalar_tv);
+    CHECK(val);
+    if (*val == null_val) {
+      return;
+    }
+    worst = !worst ? *val
+                   : (order_entry.is_desc ? std::min(*worst, *val)
+                                          : std::max(*worst, *val));
+    ++row_count;
+  }
+  if (worst && row_count >= n) {
+    shared_context.updateTopNThreshold(*worst, order_entry.is_desc);
+  }
+}
+
 }  // namespace
 
 const std::vector<uint64_t>& SharedKernelContext::getFragOffsets() {
@@ -87,11 +214,45 @@ SharedKernelContext::getFragmentResults() {
   return all_fragment_results_;
 }
 
+std::optional<int64_t> SharedKernelContext::getTopNThreshold() {
+  std::lock_guard<std::mutex> lock(top_n_threshold_mutex_);
+  return top_n_threshold_;
+}
+
+void SharedKernelContext::updateTopNThreshold(const int64_t threshold,
+                                              const bool is_desc) {
+  std::lock_guard<std::mutex> lock(top_n_threshold_mutex_);
+  if (!top_n_threshold_) {
+    top_n_threshold_ = threshold;
+  } else {
+    top_n_threshold_ = is_desc ? std::max(*top_n_threshold_, threshold)
+                               : std::min(*top_n_threshold_, threshold);
+  }
+}
+
+void SharedKernelContext::addKernelRows(const ExecutorDeviceType device_type,
+                                        const size_t outer_rows) {
+  std::lock_guard<std::mutex> lock(device_kernel_stats_mutex_);
+  device_kernel_stats_[device_type].outer_rows += outer_rows;
+}
+
+void SharedKernelContext::recordKernelFinish(const ExecutorDeviceType device_type) {
+  std::lock_guard<std::mutex> lock(device_kernel_stats_mutex_);
+  device_kernel_stats_[device_type].last_finish_time = std::chrono::steady_clock::now();
+}
+
+SharedKernelContext::DeviceKernelStats SharedKernelContext::getDeviceKernelStats(
+    const ExecutorDeviceType device_type) {
+  std::lock_guard<std::mutex> lock(device_kernel_stats_mutex_);
+  return device_kernel_stats_[device_type];
+}
+
 void ExecutionKernel::run(Executor* executor, SharedKernelContext& shared_context) {
   DEBUG_TIMER("ExecutionKernel::run");
   INJECT_TIMER(kernel_run);
   try {
     runImpl(executor, shared_context);
+    shared_context.recordKernelFinish(chosen_device_type);
   } catch (const OutOfHostMemory& e) {
     throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM, e.what());
   } catch (const std::bad_alloc& e) {
@@ -135,17 +296,88 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
   auto catalog = executor->getCatalog();
   CHECK(catalog);
 
+  // Once the heap of a kernel is full, the fragments whose chunk metadata shows they
+  // have no row as good as its worst one can't change the top n rows of the query.
+  const auto top_n_threshold_col = get_top_n_threshold_column(
+      ra_exe_unit_, query_mem_desc, chosen_device_type, kernel_dispatch_mode);
+  std::shared_ptr<Analyzer::Expr> top_n_threshold_qual;
+  if (top_n_threshold_col && rowid_lookup_key < 0) {
+    CHECK_EQ(frag_list.size(), size_t(1));
+    CHECK_EQ(outer_tab_frag_ids.size(), size_t(1));
+    const auto& order_entry = ra_exe_unit_.sort_info.order_entries.front();
+    const auto& outer_fragment =
+        shared_context.getQueryInfos().front().info.fragments[outer_tab_frag_ids[0]];
+    const auto threshold = shared_context.getTopNThreshold();
+    if (threshold && !(order_entry.nulls_first &&
+                       fragment_may_have_nulls(outer_fragment, top_n_threshold_col))) {
+      top_n_threshold_qual = make_top_n_threshold_qual(
+          top_n_threshold_col, order_entry.is_desc, *threshold);
+      if (executor
+              ->skipFragment(ra_exe_unit_.input_descs.front(),
+                             outer_fragment,
+                             {top_n_threshold_qual},
+                             shared_context.getFragOffsets(),
+                             outer_tab_frag_ids[0])
+              .first) {
+        VLOG(1) << "Skip fragment " << outer_tab_frag_ids[0]
+                << " which can't reach the top " << ra_exe_unit_.sort_info.limit;
+        return;
+      }
+    }
+  }
+
   // need to own them while query executes
   auto chunk_iterators_ptr = std::make_shared<std::list<ChunkIter>>();
   std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks;
-  std::unique_ptr<std::lock_guard<std::mutex>> gpu_lock;
+  std::optional<size_t> gpu_stream_idx;
+  ScopeGuard release_gpu_stream = [executor, &gpu_stream_idx, chosen_device_id] {
+    if (gpu_stream_idx) {
+      executor->releaseGpuStream(chosen_device_id, *gpu_stream_idx);
+    }
+  };
   std::unique_ptr<CudaAllocator> device_allocator;
+
+  // Read the chunks of this kernel from disk into the CPU buffer pool while the kernel
+  // waits for the device and while the first fragments are copied to the GPU, which
+  // overlaps disk reads with the device work of the preceding kernel. The waves of the
+  // GPU streaming mode always do, so the next wave is loaded while the current one runs.
+  std::map<int, const TableFragments*> prefetch_tables_fragments;
+  std::future<void> prefetch_future;
+  if ((g_enable_chunk_prefetch || g_enable_gpu_streaming) &&
+      chosen_device_type == ExecutorDeviceType::GPU &&
+      !ra_exe_unit_.union_all) {
+    QueryFragmentDescriptor::computeAllTablesFragments(
+        prefetch_tables_fragments, ra_exe_unit_, shared_context.getQueryInfos());
+    const auto parent_thread_id = logger::thread_id();
+    prefetch_future = std::async(std::launch::async, [&, parent_thread_id] {
+      DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+      try {
+        executor->prefetchChunksToCpu(
+            column_fetcher, ra_exe_unit_, prefetch_tables_fragments, frag_list, *catalog);
+      } catch (const std::exception& e) {
+        // the kernel fetches the chunks itself and reports any real error
+        LOG(WARNING) << "Chunk prefetch failed: " << e.what();
+      }
+    });
+  }
+  ScopeGuard wait_for_prefetch = [&prefetch_future] {
+    if (prefetch_future.valid()) {
+      prefetch_future.wait();
+    }
+  };
+
   if (chosen_device_type == ExecutorDeviceType::GPU) {
-    gpu_lock.reset(
-        new std::lock_guard<std::mutex>(executor->gpu_exec_mutex_[chosen_device_id]));
+    gpu_stream_idx = executor->acquireGpuStream(chosen_device_id);
     device_allocator =
         std::make_unique<CudaAllocator>(&catalog->getDataMgr(), chosen_device_id);
   }
+  std::shared_ptr<DeviceMemoryUsageTracker> gpu_memory_usage;
+  const auto row_set_mem_owner = executor->getRowSetMemoryOwner();
+  if (device_allocator && row_set_mem_owner) {
+    gpu_memory_usage = row_set_mem_owner->getGpuMemoryUsageTracker();
+    device_allocator->setUsageTracker(gpu_memory_usage, DeviceMemoryCategory::Scratch);
+  }
+  const auto fetch_clock_begin = timer_start();
   FetchResult fetch_result;
   try {
     std::map<int, const TableFragments*> all_tables_fragments;
@@ -193,12 +425,30 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
             kernel_dispatch_mode == ExecutorDispatchMode::MultifragmentKernel});
     return;
   }
+  const auto fetch_ms = timer_stop(fetch_clock_begin);
+
+  // the input chunks stay pinned on the device until the kernel finishes
+  size_t gpu_input_chunk_bytes{0};
+  if (gpu_memory_usage) {
+    for (const auto& chunk : chunks) {
+      for (const auto buffer : {chunk->getBuffer(), chunk->getIndexBuf()}) {
+        if (buffer && buffer->getType() == Data_Namespace::GPU_LEVEL) {
+          gpu_input_chunk_bytes += buffer->size();
+        }
+      }
+    }
+    gpu_memory_usage->allocate(DeviceMemoryCategory::InputChunks, gpu_input_chunk_bytes);
+  }
+  ScopeGuard release_input_chunk_usage = [&gpu_memory_usage, gpu_input_chunk_bytes] {
+    if (gpu_memory_usage) {
+      gpu_memory_usage->free(DeviceMemoryCategory::InputChunks, gpu_input_chunk_bytes);
+    }
+  };
 
   if (eo.executor_type == ExecutorType::Extern) {
     if (ra_exe_unit_.input_descs.size() > 1) {
       throw std::runtime_error("Joins not supported through external execution");
     }
-    const auto query = serialize_to_sql(&ra_exe_unit_, catalog);
     GroupByAndAggregate group_by_and_aggregate(executor,
                                                ExecutorDeviceType::CPU,
                                                ra_exe_unit_,
@@ -207,14 +457,21 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
                                                std::nullopt);
     const auto query_mem_desc =
         group_by_and_aggregate.initQueryMemoryDescriptor(false, 0, 8, nullptr, false);
-    device_results_ = run_query_external(
-        query,
-        fetch_result,
-        executor->plan_state_.get(),
-        ExternalQueryOutputSpec{
-            *query_mem_desc,
-            target_exprs_to_infos(ra_exe_unit_.target_exprs, *query_mem_desc),
-            executor});
+    const ExternalQueryOutputSpec output_spec{
+        *query_mem_desc,
+        target_exprs_to_infos(ra_exe_unit_.target_exprs, *query_mem_desc),
+        executor};
+    if (g_enable_interpreted_interop) {
+      device_results_ = run_query_interpreted(
+          ra_exe_unit_, fetch_result, executor->plan_state_.get(), output_spec);
+    }
+    if (!device_results_) {
+      device_results_ =
+          run_query_external(serialize_to_sql(&ra_exe_unit_, catalog),
+                             fetch_result,
+                             executor->plan_state_.get(),
+                             output_spec);
+    }
     shared_context.addDeviceResults(std::move(device_results_), outer_tab_frag_ids);
     return;
   }
@@ -246,27 +503,32 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
     }
   }
 
-  if (eo.executor_type == ExecutorType::Native) {
+  auto make_query_exe_context = [&]() {
     try {
-      query_exe_context_owned =
-          query_mem_desc.getQueryExecutionContext(ra_exe_unit_,
-                                                  executor,
-                                                  chosen_device_type,
-                                                  kernel_dispatch_mode,
-                                                  chosen_device_id,
-                                                  total_num_input_rows,
-                                                  fetch_result.col_buffers,
-                                                  fetch_result.frag_offsets,
-                                                  executor->getRowSetMemoryOwner(),
-                                                  compilation_result.output_columnar,
-                                                  query_mem_desc.sortOnGpu(),
-                                                  do_render ? render_info_ : nullptr);
+      return query_mem_desc.getQueryExecutionContext(ra_exe_unit_,
+                                                     executor,
+                                                     chosen_device_type,
+                                                     kernel_dispatch_mode,
+                                                     chosen_device_id,
+                                                     total_num_input_rows,
+                                                     fetch_result.col_buffers,
+                                                     fetch_result.frag_offsets,
+                                                     executor->getRowSetMemoryOwner(),
+                                                     compilation_result.output_columnar,
+                                                     query_mem_desc.sortOnGpu(),
+                                                     do_render ? render_info_ : nullptr);
     } catch (const OutOfHostMemory& e) {
       throw QueryExecutionError(Executor::ERR_OUT_OF_CPU_MEM);
     }
+  };
+  if (eo.executor_type == ExecutorType::Native) {
+    query_exe_context_owned = make_query_exe_context();
   }
   QueryExecutionContext* query_exe_context{query_exe_context_owned.get()};
   CHECK(query_exe_context);
+  if (gpu_stream_idx) {
+    query_exe_context->setGpuStreamIdx(*gpu_stream_idx);
+  }
   int32_t err{0};
   uint32_t start_rowid{0};
   if (rowid_lookup_key >= 0) {
@@ -275,8 +537,62 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
       start_rowid = rowid_lookup_key -
                     all_frag_row_offsets[frag_list.begin()->fragment_ids.front()];
     }
+    if (chosen_device_type == ExecutorDeviceType::CPU && start_rowid) {
+      // only the looked up row needs to be scanned
+      CHECK(!fetch_result.num_rows.empty() && !fetch_result.num_rows[0].empty());
+      fetch_result.num_rows[0][0] = start_rowid + 1;
+    }
+  } else if (outer_row_range) {
+    // The generated CPU code resumes scanning at the start row passed through the error
+    // code and stops at the outer table row count, so a sub-fragment kernel just narrows
+    // both to its row range.
+    CHECK(chosen_device_type == ExecutorDeviceType::CPU);
+    CHECK_EQ(fetch_result.num_rows.size(), size_t(1));
+    CHECK(!fetch_result.num_rows[0].empty());
+    auto& outer_num_rows = fetch_result.num_rows[0][0];
+    const auto row_end =
+        std::min(static_cast<int64_t>(outer_row_range->second), outer_num_rows);
+    if (static_cast<int64_t>(outer_row_range->first) >= row_end) {
+      return;
+    }
+    start_rowid = outer_row_range->first;
+    outer_num_rows = row_end;
+  }
+  if (g_enable_block_zone_maps && chosen_device_type == ExecutorDeviceType::CPU &&
+      rowid_lookup_key < 0 &&
+      (!ra_exe_unit_.simple_quals.empty() || !ra_exe_unit_.quals.empty() ||
+       top_n_threshold_qual) &&
+      !ra_exe_unit_.union_all && ra_exe_unit_.input_descs.size() == 1 &&
+      kernel_dispatch_mode == ExecutorDispatchMode::KernelPerFragment) {
+    // Scan only the part of the fragment whose block zone maps and point bounding boxes
+    // pass the quals, the same way a sub-fragment kernel scans its row range.
+    auto zone_map_quals = ra_exe_unit_.simple_quals;
+    zone_map_quals.insert(
+        zone_map_quals.end(), ra_exe_unit_.quals.begin(), ra_exe_unit_.quals.end());
+    if (top_n_threshold_qual) {
+      zone_map_quals.push_back(top_n_threshold_qual);
+    }
+    CHECK_EQ(frag_list.size(), size_t(1));
+    CHECK_EQ(frag_list.front().fragment_ids.size(), size_t(1));
+    const auto& outer_fragment = shared_context.getQueryInfos()
+                                     .front()
+                                     .info.fragments[frag_list.front().fragment_ids[0]];
+    auto& outer_num_rows = fetch_result.num_rows[0][0];
+    const auto qualifying_row_range = executor->getQualifyingRowRange(
+        ra_exe_unit_.input_descs.front(),
+        outer_fragment,
+        zone_map_quals,
+        {start_rowid, static_cast<size_t>(outer_num_rows)});
+    if (qualifying_row_range.first >= qualifying_row_range.second) {
+      return;
+    }
+    start_rowid = qualifying_row_range.first;
+    outer_num_rows = qualifying_row_range.second;
   }
 
+  const auto execution_clock_begin = timer_start();
+  // the results of the group by buffers which got full, reduced with the others
+  std::vector<ResultSetPtr> spilled_results;
   if (ra_exe_unit_.groupby_exprs.empty()) {
     err = executor->executePlanWithoutGroupBy(ra_exe_unit_,
                                               compilation_result,
@@ -298,38 +614,111 @@ void ExecutionKernel::runImpl(Executor* executor, SharedKernelContext& shared_co
       VLOG(1) << "outer_table_id=" << outer_table_id
               << " ra_exe_unit_.scan_limit=" << ra_exe_unit_.scan_limit;
     }
-    err = executor->executePlanWithGroupBy(ra_exe_unit_,
-                                           compilation_result,
-                                           query_comp_desc.hoistLiterals(),
-                                           device_results_,
-                                           chosen_device_type,
-                                           fetch_result.col_buffers,
-                                           outer_tab_frag_ids,
-                                           query_exe_context,
-                                           fetch_result.num_rows,
-                                           fetch_result.frag_offsets,
-                                           &catalog->getDataMgr(),
-                                           chosen_device_id,
-                                           outer_table_id,
-                                           ra_exe_unit_.scan_limit,
-                                           start_rowid,
-                                           ra_exe_unit_.input_descs.size(),
-                                           do_render ? render_info_ : nullptr);
+    auto resume_rowid = start_rowid;
+    while (true) {
+      err = executor->executePlanWithGroupBy(ra_exe_unit_,
+                                             compilation_result,
+                                             query_comp_desc.hoistLiterals(),
+                                             device_results_,
+                                             chosen_device_type,
+                                             fetch_result.col_buffers,
+                                             outer_tab_frag_ids,
+                                             query_exe_context,
+                                             fetch_result.num_rows,
+                                             fetch_result.frag_offsets,
+                                             &catalog->getDataMgr(),
+                                             chosen_device_id,
+                                             outer_table_id,
+                                             ra_exe_unit_.scan_limit,
+                                             resume_rowid,
+                                             ra_exe_unit_.input_descs.size(),
+                                             do_render ? render_info_ : nullptr);
+      // a kernel which runs out of slots returns the negated row it stopped at, a fresh
+      // buffer doesn't help if that's the first row it scanned
+      if (err >= 0 || !device_results_ || static_cast<uint32_t>(-err) <= resume_rowid ||
+          !can_spill_group_by_buffer(ra_exe_unit_,
+                                     query_mem_desc,
+                                     chosen_device_type,
+                                     fetch_result,
+                                     do_render)) {
+        break;
+      }
+      VLOG(1) << "Group by buffer of " << query_mem_desc.getEntryCount()
+              << " entries full at row " << -err << ", going on with a fresh buffer";
+      spilled_results.push_back(std::move(device_results_));
+      resume_rowid = -err;
+      query_exe_context_owned = make_query_exe_context();
+      query_exe_context = query_exe_context_owned.get();
+      CHECK(query_exe_context);
+    }
+  }
+  std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
+  for (const auto& chunk : chunks) {
+    if (need_to_hold_chunk(chunk.get(), ra_exe_unit_)) {
+      chunks_to_hold.push_back(chunk);
+    }
+  }
+  auto hold_inputs = [&](ResultSet& results) {
+    results.holdChunks(chunks_to_hold);
+    results.holdChunkIterators(chunk_iterators_ptr);
+    if (!fetch_result.deferred_chunks.empty()) {
+      results.deferChunks(&catalog->getDataMgr(), fetch_result.deferred_chunks);
+    }
+  };
+  for (const auto& results : spilled_results) {
+    hold_inputs(*results);
   }
   if (device_results_) {
-    std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
+    hold_inputs(*device_results_);
+  } else {
+    VLOG(1) << "null device_results.";
+  }
+  if (executor->query_profile_) {
+    QueryProfile::KernelProfile kernel_profile;
+    kernel_profile.device_type =
+        chosen_device_type == ExecutorDeviceType::GPU ? "GPU" : "CPU";
+    kernel_profile.device_id = chosen_device_id;
+    kernel_profile.fragment_ids = outer_tab_frag_ids;
+    kernel_profile.fetch_ms = fetch_ms;
+    kernel_profile.execution_ms = timer_stop(execution_clock_begin);
+    // the rows of the outer table the kernel scanned, from its start row on
+    for (const auto& frag_num_rows : fetch_result.num_rows) {
+      kernel_profile.rows_in += frag_num_rows.front();
+    }
+    kernel_profile.rows_in =
+        std::max(kernel_profile.rows_in - static_cast<int64_t>(start_rowid), int64_t(0));
+    kernel_profile.rows_out = device_results_ && !err ? device_results_->rowCount() : 0;
     for (const auto& chunk : chunks) {
-      if (need_to_hold_chunk(chunk.get(), ra_exe_unit_)) {
-        chunks_to_hold.push_back(chunk);
+      for (const auto buffer : {chunk->getBuffer(), chunk->getIndexBuf()}) {
+        if (!buffer) {
+          continue;
+        }
+        if (buffer->getType() == Data_Namespace::GPU_LEVEL) {
+          kernel_profile.gpu_bytes_fetched += buffer->size();
+        } else {
+          kernel_profile.cpu_bytes_fetched += buffer->size();
+        }
       }
     }
-    device_results_->holdChunks(chunks_to_hold);
-    device_results_->holdChunkIterators(chunk_iterators_ptr);
-  } else {
-    VLOG(1) << "null device_results.";
+    executor->query_profile_->addKernel(std::move(kernel_profile));
   }
   if (err) {
     throw QueryExecutionError(err);
   }
+  if (top_n_threshold_col && device_results_) {
+    update_top_n_threshold(
+        shared_context, *device_results_, ra_exe_unit_, top_n_threshold_col);
+  }
+  if (fragment_result_cache_key && device_results_ && spilled_results.empty()) {
+    CHECK_EQ(outer_tab_frag_ids.size(), size_t(1));
+    FragmentResultCache::instance().put(
+        *fragment_result_cache_key,
+        shared_context.getQueryInfos().front().info.fragments[outer_tab_frag_ids[0]],
+        *device_results_,
+        executor);
+  }
+  for (auto& results : spilled_results) {
+    shared_context.addDeviceResults(std::move(results), outer_tab_frag_ids);
+  }
   shared_context.addDeviceResults(std::move(device_results_), outer_tab_frag_ids);
 }
@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <map>
+
 #include "Logger/Logger.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
@@ -34,9 +37,35 @@ class SharedKernelContext {
 
   const std::vector<InputTableInfo>& getQueryInfos() const { return query_infos_; }
 
+  // The order entry value the rows of a streaming top n projection have to reach to get
+  // in the top n, once the heap of a kernel was filled
+  std::optional<int64_t> getTopNThreshold();
+
+  void updateTopNThreshold(const int64_t threshold, const bool is_desc);
+
+  // The outer rows given to the kernels of a device type and the time the last of them
+  // finished, from which the hybrid queries measure the throughput of the CPU and the
+  // GPU kernels
+  struct DeviceKernelStats {
+    size_t outer_rows{0};
+    std::optional<std::chrono::steady_clock::time_point> last_finish_time;
+  };
+
+  void addKernelRows(const ExecutorDeviceType device_type, const size_t outer_rows);
+
+  void recordKernelFinish(const ExecutorDeviceType device_type);
+
+  DeviceKernelStats getDeviceKernelStats(const ExecutorDeviceType device_type);
+
   std::atomic_flag dynamic_watchdog_set = ATOMIC_FLAG_INIT;
 
  private:
+  std::mutex top_n_threshold_mutex_;
+  std::optional<int64_t> top_n_threshold_;
+
+  std::mutex device_kernel_stats_mutex_;
+  std::map<ExecutorDeviceType, DeviceKernelStats> device_kernel_stats_;
+
   std::mutex reduce_mutex_;
   std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
 
@@ -57,7 +86,10 @@ class ExecutionKernel {
                   const FragmentsList& frag_list,
                   const ExecutorDispatchMode kernel_dispatch_mode,
                   RenderInfo* render_info,
-                  const int64_t rowid_lookup_key)
+                  const int64_t rowid_lookup_key,
+                  const std::optional<FragmentRowRange>& outer_row_range = std::nullopt,
+                  const std::optional<std::string>& fragment_result_cache_key =
+                      std::nullopt)
       : ra_exe_unit_(ra_exe_unit)
       , chosen_device_type(chosen_device_type)
       , chosen_device_id(chosen_device_id)
@@ -68,10 +100,20 @@ class ExecutionKernel {
       , frag_list(frag_list)
       , kernel_dispatch_mode(kernel_dispatch_mode)
       , render_info_(render_info)
-      , rowid_lookup_key(rowid_lookup_key) {}
+      , rowid_lookup_key(rowid_lookup_key)
+      , outer_row_range(outer_row_range)
+      , fragment_result_cache_key(fragment_result_cache_key) {}
 
   void run(Executor* executor, SharedKernelContext& shared_context);
 
+  ExecutorDeviceType getDeviceType() const { return chosen_device_type; }
+
+  int getDeviceId() const { return chosen_device_id; }
+
+  const FragmentsList& getFragmentsList() const { return frag_list; }
+
+  const QueryMemoryDescriptor& getQueryMemoryDescriptor() const { return query_mem_desc; }
+
  private:
   const RelAlgExecutionUnit& ra_exe_unit_;
   const ExecutorDeviceType chosen_device_type;
@@ -84,6 +126,9 @@ class ExecutionKernel {
   const ExecutorDispatchMode kernel_dispatch_mode;
   RenderInfo* render_info_;
   const int64_t rowid_lookup_key;
+  const std::optional<FragmentRowRange> outer_row_range;
+  // set when the results of the kernel go to the FragmentResultCache
+  const std::optional<std::string> fragment_result_cache_key;
 
   ResultSetPtr device_results_;
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Logger/Logger.h"
+#include "QueryEngine/QueryPriority.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+/**
+ * ExecutorResourcePool hands out CPU kernel slots, GPU devices and buffer pool memory to
+ * concurrently running queries. It replaces the exclusive kernel lock when concurrent
+ * query execution is enabled: a query blocks only until the CPU slots and GPU devices
+ * its kernels need are available, so queries targeting disjoint resources run in
+ * parallel. When memory budgets are set, a query is also admitted only once its
+ * estimated buffer footprint fits next to the queries already running. The waiting
+ * queries which fit are admitted in the weighted fair order of their priority classes.
+ */
+class ExecutorResourcePool {
+ public:
+  struct ResourceRequest {
+    size_t cpu_slots{0};
+    std::set<int> gpu_ids;
+    size_t cpu_memory_bytes{0};
+    std::map<int, size_t> gpu_memory_bytes;  // keyed by device id
+    QueryPriority priority{QueryPriority::NORMAL};
+  };
+
+  /**
+   * RAII handle for a set of acquired resources. Resources are returned to the pool (and
+   * waiters are woken) when the handle is destroyed.
+   */
+  class ResourceHandle {
+   public:
+    ResourceHandle(ExecutorResourcePool* pool, const ResourceRequest& granted)
+        : pool_(pool), granted_(granted) {}
+
+    ResourceHandle(const ResourceHandle&) = delete;
+    ResourceHandle& operator=(const ResourceHandle&) = delete;
+
+    ~ResourceHandle() {
+      CHECK(pool_);
+      pool_->release(granted_);
+    }
+
+    size_t getCpuSlots() const { return granted_.cpu_slots; }
+    const std::set<int>& getGpuIds() const { return granted_.gpu_ids; }
+    size_t getCpuMemoryBytes() const { return granted_.cpu_memory_bytes; }
+
+   private:
+    ExecutorResourcePool* pool_;
+    const ResourceRequest granted_;
+  };
+
+  ExecutorResourcePool(const size_t total_cpu_slots)
+      : total_cpu_slots_(std::max(total_cpu_slots, size_t(1)))
+      , available_cpu_slots_(total_cpu_slots_) {}
+
+  /**
+   * Sets the buffer pool capacity queries are admitted against. A budget of zero means
+   * memory is not accounted for that level.
+   */
+  void setMemoryBudgets(const size_t cpu_memory_budget,
+                        const std::map<int, size_t>& gpu_memory_budgets) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    cpu_memory_budget_ = cpu_memory_budget;
+    gpu_memory_budgets_ = gpu_memory_budgets;
+    memory_budgets_set_ = true;
+  }
+
+  bool hasMemoryBudgets() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return memory_budgets_set_;
+  }
+
+  /**
+   * Returns true if the request can never be satisfied because it asks for more memory
+   * on some GPU than that device's whole budget. Such queries should run on CPU instead.
+   */
+  bool exceedsGpuBudget(const ResourceRequest& request) const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    for (const auto& [device_id, bytes] : request.gpu_memory_bytes) {
+      const auto budget_it = gpu_memory_budgets_.find(device_id);
+      if (budget_it != gpu_memory_budgets_.end() && budget_it->second &&
+          bytes > budget_it->second) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Blocks until the requested number of CPU slots, all of the requested GPU devices and
+   * the requested memory are free. Requests larger than the pool are clamped to the pool
+   * size, so a single query can always make progress once the pool drains.
+   */
+  std::unique_ptr<ResourceHandle> acquire(const ResourceRequest& request) {
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    const auto granted = clampToPool(request);
+    const auto cost = granted.cpu_slots + granted.gpu_ids.size();
+    const auto tag = fair_clock_.nextTag(granted.priority, static_cast<double>(cost));
+    const auto waiter_it = waiters_.emplace(tag, &granted).first;
+    cv_.wait(lock, [this, &granted, &waiter_it] {
+      return fits(granted) && isFirstFittingWaiter(waiter_it);
+    });
+    waiters_.erase(waiter_it);
+    fair_clock_.serve(tag);
+    available_cpu_slots_ -= granted.cpu_slots;
+    busy_gpus_.insert(granted.gpu_ids.begin(), granted.gpu_ids.end());
+    used_cpu_memory_ += granted.cpu_memory_bytes;
+    for (const auto& [device_id, bytes] : granted.gpu_memory_bytes) {
+      used_gpu_memory_[device_id] += bytes;
+    }
+    VLOG(1) << "Acquired " << granted.cpu_slots << " CPU slots, "
+            << granted.gpu_ids.size() << " GPUs and " << granted.cpu_memory_bytes
+            << " bytes of CPU memory, " << available_cpu_slots_
+            << " CPU slots remain available.";
+    lock.unlock();
+    // the waiters behind this one may fit in what is left
+    cv_.notify_all();
+    return std::make_unique<ResourceHandle>(this, granted);
+  }
+
+  std::unique_ptr<ResourceHandle> acquire(const size_t cpu_slots,
+                                          const std::set<int>& gpu_ids) {
+    ResourceRequest request;
+    request.cpu_slots = cpu_slots;
+    request.gpu_ids = gpu_ids;
+    return acquire(request);
+  }
+
+  size_t getTotalCpuSlots() const { return total_cpu_slots_; }
+
+  size_t getAvailableCpuSlots() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return available_cpu_slots_;
+  }
+
+  size_t getUsedCpuMemory() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return used_cpu_memory_;
+  }
+
+  bool isGpuBusy(const int gpu_id) const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return busy_gpus_.count(gpu_id);
+  }
+
+ private:
+  ResourceRequest clampToPool(const ResourceRequest& request) const {
+    auto granted = request;
+    granted.cpu_slots = std::min(request.cpu_slots, total_cpu_slots_);
+    if (cpu_memory_budget_) {
+      granted.cpu_memory_bytes = std::min(request.cpu_memory_bytes, cpu_memory_budget_);
+    } else {
+      granted.cpu_memory_bytes = 0;
+    }
+    for (auto& [device_id, bytes] : granted.gpu_memory_bytes) {
+      const auto budget_it = gpu_memory_budgets_.find(device_id);
+      bytes = budget_it == gpu_memory_budgets_.end() ? 0
+                                                     : std::min(bytes, budget_it->second);
+    }
+    return granted;
+  }
+
+  bool fits(const ResourceRequest& request) const {
+    if (available_cpu_slots_ < request.cpu_slots) {
+      return false;
+    }
+    for (const auto gpu_id : request.gpu_ids) {
+      if (busy_gpus_.count(gpu_id)) {
+        return false;
+      }
+    }
+    if (used_cpu_memory_ + request.cpu_memory_bytes >
+        std::max(cpu_memory_budget_, request.cpu_memory_bytes)) {
+      return false;
+    }
+    for (const auto& [device_id, bytes] : request.gpu_memory_bytes) {
+      const auto used_it = used_gpu_memory_.find(device_id);
+      const auto used = used_it == used_gpu_memory_.end() ? size_t(0) : used_it->second;
+      const auto budget = gpu_memory_budgets_.find(device_id);
+      if (budget != gpu_memory_budgets_.end() &&
+          used + bytes > std::max(budget->second, bytes)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  using Waiters = std::map<WeightedFairClock::Tag, const ResourceRequest*>;
+
+  // A waiter which fits goes ahead of the later ones, so the queries of the classes with
+  // the larger weights don't wait behind the backlog of the others, and a waiter which
+  // doesn't fit doesn't hold back the ones which do.
+  bool isFirstFittingWaiter(const Waiters::const_iterator waiter_it) const {
+    for (auto it = waiters_.begin(); it != waiter_it; ++it) {
+      if (fits(*it->second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void release(const ResourceRequest& granted) {
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      available_cpu_slots_ += granted.cpu_slots;
+      CHECK_LE(available_cpu_slots_, total_cpu_slots_);
+      for (const auto gpu_id : granted.gpu_ids) {
+        CHECK_EQ(busy_gpus_.erase(gpu_id), size_t(1));
+      }
+      CHECK_GE(used_cpu_memory_, granted.cpu_memory_bytes);
+      used_cpu_memory_ -= granted.cpu_memory_bytes;
+      for (const auto& [device_id, bytes] : granted.gpu_memory_bytes) {
+        CHECK_GE(used_gpu_memory_[device_id], bytes);
+        used_gpu_memory_[device_id] -= bytes;
+      }
+    }
+    cv_.notify_all();
+  }
+
+  const size_t total_cpu_slots_;
+  size_t available_cpu_slots_;
+  std::set<int> busy_gpus_;
+
+  bool memory_budgets_set_{false};
+  size_t cpu_memory_budget_{0};
+  std::map<int, size_t> gpu_memory_budgets_;
+  size_t used_cpu_memory_{0};
+  std::map<int, size_t> used_gpu_memory_;
+
+  WeightedFairClock fair_clock_;
+  Waiters waiters_;
+
+  mutable std::mutex pool_mutex_;
+  std::condition_variable cv_;
+};
@@ -410,6 +410,10 @@ double distance_ring_ring(int8_t* ring1,
 // chance of error. No intersections means P is outside, irrespective of main probe's
 // result.
 //
+// Most edges of a large polygon are far from P and its rays: their bounding boxes alone
+// tell that P isn't on them and that they don't cross a ray, without the distance and
+// orientation tests.
+//
 DEVICE
 bool polygon_contains_point(int8_t* poly,
                             int32_t poly_num_coords,
@@ -422,6 +426,8 @@ bool polygon_contains_point(int8_t* poly,
   int xray_touch = 0;
   bool horizontal_edge = false;
   bool yray_intersects = false;
+  // Well above the tolerances and the rounding errors of the distances around P
+  const double far_distance = 1e-6 * (1.0 + fabs(px) + fabs(py));
 
   double e1x = coord_x(poly, poly_num_coords - 2, ic1, isr1, osr);
   double e1y = coord_y(poly, poly_num_coords - 1, ic1, isr1, osr);
@@ -429,8 +435,14 @@ bool polygon_contains_point(int8_t* poly,
     double e2x = coord_x(poly, i, ic1, isr1, osr);
     double e2y = coord_y(poly, i + 1, ic1, isr1, osr);
 
+    // How far P is left or right of the edge's box, and below or above it, negative
+    // within
+    double edge_dx = fmax(fmin(e1x, e2x) - px, px - fmax(e1x, e2x));
+    double edge_dy = fmax(fmin(e1y, e2y) - py, py - fmax(e1y, e2y));
+
     // Check if point sits on an edge.
-    if (tol_zero(distance_point_line(px, py, e1x, e1y, e2x, e2y))) {
+    if (edge_dx <= far_distance && edge_dy <= far_distance &&
+        tol_zero(distance_point_line(px, py, e1x, e1y, e2x, e2y))) {
       return true;
     }
 
@@ -446,8 +458,13 @@ bool polygon_contains_point(int8_t* poly,
     // Main probe: xray
     // Overshoot the xray to detect an intersection if there is one.
     double xray = fmax(e2x, e1x) + 1.0;
+    // An edge whose ends are both above or both below the xray, beyond the tolerance of
+    // the orientations, doesn't cross it
+    bool xray_misses_edge =
+        edge_dy > far_distance && (xray - px) * edge_dy > TOLERANCE_DEFAULT;
     if (px <= xray &&        // Only check for intersection if the edge is on the right
         !horizontal_edge &&  // Keep moving through horizontal edges
+        !xray_misses_edge &&
         line_intersects_line(px,  // xray shooting from point p to the right
                              py,
                              xray,
@@ -500,7 +517,11 @@ bool polygon_contains_point(int8_t* poly,
     // outside.
     if (!yray_intersects) {  // Continue checking on yray until intersection is found
       double yray = fmin(e2y, e1y) - 1.0;
-      if (yray <= py) {  // Only check for yray intersection if point P is above the edge
+      // The same for the ends left or right of the yray
+      bool yray_misses_edge =
+          edge_dx > far_distance && (py - yray) * edge_dx > TOLERANCE_DEFAULT;
+      if (yray <= py &&  // Only check for yray intersection if point P is above the edge
+          !yray_misses_edge) {
         yray_intersects = line_intersects_line(px,  // yray shooting from point P down
                                                py,
                                                px,
@@ -556,6 +577,145 @@ bool polygon_contains_linestring(int8_t* poly,
   return true;
 }
 
+// Returns true if simple polygon (no holes) contains a closed ring, including the edge
+// from the last point of the ring back to the first
+DEVICE ALWAYS_INLINE bool polygon_contains_ring(int8_t* poly,
+                                                int32_t poly_num_coords,
+                                                int8_t* ring,
+                                                int32_t ring_num_coords,
+                                                int32_t ic1,
+                                                int32_t isr1,
+                                                int32_t ic2,
+                                                int32_t isr2,
+                                                int32_t osr) {
+  if (!polygon_contains_linestring(
+          poly, poly_num_coords, ring, ring_num_coords, ic1, isr1, ic2, isr2, osr)) {
+    return false;
+  }
+  double r1x = coord_x(ring, ring_num_coords - 2, ic2, isr2, osr);
+  double r1y = coord_y(ring, ring_num_coords - 1, ic2, isr2, osr);
+  double r2x = coord_x(ring, 0, ic2, isr2, osr);
+  double r2y = coord_y(ring, 1, ic2, isr2, osr);
+  return !ring_intersects_line(poly, poly_num_coords, r1x, r1y, r2x, r2y, ic1, isr1, osr);
+}
+
+// Returns true if a linestring, or a closed ring, has a point inside a hole of a polygon
+// or meets one of the edges of the hole
+DEVICE ALWAYS_INLINE bool linestring_meets_hole(int8_t* hole,
+                                                int32_t hole_num_coords,
+                                                int8_t* l,
+                                                int64_t lnum_coords,
+                                                bool closed,
+                                                int32_t ic1,
+                                                int32_t isr1,
+                                                int32_t ic2,
+                                                int32_t isr2,
+                                                int32_t osr) {
+  double l1x = coord_x(l, 0, ic2, isr2, osr);
+  double l1y = coord_y(l, 1, ic2, isr2, osr);
+  if (polygon_contains_point(hole, hole_num_coords, l1x, l1y, ic1, isr1, osr)) {
+    return true;
+  }
+  for (int64_t i = 2; i < lnum_coords; i += 2) {
+    double l2x = coord_x(l, i, ic2, isr2, osr);
+    double l2y = coord_y(l, i + 1, ic2, isr2, osr);
+    if (ring_intersects_line(hole, hole_num_coords, l1x, l1y, l2x, l2y, ic1, isr1, osr)) {
+      return true;
+    }
+    l1x = l2x;
+    l1y = l2y;
+  }
+  if (closed) {
+    double l2x = coord_x(l, 0, ic2, isr2, osr);
+    double l2y = coord_y(l, 1, ic2, isr2, osr);
+    return ring_intersects_line(
+        hole, hole_num_coords, l1x, l1y, l2x, l2y, ic1, isr1, osr);
+  }
+  return false;
+}
+
+// Returns true if polygon poly1 contains polygon poly2, both possibly with holes: the
+// exterior ring of poly2 is in the exterior ring of poly1 and out of its holes, and the
+// holes of poly1 are out of poly2 or in one of the holes of poly2
+DEVICE
+bool polygon_contains_polygon(int8_t* poly1,
+                              int32_t* poly1_ring_sizes,
+                              int64_t poly1_num_rings,
+                              int32_t poly1_num_coords,
+                              int8_t* poly2,
+                              int32_t* poly2_ring_sizes,
+                              int64_t poly2_num_rings,
+                              int32_t poly2_num_coords,
+                              int32_t ic1,
+                              int32_t isr1,
+                              int32_t ic2,
+                              int32_t isr2,
+                              int32_t osr) {
+  auto poly1_exterior_ring_num_coords = poly1_num_coords;
+  if (poly1_num_rings > 0) {
+    poly1_exterior_ring_num_coords = poly1_ring_sizes[0] * 2;
+  }
+  auto poly2_exterior_ring_num_coords = poly2_num_coords;
+  if (poly2_num_rings > 0) {
+    poly2_exterior_ring_num_coords = poly2_ring_sizes[0] * 2;
+  }
+  if (!polygon_contains_ring(poly1,
+                             poly1_exterior_ring_num_coords,
+                             poly2,
+                             poly2_exterior_ring_num_coords,
+                             ic1,
+                             isr1,
+                             ic2,
+                             isr2,
+                             osr)) {
+    return false;
+  }
+
+  auto hole1 = poly1 + poly1_exterior_ring_num_coords * compression_unit_size(ic1);
+  for (auto r1 = 1; r1 < poly1_num_rings; r1++) {
+    int32_t hole1_num_coords = poly1_ring_sizes[r1] * 2;
+    if (linestring_meets_hole(hole1,
+                              hole1_num_coords,
+                              poly2,
+                              poly2_exterior_ring_num_coords,
+                              true,
+                              ic1,
+                              isr1,
+                              ic2,
+                              isr2,
+                              osr)) {
+      return false;
+    }
+    // The exterior ring of poly2 doesn't meet the hole, the hole is either out of poly2
+    // or within its exterior ring
+    double hx = coord_x(hole1, 0, ic1, isr1, osr);
+    double hy = coord_y(hole1, 1, ic1, isr1, osr);
+    if (polygon_contains_point(
+            poly2, poly2_exterior_ring_num_coords, hx, hy, ic2, isr2, osr)) {
+      bool in_hole2 = false;
+      auto hole2 = poly2 + poly2_exterior_ring_num_coords * compression_unit_size(ic2);
+      for (auto r2 = 1; r2 < poly2_num_rings && !in_hole2; r2++) {
+        int32_t hole2_num_coords = poly2_ring_sizes[r2] * 2;
+        in_hole2 = polygon_contains_ring(hole2,
+                                         hole2_num_coords,
+                                         hole1,
+                                         hole1_num_coords,
+                                         ic2,
+                                         isr2,
+                                         ic1,
+                                         isr1,
+                                         osr);
+        hole2 += hole2_num_coords * compression_unit_size(ic2);
+      }
+      if (!in_hole2) {
+        return false;
+      }
+    }
+    hole1 += hole1_num_coords * compression_unit_size(ic1);
+  }
+  return true;
+}
+
 DEVICE ALWAYS_INLINE bool box_contains_point(double* bounds,
                                              int64_t bounds_size,
                                              double px,
@@ -571,6 +731,19 @@ EXTENSION_NOINLINE bool Point_Overlaps_Box(double* bounds,
   return box_contains_point(bounds, bounds_size, px, py);
 }
 
+// Point of a GEOINT32 compressed column in a box compressed the same way, outwards,
+// compared without decompressing the coordinates
+EXTENSION_NOINLINE bool Point_Overlaps_Compressed_Box(int8_t* p,
+                                                      int64_t psize,
+                                                      int32_t xmin,
+                                                      int32_t ymin,
+                                                      int32_t xmax,
+                                                      int32_t ymax) {
+  auto compressed_coords = reinterpret_cast<int32_t*>(p);
+  return compressed_coords[0] >= xmin && compressed_coords[1] >= ymin &&
+         compressed_coords[0] <= xmax && compressed_coords[1] <= ymax;
+}
+
 DEVICE ALWAYS_INLINE bool box_contains_box(double* bounds1,
                                            int64_t bounds1_size,
                                            double* bounds2,
@@ -2628,10 +2801,6 @@ bool ST_Contains_Polygon_LineString(int8_t* poly_coords,
                                     int32_t ic2,
                                     int32_t isr2,
                                     int32_t osr) {
-  if (poly_num_rings > 1) {
-    return false;  // TODO: support polygons with interior rings
-  }
-
   auto poly_num_coords = poly_coords_size / compression_unit_size(ic1);
   auto lnum_coords = lsize / compression_unit_size(ic2);
   auto lnum_points = lnum_coords / 2;
@@ -2640,15 +2809,19 @@ bool ST_Contains_Polygon_LineString(int8_t* poly_coords,
     if (li < 0 || li > lnum_points) {
       li = lnum_points;
     }
-    double lx = coord_x(l, 2 * (li - 1), ic2, isr2, osr);
-    double ly = coord_y(l, 2 * (li - 1) + 1, ic2, isr2, osr);
-
-    if (poly_bounds) {
-      if (!box_contains_point(poly_bounds, poly_bounds_size, lx, ly)) {
-        return false;
-      }
-    }
-    return polygon_contains_point(poly_coords, poly_num_coords, lx, ly, ic1, isr1, osr);
+    return ST_Contains_Polygon_Point(poly_coords,
+                                     poly_coords_size,
+                                     poly_ring_sizes,
+                                     poly_num_rings,
+                                     poly_bounds,
+                                     poly_bounds_size,
+                                     l + 2 * (li - 1) * compression_unit_size(ic2),
+                                     2 * compression_unit_size(ic2),
+                                     ic1,
+                                     isr1,
+                                     ic2,
+                                     isr2,
+                                     osr);
   }
 
   // Bail out if poly bounding box doesn't contain linestring bounding box
@@ -2658,8 +2831,33 @@ bool ST_Contains_Polygon_LineString(int8_t* poly_coords,
     }
   }
 
-  return polygon_contains_linestring(
-      poly_coords, poly_num_coords, l, lnum_coords, ic1, isr1, ic2, isr2, osr);
+  auto exterior_ring_num_coords = poly_num_coords;
+  if (poly_num_rings > 0) {
+    exterior_ring_num_coords = poly_ring_sizes[0] * 2;
+  }
+  if (!polygon_contains_linestring(poly_coords,
+                                   exterior_ring_num_coords,
+                                   l,
+                                   lnum_coords,
+                                   ic1,
+                                   isr1,
+                                   ic2,
+                                   isr2,
+                                   osr)) {
+    return false;
+  }
+
+  // Inside exterior ring, the linestring must not get into any of the holes
+  auto hole = poly_coords + exterior_ring_num_coords * compression_unit_size(ic1);
+  for (auto r = 1; r < poly_num_rings; r++) {
+    int32_t hole_num_coords = poly_ring_sizes[r] * 2;
+    if (linestring_meets_hole(
+            hole, hole_num_coords, l, lnum_coords, false, ic1, isr1, ic2, isr2, osr)) {
+      return false;
+    }
+    hole += hole_num_coords * compression_unit_size(ic1);
+  }
+  return true;
 }
 
 EXTENSION_NOINLINE
@@ -2680,12 +2878,6 @@ bool ST_Contains_Polygon_Polygon(int8_t* poly1_coords,
                                  int32_t ic2,
                                  int32_t isr2,
                                  int32_t osr) {
-  // TODO: needs to be extended, cover more cases
-  // Right now only checking if simple poly1 (no holes) contains poly2's exterior shape
-  if (poly1_num_rings > 1) {
-    return false;  // TODO: support polygons with interior rings
-  }
-
   if (poly1_bounds && poly2_bounds) {
     if (!box_contains_box(
             poly1_bounds, poly1_bounds_size, poly2_bounds, poly2_bounds_size)) {
@@ -2693,27 +2885,85 @@ bool ST_Contains_Polygon_Polygon(int8_t* poly1_coords,
     }
   }
 
-  int64_t poly2_exterior_ring_coords_size = poly2_coords_size;
-  if (poly2_num_rings > 0) {
-    poly2_exterior_ring_coords_size =
-        2 * poly2_ring_sizes[0] * compression_unit_size(ic2);
-  }
-  return ST_Contains_Polygon_LineString(poly1_coords,
-                                        poly1_coords_size,
-                                        poly1_ring_sizes,
-                                        poly1_num_rings,
-                                        poly1_bounds,
-                                        poly1_bounds_size,
-                                        poly2_coords,
-                                        poly2_exterior_ring_coords_size,
-                                        poly2_bounds,
-                                        poly2_bounds_size,
-                                        0,
-                                        ic1,
-                                        isr1,
-                                        ic2,
-                                        isr2,
-                                        osr);
+  return polygon_contains_polygon(poly1_coords,
+                                  poly1_ring_sizes,
+                                  poly1_num_rings,
+                                  poly1_coords_size / compression_unit_size(ic1),
+                                  poly2_coords,
+                                  poly2_ring_sizes,
+                                  poly2_num_rings,
+                                  poly2_coords_size / compression_unit_size(ic2),
+                                  ic1,
+                                  isr1,
+                                  ic2,
+                                  isr2,
+                                  osr);
+}
+
+EXTENSION_NOINLINE
+bool ST_Contains_Polygon_MultiPolygon(int8_t* poly_coords,
+                                      int64_t poly_coords_size,
+                                      int32_t* poly_ring_sizes,
+                                      int64_t poly_num_rings,
+                                      double* poly_bounds,
+                                      int64_t poly_bounds_size,
+                                      int8_t* mpoly_coords,
+                                      int64_t mpoly_coords_size,
+                                      int32_t* mpoly_ring_sizes,
+                                      int64_t mpoly_num_rings,
+                                      int32_t* mpoly_poly_sizes,
+                                      int64_t mpoly_num_polys,
+                                      double* mpoly_bounds,
+                                      int64_t mpoly_bounds_size,
+                                      int32_t ic1,
+                                      int32_t isr1,
+                                      int32_t ic2,
+                                      int32_t isr2,
+                                      int32_t osr) {
+  if (mpoly_num_polys <= 0) {
+    return false;
+  }
+
+  if (poly_bounds && mpoly_bounds) {
+    if (!box_contains_box(
+            poly_bounds, poly_bounds_size, mpoly_bounds, mpoly_bounds_size)) {
+      return false;
+    }
+  }
+
+  // Every polygon of the multipolygon has to be in the polygon
+  auto next_poly_coords = mpoly_coords;
+  auto next_poly_ring_sizes = mpoly_ring_sizes;
+
+  for (auto poly = 0; poly < mpoly_num_polys; poly++) {
+    auto mpoly_poly_coords = next_poly_coords;
+    auto mpoly_poly_ring_sizes = next_poly_ring_sizes;
+    auto mpoly_poly_num_rings = mpoly_poly_sizes[poly];
+    // Count number of coords in all of poly's rings, advance ring size pointer.
+    int32_t mpoly_poly_num_coords = 0;
+    for (auto ring = 0; ring < mpoly_poly_num_rings; ring++) {
+      mpoly_poly_num_coords += 2 * *next_poly_ring_sizes++;
+    }
+    next_poly_coords += mpoly_poly_num_coords * compression_unit_size(ic2);
+
+    if (!polygon_contains_polygon(poly_coords,
+                                  poly_ring_sizes,
+                                  poly_num_rings,
+                                  poly_coords_size / compression_unit_size(ic1),
+                                  mpoly_poly_coords,
+                                  mpoly_poly_ring_sizes,
+                                  mpoly_poly_num_rings,
+                                  mpoly_poly_num_coords,
+                                  ic1,
+                                  isr1,
+                                  ic2,
+                                  isr2,
+                                  osr)) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 EXTENSION_NOINLINE
@@ -2885,6 +3135,150 @@ bool ST_Contains_MultiPolygon_LineString(int8_t* mpoly_coords,
   return false;
 }
 
+// A polygon is taken as contained by a multipolygon if one of the polygons of the latter
+// contains it. A polygon across the shared edge of two polygons of the multipolygon
+// isn't found contained.
+EXTENSION_NOINLINE
+bool ST_Contains_MultiPolygon_Polygon(int8_t* mpoly_coords,
+                                      int64_t mpoly_coords_size,
+                                      int32_t* mpoly_ring_sizes,
+                                      int64_t mpoly_num_rings,
+                                      int32_t* mpoly_poly_sizes,
+                                      int64_t mpoly_num_polys,
+                                      double* mpoly_bounds,
+                                      int64_t mpoly_bounds_size,
+                                      int8_t* poly_coords,
+                                      int64_t poly_coords_size,
+                                      int32_t* poly_ring_sizes,
+                                      int64_t poly_num_rings,
+                                      double* poly_bounds,
+                                      int64_t poly_bounds_size,
+                                      int32_t ic1,
+                                      int32_t isr1,
+                                      int32_t ic2,
+                                      int32_t isr2,
+                                      int32_t osr) {
+  if (mpoly_num_polys <= 0) {
+    return false;
+  }
+
+  if (mpoly_bounds && poly_bounds) {
+    if (!box_contains_box(
+            mpoly_bounds, mpoly_bounds_size, poly_bounds, poly_bounds_size)) {
+      return false;
+    }
+  }
+
+  // Set specific poly pointers as we move through the coords/ringsizes/polyrings arrays.
+  auto next_poly_coords = mpoly_coords;
+  auto next_poly_ring_sizes = mpoly_ring_sizes;
+
+  for (auto poly = 0; poly < mpoly_num_polys; poly++) {
+    auto mpoly_poly_coords = next_poly_coords;
+    auto mpoly_poly_ring_sizes = next_poly_ring_sizes;
+    auto mpoly_poly_num_rings = mpoly_poly_sizes[poly];
+    // Count number of coords in all of poly's rings, advance ring size pointer.
+    int32_t mpoly_poly_num_coords = 0;
+    for (auto ring = 0; ring < mpoly_poly_num_rings; ring++) {
+      mpoly_poly_num_coords += 2 * *next_poly_ring_sizes++;
+    }
+    next_poly_coords += mpoly_poly_num_coords * compression_unit_size(ic1);
+
+    if (polygon_contains_polygon(mpoly_poly_coords,
+                                 mpoly_poly_ring_sizes,
+                                 mpoly_poly_num_rings,
+                                 mpoly_poly_num_coords,
+                                 poly_coords,
+                                 poly_ring_sizes,
+                                 poly_num_rings,
+                                 poly_coords_size / compression_unit_size(ic2),
+                                 ic1,
+                                 isr1,
+                                 ic2,
+                                 isr2,
+                                 osr)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+EXTENSION_NOINLINE
+bool ST_Contains_MultiPolygon_MultiPolygon(int8_t* mpoly1_coords,
+                                           int64_t mpoly1_coords_size,
+                                           int32_t* mpoly1_ring_sizes,
+                                           int64_t mpoly1_num_rings,
+                                           int32_t* mpoly1_poly_sizes,
+                                           int64_t mpoly1_num_polys,
+                                           double* mpoly1_bounds,
+                                           int64_t mpoly1_bounds_size,
+                                           int8_t* mpoly2_coords,
+                                           int64_t mpoly2_coords_size,
+                                           int32_t* mpoly2_ring_sizes,
+                                           int64_t mpoly2_num_rings,
+                                           int32_t* mpoly2_poly_sizes,
+                                           int64_t mpoly2_num_polys,
+                                           double* mpoly2_bounds,
+                                           int64_t mpoly2_bounds_size,
+                                           int32_t ic1,
+                                           int32_t isr1,
+                                           int32_t ic2,
+                                           int32_t isr2,
+                                           int32_t osr) {
+  if (mpoly1_num_polys <= 0 || mpoly2_num_polys <= 0) {
+    return false;
+  }
+
+  if (mpoly1_bounds && mpoly2_bounds) {
+    if (!box_contains_box(
+            mpoly1_bounds, mpoly1_bounds_size, mpoly2_bounds, mpoly2_bounds_size)) {
+      return false;
+    }
+  }
+
+  // Every polygon of mpoly2 has to be in one of the polygons of mpoly1
+  auto next_poly_coords = mpoly2_coords;
+  auto next_poly_ring_sizes = mpoly2_ring_sizes;
+
+  for (auto poly = 0; poly < mpoly2_num_polys; poly++) {
+    auto poly_coords = next_poly_coords;
+    auto poly_ring_sizes = next_poly_ring_sizes;
+    auto poly_num_rings = mpoly2_poly_sizes[poly];
+    // Count number of coords in all of poly's rings, advance ring size pointer.
+    int32_t poly_num_coords = 0;
+    for (auto ring = 0; ring < poly_num_rings; ring++) {
+      poly_num_coords += 2 * *next_poly_ring_sizes++;
+    }
+    auto poly_coords_size = poly_num_coords * compression_unit_size(ic2);
+    next_poly_coords += poly_coords_size;
+
+    if (!ST_Contains_MultiPolygon_Polygon(mpoly1_coords,
+                                          mpoly1_coords_size,
+                                          mpoly1_ring_sizes,
+                                          mpoly1_num_rings,
+                                          mpoly1_poly_sizes,
+                                          mpoly1_num_polys,
+                                          nullptr,
+                                          0,
+                                          poly_coords,
+                                          poly_coords_size,
+                                          poly_ring_sizes,
+                                          poly_num_rings,
+                                          nullptr,
+                                          0,
+                                          ic1,
+                                          isr1,
+                                          ic2,
+                                          isr2,
+                                          osr)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 //
 // ST_Intersects
 //
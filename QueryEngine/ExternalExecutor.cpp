@@ -399,8 +399,6 @@ void SqliteMemDatabase::run(const std::string& sql) {
   CHECK_EQ(status, SQLITE_OK);
 }
 
-namespace {
-
 int64_t* get_scan_output_slot(int64_t* output_buffer,
                               const size_t output_buffer_entry_count,
                               const size_t pos,
@@ -411,8 +409,6 @@ int64_t* get_scan_output_slot(int64_t* output_buffer,
   return output_buffer + off + 1;
 }
 
-}  // namespace
-
 std::unique_ptr<ResultSet> SqliteMemDatabase::runSelect(
     const std::string& sql,
     const ExternalQueryOutputSpec& output_spec) {
@@ -67,3 +67,10 @@ std::unique_ptr<ResultSet> run_query_external(const ExecutionUnitSql& sql,
                                               const ExternalQueryOutputSpec& output_spec);
 
 bool is_supported_type_for_extern_execution(const SQLTypeInfo& ti);
+
+// Writes the offset of the row at pos of a row-wise projection output and returns its
+// first target slot
+int64_t* get_scan_output_slot(int64_t* output_buffer,
+                              const size_t output_buffer_entry_count,
+                              const size_t pos,
+                              const size_t row_size_quad);
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/FragmentResultCache.h"
+
+#include "Analyzer/Analyzer.h"
+#include "Catalog/Catalog.h"
+#include "Fragmenter/Fragmenter.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/Descriptors/QueryMemoryDescriptor.h"
+#include "QueryEngine/ResultSet.h"
+
+bool g_enable_fragment_result_cache{false};
+size_t g_fragment_result_cache_bytes{268435456};  // 256MB
+
+namespace {
+
+// the string ids of the transient dictionaries are given by each query, they don't mean
+// the same strings for the next one
+bool is_transient_string(const Analyzer::Expr* expr) {
+  const auto& ti = expr->get_type_info();
+  return ti.is_string() && ti.get_compression() == kENCODING_DICT &&
+         ti.get_comp_param() == TRANSIENT_DICT_ID;
+}
+
+}  // namespace
+
+FragmentResultCache& FragmentResultCache::instance() {
+  static FragmentResultCache cache;
+  return cache;
+}
+
+std::optional<std::string> FragmentResultCache::getUnitKey(
+    const Catalog_Namespace::Catalog& cat,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor& query_mem_desc) {
+  const auto query_desc_type = query_mem_desc.getQueryDescriptionType();
+  if (query_desc_type != QueryDescriptionType::GroupByPerfectHash &&
+      query_desc_type != QueryDescriptionType::GroupByBaselineHash &&
+      query_desc_type != QueryDescriptionType::NonGroupedAggregate) {
+    return std::nullopt;
+  }
+  if (ra_exe_unit.input_descs.size() != 1 || ra_exe_unit.union_all ||
+      ra_exe_unit.estimator || !ra_exe_unit.join_quals.empty()) {
+    return std::nullopt;
+  }
+  const auto& input_desc = ra_exe_unit.input_descs.front();
+  if (input_desc.getSourceType() != InputSourceType::TABLE ||
+      input_desc.getTableId() <= 0) {
+    return std::nullopt;
+  }
+  const auto td =
+      cat.getMetadataForTable(input_desc.getTableId(), /*populateFragmenter=*/false);
+  if (!td || td->storageType == StorageType::FOREIGN_TABLE) {
+    return std::nullopt;
+  }
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    if (groupby_expr && is_transient_string(groupby_expr.get())) {
+      return std::nullopt;
+    }
+  }
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    if (is_transient_string(target_expr)) {
+      return std::nullopt;
+    }
+  }
+  return std::to_string(cat.getCurrentDB().dbId) + ":" +
+         ra_exec_unit_desc_for_caching(ra_exe_unit) + ":" + query_mem_desc.toString();
+}
+
+std::string FragmentResultCache::getKey(
+    const std::string& unit_key,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::optional<FragmentRowRange>& outer_row_range) {
+  auto key = unit_key + ":" + std::to_string(fragment.physicalTableId) + ":" +
+             std::to_string(fragment.fragmentId);
+  if (outer_row_range) {
+    key += ":" + std::to_string(outer_row_range->first) + "-" +
+           std::to_string(outer_row_range->second);
+  }
+  return key;
+}
+
+ResultSetPtr FragmentResultCache::get(const std::string& key,
+                                      const Fragmenter_Namespace::FragmentInfo& fragment,
+                                      const Executor* executor) {
+  ResultSetPtr cached_rows;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    if (it->second->num_tuples != fragment.getPhysicalNumTuples() ||
+        it->second->contents_version != fragment.contentsVersion) {
+      VLOG(1) << "Invalidate the cached result of fragment " << fragment.fragmentId
+              << ", its rows have changed";
+      erase(it->second);
+      ++stats_.misses;
+      return nullptr;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.end(), entries_, it->second);
+    cached_rows = entries_.back().rows;
+  }
+  // the reduction writes to the first result, every hit gets rows of its own
+  auto rows = cached_rows->copy(executor);
+  CHECK(rows);
+  return rows;
+}
+
+void FragmentResultCache::put(const std::string& key,
+                              const Fragmenter_Namespace::FragmentInfo& fragment,
+                              const ResultSet& rows,
+                              const Executor* executor) {
+  if (!rows.getStorage() ||
+      rows.getBufferSizeBytes(rows.getDeviceType()) > g_fragment_result_cache_bytes) {
+    return;
+  }
+  auto rows_copy = rows.copy(executor);
+  if (!rows_copy) {
+    return;
+  }
+  const auto bytes = rows_copy->getBufferSizeBytes(rows_copy->getDeviceType());
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = index_.find(key);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+  while (!entries_.empty() && stats_.bytes + bytes > g_fragment_result_cache_bytes) {
+    VLOG(1) << "Evicting a cached fragment result of " << entries_.front().bytes
+            << " bytes";
+    ++stats_.evictions;
+    erase(entries_.begin());
+  }
+  entries_.push_back({key,
+                      fragment.getPhysicalNumTuples(),
+                      fragment.contentsVersion,
+                      std::move(rows_copy),
+                      bytes});
+  index_.emplace(key, std::prev(entries_.end()));
+  stats_.bytes += bytes;
+}
+
+void FragmentResultCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  VLOG(1) << "Invalidate " << entries_.size() << " cached fragment results, "
+          << stats_.hits << " hits, " << stats_.misses << " misses, "
+          << stats_.evictions << " evictions";
+  index_.clear();
+  entries_.clear();
+  stats_.bytes = 0;
+}
+
+size_t FragmentResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+FragmentResultCache::Stats FragmentResultCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void FragmentResultCache::erase(const EntryList::iterator it) {
+  stats_.bytes -= it->bytes;
+  index_.erase(it->key);
+  entries_.erase(it);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    FragmentResultCache.h
+ * @brief   Byte bounded LRU cache of the aggregates of the fragments of the tables
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "QueryEngine/Descriptors/QueryFragmentDescriptor.h"
+#include "QueryEngine/RelAlgExecutionUnit.h"
+
+extern bool g_enable_fragment_result_cache;
+extern size_t g_fragment_result_cache_bytes;
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+class Executor;
+class QueryMemoryDescriptor;
+
+/**
+ * Keeps the results of the CPU kernels of the aggregates over a single table, by the
+ * execution unit, the layout of the output buffer and the fragment the kernel ran on. The
+ * tables the dashboards refresh are mostly appended to: a query which runs again only
+ * runs the kernels of the fragments added since and of the last fragment, which took in
+ * the new rows, and reduces their results with copies of the cached ones. An entry is
+ * only returned while its fragment has the number of tuples and the contents version it
+ * had when the kernel ran, the updates and deletes giving the fragments of the table a
+ * new contents version. The least recently used entries are evicted once the rows take
+ * more than g_fragment_result_cache_bytes.
+ */
+class FragmentResultCache {
+ public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t bytes{0};
+  };
+
+  static FragmentResultCache& instance();
+
+  //! The part of the keys the kernels of ra_exe_unit share, none when their results
+  //! can't be cached, e.g. for joins, projections or foreign tables
+  static std::optional<std::string> getUnitKey(const Catalog_Namespace::Catalog& cat,
+                                               const RelAlgExecutionUnit& ra_exe_unit,
+                                               const QueryMemoryDescriptor& query_mem_desc);
+
+  //! The key of the kernel over fragment, or over the outer_row_range of its rows
+  static std::string getKey(const std::string& unit_key,
+                            const Fragmenter_Namespace::FragmentInfo& fragment,
+                            const std::optional<FragmentRowRange>& outer_row_range);
+
+  //! A copy of the rows of the kernel, null unless fragment is as it was then
+  ResultSetPtr get(const std::string& key,
+                   const Fragmenter_Namespace::FragmentInfo& fragment,
+                   const Executor* executor);
+
+  void put(const std::string& key,
+           const Fragmenter_Namespace::FragmentInfo& fragment,
+           const ResultSet& rows,
+           const Executor* executor);
+
+  void clear();
+
+  size_t size() const;
+
+  Stats getStats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    size_t num_tuples;
+    uint64_t contents_version;
+    ResultSetPtr rows;
+    size_t bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(const EntryList::iterator it);
+
+  mutable std::mutex mutex_;
+  EntryList entries_;  // from the least to the most recently used
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  Stats stats_;
+};
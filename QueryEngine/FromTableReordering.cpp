@@ -240,14 +240,21 @@ std::vector<node_t> traverse_join_cost_graph(
 std::vector<node_t> get_node_input_permutation(
     const JoinQualsPerNestingLevel& left_deep_join_quals,
     const std::vector<InputTableInfo>& table_infos,
-    const Executor* executor) {
+    const Executor* executor,
+    const std::vector<size_t>& filtered_table_sizes) {
   const auto join_cost_graph =
       build_join_cost_graph(left_deep_join_quals, table_infos, executor);
+  CHECK(filtered_table_sizes.empty() ||
+        filtered_table_sizes.size() == table_infos.size());
+  const auto table_size = [&table_infos, &filtered_table_sizes](const node_t nest_level) {
+    return filtered_table_sizes.empty()
+               ? table_infos[nest_level].info.getNumTuplesUpperBound()
+               : filtered_table_sizes[nest_level];
+  };
   // Use the number of tuples in each table to break ties in BFS.
-  const auto compare_node = [&table_infos](const node_t lhs_nest_level,
-                                           const node_t rhs_nest_level) {
-    return table_infos[lhs_nest_level].info.getNumTuplesUpperBound() <
-           table_infos[rhs_nest_level].info.getNumTuplesUpperBound();
+  const auto compare_node = [&table_size](const node_t lhs_nest_level,
+                                          const node_t rhs_nest_level) {
+    return table_size(lhs_nest_level) < table_size(rhs_nest_level);
   };
   const auto compare_edge = [&compare_node](const TraversalEdge& lhs_edge,
                                             const TraversalEdge& rhs_edge) {
@@ -19,8 +19,11 @@
 #include "InputMetadata.h"
 #include "RelAlgExecutionUnit.h"
 
-// Returns a FROM permutation for the given join qualifiers and table sizes.
+// Returns a FROM permutation for the given join qualifiers and table sizes. The row
+// counts of the tables after their filters, by nest level, replace the sizes of the
+// tables if given.
 std::vector<size_t> get_node_input_permutation(
     const JoinQualsPerNestingLevel& left_deep_join_quals,
     const std::vector<InputTableInfo>& table_infos,
-    const Executor* executor);
+    const Executor* executor,
+    const std::vector<size_t>& filtered_table_sizes = {});
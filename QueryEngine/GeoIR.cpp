@@ -148,7 +148,8 @@ std::vector<llvm::Value*> CodeGenerator::codegenGeoBinOper(
     // Append geo expr compression
     arg1_list.insert(arg1_list.end(),
                      cgen_state_->llInt(geo_expr->getTypeInfo1().get_output_srid()));
-  } else if (geo_expr->getOp() == Geo_namespace::GeoBase::GeoOp::kBUFFER) {
+  } else if (geo_expr->getOp() == Geo_namespace::GeoBase::GeoOp::kBUFFER ||
+             geo_expr->getOp() == Geo_namespace::GeoBase::GeoOp::kSIMPLIFY) {
     // Extra argument in this case is double
     func += "_double"s;
   } else {
@@ -364,6 +364,9 @@ extern "C" bool Geos_Wkb_double(int op,
     if (static_cast<GeoBase::GeoOp>(op) == GeoBase::GeoOp::kBUFFER) {
       int quadsegs = 8;  // default
       g = GEOSBuffer_r(context, g1, arg2, quadsegs);
+    } else if (static_cast<GeoBase::GeoOp>(op) == GeoBase::GeoOp::kSIMPLIFY) {
+      // keeps the rings valid, unlike plain Douglas-Peucker
+      g = GEOSTopologyPreserveSimplify_r(context, g1, arg2);
     }
     if (g) {
       size_t wkb_size = 0ULL;
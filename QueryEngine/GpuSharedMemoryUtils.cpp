@@ -15,6 +15,8 @@
  */
 
 #include "GpuSharedMemoryUtils.h"
+#include "GpuRtConstants.h"
+#include "ResultSetBufferAccessors.h"
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 
@@ -23,43 +25,63 @@ GpuSharedMemCodeBuilder::GpuSharedMemCodeBuilder(
     llvm::LLVMContext& context,
     const QueryMemoryDescriptor& qmd,
     const std::vector<TargetInfo>& targets,
-    const std::vector<int64_t>& init_agg_values)
+    const std::vector<int64_t>& init_agg_values,
+    const size_t smem_entry_count)
     : module_(module)
     , context_(context)
     , reduction_func_(nullptr)
     , init_func_(nullptr)
     , query_mem_desc_(qmd)
     , targets_(targets)
-    , init_agg_values_(init_agg_values) {
+    , init_agg_values_(init_agg_values)
+    , smem_entry_count_(smem_entry_count) {
   /**
    * This class currently works only with:
    * 1. row-wise output memory layout
-   * 2. GroupByPerfectHash
-   * 3. single-column group by
-   * 4. Keyless hash strategy (no redundant group column in the output buffer)
+   * 2. GroupByPerfectHash or GroupByBaselineHash
+   * 3. single-column group by, for GroupByPerfectHash
+   * 4. Keyless hash strategy (no redundant group column in the output buffer), for
+   * GroupByPerfectHash
    *
    * All conditions in 1, 3, and 4 can be easily relaxed if proper code is added to
    * support them in the future.
    */
   CHECK(!query_mem_desc_.didOutputColumnar());
-  CHECK(query_mem_desc_.getQueryDescriptionType() ==
-        QueryDescriptionType::GroupByPerfectHash);
-  CHECK(query_mem_desc_.hasKeylessHash());
+  CHECK_GT(smem_entry_count_, size_t(0));
+  if (query_mem_desc_.getQueryDescriptionType() ==
+      QueryDescriptionType::GroupByPerfectHash) {
+    CHECK(query_mem_desc_.hasKeylessHash());
+    CHECK_EQ(smem_entry_count_, query_mem_desc_.getEntryCount());
+  } else {
+    CHECK(query_mem_desc_.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash);
+    CHECK_LE(smem_entry_count_, query_mem_desc_.getEntryCount());
+  }
 }
 
 void GpuSharedMemCodeBuilder::codegen() {
   auto timer = DEBUG_TIMER(__func__);
+  const bool is_baseline = query_mem_desc_.getQueryDescriptionType() ==
+                           QueryDescriptionType::GroupByBaselineHash;
 
   // codegen the init function
   init_func_ = createInitFunction();
   CHECK(init_func_);
-  codegenInitialization();
+  if (is_baseline) {
+    codegenBaselineInitialization();
+  } else {
+    codegenInitialization();
+  }
   verify_function_ir(init_func_);
 
   // codegen the reduction function:
   reduction_func_ = createReductionFunction();
   CHECK(reduction_func_);
-  codegenReduction();
+  if (is_baseline) {
+    codegenBaselineReduction();
+  } else {
+    codegenReduction();
+  }
   verify_function_ir(reduction_func_);
 }
 
@@ -70,10 +92,10 @@ void GpuSharedMemCodeBuilder::codegen() {
  * major differences that will be discussed below:
  *
  * The general procedure is as follows:
- * 1. the function takes three arguments: 1) dest_buffer_ptr which points to global memory
+ * 1. the function takes four arguments: 1) dest_buffer_ptr which points to global memory
  * group by buffer (what existed before), 2) src_buffer_ptr which points to the shared
  * memory group by buffer, exclusively accessed by each specific GPU thread-block, 3)
- * total buffer size.
+ * total buffer size, 4) the error codes of the threads (unused for perfect hash).
  * 2. We assign each thread to a specific entry (all targets within that entry), so any
  * thread with an index larger than max entries, will have an early return from this
  * function
@@ -131,6 +153,31 @@ void GpuSharedMemCodeBuilder::codegenReduction() {
   const auto dest_byte_stream = ir_builder.CreatePointerCast(
       dest_buffer_ptr, llvm::Type::getInt8PtrTy(context_, 0), "dest_byte_stream");
 
+  linkReductionCode();
+  const auto reduce_one_entry_idx_func = getFunction("reduce_one_entry_idx");
+  CHECK(reduce_one_entry_idx_func);
+
+  // qmd_handles are only used with count distinct and baseline group by
+  // serialized varlen buffer is only used with SAMPLE on varlen types, which we will
+  // disable for current shared memory support.
+  const auto null_ptr_ll =
+      llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(context_, 0));
+  const auto thread_idx_i32 = ir_builder.CreateCast(
+      llvm::Instruction::CastOps::Trunc, thread_idx, get_int_type(32, context_));
+  ir_builder.CreateCall(reduce_one_entry_idx_func,
+                        {dest_byte_stream,
+                         src_byte_stream,
+                         thread_idx_i32,
+                         entry_count_i32,
+                         null_ptr_ll,
+                         null_ptr_ll,
+                         null_ptr_ll},
+                        "");
+  ir_builder.CreateBr(bb_exit);
+  llvm::ReturnInst::Create(context_, bb_exit);
+}
+
+void GpuSharedMemCodeBuilder::linkReductionCode() {
   // running the result set reduction JIT code to get reduce_one_entry_idx function
   auto rs_reduction_jit = std::make_unique<GpuReductionHelperJIT>(
       ResultSet::fixupQueryMemoryDescriptor(query_mem_desc_),
@@ -179,27 +226,6 @@ void GpuSharedMemCodeBuilder::codegenReduction() {
       }
     }
   }
-  const auto reduce_one_entry_idx_func = getFunction("reduce_one_entry_idx");
-  CHECK(reduce_one_entry_idx_func);
-
-  // qmd_handles are only used with count distinct and baseline group by
-  // serialized varlen buffer is only used with SAMPLE on varlen types, which we will
-  // disable for current shared memory support.
-  const auto null_ptr_ll =
-      llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(context_, 0));
-  const auto thread_idx_i32 = ir_builder.CreateCast(
-      llvm::Instruction::CastOps::Trunc, thread_idx, get_int_type(32, context_));
-  ir_builder.CreateCall(reduce_one_entry_idx_func,
-                        {dest_byte_stream,
-                         src_byte_stream,
-                         thread_idx_i32,
-                         entry_count_i32,
-                         null_ptr_ll,
-                         null_ptr_ll,
-                         null_ptr_ll},
-                        "");
-  ir_builder.CreateBr(bb_exit);
-  llvm::ReturnInst::Create(context_, bb_exit);
 }
 
 namespace {
@@ -324,11 +350,258 @@ void GpuSharedMemCodeBuilder::codegenInitialization() {
   ir_builder.CreateRet(shared_mem_buffer);
 }
 
+/**
+ * This function generates code to initialize the baseline hash table of the block in the
+ * shared memory, smem_entry_count_ entries with the layout of the output buffer. The
+ * threads of the block loop over the entries with a stride of the block size, setting
+ * all the key components of an entry to the empty key and its slots to the aggregate
+ * init values. Unlike perfect hash, the function returns the global memory buffer it's
+ * given: the row function looks up the table of the block through the dynamic shared
+ * memory itself and falls back to the global memory buffer once the table is full.
+ */
+void GpuSharedMemCodeBuilder::codegenBaselineInitialization() {
+  CHECK(init_func_);
+  auto fixup_query_mem_desc = ResultSet::fixupQueryMemoryDescriptor(query_mem_desc_);
+  CHECK(!fixup_query_mem_desc.didOutputColumnar());
+  CHECK(!fixup_query_mem_desc.hasKeylessHash());
+  CHECK_GE(init_agg_values_.size(), targets_.size());
+
+  auto arg_it = init_func_->arg_begin();
+  auto groups_buffer = &*arg_it;
+  groups_buffer->setName("groups_buffer");
+
+  auto bb_entry = llvm::BasicBlock::Create(context_, ".entry", init_func_);
+  auto bb_loop_cond = llvm::BasicBlock::Create(context_, ".loop_cond", init_func_);
+  auto bb_body = llvm::BasicBlock::Create(context_, ".body", init_func_);
+  auto bb_exit = llvm::BasicBlock::Create(context_, ".exit", init_func_);
+
+  llvm::IRBuilder<> ir_builder(bb_entry);
+  const auto thread_idx =
+      ir_builder.CreateCall(getFunction("get_thread_index"), {}, "thread_index");
+  const auto block_dim =
+      ir_builder.CreateCall(getFunction("get_block_dim"), {}, "block_dim");
+
+  // declare dynamic shared memory:
+  const auto declare_smem_func = getFunction("declare_dynamic_shared_memory");
+  const auto shared_mem_buffer =
+      ir_builder.CreateCall(declare_smem_func, {}, "shared_mem_buffer");
+  const auto dest_byte_stream = ir_builder.CreatePointerCast(
+      shared_mem_buffer, llvm::Type::getInt8PtrTy(context_), "dest_byte_stream");
+  ir_builder.CreateBr(bb_loop_cond);
+
+  ir_builder.SetInsertPoint(bb_loop_cond);
+  auto entry_idx = ir_builder.CreatePHI(thread_idx->getType(), 2, "entry_idx");
+  entry_idx->addIncoming(thread_idx, bb_entry);
+  const auto is_entry_inbound = ir_builder.CreateICmpSLT(
+      entry_idx, ll_int(smem_entry_count_, context_), "is_entry_inbound");
+  ir_builder.CreateCondBr(is_entry_inbound, bb_body, bb_exit);
+
+  ir_builder.SetInsertPoint(bb_body);
+  const auto row_size_bytes = ll_int(fixup_query_mem_desc.getRowSize(), context_);
+  const auto row_offset_ll =
+      ir_builder.CreateMul(row_size_bytes, entry_idx, "row_offset");
+
+  // the empty key, on all the components since the matching spins on the last one
+  const auto key_width = fixup_query_mem_desc.getEffectiveKeyWidth();
+  CHECK(key_width == sizeof(int32_t) || key_width == sizeof(int64_t));
+  const auto key_ptr_type =
+      llvm::PointerType::get(get_int_type(key_width * 8, context_), /*address_space=*/3);
+  const auto empty_key_ll = key_width == sizeof(int32_t)
+                                ? ll_int(static_cast<int32_t>(EMPTY_KEY_32), context_)
+                                : ll_int(static_cast<int64_t>(EMPTY_KEY_64), context_);
+  for (size_t key_idx = 0; key_idx < fixup_query_mem_desc.getGroupbyColCount();
+       ++key_idx) {
+    const auto key_offset_ll = ir_builder.CreateAdd(
+        row_offset_ll, ll_int(static_cast<int64_t>(key_idx * key_width), context_));
+    const auto key_ptr = ir_builder.CreatePointerCast(
+        ir_builder.CreateGEP(dest_byte_stream, key_offset_ll),
+        key_ptr_type,
+        "dest_key_adr_" + std::to_string(key_idx));
+    ir_builder.CreateStore(empty_key_ll, key_ptr);
+  }
+
+  const auto& col_slot_context = fixup_query_mem_desc.getColSlotContext();
+  size_t init_agg_idx = 0;
+  for (size_t target_logical_idx = 0; target_logical_idx < targets_.size();
+       ++target_logical_idx) {
+    const auto& target_info = targets_[target_logical_idx];
+    const auto& slots_for_target = col_slot_context.getSlotsForCol(target_logical_idx);
+    for (size_t slot_idx = slots_for_target.front(); slot_idx <= slots_for_target.back();
+         slot_idx++) {
+      const auto slot_size = fixup_query_mem_desc.getPaddedSlotWidthBytes(slot_idx);
+      const auto slot_offset_ll = ir_builder.CreateAdd(
+          row_offset_ll,
+          ll_int(static_cast<int64_t>(fixup_query_mem_desc.getColOffInBytes(slot_idx)),
+                 context_));
+      auto casted_dest_slot_address = codegen_smem_dest_slot_ptr(context_,
+                                                                 fixup_query_mem_desc,
+                                                                 ir_builder,
+                                                                 slot_idx,
+                                                                 target_info,
+                                                                 dest_byte_stream,
+                                                                 slot_offset_ll);
+      llvm::Value* init_value_ll = nullptr;
+      if (slot_size == sizeof(int32_t)) {
+        init_value_ll =
+            ll_int(static_cast<int32_t>(init_agg_values_[init_agg_idx++]), context_);
+      } else if (slot_size == sizeof(int64_t)) {
+        init_value_ll =
+            ll_int(static_cast<int64_t>(init_agg_values_[init_agg_idx++]), context_);
+      } else {
+        UNREACHABLE() << "Invalid slot size encountered.";
+      }
+      ir_builder.CreateStore(init_value_ll, casted_dest_slot_address);
+    }
+  }
+  entry_idx->addIncoming(ir_builder.CreateAdd(entry_idx, block_dim, "next_entry_idx"),
+                         bb_body);
+  ir_builder.CreateBr(bb_loop_cond);
+
+  ir_builder.SetInsertPoint(bb_exit);
+  // synchronize all threads within a threadblock:
+  const auto sync_threadblock = getFunction("sync_threadblock");
+  ir_builder.CreateCall(sync_threadblock, {});
+  ir_builder.CreateRet(groups_buffer);
+}
+
+/**
+ * The reduction function of the baseline hash table of the block, called at the end of
+ * the block with the global memory buffer as both dest_buffer_ptr and src_buffer_ptr
+ * (see codegenBaselineInitialization). After the block synchronizes, its threads loop
+ * over the entries of the table in the shared memory with a stride of the block size.
+ * Each non-empty entry is looked up (or inserted) by its key in the global memory buffer
+ * with get_group_value, then its targets are reduced into the global entry with the
+ * reduce_one_entry function of ResultSetReductionJIT, where the agg_* functions are
+ * replaced by their atomic agg_*_shared counterparts as for perfect hash. The keys which
+ * already spilled to the global memory during the scan get aggregated there.
+ * If the global memory buffer runs out of entries, the thread records an out of slots
+ * error, the same the row function would have without the table of the block.
+ */
+void GpuSharedMemCodeBuilder::codegenBaselineReduction() {
+  CHECK(reduction_func_);
+  auto fixup_query_mem_desc = ResultSet::fixupQueryMemoryDescriptor(query_mem_desc_);
+  auto arg_it = reduction_func_->arg_begin();
+  auto dest_buffer_ptr = &*arg_it;
+  dest_buffer_ptr->setName("dest_buffer_ptr");
+  arg_it++;
+  auto src_buffer_ptr = &*arg_it;
+  src_buffer_ptr->setName("src_buffer_ptr");
+  arg_it++;
+  auto buffer_size = &*arg_it;
+  buffer_size->setName("buffer_size");
+  arg_it++;
+  auto error_codes = &*arg_it;
+  error_codes->setName("error_codes");
+
+  auto bb_entry = llvm::BasicBlock::Create(context_, ".entry", reduction_func_);
+  auto bb_loop_cond = llvm::BasicBlock::Create(context_, ".loop_cond", reduction_func_);
+  auto bb_body = llvm::BasicBlock::Create(context_, ".body", reduction_func_);
+  auto bb_lookup = llvm::BasicBlock::Create(context_, ".lookup", reduction_func_);
+  auto bb_reduce = llvm::BasicBlock::Create(context_, ".reduce", reduction_func_);
+  auto bb_out_of_slots =
+      llvm::BasicBlock::Create(context_, ".out_of_slots", reduction_func_);
+  auto bb_loop_inc = llvm::BasicBlock::Create(context_, ".loop_inc", reduction_func_);
+  auto bb_exit = llvm::BasicBlock::Create(context_, ".exit", reduction_func_);
+  llvm::IRBuilder<> ir_builder(bb_entry);
+
+  // synchronize all threads within a threadblock:
+  const auto sync_threadblock = getFunction("sync_threadblock");
+  ir_builder.CreateCall(sync_threadblock, {});
+
+  const auto thread_idx =
+      ir_builder.CreateCall(getFunction("get_thread_index"), {}, "thread_index");
+  const auto block_dim =
+      ir_builder.CreateCall(getFunction("get_block_dim"), {}, "block_dim");
+  const auto shared_mem_buffer = ir_builder.CreateCall(
+      getFunction("declare_dynamic_shared_memory"), {}, "shared_mem_buffer");
+  const auto src_byte_stream = ir_builder.CreatePointerCast(
+      shared_mem_buffer, llvm::Type::getInt8PtrTy(context_, 0), "src_byte_stream");
+
+  linkReductionCode();
+  const auto is_empty_entry_func = getFunction("is_empty_entry");
+  const auto reduce_one_entry_func = getFunction("reduce_one_entry");
+  ir_builder.CreateBr(bb_loop_cond);
+
+  ir_builder.SetInsertPoint(bb_loop_cond);
+  auto entry_idx = ir_builder.CreatePHI(thread_idx->getType(), 2, "entry_idx");
+  entry_idx->addIncoming(thread_idx, bb_entry);
+  const auto is_entry_inbound = ir_builder.CreateICmpSLT(
+      entry_idx, ll_int(smem_entry_count_, context_), "is_entry_inbound");
+  ir_builder.CreateCondBr(is_entry_inbound, bb_body, bb_exit);
+
+  ir_builder.SetInsertPoint(bb_body);
+  const auto row_offset_ll = ir_builder.CreateMul(
+      ll_int(fixup_query_mem_desc.getRowSize(), context_), entry_idx, "row_offset");
+  const auto src_row_ptr =
+      ir_builder.CreateGEP(src_byte_stream, row_offset_ll, "src_row_ptr");
+  const auto is_empty =
+      ir_builder.CreateCall(is_empty_entry_func, {src_row_ptr}, "is_empty");
+  ir_builder.CreateCondBr(is_empty, bb_loop_inc, bb_lookup);
+
+  ir_builder.SetInsertPoint(bb_lookup);
+  const auto src_key_ptr = ir_builder.CreatePointerCast(
+      src_row_ptr, llvm::Type::getInt64PtrTy(context_), "src_key_ptr");
+  const auto null_i64_ptr_ll = llvm::ConstantPointerNull::get(
+      llvm::Type::getInt64PtrTy(context_));
+  const auto dest_targets_ptr = ir_builder.CreateCall(
+      getFunction("get_group_value"),
+      {dest_buffer_ptr,
+       ll_int(static_cast<int32_t>(fixup_query_mem_desc.getEntryCount()), context_),
+       src_key_ptr,
+       ll_int(static_cast<int32_t>(fixup_query_mem_desc.getGroupbyColCount()), context_),
+       ll_int(static_cast<int32_t>(fixup_query_mem_desc.getEffectiveKeyWidth()),
+              context_),
+       ll_int(static_cast<int32_t>(fixup_query_mem_desc.getRowSize() / sizeof(int64_t)),
+              context_),
+       null_i64_ptr_ll},
+      "dest_targets_ptr");
+  const auto is_dest_found =
+      ir_builder.CreateICmpNE(dest_targets_ptr, null_i64_ptr_ll, "is_dest_found");
+  ir_builder.CreateCondBr(is_dest_found, bb_reduce, bb_out_of_slots);
+
+  ir_builder.SetInsertPoint(bb_reduce);
+  const auto src_targets_ptr = ir_builder.CreateGEP(
+      src_row_ptr,
+      ll_int(static_cast<int64_t>(get_slot_off_quad(fixup_query_mem_desc) *
+                                  sizeof(int64_t)),
+             context_),
+      "src_targets_ptr");
+  // qmd_handles are only used with count distinct, serialized varlen buffer only with
+  // SAMPLE on varlen types, neither of which use the shared memory
+  const auto null_ptr_ll =
+      llvm::ConstantPointerNull::get(llvm::Type::getInt8PtrTy(context_, 0));
+  ir_builder.CreateCall(
+      reduce_one_entry_func,
+      {ir_builder.CreatePointerCast(dest_targets_ptr,
+                                    llvm::Type::getInt8PtrTy(context_, 0),
+                                    "dest_targets_byte_stream"),
+       src_targets_ptr,
+       null_ptr_ll,
+       null_ptr_ll,
+       null_ptr_ll},
+      "");
+  ir_builder.CreateBr(bb_loop_inc);
+
+  ir_builder.SetInsertPoint(bb_out_of_slots);
+  ir_builder.CreateCall(getFunction("record_error_code"),
+                        {ll_int(int32_t(-1), context_), error_codes});
+  ir_builder.CreateBr(bb_loop_inc);
+
+  ir_builder.SetInsertPoint(bb_loop_inc);
+  entry_idx->addIncoming(ir_builder.CreateAdd(entry_idx, block_dim, "next_entry_idx"),
+                         bb_loop_inc);
+  ir_builder.CreateBr(bb_loop_cond);
+
+  ir_builder.SetInsertPoint(bb_exit);
+  ir_builder.CreateRetVoid();
+}
+
 llvm::Function* GpuSharedMemCodeBuilder::createReductionFunction() const {
   std::vector<llvm::Type*> input_arguments;
   input_arguments.push_back(llvm::Type::getInt64PtrTy(context_));
   input_arguments.push_back(llvm::Type::getInt64PtrTy(context_));
   input_arguments.push_back(llvm::Type::getInt32Ty(context_));
+  input_arguments.push_back(llvm::Type::getInt32PtrTy(context_));  // error codes
 
   llvm::FunctionType* ft =
       llvm::FunctionType::get(llvm::Type::getVoidTy(context_), input_arguments, false);
@@ -35,7 +35,10 @@
 
 /**
  * This is a builder class for extra functions that are required to
- * support GPU shared memory usage for GroupByPerfectHash query types.
+ * support GPU shared memory usage for GroupByPerfectHash and GroupByBaselineHash
+ * query types. With perfect hash the shared memory holds the whole output buffer of the
+ * block, with baseline hash a table of smem_entry_count entries the row function falls
+ * back to the global memory buffer from once full.
  *
  * This class does not own its own LLVM module and uses a pointer to the
  * global module provided to it as an argument during construction
@@ -46,7 +49,8 @@ class GpuSharedMemCodeBuilder {
                           llvm::LLVMContext& context,
                           const QueryMemoryDescriptor& qmd,
                           const std::vector<TargetInfo>& targets,
-                          const std::vector<int64_t>& init_agg_values);
+                          const std::vector<int64_t>& init_agg_values,
+                          const size_t smem_entry_count);
   /**
    * generates code for both the reduction and initialization steps required for shared
    * memory usage
@@ -74,6 +78,17 @@ class GpuSharedMemCodeBuilder {
    * Generates code for the shared memory buffer initialization
    */
   void codegenInitialization();
+  /**
+   * Baseline hash counterparts of the above, over the smem_entry_count_ entries table of
+   * the block
+   */
+  void codegenBaselineReduction();
+  void codegenBaselineInitialization();
+  /**
+   * Links the reduction functions of ResultSetReductionJIT into the module, with their
+   * aggregates replaced by the shared memory (atomic) ones
+   */
+  void linkReductionCode();
   /**
    * Create the reduction function in the LLVM module, with predefined arguments and
    * return type
@@ -96,4 +111,5 @@ class GpuSharedMemCodeBuilder {
   const QueryMemoryDescriptor query_mem_desc_;
   const std::vector<TargetInfo> targets_;
   const std::vector<int64_t> init_agg_values_;
+  const size_t smem_entry_count_;
 };
@@ -23,10 +23,13 @@
 #include "ExpressionRange.h"
 #include "ExpressionRewrite.h"
 #include "GpuInitGroups.h"
+#include "HyperLogLogRank.h"
 #include "InPlaceSort.h"
 #include "LLVMFunctionAttributesUtil.h"
 #include "MaxwellCodegenPatch.h"
+#include "MurmurHash.h"
 #include "OutputBufferInitialization.h"
+#include "TDigest.h"
 #include "TargetExprBuilder.h"
 
 #include "../CudaMgr/CudaMgr.h"
@@ -42,12 +45,14 @@
 
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 
+#include <algorithm>
 #include <numeric>
 #include <thread>
 
 bool g_cluster{false};
 bool g_bigint_count{false};
 int g_hll_precision_bits{11};
+bool g_enable_sparse_hll{false};
 extern size_t g_leaf_count;
 
 namespace {
@@ -407,7 +412,8 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
     const bool output_columnar_hint) {
   addTransientStringLiterals();
 
-  const auto count_distinct_descriptors = initCountDistinctDescriptors();
+  const auto count_distinct_descriptors =
+      initCountDistinctDescriptors(max_groups_buffer_entry_count);
 
   auto group_col_widths = get_col_byte_widths(ra_exe_unit_.groupby_exprs, {});
 
@@ -444,6 +450,16 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
             130000000))) {
     throw WatchdogException("Query would use too much memory");
   }
+  // the slots of the t-digests are finalized in place, which assumes the row-wise layout
+  const bool output_columnar =
+      output_columnar_hint &&
+      std::none_of(ra_exe_unit_.target_exprs.begin(),
+                   ra_exe_unit_.target_exprs.end(),
+                   [](const Analyzer::Expr* target_expr) {
+                     const auto agg_expr =
+                         dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+                     return agg_expr && agg_expr->get_aggtype() == kAPPROX_QUANTILE;
+                   });
   try {
     return QueryMemoryDescriptor::init(executor_,
                                        ra_exe_unit_,
@@ -459,7 +475,7 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
                                        render_info,
                                        count_distinct_descriptors,
                                        must_use_baseline_sort,
-                                       output_columnar_hint,
+                                       output_columnar,
                                        /*streaming_top_n_hint=*/true);
   } catch (const StreamingTopNOOM& e) {
     LOG(WARNING) << e.what() << " Disabling Streaming Top N.";
@@ -477,7 +493,7 @@ std::unique_ptr<QueryMemoryDescriptor> GroupByAndAggregate::initQueryMemoryDescr
                                        render_info,
                                        count_distinct_descriptors,
                                        must_use_baseline_sort,
-                                       output_columnar_hint,
+                                       output_columnar,
                                        /*streaming_top_n_hint=*/false);
   }
 }
@@ -576,7 +592,8 @@ void GroupByAndAggregate::addTransientStringLiterals(
   row_set_mem_owner->addLiteralStringDictProxy(executor->lit_str_dict_proxy_);
 }
 
-CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
+CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors(
+    const size_t max_groups_buffer_entry_count) {
   CountDistinctDescriptors count_distinct_descriptors;
   for (const auto target_expr : ra_exe_unit_.target_exprs) {
     auto agg_info = get_target_info(target_expr, g_bigint_count);
@@ -605,7 +622,7 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-        const auto error_rate = agg_expr->get_error_rate();
+        const auto error_rate = agg_expr->get_arg1();
         if (error_rate) {
           CHECK(error_rate->get_type_info().get_type() == kINT);
           CHECK_GE(error_rate->get_constval().intval, 1);
@@ -646,6 +663,23 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           count_distinct_impl_type == CountDistinctImplType::StdSet) {
         throw WatchdogException("Cannot use a fast path for COUNT distinct");
       }
+      if (count_distinct_impl_type == CountDistinctImplType::StdSet &&
+          !(arg_ti.is_array() || arg_ti.is_geometry())) {
+        // the arrays are inserted into a std::set by agg_count_distinct_array_*
+        count_distinct_impl_type = CountDistinctImplType::HashSet;
+      }
+      if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
+          count_distinct_impl_type == CountDistinctImplType::Bitmap &&
+          useSparseHll(bitmap_sz_bits, max_groups_buffer_entry_count)) {
+        count_distinct_descriptors.emplace_back(
+            CountDistinctDescriptor{CountDistinctImplType::StdSet,
+                                    arg_range_info.min,
+                                    bitmap_sz_bits,
+                                    true,
+                                    device_type_,
+                                    1});
+        continue;
+      }
       const auto sub_bitmap_count =
           get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit_, device_type_);
       count_distinct_descriptors.emplace_back(
@@ -663,6 +697,20 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
   return count_distinct_descriptors;
 }
 
+bool GroupByAndAggregate::useSparseHll(const int64_t bitmap_sz_bits,
+                                       const size_t max_groups_buffer_entry_count) const {
+  if (!g_enable_sparse_hll || device_type_ != ExecutorDeviceType::CPU ||
+      query_infos_.empty()) {
+    return false;
+  }
+  // the sparse registers take at most a set node by row, the dense ones a byte by
+  // register and group
+  constexpr size_t kSparseEntryBytes{48};
+  const auto max_row_count = query_infos_.front().info.getNumTuplesUpperBound();
+  return max_row_count * kSparseEntryBytes <
+         (max_groups_buffer_entry_count << bitmap_sz_bits);
+}
+
 /**
  * This function goes through all target expressions and answers two questions:
  * 1. Is it possible to have keyless hash?
@@ -848,7 +896,8 @@ bool GroupByAndAggregate::gpuCanHandleOrderEntries(
     auto agg_expr = static_cast<Analyzer::AggExpr*>(target_expr);
     if (agg_expr->get_is_distinct() || agg_expr->get_aggtype() == kAVG ||
         agg_expr->get_aggtype() == kMIN || agg_expr->get_aggtype() == kMAX ||
-        agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT) {
+        agg_expr->get_aggtype() == kAPPROX_COUNT_DISTINCT ||
+        agg_expr->get_aggtype() == kAPPROX_QUANTILE) {
       return false;
     }
     if (agg_expr->get_arg()) {
@@ -969,7 +1018,8 @@ bool GroupByAndAggregate::codegen(llvm::Value* filter_result,
         LL_BUILDER.CreateStore(old_total_matched_val, old_total_matched_ptr);
       }
 
-      auto agg_out_ptr_w_idx = codegenGroupBy(query_mem_desc, co, filter_cfg);
+      auto agg_out_ptr_w_idx =
+          codegenGroupBy(query_mem_desc, co, gpu_smem_context, filter_cfg);
       if (query_mem_desc.usesGetGroupValueFast() ||
           query_mem_desc.getQueryDescriptionType() ==
               QueryDescriptionType::GroupByPerfectHash) {
@@ -1138,6 +1188,7 @@ llvm::Value* GroupByAndAggregate::codegenOutputSlot(
 std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
     const QueryMemoryDescriptor& query_mem_desc,
     const CompilationOptions& co,
+    const GpuSharedMemoryContext& gpu_smem_context,
     DiamondCodegen& diamond_codegen) {
   AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
   auto arg_it = ROW_FUNC->arg_begin();
@@ -1242,6 +1293,7 @@ std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenGroupBy(
   } else if (query_mem_desc.getQueryDescriptionType() ==
              QueryDescriptionType::GroupByBaselineHash) {
     return codegenMultiColumnBaselineHash(co,
+                                          gpu_smem_context,
                                           &*groups_buffer,
                                           group_key,
                                           key_size_lv,
@@ -1350,6 +1402,7 @@ std::tuple<llvm::Value*, llvm::Value*> GroupByAndAggregate::codegenMultiColumnPe
 std::tuple<llvm::Value*, llvm::Value*>
 GroupByAndAggregate::codegenMultiColumnBaselineHash(
     const CompilationOptions& co,
+    const GpuSharedMemoryContext& gpu_smem_context,
     llvm::Value* groups_buffer,
     llvm::Value* group_key,
     llvm::Value* key_size_lv,
@@ -1373,8 +1426,28 @@ GroupByAndAggregate::codegenMultiColumnBaselineHash(
       groups_buffer,
       LL_INT(static_cast<int32_t>(query_mem_desc.getEntryCount())),
       &*group_key,
-      &*key_size_lv,
-      LL_INT(static_cast<int32_t>(key_width))};
+      &*key_size_lv};
+  if (gpu_smem_context.isSharedMemoryUsed()) {
+    // the block's table in the shared memory comes first, groups_buffer once it's full
+    CHECK(!query_mem_desc.didOutputColumnar());
+    const auto smem_entry_count =
+        gpu_smem_context.getSharedMemorySize() / query_mem_desc.getRowSize();
+    func_args.push_back(LL_INT(static_cast<int32_t>(key_width)));
+    func_args.push_back(LL_INT(row_size_quad));
+    func_args.push_back(&*arg_it);
+    func_args.push_back(LL_INT(static_cast<int32_t>(smem_entry_count)));
+    std::string func_name{"get_group_value_with_smem_spill"};
+    if (co.with_dynamic_watchdog) {
+      func_name += "_with_watchdog";
+    }
+    return std::make_tuple(emitCall(func_name, func_args), nullptr);
+  }
+  // the variants by key width have the probing specialized for it
+  const bool specialized_key_width =
+      key_width == sizeof(int32_t) || key_width == sizeof(int64_t);
+  if (!specialized_key_width) {
+    func_args.push_back(LL_INT(static_cast<int32_t>(key_width)));
+  }
   std::string func_name{"get_group_value"};
   if (query_mem_desc.didOutputColumnar()) {
     func_name += "_columnar_slot";
@@ -1385,6 +1458,9 @@ GroupByAndAggregate::codegenMultiColumnBaselineHash(
   if (co.with_dynamic_watchdog) {
     func_name += "_with_watchdog";
   }
+  if (specialized_key_width) {
+    func_name += "_" + std::to_string(key_width * 8);
+  }
   if (query_mem_desc.didOutputColumnar()) {
     return std::make_tuple(groups_buffer, emitCall(func_name, func_args));
   } else {
@@ -1498,7 +1574,8 @@ llvm::Value* GroupByAndAggregate::codegenWindowRowPointer(
   AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
   const auto window_func_context =
       WindowProjectNodeContext::getActiveWindowFunctionContext(executor_);
-  if (window_func_context && window_function_is_aggregate(window_func->getKind())) {
+  if (window_func_context && window_function_is_aggregate(window_func->getKind()) &&
+      !window_function_is_frame_aggregate(window_func)) {
     const int32_t row_size_quad = query_mem_desc.didOutputColumnar()
                                       ? 0
                                       : query_mem_desc.getRowSize() / sizeof(int64_t);
@@ -1704,6 +1781,47 @@ extern "C" void agg_count_distinct_skip_val(int64_t* agg,
   }
 }
 
+extern "C" void agg_count_distinct_hash_set(int64_t* agg, const int64_t val) {
+  reinterpret_cast<CountDistinctHashSet*>(*agg)->insert(val);
+}
+
+extern "C" void agg_count_distinct_hash_set_skip_val(int64_t* agg,
+                                                     const int64_t val,
+                                                     const int64_t skip_val) {
+  if (val != skip_val) {
+    agg_count_distinct_hash_set(agg, val);
+  }
+}
+
+extern "C" void agg_approx_quantile(int64_t* agg, const double val) {
+  reinterpret_cast<TDigest*>(*agg)->add(val);
+}
+
+extern "C" void agg_approx_quantile_skip_val(int64_t* agg,
+                                             const double val,
+                                             const double skip_val) {
+  if (val != skip_val) {
+    agg_approx_quantile(agg, val);
+  }
+}
+
+extern "C" void agg_approximate_count_distinct_sparse(int64_t* agg,
+                                                     const int64_t key,
+                                                     const uint32_t b) {
+  const uint64_t hash = MurmurHash64A(&key, sizeof(key), 0);
+  const uint32_t index = hash >> (64 - b);
+  const uint8_t rank = get_rank(hash << b, 64 - b);
+  auto entries = reinterpret_cast<std::set<int64_t>*>(*agg);
+  auto it = entries->lower_bound(hll_sparse_entry(index, 0));
+  if (it != entries->end() && (*it >> 8) == index) {
+    if ((*it & 0xff) >= rank) {
+      return;
+    }
+    it = entries->erase(it);
+  }
+  entries->insert(it, hll_sparse_entry(index, rank));
+}
+
 void GroupByAndAggregate::codegenCountDistinct(
     const size_t target_idx,
     const Analyzer::Expr* target_expr,
@@ -1722,8 +1840,15 @@ void GroupByAndAggregate::codegenCountDistinct(
       query_mem_desc.getCountDistinctDescriptor(target_idx);
   CHECK(count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid);
   if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
-    CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     agg_args.push_back(LL_INT(int32_t(count_distinct_descriptor.bitmap_sz_bits)));
+    if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet) {
+      CHECK(device_type == ExecutorDeviceType::CPU);
+      executor_->cgen_state_->emitExternalCall("agg_approximate_count_distinct_sparse",
+                                               llvm::Type::getVoidTy(LL_CONTEXT),
+                                               agg_args);
+      return;
+    }
+    CHECK(count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap);
     if (device_type == ExecutorDeviceType::GPU) {
       const auto base_dev_addr = getAdditionalLiteral(-1);
       const auto base_host_addr = getAdditionalLiteral(-2);
@@ -1739,6 +1864,8 @@ void GroupByAndAggregate::codegenCountDistinct(
   if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap) {
     agg_fname += "_bitmap";
     agg_args.push_back(LL_INT(static_cast<int64_t>(count_distinct_descriptor.min_val)));
+  } else if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::HashSet) {
+    agg_fname += "_hash_set";
   }
   if (agg_info.skip_null_val) {
     auto null_lv = executor_->cgen_state_->castToTypeIn(
@@ -1773,6 +1900,24 @@ void GroupByAndAggregate::codegenCountDistinct(
   }
 }
 
+void GroupByAndAggregate::codegenApproxQuantile(
+    const Analyzer::Expr* target_expr,
+    std::vector<llvm::Value*>& agg_args,
+    const ExecutorDeviceType device_type) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  // the slot holds a TDigest pointer, see QueryMemoryInitializer::allocateTDigests
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  const auto agg_info = get_target_info(target_expr, g_bigint_count);
+  CHECK_EQ(agg_info.agg_arg_type.get_type(), kDOUBLE);
+  std::string agg_fname{"agg_approx_quantile"};
+  if (agg_info.skip_null_val) {
+    agg_fname += "_skip_val";
+    agg_args.push_back(executor_->cgen_state_->inlineFpNull(agg_info.agg_arg_type));
+  }
+  executor_->cgen_state_->emitExternalCall(
+      agg_fname, llvm::Type::getVoidTy(LL_CONTEXT), agg_args);
+}
+
 llvm::Value* GroupByAndAggregate::getAdditionalLiteral(const int32_t off) {
   CHECK_LT(off, 0);
   const auto lit_buff_lv = get_arg_by_name(ROW_FUNC, "literals");
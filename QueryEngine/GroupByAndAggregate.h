@@ -190,7 +190,11 @@ class GroupByAndAggregate {
 
   void addTransientStringLiterals();
 
-  CountDistinctDescriptors initCountDistinctDescriptors();
+  CountDistinctDescriptors initCountDistinctDescriptors(
+      const size_t max_groups_buffer_entry_count);
+
+  bool useSparseHll(const int64_t bitmap_sz_bits,
+                    const size_t max_groups_buffer_entry_count) const;
 
   llvm::Value* codegenOutputSlot(llvm::Value* groups_buffer,
                                  const QueryMemoryDescriptor& query_mem_desc,
@@ -200,6 +204,7 @@ class GroupByAndAggregate {
   std::tuple<llvm::Value*, llvm::Value*> codegenGroupBy(
       const QueryMemoryDescriptor& query_mem_desc,
       const CompilationOptions& co,
+      const GpuSharedMemoryContext& gpu_smem_context,
       DiamondCodegen& codegen);
 
   std::tuple<llvm::Value*, llvm::Value*> codegenSingleColumnPerfectHash(
@@ -220,6 +225,7 @@ class GroupByAndAggregate {
 
   std::tuple<llvm::Value*, llvm::Value*> codegenMultiColumnBaselineHash(
       const CompilationOptions& co,
+      const GpuSharedMemoryContext& gpu_smem_context,
       llvm::Value* groups_buffer,
       llvm::Value* group_key,
       llvm::Value* key_size_lv,
@@ -272,6 +278,10 @@ class GroupByAndAggregate {
                             const QueryMemoryDescriptor&,
                             const ExecutorDeviceType);
 
+  void codegenApproxQuantile(const Analyzer::Expr* target_expr,
+                             std::vector<llvm::Value*>& agg_args,
+                             const ExecutorDeviceType);
+
   llvm::Value* getAdditionalLiteral(const int32_t off);
 
   std::vector<llvm::Value*> codegenAggArg(const Analyzer::Expr* target_expr,
@@ -104,6 +104,30 @@ TEST(SetGetTest, ManyKeys) {
   ASSERT_EQ(*gv3, val);
 }
 
+TEST(SetGetTest, KeyWidthVariants) {
+  const int32_t groups_buffer_entry_count{10};
+  const int32_t key_qw_count{3};
+  const int32_t row_size_quad{key_qw_count + 1};
+  GroupsBuffer gb(groups_buffer_entry_count, key_qw_count, 0);
+  int64_t key[] = {31, 32, 33};
+  auto gv1 = get_group_value(
+      gb, groups_buffer_entry_count, key, key_qw_count, sizeof(int64_t), row_size_quad);
+  ASSERT_NE(gv1, nullptr);
+  auto gv2 = get_group_value_64(
+      gb, groups_buffer_entry_count, key, key_qw_count, row_size_quad);
+  ASSERT_EQ(gv1, gv2);
+  int64_t val = 42;
+  *gv2 = val;
+  int64_t other_key[] = {41, 42, 43};
+  auto gv3 = get_group_value_64(
+      gb, groups_buffer_entry_count, other_key, key_qw_count, row_size_quad);
+  ASSERT_NE(gv3, nullptr);
+  ASSERT_NE(gv3, gv1);
+  ASSERT_EQ(*get_group_value_64(
+                gb, groups_buffer_entry_count, key, key_qw_count, row_size_quad),
+            val);
+}
+
 TEST(SetGetTest, OneKeyCollision) {
   const int32_t groups_buffer_entry_count{10};
   const int32_t key_qw_count{1};
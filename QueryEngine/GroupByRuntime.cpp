@@ -23,7 +23,12 @@ extern "C" ALWAYS_INLINE DEVICE uint32_t key_hash(const int64_t* key,
   return MurmurHash1(key, key_byte_width * key_count, 0);
 }
 
-extern "C" NEVER_INLINE DEVICE int64_t* get_group_value(
+extern "C" NEVER_INLINE DEVICE bool dynamic_watchdog();
+
+// With a constant key_width, the switches on it in the matching functions fold away once
+// they're inlined, which the variants by key width below rely on
+template <bool WITH_WATCHDOG>
+ALWAYS_INLINE DEVICE int64_t* get_group_value_impl(
     int64_t* groups_buffer,
     const uint32_t groups_buffer_entry_count,
     const int64_t* key,
@@ -37,6 +42,7 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value(
   if (matching_group) {
     return matching_group;
   }
+  uint32_t watchdog_countdown = 100;
   uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
   while (h_probe != h) {
     matching_group = get_matching_group_value(
@@ -45,11 +51,32 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value(
       return matching_group;
     }
     h_probe = (h_probe + 1) % groups_buffer_entry_count;
+    if (WITH_WATCHDOG && --watchdog_countdown == 0) {
+      if (dynamic_watchdog()) {
+        return NULL;
+      }
+      watchdog_countdown = 100;
+    }
   }
   return NULL;
 }
 
-extern "C" NEVER_INLINE DEVICE bool dynamic_watchdog();
+extern "C" NEVER_INLINE DEVICE int64_t* get_group_value(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals) {
+  return get_group_value_impl<false>(groups_buffer,
+                                     groups_buffer_entry_count,
+                                     key,
+                                     key_count,
+                                     key_width,
+                                     row_size_quad,
+                                     init_vals);
+}
 
 extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_with_watchdog(
     int64_t* groups_buffer,
@@ -59,29 +86,83 @@ extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_with_watchdog(
     const uint32_t key_width,
     const uint32_t row_size_quad,
     const int64_t* init_vals) {
+  return get_group_value_impl<true>(groups_buffer,
+                                    groups_buffer_entry_count,
+                                    key,
+                                    key_count,
+                                    key_width,
+                                    row_size_quad,
+                                    init_vals);
+}
+
+#define DEF_GET_GROUP_VALUE(key_bits)                                               \
+  extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_##key_bits(               \
+      int64_t* groups_buffer,                                                       \
+      const uint32_t groups_buffer_entry_count,                                     \
+      const int64_t* key,                                                           \
+      const uint32_t key_count,                                                     \
+      const uint32_t row_size_quad,                                                 \
+      const int64_t* init_vals) {                                                   \
+    return get_group_value_impl<false>(groups_buffer,                               \
+                                       groups_buffer_entry_count,                   \
+                                       key,                                         \
+                                       key_count,                                   \
+                                       key_bits / 8,                                \
+                                       row_size_quad,                               \
+                                       init_vals);                                  \
+  }                                                                                 \
+                                                                                    \
+  extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_with_watchdog_##key_bits( \
+      int64_t* groups_buffer,                                                       \
+      const uint32_t groups_buffer_entry_count,                                     \
+      const int64_t* key,                                                           \
+      const uint32_t key_count,                                                     \
+      const uint32_t row_size_quad,                                                 \
+      const int64_t* init_vals) {                                                   \
+    return get_group_value_impl<true>(groups_buffer,                                \
+                                      groups_buffer_entry_count,                    \
+                                      key,                                          \
+                                      key_count,                                    \
+                                      key_bits / 8,                                 \
+                                      row_size_quad,                                \
+                                      init_vals);                                   \
+  }
+
+DEF_GET_GROUP_VALUE(32)
+DEF_GET_GROUP_VALUE(64)
+
+#undef DEF_GET_GROUP_VALUE
+
+template <bool WITH_WATCHDOG>
+ALWAYS_INLINE DEVICE int32_t
+get_group_value_columnar_slot_impl(int64_t* groups_buffer,
+                                   const uint32_t groups_buffer_entry_count,
+                                   const int64_t* key,
+                                   const uint32_t key_count,
+                                   const uint32_t key_width) {
   uint32_t h = key_hash(key, key_count, key_width) % groups_buffer_entry_count;
-  int64_t* matching_group = get_matching_group_value(
-      groups_buffer, h, key, key_count, key_width, row_size_quad, init_vals);
-  if (matching_group) {
-    return matching_group;
+  int32_t matching_slot = get_matching_group_value_columnar_slot(
+      groups_buffer, groups_buffer_entry_count, h, key, key_count, key_width);
+  if (matching_slot != -1) {
+    return h;
   }
   uint32_t watchdog_countdown = 100;
   uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
   while (h_probe != h) {
-    matching_group = get_matching_group_value(
-        groups_buffer, h_probe, key, key_count, key_width, row_size_quad, init_vals);
-    if (matching_group) {
-      return matching_group;
+    matching_slot = get_matching_group_value_columnar_slot(
+        groups_buffer, groups_buffer_entry_count, h_probe, key, key_count, key_width);
+    if (matching_slot != -1) {
+      return h_probe;
     }
     h_probe = (h_probe + 1) % groups_buffer_entry_count;
-    if (--watchdog_countdown == 0) {
+    if (WITH_WATCHDOG && --watchdog_countdown == 0) {
       if (dynamic_watchdog()) {
-        return NULL;
+        return -1;
       }
       watchdog_countdown = 100;
     }
   }
-  return NULL;
+  return -1;
 }
 
 extern "C" NEVER_INLINE DEVICE int32_t
@@ -90,22 +171,8 @@ get_group_value_columnar_slot(int64_t* groups_buffer,
                               const int64_t* key,
                               const uint32_t key_count,
                               const uint32_t key_width) {
-  uint32_t h = key_hash(key, key_count, key_width) % groups_buffer_entry_count;
-  int32_t matching_slot = get_matching_group_value_columnar_slot(
-      groups_buffer, groups_buffer_entry_count, h, key, key_count, key_width);
-  if (matching_slot != -1) {
-    return h;
-  }
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
-  while (h_probe != h) {
-    matching_slot = get_matching_group_value_columnar_slot(
-        groups_buffer, groups_buffer_entry_count, h_probe, key, key_count, key_width);
-    if (matching_slot != -1) {
-      return h_probe;
-    }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
-  }
-  return -1;
+  return get_group_value_columnar_slot_impl<false>(
+      groups_buffer, groups_buffer_entry_count, key, key_count, key_width);
 }
 
 extern "C" NEVER_INLINE DEVICE int32_t
@@ -114,31 +181,35 @@ get_group_value_columnar_slot_with_watchdog(int64_t* groups_buffer,
                                             const int64_t* key,
                                             const uint32_t key_count,
                                             const uint32_t key_width) {
-  uint32_t h = key_hash(key, key_count, key_width) % groups_buffer_entry_count;
-  int32_t matching_slot = get_matching_group_value_columnar_slot(
-      groups_buffer, groups_buffer_entry_count, h, key, key_count, key_width);
-  if (matching_slot != -1) {
-    return h;
-  }
-  uint32_t watchdog_countdown = 100;
-  uint32_t h_probe = (h + 1) % groups_buffer_entry_count;
-  while (h_probe != h) {
-    matching_slot = get_matching_group_value_columnar_slot(
-        groups_buffer, groups_buffer_entry_count, h_probe, key, key_count, key_width);
-    if (matching_slot != -1) {
-      return h_probe;
-    }
-    h_probe = (h_probe + 1) % groups_buffer_entry_count;
-    if (--watchdog_countdown == 0) {
-      if (dynamic_watchdog()) {
-        return -1;
-      }
-      watchdog_countdown = 100;
-    }
-  }
-  return -1;
+  return get_group_value_columnar_slot_impl<true>(
+      groups_buffer, groups_buffer_entry_count, key, key_count, key_width);
 }
 
+#define DEF_GET_GROUP_VALUE_COLUMNAR_SLOT(key_bits)                                \
+  extern "C" NEVER_INLINE DEVICE int32_t get_group_value_columnar_slot_##key_bits( \
+      int64_t* groups_buffer,                                                      \
+      const uint32_t groups_buffer_entry_count,                                    \
+      const int64_t* key,                                                          \
+      const uint32_t key_count) {                                                  \
+    return get_group_value_columnar_slot_impl<false>(                              \
+        groups_buffer, groups_buffer_entry_count, key, key_count, key_bits / 8);   \
+  }                                                                                \
+                                                                                   \
+  extern "C" NEVER_INLINE DEVICE int32_t                                           \
+      get_group_value_columnar_slot_with_watchdog_##key_bits(                      \
+          int64_t* groups_buffer,                                                  \
+          const uint32_t groups_buffer_entry_count,                                \
+          const int64_t* key,                                                      \
+          const uint32_t key_count) {                                              \
+    return get_group_value_columnar_slot_impl<true>(                               \
+        groups_buffer, groups_buffer_entry_count, key, key_count, key_bits / 8);   \
+  }
+
+DEF_GET_GROUP_VALUE_COLUMNAR_SLOT(32)
+DEF_GET_GROUP_VALUE_COLUMNAR_SLOT(64)
+
+#undef DEF_GET_GROUP_VALUE_COLUMNAR_SLOT
+
 extern "C" NEVER_INLINE DEVICE int64_t* get_group_value_columnar(
     int64_t* groups_buffer,
     const uint32_t groups_buffer_entry_count,
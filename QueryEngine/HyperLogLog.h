@@ -27,7 +27,9 @@
 
 #include "Descriptors/CountDistinctDescriptor.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 inline double get_alpha(const size_t m) {
   switch (m) {
@@ -112,6 +114,23 @@ inline void hll_unify(T1* lhs, T2* rhs, const size_t m) {
   }
 }
 
+// The sparse registers of the groups which see few distinct values keep the
+// index << 8 | rank of their non-zero registers in an ordered set, where an index can
+// have more than a rank after unions.
+inline int64_t hll_sparse_entry(const uint32_t index, const uint8_t rank) {
+  return static_cast<int64_t>(index) << 8 | rank;
+}
+
+template <class T>
+inline size_t hll_sparse_size(const T& entries, const size_t bitmap_sz_bits) {
+  std::vector<int8_t> M(1 << bitmap_sz_bits, 0);
+  for (const int64_t entry : entries) {
+    auto& rank = M[entry >> 8];
+    rank = std::max(rank, static_cast<int8_t>(entry & 0xff));
+  }
+  return hll_size(M.data(), bitmap_sz_bits);
+}
+
 inline int hll_size_for_rate(const int err_percent) {
   double err_rate{static_cast<double>(err_percent) / 100.0};
   double k = ceil(2 * log2(1.04 / err_rate));
@@ -121,5 +140,6 @@ inline int hll_size_for_rate(const int err_percent) {
 }
 
 extern int g_hll_precision_bits;
+extern bool g_enable_sparse_hll;
 
 #endif  // QUERYENGINE_HYPERLOGLOG_H
@@ -21,6 +21,11 @@
 #include "MaxwellCodegenPatch.h"
 #include "RelAlgTranslator.h"
 
+#include <future>
+
+extern bool g_enable_parallel_join_hash_table_build;
+extern bool g_enable_smem_join_hash_table;
+
 // Driver methods for the IR generation.
 
 std::vector<llvm::Value*> CodeGenerator::codegen(const Analyzer::Expr* expr,
@@ -266,6 +271,8 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
   INJECT_TIMER(buildJoinLoops);
   AUTOMATIC_IR_METADATA(cgen_state_.get());
   std::vector<JoinLoop> join_loops;
+  const auto prebuilt_hash_tables =
+      buildInnerJoinHashTables(ra_exe_unit, co, query_infos, column_cache);
   for (size_t level_idx = 0, current_hash_table_idx = 0;
        level_idx < ra_exe_unit.join_quals.size();
        ++level_idx) {
@@ -280,8 +287,13 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
             current_level_join_conditions.type == JoinType::LEFT) {
           JoinCondition join_condition{{first_qual}, current_level_join_conditions.type};
 
-          return buildCurrentLevelHashTable(
-              join_condition, ra_exe_unit, co, query_infos, column_cache, fail_reasons);
+          return buildCurrentLevelHashTable(join_condition,
+                                            ra_exe_unit,
+                                            co,
+                                            query_infos,
+                                            column_cache,
+                                            prebuilt_hash_tables,
+                                            fail_reasons);
         }
       }
       return buildCurrentLevelHashTable(current_level_join_conditions,
@@ -289,6 +301,7 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
                                         co,
                                         query_infos,
                                         column_cache,
+                                        prebuilt_hash_tables,
                                         fail_reasons);
     };
     const auto current_level_hash_table = build_cur_level_hash_table();
@@ -412,7 +425,7 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
             return domain;
           },
           /*outer_condition_match=*/
-          current_level_join_conditions.type == JoinType::LEFT
+          current_level_join_conditions.type != JoinType::INNER
               ? std::function<llvm::Value*(const std::vector<llvm::Value*>&)>(
                     outer_join_condition_cb)
               : nullptr,
@@ -426,6 +439,106 @@ std::vector<JoinLoop> Executor::buildJoinLoops(
   return join_loops;
 }
 
+llvm::Value* Executor::codegenJoinHashTablesArg(
+    llvm::Function* query_func,
+    const CompilationOptions& co,
+    const GpuSharedMemoryContext& gpu_smem_context) {
+  AUTOMATIC_IR_METADATA(cgen_state_.get());
+  const auto join_hash_tables = get_arg_by_name(query_func, "join_hash_tables");
+  const auto& hash_tables = plan_state_->join_info_.join_hash_tables_;
+  // the shared memory of the blocks goes to the group by buffers first
+  if (!g_enable_smem_join_hash_table || co.device_type != ExecutorDeviceType::GPU ||
+      gpu_smem_context.isSharedMemoryUsed() || hash_tables.empty()) {
+    return join_hash_tables;
+  }
+  const auto cuda_mgr = catalog_->getDataMgr().getCudaMgr();
+  CHECK(cuda_mgr);
+  const size_t max_shared_hash_table_size =
+      cuda_mgr->getMinSharedMemoryPerBlockForAllDevices() / numBlocksPerMP();
+  // the first perfect one to one hash table of the same size on all devices which fits
+  size_t shared_table_idx = hash_tables.size();
+  size_t hash_table_size{0};
+  for (size_t table_idx = 0; table_idx < hash_tables.size(); ++table_idx) {
+    const auto& hash_table = hash_tables[table_idx];
+    if (!dynamic_cast<const JoinHashTable*>(hash_table.get()) ||
+        hash_table->getHashType() != JoinHashTableInterface::HashType::OneToOne ||
+        hash_table->getMemoryLevel() != Data_Namespace::GPU_LEVEL) {
+      continue;
+    }
+    hash_table_size = hash_table->getJoinHashBufferSize(ExecutorDeviceType::GPU, 0);
+    bool same_size_on_all_devices{true};
+    for (int device_id = 1; device_id < hash_table->getDeviceCount(); ++device_id) {
+      same_size_on_all_devices &=
+          hash_table->getJoinHashBufferSize(ExecutorDeviceType::GPU, device_id) ==
+          hash_table_size;
+    }
+    if (hash_table_size && hash_table_size <= max_shared_hash_table_size &&
+        same_size_on_all_devices) {
+      shared_table_idx = table_idx;
+      break;
+    }
+  }
+  if (shared_table_idx == hash_tables.size()) {
+    return join_hash_tables;
+  }
+  VLOG(1) << "Probing join hash table " << shared_table_idx << " of "
+          << hash_table_size << " bytes from GPU shared memory";
+
+  auto& ir_builder = cgen_state_->query_func_entry_ir_builder_;
+  auto i32_type = get_int_type(32, cgen_state_->context_);
+  auto i64_type = get_int_type(64, cgen_state_->context_);
+  auto shared_hash_table_type =
+      llvm::ArrayType::get(i32_type, hash_table_size / sizeof(int32_t));
+  constexpr unsigned kSharedAddressSpace{3};
+  auto shared_hash_table =
+      new llvm::GlobalVariable(*cgen_state_->module_,
+                               shared_hash_table_type,
+                               false,
+                               llvm::GlobalValue::InternalLinkage,
+                               llvm::UndefValue::get(shared_hash_table_type),
+                               "shared_join_hash_table",
+                               nullptr,
+                               llvm::GlobalValue::NotThreadLocal,
+                               kSharedAddressSpace);
+  auto shared_hash_table_ptr = ir_builder.CreateAddrSpaceCast(
+      ir_builder.CreateBitCast(shared_hash_table,
+                               llvm::PointerType::get(i32_type, kSharedAddressSpace)),
+      llvm::PointerType::get(i32_type, 0));
+  // a single hash table is passed directly, several as an array of their addresses
+  auto hash_table_address = [&](const size_t table_idx) -> llvm::Value* {
+    if (hash_tables.size() == 1) {
+      return ir_builder.CreatePtrToInt(join_hash_tables, i64_type);
+    }
+    return ir_builder.CreateLoad(ir_builder.CreateGEP(
+        join_hash_tables, cgen_state_->llInt(static_cast<int64_t>(table_idx))));
+  };
+  auto init_func = cgen_state_->module_->getFunction("init_shared_join_hash_table");
+  CHECK(init_func);
+  ir_builder.CreateCall(
+      init_func,
+      std::vector<llvm::Value*>{
+          shared_hash_table_ptr,
+          ir_builder.CreateIntToPtr(hash_table_address(shared_table_idx),
+                                    llvm::PointerType::get(i32_type, 0)),
+          cgen_state_->llInt(static_cast<int32_t>(hash_table_size))});
+  const auto shared_hash_table_address =
+      ir_builder.CreatePtrToInt(shared_hash_table_ptr, i64_type);
+  if (hash_tables.size() == 1) {
+    return ir_builder.CreateIntToPtr(shared_hash_table_address,
+                                     llvm::PointerType::get(i64_type, 0));
+  }
+  auto hash_table_addresses = ir_builder.CreateAlloca(
+      i64_type, cgen_state_->llInt(static_cast<int32_t>(hash_tables.size())));
+  for (size_t table_idx = 0; table_idx < hash_tables.size(); ++table_idx) {
+    ir_builder.CreateStore(
+        table_idx == shared_table_idx ? shared_hash_table_address
+                                      : hash_table_address(table_idx),
+        ir_builder.CreateGEP(hash_table_addresses,
+                             cgen_state_->llInt(static_cast<int64_t>(table_idx))));
+  }
+  return hash_table_addresses;
+}
+
 std::function<llvm::Value*(const std::vector<llvm::Value*>&, llvm::Value*)>
 Executor::buildIsDeletedCb(const RelAlgExecutionUnit& ra_exe_unit,
                            const size_t level_idx,
@@ -487,12 +600,66 @@ Executor::buildIsDeletedCb(const RelAlgExecutionUnit& ra_exe_unit,
   };
 }
 
+Executor::JoinHashTablesByQual Executor::buildInnerJoinHashTables(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const CompilationOptions& co,
+    const std::vector<InputTableInfo>& query_infos,
+    ColumnCacheMap& column_cache) {
+  JoinHashTablesByQual hash_tables;
+  if (!g_enable_parallel_join_hash_table_build) {
+    return hash_tables;
+  }
+  // the qualifiers buildCurrentLevelHashTable starts with on the inner join levels
+  std::vector<std::shared_ptr<Analyzer::BinOper>> quals;
+  for (const auto& join_condition : ra_exe_unit.join_quals) {
+    if (join_condition.type != JoinType::INNER) {
+      continue;
+    }
+    for (const auto& join_qual : join_condition.quals) {
+      auto qual_bin_oper = std::dynamic_pointer_cast<Analyzer::BinOper>(join_qual);
+      if (qual_bin_oper && IS_EQUIVALENCE(qual_bin_oper->get_optype())) {
+        quals.push_back(qual_bin_oper);
+        break;
+      }
+    }
+  }
+  if (quals.size() < 2) {
+    return hash_tables;
+  }
+  const auto memory_level = co.device_type == ExecutorDeviceType::GPU
+                                ? MemoryLevel::GPU_LEVEL
+                                : MemoryLevel::CPU_LEVEL;
+  std::vector<std::future<JoinHashTableOrError>> build_threads;
+  for (const auto& qual_bin_oper : quals) {
+    build_threads.push_back(std::async(
+        std::launch::async,
+        [this,
+         qual_bin_oper,
+         &query_infos,
+         memory_level,
+         &column_cache,
+         parent_thread_id = logger::thread_id()] {
+          DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+          return buildHashTableForQualifier(qual_bin_oper,
+                                            query_infos,
+                                            memory_level,
+                                            JoinHashTableInterface::HashType::OneToOne,
+                                            column_cache);
+        }));
+  }
+  for (size_t i = 0; i < quals.size(); ++i) {
+    hash_tables.emplace(quals[i].get(), build_threads[i].get());
+  }
+  return hash_tables;
+}
+
 std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
     const JoinCondition& current_level_join_conditions,
     RelAlgExecutionUnit& ra_exe_unit,
     const CompilationOptions& co,
     const std::vector<InputTableInfo>& query_infos,
     ColumnCacheMap& column_cache,
+    const JoinHashTablesByQual& prebuilt_hash_tables,
     std::vector<std::string>& fail_reasons) {
   AUTOMATIC_IR_METADATA(cgen_state_.get());
   if (current_level_join_conditions.type != JoinType::INNER &&
@@ -512,13 +679,17 @@ std::shared_ptr<JoinHashTableInterface> Executor::buildCurrentLevelHashTable(
     }
     JoinHashTableOrError hash_table_or_error;
     if (!current_level_hash_table) {
-      hash_table_or_error = buildHashTableForQualifier(
-          qual_bin_oper,
-          query_infos,
-          co.device_type == ExecutorDeviceType::GPU ? MemoryLevel::GPU_LEVEL
-                                                    : MemoryLevel::CPU_LEVEL,
-          JoinHashTableInterface::HashType::OneToOne,
-          column_cache);
+      const auto prebuilt_it = prebuilt_hash_tables.find(qual_bin_oper.get());
+      hash_table_or_error =
+          prebuilt_it != prebuilt_hash_tables.end()
+              ? prebuilt_it->second
+              : buildHashTableForQualifier(
+                    qual_bin_oper,
+                    query_infos,
+                    co.device_type == ExecutorDeviceType::GPU ? MemoryLevel::GPU_LEVEL
+                                                              : MemoryLevel::CPU_LEVEL,
+                    JoinHashTableInterface::HashType::OneToOne,
+                    column_cache);
       current_level_hash_table = hash_table_or_error.hash_table;
     }
     if (hash_table_or_error.hash_table) {
@@ -631,6 +802,25 @@ Executor::GroupColLLVMValue Executor::groupByColumnCodegen(
     const auto& array_ti = arr_expr->get_type_info();
     CHECK(array_ti.is_array());
     const auto& elem_ti = array_ti.get_elem_type();
+    const auto ar_ret_ty =
+        elem_ti.is_fp()
+            ? (elem_ti.get_type() == kDOUBLE
+                   ? llvm::Type::getDoubleTy(cgen_state_->context_)
+                   : llvm::Type::getFloatTy(cgen_state_->context_))
+            : get_int_type(elem_ti.get_logical_size() * 8, cgen_state_->context_);
+    // the elements are read from the buffer of the array, found once per row rather
+    // than for each of them
+    std::string array_buff_fname{"array_buff"};
+    if (array_ti.get_size() < 0) {
+      array_buff_fname =
+          array_ti.get_notnull() ? "varlen_notnull_array_buff" : "varlen_array_buff";
+    }
+    auto array_buff = cgen_state_->ir_builder_.CreatePointerCast(
+        cgen_state_->emitExternalCall(
+            array_buff_fname,
+            llvm::Type::getInt8PtrTy(cgen_state_->context_),
+            {group_key, code_generator.posArg(arr_expr)}),
+        llvm::PointerType::get(ar_ret_ty, 0));
     auto array_len =
         (array_ti.get_size() > 0)
             ? cgen_state_->llInt(array_ti.get_size() / elem_ti.get_size())
@@ -656,23 +846,8 @@ Executor::GroupColLLVMValue Executor::groupByColumnCodegen(
     cgen_state_->ir_builder_.CreateStore(
         cgen_state_->ir_builder_.CreateAdd(array_idx, cgen_state_->llInt(int32_t(1))),
         array_idx_ptr);
-    auto array_at_fname = "array_at_" + numeric_type_name(elem_ti);
-    if (array_ti.get_size() < 0) {
-      if (array_ti.get_notnull()) {
-        array_at_fname = "notnull_" + array_at_fname;
-      }
-      array_at_fname = "varlen_" + array_at_fname;
-    }
-    const auto ar_ret_ty =
-        elem_ti.is_fp()
-            ? (elem_ti.get_type() == kDOUBLE
-                   ? llvm::Type::getDoubleTy(cgen_state_->context_)
-                   : llvm::Type::getFloatTy(cgen_state_->context_))
-            : get_int_type(elem_ti.get_logical_size() * 8, cgen_state_->context_);
-    group_key = cgen_state_->emitExternalCall(
-        array_at_fname,
-        ar_ret_ty,
-        {group_key, code_generator.posArg(arr_expr), array_idx});
+    group_key = cgen_state_->ir_builder_.CreateLoad(
+        cgen_state_->ir_builder_.CreateGEP(array_buff, array_idx));
     if (need_patch_unnest_double(
             elem_ti, isArchMaxwell(co.device_type), thread_mem_shared)) {
       key_to_cache = spillDoubleElement(group_key, ar_ret_ty);
@@ -27,6 +27,7 @@
 #include "RuntimeFunctions.h"
 
 #include <boost/multiprecision/cpp_int.hpp>
+#include <algorithm>
 #include <limits>
 
 using checked_int64_t = boost::multiprecision::number<
@@ -36,6 +37,15 @@ using checked_int64_t = boost::multiprecision::number<
                                            boost::multiprecision::checked,
                                            void>>;
 
+namespace {
+
+// Above it, a bitmap more than kMaxBitmapToArrayRatio times larger than the sorted array
+// of the values is replaced by the latter
+constexpr size_t kMinSparseBitmapBytes{size_t(1) << 20};
+constexpr size_t kMaxBitmapToArrayRatio{8};
+
+}  // namespace
+
 InValuesBitmap::InValuesBitmap(const std::vector<int64_t>& values,
                                const int64_t null_val,
                                const Data_Namespace::MemoryLevel memory_level,
@@ -76,18 +86,42 @@ InValuesBitmap::InValuesBitmap(const std::vector<int64_t>& values,
     return;
   }
   const int64_t MAX_BITMAP_BITS{8 * 1000 * 1000 * 1000L};
-  const auto bitmap_sz_bits =
-      static_cast<int64_t>(checked_int64_t(max_val_) - min_val_ + 1);
-  if (bitmap_sz_bits > MAX_BITMAP_BITS) {
-    throw FailedToCreateBitmap();
+  int64_t bitmap_sz_bits{std::numeric_limits<int64_t>::max()};
+  try {
+    bitmap_sz_bits = static_cast<int64_t>(checked_int64_t(max_val_) - min_val_ + 1);
+  } catch (...) {
+    // the range of the values doesn't fit in 64 bits, only a sorted array will do
   }
-  const auto bitmap_sz_bytes = bitmap_bits_to_bytes(bitmap_sz_bits);
-  auto cpu_bitset = static_cast<int8_t*>(checked_calloc(bitmap_sz_bytes, 1));
-  for (const auto value : values) {
-    if (value == null_val) {
-      continue;
+  size_t bitmap_sz_bytes{0};
+  int8_t* cpu_bitset{nullptr};
+  const auto sorted_array_bytes = values.size() * sizeof(int64_t);
+  if (bitmap_sz_bits > MAX_BITMAP_BITS ||
+      (bitmap_bits_to_bytes(bitmap_sz_bits) > kMinSparseBitmapBytes &&
+       bitmap_bits_to_bytes(bitmap_sz_bits) >
+           kMaxBitmapToArrayRatio * sorted_array_bytes)) {
+    std::vector<int64_t> sorted_values;
+    sorted_values.reserve(values.size());
+    std::copy_if(values.begin(),
+                 values.end(),
+                 std::back_inserter(sorted_values),
+                 [null_val](const int64_t value) { return value != null_val; });
+    std::sort(sorted_values.begin(), sorted_values.end());
+    sorted_values.erase(std::unique(sorted_values.begin(), sorted_values.end()),
+                        sorted_values.end());
+    sorted_value_count_ = sorted_values.size();
+    bitmap_sz_bytes = sorted_value_count_ * sizeof(int64_t);
+    cpu_bitset = static_cast<int8_t*>(checked_malloc(bitmap_sz_bytes));
+    memcpy(cpu_bitset, sorted_values.data(), bitmap_sz_bytes);
+  } else {
+    bitmap_sz_bytes = bitmap_bits_to_bytes(bitmap_sz_bits);
+    cpu_bitset = static_cast<int8_t*>(checked_calloc(bitmap_sz_bytes, 1));
+    for (const auto value : values) {
+      if (value == null_val) {
+        continue;
+      }
+      agg_count_distinct_bitmap(
+          reinterpret_cast<int64_t*>(&cpu_bitset), value, min_val_);
     }
-    agg_count_distinct_bitmap(reinterpret_cast<int64_t*>(&cpu_bitset), value, min_val_);
   }
 #ifdef HAVE_CUDA
   if (memory_level_ == Data_Namespace::GPU_LEVEL) {
@@ -156,6 +190,15 @@ llvm::Value* InValuesBitmap::codegen(llvm::Value* needle, Executor* executor) co
   const auto bitset_handle_lvs =
       code_generator.codegenHoistedConstants(constants, kENCODING_NONE, 0);
   CHECK_EQ(size_t(1), bitset_handle_lvs.size());
+  if (isSortedArray()) {
+    return executor->cgen_state_->emitCall(
+        "sorted_set_contains",
+        {executor->cgen_state_->castToTypeIn(bitset_handle_lvs.front(), 64),
+         executor->cgen_state_->llInt(static_cast<int64_t>(sorted_value_count_)),
+         needle_i64,
+         executor->cgen_state_->llInt(null_val_),
+         executor->cgen_state_->llInt(null_bool_val)});
+  }
   return executor->cgen_state_->emitCall(
       "bit_is_set",
       {executor->cgen_state_->castToTypeIn(bitset_handle_lvs.front(), 64),
@@ -39,6 +39,10 @@ class FailedToCreateBitmap : public std::runtime_error {
   FailedToCreateBitmap() : std::runtime_error("FailedToCreateBitmap") {}
 };
 
+/**
+ * The integer values of an IN list or subquery, as a bitmap over their range, or as a
+ * sorted array binary searched when the range is too sparse for a bitmap
+ */
 class InValuesBitmap {
  public:
   InValuesBitmap(const std::vector<int64_t>& values,
@@ -56,12 +60,16 @@ class InValuesBitmap {
 
   size_t gpuBuffers() const { return gpu_buffers_.size(); }
 
+  bool isSortedArray() const { return sorted_value_count_ > 0; }
+
  private:
   std::vector<Data_Namespace::AbstractBuffer*> gpu_buffers_;
   std::vector<int8_t*> bitsets_;
   bool rhs_has_null_;
   int64_t min_val_;
   int64_t max_val_;
+  // of the sorted array, zero for a bitmap
+  size_t sorted_value_count_{0};
   const int64_t null_val_;
   const Data_Namespace::MemoryLevel memory_level_;
   const int device_count_;
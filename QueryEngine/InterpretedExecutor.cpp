@@ -0,0 +1,791 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/InterpretedExecutor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <optional>
+#include <unordered_map>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/OutputBufferInitialization.h"
+#include "Shared/thread_count.h"
+#include "Utils/ChunkIter.h"
+#include "Utils/StringLike.h"
+
+bool g_enable_interpreted_interop{true};
+
+namespace {
+
+// the fragments smaller than this are interpreted by the thread of their kernel
+constexpr size_t kMinRowsPerThread{1 << 16};
+
+struct Value {
+  enum class Kind { Null, Int, Fp, Str };
+
+  Kind kind{Kind::Null};
+  int64_t int_val{0};
+  double fp_val{0};
+  std::string str_val;
+
+  bool isNull() const { return kind == Kind::Null; }
+
+  double asFp() const { return kind == Kind::Fp ? fp_val : static_cast<double>(int_val); }
+};
+
+Value make_int(const int64_t val) {
+  Value value;
+  value.kind = Value::Kind::Int;
+  value.int_val = val;
+  return value;
+}
+
+Value make_bool(const bool val) {
+  return make_int(val ? 1 : 0);
+}
+
+Value make_fp(const double val) {
+  Value value;
+  value.kind = Value::Kind::Fp;
+  value.fp_val = val;
+  return value;
+}
+
+Value make_str(std::string val) {
+  Value value;
+  value.kind = Value::Kind::Str;
+  value.str_val = std::move(val);
+  return value;
+}
+
+const std::string overflow_message{"Overflow or underflow"};
+
+int64_t check_int_range(const int64_t val, const SQLTypeInfo& ti) {
+  if (ti.is_boolean()) {
+    return val;
+  }
+  const auto limits = inline_int_max_min(ti.get_logical_size());
+  if (val > limits.first || val < limits.second) {
+    throw std::runtime_error(overflow_message);
+  }
+  return val;
+}
+
+bool is_interpretable_type(const SQLTypeInfo& ti) {
+  return ti.is_boolean() || is_supported_type_for_extern_execution(ti);
+}
+
+int64_t read_int(const int8_t* buffer, const size_t byte_width, const size_t row) {
+  switch (byte_width) {
+    case 1:
+      return buffer[row];
+    case 2:
+      return reinterpret_cast<const int16_t*>(buffer)[row];
+    case 4:
+      return reinterpret_cast<const int32_t*>(buffer)[row];
+    case 8:
+      return reinterpret_cast<const int64_t*>(buffer)[row];
+    default:
+      LOG(FATAL) << "Invalid integer width: " << byte_width;
+      return 0;
+  }
+}
+
+template <class T>
+Value read_dictionary_string(const int8_t* buffer,
+                             const size_t row,
+                             const StringDictionaryProxy* sdp) {
+  const auto string_id = reinterpret_cast<const T*>(buffer)[row];
+  if (string_id == inline_int_null_value<T>()) {
+    return {};
+  }
+  const auto str = sdp->getStringBytes(string_id);
+  return make_str(std::string(str.first, str.second));
+}
+
+// SUBSTR of SQLite: a start position below one counts from the end and a negative length
+// takes the characters before the start position
+std::string substring(const std::string& str,
+                      const int64_t start,
+                      const std::optional<int64_t>& length) {
+  const int64_t str_size = str.size();
+  int64_t begin = start > 0 ? start - 1 : (start < 0 ? str_size + start : -1);
+  int64_t end = str_size;
+  if (length) {
+    end = begin + *length;
+    if (*length < 0) {
+      std::swap(begin, end);
+    }
+  }
+  begin = std::clamp(begin, int64_t(0), str_size);
+  end = std::clamp(end, begin, str_size);
+  return str.substr(begin, end - begin);
+}
+
+bool compare(const Value& lhs, const Value& rhs, const SQLOps optype) {
+  int cmp{0};
+  if (lhs.kind == Value::Kind::Str) {
+    cmp = lhs.str_val.compare(rhs.str_val);
+  } else if (lhs.kind == Value::Kind::Fp || rhs.kind == Value::Kind::Fp) {
+    const auto lhs_val = lhs.asFp();
+    const auto rhs_val = rhs.asFp();
+    cmp = lhs_val < rhs_val ? -1 : (lhs_val > rhs_val ? 1 : 0);
+  } else {
+    cmp = lhs.int_val < rhs.int_val ? -1 : (lhs.int_val > rhs.int_val ? 1 : 0);
+  }
+  switch (optype) {
+    case kEQ:
+      return cmp == 0;
+    case kNE:
+      return cmp != 0;
+    case kLT:
+      return cmp < 0;
+    case kLE:
+      return cmp <= 0;
+    case kGT:
+      return cmp > 0;
+    case kGE:
+      return cmp >= 0;
+    default:
+      UNREACHABLE();
+      return false;
+  }
+}
+
+Value arithmetic(const Value& lhs,
+                 const Value& rhs,
+                 const SQLOps optype,
+                 const SQLTypeInfo& ti) {
+  if ((optype == kDIVIDE || optype == kMODULO) && rhs.asFp() == 0) {
+    throw std::runtime_error("Division by zero");
+  }
+  if (ti.is_fp()) {
+    const auto lhs_val = lhs.asFp();
+    const auto rhs_val = rhs.asFp();
+    switch (optype) {
+      case kPLUS:
+        return make_fp(lhs_val + rhs_val);
+      case kMINUS:
+        return make_fp(lhs_val - rhs_val);
+      case kMULTIPLY:
+        return make_fp(lhs_val * rhs_val);
+      case kDIVIDE:
+        return make_fp(lhs_val / rhs_val);
+      case kMODULO:
+        return make_fp(std::fmod(lhs_val, rhs_val));
+      default:
+        UNREACHABLE();
+        return {};
+    }
+  }
+  int64_t result{0};
+  bool overflow{false};
+  switch (optype) {
+    case kPLUS:
+      overflow = __builtin_add_overflow(lhs.int_val, rhs.int_val, &result);
+      break;
+    case kMINUS:
+      overflow = __builtin_sub_overflow(lhs.int_val, rhs.int_val, &result);
+      break;
+    case kMULTIPLY:
+      overflow = __builtin_mul_overflow(lhs.int_val, rhs.int_val, &result);
+      break;
+    case kDIVIDE:
+      result = lhs.int_val / rhs.int_val;
+      break;
+    case kMODULO:
+      result = lhs.int_val % rhs.int_val;
+      break;
+    default:
+      UNREACHABLE();
+  }
+  if (overflow) {
+    throw std::runtime_error(overflow_message);
+  }
+  return make_int(check_int_range(result, ti));
+}
+
+Value cast(Value value, const SQLTypeInfo& ti) {
+  if (value.isNull() || ti.is_string()) {
+    return value;
+  }
+  if (ti.is_fp()) {
+    return make_fp(value.asFp());
+  }
+  if (ti.is_boolean()) {
+    return make_bool(value.int_val);
+  }
+  return make_int(check_int_range(value.int_val, ti));
+}
+
+// An input column of the fragment, with the dictionary of its strings if it has one
+struct InputColumn {
+  const int8_t* buffer;
+  SQLTypeInfo ti;
+  const StringDictionaryProxy* sdp;
+};
+
+class RowInterpreter {
+ public:
+  RowInterpreter(const FetchResult& fetch_result,
+                 PlanState* plan_state,
+                 const Executor* executor)
+      : fetch_result_(fetch_result), plan_state_(plan_state), executor_(executor) {}
+
+  // Whether expr can be interpreted, also resolves the input columns it reads. Must be
+  // called for all the expressions before evaluating any of them.
+  bool bind(const Analyzer::Expr* expr);
+
+  Value eval(const Analyzer::Expr* expr, const size_t row) const;
+
+ private:
+  bool bindColumn(const Analyzer::ColumnVar* col_var);
+
+  Value evalColumn(const Analyzer::ColumnVar* col_var, const size_t row) const;
+  Value evalUOper(const Analyzer::UOper* uoper, const size_t row) const;
+  Value evalBinOper(const Analyzer::BinOper* bin_oper, const size_t row) const;
+  Value evalInValues(const Analyzer::InValues* in_values, const size_t row) const;
+  Value evalLikeExpr(const Analyzer::LikeExpr* like, const size_t row) const;
+  Value evalCaseExpr(const Analyzer::CaseExpr* case_, const size_t row) const;
+  Value evalFunctionOper(const Analyzer::FunctionOper* func_oper, const size_t row) const;
+
+  const FetchResult& fetch_result_;
+  PlanState* plan_state_;
+  const Executor* executor_;
+  std::unordered_map<const Analyzer::ColumnVar*, InputColumn> columns_;
+};
+
+const std::string* get_string_constant(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null() || !constant->get_type_info().is_string()) {
+    return nullptr;
+  }
+  return constant->get_constval().stringval;
+}
+
+bool RowInterpreter::bind(const Analyzer::Expr* expr) {
+  if (!expr || !is_interpretable_type(expr->get_type_info()) ||
+      dynamic_cast<const Analyzer::Var*>(expr)) {
+    return false;
+  }
+  if (const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+    return bindColumn(col_var);
+  }
+  if (dynamic_cast<const Analyzer::Constant*>(expr)) {
+    return true;
+  }
+  if (const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+    const auto operand = uoper->get_operand();
+    switch (uoper->get_optype()) {
+      case kNOT:
+      case kUMINUS:
+      case kISNULL:
+        return bind(operand);
+      case kCAST: {
+        const auto& operand_ti = operand->get_type_info();
+        const auto& ti = uoper->get_type_info();
+        // the native casts of the floating point values to integers round them
+        if (operand_ti.is_string() != ti.is_string() ||
+            (operand_ti.is_fp() && !ti.is_fp())) {
+          return false;
+        }
+        return bind(operand);
+      }
+      default:
+        return false;
+    }
+  }
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+    if (bin_oper->get_qualifier() != kONE) {
+      return false;
+    }
+    switch (bin_oper->get_optype()) {
+      case kEQ:
+      case kNE:
+      case kLT:
+      case kLE:
+      case kGT:
+      case kGE:
+      case kAND:
+      case kOR:
+      case kPLUS:
+      case kMINUS:
+      case kMULTIPLY:
+      case kDIVIDE:
+      case kMODULO:
+        return bind(bin_oper->get_left_operand()) && bind(bin_oper->get_right_operand());
+      default:
+        return false;
+    }
+  }
+  if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(expr)) {
+    const auto& value_list = in_values->get_value_list();
+    return bind(in_values->get_arg()) &&
+           std::all_of(value_list.begin(), value_list.end(), [this](const auto& value) {
+             return bind(value.get());
+           });
+  }
+  if (const auto like = dynamic_cast<const Analyzer::LikeExpr*>(expr)) {
+    const auto escape_expr = like->get_escape_expr();
+    if (!get_string_constant(like->get_like_expr())) {
+      return false;
+    }
+    if (escape_expr) {
+      const auto escape = get_string_constant(escape_expr);
+      if (!escape || escape->empty()) {
+        return false;
+      }
+    }
+    return bind(like->get_arg());
+  }
+  if (const auto case_ = dynamic_cast<const Analyzer::CaseExpr*>(expr)) {
+    for (const auto& expr_pair : case_->get_expr_pair_list()) {
+      if (!bind(expr_pair.first.get()) || !bind(expr_pair.second.get())) {
+        return false;
+      }
+    }
+    return !case_->get_else_expr() || bind(case_->get_else_expr());
+  }
+  if (const auto func_oper = dynamic_cast<const Analyzer::FunctionOper*>(expr)) {
+    const auto& name = func_oper->getName();
+    const auto arity = func_oper->getArity();
+    if (!(name == "||" && arity == 2) &&
+        !(name == "SUBSTRING" && (arity == 2 || arity == 3))) {
+      return false;
+    }
+    for (size_t i = 0; i < arity; ++i) {
+      if (!bind(func_oper->getArg(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+bool RowInterpreter::bindColumn(const Analyzer::ColumnVar* col_var) {
+  const auto& ti = col_var->get_type_info();
+  switch (ti.get_compression()) {
+    case kENCODING_NONE:
+      break;
+    case kENCODING_FIXED:
+      if (!ti.is_integer()) {
+        return false;
+      }
+      break;
+    case kENCODING_DICT:
+      if (!ti.is_string()) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  const auto local_col_id = plan_state_->getLocalColumnId(col_var, false);
+  CHECK_EQ(fetch_result_.col_buffers.size(), size_t(1));
+  CHECK_LT(static_cast<size_t>(local_col_id), fetch_result_.col_buffers.front().size());
+  InputColumn column{fetch_result_.col_buffers.front()[local_col_id], ti, nullptr};
+  if (ti.is_string() && ti.get_compression() == kENCODING_DICT) {
+    column.sdp = executor_->getStringDictionaryProxy(
+        ti.get_comp_param(), executor_->getRowSetMemoryOwner(), true);
+    CHECK(column.sdp);
+  }
+  columns_.emplace(col_var, column);
+  return true;
+}
+
+Value RowInterpreter::eval(const Analyzer::Expr* expr, const size_t row) const {
+  if (const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr)) {
+    return evalColumn(col_var, row);
+  }
+  if (const auto constant = dynamic_cast<const Analyzer::Constant*>(expr)) {
+    if (constant->get_is_null()) {
+      return {};
+    }
+    const auto& ti = constant->get_type_info();
+    const auto& datum = constant->get_constval();
+    switch (ti.get_type()) {
+      case kBOOLEAN:
+        return make_bool(datum.boolval);
+      case kTINYINT:
+        return make_int(datum.tinyintval);
+      case kSMALLINT:
+        return make_int(datum.smallintval);
+      case kINT:
+        return make_int(datum.intval);
+      case kBIGINT:
+        return make_int(datum.bigintval);
+      case kFLOAT:
+        return make_fp(datum.floatval);
+      case kDOUBLE:
+        return make_fp(datum.doubleval);
+      default:
+        CHECK(ti.is_string() && datum.stringval);
+        return make_str(*datum.stringval);
+    }
+  }
+  if (const auto uoper = dynamic_cast<const Analyzer::UOper*>(expr)) {
+    return evalUOper(uoper, row);
+  }
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(expr)) {
+    return evalBinOper(bin_oper, row);
+  }
+  if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(expr)) {
+    return evalInValues(in_values, row);
+  }
+  if (const auto like = dynamic_cast<const Analyzer::LikeExpr*>(expr)) {
+    return evalLikeExpr(like, row);
+  }
+  if (const auto case_ = dynamic_cast<const Analyzer::CaseExpr*>(expr)) {
+    return evalCaseExpr(case_, row);
+  }
+  const auto func_oper = dynamic_cast<const Analyzer::FunctionOper*>(expr);
+  CHECK(func_oper);
+  return evalFunctionOper(func_oper, row);
+}
+
+Value RowInterpreter::evalColumn(const Analyzer::ColumnVar* col_var,
+                                 const size_t row) const {
+  const auto it = columns_.find(col_var);
+  CHECK(it != columns_.end());
+  const auto& column = it->second;
+  const auto& ti = column.ti;
+  if (ti.get_type() == kFLOAT) {
+    const auto val = reinterpret_cast<const float*>(column.buffer)[row];
+    return val == inline_fp_null_value<float>() ? Value{} : make_fp(val);
+  }
+  if (ti.get_type() == kDOUBLE) {
+    const auto val = reinterpret_cast<const double*>(column.buffer)[row];
+    return val == inline_fp_null_value<double>() ? Value{} : make_fp(val);
+  }
+  if (ti.is_string()) {
+    if (column.sdp) {
+      switch (ti.get_size()) {
+        case 1:
+          return read_dictionary_string<uint8_t>(column.buffer, row, column.sdp);
+        case 2:
+          return read_dictionary_string<uint16_t>(column.buffer, row, column.sdp);
+        case 4:
+          return read_dictionary_string<int32_t>(column.buffer, row, column.sdp);
+        default:
+          LOG(FATAL) << "Invalid encoding size: " << ti.get_size();
+          return {};
+      }
+    }
+    // only reads the iterator, the kernel threads share it
+    const auto chunk_iter =
+        const_cast<ChunkIter*>(reinterpret_cast<const ChunkIter*>(column.buffer));
+    VarlenDatum vd;
+    bool is_end;
+    ChunkIter_get_nth(chunk_iter, static_cast<int>(row), false, &vd, &is_end);
+    return vd.is_null ? Value{}
+                      : make_str(std::string(reinterpret_cast<const char*>(vd.pointer),
+                                             vd.length));
+  }
+  const bool is_fixed_encoded = ti.get_compression() == kENCODING_FIXED;
+  const auto val =
+      read_int(column.buffer,
+               is_fixed_encoded ? ti.get_comp_param() / 8 : ti.get_logical_size(),
+               row);
+  const auto null_val =
+      is_fixed_encoded ? inline_fixed_encoding_null_val(ti) : inline_int_null_val(ti);
+  return val == null_val ? Value{} : make_int(val);
+}
+
+Value RowInterpreter::evalUOper(const Analyzer::UOper* uoper, const size_t row) const {
+  auto operand = eval(uoper->get_operand(), row);
+  switch (uoper->get_optype()) {
+    case kISNULL:
+      return make_bool(operand.isNull());
+    case kNOT:
+      return operand.isNull() ? Value{} : make_bool(!operand.int_val);
+    case kUMINUS:
+      if (operand.isNull()) {
+        return {};
+      }
+      if (operand.kind == Value::Kind::Fp) {
+        return make_fp(-operand.fp_val);
+      }
+      return make_int(check_int_range(-operand.int_val, uoper->get_type_info()));
+    case kCAST:
+      return cast(std::move(operand), uoper->get_type_info());
+    default:
+      UNREACHABLE();
+      return {};
+  }
+}
+
+Value RowInterpreter::evalBinOper(const Analyzer::BinOper* bin_oper,
+                                  const size_t row) const {
+  const auto optype = bin_oper->get_optype();
+  const auto lhs = eval(bin_oper->get_left_operand(), row);
+  if (optype == kAND || optype == kOR) {
+    // false decides an AND and true an OR, whatever the other operand is
+    const bool decisive = optype == kOR;
+    if (!lhs.isNull() && static_cast<bool>(lhs.int_val) == decisive) {
+      return make_bool(decisive);
+    }
+    const auto rhs = eval(bin_oper->get_right_operand(), row);
+    if (!rhs.isNull() && static_cast<bool>(rhs.int_val) == decisive) {
+      return make_bool(decisive);
+    }
+    return lhs.isNull() || rhs.isNull() ? Value{} : make_bool(!decisive);
+  }
+  const auto rhs = eval(bin_oper->get_right_operand(), row);
+  if (lhs.isNull() || rhs.isNull()) {
+    return {};
+  }
+  switch (optype) {
+    case kEQ:
+    case kNE:
+    case kLT:
+    case kLE:
+    case kGT:
+    case kGE:
+      return make_bool(compare(lhs, rhs, optype));
+    default:
+      return arithmetic(lhs, rhs, optype, bin_oper->get_type_info());
+  }
+}
+
+Value RowInterpreter::evalInValues(const Analyzer::InValues* in_values,
+                                   const size_t row) const {
+  const auto arg = eval(in_values->get_arg(), row);
+  if (arg.isNull()) {
+    return {};
+  }
+  bool has_null{false};
+  for (const auto& value_expr : in_values->get_value_list()) {
+    const auto value = eval(value_expr.get(), row);
+    if (value.isNull()) {
+      has_null = true;
+    } else if (compare(arg, value, kEQ)) {
+      return make_bool(true);
+    }
+  }
+  return has_null ? Value{} : make_bool(false);
+}
+
+Value RowInterpreter::evalLikeExpr(const Analyzer::LikeExpr* like,
+                                   const size_t row) const {
+  const auto arg = eval(like->get_arg(), row);
+  if (arg.isNull()) {
+    return {};
+  }
+  // the patterns of ILIKE are lowercase already
+  const auto& pattern = *get_string_constant(like->get_like_expr());
+  const auto& str = arg.str_val;
+  if (like->get_is_simple()) {
+    return make_bool(
+        like->get_is_ilike()
+            ? string_ilike_simple(str.c_str(), str.size(), pattern.c_str(), pattern.size())
+            : string_like_simple(str.c_str(), str.size(), pattern.c_str(), pattern.size()));
+  }
+  const char escape_char =
+      like->get_escape_expr() ? get_string_constant(like->get_escape_expr())->front()
+                              : '\\';
+  return make_bool(
+      like->get_is_ilike()
+          ? string_ilike(
+                str.c_str(), str.size(), pattern.c_str(), pattern.size(), escape_char)
+          : string_like(
+                str.c_str(), str.size(), pattern.c_str(), pattern.size(), escape_char));
+}
+
+Value RowInterpreter::evalCaseExpr(const Analyzer::CaseExpr* case_,
+                                   const size_t row) const {
+  for (const auto& expr_pair : case_->get_expr_pair_list()) {
+    const auto when = eval(expr_pair.first.get(), row);
+    if (!when.isNull() && when.int_val) {
+      return cast(eval(expr_pair.second.get(), row), case_->get_type_info());
+    }
+  }
+  return case_->get_else_expr()
+             ? cast(eval(case_->get_else_expr(), row), case_->get_type_info())
+             : Value{};
+}
+
+Value RowInterpreter::evalFunctionOper(const Analyzer::FunctionOper* func_oper,
+                                       const size_t row) const {
+  std::vector<Value> args;
+  for (size_t i = 0; i < func_oper->getArity(); ++i) {
+    args.push_back(eval(func_oper->getArg(i), row));
+    if (args.back().isNull()) {
+      return {};
+    }
+  }
+  if (func_oper->getName() == "||") {
+    return make_str(args[0].str_val + args[1].str_val);
+  }
+  CHECK_EQ(func_oper->getName(), "SUBSTRING");
+  return make_str(substring(
+      args[0].str_val,
+      args[1].int_val,
+      args.size() > 2 ? std::make_optional(args[2].int_val) : std::nullopt));
+}
+
+// Writes value into the slots of target the way SqliteMemDatabase::runSelect does
+void write_target(int64_t* row,
+                  size_t& slot_idx,
+                  const Value& value,
+                  const SQLTypeInfo& ti,
+                  RowSetMemoryOwner& row_set_mem_owner) {
+  if (ti.is_fp()) {
+    reinterpret_cast<double*>(row)[slot_idx] =
+        value.isNull() ? (ti.get_type() == kFLOAT ? inline_fp_null_value<float>()
+                                                  : inline_fp_null_value<double>())
+                       : value.asFp();
+    return;
+  }
+  if (ti.is_string()) {
+    if (value.isNull()) {
+      row[slot_idx] = 0;
+      row[++slot_idx] = 0;
+    } else {
+      const auto owned_str = row_set_mem_owner.addString(value.str_val);
+      row[slot_idx] = reinterpret_cast<int64_t>(owned_str->c_str());
+      row[++slot_idx] = value.str_val.size();
+    }
+    return;
+  }
+  row[slot_idx] = value.isNull() ? inline_int_null_val(ti) : value.int_val;
+}
+
+// The [begin, end) ranges of the slices of row_count rows, one per CPU thread for the
+// large fragments
+std::vector<std::pair<size_t, size_t>> get_row_slices(const size_t row_count) {
+  const size_t slice_count =
+      std::max(std::min(row_count / kMinRowsPerThread,
+                        static_cast<size_t>(std::max(cpu_threads(), 1))),
+               size_t(1));
+  const size_t slice_size = (row_count + slice_count - 1) / slice_count;
+  std::vector<std::pair<size_t, size_t>> slices;
+  for (size_t slice_idx = 0; slice_idx < slice_count; ++slice_idx) {
+    const size_t begin = std::min(slice_idx * slice_size, row_count);
+    slices.emplace_back(begin, std::min(begin + slice_size, row_count));
+  }
+  return slices;
+}
+
+void run_on_slices(const size_t slice_count, const std::function<void(size_t)>& func) {
+  if (slice_count == 1) {
+    func(0);
+    return;
+  }
+  std::vector<std::future<void>> slice_runs;
+  for (size_t slice_idx = 0; slice_idx < slice_count; ++slice_idx) {
+    slice_runs.push_back(std::async(std::launch::async, func, slice_idx));
+  }
+  for (auto& slice_run : slice_runs) {
+    slice_run.wait();
+  }
+  for (auto& slice_run : slice_runs) {
+    slice_run.get();
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<ResultSet> run_query_interpreted(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const FetchResult& fetch_result,
+    PlanState* plan_state,
+    const ExternalQueryOutputSpec& output_spec) {
+  if (ra_exe_unit.input_descs.size() != 1 || ra_exe_unit.groupby_exprs.size() != 1 ||
+      ra_exe_unit.groupby_exprs.front()) {
+    return nullptr;
+  }
+  RowInterpreter interpreter(fetch_result, plan_state, output_spec.executor);
+  std::vector<const Analyzer::Expr*> quals;
+  for (const auto& qual : ra_exe_unit.quals) {
+    quals.push_back(qual.get());
+  }
+  for (const auto& qual : ra_exe_unit.simple_quals) {
+    quals.push_back(qual.get());
+  }
+  for (const auto qual : quals) {
+    if (!interpreter.bind(qual)) {
+      return nullptr;
+    }
+  }
+  CHECK_EQ(ra_exe_unit.target_exprs.size(), output_spec.target_infos.size());
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto& ti = target_expr->get_type_info();
+    // the output holds the strings themselves, like the results of SQLite
+    if ((ti.is_string() && ti.get_compression() != kENCODING_NONE) ||
+        !interpreter.bind(target_expr)) {
+      return nullptr;
+    }
+  }
+
+  CHECK_EQ(fetch_result.num_rows.size(), size_t(1));
+  CHECK_EQ(fetch_result.num_rows.front().size(), size_t(1));
+  const size_t input_row_count = fetch_result.num_rows.front().front();
+  const auto slices = get_row_slices(input_row_count);
+  // the filter runs first, so that the output is allocated for the selected rows only
+  std::vector<std::vector<size_t>> slice_rows(slices.size());
+  run_on_slices(slices.size(), [&](const size_t slice_idx) {
+    for (size_t row = slices[slice_idx].first; row < slices[slice_idx].second; ++row) {
+      const bool selected = std::all_of(quals.begin(), quals.end(), [&](const auto qual) {
+        const auto val = interpreter.eval(qual, row);
+        return !val.isNull() && val.int_val;
+      });
+      if (selected) {
+        slice_rows[slice_idx].push_back(row);
+      }
+    }
+  });
+
+  std::vector<size_t> slice_offsets;
+  size_t output_row_count{0};
+  for (const auto& rows : slice_rows) {
+    slice_offsets.push_back(output_row_count);
+    output_row_count += rows.size();
+  }
+  auto query_mem_desc = output_spec.query_mem_desc;
+  query_mem_desc.setEntryCount(output_row_count);
+  auto row_set_mem_owner = output_spec.executor->getRowSetMemoryOwner();
+  auto rs = std::make_unique<ResultSet>(output_spec.target_infos,
+                                        ExecutorDeviceType::CPU,
+                                        query_mem_desc,
+                                        row_set_mem_owner,
+                                        nullptr);
+  const auto storage = rs->allocateStorage();
+  auto output_buffer = reinterpret_cast<int64_t*>(storage->getUnderlyingBuffer());
+  CHECK(!output_row_count || output_buffer);
+  const size_t row_size_quad = query_mem_desc.getRowSize() / sizeof(int64_t);
+  run_on_slices(slices.size(), [&](const size_t slice_idx) {
+    auto output_row_idx = slice_offsets[slice_idx];
+    for (const auto row : slice_rows[slice_idx]) {
+      auto output_row = get_scan_output_slot(
+          output_buffer, output_row_count, output_row_idx++, row_size_quad);
+      size_t slot_idx = 0;
+      for (size_t target_idx = 0; target_idx < ra_exe_unit.target_exprs.size();
+           ++target_idx, ++slot_idx) {
+        write_target(output_row,
+                     slot_idx,
+                     interpreter.eval(ra_exe_unit.target_exprs[target_idx], row),
+                     output_spec.target_infos[target_idx].sql_type,
+                     *row_set_mem_owner);
+      }
+    }
+  });
+  return rs;
+}
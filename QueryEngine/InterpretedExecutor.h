@@ -0,0 +1,43 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    InterpretedExecutor.h
+ * @brief   Interpreter of the steps the native code generator can't compile
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "QueryEngine/ExternalExecutor.h"
+
+extern bool g_enable_interpreted_interop;
+
+struct RelAlgExecutionUnit;
+
+/**
+ * Runs the filter and the projection of ra_exe_unit on the fragment of its single input
+ * in fetch_result, evaluating the expressions row by row on all the CPU threads instead
+ * of going through SQLite a row at a time. The output has the layout of the results of
+ * run_query_external. Returns nullptr when the step has an expression, a type or an
+ * encoding the interpreter doesn't handle; the callers fall back to SQLite then.
+ */
+std::unique_ptr<ResultSet> run_query_interpreted(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const FetchResult& fetch_result,
+    PlanState* plan_state,
+    const ExternalQueryOutputSpec& output_spec);
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JitObjectCache.h"
+
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "Logger/Logger.h"
+
+bool g_enable_jit_object_cache{false};
+std::string g_jit_object_cache_path;
+size_t g_jit_object_cache_entry_limit{4096};
+
+JitObjectCache* JitObjectCache::get() {
+  if (!g_enable_jit_object_cache || g_jit_object_cache_path.empty()) {
+    return nullptr;
+  }
+  static JitObjectCache* cache = []() -> JitObjectCache* {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(g_jit_object_cache_path, ec);
+    if (ec) {
+      LOG(WARNING) << "Disabling the JIT object cache, could not create "
+                   << g_jit_object_cache_path << ": " << ec.message();
+      return nullptr;
+    }
+    return new JitObjectCache(g_jit_object_cache_path);
+  }();
+  return cache;
+}
+
+std::string JitObjectCache::getObjectName(const CodeCacheKey& key,
+                                          const std::string& target,
+                                          const std::string& extension) {
+  // two independent 64-bit hashes, the IR of a collision would have to match both
+  std::string serialized = target;
+  for (const auto& part : key) {
+    serialized += '\0';
+    serialized += part;
+  }
+  const uint64_t std_hash = std::hash<std::string>{}(serialized);
+  const uint64_t boost_hash = boost::hash_range(serialized.begin(), serialized.end());
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0') << std::setw(16) << std_hash << std::setw(16)
+      << boost_hash << extension;
+  return oss.str();
+}
+
+bool JitObjectCache::contains(const std::string& name) const {
+  boost::system::error_code ec;
+  return boost::filesystem::is_regular_file(dir_ / name, ec);
+}
+
+std::optional<std::string> JitObjectCache::read(const std::string& name) const {
+  const auto file_path = dir_ / name;
+  std::ifstream file(file_path.string(), std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  if (!file) {
+    LOG(WARNING) << "Could not read the cached JIT object " << file_path.string();
+    return std::nullopt;
+  }
+  // the modification times order the least recently used files for the eviction
+  boost::system::error_code ec;
+  boost::filesystem::last_write_time(file_path, std::time(nullptr), ec);
+  VLOG(1) << "Read the cached JIT object " << name;
+  return contents.str();
+}
+
+void JitObjectCache::write(const std::string& name, const llvm::StringRef contents) {
+  const auto file_path = dir_ / name;
+  // other servers may share the directory, only complete files get the final name
+  const auto tmp_path =
+      dir_ / (name + ".tmp" + std::to_string(getpid()) + "_" +
+              std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+  {
+    std::ofstream file(tmp_path.string(), std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+    if (!file) {
+      LOG(WARNING) << "Could not write the JIT object " << tmp_path.string();
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp_path, ec);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path, file_path, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not write the JIT object " << file_path.string() << ": "
+                 << ec.message();
+    boost::filesystem::remove(tmp_path, ec);
+    return;
+  }
+  VLOG(1) << "Cached the JIT object " << name;
+  evictLeastRecentlyUsed();
+}
+
+void JitObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                          llvm::MemoryBufferRef obj) {
+  const auto& name = module->getModuleIdentifier();
+  if (name.empty() || contains(name)) {
+    return;
+  }
+  write(name, obj.getBuffer());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> JitObjectCache::getObject(
+    const llvm::Module* module) {
+  const auto& name = module->getModuleIdentifier();
+  if (name.empty()) {
+    return nullptr;
+  }
+  const auto contents = read(name);
+  if (!contents) {
+    return nullptr;
+  }
+  return llvm::MemoryBuffer::getMemBufferCopy(*contents, name);
+}
+
+void JitObjectCache::evictLeastRecentlyUsed() {
+  std::lock_guard<std::mutex> lock(evict_mutex_);
+  boost::system::error_code ec;
+  std::vector<std::pair<std::time_t, boost::filesystem::path>> entries;
+  for (boost::filesystem::directory_iterator it(dir_, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    if (!boost::filesystem::is_regular_file(it->status())) {
+      continue;
+    }
+    const auto& path = it->path();
+    if (path.filename().string().find(".tmp") != std::string::npos) {
+      continue;
+    }
+    boost::system::error_code time_ec;
+    const auto time = boost::filesystem::last_write_time(path, time_ec);
+    if (!time_ec) {
+      entries.emplace_back(time, path);
+    }
+  }
+  if (entries.size() <= g_jit_object_cache_entry_limit) {
+    return;
+  }
+  const size_t evicted_count = entries.size() - g_jit_object_cache_entry_limit;
+  std::partial_sort(entries.begin(), entries.begin() + evicted_count, entries.end());
+  for (size_t i = 0; i < evicted_count; ++i) {
+    boost::filesystem::remove(entries[i].second, ec);
+  }
+  VLOG(1) << "Evicted " << evicted_count << " cached JIT objects";
+}
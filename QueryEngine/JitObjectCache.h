@@ -0,0 +1,79 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    JitObjectCache.h
+ * @brief   On disk cache of the compiled query code, kept across restarts
+ */
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "QueryEngine/CodeCache.h"
+
+extern bool g_enable_jit_object_cache;
+extern std::string g_jit_object_cache_path;
+extern size_t g_jit_object_cache_entry_limit;
+
+/**
+ * Keeps the CPU objects generated by MCJIT and the PTX generated for the GPUs in files of
+ * g_jit_object_cache_path, named by a hash of the code cache key of the query and of the
+ * target. A restarted server reads the code of the queries it has seen instead of
+ * running the LLVM optimizations and code generation again. Past
+ * g_jit_object_cache_entry_limit files, the least recently used ones are removed. The
+ * UdfCompiler keeps the AST and the bitcode of the UDF files there too, named by their
+ * source and compiler.
+ *
+ * As an llvm::ObjectCache, the objects are named by the identifiers of the modules.
+ */
+class JitObjectCache : public llvm::ObjectCache {
+ public:
+  //! The cache of the process, null unless g_enable_jit_object_cache
+  static JitObjectCache* get();
+
+  //! The name of the code of key compiled for target, which combines the LLVM version
+  //! with e.g. the host CPU features or the GPU architecture
+  static std::string getObjectName(const CodeCacheKey& key,
+                                   const std::string& target,
+                                   const std::string& extension);
+
+  bool contains(const std::string& name) const;
+
+  std::optional<std::string> read(const std::string& name) const;
+
+  void write(const std::string& name, const llvm::StringRef contents);
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef obj) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+ private:
+  explicit JitObjectCache(const boost::filesystem::path& dir) : dir_(dir) {}
+
+  void evictLeastRecentlyUsed();
+
+  const boost::filesystem::path dir_;
+  std::mutex evict_mutex_;
+};
@@ -26,10 +26,18 @@
 #include "QueryEngine/JoinHashTable/HashJoinKeyHandlers.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableGpuUtils.h"
 
-std::vector<std::pair<BaselineJoinHashTable::HashTableCacheKey,
-                      BaselineJoinHashTable::HashTableCacheValue>>
-    BaselineJoinHashTable::hash_table_cache_;
-std::mutex BaselineJoinHashTable::hash_table_cache_mutex_;
+extern size_t g_baseline_hash_join_partition_bytes;
+
+namespace {
+
+// tables of fewer partitions fit the last level cache well enough to be filled directly
+constexpr size_t kMinHashJoinPartitions{32};
+
+}  // namespace
+
+HashTableCache<BaselineJoinHashTable::HashTableCacheKey,
+               BaselineJoinHashTable::HashTableCacheValue>
+    BaselineJoinHashTable::hash_table_cache_("baseline");
 
 //! Make hash table from an in-flight SQL query's parse tree etc.
 std::shared_ptr<BaselineJoinHashTable> BaselineJoinHashTable::getInstance(
@@ -701,8 +709,51 @@ int BaselineJoinHashTable::initHashTableOnCpu(
   for (auto& child : init_cpu_buff_threads) {
     child.get();
   }
+  const size_t partition_count = g_baseline_hash_join_partition_bytes
+                                     ? entry_size * entry_count_ /
+                                           g_baseline_hash_join_partition_bytes
+                                     : 0;
+  const bool fill_by_partitions = partition_count >= kMinHashJoinPartitions;
   std::vector<std::future<int>> fill_cpu_buff_threads;
-  for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+  if (fill_by_partitions) {
+    VLOG(1) << "Filling the CPU Join Hash Table by " << partition_count << " partitions";
+    fill_cpu_buff_threads.emplace_back(std::async(std::launch::async, [&] {
+      const auto key_handler =
+          GenericKeyHandler(key_component_count,
+                            true,
+                            &join_columns[0],
+                            &join_column_types[0],
+                            &composite_key_info.sd_inner_proxy_per_key[0],
+                            &composite_key_info.sd_outer_proxy_per_key[0]);
+      switch (key_component_width) {
+        case 4:
+          return fill_baseline_hash_join_buff_partitioned_32(
+              &(*cpu_hash_table_buff_)[0],
+              entry_count_,
+              -1,
+              key_component_count,
+              layout == JoinHashTableInterface::HashType::OneToOne,
+              &key_handler,
+              partition_count,
+              thread_count);
+        case 8:
+          return fill_baseline_hash_join_buff_partitioned_64(
+              &(*cpu_hash_table_buff_)[0],
+              entry_count_,
+              -1,
+              key_component_count,
+              layout == JoinHashTableInterface::HashType::OneToOne,
+              &key_handler,
+              partition_count,
+              thread_count);
+        default:
+          CHECK(false);
+      }
+      return -1;
+    }));
+  }
+  for (int thread_idx = 0; thread_idx < thread_count && !fill_by_partitions;
+       ++thread_idx) {
     fill_cpu_buff_threads.emplace_back(std::async(
         std::launch::async,
         [this,
@@ -990,6 +1041,7 @@ int BaselineJoinHashTable::initHashTableForDevice(
     VLOG(1) << "Total hash table size: " << hash_table_size << " Bytes";
     gpu_hash_table_buff_[device_id] =
         CudaAllocator::allocGpuAbstractBuffer(&data_mgr, hash_table_size, device_id);
+    trackGpuHashTableBuffer(executor_, gpu_hash_table_buff_[device_id]);
   }
 #else
   CHECK_EQ(Data_Namespace::CPU_LEVEL, effective_memory_level);
@@ -1225,36 +1277,15 @@ void BaselineJoinHashTable::checkHashJoinReplicationConstraint(const int table_i
   }
 }
 
-const BaselineJoinHashTable::HashTableCacheValue*
-BaselineJoinHashTable::findHashTableOnCpuInCache(const HashTableCacheKey& key) {
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      return &kv.second;
-    }
-  }
-  return nullptr;
-}
-
 void BaselineJoinHashTable::initHashTableOnCpuFromCache(const HashTableCacheKey& key) {
   auto timer = DEBUG_TIMER(__func__);
   VLOG(1) << "Checking CPU hash table cache.";
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  if (hash_table_cache_.size() == 0) {
-    VLOG(1) << "CPU hash table cache was empty.";
-  }
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      VLOG(1) << "Found a suitable hash table in the cache.";
-      cpu_hash_table_buff_ = kv.second.buffer;
-      layout_ = kv.second.type;
-      entry_count_ = kv.second.entry_count;
-      emitted_keys_count_ = kv.second.emitted_keys_count;
-      break;
-    } else {
-      VLOG(1) << hash_table_cache_.size()
-              << " hash tables found in cache. None were suitable for this query.";
-    }
+  if (const auto cached = hash_table_cache_.get(key)) {
+    VLOG(1) << "Found a suitable hash table in the cache.";
+    cpu_hash_table_buff_ = cached->buffer;
+    layout_ = cached->type;
+    entry_count_ = cached->entry_count;
+    emitted_keys_count_ = cached->emitted_keys_count;
   }
 }
 
@@ -1266,17 +1297,12 @@ void BaselineJoinHashTable::putHashTableOnCpuToCache(const HashTableCacheKey& ke
     }
   }
 
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
   VLOG(1) << "Storing hash table in cache.";
-  for (const auto& kv : hash_table_cache_) {
-    if (std::get<0>(kv) == key) {
-      return;
-    }
-  }
-  hash_table_cache_.emplace_back(
+  hash_table_cache_.put(
       key,
       HashTableCacheValue{
-          cpu_hash_table_buff_, layout_, entry_count_, emitted_keys_count_});
+          cpu_hash_table_buff_, layout_, entry_count_, emitted_keys_count_},
+      cpu_hash_table_buff_->size());
 }
 
 std::pair<ssize_t, size_t> BaselineJoinHashTable::getApproximateTupleCountFromCache(
@@ -1289,11 +1315,8 @@ std::pair<ssize_t, size_t> BaselineJoinHashTable::getApproximateTupleCountFromCa
     }
   }
 
-  std::lock_guard<std::mutex> hash_table_cache_lock(hash_table_cache_mutex_);
-  for (const auto& kv : hash_table_cache_) {
-    if (kv.first == key) {
-      return std::make_pair(kv.second.entry_count / 2, kv.second.emitted_keys_count);
-    }
+  if (const auto cached = hash_table_cache_.get(key)) {
+    return std::make_pair(cached->entry_count / 2, cached->emitted_keys_count);
   }
   return std::make_pair(-1, 0);
 }
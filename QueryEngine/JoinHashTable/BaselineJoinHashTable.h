@@ -19,6 +19,8 @@
 #ifdef HAVE_CUDA
 #include <cuda.h>
 #endif
+#include <boost/functional/hash.hpp>
+
 #include <cstdint>
 #include <map>
 #include <mutex>
@@ -32,6 +34,7 @@
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/InputMetadata.h"
 #include "QueryEngine/JoinHashTable/HashJoinRuntime.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 class Executor;
@@ -94,31 +97,18 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
   size_t payloadBufferOff() const noexcept override;
 
   static auto yieldCacheInvalidator() -> std::function<void()> {
-    VLOG(1) << "Invalidate " << hash_table_cache_.size() << " cached baseline hashtable.";
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-      hash_table_cache_.clear();
-    };
+    return []() -> void { hash_table_cache_.clear(); };
   }
 
   static const std::shared_ptr<std::vector<int8_t>>& getCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    CHECK(!hash_table_cache_.empty());
-    CHECK_LT(idx, hash_table_cache_.size());
-    return hash_table_cache_.at(idx).second.buffer;
+    return hash_table_cache_.at(idx).buffer;
   }
 
   static size_t getEntryCntCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    CHECK(!hash_table_cache_.empty());
-    CHECK_LT(idx, hash_table_cache_.size());
-    return hash_table_cache_.at(idx).second.entry_count;
+    return hash_table_cache_.at(idx).entry_count;
   }
 
-  static uint64_t getNumberOfCachedHashTables() {
-    std::lock_guard<std::mutex> guard(hash_table_cache_mutex_);
-    return hash_table_cache_.size();
-  }
+  static uint64_t getNumberOfCachedHashTables() { return hash_table_cache_.size(); }
 
   virtual ~BaselineJoinHashTable();
 
@@ -239,6 +229,18 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
              optype < that.optype && !oeq &&
              overlaps_hashjoin_bucket_threshold < that.overlaps_hashjoin_bucket_threshold;
     }
+
+    // thresholds compare approximately, only whether there is one is hashed
+    size_t hash() const {
+      size_t seed = 0;
+      for (const auto& chunk_key : chunk_keys) {
+        boost::hash_combine(seed, boost::hash_range(chunk_key.begin(), chunk_key.end()));
+      }
+      boost::hash_combine(seed, num_elements);
+      boost::hash_combine(seed, optype);
+      boost::hash_combine(seed, bool(overlaps_hashjoin_bucket_threshold));
+      return seed;
+    }
   };
 
   void initHashTableOnCpuFromCache(const HashTableCacheKey&);
@@ -288,10 +290,7 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
     const size_t emitted_keys_count;
   };
 
-  const HashTableCacheValue* findHashTableOnCpuInCache(const HashTableCacheKey&);
-
-  static std::vector<std::pair<HashTableCacheKey, HashTableCacheValue>> hash_table_cache_;
-  static std::mutex hash_table_cache_mutex_;
+  static HashTableCache<HashTableCacheKey, HashTableCacheValue> hash_table_cache_;
 
   static const int ERR_FAILED_TO_FETCH_COLUMN{-3};
   static const int ERR_FAILED_TO_JOIN_ON_VIRTUAL_COLUMN{-4};
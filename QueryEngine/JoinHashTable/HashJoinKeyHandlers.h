@@ -89,8 +89,13 @@ struct GenericKeyHandler {
             static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
         const auto sd_outer_dict_proxy =
             static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-        const auto elem_str = sd_inner_dict_proxy->getString(elem);
-        const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+        const auto& translation_map =
+            sd_inner_dict_proxy->getTranslationMap(sd_outer_dict_proxy);
+        const auto outer_id =
+            elem >= 0 && static_cast<size_t>(elem) < translation_map.size()
+                ? translation_map[elem]
+                : sd_outer_dict_proxy->getIdOfString(
+                      sd_inner_dict_proxy->getString(elem));
         if (outer_id == StringDictionary::INVALID_STR_ID) {
           skip_entry = true;
           break;
@@ -34,12 +34,11 @@
 #include "StringDictionary/StringDictionary.h"
 #include "StringDictionary/StringDictionaryProxy.h"
 
+#include <atomic>
 #include <future>
+#include <vector>
 #endif
 
-#if HAVE_CUDA
-#include <thrust/scan.h>
-#endif
 #include "../../Shared/funcannotations.h"
 
 #include <cmath>
@@ -78,8 +77,14 @@ inline int64_t translate_str_id_to_outer_dict(const int64_t elem,
       static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
   const auto sd_outer_dict_proxy =
       static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-  const auto elem_str = sd_inner_dict_proxy->getString(elem);
-  const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+  // ids below the generation of the inner proxy, i.e. all but transient ones, are
+  // translated through a map built once for the pair of dictionaries
+  const auto& translation_map =
+      sd_inner_dict_proxy->getTranslationMap(sd_outer_dict_proxy);
+  const auto outer_id =
+      elem >= 0 && static_cast<size_t>(elem) < translation_map.size()
+          ? translation_map[elem]
+          : sd_outer_dict_proxy->getIdOfString(sd_inner_dict_proxy->getString(elem));
   if (outer_id > max_elem || outer_id < min_elem) {
     return StringDictionary::INVALID_STR_ID;
   }
@@ -1291,6 +1296,63 @@ void inclusive_scan(InputIterator first,
   }
 }
 
+namespace {
+
+// Sets the positions of the row ids of the slots with matches to the exclusive prefix
+// sums of count_buff, and clears count_buff for fill_row_ids. Every thread scans a
+// contiguous range of slots twice: once to sum its counts, once to write the positions.
+template <typename SIZE>
+void compute_row_id_positions(int32_t* pos_buff,
+                              int32_t* count_buff,
+                              const SIZE entry_count,
+                              const size_t cpu_thread_count) {
+  const size_t slot_count = entry_count;
+  const size_t thread_count =
+      slot_count < 10000 ? size_t(1) : std::max(size_t(1), cpu_thread_count);
+  const size_t step = (slot_count + thread_count - 1) / thread_count;
+  auto for_each_range = [thread_count, step, slot_count](const auto& func) {
+    std::vector<std::future<void>> range_threads;
+    for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      const auto start = std::min(thread_idx * step, slot_count);
+      const auto end = std::min(start + step, slot_count);
+      range_threads.push_back(
+          std::async(std::launch::async, func, thread_idx, start, end));
+    }
+    for (auto& child : range_threads) {
+      child.get();
+    }
+  };
+
+  std::vector<int32_t> range_offsets(thread_count, 0);
+  for_each_range([count_buff, &range_offsets](
+                     const size_t thread_idx, const size_t start, const size_t end) {
+    int32_t sum = 0;
+    for (size_t i = start; i < end; ++i) {
+      sum += count_buff[i];
+    }
+    range_offsets[thread_idx] = sum;
+  });
+  int32_t offset = 0;
+  for (auto& range_offset : range_offsets) {
+    const auto range_sum = range_offset;
+    range_offset = offset;
+    offset += range_sum;
+  }
+  for_each_range([pos_buff, count_buff, &range_offsets](
+                     const size_t thread_idx, const size_t start, const size_t end) {
+    auto pos = range_offsets[thread_idx];
+    for (size_t i = start; i < end; ++i) {
+      if (count_buff[i]) {
+        pos_buff[i] = pos;
+        pos += count_buff[i];
+        count_buff[i] = 0;
+      }
+    }
+  });
+}
+
+}  // namespace
+
 template <typename COUNT_MATCHES_LAUNCH_FUNCTOR, typename FILL_ROW_IDS_LAUNCH_FUNCTOR>
 void fill_one_to_many_hash_table_impl(int32_t* buff,
                                       const int32_t hash_entry_count,
@@ -1315,34 +1377,9 @@ void fill_one_to_many_hash_table_impl(int32_t* buff,
     child.get();
   }
 
-  std::vector<int32_t> count_copy(hash_entry_count, 0);
   CHECK_GT(hash_entry_count, int32_t(0));
-  memcpy(&count_copy[1], count_buff, (hash_entry_count - 1) * sizeof(int32_t));
-#if HAVE_CUDA
-  thrust::inclusive_scan(count_copy.begin(), count_copy.end(), count_copy.begin());
-#else
-  ::inclusive_scan(
-      count_copy.begin(), count_copy.end(), count_copy.begin(), cpu_thread_count);
-#endif
-  std::vector<std::future<void>> pos_threads;
-  for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
-    pos_threads.push_back(std::async(
-        std::launch::async,
-        [&](size_t thread_idx) {
-          for (size_t i = thread_idx; i < static_cast<size_t>(hash_entry_count);
-               i += cpu_thread_count) {
-            if (count_buff[i]) {
-              pos_buff[i] = count_copy[i];
-            }
-          }
-        },
-        cpu_thread_idx));
-  }
-  for (auto& child : pos_threads) {
-    child.get();
-  }
+  compute_row_id_positions(pos_buff, count_buff, hash_entry_count, cpu_thread_count);
 
-  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
   std::vector<std::future<void>> rowid_threads;
   for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     rowid_threads.push_back(std::async(
@@ -1500,30 +1537,9 @@ void fill_one_to_many_hash_table_sharded_impl(
     child.get();
   }
 
-  std::vector<int32_t> count_copy(hash_entry_count, 0);
   CHECK_GT(hash_entry_count, int32_t(0));
-  memcpy(&count_copy[1], count_buff, (hash_entry_count - 1) * sizeof(int32_t));
-  ::inclusive_scan(
-      count_copy.begin(), count_copy.end(), count_copy.begin(), cpu_thread_count);
-  std::vector<std::future<void>> pos_threads;
-  for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
-    pos_threads.push_back(std::async(
-        std::launch::async,
-        [&](const unsigned thread_idx) {
-          for (size_t i = thread_idx; i < static_cast<size_t>(hash_entry_count);
-               i += cpu_thread_count) {
-            if (count_buff[i]) {
-              pos_buff[i] = count_copy[i];
-            }
-          }
-        },
-        cpu_thread_idx));
-  }
-  for (auto& child : pos_threads) {
-    child.get();
-  }
+  compute_row_id_positions(pos_buff, count_buff, hash_entry_count, cpu_thread_count);
 
-  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
   std::vector<std::future<void>> rowid_threads;
   for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     rowid_threads.push_back(std::async(
@@ -1727,6 +1743,151 @@ int overlaps_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                                cpu_thread_count);
 }
 
+namespace {
+
+/**
+ * Fills the keys of a baseline hash table in two passes, so that the inserts hit one
+ * region of the table at a time instead of the whole table. The first pass hashes the
+ * keys of the rows and scatters the keys, with their row ids, into partitions of the
+ * slots they hash to, by thread. The second pass inserts the keys a partition at a time,
+ * each thread taking the next partition, where the table region of a partition fits a
+ * cache. Keys which overflow into the region of the next partition are inserted by the
+ * same compare and swaps as in fill_baseline_hash_join_buff, so the table is the same.
+ */
+template <typename T, typename FILL_HANDLER>
+int fill_baseline_hash_join_buff_partitioned(int8_t* hash_buff,
+                                             const size_t entry_count,
+                                             const int32_t invalid_slot_val,
+                                             const size_t key_component_count,
+                                             const bool with_val_slot,
+                                             const FILL_HANDLER* f,
+                                             const size_t partition_count,
+                                             const int32_t cpu_thread_count) {
+  CHECK_GT(partition_count, size_t(1));
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  const size_t hash_entry_size =
+      (key_component_count + (with_val_slot ? 1 : 0)) * sizeof(T);
+  // the row id followed by the key components, by thread and partition
+  const size_t record_size = key_component_count + 1;
+  std::vector<std::vector<std::vector<T>>> partitions(
+      cpu_thread_count, std::vector<std::vector<T>>(partition_count));
+
+  std::vector<std::future<int>> partition_threads;
+  for (int32_t thread_idx = 0; thread_idx < cpu_thread_count; ++thread_idx) {
+    partition_threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+      auto& thread_partitions = partitions[thread_idx];
+      auto partition_key = [&](const size_t entry_idx,
+                               const T* key_scratch_buffer,
+                               const size_t key_component_count) {
+        const uint32_t h =
+            MurmurHash1Impl(key_scratch_buffer, key_size_in_bytes, 0) % entry_count;
+        auto& partition = thread_partitions[uint64_t(h) * partition_count / entry_count];
+        partition.push_back(static_cast<T>(entry_idx));
+        partition.insert(partition.end(),
+                         key_scratch_buffer,
+                         key_scratch_buffer + key_component_count);
+        return 0;
+      };
+      T key_scratch_buff[g_maximum_conditions_to_coalesce];
+      JoinColumnTuple cols(f->get_number_of_columns(),
+                           f->get_join_columns(),
+                           f->get_join_column_type_infos());
+      for (auto& it : cols.slice(thread_idx, cpu_thread_count)) {
+        const auto err =
+            (*f)(it.join_column_iterators, key_scratch_buff, partition_key);
+        if (err) {
+          return err;
+        }
+      }
+      return 0;
+    }));
+  }
+  int err = 0;
+  for (auto& child : partition_threads) {
+    const auto partial_err = child.get();
+    if (partial_err) {
+      err = partial_err;
+    }
+  }
+  if (err) {
+    return err;
+  }
+
+  std::atomic<size_t> next_partition{0};
+  std::vector<std::future<int>> insert_threads;
+  for (int32_t thread_idx = 0; thread_idx < cpu_thread_count; ++thread_idx) {
+    insert_threads.push_back(std::async(std::launch::async, [&] {
+      for (size_t partition_idx = next_partition++; partition_idx < partition_count;
+           partition_idx = next_partition++) {
+        for (auto& thread_partitions : partitions) {
+          auto& partition = thread_partitions[partition_idx];
+          for (size_t i = 0; i < partition.size(); i += record_size) {
+            const auto err = write_baseline_hash_slot<T>(partition[i],
+                                                         hash_buff,
+                                                         entry_count,
+                                                         &partition[i + 1],
+                                                         key_component_count,
+                                                         with_val_slot,
+                                                         invalid_slot_val,
+                                                         key_size_in_bytes,
+                                                         hash_entry_size);
+            if (err) {
+              return err;
+            }
+          }
+          std::vector<T>().swap(partition);
+        }
+      }
+      return 0;
+    }));
+  }
+  for (auto& child : insert_threads) {
+    const auto partial_err = child.get();
+    if (partial_err) {
+      err = partial_err;
+    }
+  }
+  return err;
+}
+
+}  // namespace
+
+int fill_baseline_hash_join_buff_partitioned_32(int8_t* hash_buff,
+                                                const size_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count) {
+  return fill_baseline_hash_join_buff_partitioned<int32_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           cpu_thread_count);
+}
+
+int fill_baseline_hash_join_buff_partitioned_64(int8_t* hash_buff,
+                                                const size_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count) {
+  return fill_baseline_hash_join_buff_partitioned<int64_t>(hash_buff,
+                                                           entry_count,
+                                                           invalid_slot_val,
+                                                           key_component_count,
+                                                           with_val_slot,
+                                                           key_handler,
+                                                           partition_count,
+                                                           cpu_thread_count);
+}
+
 template <typename T>
 void fill_one_to_many_baseline_hash_table(
     int32_t* buff,
@@ -1801,29 +1962,9 @@ void fill_one_to_many_baseline_hash_table(
     child.get();
   }
 
-  std::vector<int32_t> count_copy(hash_entry_count, 0);
   CHECK_GT(hash_entry_count, 0u);
-  memcpy(&count_copy[1], count_buff, (hash_entry_count - 1) * sizeof(int32_t));
-  ::inclusive_scan(
-      count_copy.begin(), count_copy.end(), count_copy.begin(), cpu_thread_count);
-  std::vector<std::future<void>> pos_threads;
-  for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
-    pos_threads.push_back(std::async(
-        std::launch::async,
-        [&](const int thread_idx) {
-          for (size_t i = thread_idx; i < hash_entry_count; i += cpu_thread_count) {
-            if (count_buff[i]) {
-              pos_buff[i] = count_copy[i];
-            }
-          }
-        },
-        cpu_thread_idx));
-  }
-  for (auto& child : pos_threads) {
-    child.get();
-  }
+  compute_row_id_positions(pos_buff, count_buff, hash_entry_count, cpu_thread_count);
 
-  memset(count_buff, 0, hash_entry_count * sizeof(int32_t));
   std::vector<std::future<void>> rowid_threads;
   for (size_t cpu_thread_idx = 0; cpu_thread_idx < cpu_thread_count; ++cpu_thread_idx) {
     if (join_buckets_per_key.size() > 0) {
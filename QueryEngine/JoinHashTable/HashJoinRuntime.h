@@ -297,6 +297,26 @@ int overlaps_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                              const int32_t cpu_thread_idx,
                                              const int32_t cpu_thread_count);
 
+// Like fill_baseline_hash_join_buff_*, for all threads at once, with the keys radix
+// partitioned into partition_count ranges of slots before they are inserted
+int fill_baseline_hash_join_buff_partitioned_32(int8_t* hash_buff,
+                                                const size_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count);
+
+int fill_baseline_hash_join_buff_partitioned_64(int8_t* hash_buff,
+                                                const size_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const GenericKeyHandler* key_handler,
+                                                const size_t partition_count,
+                                                const int32_t cpu_thread_count);
+
 void fill_baseline_hash_join_buff_on_device_32(int8_t* hash_buff,
                                                const size_t entry_count,
                                                const int32_t invalid_slot_val,
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    HashTableCache.h
+ * @brief   Byte bounded LRU cache of the CPU join hash tables
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+#include "Logger/Logger.h"
+
+extern size_t g_join_hash_table_cache_bytes;
+
+template <typename KEY>
+struct HashTableCacheKeyHash {
+  size_t operator()(const KEY& key) const { return key.hash(); }
+};
+
+/**
+ * Maps the keys of hash tables to their buffers, evicting the least recently used
+ * tables once the buffers take more than g_join_hash_table_cache_bytes. Tables larger
+ * than the budget are not cached. KEY has a hash() method consistent with ==.
+ */
+template <typename KEY, typename VALUE>
+class HashTableCache {
+ public:
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t bytes{0};
+  };
+
+  explicit HashTableCache(const char* name) : name_(name) {}
+
+  std::optional<VALUE> get(const KEY& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return std::nullopt;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.end(), entries_, it->second);
+    return it->second->value;
+  }
+
+  void put(const KEY& key, const VALUE& value, const size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(key)) {
+      return;
+    }
+    if (bytes > g_join_hash_table_cache_bytes) {
+      VLOG(1) << "Not caching a " << name_ << " hash table of " << bytes << " bytes";
+      return;
+    }
+    while (!entries_.empty() && stats_.bytes + bytes > g_join_hash_table_cache_bytes) {
+      const auto& lru = entries_.front();
+      VLOG(1) << "Evicting a " << name_ << " hash table of " << lru.bytes << " bytes";
+      stats_.bytes -= lru.bytes;
+      ++stats_.evictions;
+      index_.erase(lru.key);
+      entries_.pop_front();
+    }
+    entries_.push_back({key, value, bytes});
+    index_.emplace(key, std::prev(entries_.end()));
+    stats_.bytes += bytes;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    VLOG(1) << "Invalidate " << entries_.size() << " cached " << name_
+            << " hash tables, " << stats_.hits << " hits, " << stats_.misses
+            << " misses, " << stats_.evictions << " evictions";
+    index_.clear();
+    entries_.clear();
+    stats_.bytes = 0;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  /// The value of the idx-th table, from the least recently used, for tests
+  const VALUE& at(const size_t idx) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(idx, entries_.size());
+    return std::next(entries_.begin(), idx)->value;
+  }
+
+  Stats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  struct Entry {
+    KEY key;
+    VALUE value;
+    size_t bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  const char* name_;
+  mutable std::mutex mutex_;
+  EntryList entries_;  // from the least to the most recently used
+  std::unordered_map<KEY, typename EntryList::iterator, HashTableCacheKeyHash<KEY>>
+      index_;
+  Stats stats_;
+};
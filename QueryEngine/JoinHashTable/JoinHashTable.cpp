@@ -29,6 +29,9 @@
 #include "QueryEngine/RangeTableIndexVisitor.h"
 #include "QueryEngine/RuntimeFunctions.h"
 
+extern bool g_enable_join_hash_table_peer_copy;
+extern bool g_enable_partitioned_sharded_joins;
+
 namespace {
 
 class NeedsOneToManyHash : public HashJoinFail {
@@ -256,10 +259,9 @@ size_t get_hash_entry_count(const ExpressionRange& col_range, const bool is_bw_e
 
 }  // namespace
 
-std::vector<std::pair<JoinHashTable::JoinHashTableCacheKey,
-                      std::shared_ptr<std::vector<int32_t>>>>
-    JoinHashTable::join_hash_table_cache_;
-std::mutex JoinHashTable::join_hash_table_cache_mutex_;
+HashTableCache<JoinHashTable::JoinHashTableCacheKey,
+               std::shared_ptr<std::vector<int32_t>>>
+    JoinHashTable::join_hash_table_cache_("perfect");
 
 size_t get_shard_count(const Analyzer::BinOper* join_condition,
                        const Executor* executor) {
@@ -278,10 +280,7 @@ size_t get_shard_count(const Analyzer::BinOper* join_condition,
   return get_shard_count({inner_col, outer_col}, executor);
 }
 
-namespace {
-
-bool shard_count_less_or_equal_device_count(const int inner_table_id,
-                                            const Executor* executor) {
+bool one_shard_fragment_per_device(const int inner_table_id, const Executor* executor) {
   const auto inner_table_info = executor->getTableInfo(inner_table_id);
   std::unordered_set<int> device_holding_fragments;
   auto cuda_mgr = executor->getCatalog()->getDataMgr().getCudaMgr();
@@ -297,8 +296,6 @@ bool shard_count_less_or_equal_device_count(const int inner_table_id,
   return true;
 }
 
-}  // namespace
-
 size_t get_shard_count(
     std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*> equi_pair,
     const Executor* executor) {
@@ -322,7 +319,10 @@ size_t get_shard_count(
       inner_td->nShards != outer_td->nShards) {
     return 0;
   }
-  if (!shard_count_less_or_equal_device_count(inner_td->tableId, executor)) {
+  // the devices can also hold several shards, or shards of several fragments, of the
+  // inner table if the kernels fetch all the fragments of their device as one
+  if (!g_enable_partitioned_sharded_joins &&
+      !one_shard_fragment_per_device(inner_td->tableId, executor)) {
     return 0;
   }
   // The two columns involved must be the ones on which the tables have been sharded on.
@@ -511,9 +511,14 @@ void JoinHashTable::reify() {
 #endif  // HAVE_CUDA
   std::vector<std::future<void>> init_threads;
   const int shard_count = shardCount();
+  // a replicated table is built on the first GPU only, the others get a copy of it
+  const bool copy_from_first_device = g_enable_join_hash_table_peer_copy &&
+                                      memory_level_ == Data_Namespace::GPU_LEVEL &&
+                                      !shard_count && device_count_ > 1;
+  const int build_device_count = copy_from_first_device ? 1 : device_count_;
 
   try {
-    for (int device_id = 0; device_id < device_count_; ++device_id) {
+    for (int device_id = 0; device_id < build_device_count; ++device_id) {
       const auto fragments =
           shard_count
               ? only_shards_for_device(query_info.fragments, device_id, device_count_)
@@ -539,7 +544,7 @@ void JoinHashTable::reify() {
     hash_type_ = JoinHashTableInterface::HashType::OneToMany;
     freeHashBufferMemory();
     init_threads.clear();
-    for (int device_id = 0; device_id < device_count_; ++device_id) {
+    for (int device_id = 0; device_id < build_device_count; ++device_id) {
       const auto fragments =
           shard_count
               ? only_shards_for_device(query_info.fragments, device_id, device_count_)
@@ -559,6 +564,40 @@ void JoinHashTable::reify() {
       init_thread.get();
     }
   }
+  if (copy_from_first_device) {
+    copyHashTableFromFirstDevice();
+  }
+}
+
+void JoinHashTable::copyHashTableFromFirstDevice() {
+#ifdef HAVE_CUDA
+  auto timer = DEBUG_TIMER(__func__);
+  const auto source_buff = gpu_hash_table_buff_.front();
+  if (!source_buff) {
+    return;
+  }
+  auto& data_mgr = executor_->getCatalog()->getDataMgr();
+  const auto cuda_mgr = data_mgr.getCudaMgr();
+  CHECK(cuda_mgr);
+  const auto hash_table_size = source_buff->reservedSize();
+  for (int device_id = 1; device_id < device_count_; ++device_id) {
+    CHECK(!gpu_hash_table_buff_[device_id]);
+    gpu_hash_table_buff_[device_id] =
+        CudaAllocator::allocGpuAbstractBuffer(&data_mgr, hash_table_size, device_id);
+    trackGpuHashTableBuffer(executor_, gpu_hash_table_buff_[device_id]);
+    // peer to peer over NVLink or PCIe when the devices allow it, through the host
+    // otherwise
+    cuda_mgr->copyDeviceToDevice(gpu_hash_table_buff_[device_id]->getMemoryPtr(),
+                                 source_buff->getMemoryPtr(),
+                                 hash_table_size,
+                                 device_id,
+                                 0);
+  }
+  VLOG(1) << "Copied a join hash table of " << hash_table_size << " bytes from GPU 0 to "
+          << device_count_ - 1 << " other GPUs";
+#else
+  CHECK(false);
+#endif
 }
 
 JoinHashTable::~JoinHashTable() {
@@ -947,6 +986,7 @@ void JoinHashTable::initOneToOneHashTable(
         &data_mgr,
         hash_entry_info.getNormalizedHashEntryCount() * sizeof(int32_t),
         device_id);
+    trackGpuHashTableBuffer(executor_, gpu_hash_table_buff_[device_id]);
   }
 #else
   CHECK_EQ(Data_Namespace::CPU_LEVEL, effective_memory_level);
@@ -1091,6 +1131,7 @@ void JoinHashTable::initOneToManyHashTable(
         2 * hash_entry_info.getNormalizedHashEntryCount() + join_column.num_elems;
     gpu_hash_table_buff_[device_id] = CudaAllocator::allocGpuAbstractBuffer(
         &data_mgr, total_count * sizeof(int32_t), device_id);
+    trackGpuHashTableBuffer(executor_, gpu_hash_table_buff_[device_id]);
   }
 #endif
   const int32_t hash_join_invalid_val{-1};
@@ -1198,13 +1239,9 @@ void JoinHashTable::initHashTableOnCpuFromCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
-      cpu_hash_table_buff_ = kv.second;
-      break;
-    }
+  if (const auto cached_buff = join_hash_table_cache_.get(cache_key)) {
+    std::lock_guard<std::mutex> cpu_hash_table_buff_lock(cpu_hash_table_buff_mutex_);
+    cpu_hash_table_buff_ = *cached_buff;
   }
 }
 
@@ -1224,13 +1261,9 @@ void JoinHashTable::putHashTableOnCpuToCache(
                                   num_elements,
                                   chunk_key,
                                   qual_bin_oper_->get_optype()};
-  std::lock_guard<std::mutex> join_hash_table_cache_lock(join_hash_table_cache_mutex_);
-  for (const auto& kv : join_hash_table_cache_) {
-    if (kv.first == cache_key) {
-      return;
-    }
-  }
-  join_hash_table_cache_.emplace_back(cache_key, cpu_hash_table_buff_);
+  join_hash_table_cache_.put(cache_key,
+                             cpu_hash_table_buff_,
+                             cpu_hash_table_buff_->size() * sizeof(int32_t));
 }
 
 llvm::Value* JoinHashTable::codegenHashTableLoad(const size_t table_idx) {
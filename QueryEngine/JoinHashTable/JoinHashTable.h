@@ -33,6 +33,7 @@
 #include "QueryEngine/Descriptors/RowSetMemoryOwner.h"
 #include "QueryEngine/ExpressionRange.h"
 #include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/JoinHashTable/HashTableCache.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 #include <llvm/IR/Value.h>
@@ -40,6 +41,8 @@
 #ifdef HAVE_CUDA
 #include <cuda.h>
 #endif
+#include <boost/functional/hash.hpp>
+
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -88,6 +91,11 @@ class JoinHashTable : public JoinHashTableInterface {
 
   HashType getHashType() const noexcept override { return hash_type_; }
 
+  const Analyzer::BinOper* getQual() const { return qual_bin_oper_.get(); }
+
+  // the keys of the table lie in it, outer values outside of it have no match
+  const ExpressionRange& getKeyRange() const { return col_range_; }
+
   Data_Namespace::MemoryLevel getMemoryLevel() const noexcept override {
     return memory_level_;
   };
@@ -112,25 +120,14 @@ class JoinHashTable : public JoinHashTableInterface {
   static llvm::Value* codegenHashTableLoad(const size_t table_idx, Executor* executor);
 
   static auto yieldCacheInvalidator() -> std::function<void()> {
-    VLOG(1) << "Invalidate " << join_hash_table_cache_.size()
-            << " cached baseline hashtable.";
-    return []() -> void {
-      std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-      join_hash_table_cache_.clear();
-    };
+    return []() -> void { join_hash_table_cache_.clear(); };
   }
 
   static const std::shared_ptr<std::vector<int32_t>>& getCachedHashTable(size_t idx) {
-    std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-    CHECK(!join_hash_table_cache_.empty());
-    CHECK_LT(idx, join_hash_table_cache_.size());
-    return join_hash_table_cache_.at(idx).second;
+    return join_hash_table_cache_.at(idx);
   }
 
-  static uint64_t getNumberOfCachedHashTables() {
-    std::lock_guard<std::mutex> guard(join_hash_table_cache_mutex_);
-    return join_hash_table_cache_.size();
-  }
+  static uint64_t getNumberOfCachedHashTables() { return join_hash_table_cache_.size(); }
 
   virtual ~JoinHashTable();
 
@@ -172,6 +169,8 @@ class JoinHashTable : public JoinHashTableInterface {
       const std::vector<Fragmenter_Namespace::FragmentInfo>& fragments,
       const int device_id,
       const logger::ThreadId parent_thread_id);
+  // Copies the hash table built on the first GPU to the other ones
+  void copyHashTableFromFirstDevice();
   void checkHashJoinReplicationConstraint(const int table_id) const;
   void initOneToOneHashTable(
       const ChunkKey& chunk_key,
@@ -259,12 +258,21 @@ class JoinHashTable : public JoinHashTableInterface {
              outer_col == that.outer_col && num_elements == that.num_elements &&
              chunk_key == that.chunk_key && optype == that.optype;
     }
+
+    size_t hash() const {
+      size_t seed = boost::hash_range(chunk_key.begin(), chunk_key.end());
+      boost::hash_combine(seed, num_elements);
+      boost::hash_combine(seed, optype);
+      boost::hash_combine(seed, inner_col.get_table_id());
+      boost::hash_combine(seed, inner_col.get_column_id());
+      boost::hash_combine(seed, outer_col.get_table_id());
+      boost::hash_combine(seed, outer_col.get_column_id());
+      return seed;
+    }
   };
 
-  static std::vector<
-      std::pair<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>>
+  static HashTableCache<JoinHashTableCacheKey, std::shared_ptr<std::vector<int32_t>>>
       join_hash_table_cache_;
-  static std::mutex join_hash_table_cache_mutex_;
 };
 
 // TODO(alex): Functions below need to be moved to a separate translation unit, they don't
@@ -276,6 +284,9 @@ size_t get_shard_count(
     std::pair<const Analyzer::ColumnVar*, const Analyzer::Expr*> equi_pair,
     const Executor* executor);
 
+// Whether no GPU holds more than one fragment of the sharded table, by shard % GPU count
+bool one_shard_fragment_per_device(const int inner_table_id, const Executor* executor);
+
 bool needs_dictionary_translation(const Analyzer::ColumnVar* inner_col,
                                   const Analyzer::Expr* outer_col,
                                   const Executor* executor);
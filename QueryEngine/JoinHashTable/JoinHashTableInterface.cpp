@@ -67,6 +67,18 @@ JoinColumn JoinHashTableInterface::fetchJoinColumn(
   }
 }
 
+void JoinHashTableInterface::trackGpuHashTableBuffer(
+    Executor* executor,
+    const Data_Namespace::AbstractBuffer* buffer) {
+  CHECK(executor);
+  CHECK(buffer);
+  const auto row_set_mem_owner = executor->getRowSetMemoryOwner();
+  if (row_set_mem_owner) {
+    row_set_mem_owner->getGpuMemoryUsageTracker()->allocate(
+        DeviceMemoryCategory::HashTables, buffer->reservedSize());
+  }
+}
+
 namespace {
 
 template <typename T>
@@ -146,6 +146,11 @@ class JoinHashTableInterface {
       Executor* executor,
       ColumnCacheMap* column_cache);
 
+  //! Accounts a device hash table buffer to the GPU memory used by the running query.
+  //! Hash tables are held until the query finishes, so only the allocation is recorded.
+  static void trackGpuHashTableBuffer(Executor* executor,
+                                      const Data_Namespace::AbstractBuffer* buffer);
+
  public:
   //! Decode hash table into a std::set for easy inspection and validation.
   static DecodedJoinHashBufferSet toSet(
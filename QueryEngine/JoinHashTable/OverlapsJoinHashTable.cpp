@@ -16,6 +16,8 @@
 
 #include "QueryEngine/JoinHashTable/OverlapsJoinHashTable.h"
 
+#include <cmath>
+
 #include "QueryEngine/CodeGenerator.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExpressionRewrite.h"
@@ -23,10 +25,39 @@
 #include "QueryEngine/JoinHashTable/JoinHashTableGpuUtils.h"
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
+extern size_t g_overlaps_auto_tuner_sample_rows;
+
 std::map<OverlapsJoinHashTable::HashTableCacheKey, double>
     OverlapsJoinHashTable::auto_tuner_cache_;
 std::mutex OverlapsJoinHashTable::auto_tuner_cache_mutex_;
 
+namespace {
+
+// the share of the memory of a GPU an overlaps hash table may take
+constexpr double kMaxGpuHashTableMemoryFraction{0.25};
+// the auto-tuner refines the decades of thresholds by these steps
+const double kThresholdRefinementStep{std::pow(10.0, 0.25)};
+
+// The join columns of the leading chunks holding at least sample_rows rows
+std::vector<JoinColumn> sample_join_columns(const std::vector<JoinColumn>& join_columns,
+                                            const size_t sample_rows) {
+  std::vector<JoinColumn> sampled_columns;
+  for (const auto& join_column : join_columns) {
+    auto sampled_column = join_column;
+    const auto chunks = reinterpret_cast<const JoinChunk*>(join_column.col_chunks_buff);
+    sampled_column.num_chunks = 0;
+    sampled_column.num_elems = 0;
+    while (sampled_column.num_chunks < join_column.num_chunks &&
+           sampled_column.num_elems < sample_rows) {
+      sampled_column.num_elems += chunks[sampled_column.num_chunks++].num_elems;
+    }
+    sampled_columns.push_back(sampled_column);
+  }
+  return sampled_columns;
+}
+
+}  // namespace
+
 //! Make hash table from an in-flight SQL query's parse tree etc.
 std::shared_ptr<OverlapsJoinHashTable> OverlapsJoinHashTable::getInstance(
     const std::shared_ptr<Analyzer::BinOper> condition,
@@ -163,44 +194,78 @@ void OverlapsJoinHashTable::reifyWithLayout(
   };
 
   // Auto-tuner: Pre-calculate some possible hash table sizes.
+  const auto max_hash_table_size = getMaxHashTableSize();
   std::lock_guard<std::mutex> guard(auto_tuner_cache_mutex_);
   auto atc = auto_tuner_cache_.find(cache_key);
+  const double min_threshold{1e-5};
+  const double max_threshold{1};
   if (atc != auto_tuner_cache_.end()) {
     overlaps_hashjoin_bucket_threshold_ = atc->second;
     VLOG(1) << "Auto tuner using cached overlaps hash table size of: "
             << overlaps_hashjoin_bucket_threshold_;
   } else {
-    VLOG(1) << "Auto tuning for the overlaps hash table size:";
-    // TODO(jclay): Currently, joining on large poly sets
-    // will lead to lengthy construction times (and large hash tables)
-    // tune this to account for the characteristics of the data being joined.
-    const double min_threshold{1e-5};
-    const double max_threshold{1};
-    double good_threshold{max_threshold};
-    for (double threshold = max_threshold; threshold >= min_threshold;
-         threshold /= 10.0) {
+    VLOG(1) << "Auto tuning for the overlaps hash table size of at most "
+            << max_hash_table_size << " bytes:";
+    // On CPU, the sizes are estimated from the bounding boxes of the leading chunks of
+    // the inner table, scaled to all its rows. The columns on GPUs are left whole.
+    auto sampled_columns_per_device = columns_per_device;
+    size_t sampled_rows{0};
+    size_t total_rows{0};
+    if (g_overlaps_auto_tuner_sample_rows &&
+        getEffectiveMemoryLevel(inner_outer_pairs_) ==
+            Data_Namespace::MemoryLevel::CPU_LEVEL) {
+      for (auto& columns_for_device : sampled_columns_per_device) {
+        total_rows += columns_for_device.join_columns.front().num_elems;
+        columns_for_device.join_columns = sample_join_columns(
+            columns_for_device.join_columns, g_overlaps_auto_tuner_sample_rows);
+        sampled_rows += columns_for_device.join_columns.front().num_elems;
+      }
+    }
+    const double sample_scale =
+        sampled_rows ? static_cast<double>(total_rows) / sampled_rows : 1.0;
+    auto fits = [&](const double threshold) {
       overlaps_hashjoin_bucket_threshold_ = threshold;
       size_t entry_count;
       size_t emitted_keys_count;
       std::tie(entry_count, emitted_keys_count) =
-          calculateCounts(shard_count, query_info, columns_per_device);
-      size_t hash_table_size = calculateHashTableSize(
-          bucket_sizes_for_dimension_.size(), emitted_keys_count, entry_count);
+          calculateCounts(shard_count, query_info, sampled_columns_per_device);
+      // the distinct buckets grow at most linearly with the rows, the estimate errs on
+      // the large side
+      const size_t hash_table_size =
+          calculateHashTableSize(bucket_sizes_for_dimension_.size(),
+                                 static_cast<size_t>(emitted_keys_count * sample_scale),
+                                 static_cast<size_t>(entry_count * sample_scale));
       bucket_sizes_for_dimension_.clear();
       VLOG(1) << "Calculated bin threshold of " << std::fixed << threshold
-              << " giving: entry count " << entry_count << " hash table size "
-              << hash_table_size;
-      if (hash_table_size <= g_overlaps_max_table_size_bytes) {
-        good_threshold = overlaps_hashjoin_bucket_threshold_;
-      } else {
+              << " giving: estimated entry count " << entry_count * sample_scale
+              << " estimated hash table size " << hash_table_size << " from "
+              << (sampled_rows ? sampled_rows : total_rows) << " sampled rows";
+      if (hash_table_size > max_hash_table_size) {
         VLOG(1) << "Rejected bin threshold of " << std::fixed << threshold;
+        return false;
+      }
+      return true;
+    };
+    // Sweep the decades of thresholds down from the largest, then refine the last one
+    // fitting by smaller steps.
+    double good_threshold{max_threshold};
+    double threshold = max_threshold;
+    bool rejected{false};
+    for (; threshold >= min_threshold; threshold /= 10.0) {
+      if (!fits(threshold)) {
+        rejected = true;
         break;
       }
+      good_threshold = threshold;
     }
-    overlaps_hashjoin_bucket_threshold_ = good_threshold;
-    if (!cache_key_contains_intermediate_table(cache_key)) {
-      auto_tuner_cache_[cache_key] = overlaps_hashjoin_bucket_threshold_;
+    if (rejected && threshold < max_threshold) {
+      for (double finer_threshold = good_threshold / kThresholdRefinementStep;
+           finer_threshold > threshold * 1.0001 && fits(finer_threshold);
+           finer_threshold /= kThresholdRefinementStep) {
+        good_threshold = finer_threshold;
+      }
     }
+    overlaps_hashjoin_bucket_threshold_ = good_threshold;
   }
 
   // Calculate the final size of the hash table.
@@ -212,9 +277,28 @@ void OverlapsJoinHashTable::reifyWithLayout(
       calculateCounts(shard_count, query_info, columns_per_device);
   size_t hash_table_size = calculateHashTableSize(
       bucket_sizes_for_dimension_.size(), emitted_keys_count_, entry_count_);
+  // The sample may have misled the auto-tuner, coarsen the buckets until the actual
+  // hash table fits.
+  while (hash_table_size > max_hash_table_size &&
+         overlaps_hashjoin_bucket_threshold_ < max_threshold) {
+    VLOG(1) << "Actual hash table size " << hash_table_size
+            << " exceeds the estimate for bin threshold of " << std::fixed
+            << overlaps_hashjoin_bucket_threshold_;
+    overlaps_hashjoin_bucket_threshold_ = std::min(
+        max_threshold, overlaps_hashjoin_bucket_threshold_ * kThresholdRefinementStep);
+    bucket_sizes_for_dimension_.clear();
+    std::tie(entry_count_, emitted_keys_count_) =
+        calculateCounts(shard_count, query_info, columns_per_device);
+    hash_table_size = calculateHashTableSize(
+        bucket_sizes_for_dimension_.size(), emitted_keys_count_, entry_count_);
+  }
+  if (atc == auto_tuner_cache_.end() &&
+      !cache_key_contains_intermediate_table(cache_key)) {
+    auto_tuner_cache_[cache_key] = overlaps_hashjoin_bucket_threshold_;
+  }
   VLOG(1) << "Finalized overlaps hashjoin bucket threshold of " << std::fixed
           << overlaps_hashjoin_bucket_threshold_ << " giving: entry count "
-          << entry_count_ << " hash table size " << hash_table_size;
+          << entry_count_ << " actual hash table size " << hash_table_size;
 
   std::vector<std::future<void>> init_threads;
   for (int device_id = 0; device_id < device_count_; ++device_id) {
@@ -259,6 +343,25 @@ std::pair<size_t, size_t> OverlapsJoinHashTable::calculateCounts(
       emitted_keys_count);
 }
 
+size_t OverlapsJoinHashTable::getMaxHashTableSize() const {
+  size_t max_hash_table_size = g_overlaps_max_table_size_bytes;
+#ifdef HAVE_CUDA
+  if (memory_level_ == Data_Namespace::MemoryLevel::GPU_LEVEL) {
+    const auto cuda_mgr = catalog_->getDataMgr().getCudaMgr();
+    CHECK(cuda_mgr);
+    for (int device_id = 0; device_id < device_count_; ++device_id) {
+      const auto device_properties = cuda_mgr->getDeviceProperties(device_id);
+      CHECK(device_properties);
+      max_hash_table_size = std::min(
+          max_hash_table_size,
+          static_cast<size_t>(device_properties->globalMem *
+                              kMaxGpuHashTableMemoryFraction));
+    }
+  }
+#endif
+  return max_hash_table_size;
+}
+
 size_t OverlapsJoinHashTable::calculateHashTableSize(size_t number_of_dimensions,
                                                      size_t emitted_keys_count,
                                                      size_t entry_count) const {
@@ -67,6 +67,9 @@ class OverlapsJoinHashTable : public BaselineJoinHashTable {
       const Fragmenter_Namespace::TableInfo& query_info,
       std::vector<BaselineJoinHashTable::ColumnsForDevice>& columns_per_device);
 
+  //! The budget of the auto-tuner, at most a share of the memory of the GPUs
+  size_t getMaxHashTableSize() const;
+
   size_t calculateHashTableSize(size_t number_of_dimensions,
                                 size_t emitted_keys_count,
                                 size_t entry_count) const;
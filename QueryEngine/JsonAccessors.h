@@ -43,7 +43,7 @@ inline const int64_t json_i64(const rapidjson::Value& obj) noexcept {
 
 inline const std::string json_str(const rapidjson::Value& obj) noexcept {
   CHECK(obj.IsString());
-  return obj.GetString();
+  return std::string(obj.GetString(), obj.GetStringLength());
 }
 
 inline const bool json_bool(const rapidjson::Value& obj) noexcept {
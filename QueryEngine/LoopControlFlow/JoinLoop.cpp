@@ -39,7 +39,8 @@ JoinLoop::JoinLoop(const JoinLoopKind kind,
     , found_outer_matches_(found_outer_matches)
     , is_deleted_(is_deleted)
     , name_(name) {
-  CHECK(outer_condition_match == nullptr || type == JoinType::LEFT);
+  CHECK(outer_condition_match == nullptr || type == JoinType::LEFT ||
+        type == JoinType::SEMI);
   CHECK_EQ(static_cast<bool>(found_outer_matches), (type == JoinType::LEFT));
 }
 
@@ -54,6 +55,7 @@ llvm::BasicBlock* JoinLoop::codegen(
   llvm::IRBuilder<>& builder = cgen_state->ir_builder_;
   llvm::BasicBlock* prev_exit_bb{exit_bb};
   llvm::BasicBlock* prev_iter_advance_bb{nullptr};
+  llvm::BasicBlock* prev_no_match_bb{nullptr};
   llvm::BasicBlock* last_head_bb{nullptr};
   auto& context = builder.getContext();
   const auto parent_func = builder.GetInsertBlock()->getParent();
@@ -61,7 +63,6 @@ llvm::BasicBlock* JoinLoop::codegen(
   llvm::BasicBlock* entry{nullptr};
   std::vector<llvm::Value*> iterators;
   iterators.push_back(outer_iter);
-  JoinType prev_join_type{JoinType::INVALID};
   for (const auto& join_loop : join_loops) {
     switch (join_loop.kind_) {
       case JoinLoopKind::UpperBound:
@@ -72,10 +73,7 @@ llvm::BasicBlock* JoinLoop::codegen(
           entry = preheader_bb;
         }
         if (prev_comparison_result) {
-          builder.CreateCondBr(
-              prev_comparison_result,
-              preheader_bb,
-              prev_join_type == JoinType::LEFT ? prev_iter_advance_bb : prev_exit_bb);
+          builder.CreateCondBr(prev_comparison_result, preheader_bb, prev_no_match_bb);
         }
         prev_exit_bb = prev_iter_advance_bb ? prev_iter_advance_bb : exit_bb;
         builder.SetInsertPoint(preheader_bb);
@@ -121,6 +119,7 @@ llvm::BasicBlock* JoinLoop::codegen(
           builder.CreateCondBr(row_is_deleted, iter_advance_bb, row_not_deleted_bb);
           builder.SetInsertPoint(row_not_deleted_bb);
         }
+        prev_no_match_bb = prev_exit_bb;
         if (join_loop.type_ == JoinType::LEFT) {
           std::tie(last_head_bb, prev_comparison_result) =
               evaluateOuterJoinCondition(join_loop,
@@ -131,6 +130,16 @@ llvm::BasicBlock* JoinLoop::codegen(
                                          found_an_outer_match_ptr,
                                          current_condition_match_ptr,
                                          cgen_state);
+          prev_no_match_bb = iter_advance_bb;
+        } else if (join_loop.type_ == JoinType::SEMI && join_loop.outer_condition_match_) {
+          // A loop semi join moves on to the next inner row until the condition matches.
+          const auto eval_semi_cond_bb = llvm::BasicBlock::Create(
+              context, "eval_semi_cond_" + join_loop.name_, parent_func);
+          builder.CreateCondBr(have_more_inner_rows, eval_semi_cond_bb, prev_exit_bb);
+          builder.SetInsertPoint(eval_semi_cond_bb);
+          prev_comparison_result = join_loop.outer_condition_match_(iterators);
+          last_head_bb = builder.GetInsertBlock();
+          prev_no_match_bb = iter_advance_bb;
         } else {
           prev_comparison_result = have_more_inner_rows;
           last_head_bb = row_not_deleted_bb ? row_not_deleted_bb : head_bb;
@@ -151,7 +160,10 @@ llvm::BasicBlock* JoinLoop::codegen(
           builder.CreateBr(head_bb);
         }
         builder.SetInsertPoint(last_head_bb);
-        prev_iter_advance_bb = iter_advance_bb;
+        // Nothing past a semi join level reads its rows, so the first match is enough:
+        // once the inner levels are done with it, the level is done too.
+        prev_iter_advance_bb =
+            join_loop.type_ == JoinType::SEMI ? prev_exit_bb : iter_advance_bb;
         break;
       }
       case JoinLoopKind::Singleton: {
@@ -161,10 +173,7 @@ llvm::BasicBlock* JoinLoop::codegen(
           entry = true_bb;
         }
         if (prev_comparison_result) {
-          builder.CreateCondBr(
-              prev_comparison_result,
-              true_bb,
-              prev_join_type == JoinType::LEFT ? prev_iter_advance_bb : prev_exit_bb);
+          builder.CreateCondBr(prev_comparison_result, true_bb, prev_no_match_bb);
         }
         prev_exit_bb = prev_iter_advance_bb ? prev_iter_advance_bb : exit_bb;
         builder.SetInsertPoint(true_bb);
@@ -179,7 +188,8 @@ llvm::BasicBlock* JoinLoop::codegen(
         }
         auto match_found_bb = builder.GetInsertBlock();
         switch (join_loop.type_) {
-          case JoinType::INNER: {
+          case JoinType::INNER:
+          case JoinType::SEMI: {
             prev_comparison_result = match_found;
             break;
           }
@@ -195,21 +205,18 @@ llvm::BasicBlock* JoinLoop::codegen(
         if (!prev_iter_advance_bb) {
           prev_iter_advance_bb = prev_exit_bb;
         }
+        prev_no_match_bb = prev_exit_bb;
         last_head_bb = match_found_bb;
         break;
       }
       default:
         CHECK(false);
     }
-    prev_join_type = join_loop.type_;
   }
   const auto body_bb = body_codegen(iterators);
   builder.CreateBr(prev_iter_advance_bb);
   builder.SetInsertPoint(last_head_bb);
-  builder.CreateCondBr(
-      prev_comparison_result,
-      body_bb,
-      prev_join_type == JoinType::LEFT ? prev_iter_advance_bb : prev_exit_bb);
+  builder.CreateCondBr(prev_comparison_result, body_bb, prev_no_match_bb);
   return entry;
 }
 
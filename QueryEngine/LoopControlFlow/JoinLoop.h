@@ -89,7 +89,7 @@ class JoinLoop {
   const std::function<JoinLoopDomain(const std::vector<llvm::Value*>&)>
       iteration_domain_codegen_;
   // Callback provided from the executor which generates true iff the outer condition
-  // evaluates to true.
+  // evaluates to true, or the condition of a semi join which has no hash table.
   const std::function<llvm::Value*(const std::vector<llvm::Value*>&)>
       outer_condition_match_;
   // Callback provided from the executor which receives the IR boolean value which tracks
@@ -18,11 +18,16 @@
 #include "Execute.h"
 #include "ExtensionFunctionsWhitelist.h"
 #include "GpuSharedMemoryUtils.h"
+#include "JitObjectCache.h"
 #include "LLVMFunctionAttributesUtil.h"
+#include "MapDRelease.h"
 #include "OutputBufferInitialization.h"
 #include "QueryTemplateGenerator.h"
+#include "ScalarExprVisitor.h"
 
 #include "Shared/MathUtils.h"
+#include "Shared/Metrics.h"
+#include "Shared/StringTransform.h"
 #include "Shared/mapdpath.h"
 #include "StreamingTopN.h"
 
@@ -30,8 +35,10 @@
 static_assert(false, "LLVM Version >= 4 is required.");
 #endif
 
+#include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/GlobalValue.h>
@@ -39,6 +46,7 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Object/SymbolSize.h>
 #include <llvm/Support/Casting.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
@@ -55,6 +63,7 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Vectorize.h>
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Intrinsics.h"
 
@@ -67,7 +76,19 @@ static_assert(false, "LLVM Version >= 4 is required.");
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <unistd.h>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
 float g_fraction_code_cache_to_evict = 0.2;
+bool g_enable_jit_host_cpu_features{true};
+bool g_enable_cpu_loop_vectorization{true};
+bool g_enable_tiered_cpu_compilation{false};
+bool g_enable_parallel_cpu_code_generation{false};
+bool g_enable_jit_perf_map{false};
+bool g_enable_jit_gdb_registration{false};
+size_t g_tiered_cpu_compilation_max_rows{1000000};
 
 std::unique_ptr<llvm::Module> udf_gpu_module;
 std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -148,7 +169,13 @@ void optimize_ir(llvm::Function* query_func,
                  llvm::Module* module,
                  llvm::legacy::PassManager& pass_manager,
                  const std::unordered_set<llvm::Function*>& live_funcs,
-                 const CompilationOptions& co) {
+                 const CompilationOptions& co,
+                 llvm::TargetMachine* vectorizer_target_machine = nullptr) {
+  if (vectorizer_target_machine) {
+    // without the costs of the target, the vectorizers see no vector registers
+    pass_manager.add(llvm::createTargetTransformInfoWrapperPass(
+        vectorizer_target_machine->getTargetIRAnalysis()));
+  }
   pass_manager.add(llvm::createAlwaysInlinerLegacyPass());
   pass_manager.add(llvm::createPromoteMemoryToRegisterPass());
 #if LLVM_VERSION_MAJOR >= 7
@@ -160,6 +187,14 @@ void optimize_ir(llvm::Function* query_func,
   pass_manager.add(llvm::createGlobalOptimizerPass());
 
   pass_manager.add(llvm::createLICMPass());
+  if (vectorizer_target_machine) {
+    // Once the row function is inlined, the row loop of simple filters and aggregates
+    // has no calls left: the loop vectorizer if-converts the filters into selects and
+    // processes a vector of rows per iteration.
+    pass_manager.add(llvm::createLoopVectorizePass());
+    pass_manager.add(llvm::createSLPVectorizerPass());
+    pass_manager.add(llvm::createInstructionCombiningPass());
+  }
   if (co.opt_level == ExecutorOptLevel::LoopStrengthReduction) {
     pass_manager.add(llvm::createLoopStrengthReducePass());
   }
@@ -169,6 +204,65 @@ void optimize_ir(llvm::Function* query_func,
 }
 #endif
 
+void append_to_perf_map(const std::string& entries) {
+  static std::mutex perf_map_mutex;
+  std::lock_guard<std::mutex> perf_map_lock(perf_map_mutex);
+  static std::ofstream perf_map("/tmp/perf-" + std::to_string(getpid()) + ".map",
+                                std::ios::app);
+  perf_map << entries << std::flush;
+}
+
+// Appends the functions of the objects the engine loads to /tmp/perf-<pid>.map, where
+// perf looks up the symbols of the addresses with no binary behind them. The names of
+// the functions are the same for all the queries, e.g. multifrag_query, the label of
+// the engine tells which query they belong to.
+class PerfMapListener : public llvm::JITEventListener {
+ public:
+  PerfMapListener(const std::string& label) : label_(label) {}
+
+#if LLVM_VERSION_MAJOR >= 7
+  void notifyObjectLoaded(
+      ObjectKey,
+      const llvm::object::ObjectFile& object,
+      const llvm::RuntimeDyld::LoadedObjectInfo& loaded_object_info) override {
+#else
+  void NotifyObjectEmitted(
+      const llvm::object::ObjectFile& object,
+      const llvm::RuntimeDyld::LoadedObjectInfo& loaded_object_info) override {
+#endif
+    // the symbols of the object for debug have the addresses of the loaded code
+    const auto debug_object = loaded_object_info.getObjectForDebug(object);
+    if (!debug_object.getBinary()) {
+      return;
+    }
+    std::ostringstream entries;
+    for (const auto& [symbol, size] :
+         llvm::object::computeSymbolSizes(*debug_object.getBinary())) {
+      auto type = symbol.getType();
+      if (!type) {
+        llvm::consumeError(type.takeError());
+        continue;
+      }
+      if (*type != llvm::object::SymbolRef::ST_Function) {
+        continue;
+      }
+      auto name = symbol.getName();
+      auto address = symbol.getAddress();
+      if (!name || !address) {
+        llvm::consumeError(name.takeError());
+        llvm::consumeError(address.takeError());
+        continue;
+      }
+      entries << std::hex << *address << " " << size << std::dec << " " << name->str()
+              << " [" << label_ << "]\n";
+    }
+    append_to_perf_map(entries.str());
+  }
+
+ private:
+  const std::string label_;
+};
+
 }  // namespace
 
 ExecutionEngineWrapper::ExecutionEngineWrapper() {}
@@ -177,9 +271,19 @@ ExecutionEngineWrapper::ExecutionEngineWrapper(llvm::ExecutionEngine* execution_
     : execution_engine_(execution_engine) {}
 
 ExecutionEngineWrapper::ExecutionEngineWrapper(llvm::ExecutionEngine* execution_engine,
-                                               const CompilationOptions& co)
+                                               const CompilationOptions& co,
+                                               const std::string& jit_label)
     : execution_engine_(execution_engine) {
   if (execution_engine_) {
+    if (g_enable_jit_perf_map) {
+      perf_map_listener_ = std::make_unique<PerfMapListener>(jit_label);
+      execution_engine_->RegisterJITEventListener(perf_map_listener_.get());
+    }
+    if (g_enable_jit_gdb_registration) {
+      // a static of LLVM, the engine unregisters its objects when it's destroyed
+      execution_engine_->RegisterJITEventListener(
+          llvm::JITEventListener::createGDBRegistrationListener());
+    }
     if (co.register_intel_jit_listener) {
 #ifdef ENABLE_INTEL_JIT_LISTENER
       intel_jit_listener_.reset(llvm::JITEventListener::createIntelJITEventListener());
@@ -198,6 +302,7 @@ ExecutionEngineWrapper& ExecutionEngineWrapper::operator=(
     llvm::ExecutionEngine* execution_engine) {
   execution_engine_.reset(execution_engine);
   intel_jit_listener_ = nullptr;
+  perf_map_listener_ = nullptr;
   return *this;
 }
 
@@ -212,12 +317,18 @@ void verify_function_ir(const llvm::Function* func) {
 
 std::shared_ptr<CompilationContext> Executor::getCodeFromCache(const CodeCacheKey& key,
                                                                const CodeCache& cache) {
+  static auto& hits = metrics::Registry::instance().counter(
+      "omnisci_code_cache_hits_total", "The compilations served from the cache");
+  static auto& misses = metrics::Registry::instance().counter(
+      "omnisci_code_cache_misses_total", "The compilations not in the cache");
   auto it = cache.find(key);
   if (it != cache.cend()) {
+    hits.add();
     delete cgen_state_->module_;
     cgen_state_->module_ = it->second.second;
     return it->second.first;
   }
+  misses.add();
   return {};
 }
 
@@ -232,6 +343,119 @@ void Executor::addCodeToCache(const CodeCacheKey& key,
 
 namespace {
 
+void set_host_cpu_features(llvm::EngineBuilder& eb) {
+  if (g_enable_jit_host_cpu_features) {
+    // without these, code is generated for the baseline x86-64 ISA, i.e. SSE2 only, and
+    // the loads and arithmetic of the row function never use the AVX2 / AVX-512 units
+    eb.setMCPU(llvm::sys::getHostCPUName());
+    llvm::StringMap<bool> cpu_features;
+    if (llvm::sys::getHostCPUFeatures(cpu_features)) {
+      std::vector<std::string> mattrs;
+      for (const auto& feature : cpu_features) {
+        mattrs.push_back((feature.getValue() ? "+" : "-") + feature.getKey().str());
+      }
+      eb.setMAttrs(mattrs);
+    }
+  }
+}
+
+#ifndef WITH_JIT_DEBUG
+// The target the CPU code is generated for, whose vector widths and instruction costs
+// the loop vectorizer needs, or null when the loops of the query aren't vectorized
+std::unique_ptr<llvm::TargetMachine> create_vectorizer_target_machine(
+    const CompilationOptions& co) {
+  if (!g_enable_cpu_loop_vectorization || co.device_type != ExecutorDeviceType::CPU ||
+      co.opt_level == ExecutorOptLevel::ReductionJIT) {
+    return nullptr;
+  }
+  llvm::EngineBuilder eb;
+  set_host_cpu_features(eb);
+  return std::unique_ptr<llvm::TargetMachine>(eb.selectTarget());
+}
+#endif  // WITH_JIT_DEBUG
+
+// What the CPU objects of the JitObjectCache also depend on, besides the IR of the query
+std::string get_cpu_object_target(const CompilationOptions& co) {
+  std::string target = MAPD_RELEASE + " LLVM " + LLVM_VERSION_STRING + " " +
+                       llvm::sys::getProcessTriple() + " opt " +
+                       std::to_string(static_cast<int>(co.opt_level)) +
+                       (g_enable_cpu_loop_vectorization ? " vectorized" : "");
+  if (g_enable_jit_host_cpu_features) {
+    target += " " + llvm::sys::getHostCPUName().str();
+    llvm::StringMap<bool> cpu_features;
+    if (llvm::sys::getHostCPUFeatures(cpu_features)) {
+      std::vector<std::string> enabled_features;
+      for (const auto& feature : cpu_features) {
+        if (feature.getValue()) {
+          enabled_features.push_back(feature.getKey().str());
+        }
+      }
+      // the iteration order of the map is unspecified
+      std::sort(enabled_features.begin(), enabled_features.end());
+      for (const auto& feature : enabled_features) {
+        target += " +" + feature;
+      }
+    }
+  }
+  return target;
+}
+
+// Whether the first run of the query gets quickly compiled code, while the optimized code
+// is generated in the background: the optimizations cost more than they save on the
+// inputs of at most g_tiered_cpu_compilation_max_rows rows
+bool use_tiered_cpu_compilation(const CompilationOptions& co,
+                                const std::vector<InputTableInfo>& query_infos,
+                                const size_t pending_compilation_count) {
+  if (!g_enable_tiered_cpu_compilation || co.device_type != ExecutorDeviceType::CPU ||
+      co.opt_level == ExecutorOptLevel::ReductionJIT ||
+      pending_compilation_count >= cpu_threads()) {
+    return false;
+  }
+  size_t row_count{0};
+  for (const auto& query_info : query_infos) {
+    row_count += query_info.info.getNumTuplesUpperBound();
+  }
+  return row_count <= g_tiered_cpu_compilation_max_rows;
+}
+
+// Generates the optimized code of the bitcode of a module in a new LLVM context, since
+// the global one can't be used outside of the compilation of the queries
+CodeCacheValWithModule optimize_cpu_code(const std::string& bitcode,
+                                         const std::string& query_func_name,
+                                         const std::string& multifrag_query_func_name,
+                                         const std::vector<std::string>& live_func_names,
+                                         const CompilationOptions& co,
+                                         const std::string& query_fingerprint,
+                                         const std::string& object_name) {
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto module_or_err = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(bitcode, "optimized_query"), *context);
+  if (!module_or_err) {
+    throw std::runtime_error("Could not read the bitcode of the query: " +
+                             llvm::toString(module_or_err.takeError()));
+  }
+  auto module = module_or_err->release();
+  if (!query_fingerprint.empty()) {
+    module->setModuleIdentifier(query_fingerprint);
+  }
+  std::unordered_set<llvm::Function*> live_funcs;
+  for (const auto& name : live_func_names) {
+    if (auto func = module->getFunction(name)) {
+      live_funcs.insert(func);
+    }
+  }
+  auto query_func = module->getFunction(query_func_name);
+  auto multifrag_query_func = module->getFunction(multifrag_query_func_name);
+  CHECK(query_func);
+  CHECK(multifrag_query_func);
+  auto execution_engine =
+      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co, object_name);
+  auto cpu_compilation_context = std::make_shared<CpuCompilationContext>(
+      std::move(execution_engine), std::move(context));
+  cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+  return {cpu_compilation_context, module};
+}
+
 std::string assemblyForCPU(ExecutionEngineWrapper& execution_engine,
                            llvm::Module* module) {
   llvm::legacy::PassManager pass_manager;
@@ -253,26 +477,24 @@ std::string assemblyForCPU(ExecutionEngineWrapper& execution_engine,
   return "Assembly for the CPU:\n" + std::string(code_str.str()) + "\nEnd of assembly";
 }
 
-}  // namespace
-
-ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
-    llvm::Function* func,
-    const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
-  auto module = func->getParent();
-  // run optimizations
-#ifndef WITH_JIT_DEBUG
-  llvm::legacy::PassManager pass_manager;
-  optimize_ir(func, module, pass_manager, live_funcs, co);
-#endif  // WITH_JIT_DEBUG
-
+void initialize_native_target() {
   auto init_err = llvm::InitializeNativeTarget();
   CHECK(!init_err);
 
   llvm::InitializeAllTargetMCs();
   llvm::InitializeNativeTargetAsmPrinter();
   llvm::InitializeNativeTargetAsmParser();
+}
 
+// Generates the machine code of the optimized module, which the engine takes
+ExecutionEngineWrapper create_cpu_execution_engine(llvm::Module* module,
+                                                   const CompilationOptions& co,
+                                                   JitObjectCache* object_cache) {
+  // the fingerprint of the query, like the name of its object in the JitObjectCache
+  auto jit_label = module->getModuleIdentifier();
+  if (boost::algorithm::ends_with(jit_label, ".o")) {
+    jit_label.resize(jit_label.size() - 2);
+  }
   std::string err_str;
   std::unique_ptr<llvm::Module> owner(module);
   llvm::EngineBuilder eb(std::move(owner));
@@ -281,19 +503,86 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
   llvm::TargetOptions to;
   to.EnableFastISel = true;
   eb.setTargetOptions(to);
+  set_host_cpu_features(eb);
   if (co.opt_level == ExecutorOptLevel::ReductionJIT) {
     eb.setOptLevel(llvm::CodeGenOpt::None);
   }
 
-  ExecutionEngineWrapper execution_engine(eb.create(), co);
+  ExecutionEngineWrapper execution_engine(eb.create(), co, jit_label);
   CHECK(execution_engine.get());
   LOG(ASM) << assemblyForCPU(execution_engine, module);
 
+  if (object_cache) {
+    execution_engine->setObjectCache(object_cache);
+  }
   execution_engine->finalizeObject();
 
   return execution_engine;
 }
 
+// Generates the machine code of the bitcode of an optimized module in a new LLVM
+// context, outside of the compilation lock which guards the global one
+std::shared_ptr<CpuCompilationContext> generate_cpu_code(
+    const std::string& bitcode,
+    const std::string& multifrag_query_func_name,
+    const CompilationOptions& co,
+    const std::string& query_fingerprint,
+    const std::string& object_name) {
+  auto context = std::make_unique<llvm::LLVMContext>();
+  auto module_or_err = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(bitcode, "query"), *context);
+  if (!module_or_err) {
+    throw std::runtime_error("Could not read the bitcode of the query: " +
+                             llvm::toString(module_or_err.takeError()));
+  }
+  auto module = module_or_err->release();
+  if (!query_fingerprint.empty()) {
+    module->setModuleIdentifier(query_fingerprint);
+  }
+  auto object_cache = object_name.empty() ? nullptr : JitObjectCache::get();
+  if (object_cache) {
+    module->setModuleIdentifier(object_name);
+  }
+  auto multifrag_query_func = module->getFunction(multifrag_query_func_name);
+  CHECK(multifrag_query_func);
+  auto execution_engine = create_cpu_execution_engine(module, co, object_cache);
+  auto cpu_compilation_context = std::make_shared<CpuCompilationContext>(
+      std::move(execution_engine), std::move(context));
+  cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+  return cpu_compilation_context;
+}
+
+}  // namespace
+
+ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
+    llvm::Function* func,
+    const std::unordered_set<llvm::Function*>& live_funcs,
+    const CompilationOptions& co,
+    const std::string& object_name) {
+  auto module = func->getParent();
+  auto object_cache = object_name.empty() ? nullptr : JitObjectCache::get();
+  // MCJIT loads the cached object instead of compiling the module, whose optimization
+  // would be wasted
+  const bool has_cached_object = object_cache && object_cache->contains(object_name);
+  if (object_cache) {
+    module->setModuleIdentifier(object_name);
+  }
+
+  initialize_native_target();
+
+  // run optimizations
+#ifndef WITH_JIT_DEBUG
+  if (!has_cached_object) {
+    llvm::legacy::PassManager pass_manager;
+    const auto vectorizer_target_machine = create_vectorizer_target_machine(co);
+    optimize_ir(
+        func, module, pass_manager, live_funcs, co, vectorizer_target_machine.get());
+  }
+#endif  // WITH_JIT_DEBUG
+
+  return create_cpu_execution_engine(module, co, object_cache);
+}
+
 std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
     llvm::Function* query_func,
     llvm::Function* multifrag_query_func,
@@ -305,6 +594,7 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
   for (const auto helper : cgen_state_->helper_functions_) {
     key.push_back(serialize_llvm_object(helper));
   }
+  swapInOptimizedCpuCode(key);
   auto cached_code = getCodeFromCache(key, cpu_code_cache_);
   if (cached_code) {
     return cached_code;
@@ -341,8 +631,90 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
 #endif
   }
 
+  auto object_cache = JitObjectCache::get();
+  // names the code of the query in the perf map, as well as its object in the cache
+  const auto query_fingerprint =
+      object_cache || g_enable_jit_perf_map
+          ? JitObjectCache::getObjectName(key, get_cpu_object_target(co), "")
+          : std::string();
+  const auto object_name = object_cache ? query_fingerprint + ".o" : std::string();
+  if (!query_fingerprint.empty()) {
+    module->setModuleIdentifier(query_fingerprint);
+  }
+  if (use_tiered_cpu_compilation(
+          co, cgen_state_->query_infos_, optimizing_cpu_code_.size()) &&
+      !(object_cache && object_cache->contains(object_name))) {
+    // the module is optimized in place below, its bitcode is taken before
+    std::string bitcode;
+    llvm::raw_string_ostream bitcode_os(bitcode);
+    llvm::WriteBitcodeToFile(*module, bitcode_os);
+    bitcode_os.flush();
+    std::vector<std::string> live_func_names;
+    for (const auto func : live_funcs) {
+      if (func && func->hasName()) {
+        live_func_names.push_back(func->getName().str());
+      }
+    }
+    optimizing_cpu_code_[key] = std::async(std::launch::async,
+                                           optimize_cpu_code,
+                                           std::move(bitcode),
+                                           query_func->getName().str(),
+                                           multifrag_query_func->getName().str(),
+                                           std::move(live_func_names),
+                                           co,
+                                           query_fingerprint,
+                                           object_name);
+    // compiled like the reduction code, without the vectorizers and the optimizations
+    // of the machine code
+    auto quick_co = co;
+    quick_co.opt_level = ExecutorOptLevel::ReductionJIT;
+    auto execution_engine =
+        CodeGenerator::generateNativeCPUCode(query_func, live_funcs, quick_co);
+    auto cpu_compilation_context =
+        std::make_shared<CpuCompilationContext>(std::move(execution_engine));
+    cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+    addCodeToCache(key, cpu_compilation_context, module, cpu_code_cache_);
+    return cpu_compilation_context;
+  }
+
+#ifndef WITH_JIT_DEBUG
+  if (g_enable_parallel_cpu_code_generation &&
+      !(object_cache && object_cache->contains(object_name))) {
+    // Only the optimizations need the global LLVM context. The machine code is
+    // generated from the bitcode of the optimized module, which is much smaller than
+    // the runtime, while the next query compiles and the kernels fetch their chunks.
+    initialize_native_target();
+    llvm::legacy::PassManager pass_manager;
+    const auto vectorizer_target_machine = create_vectorizer_target_machine(co);
+    optimize_ir(query_func,
+                module,
+                pass_manager,
+                live_funcs,
+                co,
+                vectorizer_target_machine.get());
+    std::string bitcode;
+    llvm::raw_string_ostream bitcode_os(bitcode);
+    llvm::WriteBitcodeToFile(*module, bitcode_os);
+    bitcode_os.flush();
+    auto pending_code = std::async(std::launch::async,
+                                   generate_cpu_code,
+                                   std::move(bitcode),
+                                   multifrag_query_func->getName().str(),
+                                   co,
+                                   query_fingerprint,
+                                   object_name);
+    // like on the hits of the code cache, nothing refers to the module past this point
+    delete module;
+    cgen_state_->module_ = nullptr;
+    auto cpu_compilation_context =
+        std::make_shared<CpuCompilationContext>(pending_code.share());
+    addCodeToCache(key, cpu_compilation_context, nullptr, cpu_code_cache_);
+    return cpu_compilation_context;
+  }
+#endif  // WITH_JIT_DEBUG
+
   auto execution_engine =
-      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co, object_name);
   auto cpu_compilation_context =
       std::make_shared<CpuCompilationContext>(std::move(execution_engine));
   cpu_compilation_context->setFunctionPointer(multifrag_query_func);
@@ -350,13 +722,84 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
   return cpu_compilation_context;
 }
 
+void Executor::swapInOptimizedCpuCode(const CodeCacheKey& key) {
+  for (auto it = optimizing_cpu_code_.begin(); it != optimizing_cpu_code_.end();) {
+    const bool is_key = it->first == key;
+    if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    // the compilations of other keys are done too, the slots they take are freed
+    try {
+      auto optimized_code = it->second.get();
+      if (is_key || cpu_code_cache_.find(it->first) != cpu_code_cache_.cend()) {
+        VLOG(1) << "Swapping in the optimized code of a tiered query";
+        cpu_code_cache_.put(it->first, std::move(optimized_code));
+      }
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Keeping the quickly compiled code of a query: " << e.what();
+    }
+    it = optimizing_cpu_code_.erase(it);
+  }
+}
+
+namespace {
+
+// The name of a UDF in the extension functions whitelist, without the suffix of its
+// overloads and of its device
+std::string drop_udf_suffix(const std::string& name) {
+  return name.substr(0, name.find("__"));
+}
+
+// The functions of udf_module named udf_names and the functions they use, directly or not
+std::unordered_set<const llvm::Function*> get_used_udf_functions(
+    const llvm::Module& udf_module,
+    const std::unordered_set<std::string>& udf_names) {
+  std::unordered_set<const llvm::Function*> used_funcs;
+  std::vector<const llvm::Function*> pending_funcs;
+  for (const auto& f : udf_module) {
+    if (!f.isDeclaration() &&
+        udf_names.count(to_upper(drop_udf_suffix(f.getName().str())))) {
+      used_funcs.insert(&f);
+      pending_funcs.push_back(&f);
+    }
+  }
+  while (!pending_funcs.empty()) {
+    const auto func = pending_funcs.back();
+    pending_funcs.pop_back();
+    for (const auto& inst : llvm::instructions(func)) {
+      for (const auto& operand : inst.operands()) {
+        const auto callee =
+            llvm::dyn_cast<llvm::Function>(operand.get()->stripPointerCasts());
+        if (callee && used_funcs.insert(callee).second) {
+          pending_funcs.push_back(callee);
+        }
+      }
+    }
+  }
+  return used_funcs;
+}
+
+}  // namespace
+
 void CodeGenerator::link_udf_module(const std::unique_ptr<llvm::Module>& udf_module,
                                     llvm::Module& module,
                                     CgenState* cgen_state,
-                                    llvm::Linker::Flags flags) {
+                                    llvm::Linker::Flags flags,
+                                    const std::unordered_set<std::string>* udf_names) {
+  const auto used_funcs = udf_names
+                              ? get_used_udf_functions(*udf_module, *udf_names)
+                              : std::unordered_set<const llvm::Function*>{};
+  auto is_linked = [udf_names, &used_funcs](const llvm::GlobalValue* gv) {
+    const auto func = llvm::dyn_cast<llvm::Function>(gv);
+    return !udf_names || !func || used_funcs.count(func);
+  };
   // throw a runtime error if the target module contains functions
   // with the same name as in module of UDF functions.
   for (auto& f : *udf_module.get()) {
+    if (!is_linked(&f)) {
+      continue;
+    }
     auto func = module.getFunction(f.getName());
     if (!(func == nullptr) && !f.isDeclaration() && flags == llvm::Linker::Flags::None) {
       LOG(ERROR) << "  Attempt to overwrite " << f.getName().str() << " in "
@@ -380,7 +823,20 @@ void CodeGenerator::link_udf_module(const std::unique_ptr<llvm::Module>& udf_mod
 #else
       udf_module.get(),
 #endif
-      cgen_state->vmap_);
+      cgen_state->vmap_,
+      is_linked);
+  if (udf_names) {
+    // the UDFs the query doesn't use are only declared in the copy, drop them
+    std::vector<llvm::Function*> unused_funcs;
+    for (auto& f : *udf_module_copy) {
+      if (f.isDeclaration() && f.use_empty()) {
+        unused_funcs.push_back(&f);
+      }
+    }
+    for (auto f : unused_funcs) {
+      f->eraseFromParent();
+    }
+  }
 
   udf_module_copy->setDataLayout(module.getDataLayout());
   udf_module_copy->setTargetTriple(module.getTargetTriple());
@@ -453,6 +909,7 @@ declare void @llvm.lifetime.start.p0i8(i64, i8* nocapture) nounwind
 declare void @llvm.lifetime.end.p0i8(i64, i8* nocapture) nounwind
 declare i64 @get_thread_index();
 declare i64 @get_block_index();
+declare i64 @get_block_dim();
 declare i32 @pos_start_impl(i32*);
 declare i32 @group_buff_idx_impl();
 declare i32 @pos_step_impl();
@@ -460,13 +917,24 @@ declare i8 @thread_warp_idx(i8);
 declare i64* @init_shared_mem(i64*, i32);
 declare i64* @init_shared_mem_nop(i64*, i32);
 declare i64* @declare_dynamic_shared_memory();
-declare void @write_back_nop(i64*, i64*, i32);
+declare void @init_shared_join_hash_table(i32*, i32*, i32);
+declare void @write_back_nop(i64*, i64*, i32, i32*);
 declare void @write_back_non_grouped_agg(i64*, i64*, i32);
 declare void @init_group_by_buffer_gpu(i64*, i64*, i32, i32, i32, i1, i8);
 declare i64* @get_group_value(i64*, i32, i64*, i32, i32, i32, i64*);
 declare i64* @get_group_value_with_watchdog(i64*, i32, i64*, i32, i32, i32, i64*);
 declare i32 @get_group_value_columnar_slot(i64*, i32, i64*, i32, i32);
 declare i32 @get_group_value_columnar_slot_with_watchdog(i64*, i32, i64*, i32, i32);
+declare i64* @get_group_value_32(i64*, i32, i64*, i32, i32, i64*);
+declare i64* @get_group_value_64(i64*, i32, i64*, i32, i32, i64*);
+declare i64* @get_group_value_with_watchdog_32(i64*, i32, i64*, i32, i32, i64*);
+declare i64* @get_group_value_with_watchdog_64(i64*, i32, i64*, i32, i32, i64*);
+declare i64* @get_group_value_with_smem_spill(i64*, i32, i64*, i32, i32, i32, i64*, i32);
+declare i64* @get_group_value_with_smem_spill_with_watchdog(i64*, i32, i64*, i32, i32, i32, i64*, i32);
+declare i32 @get_group_value_columnar_slot_32(i64*, i32, i64*, i32);
+declare i32 @get_group_value_columnar_slot_64(i64*, i32, i64*, i32);
+declare i32 @get_group_value_columnar_slot_with_watchdog_32(i64*, i32, i64*, i32);
+declare i32 @get_group_value_columnar_slot_with_watchdog_64(i64*, i32, i64*, i32);
 declare i64* @get_group_value_fast(i64*, i64, i64, i64, i32);
 declare i64* @get_group_value_fast_with_original_key(i64*, i64, i64, i64, i64, i32);
 declare i32 @get_columnar_group_bin_offset(i64*, i64, i64, i64);
@@ -533,6 +1001,7 @@ declare i1 @slotEmptyKeyCAS(i64*, i64, i64);
 declare i1 @slotEmptyKeyCAS_int32(i32*, i32, i32);
 declare i1 @slotEmptyKeyCAS_int16(i16*, i16, i16);
 declare i1 @slotEmptyKeyCAS_int8(i8*, i8, i8);
+declare i64 @datetrunc_bucketed(i64, i64*, i32, i32);
 declare i64 @datetrunc_century(i64);
 declare i64 @datetrunc_day(i64);
 declare i64 @datetrunc_decade(i64);
@@ -579,6 +1048,8 @@ declare i1 @array_is_null(i8*, i64);
 declare i1 @point_coord_array_is_null(i8*, i64);
 declare i8* @array_buff(i8*, i64);
 declare i8* @fast_fixlen_array_buff(i8*, i64);
+declare i8* @varlen_array_buff(i8*, i64);
+declare i8* @varlen_notnull_array_buff(i8*, i64);
 declare i8 @array_at_int8_t(i8*, i64, i32);
 declare i16 @array_at_int16_t(i8*, i64, i32);
 declare i32 @array_at_int32_t(i8*, i64, i32);
@@ -617,6 +1088,18 @@ declare i1 @string_like_simple(i8*, i32, i8*, i32);
 declare i1 @string_ilike_simple(i8*, i32, i8*, i32);
 declare i8 @string_like_simple_nullable(i8*, i32, i8*, i32, i8);
 declare i8 @string_ilike_simple_nullable(i8*, i32, i8*, i32, i8);
+declare i1 @string_like_prefix(i8*, i32, i8*, i32);
+declare i1 @string_ilike_prefix(i8*, i32, i8*, i32);
+declare i8 @string_like_prefix_nullable(i8*, i32, i8*, i32, i8);
+declare i8 @string_ilike_prefix_nullable(i8*, i32, i8*, i32, i8);
+declare i1 @string_like_suffix(i8*, i32, i8*, i32);
+declare i1 @string_ilike_suffix(i8*, i32, i8*, i32);
+declare i8 @string_like_suffix_nullable(i8*, i32, i8*, i32, i8);
+declare i8 @string_ilike_suffix_nullable(i8*, i32, i8*, i32, i8);
+declare i1 @string_like_exact(i8*, i32, i8*, i32);
+declare i1 @string_ilike_exact(i8*, i32, i8*, i32);
+declare i8 @string_like_exact_nullable(i8*, i32, i8*, i32, i8);
+declare i8 @string_ilike_exact_nullable(i8*, i32, i8*, i32, i8);
 declare i1 @string_lt(i8*, i32, i8*, i32);
 declare i1 @string_le(i8*, i32, i8*, i32);
 declare i1 @string_gt(i8*, i32, i8*, i32);
@@ -750,6 +1233,54 @@ std::map<std::string, std::string> get_device_parameters(bool cpu_only) {
 }
 
 std::shared_ptr<GpuCompilationContext> CodeGenerator::generateNativeGPUCode(
+    llvm::Function* func,
+    llvm::Function* wrapper_func,
+    const std::unordered_set<llvm::Function*>& live_funcs,
+    const CompilationOptions& co,
+    const GPUTarget& gpu_target,
+    const std::string& ptx_name) {
+#ifdef HAVE_CUDA
+  auto object_cache = ptx_name.empty() ? nullptr : JitObjectCache::get();
+  auto cached_ptx = object_cache ? object_cache->read(ptx_name) : std::nullopt;
+  if (!cached_ptx) {
+    cached_ptx = lowerToPTX(func, wrapper_func, live_funcs, co, gpu_target);
+    if (object_cache) {
+      object_cache->write(ptx_name, *cached_ptx);
+    }
+  }
+  const auto& ptx = *cached_ptx;
+
+  LOG(PTX) << "PTX for the GPU:\n" << ptx << "\nEnd of PTX";
+
+  auto cubin_result = ptx_to_cubin(ptx, gpu_target.block_size, gpu_target.cuda_mgr);
+  auto& option_keys = cubin_result.option_keys;
+  auto& option_values = cubin_result.option_values;
+  auto cubin = cubin_result.cubin;
+  auto link_state = cubin_result.link_state;
+  const auto num_options = option_keys.size();
+
+  auto func_name = wrapper_func->getName().str();
+  auto gpu_compilation_context = std::make_shared<GpuCompilationContext>();
+  for (int device_id = 0; device_id < gpu_target.cuda_mgr->getDeviceCount();
+       ++device_id) {
+    gpu_compilation_context->addDeviceCode(
+        std::make_unique<GpuDeviceCompilationContext>(cubin,
+                                                      func_name,
+                                                      device_id,
+                                                      gpu_target.cuda_mgr,
+                                                      num_options,
+                                                      &option_keys[0],
+                                                      &option_values[0]));
+  }
+
+  checkCudaErrors(cuLinkDestroy(link_state));
+  return gpu_compilation_context;
+#else
+  return {};
+#endif
+}
+
+std::string CodeGenerator::lowerToPTX(
     llvm::Function* func,
     llvm::Function* wrapper_func,
     const std::unordered_set<llvm::Function*>& live_funcs,
@@ -856,34 +1387,8 @@ std::shared_ptr<GpuCompilationContext> CodeGenerator::generateNativeGPUCode(
   module->eraseNamedMetadata(md);
 
   auto cuda_llir = cuda_rt_decls + extension_function_decls(udf_declarations) + ss.str();
-  const auto ptx = generatePTX(
+  return generatePTX(
       cuda_llir, gpu_target.nvptx_target_machine, gpu_target.cgen_state->context_);
-
-  LOG(PTX) << "PTX for the GPU:\n" << ptx << "\nEnd of PTX";
-
-  auto cubin_result = ptx_to_cubin(ptx, gpu_target.block_size, gpu_target.cuda_mgr);
-  auto& option_keys = cubin_result.option_keys;
-  auto& option_values = cubin_result.option_values;
-  auto cubin = cubin_result.cubin;
-  auto link_state = cubin_result.link_state;
-  const auto num_options = option_keys.size();
-
-  auto func_name = wrapper_func->getName().str();
-  auto gpu_compilation_context = std::make_shared<GpuCompilationContext>();
-  for (int device_id = 0; device_id < gpu_target.cuda_mgr->getDeviceCount();
-       ++device_id) {
-    gpu_compilation_context->addDeviceCode(
-        std::make_unique<GpuDeviceCompilationContext>(cubin,
-                                                      func_name,
-                                                      device_id,
-                                                      gpu_target.cuda_mgr,
-                                                      num_options,
-                                                      &option_keys[0],
-                                                      &option_values[0]));
-  }
-
-  checkCudaErrors(cuLinkDestroy(link_state));
-  return gpu_compilation_context;
 #else
   return {};
 #endif
@@ -934,10 +1439,19 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenGPU(
                                       blockSize(),
                                       cgen_state_.get(),
                                       row_func_not_inlined};
+  const auto ptx_name =
+      JitObjectCache::get()
+          ? JitObjectCache::getObjectName(
+                key,
+                MAPD_RELEASE + " LLVM " + LLVM_VERSION_STRING + " CUDA " +
+                    std::to_string(CUDA_VERSION) + " arch " +
+                    std::to_string(static_cast<int>(cuda_mgr->getDeviceArch())),
+                ".ptx")
+          : std::string();
   std::shared_ptr<GpuCompilationContext> compilation_context;
   try {
     compilation_context = CodeGenerator::generateNativeGPUCode(
-        query_func, multifrag_query_func, live_funcs, co, gpu_target);
+        query_func, multifrag_query_func, live_funcs, co, gpu_target, ptx_name);
     addCodeToCache(key, compilation_context, module, gpu_code_cache_);
   } catch (CudaMgr_Namespace::CudaErrorException& cuda_error) {
     if (cuda_error.getStatus() == CUDA_ERROR_OUT_OF_MEMORY) {
@@ -948,7 +1462,7 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenGPU(
                    << "% of GPU code cache and re-trying.";
       gpu_code_cache_.evictFractionEntries(g_fraction_code_cache_to_evict);
       compilation_context = CodeGenerator::generateNativeGPUCode(
-          query_func, multifrag_query_func, live_funcs, co, gpu_target);
+          query_func, multifrag_query_func, live_funcs, co, gpu_target, ptx_name);
       addCodeToCache(key, compilation_context, module, gpu_code_cache_);
     } else {
       throw;
@@ -1108,6 +1622,23 @@ void bind_pos_placeholders(const std::string& pos_fn_name,
   }
 }
 
+// On CPU a kernel scans every row, a constant step lets the loop vectorizer compute the
+// trip count of the row loop
+void bind_cpu_pos_step(llvm::Function* query_func) {
+  for (auto it = llvm::inst_begin(query_func), e = llvm::inst_end(query_func); it != e;
+       ++it) {
+    if (!llvm::isa<llvm::CallInst>(*it)) {
+      continue;
+    }
+    auto& pos_call = llvm::cast<llvm::CallInst>(*it);
+    if (std::string(pos_call.getCalledFunction()->getName()) == "pos_step") {
+      pos_call.replaceAllUsesWith(llvm::ConstantInt::get(pos_call.getType(), 1));
+      pos_call.eraseFromParent();
+      break;
+    }
+  }
+}
+
 void set_row_func_argnames(llvm::Function* row_func,
                            const size_t in_col_count,
                            const size_t agg_col_count,
@@ -1348,6 +1879,9 @@ std::vector<std::string> get_agg_fnames(const std::vector<Analyzer::Expr*>& targ
       case kAPPROX_COUNT_DISTINCT:
         result.emplace_back("agg_approximate_count_distinct");
         break;
+      case kAPPROX_QUANTILE:
+        result.emplace_back("agg_approx_quantile");
+        break;
       default:
         CHECK(false);
     }
@@ -1790,11 +2324,61 @@ std::vector<llvm::Value*> Executor::inlineHoistedLiterals() {
 
 namespace {
 
+// The bytes of GPU shared memory each block can use while num_blocks_per_mp blocks still
+// fit on a multiprocessor, capped by g_gpu_smem_threshold
+size_t get_shared_memory_threshold(const CudaMgr_Namespace::CudaMgr* cuda_mgr,
+                                   const unsigned num_blocks_per_mp) {
+  CHECK(cuda_mgr);
+  return std::min(
+      g_gpu_smem_threshold == 0 ? SIZE_MAX : g_gpu_smem_threshold,
+      cuda_mgr->getMinSharedMemoryPerBlockForAllDevices() / num_blocks_per_mp);
+}
+
+// The entries of the baseline hash table each block keeps in its shared memory, no more
+// than the output buffer in the global memory has
+size_t get_smem_baseline_entry_count(const QueryMemoryDescriptor* query_mem_desc_ptr,
+                                     const size_t shared_memory_threshold_bytes) {
+  return std::min(query_mem_desc_ptr->getEntryCount(),
+                  shared_memory_threshold_bytes / query_mem_desc_ptr->getRowSize());
+}
+
 size_t get_shared_memory_size(const bool shared_mem_used,
-                              const QueryMemoryDescriptor* query_mem_desc_ptr) {
-  return shared_mem_used
-             ? (query_mem_desc_ptr->getRowSize() * query_mem_desc_ptr->getEntryCount())
-             : 0;
+                              const QueryMemoryDescriptor* query_mem_desc_ptr,
+                              const size_t shared_memory_threshold_bytes) {
+  if (!shared_mem_used) {
+    return 0;
+  }
+  if (query_mem_desc_ptr->getQueryDescriptionType() ==
+      QueryDescriptionType::GroupByBaselineHash) {
+    return query_mem_desc_ptr->getRowSize() *
+           get_smem_baseline_entry_count(query_mem_desc_ptr,
+                                         shared_memory_threshold_bytes);
+  }
+  return query_mem_desc_ptr->getRowSize() * query_mem_desc_ptr->getEntryCount();
+}
+
+// skip shared memory usage when dealing with 1) variable length targets, 2)
+// non-basic aggregates (COUNT, SUM, MIN, MAX, AVG)
+// TODO: relax this if necessary
+bool are_smem_group_by_targets_supported(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const QueryMemoryDescriptor* query_mem_desc_ptr) {
+  const auto target_infos =
+      target_exprs_to_infos(ra_exe_unit.target_exprs, *query_mem_desc_ptr);
+  std::unordered_set<SQLAgg> supported_aggs{kCOUNT};
+  if (g_enable_smem_grouped_non_count_agg) {
+    supported_aggs = {kCOUNT, kMIN, kMAX, kSUM, kAVG};
+  }
+  return std::find_if(target_infos.begin(),
+                      target_infos.end(),
+                      [&supported_aggs](const TargetInfo& ti) {
+                        if (ti.sql_type.is_varlen() ||
+                            !supported_aggs.count(ti.agg_kind)) {
+                          return true;
+                        } else {
+                          return false;
+                        }
+                      }) == target_infos.end();
 }
 
 bool is_gpu_shared_mem_supported(const QueryMemoryDescriptor* query_mem_desc_ptr,
@@ -1873,36 +2457,33 @@ bool is_gpu_shared_mem_supported(const QueryMemoryDescriptor* query_mem_desc_ptr
     if (query_mem_desc_ptr->hasKeylessHash() &&
         query_mem_desc_ptr->countDistinctDescriptorsLogicallyEmpty() &&
         !query_mem_desc_ptr->useStreamingTopN()) {
-      const size_t shared_memory_threshold_bytes = std::min(
-          g_gpu_smem_threshold == 0 ? SIZE_MAX : g_gpu_smem_threshold,
-          cuda_mgr->getMinSharedMemoryPerBlockForAllDevices() / num_blocks_per_mp);
+      const size_t shared_memory_threshold_bytes =
+          get_shared_memory_threshold(cuda_mgr, num_blocks_per_mp);
       const auto output_buffer_size =
           query_mem_desc_ptr->getRowSize() * query_mem_desc_ptr->getEntryCount();
       if (output_buffer_size > shared_memory_threshold_bytes) {
         return false;
       }
-
-      // skip shared memory usage when dealing with 1) variable length targets, 2)
-      // non-basic aggregates (COUNT, SUM, MIN, MAX, AVG)
-      // TODO: relax this if necessary
-      const auto target_infos =
-          target_exprs_to_infos(ra_exe_unit.target_exprs, *query_mem_desc_ptr);
-      std::unordered_set<SQLAgg> supported_aggs{kCOUNT};
-      if (g_enable_smem_grouped_non_count_agg) {
-        supported_aggs = {kCOUNT, kMIN, kMAX, kSUM, kAVG};
-      }
-      if (std::find_if(target_infos.begin(),
-                       target_infos.end(),
-                       [&supported_aggs](const TargetInfo& ti) {
-                         if (ti.sql_type.is_varlen() ||
-                             !supported_aggs.count(ti.agg_kind)) {
-                           return true;
-                         } else {
-                           return false;
-                         }
-                       }) == target_infos.end()) {
-        return true;
+      return are_smem_group_by_targets_supported(ra_exe_unit, query_mem_desc_ptr);
+    }
+  }
+  if (query_mem_desc_ptr->getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByBaselineHash &&
+      g_enable_smem_group_by && g_enable_smem_baseline_group_by) {
+    /**
+     * Unlike perfect hash, the output buffer doesn't have to fit in the shared memory:
+     * each block aggregates into a hash table of as many entries as fit in it and the
+     * keys which don't find room there go to the output buffer in the global memory.
+     * A block table smaller than a warp would send most rows there anyway.
+     */
+    if (query_mem_desc_ptr->countDistinctDescriptorsLogicallyEmpty() &&
+        !query_mem_desc_ptr->useStreamingTopN()) {
+      const auto smem_entry_count = get_smem_baseline_entry_count(
+          query_mem_desc_ptr, get_shared_memory_threshold(cuda_mgr, num_blocks_per_mp));
+      if (smem_entry_count < 32) {
+        return false;
       }
+      return are_smem_group_by_targets_supported(ra_exe_unit, query_mem_desc_ptr);
     }
   }
   return false;
@@ -1960,6 +2541,57 @@ std::string serialize_llvm_metadata_footnotes(llvm::Function* query_func,
   return llvm_ir;
 }
 
+class UsedFunctionNamesVisitor
+    : public ScalarExprVisitor<std::unordered_set<std::string>> {
+ protected:
+  std::unordered_set<std::string> visitFunctionOper(
+      const Analyzer::FunctionOper* func_oper) const override {
+    auto result = ScalarExprVisitor::visitFunctionOper(func_oper);
+    result.insert(to_upper(func_oper->getName()));
+    return result;
+  }
+
+  std::unordered_set<std::string> aggregateResult(
+      const std::unordered_set<std::string>& aggregate,
+      const std::unordered_set<std::string>& next_result) const override {
+    auto result = aggregate;
+    result.insert(next_result.begin(), next_result.end());
+    return result;
+  }
+};
+
+// The upper case names of the functions called by the expressions of ra_exe_unit, the
+// UDFs linked into the module of the query
+std::unordered_set<std::string> get_used_function_names(
+    const RelAlgExecutionUnit& ra_exe_unit) {
+  UsedFunctionNamesVisitor visitor;
+  std::unordered_set<std::string> names;
+  auto collect_names = [&visitor, &names](const Analyzer::Expr* expr) {
+    if (expr) {
+      const auto expr_names = visitor.visit(expr);
+      names.insert(expr_names.begin(), expr_names.end());
+    }
+  };
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    collect_names(target_expr);
+  }
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    collect_names(groupby_expr.get());
+  }
+  for (const auto& qual : ra_exe_unit.simple_quals) {
+    collect_names(qual.get());
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    collect_names(qual.get());
+  }
+  for (const auto& join_condition : ra_exe_unit.join_quals) {
+    for (const auto& qual : join_condition.quals) {
+      collect_names(qual.get());
+    }
+  }
+  return names;
+}
+
 }  // namespace
 
 std::tuple<CompilationResult, std::unique_ptr<QueryMemoryDescriptor>>
@@ -2019,19 +2651,21 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
                                   co.device_type,
                                   cuda_mgr ? this->blockSize() : 1,
                                   cuda_mgr ? this->numBlocksPerMP() : 1);
+  const size_t gpu_smem_threshold_bytes =
+      gpu_shared_mem_optimization
+          ? get_shared_memory_threshold(cuda_mgr, this->numBlocksPerMP())
+          : 0;
+  const GpuSharedMemoryContext gpu_smem_context(get_shared_memory_size(
+      gpu_shared_mem_optimization, query_mem_desc.get(), gpu_smem_threshold_bytes));
   if (gpu_shared_mem_optimization) {
     // disable interleaved bins optimization on the GPU
     query_mem_desc->setHasInterleavedBinsOnGpu(false);
     LOG(DEBUG1) << "GPU shared memory is used for the " +
                        query_mem_desc->queryDescTypeToString() + " query(" +
-                       std::to_string(get_shared_memory_size(gpu_shared_mem_optimization,
-                                                             query_mem_desc.get())) +
+                       std::to_string(gpu_smem_context.getSharedMemorySize()) +
                        " out of " + std::to_string(g_gpu_smem_threshold) + " bytes).";
   }
 
-  const GpuSharedMemoryContext gpu_smem_context(
-      get_shared_memory_size(gpu_shared_mem_optimization, query_mem_desc.get()));
-
   if (co.device_type == ExecutorDeviceType::GPU) {
     const size_t num_count_distinct_descs =
         query_mem_desc->getCountDistinctDescriptorsSize();
@@ -2039,11 +2673,19 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       const auto& count_distinct_descriptor =
           query_mem_desc->getCountDistinctDescriptor(i);
       if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+          count_distinct_descriptor.impl_type_ == CountDistinctImplType::HashSet ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals)) {
         throw QueryMustRunOnCpu();
       }
     }
+    // the t-digests of APPROX_PERCENTILE are only updated on the host
+    for (const auto target_expr : ra_exe_unit.target_exprs) {
+      const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(target_expr);
+      if (agg_expr && agg_expr->get_aggtype() == kAPPROX_QUANTILE) {
+        throw QueryMustRunOnCpu();
+      }
+    }
   }
 
   // Read the module template and target either CPU or GPU
@@ -2066,13 +2708,22 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
                 CodeGenerator::alwaysCloneRuntimeFunction(func));
       });
 
+  // only the UDFs the query calls get into its module, rather than all of them
+  const auto used_function_names = get_used_function_names(ra_exe_unit);
   if (co.device_type == ExecutorDeviceType::CPU) {
     if (is_udf_module_present(true)) {
-      CodeGenerator::link_udf_module(udf_cpu_module, *rt_module_copy, cgen_state_.get());
+      CodeGenerator::link_udf_module(udf_cpu_module,
+                                     *rt_module_copy,
+                                     cgen_state_.get(),
+                                     llvm::Linker::Flags::None,
+                                     &used_function_names);
     }
     if (is_rt_udf_module_present(true)) {
-      CodeGenerator::link_udf_module(
-          rt_udf_cpu_module, *rt_module_copy, cgen_state_.get());
+      CodeGenerator::link_udf_module(rt_udf_cpu_module,
+                                     *rt_module_copy,
+                                     cgen_state_.get(),
+                                     llvm::Linker::Flags::None,
+                                     &used_function_names);
     }
   } else {
     rt_module_copy->setDataLayout(get_gpu_data_layout());
@@ -2085,11 +2736,18 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
         throw QueryMustRunOnCpu();
       }
 
-      CodeGenerator::link_udf_module(udf_gpu_module, *rt_module_copy, cgen_state_.get());
+      CodeGenerator::link_udf_module(udf_gpu_module,
+                                     *rt_module_copy,
+                                     cgen_state_.get(),
+                                     llvm::Linker::Flags::None,
+                                     &used_function_names);
     }
     if (is_rt_udf_module_present()) {
-      CodeGenerator::link_udf_module(
-          rt_udf_gpu_module, *rt_module_copy, cgen_state_.get());
+      CodeGenerator::link_udf_module(rt_udf_gpu_module,
+                                     *rt_module_copy,
+                                     cgen_state_.get(),
+                                     llvm::Linker::Flags::None,
+                                     &used_function_names);
     }
   }
 
@@ -2115,7 +2773,11 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
                                                  gpu_smem_context);
   bind_pos_placeholders("pos_start", true, query_func, cgen_state_->module_);
   bind_pos_placeholders("group_buff_idx", false, query_func, cgen_state_->module_);
-  bind_pos_placeholders("pos_step", false, query_func, cgen_state_->module_);
+  if (co.device_type == ExecutorDeviceType::CPU && g_enable_cpu_loop_vectorization) {
+    bind_cpu_pos_step(query_func);
+  } else {
+    bind_pos_placeholders("pos_step", false, query_func, cgen_state_->module_);
+  }
 
   cgen_state_->query_func_ = query_func;
   cgen_state_->query_func_entry_ir_builder_.SetInsertPoint(
@@ -2191,7 +2853,7 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
         args.push_back(filter_call.getArgOperand(i));
       }
       args.insert(args.end(), col_heads.begin(), col_heads.end());
-      args.push_back(get_arg_by_name(query_func, "join_hash_tables"));
+      args.push_back(codegenJoinHashTablesArg(query_func, co, gpu_smem_context));
       // push hoisted literals arguments, if any
       args.insert(args.end(), hoisted_literals.begin(), hoisted_literals.end());
 
@@ -2213,13 +2875,16 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
    */
   if (gpu_smem_context.isSharedMemoryUsed()) {
     if (query_mem_desc->getQueryDescriptionType() ==
-        QueryDescriptionType::GroupByPerfectHash) {
+            QueryDescriptionType::GroupByPerfectHash ||
+        query_mem_desc->getQueryDescriptionType() ==
+            QueryDescriptionType::GroupByBaselineHash) {
       GpuSharedMemCodeBuilder gpu_smem_code(
           cgen_state_->module_,
           cgen_state_->context_,
           *query_mem_desc,
           target_exprs_to_infos(ra_exe_unit.target_exprs, *query_mem_desc),
-          plan_state_->init_agg_vals_);
+          plan_state_->init_agg_vals_,
+          gpu_smem_context.getSharedMemorySize() / query_mem_desc->getRowSize());
       gpu_smem_code.codegen();
       gpu_smem_code.injectFunctionsInto(query_func);
 
@@ -2260,7 +2925,13 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       // Note that we don't run the NVVM reflect pass here. Use LOG(IR) to get the
       // optimized IR after NVVM reflect
       llvm::legacy::PassManager pass_manager;
-      optimize_ir(query_func, cgen_state_->module_, pass_manager, live_funcs, co);
+      const auto vectorizer_target_machine = create_vectorizer_target_machine(co);
+      optimize_ir(query_func,
+                  cgen_state_->module_,
+                  pass_manager,
+                  live_funcs,
+                  co,
+                  vectorizer_target_machine.get());
 #endif  // WITH_JIT_DEBUG
     }
     llvm_ir =
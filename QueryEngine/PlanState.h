@@ -36,6 +36,9 @@ struct JoinInfo {
                                // fold them to true during code generation
   std::vector<std::shared_ptr<JoinHashTableInterface>> join_hash_tables_;
   std::unordered_set<size_t> sharded_range_table_indices_;
+  // sharded inner tables of which a device can hold several fragments, the kernels fetch
+  // them all as one column
+  std::unordered_set<size_t> partitioned_table_indices_;
 };
 
 struct PlanState {
@@ -53,6 +56,8 @@ struct PlanState {
   std::set<std::pair<TableId, ColumnId>> columns_to_fetch_;
   std::set<std::pair<TableId, ColumnId>> columns_to_not_fetch_;
   bool allow_lazy_fetch_;
+  // cleared for UNION ALL, whose inputs share the generated code
+  bool allow_diff_decode_in_codegen_{true};
   JoinInfo join_info_;
   const Executor* executor_;
 
@@ -63,6 +68,15 @@ struct PlanState {
 
   bool isLazyFetchColumn(const Analyzer::Expr* target_expr);
 
+  /**
+   * Whether the generated code reads the chunks of the DIFF encoded columns of the input
+   * at nest_level, which is the case for the outer table only. The columns of the other
+   * inputs are decoded when fetched and look like their logical type.
+   */
+  bool isDiffDecodedInCodegen(const int nest_level) const {
+    return allow_diff_decode_in_codegen_ && nest_level == 0;
+  }
+
   bool isLazyFetchColumn(const InputColDescriptor& col_desc) {
     Analyzer::ColumnVar column(SQLTypeInfo(),
                                col_desc.getScanDesc().getTableId(),
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PredictiveWatchdog.h"
+
+#include "Logger/Logger.h"
+#include "QueryEngine/Execute.h"
+
+bool g_enable_predictive_watchdog{false};
+
+extern unsigned g_dynamic_watchdog_time_limit;
+
+PredictiveWatchdog& PredictiveWatchdog::instance() {
+  static PredictiveWatchdog predictive_watchdog;
+  return predictive_watchdog;
+}
+
+void PredictiveWatchdog::recordStep(const ExecutorDeviceType device_type,
+                                    const size_t input_bytes,
+                                    const double seconds) {
+  if (input_bytes < kMinRecordedBytes || seconds <= 0) {
+    // the fixed costs of the step dominate, it says little about the scan rate
+    return;
+  }
+  const double bytes_per_sec = input_bytes / seconds;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& scan_rate = getScanRate(device_type);
+  scan_rate.bytes_per_sec =
+      scan_rate.step_count ? kRateSmoothing * bytes_per_sec +
+                                 (1 - kRateSmoothing) * scan_rate.bytes_per_sec
+                           : bytes_per_sec;
+  ++scan_rate.step_count;
+  VLOG(1) << "Scan rate on " << (device_type == ExecutorDeviceType::GPU ? "GPU" : "CPU")
+          << " at " << scan_rate.bytes_per_sec / 1e9
+          << " GB/s after a step of " << input_bytes << " bytes in " << seconds * 1e3
+          << " ms";
+}
+
+std::optional<double> PredictiveWatchdog::estimateSeconds(
+    const ExecutorDeviceType device_type,
+    const size_t input_bytes) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& scan_rate = getScanRate(device_type);
+  if (scan_rate.step_count < kMinRecordedSteps || scan_rate.bytes_per_sec <= 0) {
+    return std::nullopt;
+  }
+  return input_bytes / scan_rate.bytes_per_sec;
+}
+
+ExecutorDeviceType PredictiveWatchdog::checkStep(
+    const DeviceCostModel::InputBytes& input_bytes,
+    const ExecutorDeviceType device_type,
+    const size_t gpu_buffer_pool_bytes) const {
+  const double time_limit_sec = g_dynamic_watchdog_time_limit / 1e3;
+  const auto seconds = estimateSeconds(device_type, input_bytes.total);
+  const bool over_time_limit = seconds && *seconds > time_limit_sec;
+  if (device_type == ExecutorDeviceType::GPU) {
+    const bool over_buffer_pool =
+        input_bytes.total - input_bytes.gpu_resident > gpu_buffer_pool_bytes;
+    if (!over_time_limit && !over_buffer_pool) {
+      return device_type;
+    }
+    const auto cpu_seconds =
+        estimateSeconds(ExecutorDeviceType::CPU, input_bytes.total);
+    if (!cpu_seconds || *cpu_seconds <= time_limit_sec) {
+      VLOG(1) << "Run the step of " << input_bytes.total << " input bytes on CPU, "
+              << (over_buffer_pool ? "it doesn't fit in the GPU buffer pool"
+                                   : "it is estimated over the time limit on GPU");
+      return ExecutorDeviceType::CPU;
+    }
+    if (!over_time_limit) {
+      // a GPU step which doesn't fit is left to the retry on CPU, it'd be too slow there
+      return device_type;
+    }
+  } else if (!over_time_limit) {
+    return device_type;
+  }
+  CHECK(seconds);
+  throw WatchdogException("Query is estimated to run for " +
+                          std::to_string(static_cast<int64_t>(*seconds * 1e3)) +
+                          " ms, over the watchdog time limit of " +
+                          std::to_string(g_dynamic_watchdog_time_limit) + " ms");
+}
+
+void PredictiveWatchdog::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cpu_scan_rate_ = {};
+  gpu_scan_rate_ = {};
+}
+
+PredictiveWatchdog::ScanRate& PredictiveWatchdog::getScanRate(
+    const ExecutorDeviceType device_type) {
+  return device_type == ExecutorDeviceType::GPU ? gpu_scan_rate_ : cpu_scan_rate_;
+}
+
+const PredictiveWatchdog::ScanRate& PredictiveWatchdog::getScanRate(
+    const ExecutorDeviceType device_type) const {
+  return device_type == ExecutorDeviceType::GPU ? gpu_scan_rate_ : cpu_scan_rate_;
+}
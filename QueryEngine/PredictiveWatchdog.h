@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PredictiveWatchdog.h
+ * @brief   Watchdog of the steps estimated to run over the time limit before they run
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/DeviceCostModel.h"
+
+extern bool g_enable_predictive_watchdog;
+
+/**
+ * Estimates the time of a step from the bytes of its input columns, known from the
+ * metadata of their fragments, and the scan rates measured on the steps which ran before
+ * it on the same device type. A GPU step estimated over g_dynamic_watchdog_time_limit, or
+ * whose input wouldn't fit in the GPU buffer pool, runs on CPU instead unless it is
+ * estimated over the limit there too; any other step estimated over the limit is rejected
+ * before it fetches a single chunk, rather than interrupted by the dynamic watchdog once
+ * it has spent the time and evicted the chunks of the other queries from the GPUs.
+ *
+ * The rates are exponential moving averages of the steps of at least kMinRecordedBytes,
+ * no step is estimated before kMinRecordedSteps of them ran on its device type.
+ */
+class PredictiveWatchdog {
+ public:
+  static constexpr size_t kMinRecordedBytes{size_t(1) << 20};  // 1MB
+  static constexpr size_t kMinRecordedSteps{3};
+  static constexpr double kRateSmoothing{0.25};  // weight of the latest step
+
+  struct ScanRate {
+    double bytes_per_sec{0};
+    size_t step_count{0};
+  };
+
+  static PredictiveWatchdog& instance();
+
+  //! Adds a step which scanned input_bytes in seconds on device_type to its scan rate
+  void recordStep(const ExecutorDeviceType device_type,
+                  const size_t input_bytes,
+                  const double seconds);
+
+  //! The time of a step scanning input_bytes on device_type, once its rate is known
+  std::optional<double> estimateSeconds(const ExecutorDeviceType device_type,
+                                        const size_t input_bytes) const;
+
+  //! The device to run a step of input_bytes on, device_type unless it is a GPU the step
+  //! doesn't fit in; throws a WatchdogException for a step estimated over the limit
+  ExecutorDeviceType checkStep(const DeviceCostModel::InputBytes& input_bytes,
+                               const ExecutorDeviceType device_type,
+                               const size_t gpu_buffer_pool_bytes) const;
+
+  //! Forgets the measured rates
+  void reset();
+
+ private:
+  ScanRate& getScanRate(const ExecutorDeviceType device_type);
+  const ScanRate& getScanRate(const ExecutorDeviceType device_type) const;
+
+  mutable std::mutex mutex_;
+  ScanRate cpu_scan_rate_;
+  ScanRate gpu_scan_rate_;
+};
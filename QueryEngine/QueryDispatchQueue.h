@@ -18,13 +18,15 @@
 
 #include <condition_variable>
 #include <future>
+#include <map>
 #include <mutex>
-#include <queue>
 #include <thread>
 
+#include "QueryEngine/QueryPriority.h"
+
 /**
  * QueryDispatchQueue maintains a list of pending queries and dispatches those queries as
- * Executors become available
+ * Executors become available, in the weighted fair order of their priority classes
  */
 class QueryDispatchQueue {
  public:
@@ -43,11 +45,12 @@ class QueryDispatchQueue {
    * expected to maintain a copy of the shared_ptr which will be used to access results
    * once the task runs.
    */
-  void submit(std::shared_ptr<Task> task) {
+  void submit(std::shared_ptr<Task> task,
+              const QueryPriority priority = QueryPriority::NORMAL) {
     std::unique_lock<decltype(queue_mutex_)> lock(queue_mutex_);
 
     LOG(INFO) << "Dispatching query with " << queue_.size() << " queries in the queue.";
-    queue_.push(task);
+    queue_.emplace(fair_clock_.nextTag(priority, 1), task);
     lock.unlock();
     cv_.notify_all();
   }
@@ -74,8 +77,9 @@ class QueryDispatchQueue {
       }
 
       if (!queue_.empty()) {
-        auto task = queue_.front();
-        queue_.pop();
+        auto task = queue_.begin()->second;
+        fair_clock_.serve(queue_.begin()->first);
+        queue_.erase(queue_.begin());
 
         LOG(INFO) << "Running query and returning control. There are now "
                   << queue_.size() << " queries in the queue.";
@@ -94,6 +98,7 @@ class QueryDispatchQueue {
   std::condition_variable cv_;
 
   bool threads_should_exit_{false};
-  std::queue<std::shared_ptr<Task>> queue_;
+  WeightedFairClock fair_clock_;
+  std::map<WeightedFairClock::Tag, std::shared_ptr<Task>> queue_;
   std::vector<std::thread> workers_;
 };
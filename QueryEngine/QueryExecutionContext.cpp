@@ -50,6 +50,10 @@ QueryExecutionContext::QueryExecutionContext(
   auto& data_mgr = executor->catalog_->getDataMgr();
   if (device_type == ExecutorDeviceType::GPU) {
     gpu_allocator_ = std::make_unique<CudaAllocator>(&data_mgr, device_id);
+    if (row_set_mem_owner) {
+      gpu_allocator_->setUsageTracker(row_set_mem_owner->getGpuMemoryUsageTracker(),
+                                      DeviceMemoryCategory::OutputBuffers);
+    }
   }
 
   auto render_allocator_map = render_info && render_info->isPotentialInSituRender()
@@ -211,6 +215,15 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
   CHECK(cu_functions);
   const auto native_code = cu_functions->getNativeCode(device_id);
   auto cu_func = static_cast<CUfunction>(native_code.first);
+  // A kernel on a stream of its own doesn't wait for the copies and the memsets of its
+  // inputs on the default stream, nor do the copies of its results wait for it, so the
+  // stream is synchronized with both sides of the launch. The buffers of the kernel go
+  // back to the buffer pool after that, when nothing on the stream uses them anymore.
+  CUstream stream{nullptr};
+  if (gpu_stream_idx_) {
+    CHECK(data_mgr->getCudaMgr());
+    stream = data_mgr->getCudaMgr()->getStream(device_id, gpu_stream_idx_);
+  }
   std::vector<int64_t*> out_vec;
   uint32_t num_fragments = col_buffers.size();
   std::vector<int32_t> error_codes(grid_size_x * block_size_x);
@@ -302,6 +315,9 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
       cuEventRecord(start1, 0);
     }
 
+    if (stream) {
+      checkCudaErrors(cuStreamSynchronize(nullptr));
+    }
     if (hoist_literals) {
       checkCudaErrors(cuLaunchKernel(cu_func,
                                      grid_size_x,
@@ -311,7 +327,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
                                      block_size_y,
                                      block_size_z,
                                      shared_memory_size,
-                                     nullptr,
+                                     stream,
                                      &param_ptrs[0],
                                      nullptr));
     } else {
@@ -324,10 +340,13 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
                                      block_size_y,
                                      block_size_z,
                                      shared_memory_size,
-                                     nullptr,
+                                     stream,
                                      &param_ptrs[0],
                                      nullptr));
     }
+    if (stream) {
+      checkCudaErrors(cuStreamSynchronize(stream));
+    }
     if (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) {
       executor_->registerActiveModule(native_code.second, device_id);
       cuEventRecord(stop1, 0);
@@ -472,6 +491,9 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
       cuEventRecord(start1, 0);
     }
 
+    if (stream) {
+      checkCudaErrors(cuStreamSynchronize(nullptr));
+    }
     if (hoist_literals) {
       checkCudaErrors(cuLaunchKernel(cu_func,
                                      grid_size_x,
@@ -481,7 +503,7 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
                                      block_size_y,
                                      block_size_z,
                                      shared_memory_size,
-                                     nullptr,
+                                     stream,
                                      &param_ptrs[0],
                                      nullptr));
     } else {
@@ -494,10 +516,13 @@ std::vector<int64_t*> QueryExecutionContext::launchGpuCode(
                                      block_size_y,
                                      block_size_z,
                                      shared_memory_size,
-                                     nullptr,
+                                     stream,
                                      &param_ptrs[0],
                                      nullptr));
     }
+    if (stream) {
+      checkCudaErrors(cuStreamSynchronize(stream));
+    }
 
     if (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) {
       executor_->registerActiveModule(native_code.second, device_id);
@@ -614,9 +639,9 @@ std::vector<int64_t*> QueryExecutionContext::launchCpuCode(
     flatened_frag_offsets.insert(
         flatened_frag_offsets.end(), offsets.begin(), offsets.end());
   }
-  int64_t rowid_lookup_num_rows{*error_code ? *error_code + 1 : 0};
-  auto num_rows_ptr =
-      rowid_lookup_num_rows ? &rowid_lookup_num_rows : &flatened_num_rows[0];
+  // the caller narrows the outer row count for rowid lookups and sub-fragment kernels,
+  // error_code holds the row index to start scanning at
+  auto num_rows_ptr = &flatened_num_rows[0];
   int32_t total_matched_init{0};
 
   std::vector<int64_t> cmpt_val_buff;
@@ -91,6 +91,10 @@ class QueryExecutionContext : boost::noncopyable {
 
   int64_t getAggInitValForIndex(const size_t index) const;
 
+  //! The stream slot of the device the GPU kernels launch on, see
+  //! Executor::acquireGpuStream()
+  void setGpuStreamIdx(const size_t gpu_stream_idx) { gpu_stream_idx_ = gpu_stream_idx; }
+
  private:
 #ifdef HAVE_CUDA
   enum {
@@ -142,6 +146,7 @@ class QueryExecutionContext : boost::noncopyable {
   const bool output_columnar_;
   std::unique_ptr<QueryMemoryInitializer> query_buffers_;
   mutable std::unique_ptr<ResultSet> estimator_result_set_;
+  size_t gpu_stream_idx_{0};
 
   friend class Executor;
 };
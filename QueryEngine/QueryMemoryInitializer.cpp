@@ -22,12 +22,67 @@
 #include "Logger/Logger.h"
 #include "OutputBufferInitialization.h"
 #include "ResultSet.h"
+#include "Shared/Intervals.h"
+#include "Shared/thread_count.h"
 #include "StreamingTopN.h"
 
 #include <Shared/checked_alloc.h>
 
+#include <algorithm>
+#include <future>
+
 namespace {
 
+// the deferred bitmap size of the hash sets, the std::set ones are -1
+constexpr ssize_t kHashSetBitmapSize{-2};
+
+// the deferred quantile of the slots which are not APPROX_PERCENTILE t-digests
+constexpr double kNoTDigest{-1};
+
+// Below it, an output buffer or a column of one is initialized by the calling thread
+constexpr size_t kMinParallelInitBytes{size_t(1) << 24};
+
+// Runs fill(begin, end) over the intervals of [0, entry_count), in cpu_threads() threads
+// once the entries take kMinParallelInitBytes
+template <typename FILL>
+void parallel_init(const size_t entry_count, const size_t entry_bytes, FILL fill) {
+  if (entry_count * entry_bytes < kMinParallelInitBytes) {
+    fill(size_t(0), entry_count);
+    return;
+  }
+  std::vector<std::future<void>> init_threads;
+  for (const auto& interval : makeIntervals(size_t(0), entry_count, cpu_threads())) {
+    init_threads.push_back(
+        std::async(std::launch::async, fill, interval.begin, interval.end));
+  }
+  for (auto& init_thread : init_threads) {
+    init_thread.wait();
+  }
+  for (auto& init_thread : init_threads) {
+    init_thread.get();
+  }
+}
+
+// Copies the first of the row_count rows of buffer into the others, the runs of rows
+// copied doubling, so that most of the bytes are written by large memcpy calls
+void replicate_first_row(int8_t* buffer, const size_t row_size, const size_t row_count) {
+  parallel_init(row_count, row_size, [buffer, row_size](size_t begin, size_t end) {
+    if (begin == end) {
+      return;
+    }
+    auto rows_ptr = buffer + begin * row_size;
+    if (begin > 0) {
+      memcpy(rows_ptr, buffer, row_size);
+    }
+    const auto interval_row_count = end - begin;
+    for (size_t filled = 1; filled < interval_row_count;) {
+      const auto copied = std::min(filled, interval_row_count - filled);
+      memcpy(rows_ptr + filled * row_size, rows_ptr, copied * row_size);
+      filled += copied;
+    }
+  });
+}
+
 inline void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_desc) {
   const int32_t groups_buffer_entry_count = query_mem_desc.getEntryCount();
   if (g_enable_watchdog) {
@@ -191,6 +246,7 @@ QueryMemoryInitializer::QueryMemoryInitializer(
 
   if (render_allocator_map || !query_mem_desc.isGroupBy()) {
     allocateCountDistinctBuffers(query_mem_desc, false, executor);
+    allocateTDigests(query_mem_desc, false, executor);
     if (render_info && render_info->useCudaBuffers()) {
       return;
     }
@@ -409,14 +465,35 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
   const size_t col_base_off{query_mem_desc.getColOffInBytes(0)};
 
   auto agg_bitmap_size = allocateCountDistinctBuffers(query_mem_desc, true, executor);
+  const auto quantiles = allocateTDigests(query_mem_desc, true, executor);
   auto buffer_ptr = reinterpret_cast<int8_t*>(groups_buffer);
 
   const auto query_mem_desc_fixedup =
       ResultSet::fixupQueryMemoryDescriptor(query_mem_desc);
 
+  // without count distinct or approximate quantile slots, which get buffers of their own,
+  // all the rows start the same
+  const bool same_rows =
+      std::all_of(agg_bitmap_size.begin(),
+                  agg_bitmap_size.end(),
+                  [](const ssize_t bitmap_size) { return bitmap_size == 0; }) &&
+      std::all_of(quantiles.begin(), quantiles.end(), [](const double quantile) {
+        return quantile == kNoTDigest;
+      });
+
   if (query_mem_desc.hasKeylessHash()) {
     CHECK(warp_size >= 1);
     CHECK(key_count == 1 || warp_size == 1);
+    if (same_rows && groups_buffer_entry_count > 0) {
+      initColumnPerRow(query_mem_desc_fixedup,
+                       &buffer_ptr[col_base_off],
+                       0,
+                       init_vals,
+                       agg_bitmap_size,
+                       quantiles);
+      replicate_first_row(buffer_ptr, row_size, warp_size * groups_buffer_entry_count);
+      return;
+    }
     for (size_t warp_idx = 0; warp_idx < warp_size; ++warp_idx) {
       for (size_t bin = 0; bin < static_cast<size_t>(groups_buffer_entry_count);
            ++bin, buffer_ptr += row_size) {
@@ -424,12 +501,25 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                          &buffer_ptr[col_base_off],
                          bin,
                          init_vals,
-                         agg_bitmap_size);
+                         agg_bitmap_size,
+                         quantiles);
       }
     }
     return;
   }
 
+  if (same_rows && groups_buffer_entry_count > 0) {
+    fill_empty_key(buffer_ptr, key_count, query_mem_desc.getEffectiveKeyWidth());
+    initColumnPerRow(query_mem_desc_fixedup,
+                     &buffer_ptr[col_base_off],
+                     0,
+                     init_vals,
+                     agg_bitmap_size,
+                     quantiles);
+    replicate_first_row(buffer_ptr, row_size, groups_buffer_entry_count);
+    return;
+  }
+
   for (size_t bin = 0; bin < static_cast<size_t>(groups_buffer_entry_count);
        ++bin, buffer_ptr += row_size) {
     fill_empty_key(buffer_ptr, key_count, query_mem_desc.getEffectiveKeyWidth());
@@ -437,7 +527,8 @@ void QueryMemoryInitializer::initGroups(const QueryMemoryDescriptor& query_mem_d
                      &buffer_ptr[col_base_off],
                      bin,
                      init_vals,
-                     agg_bitmap_size);
+                     agg_bitmap_size,
+                     quantiles);
   }
 }
 
@@ -446,9 +537,9 @@ namespace {
 template <typename T>
 int8_t* initColumnarBuffer(T* buffer_ptr, const T init_val, const uint32_t entry_count) {
   static_assert(sizeof(T) <= sizeof(int64_t), "Unsupported template type");
-  for (uint32_t i = 0; i < entry_count; ++i) {
-    buffer_ptr[i] = init_val;
-  }
+  parallel_init(entry_count, sizeof(T), [buffer_ptr, init_val](size_t begin, size_t end) {
+    std::fill(buffer_ptr + begin, buffer_ptr + end, init_val);
+  });
   return reinterpret_cast<int8_t*>(buffer_ptr + entry_count);
 }
 
@@ -522,14 +613,21 @@ void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query
                                               int8_t* row_ptr,
                                               const size_t bin,
                                               const std::vector<int64_t>& init_vals,
-                                              const std::vector<ssize_t>& bitmap_sizes) {
+                                              const std::vector<ssize_t>& bitmap_sizes,
+                                              const std::vector<double>& quantiles) {
   int8_t* col_ptr = row_ptr;
   size_t init_vec_idx = 0;
   for (size_t col_idx = 0; col_idx < query_mem_desc.getSlotCount();
        col_ptr += query_mem_desc.getNextColOffInBytes(col_ptr, bin, col_idx++)) {
     const ssize_t bm_sz{bitmap_sizes[col_idx]};
     int64_t init_val{0};
-    if (!bm_sz || !query_mem_desc.isGroupBy()) {
+    if (query_mem_desc.isGroupBy() && quantiles[col_idx] != kNoTDigest) {
+      CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
+               sizeof(int64_t));
+      init_val = reinterpret_cast<int64_t>(
+          row_set_mem_owner_->newTDigest(quantiles[col_idx]));
+      ++init_vec_idx;
+    } else if (!bm_sz || !query_mem_desc.isGroupBy()) {
       if (query_mem_desc.getPaddedSlotWidthBytes(col_idx) > 0) {
         CHECK_LT(init_vec_idx, init_vals.size());
         init_val = init_vals[init_vec_idx++];
@@ -537,8 +635,13 @@ void QueryMemoryInitializer::initColumnPerRow(const QueryMemoryDescriptor& query
     } else {
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      if (bm_sz > 0) {
+        init_val = allocateCountDistinctBitmap(bm_sz);
+      } else {
+        init_val = allocateCountDistinctSet(bm_sz == kHashSetBitmapSize
+                                                ? CountDistinctImplType::HashSet
+                                                : CountDistinctImplType::StdSet);
+      }
       ++init_vec_idx;
     }
     switch (query_mem_desc.getPaddedSlotWidthBytes(col_idx)) {
@@ -627,11 +730,16 @@ std::vector<ssize_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
           init_agg_vals_[agg_col_idx] = allocateCountDistinctBitmap(bitmap_byte_sz);
         }
       } else {
-        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
+        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet ||
+              count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet);
         if (deferred) {
-          agg_bitmap_size[agg_col_idx] = -1;
+          agg_bitmap_size[agg_col_idx] =
+              count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet
+                  ? kHashSetBitmapSize
+                  : -1;
         } else {
-          init_agg_vals_[agg_col_idx] = allocateCountDistinctSet();
+          init_agg_vals_[agg_col_idx] =
+              allocateCountDistinctSet(count_distinct_desc.impl_type_);
         }
       }
     }
@@ -653,12 +761,49 @@ int64_t QueryMemoryInitializer::allocateCountDistinctBitmap(const size_t bitmap_
       row_set_mem_owner_->allocateCountDistinctBuffer(bitmap_byte_sz));
 }
 
-int64_t QueryMemoryInitializer::allocateCountDistinctSet() {
+int64_t QueryMemoryInitializer::allocateCountDistinctSet(
+    const CountDistinctImplType impl_type) {
+  if (impl_type == CountDistinctImplType::HashSet) {
+    auto count_distinct_hash_set = new CountDistinctHashSet();
+    row_set_mem_owner_->addCountDistinctHashSet(count_distinct_hash_set);
+    return reinterpret_cast<int64_t>(count_distinct_hash_set);
+  }
   auto count_distinct_set = new std::set<int64_t>();
   row_set_mem_owner_->addCountDistinctSet(count_distinct_set);
   return reinterpret_cast<int64_t>(count_distinct_set);
 }
 
+// deferred is true for group by queries; initGroups will allocate a t-digest for each
+// group slot of the returned quantiles
+std::vector<double> QueryMemoryInitializer::allocateTDigests(
+    const QueryMemoryDescriptor& query_mem_desc,
+    const bool deferred,
+    const Executor* executor) {
+  const size_t slot_count{query_mem_desc.getSlotCount()};
+  std::vector<double> quantiles(deferred ? slot_count : 0, kNoTDigest);
+
+  for (size_t target_idx = 0; target_idx < executor->plan_state_->target_exprs_.size();
+       ++target_idx) {
+    const auto agg_expr = dynamic_cast<const Analyzer::AggExpr*>(
+        executor->plan_state_->target_exprs_[target_idx]);
+    if (!agg_expr || agg_expr->get_aggtype() != kAPPROX_QUANTILE) {
+      continue;
+    }
+    const auto slot_idx = query_mem_desc.getSlotIndexForSingleSlotCol(target_idx);
+    CHECK_LT(static_cast<size_t>(slot_idx), slot_count);
+    CHECK(agg_expr->get_arg1());
+    const double q = agg_expr->get_arg1()->get_constval().doubleval;
+    if (deferred) {
+      quantiles[slot_idx] = q;
+    } else {
+      init_agg_vals_[slot_idx] =
+          reinterpret_cast<int64_t>(row_set_mem_owner_->newTDigest(q));
+    }
+  }
+
+  return quantiles;
+}
+
 #ifdef HAVE_CUDA
 GpuGroupByBuffers QueryMemoryInitializer::prepareTopNHeapsDevBuffer(
     const QueryMemoryDescriptor& query_mem_desc,
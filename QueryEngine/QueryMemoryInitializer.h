@@ -151,7 +151,8 @@ class QueryMemoryInitializer {
                         int8_t* row_ptr,
                         const size_t bin,
                         const std::vector<int64_t>& init_vals,
-                        const std::vector<ssize_t>& bitmap_sizes);
+                        const std::vector<ssize_t>& bitmap_sizes,
+                        const std::vector<double>& quantiles);
 
   void allocateCountDistinctGpuMem(const QueryMemoryDescriptor& query_mem_desc);
 
@@ -162,7 +163,11 @@ class QueryMemoryInitializer {
 
   int64_t allocateCountDistinctBitmap(const size_t bitmap_byte_sz);
 
-  int64_t allocateCountDistinctSet();
+  int64_t allocateCountDistinctSet(const CountDistinctImplType impl_type);
+
+  std::vector<double> allocateTDigests(const QueryMemoryDescriptor& query_mem_desc,
+                                       const bool deferred,
+                                       const Executor* executor);
 
 #ifdef HAVE_CUDA
   GpuGroupByBuffers prepareTopNHeapsDevBuffer(const QueryMemoryDescriptor& query_mem_desc,
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+ * The priority classes of the queries. The dispatch queue and the executor resource pool
+ * serve the classes with weighted fair queuing, so the queries of a class get their share
+ * of the executors and of the kernel resources however many queries the other classes
+ * have waiting.
+ */
+enum class QueryPriority : size_t { HIGH = 0, NORMAL, LOW };
+
+constexpr size_t kQueryPriorityCount{3};
+
+// the relative shares of the priority classes when all of them have queries waiting
+constexpr std::array<double, kQueryPriorityCount> kQueryPriorityWeights{{8.0, 4.0, 1.0}};
+
+//! The priority class of the queries of user_name, given by the high-priority-users and
+//! low-priority-users options.
+QueryPriority get_query_priority(const std::string& user_name);
+
+/**
+ * The virtual finish times of the weighted fair queuing of the priority classes: a
+ * request of class c finishes cost / weight(c) after the later of the current virtual
+ * time and the finish of the previous request of c. Serving the requests in the order
+ * of their finish times gives each class its weighted share, and a class which was idle
+ * doesn't get a burst of credit when it comes back.
+ */
+class WeightedFairClock {
+ public:
+  // the sequence number breaks the ties between the equal finish times in arrival order
+  using Tag = std::pair<double, uint64_t>;
+
+  Tag nextTag(const QueryPriority priority, const double cost) {
+    const auto priority_idx = static_cast<size_t>(priority);
+    const auto finish_time = std::max(virtual_time_, last_finish_times_[priority_idx]) +
+                             std::max(cost, 1.0) / kQueryPriorityWeights[priority_idx];
+    last_finish_times_[priority_idx] = finish_time;
+    return {finish_time, next_sequence_number_++};
+  }
+
+  // advances the virtual time to the tag of a request which starts being served
+  void serve(const Tag& tag) { virtual_time_ = std::max(virtual_time_, tag.first); }
+
+ private:
+  double virtual_time_{0};
+  std::array<double, kQueryPriorityCount> last_finish_times_{};
+  uint64_t next_sequence_number_{0};
+};
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/QueryProfile.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "Logger/Logger.h"
+
+namespace {
+
+rapidjson::Value kernel_to_json(const QueryProfile::KernelProfile& kernel,
+                                rapidjson::Document::AllocatorType& alloc) {
+  rapidjson::Value json(rapidjson::kObjectType);
+  json.AddMember(
+      "device_type", rapidjson::Value(kernel.device_type.c_str(), alloc), alloc);
+  json.AddMember("device_id", kernel.device_id, alloc);
+  rapidjson::Value fragment_ids(rapidjson::kArrayType);
+  for (const auto fragment_id : kernel.fragment_ids) {
+    fragment_ids.PushBack(static_cast<uint64_t>(fragment_id), alloc);
+  }
+  json.AddMember("fragment_ids", fragment_ids, alloc);
+  json.AddMember("fetch_ms", kernel.fetch_ms, alloc);
+  json.AddMember("execution_ms", kernel.execution_ms, alloc);
+  json.AddMember("rows_in", kernel.rows_in, alloc);
+  json.AddMember("rows_out", static_cast<uint64_t>(kernel.rows_out), alloc);
+  json.AddMember(
+      "cpu_bytes_fetched", static_cast<uint64_t>(kernel.cpu_bytes_fetched), alloc);
+  json.AddMember(
+      "gpu_bytes_fetched", static_cast<uint64_t>(kernel.gpu_bytes_fetched), alloc);
+  return json;
+}
+
+rapidjson::Value step_to_json(const QueryProfile::StepProfile& step,
+                              rapidjson::Document::AllocatorType& alloc) {
+  rapidjson::Value json(rapidjson::kObjectType);
+  json.AddMember("step", static_cast<uint64_t>(step.step_idx), alloc);
+  json.AddMember("id", step.node_id, alloc);
+  json.AddMember("node", rapidjson::Value(step.node.c_str(), alloc), alloc);
+  rapidjson::Value input_ids(rapidjson::kArrayType);
+  for (const auto input_id : step.input_ids) {
+    input_ids.PushBack(input_id, alloc);
+  }
+  json.AddMember("inputs", input_ids, alloc);
+  json.AddMember("total_ms", step.total_ms, alloc);
+  json.AddMember("compilation_ms", step.compilation_ms, alloc);
+  json.AddMember("kernels_ms", step.kernels_ms, alloc);
+  json.AddMember("reduction_ms", step.reduction_ms, alloc);
+  json.AddMember("rows_out", static_cast<uint64_t>(step.rows_out), alloc);
+  json.AddMember("fragment_result_cache_hits",
+                 static_cast<uint64_t>(step.fragment_result_cache_hits),
+                 alloc);
+  json.AddMember(
+      "chunk_metadata_counts", static_cast<uint64_t>(step.chunk_metadata_counts), alloc);
+  rapidjson::Value kernels(rapidjson::kArrayType);
+  for (const auto& kernel : step.kernels) {
+    kernels.PushBack(kernel_to_json(kernel, alloc), alloc);
+  }
+  json.AddMember("kernels", kernels, alloc);
+  return json;
+}
+
+}  // namespace
+
+size_t QueryProfile::beginStep(const size_t step_idx,
+                               const unsigned node_id,
+                               const std::string& node,
+                               const std::vector<unsigned>& input_ids) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  StepProfile step;
+  step.step_idx = step_idx;
+  step.node_id = node_id;
+  step.node = node;
+  step.input_ids = input_ids;
+  steps_.push_back(std::move(step));
+  return steps_.size() - 1;
+}
+
+void QueryProfile::endStep(const size_t idx,
+                           const int64_t total_ms,
+                           const size_t rows_out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK_LT(idx, steps_.size());
+  steps_[idx].total_ms = total_ms;
+  steps_[idx].rows_out = rows_out;
+}
+
+void QueryProfile::addWorkUnitTimes(const int64_t compilation_ms,
+                                    const int64_t kernels_ms,
+                                    const int64_t reduction_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // the work units which run outside of a step have no step to go to
+  if (steps_.empty()) {
+    return;
+  }
+  steps_.back().compilation_ms += compilation_ms;
+  steps_.back().kernels_ms += kernels_ms;
+  steps_.back().reduction_ms += reduction_ms;
+}
+
+void QueryProfile::addKernel(KernelProfile&& kernel) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (steps_.empty()) {
+    return;
+  }
+  steps_.back().kernels.push_back(std::move(kernel));
+}
+
+void QueryProfile::addFragmentResultCacheHit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (steps_.empty()) {
+    return;
+  }
+  ++steps_.back().fragment_result_cache_hits;
+}
+
+void QueryProfile::addChunkMetadataCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (steps_.empty()) {
+    return;
+  }
+  ++steps_.back().chunk_metadata_counts;
+}
+
+void QueryProfile::setResultSetCacheHit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  result_set_cache_hit_ = true;
+}
+
+void QueryProfile::setTotalTime(const int64_t total_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_ms_ = total_ms;
+}
+
+std::vector<QueryProfile::StepProfile> QueryProfile::getSteps() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return steps_;
+}
+
+std::string QueryProfile::toJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  rapidjson::Document doc(rapidjson::kObjectType);
+  auto& alloc = doc.GetAllocator();
+  doc.AddMember("total_ms", total_ms_, alloc);
+  doc.AddMember("result_set_cache_hit", result_set_cache_hit_, alloc);
+  rapidjson::Value steps(rapidjson::kArrayType);
+  for (const auto& step : steps_) {
+    steps.PushBack(step_to_json(step, alloc), alloc);
+  }
+  doc.AddMember("steps", steps, alloc);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return {buffer.GetString(), buffer.GetSize()};
+}
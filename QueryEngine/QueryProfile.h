@@ -0,0 +1,100 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    QueryProfile.h
+ * @brief   Where the time of a query went, by step and by kernel, for EXPLAIN ANALYZE
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Collects, while a query runs, the times, row counts, fetched bytes and cache hits of
+ * its steps and of the kernels of each of them. The steps are the nodes of the RA plan
+ * the query runs one after the other, each one with the ids of its inputs, so that the
+ * JSON of the profile is the tree of the plan. The kernels run in parallel, the records
+ * are taken under a lock, once per kernel and per work unit.
+ */
+class QueryProfile {
+ public:
+  struct KernelProfile {
+    std::string device_type;
+    int device_id{0};
+    std::vector<size_t> fragment_ids;
+    int64_t fetch_ms{0};
+    int64_t execution_ms{0};
+    int64_t rows_in{0};
+    size_t rows_out{0};
+    size_t cpu_bytes_fetched{0};
+    size_t gpu_bytes_fetched{0};
+  };
+
+  struct StepProfile {
+    size_t step_idx{0};
+    unsigned node_id{0};
+    std::string node;
+    std::vector<unsigned> input_ids;
+    int64_t total_ms{0};
+    int64_t compilation_ms{0};
+    int64_t kernels_ms{0};
+    int64_t reduction_ms{0};
+    size_t rows_out{0};
+    size_t fragment_result_cache_hits{0};
+    size_t chunk_metadata_counts{0};
+    std::vector<KernelProfile> kernels;
+  };
+
+  //! Starts the current step, returns its index for endStep
+  size_t beginStep(const size_t step_idx,
+                   const unsigned node_id,
+                   const std::string& node,
+                   const std::vector<unsigned>& input_ids);
+
+  void endStep(const size_t idx, const int64_t total_ms, const size_t rows_out);
+
+  //! The compilation, kernels and reduction times of a work unit of the current step
+  void addWorkUnitTimes(const int64_t compilation_ms,
+                        const int64_t kernels_ms,
+                        const int64_t reduction_ms);
+
+  void addKernel(KernelProfile&& kernel);
+
+  //! A fragment of the current step whose result came from the fragment result cache
+  void addFragmentResultCacheHit();
+
+  //! A fragment of the current step whose COUNTs came from its chunk metadata
+  void addChunkMetadataCount();
+
+  void setResultSetCacheHit();
+
+  void setTotalTime(const int64_t total_ms);
+
+  std::vector<StepProfile> getSteps() const;
+
+  std::string toJson() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<StepProfile> steps_;
+  bool result_set_cache_hit_{false};
+  int64_t total_ms_{0};
+};
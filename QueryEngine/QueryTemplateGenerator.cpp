@@ -806,10 +806,11 @@ llvm::Function* query_group_by_template_impl(
   BranchInst::Create(bb_exit, bb_crit_edge);
 
   // Block .exit
-  CallInst::Create(func_write_back,
-                   std::vector<Value*>{col_buffer, result_buffer, shared_mem_bytes_lv},
-                   "",
-                   bb_exit);
+  CallInst::Create(
+      func_write_back,
+      std::vector<Value*>{col_buffer, result_buffer, shared_mem_bytes_lv, error_code},
+      "",
+      bb_exit);
 
   ReturnInst::Create(mod->getContext(), bb_exit);
 
@@ -30,11 +30,16 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <algorithm>
+#include <list>
+#include <optional>
 #include <string>
 #include <unordered_set>
 
 extern bool g_cluster;
 extern bool g_enable_union;
+extern bool g_enable_result_set_cache;
+extern bool g_enable_semi_join;
 
 namespace {
 
@@ -58,7 +63,7 @@ void RexSubQuery::setExecutionResult(
 }
 
 std::unique_ptr<RexSubQuery> RexSubQuery::deepCopy() const {
-  return std::make_unique<RexSubQuery>(type_, result_, ra_->deepCopy());
+  return std::make_unique<RexSubQuery>(type_, result_, ra_->deepCopy(), plan_);
 }
 
 unsigned RexSubQuery::getId() const {
@@ -903,7 +908,9 @@ std::unique_ptr<const RexSubQuery> parse_subquery(const rapidjson::Value& expr,
   const auto& subquery_ast = field(expr, "subquery");
 
   RelAlgDagBuilder subquery_dag(root_dag_builder, subquery_ast, cat, nullptr);
-  auto subquery = std::make_shared<RexSubQuery>(subquery_dag.getRootNodeShPtr());
+  auto subquery = std::make_shared<RexSubQuery>(
+      subquery_dag.getRootNodeShPtr(),
+      g_enable_result_set_cache ? json_node_to_string(subquery_ast) : "");
   root_dag_builder.registerSubquery(subquery);
   return subquery->deepCopy();
 }
@@ -1006,7 +1013,9 @@ std::unique_ptr<const RexAgg> parse_aggregate_expr(const rapidjson::Value& expr)
   const auto distinct = json_bool(field(expr, "distinct"));
   const auto agg_ti = parse_type(field(expr, "type"));
   const auto operands = indices_from_json_array(field(expr, "operands"));
-  if (operands.size() > 1 && (operands.size() != 2 || agg != kAPPROX_COUNT_DISTINCT)) {
+  if (operands.size() > 1 &&
+      (operands.size() != 2 ||
+       (agg != kAPPROX_COUNT_DISTINCT && agg != kAPPROX_QUANTILE))) {
     throw QueryNotSupported("Multiple arguments for aggregates aren't supported");
   }
   return std::unique_ptr<const RexAgg>(new RexAgg(agg, distinct, agg_ti, operands));
@@ -1236,6 +1245,90 @@ void handleQueryHint(const std::vector<std::shared_ptr<RelAlgNode>>& nodes,
   dag_builder->registerQueryHints(query_hints);
 }
 
+std::unique_ptr<const RexScalar> rescale_sampled_agg(const RelAggregate* aggregate,
+                                                     const size_t agg_idx,
+                                                     const double sample_rate) {
+  const auto& agg_expr = aggregate->getAggExprs()[agg_idx];
+  auto input =
+      std::make_unique<RexInput>(aggregate, aggregate->getGroupByCount() + agg_idx);
+  const bool is_additive =
+      (agg_expr->getKind() == kCOUNT || agg_expr->getKind() == kSUM) &&
+      !agg_expr->isDistinct();
+  if (!is_additive) {
+    return input;
+  }
+  const auto& agg_ti = agg_expr->getType();
+  std::vector<std::unique_ptr<const RexScalar>> operands;
+  operands.emplace_back(std::move(input));
+  operands.emplace_back(
+      std::make_unique<RexLiteral>(1. / sample_rate, kDOUBLE, kDOUBLE, 0, 0, 0, 0));
+  std::unique_ptr<const RexScalar> rescaled = std::make_unique<RexOperator>(
+      kMULTIPLY, operands, SQLTypeInfo(kDOUBLE, agg_ti.get_notnull()));
+  if (agg_ti.get_type() == kDOUBLE) {
+    return rescaled;
+  }
+  std::vector<std::unique_ptr<const RexScalar>> cast_operands;
+  cast_operands.emplace_back(std::move(rescaled));
+  return std::make_unique<RexOperator>(kCAST, cast_operands, agg_ti);
+}
+
+// The COUNT and SUM aggregates over rows which went through TABLESAMPLE estimate those
+// of the whole tables: a projection after their aggregate divides them by the share of
+// the rows sampled, keeping their types. The shares of the sampled tables multiply
+// through the joins; the other aggregates are left alone.
+void rescale_sampled_aggregates(std::vector<std::shared_ptr<RelAlgNode>>& nodes) {
+  std::unordered_map<const RelAlgNode*, double> sample_rates;
+  std::list<std::shared_ptr<RelAlgNode>> node_list(nodes.begin(), nodes.end());
+  bool has_sample{false};
+  for (auto node_it = node_list.begin(); node_it != node_list.end(); ++node_it) {
+    const auto node = *node_it;
+    double sample_rate{1.};
+    if (const auto scan = std::dynamic_pointer_cast<const RelScan>(node)) {
+      sample_rate = scan->getSampleRate();
+    } else if (std::dynamic_pointer_cast<const RelLogicalUnion>(node)) {
+      sample_rate = sample_rates[node->getInput(0)];
+      for (size_t i = 1; i < node->inputCount(); ++i) {
+        if (sample_rates[node->getInput(i)] != sample_rate) {
+          throw QueryNotSupported("UNION of inputs sampled at different rates");
+        }
+      }
+    } else {
+      for (size_t i = 0; i < node->inputCount(); ++i) {
+        sample_rate *= sample_rates[node->getInput(i)];
+      }
+    }
+    has_sample |= sample_rate < 1.;
+    const auto aggregate = std::dynamic_pointer_cast<const RelAggregate>(node);
+    if (sample_rate == 1. || !aggregate) {
+      sample_rates[node.get()] = sample_rate;
+      continue;
+    }
+    sample_rates[node.get()] = 1.;
+    if (!aggregate->getAggExprsCount()) {
+      continue;
+    }
+    std::vector<std::unique_ptr<const RexScalar>> scalar_exprs;
+    for (size_t i = 0; i < aggregate->getGroupByCount(); ++i) {
+      scalar_exprs.emplace_back(std::make_unique<RexInput>(aggregate.get(), i));
+    }
+    for (size_t i = 0; i < aggregate->getAggExprsCount(); ++i) {
+      scalar_exprs.emplace_back(rescale_sampled_agg(aggregate.get(), i, sample_rate));
+    }
+    auto rescale_project =
+        std::make_shared<RelProject>(scalar_exprs, aggregate->getFields(), aggregate);
+    sample_rates[rescale_project.get()] = 1.;
+    for (auto user_it = std::next(node_it); user_it != node_list.end(); ++user_it) {
+      if ((*user_it)->hasInput(aggregate.get())) {
+        (*user_it)->replaceInput(aggregate, rescale_project);
+      }
+    }
+    node_it = node_list.insert(std::next(node_it), rescale_project);
+  }
+  if (has_sample) {
+    nodes.assign(node_list.begin(), node_list.end());
+  }
+}
+
 void mark_nops(const std::vector<std::shared_ptr<RelAlgNode>>& nodes) noexcept {
   for (auto node : nodes) {
     const auto agg_node = std::dynamic_pointer_cast<RelAggregate>(node);
@@ -2072,6 +2165,210 @@ void add_window_function_pre_project(std::vector<std::shared_ptr<RelAlgNode>>& n
   nodes.assign(node_list.begin(), node_list.end());
 }
 
+class RexSubQueryUseCounter : public RexVisitor<void*> {
+ public:
+  void* visitSubQuery(const RexSubQuery* subquery) const override {
+    ++uses_[subquery->getId()];
+    return nullptr;
+  }
+
+  void visitNode(const RelAlgNode* node) const {
+    if (auto filter = dynamic_cast<const RelFilter*>(node)) {
+      visit(filter->getCondition());
+    } else if (auto compound = dynamic_cast<const RelCompound*>(node)) {
+      if (compound->getFilterExpr()) {
+        visit(compound->getFilterExpr());
+      }
+      for (size_t i = 0; i < compound->getScalarSourcesSize(); ++i) {
+        visit(compound->getScalarSource(i));
+      }
+    } else if (auto project = dynamic_cast<const RelProject*>(node)) {
+      for (size_t i = 0; i < project->size(); ++i) {
+        visit(project->getProjectAt(i));
+      }
+    } else if (auto join = dynamic_cast<const RelJoin*>(node)) {
+      if (join->getCondition()) {
+        visit(join->getCondition());
+      }
+    }
+  }
+
+  size_t getUses(const RexSubQuery* subquery) const {
+    const auto it = uses_.find(subquery->getId());
+    return it == uses_.end() ? 0 : it->second;
+  }
+
+ private:
+  mutable std::unordered_map<unsigned, size_t> uses_;
+};
+
+// The type of the index-th output of node if it's a column of one of the scans under
+// the joins starting at node.
+std::optional<SQLTypeInfo> get_scan_column_type(const RelAlgNode* node,
+                                                size_t index,
+                                                const Catalog_Namespace::Catalog& cat) {
+  while (const auto join = dynamic_cast<const RelJoin*>(node)) {
+    const auto lhs_size = join->getInput(0)->size();
+    if (index < lhs_size) {
+      node = join->getInput(0);
+    } else {
+      node = join->getInput(1);
+      index -= lhs_size;
+    }
+  }
+  const auto scan = dynamic_cast<const RelScan*>(node);
+  if (!scan) {
+    return std::nullopt;
+  }
+  const auto cd = cat.getMetadataForColumn(scan->getTableDescriptor()->tableId,
+                                           scan->getFieldName(index));
+  if (!cd) {
+    return std::nullopt;
+  }
+  return cd->columnType;
+}
+
+// Whether conjunct is an 'input IN (subquery)' the node with the filter of the
+// conjunct can run as a semi join of its input and of the subquery.
+bool is_semi_join_candidate(const RexScalar* conjunct,
+                            const RelAlgNode* input,
+                            const RexSubQueryUseCounter& subquery_uses,
+                            const Catalog_Namespace::Catalog& cat) {
+  const auto in_oper = dynamic_cast<const RexOperator*>(conjunct);
+  if (!in_oper || in_oper->getOperator() != kIN || in_oper->size() != 2) {
+    return false;
+  }
+  const auto lhs = dynamic_cast<const RexInput*>(in_oper->getOperand(0));
+  const auto subquery = dynamic_cast<const RexSubQuery*>(in_oper->getOperand(1));
+  if (!lhs || lhs->getSourceNode() != input || !subquery ||
+      subquery->getRelAlg()->size() != 1 || subquery_uses.getUses(subquery) != 1) {
+    return false;
+  }
+  // The subquery results must have the type of the input for the IN as well, only the
+  // integers have hash joins whatever the encoding of the two sides.
+  const auto lhs_ti = get_scan_column_type(input, lhs->getIndex(), cat);
+  return lhs_ti && lhs_ti->is_integer();
+}
+
+/**
+ * Runs the 'input IN (subquery)' conjuncts of the filters as semi joins of the inputs of
+ * the filters and of the subqueries, which get executed as steps of the query instead of
+ * value lists for the IN operator. The executor builds a join hash table on the
+ * subquery results and the semi join level only looks for the first match of each row.
+ * Runs on the coalesced nodes, and puts the semi joins right under the filters: the
+ * filters with an inner join under them stay the start of a left-deep join pattern.
+ * Returns whether any conjunct was rewritten.
+ */
+bool create_semi_joins_for_in_subqueries(std::vector<std::shared_ptr<RelAlgNode>>& nodes,
+                                         const Catalog_Namespace::Catalog& cat) {
+  RexSubQueryUseCounter subquery_uses;
+  for (const auto& node : nodes) {
+    subquery_uses.visitNode(node.get());
+  }
+  // The updates and the deletes don't run over joins.
+  const auto is_modify = [](const RelAlgNode* node) {
+    const auto modify_target = dynamic_cast<const ModifyManipulationTarget*>(node);
+    return modify_target &&
+           (modify_target->isUpdateViaSelect() || modify_target->isDeleteViaSelect());
+  };
+  // The outputs of a filter over a semi join include the subquery column, which these
+  // nodes ignore since they pick the columns of their input.
+  const auto picks_input_columns = [](const RelAlgNode* node) {
+    return dynamic_cast<const RelCompound*>(node) ||
+           dynamic_cast<const RelProject*>(node) ||
+           dynamic_cast<const RelAggregate*>(node);
+  };
+  std::vector<std::shared_ptr<RelAlgNode>> new_nodes;
+  bool has_semi_joins{false};
+  for (auto& node : nodes) {
+    const auto filter = std::dynamic_pointer_cast<RelFilter>(node);
+    const auto compound = std::dynamic_pointer_cast<RelCompound>(node);
+    const RexScalar* condition{nullptr};
+    if (filter) {
+      condition = filter->getCondition();
+      for (const auto& user : nodes) {
+        if (user->hasInput(filter.get()) &&
+            (!picks_input_columns(user.get()) || is_modify(user.get()))) {
+          condition = nullptr;
+          break;
+        }
+      }
+    } else if (compound && !is_modify(compound.get())) {
+      condition = compound->getFilterExpr();
+    }
+    if (!condition) {
+      new_nodes.push_back(node);
+      continue;
+    }
+    const auto input = node->getAndOwnInput(0);
+    std::vector<const RexScalar*> conjuncts;
+    auto and_oper = dynamic_cast<const RexOperator*>(condition);
+    if (and_oper && and_oper->getOperator() != kAND) {
+      and_oper = nullptr;
+    }
+    if (and_oper) {
+      for (size_t i = 0; i < and_oper->size(); ++i) {
+        conjuncts.push_back(and_oper->getOperand(i));
+      }
+    } else {
+      conjuncts.push_back(condition);
+    }
+    if (std::none_of(conjuncts.begin(), conjuncts.end(), [&](const RexScalar* conjunct) {
+          return is_semi_join_candidate(conjunct, input.get(), subquery_uses, cat);
+        })) {
+      new_nodes.push_back(node);
+      continue;
+    }
+    std::shared_ptr<const RelAlgNode> semi_join_input = input;
+    std::vector<std::unique_ptr<const RexScalar>> rest_conjuncts;
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+      // the conjuncts of an AND move to the rest of the condition or go away
+      std::unique_ptr<const RexScalar> conjunct(
+          and_oper ? and_oper->getOperandAndRelease(i) : nullptr);
+      const auto conjunct_ptr = and_oper ? conjunct.get() : condition;
+      if (!is_semi_join_candidate(conjunct_ptr, input.get(), subquery_uses, cat)) {
+        CHECK(conjunct);
+        rest_conjuncts.emplace_back(std::move(conjunct));
+        continue;
+      }
+      const auto in_oper = static_cast<const RexOperator*>(conjunct_ptr);
+      const auto lhs = static_cast<const RexInput*>(in_oper->getOperand(0));
+      const auto subquery = static_cast<const RexSubQuery*>(in_oper->getOperand(1));
+      std::vector<std::unique_ptr<const RexScalar>> eq_operands;
+      eq_operands.emplace_back(
+          std::make_unique<RexInput>(semi_join_input.get(), lhs->getIndex()));
+      eq_operands.emplace_back(std::make_unique<RexInput>(subquery->getRelAlg(), 0));
+      std::unique_ptr<const RexScalar> semi_join_condition(
+          new RexOperator(kEQ, eq_operands, SQLTypeInfo(kBOOLEAN, false)));
+      auto semi_join = std::make_shared<RelJoin>(semi_join_input,
+                                                 subquery->getRelAlgShPtr(),
+                                                 semi_join_condition,
+                                                 JoinType::SEMI);
+      new_nodes.push_back(semi_join);
+      semi_join_input = semi_join;
+    }
+    std::unique_ptr<const RexScalar> rest_condition;
+    if (rest_conjuncts.size() > 1) {
+      rest_condition.reset(new RexOperator(kAND, rest_conjuncts, and_oper->getType()));
+    } else if (!rest_conjuncts.empty()) {
+      rest_condition = std::move(rest_conjuncts.front());
+    }
+    if (filter) {
+      if (!rest_condition) {
+        rest_condition.reset(new RexLiteral(true, kBOOLEAN, kBOOLEAN, 0, 0, 0, 0));
+      }
+      filter->setCondition(rest_condition);
+    } else {
+      compound->setFilterExpr(rest_condition);
+    }
+    node->replaceInput(input, semi_join_input);
+    new_nodes.push_back(node);
+    has_semi_joins = true;
+  }
+  nodes.swap(new_nodes);
+  return has_semi_joins;
+}
+
 int64_t get_int_literal_field(const rapidjson::Value& obj,
                               const char field[],
                               const int64_t default_val) noexcept {
@@ -2152,6 +2449,8 @@ class RelAlgDispatcher {
         ra_node = dispatchTableFunction(crt_node, root_dag_builder);
       } else if (rel_op == std::string("LogicalUnion")) {
         ra_node = dispatchUnion(crt_node);
+      } else if (rel_op == std::string("Sample")) {
+        ra_node = dispatchSample(crt_node);
       } else {
         throw QueryNotSupported(std::string("Node ") + rel_op + " not supported yet");
       }
@@ -2440,6 +2739,50 @@ class RelAlgDispatcher {
     return std::make_shared<RelLogicalUnion>(std::move(inputs), all_type_bool.GetBool());
   }
 
+  // TABLESAMPLE, on a table only. A BERNOULLI sample becomes a SAMPLE_RATIO filter of the
+  // scan, a SYSTEM sample an identity projection of it and a FragmentSample the kernels
+  // dispatch skips the other fragments by. Either way the scan keeps the rate, for
+  // rescale_sampled_aggregates().
+  std::shared_ptr<RelAlgNode> dispatchSample(const rapidjson::Value& sample_ra) {
+    const auto inputs = getRelAlgInputs(sample_ra);
+    CHECK_EQ(size_t(1), inputs.size());
+    auto scan = std::const_pointer_cast<RelScan>(
+        std::dynamic_pointer_cast<const RelScan>(inputs.front()));
+    if (!scan) {
+      throw QueryNotSupported("TABLESAMPLE is only supported on tables");
+    }
+    const auto& rate_json = field(sample_ra, "rate");
+    CHECK(rate_json.IsNumber());
+    const auto rate = rate_json.GetDouble();
+    if (rate <= 0 || rate > 1) {
+      throw QueryNotSupported("TABLESAMPLE percentage must be in (0, 100]");
+    }
+    const bool bernoulli = json_str(field(sample_ra, "mode")) == "bernoulli";
+    int64_t seed{0};
+    if (sample_ra.HasMember("repeatableSeed")) {
+      const auto& seed_json = field(sample_ra, "repeatableSeed");
+      if (seed_json.IsInt64()) {
+        seed = json_i64(seed_json);
+      }
+    }
+    scan->setSample(bernoulli, rate, seed);
+    if (bernoulli) {
+      std::vector<std::unique_ptr<const RexScalar>> sample_ratio_args;
+      sample_ratio_args.emplace_back(
+          std::make_unique<RexLiteral>(rate, kDOUBLE, kDOUBLE, 0, 0, 0, 0));
+      std::unique_ptr<const RexScalar> condition =
+          std::make_unique<RexFunctionOperator>("SAMPLE_RATIO",
+                                                sample_ratio_args,
+                                                SQLTypeInfo(kBOOLEAN, false));
+      return std::make_shared<RelFilter>(condition, scan);
+    }
+    std::vector<std::unique_ptr<const RexScalar>> exprs;
+    for (size_t i = 0; i < scan->size(); ++i) {
+      exprs.emplace_back(std::make_unique<RexAbstractInput>(i));
+    }
+    return std::make_shared<RelProject>(exprs, scan->getFieldNames(), scan);
+  }
+
   RelAlgInputs getRelAlgInputs(const rapidjson::Value& node) {
     if (node.HasMember("inputs")) {
       const auto str_input_ids = strings_from_json_array(field(node, "inputs"));
@@ -2577,8 +2920,12 @@ RelAlgDagBuilder::RelAlgDagBuilder(const std::string& query_ra,
                                    const Catalog_Namespace::Catalog& cat,
                                    const RenderInfo* render_info)
     : cat_(cat), render_info_(render_info) {
+  // Parsed in place, the strings of the DOM point into query_ra_buffer instead of being
+  // copied one by one. The DOM and its buffer go away once the DAG is built.
+  std::vector<char> query_ra_buffer(query_ra.begin(), query_ra.end());
+  query_ra_buffer.push_back('\0');
   rapidjson::Document query_ast;
-  query_ast.Parse(query_ra.c_str());
+  query_ast.ParseInsitu(query_ra_buffer.data());
   VLOG(2) << "Parsing query RA JSON: " << query_ra;
   if (query_ast.HasParseError()) {
     query_ast.GetParseError();
@@ -2621,6 +2968,7 @@ void RelAlgDagBuilder::build(const rapidjson::Value& query_ast,
   }
 
   handleQueryHint(nodes_, this);
+  rescale_sampled_aggregates(nodes_);
   mark_nops(nodes_);
   simplify_sort(nodes_);
   sink_projected_boolean_expr_to_join(nodes_);
@@ -2650,6 +2998,10 @@ void RelAlgDagBuilder::build(const rapidjson::Value& query_ast,
   }
   coalesce_nodes(nodes_, left_deep_joins);
   CHECK(nodes_.back().unique());
+  if (g_enable_semi_join && !g_cluster && !render_info_ &&
+      create_semi_joins_for_in_subqueries(nodes_, cat_)) {
+    eliminate_dead_subqueries(subqueries_, nodes_.back().get());
+  }
   create_left_deep_join(nodes_);
 }
 
@@ -30,6 +30,7 @@
 #include <boost/core/noncopyable.hpp>
 
 #include "Catalog/Catalog.h"
+#include "QueryEngine/Descriptors/InputDescriptors.h"
 #include "QueryEngine/QueryHint.h"
 #include "QueryEngine/Rendering/RenderInfo.h"
 #include "QueryEngine/TargetMetaInfo.h"
@@ -262,16 +263,18 @@ class ExecutionResult;
 
 class RexSubQuery : public RexScalar {
  public:
-  RexSubQuery(const std::shared_ptr<const RelAlgNode> ra)
+  RexSubQuery(const std::shared_ptr<const RelAlgNode> ra, const std::string& plan = "")
       : type_(new SQLTypeInfo(kNULLT, false))
       , result_(new std::shared_ptr<const ExecutionResult>(nullptr))
-      , ra_(ra) {}
+      , ra_(ra)
+      , plan_(plan) {}
 
   // for deep copy
   RexSubQuery(std::shared_ptr<SQLTypeInfo> type,
               std::shared_ptr<std::shared_ptr<const ExecutionResult>> result,
-              const std::shared_ptr<const RelAlgNode> ra)
-      : type_(type), result_(result), ra_(ra) {}
+              const std::shared_ptr<const RelAlgNode> ra,
+              const std::string& plan)
+      : type_(type), result_(result), ra_(ra), plan_(plan) {}
 
   RexSubQuery(const RexSubQuery&) = delete;
 
@@ -296,6 +299,11 @@ class RexSubQuery : public RexScalar {
 
   const RelAlgNode* getRelAlg() const { return ra_.get(); }
 
+  std::shared_ptr<const RelAlgNode> getRelAlgShPtr() const { return ra_; }
+
+  // The JSON the subquery was built from, empty unless its result may be cached
+  const std::string& getPlan() const { return plan_; }
+
   std::string toString() const override {
     return "(RexSubQuery " + std::to_string(reinterpret_cast<const uint64_t>(this)) +
            " id(" + std::to_string(getId()) + "))";
@@ -309,6 +317,7 @@ class RexSubQuery : public RexScalar {
   std::shared_ptr<SQLTypeInfo> type_;
   std::shared_ptr<std::shared_ptr<const ExecutionResult>> result_;
   const std::shared_ptr<const RelAlgNode> ra_;
+  const std::string plan_;
 };
 
 // The actual input node understood by the Executor.
@@ -802,6 +811,25 @@ class RelScan : public RelAlgNode {
 
   const std::string getFieldName(const size_t i) const { return field_names_[i]; }
 
+  /**
+   * TABLESAMPLE of the scan: BERNOULLI keeps each row with probability rate, through a
+   * SAMPLE_RATIO filter above the scan, SYSTEM each fragment, by skipping the others when
+   * dispatching the kernels.
+   */
+  void setSample(const bool bernoulli, const double rate, const int64_t seed) {
+    bernoulli_sample_ = bernoulli;
+    sample_rate_ = rate;
+    sample_seed_ = seed;
+  }
+
+  //! The share of the rows of the table the scan outputs
+  double getSampleRate() const { return sample_rate_; }
+
+  FragmentSample getFragmentSample() const {
+    return bernoulli_sample_ ? FragmentSample{}
+                             : FragmentSample{sample_rate_, sample_seed_};
+  }
+
   std::string toString() const override {
     return "(RelScan<" + std::to_string(reinterpret_cast<uint64_t>(this)) + "> " +
            td_->tableName + ")";
@@ -838,6 +866,9 @@ class RelScan : public RelAlgNode {
   const std::vector<std::string> field_names_;
   bool hint_applied_;
   std::unique_ptr<Hints> hints_;
+  bool bernoulli_sample_{false};
+  double sample_rate_{1.};
+  int64_t sample_seed_{0};
 };
 
 class ModifyManipulationTarget {
@@ -1239,8 +1270,11 @@ class RelLeftDeepInnerJoin : public RelAlgNode {
 
   const RexScalar* getInnerCondition() const;
 
+  // The condition of the outer or semi join at nesting_level, if any
   const RexScalar* getOuterCondition(const size_t nesting_level) const;
 
+  JoinType getJoinType(const size_t nesting_level) const;
+
   std::string toString() const override;
 
   size_t size() const override;
@@ -1574,6 +1608,11 @@ class RelModify : public RelAlgNode {
             throw std::runtime_error("UPDATE of a shard key is currently unsupported.");
           }
         }
+        // the updated rows would stay in the fragments of their old partition
+        if (column_desc->columnId == table_descriptor_->partitionColumnId) {
+          throw std::runtime_error(
+              "UPDATE of a partition column is currently unsupported.");
+        }
 
         // Check for valid types
         if (column_desc->columnType.is_varlen()) {
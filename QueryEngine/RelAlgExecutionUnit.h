@@ -87,6 +87,7 @@ struct TableFunctionExecutionUnit {
   std::vector<Analyzer::Expr*> target_exprs;
   const std::optional<size_t> output_buffer_multiplier;
   const std::string table_func_name;
+  const bool is_partitionable;
 };
 
 class ResultSet;
@@ -15,16 +15,20 @@
  */
 
 #include "RelAlgExecutor.h"
+#include "CudaMgr/CudaMgr.h"
 #include "Parser/ParserNode.h"
 #include "QueryEngine/CalciteDeserializerUtils.h"
 #include "QueryEngine/CardinalityEstimator.h"
 #include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/DeviceCostModel.h"
 #include "QueryEngine/EquiJoinCondition.h"
 #include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/ExpressionRewrite.h"
 #include "QueryEngine/ExternalExecutor.h"
 #include "QueryEngine/FromTableReordering.h"
+#include "QueryEngine/PredictiveWatchdog.h"
 #include "QueryEngine/QueryPhysicalInputsCollector.h"
+#include "QueryEngine/QueryProfile.h"
 #include "QueryEngine/RangeTableIndexVisitor.h"
 #include "QueryEngine/RelAlgDagBuilder.h"
 #include "QueryEngine/RelAlgTranslator.h"
@@ -41,12 +45,17 @@
 
 #include <algorithm>
 #include <functional>
+#include <future>
 #include <numeric>
 
 bool g_skip_intermediate_count{true};
 extern bool g_enable_bump_allocator;
 bool g_enable_interop{false};
 bool g_enable_union{false};
+bool g_enable_parallel_union_branches{false};
+bool g_enable_semi_join{true};
+bool g_enable_delete_fragment_drop{true};
+bool g_enable_columnar_update{true};
 
 namespace {
 
@@ -255,6 +264,17 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const CompilationOptio
     return ret;
   };
   auto lock = aquire_execute_mutex(executor_);
+  // the kernels and the subqueries find the profile through the executor, which no other
+  // query uses while this one has the lock
+  executor_->query_profile_ = query_profile_;
+  ScopeGuard reset_query_profile = [this] { executor_->query_profile_ = nullptr; };
+  if (query_state_ != nullptr && query_state_->getConstSessionInfo() != nullptr) {
+    executor_->query_priority_ = get_query_priority(
+        query_state_->getConstSessionInfo()->get_currentUser().userName);
+  }
+  ScopeGuard reset_query_priority = [this] {
+    executor_->query_priority_ = QueryPriority::NORMAL;
+  };
   ScopeGuard clearRuntimeInterruptStatus = [this] {
     // reset the runtime query interrupt status
     if (g_enable_runtime_query_interrupt) {
@@ -352,6 +372,27 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const CompilationOptio
     return executeRelAlgQueryWithFilterPushDown(
         ed_seq, co, eo, render_info, queue_time_ms);
   }
+
+  // taken before the query runs, a change of the tables while it does is seen as one
+  // after its result
+  std::string result_set_cache_key;
+  std::optional<ResultSetCache::Versions> result_set_cache_versions;
+  if (canUseResultSetCache(query_ra_, eo, render_info)) {
+    result_set_cache_key = std::to_string(cat_.getCurrentDB().dbId) + ":" + query_ra_;
+    result_set_cache_versions = getResultSetCacheVersions(&ra);
+  }
+  if (result_set_cache_versions) {
+    auto cached_result = ResultSetCache::instance().get(
+        result_set_cache_key, *result_set_cache_versions, executor_);
+    if (cached_result) {
+      VLOG(1) << "Using the cached result of the query";
+      if (query_profile_) {
+        query_profile_->setResultSetCacheHit();
+      }
+      cached_result->setQueueTime(queue_time_ms);
+      return std::move(*cached_result);
+    }
+  }
   timer_setup.stop();
 
   // Dispatch the subqueries first
@@ -361,13 +402,75 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const CompilationOptio
     if (subquery_ra->hasContextData()) {
       continue;
     }
+    // the queries of a dashboard often share a subquery, which then runs once while its
+    // tables are unchanged
+    std::string subquery_cache_key;
+    std::optional<ResultSetCache::Versions> subquery_cache_versions;
+    if (canUseResultSetCache(subquery->getPlan(), eo, nullptr)) {
+      subquery_cache_key =
+          std::to_string(cat_.getCurrentDB().dbId) + ":subquery:" + subquery->getPlan();
+      subquery_cache_versions = getResultSetCacheVersions(subquery_ra);
+    }
+    if (subquery_cache_versions) {
+      auto cached_result = ResultSetCache::instance().get(
+          subquery_cache_key, *subquery_cache_versions, executor_);
+      if (cached_result) {
+        VLOG(1) << "Using the cached result of subquery " << subquery->getId();
+        subquery->setExecutionResult(
+            std::make_shared<ExecutionResult>(std::move(*cached_result)));
+        continue;
+      }
+    }
+    auto subquery_co = co;
+    if (subquery_cache_versions) {
+      // the rows of lazily fetched columns point into the chunks, they aren't cached
+      subquery_co.allow_lazy_fetch = false;
+    }
     // Execute the subquery and cache the result.
     RelAlgExecutor ra_executor(executor_, cat_, query_state_);
     RaExecutionSequence subquery_seq(subquery_ra);
-    auto result = ra_executor.executeRelAlgSeq(subquery_seq, co, eo, nullptr, 0);
+    auto result = ra_executor.executeRelAlgSeq(subquery_seq, subquery_co, eo, nullptr, 0);
+    if (subquery_cache_versions && !result.empty()) {
+      ResultSetCache::instance().put(
+          subquery_cache_key, *subquery_cache_versions, result, executor_);
+    }
     subquery->setExecutionResult(std::make_shared<ExecutionResult>(result));
   }
-  return executeRelAlgSeq(ed_seq, co, eo, render_info, queue_time_ms);
+  auto result = executeRelAlgSeq(ed_seq, co, eo, render_info, queue_time_ms);
+  if (!result.empty() && executor_->row_set_mem_owner_) {
+    result.setGpuMemoryUsage(
+        executor_->row_set_mem_owner_->getGpuMemoryUsageTracker()->getUsage());
+  }
+  if (result_set_cache_versions && !result.empty()) {
+    ResultSetCache::instance().put(
+        result_set_cache_key, *result_set_cache_versions, result, executor_);
+  }
+  return result;
+}
+
+bool RelAlgExecutor::canUseResultSetCache(const std::string& plan,
+                                          const ExecutionOptions& eo,
+                                          const RenderInfo* render_info) const {
+  return g_enable_result_set_cache && !g_cluster && !render_info && !eo.just_explain &&
+         !eo.just_validate && !eo.just_calcite_explain &&
+         eo.executor_type == ExecutorType::Native &&
+         eo.outer_fragment_indices.empty() && ResultSetCache::isCacheable(plan);
+}
+
+std::optional<ResultSetCache::Versions> RelAlgExecutor::getResultSetCacheVersions(
+    const RelAlgNode* ra) const {
+  if (ra == &getRootRelAlgNode()) {
+    return ResultSetCache::getVersions(
+        cat_, executor_->table_generations_, executor_->string_dictionary_generations_);
+  }
+  // the tables of a subquery, the dictionaries of the whole query conservatively
+  TableGenerations table_generations;
+  for (const auto table_id : get_physical_table_inputs(ra)) {
+    table_generations.setGeneration(
+        table_id, executor_->table_generations_.getGeneration(table_id));
+  }
+  return ResultSetCache::getVersions(
+      cat_, table_generations, executor_->string_dictionary_generations_);
 }
 
 AggregatedColRange RelAlgExecutor::computeColRangesCache() {
@@ -492,6 +595,11 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(const RaExecutionSequence& seq,
   const auto exec_desc_count = eo.just_explain ? size_t(1) : seq.size();
 
   for (size_t i = 0; i < exec_desc_count; i++) {
+    if (const auto branch_count = executeUnionBranchesInParallel(
+            seq, i, exec_desc_count, co, eo, queue_time_ms)) {
+      i += branch_count - 1;
+      continue;
+    }
     VLOG(1) << "Executing query step " << i;
     // only render on the last step
     try {
@@ -551,6 +659,142 @@ ExecutionResult RelAlgExecutor::executeRelAlgSubSeq(
   return seq.getDescriptor(interval.second - 1)->getResult();
 }
 
+namespace {
+
+constexpr size_t kMaxParallelUnionBranches{16};
+
+// A step which only reads physical tables and whose result only feeds a UNION ALL, so
+// it doesn't depend on any other step
+bool is_independent_union_branch(const RaExecutionSequence& seq,
+                                 const size_t step_idx,
+                                 const size_t step_count) {
+  const auto body = seq.getDescriptor(step_idx)->getBody();
+  if (body->isNop() || !body->inputCount()) {
+    return false;
+  }
+  const auto compound = dynamic_cast<const RelCompound*>(body);
+  const auto project = dynamic_cast<const RelProject*>(body);
+  if ((!compound && !project && !dynamic_cast<const RelAggregate*>(body) &&
+       !dynamic_cast<const RelFilter*>(body)) ||
+      (compound &&
+       (compound->isDeleteViaSelect() || compound->isUpdateViaSelect())) ||
+      (project && (project->isDeleteViaSelect() || project->isUpdateViaSelect()))) {
+    return false;
+  }
+  for (size_t i = 0; i < body->inputCount(); ++i) {
+    if (!dynamic_cast<const RelScan*>(body->getInput(i))) {
+      return false;
+    }
+  }
+  for (size_t i = step_idx + 1; i < step_count; ++i) {
+    const auto logical_union =
+        dynamic_cast<const RelLogicalUnion*>(seq.getDescriptor(i)->getBody());
+    if (logical_union && logical_union->isAll() && logical_union->hasInput(body)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The executors of the parallel UNION ALL branches of the queries of executor_id. Their
+// ids are past those of the dispatch queue workers, and an executor runs one query at a
+// time, so no other query uses them meanwhile.
+std::shared_ptr<Executor> get_union_branch_executor(
+    const Executor::ExecutorId executor_id,
+    const size_t branch_idx,
+    const SystemParameters& system_parameters) {
+  constexpr Executor::ExecutorId kUnionBranchExecutorIdBase{size_t(1) << 32};
+  CHECK_LT(branch_idx, kMaxParallelUnionBranches);
+  return Executor::getExecutor(
+      kUnionBranchExecutorIdBase + executor_id * kMaxParallelUnionBranches + branch_idx,
+      "",
+      "",
+      system_parameters);
+}
+
+}  // namespace
+
+size_t RelAlgExecutor::executeUnionBranchesInParallel(const RaExecutionSequence& seq,
+                                                      const size_t step_idx,
+                                                      const size_t step_count,
+                                                      const CompilationOptions& co,
+                                                      const ExecutionOptions& eo,
+                                                      const int64_t queue_time_ms) {
+  if (!g_enable_parallel_union_branches || g_cluster || g_enable_interop ||
+      eo.just_explain || eo.find_push_down_candidates ||
+      eo.executor_type != ExecutorType::Native) {
+    return 0;
+  }
+  size_t branch_count{0};
+  while (branch_count < kMaxParallelUnionBranches &&
+         step_idx + branch_count < step_count &&
+         is_independent_union_branch(seq, step_idx + branch_count, step_count)) {
+    ++branch_count;
+  }
+  if (branch_count < 2) {
+    return 0;
+  }
+  auto timer = DEBUG_TIMER(__func__);
+  VLOG(1) << "Executing query steps " << step_idx << " to "
+          << step_idx + branch_count - 1 << " as parallel UNION ALL branches";
+  SystemParameters system_parameters;
+  system_parameters.cuda_block_size = executor_->block_size_x_;
+  system_parameters.cuda_grid_size = executor_->grid_size_x_;
+  system_parameters.max_gpu_slab_size = executor_->max_gpu_slab_size_;
+  std::vector<std::future<void>> branch_futures;
+  for (size_t branch_idx = 0; branch_idx < branch_count; ++branch_idx) {
+    branch_futures.push_back(std::async(
+        std::launch::async,
+        [this,
+         &seq,
+         &co,
+         &eo,
+         &system_parameters,
+         queue_time_ms,
+         branch_idx,
+         step_idx,
+         parent_thread_id = logger::thread_id()] {
+          DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+          auto branch_executor = get_union_branch_executor(
+              executor_->executor_id_, branch_idx, system_parameters);
+          // the branch shares the caches and the result memory of the query
+          branch_executor->row_set_mem_owner_ = executor_->row_set_mem_owner_;
+          branch_executor->agg_col_range_cache_ = executor_->agg_col_range_cache_;
+          branch_executor->string_dictionary_generations_ =
+              executor_->string_dictionary_generations_;
+          branch_executor->table_generations_ = executor_->table_generations_;
+          branch_executor->query_priority_ = executor_->query_priority_;
+          ScopeGuard reset_branch_executor = [&branch_executor] {
+            branch_executor->row_set_mem_owner_ = nullptr;
+            branch_executor->temporary_tables_ = nullptr;
+            branch_executor->query_priority_ = QueryPriority::NORMAL;
+            branch_executor->clearMetaInfoCache();
+          };
+          RelAlgExecutor branch_ra_executor(branch_executor.get(), cat_, query_state_);
+          branch_executor->catalog_ = &cat_;
+          branch_executor->temporary_tables_ = &branch_ra_executor.temporary_tables_;
+          branch_ra_executor.now_ = now_;
+          // the lazily fetched columns are read through the executor of the step
+          auto branch_co = co;
+          branch_co.allow_lazy_fetch = false;
+          branch_ra_executor.executeRelAlgStep(
+              seq, step_idx + branch_idx, branch_co, eo, nullptr, queue_time_ms);
+        }));
+  }
+  for (auto& branch_future : branch_futures) {
+    branch_future.wait();
+  }
+  for (auto& branch_future : branch_futures) {
+    branch_future.get();
+  }
+  for (size_t i = step_idx; i < step_idx + branch_count; ++i) {
+    const auto exec_desc = seq.getDescriptor(i);
+    addTemporaryTable(-exec_desc->getBody()->getId(),
+                      exec_desc->getResult().getDataPtr());
+  }
+  return branch_count;
+}
+
 void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
                                        const size_t step_idx,
                                        const CompilationOptions& co,
@@ -559,6 +803,10 @@ void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
                                        const int64_t queue_time_ms) {
   INJECT_TIMER(executeRelAlgStep);
   auto timer = DEBUG_TIMER(__func__);
+  if (Executor::isInterrupted()) {
+    // the remaining steps of an interrupted query don't run
+    throw std::runtime_error(getErrorMessageFromCode(Executor::ERR_INTERRUPTED));
+  }
   WindowProjectNodeContext::reset(executor_);
   auto exec_desc_ptr = seq.getDescriptor(step_idx);
   CHECK(exec_desc_ptr);
@@ -568,6 +816,24 @@ void RelAlgExecutor::executeRelAlgStep(const RaExecutionSequence& seq,
     handleNop(exec_desc);
     return;
   }
+  const auto query_profile = executor_->query_profile_;
+  std::optional<size_t> query_profile_step;
+  if (query_profile) {
+    std::vector<unsigned> input_ids;
+    for (size_t i = 0; i < body->inputCount(); ++i) {
+      input_ids.push_back(body->getInput(i)->getId());
+    }
+    query_profile_step =
+        query_profile->beginStep(step_idx, body->getId(), body->toString(), input_ids);
+  }
+  const auto step_clock_begin = timer_start();
+  ScopeGuard end_query_profile_step = [&] {
+    if (query_profile_step) {
+      const auto& rows = exec_desc.getResult().getRows();
+      query_profile->endStep(
+          *query_profile_step, timer_stop(step_clock_begin), rows ? rows->rowCount() : 0);
+    }
+  };
   const ExecutionOptions eo_work_unit{
       eo.output_columnar_hint,
       eo.allow_multifrag,
@@ -1012,7 +1278,16 @@ get_input_desc_impl(const RA* ra_node,
         input_permutation.empty() ? input_idx : input_permutation[input_idx];
     auto input_ra = data_sink_node->getInput(input_node_idx);
     const int table_id = table_id_from_ra(input_ra);
-    input_descs.emplace_back(table_id, input_idx);
+    FragmentSample fragment_sample;
+    if (const auto scan_ra = dynamic_cast<const RelScan*>(input_ra)) {
+      fragment_sample = scan_ra->getFragmentSample();
+    }
+    if (fragment_sample.isSampled() && input_idx > 0) {
+      // the inner tables are read whole, by the hash joins in particular
+      throw QueryNotSupported(
+          "TABLESAMPLE SYSTEM is only supported on the outer table of a join");
+    }
+    input_descs.emplace_back(table_id, input_idx, fragment_sample);
   }
   std::sort(input_descs.begin(),
             input_descs.end(),
@@ -1375,6 +1650,14 @@ void RelAlgExecutor::executeUpdate(const RelAlgNode* node,
 
   auto execute_update_for_node =
       [this, &co, &eo_in](const auto node, auto& work_unit, const bool is_aggregate) {
+        for (const auto& column_name : node->getTargetColumns()) {
+          const auto cd = cat_.getMetadataForColumn(
+              node->getModifiedTableDescriptor()->tableId, column_name);
+          if (cd && cd->columnType.get_compression() == kENCODING_DIFF) {
+            throw std::runtime_error("Updating Diff encoded column " + column_name +
+                                     " is not supported.");
+          }
+        }
         UpdateTransactionParameters update_params(node->getModifiedTableDescriptor(),
                                                   node->getTargetColumns(),
                                                   node->getOutputMetainfo(),
@@ -1393,6 +1676,12 @@ void RelAlgExecutor::executeUpdate(const RelAlgNode* node,
                 co_project.allow_lazy_fetch = false;
                 co_project.filter_on_deleted_column =
                     false;  // project the entire delete column for columnar update
+              } else if (g_enable_columnar_update &&
+                         !update_params.isVarlenUpdateRequired()) {
+                // the update callback copies the projected columns into the chunks
+                // directly where their types allow it
+                eo.output_columnar_hint = true;
+                co_project.allow_lazy_fetch = false;
               }
 
               auto update_callback = yieldUpdateCallback(update_params);
@@ -1500,8 +1789,39 @@ void RelAlgExecutor::executeDelete(const RelAlgNode* node,
             CHECK_EQ(exe_unit.target_exprs.size(), size_t(1));
           }
 
+          // the fragments whose chunk stats show that all of their rows are deleted,
+          // by physical table, are dropped instead of marking their rows
+          std::map<int, std::vector<int>> dropped_fragment_ids;
+          auto update_table_infos = table_infos;
+          if (g_enable_delete_fragment_drop && !delete_params.tableIsTemporary() &&
+              exe_unit.input_descs.size() == 1 && exe_unit.quals.empty() &&
+              exe_unit.join_quals.empty() && !exe_unit.scan_limit) {
+            auto& fragments = update_table_infos.front().info.fragments;
+            // the last fragment of a physical table takes the inserts
+            std::map<int, int> last_fragment_ids;
+            for (const auto& fragment : fragments) {
+              auto& last_fragment_id = last_fragment_ids
+                                           .emplace(fragment.physicalTableId,
+                                                    fragment.fragmentId)
+                                           .first->second;
+              last_fragment_id = std::max(last_fragment_id, fragment.fragmentId);
+            }
+            const auto& table_desc = exe_unit.input_descs.front();
+            auto dropped_it = std::stable_partition(
+                fragments.begin(), fragments.end(), [&](const auto& fragment) {
+                  return fragment.fragmentId ==
+                             last_fragment_ids[fragment.physicalTableId] ||
+                         !executor_->allFragmentRowsQualify(
+                             table_desc, fragment, exe_unit.simple_quals);
+                });
+            for (auto it = dropped_it; it != fragments.end(); ++it) {
+              dropped_fragment_ids[it->physicalTableId].push_back(it->fragmentId);
+            }
+            fragments.erase(dropped_it, fragments.end());
+          }
+
           executor_->executeUpdate(exe_unit,
-                                   table_infos,
+                                   update_table_infos,
                                    co_delete,
                                    eo,
                                    cat_,
@@ -1509,6 +1829,19 @@ void RelAlgExecutor::executeDelete(const RelAlgNode* node,
                                    delete_callback,
                                    is_aggregate);
           delete_params.finalizeTransaction();
+
+          // only once the other fragments were updated, since dropping is final
+          if (!dropped_fragment_ids.empty()) {
+            size_t num_dropped{0};
+            for (const auto& [physical_table_id, fragment_ids] : dropped_fragment_ids) {
+              const auto physical_td = cat_.getMetadataForTable(physical_table_id);
+              CHECK(physical_td && physical_td->fragmenter);
+              num_dropped += physical_td->fragmenter->dropFragments(fragment_ids);
+            }
+            cat_.checkpoint(table_descriptor->tableId);
+            VLOG(1) << "DELETE dropped " << num_dropped << " fragments of table "
+                    << table_descriptor->tableName;
+          }
         };
 
     if (table_is_temporary(table_descriptor)) {
@@ -1594,6 +1927,30 @@ bool is_window_execution_unit(const RelAlgExecutionUnit& ra_exe_unit) {
                      });
 }
 
+// The window functions with the same partition keys share the hash table of their
+// partitions.
+std::string window_partition_key(const Analyzer::WindowFunction* window_func) {
+  std::string key;
+  for (const auto& partition_key : window_func->getPartitionKeys()) {
+    key += partition_key->toString();
+  }
+  return key;
+}
+
+// The window functions with the same partition keys and order keys and collations share
+// the sort of their partitions too.
+std::string window_sort_key(const Analyzer::WindowFunction* window_func) {
+  auto key = window_partition_key(window_func) + "|";
+  const auto& order_keys = window_func->getOrderKeys();
+  const auto& collation = window_func->getCollation();
+  CHECK_EQ(order_keys.size(), collation.size());
+  for (size_t i = 0; i < order_keys.size(); ++i) {
+    key += order_keys[i]->toString() + (collation[i].is_desc ? " DESC" : " ASC") +
+           (collation[i].nulls_first ? " NULLS FIRST " : " NULLS LAST ");
+  }
+  return key;
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeProject(const RelProject* project,
@@ -1699,7 +2056,8 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
                                    const CompilationOptions& co,
                                    const ExecutionOptions& eo,
                                    ColumnCacheMap& column_cache_map,
-                                   const int64_t queue_time_ms) {
+                                   const int64_t queue_time_ms,
+                                   const bool gpu_requested) {
   auto query_infos = get_table_infos(ra_exe_unit.input_descs, executor_);
   CHECK_EQ(query_infos.size(), size_t(1));
   if (query_infos.front().info.fragments.size() != 1) {
@@ -1711,6 +2069,19 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
   }
   query_infos.push_back(query_infos.front());
   auto window_project_node_context = WindowProjectNodeContext::create(executor_);
+  // the number of the window functions left to compute by each sort of the partitions,
+  // the sorts are only kept while some of them still need them
+  std::unordered_map<std::string, size_t> sort_uses;
+  for (const auto target_expr : ra_exe_unit.target_exprs) {
+    const auto window_func = dynamic_cast<const Analyzer::WindowFunction*>(target_expr);
+    if (window_func) {
+      ++sort_uses[window_sort_key(window_func)];
+    }
+  }
+  std::unordered_map<std::string, std::shared_ptr<JoinHashTableInterface>>
+      partitions_by_key;
+  std::unordered_map<std::string, std::shared_ptr<std::vector<int64_t>>>
+      sorted_partitions_by_key;
   for (size_t target_index = 0; target_index < ra_exe_unit.target_exprs.size();
        ++target_index) {
     const auto& target_expr = ra_exe_unit.target_exprs[target_index];
@@ -1738,27 +2109,43 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
                                     kONE,
                                     partition_key_tuple,
                                     transform_to_inner(partition_key_tuple.get()));
+    auto& partitions = partitions_by_key[window_partition_key(window_func)];
+    if (!partitions) {
+      partitions = buildWindowFunctionPartitions(
+          partition_key_cond, query_infos, co, column_cache_map);
+    }
     auto context = createWindowFunctionContext(window_func,
-                                               partition_key_cond,
+                                               partitions,
                                                ra_exe_unit,
                                                query_infos,
                                                co,
                                                column_cache_map,
                                                executor_->getRowSetMemoryOwner());
+    if (gpu_requested && g_enable_window_function_gpu_sort) {
+      context->setGpuSortDataMgr(&cat_.getDataMgr());
+    }
+    const auto sort_key = window_sort_key(window_func);
+    auto& sorted_partitions = sorted_partitions_by_key[sort_key];
+    auto& uses_left = sort_uses[sort_key];
+    CHECK_GT(uses_left, size_t(0));
+    --uses_left;
+    if (sorted_partitions) {
+      context->setSortedPartitions(sorted_partitions);
+    } else if (uses_left) {
+      context->keepSortedPartitions();
+    }
     context->compute();
+    sorted_partitions = uses_left ? context->getSortedPartitions() : nullptr;
     window_project_node_context->addWindowFunctionContext(std::move(context),
                                                           target_index);
   }
 }
 
-std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionContext(
-    const Analyzer::WindowFunction* window_func,
+std::shared_ptr<JoinHashTableInterface> RelAlgExecutor::buildWindowFunctionPartitions(
     const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
-    const RelAlgExecutionUnit& ra_exe_unit,
     const std::vector<InputTableInfo>& query_infos,
     const CompilationOptions& co,
-    ColumnCacheMap& column_cache_map,
-    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner) {
+    ColumnCacheMap& column_cache_map) {
   const auto memory_level = co.device_type == ExecutorDeviceType::GPU
                                 ? MemoryLevel::GPU_LEVEL
                                 : MemoryLevel::CPU_LEVEL;
@@ -1773,11 +2160,25 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
   }
   CHECK(join_table_or_err.hash_table->getHashType() ==
         JoinHashTableInterface::HashType::OneToMany);
+  return join_table_or_err.hash_table;
+}
+
+std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionContext(
+    const Analyzer::WindowFunction* window_func,
+    const std::shared_ptr<JoinHashTableInterface>& partitions,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& query_infos,
+    const CompilationOptions& co,
+    ColumnCacheMap& column_cache_map,
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner) {
+  const auto memory_level = co.device_type == ExecutorDeviceType::GPU
+                                ? MemoryLevel::GPU_LEVEL
+                                : MemoryLevel::CPU_LEVEL;
   const auto& order_keys = window_func->getOrderKeys();
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   const size_t elem_count = query_infos.front().info.fragments.front().getNumTuples();
   auto context = std::make_unique<WindowFunctionContext>(window_func,
-                                                         join_table_or_err.hash_table,
+                                                         partitions,
                                                          elem_count,
                                                          co.device_type,
                                                          row_set_mem_owner);
@@ -1801,6 +2202,31 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
     CHECK_EQ(join_col_elem_count, elem_count);
     context->addOrderColumn(column, order_col.get(), chunks_owner);
   }
+  const auto& args = window_func->getArgs();
+  if (window_function_is_frame_aggregate(window_func) && !args.empty()) {
+    const auto arg_col =
+        std::dynamic_pointer_cast<const Analyzer::ColumnVar>(args.front());
+    if (!arg_col) {
+      throw std::runtime_error("Only columns supported in the window frame aggregates");
+    }
+    if (arg_col->get_type_info().get_compression() == kENCODING_DIFF) {
+      throw std::runtime_error("DIFF encoded columns not supported in window frames yet");
+    }
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> aggregate_chunks_owner;
+    const int8_t* column;
+    size_t agg_col_elem_count;
+    std::tie(column, agg_col_elem_count) =
+        ColumnFetcher::getOneColumnFragment(executor_,
+                                            *arg_col,
+                                            query_infos.front().info.fragments.front(),
+                                            memory_level,
+                                            0,
+                                            nullptr,
+                                            aggregate_chunks_owner,
+                                            column_cache_map);
+    CHECK_EQ(agg_col_elem_count, elem_count);
+    context->addAggregateColumn(column, aggregate_chunks_owner);
+  }
   return context;
 }
 
@@ -2521,6 +2947,20 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createSortInputWorkUnit(
 
 namespace {
 
+// over all the devices
+size_t get_gpu_buffer_pool_bytes(Data_Namespace::DataMgr& data_mgr) {
+  const auto cuda_mgr = data_mgr.getCudaMgr();
+  if (!data_mgr.gpusPresent() || !cuda_mgr) {
+    return 0;
+  }
+  size_t buffer_pool_bytes{0};
+  for (int device_id = 0; device_id < cuda_mgr->getDeviceCount(); ++device_id) {
+    buffer_pool_bytes +=
+        data_mgr.getBufferPoolMaxSize(Data_Namespace::GPU_LEVEL, device_id);
+  }
+  return buffer_pool_bytes;
+}
+
 /**
  *  Upper bound estimation for the number of groups. Not strictly correct and not tight,
  * but if the tables involved are really small we shouldn't waste time doing the NDV
@@ -2539,6 +2979,44 @@ size_t groups_approx_upper_bound(const std::vector<InputTableInfo>& table_infos)
   return std::max(max_num_groups, size_t(1));
 }
 
+/**
+ * Upper bound of the number of groups from the statistics ANALYZE TABLE collected for
+ * the group by columns: the product of their NDVs, counting the nulls as a value. The
+ * filters don't matter for the bound. Returns std::nullopt unless every group by
+ * expression is a column with statistics collected since the last rows were added to its
+ * table, or if the product doesn't beat groups_approx_upper_bound().
+ */
+std::optional<size_t> groups_statistics_upper_bound(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& table_infos,
+    const Catalog_Namespace::Catalog& cat) {
+  const auto approx_upper_bound = groups_approx_upper_bound(table_infos);
+  size_t num_groups{1};
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(groupby_expr.get());
+    if (!col_var || col_var->get_table_id() <= 0) {
+      return std::nullopt;
+    }
+    const auto statistics =
+        cat.getColumnStatistics(col_var->get_table_id(), col_var->get_column_id());
+    const auto table_info_it = std::find_if(
+        table_infos.begin(), table_infos.end(), [col_var](const auto& table_info) {
+          return table_info.table_id == col_var->get_table_id();
+        });
+    if (!statistics || table_info_it == table_infos.end() ||
+        table_info_it->info.getNumTuples() > static_cast<size_t>(statistics->rowCount)) {
+      return std::nullopt;
+    }
+    const size_t column_groups =
+        std::max(statistics->ndv + (statistics->nullCount ? 1 : 0), int64_t(1));
+    if (column_groups >= approx_upper_bound / num_groups) {
+      return std::nullopt;
+    }
+    num_groups *= column_groups;
+  }
+  return num_groups;
+}
+
 /**
  * Determines whether a query needs to compute the size of its output buffer. Returns
  * true for projection queries with no LIMIT or a LIMIT that exceeds the high scan limit
@@ -2602,7 +3080,7 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
         get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
     int64_t approx_bitmap_sz_bits{0};
     const auto error_rate =
-        static_cast<Analyzer::AggExpr*>(target_expr)->get_error_rate();
+        static_cast<Analyzer::AggExpr*>(target_expr)->get_arg1();
     if (error_rate) {
       CHECK(error_rate->get_type_info().get_type() == kINT);
       CHECK_GE(error_rate->get_constval().intval, 1);
@@ -2673,9 +3151,11 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     if (!g_enable_window_functions) {
       throw std::runtime_error("Window functions support is disabled");
     }
+    const bool gpu_requested = co.device_type == ExecutorDeviceType::GPU;
     co.device_type = ExecutorDeviceType::CPU;
     co.allow_lazy_fetch = false;
-    computeWindow(work_unit.exe_unit, co, eo, column_cache, queue_time_ms);
+    computeWindow(
+        work_unit.exe_unit, co, eo, column_cache, queue_time_ms, gpu_requested);
   }
   if (!eo.just_explain && eo.find_push_down_candidates) {
     // find potential candidates:
@@ -2705,6 +3185,21 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     return result;
   }
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
+  if (g_enable_device_cost_model && co.device_type == ExecutorDeviceType::GPU &&
+      !render_info && eo.executor_type == ::ExecutorType::Native) {
+    co.device_type = DeviceCostModel::instance().chooseDeviceType(
+        work_unit.exe_unit, table_infos, cat_);
+  }
+  const bool check_predicted_cost = g_enable_predictive_watchdog && !render_info &&
+                                    !eo.just_explain && !eo.just_validate &&
+                                    eo.executor_type == ::ExecutorType::Native;
+  DeviceCostModel::InputBytes input_bytes;
+  if (check_predicted_cost) {
+    input_bytes =
+        DeviceCostModel::getInputBytes(work_unit.exe_unit, table_infos, cat_);
+    co.device_type = PredictiveWatchdog::instance().checkStep(
+        input_bytes, co.device_type, get_gpu_buffer_pool_bytes(cat_.getDataMgr()));
+  }
 
   auto ra_exe_unit = decide_approx_count_distinct_implementation(
       work_unit.exe_unit, table_infos, executor_, co.device_type, target_exprs_owned_);
@@ -2748,17 +3243,25 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     // due to OOM
     auto local_groups_buffer_entry_guess = max_groups_buffer_entry_guess_in;
     try {
-      return {executor_->executeWorkUnit(local_groups_buffer_entry_guess,
-                                         is_agg,
-                                         table_infos,
-                                         ra_exe_unit,
-                                         co,
-                                         eo,
-                                         cat_,
-                                         render_info,
-                                         has_cardinality_estimation,
-                                         column_cache),
-              targets_meta};
+      const auto step_begin = std::chrono::steady_clock::now();
+      auto rows = executor_->executeWorkUnit(local_groups_buffer_entry_guess,
+                                             is_agg,
+                                             table_infos,
+                                             ra_exe_unit,
+                                             co,
+                                             eo,
+                                             cat_,
+                                             render_info,
+                                             has_cardinality_estimation,
+                                             column_cache);
+      if (check_predicted_cost) {
+        PredictiveWatchdog::instance().recordStep(
+            co.device_type,
+            input_bytes.total,
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - step_begin)
+                .count());
+      }
+      return {rows, targets_meta};
     } catch (const QueryExecutionError& e) {
       handlePersistentError(e.getErrorCode());
       return handleOutOfMemoryRetry(
@@ -2791,9 +3294,18 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     if (cached_cardinality.first && card >= 0) {
       result = execute_and_handle_errors(card, true);
     } else {
+      // the statistics of the group by columns spare the estimator query
+      const auto statistics_upper_bound =
+          groups_statistics_upper_bound(ra_exe_unit, table_infos, cat_);
+      if (statistics_upper_bound) {
+        VLOG(1) << "Groups buffer sized from the column statistics for "
+                << *statistics_upper_bound << " groups";
+      }
       const auto estimated_groups_buffer_entry_guess =
-          2 * std::min(groups_approx_upper_bound(table_infos),
-                       getNDVEstimation(work_unit, e.range(), is_agg, co, eo));
+          2 * (statistics_upper_bound
+                   ? *statistics_upper_bound
+                   : std::min(groups_approx_upper_bound(table_infos),
+                              getNDVEstimation(work_unit, e.range(), is_agg, co, eo)));
       CHECK_GT(estimated_groups_buffer_entry_guess, size_t(0));
       result = execute_and_handle_errors(estimated_groups_buffer_entry_guess, true);
       if (!(eo.just_validate || eo.just_explain)) {
@@ -3190,7 +3702,7 @@ std::vector<JoinType> left_deep_join_types(const RelLeftDeepInnerJoin* left_deep
   for (size_t nesting_level = 1; nesting_level <= left_deep_join->inputCount() - 1;
        ++nesting_level) {
     if (left_deep_join->getOuterCondition(nesting_level)) {
-      join_types[nesting_level - 1] = JoinType::LEFT;
+      join_types[nesting_level - 1] = left_deep_join->getJoinType(nesting_level);
     }
   }
   return join_types;
@@ -3204,7 +3716,8 @@ std::vector<size_t> do_table_reordering(
     std::unordered_map<const RelAlgNode*, int>& input_to_nest_level,
     const RA* node,
     const std::vector<InputTableInfo>& query_infos,
-    const Executor* executor) {
+    const Executor* executor,
+    const std::vector<size_t>& filtered_table_sizes) {
   if (g_cluster) {
     // Disable table reordering in distributed mode. The aggregator does not have enough
     // information to break ties
@@ -3222,7 +3735,8 @@ std::vector<size_t> do_table_reordering(
     }
   }
   const auto input_permutation =
-      get_node_input_permutation(left_deep_join_quals, query_infos, executor);
+      get_node_input_permutation(
+          left_deep_join_quals, query_infos, executor, filtered_table_sizes);
   input_to_nest_level = get_input_nest_levels(node, input_permutation);
   std::tie(input_descs, input_col_descs, std::ignore) =
       get_input_desc(node, input_to_nest_level, input_permutation, cat);
@@ -3276,14 +3790,21 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createCompoundWorkUnit(
         left_deep_join, input_descs, input_to_nest_level, eo.just_explain);
     if (g_from_table_reordering &&
         std::find(join_types.begin(), join_types.end(), JoinType::LEFT) ==
+            join_types.end() &&
+        std::find(join_types.begin(), join_types.end(), JoinType::SEMI) ==
             join_types.end()) {
+      const auto filtered_table_sizes =
+          g_from_table_reordering_filtered_counts
+              ? getFilteredTableSizes(compound, input_to_nest_level, query_infos, eo)
+              : std::vector<size_t>{};
       input_permutation = do_table_reordering(input_descs,
                                               input_col_descs,
                                               left_deep_join_quals,
                                               input_to_nest_level,
                                               compound,
                                               query_infos,
-                                              executor_);
+                                              executor_,
+                                              filtered_table_sizes);
       input_to_nest_level = get_input_nest_levels(compound, input_permutation);
       std::tie(input_descs, input_col_descs, std::ignore) =
           get_input_desc(compound, input_to_nest_level, input_permutation, cat_);
@@ -3428,6 +3949,108 @@ std::shared_ptr<Analyzer::Expr> reverse_logical_distribution(
 
 }  // namespace
 
+std::vector<size_t> RelAlgExecutor::getFilteredTableSizes(
+    const RelCompound* compound,
+    const std::unordered_map<const RelAlgNode*, int>& input_to_nest_level,
+    const std::vector<InputTableInfo>& query_infos,
+    const ExecutionOptions& eo) {
+  const auto filter_rex = compound->getFilterExpr();
+  if (!filter_rex || eo.just_explain || eo.find_push_down_candidates) {
+    return {};
+  }
+  // The conjuncts of the filter which only reference a table, by the scan of the table
+  std::map<const RelScan*, std::vector<const RexScalar*>> table_conjuncts;
+  RexUsedInputsVisitor visitor(cat_);
+  for (const auto conjunct : rex_to_conjunctive_form(filter_rex)) {
+    const auto used_inputs = visitor.visit(conjunct);
+    if (used_inputs.empty()) {
+      continue;
+    }
+    const auto source = (*used_inputs.begin())->getSourceNode();
+    const auto scan = dynamic_cast<const RelScan*>(source);
+    if (!scan || !input_to_nest_level.count(source) ||
+        std::any_of(used_inputs.begin(),
+                    used_inputs.end(),
+                    [source](const RexInput* input) {
+                      return input->getSourceNode() != source;
+                    })) {
+      continue;
+    }
+    table_conjuncts[scan].push_back(conjunct);
+  }
+  if (table_conjuncts.empty()) {
+    return {};
+  }
+  std::vector<size_t> table_sizes;
+  for (const auto& query_info : query_infos) {
+    table_sizes.push_back(query_info.info.getNumTuplesUpperBound());
+  }
+  for (const auto& [scan, conjuncts] : table_conjuncts) {
+    const auto td = scan->getTableDescriptor();
+    CHECK(td);
+    const auto nest_level = input_to_nest_level.find(scan)->second;
+    CHECK_LT(static_cast<size_t>(nest_level), table_sizes.size());
+    // Translate the conjuncts as the filter of the table alone
+    const std::unordered_map<const RelAlgNode*, int> table_nest_level{{scan, 0}};
+    RelAlgTranslator translator(
+        cat_, query_state_, executor_, table_nest_level, {JoinType::INNER}, now_, false);
+    std::list<std::shared_ptr<Analyzer::Expr>> simple_quals;
+    std::list<std::shared_ptr<Analyzer::Expr>> quals;
+    std::set<const Analyzer::ColumnVar*,
+             bool (*)(const Analyzer::ColumnVar*, const Analyzer::ColumnVar*)>
+        col_vars(Analyzer::ColumnVar::colvar_comp);
+    try {
+      for (const auto conjunct : conjuncts) {
+        const auto qual = fold_expr(translator.translateScalarRex(conjunct).get());
+        qual->collect_column_var(col_vars, true);
+        const auto qual_cf = qual_to_conjunctive_form(qual);
+        simple_quals.insert(
+            simple_quals.end(), qual_cf.simple_quals.begin(), qual_cf.simple_quals.end());
+        quals.insert(quals.end(), qual_cf.quals.begin(), qual_cf.quals.end());
+      }
+    } catch (const std::exception& e) {
+      VLOG(1) << "Not counting the filtered rows of " << td->tableName << ": "
+              << e.what();
+      continue;
+    }
+    std::list<std::shared_ptr<const InputColDescriptor>> input_col_descs;
+    for (const auto col_var : col_vars) {
+      input_col_descs.push_back(std::make_shared<const InputColDescriptor>(
+          col_var->get_column_id(), td->tableId, 0));
+    }
+    const WorkUnit work_unit{{{InputDescriptor(td->tableId, 0)},
+                              input_col_descs,
+                              simple_quals,
+                              quals,
+                              {},
+                              {},
+                              {},
+                              nullptr,
+                              SortInfo{{}, SortAlgorithm::Default, 0, 0},
+                              0,
+                              false,
+                              std::nullopt,
+                              query_state_},
+                             compound,
+                             0,
+                             nullptr,
+                             {},
+                             {}};
+    // Count on CPU, so as not to move the filtered columns to the GPUs yet
+    const auto filtered_count =
+        getFilteredCountAll(work_unit,
+                            true,
+                            CompilationOptions::defaults(ExecutorDeviceType::CPU),
+                            eo);
+    if (filtered_count >= 0) {
+      VLOG(1) << "Reordering the FROM clause with the " << filtered_count
+              << " rows of " << td->tableName << " which pass its filters";
+      table_sizes[nest_level] = filtered_count;
+    }
+  }
+  return table_sizes;
+}
+
 std::list<std::shared_ptr<Analyzer::Expr>> RelAlgExecutor::makeJoinQuals(
     const RexScalar* join_condition,
     const std::vector<JoinType>& join_types,
@@ -3473,8 +4096,9 @@ JoinQualsPerNestingLevel RelAlgExecutor::translateLeftDeepJoinFilter(
       result[rte_idx - 1].quals =
           makeJoinQuals(outer_condition, join_types, input_to_nest_level, just_explain);
       CHECK_LE(rte_idx, join_types.size());
-      CHECK(join_types[rte_idx - 1] == JoinType::LEFT);
-      result[rte_idx - 1].type = JoinType::LEFT;
+      CHECK(join_types[rte_idx - 1] == JoinType::LEFT ||
+            join_types[rte_idx - 1] == JoinType::SEMI);
+      result[rte_idx - 1].type = join_types[rte_idx - 1];
       continue;
     }
     for (const auto& qual : join_condition_quals) {
@@ -3595,14 +4219,18 @@ RelAlgExecutor::WorkUnit RelAlgExecutor::createProjectWorkUnit(
     const auto query_infos = get_table_infos(input_descs, executor_);
     left_deep_join_quals = translateLeftDeepJoinFilter(
         left_deep_join, input_descs, input_to_nest_level, eo.just_explain);
-    if (g_from_table_reordering) {
+    // the semi join levels stay the innermost ones
+    if (g_from_table_reordering &&
+        std::find(join_types.begin(), join_types.end(), JoinType::SEMI) ==
+            join_types.end()) {
       input_permutation = do_table_reordering(input_descs,
                                               input_col_descs,
                                               left_deep_join_quals,
                                               input_to_nest_level,
                                               project,
                                               query_infos,
-                                              executor_);
+                                              executor_,
+                                              {});
       input_to_nest_level = get_input_nest_levels(project, input_permutation);
       std::tie(input_descs, input_col_descs, std::ignore) =
           get_input_desc(project, input_to_nest_level, input_permutation, cat_);
@@ -3828,7 +4456,8 @@ RelAlgExecutor::TableFunctionWorkUnit RelAlgExecutor::createTableFunctionWorkUni
       input_col_exprs,        // table function column inputs (duplicates w/ above)
       table_func_outputs,     // table function projected exprs
       output_row_multiplier,  // output buffer multiplier
-      table_func->getFunctionName()};
+      table_func->getFunctionName(),
+      table_function_impl.isPartitionable()};
   const auto targets_meta = get_targets_meta(table_func, exe_unit.target_exprs);
   table_func->setOutputMetainfo(targets_meta);
   return {exe_unit, table_func};
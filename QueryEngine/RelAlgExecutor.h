@@ -24,6 +24,7 @@
 #include "QueryEngine/JoinFilterPushDown.h"
 #include "QueryEngine/QueryRewrite.h"
 #include "QueryEngine/RelAlgDagBuilder.h"
+#include "QueryEngine/ResultSetCache.h"
 #include "QueryEngine/SpeculativeTopN.h"
 #include "QueryEngine/StreamingTopN.h"
 #include "Shared/scope.h"
@@ -72,6 +73,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
       : StorageIOFacility(executor, cat)
       , executor_(executor)
       , cat_(cat)
+      , query_ra_(query_ra)
       , query_dag_(std::make_unique<RelAlgDagBuilder>(query_ra, cat_, nullptr))
       , query_state_(std::move(query_state))
       , now_(0)
@@ -96,6 +98,10 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                                      const bool just_explain_plan,
                                      RenderInfo* render_info);
 
+  //! Collects the times, rows and cache hits of the steps and kernels of the query into
+  //! query_profile, for EXPLAIN ANALYZE
+  void setQueryProfile(QueryProfile* query_profile) { query_profile_ = query_profile; }
+
   ExecutionResult executeRelAlgQueryWithFilterPushDown(const RaExecutionSequence& seq,
                                                        const CompilationOptions& co,
                                                        const ExecutionOptions& eo,
@@ -158,6 +164,15 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   static std::string getErrorMessageFromCode(const int32_t error_code);
 
  private:
+  // Whether the result of plan may be taken from and kept in the ResultSetCache
+  bool canUseResultSetCache(const std::string& plan,
+                            const ExecutionOptions& eo,
+                            const RenderInfo* render_info) const;
+
+  // The versions of the tables ra reads, as of the start of the query
+  std::optional<ResultSetCache::Versions> getResultSetCacheVersions(
+      const RelAlgNode* ra) const;
+
   ExecutionResult executeRelAlgQueryNoRetry(const CompilationOptions& co,
                                             const ExecutionOptions& eo,
                                             const bool just_explain_plan,
@@ -170,6 +185,15 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                          RenderInfo*,
                          const int64_t queue_time_ms);
 
+  // Executes the independent UNION ALL branches starting at step_idx concurrently.
+  // Returns the number of steps executed, 0 if step_idx isn't such a branch.
+  size_t executeUnionBranchesInParallel(const RaExecutionSequence& seq,
+                                        const size_t step_idx,
+                                        const size_t step_count,
+                                        const CompilationOptions&,
+                                        const ExecutionOptions&,
+                                        const int64_t queue_time_ms);
+
   void executeUpdate(const RelAlgNode* node,
                      const CompilationOptions& co,
                      const ExecutionOptions& eo,
@@ -209,12 +233,20 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                      const CompilationOptions& co,
                      const ExecutionOptions& eo,
                      ColumnCacheMap& column_cache_map,
-                     const int64_t queue_time_ms);
+                     const int64_t queue_time_ms,
+                     const bool gpu_requested);
+
+  // Builds the hash table of the partitions of a window function.
+  std::shared_ptr<JoinHashTableInterface> buildWindowFunctionPartitions(
+      const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
+      const std::vector<InputTableInfo>& query_infos,
+      const CompilationOptions& co,
+      ColumnCacheMap& column_cache_map);
 
   // Creates the window context for the given window function.
   std::unique_ptr<WindowFunctionContext> createWindowFunctionContext(
       const Analyzer::WindowFunction* window_func,
-      const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
+      const std::shared_ptr<JoinHashTableInterface>& partitions,
       const RelAlgExecutionUnit& ra_exe_unit,
       const std::vector<InputTableInfo>& query_infos,
       const CompilationOptions& co,
@@ -282,6 +314,14 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                               const CompilationOptions& co,
                               const ExecutionOptions& eo);
 
+  // The row counts of the tables joined by compound which pass their filters, by nest
+  // level, or empty if the filter of compound doesn't reference a table on its own
+  std::vector<size_t> getFilteredTableSizes(
+      const RelCompound* compound,
+      const std::unordered_map<const RelAlgNode*, int>& input_to_nest_level,
+      const std::vector<InputTableInfo>& query_infos,
+      const ExecutionOptions& eo);
+
   FilterSelectivity getFilterSelectivity(
       const std::vector<std::shared_ptr<Analyzer::Expr>>& filter_expressions,
       const CompilationOptions& co,
@@ -361,6 +401,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
 
   Executor* executor_;
   const Catalog_Namespace::Catalog& cat_;
+  const std::string query_ra_;  // the plan of query_dag_, if built from one
   std::unique_ptr<RelAlgDagBuilder> query_dag_;
   std::shared_ptr<const query_state::QueryState> query_state_;
   TemporaryTables temporary_tables_;
@@ -368,6 +409,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
   std::vector<std::shared_ptr<Analyzer::Expr>> target_exprs_owned_;  // TODO(alex): remove
   std::unordered_map<unsigned, AggregatedResult> leaf_results_;
   int64_t queue_time_ms_;
+  QueryProfile* query_profile_{nullptr};
   static SpeculativeTopNBlacklist speculative_topn_blacklist_;
   static const size_t max_groups_buffer_entry_default_guess{16384};
 
@@ -230,17 +230,17 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
   const bool is_distinct = rex->isDistinct();
   const bool takes_arg{rex->size() > 0};
   std::shared_ptr<Analyzer::Expr> arg_expr;
-  std::shared_ptr<Analyzer::Constant> err_rate;
+  std::shared_ptr<Analyzer::Constant> arg1;
   if (takes_arg) {
     const auto operand = rex->getOperand(0);
     CHECK_LT(operand, scalar_sources.size());
     CHECK_LE(rex->size(), 2u);
     arg_expr = scalar_sources[operand];
     if (agg_kind == kAPPROX_COUNT_DISTINCT && rex->size() == 2) {
-      err_rate = std::dynamic_pointer_cast<Analyzer::Constant>(
+      arg1 = std::dynamic_pointer_cast<Analyzer::Constant>(
           scalar_sources[rex->getOperand(1)]);
-      if (!err_rate || err_rate->get_type_info().get_type() != kINT ||
-          err_rate->get_constval().intval < 1 || err_rate->get_constval().intval > 100) {
+      if (!arg1 || arg1->get_type_info().get_type() != kINT ||
+          arg1->get_constval().intval < 1 || arg1->get_constval().intval > 100) {
         throw std::runtime_error(
             "APPROX_COUNT_DISTINCT's second parameter should be SMALLINT literal between "
             "1 and 100");
@@ -251,9 +251,39 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateAggregateRex(
       throw std::runtime_error("Aggregate on " + arg_ti.get_type_name() +
                                " is not supported yet.");
     }
+    if (agg_kind == kAPPROX_QUANTILE) {
+      if (!arg_ti.is_number()) {
+        throw std::runtime_error("APPROX_PERCENTILE on " + arg_ti.get_type_name() +
+                                 " is not supported.");
+      }
+      // the t-digest keeps doubles, APPROX_MEDIAN is the 0.5 quantile
+      Datum q;
+      q.doubleval = 0.5;
+      if (rex->size() == 2) {
+        const auto q_expr = std::dynamic_pointer_cast<Analyzer::Constant>(
+            scalar_sources[rex->getOperand(1)]);
+        if (!q_expr || q_expr->get_is_null() || !q_expr->get_type_info().is_number()) {
+          throw std::runtime_error(
+              "APPROX_PERCENTILE's second parameter should be a numeric literal");
+        }
+        const auto q_double =
+            std::dynamic_pointer_cast<Analyzer::Constant>(q_expr->deep_copy()->add_cast(
+                SQLTypeInfo(kDOUBLE, q_expr->get_type_info().get_notnull())));
+        CHECK(q_double);
+        q = q_double->get_constval();
+      }
+      if (!(q.doubleval >= 0 && q.doubleval <= 1)) {
+        throw std::runtime_error(
+            "APPROX_PERCENTILE's second parameter should be between 0 and 1");
+      }
+      arg1 = makeExpr<Analyzer::Constant>(kDOUBLE, false, q);
+      if (arg_ti.get_type() != kDOUBLE) {
+        arg_expr = arg_expr->add_cast(SQLTypeInfo(kDOUBLE, arg_ti.get_notnull()));
+      }
+    }
   }
   const auto agg_ti = get_agg_type(agg_kind, arg_expr.get());
-  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, err_rate);
+  return makeExpr<Analyzer::AggExpr>(agg_ti, agg_kind, arg_expr, is_distinct, arg1);
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateLiteral(
@@ -379,6 +409,10 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateInput(
     if (col_ti.is_string()) {
       col_ti.set_type(kTEXT);
     }
+    if (col_ti.get_compression() == kENCODING_DIFF) {
+      // decoded by the generated code or when fetched, see PlanState
+      col_ti = get_logical_type_info(col_ti);
+    }
     if (cd->isVirtualCol) {
       // TODO(alex): remove at some point, we only need this fixup for backwards
       // compatibility with old imported data
@@ -1569,7 +1603,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateFunction(
                    "ST_Intersection"sv,
                    "ST_Difference"sv,
                    "ST_Union"sv,
-                   "ST_Buffer"sv)) {
+                   "ST_Buffer"sv,
+                   "ST_Simplify"sv)) {
     SQLTypeInfo ti;
     return translateGeoBinaryConstructor(rex_function, ti, false);
   }
@@ -1660,14 +1695,52 @@ bool supported_upper_bound(const RexWindowFunctionOperator* rex_window_function)
   }
 }
 
+// Returns the offset from the current row of the bound of a ROWS frame, negative for the
+// preceding rows, none for the unbounded ones.
+std::optional<int64_t> translate_rows_frame_bound(
+    const RexWindowFunctionOperator::RexWindowBound& window_bound) {
+  if (window_bound.unbounded) {
+    return std::nullopt;
+  }
+  if (window_bound.is_current_row) {
+    return int64_t(0);
+  }
+  const auto offset = dynamic_cast<const RexLiteral*>(window_bound.offset.get());
+  if (!offset ||
+      !(IS_INTEGER(offset->getType()) ||
+        (offset->getType() == kDECIMAL && offset->getScale() == 0))) {
+    throw std::runtime_error("Only integer literals supported as frame offsets for now");
+  }
+  const auto offset_val = offset->getVal<int64_t>();
+  if (offset_val < 0) {
+    throw std::runtime_error("Frame offsets cannot be negative");
+  }
+  CHECK(window_bound.preceding || window_bound.following);
+  return window_bound.preceding ? -offset_val : offset_val;
+}
+
+// Returns the ROWS frame of a window aggregate, none for the other frames.
+std::optional<Analyzer::WindowRowsFrame> translate_rows_frame(
+    const RexWindowFunctionOperator* rex_window_function) {
+  if (!rex_window_function->isRows() ||
+      !window_function_is_aggregate(rex_window_function->getKind())) {
+    return std::nullopt;
+  }
+  return Analyzer::WindowRowsFrame{
+      translate_rows_frame_bound(rex_window_function->getLowerBound()),
+      translate_rows_frame_bound(rex_window_function->getUpperBound())};
+}
+
 }  // namespace
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
     const RexWindowFunctionOperator* rex_window_function) const {
-  if (!supported_lower_bound(rex_window_function->getLowerBound()) ||
-      !supported_upper_bound(rex_window_function) ||
-      ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
-       rex_window_function->isRows())) {
+  const auto rows_frame = translate_rows_frame(rex_window_function);
+  if (!rows_frame &&
+      (!supported_lower_bound(rex_window_function->getLowerBound()) ||
+       !supported_upper_bound(rex_window_function) ||
+       ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
+        rex_window_function->isRows()))) {
     throw std::runtime_error("Frame specification not supported");
   }
   std::vector<std::shared_ptr<Analyzer::Expr>> args;
@@ -1693,7 +1766,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
       args,
       partition_keys,
       order_keys,
-      translate_collation(rex_window_function->getCollation()));
+      translate_collation(rex_window_function->getCollation()),
+      rows_frame);
 }
 
 Analyzer::ExpressionPtrVector RelAlgTranslator::translateFunctionArgs(
@@ -16,6 +16,10 @@
 
 #include "QueryEngine/RelAlgTranslator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -23,6 +27,99 @@
 #include "Shared/geo_compression.h"
 #include "Shared/geo_types.h"
 
+namespace {
+
+// GEOINT32 maps the longitudes from -180..180 and the latitudes from -90..90. The box is
+// compressed outwards, by the tolerance of the geo functions and a unit on top of the
+// rounding, so that no point the functions would take as in the box is left out of it.
+int32_t compress_box_coord(const double coord, const double range, const bool upper) {
+  const double scale = 2147483647.0 / range;
+  const double compressed = upper ? std::ceil((coord + TOLERANCE_DEFAULT) * scale) + 1
+                                  : std::floor((coord - TOLERANCE_DEFAULT) * scale) - 1;
+  return static_cast<int32_t>(std::max<double>(
+      std::numeric_limits<int32_t>::min(),
+      std::min<double>(std::numeric_limits<int32_t>::max(), compressed)));
+}
+
+// A test of the points of a GEOINT32 compressed column against the box of a constant,
+// comparing their compressed coordinates to the box compressed once, ahead of the geo
+// function the box bounds. It's cheap and rejects most rows of a selective filter, so it
+// is marked unlikely for the codegen to evaluate it first and defer the geo function.
+// Null unless the points are compressed and not transformed.
+std::shared_ptr<Analyzer::Expr> make_compressed_point_box_filter(
+    const std::shared_ptr<Analyzer::Expr>& point_coords,
+    const int32_t compression,
+    const int32_t input_srid,
+    const int32_t output_srid,
+    const double xmin,
+    const double ymin,
+    const double xmax,
+    const double ymax) {
+  if (!std::dynamic_pointer_cast<Analyzer::ColumnVar>(point_coords) ||
+      compression != COMPRESSION_GEOINT32 || input_srid != output_srid) {
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<Analyzer::Expr>> args{point_coords};
+  for (const auto compressed : {compress_box_coord(xmin, 180.0, false),
+                                compress_box_coord(ymin, 90.0, false),
+                                compress_box_coord(xmax, 180.0, true),
+                                compress_box_coord(ymax, 90.0, true)}) {
+    Datum d;
+    d.intval = compressed;
+    args.push_back(makeExpr<Analyzer::Constant>(kINT, false, d));
+  }
+  const auto filter = makeExpr<Analyzer::FunctionOper>(
+      SQLTypeInfo(kBOOLEAN, false), "Point_Overlaps_Compressed_Box", args);
+  return makeExpr<Analyzer::LikelihoodExpr>(filter, 0.05);
+}
+
+// The values of a constant array of doubles, e.g. the bounds of a geo literal
+std::vector<double> get_constant_doubles(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null() || !constant->get_type_info().is_array() ||
+      constant->get_type_info().get_subtype() != kDOUBLE) {
+    return {};
+  }
+  std::vector<double> values;
+  for (const auto& value : constant->get_value_list()) {
+    const auto value_constant = dynamic_cast<const Analyzer::Constant*>(value.get());
+    if (!value_constant || value_constant->get_is_null()) {
+      return {};
+    }
+    values.push_back(value_constant->get_constval().doubleval);
+  }
+  return values;
+}
+
+// The coordinates of an uncompressed point literal, an array of their bytes
+std::vector<double> get_constant_point_coords(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  if (!constant || constant->get_is_null() || !constant->get_type_info().is_array() ||
+      constant->get_type_info().get_subtype() != kTINYINT ||
+      constant->get_value_list().size() != 2 * sizeof(double)) {
+    return {};
+  }
+  std::vector<int8_t> bytes;
+  for (const auto& value : constant->get_value_list()) {
+    const auto byte = dynamic_cast<const Analyzer::Constant*>(value.get());
+    if (!byte) {
+      return {};
+    }
+    bytes.push_back(byte->get_constval().tinyintval);
+  }
+  std::vector<double> coords(2);
+  std::memcpy(coords.data(), bytes.data(), bytes.size());
+  return coords;
+}
+
+int32_t get_int_constant(const Analyzer::Expr* expr) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  CHECK(constant);
+  return constant->get_constval().intval;
+}
+
+}  // namespace
+
 std::vector<std::shared_ptr<Analyzer::Expr>> RelAlgTranslator::translateGeoColumn(
     const RexInput* rex_input,
     SQLTypeInfo& ti,
@@ -594,7 +691,8 @@ std::vector<std::shared_ptr<Analyzer::Expr>> RelAlgTranslator::translateGeoFunct
                             "ST_Intersection"sv,
                             "ST_Difference"sv,
                             "ST_Union"sv,
-                            "ST_Buffer"sv)) {
+                            "ST_Buffer"sv,
+                            "ST_Simplify"sv)) {
       CHECK_EQ(size_t(2), rex_function->size());
       // What geo type will the constructor return? Could be anything.
       return {translateGeoBinaryConstructor(rex_function, arg_ti, with_bounds)};
@@ -642,6 +740,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateGeoBinaryConstructor(
     op = Geo_namespace::GeoBase::GeoOp::kUNION;
   } else if (rex_function->getName() == "ST_Buffer"sv) {
     op = Geo_namespace::GeoBase::GeoOp::kBUFFER;
+  } else if (rex_function->getName() == "ST_Simplify"sv) {
+    op = Geo_namespace::GeoBase::GeoOp::kSIMPLIFY;
   }
 
   Analyzer::ExpressionPtrVector geoargs0{};
@@ -652,7 +752,8 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateGeoBinaryConstructor(
                    "ST_Intersection"sv,
                    "ST_Difference"sv,
                    "ST_Union"sv,
-                   "ST_Buffer"sv)) {
+                   "ST_Buffer"sv,
+                   "ST_Simplify"sv)) {
     // First arg: geometry
     int32_t lindex0 = 0;
     geoargs0 = translateGeoFunctionArg(
@@ -678,7 +779,13 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateGeoBinaryConstructor(
             "Indexed LINESTRING geometries not supported in this context");
       }
     }
-  } else if (func_resolve(rex_function->getName(), "ST_Buffer"sv)) {
+  } else if (func_resolve(rex_function->getName(), "ST_Buffer"sv, "ST_Simplify"sv)) {
+    // The constructed geometries are multipolygons, only the polygons get simplified
+    // into one
+    if (rex_function->getName() == "ST_Simplify"sv && !IS_GEO_POLY(arg0_ti.get_type())) {
+      throw QueryNotSupported(rex_function->getName() +
+                              " expects a POLYGON or MULTIPOLYGON");
+    }
     // Second arg: double scalar
     auto param_expr = translateScalarRex(rex_function->getOperand(1));
     arg1_ti = SQLTypeInfo(kDOUBLE, false);
@@ -1058,11 +1165,29 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateBinaryGeoFunction(
   output_srid.intval = arg0_ti.get_output_srid();
   geoargs.push_back(makeExpr<Analyzer::Constant>(kINT, false, output_srid));
 
-  auto result =
+  std::shared_ptr<Analyzer::Expr> result =
       makeExpr<Analyzer::FunctionOper>(return_type, specialized_geofunc, geoargs);
   if (negate_result) {
     return makeExpr<Analyzer::UOper>(kBOOLEAN, kNOT, result);
   }
+  if (with_bounds && IS_GEO_POLY(arg0_ti.get_type()) && arg1_ti.get_type() == kPOINT) {
+    // the bounds of a literal polygon are the last of its args
+    const auto bounds = get_constant_doubles(geoargs0.back().get());
+    if (bounds.size() == 4) {
+      const auto box_filter =
+          make_compressed_point_box_filter(geoargs1.front(),
+                                           input_compression1.intval,
+                                           input_srid1.intval,
+                                           output_srid.intval,
+                                           bounds[0],
+                                           bounds[1],
+                                           bounds[2],
+                                           bounds[3]);
+      if (box_filter) {
+        result = makeExpr<Analyzer::BinOper>(kBOOLEAN, kAND, kONE, box_filter, result);
+      }
+    }
+  }
   return result;
 }
 
@@ -1079,8 +1204,36 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateTernaryGeoFunction(
   // Translate the geo distance function call portion
   const auto geo_distance_expr = translateBinaryGeoFunction(rex_function);
 
+  std::shared_ptr<Analyzer::Expr> box_filter;
   if (rex_function->getName() == "ST_DWithin") {
     auto func_oper = dynamic_cast<Analyzer::FunctionOper*>(geo_distance_expr.get());
+    const auto distance_constant =
+        std::dynamic_pointer_cast<Analyzer::Constant>(distance_expr);
+    if (func_oper && func_oper->getName() == "ST_Distance_Point_Point_Squared"sv &&
+        distance_constant && !distance_constant->get_is_null() &&
+        distance_constant->get_type_info().get_type() == kDOUBLE) {
+      // a point column within a distance of a point literal, args (p0, p1, ic0, isr0,
+      // ic1, isr1, osr)
+      CHECK_EQ(size_t(7), func_oper->getArity());
+      const auto distance = distance_constant->get_constval().doubleval;
+      const auto osr = get_int_constant(func_oper->getArg(6));
+      for (size_t i = 0; i < 2 && !box_filter && distance >= 0; ++i) {
+        const auto center = get_constant_point_coords(func_oper->getArg(1 - i));
+        if (center.empty() ||
+            get_int_constant(func_oper->getArg(4 - 2 * i)) != COMPRESSION_NONE) {
+          continue;
+        }
+        box_filter = make_compressed_point_box_filter(
+            func_oper->getOwnArg(i),
+            get_int_constant(func_oper->getArg(2 + 2 * i)),
+            get_int_constant(func_oper->getArg(3 + 2 * i)),
+            osr,
+            center[0] - distance,
+            center[1] - distance,
+            center[0] + distance,
+            center[1] + distance);
+      }
+    }
     if (func_oper && func_oper->getName() == "ST_Distance_Point_Point_Squared"sv) {
       // Point_Point combination will yield geo_distance squared which is faster,
       // need to compare it with distance squared
@@ -1094,8 +1247,12 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateTernaryGeoFunction(
     }
   }
 
-  return makeExpr<Analyzer::BinOper>(
-      kBOOLEAN, kLE, kONE, geo_distance_expr, distance_expr);
+  std::shared_ptr<Analyzer::Expr> result =
+      makeExpr<Analyzer::BinOper>(kBOOLEAN, kLE, kONE, geo_distance_expr, distance_expr);
+  if (box_filter) {
+    result = makeExpr<Analyzer::BinOper>(kBOOLEAN, kAND, kONE, box_filter, result);
+  }
+  return result;
 }
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateGeoComparison(
@@ -51,7 +51,8 @@ RelLeftDeepInnerJoin::RelLeftDeepInnerJoin(
           }
           break;
         }
-        case JoinType::LEFT: {
+        case JoinType::LEFT:
+        case JoinType::SEMI: {
           if (original_join->getCondition()) {
             outer_conditions_per_level_[nesting_level].reset(
                 original_join->getAndReleaseCondition());
@@ -100,6 +101,12 @@ const RexScalar* RelLeftDeepInnerJoin::getOuterCondition(
       .get();
 }
 
+JoinType RelLeftDeepInnerJoin::getJoinType(const size_t nesting_level) const {
+  CHECK_GE(nesting_level, size_t(1));
+  CHECK_LE(nesting_level, original_joins_.size());
+  return original_joins_[original_joins_.size() - nesting_level]->getJoinType();
+}
+
 std::string RelLeftDeepInnerJoin::toString() const {
   std::string result =
       "(RelLeftDeepInnerJoin<" + std::to_string(reinterpret_cast<uint64_t>(this)) + ">(";
@@ -229,7 +236,13 @@ std::shared_ptr<const RelAlgNode> get_left_deep_join_root(
     if (!join) {
       return nullptr;
     }
-    if (join->getJoinType() == JoinType::INNER) {
+    // The qualifiers of a filter over semi joins only reference the inputs of the join
+    // under them, the filter starts the pattern if that one is an inner join.
+    auto inner_join = join;
+    while (inner_join && inner_join->getJoinType() == JoinType::SEMI) {
+      inner_join = dynamic_cast<const RelJoin*>(inner_join->getInput(0));
+    }
+    if (inner_join && inner_join->getJoinType() == JoinType::INNER) {
       return node;
     }
   }
@@ -36,20 +36,46 @@
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
 #include "Shared/threadpool.h"
+#include "TDigest.h"
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <future>
 #include <numeric>
 
 extern bool g_use_tbb_pool;
+extern bool g_enable_dynamic_watchdog;
+extern bool g_enable_runtime_query_interrupt;
+
+namespace {
+
+using EntryComparator = std::function<bool(const uint32_t, const uint32_t)>;
+
+// Checks whether the query was interrupted every 64K comparisons of a sorting thread,
+// so that an interrupted query doesn't finish the sort of a large result
+EntryComparator make_interruptible(EntryComparator compare) {
+  if (!g_enable_dynamic_watchdog && !g_enable_runtime_query_interrupt) {
+    return compare;
+  }
+  return [compare = std::move(compare)](const uint32_t lhs, const uint32_t rhs) {
+    thread_local uint32_t comparison_count{0};
+    if (UNLIKELY((++comparison_count & 0xFFFF) == 0 && Executor::isInterrupted())) {
+      throw std::runtime_error("Query execution has been interrupted");
+    }
+    return compare(lhs, rhs);
+  };
+}
+
+}  // namespace
 
 std::vector<int64_t> initialize_target_values_for_storage(
     const std::vector<TargetInfo>& targets) {
   std::vector<int64_t> target_init_vals;
   for (const auto& target_info : targets) {
     if (target_info.agg_kind == kCOUNT ||
-        target_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
+        target_info.agg_kind == kAPPROX_COUNT_DISTINCT ||
+        target_info.agg_kind == kAPPROX_QUANTILE) {
       target_init_vals.push_back(0);
       continue;
     }
@@ -91,6 +117,49 @@ int8_t* ResultSetStorage::getUnderlyingBuffer() const {
   return buff_;
 }
 
+void ResultSet::finalizeApproxQuantiles() {
+  if (approx_quantiles_finalized_) {
+    return;
+  }
+  approx_quantiles_finalized_ = true;
+  std::vector<size_t> slot_idxs;
+  for (size_t target_idx = 0; target_idx < targets_.size(); ++target_idx) {
+    if (targets_[target_idx].is_agg &&
+        targets_[target_idx].agg_kind == kAPPROX_QUANTILE) {
+      slot_idxs.push_back(query_mem_desc_.getSlotIndexForSingleSlotCol(target_idx));
+    }
+  }
+  if (slot_idxs.empty()) {
+    return;
+  }
+  CHECK(!query_mem_desc_.didOutputColumnar());
+  auto finalize_storage = [&slot_idxs](ResultSetStorage* storage) {
+    const auto& query_mem_desc = storage->query_mem_desc_;
+    for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+      if (storage->isEmptyEntry(entry_idx)) {
+        continue;
+      }
+      auto row_ptr = storage->buff_ + entry_idx * query_mem_desc.getRowSize();
+      for (const auto slot_idx : slot_idxs) {
+        CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(slot_idx)),
+                 sizeof(int64_t));
+        auto slot_ptr = reinterpret_cast<int64_t*>(
+            row_ptr + query_mem_desc.getColOffInBytes(slot_idx));
+        auto t_digest = reinterpret_cast<TDigest*>(*slot_ptr);
+        const double quantile =
+            t_digest && !t_digest->empty() ? t_digest->quantile() : NULL_DOUBLE;
+        *slot_ptr = *reinterpret_cast<const int64_t*>(may_alias_ptr(&quantile));
+      }
+    }
+  };
+  if (storage_) {
+    finalize_storage(storage_.get());
+  }
+  for (auto& storage : appended_storage_) {
+    finalize_storage(storage.get());
+  }
+}
+
 void ResultSet::keepFirstN(const size_t n) {
   CHECK_EQ(-1, cached_row_count_);
   keep_first_ = n;
@@ -277,6 +346,13 @@ void ResultSet::append(ResultSet& that) {
       query_mem_desc_.getEntryCount() +
       appended_storage_.back()->query_mem_desc_.getEntryCount());
   chunks_.insert(chunks_.end(), that.chunks_.begin(), that.chunks_.end());
+  if (!deferred_chunks_.empty() || !that.deferred_chunks_.empty()) {
+    deferred_chunks_.resize(col_buffers_.size());
+    that.deferred_chunks_.resize(that.col_buffers_.size());
+    deferred_chunks_.insert(deferred_chunks_.end(),
+                            that.deferred_chunks_.begin(),
+                            that.deferred_chunks_.end());
+  }
   col_buffers_.insert(
       col_buffers_.end(), that.col_buffers_.begin(), that.col_buffers_.end());
   frag_offsets_.insert(
@@ -297,6 +373,75 @@ void ResultSet::append(ResultSet& that) {
   }
 }
 
+void ResultSet::deferChunks(
+    Data_Namespace::DataMgr* data_mgr,
+    const std::vector<std::vector<DeferredColumnChunk>>& deferred_chunks) {
+  CHECK(data_mgr);
+  // the storages of a kernel on the GPU all have the column buffers of its fragments
+  deferred_chunks_.resize(col_buffers_.size());
+  for (size_t storage_idx = 0; storage_idx < col_buffers_.size(); ++storage_idx) {
+    CHECK_EQ(col_buffers_[storage_idx].size(), deferred_chunks.size());
+    auto& frag_deferred_chunks = deferred_chunks_[storage_idx];
+    frag_deferred_chunks.clear();
+    for (const auto& chunks : deferred_chunks) {
+      if (chunks.empty()) {
+        frag_deferred_chunks.emplace_back();
+        continue;
+      }
+      auto frag_chunks = std::make_shared<DeferredChunks>();
+      frag_chunks->data_mgr = data_mgr;
+      frag_chunks->chunks = chunks;
+      frag_deferred_chunks.push_back(std::move(frag_chunks));
+    }
+  }
+}
+
+std::shared_ptr<ResultSet> ResultSet::copy(const Executor* executor) const {
+  if (!storage_ || !row_set_mem_owner_ || just_explain_ || estimator_ ||
+      separate_varlen_storage_valid_ || !chunks_.empty() || !literal_buffers_.empty()) {
+    return nullptr;
+  }
+  if (std::any_of(
+          lazy_fetch_info_.begin(),
+          lazy_fetch_info_.end(),
+          [](const ColumnLazyFetchInfo& info) { return info.is_lazily_fetched; })) {
+    return nullptr;
+  }
+  for (const auto& target : targets_) {
+    // count distinct and not yet finalized quantile targets point to memory of the query
+    if (target.sql_type.is_varlen() || (target.is_agg && is_distinct_target(target)) ||
+        (target.is_agg && target.agg_kind == kAPPROX_QUANTILE &&
+         !approx_quantiles_finalized_)) {
+      return nullptr;
+    }
+  }
+  auto copied = std::make_shared<ResultSet>(targets_,
+                                            device_type_,
+                                            query_mem_desc_,
+                                            row_set_mem_owner_->cloneStrDictDataOnly(),
+                                            executor);
+  auto copy_storage = [&copied](const ResultSetStorage& storage) {
+    const auto bytes = storage.query_mem_desc_.getBufferSizeBytes(copied->device_type_);
+    auto buff = copied->row_set_mem_owner_->allocate(bytes);
+    std::memcpy(buff, storage.buff_, bytes);
+    auto copied_storage = std::make_unique<ResultSetStorage>(
+        storage.targets_, storage.query_mem_desc_, buff, /*buff_is_provided=*/true);
+    copied_storage->target_init_vals_ = storage.target_init_vals_;
+    return copied_storage;
+  };
+  copied->storage_ = copy_storage(*storage_);
+  for (const auto& storage : appended_storage_) {
+    copied->appended_storage_.push_back(copy_storage(*storage));
+  }
+  copied->drop_first_ = drop_first_;
+  copied->keep_first_ = keep_first_;
+  copied->permutation_ = permutation_;
+  copied->approx_quantiles_finalized_ = approx_quantiles_finalized_;
+  copied->geo_return_type_ = geo_return_type_;
+  copied->cached_row_count_ = cached_row_count_.load();
+  return copied;
+}
+
 const ResultSetStorage* ResultSet::getStorage() const {
   return storage_.get();
 }
@@ -567,7 +712,7 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
 
   permutation_ = initPermutationBuffer(0, 1);
 
-  auto compare = createComparator(order_entries, use_heap);
+  auto compare = make_interruptible(createComparator(order_entries, use_heap));
 
   if (use_heap) {
     topPermutation(permutation_, top_n, compare);
@@ -600,7 +745,11 @@ std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start,
   std::vector<uint32_t> permutation;
   const auto total_entries = query_mem_desc_.getEntryCount();
   permutation.reserve(total_entries / step);
+  size_t visited_entries{0};
   for (size_t i = start; i < total_entries; i += step) {
+    if (UNLIKELY((visited_entries++ & 0xFFFF) == 0 && Executor::isInterrupted())) {
+      throw std::runtime_error("Query execution has been interrupted");
+    }
     const auto storage_lookup_result = findStorage(i);
     const auto lhs_storage = storage_lookup_result.storage_ptr;
     const auto off = storage_lookup_result.fixedup_entry_idx;
@@ -634,7 +783,7 @@ void ResultSet::parallelTop(const std::list<Analyzer::OrderEntry>& order_entries
   for (auto& init_future : init_futures) {
     init_future.get();
   }
-  auto compare = createComparator(order_entries, true);
+  auto compare = make_interruptible(createComparator(order_entries, true));
   std::vector<std::future<void>> top_futures;
   for (auto& strided_permutation : strided_permutations) {
     top_futures.emplace_back(
@@ -745,6 +894,119 @@ ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeCountDistinctCo
   return count_distinct_materialized_buffer;
 }
 
+namespace {
+
+// Maps the integers to unsigned ones in the same order
+inline uint64_t normalize_int_key(const int64_t val) {
+  return static_cast<uint64_t>(val) ^ (uint64_t(1) << 63);
+}
+
+// Maps the doubles to unsigned integers in the same order, the negative ones have their
+// bits flipped and the positive ones their sign bit set
+inline uint64_t normalize_fp_key(const double val) {
+  const double dval = val == 0 ? 0. : val;  // -0 == 0
+  const auto bits = *reinterpret_cast<const uint64_t*>(may_alias_ptr(&dval));
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+}  // namespace
+
+template <typename BUFFER_ITERATOR_TYPE>
+bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::isFloatArgumentInput(
+    const Analyzer::OrderEntry& order_entry) const {
+  const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
+  const auto entry_ti = get_compact_type(agg_info);
+  bool float_argument_input = takes_float_argument(agg_info);
+  // Need to determine if the float value has been stored as float
+  // or if it has been compacted to a different (often larger 8 bytes)
+  // in distributed case the floats are actually 4 bytes
+  // TODO the above takes_float_argument() is widely used wonder if this problem
+  // exists elsewhere
+  if (entry_ti.get_type() == kFLOAT) {
+    const auto is_col_lazy =
+        !result_set_->lazy_fetch_info_.empty() &&
+        result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
+    if (result_set_->query_mem_desc_.getPaddedSlotWidthBytes(order_entry.tle_no - 1) ==
+        sizeof(float)) {
+      float_argument_input =
+          result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
+    }
+  }
+  return float_argument_input;
+}
+
+// Reads the order entries of the numeric, boolean and time targets once, so that the
+// comparisons are on plain integers instead of the target values of both entries
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::materializeNormalizedKeys() {
+  const size_t num_non_empty_entries = result_set_->permutation_.size();
+  for (const auto& order_entry : order_entries_) {
+    normalized_keys_.emplace_back();
+    normalized_key_nulls_.emplace_back();
+    const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
+    const auto entry_ti = get_compact_type(agg_info);
+    if (!num_non_empty_entries || is_distinct_target(agg_info) ||
+        !(entry_ti.is_number() || entry_ti.is_boolean() || entry_ti.is_time())) {
+      continue;
+    }
+    const bool float_argument_input = isFloatArgumentInput(order_entry);
+    const bool use_desc_cmp = use_heap_ ? !order_entry.is_desc : order_entry.is_desc;
+    auto& keys = normalized_keys_.back();
+    auto& nulls = normalized_key_nulls_.back();
+    keys.resize(result_set_->query_mem_desc_.getEntryCount());
+    nulls.resize(keys.size());
+    const size_t worker_count = cpu_threads();
+    threadpool::FuturesThreadPool<void> thread_pool;
+    for (size_t i = 0,
+                start_entry = 0,
+                stride = (num_non_empty_entries + worker_count - 1) / worker_count;
+         i < worker_count && start_entry < num_non_empty_entries;
+         ++i, start_entry += stride) {
+      const auto end_entry = std::min(start_entry + stride, num_non_empty_entries);
+      thread_pool.spawn(
+          [this, &order_entry, &entry_ti, &keys, &nulls](const size_t start,
+                                                         const size_t end,
+                                                         const bool float_argument_input,
+                                                         const bool use_desc_cmp) {
+            for (size_t i = start; i < end; ++i) {
+              const uint32_t permuted_idx = result_set_->permutation_[i];
+              const auto storage_lookup_result = result_set_->findStorage(permuted_idx);
+              const auto storage = storage_lookup_result.storage_ptr;
+              const auto off = storage_lookup_result.fixedup_entry_idx;
+              const auto value = buffer_itr_.getColumnInternal(
+                  storage->buff_, off, order_entry.tle_no - 1, storage_lookup_result);
+              if (isNull(entry_ti, value, float_argument_input)) {
+                nulls[permuted_idx] = 1;
+                continue;
+              }
+              uint64_t key{0};
+              if (value.isPair()) {
+                key = normalize_fp_key(
+                    pair_to_double({value.i1, value.i2}, entry_ti, float_argument_input));
+              } else {
+                CHECK(value.isInt());
+                if (!entry_ti.is_fp()) {
+                  key = normalize_int_key(value.i1);
+                } else if (float_argument_input) {
+                  key = normalize_fp_key(
+                      *reinterpret_cast<const float*>(may_alias_ptr(&value.i1)));
+                } else {
+                  key = normalize_fp_key(
+                      *reinterpret_cast<const double*>(may_alias_ptr(&value.i1)));
+                }
+              }
+              keys[permuted_idx] = use_desc_cmp ? ~key : key;
+            }
+          },
+          start_entry,
+          end_entry,
+          float_argument_input,
+          use_desc_cmp);
+    }
+    thread_pool.join();
+  }
+}
+
 template <typename BUFFER_ITERATOR_TYPE>
 bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
     const uint32_t lhs,
@@ -758,28 +1020,31 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
   const auto fixedup_lhs = lhs_storage_lookup_result.fixedup_entry_idx;
   const auto fixedup_rhs = rhs_storage_lookup_result.fixedup_entry_idx;
   size_t materialized_count_distinct_buffer_idx{0};
+  size_t order_entry_idx{0};
 
   for (const auto& order_entry : order_entries_) {
     CHECK_GE(order_entry.tle_no, 1);
-    const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
-    const auto entry_ti = get_compact_type(agg_info);
-    bool float_argument_input = takes_float_argument(agg_info);
-    // Need to determine if the float value has been stored as float
-    // or if it has been compacted to a different (often larger 8 bytes)
-    // in distributed case the floats are actually 4 bytes
-    // TODO the above takes_float_argument() is widely used wonder if this problem
-    // exists elsewhere
-    if (entry_ti.get_type() == kFLOAT) {
-      const auto is_col_lazy =
-          !result_set_->lazy_fetch_info_.empty() &&
-          result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
-      if (result_set_->query_mem_desc_.getPaddedSlotWidthBytes(order_entry.tle_no - 1) ==
-          sizeof(float)) {
-        float_argument_input =
-            result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
+    const auto& keys = normalized_keys_[order_entry_idx];
+    const auto& nulls = normalized_key_nulls_[order_entry_idx];
+    ++order_entry_idx;
+    if (!keys.empty()) {
+      if (UNLIKELY(nulls[lhs] && nulls[rhs])) {
+        return false;
+      }
+      if (UNLIKELY(nulls[lhs])) {
+        return use_heap_ ? !order_entry.nulls_first : order_entry.nulls_first;
       }
+      if (UNLIKELY(nulls[rhs])) {
+        return use_heap_ ? order_entry.nulls_first : !order_entry.nulls_first;
+      }
+      if (keys[lhs] == keys[rhs]) {
+        continue;
+      }
+      return keys[lhs] < keys[rhs];
     }
-
+    const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
+    const auto entry_ti = get_compact_type(agg_info);
+    const bool float_argument_input = isFloatArgumentInput(order_entry);
     const bool use_desc_cmp = use_heap_ ? !order_entry.is_desc : order_entry.is_desc;
 
     if (UNLIKELY(is_distinct_target(agg_info))) {
@@ -894,7 +1159,54 @@ void ResultSet::topPermutation(
 void ResultSet::sortPermutation(
     const std::function<bool(const uint32_t, const uint32_t)> compare) {
   auto timer = DEBUG_TIMER(__func__);
-  std::sort(permutation_.begin(), permutation_.end(), compare);
+  const size_t worker_count = cpu_threads();
+  if (permutation_.size() <= 100000 || worker_count <= 1) {
+    std::sort(permutation_.begin(), permutation_.end(), compare);
+    return;
+  }
+  // sort a run by thread, then merge the runs by pairs until there is one left
+  const size_t stride = (permutation_.size() + worker_count - 1) / worker_count;
+  std::vector<size_t> run_bounds;
+  for (size_t start = 0; start < permutation_.size(); start += stride) {
+    run_bounds.push_back(start);
+  }
+  run_bounds.push_back(permutation_.size());
+  std::vector<std::future<void>> sort_futures;
+  for (size_t i = 0; i + 1 < run_bounds.size(); ++i) {
+    sort_futures.emplace_back(std::async(std::launch::async, [&, i] {
+      std::sort(permutation_.begin() + run_bounds[i],
+                permutation_.begin() + run_bounds[i + 1],
+                compare);
+    }));
+  }
+  for (auto& sort_future : sort_futures) {
+    sort_future.get();
+  }
+  std::vector<uint32_t> merged(permutation_.size());
+  while (run_bounds.size() > 2) {
+    std::vector<size_t> merged_bounds;
+    std::vector<std::future<void>> merge_futures;
+    for (size_t i = 0; i + 1 < run_bounds.size(); i += 2) {
+      merged_bounds.push_back(run_bounds[i]);
+      const auto mid = run_bounds[i + 1];
+      const auto end = i + 2 < run_bounds.size() ? run_bounds[i + 2] : mid;
+      merge_futures.emplace_back(
+          std::async(std::launch::async, [&, start = run_bounds[i], mid, end] {
+            std::merge(permutation_.begin() + start,
+                       permutation_.begin() + mid,
+                       permutation_.begin() + mid,
+                       permutation_.begin() + end,
+                       merged.begin() + start,
+                       compare);
+          }));
+    }
+    merged_bounds.push_back(permutation_.size());
+    for (auto& merge_future : merge_futures) {
+      merge_future.get();
+    }
+    permutation_.swap(merged);
+    run_bounds.swap(merged_bounds);
+  }
 }
 
 void ResultSet::radixSortOnGpu(
@@ -1026,6 +1338,11 @@ bool ResultSet::isDirectColumnarConversionPossible() const {
                                      query_mem_desc_.getQueryDescriptionType() ==
                                          QueryDescriptionType::GroupByBaselineHash));
   } else {
+    // the row-wise projections are compacted like the group by buffers, reading their
+    // entries from the storage they are in; their limits are applied by the iterators
+    if (query_mem_desc_.getQueryDescriptionType() == QueryDescriptionType::Projection) {
+      return permutation_.empty() && !drop_first_ && !keep_first_;
+    }
     return permutation_.empty() && (query_mem_desc_.getQueryDescriptionType() ==
                                         QueryDescriptionType::GroupByPerfectHash ||
                                     query_mem_desc_.getQueryDescriptionType() ==
@@ -1074,12 +1391,28 @@ std::tuple<std::vector<bool>, size_t> ResultSet::getSupportedSingleSlotTargetBit
     const {
   CHECK(isDirectColumnarConversionPossible());
   auto [single_slot_targets, num_single_slot_targets] = getSingleSlotTargetBitmap();
+  const bool is_row_wise_projection =
+      query_mem_desc_.getQueryDescriptionType() == QueryDescriptionType::Projection &&
+      !query_mem_desc_.didOutputColumnar();
+  const auto slot_idx_per_target_idx = getSlotIndicesForTargetIndices();
+
+  // the lazily fetched columns, the dates in days and the floating point values which
+  // don't have slots of their size need the decoding of the iterators in projections
+  const auto is_decoded_projection_target = [&](const size_t target_idx) {
+    const auto& sql_type = targets_[target_idx].sql_type;
+    const auto slot_width =
+        query_mem_desc_.getPaddedSlotWidthBytes(slot_idx_per_target_idx[target_idx]);
+    return (!lazy_fetch_info_.empty() && lazy_fetch_info_[target_idx].is_lazily_fetched) ||
+           sql_type.is_date_in_days() ||
+           (sql_type.is_fp() && slot_width != sql_type.get_size());
+  };
 
   for (size_t target_idx = 0; target_idx < single_slot_targets.size(); target_idx++) {
     const auto& target = targets_[target_idx];
     if (single_slot_targets[target_idx] &&
         (is_distinct_target(target) ||
-         (target.is_agg && target.agg_kind == kSAMPLE && target.sql_type == kFLOAT))) {
+         (target.is_agg && target.agg_kind == kSAMPLE && target.sql_type == kFLOAT) ||
+         (is_row_wise_projection && is_decoded_projection_target(target_idx)))) {
       single_slot_targets[target_idx] = false;
       num_single_slot_targets--;
     }
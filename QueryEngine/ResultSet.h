@@ -26,6 +26,7 @@
 #define QUERYENGINE_RESULTSET_H
 
 #include "CardinalityEstimator.h"
+#include "DataMgr/Allocators/DeviceMemoryUsageTracker.h"
 #include "DataMgr/Chunk/Chunk.h"
 #include "ResultSetBufferAccessors.h"
 #include "TargetValue.h"
@@ -33,6 +34,7 @@
 #include <atomic>
 #include <functional>
 #include <list>
+#include <mutex>
 
 /*
  * Stores the underlying buffer and the meta-data for a result set. The buffer
@@ -88,6 +90,13 @@ class ResultSetStorage {
               const std::vector<std::string>& serialized_varlen_buffer,
               const ReductionCode& reduction_code) const;
 
+  void reduce(const std::vector<const ResultSetStorage*>& those,
+              const ReductionCode& reduction_code) const;
+
+  // Reduces the entries of several result sets into this baseline hash buffer at once
+  void reducePartitioned(const std::vector<const ResultSetStorage*>& those,
+                         const ReductionCode& reduction_code) const;
+
   void rewriteAggregateBufferOffsets(
       const std::vector<std::string>& serialized_varlen_buffer) const;
 
@@ -95,6 +104,8 @@ class ResultSetStorage {
 
   size_t getEntryCount() const { return query_mem_desc_.getEntryCount(); }
 
+  size_t getNonEmptyEntryCount() const;
+
   template <class KeyType>
   void moveEntriesToBuffer(int8_t* new_buff, const size_t new_entry_count) const;
 
@@ -236,6 +247,16 @@ struct ColumnLazyFetchInfo {
   const SQLTypeInfo type;
 };
 
+//! The chunk of a lazily fetched column the kernel didn't read, only fetched once the
+//! results read a row of its fragment
+struct DeferredColumnChunk {
+  int local_col_id;
+  const ColumnDescriptor* cd;
+  ChunkKey chunk_key;
+  size_t num_bytes;
+  size_t num_elements;
+};
+
 struct OneIntegerColumnRow {
   const int64_t value;
   const bool valid;
@@ -389,6 +410,11 @@ class ResultSet {
       const size_t index,
       const std::vector<bool>& targets_to_skip = {}) const;
 
+  // The entry at index as getNextRow(true, decimal_to_double) returns it, without
+  // moving the cursor, so that ranges of entries can be read in parallel
+  std::vector<TargetValue> getRowAtWithTranslations(const size_t index,
+                                                    const bool decimal_to_double) const;
+
   bool isRowAtEmpty(const size_t index) const;
 
   void sort(const std::list<Analyzer::OrderEntry>& order_entries, const size_t top_n);
@@ -397,8 +423,18 @@ class ResultSet {
 
   void dropFirstN(const size_t n);
 
+  // Replaces the t-digests of the APPROX_PERCENTILE targets by their quantiles, once the
+  // results are reduced
+  void finalizeApproxQuantiles();
+
   void append(ResultSet& that);
 
+  // A copy of the rows for executor, in memory of its own which only shares the string
+  // dictionary proxies of this result set. Null unless all the rows are in the buffers of
+  // the result set, i.e. without lazily fetched columns, variable length or count
+  // distinct targets.
+  std::shared_ptr<ResultSet> copy(const Executor* executor) const;
+
   const ResultSetStorage* getStorage() const;
 
   size_t colCount() const;
@@ -444,6 +480,12 @@ class ResultSet {
   int64_t getQueueTime() const;
   int64_t getRenderTime() const;
 
+  void setGpuMemoryUsage(const DeviceMemoryUsage& gpu_memory_usage) {
+    gpu_memory_usage_ = gpu_memory_usage;
+  }
+  // Peak GPU memory used by the query which produced this result, by purpose
+  const DeviceMemoryUsage& getGpuMemoryUsage() const { return gpu_memory_usage_; }
+
   void moveToBegin() const;
 
   bool isTruncated() const;
@@ -475,6 +517,9 @@ class ResultSet {
   void holdChunkIterators(const std::shared_ptr<std::list<ChunkIter>> chunk_iters) {
     chunk_iters_.push_back(chunk_iters);
   }
+  //! By fragment, the chunks of the lazily fetched columns the kernel left to be fetched
+  void deferChunks(Data_Namespace::DataMgr* data_mgr,
+                   const std::vector<std::vector<DeferredColumnChunk>>& deferred_chunks);
   void holdLiterals(std::vector<int8_t>& literal_buff) {
     literal_buffers_.push_back(std::move(literal_buff));
   }
@@ -486,10 +531,17 @@ class ResultSet {
   const std::vector<uint32_t>& getPermutationBuffer() const;
   const bool isPermutationBufferEmpty() const { return permutation_.empty(); };
 
+  // The buffers of the results as the leaves ship them to the aggregator. The results
+  // of lazily fetched columns and of none encoded strings, arrays and geo aren't
+  // supported, and neither are the permutation and the limit of sorted results.
   void serialize(TSerializedRows& serialized_rows) const;
 
-  static std::unique_ptr<ResultSet> unserialize(const TSerializedRows& serialized_rows,
-                                                const Executor*);
+  // The results of the serialized rows in the memory of row_set_mem_owner, which has to
+  // be the one of the other results they are reduced with
+  static std::unique_ptr<ResultSet> unserialize(
+      const TSerializedRows& serialized_rows,
+      const Executor*,
+      const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner);
 
   size_t getLimit() const;
 
@@ -550,9 +602,29 @@ class ResultSet {
                         const size_t target_idx,
                         const size_t slot_idx) const;
 
+  // True if getColumnValues can read the target straight from the storage
+  bool isTypedColumnAccessPossible(const size_t target_idx) const;
+
+  // Appends the values of the target in the non-empty entries of [first_entry, end_entry)
+  // to values, read a column at a time from the storage instead of boxed in the rows of
+  // getRowAtNoTranslations, with the same values. The integers, the times and the
+  // dictionary ids come as int64_t, the floating point values as their own type.
+  template <typename T>
+  void getColumnValues(const size_t target_idx,
+                       const size_t first_entry,
+                       const size_t end_entry,
+                       std::vector<T>& values) const;
+
  private:
   void advanceCursorToNextEntry(ResultSetRowIterator& iter) const;
 
+  template <typename ENTRY_TYPE, typename T>
+  void getColumnValuesImpl(const size_t target_idx,
+                           const size_t slot_idx,
+                           const size_t first_entry,
+                           const size_t end_entry,
+                           std::vector<T>& values) const;
+
   std::vector<TargetValue> getNextRowImpl(const bool translate_strings,
                                           const bool decimal_to_double) const;
 
@@ -576,6 +648,11 @@ class ResultSet {
                                           const size_t target_idx,
                                           const size_t slot_idx) const;
 
+  template <typename ENTRY_TYPE>
+  ENTRY_TYPE getRowWiseProjectionEntryAt(const size_t row_idx,
+                                         const size_t target_idx,
+                                         const size_t slot_idx) const;
+
   template <typename ENTRY_TYPE>
   ENTRY_TYPE getRowWiseBaselineEntryAt(const size_t row_idx,
                                        const size_t target_idx,
@@ -682,6 +759,8 @@ class ResultSet {
                                                   const size_t col_logical_idx,
                                                   int64_t& global_idx) const;
 
+  void fetchDeferredChunks(const size_t storage_idx, const size_t frag_idx) const;
+
   StorageLookupResult findStorage(const size_t entry_idx) const;
 
   struct TargetOffsets {
@@ -754,6 +833,7 @@ class ResultSet {
         , result_set_(result_set)
         , buffer_itr_(result_set) {
       materializeCountDistinctColumns();
+      materializeNormalizedKeys();
     }
 
     void materializeCountDistinctColumns();
@@ -761,6 +841,10 @@ class ResultSet {
     std::vector<int64_t> materializeCountDistinctColumn(
         const Analyzer::OrderEntry& order_entry) const;
 
+    void materializeNormalizedKeys();
+
+    bool isFloatArgumentInput(const Analyzer::OrderEntry& order_entry) const;
+
     bool operator()(const uint32_t lhs, const uint32_t rhs) const;
 
     // TODO(adb): make order_entries_ a pointer
@@ -769,6 +853,11 @@ class ResultSet {
     const ResultSet* result_set_;
     const BufferIteratorType buffer_itr_;
     std::vector<std::vector<int64_t>> count_distinct_materialized_buffers_;
+    // By order entry, keys of the entries which compare as unsigned integers in the
+    // order of the entry, and whether the entries are null. Empty for the order entries
+    // compared through their target values, strings and count distinct.
+    std::vector<std::vector<uint64_t>> normalized_keys_;
+    std::vector<std::vector<int8_t>> normalized_key_nulls_;
   };
 
   std::function<bool(const uint32_t, const uint32_t)> createComparator(
@@ -847,6 +936,7 @@ class ResultSet {
   std::vector<uint32_t> permutation_;
 
   QueryExecutionTimings timings_;
+  DeviceMemoryUsage gpu_memory_usage_;
   const Executor* executor_;  // TODO(alex): remove
 
   std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_;
@@ -855,10 +945,20 @@ class ResultSet {
   //   setting offset instead of ptr in group by buffer.
   std::vector<std::vector<int8_t>> literal_buffers_;
   const std::vector<ColumnLazyFetchInfo> lazy_fetch_info_;
-  std::vector<std::vector<std::vector<const int8_t*>>> col_buffers_;
+  // the deferred chunks fill in their buffers on the first read of their fragment
+  mutable std::vector<std::vector<std::vector<const int8_t*>>> col_buffers_;
   std::vector<std::vector<std::vector<int64_t>>> frag_offsets_;
   std::vector<std::vector<int64_t>> consistent_frag_sizes_;
 
+  struct DeferredChunks {
+    Data_Namespace::DataMgr* data_mgr;
+    std::vector<DeferredColumnChunk> chunks;
+    std::once_flag fetched;
+    std::list<std::shared_ptr<Chunk_NS::Chunk>> fetched_chunks;
+  };
+  // by storage and fragment, parallel to col_buffers_
+  std::vector<std::vector<std::shared_ptr<DeferredChunks>>> deferred_chunks_;
+
   const std::shared_ptr<const Analyzer::Estimator> estimator_;
   Data_Namespace::AbstractBuffer* device_estimator_buffer_{nullptr};
   mutable int8_t* host_estimator_buffer_{nullptr};
@@ -871,6 +971,7 @@ class ResultSet {
   bool separate_varlen_storage_valid_;
   std::string explanation_;
   const bool just_explain_;
+  bool approx_quantiles_finalized_{false};
   mutable std::atomic<ssize_t> cached_row_count_;
   mutable std::mutex row_iteration_mutex_;
 
@@ -961,4 +1062,8 @@ GroupValueInfo get_group_value_reduction(int64_t* groups_buffer,
 
 std::vector<int64_t> initialize_target_values_for_storage(
     const std::vector<TargetInfo>& targets);
+
+// The entry count of the baseline hash buffer which holds the reduction of storages
+size_t get_baseline_reduced_entry_count(
+    const std::vector<const ResultSetStorage*>& storages);
 #endif  // QUERYENGINE_RESULTSET_H
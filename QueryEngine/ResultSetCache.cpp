@@ -0,0 +1,167 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ResultSetCache.h"
+
+#include "Catalog/Catalog.h"
+#include "Logger/Logger.h"
+#include "QueryEngine/ResultSet.h"
+#include "QueryEngine/StringDictionaryGenerations.h"
+#include "QueryEngine/TableGenerations.h"
+
+bool g_enable_result_set_cache{false};
+size_t g_result_set_cache_bytes{268435456};  // 256MB
+
+ResultSetCache& ResultSetCache::instance() {
+  static ResultSetCache cache;
+  return cache;
+}
+
+bool ResultSetCache::isCacheable(const std::string& query_ra) {
+  // by the names in the plan JSON, a string literal spelled as one of them only makes
+  // the query run every time
+  static const char* non_deterministic_names[] = {"\"LogicalTableModify\"",
+                                                  "\"LogicalTableFunctionScan\"",
+                                                  "\"NOW\"",
+                                                  "\"DATETIME\"",
+                                                  "\"CURRENT_TIMESTAMP\"",
+                                                  "\"CURRENT_DATE\"",
+                                                  "\"CURRENT_TIME\"",
+                                                  "\"CURRENT_USER\""};
+  if (query_ra.empty()) {
+    return false;
+  }
+  for (const auto name : non_deterministic_names) {
+    if (query_ra.find(name) != std::string::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<ResultSetCache::Versions> ResultSetCache::getVersions(
+    const Catalog_Namespace::Catalog& cat,
+    const TableGenerations& table_generations,
+    const StringDictionaryGenerations& string_dictionary_generations) {
+  Versions versions;
+  for (const auto& [table_id, generation] : table_generations.asMap()) {
+    const auto td = cat.getMetadataForTable(table_id, /*populateFragmenter=*/false);
+    if (!td || table_is_temporary(td) || td->storageType == StorageType::FOREIGN_TABLE) {
+      return std::nullopt;
+    }
+    const auto epoch = cat.getTableEpoch(cat.getCurrentDB().dbId, table_id);
+    if (epoch < 0) {
+      // the shards don't agree on the epoch
+      return std::nullopt;
+    }
+    versions.tables.emplace(
+        table_id, std::make_tuple(generation.tuple_count, generation.start_rowid, epoch));
+  }
+  for (const auto& [dict_id, generation] : string_dictionary_generations.asMap()) {
+    versions.string_dictionaries.emplace(dict_id, generation);
+  }
+  return versions;
+}
+
+std::optional<ExecutionResult> ResultSetCache::get(const std::string& key,
+                                                   const Versions& versions,
+                                                   const Executor* executor) {
+  std::shared_ptr<ResultSet> cached_rows;
+  std::vector<TargetMetaInfo> targets_meta;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++stats_.misses;
+      return std::nullopt;
+    }
+    if (!(it->second->versions == versions)) {
+      VLOG(1) << "Invalidate a cached result of " << it->second->bytes
+              << " bytes, its tables have changed";
+      erase(it->second);
+      ++stats_.misses;
+      return std::nullopt;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.end(), entries_, it->second);
+    cached_rows = entries_.back().rows;
+    targets_meta = entries_.back().targets_meta;
+  }
+  // the cached rows are never modified, the copy doesn't need the lock
+  auto rows = cached_rows->copy(executor);
+  CHECK(rows);
+  return ExecutionResult(std::move(rows), targets_meta);
+}
+
+void ResultSetCache::put(const std::string& key,
+                         const Versions& versions,
+                         const ExecutionResult& result,
+                         const Executor* executor) {
+  const auto& result_rows = result.getRows();
+  if (!result_rows) {
+    return;
+  }
+  if (result_rows->getStorage() &&
+      result_rows->getBufferSizeBytes(result_rows->getDeviceType()) >
+          g_result_set_cache_bytes) {
+    VLOG(1) << "Not caching a result larger than the result set cache";
+    return;
+  }
+  auto rows = result_rows->copy(executor);
+  if (!rows) {
+    return;
+  }
+  const auto bytes = rows->getBufferSizeBytes(rows->getDeviceType());
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = index_.find(key);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+  while (!entries_.empty() && stats_.bytes + bytes > g_result_set_cache_bytes) {
+    VLOG(1) << "Evicting a cached result of " << entries_.front().bytes << " bytes";
+    ++stats_.evictions;
+    erase(entries_.begin());
+  }
+  entries_.push_back({key, versions, std::move(rows), result.getTargetsMeta(), bytes});
+  index_.emplace(key, std::prev(entries_.end()));
+  stats_.bytes += bytes;
+}
+
+void ResultSetCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  VLOG(1) << "Invalidate " << entries_.size() << " cached results, " << stats_.hits
+          << " hits, " << stats_.misses << " misses, " << stats_.evictions
+          << " evictions";
+  index_.clear();
+  entries_.clear();
+  stats_.bytes = 0;
+}
+
+size_t ResultSetCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+ResultSetCache::Stats ResultSetCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void ResultSetCache::erase(const EntryList::iterator it) {
+  stats_.bytes -= it->bytes;
+  index_.erase(it->key);
+  entries_.erase(it);
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ResultSetCache.h
+ * @brief   Byte bounded LRU cache of the results of the queries over unchanged tables
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+#include "QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
+
+extern bool g_enable_result_set_cache;
+extern size_t g_result_set_cache_bytes;
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+class Executor;
+class StringDictionaryGenerations;
+class TableGenerations;
+
+/**
+ * Keeps the results of the queries by their database and RA plan, for the dashboards
+ * which refresh the same queries against tables that have not changed since. An entry is
+ * only returned while the tables the query has read have the row counts and epochs they
+ * had when it ran, and its string dictionaries the same generations. The rows are copies
+ * in memory of their own, so that the entries don't hold the buffers of the queries and
+ * each hit iterates over its own rows. The least recently used entries are evicted once
+ * the rows take more than g_result_set_cache_bytes.
+ */
+class ResultSetCache {
+ public:
+  //! What the result of a query depends on
+  struct Versions {
+    // by table id, the number of tuples, the first row id and the epoch
+    std::map<int, std::tuple<size_t, size_t, int32_t>> tables;
+    // by dictionary id
+    std::map<uint32_t, size_t> string_dictionaries;
+
+    bool operator==(const Versions& that) const {
+      return tables == that.tables && string_dictionaries == that.string_dictionaries;
+    }
+  };
+
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    size_t bytes{0};
+  };
+
+  static ResultSetCache& instance();
+
+  //! Whether the result of query_ra only depends on its tables, i.e. the plan has no
+  //! modifications, table functions or functions of the time or of the session
+  static bool isCacheable(const std::string& query_ra);
+
+  //! The versions of the tables and dictionaries a query reads, none when one of the
+  //! tables changes without a new epoch, i.e. for temporary and foreign tables
+  static std::optional<Versions> getVersions(
+      const Catalog_Namespace::Catalog& cat,
+      const TableGenerations& table_generations,
+      const StringDictionaryGenerations& string_dictionary_generations);
+
+  std::optional<ExecutionResult> get(const std::string& key,
+                                     const Versions& versions,
+                                     const Executor* executor);
+
+  void put(const std::string& key,
+           const Versions& versions,
+           const ExecutionResult& result,
+           const Executor* executor);
+
+  void clear();
+
+  size_t size() const;
+
+  Stats getStats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    Versions versions;
+    std::shared_ptr<ResultSet> rows;
+    std::vector<TargetMetaInfo> targets_meta;
+    size_t bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(const EntryList::iterator it);
+
+  mutable std::mutex mutex_;
+  EntryList entries_;  // from the least to the most recently used
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  Stats stats_;
+};
@@ -279,6 +279,17 @@ std::vector<TargetValue> ResultSet::getRowAtNoTranslations(
   return getRowAt(entry_idx, false, false, false, targets_to_skip);
 }
 
+std::vector<TargetValue> ResultSet::getRowAtWithTranslations(
+    const size_t logical_index,
+    const bool decimal_to_double) const {
+  if (logical_index >= entryCount()) {
+    return {};
+  }
+  const auto entry_idx =
+      permutation_.empty() ? logical_index : permutation_[logical_index];
+  return getRowAt(entry_idx, true, decimal_to_double, false);
+}
+
 bool ResultSet::isRowAtEmpty(const size_t logical_index) const {
   if (logical_index >= entryCount()) {
     return true;
@@ -786,6 +797,16 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
   }
   CHECK_EQ(size_t(0), type_bitwidth % 8);
   int64_t val;
+  if (type_info.get_compression() == kENCODING_DIFF) {
+    const int32_t null_val = type_info.get_size() == 4   ? NULL_INT
+                             : type_info.get_size() == 2 ? NULL_SMALLINT
+                                                         : NULL_TINYINT;
+    return diff_fixed_width_int_decode_noinline(byte_stream,
+                                                type_info.get_size(),
+                                                null_val,
+                                                inline_int_null_val(type_info),
+                                                pos);
+  }
   if (type_info.is_date_in_days()) {
     val = type_info.get_comp_param() == 16
               ? fixed_width_small_date_decode_noinline(
@@ -1158,13 +1179,46 @@ const std::vector<const int8_t*>& ResultSet::getColumnFrag(const size_t storage_
     CHECK_GE(frag_id, int64_t(0));
     CHECK_LT(static_cast<size_t>(frag_id), col_buffers_[storage_idx].size());
     global_idx = local_idx;
+    fetchDeferredChunks(storage_idx, frag_id);
     return col_buffers_[storage_idx][frag_id];
   } else {
     CHECK_EQ(size_t(1), col_buffers_[storage_idx].size());
+    fetchDeferredChunks(storage_idx, 0);
     return col_buffers_[storage_idx][0];
   }
 }
 
+void ResultSet::fetchDeferredChunks(const size_t storage_idx,
+                                    const size_t frag_idx) const {
+  if (storage_idx >= deferred_chunks_.size() ||
+      frag_idx >= deferred_chunks_[storage_idx].size() ||
+      !deferred_chunks_[storage_idx][frag_idx]) {
+    return;
+  }
+  auto& deferred = *deferred_chunks_[storage_idx][frag_idx];
+  // the rows are read by several threads, e.g. to sort them, the first one to read a
+  // row of the fragment fetches its chunks for the others
+  std::call_once(deferred.fetched, [this, &deferred, storage_idx, frag_idx] {
+    auto& frag_col_buffers = col_buffers_[storage_idx][frag_idx];
+    for (const auto& deferred_chunk : deferred.chunks) {
+      auto chunk = Chunk_NS::Chunk::getChunk(deferred_chunk.cd,
+                                             deferred.data_mgr,
+                                             deferred_chunk.chunk_key,
+                                             Data_Namespace::CPU_LEVEL,
+                                             0,
+                                             deferred_chunk.num_bytes,
+                                             deferred_chunk.num_elements);
+      CHECK(chunk);
+      const auto ab = chunk->getBuffer();
+      CHECK(ab->getMemoryPtr());
+      CHECK_LT(static_cast<size_t>(deferred_chunk.local_col_id),
+               frag_col_buffers.size());
+      frag_col_buffers[deferred_chunk.local_col_id] = ab->getMemoryPtr();
+      deferred.fetched_chunks.push_back(std::move(chunk));
+    }
+  });
+}
+
 /**
  * For each specified column, this function goes through all available storages and copy
  * its content into a contiguous output_buffer
@@ -1226,6 +1280,9 @@ ENTRY_TYPE ResultSet::getEntryAt(const size_t row_idx,
     } else {
       return getRowWiseBaselineEntryAt<ENTRY_TYPE>(row_idx, target_idx, slot_idx);
     }
+  } else if constexpr (QUERY_TYPE == QueryDescriptionType::Projection &&
+                       !COLUMNAR_FORMAT) {
+    return getRowWiseProjectionEntryAt<ENTRY_TYPE>(row_idx, target_idx, slot_idx);
   } else {
     UNREACHABLE() << "Invalid query type is used";
     return 0;
@@ -1241,6 +1298,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T int32_t
@@ -1248,6 +1306,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T int16_t
@@ -1255,6 +1314,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T int8_t
@@ -1262,6 +1322,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T float
@@ -1269,6 +1330,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #define DATA_T double
@@ -1276,6 +1338,7 @@ DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByPerfectHash, false)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, true)
 DEF_GET_ENTRY_AT(QueryDescriptionType::GroupByBaselineHash, false)
+DEF_GET_ENTRY_AT(QueryDescriptionType::Projection, false)
 #undef DATA_T
 
 #undef DEF_GET_ENTRY_AT
@@ -1312,6 +1375,26 @@ ENTRY_TYPE ResultSet::getRowWisePerfectHashEntryAt(const size_t row_idx,
   return *reinterpret_cast<const ENTRY_TYPE*>(storage_buffer);
 }
 
+/**
+ * Directly accesses the storage buffer holding row_idx for a particular data type
+ * (row-wise output, projection), the projections have a storage per fragment
+ *
+ * NOTE: Currently, only used in direct columnarization
+ */
+template <typename ENTRY_TYPE>
+ENTRY_TYPE ResultSet::getRowWiseProjectionEntryAt(const size_t row_idx,
+                                                  const size_t target_idx,
+                                                  const size_t slot_idx) const {
+  const auto storage_lookup_result = findStorage(row_idx);
+  const auto storage = storage_lookup_result.storage_ptr;
+  const auto& query_mem_desc = storage->query_mem_desc_;
+  const int8_t* storage_buffer =
+      storage->getUnderlyingBuffer() +
+      query_mem_desc.getRowSize() * storage_lookup_result.fixedup_entry_idx +
+      query_mem_desc.getColOffInBytes(slot_idx);
+  return *reinterpret_cast<const ENTRY_TYPE*>(storage_buffer);
+}
+
 /**
  * Directly accesses the result set's storage buffer for a particular data type (columnar
  * output, baseline hash group by)
@@ -1355,6 +1438,167 @@ ENTRY_TYPE ResultSet::getColumnarBaselineEntryAt(const size_t row_idx,
   return reinterpret_cast<const ENTRY_TYPE*>(column_buffer)[row_idx];
 }
 
+bool ResultSet::isTypedColumnAccessPossible(const size_t target_idx) const {
+  CHECK_LT(target_idx, targets_.size());
+  if (!storage_ || !isDirectColumnarConversionPossible() || drop_first_ || keep_first_) {
+    return false;
+  }
+  const auto& target = targets_[target_idx];
+  const auto& chosen_type = get_compact_type(target);
+  const auto slot_idx = getSlotIndicesForTargetIndices()[target_idx];
+  const auto slot_width = query_mem_desc_.getPaddedSlotWidthBytes(slot_idx);
+  // the types makeTargetValue reads as they are stored in their slots
+  bool is_plain_slot{false};
+  if (chosen_type.is_integer() || chosen_type.is_boolean() || chosen_type.is_time() ||
+      chosen_type.is_timeinterval()) {
+    is_plain_slot = !chosen_type.is_date_in_days();
+  } else if (chosen_type.is_dict_encoded_string()) {
+    is_plain_slot = true;
+  } else if (chosen_type.get_type() == kDOUBLE) {
+    is_plain_slot = slot_width == sizeof(double);
+  } else if (chosen_type.get_type() == kFLOAT) {
+    is_plain_slot = !target.is_agg && slot_width == sizeof(float) &&
+                    (query_mem_desc_.forceFourByteFloat() ||
+                     query_mem_desc_.isLogicalSizedColumnsAllowed());
+  }
+  if (!is_plain_slot || target.sql_type.is_column()) {
+    return false;
+  }
+  if (query_mem_desc_.didOutputColumnar() &&
+      query_mem_desc_.getQueryDescriptionType() == QueryDescriptionType::Projection) {
+    return isZeroCopyColumnarConversionPossible(target_idx);
+  }
+  return std::get<0>(getSupportedSingleSlotTargetBitmap())[target_idx];
+}
+
+template <typename T>
+void ResultSet::getColumnValues(const size_t target_idx,
+                                const size_t first_entry,
+                                const size_t end_entry,
+                                std::vector<T>& values) const {
+  CHECK(isTypedColumnAccessPossible(target_idx));
+  CHECK_EQ(std::is_floating_point<T>::value,
+           get_compact_type(targets_[target_idx]).is_fp());
+  const auto slot_idx = getSlotIndicesForTargetIndices()[target_idx];
+  if constexpr (std::is_floating_point<T>::value) {  // NOLINT
+    switch (query_mem_desc_.getPaddedSlotWidthBytes(slot_idx)) {
+      case 8:
+        getColumnValuesImpl<double>(target_idx, slot_idx, first_entry, end_entry, values);
+        break;
+      case 4:
+        getColumnValuesImpl<float>(target_idx, slot_idx, first_entry, end_entry, values);
+        break;
+      default:
+        UNREACHABLE();
+    }
+  } else {
+    switch (query_mem_desc_.getPaddedSlotWidthBytes(slot_idx)) {
+      case 8:
+        getColumnValuesImpl<int64_t>(
+            target_idx, slot_idx, first_entry, end_entry, values);
+        break;
+      case 4:
+        getColumnValuesImpl<int32_t>(
+            target_idx, slot_idx, first_entry, end_entry, values);
+        break;
+      case 2:
+        getColumnValuesImpl<int16_t>(
+            target_idx, slot_idx, first_entry, end_entry, values);
+        break;
+      case 1:
+        getColumnValuesImpl<int8_t>(target_idx, slot_idx, first_entry, end_entry, values);
+        break;
+      default:
+        UNREACHABLE();
+    }
+  }
+}
+
+template void ResultSet::getColumnValues<int64_t>(const size_t target_idx,
+                                                  const size_t first_entry,
+                                                  const size_t end_entry,
+                                                  std::vector<int64_t>& values) const;
+template void ResultSet::getColumnValues<float>(const size_t target_idx,
+                                                const size_t first_entry,
+                                                const size_t end_entry,
+                                                std::vector<float>& values) const;
+template void ResultSet::getColumnValues<double>(const size_t target_idx,
+                                                 const size_t first_entry,
+                                                 const size_t end_entry,
+                                                 std::vector<double>& values) const;
+
+template <typename ENTRY_TYPE, typename T>
+void ResultSet::getColumnValuesImpl(const size_t target_idx,
+                                    const size_t slot_idx,
+                                    const size_t first_entry,
+                                    const size_t end_entry,
+                                    std::vector<T>& values) const {
+  const auto& target = targets_[target_idx];
+  const auto& chosen_type = get_compact_type(target);
+  // the null sentinels and the dictionary ids as makeTargetValue returns them
+  const auto to_value = [&](const ENTRY_TYPE entry) -> T {
+    if constexpr (std::is_floating_point<T>::value) {  // NOLINT
+      return entry;
+    } else {
+      const int64_t ival = entry;
+      if (chosen_type.is_dict_encoded_string()) {
+        return static_cast<int32_t>(ival);
+      }
+      if (inline_int_null_val(chosen_type) ==
+          int_resize_cast(ival, chosen_type.get_logical_size())) {
+        return inline_int_null_val(target.sql_type);
+      }
+      return ival;
+    }
+  };
+  const auto entry_count = std::min(end_entry, entryCount());
+  if (entry_count > first_entry) {
+    values.reserve(values.size() + entry_count - first_entry);
+  }
+  const auto read_entries = [&](const auto& read_entry) {
+    for (size_t entry_idx = first_entry; entry_idx < entry_count; ++entry_idx) {
+      if (!isRowAtEmpty(entry_idx)) {
+        values.push_back(to_value(read_entry(entry_idx)));
+      }
+    }
+  };
+#define READ_ENTRIES(query_type, columnar_output)                     \
+  read_entries([this, target_idx, slot_idx](const size_t entry_idx) { \
+    return getEntryAt<ENTRY_TYPE, query_type, columnar_output>(       \
+        entry_idx, target_idx, slot_idx);                             \
+  })
+  const bool is_columnar = query_mem_desc_.didOutputColumnar();
+  switch (query_mem_desc_.getQueryDescriptionType()) {
+    case QueryDescriptionType::Projection:
+      if (is_columnar) {
+        const auto column_buffer = reinterpret_cast<const ENTRY_TYPE*>(
+            storage_->getUnderlyingBuffer() + query_mem_desc_.getColOffInBytes(slot_idx));
+        read_entries(
+            [column_buffer](const size_t entry_idx) { return column_buffer[entry_idx]; });
+      } else {
+        READ_ENTRIES(QueryDescriptionType::Projection, false);
+      }
+      break;
+    case QueryDescriptionType::GroupByPerfectHash:
+      if (is_columnar) {
+        READ_ENTRIES(QueryDescriptionType::GroupByPerfectHash, true);
+      } else {
+        READ_ENTRIES(QueryDescriptionType::GroupByPerfectHash, false);
+      }
+      break;
+    case QueryDescriptionType::GroupByBaselineHash:
+      if (is_columnar) {
+        READ_ENTRIES(QueryDescriptionType::GroupByBaselineHash, true);
+      } else {
+        READ_ENTRIES(QueryDescriptionType::GroupByBaselineHash, false);
+      }
+      break;
+    default:
+      UNREACHABLE() << "Invalid query type is used";
+  }
+#undef READ_ENTRIES
+}
+
 // Interprets ptr1, ptr2 as the ptr and len pair used for variable length data.
 TargetValue ResultSet::makeVarlenTargetValue(const int8_t* ptr1,
                                              const int8_t compact_sz1,
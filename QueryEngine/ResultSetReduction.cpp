@@ -29,6 +29,7 @@
 #include "ResultSetReductionJIT.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
+#include "TDigest.h"
 
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
@@ -371,11 +372,157 @@ void ResultSetStorage::reduce(const ResultSetStorage& that,
   }
 }
 
+// Reduces the entries of those into the buffer of this ResultSetStorage object, whose
+// entries may be overwritten unless it is this one.
+void ResultSetStorage::reduce(const std::vector<const ResultSetStorage*>& those,
+                              const ReductionCode& reduction_code) const {
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  // the JIT-compiled reduction can run from several threads, not the interpreter
+  const bool can_reduce_concurrently =
+      query_mem_desc_.didOutputColumnar() || reduction_code.func_ptr;
+  if (query_mem_desc_.getQueryDescriptionType() ==
+      QueryDescriptionType::GroupByBaselineHash) {
+    if (those.size() > 1 && use_multithreaded_reduction(entry_count) &&
+        can_reduce_concurrently) {
+      reducePartitioned(those, reduction_code);
+      return;
+    }
+  } else if (those.size() > 1 && !use_multithreaded_reduction(entry_count) &&
+             can_reduce_concurrently) {
+    // Small buffers are reduced by a single thread each, pair them up in a tree instead
+    std::vector<const ResultSetStorage*> storages{this};
+    storages.insert(storages.end(), those.begin(), those.end());
+    for (size_t stride = 1; stride < storages.size(); stride *= 2) {
+      std::vector<std::future<void>> reduction_threads;
+      for (size_t i = 0; i + stride < storages.size(); i += 2 * stride) {
+        reduction_threads.emplace_back(
+            std::async(std::launch::async, [&storages, &reduction_code, i, stride] {
+              storages[i]->reduce(*storages[i + stride], {}, reduction_code);
+            }));
+      }
+      for (auto& reduction_thread : reduction_threads) {
+        reduction_thread.wait();
+      }
+      for (auto& reduction_thread : reduction_threads) {
+        reduction_thread.get();
+      }
+    }
+    return;
+  }
+  for (const auto that : those) {
+    reduce(*that, {}, reduction_code);
+  }
+}
+
+// Reduces the entries of those into the baseline buffer of this ResultSetStorage object
+// in two phases, instead of one pass over the buffer of this object by result set. The
+// threads first partition the entries of those by the range of their home slot in this
+// buffer, then reduce a partition each. All the entries of a group are reduced by the
+// thread of its partition, even if the group is probed into a slot of another one.
+void ResultSetStorage::reducePartitioned(
+    const std::vector<const ResultSetStorage*>& those,
+    const ReductionCode& reduction_code) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!query_mem_desc_.hasKeylessHash());
+  CHECK(query_mem_desc_.didOutputColumnar() || reduction_code.func_ptr);
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  const auto key_count = query_mem_desc_.getGroupbyColCount();
+  const size_t thread_count = cpu_threads();
+  const auto partition_entry_count = (entry_count + thread_count - 1) / thread_count;
+  const auto home_partition = [this, entry_count, key_count, partition_entry_count](
+                                  const ResultSetStorage& that,
+                                  const size_t that_entry_idx) {
+    const auto that_buff_i64 = reinterpret_cast<const int64_t*>(that.buff_);
+    uint32_t h{0};
+    if (query_mem_desc_.didOutputColumnar()) {
+      const auto key = make_key(&that_buff_i64[that_entry_idx],
+                                that.query_mem_desc_.getEntryCount(),
+                                key_count);
+      h = key_hash(&key[0], key_count, sizeof(int64_t));
+    } else {
+      const auto key_off = get_row_qw_count(query_mem_desc_) * that_entry_idx;
+      h = key_hash(&that_buff_i64[key_off],
+                   key_count,
+                   query_mem_desc_.getEffectiveKeyWidth());
+    }
+    return (h % entry_count) / partition_entry_count;
+  };
+  // the indices of the non-empty entries of those, by that, partitioning thread and
+  // partition
+  std::vector<std::vector<uint32_t>> partitions(those.size() * thread_count *
+                                                thread_count);
+  const auto partition_entries = [&](const size_t that_idx, const size_t thread_idx) {
+    return partitions.begin() + (that_idx * thread_count + thread_idx) * thread_count;
+  };
+  std::vector<std::future<void>> partition_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    partition_threads.emplace_back(std::async(std::launch::async, [&, thread_idx] {
+      for (size_t that_idx = 0; that_idx < those.size(); ++that_idx) {
+        const auto& that = *those[that_idx];
+        const auto that_entry_count = that.query_mem_desc_.getEntryCount();
+        const auto thread_entry_count =
+            (that_entry_count + thread_count - 1) / thread_count;
+        const auto start_index = thread_idx * thread_entry_count;
+        const auto end_index =
+            std::min(start_index + thread_entry_count, that_entry_count);
+        const auto entries = partition_entries(that_idx, thread_idx);
+        for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
+          if (!that.isEmptyEntry(entry_idx, that.buff_)) {
+            entries[home_partition(that, entry_idx)].push_back(entry_idx);
+          }
+        }
+      }
+    }));
+  }
+  for (auto& partition_thread : partition_threads) {
+    partition_thread.wait();
+  }
+  for (auto& partition_thread : partition_threads) {
+    partition_thread.get();
+  }
+  std::vector<std::future<void>> reduction_threads;
+  for (size_t partition = 0; partition < thread_count; ++partition) {
+    reduction_threads.emplace_back(std::async(std::launch::async, [&, partition] {
+      for (size_t that_idx = 0; that_idx < those.size(); ++that_idx) {
+        const auto& that = *those[that_idx];
+        const auto that_entry_count = that.query_mem_desc_.getEntryCount();
+        for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+          const auto& entries = partition_entries(that_idx, thread_idx)[partition];
+          for (const auto entry_idx : entries) {
+            if (reduction_code.func_ptr) {
+              run_reduction_code(reduction_code,
+                                 buff_,
+                                 that.buff_,
+                                 entry_idx,
+                                 entry_idx + 1,
+                                 that_entry_count,
+                                 &query_mem_desc_,
+                                 &that.query_mem_desc_,
+                                 nullptr);
+            } else {
+              reduceOneEntryBaseline(
+                  buff_, that.buff_, entry_idx, that_entry_count, that);
+            }
+          }
+        }
+      }
+    }));
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.wait();
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.get();
+  }
+}
+
 namespace {
 
 ALWAYS_INLINE void check_watchdog(const size_t sample_seed) {
-  if (UNLIKELY(g_enable_dynamic_watchdog && (sample_seed & 0x3F) == 0 &&
-               dynamic_watchdog())) {
+  if (UNLIKELY((sample_seed & 0x3F) == 0 &&
+               ((g_enable_dynamic_watchdog && dynamic_watchdog()) ||
+                Executor::isInterrupted()))) {
     // TODO(alex): distinguish between the deadline and interrupt
     throw std::runtime_error(
         "Query execution has exceeded the time limit or was interrupted during result "
@@ -1000,6 +1147,57 @@ void ResultSet::initializeStorage() const {
 // Driver for reductions. Needed because the result of a reduction on the baseline
 // layout, which can have collisions, cannot be done in place and something needs
 // to take the ownership of the new result set with the bigger underlying buffer.
+size_t ResultSetStorage::getNonEmptyEntryCount() const {
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  if (!use_multithreaded_reduction(entry_count)) {
+    size_t non_empty_entry_count{0};
+    for (size_t entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+      non_empty_entry_count += !isEmptyEntry(entry_idx, buff_);
+    }
+    return non_empty_entry_count;
+  }
+  const size_t thread_count = cpu_threads();
+  std::vector<std::future<size_t>> count_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    const auto thread_entry_count = (entry_count + thread_count - 1) / thread_count;
+    const auto start_index = thread_idx * thread_entry_count;
+    const auto end_index = std::min(start_index + thread_entry_count, entry_count);
+    count_threads.emplace_back(
+        std::async(std::launch::async, [this, start_index, end_index] {
+          size_t non_empty_entry_count{0};
+          for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
+            non_empty_entry_count += !isEmptyEntry(entry_idx, buff_);
+          }
+          return non_empty_entry_count;
+        }));
+  }
+  size_t non_empty_entry_count{0};
+  for (auto& count_thread : count_threads) {
+    non_empty_entry_count += count_thread.get();
+  }
+  return non_empty_entry_count;
+}
+
+// The result of every kernel has a buffer sized for all the groups of the query, so the
+// buffer the results are reduced into is sized by their groups instead of their entries
+// when it's smaller. It isn't more than half full and it is larger than the buffers of
+// the results, which are moved or reduced into it.
+size_t get_baseline_reduced_entry_count(
+    const std::vector<const ResultSetStorage*>& storages) {
+  CHECK_GT(storages.size(), size_t(1));
+  size_t total_entry_count{0};
+  size_t max_entry_count{0};
+  size_t group_count{0};
+  for (const auto storage : storages) {
+    CHECK(storage);
+    total_entry_count += storage->getEntryCount();
+    max_entry_count = std::max(max_entry_count, storage->getEntryCount());
+    group_count += storage->getNonEmptyEntryCount();
+  }
+  CHECK(total_entry_count);
+  return std::min(total_entry_count, std::max(2 * group_count, max_entry_count + 1));
+}
+
 ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
   CHECK(!result_sets.empty());
   auto result_rs = result_sets.front();
@@ -1015,17 +1213,14 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
     CHECK_EQ(executor, result_set->executor_);
   }
   if (first_result.query_mem_desc_.getQueryDescriptionType() ==
-      QueryDescriptionType::GroupByBaselineHash) {
-    const auto total_entry_count =
-        std::accumulate(result_sets.begin(),
-                        result_sets.end(),
-                        size_t(0),
-                        [](const size_t init, const ResultSet* rs) {
-                          return init + rs->query_mem_desc_.getEntryCount();
-                        });
-    CHECK(total_entry_count);
+          QueryDescriptionType::GroupByBaselineHash &&
+      result_sets.size() > 1) {
+    std::vector<const ResultSetStorage*> storages;
+    for (const auto result_set : result_sets) {
+      storages.push_back(result_set->storage_.get());
+    }
     auto query_mem_desc = first_result.query_mem_desc_;
-    query_mem_desc.setEntryCount(total_entry_count);
+    query_mem_desc.setEntryCount(get_baseline_reduced_entry_count(storages));
     rs_.reset(new ResultSet(first_result.targets_,
                             ExecutorDeviceType::CPU,
                             query_mem_desc,
@@ -1065,6 +1260,15 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
                                       result_rs->getTargetInfos(),
                                       result_rs->getTargetInitVals());
   auto reduction_code = reduction_jit.codegen();
+  if (serialized_varlen_buffer.empty()) {
+    std::vector<const ResultSetStorage*> those;
+    for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end();
+         ++result_it) {
+      those.push_back((*result_it)->storage_.get());
+    }
+    result->reduce(those, reduction_code);
+    return result_rs;
+  }
   size_t ctr = 1;
   for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end();
        ++result_it) {
@@ -1439,6 +1643,12 @@ void ResultSetStorage::reduceOneSlot(
         AGGREGATE_ONE_COUNT(this_ptr1, that_ptr1, chosen_bytes);
         break;
       }
+      case kAPPROX_QUANTILE: {
+        CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+        approx_quantile_union(reinterpret_cast<int64_t*>(this_ptr1),
+                              *reinterpret_cast<const int64_t*>(that_ptr1));
+        break;
+      }
       case kAVG: {
         // Ignore float argument compaction for count component for fear of its overflow
         AGGREGATE_ONE_COUNT(this_ptr2,
@@ -26,6 +26,7 @@
 
 #include "Shared/likely.h"
 #include "Shared/mapdpath.h"
+#include "TDigest.h"
 
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Function.h>
@@ -457,6 +458,12 @@ extern "C" void count_distinct_set_union_jit_rt(const int64_t new_set_handle,
       new_set_handle, old_set_handle, new_count_distinct_desc, old_count_distinct_desc);
 }
 
+extern "C" void approx_quantile_union_jit_rt(int8_t* this_ptr1,
+                                             const int8_t* that_ptr1) {
+  approx_quantile_union(reinterpret_cast<int64_t*>(this_ptr1),
+                        *reinterpret_cast<const int64_t*>(that_ptr1));
+}
+
 extern "C" void get_group_value_reduction_rt(int8_t* groups_buffer,
                                              const int8_t* key,
                                              const uint32_t key_count,
@@ -483,8 +490,9 @@ extern "C" void get_group_value_reduction_rt(int8_t* groups_buffer,
 }
 
 extern "C" uint8_t check_watchdog_rt(const size_t sample_seed) {
-  if (UNLIKELY(g_enable_dynamic_watchdog && (sample_seed & 0x3F) == 0 &&
-               dynamic_watchdog())) {
+  if (UNLIKELY((sample_seed & 0x3F) == 0 &&
+               ((g_enable_dynamic_watchdog && dynamic_watchdog()) ||
+                Executor::isInterrupted()))) {
     return true;
   }
   return false;
@@ -1130,6 +1138,15 @@ void ResultSetReductionJIT::reduceOneAggregateSlot(Value* this_ptr1,
       emit_aggregate_one_count(this_ptr1, that_ptr1, chosen_bytes, ir_reduce_one_entry);
       break;
     }
+    case kAPPROX_QUANTILE: {
+      CHECK_EQ(static_cast<size_t>(chosen_bytes), sizeof(int64_t));
+      ir_reduce_one_entry->add<ExternalCall>(
+          "approx_quantile_union_jit_rt",
+          Type::Void,
+          std::vector<const Value*>{this_ptr1, that_ptr1},
+          "");
+      break;
+    }
     case kAVG: {
       // Ignore float argument compaction for count component for fear of its overflow
       emit_aggregate_one_count(this_ptr2,
@@ -1268,11 +1285,18 @@ std::string ResultSetReductionJIT::cacheKey() const {
 ReductionCode GpuReductionHelperJIT::codegen() const {
   const auto hash_type = query_mem_desc_.getQueryDescriptionType();
   auto reduction_code = setup_functions_ir(hash_type);
-  CHECK(hash_type == QueryDescriptionType::GroupByPerfectHash);
+  // the baseline entry lookup in the destination buffer goes through the host, the GPU
+  // code looks up the entries itself and only needs the reduction of their targets
+  const bool is_baseline = hash_type == QueryDescriptionType::GroupByBaselineHash;
   isEmpty(reduction_code);
-  reduceOneEntryNoCollisions(reduction_code);
-  reduceOneEntryNoCollisionsIdx(reduction_code);
-  reduceLoop(reduction_code);
+  if (is_baseline) {
+    reduceOneEntryBaseline(reduction_code);
+  } else {
+    CHECK(hash_type == QueryDescriptionType::GroupByPerfectHash);
+    reduceOneEntryNoCollisions(reduction_code);
+    reduceOneEntryNoCollisionsIdx(reduction_code);
+    reduceLoop(reduction_code);
+  }
   reduction_code.cgen_state.reset(new CgenState({}, false));
   auto cgen_state = reduction_code.cgen_state.get();
   std::unique_ptr<llvm::Module> module(runtime_module_shallow_copy(cgen_state));
@@ -1282,18 +1306,22 @@ ReductionCode GpuReductionHelperJIT::codegen() const {
   auto ir_is_empty = create_llvm_function(reduction_code.ir_is_empty.get(), cgen_state);
   auto ir_reduce_one_entry =
       create_llvm_function(reduction_code.ir_reduce_one_entry.get(), cgen_state);
-  auto ir_reduce_one_entry_idx =
-      create_llvm_function(reduction_code.ir_reduce_one_entry_idx.get(), cgen_state);
-  auto ir_reduce_loop =
-      create_llvm_function(reduction_code.ir_reduce_loop.get(), cgen_state);
   std::unordered_map<const Function*, llvm::Function*> f;
   f.emplace(reduction_code.ir_is_empty.get(), ir_is_empty);
   f.emplace(reduction_code.ir_reduce_one_entry.get(), ir_reduce_one_entry);
-  f.emplace(reduction_code.ir_reduce_one_entry_idx.get(), ir_reduce_one_entry_idx);
-  f.emplace(reduction_code.ir_reduce_loop.get(), ir_reduce_loop);
   translate_function(reduction_code.ir_is_empty.get(), ir_is_empty, reduction_code, f);
   translate_function(
       reduction_code.ir_reduce_one_entry.get(), ir_reduce_one_entry, reduction_code, f);
+  if (is_baseline) {
+    reduction_code.module = std::move(module);
+    return reduction_code;
+  }
+  auto ir_reduce_one_entry_idx =
+      create_llvm_function(reduction_code.ir_reduce_one_entry_idx.get(), cgen_state);
+  auto ir_reduce_loop =
+      create_llvm_function(reduction_code.ir_reduce_loop.get(), cgen_state);
+  f.emplace(reduction_code.ir_reduce_one_entry_idx.get(), ir_reduce_one_entry_idx);
+  f.emplace(reduction_code.ir_reduce_loop.get(), ir_reduce_loop);
   translate_function(reduction_code.ir_reduce_one_entry_idx.get(),
                      ir_reduce_one_entry_idx,
                      reduction_code,
@@ -146,16 +146,22 @@ class GpuReductionHelperJIT : public ResultSetReductionJIT {
                         const std::vector<int64_t>& target_init_vals)
       : ResultSetReductionJIT(query_mem_desc, targets, target_init_vals)
       , query_mem_desc_(query_mem_desc) {
-    CHECK(query_mem_desc_.getQueryDescriptionType() ==
-          QueryDescriptionType::GroupByPerfectHash);
     CHECK(!query_mem_desc_.didOutputColumnar());
-    CHECK(query_mem_desc_.hasKeylessHash());
+    if (query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByPerfectHash) {
+      CHECK(query_mem_desc_.hasKeylessHash());
+    } else {
+      CHECK(query_mem_desc_.getQueryDescriptionType() ==
+            QueryDescriptionType::GroupByBaselineHash);
+    }
   }
   /**
    * generates code for perfect hash group by reduction: the following functions are
    * internally created: isEmpty, reduceOneEntryNoCollision (reduce for perfect hash),
    * reduceOneEntryNoCollissionsIdx(reduce one slot for perfect hash), and reduceLoop (the
    * outer loop).
+   * For baseline hash group by, only isEmpty and reduceOneEntryBaseline (reduce the
+   * targets of one entry) are created, the caller looks up the destination entry itself.
    */
   virtual ReductionCode codegen() const;
 
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ResultSetSerialization.cpp
+ * @brief   Serialization of the result sets the leaves ship to the aggregator.
+ *
+ * The buffers are shipped as they are laid out in memory, so the aggregator reduces
+ * them with the same reduction code as the results of its own kernels. The projection
+ * buffers only ship their filled entries and the COUNT(DISTINCT) bitmaps which are all
+ * zeros aren't shipped at all.
+ */
+
+#include "ResultSet.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <set>
+
+#include "CountDistinct.h"
+#include "Execute.h"
+#include "ResultSetBufferAccessors.h"
+#include "ThriftSerializers.h"
+
+namespace {
+
+// Throws if the targets of the results need more than their buffers to be read back
+void check_serializable(const std::vector<TargetInfo>& targets,
+                        const std::vector<ColumnLazyFetchInfo>& lazy_fetch_info,
+                        const QueryMemoryDescriptor& query_mem_desc,
+                        const bool has_appended_storage) {
+  if (query_mem_desc.useStreamingTopN()) {
+    throw std::runtime_error("The results of a streaming top n can't be serialized");
+  }
+  for (const auto& col_lazy_fetch : lazy_fetch_info) {
+    if (col_lazy_fetch.is_lazily_fetched) {
+      throw std::runtime_error(
+          "The results of lazily fetched columns can't be serialized");
+    }
+  }
+  for (const auto& target_info : targets) {
+    if (target_info.agg_kind == kSINGLE_VALUE ||
+        target_info.agg_kind == kAPPROX_QUANTILE) {
+      throw std::runtime_error(
+          "The results of SINGLE_VALUE and APPROX_QUANTILE can't be serialized");
+    }
+    if (is_real_str_or_array(target_info) || target_info.sql_type.is_geometry()) {
+      throw std::runtime_error("The results of " + target_info.sql_type.get_type_name() +
+                               " columns can't be serialized");
+    }
+    if (is_distinct_target(target_info) &&
+        (query_mem_desc.didOutputColumnar() || has_appended_storage)) {
+      throw std::runtime_error(
+          "Only the row-wise results of COUNT(DISTINCT) can be serialized");
+    }
+  }
+}
+
+// Calls f with the address of each COUNT(DISTINCT) slot of the non-empty entries of a
+// row-wise buffer and the logical index of its target
+template <typename F>
+void for_each_count_distinct_slot(int8_t* buff,
+                                  const QueryMemoryDescriptor& query_mem_desc,
+                                  const std::vector<TargetInfo>& targets,
+                                  const std::function<bool(const size_t)>& is_empty_entry,
+                                  F f) {
+  CHECK(!query_mem_desc.didOutputColumnar());
+  const auto key_bytes_with_padding =
+      align_to_int64(get_key_bytes_rowwise(query_mem_desc));
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+    if (is_empty_entry(entry_idx)) {
+      continue;
+    }
+    auto target_ptr =
+        row_ptr_rowwise(buff, query_mem_desc, entry_idx) + key_bytes_with_padding;
+    size_t slot_idx = 0;
+    for (size_t target_idx = 0; target_idx < targets.size(); ++target_idx) {
+      const auto& target_info = targets[target_idx];
+      if (is_distinct_target(target_info)) {
+        f(reinterpret_cast<int64_t*>(target_ptr), target_idx);
+      }
+      target_ptr = advance_target_ptr_row_wise(
+          target_ptr, target_info, slot_idx, query_mem_desc, false);
+      slot_idx = advance_slot(slot_idx, target_info, false);
+    }
+  }
+}
+
+size_t get_bitmap_byte_size(const CountDistinctDescriptor& count_distinct_desc) {
+  return count_distinct_desc.sub_bitmap_count == 1
+             ? count_distinct_desc.bitmapSizeBytes()
+             : count_distinct_desc.bitmapPaddedSizeBytes();
+}
+
+}  // namespace
+
+void ResultSet::serialize(TSerializedRows& serialized_rows) const {
+  if (just_explain_) {
+    serialized_rows.explanation = explanation_;
+    return;
+  }
+  CHECK(storage_);
+  check_serializable(
+      targets_, lazy_fetch_info_, query_mem_desc_, !appended_storage_.empty());
+  serialized_rows.descriptor = QueryMemoryDescriptor::toThrift(query_mem_desc_);
+  serialized_rows.targets = ThriftSerializers::target_infos_to_thrift(targets_);
+  serialized_rows.target_init_vals = storage_->target_init_vals_;
+  serialized_rows.buffers_total_size = 0;
+  serialized_rows.total_compression_time_ms = 0;
+  auto serialize_storage = [&serialized_rows](const ResultSetStorage& storage) {
+    const auto& storage_query_mem_desc = storage.query_mem_desc_;
+    auto entry_count = storage.getEntryCount();
+    // the entries of the row-wise projections past the row count are all empty
+    if (storage_query_mem_desc.getQueryDescriptionType() ==
+            QueryDescriptionType::Projection &&
+        !storage_query_mem_desc.didOutputColumnar()) {
+      entry_count = storage.binSearchRowCount();
+    }
+    const auto buffer_size =
+        storage_query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU, entry_count);
+    serialized_rows.buffers.emplace_back(reinterpret_cast<const char*>(storage.buff_),
+                                         buffer_size);
+    serialized_rows.buffer_lengths.push_back(buffer_size);
+    serialized_rows.buffer_entry_counts.push_back(entry_count);
+    serialized_rows.buffers_total_size += buffer_size;
+  };
+  serialize_storage(*storage_);
+  for (const auto& storage : appended_storage_) {
+    serialize_storage(*storage);
+  }
+  serializeCountDistinctColumns(serialized_rows);
+}
+
+std::unique_ptr<ResultSet> ResultSet::unserialize(
+    const TSerializedRows& serialized_rows,
+    const Executor* executor,
+    const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner) {
+  if (!serialized_rows.explanation.empty()) {
+    return std::make_unique<ResultSet>(serialized_rows.explanation);
+  }
+  CHECK(row_set_mem_owner);
+  const auto target_infos =
+      ThriftSerializers::target_infos_from_thrift(serialized_rows.targets);
+  QueryMemoryDescriptor query_mem_desc(serialized_rows.descriptor);
+  CHECK_EQ(serialized_rows.buffers.size(), serialized_rows.buffer_entry_counts.size());
+  std::unique_ptr<ResultSet> result_set;
+  for (size_t i = 0; i < serialized_rows.buffers.size(); ++i) {
+    const auto& buffer = serialized_rows.buffers[i];
+    query_mem_desc.setEntryCount(serialized_rows.buffer_entry_counts[i]);
+    CHECK_EQ(buffer.size(), query_mem_desc.getBufferSizeBytes(ExecutorDeviceType::CPU));
+    auto buffer_result_set = std::make_unique<ResultSet>(target_infos,
+                                                         ExecutorDeviceType::CPU,
+                                                         query_mem_desc,
+                                                         row_set_mem_owner,
+                                                         executor);
+    const auto storage =
+        buffer_result_set->allocateStorage(serialized_rows.target_init_vals);
+    std::memcpy(storage->getUnderlyingBuffer(), buffer.data(), buffer.size());
+    if (result_set) {
+      result_set->append(*buffer_result_set);
+    } else {
+      result_set = std::move(buffer_result_set);
+    }
+  }
+  CHECK(result_set);
+  result_set->unserializeCountDistinctColumns(serialized_rows);
+  return result_set;
+}
+
+void ResultSet::serializeCountDistinctColumns(TSerializedRows& serialized_rows) const {
+  if (std::none_of(targets_.begin(), targets_.end(), is_distinct_target)) {
+    return;
+  }
+  for_each_count_distinct_slot(
+      storage_->buff_,
+      query_mem_desc_,
+      targets_,
+      [this](const size_t entry_idx) { return storage_->isEmptyEntry(entry_idx); },
+      [this, &serialized_rows](const int64_t* slot, const size_t target_idx) {
+        const auto remote_ptr = *slot;
+        if (!remote_ptr) {
+          return;
+        }
+        const auto& count_distinct_desc =
+            query_mem_desc_.getCountDistinctDescriptor(target_idx);
+        TCountDistinctSet count_distinct_set;
+        count_distinct_set.type = ThriftSerializers::count_distinct_impl_type_to_thrift(
+            count_distinct_desc.impl_type_);
+        count_distinct_set.remote_ptr = remote_ptr;
+        switch (count_distinct_desc.impl_type_) {
+          case CountDistinctImplType::Bitmap: {
+            const auto bitmap = reinterpret_cast<const char*>(remote_ptr);
+            const auto bitmap_byte_sz = get_bitmap_byte_size(count_distinct_desc);
+            // the aggregator makes the bitmaps it doesn't get zeros
+            if (std::all_of(bitmap, bitmap + bitmap_byte_sz, [](const char byte) {
+                  return byte == 0;
+                })) {
+              return;
+            }
+            count_distinct_set.storage.__set_bitmap(std::string(bitmap, bitmap_byte_sz));
+            break;
+          }
+          case CountDistinctImplType::StdSet: {
+            const auto set = reinterpret_cast<const std::set<int64_t>*>(remote_ptr);
+            count_distinct_set.storage.__set_sparse_set(*set);
+            break;
+          }
+          case CountDistinctImplType::HashSet: {
+            std::set<int64_t> sparse_set;
+            reinterpret_cast<const CountDistinctHashSet*>(remote_ptr)
+                ->forEach([&sparse_set](const int64_t val) { sparse_set.insert(val); });
+            count_distinct_set.storage.__set_sparse_set(sparse_set);
+            break;
+          }
+          default:
+            CHECK(false);
+        }
+        serialized_rows.count_distinct_sets.push_back(count_distinct_set);
+      });
+}
+
+void ResultSet::unserializeCountDistinctColumns(const TSerializedRows& serialized_rows) {
+  for (const auto& count_distinct_set : serialized_rows.count_distinct_sets) {
+    int64_t ptr{0};
+    switch (ThriftSerializers::count_distinct_impl_type_from_thrift(
+        count_distinct_set.type)) {
+      case CountDistinctImplType::Bitmap: {
+        const auto& bitmap = count_distinct_set.storage.bitmap;
+        auto count_distinct_buffer =
+            row_set_mem_owner_->allocateCountDistinctBuffer(bitmap.size());
+        std::memcpy(count_distinct_buffer, bitmap.data(), bitmap.size());
+        ptr = reinterpret_cast<int64_t>(count_distinct_buffer);
+        break;
+      }
+      case CountDistinctImplType::StdSet: {
+        auto set = new std::set<int64_t>(count_distinct_set.storage.sparse_set);
+        row_set_mem_owner_->addCountDistinctSet(set);
+        ptr = reinterpret_cast<int64_t>(set);
+        break;
+      }
+      case CountDistinctImplType::HashSet: {
+        auto hash_set = new CountDistinctHashSet();
+        row_set_mem_owner_->addCountDistinctHashSet(hash_set);
+        for (const auto val : count_distinct_set.storage.sparse_set) {
+          hash_set->insert(val);
+        }
+        ptr = reinterpret_cast<int64_t>(hash_set);
+        break;
+      }
+      default:
+        CHECK(false);
+    }
+    storage_->addCountDistinctSetPointerMapping(count_distinct_set.remote_ptr, ptr);
+  }
+  fixupCountDistinctPointers();
+}
+
+void ResultSet::fixupCountDistinctPointers() {
+  if (std::none_of(targets_.begin(), targets_.end(), is_distinct_target)) {
+    return;
+  }
+  for_each_count_distinct_slot(
+      storage_->buff_,
+      query_mem_desc_,
+      targets_,
+      [this](const size_t entry_idx) { return storage_->isEmptyEntry(entry_idx); },
+      [this](int64_t* slot, const size_t target_idx) {
+        const auto remote_ptr = *slot;
+        if (!remote_ptr) {
+          return;
+        }
+        const auto ptr = storage_->mappedPtr(remote_ptr);
+        if (ptr) {
+          *slot = ptr;
+          return;
+        }
+        // the leaf didn't ship the bitmaps which were all zeros
+        const auto& count_distinct_desc =
+            query_mem_desc_.getCountDistinctDescriptor(target_idx);
+        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::Bitmap);
+        *slot = reinterpret_cast<int64_t>(row_set_mem_owner_->allocateCountDistinctBuffer(
+            get_bitmap_byte_size(count_distinct_desc)));
+      });
+}
@@ -352,6 +352,29 @@ extern "C" ALWAYS_INLINE int8_t bit_is_set(const int64_t bitset,
              : 0;
 }
 
+// The IN sets too sparse for a bitmap, binary searched
+extern "C" ALWAYS_INLINE int8_t sorted_set_contains(const int64_t sorted_values,
+                                                    const int64_t value_count,
+                                                    const int64_t val,
+                                                    const int64_t null_val,
+                                                    const int8_t null_bool_val) {
+  if (val == null_val) {
+    return null_bool_val;
+  }
+  const auto values = reinterpret_cast<const int64_t*>(sorted_values);
+  int64_t begin = 0;
+  int64_t end = value_count;
+  while (begin < end) {
+    const auto mid = begin + (end - begin) / 2;
+    if (values[mid] < val) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin < value_count && values[begin] == val ? 1 : 0;
+}
+
 extern "C" ALWAYS_INLINE int64_t agg_sum(int64_t* agg, const int64_t val) {
   const auto old = *agg;
   *agg += val;
@@ -928,6 +951,38 @@ extern "C" GPU_RT_STUB int64_t get_block_index() {
   return 0;
 }
 
+extern "C" GPU_RT_STUB int64_t get_block_dim() {
+  return 0;
+}
+
+extern "C" GPU_RT_STUB int64_t* get_group_value_with_smem_spill(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals,
+    const uint32_t smem_entry_count) {
+  return nullptr;
+}
+
+extern "C" GPU_RT_STUB int64_t* get_group_value_with_smem_spill_with_watchdog(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals,
+    const uint32_t smem_entry_count) {
+  return nullptr;
+}
+
+extern "C" GPU_RT_STUB void init_shared_join_hash_table(int32_t* shared_hash_table,
+                                                        const int32_t* global_hash_table,
+                                                        const int32_t hash_table_size) {}
+
 #undef GPU_RT_STUB
 
 extern "C" ALWAYS_INLINE int32_t record_error_code(const int32_t err_code,
@@ -954,7 +1009,8 @@ extern "C" __attribute__((noinline)) const int64_t* init_shared_mem_nop(
 
 extern "C" __attribute__((noinline)) void write_back_nop(int64_t* dest,
                                                          int64_t* src,
-                                                         const int32_t sz) {
+                                                         const int32_t sz,
+                                                         int32_t* error_codes) {
   // the body is not really needed, just make sure the call is not optimized away
   assert(dest);
 }
@@ -128,6 +128,20 @@ extern "C" int64_t* get_group_value(int64_t* groups_buffer,
                                     const uint32_t row_size_quad,
                                     const int64_t* init_val = nullptr);
 
+extern "C" int64_t* get_group_value_32(int64_t* groups_buffer,
+                                       const uint32_t groups_buffer_entry_count,
+                                       const int64_t* key,
+                                       const uint32_t key_count,
+                                       const uint32_t row_size_quad,
+                                       const int64_t* init_val = nullptr);
+
+extern "C" int64_t* get_group_value_64(int64_t* groups_buffer,
+                                       const uint32_t groups_buffer_entry_count,
+                                       const int64_t* key,
+                                       const uint32_t key_count,
+                                       const uint32_t row_size_quad,
+                                       const int64_t* init_val = nullptr);
+
 enum RuntimeInterruptFlags { INT_CHECK = 0, INT_ABORT = -1, INT_RESET = -2 };
 
 extern "C" bool check_interrupt();
@@ -253,6 +267,12 @@ extern "C" int64_t fixed_width_small_date_decode_noinline(const int8_t* byte_str
                                                           const int64_t ret_null_val,
                                                           const int64_t pos);
 
+extern "C" int64_t diff_fixed_width_int_decode_noinline(const int8_t* byte_stream,
+                                                        const int32_t byte_width,
+                                                        const int32_t null_val,
+                                                        const int64_t ret_null_val,
+                                                        const int64_t pos);
+
 extern "C" int8_t* extract_str_ptr_noinline(const uint64_t str_and_len);
 
 extern "C" int32_t extract_str_len_noinline(const uint64_t str_and_len);
@@ -134,6 +134,8 @@ std::string agg_type_to_string(const SQLAgg agg_type) {
       return "APPROX_COUNT_DISTINCT";
     case kSAMPLE:
       return "SAMPLE";
+    case kAPPROX_QUANTILE:
+      return "APPROX_PERCENTILE";
     default:
       LOG(FATAL) << "Invalid aggregate type: " << agg_type;
       return "";
@@ -199,6 +201,23 @@ std::string ScalarExprToSql::visitWindowFunction(
       result += " ORDER BY " + boost::algorithm::join(order_strs, ",");
     }
   }
+  const auto& rows_frame = window_func->getRowsFrame();
+  if (rows_frame) {
+    const auto bound_to_sql = [](const std::optional<int64_t>& offset,
+                                 const std::string& unbounded) {
+      if (!offset) {
+        return unbounded;
+      }
+      if (*offset == 0) {
+        return std::string("CURRENT ROW");
+      }
+      return std::to_string(std::abs(*offset)) +
+             (*offset < 0 ? " PRECEDING" : " FOLLOWING");
+    };
+    result += " ROWS BETWEEN " +
+              bound_to_sql(rows_frame->start_offset, "UNBOUNDED PRECEDING") + " AND " +
+              bound_to_sql(rows_frame->end_offset, "UNBOUNDED FOLLOWING");
+  }
   result += ")";
   return result;
 }
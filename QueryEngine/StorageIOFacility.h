@@ -211,13 +211,11 @@ StorageIOFacility<EXECUTOR_TRAITS, FRAGMENT_UPDATER>::yieldUpdateCallback(
       CHECK(fragmenter);
 
       // The fragmenter copy of the fragment info differs from the copy used by the query
-      // engine. Update metadata in the fragmenter directly.
+      // engine. Update metadata in the fragmenter directly, under the fragmenter lock so
+      // that queries stop using the fragments they cached.
+      fragmenter->updateColumnChunkMetadata(
+          cd, fragment_info.fragmentId, new_chunk_metadata);
       auto fragment = fragmenter->getFragmentInfo(fragment_info.fragmentId);
-      // TODO: we may want to put this directly in the fragmenter so we are under the
-      // fragmenter lock. But, concurrent queries on the same fragmenter should not be
-      // allowed in this path.
-
-      fragment->setChunkMetadata(cd->columnId, new_chunk_metadata);
       fragment->shadowChunkMetadataMap =
           fragment->getChunkMetadataMap();  // TODO(adb): needed?
 
@@ -290,10 +288,48 @@ StorageIOFacility<EXECUTOR_TRAITS, FRAGMENT_UPDATER>::yieldUpdateCallback(
         return (thread_index * complete_entry_block_size);
       };
 
+      // A columnar projection without lazily fetched columns holds its rows in its
+      // first entries, so its columns can be copied into the chunks without being
+      // converted row by row
+      auto rs = update_log.getResultSet();
+      const auto offset_column_index = update_parameters.getUpdateColumnCount();
+      const int64_t* columnar_frag_offsets{nullptr};
+      if (rs->isZeroCopyColumnarConversionPossible(offset_column_index) &&
+          rs->getPaddedSlotWidthBytes(offset_column_index) == sizeof(int64_t)) {
+        columnar_frag_offsets =
+            reinterpret_cast<const int64_t*>(rs->getColumnarBuffer(offset_column_index));
+      }
+
       // Iterate over each column
       for (decltype(update_parameters.getUpdateColumnCount()) column_index = 0;
            column_index < update_parameters.getUpdateColumnCount();
            column_index++) {
+        const auto table_id = update_log.getPhysicalTableId();
+        auto const* table_descriptor =
+            catalog_.getMetadataForTable(update_log.getPhysicalTableId());
+        CHECK(table_descriptor);
+        const auto fragmenter = table_descriptor->fragmenter;
+        CHECK(fragmenter);
+        auto const* target_column = catalog_.getMetadataForColumn(
+            table_id, update_parameters.getUpdateColumnNames()[column_index]);
+
+        if (columnar_frag_offsets &&
+            rs->isZeroCopyColumnarConversionPossible(column_index) &&
+            fragmenter->updateColumnFromColumnar(
+                &catalog_,
+                table_descriptor,
+                target_column,
+                update_log.getFragmentId(),
+                columnar_frag_offsets,
+                rs->getColumnarBuffer(column_index),
+                rs->getPaddedSlotWidthBytes(column_index),
+                rows_per_column,
+                update_log.getColumnType(column_index),
+                Data_Namespace::MemoryLevel::CPU_LEVEL,
+                update_parameters.getTransactionTracker())) {
+          continue;
+        }
+
         row_idx = 0;
         RowProcessingFuturesVector entry_processing_futures;
         entry_processing_futures.reserve(usable_threads);
@@ -333,15 +369,6 @@ StorageIOFacility<EXECUTOR_TRAITS, FRAGMENT_UPDATER>::yieldUpdateCallback(
 
         CHECK(row_idx == rows_per_column);
 
-        const auto table_id = update_log.getPhysicalTableId();
-        auto const* table_descriptor =
-            catalog_.getMetadataForTable(update_log.getPhysicalTableId());
-        CHECK(table_descriptor);
-        const auto fragmenter = table_descriptor->fragmenter;
-        CHECK(fragmenter);
-        auto const* target_column = catalog_.getMetadataForColumn(
-            table_id, update_parameters.getUpdateColumnNames()[column_index]);
-
         fragmenter->updateColumn(&catalog_,
                                  table_descriptor,
                                  target_column,
@@ -412,13 +439,11 @@ StorageIOFacility<EXECUTOR_TRAITS, FRAGMENT_UPDATER>::yieldDeleteCallback(
       CHECK(fragmenter);
 
       // The fragmenter copy of the fragment info differs from the copy used by the query
-      // engine. Update metadata in the fragmenter directly.
+      // engine. Update metadata in the fragmenter directly, under the fragmenter lock so
+      // that queries stop using the fragments they cached.
+      fragmenter->updateColumnChunkMetadata(
+          cd, fragment_info.fragmentId, new_chunk_metadata);
       auto fragment = fragmenter->getFragmentInfo(fragment_info.fragmentId);
-      // TODO: we may want to put this directly in the fragmenter so we are under the
-      // fragmenter lock. But, concurrent queries on the same fragmenter should not be
-      // allowed in this path.
-
-      fragment->setChunkMetadata(cd->columnId, new_chunk_metadata);
       fragment->shadowChunkMetadataMap =
           fragment->getChunkMetadataMap();  // TODO(adb): needed?
 
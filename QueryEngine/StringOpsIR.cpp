@@ -124,6 +124,38 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::LowerExpr* expr,
       "lower_encoded", get_int_type(32, cgen_state_->context_), args);
 }
 
+namespace {
+
+// The patterns without any wildcard or escape but a leading or trailing '%', matched
+// without interpreting them
+enum class LikeFixedPattern { kNone, kPrefix, kSuffix, kExact };
+
+LikeFixedPattern get_like_fixed_pattern(const std::string& pattern,
+                                        const char escape_char) {
+  const auto is_fixed = [&pattern, escape_char](const size_t begin, const size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const auto c = pattern[i];
+      if (c == '%' || c == '_' || c == '[' || c == ']' || c == escape_char) {
+        return false;
+      }
+    }
+    return true;
+  };
+  const auto len = pattern.size();
+  if (is_fixed(0, len)) {
+    return LikeFixedPattern::kExact;
+  }
+  if (len > 1 && pattern.back() == '%' && is_fixed(0, len - 1)) {
+    return LikeFixedPattern::kPrefix;
+  }
+  if (len > 1 && pattern.front() == '%' && is_fixed(1, len)) {
+    return LikeFixedPattern::kSuffix;
+  }
+  return LikeFixedPattern::kNone;
+}
+
+}  // namespace
+
 llvm::Value* CodeGenerator::codegen(const Analyzer::LikeExpr* expr,
                                     const CompilationOptions& co) {
   AUTOMATIC_IR_METADATA(cgen_state_);
@@ -172,8 +204,25 @@ llvm::Value* CodeGenerator::codegen(const Analyzer::LikeExpr* expr,
   std::vector<llvm::Value*> str_like_args{
       str_lv[1], str_lv[2], like_expr_arg_lvs[1], like_expr_arg_lvs[2]};
   std::string fn_name{expr->get_is_ilike() ? "string_ilike" : "string_like"};
+  const auto fixed_pattern =
+      expr->get_is_simple()
+          ? LikeFixedPattern::kNone
+          : get_like_fixed_pattern(*pattern->get_constval().stringval, escape_char);
   if (expr->get_is_simple()) {
     fn_name += "_simple";
+  } else if (fixed_pattern == LikeFixedPattern::kExact) {
+    fn_name += "_exact";
+  } else if (fixed_pattern != LikeFixedPattern::kNone) {
+    // the pattern without the '%'
+    if (fixed_pattern == LikeFixedPattern::kSuffix) {
+      fn_name += "_suffix";
+      str_like_args[2] =
+          cgen_state_->ir_builder_.CreateGEP(str_like_args[2], cgen_state_->llInt(1));
+    } else {
+      fn_name += "_prefix";
+    }
+    str_like_args[3] =
+        cgen_state_->ir_builder_.CreateSub(str_like_args[3], cgen_state_->llInt(1));
   } else {
     str_like_args.push_back(cgen_state_->llInt(int8_t(escape_char)));
   }
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TDigest.h
+ * @brief   Merging t-digest of the values of an APPROX_PERCENTILE group
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * Summarizes a stream of doubles by weighted centroids, which are small close to the
+ * extreme quantiles and large in the middle, so that the tails are kept accurately in
+ * O(compression) memory. Values are buffered and merged into the centroids in batches.
+ * Inputs of fewer than about compression / 2 values keep a centroid per value, which
+ * makes their quantiles exact.
+ */
+class TDigest {
+ public:
+  explicit TDigest(const double q, const double compression = kDefaultCompression)
+      : q_(q), compression_(compression) {}
+
+  void add(const double val) {
+    buffer_.push_back({val, 1});
+    if (buffer_.size() >= kBufferSize) {
+      flush();
+    }
+  }
+
+  void merge(TDigest& that) {
+    if (&that == this) {
+      return;
+    }
+    that.flush();
+    buffer_.insert(buffer_.end(), that.centroids_.begin(), that.centroids_.end());
+    flush();
+    min_ = std::min(min_, that.min_);
+    max_ = std::max(max_, that.max_);
+  }
+
+  bool empty() const { return centroids_.empty() && buffer_.empty(); }
+
+  double getQ() const { return q_; }
+
+  //! The q-th quantile of the values added, which must not be empty
+  double quantile() {
+    flush();
+    const size_t n = centroids_.size();
+    const double idx = q_ * total_weight_;
+    // interpolate between the centers of the centroids, and the extremes at the ends
+    double center = centroids_.front().weight / 2;
+    if (idx <= center) {
+      return interpolate(0, min_, center, centroids_.front().mean, idx);
+    }
+    for (size_t i = 1; i < n; ++i) {
+      const double next_center =
+          center + (centroids_[i - 1].weight + centroids_[i].weight) / 2;
+      if (idx <= next_center) {
+        return interpolate(
+            center, centroids_[i - 1].mean, next_center, centroids_[i].mean, idx);
+      }
+      center = next_center;
+    }
+    return interpolate(center, centroids_.back().mean, total_weight_, max_, idx);
+  }
+
+  static constexpr double kDefaultCompression{100};
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  static constexpr size_t kBufferSize{512};
+
+  static double interpolate(const double x0,
+                            const double y0,
+                            const double x1,
+                            const double y1,
+                            const double x) {
+    return x1 > x0 ? y0 + (y1 - y0) * (x - x0) / (x1 - x0) : y1;
+  }
+
+  // the k1 scale function, centroids span at most 1 in k
+  double k(const double q) const {
+    return compression_ / (2 * M_PI) * std::asin(2 * q - 1);
+  }
+
+  double kInverse(const double k) const {
+    if (k >= compression_ / 4) {
+      return 1;
+    }
+    return (std::sin(k * 2 * M_PI / compression_) + 1) / 2;
+  }
+
+  void flush() {
+    if (buffer_.empty()) {
+      return;
+    }
+    for (const auto& c : buffer_) {
+      total_weight_ += c.weight;
+      min_ = std::min(min_, c.mean);
+      max_ = std::max(max_, c.mean);
+    }
+    buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+    std::sort(buffer_.begin(), buffer_.end(), [](const Centroid& a, const Centroid& b) {
+      return a.mean < b.mean;
+    });
+    centroids_.clear();
+    double weight_so_far{0};
+    double q_limit = kInverse(k(0) + 1);
+    auto cur = buffer_.front();
+    for (size_t i = 1; i < buffer_.size(); ++i) {
+      const auto& next = buffer_[i];
+      if (weight_so_far + cur.weight + next.weight <= q_limit * total_weight_) {
+        cur.weight += next.weight;
+        cur.mean += (next.mean - cur.mean) * next.weight / cur.weight;
+      } else {
+        weight_so_far += cur.weight;
+        centroids_.push_back(cur);
+        cur = next;
+        q_limit = kInverse(k(weight_so_far / total_weight_) + 1);
+      }
+    }
+    centroids_.push_back(cur);
+    buffer_.clear();
+  }
+
+  const double q_;
+  const double compression_;
+  std::vector<Centroid> centroids_;  // by mean
+  std::vector<Centroid> buffer_;     // added since the last flush
+  double total_weight_{0};
+  double min_{std::numeric_limits<double>::max()};
+  double max_{std::numeric_limits<double>::lowest()};
+};
+
+// Merges the t-digest of that_handle into the one of this_handle, either of which may
+// be 0 for an entry without a t-digest yet
+inline void approx_quantile_union(int64_t* this_handle, const int64_t that_handle) {
+  if (!that_handle) {
+    return;
+  }
+  if (!*this_handle) {
+    *this_handle = that_handle;
+    return;
+  }
+  reinterpret_cast<TDigest*>(*this_handle)
+      ->merge(*reinterpret_cast<TDigest*>(that_handle));
+}
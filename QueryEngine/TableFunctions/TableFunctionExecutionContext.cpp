@@ -16,11 +16,16 @@
 
 #include "QueryEngine/TableFunctions/TableFunctionExecutionContext.h"
 
+#include <future>
+
 #include "Analyzer/Analyzer.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/TableFunctions/TableFunctionCompilationContext.h"
+#include "Shared/thread_count.h"
+
+size_t g_table_function_partition_rows{1 << 16};
 
 namespace {
 
@@ -61,6 +66,53 @@ size_t get_output_row_count(const TableFunctionExecutionUnit& exe_unit,
   return allocated_output_row_count;
 }
 
+// The sizes of the input elements of the table function, zero for the literals which
+// are shared by all the rows
+std::vector<size_t> get_input_element_sizes(const TableFunctionExecutionUnit& exe_unit) {
+  std::vector<size_t> element_sizes;
+  for (const auto input_expr : exe_unit.input_exprs) {
+    if (const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(input_expr)) {
+      const auto size = col_var->get_type_info().get_size();
+      element_sizes.push_back(size > 0 ? static_cast<size_t>(size) : 0);
+    } else {
+      element_sizes.push_back(0);
+    }
+  }
+  return element_sizes;
+}
+
+// The [begin, end) input rows of the slices the table function runs on. A partitionable
+// function, whose outputs only depend on the input rows of their slice, runs on a slice
+// per CPU thread of at least g_table_function_partition_rows rows; the others run on a
+// single slice of all the rows.
+std::vector<std::pair<size_t, size_t>> get_input_slices(
+    const TableFunctionExecutionUnit& exe_unit,
+    const std::vector<size_t>& input_element_sizes,
+    const size_t elem_count) {
+  CHECK_EQ(input_element_sizes.size(), exe_unit.input_exprs.size());
+  bool has_varlen_input{false};
+  for (size_t i = 0; i < exe_unit.input_exprs.size(); ++i) {
+    if (dynamic_cast<const Analyzer::ColumnVar*>(exe_unit.input_exprs[i]) &&
+        !input_element_sizes[i]) {
+      has_varlen_input = true;
+    }
+  }
+  if (!exe_unit.is_partitionable || !g_table_function_partition_rows ||
+      has_varlen_input || elem_count <= g_table_function_partition_rows) {
+    return {{0, elem_count}};
+  }
+  const size_t slice_count =
+      std::min((elem_count + g_table_function_partition_rows - 1) /
+                   g_table_function_partition_rows,
+               static_cast<size_t>(std::max(cpu_threads(), 1)));
+  const size_t slice_size = (elem_count + slice_count - 1) / slice_count;
+  std::vector<std::pair<size_t, size_t>> slices;
+  for (size_t begin = 0; begin < elem_count; begin += slice_size) {
+    slices.emplace_back(begin, std::min(begin + slice_size, elem_count));
+  }
+  return slices;
+}
+
 }  // namespace
 
 ResultSetPtr TableFunctionExecutionContext::execute(
@@ -187,10 +239,6 @@ ResultSetPtr TableFunctionExecutionContext::launchCpuCode(
     std::vector<const int8_t*>& col_buf_ptrs,
     const size_t elem_count,
     Executor* executor) {
-  // setup the inputs
-  const auto byte_stream_ptr = reinterpret_cast<const int8_t**>(col_buf_ptrs.data());
-  CHECK(byte_stream_ptr);
-
   // initialize output memory
   auto num_out_columns = exe_unit.target_exprs.size();
   QueryMemoryDescriptor query_mem_desc(
@@ -216,7 +264,7 @@ ResultSetPtr TableFunctionExecutionContext::launchCpuCode(
       executor);
 
   // setup the output
-  int64_t output_row_count = -1;
+  int64_t output_row_count = 0;
   auto group_by_buffers_ptr = query_buffers->getGroupByBuffersPtr();
   CHECK(group_by_buffers_ptr);
 
@@ -226,34 +274,76 @@ ResultSetPtr TableFunctionExecutionContext::launchCpuCode(
     output_col_buf_ptrs.emplace_back(output_buffers_ptr + i * allocated_output_row_count);
   }
 
-  // execute
-  const auto kernel_element_count = static_cast<int64_t>(elem_count);
-  const auto err = compilation_context->getFuncPtr()(byte_stream_ptr,
-                                                     &kernel_element_count,
-                                                     output_col_buf_ptrs.data(),
-                                                     &output_row_count);
-  if (err) {
-    throw std::runtime_error("Error executing table function: " + std::to_string(err));
+  // execute, each slice of the input rows writes its outputs to its share of the output
+  // buffers: the multiplier times the rows before the slice
+  const auto input_element_sizes = get_input_element_sizes(exe_unit);
+  const auto slices = get_input_slices(exe_unit, input_element_sizes, elem_count);
+  const auto output_row_multiplier = *exe_unit.output_buffer_multiplier;
+  std::vector<int64_t> slice_output_row_counts(slices.size(), -1);
+  auto run_slice = [&](const size_t slice_idx) {
+    const auto [begin, end] = slices[slice_idx];
+    std::vector<const int8_t*> slice_col_buf_ptrs;
+    for (size_t i = 0; i < col_buf_ptrs.size(); ++i) {
+      slice_col_buf_ptrs.push_back(col_buf_ptrs[i] + begin * input_element_sizes[i]);
+    }
+    std::vector<int64_t*> slice_output_col_buf_ptrs;
+    for (const auto output_col_buf_ptr : output_col_buf_ptrs) {
+      slice_output_col_buf_ptrs.push_back(output_col_buf_ptr +
+                                          begin * output_row_multiplier);
+    }
+    const auto kernel_element_count = static_cast<int64_t>(end - begin);
+    auto& slice_output_row_count = slice_output_row_counts[slice_idx];
+    const auto err = compilation_context->getFuncPtr()(
+        reinterpret_cast<const int8_t**>(slice_col_buf_ptrs.data()),
+        &kernel_element_count,
+        slice_output_col_buf_ptrs.data(),
+        &slice_output_row_count);
+    if (err) {
+      throw std::runtime_error("Error executing table function: " + std::to_string(err));
+    }
+    const size_t slice_allocated_row_count = output_row_multiplier * (end - begin);
+    if (slice_output_row_count < 0 ||
+        (size_t)slice_output_row_count > slice_allocated_row_count) {
+      slice_output_row_count = slice_allocated_row_count;
+    }
+  };
+  if (slices.size() == 1) {
+    run_slice(0);
+  } else {
+    VLOG(1) << "Running table function " << exe_unit.table_func_name << " on "
+            << slices.size() << " slices of its " << elem_count << " input rows";
+    std::vector<std::future<void>> slice_runs;
+    for (size_t slice_idx = 0; slice_idx < slices.size(); ++slice_idx) {
+      slice_runs.push_back(std::async(std::launch::async, run_slice, slice_idx));
+    }
+    for (auto& slice_run : slice_runs) {
+      slice_run.wait();
+    }
+    for (auto& slice_run : slice_runs) {
+      slice_run.get();
+    }
   }
-  if (output_row_count < 0 || (size_t)output_row_count > allocated_output_row_count) {
-    output_row_count = allocated_output_row_count;
+  for (const auto slice_output_row_count : slice_output_row_counts) {
+    output_row_count += slice_output_row_count;
   }
 
   // Update entry count, it may differ from allocated mem size
   query_buffers->getResultSet(0)->updateStorageEntryCount(output_row_count);
 
-  const size_t column_size = output_row_count * sizeof(int64_t);
-  const size_t allocated_column_size = allocated_output_row_count * sizeof(int64_t);
-
-  int8_t* src = reinterpret_cast<int8_t*>(output_buffers_ptr);
+  // concatenate the outputs of the slices into contiguous columns of output_row_count
   int8_t* dst = reinterpret_cast<int8_t*>(output_buffers_ptr);
   for (size_t i = 0; i < num_out_columns; i++) {
-    if (src != dst) {
-      auto t = memmove(dst, src, column_size);
-      CHECK_EQ(dst, t);
+    for (size_t slice_idx = 0; slice_idx < slices.size(); ++slice_idx) {
+      const size_t slice_column_size =
+          slice_output_row_counts[slice_idx] * sizeof(int64_t);
+      int8_t* src = reinterpret_cast<int8_t*>(
+          output_col_buf_ptrs[i] + slices[slice_idx].first * output_row_multiplier);
+      if (src != dst) {
+        auto t = memmove(dst, src, slice_column_size);
+        CHECK_EQ(dst, t);
+      }
+      dst += slice_column_size;
     }
-    src += allocated_column_size;
-    dst += column_size;
   }
 
   return query_buffers->getResultSetOwned(0);
@@ -51,3 +51,30 @@ EXTENSION_NOINLINE int32_t row_copier(Column<double> input_col,
 
   return output_row_count;
 }
+
+EXTENSION_NOINLINE int32_t row_adder(Column<double> input_col1,
+                                     Column<double> input_col2,
+                                     int copy_multiplier,
+                                     Column<double> output_col) {
+  // Each output row only depends on its input row, the function is partitionable.
+  int32_t output_row_count = copy_multiplier * input_col1.sz;
+  output_col.sz = output_row_count;
+
+#ifdef __CUDACC__
+  int32_t start = threadIdx.x + blockDim.x * blockIdx.x;
+  int32_t stop = static_cast<int32_t>(input_col1.sz);
+  int32_t step = blockDim.x * gridDim.x;
+#else
+  auto start = 0;
+  auto stop = input_col1.sz;
+  auto step = 1;
+#endif
+
+  for (auto i = start; i < stop; i += step) {
+    for (int c = 0; c < copy_multiplier; c++) {
+      output_col.ptr[i + (c * input_col1.sz)] = input_col1.ptr[i] + input_col2.ptr[i];
+    }
+  }
+
+  return output_row_count;
+}
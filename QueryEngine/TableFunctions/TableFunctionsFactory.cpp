@@ -87,9 +87,12 @@ void TableFunctionsFactory::add(const std::string& name,
                                 const TableFunctionOutputRowSizer sizer,
                                 const std::vector<ExtArgumentType>& input_args,
                                 const std::vector<ExtArgumentType>& output_args,
-                                bool is_runtime) {
+                                bool is_runtime,
+                                bool is_partitionable) {
   functions_.insert(std::make_pair(
-      name, TableFunction(name, sizer, input_args, output_args, is_runtime)));
+      name,
+      TableFunction(
+          name, sizer, input_args, output_args, is_runtime, is_partitionable)));
 }
 
 std::once_flag init_flag;
@@ -105,6 +108,15 @@ void TableFunctionsFactory::init() {
         std::vector<ExtArgumentType>{ExtArgumentType::ColumnDouble,
                                      ExtArgumentType::Int32},
         std::vector<ExtArgumentType>{ExtArgumentType::ColumnDouble});
+    TableFunctionsFactory::add(
+        "row_adder",
+        TableFunctionOutputRowSizer{OutputBufferSizeType::kUserSpecifiedRowMultiplier, 3},
+        std::vector<ExtArgumentType>{ExtArgumentType::ColumnDouble,
+                                     ExtArgumentType::ColumnDouble,
+                                     ExtArgumentType::Int32},
+        std::vector<ExtArgumentType>{ExtArgumentType::ColumnDouble},
+        /*is_runtime=*/false,
+        /*is_partitionable=*/true);
   });
 }
 
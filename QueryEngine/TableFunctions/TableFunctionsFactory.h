@@ -40,12 +40,14 @@ class TableFunction {
                 const TableFunctionOutputRowSizer output_sizer,
                 const std::vector<ExtArgumentType>& input_args,
                 const std::vector<ExtArgumentType>& output_args,
-                bool is_runtime)
+                bool is_runtime,
+                bool is_partitionable)
       : name_(name)
       , output_sizer_(output_sizer)
       , input_args_(input_args)
       , output_args_(output_args)
-      , is_runtime_(is_runtime) {}
+      , is_runtime_(is_runtime)
+      , is_partitionable_(is_partitionable) {}
 
   std::vector<ExtArgumentType> getArgs() const {
     std::vector<ExtArgumentType> args;
@@ -69,12 +71,18 @@ class TableFunction {
 
   bool isRuntime() const { return is_runtime_; }
 
+  // The outputs of a partitionable function on the concatenation of slices of its input
+  // rows are the concatenation of its outputs on each slice, so the CPU can run it on the
+  // slices concurrently.
+  bool isPartitionable() const { return is_partitionable_; }
+
   std::string toString() const {
     auto result = "TableFunction(" + name_ + ", [";
     result += ExtensionFunctionsWhitelist::toString(input_args_);
     result += "], [";
     result += ExtensionFunctionsWhitelist::toString(output_args_);
     result += "], is_runtime=" + std::string((is_runtime_ ? "true" : "false"));
+    result += ", is_partitionable=" + std::string((is_partitionable_ ? "true" : "false"));
     result += ")";
     return result;
   }
@@ -85,6 +93,7 @@ class TableFunction {
   const std::vector<ExtArgumentType> input_args_;
   const std::vector<ExtArgumentType> output_args_;
   const bool is_runtime_;
+  const bool is_partitionable_;
 };
 
 class TableFunctionsFactory {
@@ -93,7 +102,8 @@ class TableFunctionsFactory {
                   const TableFunctionOutputRowSizer sizer,
                   const std::vector<ExtArgumentType>& input_args,
                   const std::vector<ExtArgumentType>& output_args,
-                  bool is_runtime = false);
+                  bool is_runtime = false,
+                  bool is_partitionable = false);
 
   static const TableFunction& get(const std::string& name);
 
@@ -16,11 +16,20 @@
 
 #include "TableOptimizer.h"
 
+#include <random>
+
 #include "Analyzer/Analyzer.h"
 #include "Logger/Logger.h"
+#include "Catalog/SharedDictionaryValidator.h"
+#include "DataMgr/Chunk/Chunk.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/HyperLogLog.h"
+#include "QueryEngine/HyperLogLogRank.h"
+#include "QueryEngine/MurmurHash.h"
 #include "Shared/scope.h"
 
+size_t g_statistics_sample_rows{1 << 20};
+
 TableOptimizer::TableOptimizer(const TableDescriptor* td,
                                Executor* executor,
                                const Catalog_Namespace::Catalog& cat)
@@ -347,3 +356,246 @@ void TableOptimizer::vacuumDeletedRows() const {
   cat_.vacuumDeletedRows(table_id);
   cat_.checkpoint(table_id);
 }
+
+void TableOptimizer::sortFragmentRows() const {
+  cat_.sortFragmentRows(td_->tableId);
+}
+
+std::vector<std::pair<const ColumnDescriptor*, SQLTypeInfo>>
+TableOptimizer::getNarrowerColumnTypes() const {
+  std::vector<std::pair<const ColumnDescriptor*, SQLTypeInfo>> narrower_types;
+  const auto physical_tds = cat_.getPhysicalTablesDescriptors(td_);
+  const auto cds = cat_.getAllColumnMetadataForTable(td_->tableId, false, false, false);
+  for (const auto cd : cds) {
+    const auto& ti = cd->columnType;
+    if (!ti.is_integer() || ti.get_type() == kTINYINT ||
+        (ti.get_compression() != kENCODING_NONE &&
+         ti.get_compression() != kENCODING_FIXED)) {
+      continue;
+    }
+    bool has_values{false};
+    int64_t min{std::numeric_limits<int64_t>::max()};
+    int64_t max{std::numeric_limits<int64_t>::min()};
+    for (const auto physical_td : physical_tds) {
+      const auto table_info = physical_td->fragmenter->getFragmentsForQuery();
+      for (const auto& fragment : table_info.fragments) {
+        const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+        const auto chunk_meta_it = chunk_metadata_map.find(cd->columnId);
+        CHECK(chunk_meta_it != chunk_metadata_map.end());
+        const auto& chunk_stats = chunk_meta_it->second->chunkStats;
+        const auto chunk_min = extract_min_stat(chunk_stats, ti);
+        const auto chunk_max = extract_max_stat(chunk_stats, ti);
+        if (chunk_min > chunk_max) {
+          continue;  // only nulls
+        }
+        has_values = true;
+        min = std::min(min, chunk_min);
+        max = std::max(max, chunk_max);
+      }
+    }
+    if (!has_values) {
+      continue;
+    }
+    // the smallest value of the encoded width is the null sentinel
+    for (int comp_param = 8; comp_param < ti.get_size() * 8; comp_param *= 2) {
+      const int64_t encoded_max = (int64_t(1) << (comp_param - 1)) - 1;
+      if (min >= -encoded_max && max <= encoded_max) {
+        auto new_type = ti;
+        new_type.set_compression(kENCODING_FIXED);
+        new_type.set_comp_param(comp_param);
+        new_type.set_size(new_type.get_storage_size());
+        narrower_types.emplace_back(cd, new_type);
+        break;
+      }
+    }
+  }
+  return narrower_types;
+}
+
+std::vector<int> TableOptimizer::getCompactableDictionaryIds() const {
+  std::vector<int> dict_ids;
+  if (td_->persistenceLevel != Data_Namespace::DISK_LEVEL ||
+      !cat_.getStringDictionaryHosts().empty()) {
+    return dict_ids;
+  }
+  const auto physical_tds = cat_.getPhysicalTablesDescriptors(td_);
+  const auto cds = cat_.getAllColumnMetadataForTable(td_->tableId, false, false, false);
+  for (const auto cd : cds) {
+    const auto& ti = cd->columnType;
+    if (!ti.is_dict_encoded_string()) {
+      continue;
+    }
+    const int dict_id = ti.get_comp_param();
+    if (std::find(dict_ids.begin(), dict_ids.end(), dict_id) != dict_ids.end()) {
+      continue;  // two columns of the table share it
+    }
+    bool compactable{true};
+    for (const auto dict_cd : get_dictionary_columns(dict_id, cat_)) {
+      const bool of_table =
+          dict_cd->tableId == td_->tableId ||
+          std::any_of(
+              physical_tds.begin(), physical_tds.end(), [dict_cd](const auto td) {
+                return td->tableId == dict_cd->tableId;
+              });
+      compactable =
+          compactable && of_table && dict_cd->columnType.is_dict_encoded_string();
+    }
+    if (compactable) {
+      dict_ids.push_back(dict_id);
+    }
+  }
+  return dict_ids;
+}
+
+namespace {
+
+constexpr uint32_t kStatisticsHllBits{14};
+constexpr size_t kStatisticsHistogramBuckets{100};
+constexpr size_t kStatisticsMostCommonValues{10};
+constexpr size_t kStatisticsDecodeRows{64 * 1024};
+
+// The statistics of a column from its values, added a batch of rows at a time with the
+// nulls as the minimum of int64_t
+class ColumnStatisticsBuilder {
+ public:
+  ColumnStatisticsBuilder(const size_t sample_rows)
+      : registers_(1 << kStatisticsHllBits, 0)
+      , sample_rows_(std::max(sample_rows, size_t(1))) {}
+
+  void add(const std::vector<int64_t>& values) {
+    for (const auto value : values) {
+      ++row_count_;
+      if (value == std::numeric_limits<int64_t>::min()) {
+        ++null_count_;
+        continue;
+      }
+      const uint64_t hash = MurmurHash64A(&value, sizeof(value), 0);
+      auto& rank = registers_[hash >> (64 - kStatisticsHllBits)];
+      rank = std::max(rank,
+                      get_rank(hash << kStatisticsHllBits, 64 - kStatisticsHllBits));
+      // reservoir sampling, each non null value has the same chance to be in the sample
+      ++non_null_count_;
+      if (sample_.size() < sample_rows_) {
+        sample_.push_back(value);
+      } else {
+        const auto slot = random_engine_() % non_null_count_;
+        if (slot < sample_rows_) {
+          sample_[slot] = value;
+        }
+      }
+    }
+  }
+
+  Catalog_Namespace::ColumnStatistics finish() {
+    Catalog_Namespace::ColumnStatistics statistics;
+    statistics.rowCount = row_count_;
+    statistics.nullCount = null_count_;
+    if (sample_.empty()) {
+      return statistics;
+    }
+    std::sort(sample_.begin(), sample_.end());
+    std::vector<std::pair<int64_t, int64_t>> value_counts;
+    for (const auto value : sample_) {
+      if (value_counts.empty() || value_counts.back().first != value) {
+        value_counts.emplace_back(value, 0);
+      }
+      ++value_counts.back().second;
+    }
+    const bool exact = sample_.size() == non_null_count_;
+    statistics.ndv =
+        exact ? value_counts.size()
+              : std::max(hll_size(registers_.data(), kStatisticsHllBits),
+                         value_counts.size());
+
+    const auto bucket_count = std::min(kStatisticsHistogramBuckets, sample_.size() - 1);
+    for (size_t bucket = 0; bucket <= bucket_count; ++bucket) {
+      const auto idx = bucket_count ? bucket * (sample_.size() - 1) / bucket_count : 0;
+      statistics.histogramBounds.push_back(sample_[idx]);
+    }
+
+    // a value seen once in the sample isn't common
+    const auto common_count = std::min(kStatisticsMostCommonValues, value_counts.size());
+    std::partial_sort(value_counts.begin(),
+                      value_counts.begin() + common_count,
+                      value_counts.end(),
+                      [](const auto& lhs, const auto& rhs) {
+                        return lhs.second > rhs.second ||
+                               (lhs.second == rhs.second && lhs.first < rhs.first);
+                      });
+    const double scale = static_cast<double>(non_null_count_) / sample_.size();
+    for (size_t i = 0; i < common_count && value_counts[i].second > 1; ++i) {
+      statistics.mostCommonValues.emplace_back(
+          value_counts[i].first, std::llround(value_counts[i].second * scale));
+    }
+    return statistics;
+  }
+
+ private:
+  std::vector<uint8_t> registers_;
+  const size_t sample_rows_;
+  std::vector<int64_t> sample_;
+  std::mt19937_64 random_engine_;  // default seeded, ANALYZE is repeatable
+  size_t row_count_{0};
+  size_t null_count_{0};
+  size_t non_null_count_{0};
+};
+
+}  // namespace
+
+std::map<int, Catalog_Namespace::ColumnStatistics>
+TableOptimizer::computeColumnStatistics(const std::vector<int>& column_ids) const {
+  std::map<int, Catalog_Namespace::ColumnStatistics> statistics;
+  const auto physical_tds = cat_.getPhysicalTablesDescriptors(td_);
+  auto& data_mgr = cat_.getDataMgr();
+  const auto db_id = cat_.getCurrentDB().dbId;
+  std::vector<int64_t> values;
+  for (const auto column_id : column_ids) {
+    const auto cd = cat_.getMetadataForColumn(td_->tableId, column_id);
+    CHECK(cd);
+    const auto& ti = cd->columnType;
+    if (!(ti.is_integer() || ti.is_decimal() || ti.is_time() ||
+          (ti.is_dict_encoded_string() && ti.get_size() == sizeof(int32_t)))) {
+      LOG(INFO) << "Skipping the statistics of column " << cd->columnName;
+      continue;
+    }
+    ColumnStatisticsBuilder builder(g_statistics_sample_rows);
+    bool decoded{true};
+    for (const auto physical_td : physical_tds) {
+      CHECK(physical_td->fragmenter);
+      const auto table_info = physical_td->fragmenter->getFragmentsForQuery();
+      for (const auto& fragment : table_info.fragments) {
+        const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+        const auto chunk_meta_it = chunk_metadata_map.find(column_id);
+        CHECK(chunk_meta_it != chunk_metadata_map.end());
+        const auto& chunk_metadata = chunk_meta_it->second;
+        const ChunkKey chunk_key{
+            db_id, physical_td->tableId, column_id, fragment.fragmentId};
+        const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                                     &data_mgr,
+                                                     chunk_key,
+                                                     Data_Namespace::CPU_LEVEL,
+                                                     0,
+                                                     chunk_metadata->numBytes,
+                                                     chunk_metadata->numElements);
+        for (size_t begin = 0; decoded && begin < chunk_metadata->numElements;
+             begin += kStatisticsDecodeRows) {
+          const auto end =
+              std::min(begin + kStatisticsDecodeRows, chunk_metadata->numElements);
+          decoded = chunk->decodeValues(begin, end, values);
+          if (decoded) {
+            builder.add(values);
+          }
+        }
+        if (!decoded) {
+          break;
+        }
+      }
+    }
+    if (!decoded) {
+      LOG(WARNING) << "Could not decode the values of column " << cd->columnName;
+      continue;
+    }
+    statistics[column_id] = builder.finish();
+  }
+  return statistics;
+}
@@ -51,6 +51,44 @@ class TableOptimizer {
    */
   void vacuumDeletedRows() const;
 
+  /**
+   * @brief Reorders the rows of each fragment by the table's sort column.
+   * Inserts keep the rows of each insert in the order of the SORT_COLUMN, not the rows
+   * of a fragment filled by several inserts. Sorted fragments make the block zone maps
+   * narrower and let range filters on the sort column binary search the chunk.
+   */
+  void sortFragmentRows() const;
+
+  /**
+   * @brief Finds integer columns whose values fit a narrower fixed encoding.
+   * Returns, for each such column, its type with the narrowest fixed encoding that the
+   * chunk metadata of all fragments allows, to be applied with
+   * Catalog::reencodeColumn(). Columns without any non null value are skipped.
+   */
+  std::vector<std::pair<const ColumnDescriptor*, SQLTypeInfo>> getNarrowerColumnTypes()
+      const;
+
+  /**
+   * @brief Finds the dictionaries of the table's string columns which can be compacted.
+   * Deletes and updates leave strings in a dictionary which no row references any
+   * more. Returns the ids of the dictionaries used by scalar string columns of this
+   * table only, to be compacted with Catalog::compactDictionary(). Dictionaries shared
+   * with other tables or with string arrays, and those of temporary tables or of a
+   * string dictionary server, are skipped.
+   */
+  std::vector<int> getCompactableDictionaryIds() const;
+
+  /**
+   * @brief Collects the statistics of the given columns for the query planning.
+   * Reads the chunks of the integer, decimal, time and 32 bit dictionary encoded string
+   * columns among column_ids, to be persisted with Catalog::setColumnStatistics(); the
+   * other columns are skipped. The NDV is estimated with a HyperLogLog sketch of all the
+   * values, the histogram and the most common values come from a uniform sample of up to
+   * --statistics-sample-rows of them, all the values of smaller tables.
+   */
+  std::map<int, Catalog_Namespace::ColumnStatistics> computeColumnStatistics(
+      const std::vector<int>& column_ids) const;
+
  private:
   const TableDescriptor* td_;
   Executor* executor_;
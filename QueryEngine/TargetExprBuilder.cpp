@@ -65,6 +65,8 @@ std::vector<std::string> agg_fn_base_names(const TargetInfo& target_info) {
       return {"agg_approximate_count_distinct"};
     case kSINGLE_VALUE:
       return {"checked_single_agg_id"};
+    case kAPPROX_QUANTILE:
+      return {"agg_approx_quantile"};
     case kSAMPLE:
       return {"agg_id"};
     default:
@@ -122,7 +124,8 @@ void TargetExprCodegen::codegen(
   if (window_row_ptr) {
     agg_out_ptr_w_idx =
         std::make_tuple(window_row_ptr, std::get<1>(agg_out_ptr_w_idx_in));
-    if (window_function_is_aggregate(window_func->getKind())) {
+    if (window_function_is_aggregate(window_func->getKind()) &&
+        !window_function_is_frame_aggregate(window_func)) {
       out_row_idx = window_row_ptr;
     }
   }
@@ -179,6 +182,12 @@ void TargetExprCodegen::codegen(
       (!arg_expr || arg_expr->get_type_info().get_notnull())) {
     CHECK_EQ(size_t(1), agg_fn_names.size());
     const auto chosen_bytes = query_mem_desc.getPaddedSlotWidthBytes(slot_index);
+    // the rows of the baseline hash tables of the blocks spill to the global memory, so
+    // only the shared memory perfect hash rows are known to be in its address space
+    const bool is_shared_address_space =
+        gpu_smem_context.isSharedMemoryUsed() &&
+        query_mem_desc.getQueryDescriptionType() !=
+            QueryDescriptionType::GroupByBaselineHash;
     llvm::Value* agg_col_ptr{nullptr};
     if (is_group_by) {
       if (query_mem_desc.didOutputColumnar()) {
@@ -224,7 +233,7 @@ void TargetExprCodegen::codegen(
         auto acc_i32 = LL_BUILDER.CreateBitCast(
             is_group_by ? agg_col_ptr : agg_out_vec[slot_index],
             llvm::PointerType::get(get_int_type(32, LL_CONTEXT), 0));
-        if (gpu_smem_context.isSharedMemoryUsed()) {
+        if (is_shared_address_space) {
           acc_i32 = LL_BUILDER.CreatePointerCast(
               acc_i32, llvm::Type::getInt32PtrTy(LL_CONTEXT, 3));
         }
@@ -235,7 +244,7 @@ void TargetExprCodegen::codegen(
       }
     } else {
       const auto acc_i32 = (is_group_by ? agg_col_ptr : agg_out_vec[slot_index]);
-      if (gpu_smem_context.isSharedMemoryUsed()) {
+      if (is_shared_address_space) {
         // Atomic operation on address space level 3 (Shared):
         const auto shared_acc_i32 = LL_BUILDER.CreatePointerCast(
             acc_i32, llvm::Type::getInt32PtrTy(LL_CONTEXT, 3));
@@ -408,6 +417,9 @@ void TargetExprCodegen::codegenAggregate(
       CHECK(!chosen_type.is_fp());
       group_by_and_agg->codegenCountDistinct(
           target_idx, target_expr, agg_args, query_mem_desc, co.device_type);
+    } else if (target_info.agg_kind == kAPPROX_QUANTILE) {
+      CHECK_EQ(agg_chosen_bytes, sizeof(int64_t));
+      group_by_and_agg->codegenApproxQuantile(target_expr, agg_args, co.device_type);
     } else {
       const auto& arg_ti = target_info.agg_arg_type;
       if (need_skip_null && !arg_ti.is_geometry()) {
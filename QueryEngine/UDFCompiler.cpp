@@ -27,14 +27,21 @@
 #include <clang/Parse/ParseAST.h>
 #include <clang/Tooling/CommonOptionsParser.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/Support/Program.h>
 #include <llvm/Support/raw_ostream.h>
+#include <boost/filesystem.hpp>
 #include <boost/process/search_path.hpp>
+#include <fstream>
 #include <iterator>
 #include <memory>
+#include <optional>
+#include <sstream>
 
 #include "Execute.h"
+#include "JitObjectCache.h"
 #include "Logger/Logger.h"
+#include "MapDRelease.h"
 
 using namespace clang;
 using namespace clang::tooling;
@@ -154,6 +161,16 @@ class ToolFactory : public FrontendActionFactory {
 const char* convert(const std::string& s) {
   return s.c_str();
 }
+
+std::optional<std::string> read_file_contents(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  if (!file) {
+    return std::nullopt;
+  }
+  return contents.str();
+}
 }  // namespace
 
 UdfClangDriver::UdfClangDriver(const std::string& clang_path)
@@ -405,12 +422,95 @@ int UdfCompiler::compileForGpu() {
   return gpu_compile_result;
 }
 
+// The files generated for the UDF file and the extensions of their names in the
+// JitObjectCache
+std::vector<std::pair<std::string, std::string>> UdfCompiler::getCachedFiles() {
+  std::vector<std::pair<std::string, std::string>> cached_files{
+      {udf_ast_file_name_, "_udf.ast"},
+      {genCpuIrFilename(udf_file_name_.c_str()), "_udf_cpu.bc"}};
+#ifdef HAVE_CUDA
+  cached_files.emplace_back(genGpuIrFilename(udf_file_name_.c_str()), "_udf_gpu.bc");
+#endif
+  return cached_files;
+}
+
+// What the generated files depend on besides the UDF source: the headers shipped with
+// the release, the compiler and its options
+std::string UdfCompiler::getCacheTarget() const {
+  boost::system::error_code ec;
+  const auto clang_write_time = boost::filesystem::last_write_time(clang_path_, ec);
+  std::string target = MAPD_RELEASE + " LLVM " + LLVM_VERSION_STRING + " " + clang_path_ +
+                       " " + std::to_string(ec ? 0 : clang_write_time) + " " +
+                       CudaMgr_Namespace::CudaMgr::deviceArchToSM(target_arch_);
+  for (const auto& clang_option : clang_options_) {
+    target += " " + clang_option;
+  }
+  return target;
+}
+
+// Writes the files of the previous compilation of the same UDF source and compiler, if
+// the JitObjectCache has all of them, and reads the modules from them
+bool UdfCompiler::readCachedCompilation() {
+  auto object_cache = JitObjectCache::get();
+  const auto udf_source = read_file_contents(udf_file_name_);
+  if (!object_cache || !udf_source) {
+    return false;
+  }
+  const CodeCacheKey key{*udf_source};
+  const auto target = getCacheTarget();
+  std::vector<std::pair<std::string, std::string>> cached_contents;
+  for (const auto& [file_name, extension] : getCachedFiles()) {
+    auto contents =
+        object_cache->read(JitObjectCache::getObjectName(key, target, extension));
+    if (!contents) {
+      return false;
+    }
+    cached_contents.emplace_back(file_name, std::move(*contents));
+  }
+  for (const auto& [file_name, contents] : cached_contents) {
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+    if (!file) {
+      LOG(WARNING) << "Could not write the cached UDF compilation to " << file_name;
+      return false;
+    }
+  }
+  LOG(INFO) << "UDFCompiler reused the cached compilation of " << udf_file_name_;
+  readCpuCompiledModule();
+#ifdef HAVE_CUDA
+  readGpuCompiledModule();
+#endif
+  return true;
+}
+
+void UdfCompiler::cacheCompilation() {
+  auto object_cache = JitObjectCache::get();
+  const auto udf_source = read_file_contents(udf_file_name_);
+  if (!object_cache || !udf_source) {
+    return;
+  }
+  const CodeCacheKey key{*udf_source};
+  const auto target = getCacheTarget();
+  for (const auto& [file_name, extension] : getCachedFiles()) {
+    const auto contents = read_file_contents(file_name);
+    if (!contents) {
+      LOG(WARNING) << "Could not read " << file_name << " to cache it";
+      return;
+    }
+    object_cache->write(JitObjectCache::getObjectName(key, target, extension),
+                        *contents);
+  }
+}
+
 int UdfCompiler::compileUdf() {
   LOG(INFO) << "UDFCompiler filename to compile: " << udf_file_name_;
   if (!boost::filesystem::exists(udf_file_name_)) {
     LOG(FATAL) << "User defined function file " << udf_file_name_ << " does not exist.";
     return 1;
   }
+  if (readCachedCompilation()) {
+    return 0;
+  }
 
   auto ast_result = parseToAst(udf_file_name_.c_str());
 
@@ -442,6 +542,7 @@ int UdfCompiler::compileUdf() {
     LOG(FATAL) << "Unable to create AST file for udf compilation";
     return 1;
   }
+  cacheCompilation();
 
   return 0;
 }
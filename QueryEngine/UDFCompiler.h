@@ -29,6 +29,7 @@
 #include <clang/Driver/Driver.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "CudaMgr/CudaMgr.h"
@@ -74,6 +75,10 @@ class UdfCompiler {
   void readGpuCompiledModule();
   void readCpuCompiledModule();
   int compileForGpu();
+  std::vector<std::pair<std::string, std::string>> getCachedFiles();
+  std::string getCacheTarget() const;
+  bool readCachedCompilation();
+  void cacheCompilation();
 
  private:
   std::string udf_file_name_;
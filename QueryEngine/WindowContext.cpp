@@ -16,16 +16,28 @@
 
 #include "QueryEngine/WindowContext.h"
 
+#include <atomic>
+#include <future>
+#include <limits>
 #include <numeric>
+#include <optional>
+#include <type_traits>
 
+#include "DataMgr/Allocators/ThrustAllocator.h"
+#include "DataMgr/BufferMgr/BufferMgr.h"
 #include "QueryEngine/Descriptors/CountDistinctDescriptor.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/ExtractFromTime.h"
 #include "QueryEngine/OutputBufferInitialization.h"
 #include "QueryEngine/ResultSetBufferAccessors.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "QueryEngine/TypePunning.h"
+#include "QueryEngine/WindowSortImpl.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/sql_window_function_to_string.h"
+#include "Shared/thread_count.h"
+
+bool g_enable_window_function_gpu_sort{false};
 
 WindowFunctionContext::WindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
@@ -34,13 +46,16 @@ WindowFunctionContext::WindowFunctionContext(
     const ExecutorDeviceType device_type,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner)
     : window_func_(window_func)
+    , aggregate_column_(nullptr)
     , partitions_(partitions)
     , elem_count_(elem_count)
     , output_(nullptr)
     , partition_start_(nullptr)
     , partition_end_(nullptr)
     , device_type_(device_type)
-    , row_set_mem_owner_(row_set_mem_owner) {}
+    , row_set_mem_owner_(row_set_mem_owner)
+    , gpu_sort_data_mgr_(nullptr)
+    , keep_sorted_partitions_(false) {}
 
 WindowFunctionContext::~WindowFunctionContext() {
   free(partition_start_);
@@ -55,6 +70,34 @@ void WindowFunctionContext::addOrderColumn(
   order_columns_.push_back(column);
 }
 
+void WindowFunctionContext::setGpuSortDataMgr(Data_Namespace::DataMgr* data_mgr) {
+  gpu_sort_data_mgr_ = data_mgr;
+}
+
+void WindowFunctionContext::setSortedPartitions(
+    const std::shared_ptr<std::vector<int64_t>>& sorted_partitions) {
+  CHECK(sorted_partitions);
+  CHECK_EQ(sorted_partitions->size(), elem_count_);
+  sorted_partitions_ = sorted_partitions;
+}
+
+void WindowFunctionContext::keepSortedPartitions() {
+  keep_sorted_partitions_ = true;
+}
+
+const std::shared_ptr<std::vector<int64_t>>& WindowFunctionContext::getSortedPartitions()
+    const {
+  return sorted_partitions_;
+}
+
+void WindowFunctionContext::addAggregateColumn(
+    const int8_t* column,
+    const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  CHECK(window_function_is_frame_aggregate(window_func_));
+  aggregate_column_owner_ = chunks_owner;
+  aggregate_column_ = column;
+}
+
 namespace {
 
 // Converts the sorted indices to a mapping from row position to row number.
@@ -272,14 +315,19 @@ void index_to_partition_end(
     const int64_t* index,
     const size_t index_size,
     const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
-  int64_t partition_end_handle = reinterpret_cast<int64_t>(partition_end);
+  // the partitions computed by other threads can have their ends in the same bytes
+  const auto set_partition_end = [partition_end](const size_t pos) {
+    __atomic_fetch_or(const_cast<int8_t*>(partition_end) + (pos >> 3),
+                      static_cast<int8_t>(1 << (pos & 7)),
+                      __ATOMIC_RELAXED);
+  };
   for (size_t i = 0; i < index_size; ++i) {
     if (advance_current_rank(comparator, index, i)) {
-      agg_count_distinct_bitmap(&partition_end_handle, off + i - 1, 0);
+      set_partition_end(off + i - 1);
     }
   }
   CHECK(index_size);
-  agg_count_distinct_bitmap(&partition_end_handle, off + index_size - 1, 0);
+  set_partition_end(off + index_size - 1);
 }
 
 bool pos_is_set(const int64_t bitset, const int64_t pos) {
@@ -380,10 +428,375 @@ extern "C" void add_window_pending_output(void* pending_output, const int64_t ha
   reinterpret_cast<std::vector<void*>*>(handle)->push_back(pending_output);
 }
 
+namespace {
+
+// Below it, the partitions are all computed by the calling thread
+constexpr size_t kMinParallelWindowElements{100000};
+
+// Sorts the index of a partition by runs in worker_count threads, merged by pairs until
+// there is one left, as ResultSet::sortPermutation() does
+void parallel_sort(int64_t* index,
+                   const size_t index_size,
+                   const WindowFunctionContext::Comparator& comparator,
+                   const size_t worker_count) {
+  const size_t stride = (index_size + worker_count - 1) / worker_count;
+  std::vector<size_t> run_bounds;
+  for (size_t start = 0; start < index_size; start += stride) {
+    run_bounds.push_back(start);
+  }
+  run_bounds.push_back(index_size);
+  std::vector<std::future<void>> sort_futures;
+  for (size_t i = 0; i + 1 < run_bounds.size(); ++i) {
+    sort_futures.emplace_back(std::async(std::launch::async, [&, i] {
+      std::sort(index + run_bounds[i], index + run_bounds[i + 1], comparator);
+    }));
+  }
+  for (auto& sort_future : sort_futures) {
+    sort_future.get();
+  }
+  std::vector<int64_t> merged(index_size);
+  auto runs = index;
+  auto merged_runs = merged.data();
+  while (run_bounds.size() > 2) {
+    std::vector<size_t> merged_bounds;
+    std::vector<std::future<void>> merge_futures;
+    for (size_t i = 0; i + 1 < run_bounds.size(); i += 2) {
+      merged_bounds.push_back(run_bounds[i]);
+      const auto mid = run_bounds[i + 1];
+      const auto end = i + 2 < run_bounds.size() ? run_bounds[i + 2] : mid;
+      merge_futures.emplace_back(
+          std::async(std::launch::async, [&, start = run_bounds[i], mid, end] {
+            std::merge(runs + start,
+                       runs + mid,
+                       runs + mid,
+                       runs + end,
+                       merged_runs + start,
+                       comparator);
+          }));
+    }
+    merged_bounds.push_back(index_size);
+    for (auto& merge_future : merge_futures) {
+      merge_future.get();
+    }
+    std::swap(runs, merged_runs);
+    run_bounds.swap(merged_bounds);
+  }
+  if (runs != index) {
+    std::copy(runs, runs + index_size, index);
+  }
+}
+
+// Segment tree over the values of a partition in window order, which gives the aggregate
+// of any range of them in O(log n)
+template <class T, class AggOp>
+class SegmentTree {
+ public:
+  SegmentTree(const std::vector<T>& leaves, const T identity, const AggOp agg_op)
+      : leaf_count_(leaves.size())
+      , identity_(identity)
+      , agg_op_(agg_op)
+      , tree_(2 * leaves.size(), identity) {
+    std::copy(leaves.begin(), leaves.end(), tree_.begin() + leaf_count_);
+    for (size_t i = leaf_count_; i-- > 1;) {
+      tree_[i] = agg_op_(tree_[2 * i], tree_[2 * i + 1]);
+    }
+  }
+
+  // The aggregate of the leaves in [start, end)
+  T query(size_t start, size_t end) const {
+    T start_agg = identity_;
+    T end_agg = identity_;
+    for (start += leaf_count_, end += leaf_count_; start < end; start >>= 1, end >>= 1) {
+      if (start & 1) {
+        start_agg = agg_op_(start_agg, tree_[start++]);
+      }
+      if (end & 1) {
+        end_agg = agg_op_(tree_[--end], end_agg);
+      }
+    }
+    return agg_op_(start_agg, end_agg);
+  }
+
+ private:
+  const size_t leaf_count_;
+  const T identity_;
+  const AggOp agg_op_;
+  std::vector<T> tree_;
+};
+
+template <class T, class AggOp>
+SegmentTree<T, AggOp> make_segment_tree(const std::vector<T>& leaves,
+                                        const T identity,
+                                        const AggOp agg_op) {
+  return SegmentTree<T, AggOp>(leaves, identity, agg_op);
+}
+
+// Reads the value of an integer, decimal or time column at pos, none for nulls
+std::optional<int64_t> read_int_value(const int8_t* column,
+                                      const SQLTypeInfo& ti,
+                                      const int32_t pos) {
+  int64_t val;
+  switch (ti.get_size()) {
+    case 8: {
+      val = reinterpret_cast<const int64_t*>(column)[pos];
+      break;
+    }
+    case 4: {
+      val = reinterpret_cast<const int32_t*>(column)[pos];
+      break;
+    }
+    case 2: {
+      val = reinterpret_cast<const int16_t*>(column)[pos];
+      break;
+    }
+    case 1: {
+      val = column[pos];
+      break;
+    }
+    default: {
+      LOG(FATAL) << "Invalid type size: " << ti.get_size();
+      return std::nullopt;
+    }
+  }
+  if (val == inline_fixed_encoding_null_val(ti)) {
+    return std::nullopt;
+  }
+  return ti.is_date_in_days() ? val * kSecsPerDay : val;
+}
+
+// Reads the value of a floating point column at pos, none for nulls
+std::optional<double> read_fp_value(const int8_t* column,
+                                    const SQLTypeInfo& ti,
+                                    const int32_t pos) {
+  if (ti.get_type() == kFLOAT) {
+    const auto val = reinterpret_cast<const float*>(column)[pos];
+    if (val == inline_fp_null_value<float>()) {
+      return std::nullopt;
+    }
+    return val;
+  }
+  CHECK_EQ(kDOUBLE, ti.get_type());
+  const auto val = reinterpret_cast<const double*>(column)[pos];
+  if (val == inline_fp_null_value<double>()) {
+    return std::nullopt;
+  }
+  return val;
+}
+
+// The values of a partition in window order, the nulls being replaced by identity, and
+// the prefix counts of the values which aren't null
+template <class T>
+std::pair<std::vector<T>, std::vector<int64_t>> read_frame_values(
+    const int8_t* column,
+    const SQLTypeInfo& ti,
+    const int32_t* partition_row_offsets,
+    const std::vector<int64_t>& index,
+    const T identity) {
+  std::vector<T> values(index.size(), identity);
+  std::vector<int64_t> non_null_prefix(index.size() + 1, 0);
+  for (size_t i = 0; i < index.size(); ++i) {
+    std::optional<T> val;
+    if constexpr (std::is_floating_point_v<T>) {
+      val = read_fp_value(column, ti, partition_row_offsets[index[i]]);
+    } else {
+      val = read_int_value(column, ti, partition_row_offsets[index[i]]);
+    }
+    if (val) {
+      values[i] = *val;
+    }
+    non_null_prefix[i + 1] = non_null_prefix[i] + (val ? 1 : 0);
+  }
+  return {std::move(values), std::move(non_null_prefix)};
+}
+
+// Computes the aggregate over the ROWS frame of each row of a partition. The index holds
+// the rows of the partition in window order, it's overwritten with the value of each row
+// (a 64-bit integer, or the bits of a double for the floating point results) at their
+// positions in the partition, as for the rank functions. COUNT, and SUM and AVG of the
+// exact types, are differences of prefix aggregates, MIN, MAX and the floating point SUM
+// and AVG, whose rounding errors wouldn't cancel out, are given by a segment tree.
+void apply_frame_aggregate_to_partition(const Analyzer::WindowFunction* window_func,
+                                        const int8_t* aggregate_column,
+                                        const int32_t* partition_row_offsets,
+                                        int64_t* output_for_partition_buff,
+                                        const size_t partition_size) {
+  const auto& rows_frame = *window_func->getRowsFrame();
+  const std::vector<int64_t> index(output_for_partition_buff,
+                                   output_for_partition_buff + partition_size);
+  const int64_t row_count = partition_size;
+  // the frame of the row at position i is [frame_start(i), frame_end(i)), maybe empty
+  const auto clamp_to_partition = [row_count](const int64_t pos) {
+    return std::min(std::max(pos, int64_t(0)), row_count);
+  };
+  const auto clamp_offset = [row_count](const int64_t offset) {
+    return std::min(std::max(offset, -row_count), row_count);
+  };
+  const auto frame_start = [&](const int64_t i) {
+    return rows_frame.start_offset
+               ? clamp_to_partition(i + clamp_offset(*rows_frame.start_offset))
+               : int64_t(0);
+  };
+  const auto frame_end = [&](const int64_t i) {
+    return rows_frame.end_offset
+               ? clamp_to_partition(i + clamp_offset(*rows_frame.end_offset) + 1)
+               : row_count;
+  };
+  const auto kind = window_func->getKind();
+  const auto& window_func_ti = window_func->get_type_info();
+  auto output_fp = reinterpret_cast<double*>(may_alias_ptr(output_for_partition_buff));
+  const double null_fp = window_func_ti.get_type() == kFLOAT
+                             ? inline_fp_null_value<float>()
+                             : inline_fp_null_value<double>();
+  const auto& args = window_func->getArgs();
+  if (args.empty()) {
+    CHECK(kind == SqlWindowFunctionKind::COUNT);
+    for (int64_t i = 0; i < row_count; ++i) {
+      output_for_partition_buff[index[i]] =
+          std::max(frame_end(i) - frame_start(i), int64_t(0));
+    }
+    return;
+  }
+  CHECK(aggregate_column);
+  const auto& arg_ti = args.front()->get_type_info();
+  if (arg_ti.is_fp()) {
+    const bool is_min = kind == SqlWindowFunctionKind::MIN;
+    const bool is_max = kind == SqlWindowFunctionKind::MAX;
+    const double identity = is_min ? std::numeric_limits<double>::max()
+                                   : is_max ? std::numeric_limits<double>::lowest() : 0;
+    const auto [values, non_null_prefix] = read_frame_values(
+        aggregate_column, arg_ti, partition_row_offsets, index, identity);
+    const auto tree =
+        make_segment_tree(values, identity, [is_min, is_max](auto x, auto y) {
+          return is_min ? std::min(x, y) : is_max ? std::max(x, y) : x + y;
+        });
+    for (int64_t i = 0; i < row_count; ++i) {
+      const auto start = frame_start(i);
+      const auto end = std::max(frame_end(i), start);
+      const auto non_null_count = non_null_prefix[end] - non_null_prefix[start];
+      if (kind == SqlWindowFunctionKind::COUNT) {
+        output_for_partition_buff[index[i]] = non_null_count;
+        continue;
+      }
+      const auto agg = tree.query(start, end);
+      if (!non_null_count) {
+        output_fp[index[i]] = null_fp;
+      } else {
+        output_fp[index[i]] =
+            kind == SqlWindowFunctionKind::AVG ? agg / non_null_count : agg;
+      }
+    }
+    return;
+  }
+  if (!arg_ti.is_integer() && !arg_ti.is_decimal() && !arg_ti.is_time()) {
+    throw std::runtime_error("Type not supported yet in window frames");
+  }
+  const auto null_int = window_func_ti.is_fp() ? int64_t(0)
+                                               : inline_int_null_val(window_func_ti);
+  if (kind == SqlWindowFunctionKind::MIN || kind == SqlWindowFunctionKind::MAX) {
+    const bool is_min = kind == SqlWindowFunctionKind::MIN;
+    const int64_t identity = is_min ? std::numeric_limits<int64_t>::max()
+                                    : std::numeric_limits<int64_t>::min();
+    const auto [values, non_null_prefix] = read_frame_values(
+        aggregate_column, arg_ti, partition_row_offsets, index, identity);
+    const auto tree = make_segment_tree(values, identity, [is_min](auto x, auto y) {
+      return is_min ? std::min(x, y) : std::max(x, y);
+    });
+    for (int64_t i = 0; i < row_count; ++i) {
+      const auto start = frame_start(i);
+      const auto end = std::max(frame_end(i), start);
+      output_for_partition_buff[index[i]] =
+          non_null_prefix[end] == non_null_prefix[start] ? null_int
+                                                         : tree.query(start, end);
+    }
+    return;
+  }
+  const auto [values, non_null_prefix] = read_frame_values(
+      aggregate_column, arg_ti, partition_row_offsets, index, int64_t(0));
+  std::vector<int64_t> sum_prefix(row_count + 1, 0);
+  std::partial_sum(values.begin(), values.end(), sum_prefix.begin() + 1);
+  const double avg_scale = arg_ti.is_decimal() ? exp_to_scale(arg_ti.get_scale()) : 1;
+  for (int64_t i = 0; i < row_count; ++i) {
+    const auto start = frame_start(i);
+    const auto end = std::max(frame_end(i), start);
+    const auto non_null_count = non_null_prefix[end] - non_null_prefix[start];
+    const auto sum = sum_prefix[end] - sum_prefix[start];
+    switch (kind) {
+      case SqlWindowFunctionKind::COUNT: {
+        output_for_partition_buff[index[i]] = non_null_count;
+        break;
+      }
+      case SqlWindowFunctionKind::SUM: {
+        output_for_partition_buff[index[i]] = non_null_count ? sum : null_int;
+        break;
+      }
+      case SqlWindowFunctionKind::AVG: {
+        output_fp[index[i]] = non_null_count ? sum / avg_scale / non_null_count : null_fp;
+        break;
+      }
+      default: {
+        LOG(FATAL) << "Invalid window function kind";
+      }
+    }
+  }
+}
+
+// Whether the GPU sort orders the values of the type as the comparators do
+bool window_sort_key_is_supported(const SQLTypeInfo& ti) {
+  return ti.is_integer() || ti.is_decimal() || ti.is_time() || ti.is_boolean() ||
+         ti.is_fp();
+}
+
+// Fills keys with the values of the order column at the positions of the payload, mapped
+// to unsigned integers which sort ascending in the order of the collation, and
+// null_flags with the flags which sort the nulls where the comparators put them. Returns
+// whether there are any nulls.
+bool fill_window_sort_keys(std::vector<uint64_t>& keys,
+                           std::vector<uint8_t>& null_flags,
+                           const int8_t* order_column,
+                           const SQLTypeInfo& ti,
+                           const int32_t* payload,
+                           const size_t elem_count,
+                           const Analyzer::OrderEntry& collation) {
+  constexpr uint64_t sign_bit = uint64_t(1) << 63;
+  // the descending comparators swap the arguments of the ascending ones, nulls first
+  // included
+  const bool nulls_first = collation.is_desc ? !collation.nulls_first
+                                             : collation.nulls_first;
+  keys.resize(elem_count);
+  null_flags.resize(elem_count);
+  bool has_nulls{false};
+  for (size_t i = 0; i < elem_count; ++i) {
+    uint64_t key{0};
+    bool is_null;
+    if (ti.is_fp()) {
+      const auto val = read_fp_value(order_column, ti, payload[i]);
+      is_null = !val;
+      if (val) {
+        // the bits of the negative values are flipped, the sign of the others
+        const auto bits = *reinterpret_cast<const uint64_t*>(may_alias_ptr(&*val));
+        key = (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+      }
+    } else {
+      const auto val = read_int_value(order_column, ti, payload[i]);
+      is_null = !val;
+      if (val) {
+        key = static_cast<uint64_t>(*val) ^ sign_bit;
+      }
+    }
+    keys[i] = collation.is_desc ? ~key : key;
+    null_flags[i] = is_null == nulls_first ? 0 : 1;
+    has_nulls = has_nulls || is_null;
+  }
+  return has_nulls;
+}
+
+}  // namespace
+
 // Returns true iff the aggregate window function requires special multiplicity handling
 // to ensure that peer rows have the same value for the window function.
 bool window_function_requires_peer_handling(const Analyzer::WindowFunction* window_func) {
-  if (!window_function_is_aggregate(window_func->getKind())) {
+  if (!window_function_is_aggregate(window_func->getKind()) ||
+      window_function_is_frame_aggregate(window_func)) {
     return false;
   }
   if (window_func->getOrderKeys().empty()) {
@@ -404,74 +817,94 @@ void WindowFunctionContext::compute() {
   CHECK(!output_);
   output_ = static_cast<int8_t*>(row_set_mem_owner_->allocate(
       elem_count_ * window_function_buffer_element_size(window_func_->getKind())));
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  const bool is_streaming_aggregate =
+      window_function_is_aggregate(window_func_->getKind()) &&
+      !window_function_is_frame_aggregate(window_func_);
+  if (is_streaming_aggregate) {
     fillPartitionStart();
     if (window_function_requires_peer_handling(window_func_)) {
       fillPartitionEnd();
     }
   }
   std::unique_ptr<int64_t[]> scratchpad(new int64_t[elem_count_]);
-  int64_t off = 0;
-  for (size_t i = 0; i < partitionCount(); ++i) {
-    auto partition_size = counts()[i];
-    if (partition_size == 0) {
-      continue;
+  const size_t partition_count = partitionCount();
+  const size_t worker_count =
+      elem_count_ < kMinParallelWindowElements ? size_t(1) : cpu_threads();
+  bool already_sorted{false};
+  if (sorted_partitions_) {
+    std::copy(sorted_partitions_->begin(), sorted_partitions_->end(), scratchpad.get());
+    already_sorted = true;
+  } else {
+    already_sorted = sortPartitionsOnGpu(scratchpad.get());
+    if (keep_sorted_partitions_ && already_sorted) {
+      sorted_partitions_ = std::make_shared<std::vector<int64_t>>(
+          scratchpad.get(), scratchpad.get() + elem_count_);
+    } else if (keep_sorted_partitions_) {
+      // filled by partition as the partitions get sorted
+      sorted_partitions_ = std::make_shared<std::vector<int64_t>>(elem_count_);
     }
-    auto output_for_partition_buff = scratchpad.get() + offsets()[i];
-    std::iota(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              int64_t(0));
-    std::vector<Comparator> comparators;
-    const auto& order_keys = window_func_->getOrderKeys();
-    const auto& collation = window_func_->getCollation();
-    CHECK_EQ(order_keys.size(), collation.size());
-    for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
-         ++order_column_idx) {
-      auto order_column_buffer = order_columns_[order_column_idx];
-      const auto order_col =
-          dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
-      CHECK(order_col);
-      const auto& order_col_collation = collation[order_column_idx];
-      const auto asc_comparator = makeComparator(order_col,
-                                                 order_column_buffer,
-                                                 payload() + offsets()[i],
-                                                 order_col_collation.nulls_first);
-      auto comparator = asc_comparator;
-      if (order_col_collation.is_desc) {
-        comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
-          return asc_comparator(rhs, lhs);
-        };
-      }
-      comparators.push_back(comparator);
+  }
+  const size_t partition_sort_worker_count = already_sorted ? 0 : 1;
+  if (worker_count <= 1) {
+    for (size_t i = 0; i < partition_count; ++i) {
+      sortAndComputePartition(i, scratchpad.get(), partition_sort_worker_count);
     }
-    const auto col_tuple_comparator = [&comparators](const int64_t lhs,
-                                                     const int64_t rhs) {
-      for (const auto& comparator : comparators) {
-        if (comparator(lhs, rhs)) {
-          return true;
+  } else {
+    // Batches of consecutive partitions of about batch_size rows are computed by the
+    // threads as they get free. The large partitions are computed first, one at a time,
+    // each of them sorted by all of the threads.
+    const size_t batch_size = std::max(elem_count_ / (4 * worker_count), size_t(1));
+    const size_t large_partition_size = std::max(batch_size, kMinParallelWindowElements);
+    std::vector<std::pair<size_t, size_t>> batches;
+    size_t batch_start{0};
+    size_t batch_rows{0};
+    for (size_t i = 0; i < partition_count; ++i) {
+      const size_t partition_size = counts()[i];
+      if (partition_size >= large_partition_size) {
+        if (batch_start < i) {
+          batches.emplace_back(batch_start, i);
         }
+        batch_start = i + 1;
+        batch_rows = 0;
+        sortAndComputePartition(
+            i, scratchpad.get(), already_sorted ? 0 : worker_count);
+        continue;
       }
-      return false;
-    };
-    std::sort(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              col_tuple_comparator);
-    computePartition(output_for_partition_buff,
-                     partition_size,
-                     off,
-                     window_func_,
-                     col_tuple_comparator);
-    if (window_function_is_value(window_func_->getKind()) ||
-        window_function_is_aggregate(window_func_->getKind())) {
-      off += partition_size;
+      batch_rows += partition_size;
+      if (batch_rows >= batch_size) {
+        batches.emplace_back(batch_start, i + 1);
+        batch_start = i + 1;
+        batch_rows = 0;
+      }
+    }
+    if (batch_start < partition_count) {
+      batches.emplace_back(batch_start, partition_count);
+    }
+    std::atomic<size_t> next_batch{0};
+    std::vector<std::future<void>> batch_futures;
+    for (size_t w = 0; w < std::min(worker_count, batches.size()); ++w) {
+      batch_futures.emplace_back(std::async(std::launch::async, [&] {
+        for (auto b = next_batch++; b < batches.size(); b = next_batch++) {
+          for (size_t i = batches[b].first; i < batches[b].second; ++i) {
+            sortAndComputePartition(i, scratchpad.get(), partition_sort_worker_count);
+          }
+        }
+      }));
+    }
+    for (auto& batch_future : batch_futures) {
+      batch_future.wait();
+    }
+    for (auto& batch_future : batch_futures) {
+      batch_future.get();
     }
   }
   if (window_function_is_value(window_func_->getKind()) ||
       window_function_is_aggregate(window_func_->getKind())) {
-    CHECK_EQ(static_cast<size_t>(off), elem_count_);
+    CHECK_EQ(std::accumulate(counts(), counts() + partition_count, size_t(0)),
+             elem_count_);
   }
   auto output_i64 = reinterpret_cast<int64_t*>(output_);
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  if (is_streaming_aggregate) {
     std::copy(scratchpad.get(), scratchpad.get() + elem_count_, output_i64);
   } else {
     for (size_t i = 0; i < elem_count_; ++i) {
@@ -480,6 +913,136 @@ void WindowFunctionContext::compute() {
   }
 }
 
+void WindowFunctionContext::sortAndComputePartition(const size_t partition_idx,
+                                                    int64_t* scratchpad,
+                                                    const size_t sort_worker_count) {
+  const size_t partition_size = counts()[partition_idx];
+  if (partition_size == 0) {
+    return;
+  }
+  // the partitions are laid out in the payload in order, without gaps
+  const size_t off = offsets()[partition_idx];
+  auto output_for_partition_buff = scratchpad + off;
+  if (sort_worker_count) {
+    std::iota(output_for_partition_buff,
+              output_for_partition_buff + partition_size,
+              int64_t(0));
+  }
+  std::vector<Comparator> comparators;
+  const auto& order_keys = window_func_->getOrderKeys();
+  const auto& collation = window_func_->getCollation();
+  CHECK_EQ(order_keys.size(), collation.size());
+  for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
+       ++order_column_idx) {
+    auto order_column_buffer = order_columns_[order_column_idx];
+    const auto order_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
+    CHECK(order_col);
+    const auto& order_col_collation = collation[order_column_idx];
+    const auto asc_comparator = makeComparator(order_col,
+                                               order_column_buffer,
+                                               payload() + off,
+                                               order_col_collation.nulls_first);
+    auto comparator = asc_comparator;
+    if (order_col_collation.is_desc) {
+      comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
+        return asc_comparator(rhs, lhs);
+      };
+    }
+    comparators.push_back(comparator);
+  }
+  const Comparator col_tuple_comparator = [&comparators](const int64_t lhs,
+                                                         const int64_t rhs) {
+    // lexicographic, the later keys only order the rows the earlier ones don't
+    for (const auto& comparator : comparators) {
+      if (comparator(lhs, rhs)) {
+        return true;
+      }
+      if (comparator(rhs, lhs)) {
+        return false;
+      }
+    }
+    return false;
+  };
+  if (sort_worker_count > 1) {
+    parallel_sort(output_for_partition_buff,
+                  partition_size,
+                  col_tuple_comparator,
+                  sort_worker_count);
+  } else if (sort_worker_count == 1) {
+    std::sort(output_for_partition_buff,
+              output_for_partition_buff + partition_size,
+              col_tuple_comparator);
+  }
+  if (sort_worker_count && keep_sorted_partitions_) {
+    CHECK(sorted_partitions_);
+    std::copy(output_for_partition_buff,
+              output_for_partition_buff + partition_size,
+              sorted_partitions_->begin() + off);
+  }
+  computePartition(
+      output_for_partition_buff, partition_size, off, window_func_, col_tuple_comparator);
+}
+
+bool WindowFunctionContext::sortPartitionsOnGpu(int64_t* scratchpad) const {
+#ifdef HAVE_CUDA
+  if (!gpu_sort_data_mgr_ || !g_enable_window_function_gpu_sort ||
+      elem_count_ < kMinParallelWindowElements || order_columns_.empty()) {
+    return false;
+  }
+  const auto& order_keys = window_func_->getOrderKeys();
+  const auto& collation = window_func_->getCollation();
+  CHECK_EQ(order_keys.size(), order_columns_.size());
+  std::vector<std::vector<uint64_t>> keys(order_columns_.size());
+  std::vector<std::vector<uint8_t>> null_flags(order_columns_.size());
+  std::vector<WindowSortKey> sort_keys;
+  for (size_t i = 0; i < order_columns_.size(); ++i) {
+    const auto order_col = dynamic_cast<const Analyzer::ColumnVar*>(order_keys[i].get());
+    CHECK(order_col);
+    const auto& order_col_ti = order_col->get_type_info();
+    if (!window_sort_key_is_supported(order_col_ti)) {
+      return false;
+    }
+    const bool has_nulls = fill_window_sort_keys(keys[i],
+                                                 null_flags[i],
+                                                 order_columns_[i],
+                                                 order_col_ti,
+                                                 payload(),
+                                                 elem_count_,
+                                                 collation[i]);
+    sort_keys.push_back({keys[i].data(), has_nulls ? null_flags[i].data() : nullptr});
+  }
+  const size_t partition_count = partitionCount();
+  std::vector<int32_t> partition_ids(elem_count_);
+  for (size_t i = 0; i < partition_count; ++i) {
+    const auto partition_begin = partition_ids.begin() + offsets()[i];
+    std::fill(partition_begin, partition_begin + counts()[i], i);
+  }
+  std::vector<int32_t> sorted_positions(elem_count_);
+  try {
+    ThrustAllocator thrust_allocator(gpu_sort_data_mgr_, 0);
+    sort_window_partitions_on_gpu(sorted_positions.data(),
+                                  partition_ids.data(),
+                                  sort_keys,
+                                  elem_count_,
+                                  thrust_allocator);
+  } catch (const OutOfMemory& e) {
+    LOG(INFO) << "Sorting the window partitions on the CPU: " << e.what();
+    return false;
+  }
+  // the partitions keep their ranges, the positions become relative to them
+  for (size_t i = 0; i < partition_count; ++i) {
+    const size_t off = offsets()[i];
+    for (size_t pos = off; pos < off + counts()[i]; ++pos) {
+      scratchpad[pos] = sorted_positions[pos] - off;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif  // HAVE_CUDA
+}
+
 const Analyzer::WindowFunction* WindowFunctionContext::getWindowFunction() const {
   return window_func_;
 }
@@ -717,6 +1280,14 @@ void WindowFunctionContext::computePartition(
     case SqlWindowFunctionKind::SUM:
     case SqlWindowFunctionKind::COUNT: {
       const auto partition_row_offsets = payload() + off;
+      if (window_function_is_frame_aggregate(window_func)) {
+        apply_frame_aggregate_to_partition(window_func,
+                                           aggregate_column_,
+                                           partition_row_offsets,
+                                           output_for_partition_buff,
+                                           partition_size);
+        break;
+      }
       if (window_function_requires_peer_handling(window_func)) {
         index_to_partition_end(
             partitionEnd(), off, output_for_partition_buff, partition_size, comparator);
@@ -21,7 +21,15 @@
 #include "QueryEngine/JoinHashTable/JoinHashTableInterface.h"
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
+#include <vector>
+
+extern bool g_enable_window_function_gpu_sort;
+
+namespace Data_Namespace {
+class DataMgr;
+}
 
 // Returns true for value window functions, false otherwise.
 inline bool window_function_is_value(const SqlWindowFunctionKind kind) {
@@ -55,6 +63,15 @@ inline bool window_function_is_aggregate(const SqlWindowFunctionKind kind) {
   }
 }
 
+// Returns true for the aggregate window functions over a ROWS frame. The other aggregates
+// are computed by the generated code over the rows in window order, these are computed
+// by the window function context, as the rank functions are.
+inline bool window_function_is_frame_aggregate(
+    const Analyzer::WindowFunction* window_func) {
+  return window_function_is_aggregate(window_func->getKind()) &&
+         window_func->getRowsFrame().has_value();
+}
+
 class Executor;
 
 // Per-window function context which encapsulates the logic for computing the various
@@ -82,6 +99,28 @@ class WindowFunctionContext {
                       const Analyzer::ColumnVar* col_var,
                       const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
+  // Adds the buffer of the column a frame aggregate is computed over to the context and
+  // keeps ownership of it.
+  void addAggregateColumn(
+      const int8_t* column,
+      const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
+  // Sorts the partitions on the GPU of data_mgr when there are enough rows, the window
+  // function itself is still computed on the CPU.
+  void setGpuSortDataMgr(Data_Namespace::DataMgr* data_mgr);
+
+  // Reuses the partitions as sorted for another window function with the same partitions,
+  // order keys and collation, instead of sorting them again.
+  void setSortedPartitions(
+      const std::shared_ptr<std::vector<int64_t>>& sorted_partitions);
+
+  // Keeps the sorted partitions when computing, for the window functions reusing them.
+  void keepSortedPartitions();
+
+  // Returns the positions of the rows of each partition in window order, relative to the
+  // partition, null unless they were kept or reused.
+  const std::shared_ptr<std::vector<int64_t>>& getSortedPartitions() const;
+
   // Computes the window function result to be used during the actual projection query.
   void compute();
 
@@ -131,6 +170,17 @@ class WindowFunctionContext {
                                    const int32_t* partition_indices,
                                    const bool nulls_first);
 
+  // Sorts the partition at partition_idx by the order keys into its range of scratchpad,
+  // with sort_worker_count threads, and computes the window function over it. The range
+  // is left as it is, already sorted, for a sort_worker_count of 0.
+  void sortAndComputePartition(const size_t partition_idx,
+                               int64_t* scratchpad,
+                               const size_t sort_worker_count);
+
+  // Sorts all the partitions by the order keys into their ranges of scratchpad on the
+  // GPU, false when they are to be sorted on the CPU
+  bool sortPartitionsOnGpu(int64_t* scratchpad) const;
+
   void computePartition(
       int64_t* output_for_partition_buff,
       const size_t partition_size,
@@ -155,6 +205,10 @@ class WindowFunctionContext {
   std::vector<std::vector<std::shared_ptr<Chunk_NS::Chunk>>> order_columns_owner_;
   // Order column buffers.
   std::vector<const int8_t*> order_columns_;
+  // Keeps ownership of the column of a frame aggregate.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> aggregate_column_owner_;
+  // The column buffer of a frame aggregate, null for COUNT(*) and the other functions.
+  const int8_t* aggregate_column_;
   // Hash table which contains the partitions specified by the window.
   std::shared_ptr<JoinHashTableInterface> partitions_;
   // The number of elements in the table.
@@ -171,6 +225,11 @@ class WindowFunctionContext {
   AggregateState aggregate_state_;
   const ExecutorDeviceType device_type_;
   std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
+  // The data manager of the GPU the partitions are sorted on, if any.
+  Data_Namespace::DataMgr* gpu_sort_data_mgr_;
+  // The sorted partitions shared with the other window functions, if any.
+  std::shared_ptr<std::vector<int64_t>> sorted_partitions_;
+  bool keep_sorted_partitions_;
 };
 
 // Keeps track of the multiple window functions in a window query.
@@ -59,6 +59,22 @@ llvm::Value* Executor::codegenWindowFunction(const size_t target_index,
     case SqlWindowFunctionKind::MAX:
     case SqlWindowFunctionKind::SUM:
     case SqlWindowFunctionKind::COUNT: {
+      if (window_function_is_frame_aggregate(window_func)) {
+        // computed over the frames by the context, read as the rank functions are
+        const auto output_lv = cgen_state_->llInt(
+            reinterpret_cast<const int64_t>(window_func_context->output()));
+        const auto& window_func_ti = window_func->get_type_info();
+        if (!window_func_ti.is_fp()) {
+          return cgen_state_->emitCall("row_number_window_func",
+                                       {output_lv, code_generator.posArg(nullptr)});
+        }
+        const auto frame_agg_lv = cgen_state_->emitCall(
+            "percent_window_func", {output_lv, code_generator.posArg(nullptr)});
+        return window_func_ti.get_type() == kFLOAT
+                   ? cgen_state_->ir_builder_.CreateFPTrunc(
+                         frame_agg_lv, llvm::Type::getFloatTy(cgen_state_->context_))
+                   : frame_agg_lv;
+      }
       return codegenWindowFunctionAggregate(co);
     }
     default: {
@@ -0,0 +1,69 @@
+#include "DataMgr/Allocators/ThrustAllocator.h"
+#include "GpuMemUtils.h"
+#include "WindowSortImpl.h"
+
+#include <thrust/device_ptr.h>
+#include <thrust/execution_policy.h>
+#include <thrust/gather.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+
+namespace {
+
+// Reorders the positions by the keys of the rows they are at, keeping the order of the
+// ties from the previous passes. The keys are only on the device for the pass.
+template <typename T>
+void stable_sort_positions_by_key(thrust::device_ptr<int32_t> dev_positions,
+                                  const T* host_keys,
+                                  const size_t elem_count,
+                                  ThrustAllocator& thrust_allocator) {
+  const auto keys_bytes = elem_count * sizeof(T);
+  auto dev_keys_buff = thrust_allocator.allocate(2 * keys_bytes);
+  thrust::device_ptr<T> dev_keys(reinterpret_cast<T*>(dev_keys_buff));
+  thrust::device_ptr<T> dev_sorted_keys(reinterpret_cast<T*>(dev_keys_buff + keys_bytes));
+  copy_to_gpu(thrust_allocator.getDataMgr(),
+              reinterpret_cast<CUdeviceptr>(dev_keys.get()),
+              host_keys,
+              keys_bytes,
+              thrust_allocator.getDeviceId());
+  thrust::gather(thrust::device(thrust_allocator),
+                 dev_positions,
+                 dev_positions + elem_count,
+                 dev_keys,
+                 dev_sorted_keys);
+  thrust::stable_sort_by_key(thrust::device(thrust_allocator),
+                             dev_sorted_keys,
+                             dev_sorted_keys + elem_count,
+                             dev_positions);
+  thrust_allocator.deallocate(dev_keys_buff, 2 * keys_bytes);
+}
+
+}  // namespace
+
+void sort_window_partitions_on_gpu(int32_t* sorted_positions,
+                                   const int32_t* partition_ids,
+                                   const std::vector<WindowSortKey>& sort_keys,
+                                   const size_t elem_count,
+                                   ThrustAllocator& thrust_allocator) {
+  if (!elem_count) {
+    return;
+  }
+  thrust::device_ptr<int32_t> dev_positions(reinterpret_cast<int32_t*>(
+      thrust_allocator.allocateScopedBuffer(elem_count * sizeof(int32_t))));
+  thrust::sequence(
+      thrust::device(thrust_allocator), dev_positions, dev_positions + elem_count);
+  for (auto it = sort_keys.rbegin(); it != sort_keys.rend(); ++it) {
+    stable_sort_positions_by_key(dev_positions, it->keys, elem_count, thrust_allocator);
+    if (it->null_flags) {
+      stable_sort_positions_by_key(
+          dev_positions, it->null_flags, elem_count, thrust_allocator);
+    }
+  }
+  stable_sort_positions_by_key(
+      dev_positions, partition_ids, elem_count, thrust_allocator);
+  copy_from_gpu(thrust_allocator.getDataMgr(),
+                sorted_positions,
+                reinterpret_cast<CUdeviceptr>(dev_positions.get()),
+                elem_count * sizeof(int32_t),
+                thrust_allocator.getDeviceId());
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    WindowSortImpl.h
+ * @brief   Sort of the rows of the window partitions by their order keys on the GPU
+ */
+
+#ifndef QUERYENGINE_WINDOWSORTIMPL_H
+#define QUERYENGINE_WINDOWSORTIMPL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThrustAllocator;
+
+// The keys of an order column for the positions of the partition payload, as unsigned
+// integers sorted ascending, and the null flags sorted before them, null when the column
+// has no nulls
+struct WindowSortKey {
+  const uint64_t* keys;
+  const uint8_t* null_flags;
+};
+
+// Sorts the positions of the partition payload by partition, then by the order keys, the
+// first one being the most significant, with stable radix sorts from the least
+// significant key on the device of the allocator. The positions are written to
+// sorted_positions, by partition and in window order in each of them.
+void sort_window_partitions_on_gpu(int32_t* sorted_positions,
+                                   const int32_t* partition_ids,
+                                   const std::vector<WindowSortKey>& sort_keys,
+                                   const size_t elem_count,
+                                   ThrustAllocator& thrust_allocator);
+
+#endif  // QUERYENGINE_WINDOWSORTIMPL_H
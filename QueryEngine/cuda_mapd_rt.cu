@@ -25,6 +25,10 @@ extern "C" __device__ int64_t get_block_index() {
   return blockIdx.x;
 }
 
+extern "C" __device__ int64_t get_block_dim() {
+  return blockDim.x;
+}
+
 extern "C" __device__ int32_t pos_start_impl(const int32_t* row_index_resume) {
   return blockIdx.x * blockDim.x + threadIdx.x;
 }
@@ -47,8 +51,10 @@ extern "C" __device__ const int64_t* init_shared_mem_nop(
   return groups_buffer;
 }
 
-extern "C" __device__ void write_back_nop(int64_t* dest, int64_t* src, const int32_t sz) {
-}
+extern "C" __device__ void write_back_nop(int64_t* dest,
+                                          int64_t* src,
+                                          const int32_t sz,
+                                          int32_t* error_codes) {}
 
 /*
  * Just declares and returns a dynamic shared memory pointer. Total size should be
@@ -80,6 +86,20 @@ extern "C" __device__ const int64_t* init_shared_mem(const int64_t* global_group
   return shared_groups_buffer;
 }
 
+/**
+ * Copies a perfect join hash table of hash_table_size bytes from the global memory to the
+ * shared memory of the block, where the threads of the block probe it from.
+ */
+extern "C" __device__ void init_shared_join_hash_table(int32_t* shared_hash_table,
+                                                       const int32_t* global_hash_table,
+                                                       const int32_t hash_table_size) {
+  const int32_t entry_count = hash_table_size >> 2;
+  for (int32_t pos = threadIdx.x; pos < entry_count; pos += blockDim.x) {
+    shared_hash_table[pos] = global_hash_table[pos];
+  }
+  __syncthreads();
+}
+
 #define init_group_by_buffer_gpu_impl init_group_by_buffer_gpu
 
 #include "GpuInitGroups.cu"
@@ -329,6 +349,87 @@ extern "C" __device__ int64_t* get_matching_group_value_columnar(
 #include "MurmurHash.cpp"
 #include "TopKRuntime.cpp"
 
+// A key stays within this many entries of its hash in the baseline hash table of the
+// block, past them the block's table is considered full for it
+#define SMEM_GROUP_BY_MAX_PROBES 32U
+
+/**
+ * Returns the row of key in the baseline hash table of the block, kept in the dynamic
+ * shared memory with smem_entry_count entries of the same layout as groups_buffer. Once
+ * the probing of the block's table runs past SMEM_GROUP_BY_MAX_PROBES entries, the key
+ * goes to groups_buffer in the global memory instead. A key can then have rows in both
+ * tables, the write back of the block's table at its end aggregates them together.
+ */
+template <bool WITH_WATCHDOG>
+__device__ int64_t* get_group_value_with_smem_spill_impl(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals,
+    const uint32_t smem_entry_count) {
+  extern __shared__ int64_t shared_groups_buffer[];
+  uint32_t h = key_hash(key, key_count, key_width) % smem_entry_count;
+  const uint32_t max_probes = min(smem_entry_count, SMEM_GROUP_BY_MAX_PROBES);
+  for (uint32_t probe = 0; probe < max_probes; ++probe) {
+    int64_t* matching_group = get_matching_group_value(
+        shared_groups_buffer, h, key, key_count, key_width, row_size_quad, init_vals);
+    if (matching_group) {
+      return matching_group;
+    }
+    h = (h + 1) % smem_entry_count;
+  }
+  return get_group_value_impl<WITH_WATCHDOG>(groups_buffer,
+                                             groups_buffer_entry_count,
+                                             key,
+                                             key_count,
+                                             key_width,
+                                             row_size_quad,
+                                             init_vals);
+}
+
+extern "C" __device__ int64_t* get_group_value_with_smem_spill(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals,
+    const uint32_t smem_entry_count) {
+  return get_group_value_with_smem_spill_impl<false>(groups_buffer,
+                                                     groups_buffer_entry_count,
+                                                     key,
+                                                     key_count,
+                                                     key_width,
+                                                     row_size_quad,
+                                                     init_vals,
+                                                     smem_entry_count);
+}
+
+extern "C" __device__ int64_t* get_group_value_with_smem_spill_with_watchdog(
+    int64_t* groups_buffer,
+    const uint32_t groups_buffer_entry_count,
+    const int64_t* key,
+    const uint32_t key_count,
+    const uint32_t key_width,
+    const uint32_t row_size_quad,
+    const int64_t* init_vals,
+    const uint32_t smem_entry_count) {
+  return get_group_value_with_smem_spill_impl<true>(groups_buffer,
+                                                    groups_buffer_entry_count,
+                                                    key,
+                                                    key_count,
+                                                    key_width,
+                                                    row_size_quad,
+                                                    init_vals,
+                                                    smem_entry_count);
+}
+
+#undef SMEM_GROUP_BY_MAX_PROBES
+
 __device__ int64_t atomicMax64(int64_t* address, int64_t val) {
   unsigned long long int* address_as_ull = (unsigned long long int*)address;
   unsigned long long int old = *address_as_ull, assumed;
@@ -23,7 +23,8 @@ struct TColSlotContext {
 enum TCountDistinctImplType {
   Invalid,
   Bitmap,
-  StdSet
+  StdSet,
+  HashSet
 }
 
 struct TCountDistinctDescriptor {
@@ -51,6 +52,7 @@ struct TResultSetBufferDescriptor {
   11: list<i32> target_groupby_indices,
   12: TCountDistinctDescriptors count_distinct_descriptors,
   13: bool force_4byte_float,
+  14: bool output_columnar
 }
 
 enum TAggKind {
@@ -87,5 +89,6 @@ struct TSerializedRows {
   7: list<i64> target_init_vals,
   8: list<binary> varlen_buffer,
   9: list<TCountDistinctSet> count_distinct_sets,
-  10: string explanation
+  10: string explanation,
+  11: list<i64> buffer_entry_counts
 }
@@ -442,7 +442,8 @@ std::shared_ptr<ExecutionResult> run_select_query_with_filter_push_down(
     const bool hoist_literals,
     const bool allow_loop_joins,
     const bool just_explain,
-    const bool with_filter_push_down) {
+    const bool with_filter_push_down,
+    QueryProfile* query_profile) {
   auto const& query_state = query_state_proxy.getQueryState();
   const auto& cat = query_state.getConstSessionInfo()->getCatalog();
   auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
@@ -474,6 +475,7 @@ std::shared_ptr<ExecutionResult> run_select_query_with_filter_push_down(
                                       true)
                             .plan_result;
   auto ra_executor = RelAlgExecutor(executor.get(), cat, query_ra);
+  ra_executor.setQueryProfile(query_profile);
   const auto& query_hints = ra_executor.getParsedQueryHints();
   if (query_hints.cpu_mode) {
     co.device_type = ExecutorDeviceType::CPU;
@@ -513,6 +515,7 @@ std::shared_ptr<ExecutionResult> run_select_query_with_filter_push_down(
                                        eo.gpu_input_mem_limit_percent,
                                        eo.allow_runtime_query_interrupt};
     auto new_ra_executor = RelAlgExecutor(executor.get(), cat, new_query_ra);
+    new_ra_executor.setQueryProfile(query_profile);
     return std::make_shared<ExecutionResult>(
         new_ra_executor.executeRelAlgQuery(co, eo_modified, false, nullptr));
   } else {
@@ -527,7 +530,8 @@ std::shared_ptr<ExecutionResult> QueryRunner::runSelectQuery(
     const ExecutorDeviceType device_type,
     const bool hoist_literals,
     const bool allow_loop_joins,
-    const bool just_explain) {
+    const bool just_explain,
+    QueryProfile* query_profile) {
   CHECK(session_info_);
   CHECK(!Catalog_Namespace::SysCatalog::instance().isAggregator());
   auto query_state = create_query_state(session_info_, query_str);
@@ -538,7 +542,8 @@ std::shared_ptr<ExecutionResult> QueryRunner::runSelectQuery(
                                                   hoist_literals,
                                                   allow_loop_joins,
                                                   just_explain,
-                                                  g_enable_filter_push_down);
+                                                  g_enable_filter_push_down,
+                                                  query_profile);
   }
 
   const auto& cat = session_info_->getCatalog();
@@ -551,7 +556,8 @@ std::shared_ptr<ExecutionResult> QueryRunner::runSelectQuery(
                                                   &allow_loop_joins,
                                                   &just_explain,
                                                   &query_state,
-                                                  &result](const size_t worker_id) {
+                                                  &result,
+                                                  query_profile](const size_t worker_id) {
         auto executor = Executor::getExecutor(worker_id);
         CompilationOptions co = CompilationOptions::defaults(device_type);
         co.opt_level = ExecutorOptLevel::LoopStrengthReduction;
@@ -581,6 +587,7 @@ std::shared_ptr<ExecutionResult> QueryRunner::runSelectQuery(
                                             true)
                                   .plan_result;
         auto ra_executor = RelAlgExecutor(executor.get(), cat, query_ra);
+        ra_executor.setQueryProfile(query_profile);
         const auto& query_hints = ra_executor.getParsedQueryHints();
         if (query_hints.cpu_mode) {
           co.device_type = ExecutorDeviceType::CPU;
@@ -41,6 +41,7 @@ struct UserMetadata;
 
 class ResultSet;
 class ExecutionResult;
+class QueryProfile;
 
 namespace Parser {
 class CopyTableStmt;
@@ -133,7 +134,8 @@ class QueryRunner {
       const ExecutorDeviceType device_type,
       const bool hoist_literals,
       const bool allow_loop_joins,
-      const bool just_explain = false);
+      const bool just_explain = false,
+      QueryProfile* query_profile = nullptr);
   virtual std::shared_ptr<ResultSet> runSQLWithAllowingInterrupt(
       const std::string& query_str,
       std::shared_ptr<Executor> executor,
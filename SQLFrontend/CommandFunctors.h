@@ -266,6 +266,8 @@ StandardCommand(Help, {
                "specified file and returns a CREATE TABLE statement\n";
   std::cout << "\\clear_cpu Releases CPU memory held by OmniSci server Data Manager\n";
   std::cout << "\\clear_gpu Releases GPU memory held by OmniSci server Data Manager\n";
+  std::cout << "\\compact_cpu Defragments the OmniSci server CPU buffer pool\n";
+  std::cout << "\\compact_gpu Defragments the OmniSci server GPU buffer pools\n";
 
   std::cout << "\\q Quit.\n";
   std::cout.flush();
@@ -20,6 +20,8 @@ enum ThriftService {
   kGET_TABLE_DETAILS,
   kCLEAR_MEMORY_GPU,
   kCLEAR_MEMORY_CPU,
+  kCOMPACT_MEMORY_GPU,
+  kCOMPACT_MEMORY_CPU,
   kINTERRUPT,
   kSET_TABLE_EPOCH,
   kSET_TABLE_EPOCH_BY_NAME,
@@ -87,6 +87,12 @@ bool thrift_with_retry(SERVICE_ENUM which_service,
       case kCLEAR_MEMORY_CPU:
         context.client.clear_cpu_memory(context.session);
         break;
+      case kCOMPACT_MEMORY_GPU:
+        context.client.compact_memory(context.session, "gpu");
+        break;
+      case kCOMPACT_MEMORY_CPU:
+        context.client.compact_memory(context.session, "cpu");
+        break;
       case kGET_HARDWARE_INFO:
         context.client.get_hardware_info(context.cluster_hardware_info, context.session);
         break;
@@ -765,6 +765,21 @@ void print_memory_info(ClientContext& context, std::string memory_level) {
     if (nodeIt.is_allocation_capped) {
       tss << "The allocation is capped!";
     }
+    if (nodeIt.is_pinned) {
+      tss << "Slabs are allocated as pinned host memory." << std::endl;
+    }
+    if (nodeIt.host_to_device_bytes || nodeIt.device_to_host_bytes) {
+      tss << std::fixed << std::setprecision(2)
+          << "Host to device: " << nodeIt.host_to_device_bytes / MB << " MB at "
+          << nodeIt.host_to_device_bandwidth_gbs << " GB/s, device to host: "
+          << nodeIt.device_to_host_bytes / MB << " MB at "
+          << nodeIt.device_to_host_bandwidth_gbs << " GB/s" << std::endl;
+    }
+    if (!nodeIt.eviction_policy.empty()) {
+      tss << "Eviction policy: " << nodeIt.eviction_policy << ", hits: " << nodeIt.num_hits
+          << ", misses: " << nodeIt.num_misses << ", evictions: " << nodeIt.num_evictions
+          << ", free space fragmentation: " << nodeIt.fragmentation_ratio << std::endl;
+    }
     tss << "SLAB     ST_PAGE NUM_PAGE  TOUCH         CHUNK_KEY" << std::endl;
     for (auto segIt = nodeIt.node_memory_data.begin();
          segIt != nodeIt.node_memory_data.end();
@@ -1395,6 +1410,14 @@ int main(int argc, char** argv) {
       if (thrift_with_retry(kCLEAR_MEMORY_CPU, context, nullptr)) {
         std::cout << "OmniSci Server CPU memory Cleared " << std::endl;
       }
+    } else if (!strncmp(line, "\\compact_gpu", 12)) {
+      if (thrift_with_retry(kCOMPACT_MEMORY_GPU, context, nullptr)) {
+        std::cout << "OmniSci Server GPU memory Compacted " << std::endl;
+      }
+    } else if (!strncmp(line, "\\compact_cpu", 12)) {
+      if (thrift_with_retry(kCOMPACT_MEMORY_CPU, context, nullptr)) {
+        std::cout << "OmniSci Server CPU memory Compacted " << std::endl;
+      }
     } else if (!strncmp(line, "\\memory_summary", 11)) {
       if (thrift_with_retry(kGET_MEMORY_SUMMARY, context, nullptr)) {
         print_memory_summary(context, "cpu");
@@ -71,8 +71,8 @@ std::string SQLTypeInfo::comp_name[kENCODING_LAST] =
 int64_t parse_numeric(const std::string_view s, SQLTypeInfo& ti) {
   assert(s.length() <= 20);
   size_t dot = s.find_first_of('.', 0);
-  std::string before_dot;
-  std::string after_dot;
+  std::string_view before_dot;
+  std::string_view after_dot;
   if (dot != std::string::npos) {
     // make .99 as 0.99, or std::stoll below throws exception 'std::invalid_argument'
     before_dot = (0 == dot) ? "0" : s.substr(0, dot);
@@ -84,11 +84,11 @@ int64_t parse_numeric(const std::string_view s, SQLTypeInfo& ti) {
   const bool is_negative = before_dot.find_first_of('-', 0) != std::string::npos;
   const int64_t sign = is_negative ? -1 : 1;
   int64_t result;
-  result = std::abs(std::stoll(before_dot));
+  result = std::abs(parse_int64(before_dot));
   int64_t fraction = 0;
   const size_t before_dot_digits = before_dot.length() - (is_negative ? 1 : 0);
   if (!after_dot.empty()) {
-    fraction = std::stoll(after_dot);
+    fraction = parse_int64(after_dot);
   }
   if (ti.get_dimension() == 0) {
     // set the type info based on the literal string
@@ -143,32 +143,39 @@ Datum StringToDatum(std::string_view s, SQLTypeInfo& ti) {
         d.bigintval = parse_numeric(s, ti);
         break;
       case kBIGINT:
-        d.bigintval = std::stoll(std::string(s));
+        d.bigintval = parse_int64(s);
         break;
       case kINT:
-        d.intval = std::stoi(std::string(s));
+        d.intval = parse_int(s);
         break;
       case kSMALLINT:
-        d.smallintval = std::stoi(std::string(s));
+        d.smallintval = parse_int(s);
         break;
       case kTINYINT:
-        d.tinyintval = std::stoi(std::string(s));
+        d.tinyintval = parse_int(s);
         break;
       case kFLOAT:
         d.floatval = std::stof(std::string(s));
         break;
       case kDOUBLE:
-        d.doubleval = std::stod(std::string(s));
+        if (!parse_double_fast(s, d.doubleval)) {
+          d.doubleval = std::stod(std::string(s));
+        }
         break;
       case kTIME:
         d.bigintval = DateTimeStringValidate<kTIME>()(std::string(s), ti.get_dimension());
         break;
       case kTIMESTAMP:
-        d.bigintval =
-            DateTimeStringValidate<kTIMESTAMP>()(std::string(s), ti.get_dimension());
+        if (!parse_iso_date_time<kTIMESTAMP>(s, ti.get_dimension(), d.bigintval)) {
+          d.bigintval =
+              DateTimeStringValidate<kTIMESTAMP>()(std::string(s), ti.get_dimension());
+        }
         break;
       case kDATE:
-        d.bigintval = DateTimeStringValidate<kDATE>()(std::string(s), ti.get_dimension());
+        if (!parse_iso_date_time<kDATE>(s, ti.get_dimension(), d.bigintval)) {
+          d.bigintval =
+              DateTimeStringValidate<kDATE>()(std::string(s), ti.get_dimension());
+        }
         break;
       case kPOINT:
       case kLINESTRING:
@@ -32,6 +32,11 @@
 #include <stdexcept>
 #include <string>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "Logger/Logger.h"
 
 namespace File_Namespace {
@@ -218,6 +223,27 @@ void renameForDelete(const std::string directoryName) {
   }
 }
 
+bool setThreadIoPriority(const int level) {
+#if defined(__linux__) && defined(SYS_ioprio_set)
+  // constants from linux/ioprio.h, which is not exported to user space everywhere
+  constexpr int kIoprioWhoProcess{1};
+  constexpr int kIoprioClassShift{13};
+  constexpr int kIoprioClassBestEffort{2};
+  constexpr int kIoprioClassIdle{3};
+  const int ioprio = level < 0 ? kIoprioClassIdle << kIoprioClassShift
+                               : (kIoprioClassBestEffort << kIoprioClassShift) |
+                                     std::min(level, 7);
+  // a "process" id of 0 means the calling thread
+  if (syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, ioprio) != 0) {
+    LOG(WARNING) << "Could not set I/O priority: " << std::strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 }  // namespace File_Namespace
 
 // Still temporary location but avoids the link errors in the new distributed branch.
@@ -151,4 +151,12 @@ size_t fileSize(FILE* f);
  */
 void renameForDelete(const std::string directoryName);
 
+/**
+ * @brief Sets the I/O scheduling priority of the calling thread.
+ * @param level 0 (highest) to 7 (lowest) within the best-effort class, or a negative
+ * value for the idle class, which only gets disk time nobody else wants.
+ * @return false if I/O priorities are not supported on this platform.
+ */
+bool setThreadIoPriority(const int level);
+
 }  // namespace File_Namespace
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/Metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "Logger/Logger.h"
+
+namespace metrics {
+
+size_t thread_slot() {
+  static std::atomic<size_t> next_slot{0};
+  // the threads take the slots round robin, a slot only shared once there are more
+  // threads than slots
+  thread_local const size_t slot =
+      next_slot.fetch_add(1, std::memory_order_relaxed) % Counter::kNumSlots;
+  return slot;
+}
+
+uint64_t Counter::value() const {
+  uint64_t value{0};
+  for (const auto& slot : slots_) {
+    value += slot.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)), bucket_counts_(new Counter[bounds_.size() + 1]) {
+  CHECK(std::is_sorted(bounds_.begin(), bounds_.end()));
+}
+
+void Histogram::observe(const double value) {
+  const auto bucket =
+      std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+  bucket_counts_[bucket].add();
+  auto& sum = sums_[thread_slot()].sum;
+  auto crt_sum = sum.load(std::memory_order_relaxed);
+  while (!sum.compare_exchange_weak(
+      crt_sum, crt_sum + value, std::memory_order_relaxed)) {
+  }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snapshot;
+  uint64_t cumulative_count{0};
+  for (size_t i = 0; i <= bounds_.size(); ++i) {
+    cumulative_count += bucket_counts_[i].value();
+    snapshot.cumulative_counts.push_back(cumulative_count);
+  }
+  for (const auto& slot : sums_) {
+    snapshot.sum += slot.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+const std::vector<double>& latency_buckets() {
+  static const std::vector<double> buckets{
+      0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 60};
+  return buckets;
+}
+
+namespace {
+
+std::string escape_label_value(const std::string& value) {
+  std::string escaped;
+  for (const auto c : value) {
+    switch (c) {
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      default:
+        escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// {a="x",b="y"}, empty without labels
+std::string labels_to_text(const Labels& labels) {
+  if (labels.empty()) {
+    return "";
+  }
+  std::string text{"{"};
+  for (const auto& [name, value] : labels) {
+    if (text.size() > 1) {
+      text += ",";
+    }
+    text += name + "=\"" + escape_label_value(value) + "\"";
+  }
+  return text + "}";
+}
+
+// the labels of the buckets of a histogram are its own plus the upper bound
+std::string bucket_labels_to_text(const std::string& labels_text, const std::string& le) {
+  const auto le_text = "le=\"" + le + "\"";
+  if (labels_text.empty()) {
+    return "{" + le_text + "}";
+  }
+  return labels_text.substr(0, labels_text.size() - 1) + "," + le_text + "}";
+}
+
+std::string value_to_text(const double value) {
+  if (std::isinf(value)) {
+    return value > 0 ? "+Inf" : "-Inf";
+  }
+  // the shortest of the texts which read back as the value, 0.1 rather than
+  // 0.10000000000000001
+  std::string text;
+  for (const int precision : {15, 17}) {
+    std::ostringstream oss;
+    oss.precision(precision);
+    oss << value;
+    text = oss.str();
+    if (std::stod(text) == value) {
+      break;
+    }
+  }
+  return text;
+}
+
+}  // namespace
+
+Registry& Registry::instance() {
+  static Registry registry;
+  return registry;
+}
+
+Registry::Family& Registry::getFamily(const std::string& name,
+                                      const std::string& help,
+                                      const std::string& type) {
+  auto& family = families_[name];
+  if (family.type.empty()) {
+    family.help = help;
+    family.type = type;
+  }
+  CHECK_EQ(family.type, type) << name;
+  return family;
+}
+
+Counter& Registry::counter(const std::string& name,
+                           const std::string& help,
+                           const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = getFamily(name, help, "counter");
+  auto& counter = family.counters[labels_to_text(labels)];
+  if (!counter) {
+    counter = std::make_unique<Counter>();
+  }
+  return *counter;
+}
+
+Histogram& Registry::histogram(const std::string& name,
+                               const std::string& help,
+                               const std::vector<double>& bounds,
+                               const Labels& labels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& family = getFamily(name, help, "histogram");
+  auto& histogram = family.histograms[labels_to_text(labels)];
+  if (!histogram) {
+    histogram = std::make_unique<Histogram>(bounds);
+  }
+  return *histogram;
+}
+
+size_t Registry::addCollector(Collector collector) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto collector_id = next_collector_id_++;
+  collectors_.emplace(collector_id, std::move(collector));
+  return collector_id;
+}
+
+void Registry::removeCollector(const size_t collector_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  collectors_.erase(collector_id);
+}
+
+std::string Registry::toText() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream oss;
+  for (const auto& [name, family] : families_) {
+    oss << "# HELP " << name << " " << family.help << "\n";
+    oss << "# TYPE " << name << " " << family.type << "\n";
+    for (const auto& [labels_text, counter] : family.counters) {
+      oss << name << labels_text << " " << counter->value() << "\n";
+    }
+    for (const auto& [labels_text, histogram] : family.histograms) {
+      const auto snapshot = histogram->snapshot();
+      const auto& bounds = histogram->getBounds();
+      for (size_t i = 0; i < snapshot.cumulative_counts.size(); ++i) {
+        const auto le = i < bounds.size() ? value_to_text(bounds[i]) : "+Inf";
+        oss << name << "_bucket" << bucket_labels_to_text(labels_text, le) << " "
+            << snapshot.cumulative_counts[i] << "\n";
+      }
+      oss << name << "_sum" << labels_text << " " << value_to_text(snapshot.sum) << "\n";
+      oss << name << "_count" << labels_text << " "
+          << snapshot.cumulative_counts.back() << "\n";
+    }
+  }
+  // the samples of a name stay together, whichever collectors they come from
+  std::vector<Sample> samples;
+  for (const auto& [collector_id, collector] : collectors_) {
+    collector(samples);
+  }
+  std::stable_sort(
+      samples.begin(), samples.end(), [](const Sample& lhs, const Sample& rhs) {
+        return lhs.name < rhs.name;
+      });
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const auto& sample = samples[i];
+    if (i == 0 || samples[i - 1].name != sample.name) {
+      oss << "# HELP " << sample.name << " " << sample.help << "\n";
+      oss << "# TYPE " << sample.name << " " << sample.type << "\n";
+    }
+    oss << sample.name << labels_to_text(sample.labels) << " "
+        << value_to_text(sample.value) << "\n";
+  }
+  return oss.str();
+}
+
+}  // namespace metrics
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    Metrics.h
+ * @brief   Counters and histograms of the server, in the Prometheus text format
+ *
+ * The hot paths only add to the counters and histograms they looked up once, e.g. into
+ * a function local static, and the additions of the threads go to slots on cache lines
+ * of their own, summed when the metrics are scraped. The stats the modules already keep,
+ * e.g. the hits of the buffer pools, are read at scrape time by collectors instead.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+//! The slot of the calling thread in the counters
+size_t thread_slot();
+
+class Counter {
+ public:
+  static constexpr size_t kNumSlots{16};
+
+  void add(const uint64_t n = 1) {
+    slots_[thread_slot()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const;
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Slot, kNumSlots> slots_;
+};
+
+class Histogram {
+ public:
+  //! The upper bounds of the buckets, in increasing order, +Inf aside
+  explicit Histogram(std::vector<double> bounds);
+
+  void observe(const double value);
+
+  struct Snapshot {
+    std::vector<uint64_t> cumulative_counts;  // by bucket, the last one is +Inf
+    double sum{0};
+  };
+
+  Snapshot snapshot() const;
+
+  const std::vector<double>& getBounds() const { return bounds_; }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<double> sum{0};
+  };
+
+  const std::vector<double> bounds_;
+  std::unique_ptr<Counter[]> bucket_counts_;
+  std::array<Slot, Counter::kNumSlots> sums_;
+};
+
+//! Observes the seconds from its construction to its destruction into a histogram
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Histogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedTimer() {
+    histogram_.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                     start_)
+                           .count());
+  }
+
+ private:
+  Histogram& histogram_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+//! The buckets of the latencies, in seconds
+const std::vector<double>& latency_buckets();
+
+//! A value read at scrape time by a collector
+struct Sample {
+  std::string name;
+  std::string help;
+  std::string type;  // "counter" or "gauge"
+  Labels labels;
+  double value;
+};
+
+class Registry {
+ public:
+  using Collector = std::function<void(std::vector<Sample>&)>;
+
+  static Registry& instance();
+
+  //! The counter of name and labels, created on the first call, valid for the lifetime
+  //! of the process
+  Counter& counter(const std::string& name,
+                   const std::string& help,
+                   const Labels& labels = {});
+
+  Histogram& histogram(const std::string& name,
+                       const std::string& help,
+                       const std::vector<double>& bounds,
+                       const Labels& labels = {});
+
+  //! Returns the id to remove the collector with, before what it reads is destroyed
+  size_t addCollector(Collector collector);
+
+  void removeCollector(const size_t collector_id);
+
+  //! All the metrics, in the Prometheus text exposition format 0.0.4
+  std::string toText() const;
+
+ private:
+  struct Family {
+    std::string help;
+    std::string type;
+    // by the text of the labels
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+  };
+
+  Family& getFamily(const std::string& name,
+                    const std::string& help,
+                    const std::string& type);
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Family> families_;
+  std::map<size_t, Collector> collectors_;
+  size_t next_collector_id_{0};
+};
+
+}  // namespace metrics
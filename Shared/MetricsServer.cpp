@@ -0,0 +1,139 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/MetricsServer.h"
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "Logger/Logger.h"
+#include "Shared/Metrics.h"
+
+namespace metrics {
+
+namespace {
+
+// how often the serving thread checks whether it has to stop
+constexpr int kPollTimeoutMs{500};
+
+constexpr size_t kMaxRequestSize{8192};
+
+bool send_all(const int fd, const std::string& data) {
+  size_t sent{0};
+  while (sent < data.size()) {
+    const auto n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    sent += n;
+  }
+  return true;
+}
+
+std::string http_response(const std::string& status,
+                          const std::string& content_type,
+                          const std::string& body) {
+  return "HTTP/1.1 " + status + "\r\nContent-Type: " + content_type +
+         "\r\nContent-Length: " + std::to_string(body.size()) +
+         "\r\nConnection: close\r\n\r\n" + body;
+}
+
+}  // namespace
+
+HttpServer::HttpServer(const int port) {
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    throw std::runtime_error("Failed to create the metrics socket: " +
+                             std::string(std::strerror(errno)));
+  }
+  const int reuse_addr{1};
+  ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse_addr, sizeof(reuse_addr));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      ::listen(listen_fd_, 16) < 0) {
+    const std::string error{std::strerror(errno)};
+    ::close(listen_fd_);
+    throw std::runtime_error("Failed to listen on the metrics port " +
+                             std::to_string(port) + ": " + error);
+  }
+  thread_ = std::thread([this] { serve(); });
+}
+
+HttpServer::~HttpServer() {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  ::close(listen_fd_);
+}
+
+void HttpServer::serve() {
+  while (running_) {
+    pollfd listen_poll_fd{listen_fd_, POLLIN, 0};
+    const auto ready = ::poll(&listen_poll_fd, 1, kPollTimeoutMs);
+    if (ready <= 0) {
+      continue;
+    }
+    const auto connection_fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (connection_fd < 0) {
+      continue;
+    }
+    handleConnection(connection_fd);
+    ::close(connection_fd);
+  }
+}
+
+void HttpServer::handleConnection(const int connection_fd) {
+  // a stalled client can't hold the thread for longer than the timeout
+  timeval timeout{1, 0};
+  ::setsockopt(connection_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  ::setsockopt(connection_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < kMaxRequestSize) {
+    const auto n = ::recv(connection_fd, buffer, sizeof(buffer), 0);
+    if (n <= 0) {
+      return;
+    }
+    request.append(buffer, n);
+  }
+  const auto request_line = request.substr(0, request.find("\r\n"));
+  if (request_line.rfind("GET /metrics ", 0) == 0 || request_line == "GET /metrics") {
+    send_all(connection_fd,
+             http_response("200 OK",
+                           "text/plain; version=0.0.4",
+                           Registry::instance().toText()));
+  } else {
+    send_all(connection_fd, http_response("404 Not Found", "text/plain", "Not Found\n"));
+  }
+}
+
+}  // namespace metrics
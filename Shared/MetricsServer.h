@@ -0,0 +1,51 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    MetricsServer.h
+ * @brief   The HTTP endpoint the metrics of the registry are scraped from
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+namespace metrics {
+
+/**
+ * Answers GET /metrics with the text of the registry, one request at a time, on a
+ * thread of its own. The scrapes are rare and small, which a blocking loop on the
+ * socket serves well enough without pulling in an HTTP library.
+ */
+class HttpServer {
+ public:
+  //! Throws if the port can't be bound
+  explicit HttpServer(const int port);
+
+  ~HttpServer();
+
+ private:
+  void serve();
+
+  void handleConnection(const int connection_fd);
+
+  int listen_fd_{-1};
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+}  // namespace metrics
@@ -17,6 +17,8 @@
 #include "StringTransform.h"
 #include "Logger/Logger.h"
 
+#include <charconv>
+#include <cmath>
 #include <numeric>
 #include <random>
 #include <regex>
@@ -171,6 +173,91 @@ std::string strip(std::string_view str) {
   return std::string(str.substr(i, j - i));
 }
 
+namespace {
+
+template <typename T>
+bool parse_plain_integer(const std::string_view str, T& value) {
+  const auto end = str.data() + str.size();
+  const auto [ptr, ec] = std::from_chars(str.data(), end, value);
+  return ec == std::errc() && ptr == end;
+}
+
+}  // namespace
+
+int parse_int(std::string_view str) {
+  int value;
+  // std::stoi() throws just the same for the strings std::from_chars() rejects
+  return parse_plain_integer(str, value) ? value : std::stoi(std::string(str));
+}
+
+int64_t parse_int64(std::string_view str) {
+  int64_t value;
+  return parse_plain_integer(str, value) ? value : std::stoll(std::string(str));
+}
+
+bool parse_double_fast(std::string_view str, double& value) {
+  // Clinger's fast path ("How to Read Floating Point Numbers Accurately", PLDI 1990):
+  // a mantissa of at most 15 digits and a power of ten of at most 10^22 are both exact
+  // doubles, so one IEEE operation on them rounds the decimal correctly, as strtod()
+  static constexpr double powers_of_ten[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  constexpr int max_exponent = 22;
+  constexpr int max_digits = 15;
+
+  auto p = str.begin();
+  const auto end = str.end();
+  const bool is_negative = p != end && *p == '-';
+  if (is_negative) {
+    ++p;
+  }
+  uint64_t mantissa = 0;
+  int num_digits = 0;
+  int exponent = 0;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    mantissa = 10 * mantissa + (*p - '0');
+    ++num_digits;
+  }
+  if (p != end && *p == '.') {
+    for (++p; p != end && *p >= '0' && *p <= '9'; ++p) {
+      mantissa = 10 * mantissa + (*p - '0');
+      ++num_digits;
+      --exponent;
+    }
+  }
+  if (num_digits == 0 || num_digits > max_digits) {
+    return false;
+  }
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    const bool is_negative_exponent = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+')) {
+      ++p;
+    }
+    int explicit_exponent = 0;
+    int num_exponent_digits = 0;
+    for (; p != end && *p >= '0' && *p <= '9' && num_exponent_digits < 4; ++p) {
+      explicit_exponent = 10 * explicit_exponent + (*p - '0');
+      ++num_exponent_digits;
+    }
+    if (num_exponent_digits == 0) {
+      return false;
+    }
+    exponent += is_negative_exponent ? -explicit_exponent : explicit_exponent;
+  }
+  if (p != end || std::abs(exponent) > max_exponent) {
+    return false;
+  }
+  double result = static_cast<double>(mantissa);
+  if (exponent < 0) {
+    result /= powers_of_ten[-exponent];
+  } else {
+    result *= powers_of_ten[exponent];
+  }
+  value = is_negative ? -result : result;
+  return true;
+}
+
 std::optional<size_t> inside_string_literal(
     const size_t start,
     const size_t length,
@@ -25,6 +25,7 @@
 #endif  // __CUDACC__
 
 #include <algorithm>
+#include <cstdint>
 #include <iomanip>
 #include <sstream>
 #include <string>
@@ -113,6 +114,17 @@ std::vector<std::string> split(std::string_view str,
 
 //! trim any whitespace from the left and right ends of a string
 std::string strip(std::string_view str);
+
+//! std::stoi() of str, without copying str into a std::string if it is a plain integer
+int parse_int(std::string_view str);
+
+//! std::stoll() of str, without copying str into a std::string if it is a plain integer
+int64_t parse_int64(std::string_view str);
+
+//! Parses a plain decimal number, such as -12.5e3, into the value std::strtod() gives
+//! it, as long as that takes no more than one correctly rounded multiplication or
+//! division. Returns false, leaving value unchanged, for any other string.
+bool parse_double_fast(std::string_view str, double& value);
 #endif  // __CUDACC__
 
 //! sanitize an SQL string
@@ -46,6 +46,11 @@ struct SystemParameters {
       1L << 32;  // max size of CPU buffer pool memory allocations [bytes], default=4GB
   size_t max_gpu_slab_size =
       1L << 32;  // max size of CPU buffer pool memory allocations [bytes], default=4GB
+  bool pinned_cpu_buffer_pool = false;  // page-lock CPU slabs for faster GPU transfers
+  bool numa_aware_cpu_buffer_pool = false;  // place CPU slabs and kernels per NUMA node
+  std::string cpu_buffer_eviction_policy = "lru";  // lru or lru2 (scan resistant)
+  std::string gpu_buffer_eviction_policy = "lru";
+  double max_resident_buffer_pool_fraction = 0.5;  // max share of the pinned columns
   double gpu_input_mem_limit = 0.9;  // Punt query to CPU if input mem exceeds % GPU mem
   std::string config_file = "";
   std::string ssl_cert_file = "";    // file path to server's certified PKI certificate
@@ -21,6 +21,7 @@
 #include <cstring>
 #include <ctime>
 #include <sstream>
+#include <string_view>
 #include <type_traits>
 #include "sqltypes.h"
 
@@ -205,4 +206,87 @@ class DateTimeStringValidate {
   std::tm tm_{0};
 };
 
+/**
+ * Parses the ISO 8601 dates YYYY-MM-DD, and the timestamps YYYY-MM-DD HH:MM:SS[.f] with
+ * a space or a T, without strptime(), into the value DateTimeStringValidate gives them.
+ * Returns false, leaving value unchanged, for any other string.
+ */
+template <SQLTypes SQL_TYPE>
+bool parse_iso_date_time(const std::string_view str,
+                         const int32_t dimen,
+                         int64_t& value) {
+  static_assert(SQL_TYPE == kDATE || SQL_TYPE == kTIMESTAMP);
+  const auto is_digit = [](const char c) { return c >= '0' && c <= '9'; };
+  // the field of num_digits digits at pos, which has to be in [min, max] as strptime()
+  // has it
+  const auto parse_field =
+      [&str, &is_digit](
+          const size_t pos, const size_t num_digits, const int min, const int max) {
+        int field = 0;
+        for (size_t i = pos; i < pos + num_digits; ++i) {
+          if (!is_digit(str[i])) {
+            return -1;
+          }
+          field = 10 * field + (str[i] - '0');
+        }
+        return field >= min && field <= max ? field : -1;
+      };
+  constexpr size_t date_size = 10;  // YYYY-MM-DD
+  if (str.size() < date_size || str[4] != '-' || str[7] != '-') {
+    return false;
+  }
+  std::tm tm{};
+  const int year = parse_field(0, 4, 0, 9999);
+  const int month = parse_field(5, 2, 1, 12);
+  tm.tm_mday = parse_field(8, 2, 1, 31);
+  if (year < 0 || month < 0 || tm.tm_mday < 0) {
+    return false;
+  }
+  tm.tm_year = year - 1900;
+  tm.tm_mon = month - 1;
+  if constexpr (SQL_TYPE == kDATE) {  // NOLINT
+    if (str.size() != date_size) {
+      return false;
+    }
+    value = static_cast<int64_t>(TimeGM::instance().my_timegm(&tm));
+    return true;
+  } else {
+    constexpr size_t timestamp_size = 19;  // YYYY-MM-DD HH:MM:SS
+    if (str.size() < timestamp_size || (str[10] != ' ' && str[10] != 'T') ||
+        str[13] != ':' || str[16] != ':') {
+      return false;
+    }
+    tm.tm_hour = parse_field(11, 2, 0, 23);
+    tm.tm_min = parse_field(14, 2, 0, 59);
+    tm.tm_sec = parse_field(17, 2, 0, 61);
+    if (tm.tm_hour < 0 || tm.tm_min < 0 || tm.tm_sec < 0) {
+      return false;
+    }
+    uint64_t frac = 0;
+    int32_t num_frac_digits = 0;
+    if (str.size() > timestamp_size) {
+      if (str[timestamp_size] != '.' || str.size() == timestamp_size + 1) {
+        return false;
+      }
+      for (size_t i = timestamp_size + 1; i < str.size(); ++i) {
+        // more digits would overflow the sscanf() of DateTimeStringValidate
+        if (!is_digit(str[i]) || ++num_frac_digits > 18) {
+          return false;
+        }
+        frac = 10 * frac + (str[i] - '0');
+      }
+    }
+    if (dimen > 0) {
+      const auto fsc = num_frac_digits > 0
+                           ? TimeGM::instance().parse_fractional_seconds(
+                                 frac, num_frac_digits, dimen)
+                           : 0;
+      value = static_cast<int64_t>(TimeGM::instance().my_timegm(&tm, fsc, dimen));
+    } else {
+      value = static_cast<int64_t>(TimeGM::instance().my_timegm(&tm));
+    }
+    return true;
+  }
+}
+
 #endif  // TIMEGM_H
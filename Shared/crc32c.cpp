@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace crc32c {
+
+namespace {
+
+constexpr uint32_t kPolynomial{0x82f63b78};  // reflected Castagnoli polynomial
+
+// slicing-by-8 tables, table[0] is the classic byte at a time table
+using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+Tables make_tables() {
+  Tables tables;
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (crc & 1 ? kPolynomial : 0);
+    }
+    tables[0][i] = crc;
+  }
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (size_t t = 1; t < tables.size(); ++t) {
+      tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+    }
+  }
+  return tables;
+}
+
+uint32_t extend_software(uint32_t crc, const uint8_t* data, size_t num_bytes) {
+  static const Tables tables = make_tables();
+  for (; num_bytes >= 8; num_bytes -= 8, data += 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    word ^= crc;
+    crc = tables[7][word & 0xff] ^ tables[6][(word >> 8) & 0xff] ^
+          tables[5][(word >> 16) & 0xff] ^ tables[4][(word >> 24) & 0xff] ^
+          tables[3][(word >> 32) & 0xff] ^ tables[2][(word >> 40) & 0xff] ^
+          tables[1][(word >> 48) & 0xff] ^ tables[0][word >> 56];
+  }
+  for (; num_bytes > 0; --num_bytes, ++data) {
+    crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xff];
+  }
+  return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t extend_hardware(uint32_t crc,
+                                                           const uint8_t* data,
+                                                           size_t num_bytes) {
+  // eight bytes per instruction, the unaligned tail one byte at a time
+  uint64_t crc64 = crc;
+  for (; num_bytes >= 8; num_bytes -= 8, data += 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; num_bytes > 0; --num_bytes, ++data) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+
+bool cpu_has_sse42() {
+  static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+  return has_sse42;
+}
+#endif
+
+}  // namespace
+
+uint32_t extend(const uint32_t crc, const int8_t* data, const size_t num_bytes) {
+  const auto bytes = reinterpret_cast<const uint8_t*>(data);
+#if defined(__x86_64__)
+  if (cpu_has_sse42()) {
+    return ~extend_hardware(~crc, bytes, num_bytes);
+  }
+#endif
+  return ~extend_software(~crc, bytes, num_bytes);
+}
+
+bool is_hardware_accelerated() {
+#if defined(__x86_64__)
+  return cpu_has_sse42();
+#else
+  return false;
+#endif
+}
+
+}  // namespace crc32c
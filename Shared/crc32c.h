@@ -0,0 +1,46 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    crc32c.h
+ * @brief   CRC32C (Castagnoli) checksums
+ *
+ * Uses the SSE4.2 crc32 instruction when the CPU supports it, checked once at runtime,
+ * and a table driven implementation otherwise. Both produce the same checksums.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace crc32c {
+
+/**
+ * Extends crc with num_bytes of data. Start with crc 0 for a new checksum.
+ */
+uint32_t extend(const uint32_t crc, const int8_t* data, const size_t num_bytes);
+
+inline uint32_t value(const int8_t* data, const size_t num_bytes) {
+  return extend(0, data, num_bytes);
+}
+
+/**
+ * True if extend() runs on the hardware crc32 instruction.
+ */
+bool is_hardware_accelerated();
+
+}  // namespace crc32c
@@ -77,11 +77,10 @@ int process_poly_ring(OGRLinearRing* ring,
         "All poly rings must have more than 3 points. Found ring with " +
             std::to_string(num_points_in_ring) + " points.");
   }
+  coords.reserve(coords.size() + 2 * num_points_in_ring);
   for (auto i = 0; i < num_points_in_ring; i++) {
-    OGRPoint point;
-    ring->getPoint(i, &point);
-    last_x = point.getX();
-    last_y = point.getY();
+    last_x = ring->getX(i);
+    last_y = ring->getY(i);
     coords.push_back(last_x);
     coords.push_back(last_y);
     if (bbox) {
@@ -295,6 +294,9 @@ std::unique_ptr<GeoBase> GeoBase::run(GeoBase::GeoOp op, double param) const {
     case GeoBase::GeoOp::kBUFFER:
       result = geom_->Buffer(param);
       break;
+    case GeoBase::GeoOp::kSIMPLIFY:
+      result = geom_->SimplifyPreserveTopology(param);
+      break;
     default:
       break;
   }
@@ -411,11 +413,10 @@ void GeoLineString::getColumns(std::vector<double>& coords,
   }
 
   BoundingBox bbox;
+  coords.reserve(coords.size() + 2 * linestring_geom->getNumPoints());
   for (auto i = 0; i < linestring_geom->getNumPoints(); i++) {
-    OGRPoint point;
-    linestring_geom->getPoint(i, &point);
-    double x = point.getX();
-    double y = point.getY();
+    double x = linestring_geom->getX(i);
+    double y = linestring_geom->getY(i);
     coords.push_back(x);
     coords.push_back(y);
     bbox.update(x, y);
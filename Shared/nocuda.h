@@ -22,6 +22,7 @@ typedef int CUresult;
 typedef int CUcontext;
 typedef void* CUmodule;
 typedef void* CUfunction;
+typedef void* CUstream;
 typedef int CUjit_option;
 typedef int CUlinkState;
 typedef unsigned long long CUdeviceptr;
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shared/numa.h"
+
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <cstdlib>
+#endif
+
+namespace numa {
+
+namespace {
+
+// Parses a sysfs cpu/node list such as "0-3,8-11".
+std::vector<int> parse_list(const std::string& list) {
+  std::vector<int> values;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    auto end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    const auto range = list.substr(pos, end - pos);
+    const auto dash = range.find('-');
+    try {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int value = first; value <= last; ++value) {
+        values.push_back(value);
+      }
+    } catch (const std::exception&) {
+      // ignore malformed entries, e.g. the trailing newline
+    }
+    pos = end + 1;
+  }
+  return values;
+}
+
+std::vector<int> read_list(const std::string& path) {
+  std::ifstream file(path);
+  std::string list;
+  if (!file || !std::getline(file, list)) {
+    return {};
+  }
+  return parse_list(list);
+}
+
+}  // namespace
+
+size_t get_num_nodes() {
+  return get_node_cpus().size();
+}
+
+const std::vector<std::vector<int>>& get_node_cpus() {
+  static const std::vector<std::vector<int>> node_cpus = [] {
+    std::vector<std::vector<int>> node_cpus;
+#ifdef __linux__
+    const auto nodes = read_list("/sys/devices/system/node/online");
+    for (const auto node : nodes) {
+      if (node < 0) {
+        continue;
+      }
+      if (static_cast<size_t>(node) >= node_cpus.size()) {
+        node_cpus.resize(node + 1);
+      }
+      node_cpus[node] = read_list("/sys/devices/system/node/node" +
+                                  std::to_string(node) + "/cpulist");
+    }
+#endif
+    if (node_cpus.empty()) {
+      node_cpus.resize(1);
+    }
+    return node_cpus;
+  }();
+  return node_cpus;
+}
+
+void* allocate_on_node(const size_t num_bytes, const int node) {
+#ifdef __linux__
+  auto ptr =
+      mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    return nullptr;
+  }
+  // Binding before first touch makes the kernel fault every page in on the node.
+  bind_to_node(ptr, num_bytes, node);
+  return ptr;
+#else
+  return malloc(num_bytes);
+#endif
+}
+
+void free_on_node(void* ptr, const size_t num_bytes) {
+#ifdef __linux__
+  munmap(ptr, num_bytes);
+#else
+  free(ptr);
+#endif
+}
+
+bool bind_to_node(void* ptr, const size_t num_bytes, const int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  constexpr int kMpolBind = 2;
+  constexpr unsigned kMpolMfMove = 1 << 1;
+  if (node < 0 || get_num_nodes() < 2) {
+    return false;
+  }
+  constexpr size_t kBitsPerMask = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> node_mask(node / kBitsPerMask + 1, 0);
+  node_mask[node / kBitsPerMask] |= 1UL << (node % kBitsPerMask);
+  // mbind requires a page aligned start address
+  const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto start = reinterpret_cast<uintptr_t>(ptr) & ~(page_size - 1);
+  const auto length = reinterpret_cast<uintptr_t>(ptr) + num_bytes - start;
+  return syscall(SYS_mbind,
+                 start,
+                 length,
+                 kMpolBind,
+                 node_mask.data(),
+                 node_mask.size() * kBitsPerMask + 1,
+                 kMpolMfMove) == 0;
+#else
+  return false;
+#endif
+}
+
+ScopedNodeAffinity::ScopedNodeAffinity(const int node) {
+#ifdef __linux__
+  const auto& node_cpus = get_node_cpus();
+  if (node_cpus.size() < 2 || node < 0 || static_cast<size_t>(node) >= node_cpus.size() ||
+      node_cpus[node].empty()) {
+    return;
+  }
+  if (pthread_getaffinity_np(pthread_self(), sizeof(previous_cpus_), &previous_cpus_)) {
+    return;
+  }
+  cpu_set_t node_set;
+  CPU_ZERO(&node_set);
+  for (const auto cpu : node_cpus[node]) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &node_set);
+    }
+  }
+  restore_ = pthread_setaffinity_np(pthread_self(), sizeof(node_set), &node_set) == 0;
+#endif
+}
+
+ScopedNodeAffinity::~ScopedNodeAffinity() {
+#ifdef __linux__
+  if (restore_) {
+    pthread_setaffinity_np(pthread_self(), sizeof(previous_cpus_), &previous_cpus_);
+  }
+#endif
+}
+
+}  // namespace numa
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    numa.h
+ * @brief   Minimal NUMA topology, memory binding and thread placement helpers
+ *
+ * Topology is read from sysfs and memory is bound through the mbind system call, so no
+ * dependency on libnuma is needed. On systems without NUMA support every helper degrades
+ * to a single node and binding / pinning become no-ops.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace numa {
+
+/**
+ * Number of NUMA nodes configured on this host, at least 1.
+ */
+size_t get_num_nodes();
+
+/**
+ * CPUs belonging to each NUMA node, indexed by node. Read once and cached.
+ */
+const std::vector<std::vector<int>>& get_node_cpus();
+
+/**
+ * Places the node containing a table fragment; consecutive fragments alternate nodes so
+ * scans spread evenly across sockets.
+ */
+inline int get_node_for_fragment(const int fragment_id, const size_t num_nodes) {
+  return num_nodes > 1 ? fragment_id % static_cast<int>(num_nodes) : 0;
+}
+
+/**
+ * Allocates page aligned memory whose pages are bound to the given node. Returns nullptr
+ * if the allocation fails.
+ */
+void* allocate_on_node(const size_t num_bytes, const int node);
+
+void free_on_node(void* ptr, const size_t num_bytes);
+
+/**
+ * Binds (and migrates, if already faulted in) the pages of an existing allocation to the
+ * given node. Returns false if the kernel rejected the request.
+ */
+bool bind_to_node(void* ptr, const size_t num_bytes, const int node);
+
+/**
+ * Restricts the calling thread to the CPUs of a node for the lifetime of the object and
+ * restores the previous affinity on destruction, so pooled worker threads can be reused
+ * for work placed on other nodes.
+ */
+class ScopedNodeAffinity {
+ public:
+  ScopedNodeAffinity(const int node);
+  ~ScopedNodeAffinity();
+
+  ScopedNodeAffinity(const ScopedNodeAffinity&) = delete;
+  ScopedNodeAffinity& operator=(const ScopedNodeAffinity&) = delete;
+
+ private:
+  bool restore_{false};
+#ifdef __linux__
+  cpu_set_t previous_cpus_;
+#endif
+};
+
+}  // namespace numa
@@ -76,7 +76,8 @@ enum SQLAgg {
   kCOUNT,
   kAPPROX_COUNT_DISTINCT,
   kSAMPLE,
-  kSINGLE_VALUE
+  kSINGLE_VALUE,
+  kAPPROX_QUANTILE
 };
 
 enum class SqlWindowFunctionKind {
@@ -104,6 +105,6 @@ enum StorageOption { kDISK = 0, kGPU = 1, kCPU = 2 };
 
 enum ViewRefreshOption { kMANUAL = 0, kAUTO = 1, kIMMEDIATE = 2 };
 
-enum class JoinType { INNER, LEFT, INVALID };
+enum class JoinType { INNER, LEFT, SEMI, INVALID };
 
 #endif  // SQLDEFS_H
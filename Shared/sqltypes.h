@@ -157,7 +157,7 @@ enum EncodingType {
   kENCODING_NONE = 0,          // no encoding
   kENCODING_FIXED = 1,         // Fixed-bit encoding
   kENCODING_RL = 2,            // Run Length encoding
-  kENCODING_DIFF = 3,          // Differential encoding
+  kENCODING_DIFF = 3,          // Offsets from a reference value per chunk
   kENCODING_DICT = 4,          // Dictionary encoding
   kENCODING_SPARSE = 5,        // Null encoding for sparse columns
   kENCODING_GEOINT = 6,        // Encoding coordinates as intergers
@@ -268,7 +268,8 @@ class SQLTypeInfo {
   HOST DEVICE inline int get_comp_param() const { return comp_param; }
   HOST DEVICE inline int get_size() const { return size; }
   inline int get_logical_size() const {
-    if (compression == kENCODING_FIXED || compression == kENCODING_DATE_IN_DAYS) {
+    if (compression == kENCODING_FIXED || compression == kENCODING_DATE_IN_DAYS ||
+        compression == kENCODING_DIFF) {
       SQLTypeInfo ti(type, dimension, scale, notnull, kENCODING_NONE, 0, subtype);
       return ti.get_size();
     }
@@ -677,9 +678,9 @@ class SQLTypeInfo {
             return sizeof(int16_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
+          case kENCODING_DIFF:
             return comp_param / 8;
           case kENCODING_RL:
-          case kENCODING_DIFF:
             break;
           default:
             assert(false);
@@ -691,9 +692,9 @@ class SQLTypeInfo {
             return sizeof(int32_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
+          case kENCODING_DIFF:
             return comp_param / 8;
           case kENCODING_RL:
-          case kENCODING_DIFF:
             break;
           default:
             assert(false);
@@ -707,9 +708,9 @@ class SQLTypeInfo {
             return sizeof(int64_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
+          case kENCODING_DIFF:
             return comp_param / 8;
           case kENCODING_RL:
-          case kENCODING_DIFF:
             break;
           default:
             assert(false);
@@ -756,8 +757,13 @@ class SQLTypeInfo {
               assert(false);  // disable compression for timestamp precisions
             }
             return comp_param / 8;
-          case kENCODING_RL:
           case kENCODING_DIFF:
+            if (type == kDATE || type == kINTERVAL_DAY_TIME ||
+                type == kINTERVAL_YEAR_MONTH) {
+              assert(false);  // dates use DAYS, intervals are never stored
+            }
+            return comp_param / 8;
+          case kENCODING_RL:
           case kENCODING_SPARSE:
             assert(false);
             break;
@@ -818,16 +824,22 @@ int64_t convert_decimal_value_to_scale(const int64_t decimal_value,
 
 inline SQLTypeInfo get_logical_type_info(const SQLTypeInfo& type_info) {
   EncodingType encoding = type_info.get_compression();
+  int comp_param = type_info.get_comp_param();
   if (encoding == kENCODING_DATE_IN_DAYS ||
       (encoding == kENCODING_FIXED && type_info.get_type() != kARRAY)) {
     encoding = kENCODING_NONE;
   }
+  if (encoding == kENCODING_DIFF) {
+    // the offsets and their reference only exist in storage
+    encoding = kENCODING_NONE;
+    comp_param = 0;
+  }
   return SQLTypeInfo(type_info.get_type(),
                      type_info.get_dimension(),
                      type_info.get_scale(),
                      type_info.get_notnull(),
                      encoding,
-                     type_info.get_comp_param(),
+                     comp_param,
                      type_info.get_subtype());
 }
 
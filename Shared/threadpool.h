@@ -20,9 +20,20 @@
 #include "tbb/task_group.h"
 #endif
 
+#include "Shared/thread_count.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 namespace threadpool {
 
@@ -72,6 +83,258 @@ class FuturesThreadPool<T, std::enable_if_t<std::is_object<T>::value>>
   }
 };
 
+/**
+ * Tracks completion of the tasks spawned by one WorkStealingThreadPool instance. The
+ * first exception thrown by a task is captured and rethrown on join.
+ */
+class WorkStealingTaskGroup {
+ public:
+  void taskStarted() { pending_tasks_.fetch_add(1); }
+
+  void taskFinished(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    if (error && !first_error_) {
+      first_error_ = error;
+    }
+    if (pending_tasks_.fetch_sub(1) == 1) {
+      cv_.notify_all();
+    }
+  }
+
+  bool done() const { return pending_tasks_.load() == 0; }
+
+  template <typename Rep, typename Period>
+  void waitFor(const std::chrono::duration<Rep, Period>& timeout) {
+    std::unique_lock<std::mutex> lock(group_mutex_);
+    cv_.wait_for(lock, timeout, [this] { return done(); });
+  }
+
+  void rethrowIfFailed() {
+    std::lock_guard<std::mutex> lock(group_mutex_);
+    if (first_error_) {
+      std::rethrow_exception(first_error_);
+    }
+  }
+
+ private:
+  std::atomic<size_t> pending_tasks_{0};
+  std::exception_ptr first_error_;
+  std::mutex group_mutex_;
+  std::condition_variable cv_;
+};
+
+/**
+ * Persistent pool of worker threads with one task deque per worker. Workers pop work
+ * from the back of their own deque and, once it runs dry, steal from the front of the
+ * other workers' deques, so a worker stuck on a large task does not leave the remaining
+ * queued tasks behind it waiting. Threads are created once for the lifetime of the
+ * process instead of once per task.
+ */
+class WorkStealingScheduler {
+ public:
+  struct Task {
+    std::function<void()> func;
+    WorkStealingTaskGroup* group;
+  };
+
+  static WorkStealingScheduler& instance() {
+    static WorkStealingScheduler scheduler(static_cast<size_t>(cpu_threads()));
+    return scheduler;
+  }
+
+  void submit(Task&& task) {
+    task.group->taskStarted();
+    // tasks spawned from a worker go to that worker's own deque to preserve locality,
+    // external submissions are distributed round robin
+    const auto queue_idx = current_worker_idx() >= 0
+                               ? static_cast<size_t>(current_worker_idx())
+                               : next_queue_.fetch_add(1) % queues_.size();
+    {
+      std::lock_guard<std::mutex> lock(queues_[queue_idx]->mutex);
+      queues_[queue_idx]->tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(idle_mutex_);
+      ++queued_tasks_;
+    }
+    idle_cv_.notify_one();
+  }
+
+  /**
+   * Waits until all tasks in the group have finished. A worker thread waiting on a
+   * nested group keeps executing queued tasks, so nested spawns cannot deadlock.
+   */
+  void wait(WorkStealingTaskGroup& group) {
+    const auto worker_idx = current_worker_idx();
+    while (!group.done()) {
+      if (worker_idx >= 0) {
+        Task task;
+        if (tryGetTask(static_cast<size_t>(worker_idx), task)) {
+          runTask(task);
+          continue;
+        }
+      }
+      group.waitFor(std::chrono::milliseconds(1));
+    }
+    group.rethrowIfFailed();
+  }
+
+  size_t workerCount() const { return workers_.size(); }
+
+  ~WorkStealingScheduler() {
+    {
+      std::lock_guard<std::mutex> lock(idle_mutex_);
+      threads_should_exit_ = true;
+    }
+    idle_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  WorkStealingScheduler(const size_t num_workers) {
+    const auto worker_count = std::max(num_workers, size_t(1));
+    for (size_t i = 0; i < worker_count; ++i) {
+      queues_.emplace_back(std::make_unique<TaskQueue>());
+    }
+    for (size_t i = 0; i < worker_count; ++i) {
+      workers_.emplace_back(&WorkStealingScheduler::worker, this, i);
+    }
+  }
+
+  static int& current_worker_idx() {
+    static thread_local int worker_idx{-1};
+    return worker_idx;
+  }
+
+  bool tryGetTask(const size_t worker_idx, Task& task) {
+    {
+      auto& own_queue = *queues_[worker_idx];
+      std::lock_guard<std::mutex> lock(own_queue.mutex);
+      if (!own_queue.tasks.empty()) {
+        task = std::move(own_queue.tasks.back());
+        own_queue.tasks.pop_back();
+        onTaskDequeued();
+        return true;
+      }
+    }
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      auto& victim_queue = *queues_[(worker_idx + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(victim_queue.mutex);
+      if (!victim_queue.tasks.empty()) {
+        task = std::move(victim_queue.tasks.front());
+        victim_queue.tasks.pop_front();
+        onTaskDequeued();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void onTaskDequeued() {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    --queued_tasks_;
+  }
+
+  static void runTask(Task& task) {
+    std::exception_ptr error;
+    try {
+      task.func();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    task.group->taskFinished(error);
+  }
+
+  void worker(const size_t worker_idx) {
+    current_worker_idx() = static_cast<int>(worker_idx);
+    while (true) {
+      Task task;
+      if (tryGetTask(worker_idx, task)) {
+        runTask(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(idle_mutex_);
+      idle_cv_.wait(lock, [this] { return queued_tasks_ > 0 || threads_should_exit_; });
+      if (threads_should_exit_) {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> next_queue_{0};
+
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cv_;
+  size_t queued_tasks_{0};
+  bool threads_should_exit_{false};
+};
+
+class WorkStealingThreadPoolBase {
+ public:
+  ~WorkStealingThreadPoolBase() {
+    // tasks reference this pool's group; never let them outlive it
+    if (!group_.done()) {
+      try {
+        WorkStealingScheduler::instance().wait(group_);
+      } catch (...) {
+      }
+    }
+  }
+
+ protected:
+  WorkStealingTaskGroup group_;
+};
+
+template <typename T, typename ENABLE = void>
+class WorkStealingThreadPool : public WorkStealingThreadPoolBase {
+ public:
+  WorkStealingThreadPool() {}
+
+  template <class Function, class... Args>
+  void spawn(Function&& f, Args&&... args) {
+    WorkStealingScheduler::instance().submit({[f, args...] { f(args...); }, &group_});
+  }
+
+  void join() { WorkStealingScheduler::instance().wait(group_); }
+};
+
+template <typename T>
+class WorkStealingThreadPool<T, std::enable_if_t<std::is_object<T>::value>>
+    : public WorkStealingThreadPoolBase {
+ public:
+  WorkStealingThreadPool() {}
+
+  template <class Function, class... Args>
+  void spawn(Function&& f, Args&&... args) {
+    results_.emplace_back(std::make_unique<T>());
+    auto result = results_.back().get();
+    WorkStealingScheduler::instance().submit(
+        {[result, f, args...] { *result = f(args...); }, &group_});
+  }
+
+  auto join() {
+    WorkStealingScheduler::instance().wait(group_);
+    std::vector<T> results;
+    results.reserve(results_.size());
+    for (auto& result : results_) {
+      results.push_back(std::move(*result));
+    }
+    return results;
+  }
+
+ private:
+  std::vector<std::unique_ptr<T>> results_;
+};
+
 #ifdef HAVE_TBB
 
 class TbbThreadPoolBase {
@@ -20,8 +20,10 @@
 #include "../Utils/StringLike.h"
 #include "LeafHostInfo.h"
 #include "Logger/Logger.h"
+#include "Shared/crc32c.h"
 #include "Shared/thread_count.h"
 #include "StringDictionaryClient.h"
+#include "StringSymbolTable.h"
 
 #include <sys/fcntl.h>
 #include <sys/mman.h>
@@ -33,6 +35,8 @@
 
 #include <tbb/parallel_for.h>
 
+#include <cstring>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <string_view>
@@ -75,6 +79,94 @@ void checked_munmap(void* addr, size_t length) {
   CHECK_EQ(0, munmap(addr, length));
 }
 
+bool write_fully(const int fd, const void* data, const size_t num_bytes) {
+  size_t bytes_written = 0;
+  while (bytes_written < num_bytes) {
+    const auto ret = write(
+        fd, static_cast<const char*>(data) + bytes_written, num_bytes - bytes_written);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    bytes_written += ret;
+  }
+  return true;
+}
+
+// Writes the parts to a file renamed to path, so that a crash leaves either the
+// previous or the new file
+bool write_file_atomically(const std::string& path,
+                           const std::vector<std::pair<const void*, size_t>>& parts) {
+  const auto tmp_path = path + ".tmp";
+  const int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = true;
+  for (const auto& part : parts) {
+    ok = ok && write_fully(fd, part.first, part.second);
+  }
+  ok = ok && fsync(fd) == 0;
+  close(fd);
+  return ok && rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+bool read_fully(const int fd, void* dst, const size_t num_bytes, const size_t offset) {
+  size_t bytes_read = 0;
+  while (bytes_read < num_bytes) {
+    const auto ret = pread(fd,
+                           static_cast<char*>(dst) + bytes_read,
+                           num_bytes - bytes_read,
+                           offset + bytes_read);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    bytes_read += ret;
+  }
+  return true;
+}
+
+// The sorted cache is persisted as its number of ids followed by the ids
+bool write_sorted_ids(const std::string& path, const std::vector<int32_t>& sorted_ids) {
+  const uint64_t num_ids = sorted_ids.size();
+  return write_file_atomically(path,
+                               {{&num_ids, sizeof(num_ids)},
+                                {sorted_ids.data(), num_ids * sizeof(int32_t)}});
+}
+
+// The persisted sorted cache, or nothing if it is missing or not a permutation of the
+// ids below some count up to max_count
+std::vector<int32_t> read_sorted_ids(const std::string& path, const size_t max_count) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return {};
+  }
+  std::vector<int32_t> sorted_ids;
+  uint64_t num_ids{0};
+  if (read_fully(fd, &num_ids, sizeof(num_ids), 0) && num_ids <= max_count &&
+      file_size(fd) == sizeof(num_ids) + num_ids * sizeof(int32_t)) {
+    sorted_ids.resize(num_ids);
+    if (!read_fully(fd, sorted_ids.data(), num_ids * sizeof(int32_t), sizeof(num_ids))) {
+      sorted_ids.clear();
+    }
+  }
+  close(fd);
+  std::vector<bool> seen(sorted_ids.size());
+  for (const auto id : sorted_ids) {
+    if (id < 0 || static_cast<size_t>(id) >= seen.size() || seen[id]) {
+      LOG(WARNING) << "Ignoring invalid sorted dictionary cache " << path;
+      return {};
+    }
+    seen[id] = true;
+  }
+  return sorted_ids;
+}
+
 const uint64_t round_up_p2(const uint64_t num) {
   uint64_t in = num;
   in--;
@@ -93,20 +185,106 @@ const uint64_t round_up_p2(const uint64_t num) {
   return in;
 }
 
-uint32_t rk_hash(const std::string_view& str) {
-  uint32_t str_hash = 1;
-  // rely on fact that unsigned overflow is defined and wraps
-  for (size_t i = 0; i < str.size(); ++i) {
-    str_hash = str_hash * 997 + str[i];
-  }
-  return str_hash;
+uint64_t read_u64(const char* data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t read_u32(const char* data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// folds the 128 bit product of a and b into 64 bits
+uint64_t hash_mix(const uint64_t a, const uint64_t b) {
+  const auto product = static_cast<unsigned __int128>(a) * b;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+// wyhash style hash, which consumes 16 bytes per multiply instead of one byte per step.
+// Changing it must bump kHashTableFileVersion, the persisted hash tables depend on it.
+uint32_t hash_string(const std::string_view& str) {
+  constexpr uint64_t kSecret0{0xa0761d6478bd642fULL};
+  constexpr uint64_t kSecret1{0xe7037ed1a0b428dbULL};
+  constexpr uint64_t kSecret2{0x8ebc6af09c88c6e3ULL};
+  const char* data = str.data();
+  const size_t len = str.size();
+  uint64_t seed = kSecret0 ^ len;
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    seed = hash_mix(read_u64(data + i) ^ kSecret1, read_u64(data + i + 8) ^ seed);
+  }
+  // the tail, read as two possibly overlapping words
+  const size_t rest = len - i;
+  uint64_t a{0};
+  uint64_t b{0};
+  if (rest >= 8) {
+    a = read_u64(data + i);
+    b = read_u64(data + len - 8);
+  } else if (rest >= 4) {
+    a = read_u32(data + i);
+    b = read_u32(data + len - 4);
+  } else if (rest > 0) {
+    a = (static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << 16) |
+        (static_cast<uint64_t>(static_cast<uint8_t>(data[i + rest / 2])) << 8) |
+        static_cast<uint8_t>(data[len - 1]);
+  }
+  const auto hash = hash_mix(kSecret2 ^ len, hash_mix(a ^ kSecret1, b ^ seed));
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+// how many strings ahead of the one being looked up the bulk paths prefetch buckets
+constexpr size_t kBucketPrefetchDistance{16};
+
+// The hash table is persisted as this header, the table, and the cached hashes of the
+// strings if the dictionary materializes them
+struct HashTableFileHeader {
+  uint64_t version;
+  uint64_t str_count;
+  uint64_t payload_size;
+  uint64_t table_size;
+  uint64_t has_hashes;
+  uint32_t crc;  // of the table and the hashes
+  uint32_t padding;
+};
+
+constexpr uint64_t kHashTableFileVersion{1};
+
+// how many strings the background validation of a loaded hash table checks per lock
+constexpr size_t kHashTableValidationChunkSize{65536};
+
+// A symbol table is trained on up to kSymbolTableSampleBytes of the first strings added,
+// and only used if they are at least kMinSymbolTableSampleBytes and it encodes them in
+// at most kMaxSymbolTableCompressionRatio of that
+constexpr size_t kSymbolTableSampleBytes{1 << 16};
+constexpr size_t kMinSymbolTableSampleBytes{1 << 12};
+constexpr double kMaxSymbolTableCompressionRatio{0.8};
+
+// The symbol table persisted in path, null if there is none
+std::unique_ptr<const StringSymbolTable> read_symbol_table(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  std::string bytes(file_size(fd), '\0');
+  const bool ok = read_fully(fd, &bytes[0], bytes.size(), 0);
+  close(fd);
+  auto symbol_table = ok ? StringSymbolTable::deserialize(bytes) : nullptr;
+  // the strings of the dictionary cannot be read without it
+  CHECK(symbol_table) << "Invalid string dictionary symbol table " << path;
+  return symbol_table;
 }
 }  // namespace
 
 bool g_enable_stringdict_parallel{false};
+bool g_enable_stringdict_compression{false};
 constexpr int32_t StringDictionary::INVALID_STR_ID;
 constexpr size_t StringDictionary::MAX_STRLEN;
 constexpr size_t StringDictionary::MAX_STRCOUNT;
+constexpr size_t StringDictionary::MATCHING_IDS_CACHE_SIZE;
+constexpr size_t StringDictionary::COMPARE_CACHE_SIZE;
 
 StringDictionary::StringDictionary(const std::string& folder,
                                    const bool isTemp,
@@ -115,7 +293,7 @@ StringDictionary::StringDictionary(const std::string& folder,
                                    size_t initial_capacity)
     : str_count_(0)
     , string_id_hash_table_(initial_capacity, INVALID_STR_ID)
-    , rk_hashes_(initial_capacity)
+    , hash_cache_(initial_capacity)
     , isTemp_(isTemp)
     , materialize_hashes_(materializeHashes)
     , payload_fd_(-1)
@@ -135,6 +313,17 @@ StringDictionary::StringDictionary(const std::string& folder,
   if (!isTemp_) {
     boost::filesystem::path storage_path(folder);
     offsets_path_ = (storage_path / boost::filesystem::path("DictOffsets")).string();
+    sorted_ids_path_ = (storage_path / boost::filesystem::path("DictSortedIds")).string();
+    hash_table_path_ = (storage_path / boost::filesystem::path("DictHashTable")).string();
+    symbol_table_path_ =
+        (storage_path / boost::filesystem::path("DictSymbolTable")).string();
+    if (!recover) {
+      boost::filesystem::remove(sorted_ids_path_);
+      boost::filesystem::remove(hash_table_path_);
+      boost::filesystem::remove(symbol_table_path_);
+    }
+    symbol_table_ = read_symbol_table(symbol_table_path_);
+    symbol_table_undecided_ = !symbol_table_ && g_enable_stringdict_compression;
     const auto payload_path =
         (storage_path / boost::filesystem::path("DictPayload")).string();
     payload_fd_ = checked_open(payload_path.c_str(), recover);
@@ -162,6 +351,18 @@ StringDictionary::StringDictionary(const std::string& folder,
       const uint64_t str_count =
           storage_is_empty ? 0 : getNumStringsFromStorage(bytes / sizeof(StringIdxEntry));
       collisions_ = 0;
+      if (str_count > 0 && loadHashTable(str_count)) {
+        VLOG(1) << "Opened string dictionary " << folder << " # Strings: " << str_count_
+                << " from its persisted hash table of size "
+                << string_id_hash_table_.size();
+        // lookups are served meanwhile
+        const size_t num_persisted_strings = persisted_hash_table_str_count_;
+        hash_table_validation_ =
+            std::async(std::launch::async, [this, num_persisted_strings] {
+              validateHashTable(num_persisted_strings);
+            });
+        return;
+      }
       // at this point we know the size of the StringDict we need to load
       // so lets reallocate the vector to the correct size
       const uint64_t max_entries =
@@ -170,8 +371,8 @@ StringDictionary::StringDictionary(const std::string& folder,
       std::vector<int32_t> new_str_ids(max_entries, INVALID_STR_ID);
       string_id_hash_table_.swap(new_str_ids);
       if (materialize_hashes_) {
-        std::vector<uint32_t> new_rk_hashes(max_entries / 2);
-        rk_hashes_.swap(new_rk_hashes);
+        std::vector<uint32_t> new_hash_cache(max_entries / 2);
+        hash_cache_.swap(new_hash_cache);
       }
       // Bail early if we know we don't have strings to add (i.e. a new or empty
       // dictionary)
@@ -201,7 +402,7 @@ StringDictionary::StringDictionary(const std::string& folder,
                   break;
                 } else {
                   std::string temp(recovered.c_str_ptr, recovered.size);
-                  hashVec.emplace_back(std::make_pair(rk_hash(temp), temp.size()));
+                  hashVec.emplace_back(std::make_pair(hash_string(temp), temp.size()));
                 }
               }
               return hashVec;
@@ -234,7 +435,7 @@ void StringDictionary::processDictionaryFutures(
       payload_file_off_ += hash.second;
       string_id_hash_table_[bucket] = static_cast<int32_t>(str_count_);
       if (materialize_hashes_) {
-        rk_hashes_[str_count_] = hash.first;
+        hash_cache_[str_count_] = hash.first;
       }
       ++str_count_;
     }
@@ -278,6 +479,10 @@ StringDictionary::StringDictionary(const LeafHostInfo& host, const DictRef dict_
     , client_no_timeout_(new StringDictionaryClient(host, dict_ref, false)) {}
 
 StringDictionary::~StringDictionary() noexcept {
+  if (hash_table_validation_.valid()) {
+    stop_hash_table_validation_ = true;
+    hash_table_validation_.wait();
+  }
   free(CANARY_BUFFER);
   if (client_) {
     return;
@@ -338,7 +543,7 @@ template void StringDictionary::getOrAddBulkArray(
     std::vector<std::vector<int32_t>>& ids_array_vec);
 
 /**
- * Method to rk_hash a vector of strings in parallel.
+ * Method to hash a vector of strings in parallel.
  * @param string_vec input vector of strings to be hashed
  * @param hashes space for the output - should be pre-sized to match string_vec size
  */
@@ -353,7 +558,7 @@ void StringDictionary::hashStrings(const std::vector<String>& string_vec,
                         if (string_vec[curr_id].empty()) {
                           continue;
                         }
-                        hashes[curr_id] = rk_hash(string_vec[curr_id]);
+                        hashes[curr_id] = hash_string(string_vec[curr_id]);
                       }
                     });
 }
@@ -370,17 +575,36 @@ void StringDictionary::getOrAddBulk(const std::vector<String>& input_strings,
     getOrAddBulkRemote(input_strings, output_string_ids);
     return;
   }
+  if (const auto symbol_table =
+          getSymbolTableForAdd(input_strings.data(), input_strings.size())) {
+    getOrAddBulkImpl(encodeStrings(*symbol_table, input_strings), output_string_ids);
+    return;
+  }
+  getOrAddBulkImpl(input_strings, output_string_ids);
+}
+
+template <class T, class String>
+void StringDictionary::getOrAddBulkImpl(const std::vector<String>& input_strings,
+                                        T* output_string_ids) {
+  // hashed up front, so that the buckets of the strings ahead can be prefetched
+  std::vector<uint32_t> input_strings_hashes(input_strings.size());
+  for (size_t i = 0; i < input_strings.size(); ++i) {
+    if (!input_strings[i].empty()) {
+      input_strings_hashes[i] = hash_string(input_strings[i]);
+    }
+  }
   size_t out_idx{0};
   mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
 
   for (const auto& str : input_strings) {
+    prefetchBuckets(input_strings_hashes, out_idx);
     if (str.empty()) {
       output_string_ids[out_idx++] = inline_int_null_value<T>();
       continue;
     }
-    CHECK(str.size() <= MAX_STRLEN);
+    CHECK(str.size() <= maxStoredStringSize());
     uint32_t bucket;
-    const uint32_t hash = rk_hash(str);
+    const uint32_t hash = input_strings_hashes[out_idx];
     bucket = computeBucket(hash, str, string_id_hash_table_);
     if (string_id_hash_table_[bucket] != INVALID_STR_ID) {
       output_string_ids[out_idx++] = string_id_hash_table_[bucket];
@@ -408,7 +632,7 @@ void StringDictionary::getOrAddBulk(const std::vector<String>& input_strings,
 
       string_id_hash_table_[bucket] = static_cast<int32_t>(str_count_);
       if (materialize_hashes_) {
-        rk_hashes_[str_count_] = hash;
+        hash_cache_[str_count_] = hash;
       }
       ++str_count_;
     }
@@ -424,39 +648,79 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     getOrAddBulkRemote(input_strings, output_string_ids);
     return;
   }
-  // Run rk_hash on the input strings up front, and in parallel,
+  if (const auto symbol_table =
+          getSymbolTableForAdd(input_strings.data(), input_strings.size())) {
+    getOrAddBulkParallelImpl(encodeStrings(*symbol_table, input_strings),
+                             output_string_ids);
+    return;
+  }
+  getOrAddBulkParallelImpl(input_strings, output_string_ids);
+}
+
+template <class T, class String>
+void StringDictionary::getOrAddBulkParallelImpl(const std::vector<String>& input_strings,
+                                                T* output_string_ids) {
+  // Hash the input strings up front, and in parallel,
   // as the string hashing does not need to be behind the subsequent write_lock
-  std::vector<uint32_t> input_strings_rk_hashes(input_strings.size());
-  hashStrings(input_strings, input_strings_rk_hashes);
+  std::vector<uint32_t> input_strings_hashes(input_strings.size());
+  hashStrings(input_strings, input_strings_hashes);
+
+  // Look the strings up under a shared lock first, so that concurrent bulk adds (e.g.
+  // from the threads of an import) only serialize on the strings new to the dictionary
+  std::vector<size_t> missing_string_idxs;
+  std::vector<uint32_t> missing_string_hashes;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    for (size_t idx = 0; idx < input_strings.size(); ++idx) {
+      prefetchBuckets(input_strings_hashes, idx);
+      const auto& input_string = input_strings[idx];
+      // Currently we make empty strings null
+      if (input_string.empty()) {
+        output_string_ids[idx] = inline_int_null_value<T>();
+        continue;
+      }
+      // TODO: Recover gracefully if an input string is too long
+      CHECK(input_string.size() <= maxStoredStringSize());
+      const auto string_id = string_id_hash_table_[computeBucket(
+          input_strings_hashes[idx], input_string, string_id_hash_table_)];
+      if (string_id == INVALID_STR_ID) {
+        missing_string_idxs.push_back(idx);
+        missing_string_hashes.push_back(input_strings_hashes[idx]);
+      } else {
+        output_string_ids[idx] = string_id;
+      }
+    }
+  }
+  if (missing_string_idxs.empty()) {
+    return;
+  }
 
+  // Another bulk add may have added some of the missing strings meanwhile, so they are
+  // looked up again under the write lock
   mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
   size_t shadow_str_count =
       str_count_;  // Need to shadow str_count_ now with bulk add methods
   const size_t storage_high_water_mark = shadow_str_count;
   std::vector<size_t> string_memory_ids;
   size_t sum_new_string_lengths = 0;
-  string_memory_ids.reserve(input_strings.size());
-  size_t input_string_idx{0};
-  for (const auto& input_string : input_strings) {
-    // Currently we make empty strings null
-    if (input_string.empty()) {
-      output_string_ids[input_string_idx++] = inline_int_null_value<T>();
-      continue;
-    }
-    // TODO: Recover gracefully if an input string is too long
-    CHECK(input_string.size() <= MAX_STRLEN);
+  string_memory_ids.reserve(missing_string_idxs.size());
+  for (size_t missing_idx = 0; missing_idx < missing_string_idxs.size();
+       ++missing_idx) {
+    prefetchBuckets(missing_string_hashes, missing_idx);
+    const size_t input_string_idx = missing_string_idxs[missing_idx];
+    const auto& input_string = input_strings[input_string_idx];
 
     if (fillRateIsHigh(shadow_str_count)) {
       // resize when more than 50% is full
       increaseCapacityFromStorageAndMemory(storage_high_water_mark,
                                            input_strings,
                                            string_memory_ids,
-                                           input_strings_rk_hashes);
+                                           input_strings_hashes);
     }
-    // Get the rk_hash for this input_string
-    const uint32_t input_string_rk_hash = input_strings_rk_hashes[input_string_idx];
+    // Get the hash for this input_string
+    const uint32_t input_string_hash = input_strings_hashes[input_string_idx];
 
-    uint32_t hash_bucket = computeBucketFromStorageAndMemory(input_string_rk_hash,
+    uint32_t hash_bucket = computeBucketFromStorageAndMemory(input_string_hash,
                                                              input_string,
                                                              string_id_hash_table_,
                                                              storage_high_water_mark,
@@ -467,14 +731,14 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     // (computeBucketFromStorageAndMemory) already checked to ensure the input string and
     // bucket string are equal)
     if (string_id_hash_table_[hash_bucket] != INVALID_STR_ID) {
-      output_string_ids[input_string_idx++] = string_id_hash_table_[hash_bucket];
+      output_string_ids[input_string_idx] = string_id_hash_table_[hash_bucket];
       continue;
     }
     // Did not find string, so need to add record to dictionary
     // First check there is room
     if (shadow_str_count == static_cast<size_t>(max_valid_int_value<T>())) {
       log_encoding_error<T>(input_string);
-      output_string_ids[input_string_idx++] = inline_int_null_value<T>();
+      output_string_ids[input_string_idx] = inline_int_null_value<T>();
       continue;
     }
     CHECK_LT(shadow_str_count, MAX_STRCOUNT)
@@ -487,9 +751,9 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     sum_new_string_lengths += input_string.size();
     string_id_hash_table_[hash_bucket] = static_cast<int32_t>(shadow_str_count);
     if (materialize_hashes_) {
-      rk_hashes_[shadow_str_count] = input_string_rk_hash;
+      hash_cache_[shadow_str_count] = input_string_hash;
     }
-    output_string_ids[input_string_idx++] = shadow_str_count++;
+    output_string_ids[input_string_idx] = shadow_str_count++;
   }
   appendToStorageBulk(input_strings, string_memory_ids, sum_new_string_lengths);
   str_count_ = shadow_str_count;
@@ -563,7 +827,12 @@ int32_t StringDictionary::getIdOfString(const std::string& str) const {
 }
 
 int32_t StringDictionary::getUnlocked(const std::string& str) const noexcept {
-  const uint32_t hash = rk_hash(str);
+  if (symbol_table_) {
+    const auto encoded = symbol_table_->encode(str);
+    return string_id_hash_table_[computeBucket(
+        hash_string(encoded), encoded, string_id_hash_table_)];
+  }
+  const uint32_t hash = hash_string(str);
   auto str_id = string_id_hash_table_[computeBucket(hash, str, string_id_hash_table_)];
   return str_id;
 }
@@ -587,11 +856,17 @@ std::pair<char*, size_t> StringDictionary::getStringBytes(int32_t string_id) con
     noexcept {
   mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   CHECK(!client_);
+  CHECK(!symbol_table_);
   CHECK_LE(0, string_id);
   CHECK_LT(string_id, static_cast<int32_t>(str_count_));
   return getStringBytesChecked(string_id);
 }
 
+bool StringDictionary::isCompressed() const noexcept {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  return symbol_table_ != nullptr;
+}
+
 size_t StringDictionary::storageEntryCount() const {
   mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   if (client_) {
@@ -602,64 +877,58 @@ size_t StringDictionary::storageEntryCount() const {
 
 namespace {
 
-bool is_like(const std::string& str,
+bool is_like(const char* str,
+             const size_t str_len,
              const std::string& pattern,
              const bool icase,
              const bool is_simple,
              const char escape) {
-  return icase
-             ? (is_simple ? string_ilike_simple(
-                                str.c_str(), str.size(), pattern.c_str(), pattern.size())
-                          : string_ilike(str.c_str(),
-                                         str.size(),
-                                         pattern.c_str(),
-                                         pattern.size(),
-                                         escape))
-             : (is_simple ? string_like_simple(
-                                str.c_str(), str.size(), pattern.c_str(), pattern.size())
-                          : string_like(str.c_str(),
-                                        str.size(),
-                                        pattern.c_str(),
-                                        pattern.size(),
-                                        escape));
+  return icase ? (is_simple ? string_ilike_simple(
+                                  str, str_len, pattern.c_str(), pattern.size())
+                            : string_ilike(
+                                  str, str_len, pattern.c_str(), pattern.size(), escape))
+               : (is_simple ? string_like_simple(
+                                  str, str_len, pattern.c_str(), pattern.size())
+                            : string_like(
+                                  str, str_len, pattern.c_str(), pattern.size(), escape));
 }
 
+// fewest strings a worker of a dictionary scan is started for
+constexpr size_t kMinScanStringsPerWorker{16384};
+
 }  // namespace
 
-std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
-                                               const bool icase,
-                                               const bool is_simple,
-                                               const char escape,
-                                               const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-  if (client_) {
-    return client_->get_like(pattern, icase, is_simple, escape, generation);
-  }
-  const auto cache_key = std::make_tuple(pattern, icase, is_simple, escape);
-  const auto it = like_cache_.find(cache_key);
-  if (it != like_cache_.end()) {
-    return it->second;
-  }
-  std::vector<int32_t> result;
-  std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
-  CHECK_GT(worker_count, 0);
+template <class Matcher>
+std::vector<int32_t> StringDictionary::getMatchingIds(const size_t start_id,
+                                                      const size_t end_id,
+                                                      const Matcher& matches) const {
+  CHECK_LE(start_id, end_id);
+  CHECK_LE(end_id, str_count_);
+  // Each worker scans a contiguous range of ids, so that it reads the offsets and
+  // payload sequentially, and the results come out sorted.
+  const size_t num_strings = end_id - start_id;
+  const size_t worker_count =
+      std::max(std::min(static_cast<size_t>(cpu_threads()),
+                        num_strings / kMinScanStringsPerWorker),
+               size_t(1));
+  const size_t strings_per_worker = (num_strings + worker_count - 1) / worker_count;
   std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
-  for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+  std::vector<std::thread> workers;
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
     workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          icase,
-                          is_simple,
-                          escape,
+                          &matches,
+                          start_id,
+                          end_id,
+                          strings_per_worker,
                           worker_idx,
-                          worker_count,
                           this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_like(str, pattern, icase, is_simple, escape)) {
+      const size_t worker_start_id = start_id + worker_idx * strings_per_worker;
+      const size_t worker_end_id =
+          std::min(worker_start_id + strings_per_worker, end_id);
+      std::string buffer;
+      for (size_t string_id = worker_start_id; string_id < worker_end_id; ++string_id) {
+        const auto str = getDecodedStringFromStorage(string_id, buffer);
+        if (matches(str.data(), str.size())) {
           worker_results[worker_idx].push_back(string_id);
         }
       }
@@ -668,26 +937,63 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
   for (auto& worker : workers) {
     worker.join();
   }
+  std::vector<int32_t> result;
   for (const auto& worker_result : worker_results) {
     result.insert(result.end(), worker_result.begin(), worker_result.end());
   }
-  // place result into cache for reuse if similar query
-  const auto it_ok = like_cache_.insert(std::make_pair(cache_key, result));
+  return result;
+}
 
-  CHECK(it_ok.second);
+template <class Cache, class Key, class Matcher>
+std::vector<int32_t> StringDictionary::getMatchingIdsCached(
+    Cache& cache,
+    const Key& key,
+    const size_t generation,
+    const Matcher& matches) const {
+  CHECK_LE(generation, str_count_);
+  auto cached = cache.get(key);
+  if (!cached) {
+    cache.put(key, matching_ids_cache_value_t{0, {}});
+    cached = cache.get(key);
+  }
+  if (cached->generation < generation) {
+    // only the strings added since the entry was last extended are scanned
+    const auto new_ids = getMatchingIds(cached->generation, generation, matches);
+    cached->ids.insert(cached->ids.end(), new_ids.begin(), new_ids.end());
+    cached->generation = generation;
+  }
+  const auto ids_end = std::lower_bound(
+      cached->ids.begin(), cached->ids.end(), static_cast<int32_t>(generation));
+  return std::vector<int32_t>(cached->ids.begin(), ids_end);
+}
 
-  return result;
+std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
+                                               const bool icase,
+                                               const bool is_simple,
+                                               const char escape,
+                                               const size_t generation) const {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  if (client_) {
+    return client_->get_like(pattern, icase, is_simple, escape, generation);
+  }
+  return getMatchingIdsCached(
+      like_cache_,
+      std::make_tuple(pattern, icase, is_simple, escape),
+      generation,
+      [&pattern, icase, is_simple, escape](const char* str, const size_t str_len) {
+        return is_like(str, str_len, pattern, icase, is_simple, escape);
+      });
 }
 
 std::vector<int32_t> StringDictionary::getEquals(std::string pattern,
                                                  std::string comp_operator,
                                                  size_t generation) {
   std::vector<int32_t> result;
-  auto eq_id_itr = equal_cache_.find(pattern);
+  const auto cached_eq_id = equal_cache_.get(pattern);
   int32_t eq_id = MAX_STRLEN + 1;
   int32_t cur_size = str_count_;
-  if (eq_id_itr != equal_cache_.end()) {
-    auto eq_id = eq_id_itr->second;
+  if (cached_eq_id) {
+    auto eq_id = *cached_eq_id;
     if (comp_operator == "=") {
       result.push_back(eq_id);
     } else {
@@ -723,8 +1029,7 @@ std::vector<int32_t> StringDictionary::getEquals(std::string pattern,
       result.insert(result.end(), worker_result.begin(), worker_result.end());
     }
     if (result.size() > 0) {
-      const auto it_ok = equal_cache_.insert(std::make_pair(pattern, result[0]));
-      CHECK(it_ok.second);
+      equal_cache_.put(pattern, result[0]);
       eq_id = result[0];
     }
     if (comp_operator == "<>") {
@@ -757,26 +1062,30 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
 
     buildSortedCache();
   }
-  auto cache_index = compare_cache_.get(pattern);
+  const auto cached_index = compare_cache_.get(pattern);
+  std::shared_ptr<compare_cache_value_t> cache_index =
+      cached_index ? *cached_index : nullptr;
 
   if (!cache_index) {
     cache_index = std::make_shared<StringDictionary::compare_cache_value_t>();
+    std::string buffer;
     const auto cache_itr = std::lower_bound(
         sorted_cache.begin(),
         sorted_cache.end(),
         pattern,
-        [this](decltype(sorted_cache)::value_type const& a, decltype(pattern)& b) {
-          auto a_str = this->getStringFromStorage(a);
-          return string_lt(a_str.c_str_ptr, a_str.size, b.c_str(), b.size());
+        [this, &buffer](decltype(sorted_cache)::value_type const& a,
+                        decltype(pattern)& b) {
+          const auto a_str = this->getDecodedStringFromStorage(a, buffer);
+          return string_lt(a_str.data(), a_str.size(), b.c_str(), b.size());
         });
 
     if (cache_itr == sorted_cache.end()) {
       cache_index->index = sorted_cache.size() - 1;
       cache_index->diff = 1;
     } else {
-      const auto cache_str = getStringFromStorage(*cache_itr);
+      const auto cache_str = getDecodedStringFromStorage(*cache_itr, buffer);
       if (!string_eq(
-              cache_str.c_str_ptr, cache_str.size, pattern.c_str(), pattern.size())) {
+              cache_str.data(), cache_str.size(), pattern.c_str(), pattern.size())) {
         cache_index->index = cache_itr - sorted_cache.begin() - 1;
         cache_index->diff = 1;
       } else {
@@ -892,10 +1201,11 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
 
 namespace {
 
-bool is_regexp_like(const std::string& str,
+bool is_regexp_like(const char* str,
+                    const size_t str_len,
                     const std::string& pattern,
                     const char escape) {
-  return regexp_like(str.c_str(), str.size(), pattern.c_str(), pattern.size(), escape);
+  return regexp_like(str, str_len, pattern.c_str(), pattern.size(), escape);
 }
 
 }  // namespace
@@ -907,44 +1217,13 @@ std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
   if (client_) {
     return client_->get_regexp_like(pattern, escape, generation);
   }
-  const auto cache_key = std::make_pair(pattern, escape);
-  const auto it = regex_cache_.find(cache_key);
-  if (it != regex_cache_.end()) {
-    return it->second;
-  }
-  std::vector<int32_t> result;
-  std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
-  CHECK_GT(worker_count, 0);
-  std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
-  for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
-    workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          escape,
-                          worker_idx,
-                          worker_count,
-                          this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_regexp_like(str, pattern, escape)) {
-          worker_results[worker_idx].push_back(string_id);
-        }
-      }
-    });
-  }
-  for (auto& worker : workers) {
-    worker.join();
-  }
-  for (const auto& worker_result : worker_results) {
-    result.insert(result.end(), worker_result.begin(), worker_result.end());
-  }
-  const auto it_ok = regex_cache_.insert(std::make_pair(cache_key, result));
-  CHECK(it_ok.second);
-
-  return result;
+  return getMatchingIdsCached(
+      regex_cache_,
+      std::make_pair(pattern, escape),
+      generation,
+      [&pattern, escape](const char* str, const size_t str_len) {
+        return is_regexp_like(str, str_len, pattern, escape);
+      });
 }
 
 std::shared_ptr<const std::vector<std::string>> StringDictionary::copyStrings() const {
@@ -999,6 +1278,25 @@ std::shared_ptr<const std::vector<std::string>> StringDictionary::copyStrings()
   return strings_cache_;
 }
 
+void StringDictionary::prefetchBuckets(const std::vector<uint32_t>& hashes,
+                                       const size_t idx) const noexcept {
+  // Lookups are bound by cache misses on the bucket slot, then on the cached hash of
+  // the string in it. Both are prefetched, the slot far enough ahead to be loaded by the
+  // time the cached hash is prefetched.
+  const size_t mask = string_id_hash_table_.size() - 1;
+  if (idx + kBucketPrefetchDistance < hashes.size()) {
+    __builtin_prefetch(
+        &string_id_hash_table_[hashes[idx + kBucketPrefetchDistance] & mask]);
+  }
+  if (materialize_hashes_ && idx + kBucketPrefetchDistance / 2 < hashes.size()) {
+    const auto string_id =
+        string_id_hash_table_[hashes[idx + kBucketPrefetchDistance / 2] & mask];
+    if (string_id != INVALID_STR_ID) {
+      __builtin_prefetch(&hash_cache_[string_id]);
+    }
+  }
+}
+
 bool StringDictionary::fillRateIsHigh(const size_t num_strings) const noexcept {
   return string_id_hash_table_.size() <= num_strings * 2;
 }
@@ -1009,16 +1307,16 @@ void StringDictionary::increaseCapacity() noexcept {
   if (materialize_hashes_) {
     for (size_t i = 0; i < string_id_hash_table_.size(); ++i) {
       if (string_id_hash_table_[i] != INVALID_STR_ID) {
-        const uint32_t hash = rk_hashes_[string_id_hash_table_[i]];
+        const uint32_t hash = hash_cache_[string_id_hash_table_[i]];
         uint32_t bucket = computeUniqueBucketWithHash(hash, new_str_ids);
         new_str_ids[bucket] = string_id_hash_table_[i];
       }
     }
-    rk_hashes_.resize(rk_hashes_.size() * 2);
+    hash_cache_.resize(hash_cache_.size() * 2);
   } else {
     for (size_t i = 0; i < str_count_; ++i) {
-      const auto str = getStringChecked(i);
-      const uint32_t hash = rk_hash(str);
+      const auto str = getStringFromStorageFast(i);
+      const uint32_t hash = hash_string(str);
       uint32_t bucket = computeUniqueBucketWithHash(hash, new_str_ids);
       new_str_ids[bucket] = i;
     }
@@ -1031,28 +1329,28 @@ void StringDictionary::increaseCapacityFromStorageAndMemory(
     const size_t storage_high_water_mark,
     const std::vector<String>& input_strings,
     const std::vector<size_t>& string_memory_ids,
-    const std::vector<uint32_t>& input_strings_rk_hashes) noexcept {
+    const std::vector<uint32_t>& input_strings_hashes) noexcept {
   std::vector<int32_t> new_str_ids(string_id_hash_table_.size() * 2, INVALID_STR_ID);
   if (materialize_hashes_) {
     for (size_t i = 0; i < string_id_hash_table_.size(); ++i) {
       if (string_id_hash_table_[i] != INVALID_STR_ID) {
-        const uint32_t hash = rk_hashes_[string_id_hash_table_[i]];
+        const uint32_t hash = hash_cache_[string_id_hash_table_[i]];
         uint32_t bucket = computeUniqueBucketWithHash(hash, new_str_ids);
         new_str_ids[bucket] = string_id_hash_table_[i];
       }
     }
-    rk_hashes_.resize(rk_hashes_.size() * 2);
+    hash_cache_.resize(hash_cache_.size() * 2);
   } else {
     for (size_t storage_idx = 0; storage_idx != storage_high_water_mark; ++storage_idx) {
-      const auto storage_string = getStringChecked(storage_idx);
-      const uint32_t hash = rk_hash(storage_string);
+      const auto storage_string = getStringFromStorageFast(storage_idx);
+      const uint32_t hash = hash_string(storage_string);
       uint32_t bucket = computeUniqueBucketWithHash(hash, new_str_ids);
       new_str_ids[bucket] = storage_idx;
     }
     for (size_t memory_idx = 0; memory_idx != string_memory_ids.size(); ++memory_idx) {
       size_t string_memory_id = string_memory_ids[memory_idx];
       uint32_t bucket = computeUniqueBucketWithHash(
-          input_strings_rk_hashes[string_memory_id], new_str_ids);
+          input_strings_hashes[string_memory_id], new_str_ids);
       new_str_ids[bucket] = storage_high_water_mark + memory_idx;
     }
   }
@@ -1065,8 +1363,15 @@ int32_t StringDictionary::getOrAddImpl(const std::string& str) noexcept {
     return inline_int_null_value<int32_t>();
   }
   CHECK(str.size() <= MAX_STRLEN);
+  if (const auto symbol_table = getSymbolTableForAdd(&str, 1)) {
+    return getOrAddStored(symbol_table->encode(str));
+  }
+  return getOrAddStored(str);
+}
+
+int32_t StringDictionary::getOrAddStored(const std::string& str) noexcept {
   uint32_t bucket;
-  const uint32_t hash = rk_hash(str);
+  const uint32_t hash = hash_string(str);
   {
     mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
     bucket = computeBucket(hash, str, string_id_hash_table_);
@@ -1092,7 +1397,7 @@ int32_t StringDictionary::getOrAddImpl(const std::string& str) noexcept {
     appendToStorage(str);
     string_id_hash_table_[bucket] = static_cast<int32_t>(str_count_);
     if (materialize_hashes_) {
-      rk_hashes_[str_count_] = hash;
+      hash_cache_[str_count_] = hash;
     }
     ++str_count_;
     invalidateInvertedIndex();
@@ -1103,6 +1408,9 @@ int32_t StringDictionary::getOrAddImpl(const std::string& str) noexcept {
 std::string StringDictionary::getStringChecked(const int string_id) const noexcept {
   const auto str_canary = getStringFromStorage(string_id);
   CHECK(!str_canary.canary);
+  if (symbol_table_) {
+    return symbol_table_->decode(std::string_view(str_canary.c_str_ptr, str_canary.size));
+  }
   return std::string(str_canary.c_str_ptr, str_canary.size);
 }
 
@@ -1126,7 +1434,7 @@ uint32_t StringDictionary::computeBucket(const uint32_t hash,
       break;
     }
     if (!materialize_hashes_ ||
-        (materialize_hashes_ && hash == rk_hashes_[candidate_string_id])) {
+        (materialize_hashes_ && hash == hash_cache_[candidate_string_id])) {
       const auto old_str = getStringFromStorageFast(candidate_string_id);
       if (str.size() == old_str.size() &&
           !memcmp(str.data(), old_str.data(), str.size())) {
@@ -1144,13 +1452,13 @@ uint32_t StringDictionary::computeBucket(const uint32_t hash,
 
 template <class String>
 uint32_t StringDictionary::computeBucketFromStorageAndMemory(
-    const uint32_t input_string_rk_hash,
+    const uint32_t input_string_hash,
     const String& input_string,
     const std::vector<int32_t>& string_id_hash_table,
     const size_t storage_high_water_mark,
     const std::vector<String>& input_strings,
     const std::vector<size_t>& string_memory_ids) const noexcept {
-  auto bucket = input_string_rk_hash & (string_id_hash_table.size() - 1);
+  auto bucket = input_string_hash & (string_id_hash_table.size() - 1);
   while (true) {
     const int32_t candidate_string_id = string_id_hash_table[bucket];
     if (candidate_string_id ==
@@ -1158,7 +1466,7 @@ uint32_t StringDictionary::computeBucketFromStorageAndMemory(
       break;
     }
     if (!materialize_hashes_ ||
-        (input_string_rk_hash == rk_hashes_[candidate_string_id])) {
+        (input_string_hash == hash_cache_[candidate_string_id])) {
       if (candidate_string_id > 0 &&
           static_cast<size_t>(candidate_string_id) >= storage_high_water_mark) {
         // The candidate string is not in storage yet but in our string_memory_ids temp
@@ -1291,6 +1599,19 @@ std::string_view StringDictionary::getStringFromStorageFast(const int string_id)
   return {payload_map_ + str_meta->off, str_meta->size};
 }
 
+std::string_view StringDictionary::getDecodedStringFromStorage(
+    const int string_id,
+    std::string& buffer) const noexcept {
+  const auto str_canary = getStringFromStorage(string_id);
+  CHECK(!str_canary.canary);
+  const std::string_view str(str_canary.c_str_ptr, str_canary.size);
+  if (!symbol_table_) {
+    return str;
+  }
+  symbol_table_->decode(str, buffer);
+  return buffer;
+}
+
 StringDictionary::PayloadString StringDictionary::getStringFromStorage(
     const int string_id) const noexcept {
   if (!isTemp_) {
@@ -1366,17 +1687,89 @@ void* StringDictionary::addMemoryCapacity(void* addr,
   return new_addr;
 }
 
-void StringDictionary::invalidateInvertedIndex() noexcept {
-  if (!like_cache_.empty()) {
-    decltype(like_cache_)().swap(like_cache_);
+template <class String>
+const StringSymbolTable* StringDictionary::getSymbolTableForAdd(
+    const String* strings,
+    const size_t num_strings) {
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    if (!symbol_table_undecided_) {
+      return symbol_table_.get();
+    }
   }
-  if (!regex_cache_.empty()) {
-    decltype(regex_cache_)().swap(regex_cache_);
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  if (symbol_table_undecided_) {
+    symbol_table_undecided_ = false;
+    // strings stored already were not encoded
+    if (str_count_ == 0) {
+      std::vector<std::string_view> sample;
+      size_t sample_bytes{0};
+      for (size_t i = 0; i < num_strings && sample_bytes < kSymbolTableSampleBytes; ++i) {
+        sample.emplace_back(strings[i]);
+        sample_bytes += sample.back().size();
+      }
+      trainSymbolTable(sample);
+    }
   }
-  if (!equal_cache_.empty()) {
-    decltype(equal_cache_)().swap(equal_cache_);
+  return symbol_table_.get();
+}
+
+void StringDictionary::trainSymbolTable(
+    const std::vector<std::string_view>& sample) noexcept {
+  size_t sample_bytes{0};
+  for (const auto str : sample) {
+    sample_bytes += str.size();
+  }
+  if (sample_bytes < kMinSymbolTableSampleBytes) {
+    return;
+  }
+  auto symbol_table = StringSymbolTable::train(sample);
+  size_t encoded_bytes{0};
+  for (const auto str : sample) {
+    encoded_bytes += symbol_table->encode(str).size();
   }
-  compare_cache_.invalidateInvertedIndex();
+  if (encoded_bytes > kMaxSymbolTableCompressionRatio * sample_bytes) {
+    VLOG(1) << "Not compressing string dictionary " << offsets_path_
+            << ", its first strings only compress to " << encoded_bytes << " of "
+            << sample_bytes << " bytes";
+    return;
+  }
+  // persisted before any string is stored encoded with it
+  const auto bytes = symbol_table->serialize();
+  if (!write_file_atomically(symbol_table_path_, {{bytes.data(), bytes.size()}})) {
+    LOG(WARNING) << "Could not persist the symbol table " << symbol_table_path_
+                 << ", storing the strings uncompressed";
+    return;
+  }
+  VLOG(1) << "Compressing string dictionary " << offsets_path_ << " with "
+          << symbol_table->numSymbols() << " symbols, its first strings compress to "
+          << encoded_bytes << " of " << sample_bytes << " bytes";
+  symbol_table_ = std::move(symbol_table);
+}
+
+template <class String>
+std::vector<std::string> StringDictionary::encodeStrings(
+    const StringSymbolTable& symbol_table,
+    const std::vector<String>& strings) const {
+  std::vector<std::string> encoded_strings(strings.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, strings.size()),
+                    [&](const tbb::blocked_range<size_t>& r) {
+                      for (size_t i = r.begin(); i != r.end(); ++i) {
+                        // TODO: Recover gracefully if an input string is too long
+                        CHECK(strings[i].size() <= MAX_STRLEN);
+                        symbol_table.encode(strings[i], encoded_strings[i]);
+                      }
+                    });
+  return encoded_strings;
+}
+
+size_t StringDictionary::maxStoredStringSize() const noexcept {
+  return symbol_table_ ? StringSymbolTable::maxEncodedSize(MAX_STRLEN) : MAX_STRLEN;
+}
+
+void StringDictionary::invalidateInvertedIndex() noexcept {
+  // the LIKE, REGEXP and equality caches hold ids, which adds do not change
+  compare_cache_.clear();
 }
 
 bool StringDictionary::checkpoint() noexcept {
@@ -1388,16 +1781,194 @@ bool StringDictionary::checkpoint() noexcept {
     }
   }
   CHECK(!isTemp_);
+  size_t synced_str_count;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    synced_str_count = str_count_;
+  }
   bool ret = true;
   ret = ret && (msync((void*)offset_map_, offset_file_size_, MS_SYNC) == 0);
   ret = ret && (msync((void*)payload_map_, payload_file_size_, MS_SYNC) == 0);
   ret = ret && (fsync(offset_fd_) == 0);
   ret = ret && (fsync(payload_fd_) == 0);
+  if (ret) {
+    persistSortedCache(synced_str_count);
+    persistHashTable(synced_str_count);
+  }
   return ret;
 }
 
+bool StringDictionary::loadHashTable(const size_t storage_str_count) noexcept {
+  const int fd = open(hash_table_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  // The table covers the strings below its str_count, and the strings persisted after
+  // it must follow them in storage. A table of a dictionary truncated since is unusable.
+  HashTableFileHeader header;
+  bool ok = read_fully(fd, &header, sizeof(header), 0) &&
+            header.version == kHashTableFileVersion &&
+            header.str_count <= storage_str_count && header.str_count > 0 &&
+            header.has_hashes == materialize_hashes_ &&
+            header.table_size >= 2 * header.str_count &&
+            (header.table_size & (header.table_size - 1)) == 0;
+  if (ok) {
+    const auto last_str = offset_map_ + header.str_count - 1;
+    const size_t hashes_size = header.has_hashes ? header.str_count : 0;
+    ok = last_str->off + last_str->size == header.payload_size &&
+         file_size(fd) == sizeof(header) + header.table_size * sizeof(int32_t) +
+                              hashes_size * sizeof(uint32_t);
+  }
+  if (ok) {
+    std::vector<int32_t> table(header.table_size);
+    std::vector<uint32_t> hashes(header.has_hashes ? header.table_size / 2 : 0);
+    const size_t table_bytes = header.table_size * sizeof(int32_t);
+    const size_t hashes_bytes =
+        header.has_hashes ? header.str_count * sizeof(uint32_t) : 0;
+    ok = read_fully(fd, table.data(), table_bytes, sizeof(header)) &&
+         read_fully(fd, hashes.data(), hashes_bytes, sizeof(header) + table_bytes) &&
+         crc32c::extend(crc32c::value(reinterpret_cast<const int8_t*>(table.data()),
+                                      table_bytes),
+                        reinterpret_cast<const int8_t*>(hashes.data()),
+                        hashes_bytes) == header.crc;
+    if (ok) {
+      string_id_hash_table_.swap(table);
+      if (materialize_hashes_) {
+        hash_cache_.swap(hashes);
+      }
+    }
+  }
+  close(fd);
+  if (!ok) {
+    LOG(WARNING) << "Ignoring invalid persisted hash table " << hash_table_path_;
+    return false;
+  }
+  str_count_ = header.str_count;
+  payload_file_off_ = header.payload_size;
+  persisted_hash_table_str_count_ = header.str_count;
+  // add the strings stored after the table was persisted
+  for (size_t string_id = str_count_; string_id < storage_str_count; ++string_id) {
+    const auto recovered = getStringFromStorage(string_id);
+    if (recovered.canary) {
+      break;
+    }
+    const uint32_t hash =
+        hash_string(std::string_view(recovered.c_str_ptr, recovered.size));
+    if (fillRateIsHigh(str_count_)) {
+      increaseCapacity();
+    }
+    string_id_hash_table_[computeUniqueBucketWithHash(hash, string_id_hash_table_)] =
+        static_cast<int32_t>(string_id);
+    if (materialize_hashes_) {
+      hash_cache_[string_id] = hash;
+    }
+    payload_file_off_ += recovered.size;
+    ++str_count_;
+  }
+  return true;
+}
+
+void StringDictionary::validateHashTable(const size_t num_strings) noexcept {
+  // Checks that the strings the table was persisted with are found under their ids, and
+  // rebuilds the table from the strings otherwise
+  for (size_t start_id = 0; start_id < num_strings && !stop_hash_table_validation_;
+       start_id += kHashTableValidationChunkSize) {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    const size_t end_id = std::min(start_id + kHashTableValidationChunkSize, num_strings);
+    for (size_t string_id = start_id; string_id < end_id; ++string_id) {
+      const auto str = getStringFromStorageFast(string_id);
+      const uint32_t hash = hash_string(str);
+      if ((materialize_hashes_ && hash_cache_[string_id] != hash) ||
+          string_id_hash_table_[computeBucket(hash, str, string_id_hash_table_)] !=
+              static_cast<int32_t>(string_id)) {
+        read_lock.unlock();
+        LOG(ERROR) << "Persisted hash table " << hash_table_path_
+                   << " does not match the dictionary, rebuilding it";
+        rebuildHashTable();
+        return;
+      }
+    }
+  }
+}
+
+void StringDictionary::rebuildHashTable() noexcept {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  std::vector<int32_t> new_str_ids(string_id_hash_table_.size(), INVALID_STR_ID);
+  for (size_t string_id = 0; string_id < str_count_; ++string_id) {
+    const uint32_t hash = hash_string(getStringFromStorageFast(string_id));
+    new_str_ids[computeUniqueBucketWithHash(hash, new_str_ids)] =
+        static_cast<int32_t>(string_id);
+    if (materialize_hashes_) {
+      hash_cache_[string_id] = hash;
+    }
+  }
+  string_id_hash_table_.swap(new_str_ids);
+  // the persisted table is rewritten by the next checkpoint
+  persisted_hash_table_str_count_ = 0;
+}
+
+void StringDictionary::persistHashTable(const size_t synced_str_count) noexcept {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  std::lock_guard<std::mutex> persist_lock(persist_mutex_);
+  // Rewritten once the dictionary grew by an eighth, the strings added since are hashed
+  // again when it is opened. The table must not hold strings that are not synced yet.
+  const size_t persisted_count = persisted_hash_table_str_count_;
+  if (str_count_ <= persisted_count ||
+      (str_count_ - persisted_count) * 8 < persisted_count ||
+      str_count_ != synced_str_count) {
+    return;
+  }
+  HashTableFileHeader header{};
+  header.version = kHashTableFileVersion;
+  header.str_count = str_count_;
+  header.payload_size = payload_file_off_;
+  header.table_size = string_id_hash_table_.size();
+  header.has_hashes = materialize_hashes_;
+  const size_t table_bytes = string_id_hash_table_.size() * sizeof(int32_t);
+  const size_t hashes_bytes = materialize_hashes_ ? str_count_ * sizeof(uint32_t) : 0;
+  header.crc = crc32c::extend(
+      crc32c::value(reinterpret_cast<const int8_t*>(string_id_hash_table_.data()),
+                    table_bytes),
+      reinterpret_cast<const int8_t*>(hash_cache_.data()),
+      hashes_bytes);
+  if (!write_file_atomically(hash_table_path_,
+                             {{&header, sizeof(header)},
+                              {string_id_hash_table_.data(), table_bytes},
+                              {hash_cache_.data(), hashes_bytes}})) {
+    LOG(WARNING) << "Could not persist hash table " << hash_table_path_ << ": "
+                 << std::strerror(errno);
+    return;
+  }
+  persisted_hash_table_str_count_ = str_count_;
+}
+
+void StringDictionary::persistSortedCache(const size_t synced_str_count) noexcept {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  std::lock_guard<std::mutex> persist_lock(persist_mutex_);
+  // Rewritten once it grew by an eighth, to keep the delta sorted after a restart small.
+  // Only strings synced to disk can be in it, or it could outlive them on a crash.
+  const size_t persisted_count = persisted_sorted_cache_size_;
+  if (sorted_cache.size() <= persisted_count ||
+      (sorted_cache.size() - persisted_count) * 8 < persisted_count ||
+      sorted_cache.size() > synced_str_count) {
+    return;
+  }
+  if (!write_sorted_ids(sorted_ids_path_, sorted_cache)) {
+    LOG(WARNING) << "Could not persist sorted dictionary cache " << sorted_ids_path_
+                 << ": " << std::strerror(errno);
+    return;
+  }
+  persisted_sorted_cache_size_ = sorted_cache.size();
+}
+
 void StringDictionary::buildSortedCache() {
   // This method is not thread-safe.
+  if (sorted_cache.empty() && !sorted_ids_path_.empty()) {
+    // start from the cache persisted by checkpoint(), only the strings added since then
+    // have to be sorted
+    sorted_cache = read_sorted_ids(sorted_ids_path_, str_count_);
+    persisted_sorted_cache_size_ = sorted_cache.size();
+  }
   const auto cur_cache_size = sorted_cache.size();
   std::vector<int32_t> temp_sorted_cache;
   for (size_t i = cur_cache_size; i < str_count_; i++) {
@@ -1413,6 +1984,22 @@ void StringDictionary::sortCache(std::vector<int32_t>& cache) {
   // this boost sort is creating some problems when we use UTF-8 encoded strings.
   // TODO (vraj): investigate What is wrong with boost sort and try to mitigate it.
 
+  if (symbol_table_) {
+    // decoded once, rather than at every comparison
+    std::vector<std::pair<std::string, int32_t>> strings;
+    strings.reserve(cache.size());
+    for (const auto string_id : cache) {
+      strings.emplace_back(symbol_table_->decode(getStringFromStorageFast(string_id)),
+                           string_id);
+    }
+    std::sort(strings.begin(), strings.end(), [](const auto& a, const auto& b) {
+      return string_lt(a.first.data(), a.first.size(), b.first.data(), b.first.size());
+    });
+    for (size_t i = 0; i < strings.size(); ++i) {
+      cache[i] = strings[i].second;
+    }
+    return;
+  }
   std::sort(cache.begin(), cache.end(), [this](int32_t a, int32_t b) {
     auto a_str = this->getStringFromStorage(a);
     auto b_str = this->getStringFromStorage(b);
@@ -1422,26 +2009,112 @@ void StringDictionary::sortCache(std::vector<int32_t>& cache) {
 
 void StringDictionary::mergeSortedCache(std::vector<int32_t>& temp_sorted_cache) {
   // this method is not thread safe
-  std::vector<int32_t> updated_cache(temp_sorted_cache.size() + sorted_cache.size());
-  size_t t_idx = 0, s_idx = 0, idx = 0;
-  for (; t_idx < temp_sorted_cache.size() && s_idx < sorted_cache.size(); idx++) {
-    auto t_string = getStringFromStorage(temp_sorted_cache[t_idx]);
-    auto s_string = getStringFromStorage(sorted_cache[s_idx]);
-    const auto insert_from_temp_cache =
-        string_lt(t_string.c_str_ptr, t_string.size, s_string.c_str_ptr, s_string.size);
-    if (insert_from_temp_cache) {
-      updated_cache[idx] = temp_sorted_cache[t_idx++];
-    } else {
-      updated_cache[idx] = sorted_cache[s_idx++];
+  // The new strings are usually few compared to the sorted ones, so the position of each
+  // is found by an exponential search from the position of the previous one, and the
+  // sorted ids in between are copied without comparing their strings.
+  std::string id_buffer;
+  const auto string_lt_id = [this, &id_buffer](const int32_t id,
+                                               const std::string_view str) {
+    const auto id_str = getDecodedStringFromStorage(id, id_buffer);
+    return string_lt(id_str.data(), id_str.size(), str.data(), str.size());
+  };
+  std::vector<int32_t> updated_cache;
+  updated_cache.reserve(temp_sorted_cache.size() + sorted_cache.size());
+  auto s_it = sorted_cache.cbegin();
+  std::string t_buffer;
+  for (const auto t_id : temp_sorted_cache) {
+    const auto t_string = getDecodedStringFromStorage(t_id, t_buffer);
+    const size_t remaining = sorted_cache.cend() - s_it;
+    size_t bound = 1;
+    while (bound <= remaining && string_lt_id(s_it[bound - 1], t_string)) {
+      bound *= 2;
     }
+    const auto insert_it = std::lower_bound(s_it + bound / 2,
+                                            s_it + std::min(bound, remaining),
+                                            t_string,
+                                            string_lt_id);
+    updated_cache.insert(updated_cache.end(), s_it, insert_it);
+    updated_cache.push_back(t_id);
+    s_it = insert_it;
+  }
+  updated_cache.insert(updated_cache.end(), s_it, sorted_cache.cend());
+  sorted_cache.swap(updated_cache);
+}
+
+std::vector<int32_t> StringDictionary::buildTranslationMap(
+    const StringDictionary* dest_dict,
+    const size_t generation,
+    const size_t dest_generation) const {
+  std::vector<int32_t> translation_map(generation, INVALID_STR_ID);
+  if (client_ || dest_dict->client_) {
+    for (size_t string_id = 0; string_id < generation; ++string_id) {
+      translation_map[string_id] = truncate_to_generation(
+          dest_dict->getIdOfString(getString(string_id)), dest_generation);
+    }
+    return translation_map;
   }
-  while (t_idx < temp_sorted_cache.size()) {
-    updated_cache[idx++] = temp_sorted_cache[t_idx++];
+  if (dest_dict == this) {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    CHECK_LE(generation, str_count_);
+    for (size_t string_id = 0; string_id < generation; ++string_id) {
+      translation_map[string_id] = truncate_to_generation(string_id, dest_generation);
+    }
+    return translation_map;
+  }
+  // Lock the dictionaries in a fixed order, a translation in the opposite direction
+  // could deadlock with this one otherwise once a writer waits on either of them.
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_, std::defer_lock);
+  mapd_shared_lock<mapd_shared_mutex> dest_read_lock(dest_dict->rw_mutex_,
+                                                     std::defer_lock);
+  if (std::less<const StringDictionary*>()(this, dest_dict)) {
+    read_lock.lock();
+    dest_read_lock.lock();
+  } else {
+    dest_read_lock.lock();
+    read_lock.lock();
+  }
+  CHECK_LE(generation, str_count_);
+  const size_t worker_count =
+      std::max(std::min(static_cast<size_t>(cpu_threads()),
+                        generation / kMinScanStringsPerWorker),
+               size_t(1));
+  const size_t strings_per_worker = (generation + worker_count - 1) / worker_count;
+  std::vector<std::thread> workers;
+  for (size_t worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
+    workers.emplace_back([&translation_map,
+                          dest_dict,
+                          generation,
+                          dest_generation,
+                          strings_per_worker,
+                          worker_idx,
+                          this]() {
+      const size_t worker_start_id = worker_idx * strings_per_worker;
+      const size_t worker_end_id =
+          std::min(worker_start_id + strings_per_worker, generation);
+      const auto& dest_hash_table = dest_dict->string_id_hash_table_;
+      const auto dest_symbol_table = dest_dict->symbol_table_.get();
+      std::string decoded;
+      std::string dest_encoded;
+      for (size_t string_id = worker_start_id; string_id < worker_end_id; ++string_id) {
+        auto str = getStringFromStorageFast(string_id);
+        if (symbol_table_ || dest_symbol_table) {
+          // the dictionaries store the string differently
+          str = getDecodedStringFromStorage(string_id, decoded);
+          if (dest_symbol_table) {
+            dest_symbol_table->encode(str, dest_encoded);
+            str = dest_encoded;
+          }
+        }
+        const auto dest_id = dest_hash_table[dest_dict->computeBucket(
+            hash_string(str), str, dest_hash_table)];
+        translation_map[string_id] = truncate_to_generation(dest_id, dest_generation);
+      }
+    });
   }
-  while (s_idx < sorted_cache.size()) {
-    updated_cache[idx++] = sorted_cache[s_idx++];
+  for (auto& worker : workers) {
+    worker.join();
   }
-  sorted_cache.swap(updated_cache);
+  return translation_map;
 }
 
 void StringDictionary::populate_string_ids(
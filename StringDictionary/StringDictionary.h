@@ -19,18 +19,26 @@
 
 #include "../Shared/mapd_shared_mutex.h"
 #include "DictRef.h"
-#include "DictionaryCache.hpp"
 #include "LeafHostInfo.h"
+#include "LruCache.hpp"
 
+#include <boost/functional/hash.hpp>
+
+#include <atomic>
 #include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
 extern bool g_enable_stringdict_parallel;
+extern bool g_enable_stringdict_compression;
 
 class StringDictionaryClient;
+class StringSymbolTable;
 
 class DictPayloadUnavailable : public std::runtime_error {
  public:
@@ -61,6 +69,11 @@ class StringDictionary {
   std::string getString(int32_t string_id) const;
   std::pair<char*, size_t> getStringBytes(int32_t string_id) const noexcept;
   size_t storageEntryCount() const;
+  /**
+   * Whether the strings are stored encoded with a symbol table. Their bytes are not in
+   * storage then, StringDictionaryProxy::getStringBytes() decodes them instead.
+   */
+  bool isCompressed() const noexcept;
 
   std::vector<int32_t> getLike(const std::string& pattern,
                                const bool icase,
@@ -80,6 +93,15 @@ class StringDictionary {
 
   bool checkpoint() noexcept;
 
+  /**
+   * Returns the id in dest_dict of each string below generation, INVALID_STR_ID where
+   * dest_dict has no such string below dest_generation. Scans both dictionaries in
+   * parallel, without materializing the strings.
+   */
+  std::vector<int32_t> buildTranslationMap(const StringDictionary* dest_dict,
+                                           const size_t generation,
+                                           const size_t dest_generation) const;
+
   /**
    * @brief Populates provided \p dest_ids vector with string ids corresponding to given
    * source strings
@@ -129,6 +151,19 @@ class StringDictionary {
     int32_t diff;
   };
 
+  // The sorted ids of the strings matching a LIKE or REGEXP pattern, among the strings
+  // below generation. Ids never change, so an entry is extended over the strings added
+  // since, rather than invalidated by adds.
+  struct matching_ids_cache_value_t {
+    size_t generation;
+    std::vector<int32_t> ids;
+  };
+  using LikeCacheKey = std::tuple<std::string, bool, bool, char>;
+  using RegexpCacheKey = std::pair<std::string, char>;
+
+  static constexpr size_t MATCHING_IDS_CACHE_SIZE{128};
+  static constexpr size_t COMPARE_CACHE_SIZE{4096};
+
   struct PayloadString {
     char* c_str_ptr;
     size_t size;
@@ -139,6 +174,20 @@ class StringDictionary {
       std::vector<std::future<std::vector<std::pair<uint32_t, unsigned int>>>>&
           dictionary_futures);
   size_t getNumStringsFromStorage(const size_t storage_slots) const noexcept;
+  /// Ids in [start_id, end_id) of the strings matches(str, str_len) holds for, in order
+  template <class Matcher>
+  std::vector<int32_t> getMatchingIds(const size_t start_id,
+                                      const size_t end_id,
+                                      const Matcher& matches) const;
+  /// getMatchingIds() below generation, through the cache entry for key
+  template <class Cache, class Key, class Matcher>
+  std::vector<int32_t> getMatchingIdsCached(Cache& cache,
+                                            const Key& key,
+                                            const size_t generation,
+                                            const Matcher& matches) const;
+  /// Prefetches the hash table data to look up the strings following the one at idx
+  void prefetchBuckets(const std::vector<uint32_t>& hashes,
+                       const size_t idx) const noexcept;
   bool fillRateIsHigh(const size_t num_strings) const noexcept;
   void increaseCapacity() noexcept;
   template <class String>
@@ -146,11 +195,29 @@ class StringDictionary {
       const size_t storage_high_water_mark,
       const std::vector<String>& input_strings,
       const std::vector<size_t>& string_memory_ids,
-      const std::vector<uint32_t>& input_strings_rk_hashes) noexcept;
+      const std::vector<uint32_t>& input_strings_hashes) noexcept;
   int32_t getOrAddImpl(const std::string& str) noexcept;
+  int32_t getOrAddStored(const std::string& str) noexcept;
   template <class String>
   void hashStrings(const std::vector<String>& string_vec,
                    std::vector<uint32_t>& hashes) const noexcept;
+  // the bulk adds of strings in stored form, i.e. encoded if the dictionary is compressed
+  template <class T, class String>
+  void getOrAddBulkImpl(const std::vector<String>& string_vec, T* encoded_vec);
+  template <class T, class String>
+  void getOrAddBulkParallelImpl(const std::vector<String>& string_vec, T* encoded_vec);
+  /**
+   * The symbol table to encode added strings with. The first add to a new dictionary
+   * trains it on the strings added, if compression is enabled.
+   */
+  template <class String>
+  const StringSymbolTable* getSymbolTableForAdd(const String* strings,
+                                                const size_t num_strings);
+  void trainSymbolTable(const std::vector<std::string_view>& sample) noexcept;
+  template <class String>
+  std::vector<std::string> encodeStrings(const StringSymbolTable& symbol_table,
+                                         const std::vector<String>& strings) const;
+  size_t maxStoredStringSize() const noexcept;
   template <class T, class String>
   void getOrAddBulkRemote(const std::vector<String>& string_vec, T* encoded_vec);
   int32_t getUnlocked(const std::string& str) const noexcept;
@@ -163,7 +230,7 @@ class StringDictionary {
                          const std::vector<int32_t>& data) const noexcept;
   template <class String>
   uint32_t computeBucketFromStorageAndMemory(
-      const uint32_t input_string_rk_hash,
+      const uint32_t input_string_hash,
       const String& input_string,
       const std::vector<int32_t>& string_id_hash_table,
       const size_t storage_high_water_mark,
@@ -182,6 +249,9 @@ class StringDictionary {
                            const size_t sum_new_strings_lengths) noexcept;
   PayloadString getStringFromStorage(const int string_id) const noexcept;
   std::string_view getStringFromStorageFast(const int string_id) const noexcept;
+  /// The string as added, decoded into buffer if the dictionary is compressed
+  std::string_view getDecodedStringFromStorage(const int string_id,
+                                               std::string& buffer) const noexcept;
   void addPayloadCapacity(const size_t min_capacity_requested = 0) noexcept;
   void addOffsetCapacity(const size_t min_capacity_requested = 0) noexcept;
   size_t addStorageCapacity(int fd, const size_t min_capacity_requested = 0) noexcept;
@@ -192,6 +262,15 @@ class StringDictionary {
   std::vector<int32_t> getEquals(std::string pattern,
                                  std::string comp_operator,
                                  size_t generation);
+  /**
+   * Loads the hash table persisted by checkpoint() and adds the strings stored since, for
+   * a dictionary of storage_str_count strings. False if there is no usable table.
+   */
+  bool loadHashTable(const size_t storage_str_count) noexcept;
+  void validateHashTable(const size_t num_strings) noexcept;
+  void rebuildHashTable() noexcept;
+  void persistHashTable(const size_t synced_str_count) noexcept;
+  void persistSortedCache(const size_t synced_str_count) noexcept;
   void buildSortedCache();
   void insertInSortedCache(std::string str, int32_t str_id);
   void sortCache(std::vector<int32_t>& cache);
@@ -201,11 +280,22 @@ class StringDictionary {
   size_t str_count_;
   size_t collisions_;
   std::vector<int32_t> string_id_hash_table_;
-  std::vector<uint32_t> rk_hashes_;
+  std::vector<uint32_t> hash_cache_;
   std::vector<int32_t> sorted_cache;
+  size_t persisted_sorted_cache_size_{0};
   bool isTemp_;
   bool materialize_hashes_;
   std::string offsets_path_;
+  std::string sorted_ids_path_;
+  std::string hash_table_path_;
+  std::string symbol_table_path_;
+  // the strings are stored encoded with it if set, which is decided by the first add
+  std::unique_ptr<const StringSymbolTable> symbol_table_;
+  bool symbol_table_undecided_{false};
+  size_t persisted_hash_table_str_count_{0};
+  std::mutex persist_mutex_;  // serializes persisting the hash table and sorted cache
+  std::future<void> hash_table_validation_;
+  std::atomic<bool> stop_hash_table_validation_{false};
   int payload_fd_;
   int offset_fd_;
   StringIdxEntry* offset_map_;
@@ -214,11 +304,16 @@ class StringDictionary {
   size_t payload_file_size_;
   size_t payload_file_off_;
   mutable mapd_shared_mutex rw_mutex_;
-  mutable std::map<std::tuple<std::string, bool, bool, char>, std::vector<int32_t>>
-      like_cache_;
-  mutable std::map<std::pair<std::string, char>, std::vector<int32_t>> regex_cache_;
-  mutable std::map<std::string, int32_t> equal_cache_;
-  mutable DictionaryCache<std::string, compare_cache_value_t> compare_cache_;
+  mutable LruCache<LikeCacheKey, matching_ids_cache_value_t, boost::hash<LikeCacheKey>>
+      like_cache_{MATCHING_IDS_CACHE_SIZE};
+  mutable LruCache<RegexpCacheKey,
+                   matching_ids_cache_value_t,
+                   boost::hash<RegexpCacheKey>>
+      regex_cache_{MATCHING_IDS_CACHE_SIZE};
+  mutable LruCache<std::string, int32_t> equal_cache_{COMPARE_CACHE_SIZE};
+  // positions in sorted_cache, invalidated by adds
+  mutable LruCache<std::string, std::shared_ptr<compare_cache_value_t>> compare_cache_{
+      COMPARE_CACHE_SIZE};
   mutable std::shared_ptr<std::vector<std::string>> strings_cache_;
   std::unique_ptr<StringDictionaryClient> client_;
   std::unique_ptr<StringDictionaryClient> client_no_timeout_;
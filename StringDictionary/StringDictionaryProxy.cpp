@@ -75,6 +75,37 @@ int32_t StringDictionaryProxy::getIdOfString(const std::string& str) const {
                                            : StringDictionary::INVALID_STR_ID;
 }
 
+const std::vector<int32_t>& StringDictionaryProxy::getTranslationMap(
+    const StringDictionaryProxy* dest_proxy) const {
+  CHECK(dest_proxy);
+  CHECK_GE(generation_, 0);
+  CHECK_GE(dest_proxy->generation_, 0);
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(translation_maps_mutex_);
+    const auto it = translation_maps_.find(dest_proxy);
+    if (it != translation_maps_.end()) {
+      return *it->second;
+    }
+  }
+  mapd_lock_guard<mapd_shared_mutex> write_lock(translation_maps_mutex_);
+  auto& translation_map = translation_maps_[dest_proxy];
+  if (!translation_map) {
+    auto dest_ids = string_dict_->buildTranslationMap(
+        dest_proxy->string_dict_.get(), generation_, dest_proxy->generation_);
+    // a string missing from the destination dictionary can be one of its transients
+    mapd_shared_lock<mapd_shared_mutex> dest_read_lock(dest_proxy->rw_mutex_);
+    for (const auto& [str, transient_id] : dest_proxy->transient_str_to_int_) {
+      const auto string_id =
+          truncate_to_generation(string_dict_->getIdOfString(str), generation_);
+      if (string_id != StringDictionary::INVALID_STR_ID) {
+        dest_ids[string_id] = transient_id;
+      }
+    }
+    translation_map = std::make_unique<const std::vector<int32_t>>(std::move(dest_ids));
+  }
+  return *translation_map;
+}
+
 int32_t StringDictionaryProxy::getIdOfStringNoGeneration(const std::string& str) const {
   mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   auto str_id = string_dict_->getIdOfString(str);
@@ -209,7 +240,15 @@ int32_t StringDictionaryProxy::getOrAdd(const std::string& str) noexcept {
 std::pair<const char*, size_t> StringDictionaryProxy::getStringBytes(
     int32_t string_id) const noexcept {
   if (string_id >= 0) {
-    return string_dict_.get()->getStringBytes(string_id);
+    if (!string_dict_->isCompressed()) {
+      return string_dict_.get()->getStringBytes(string_id);
+    }
+    std::lock_guard<std::mutex> lock(decoded_strings_mutex_);
+    auto it = decoded_strings_.find(string_id);
+    if (it == decoded_strings_.end()) {
+      it = decoded_strings_.emplace(string_id, string_dict_->getString(string_id)).first;
+    }
+    return std::make_pair(it->second.c_str(), it->second.size());
   }
   CHECK_NE(StringDictionary::INVALID_STR_ID, string_id);
   auto it = transient_int_to_str_.find(string_id);
@@ -21,8 +21,11 @@
 #include "StringDictionary.h"
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 // used to access a StringDictionary when transient strings are involved
@@ -56,11 +59,29 @@ class StringDictionaryProxy {
     return transient_int_to_str_;
   }
 
+  /**
+   * Returns the id in dest_proxy of each string of the dictionary below the generation,
+   * including transient ids of dest_proxy, or INVALID_STR_ID. The map is built once and
+   * kept for the lifetime of the proxy, so transient strings added to dest_proxy
+   * afterwards are not in it.
+   */
+  const std::vector<int32_t>& getTranslationMap(
+      const StringDictionaryProxy* dest_proxy) const;
+
  private:
   std::shared_ptr<StringDictionary> string_dict_;
   std::map<int32_t, std::string> transient_int_to_str_;
   std::map<std::string, int32_t> transient_str_to_int_;
   ssize_t generation_;
   mutable mapd_shared_mutex rw_mutex_;
+  // per destination proxy, both of whose generations are fixed once set
+  mutable std::map<const StringDictionaryProxy*,
+                   std::unique_ptr<const std::vector<int32_t>>>
+      translation_maps_;
+  mutable mapd_shared_mutex translation_maps_mutex_;
+  // strings of a compressed dictionary decoded by getStringBytes(), which lend their
+  // bytes until the proxy is destroyed
+  mutable std::unordered_map<int32_t, std::string> decoded_strings_;
+  mutable std::mutex decoded_strings_mutex_;
 };
 #endif  // STRINGDICTIONARY_STRINGDICTIONARYPROXY_H
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StringSymbolTable.h"
+#include "Logger/Logger.h"
+#include "Shared/crc32c.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// Each generation of the table is learned from the symbols the previous one encodes the
+// sample with, and from the concatenations of adjacent ones
+constexpr size_t kTrainingGenerations{5};
+
+// The table is serialized as the version, the number of symbols, the size and bytes of
+// every symbol, and the crc32c of all that
+constexpr uint32_t kSymbolTableVersion{1};
+
+template <class T>
+void append_value(std::string& bytes, const T value) {
+  bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <class T>
+bool read_value(const std::string& bytes, size_t& pos, T& value) {
+  if (bytes.size() - pos < sizeof(value)) {
+    return false;
+  }
+  memcpy(&value, bytes.data() + pos, sizeof(value));
+  pos += sizeof(value);
+  return true;
+}
+
+}  // namespace
+
+constexpr size_t StringSymbolTable::kMaxSymbolSize;
+constexpr uint8_t StringSymbolTable::kEscapeCode;
+
+StringSymbolTable::StringSymbolTable(std::vector<std::string> symbols)
+    : symbols_(std::move(symbols)) {
+  CHECK_LE(symbols_.size(), size_t(kEscapeCode));
+  for (auto& padded_symbol : padded_symbols_) {
+    padded_symbol.fill(0);
+  }
+  symbol_sizes_.fill(0);
+  for (size_t code = 0; code < symbols_.size(); ++code) {
+    const auto& symbol = symbols_[code];
+    CHECK(!symbol.empty() && symbol.size() <= kMaxSymbolSize);
+    memcpy(padded_symbols_[code].data(), symbol.data(), symbol.size());
+    symbol_sizes_[code] = symbol.size();
+    codes_by_first_byte_[static_cast<uint8_t>(symbol.front())].push_back(code);
+  }
+  for (auto& codes : codes_by_first_byte_) {
+    std::stable_sort(codes.begin(), codes.end(), [this](const uint8_t a, const uint8_t b) {
+      return symbols_[a].size() > symbols_[b].size();
+    });
+  }
+}
+
+std::unique_ptr<StringSymbolTable> StringSymbolTable::train(
+    const std::vector<std::string_view>& sample) {
+  std::unique_ptr<StringSymbolTable> symbol_table(new StringSymbolTable({}));
+  for (size_t generation = 0; generation < kTrainingGenerations; ++generation) {
+    // the gain of a candidate symbol is the number of sample bytes it covers
+    std::unordered_map<std::string, size_t> gains;
+    for (const auto str : sample) {
+      std::string_view previous;
+      for (size_t pos = 0; pos < str.size();) {
+        const auto code = symbol_table->findLongestSymbol(str.substr(pos));
+        const auto current =
+            str.substr(pos, code == kEscapeCode ? 1 : symbol_table->symbol_sizes_[code]);
+        gains[std::string(current)] += current.size();
+        if (!previous.empty() && previous.size() + current.size() <= kMaxSymbolSize) {
+          // previous is right before current in str
+          const std::string_view concatenation(previous.data(),
+                                               previous.size() + current.size());
+          gains[std::string(concatenation)] += concatenation.size();
+        }
+        previous = current;
+        pos += current.size();
+      }
+    }
+    std::vector<std::pair<size_t, std::string>> candidates;
+    candidates.reserve(gains.size());
+    for (auto& gain : gains) {
+      candidates.emplace_back(gain.second, gain.first);
+    }
+    // ties are broken by the symbol, so that the table only depends on the sample
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+      return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < candidates.size() && i < kEscapeCode; ++i) {
+      symbols.push_back(std::move(candidates[i].second));
+    }
+    symbol_table.reset(new StringSymbolTable(std::move(symbols)));
+  }
+  return symbol_table;
+}
+
+std::unique_ptr<StringSymbolTable> StringSymbolTable::deserialize(
+    const std::string& bytes) {
+  if (bytes.size() < sizeof(uint32_t)) {
+    return nullptr;
+  }
+  const size_t payload_size = bytes.size() - sizeof(uint32_t);
+  uint32_t crc;
+  memcpy(&crc, bytes.data() + payload_size, sizeof(crc));
+  if (crc != crc32c::value(reinterpret_cast<const int8_t*>(bytes.data()), payload_size)) {
+    return nullptr;
+  }
+  const std::string payload = bytes.substr(0, payload_size);
+  size_t pos = 0;
+  uint32_t version;
+  uint32_t num_symbols;
+  if (!read_value(payload, pos, version) || version != kSymbolTableVersion ||
+      !read_value(payload, pos, num_symbols) || num_symbols > kEscapeCode) {
+    return nullptr;
+  }
+  std::vector<std::string> symbols;
+  for (uint32_t i = 0; i < num_symbols; ++i) {
+    uint8_t symbol_size;
+    if (!read_value(payload, pos, symbol_size) || symbol_size == 0 ||
+        symbol_size > kMaxSymbolSize || payload.size() - pos < symbol_size) {
+      return nullptr;
+    }
+    symbols.push_back(payload.substr(pos, symbol_size));
+    pos += symbol_size;
+  }
+  if (pos != payload.size()) {
+    return nullptr;
+  }
+  return std::unique_ptr<StringSymbolTable>(new StringSymbolTable(std::move(symbols)));
+}
+
+std::string StringSymbolTable::serialize() const {
+  std::string bytes;
+  append_value(bytes, kSymbolTableVersion);
+  append_value(bytes, static_cast<uint32_t>(symbols_.size()));
+  for (const auto& symbol : symbols_) {
+    append_value(bytes, static_cast<uint8_t>(symbol.size()));
+    bytes += symbol;
+  }
+  append_value(bytes,
+               crc32c::value(reinterpret_cast<const int8_t*>(bytes.data()), bytes.size()));
+  return bytes;
+}
+
+uint8_t StringSymbolTable::findLongestSymbol(const std::string_view str) const {
+  for (const auto code : codes_by_first_byte_[static_cast<uint8_t>(str.front())]) {
+    const size_t symbol_size = symbol_sizes_[code];
+    if (symbol_size <= str.size() &&
+        !memcmp(padded_symbols_[code].data(), str.data(), symbol_size)) {
+      return code;
+    }
+  }
+  return kEscapeCode;
+}
+
+void StringSymbolTable::encode(const std::string_view str, std::string& encoded) const {
+  encoded.clear();
+  encoded.reserve(maxEncodedSize(str.size()));
+  for (size_t pos = 0; pos < str.size();) {
+    const auto code = findLongestSymbol(str.substr(pos));
+    encoded.push_back(static_cast<char>(code));
+    if (code == kEscapeCode) {
+      encoded.push_back(str[pos++]);
+    } else {
+      pos += symbol_sizes_[code];
+    }
+  }
+}
+
+void StringSymbolTable::decode(const std::string_view encoded, std::string& str) const {
+  // a code decodes to at most kMaxSymbolSize bytes, which are copied at once
+  str.resize(encoded.size() * kMaxSymbolSize);
+  char* out = &str[0];
+  for (size_t pos = 0; pos < encoded.size(); ++pos) {
+    const auto code = static_cast<uint8_t>(encoded[pos]);
+    if (code == kEscapeCode) {
+      if (++pos < encoded.size()) {
+        *out++ = encoded[pos];
+      }
+      continue;
+    }
+    memcpy(out, padded_symbols_[code].data(), kMaxSymbolSize);
+    out += symbol_sizes_[code];
+  }
+  str.resize(out - str.data());
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    StringSymbolTable.h
+ * @brief   Static symbol table compressing the strings of a dictionary one at a time
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Replaces substrings of up to kMaxSymbolSize bytes by one byte codes. The symbols are
+ * learned from a sample of the strings as in FSST (Boncz et al., "FSST: Fast Random
+ * Access String Compression", VLDB 2020), and a byte not covered by a symbol is escaped.
+ * Every string is encoded on its own, and its encoding only depends on the table, so
+ * two strings are equal if and only if their encodings are.
+ */
+class StringSymbolTable {
+ public:
+  /// Learns the symbols which shorten the strings of sample the most
+  static std::unique_ptr<StringSymbolTable> train(
+      const std::vector<std::string_view>& sample);
+
+  /// The table serialized by serialize(), or null if bytes are not one
+  static std::unique_ptr<StringSymbolTable> deserialize(const std::string& bytes);
+
+  std::string serialize() const;
+
+  void encode(const std::string_view str, std::string& encoded) const;
+
+  std::string encode(const std::string_view str) const {
+    std::string encoded;
+    encode(str, encoded);
+    return encoded;
+  }
+
+  void decode(const std::string_view encoded, std::string& str) const;
+
+  std::string decode(const std::string_view encoded) const {
+    std::string str;
+    decode(encoded, str);
+    return str;
+  }
+
+  size_t numSymbols() const { return symbols_.size(); }
+
+  /// Longest encoding of a string of num_bytes bytes, every byte escaped
+  static constexpr size_t maxEncodedSize(const size_t num_bytes) {
+    return 2 * num_bytes;
+  }
+
+  static constexpr size_t kMaxSymbolSize{8};
+
+ private:
+  explicit StringSymbolTable(std::vector<std::string> symbols);
+
+  /// Code of the longest symbol str starts with, kEscapeCode if there is none
+  uint8_t findLongestSymbol(const std::string_view str) const;
+
+  static constexpr uint8_t kEscapeCode{255};
+
+  std::vector<std::string> symbols_;  // by code
+  // the codes of the symbols starting with each byte, longest symbols first
+  std::array<std::vector<uint8_t>, 256> codes_by_first_byte_;
+  // by code, the symbols padded to kMaxSymbolSize bytes so that decoding copies whole
+  // words, and their sizes, zero for unused codes
+  std::array<std::array<char, kMaxSymbolSize>, kEscapeCode> padded_symbols_;
+  std::array<uint8_t, kEscapeCode> symbol_sizes_;
+};
@@ -16,6 +16,9 @@
 
 #include "TestHelpers.h"
 
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/feather.h>
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
@@ -31,6 +34,7 @@
 #include "Parser/parser.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/ArrowUtil.h"
 #include "Shared/geo_types.h"
 #include "Shared/scope.h"
 
@@ -534,6 +538,83 @@ TEST(NullValuesTest, NullTextColumn) {
                "SELECT COUNT(col3) FROM fsi_nulls_text WHERE col3 IS NOT NULL;")));
 }
 
+// Two record batches of a nullable BIGINT column and of a dictionary encoded string
+// column, written as an uncompressed Feather version 2 file, i.e. an Arrow IPC file
+void write_arrow_file(const std::string& file_path) {
+  arrow::Int64Builder id_builder;
+  ARROW_THROW_NOT_OK(id_builder.AppendValues({1, 2, 3}));
+  ARROW_THROW_NOT_OK(id_builder.AppendNull());
+  std::shared_ptr<arrow::Array> ids;
+  ARROW_THROW_NOT_OK(id_builder.Finish(&ids));
+
+  arrow::StringBuilder dictionary_builder;
+  ARROW_THROW_NOT_OK(dictionary_builder.AppendValues({"a", "b", "c"}));
+  std::shared_ptr<arrow::Array> dictionary;
+  ARROW_THROW_NOT_OK(dictionary_builder.Finish(&dictionary));
+  arrow::Int32Builder index_builder;
+  ARROW_THROW_NOT_OK(index_builder.AppendValues({0, 2, 2, 1}));
+  std::shared_ptr<arrow::Array> indices;
+  ARROW_THROW_NOT_OK(index_builder.Finish(&indices));
+  auto dictionary_type = arrow::dictionary(arrow::int32(), arrow::utf8());
+  std::shared_ptr<arrow::Array> names;
+  ARROW_ASSIGN_OR_THROW(
+      names, arrow::DictionaryArray::FromArrays(dictionary_type, indices, dictionary));
+
+  auto schema = arrow::schema(
+      {arrow::field("id", arrow::int64()), arrow::field("name", dictionary_type)});
+  auto table = arrow::Table::Make(
+      schema,
+      {std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{ids, ids}),
+       std::make_shared<arrow::ChunkedArray>(arrow::ArrayVector{names, names})});
+  std::shared_ptr<arrow::io::FileOutputStream> file;
+  ARROW_ASSIGN_OR_THROW(file, arrow::io::FileOutputStream::Open(file_path));
+  auto properties = arrow::ipc::feather::WriteProperties::Defaults();
+  properties.compression = arrow::Compression::UNCOMPRESSED;
+  ARROW_THROW_NOT_OK(arrow::ipc::feather::WriteTable(*table, file.get(), properties));
+  ARROW_THROW_NOT_OK(file->Close());
+}
+
+class ArrowFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    file_path_ = boost::filesystem::absolute(BASE_PATH "/arrow_file_test.arrow").string();
+    write_arrow_file(file_path_);
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists arrow_file_table;"));
+  }
+
+  void TearDown() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists arrow_file_table;"));
+    boost::filesystem::remove(file_path_);
+  }
+
+  std::string file_path_;
+};
+
+TEST_F(ArrowFileTest, SelectAcrossRecordBatches) {
+  // the second fragment spans both record batches
+  run_ddl_statement(
+      "CREATE TEMPORARY TABLE arrow_file_table (id BIGINT, name TEXT ENCODING DICT) "
+      "WITH (storage_type='ARROW:" +
+      file_path_ + "', fragment_size=3);");
+  CHECK_EQ(12, v<int64_t>(run_simple_agg("SELECT SUM(id) FROM arrow_file_table;")));
+  CHECK_EQ(2,
+           v<int64_t>(run_simple_agg(
+               "SELECT COUNT(*) FROM arrow_file_table WHERE id IS NULL;")));
+  CHECK_EQ(4,
+           v<int64_t>(run_simple_agg(
+               "SELECT COUNT(*) FROM arrow_file_table WHERE name = 'c';")));
+  check_query<NullableString>(
+      "SELECT name FROM arrow_file_table GROUP BY name ORDER BY name;",
+      {"a", "b", "c"});
+}
+
+TEST_F(ArrowFileTest, MismatchedColumnType) {
+  EXPECT_ANY_THROW(run_ddl_statement(
+      "CREATE TEMPORARY TABLE arrow_file_table (id INTEGER, name TEXT ENCODING DICT) "
+      "WITH (storage_type='ARROW:" +
+      file_path_ + "');"));
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -569,6 +650,7 @@ int main(int argc, char** argv) {
 
   QR::init(BASE_PATH);
   registerArrowCsvForeignStorage();
+  registerArrowFileForeignStorage();
   int err{0};
   try {
     err = RUN_ALL_TESTS();
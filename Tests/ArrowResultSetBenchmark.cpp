@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+#include "../ImportExport/Importer.h"
+#include "../Logger/Logger.h"
+#include "../QueryEngine/ArrowResultSet.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using QR = QueryRunner::QueryRunner;
+
+namespace {
+
+constexpr size_t kNumRows{1 << 22};
+
+// A table of kNumRows rows of an int, a double and a dictionary encoded string
+void create_table() {
+  TestHelpers::init_logger_stderr_only();
+  QR::init(BASE_PATH);
+  QR::get()->runDDLStatement("DROP TABLE IF EXISTS arrow_bench;");
+  QR::get()->runDDLStatement(
+      "CREATE TABLE arrow_bench (x INT, y DOUBLE, str TEXT ENCODING DICT(32));");
+  auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable("arrow_bench");
+  CHECK(td);
+  auto loader = QR::get()->getLoader(td);
+  CHECK(loader);
+  const auto col_descs = loader->get_column_descs();
+  std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+  for (const auto cd : col_descs) {
+    import_buffers.push_back(std::make_unique<import_export::TypedImportBuffer>(
+        cd, loader->getStringDict(cd)));
+  }
+  for (size_t i = 0; i < kNumRows; ++i) {
+    const auto key = (i * 2654435761ULL) % 100000;
+    const std::vector<std::string> values{
+        std::to_string(key), std::to_string(key * 0.25), "str" + std::to_string(key)};
+    size_t index{0};
+    for (const auto cd : col_descs) {
+      import_buffers[index]->add_value(
+          cd, values[index], /*is_null=*/false, import_export::CopyParams());
+      ++index;
+    }
+  }
+  loader->load(import_buffers, kNumRows);
+}
+
+std::once_flag setup_flag;
+
+//! Convert the results of query to an Arrow record batch in memory, i.e. what the Arrow
+//! results of the clients cost besides the serialization
+void convertToArrow(benchmark::State& state, const std::string& query) {
+  std::call_once(setup_flag, create_table);
+  const auto rows = QR::get()->runSQL(query, ExecutorDeviceType::CPU);
+  std::vector<std::string> col_names;
+  for (size_t i = 0; i < rows->colCount(); ++i) {
+    col_names.push_back("col_" + std::to_string(i));
+  }
+  const ArrowResultSetConverter converter(
+      rows, nullptr, ExecutorDeviceType::CPU, 0, col_names, -1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(converter.convertToArrow());
+  }
+  state.SetItemsProcessed(state.iterations() * rows->rowCount());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(convertToArrow, Projection, "SELECT x, y, str FROM arrow_bench;")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(convertToArrow,
+                  GroupBy,
+                  "SELECT x, COUNT(*), AVG(y) FROM arrow_bench GROUP BY x;")
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
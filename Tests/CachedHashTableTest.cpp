@@ -34,6 +34,7 @@
 #include "QueryEngine/UDFCompiler.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Shared/SystemParameters.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
 namespace po = boost::program_options;
@@ -47,6 +48,8 @@ using namespace TestHelpers;
 
 using QR = QueryRunner::QueryRunner;
 
+extern size_t g_join_hash_table_cache_bytes;
+
 const int kNoMatch = -1;
 const int kNotPresent = -2;
 
@@ -569,6 +572,39 @@ TEST(Select, DropAndReCreate_OneToMany_HashTable_WithReversedTupleInsertion) {
   run_ddl_statement("DROP TABLE cache_invalid_t2;");
 }
 
+TEST(Select, JoinHashTableCacheEviction) {
+  ScopeGuard reset_cache_bytes = [orig = g_join_hash_table_cache_bytes] {
+    g_join_hash_table_cache_bytes = orig;
+  };
+  import_tables_cache_invalidation_for_CPU_one_to_one_join(false);
+
+  run_query(
+      "SELECT t1.id1, t2.id1 FROM cache_invalid_t1 t1 join cache_invalid_t2 t2 on "
+      "t1.id1 = t2.id1;",
+      ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+  // room for a single table: the second one evicts the first
+  g_join_hash_table_cache_bytes =
+      QR::get()->getCachedJoinHashTable(0)->size() * sizeof(int32_t);
+  run_query(
+      "SELECT t1.id1, t2.id1 FROM cache_invalid_t1 t1 join cache_invalid_t2 t2 on "
+      "t1.id2 = t2.id2;",
+      ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+  // tables larger than the budget are not cached
+  g_join_hash_table_cache_bytes = 0;
+  run_query(
+      "SELECT t1.id1, t2.id1 FROM cache_invalid_t1 t1 join cache_invalid_t2 t2 on "
+      "t1.id1 = t2.id1;",
+      ExecutorDeviceType::CPU);
+  CHECK_EQ(QR::get()->getNumberOfCachedJoinHashTables(), (unsigned long)1);
+
+  run_ddl_statement("DROP TABLE cache_invalid_t1;");
+  run_ddl_statement("DROP TABLE cache_invalid_t2;");
+}
+
 TEST(Truncate, JoinCacheInvalidationTest) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -65,6 +65,46 @@ double ColumnarResultsTester::getEntryAt<double>(const size_t row_idx,
   return reinterpret_cast<double*>(column_buffers_[column_idx])[row_idx];
 }
 
+// the typed column reads of the storage return the values of the rows
+void test_typed_column_values(const ResultSet& result_set,
+                              const std::vector<TargetInfo>& target_infos) {
+  for (size_t target_idx = 0; target_idx < target_infos.size(); ++target_idx) {
+    if (!result_set.isTypedColumnAccessPossible(target_idx)) {
+      continue;
+    }
+    const auto type = target_infos[target_idx].sql_type.get_type();
+    std::vector<int64_t> int_values;
+    std::vector<float> float_values;
+    std::vector<double> double_values;
+    if (type == kFLOAT) {
+      result_set.getColumnValues(target_idx, 0, result_set.entryCount(), float_values);
+    } else if (type == kDOUBLE) {
+      result_set.getColumnValues(target_idx, 0, result_set.entryCount(), double_values);
+    } else {
+      result_set.getColumnValues(target_idx, 0, result_set.entryCount(), int_values);
+    }
+    size_t row_idx = 0;
+    for (size_t entry_idx = 0; entry_idx < result_set.entryCount(); ++entry_idx) {
+      if (result_set.isRowAtEmpty(entry_idx)) {
+        continue;
+      }
+      const auto row = result_set.getRowAtNoTranslations(entry_idx);
+      if (type == kFLOAT) {
+        ASSERT_LT(row_idx, float_values.size());
+        ASSERT_FLOAT_EQ(v<float>(row[target_idx]), float_values[row_idx]);
+      } else if (type == kDOUBLE) {
+        ASSERT_LT(row_idx, double_values.size());
+        ASSERT_DOUBLE_EQ(v<double>(row[target_idx]), double_values[row_idx]);
+      } else {
+        ASSERT_LT(row_idx, int_values.size());
+        ASSERT_EQ(v<int64_t>(row[target_idx]), int_values[row_idx]);
+      }
+      ++row_idx;
+    }
+    ASSERT_EQ(row_idx, int_values.size() + float_values.size() + double_values.size());
+  }
+}
+
 void test_columnar_conversion(const std::vector<TargetInfo>& target_infos,
                               const QueryMemoryDescriptor& query_mem_desc,
                               const size_t non_empty_step_size,
@@ -83,6 +123,8 @@ void test_columnar_conversion(const std::vector<TargetInfo>& target_infos,
                       generator,
                       non_empty_step_size);
 
+  test_typed_column_values(result_set, target_infos);
+
   // Columnar Conversion:
   std::vector<SQLTypeInfo> col_types;
   for (size_t i = 0; i < result_set.colCount(); ++i) {
@@ -171,7 +213,17 @@ TEST(Construct, Empty) {
 }
 
 // Projections:
-// TODO(Saman): add tests for Projections
+TEST(ProjectionRowWise, MixedTypes) {
+  auto target_infos = generate_custom_agg_target_infos({8, 4, 2, 1}, {}, {}, {});
+  target_infos.push_back(TargetInfo{
+      false, kMIN, SQLTypeInfo{kDOUBLE, false}, SQLTypeInfo{kNULLT, false}, true, false});
+  const auto query_mem_desc = projection_rowwise_desc(target_infos, 8, 200);
+  for (auto is_parallel : {false, true}) {
+    for (auto step_size : {1, 2, 13, 67, 127}) {
+      test_columnar_conversion(target_infos, query_mem_desc, step_size, is_parallel);
+    }
+  }
+}
 
 // Perfect Hash:
 TEST(PerfectHashRowWise, OneCol_64Key_64Agg_wo_avg) {
@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <string>
 #include <utility>
+#include <vector>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -31,6 +32,8 @@
 
 using QR = QueryRunner::QueryRunner;
 
+extern double g_fragment_merge_max_fill_fraction;
+
 namespace {
 
 inline void run_ddl_statement(const std::string& stmt) {
@@ -257,6 +260,91 @@ TEST_F(MultiFragMetadataUpdate, NoChanges) {
   }
 }
 
+TEST_F(MultiFragMetadataUpdate, DeleteDropsFragments) {
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  const auto count_rows = []() {
+    const auto rows = run_multiple_agg("SELECT COUNT(*) FROM " + g_table_name + ";",
+                                       ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(crt_row.size(), size_t(1));
+    return TestHelpers::v<int64_t>(crt_row[0]);
+  };
+  ASSERT_EQ(td->fragmenter->getFragmentsForQuery().fragments.size(), size_t(5));
+
+  // y is 0 to 3 in the first fragment, which is dropped, the next ones have negative
+  // values and the last one takes the inserts
+  run_multiple_agg("DELETE FROM " + g_table_name + " WHERE y >= 0;",
+                   ExecutorDeviceType::CPU);
+  EXPECT_EQ(td->fragmenter->getFragmentsForQuery().fragments.size(), size_t(4));
+  EXPECT_EQ(count_rows(), int64_t(4));
+
+  // inserts still go to the last fragment
+  TestHelpers::ValuesGenerator gen(g_table_name);
+  run_multiple_agg(gen(1, 1, 1, 1.1, 1.2, "'1/1/2019'", "'1/1/2019'", "'foo'"),
+                   ExecutorDeviceType::CPU);
+  EXPECT_EQ(count_rows(), int64_t(5));
+}
+
+TEST_F(MultiFragMetadataUpdate, VacuumFragments) {
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  const auto count_rows = []() {
+    const auto rows = run_multiple_agg("SELECT COUNT(*) FROM " + g_table_name + ";",
+                                       ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(crt_row.size(), size_t(1));
+    return TestHelpers::v<int64_t>(crt_row[0]);
+  };
+
+  // half of the third fragment, a quarter of the fourth one
+  run_multiple_agg("DELETE FROM " + g_table_name + " WHERE y = -4 OR y = 6 OR y = 8;",
+                   ExecutorDeviceType::CPU);
+  EXPECT_EQ(cat->getFragmentsToVacuum(td, 0.4), std::vector<int>({2}));
+  EXPECT_EQ(cat->getFragmentsToVacuum(td, 0), std::vector<int>({2, 3}));
+
+  EXPECT_TRUE(cat->vacuumFragment(td, 2));
+  EXPECT_EQ(count_rows(), int64_t(17));
+  EXPECT_EQ(td->fragmenter->getFragmentInfo(2)->getPhysicalNumTuples(), size_t(2));
+  // nothing left to remove
+  EXPECT_FALSE(cat->vacuumFragment(td, 2));
+  EXPECT_EQ(cat->getFragmentsToVacuum(td, 0), std::vector<int>({3}));
+}
+
+TEST_F(MultiFragMetadataUpdate, MergeSmallFragments) {
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  const auto sum_and_count = []() {
+    const auto rows = run_multiple_agg(
+        "SELECT SUM(CAST(y AS BIGINT)), COUNT(*) FROM " + g_table_name + ";",
+        ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(crt_row.size(), size_t(2));
+    return std::make_pair(TestHelpers::v<int64_t>(crt_row[0]),
+                          TestHelpers::v<int64_t>(crt_row[1]));
+  };
+
+  // nothing to merge while the fragments are full
+  EXPECT_EQ(cat->mergeSmallFragments(td->tableId), size_t(0));
+
+  // leaves two rows in each of the second and third fragments
+  run_multiple_agg(
+      "DELETE FROM " + g_table_name + " WHERE y = 4 OR y = -2 OR y = -4 OR y = 6;",
+      ExecutorDeviceType::CPU);
+  cat->vacuumDeletedRows(td->tableId);
+  const auto expected = sum_and_count();
+  EXPECT_EQ(expected.second, int64_t(16));
+
+  const auto max_fill_fraction = g_fragment_merge_max_fill_fraction;
+  g_fragment_merge_max_fill_fraction = 0.75;
+  EXPECT_EQ(cat->mergeSmallFragments(td->tableId), size_t(2));
+  g_fragment_merge_max_fill_fraction = max_fill_fraction;
+
+  // the four moved rows fill a new last fragment
+  EXPECT_EQ(td->fragmenter->getFragmentsForQuery().fragments.size(), size_t(4));
+  EXPECT_EQ(sum_and_count(), expected);
+}
+
 template <int NSHARDS>
 class MetadataUpdate : public ::testing::Test {
   void SetUp() override {
@@ -383,6 +471,41 @@ void BODY_F(MetadataUpdate, IntRemoveNull) {
   run_op_per_fragment(td, check_fragment_metadata(1, (int32_t)3, 3, false));
 }
 
+void BODY_F(MetadataUpdate, ColumnarUpdate) {
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+
+  // the values need no conversion, and are copied into the chunks column by column
+  run_multiple_agg("UPDATE " + g_table_name + " SET x = x * 2, y = y + 1, c = c;",
+                   ExecutorDeviceType::CPU);
+  // Check int col: expected range 1,4 nulls, as updates only widen the range
+  run_op_per_fragment(td, check_fragment_metadata(1, (int32_t)1, 4, true));
+
+  recompute_metadata(td, *cat);
+  run_op_per_fragment(td,
+                      check_fragment_metadata(1,
+                                              (int32_t)2,
+                                              4,
+                                              true,
+                                              // Check int not null col: range 2,3
+                                              2,
+                                              (int32_t)2,
+                                              3,
+                                              false,
+                                              // Check dict col: still all foo
+                                              8,
+                                              (int32_t)0,
+                                              0,
+                                              false));
+
+  const auto rows = run_multiple_agg(
+      "SELECT COUNT(*) FROM " + g_table_name + " WHERE x IS NULL AND c = 'foo';",
+      ExecutorDeviceType::CPU);
+  const auto crt_row = rows->getNextRow(true, true);
+  ASSERT_EQ(crt_row.size(), size_t(1));
+  EXPECT_EQ(TestHelpers::v<int64_t>(crt_row[0]), int64_t(td->nShards ? td->nShards : 1));
+}
+
 void BODY_F(MetadataUpdate, NotNullInt) {
   const auto cat = QR::get()->getCatalog();
   const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
@@ -524,6 +647,99 @@ void BODY_F(MetadataUpdate, AlterAfterEmptied) {
                                               std::numeric_limits<int32_t>::lowest(),
                                               true));
 }
+void BODY_F(MetadataUpdate, ReencodeColumns) {
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  const std::string query{"SELECT SUM(x), COUNT(x), SUM(y), MIN(skey + x) FROM " +
+                          g_table_name + ";"};
+  const auto get_results = [&query]() {
+    const auto rows = run_multiple_agg(query, ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    std::vector<int64_t> results;
+    for (const auto& target : crt_row) {
+      results.push_back(TestHelpers::v<int64_t>(target));
+    }
+    return results;
+  };
+  const auto results = get_results();
+
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+  TableOptimizer optimizer(td, executor.get(), *cat);
+  optimizer.recomputeMetadata();
+  const auto narrower_types = optimizer.getNarrowerColumnTypes();
+  // x, y and skey fit 8 bits, z is encoded in 8 bits already
+  ASSERT_EQ(narrower_types.size(), size_t(3));
+  for (const auto& [cd, new_type] : narrower_types) {
+    EXPECT_EQ(new_type.get_compression(), kENCODING_FIXED);
+    EXPECT_EQ(new_type.get_comp_param(), 8);
+    EXPECT_EQ(new_type.get_size(), 1);
+    cat->reencodeColumn(td, cd, new_type);
+  }
+  EXPECT_TRUE(optimizer.getNarrowerColumnTypes().empty());
+
+  for (const auto shard : cat->getPhysicalTablesDescriptors(td)) {
+    const auto cd = cat->getMetadataForColumn(shard->tableId, "x");
+    EXPECT_EQ(cd->columnType.get_compression(), kENCODING_FIXED);
+    EXPECT_EQ(cd->columnType.get_size(), 1);
+  }
+  run_op_per_fragment(td, check_fragment_metadata(1, (int32_t)1, 2, true));
+  run_op_per_fragment(td, check_fragment_metadata(2, (int32_t)1, 2, false));
+  EXPECT_EQ(results, get_results());
+
+  // inserts after re-encoding use the narrower encoding
+  TestHelpers::ValuesGenerator gen(g_table_name);
+  run_multiple_agg(gen(3, 3, 3, 3, 3, "'1/1/2010'", "'1/1/2010'", "'foo'", 0),
+                   ExecutorDeviceType::CPU);
+  const auto new_results = get_results();
+  EXPECT_EQ(results[0] + 3, new_results[0]);
+  EXPECT_EQ(results[1] + 1, new_results[1]);
+  EXPECT_EQ(results[2] + 3, new_results[2]);
+}
+
+void BODY_F(MetadataUpdate, CompactDictionary) {
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  TestHelpers::ValuesGenerator gen(g_table_name);
+  run_multiple_agg(gen(3, 3, 3, 3, 3, "'1/1/2010'", "'1/1/2010'", "'bar'", 0),
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg(gen(4, 4, 4, 4, 4, "'1/1/2010'", "'1/1/2010'", "'baz'", 1),
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("DELETE FROM " + g_table_name + " WHERE c = 'bar';",
+                   ExecutorDeviceType::CPU);
+  const auto count_rows = [](const std::string& str) {
+    const auto rows = run_multiple_agg(
+        "SELECT COUNT(*) FROM " + g_table_name + " WHERE c = '" + str + "';",
+        ExecutorDeviceType::CPU);
+    const auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(crt_row.size(), size_t(1));
+    return TestHelpers::v<int64_t>(crt_row[0]);
+  };
+  const auto num_foo_rows = count_rows("foo");
+
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+  TableOptimizer optimizer(td, executor.get(), *cat);
+  optimizer.vacuumDeletedRows();
+  const auto dict_ids = optimizer.getCompactableDictionaryIds();
+  ASSERT_EQ(dict_ids.size(), size_t(1));
+  const auto cd = cat->getMetadataForColumn(td->tableId, "c");
+  ASSERT_EQ(dict_ids.front(), cd->columnType.get_comp_param());
+  // only foo and baz are left
+  EXPECT_EQ(cat->compactDictionary(td, dict_ids.front()), size_t(1));
+  const auto string_dict = cat->getMetadataForDict(dict_ids.front())->stringDict;
+  EXPECT_EQ(string_dict->storageEntryCount(), size_t(2));
+  EXPECT_EQ(string_dict->getIdOfString("baz"), 1);
+  EXPECT_EQ(num_foo_rows, count_rows("foo"));
+  EXPECT_EQ(int64_t(0), count_rows("bar"));
+  EXPECT_EQ(int64_t(1), count_rows("baz"));
+  // nothing to remove the second time
+  EXPECT_EQ(cat->compactDictionary(td, dict_ids.front()), size_t(0));
+
+  run_multiple_agg(gen(5, 5, 5, 5, 5, "'1/1/2010'", "'1/1/2010'", "'bar'", 0),
+                   ExecutorDeviceType::CPU);
+  EXPECT_EQ(int64_t(1), count_rows("bar"));
+  EXPECT_EQ(string_dict->getIdOfString("bar"), 2);
+}
+
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, AlterAfterEmptied)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, AlterAfterOptimize)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, InitialMetadata)
@@ -535,6 +751,9 @@ TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, SmallDateNarrowMin)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, SmallDateNarrowMax)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, DeleteReset)
 TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, EncodedStringNull)
+TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, ReencodeColumns)
+TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, CompactDictionary)
+TEST_UNSHARDED_AND_SHARDED(MetadataUpdate, ColumnarUpdate)
 
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include <benchmark/benchmark.h>
+#include <mutex>
+
+#include "../ImportExport/Importer.h"
+#include "../Logger/Logger.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+using QR = QueryRunner::QueryRunner;
+
+extern bool g_enable_cpu_loop_vectorization;
+
+std::once_flag setup_flag;
+void global_setup() {
+  TestHelpers::init_logger_stderr_only();
+  QR::init(BASE_PATH);
+}
+
+inline void run_ddl_statement(const std::string& create_table_stmt) {
+  QR::get()->runDDLStatement(create_table_stmt);
+}
+
+std::shared_ptr<ResultSet> run_multiple_agg(const std::string& query_str,
+                                            const ExecutorDeviceType device_type) {
+  return QR::get()->runSQL(
+      query_str, device_type, /*hoist_literals=*/true, /*allow_loop_joins=*/true);
+}
+
+class ScanFixture : public benchmark::Fixture {
+ public:
+  void SetUp(const ::benchmark::State& state) override {
+    std::call_once(setup_flag, global_setup);
+
+    run_ddl_statement("DROP TABLE IF EXISTS vectorization_bench;");
+    run_ddl_statement(
+        "CREATE TABLE vectorization_bench (x INT, y BIGINT, z DOUBLE, w SMALLINT) WITH "
+        "(FRAGMENT_SIZE=4000000);");
+
+    auto cat = QR::get()->getCatalog();
+    const auto td = cat->getMetadataForTable("vectorization_bench");
+    CHECK(td);
+    auto loader = QR::get()->getLoader(td);
+    CHECK(loader);
+
+    auto col_descs = loader->get_column_descs();
+    std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+    for (auto cd : col_descs) {
+      import_buffers.push_back(std::unique_ptr<import_export::TypedImportBuffer>(
+          new import_export::TypedImportBuffer(cd, loader->getStringDict(cd))));
+    }
+
+    for (int64_t i = 0; i < state.range(0); i++) {
+      std::vector<std::string> values{std::to_string(i % 10000),
+                                      std::to_string((i * 7919) % 1000003),
+                                      std::to_string(0.5 * (i % 1000)),
+                                      std::to_string(i % 100)};
+      size_t index = 0;
+      for (auto cd : col_descs) {
+        CHECK_LT(index, values.size());
+        import_buffers[index]->add_value(
+            cd, values[index], /*is_null=*/false, import_export::CopyParams());
+        index++;
+      }
+    }
+
+    loader->load(import_buffers, state.range(0));
+
+    // make sure the chunks are in the CPU buffer pool
+    run_multiple_agg("SELECT SUM(x), SUM(y), SUM(z), SUM(w) FROM vectorization_bench;",
+                     ExecutorDeviceType::CPU);
+  }
+
+  void TearDown(const ::benchmark::State& state) override {
+    run_ddl_statement("DROP TABLE IF EXISTS vectorization_bench;");
+  }
+};
+
+// Runs query over state.range(0) rows with the loop vectorizer (state.range(1) = 1) and
+// with the row at a time loop (state.range(1) = 0)
+void run_scan_query(benchmark::State& state, const std::string& query) {
+  const bool enable_cpu_loop_vectorization = g_enable_cpu_loop_vectorization;
+  g_enable_cpu_loop_vectorization = state.range(1);
+  for (auto _ : state) {
+    run_multiple_agg(query, ExecutorDeviceType::CPU);
+  }
+  g_enable_cpu_loop_vectorization = enable_cpu_loop_vectorization;
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! Sum a column filtered by a range of another
+BENCHMARK_DEFINE_F(ScanFixture, FilteredSum)(benchmark::State& state) {
+  run_scan_query(state,
+                 "SELECT SUM(y) FROM vectorization_bench WHERE x > 1000 AND x < 8000;");
+}
+
+BENCHMARK_REGISTER_F(ScanFixture, FilteredSum)
+    ->Ranges({{1 << 20, 1 << 22}, {0, 1}})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Count the rows passing a filter on an arithmetic expression
+BENCHMARK_DEFINE_F(ScanFixture, FilteredCount)(benchmark::State& state) {
+  run_scan_query(state,
+                 "SELECT COUNT(*) FROM vectorization_bench WHERE x * 3 + w < 9000;");
+}
+
+BENCHMARK_REGISTER_F(ScanFixture, FilteredCount)
+    ->Ranges({{1 << 20, 1 << 22}, {0, 1}})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+//! Several aggregates of arithmetic expressions, without a filter
+BENCHMARK_DEFINE_F(ScanFixture, Aggregates)(benchmark::State& state) {
+  run_scan_query(
+      state, "SELECT SUM(x + w), MIN(y), MAX(y), SUM(z * 2) FROM vectorization_bench;");
+}
+
+BENCHMARK_REGISTER_F(ScanFixture, Aggregates)
+    ->Ranges({{1 << 20, 1 << 22}, {0, 1}})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
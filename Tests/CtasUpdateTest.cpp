@@ -24,6 +24,7 @@
 #include "../QueryEngine/ArrowResultSet.h"
 #include "../QueryEngine/Execute.h"
 #include "../Shared/file_delete.h"
+#include "../Shared/scope.h"
 #include "TestHelpers.h"
 
 // uncomment to run full test suite
@@ -33,6 +34,9 @@
 #define BASE_PATH "./tmp"
 #endif
 
+extern bool g_enable_columnar_ctas;
+extern bool g_enable_parallel_column_appends;
+
 using QR = QueryRunner::QueryRunner;
 
 using namespace TestHelpers;
@@ -1282,6 +1286,55 @@ TEST(Itas, SelectStar) {
   run_ddl_statement("DROP TABLE ITAS_TARGET;");
 }
 
+TEST(Itas, ParallelColumnAppends) {
+  ScopeGuard reset = [orig = g_enable_parallel_column_appends] {
+    g_enable_parallel_column_appends = orig;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS ITAS_SOURCE;");
+  run_ddl_statement("DROP TABLE IF EXISTS ITAS_TARGET;");
+
+  const std::string columns{
+      "(id int, big bigint, dbl double, d date, str text encoding dict(32), raw text "
+      "encoding none)"};
+  run_ddl_statement("CREATE TABLE ITAS_SOURCE " + columns + ";");
+  run_multiple_agg(
+      "INSERT INTO ITAS_SOURCE VALUES(0, 0, 0.5, '2020-01-01', 'str', 'raw');",
+      ExecutorDeviceType::CPU);
+  // 2^15 rows, enough values per fragment of the target for the parallel appends
+  for (int64_t row_count = 1; row_count < (1 << 15); row_count *= 2) {
+    const auto offset = std::to_string(row_count);
+    run_ddl_statement("INSERT INTO ITAS_SOURCE SELECT id + " + offset + ", (id + " +
+                      offset + ") * 3, dbl, d, str, raw FROM ITAS_SOURCE;");
+  }
+
+  for (const bool parallel_appends : {false, true}) {
+    g_enable_parallel_column_appends = parallel_appends;
+    run_ddl_statement("DROP TABLE IF EXISTS ITAS_TARGET;");
+    run_ddl_statement("CREATE TABLE ITAS_TARGET " + columns +
+                      " WITH (fragment_size=20000);");
+    run_ddl_statement("INSERT INTO ITAS_TARGET SELECT * FROM ITAS_SOURCE;");
+
+    auto rows = run_multiple_agg(
+        "SELECT COUNT(*), SUM(id), COUNT(raw), COUNT(DISTINCT str) FROM ITAS_TARGET;",
+        ExecutorDeviceType::CPU);
+    auto row = rows->getNextRow(false, false);
+    ASSERT_EQ(row.size(), size_t(4));
+    EXPECT_EQ(v<int64_t>(row[0]), int64_t(1) << 15);
+    EXPECT_EQ(v<int64_t>(row[1]), ((int64_t(1) << 15) - 1) * (int64_t(1) << 14));
+    EXPECT_EQ(v<int64_t>(row[2]), int64_t(1) << 15);
+    EXPECT_EQ(v<int64_t>(row[3]), int64_t(1));
+    // the rows of the chunks line up across the columns and the fragments
+    rows = run_multiple_agg(
+        "SELECT COUNT(*) FROM ITAS_TARGET WHERE big <> id * 3 OR d <> '2020-01-01';",
+        ExecutorDeviceType::CPU);
+    row = rows->getNextRow(false, false);
+    EXPECT_EQ(v<int64_t>(row[0]), int64_t(0));
+  }
+
+  run_ddl_statement("DROP TABLE ITAS_SOURCE;");
+  run_ddl_statement("DROP TABLE ITAS_TARGET;");
+}
+
 TEST(Itas, UnsupportedBooleanCast) {
   run_ddl_statement("DROP TABLE IF EXISTS ITAS_TARGET;");
   run_ddl_statement("DROP TABLE IF EXISTS ITAS_SOURCE;");
@@ -2097,6 +2150,25 @@ TEST(Itas, InsertIntoTempTableFromSelect) {
   itasTestBody(columnDescriptors, ")", ")", "TEMPORARY");
 }
 
+TEST(Itas, InsertIntoTableFromSelectRowWise) {
+  ScopeGuard reset = [orig = g_enable_columnar_ctas] { g_enable_columnar_ctas = orig; };
+  g_enable_columnar_ctas = false;
+  std::vector<std::shared_ptr<TestColumnDescriptor>> columnDescriptors = {
+      BOOLEAN,
+      TINYINT,
+      SMALLINT,
+      INTEGER,
+      BIGINT,
+      NUMERIC,
+      TEXT,
+      TIME,
+      DATE,
+      TIMESTAMP,
+  };
+
+  itasTestBody(columnDescriptors, ")", ")");
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   TestHelpers::init_logger_stderr_only(argc, argv);
@@ -1830,6 +1830,41 @@ TEST(SysCatalog, RenameUser_UserDoesntExist) {
                std::runtime_error);
 }
 
+TEST(SysCatalog, ConcurrentLogins) {
+  using namespace std::string_literals;
+
+  ScopeGuard scope_guard = [] {
+    run_ddl_statement("DROP DATABASE IF EXISTS nydb;");
+    run_ddl_statement("DROP USER chuck;");
+  };
+  run_ddl_statement("CREATE USER chuck (password='password');");
+  run_ddl_statement("CREATE DATABASE nydb (owner='chuck');");
+  // as after a restart, the first logins build the catalog
+  Catalog_Namespace::Catalog::remove("nydb");
+  ASSERT_FALSE(Catalog_Namespace::Catalog::get("nydb"s));
+
+  constexpr size_t kLoginCount{8};
+  std::vector<std::shared_ptr<Catalog_Namespace::Catalog>> cats(kLoginCount);
+  std::vector<std::thread> logins;
+  for (size_t i = 0; i < kLoginCount; ++i) {
+    logins.emplace_back([&cats, i] {
+      Catalog_Namespace::UserMetadata user_meta;
+      auto username = "chuck"s;
+      auto database_name = "nydb"s;
+      cats[i] = sys_cat.login(database_name, username, "password"s, user_meta, false);
+    });
+  }
+  for (auto& login : logins) {
+    login.join();
+  }
+  // a single catalog was built and all the sessions share it
+  const auto cat = Catalog_Namespace::Catalog::get("nydb"s);
+  ASSERT_TRUE(cat);
+  for (const auto& login_cat : cats) {
+    EXPECT_EQ(cat, login_cat);
+  }
+}
+
 namespace {
 
 std::unique_ptr<QR> get_qr_for_user(
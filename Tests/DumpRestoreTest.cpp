@@ -226,6 +226,12 @@ void BODY_F(DumpRestoreTest, DumpMigrate_Altered) {
 void BODY_F(DumpRestoreTest, DumpMigrate_Altered_Rollback) {
   dump_restore(true, true, true);
 }
+void BODY_F(DumpRestoreTest, DumpMigrate_Zstd) {
+  if (boost::process::search_path("zstd").string().empty()) {
+    GTEST_SKIP() << "zstd is not found";
+  }
+  dump_restore(true, false, false, {"compression='zstd'"});
+}
 
 // restore table tests
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpRestore)
@@ -237,6 +243,7 @@ TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate)
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Rollback)
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Altered)
 TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Altered_Rollback)
+TEST_UNSHARDED_AND_SHARDED(DumpRestoreTest, DumpMigrate_Zstd)
 
 class GeoDumpRestoreTest : public ::testing::Test {
  protected:
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "DataMgrTestHelpers.h"
+
+namespace {
+
+SQLTypeInfo make_type_info(const SQLTypes type,
+                           const EncodingType compression,
+                           const int comp_param) {
+  SQLTypeInfo ti(type, false);
+  ti.set_compression(compression);
+  ti.set_comp_param(comp_param);
+  return ti;
+}
+
+//! Append state.range(0) values, base + k * scale with k in [0, range), to a new chunk
+//! of type ti, which the encoder of the type compresses and computes the metadata of
+void appendData(benchmark::State& state,
+                const SQLTypeInfo ti,
+                const int64_t base,
+                const int64_t range,
+                const int64_t scale) {
+  std::vector<int64_t> values(state.range(0));
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = base + static_cast<int64_t>((i * 2654435761ULL) % range) * scale;
+  }
+  for (auto _ : state) {
+    TestHelpers::TestBuffer buffer(ti);
+    auto src_data = reinterpret_cast<int8_t*>(values.data());
+    benchmark::DoNotOptimize(buffer.encoder->appendData(src_data, values.size(), ti));
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(appendData,
+                  BigintNone,
+                  make_type_info(kBIGINT, kENCODING_NONE, 0),
+                  0,
+                  1 << 30,
+                  1)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(appendData,
+                  BigintFixed16,
+                  make_type_info(kBIGINT, kENCODING_FIXED, 16),
+                  0,
+                  1 << 15,
+                  1)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(appendData,
+                  TimestampDiff16,
+                  make_type_info(kTIMESTAMP, kENCODING_DIFF, 16),
+                  1600000000,
+                  1 << 15,
+                  1)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(appendData,
+                  DateInDays,
+                  make_type_info(kDATE, kENCODING_DATE_IN_DAYS, 0),
+                  0,
+                  1 << 15,
+                  86400)
+    ->Arg(1 << 22)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
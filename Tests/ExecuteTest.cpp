@@ -16,11 +16,18 @@
 
 #include "TestHelpers.h"
 
+#include "../DataMgr/Allocators/GpuScratchPool.h"
+#include "../DataMgr/Allocators/HostBufferPool.h"
 #include "../ImportExport/Importer.h"
 #include "../Parser/parser.h"
 #include "../QueryEngine/ArrowResultSet.h"
 #include "../QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
 #include "../QueryEngine/Execute.h"
+#include "../QueryEngine/FragmentResultCache.h"
+#include "../QueryEngine/JitObjectCache.h"
+#include "../QueryEngine/PredictiveWatchdog.h"
+#include "../QueryEngine/QueryProfile.h"
+#include "../QueryEngine/ResultSetCache.h"
 #include "../QueryEngine/ResultSetReductionJIT.h"
 #include "../QueryRunner/QueryRunner.h"
 #include "../Shared/StringTransform.h"
@@ -33,10 +40,15 @@
 #include <gtest/gtest.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/any.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/program_options.hpp>
 
+#include <unistd.h>
 #include <cmath>
 #include <cstdio>
+#include <fstream>
+#include <regex>
+#include <thread>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -53,16 +65,46 @@ extern bool g_allow_cpu_retry;
 extern bool g_enable_watchdog;
 extern bool g_skip_intermediate_count;
 extern bool g_use_tbb_pool;
+extern bool g_use_work_stealing_pool;
+extern bool g_enable_cpu_sub_fragment_kernels;
+extern bool g_enable_hybrid_execution;
+extern bool g_enable_gpu_streaming;
+extern size_t g_gpu_streams_per_device;
+extern bool g_enable_group_by_buffer_spill;
+extern size_t g_cpu_sub_fragment_size;
+extern bool g_enable_chunk_prefetch;
+extern bool g_enable_deferred_lazy_fetch;
+extern bool g_enable_block_zone_maps;
+extern bool g_enable_top_n_fragment_skipping;
+extern bool g_enable_count_from_chunk_metadata;
+extern bool g_enable_tiered_cpu_compilation;
+extern bool g_enable_parallel_cpu_code_generation;
+extern bool g_enable_jit_perf_map;
+extern bool g_enable_calcite_plan_cache;
+extern size_t g_block_zone_map_rows;
+extern size_t g_bloom_filter_bits_per_value;
+extern bool g_enable_parallel_join_hash_table_build;
+extern bool g_enable_smem_join_hash_table;
+extern bool g_enable_partitioned_sharded_joins;
+extern bool g_enable_smem_baseline_group_by;
+extern bool g_enable_sparse_hll;
 
 extern unsigned g_trivial_loop_join_threshold;
+extern unsigned g_dynamic_watchdog_time_limit;
 extern bool g_enable_overlaps_hashjoin;
 extern double g_gpu_mem_limit_percent;
 
 extern bool g_enable_window_functions;
+extern bool g_enable_window_function_gpu_sort;
 extern bool g_enable_calcite_view_optimize;
 extern bool g_enable_bump_allocator;
 extern bool g_enable_interop;
+extern bool g_enable_interpreted_interop;
+extern bool g_enable_datetrunc_bucket_tables;
 extern bool g_enable_union;
+extern bool g_enable_parallel_union_branches;
+extern bool g_enable_semi_join;
+extern bool g_enable_shared_columnar_fetches;
 
 extern size_t g_leaf_count;
 extern bool g_cluster;
@@ -1295,6 +1337,1057 @@ TEST(Select, FilterAndSimpleAggregation) {
   }
 }
 
+TEST(Select, CpuSubFragmentKernels) {
+  ScopeGuard reset_sub_fragment_state =
+      [orig_enable = g_enable_cpu_sub_fragment_kernels,
+       orig_size = g_cpu_sub_fragment_size] {
+        g_enable_cpu_sub_fragment_kernels = orig_enable;
+        g_cpu_sub_fragment_size = orig_size;
+      };
+  // split every fragment into kernels of a few rows each, including ranges which do
+  // not divide the fragment evenly
+  g_enable_cpu_sub_fragment_kernels = true;
+  for (const size_t sub_fragment_size : {1, 3, 7}) {
+    g_cpu_sub_fragment_size = sub_fragment_size;
+    const auto dt = ExecutorDeviceType::CPU;
+    c("SELECT COUNT(*) FROM test;", dt);
+    c("SELECT COUNT(*) FROM test WHERE x > 6 AND x < 8;", dt);
+    c("SELECT MIN(x), MAX(z), SUM(x + y) FROM test;", dt);
+    c("SELECT AVG(ff), SUM(fn) FROM test WHERE z > 100;", dt);
+    c("SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT y, SUM(x), MAX(t) FROM test GROUP BY y ORDER BY y;", dt);
+    c("SELECT COUNT(DISTINCT x) FROM test;", dt);
+    c("SELECT str, COUNT(*) FROM test GROUP BY str HAVING COUNT(*) > 5 ORDER BY str;",
+      dt);
+    // projections are not split, verify they still return every row
+    c("SELECT COUNT(*) FROM (SELECT x FROM test WHERE y > 40);", dt);
+  }
+}
+
+TEST(Select, HybridExecution) {
+  ScopeGuard reset_hybrid_state = [orig_enable = g_enable_hybrid_execution] {
+    g_enable_hybrid_execution = orig_enable;
+  };
+  g_enable_hybrid_execution = true;
+  for (auto dt : {ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // run the queries a few times, so the CPU share of the outer rows follows the
+    // measured throughput
+    for (size_t i = 0; i < 3; ++i) {
+      c("SELECT COUNT(*) FROM test;", dt);
+      c("SELECT MIN(x), MAX(z), SUM(x + y) FROM test WHERE z > 100;", dt);
+      c("SELECT x, COUNT(*), AVG(ff) FROM test GROUP BY x ORDER BY x;", dt);
+      c("SELECT y, SUM(x), MAX(t) FROM test GROUP BY y ORDER BY y;", dt);
+      c("SELECT str, COUNT(*) FROM test GROUP BY str ORDER BY str;", dt);
+      c("SELECT COUNT(*) FROM (SELECT x FROM test WHERE y > 40);", dt);
+      // count distinct and joins stay on GPU only
+      c("SELECT COUNT(DISTINCT x) FROM test;", dt);
+      c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x = b.x;", dt);
+    }
+  }
+}
+
+TEST(Select, BlockZoneMaps) {
+  ScopeGuard reset_zone_map_state = [orig_enable = g_enable_block_zone_maps,
+                                     orig_rows = g_block_zone_map_rows,
+                                     orig_sub_fragments =
+                                         g_enable_cpu_sub_fragment_kernels,
+                                     orig_sub_fragment_size = g_cpu_sub_fragment_size] {
+    g_enable_block_zone_maps = orig_enable;
+    g_block_zone_map_rows = orig_rows;
+    g_enable_cpu_sub_fragment_kernels = orig_sub_fragments;
+    g_cpu_sub_fragment_size = orig_sub_fragment_size;
+  };
+  const std::string drop_zone_map_test{"DROP TABLE IF EXISTS zone_map_test;"};
+  run_ddl_statement(drop_zone_map_test);
+  g_sqlite_comparator.query(drop_zone_map_test);
+  run_ddl_statement(
+      "CREATE TABLE zone_map_test(id INT, x SMALLINT ENCODING FIXED(8), ts TIMESTAMP(0), "
+      "d DATE, y BIGINT ENCODING DIFF(16)) WITH (fragment_size=16);");
+  g_sqlite_comparator.query(
+      "CREATE TABLE zone_map_test(id INT, x SMALLINT, ts TIMESTAMP(0), d DATE, y "
+      "BIGINT);");
+  // ordered by id and time, with a null block in the middle of the first fragment
+  for (int id = 0; id < 40; ++id) {
+    const bool is_null = id >= 6 && id < 9;
+    const auto day = std::to_string(1 + id / 2);
+    const std::string insert_query{
+        "INSERT INTO zone_map_test VALUES(" + std::to_string(id) + ", " +
+        (is_null ? "NULL" : std::to_string(id % 7)) + ", " +
+        (is_null ? "NULL" : "'2020-01-01 00:00:" + std::to_string(10 + id) + "'") +
+        ", '2020-02-" + (day.size() < 2 ? "0" + day : day) + "', " +
+        std::to_string(1000000 + id) + ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const bool sub_fragments : {false, true}) {
+    g_enable_cpu_sub_fragment_kernels = sub_fragments;
+    g_cpu_sub_fragment_size = 5;
+    for (const size_t rows_per_block : {1, 3, 64 * 1024}) {
+      g_block_zone_map_rows = rows_per_block;
+      c("SELECT COUNT(*) FROM zone_map_test WHERE id >= 5 AND id < 11;", dt);
+      c("SELECT COUNT(*), MIN(id) FROM zone_map_test WHERE id > 38;", dt);
+      c("SELECT COUNT(*) FROM zone_map_test WHERE id = 100;", dt);
+      c("SELECT SUM(id) FROM zone_map_test WHERE x = 3;", dt);
+      c("SELECT COUNT(*) FROM zone_map_test WHERE ts > '2020-01-01 00:00:25';", dt);
+      c("SELECT COUNT(*) FROM zone_map_test WHERE ts <= '2020-01-01 00:00:18';", dt);
+      c("SELECT COUNT(*) FROM zone_map_test WHERE d = '2020-02-07';", dt);
+      c("SELECT MAX(id) FROM zone_map_test WHERE y < 1000004;", dt);
+      c("SELECT id, x FROM zone_map_test WHERE id >= 14 AND id <= 19 ORDER BY id;", dt);
+      c("SELECT x, COUNT(*) FROM zone_map_test WHERE ts < '2020-01-01 00:00:30' GROUP "
+        "BY x ORDER BY x;",
+        dt);
+      c("SELECT id FROM zone_map_test WHERE id BETWEEN 30 AND 33 ORDER BY id;", dt);
+    }
+  }
+
+  // updating rows in place drops the zone maps of the updated chunk
+  g_block_zone_map_rows = 3;
+  c("SELECT COUNT(*) FROM zone_map_test WHERE id > 100;", dt);
+  run_multiple_agg("UPDATE zone_map_test SET id = id + 1000 WHERE id = 2;", dt);
+  g_sqlite_comparator.query("UPDATE zone_map_test SET id = id + 1000 WHERE id = 2;");
+  c("SELECT COUNT(*) FROM zone_map_test WHERE id > 100;", dt);
+  c("SELECT COUNT(*) FROM zone_map_test WHERE id < 3;", dt);
+
+  run_ddl_statement(drop_zone_map_test);
+  g_sqlite_comparator.query(drop_zone_map_test);
+}
+
+TEST(Select, BlockPointBounds) {
+  ScopeGuard reset_zone_map_state = [orig_enable = g_enable_block_zone_maps,
+                                     orig_rows = g_block_zone_map_rows] {
+    g_enable_block_zone_maps = orig_enable;
+    g_block_zone_map_rows = orig_rows;
+  };
+  g_enable_block_zone_maps = true;
+  run_ddl_statement("DROP TABLE IF EXISTS point_bounds_test;");
+  run_ddl_statement(
+      "CREATE TABLE point_bounds_test(id INT, p POINT, gp GEOMETRY(POINT, 4326) "
+      "ENCODING COMPRESSED(32)) WITH (fragment_size=16);");
+  ScopeGuard drop_table = [] { run_ddl_statement("DROP TABLE point_bounds_test;"); };
+  // the points are inserted along lines, the blocks of consecutive rows are near
+  const auto p_x = [](const int id) { return static_cast<double>(id); };
+  const auto p_y = [](const int id) { return static_cast<double>(id % 5); };
+  const auto gp_x = [](const int id) { return 0.5 * id - 10; };
+  const auto gp_y = [](const int id) { return 0.25 * id - 5; };
+  for (int id = 0; id < 40; ++id) {
+    run_multiple_agg("INSERT INTO point_bounds_test VALUES(" + std::to_string(id) +
+                         ", 'POINT(" + std::to_string(p_x(id)) + " " +
+                         std::to_string(p_y(id)) + ")', 'POINT(" +
+                         std::to_string(gp_x(id)) + " " + std::to_string(gp_y(id)) +
+                         ")');",
+                     ExecutorDeviceType::CPU);
+  }
+  const auto count_points = [](const std::function<bool(int)>& filter) {
+    int64_t count{0};
+    for (int id = 0; id < 40; ++id) {
+      count += filter(id);
+    }
+    return count;
+  };
+  const auto p_distance = [&](const int id, const double x, const double y) {
+    return std::hypot(p_x(id) - x, p_y(id) - y);
+  };
+  const auto gp_distance = [&](const int id, const double x, const double y) {
+    return std::hypot(gp_x(id) - x, gp_y(id) - y);
+  };
+  const std::vector<std::pair<std::string, int64_t>> queries{
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_Distance(p, ST_Point(10, 2)) < "
+       "3.3;",
+       count_points([&](const int id) { return p_distance(id, 10, 2) < 3.3; })},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE 2.5 >= ST_Distance(p, 'POINT(30 "
+       "1)');",
+       count_points([&](const int id) { return p_distance(id, 30, 1) <= 2.5; })},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_DWithin(p, 'POINT(37 3)', 1.5);",
+       count_points([&](const int id) { return p_distance(id, 37, 3) <= 1.5; })},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_Distance(p, ST_Point(100, 2)) < "
+       "3;",
+       0},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_Contains('POLYGON((5.5 0.5, "
+       "14.5 0.5, 14.5 3.5, 5.5 3.5, 5.5 0.5))', p);",
+       count_points([&](const int id) {
+         return p_x(id) > 5.5 && p_x(id) < 14.5 && p_y(id) > 0.5 && p_y(id) < 3.5;
+       })},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_Within(p, 'POLYGON((20.5 -1, "
+       "26.5 -1, 26.5 5, 20.5 5, 20.5 -1))') AND id > 22;",
+       count_points([&](const int id) {
+         return p_x(id) > 20.5 && p_x(id) < 26.5 && id > 22;
+       })},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_Distance(gp, "
+       "ST_SetSRID(ST_Point(0, 0), 4326)) < 1.93;",
+       count_points([&](const int id) { return gp_distance(id, 0, 0) < 1.93; })},
+      {"SELECT COUNT(*) FROM point_bounds_test WHERE ST_Distance(ST_GeomFromText("
+       "'POINT(-8 -4)', 4326), gp) <= 1.2;",
+       count_points([&](const int id) { return gp_distance(id, -8, -4) <= 1.2; })}};
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const size_t rows_per_block : {1, 3, 64 * 1024}) {
+    g_block_zone_map_rows = rows_per_block;
+    for (const auto& [query, expected] : queries) {
+      EXPECT_EQ(expected, v<int64_t>(run_simple_agg(query, dt))) << query;
+    }
+  }
+}
+
+TEST(Select, TopNFragmentSkipping) {
+  ScopeGuard reset_top_n_state = [orig = g_enable_top_n_fragment_skipping] {
+    g_enable_top_n_fragment_skipping = orig;
+  };
+  const std::string drop_top_n_test{"DROP TABLE IF EXISTS top_n_skip_test;"};
+  run_ddl_statement(drop_top_n_test);
+  g_sqlite_comparator.query(drop_top_n_test);
+  run_ddl_statement(
+      "CREATE TABLE top_n_skip_test(x INT, y BIGINT, ts TIMESTAMP(0)) WITH "
+      "(fragment_size=8);");
+  g_sqlite_comparator.query("CREATE TABLE top_n_skip_test(x INT, y BIGINT, ts "
+                            "TIMESTAMP(0));");
+  // the first fragments have the smallest values of x, with ties across fragments
+  for (int i = 0; i < 48; ++i) {
+    const std::string insert_query{
+        "INSERT INTO top_n_skip_test VALUES(" + std::to_string(i / 3) + ", " +
+        (i % 5 == 0 ? "NULL" : std::to_string((i * 37) % 48)) +
+        ", '2020-01-01 00:00:" + std::to_string(10 + i) + "');"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const bool enable : {false, true}) {
+    g_enable_top_n_fragment_skipping = enable;
+    c("SELECT x FROM top_n_skip_test ORDER BY x LIMIT 5;", dt);
+    c("SELECT x FROM top_n_skip_test ORDER BY x LIMIT 4 OFFSET 3;", dt);
+    c("SELECT x FROM top_n_skip_test ORDER BY x DESC LIMIT 7;", dt);
+    c("SELECT x FROM top_n_skip_test WHERE x > 2 ORDER BY x LIMIT 5;", dt);
+    c("SELECT y FROM top_n_skip_test WHERE y IS NOT NULL ORDER BY y LIMIT 6;", dt);
+    c("SELECT y FROM top_n_skip_test WHERE y IS NOT NULL ORDER BY y DESC LIMIT 6;", dt);
+    c("SELECT ts FROM top_n_skip_test ORDER BY ts DESC LIMIT 3;", dt);
+    c("SELECT x FROM top_n_skip_test ORDER BY x LIMIT 100;", dt);
+  }
+
+  run_ddl_statement(drop_top_n_test);
+  g_sqlite_comparator.query(drop_top_n_test);
+}
+
+TEST(Select, CalcitePlanCache) {
+  ScopeGuard reset_plan_cache_state = [orig = g_enable_calcite_plan_cache] {
+    g_enable_calcite_plan_cache = orig;
+  };
+  g_enable_calcite_plan_cache = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the queries of each group share a plan with their literals rebound
+    for (const std::string& bound : {"6", "7", "8"}) {
+      c("SELECT COUNT(*) FROM test WHERE x > " + bound + " AND y < 4" + bound + ";", dt);
+      c("SELECT SUM(x) FROM test WHERE y > -4" + bound + " AND x <> 2;", dt);
+    }
+    for (const std::string& str : {"foo", "bar", "baz"}) {
+      c("SELECT COUNT(*) FROM test WHERE str = '" + str + "';", dt);
+      c("SELECT COUNT(*) FROM test WHERE str LIKE '" + str.substr(0, 2) + "%';", dt);
+    }
+    for (const std::string& fraction : {"1.5", "7.5", "9.5"}) {
+      c("SELECT COUNT(*) FROM test WHERE f > " + fraction + ";", dt);
+    }
+    // literals the plans depend on, or repeated ones, are planned by Calcite each time
+    for (const std::string& num : {"1", "2"}) {
+      c("SELECT x, COUNT(*) FROM test GROUP BY " + num + " ORDER BY x;", dt);
+      c("SELECT x FROM test ORDER BY x LIMIT " + num + ";", dt);
+      c("SELECT COUNT(*) FROM test WHERE x > " + num + " OR y > " + num + ";", dt);
+      c("SELECT COUNT(*) FROM test WHERE x + 1 > " + num + " + 6;", dt);
+    }
+    // the keys ignore comments and the layout of the query
+    c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+    c("SELECT COUNT(*)\n  FROM test -- filter\n  WHERE x > 8 ;", dt);
+    c("SELECT COUNT(*) /* filter */ FROM test WHERE   x > 6", dt);
+  }
+
+  // the plans of a database are dropped on DDL
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS plan_cache_test;");
+  run_ddl_statement("CREATE TABLE plan_cache_test (x INT);");
+  run_multiple_agg("INSERT INTO plan_cache_test VALUES (5);", dt);
+  EXPECT_EQ(int64_t(1),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM plan_cache_test WHERE x > 2;", dt)));
+  run_ddl_statement("ALTER TABLE plan_cache_test RENAME COLUMN x TO y;");
+  EXPECT_ANY_THROW(
+      run_multiple_agg("SELECT COUNT(*) FROM plan_cache_test WHERE x > 3;", dt));
+  EXPECT_EQ(int64_t(1),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM plan_cache_test WHERE y > 3;", dt)));
+  run_ddl_statement("DROP TABLE plan_cache_test;");
+}
+
+TEST(Select, TieredCpuCompilation) {
+  ScopeGuard reset_tiered_state = [orig = g_enable_tiered_cpu_compilation] {
+    g_enable_tiered_cpu_compilation = orig;
+  };
+  g_enable_tiered_cpu_compilation = true;
+  // the first runs get the quickly compiled code, the following ones the optimized code
+  // once it's swapped in
+  const auto dt = ExecutorDeviceType::CPU;
+  for (int i = 0; i < 3; ++i) {
+    c("SELECT COUNT(*) FROM test WHERE x * 11 - y > 37;", dt);
+    c("SELECT x, SUM(y * 5) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT str, MAX(x + y) FROM test GROUP BY str ORDER BY str;", dt);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  }
+}
+
+TEST(Select, ParallelCpuCodeGeneration) {
+  ScopeGuard reset_parallel_codegen_state =
+      [orig = g_enable_parallel_cpu_code_generation] {
+        g_enable_parallel_cpu_code_generation = orig;
+      };
+  g_enable_parallel_cpu_code_generation = true;
+  const auto dt = ExecutorDeviceType::CPU;
+  // multi-step queries, whose kernels wait for the code of their step
+  c("SELECT COUNT(*) FROM test WHERE x IN (SELECT y - 35 FROM test WHERE z > 100);", dt);
+  c("SELECT x, COUNT(*) FROM (SELECT x, y * 3 AS y3 FROM test) WHERE y3 > 100 GROUP BY x "
+    "ORDER BY x;",
+    dt);
+  c("SELECT a.x, b.y FROM test a JOIN (SELECT x, MAX(y) AS y FROM test GROUP BY x) b ON "
+    "a.x = b.x ORDER BY a.x, b.y;",
+    dt);
+  // the code cache hands out the code while it may still be generated
+  for (int i = 0; i < 2; ++i) {
+    c("SELECT SUM(x * 7 - y), COUNT(*) FROM test WHERE y > 41;", dt);
+  }
+}
+
+TEST(Select, JitPerfMap) {
+  ScopeGuard reset_perf_map_state = [orig = g_enable_jit_perf_map] {
+    g_enable_jit_perf_map = orig;
+  };
+  g_enable_jit_perf_map = true;
+  const auto dt = ExecutorDeviceType::CPU;
+  // not in the code cache yet, the query gets compiled
+  c("SELECT COUNT(*) FROM test WHERE x * 13 + y > 53;", dt);
+  std::ifstream perf_map("/tmp/perf-" + std::to_string(getpid()) + ".map");
+  ASSERT_TRUE(perf_map.good());
+  // <address> <size> <function> [<fingerprint of the query>]
+  const std::regex entry_regex{
+      "[0-9a-f]+ [0-9a-f]+ \\S*multifrag_query\\S* \\[[0-9a-f]{32}\\]"};
+  bool found_query{false};
+  std::string line;
+  while (std::getline(perf_map, line)) {
+    found_query = found_query || std::regex_match(line, entry_regex);
+  }
+  ASSERT_TRUE(found_query);
+}
+
+TEST(Select, ResultSetCache) {
+  ScopeGuard reset_result_set_cache_state = [orig = g_enable_result_set_cache] {
+    g_enable_result_set_cache = orig;
+    ResultSetCache::instance().clear();
+  };
+  g_enable_result_set_cache = true;
+  auto& cache = ResultSetCache::instance();
+  cache.clear();
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // each repetition gets its own copy of the cached rows
+    for (int i = 0; i < 3; ++i) {
+      c("SELECT x, SUM(y), COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+      c("SELECT str, MAX(x) FROM test GROUP BY str ORDER BY str;", dt);
+      c("SELECT x, y FROM test WHERE y > 41 ORDER BY x, y LIMIT 5;", dt);
+    }
+    // the rows of count distinct targets point to memory of the query
+    c("SELECT COUNT(DISTINCT x) FROM test;", dt);
+    c("SELECT COUNT(DISTINCT x) FROM test;", dt);
+  }
+  EXPECT_GT(cache.getStats().hits, uint64_t(0));
+
+  // queries sharing a subquery reuse its result
+  {
+    const auto dt = ExecutorDeviceType::CPU;
+    const std::string subquery{"(SELECT y FROM test WHERE x = 8 AND z > 100)"};
+    c("SELECT COUNT(*) FROM test WHERE y IN " + subquery + ";", dt);
+    const auto hits = cache.getStats().hits;
+    c("SELECT SUM(x) FROM test WHERE y IN " + subquery + ";", dt);
+    c("SELECT MAX(z) FROM test WHERE y NOT IN " + subquery + ";", dt);
+    EXPECT_LT(hits, cache.getStats().hits);
+  }
+
+  // the results are dropped once their tables change
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS result_set_cache_test;");
+  run_ddl_statement("CREATE TABLE result_set_cache_test (x INT, s TEXT ENCODING DICT);");
+  run_multiple_agg("INSERT INTO result_set_cache_test VALUES (1, 'a');", dt);
+  const std::string count_query{"SELECT COUNT(*), SUM(x) FROM result_set_cache_test;"};
+  for (int i = 0; i < 2; ++i) {
+    const auto rows = run_multiple_agg(count_query, dt);
+    const auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(size_t(2), crt_row.size());
+    EXPECT_EQ(int64_t(1), v<int64_t>(crt_row[0]));
+  }
+  const auto hits = cache.getStats().hits;
+  run_multiple_agg("INSERT INTO result_set_cache_test VALUES (2, 'b');", dt);
+  EXPECT_EQ(int64_t(2), v<int64_t>(run_simple_agg(count_query, dt)));
+  EXPECT_EQ(int64_t(3),
+            v<int64_t>(run_simple_agg("SELECT SUM(x) FROM result_set_cache_test;", dt)));
+  run_multiple_agg("UPDATE result_set_cache_test SET x = 5 WHERE x = 2;", dt);
+  EXPECT_EQ(int64_t(6),
+            v<int64_t>(run_simple_agg("SELECT SUM(x) FROM result_set_cache_test;", dt)));
+  EXPECT_EQ(int64_t(1),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM result_set_cache_test WHERE s = 'b';", dt)));
+  run_multiple_agg("DELETE FROM result_set_cache_test WHERE s = 'b';", dt);
+  EXPECT_EQ(int64_t(0),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM result_set_cache_test WHERE s = 'b';", dt)));
+  EXPECT_EQ(hits, cache.getStats().hits);
+  run_ddl_statement("DROP TABLE result_set_cache_test;");
+}
+
+TEST(Select, HostBufferPool) {
+  ScopeGuard reset_host_buffer_pool_state = [orig = g_enable_host_buffer_pool] {
+    g_enable_host_buffer_pool = orig;
+    HostBufferPool::instance().clear();
+  };
+  g_enable_host_buffer_pool = true;
+  auto& pool = HostBufferPool::instance();
+  pool.clear();
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the blocks of a query are back in the pool once its rows are gone
+    for (int i = 0; i < 3; ++i) {
+      c("SELECT x, SUM(y), COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+      c("SELECT COUNT(DISTINCT x) FROM test;", dt);
+      c("SELECT x, y FROM test WHERE y > 41 ORDER BY x, y LIMIT 5;", dt);
+    }
+  }
+  EXPECT_GT(pool.getStats().hits, uint64_t(0));
+  EXPECT_LE(pool.getStats().bytes, g_host_buffer_pool_bytes);
+  pool.clear();
+  EXPECT_EQ(size_t(0), pool.size());
+}
+
+TEST(Select, GpuScratchPool) {
+  ScopeGuard reset_gpu_scratch_pool_state = [orig = g_enable_gpu_scratch_pool] {
+    g_enable_gpu_scratch_pool = orig;
+    GpuScratchPool::instance().clear();
+  };
+  g_enable_gpu_scratch_pool = true;
+  auto& pool = GpuScratchPool::instance();
+  pool.clear();
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the sorts allocate the same scratch buffers every time
+    for (int i = 0; i < 3; ++i) {
+      c("SELECT x, y FROM test ORDER BY x DESC, y LIMIT 5;", dt);
+      c("SELECT x, COUNT(*) AS n FROM test GROUP BY x ORDER BY n DESC, x LIMIT 2;", dt);
+      c("SELECT a.x, b.str FROM test AS a JOIN test_inner AS b ON a.x = b.x ORDER BY "
+        "a.x, b.str;",
+        dt);
+    }
+  }
+  EXPECT_LE(pool.getStats().bytes, g_gpu_scratch_pool_bytes);
+  pool.clear();
+  EXPECT_EQ(size_t(0), pool.size());
+  EXPECT_EQ(size_t(0), pool.getStats().bytes);
+}
+
+TEST(Select, PredictiveWatchdog) {
+  ScopeGuard reset_predictive_watchdog_state = [orig = g_enable_predictive_watchdog] {
+    g_enable_predictive_watchdog = orig;
+    PredictiveWatchdog::instance().reset();
+  };
+  auto& watchdog = PredictiveWatchdog::instance();
+  watchdog.reset();
+  const size_t one_gb = size_t(1) << 30;
+  // nothing is estimated before enough steps ran
+  EXPECT_FALSE(watchdog.estimateSeconds(ExecutorDeviceType::CPU, one_gb));
+  for (size_t i = 0; i < PredictiveWatchdog::kMinRecordedSteps; ++i) {
+    watchdog.recordStep(ExecutorDeviceType::CPU, one_gb, 1.);
+    // too small to say anything about the rate
+    watchdog.recordStep(ExecutorDeviceType::CPU, 1024, 1.);
+  }
+  const auto cpu_seconds = watchdog.estimateSeconds(ExecutorDeviceType::CPU, one_gb);
+  ASSERT_TRUE(cpu_seconds);
+  EXPECT_DOUBLE_EQ(1., *cpu_seconds);
+  EXPECT_FALSE(watchdog.estimateSeconds(ExecutorDeviceType::GPU, one_gb));
+
+  const size_t limit_bytes = g_dynamic_watchdog_time_limit / 1000. * one_gb;
+  DeviceCostModel::InputBytes small_input{one_gb, 0};
+  DeviceCostModel::InputBytes large_input{2 * limit_bytes, 0};
+  EXPECT_EQ(ExecutorDeviceType::CPU,
+            watchdog.checkStep(small_input, ExecutorDeviceType::CPU, 0));
+  EXPECT_THROW(watchdog.checkStep(large_input, ExecutorDeviceType::CPU, 0),
+               WatchdogException);
+  // a GPU step runs on CPU when its input doesn't fit in the GPU buffer pool
+  EXPECT_EQ(ExecutorDeviceType::GPU,
+            watchdog.checkStep(small_input, ExecutorDeviceType::GPU, 2 * one_gb));
+  EXPECT_EQ(ExecutorDeviceType::CPU,
+            watchdog.checkStep(small_input, ExecutorDeviceType::GPU, one_gb / 2));
+  // unless it would run over the limit on CPU
+  EXPECT_EQ(ExecutorDeviceType::GPU,
+            watchdog.checkStep(large_input, ExecutorDeviceType::GPU, one_gb / 2));
+  // the chunks already on the GPUs don't take more room
+  DeviceCostModel::InputBytes resident_input{one_gb, one_gb};
+  EXPECT_EQ(ExecutorDeviceType::GPU,
+            watchdog.checkStep(resident_input, ExecutorDeviceType::GPU, one_gb / 2));
+
+  for (size_t i = 0; i < PredictiveWatchdog::kMinRecordedSteps; ++i) {
+    watchdog.recordStep(ExecutorDeviceType::GPU, 10 * one_gb, 1.);
+  }
+  EXPECT_EQ(
+      ExecutorDeviceType::GPU,
+      watchdog.checkStep(large_input, ExecutorDeviceType::GPU, 2 * large_input.total));
+  DeviceCostModel::InputBytes huge_input{20 * limit_bytes, 0};
+  EXPECT_THROW(watchdog.checkStep(huge_input, ExecutorDeviceType::GPU, 0),
+               WatchdogException);
+
+  // the small steps of the test tables are never estimated over the limit
+  watchdog.reset();
+  g_enable_predictive_watchdog = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (int i = 0; i < 3; ++i) {
+      c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+      c("SELECT x, SUM(y) FROM test GROUP BY x ORDER BY x;", dt);
+    }
+  }
+}
+
+TEST(Select, FragmentResultCache) {
+  ScopeGuard reset_fragment_result_cache_state = [orig = g_enable_fragment_result_cache] {
+    g_enable_fragment_result_cache = orig;
+    FragmentResultCache::instance().clear();
+  };
+  g_enable_fragment_result_cache = true;
+  auto& cache = FragmentResultCache::instance();
+  cache.clear();
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS fragment_result_cache_test;");
+  run_ddl_statement(
+      "CREATE TABLE fragment_result_cache_test (x INT, s TEXT ENCODING DICT) WITH "
+      "(FRAGMENT_SIZE=2);");
+  const auto insert = [dt](const int x) {
+    run_multiple_agg("INSERT INTO fragment_result_cache_test VALUES (" +
+                         std::to_string(x) + ", '" + (x % 2 ? "a" : "b") + "');",
+                     dt);
+  };
+  for (int x = 1; x <= 5; ++x) {
+    insert(x);
+  }
+  const std::string sum_query{"SELECT SUM(x) FROM fragment_result_cache_test;"};
+  const std::string count_query{
+      "SELECT COUNT(*) FROM fragment_result_cache_test WHERE s = 'a';"};
+  EXPECT_EQ(int64_t(15), v<int64_t>(run_simple_agg(sum_query, dt)));
+  EXPECT_EQ(int64_t(3), v<int64_t>(run_simple_agg(count_query, dt)));
+  auto hits = cache.getStats().hits;
+  EXPECT_EQ(int64_t(15), v<int64_t>(run_simple_agg(sum_query, dt)));
+  EXPECT_EQ(int64_t(3), v<int64_t>(run_simple_agg(count_query, dt)));
+  EXPECT_LT(hits, cache.getStats().hits);
+
+  // the appended rows are aggregated with the cached results of the full fragments
+  hits = cache.getStats().hits;
+  insert(6);
+  insert(7);
+  EXPECT_EQ(int64_t(28), v<int64_t>(run_simple_agg(sum_query, dt)));
+  EXPECT_EQ(int64_t(4), v<int64_t>(run_simple_agg(count_query, dt)));
+  EXPECT_LT(hits, cache.getStats().hits);
+  for (int i = 0; i < 2; ++i) {
+    const auto rows = run_multiple_agg(
+        "SELECT s, COUNT(*), MAX(x) FROM fragment_result_cache_test GROUP BY s ORDER BY "
+        "s;",
+        dt);
+    ASSERT_EQ(size_t(2), rows->rowCount());
+    const auto a_row = rows->getNextRow(true, true);
+    EXPECT_EQ(int64_t(4), v<int64_t>(a_row[1]));
+    EXPECT_EQ(int64_t(7), v<int64_t>(a_row[2]));
+    const auto b_row = rows->getNextRow(true, true);
+    EXPECT_EQ(int64_t(3), v<int64_t>(b_row[1]));
+    EXPECT_EQ(int64_t(6), v<int64_t>(b_row[2]));
+  }
+
+  // the updates and deletes of the rows of any fragment drop the results of the table
+  run_multiple_agg("UPDATE fragment_result_cache_test SET x = 10 WHERE x = 1;", dt);
+  EXPECT_EQ(int64_t(37), v<int64_t>(run_simple_agg(sum_query, dt)));
+  run_multiple_agg("DELETE FROM fragment_result_cache_test WHERE s = 'b';", dt);
+  EXPECT_EQ(int64_t(25), v<int64_t>(run_simple_agg(sum_query, dt)));
+  EXPECT_EQ(int64_t(4), v<int64_t>(run_simple_agg(count_query, dt)));
+  run_ddl_statement("DROP TABLE fragment_result_cache_test;");
+}
+
+TEST(Select, CountFromChunkMetadata) {
+  ScopeGuard reset_count_from_chunk_metadata =
+      [orig = g_enable_count_from_chunk_metadata] {
+        g_enable_count_from_chunk_metadata = orig;
+      };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM test;", dt);
+    c("SELECT COUNT(*), COUNT(x), COUNT(ofd) FROM test WHERE x >= 7;", dt);
+    c("SELECT COUNT(*) FROM test WHERE x > 7 AND y < 50;", dt);
+    c("SELECT COUNT(*) FROM test WHERE x < 7;", dt);
+  }
+
+  const auto dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS count_from_chunk_metadata_test;");
+  run_ddl_statement(
+      "CREATE TABLE count_from_chunk_metadata_test (x INT, y INT) WITH "
+      "(FRAGMENT_SIZE=2);");
+  for (const auto& values : {"(1, 1)", "(2, 2)", "(3, NULL)", "(4, 4)", "(5, 5)"}) {
+    run_multiple_agg(
+        "INSERT INTO count_from_chunk_metadata_test VALUES " + std::string(values) + ";",
+        dt);
+  }
+  const auto check_counts = [dt](const std::vector<int64_t>& expected) {
+    for (const bool enable : {true, false}) {
+      g_enable_count_from_chunk_metadata = enable;
+      // the fragments are wholly in the range, partly or not at all
+      const auto rows = run_multiple_agg(
+          "SELECT COUNT(*), COUNT(x), COUNT(y) FROM count_from_chunk_metadata_test;", dt);
+      const auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(3), crt_row.size());
+      for (size_t i = 0; i < crt_row.size(); ++i) {
+        EXPECT_EQ(expected[i], v<int64_t>(crt_row[i]));
+      }
+      EXPECT_EQ(expected[3],
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(*) FROM count_from_chunk_metadata_test WHERE x >= 2;",
+                    dt)));
+      EXPECT_EQ(expected[4],
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(y) FROM count_from_chunk_metadata_test WHERE x > 2;",
+                    dt)));
+    }
+  };
+  check_counts({5, 5, 4, 4, 2});
+  // the counts of the fragments with deleted rows come from their scans
+  run_multiple_agg("DELETE FROM count_from_chunk_metadata_test WHERE x = 4;", dt);
+  check_counts({4, 4, 3, 3, 1});
+  run_ddl_statement("DROP TABLE count_from_chunk_metadata_test;");
+}
+
+TEST(Select, JitObjectCache) {
+  const bool orig_enable = g_enable_jit_object_cache;
+  const size_t orig_limit = g_jit_object_cache_entry_limit;
+  ScopeGuard reset_jit_object_cache_state = [orig_enable, orig_limit] {
+    g_enable_jit_object_cache = orig_enable;
+    g_jit_object_cache_entry_limit = orig_limit;
+  };
+  if (g_jit_object_cache_path.empty()) {
+    g_jit_object_cache_path = std::string(BASE_PATH) + "/omnisci_jit_cache_test";
+  }
+  g_enable_jit_object_cache = true;
+  auto cache = JitObjectCache::get();
+  ASSERT_TRUE(cache);
+  const auto count_entries = [] {
+    size_t entry_count{0};
+    for (boost::filesystem::directory_iterator it(g_jit_object_cache_path), end;
+         it != end;
+         ++it) {
+      ++entry_count;
+    }
+    return entry_count;
+  };
+
+  const auto name = JitObjectCache::getObjectName({"a", "b"}, "target", ".o");
+  EXPECT_NE(name, JitObjectCache::getObjectName({"ab"}, "target", ".o"));
+  EXPECT_NE(name, JitObjectCache::getObjectName({"a", "b"}, "other target", ".o"));
+  cache->write(name, "object");
+  ASSERT_TRUE(cache->contains(name));
+  EXPECT_EQ(*cache->read(name), "object");
+  EXPECT_FALSE(cache->read(JitObjectCache::getObjectName({"c"}, "target", ".o")));
+
+  // the objects of new queries are written, and the cached ones are read back
+  const auto dt = ExecutorDeviceType::CPU;
+  const auto entry_count = count_entries();
+  c("SELECT COUNT(*) FROM test WHERE x * 7 + y * 13 > 123;", dt);
+  c("SELECT SUM(x * 3 - y) FROM test WHERE y * 17 < 2000;", dt);
+  EXPECT_GT(count_entries(), entry_count);
+  c("SELECT COUNT(*) FROM test WHERE x * 7 + y * 13 > 123;", dt);
+
+  g_jit_object_cache_entry_limit = 1;
+  cache->write(JitObjectCache::getObjectName({"d"}, "target", ".o"), "object");
+  EXPECT_EQ(count_entries(), size_t(1));
+}
+
+TEST(Select, BloomFilters) {
+  ScopeGuard reset_bloom_filter_state = [orig = g_bloom_filter_bits_per_value] {
+    g_bloom_filter_bits_per_value = orig;
+  };
+  g_bloom_filter_bits_per_value = 10;
+  const std::string drop_bloom_filter_test{"DROP TABLE IF EXISTS bloom_filter_test;"};
+  run_ddl_statement(drop_bloom_filter_test);
+  g_sqlite_comparator.query(drop_bloom_filter_test);
+  run_ddl_statement(
+      "CREATE TABLE bloom_filter_test(id BIGINT, s TEXT ENCODING DICT(16), d DATE, x "
+      "INT) WITH (fragment_size=8, bloom_filter='id,s,d');");
+  g_sqlite_comparator.query(
+      "CREATE TABLE bloom_filter_test(id BIGINT, s TEXT, d DATE, x INT);");
+  // scattered ids, so that the chunk stats of every fragment cover most of them
+  for (int i = 0; i < 36; ++i) {
+    const auto id = (i * 7919) % 1000;
+    const auto day = std::to_string(1 + (i * 7) % 28);
+    const std::string insert_query{
+        "INSERT INTO bloom_filter_test VALUES(" + std::to_string(id) + ", " +
+        (i == 5 ? "NULL" : "'trace_" + std::to_string(id) + "'") + ", '2020-02-" +
+        (day.size() < 2 ? "0" + day : day) + "', " + std::to_string(i) + ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("bloom_filter_test");
+  CHECK(td);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  ASSERT_EQ(table_info.fragments.size(), size_t(5));
+  for (const auto& fragment : table_info.fragments) {
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+    for (const auto column_name : {"id", "s", "d"}) {
+      const auto cd = cat.getMetadataForColumn(td->tableId, column_name);
+      EXPECT_TRUE(chunk_metadata_map.at(cd->columnId)->bloomFilter);
+    }
+    const auto x_cd = cat.getMetadataForColumn(td->tableId, "x");
+    EXPECT_FALSE(chunk_metadata_map.at(x_cd->columnId)->bloomFilter);
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x FROM bloom_filter_test WHERE id = 919;", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE id = 500;", dt);
+    c("SELECT x FROM bloom_filter_test WHERE s = 'trace_919';", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE s = 'trace_500';", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE s = 'no_such_trace';", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE s IS NULL;", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE d = '2020-02-08';", dt);
+    c("SELECT x FROM bloom_filter_test WHERE id IN (0, 919, 838, 501) ORDER BY x;", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE id IN (500, 501, 502);", dt);
+    c("SELECT x FROM bloom_filter_test WHERE s IN ('trace_919', 'trace_1') ORDER BY x;",
+      dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE id = 919 OR x = 3;", dt);
+    c("SELECT COUNT(*) FROM bloom_filter_test WHERE id = 919 AND x < 100;", dt);
+  }
+
+  // updating rows in place drops the filter of the updated chunk, later appends to the
+  // fragment do not bring it back
+  const auto dt = ExecutorDeviceType::CPU;
+  run_multiple_agg("UPDATE bloom_filter_test SET id = 500 WHERE x = 33;", dt);
+  g_sqlite_comparator.query("UPDATE bloom_filter_test SET id = 500 WHERE x = 33;");
+  c("SELECT x FROM bloom_filter_test WHERE id = 500;", dt);
+  run_multiple_agg("INSERT INTO bloom_filter_test VALUES(501, 'trace_501', NULL, 36);",
+                   dt);
+  g_sqlite_comparator.query(
+      "INSERT INTO bloom_filter_test VALUES(501, 'trace_501', NULL, 36);");
+  c("SELECT x FROM bloom_filter_test WHERE id = 500 OR id = 501 ORDER BY x;", dt);
+  c("SELECT x FROM bloom_filter_test WHERE s = 'trace_501';", dt);
+
+  run_ddl_statement(drop_bloom_filter_test);
+  g_sqlite_comparator.query(drop_bloom_filter_test);
+}
+
+TEST(Select, JoinKeyFragmentSkipping) {
+  ScopeGuard reset_bloom_filter_state = [orig = g_bloom_filter_bits_per_value] {
+    g_bloom_filter_bits_per_value = orig;
+  };
+  g_bloom_filter_bits_per_value = 10;
+  for (const auto table : {"join_skip_fact", "join_skip_dim"}) {
+    const std::string drop_table{"DROP TABLE IF EXISTS "s + table + ";"};
+    run_ddl_statement(drop_table);
+    g_sqlite_comparator.query(drop_table);
+  }
+  run_ddl_statement(
+      "CREATE TABLE join_skip_fact(id BIGINT, x INT) WITH (fragment_size=8, "
+      "bloom_filter='id');");
+  g_sqlite_comparator.query("CREATE TABLE join_skip_fact(id BIGINT, x INT);");
+  run_ddl_statement("CREATE TABLE join_skip_dim(k BIGINT, y INT);");
+  g_sqlite_comparator.query("CREATE TABLE join_skip_dim(k BIGINT, y INT);");
+  // scattered ids, so that the chunk stats of every fragment cover most of them
+  for (int i = 0; i < 36; ++i) {
+    const auto id = i == 5 ? "NULL"s : std::to_string((i * 7919) % 1000);
+    const std::string insert_query{"INSERT INTO join_skip_fact VALUES(" + id + ", " +
+                                   std::to_string(i) + ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+  // keys in the chunk stats of all fragments, a few of them in the table
+  for (const auto k : {500, 501, 502, 919}) {
+    const std::string insert_query{"INSERT INTO join_skip_dim VALUES(" +
+                                   std::to_string(k) + ", " + std::to_string(k % 7) +
+                                   ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT f.x, d.y FROM join_skip_fact f JOIN join_skip_dim d ON f.id = d.k ORDER BY "
+      "f.x;",
+      dt);
+    c("SELECT COUNT(*) FROM join_skip_fact f JOIN join_skip_dim d ON f.id = d.k WHERE "
+      "d.k < 919;",
+      dt);
+    c("SELECT COUNT(*) FROM join_skip_fact f LEFT JOIN join_skip_dim d ON f.id = d.k;",
+      dt);
+  }
+
+  for (const auto table : {"join_skip_fact", "join_skip_dim"}) {
+    const std::string drop_table{"DROP TABLE "s + table + ";"};
+    run_ddl_statement(drop_table);
+    g_sqlite_comparator.query(drop_table);
+  }
+}
+
+TEST(Select, TimePartitions) {
+  for (const auto table : {"partition_test", "partition_source"}) {
+    const std::string drop_table{"DROP TABLE IF EXISTS "s + table + ";"};
+    run_ddl_statement(drop_table);
+    g_sqlite_comparator.query(drop_table);
+  }
+  run_ddl_statement("CREATE TABLE partition_source(ts TIMESTAMP(0), x INT);");
+  run_ddl_statement(
+      "CREATE TABLE partition_test(ts TIMESTAMP(0), x INT) WITH (fragment_size=4, "
+      "partition_column='ts', partition_interval='DAY');");
+  for (const auto table : {"partition_source", "partition_test"}) {
+    g_sqlite_comparator.query("CREATE TABLE "s + table + "(ts TIMESTAMP(0), x INT);");
+  }
+  // four rows of each of three days, in no order of the days
+  for (int i = 0; i < 12; ++i) {
+    const std::string insert_query{
+        "INSERT INTO partition_source VALUES('2020-03-0" + std::to_string(1 + i * 2 % 3) +
+        " 0" + std::to_string(i % 10) + ":00:00', " + std::to_string(i) + ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+  const std::string insert_select{
+      "INSERT INTO partition_test SELECT * FROM partition_source;"};
+  run_ddl_statement(insert_select);
+  g_sqlite_comparator.query(insert_select);
+  const std::string insert_null{"INSERT INTO partition_test VALUES(NULL, 12);"};
+  run_multiple_agg(insert_null, ExecutorDeviceType::CPU);
+  g_sqlite_comparator.query(insert_null);
+
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("partition_test");
+  CHECK(td);
+  const auto ts_cd = cat.getMetadataForColumn(td->tableId, "ts");
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  // a fragment per day, and one for the null
+  ASSERT_EQ(table_info.fragments.size(), size_t(4));
+  for (size_t i = 0; i < 3; ++i) {
+    const auto& fragment = table_info.fragments[i];
+    ASSERT_TRUE(fragment.partition);
+    EXPECT_EQ(fragment.partition->columnId, ts_cd->columnId);
+    EXPECT_EQ(fragment.partition->firstValue, 1583020800 + int64_t(i) * 86400);
+    EXPECT_EQ(fragment.getPhysicalNumTuples(), size_t(4));
+    const auto& chunk_stats =
+        fragment.getChunkMetadataMapPhysical().at(ts_cd->columnId)->chunkStats;
+    EXPECT_GE(chunk_stats.min.bigintval, fragment.partition->firstValue);
+    EXPECT_LE(chunk_stats.max.bigintval, fragment.partition->lastValue);
+  }
+  ASSERT_TRUE(table_info.fragments[3].partition);
+  EXPECT_TRUE(table_info.fragments[3].partition->isNull());
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM partition_test WHERE ts >= '2020-03-02 00:00:00';", dt);
+    c("SELECT COUNT(*) FROM partition_test WHERE ts < '2020-03-02 00:00:00';", dt);
+    c("SELECT x FROM partition_test WHERE ts = '2020-03-03 05:00:00';", dt);
+    c("SELECT x FROM partition_test WHERE ts > '2020-03-02 06:00:00' ORDER BY x;", dt);
+    c("SELECT x FROM partition_test WHERE ts IS NULL;", dt);
+    c("SELECT COUNT(*) FROM partition_test WHERE ts >= '2020-03-04 00:00:00';", dt);
+  }
+  EXPECT_ANY_THROW(run_multiple_agg(
+      "UPDATE partition_test SET ts = '2020-03-04 00:00:00' WHERE x = 0;",
+      ExecutorDeviceType::CPU));
+
+  // a DELETE covering a whole day drops its fragment
+  const std::string delete_day{
+      "DELETE FROM partition_test WHERE ts < '2020-03-02 00:00:00';"};
+  run_multiple_agg(delete_day, ExecutorDeviceType::CPU);
+  g_sqlite_comparator.query(delete_day);
+  EXPECT_EQ(td->fragmenter->getFragmentsForQuery().fragments.size(), size_t(3));
+  c("SELECT COUNT(*) FROM partition_test;", ExecutorDeviceType::CPU);
+
+  for (const auto table : {"partition_test", "partition_source"}) {
+    const std::string drop_table{"DROP TABLE IF EXISTS "s + table + ";"};
+    run_ddl_statement(drop_table);
+    g_sqlite_comparator.query(drop_table);
+  }
+}
+
+TEST(Select, TimePartitionRetention) {
+  run_ddl_statement("DROP TABLE IF EXISTS partition_retention_test;");
+  run_ddl_statement(
+      "CREATE TABLE partition_retention_test(ts TIMESTAMP(3), x INT) WITH "
+      "(partition_column='ts', partition_interval='HOUR', partition_retention=2);");
+  const auto count_rows = []() {
+    return v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM partition_retention_test;",
+                                     ExecutorDeviceType::CPU));
+  };
+  for (const auto hour : {"01", "02"}) {
+    run_multiple_agg("INSERT INTO partition_retention_test VALUES('2020-03-01 "s + hour +
+                         ":30:00.250', 1);",
+                     ExecutorDeviceType::CPU);
+  }
+  EXPECT_EQ(count_rows(), int64_t(2));
+  // the partition of the first hour expires
+  run_multiple_agg(
+      "INSERT INTO partition_retention_test VALUES('2020-03-01 03:00:00.000', 1);",
+      ExecutorDeviceType::CPU);
+  EXPECT_EQ(count_rows(), int64_t(2));
+  EXPECT_EQ(v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM partition_retention_test "
+                                      "WHERE ts < '2020-03-01 02:00:00.000';",
+                                      ExecutorDeviceType::CPU)),
+            int64_t(0));
+  // late rows go to a fragment of their own partition, the null rows never expire
+  run_multiple_agg(
+      "INSERT INTO partition_retention_test VALUES('2020-03-01 02:59:59.999', 1);",
+      ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO partition_retention_test VALUES(NULL, 1);",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg(
+      "INSERT INTO partition_retention_test VALUES('2020-03-01 04:00:00.000', 1);",
+      ExecutorDeviceType::CPU);
+  EXPECT_EQ(count_rows(), int64_t(3));
+  run_ddl_statement("DROP TABLE partition_retention_test;");
+}
+
+TEST(Select, SortColumnFragments) {
+  ScopeGuard reset_zone_map_state = [orig_enable = g_enable_block_zone_maps,
+                                     orig_rows = g_block_zone_map_rows] {
+    g_enable_block_zone_maps = orig_enable;
+    g_block_zone_map_rows = orig_rows;
+  };
+  g_enable_block_zone_maps = true;
+  g_block_zone_map_rows = 4;
+  const std::string drop_sort_column_test{"DROP TABLE IF EXISTS sort_column_test;"};
+  run_ddl_statement(drop_sort_column_test);
+  g_sqlite_comparator.query(drop_sort_column_test);
+  run_ddl_statement(
+      "CREATE TABLE sort_column_test(id INT, y BIGINT ENCODING DIFF(16), s TEXT "
+      "ENCODING NONE, t TEXT ENCODING DICT(8), d DATE) WITH (fragment_size=16, "
+      "sort_column='id');");
+  g_sqlite_comparator.query(
+      "CREATE TABLE sort_column_test(id INT, y BIGINT, s TEXT, t TEXT, d DATE);");
+  // each insert is sorted on its own, the fragments they fill are not
+  for (int i = 0; i < 40; ++i) {
+    const auto id = (i * 17) % 40;
+    const bool is_null = i % 13 == 5;
+    const auto day = std::to_string(1 + id % 28);
+    const std::string insert_query{
+        "INSERT INTO sort_column_test VALUES(" +
+        (is_null ? "NULL" : std::to_string(id)) + ", " + std::to_string(1000000 + i) +
+        ", 'str_" + std::to_string(i) + "', 't_" + std::to_string(i % 3) +
+        "', '2020-02-" + (day.size() < 2 ? "0" + day : day) + "');"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+
+  const auto dt = ExecutorDeviceType::CPU;
+  auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("sort_column_test");
+  CHECK(td);
+  c("SELECT COUNT(*) FROM sort_column_test WHERE id >= 10 AND id < 20;", dt);
+  ASSERT_TRUE(cat.sortFragmentRows(td->tableId));
+  EXPECT_FALSE(cat.sortFragmentRows(td->tableId));
+
+  // the ids of each fragment are in order, nulls first
+  const auto rows = run_multiple_agg(
+      "SELECT id, rowid FROM sort_column_test ORDER BY rowid;", dt);
+  ASSERT_EQ(size_t(40), rows->rowCount());
+  int64_t prev_id{0};
+  for (size_t i = 0; i < rows->rowCount(); ++i) {
+    const auto crt_row = rows->getNextRow(true, true);
+    const auto id = v<int64_t>(crt_row[0]);
+    if (i % 16 != 0) {
+      EXPECT_LE(prev_id, id);
+    }
+    prev_id = id;
+  }
+
+  for (const size_t rows_per_block : {1, 4, 64 * 1024}) {
+    g_block_zone_map_rows = rows_per_block;
+    c("SELECT COUNT(*) FROM sort_column_test WHERE id >= 10 AND id < 20;", dt);
+    c("SELECT COUNT(*) FROM sort_column_test WHERE id = 17;", dt);
+    c("SELECT COUNT(*) FROM sort_column_test WHERE id > 38;", dt);
+    c("SELECT COUNT(*) FROM sort_column_test WHERE id <= 3;", dt);
+    c("SELECT COUNT(*) FROM sort_column_test WHERE id < 0;", dt);
+    c("SELECT COUNT(*) FROM sort_column_test WHERE id IS NULL;", dt);
+    c("SELECT id, y, s, t FROM sort_column_test WHERE id BETWEEN 5 AND 12 ORDER BY y;",
+      dt);
+    c("SELECT MAX(y), MIN(s) FROM sort_column_test WHERE id > 20 AND d < '2020-02-10';",
+      dt);
+    c("SELECT t, COUNT(*) FROM sort_column_test WHERE id < 30 GROUP BY t ORDER BY t;",
+      dt);
+  }
+
+  run_ddl_statement(drop_sort_column_test);
+  g_sqlite_comparator.query(drop_sort_column_test);
+}
+
+TEST(Select, ChunkPrefetch) {
+  ScopeGuard reset_prefetch_state = [orig = g_enable_chunk_prefetch] {
+    g_enable_chunk_prefetch = orig;
+  };
+  g_enable_chunk_prefetch = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // evict the input chunks so the kernels actually have something to prefetch
+    QR::get()->clearGpuMemory();
+    QR::get()->clearCpuMemory();
+    c("SELECT COUNT(*) FROM test WHERE x > 6;", dt);
+    c("SELECT x, SUM(y), COUNT(str) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT real_str FROM test WHERE x = 8 ORDER BY real_str;", dt);
+    c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x = b.x;", dt);
+  }
+}
+
+TEST(Select, DeferredLazyFetch) {
+  ScopeGuard reset_deferred_lazy_fetch_state = [orig = g_enable_deferred_lazy_fetch] {
+    g_enable_deferred_lazy_fetch = orig;
+  };
+  g_enable_deferred_lazy_fetch = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // the chunks of the projected columns are only fetched by the results
+    QR::get()->clearGpuMemory();
+    QR::get()->clearCpuMemory();
+    c("SELECT x, y, t, f, d, str FROM test ORDER BY x, y, t, d, str LIMIT 5;", dt);
+    c("SELECT y, t, f, d, str FROM test WHERE x = 8 ORDER BY t DESC, y, d, str;", dt);
+    c("SELECT x, real_str, y, f FROM test WHERE x = 7 ORDER BY y, f, real_str;", dt);
+    c("SELECT COUNT(*) FROM (SELECT t, d, str FROM test WHERE y > 42 LIMIT 10);", dt);
+  }
+}
+
+TEST(Select, QueryProfile) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    const auto num_rows = v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test;", dt));
+    QueryProfile query_profile;
+    const auto rows = QR::get()
+                          ->runSelectQuery(
+                              "SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;",
+                              dt,
+                              /*hoist_literals=*/true,
+                              /*allow_loop_joins=*/false,
+                              /*just_explain=*/false,
+                              &query_profile)
+                          ->getRows();
+    const auto steps = query_profile.getSteps();
+    ASSERT_FALSE(steps.empty());
+    EXPECT_EQ(rows->rowCount(), steps.back().rows_out);
+    // the first step scans the table, the rows of its kernels are all of the table
+    const auto& first_step = steps.front();
+    ASSERT_FALSE(first_step.kernels.empty());
+    int64_t num_input_rows{0};
+    size_t num_fetched_bytes{0};
+    for (const auto& kernel : first_step.kernels) {
+      num_input_rows += kernel.rows_in;
+      num_fetched_bytes += kernel.cpu_bytes_fetched + kernel.gpu_bytes_fetched;
+    }
+    EXPECT_EQ(num_rows, num_input_rows);
+    EXPECT_GT(num_fetched_bytes, size_t(0));
+    const auto json = query_profile.toJson();
+    EXPECT_NE(std::string::npos, json.find("\"steps\""));
+    EXPECT_NE(std::string::npos, json.find("\"kernels\""));
+  }
+}
+
 TEST(Select, AggregateOnEmptyDecimalColumn) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -1565,6 +2658,15 @@ TEST(Select, InValues) {
       dt);
     c(R"(WITH dimensionValues AS (SELECT b FROM test GROUP BY b ORDER BY b) SELECT x FROM test WHERE b in (SELECT b FROM dimensionValues) GROUP BY x ORDER BY x;)",
       dt);
+    // too sparse for a bitmap, or a range which doesn't fit in one
+    c(R"(SELECT x FROM test WHERE x IN (-2000000000, -1000000000, 7, 8, 1000000000, 2000000000) GROUP BY x ORDER BY x;)",
+      dt);
+    c(R"(SELECT x FROM test WHERE x NOT IN (-2000000000, -1000000000, 7, 1000000000, 2000000000) GROUP BY x ORDER BY x;)",
+      dt);
+    c(R"(SELECT t FROM test WHERE t IN (-9223372036854775807, 1001, 1002, 9223372036854775807) GROUP BY t ORDER BY t;)",
+      dt);
+    c(R"(SELECT t FROM test WHERE t IN (-9223372036854775807, 1001, NULL, 9223372036854775807) GROUP BY t ORDER BY t;)",
+      dt);
   }
 }
 
@@ -2116,6 +3218,30 @@ TEST(Select, CountDistinct) {
   }
 }
 
+TEST(Select, ApproxCountDistinctSparse) {
+  ScopeGuard reset_sparse_hll_state = [orig = g_enable_sparse_hll] {
+    g_enable_sparse_hll = orig;
+  };
+  g_enable_sparse_hll = true;
+  const auto dt = ExecutorDeviceType::CPU;
+  c("SELECT COUNT(*), MIN(x), MAX(x), AVG(y), SUM(z) AS n, APPROX_COUNT_DISTINCT(x) "
+    "FROM test GROUP BY y ORDER BY n;",
+    "SELECT COUNT(*), MIN(x), MAX(x), AVG(y), SUM(z) AS n, COUNT(distinct x) FROM test "
+    "GROUP BY y ORDER BY n;",
+    dt);
+  c("SELECT z, str, AVG(z), APPROX_COUNT_DISTINCT(z) FROM test GROUP BY z, str ORDER "
+    "BY z;",
+    "SELECT z, str, AVG(z), COUNT(distinct z) FROM test GROUP BY z, str ORDER BY z;",
+    dt);
+  c("SELECT z, APPROX_COUNT_DISTINCT(null_str) AS n FROM test GROUP BY z ORDER BY z, n;",
+    "SELECT z, COUNT(distinct null_str) AS n FROM test GROUP BY z ORDER BY z, n;",
+    dt);
+  c("SELECT AVG(z), APPROX_COUNT_DISTINCT(x, 1) AS dx FROM test GROUP BY y HAVING dx > "
+    "1;",
+    "SELECT AVG(z), COUNT(distinct x) AS dx FROM test GROUP BY y HAVING dx > 1;",
+    dt);
+}
+
 TEST(Select, ApproxCountDistinct) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -2229,6 +3355,41 @@ TEST(Select, ApproxCountDistinct) {
   }
 }
 
+TEST(Select, ApproxPercentile) {
+  // the inputs are small enough for the t-digests to be exact, runs on CPU only
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(7., v<double>(run_simple_agg("SELECT APPROX_MEDIAN(x) FROM test;", dt)));
+    ASSERT_EQ(8.,
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(x, 0.95) FROM test;",
+                                       dt)));
+    ASSERT_EQ(-78.,
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(z, 0) FROM test;", dt)));
+    ASSERT_EQ(102.,
+              v<double>(run_simple_agg("SELECT APPROX_PERCENTILE(z, 1) FROM test;", dt)));
+    ASSERT_NEAR((double(-1000.3f) + double(-101.2f)) / 2,
+                v<double>(run_simple_agg("SELECT APPROX_MEDIAN(fn) FROM test;", dt)),
+                static_cast<double>(0.001));
+    ASSERT_EQ(NULL_DOUBLE,
+              v<double>(run_simple_agg("SELECT APPROX_MEDIAN(x) FROM test_empty;", dt)));
+    {
+      const auto rows = run_multiple_agg(
+          "SELECT y, APPROX_MEDIAN(x) FROM test GROUP BY y ORDER BY y;", dt);
+      ASSERT_EQ(size_t(2), rows->rowCount());
+      auto crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(int64_t(42), v<int64_t>(crt_row[0]));
+      ASSERT_EQ(7., v<double>(crt_row[1]));
+      crt_row = rows->getNextRow(true, true);
+      ASSERT_EQ(int64_t(43), v<int64_t>(crt_row[0]));
+      ASSERT_EQ(7.5, v<double>(crt_row[1]));
+    }
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_PERCENTILE(x, 2) FROM test;", dt),
+                 std::runtime_error);
+    EXPECT_THROW(run_multiple_agg("SELECT APPROX_MEDIAN(str) FROM test;", dt),
+                 std::runtime_error);
+  }
+}
+
 TEST(Select, ScanNoAggregation) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -3080,6 +4241,20 @@ TEST(Select, StringsNoneEncoding) {
     c("SELECT COUNT(*) FROM test WHERE real_str LIKE 'real_ba_' or real_str LIKE "
       "'real_fo_';",
       dt);
+    // the patterns matched as a prefix, a suffix or the whole string
+    c("SELECT COUNT(*) FROM test WHERE real_str LIKE 'real%';", dt);
+    c("SELECT COUNT(*) FROM test WHERE real_str NOT LIKE 'rea%';", dt);
+    c("SELECT COUNT(*) FROM test WHERE real_str LIKE '%bar';", dt);
+    c("SELECT COUNT(*) FROM test WHERE real_str LIKE '%real_bar';", dt);
+    c("SELECT COUNT(*) FROM test WHERE real_str LIKE 'real';", dt);
+    c("SELECT COUNT(*) FROM test WHERE real_str LIKE '';", dt);
+    // sqlite LIKE ignores the case
+    c("SELECT COUNT(*) FROM test WHERE real_str ILIKE 'REAL%';",
+      "SELECT COUNT(*) FROM test WHERE real_str LIKE 'REAL%';",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE real_str ILIKE '%FOO';",
+      "SELECT COUNT(*) FROM test WHERE real_str LIKE '%FOO';",
+      dt);
     c("SELECT COUNT(*) FROM test WHERE real_str IS NULL;", dt);
     c("SELECT COUNT(*) FROM test WHERE real_str IS NOT NULL;", dt);
     c("SELECT COUNT(*) FROM test WHERE real_str > 'real_bar';", dt);
@@ -4945,6 +6120,57 @@ TEST(Select, ExtractEpoch) {
   }
 }
 
+TEST(Select, DateTruncateBucketTables) {
+  ScopeGuard reset_bucket_tables_state = [orig = g_enable_datetrunc_bucket_tables] {
+    g_enable_datetrunc_bucket_tables = orig;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS datetrunc_bucket_test;");
+  run_ddl_statement(
+      "CREATE TABLE datetrunc_bucket_test(ts TIMESTAMP(0)) WITH (fragment_size=2);");
+  // the boundaries of the buckets, the leap days and the epoch
+  for (const std::string ts : {"1969-12-31 23:59:59",
+                               "1970-01-01 00:00:00",
+                               "1999-12-31 23:59:59",
+                               "2000-01-01 00:00:00",
+                               "2000-02-28 23:59:59",
+                               "2000-02-29 12:00:00",
+                               "2000-03-01 00:00:00",
+                               "2000-12-31 23:59:59",
+                               "2001-01-01 00:00:00",
+                               "2001-03-31 23:59:59",
+                               "2001-04-01 00:00:00"}) {
+    run_multiple_agg("INSERT INTO datetrunc_bucket_test VALUES('" + ts + "');",
+                     ExecutorDeviceType::CPU);
+  }
+  run_multiple_agg("INSERT INTO datetrunc_bucket_test VALUES(NULL);",
+                   ExecutorDeviceType::CPU);
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const std::string field :
+         {"month", "quarter", "year", "decade", "century", "millennium"}) {
+      std::vector<std::vector<int64_t>> groups[2];
+      for (const bool enable : {false, true}) {
+        g_enable_datetrunc_bucket_tables = enable;
+        const auto rows = run_multiple_agg(
+            "SELECT DATE_TRUNC(" + field +
+                ", ts) AS k, COUNT(*) FROM datetrunc_bucket_test GROUP BY k ORDER BY k;",
+            dt);
+        while (true) {
+          const auto row = rows->getNextRow(true, true);
+          if (row.empty()) {
+            break;
+          }
+          groups[enable].push_back({v<int64_t>(row[0]), v<int64_t>(row[1])});
+        }
+      }
+      ASSERT_EQ(groups[false], groups[true]) << field;
+    }
+  }
+
+  run_ddl_statement("DROP TABLE IF EXISTS datetrunc_bucket_test;");
+}
+
 TEST(Select, DateTruncate2) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7390,6 +8616,27 @@ TEST(Select, GroupByBaselineHash) {
   }
 }
 
+TEST(Select, GroupByBaselineHash_SharedMemory) {
+  ScopeGuard reset_smem_state = [orig_group_by = g_enable_smem_group_by,
+                                 orig_baseline = g_enable_smem_baseline_group_by] {
+    g_enable_smem_group_by = orig_group_by;
+    g_enable_smem_baseline_group_by = orig_baseline;
+  };
+  g_enable_smem_group_by = true;
+  g_enable_smem_baseline_group_by = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x1, x2, x3, x4, COUNT(*) FROM random_test "
+      "GROUP BY x1, x2, x3, x4 ORDER BY x1, x2, x3, x4;",
+      dt);
+    c("SELECT cast(x1 as double) as key, COUNT(*), SUM(x2), MIN(x3), MAX(x4) FROM "
+      "random_test GROUP BY key ORDER BY key;",
+      dt);
+    c("SELECT x, y, COUNT(*), SUM(z), AVG(x) FROM test GROUP BY x, y ORDER BY x, y;",
+      dt);
+  }
+}
+
 TEST(Select, GroupByConstrainedByInQueryRewrite) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -7847,6 +9094,36 @@ TEST(Select, Subqueries) {
   }
 }
 
+TEST(Select, SemiJoinInSubqueries) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  ScopeGuard reset_semi_join = [orig = g_enable_semi_join] {
+    g_enable_semi_join = orig;
+  };
+  for (const auto enable_semi_join : {true, false}) {
+    g_enable_semi_join = enable_semi_join;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner);", dt);
+      // the duplicate values of the subquery don't duplicate the outer rows
+      c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM join_test);", dt);
+      c("SELECT COUNT(*) FROM test WHERE y > 41 AND x IN (SELECT x FROM test_inner) AND "
+        "z < 200;",
+        dt);
+      c("SELECT x, SUM(y) FROM test WHERE x IN (SELECT x FROM join_test WHERE y > 7) "
+        "GROUP BY x ORDER BY x;",
+        dt);
+      c("SELECT COUNT(*) FROM test WHERE x IN (SELECT x FROM test_inner) AND y IN "
+        "(SELECT y FROM test WHERE z > 100);",
+        dt);
+      c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x = b.x WHERE a.y IN "
+        "(SELECT y FROM test WHERE z > 100);",
+        dt);
+      c("SELECT t FROM test WHERE x IN (SELECT x FROM test_inner) ORDER BY t;", dt);
+    }
+  }
+}
+
 TEST(Select, Joins_Arrays) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -8373,6 +9650,63 @@ TEST(Select, Joins_Negative_ShardKey) {
   }
 }
 
+TEST(Select, Joins_PartitionedShards) {
+  const auto save_partitioned_sharded_joins = g_enable_partitioned_sharded_joins;
+  g_enable_partitioned_sharded_joins = true;
+  ScopeGuard reset_partitioned_sharded_joins = [&save_partitioned_sharded_joins] {
+    g_enable_partitioned_sharded_joins = save_partitioned_sharded_joins;
+  };
+  // more shards than devices, and several fragments per shard
+  const auto num_shards = 2 * choose_shard_count();
+  for (const auto table : {"partitioned_shards_1", "partitioned_shards_2"}) {
+    run_ddl_statement("DROP TABLE IF EXISTS " + std::string(table) + ";");
+    run_ddl_statement("CREATE TABLE " + std::string(table) +
+                      " (i INTEGER, j INTEGER, SHARD KEY(i)) WITH (shard_count = " +
+                      std::to_string(num_shards) + ", fragment_size = 2);");
+  }
+  for (int i = 0; i < 20; ++i) {
+    run_multiple_agg("INSERT INTO partitioned_shards_1 VALUES(" + std::to_string(i) +
+                         ", " + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+    if (i % 2 == 0) {
+      run_multiple_agg("INSERT INTO partitioned_shards_2 VALUES(" + std::to_string(i) +
+                           ", " + std::to_string(10 * i) + ");",
+                       ExecutorDeviceType::CPU);
+    }
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(int64_t(10),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM partitioned_shards_1 t1 INNER JOIN "
+                  "partitioned_shards_2 t2 ON t1.i = t2.i;",
+                  dt)));
+    ASSERT_EQ(int64_t(900),
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(t2.j) FROM partitioned_shards_1 t1 INNER JOIN "
+                  "partitioned_shards_2 t2 ON t1.i = t2.i;",
+                  dt)));
+    ASSERT_EQ(int64_t(20),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM partitioned_shards_1 t1 LEFT JOIN "
+                  "partitioned_shards_2 t2 ON t1.i = t2.i;",
+                  dt)));
+    ASSERT_EQ(int64_t(10),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(t2.j) FROM partitioned_shards_1 t1 LEFT JOIN "
+                  "partitioned_shards_2 t2 ON t1.i = t2.i;",
+                  dt)));
+    ASSERT_EQ(int64_t(180),
+              v<int64_t>(run_simple_agg(
+                  "SELECT t2.j FROM partitioned_shards_1 t1 LEFT JOIN "
+                  "partitioned_shards_2 t2 ON t1.i = t2.i WHERE t1.j = 18;",
+                  dt)));
+  }
+  run_ddl_statement("DROP TABLE partitioned_shards_1;");
+  run_ddl_statement("DROP TABLE partitioned_shards_2;");
+}
+
 TEST(Select, Joins_InnerJoin_AtLeastThreeTables) {
   const auto save_watchdog = g_enable_watchdog;
   g_enable_watchdog = false;
@@ -8451,6 +9785,45 @@ TEST(Select, Joins_InnerJoin_AtLeastThreeTables) {
   }
 }
 
+TEST(Select, Joins_InnerJoin_StarParallelBuild) {
+  ScopeGuard reset_parallel_build_state = [orig =
+                                               g_enable_parallel_join_hash_table_build] {
+    g_enable_parallel_join_hash_table_build = orig;
+  };
+  for (const bool parallel_build : {true, false}) {
+    g_enable_parallel_join_hash_table_build = parallel_build;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      c("SELECT count(*) FROM test AS a JOIN join_test AS b ON a.x = b.x JOIN "
+        "test_inner AS c ON a.x = c.x JOIN hash_join_test AS d ON a.x = d.x;",
+        dt);
+      c("SELECT a.y, b.str, d.str FROM test AS a JOIN join_test AS b ON a.x = b.x JOIN "
+        "test_inner AS c ON a.str = c.str JOIN hash_join_test AS d ON a.x = d.x "
+        "ORDER BY a.y, b.str, d.str;",
+        dt);
+    }
+  }
+}
+
+TEST(Select, Joins_SharedMemoryHashTable) {
+  ScopeGuard reset_smem_state = [orig = g_enable_smem_join_hash_table] {
+    g_enable_smem_join_hash_table = orig;
+  };
+  g_enable_smem_join_hash_table = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT a.x, b.str FROM test AS a JOIN test_inner AS b ON a.x = b.x ORDER BY a.x, "
+      "b.str;",
+      dt);
+    c("SELECT count(*) FROM test AS a JOIN join_test AS b ON a.x = b.x JOIN "
+      "test_inner AS c ON a.x = c.x;",
+      dt);
+    c("SELECT a.y, count(*) FROM test AS a JOIN test_inner AS b ON a.x = b.x GROUP BY "
+      "a.y ORDER BY a.y;",
+      dt);
+  }
+}
+
 TEST(Select, Joins_InnerJoin_Filters) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -9969,6 +11342,175 @@ TEST(Select, PuntToCPU) {
       "SELECT COUNT(*) FROM test WHERE x IN (SELECT y FROM test WHERE y > 3);", dt));
 }
 
+TEST(Select, GpuStreaming) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto dt = ExecutorDeviceType::GPU;
+  if (skip_tests(dt)) {
+    return;
+  }
+  ScopeGuard reset_global_flag_state = [orig_streaming = g_enable_gpu_streaming,
+                                        orig_cpu_retry = g_allow_cpu_retry,
+                                        orig_mem_limit = g_gpu_mem_limit_percent] {
+    g_enable_gpu_streaming = orig_streaming;
+    g_allow_cpu_retry = orig_cpu_retry;
+    g_gpu_mem_limit_percent = orig_mem_limit;
+  };
+
+  // leave room on the device for half of the x column of test, so the fragments of
+  // the queries on x run in waves
+  const auto gpu_mem_infos =
+      QR::get()->getCatalog()->getDataMgr().getMemoryInfo(Data_Namespace::GPU_LEVEL);
+  ASSERT_FALSE(gpu_mem_infos.empty());
+  const auto gpu_mem_bytes = gpu_mem_infos.front().maxNumPages *
+                             static_cast<double>(gpu_mem_infos.front().pageSize);
+  g_gpu_mem_limit_percent = g_num_rows * sizeof(int32_t) / gpu_mem_bytes;
+  g_allow_cpu_retry = false;
+  g_enable_gpu_streaming = true;
+  c("SELECT SUM(x) FROM test;", dt);
+  c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+  c("SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+  c("SELECT x FROM test ORDER BY x LIMIT 5;", dt);
+}
+
+TEST(Select, GpuStreamsPerDevice) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  const auto dt = ExecutorDeviceType::GPU;
+  if (skip_tests(dt)) {
+    return;
+  }
+  ScopeGuard reset_global_flag_state = [orig_streams = g_gpu_streams_per_device] {
+    g_gpu_streams_per_device = orig_streams;
+  };
+
+  // the kernels per fragment of the projections and the group by queries run on several
+  // streams of the device at once
+  g_gpu_streams_per_device = 4;
+  c("SELECT COUNT(*) FROM test WHERE x > 7;", dt);
+  c("SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+  c("SELECT x, y FROM test WHERE y > 41 ORDER BY x, y LIMIT 10;", dt);
+  c("SELECT str, SUM(y) FROM test GROUP BY str ORDER BY str;", dt);
+  c("SELECT COUNT(*) FROM test a JOIN test_inner b ON a.x = b.x;", dt);
+  g_gpu_streams_per_device = 1;
+  c("SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+}
+
+TEST(Select, PinnedColumns) {
+  SKIP_ALL_ON_AGGREGATOR();
+  SKIP_WITH_TEMP_TABLES();
+
+  ScopeGuard unpin_columns = [] {
+    run_ddl_statement("ALTER TABLE test SET (PIN_CPU='NONE', PIN_GPU='NONE');");
+  };
+  EXPECT_NO_THROW(run_ddl_statement("ALTER TABLE test SET (PIN_CPU='x, str');"));
+  const auto td = QR::get()->getCatalog()->getMetadataForTable("test");
+  ASSERT_TRUE(td);
+  EXPECT_EQ(td->pinnedCpuColumnIds.size(), size_t(2));
+  EXPECT_TRUE(td->pinnedGpuColumnIds.empty());
+  EXPECT_NO_THROW(run_ddl_statement("PREWARM TABLE test;"));
+  EXPECT_NO_THROW(run_ddl_statement("PREWARM TABLE test WITH (COLUMNS='ALL');"));
+  EXPECT_THROW(run_ddl_statement("ALTER TABLE test SET (PIN_CPU='no_such_column');"),
+               std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("ALTER TABLE test SET (PIN_DISK='ALL');"),
+               std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("PREWARM TABLE test WITH (MEMORY_LEVEL='DISK');"),
+               std::runtime_error);
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    if (dt == ExecutorDeviceType::GPU) {
+      EXPECT_NO_THROW(run_ddl_statement("ALTER TABLE test SET (PIN_GPU='ALL');"));
+      EXPECT_NO_THROW(
+          run_ddl_statement("PREWARM TABLE test WITH (MEMORY_LEVEL='GPU');"));
+    }
+    c("SELECT SUM(x), COUNT(str) FROM test;", dt);
+    c("SELECT str, COUNT(*) FROM test GROUP BY str ORDER BY str;", dt);
+  }
+}
+
+TEST(Select, AnalyzeTable) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  EXPECT_NO_THROW(run_ddl_statement("ANALYZE TABLE test WITH (COLUMNS='x, y');"));
+  EXPECT_NO_THROW(run_ddl_statement("ANALYZE TABLE test;"));
+  const auto cat = QR::get()->getCatalog();
+  const auto td = cat->getMetadataForTable("test");
+  ASSERT_TRUE(td);
+  const auto cd = cat->getMetadataForColumn(td->tableId, "x");
+  ASSERT_TRUE(cd);
+  const auto x_statistics = cat->getColumnStatistics(td->tableId, cd->columnId);
+  ASSERT_TRUE(x_statistics);
+  EXPECT_EQ(x_statistics->rowCount,
+            v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test;",
+                                      ExecutorDeviceType::CPU)));
+  EXPECT_EQ(x_statistics->ndv,
+            v<int64_t>(run_simple_agg("SELECT COUNT(DISTINCT x) FROM test;",
+                                      ExecutorDeviceType::CPU)));
+  EXPECT_TRUE(std::is_sorted(x_statistics->histogramBounds.begin(),
+                             x_statistics->histogramBounds.end()));
+  EXPECT_THROW(run_ddl_statement("ANALYZE TABLE test WITH (COLUMNS='no_such_column');"),
+               std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("ANALYZE TABLE test WITH (SAMPLE='ALL');"),
+               std::runtime_error);
+  EXPECT_THROW(run_ddl_statement("ANALYZE TABLE no_such_table;"), std::runtime_error);
+
+  // the group by queries size their buffers from the statistics
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT x, COUNT(*) FROM test GROUP BY x ORDER BY x;", dt);
+    c("SELECT x, y, COUNT(*) FROM test GROUP BY x, y ORDER BY x, y;", dt);
+    c("SELECT str, SUM(x) FROM test GROUP BY str ORDER BY str;", dt);
+  }
+}
+
+TEST(Select, GroupByBufferSpill) {
+  SKIP_ALL_ON_AGGREGATOR();
+
+  ScopeGuard reset_global_flag_state = [orig_spill = g_enable_group_by_buffer_spill] {
+    g_enable_group_by_buffer_spill = orig_spill;
+    run_ddl_statement("DROP TABLE IF EXISTS spill_test;");
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS spill_test;");
+  run_ddl_statement("CREATE TABLE spill_test (x BIGINT);");
+  for (size_t i = 0; i < 10; ++i) {
+    run_multiple_agg("INSERT INTO spill_test VALUES(" + std::to_string(i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  int64_t row_count{10};
+  const auto double_rows = [&row_count] {
+    run_ddl_statement("INSERT INTO spill_test SELECT x + " + std::to_string(row_count) +
+                      " FROM spill_test;");
+    row_count *= 2;
+  };
+  // a group per row, hashed on the double keys
+  const std::string query{
+      "SELECT COUNT(*), SUM(n), MAX(n) FROM (SELECT CAST(x AS DOUBLE) AS k, COUNT(*) AS "
+      "n FROM spill_test GROUP BY k);"};
+  const auto check_groups = [&query, &row_count](const ExecutorDeviceType dt) {
+    const auto row = run_multiple_agg(query, dt)->getNextRow(false, false);
+    ASSERT_EQ(row.size(), size_t(3));
+    EXPECT_EQ(row_count, v<int64_t>(row[0]));
+    EXPECT_EQ(row_count, v<int64_t>(row[1]));
+    EXPECT_EQ(int64_t(1), v<int64_t>(row[2]));
+  };
+
+  // enough rows for the groups to be estimated, the estimate is cached
+  for (size_t i = 0; i < 11; ++i) {
+    double_rows();
+  }
+  check_groups(ExecutorDeviceType::CPU);
+  // the cached estimate now sizes the buffers for half of the groups
+  double_rows();
+  double_rows();
+  for (const bool spill : {true, false}) {
+    g_enable_group_by_buffer_spill = spill;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      check_groups(dt);
+    }
+  }
+}
+
 TEST(Select, TimestampMeridiesEncoding) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -17959,6 +19501,153 @@ TEST(Select, GeoSpatial_Projection) {
   }
 }
 
+TEST(Select, GeoSpatial_ContainsLargePolygon) {
+  run_ddl_statement("DROP TABLE IF EXISTS geo_grid_test;");
+  run_ddl_statement("CREATE TABLE geo_grid_test (p POINT);");
+  ScopeGuard drop_table = [] { run_ddl_statement("DROP TABLE geo_grid_test;"); };
+  for (int x = -12; x <= 12; x += 2) {
+    for (int y = -12; y <= 12; y += 2) {
+      run_multiple_agg("INSERT INTO geo_grid_test VALUES('POINT(" + std::to_string(x) +
+                           " " + std::to_string(y) + ")');",
+                       ExecutorDeviceType::CPU);
+    }
+  }
+  // a circle of radius 10 with 720 vertices, none of them on the grid, and a square hole
+  std::string circle;
+  for (int i = 0; i <= 720; ++i) {
+    const double angle = M_PI * (i % 720 + 0.5) / 360;
+    circle += (i ? ", " : "") + std::to_string(10 * std::cos(angle)) + " " +
+              std::to_string(10 * std::sin(angle));
+  }
+  const std::string polygon{"'POLYGON((" + circle +
+                            "), (-3.1 -3.1, 3.1 -3.1, 3.1 3.1, -3.1 3.1, -3.1 -3.1))'"};
+  int64_t expected{0};
+  for (int x = -12; x <= 12; x += 2) {
+    for (int y = -12; y <= 12; y += 2) {
+      expected += x * x + y * y < 100 && (std::abs(x) > 3 || std::abs(y) > 3);
+    }
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    ASSERT_EQ(expected,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM geo_grid_test WHERE ST_Contains(" + polygon +
+                      ", p);",
+                  dt)));
+    ASSERT_EQ(expected,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM geo_grid_test WHERE "
+                                        "ST_Contains(ST_GeomFromText(" +
+                                            polygon + "), p);",
+                                        dt)));
+    // the points on the edges and vertices
+    ASSERT_EQ(int64_t(4),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM geo_grid_test WHERE ST_Contains('POLYGON((-2 "
+                  "-2, 2 -2, 2 2, -2 2, -2 -2))', p) AND NOT ST_Contains('POLYGON((-1 "
+                  "-1, 1 -1, 1 1, -1 1, -1 -1))', p) AND ST_X(p) <> 0 AND ST_Y(p) <> 0;",
+                  dt)));
+  }
+}
+
+TEST(Select, GeoSpatial_ContainsPolygonWithHoles) {
+  run_ddl_statement("DROP TABLE IF EXISTS geo_contains_holes_test;");
+  run_ddl_statement(
+      "CREATE TABLE geo_contains_holes_test (id INT, l LINESTRING, poly POLYGON, mpoly "
+      "MULTIPOLYGON);");
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE geo_contains_holes_test;");
+  };
+  const std::string donut{
+      "(-4 -4, 4 -4, 4 4, -4 4, -4 -4), (-2 -2, 2 -2, 2 2, -2 2, -2 -2)"};
+  // the shapes of the rows, against the polygon with a hole below: 1 out of the hole, 2
+  // in the hole, 3 around the hole and 4 with a hole of their own around the hole
+  run_multiple_agg(
+      "INSERT INTO geo_contains_holes_test VALUES(1, 'LINESTRING(2 2, 3 3)', 'POLYGON((2 "
+      "2, 3 2, 3 3, 2 3, 2 2))', 'MULTIPOLYGON(((2 2, 3 2, 3 3, 2 3, 2 2)), ((-3 -3, -2 "
+      "-3, -2 -2, -3 -2, -3 -3)))');",
+      ExecutorDeviceType::CPU);
+  run_multiple_agg(
+      "INSERT INTO geo_contains_holes_test VALUES(2, 'LINESTRING(-0.5 0, 0.5 0)', "
+      "'POLYGON((-0.5 -0.5, 0.5 -0.5, 0.5 0.5, -0.5 0.5, -0.5 -0.5))', 'MULTIPOLYGON(((2 "
+      "2, 3 2, 3 3, 2 3, 2 2)), ((-0.5 -0.5, 0.5 -0.5, 0.5 0.5, -0.5 0.5, -0.5 "
+      "-0.5)))');",
+      ExecutorDeviceType::CPU);
+  run_multiple_agg(
+      "INSERT INTO geo_contains_holes_test VALUES(3, 'LINESTRING(-3 0, 3 0)', "
+      "'POLYGON((-2 -2, 2 -2, 2 2, -2 2, -2 -2))', 'MULTIPOLYGON(((4 4, 6 4, 6 6, 4 6, 4 "
+      "4)))');",
+      ExecutorDeviceType::CPU);
+  run_multiple_agg("INSERT INTO geo_contains_holes_test VALUES(4, 'LINESTRING(-3 -3, 3 "
+                   "-3, 3 3)', 'POLYGON(" +
+                       donut + ")', 'MULTIPOLYGON((" + donut + "))');",
+                   ExecutorDeviceType::CPU);
+  const std::string poly{
+      "'POLYGON((-5 -5, 5 -5, 5 5, -5 5, -5 -5), (-1 -1, 1 -1, 1 1, -1 1, -1 -1))'"};
+  // the same polygon with an island in its hole
+  const std::string mpoly{
+      "'MULTIPOLYGON(((-5 -5, 5 -5, 5 5, -5 5, -5 -5), (-1 -1, 1 -1, 1 1, -1 1, -1 -1)), "
+      "((-0.75 -0.75, 0.75 -0.75, 0.75 0.75, -0.75 0.75, -0.75 -0.75)))'"};
+  const auto contained = [](const std::string& container,
+                            const std::string& column,
+                            const ExecutorDeviceType dt) {
+    return v<int64_t>(run_simple_agg(
+        "SELECT SUM(id) FROM geo_contains_holes_test WHERE ST_Contains(ST_GeomFromText(" +
+            container + "), " + column + ");",
+        dt));
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(int64_t(1 + 4), contained(poly, "l", dt));
+    EXPECT_EQ(int64_t(1 + 4), contained(poly, "poly", dt));
+    EXPECT_EQ(int64_t(1 + 4), contained(poly, "mpoly", dt));
+    EXPECT_EQ(int64_t(1 + 2 + 4), contained(mpoly, "poly", dt));
+    EXPECT_EQ(int64_t(1 + 2 + 4), contained(mpoly, "mpoly", dt));
+  }
+}
+
+TEST(Select, GeoSpatial_CompressedPointBox) {
+  run_ddl_statement("DROP TABLE IF EXISTS geo_compressed_box_test;");
+  run_ddl_statement(
+      "CREATE TABLE geo_compressed_box_test (gp GEOMETRY(POINT, 4326) ENCODING "
+      "COMPRESSED(32));");
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE geo_compressed_box_test;");
+  };
+  for (int x = -6; x <= 6; ++x) {
+    for (int y = -6; y <= 6; ++y) {
+      run_multiple_agg("INSERT INTO geo_compressed_box_test VALUES('POINT(" +
+                           std::to_string(0.5 * x) + " " + std::to_string(0.5 * y) +
+                           ")');",
+                       ExecutorDeviceType::CPU);
+    }
+  }
+  // the points built from the decompressed coordinates aren't tested in the compressed
+  // domain first, the counts of both must match, also for the points on the edges
+  const std::string uncompressed{"ST_SetSRID(ST_Point(ST_X(gp), ST_Y(gp)), 4326)"};
+  const std::vector<std::string> filters{
+      "ST_Contains(ST_GeomFromText('POLYGON((-1 -1, 2 -1, 2 1.5, -1 1.5, -1 -1))', "
+      "4326), $)",
+      "ST_Within($, ST_GeomFromText('POLYGON((-2.5 0, 0 -2.5, 2.5 0, 0 2.5, -2.5 0))', "
+      "4326))",
+      "ST_Intersects(ST_GeomFromText('MULTIPOLYGON(((-3 -3, -1 -3, -1 -1, -3 -1, -3 "
+      "-3)), ((1 1, 3 1, 3 3, 1 3, 1 1)))', 4326), $)",
+      "ST_DWithin($, ST_GeomFromText('POINT(0.5 -0.5)', 4326), 1.5)",
+      "ST_DWithin(ST_GeomFromText('POINT(-3 3)', 4326), $, 1)"};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto& filter : filters) {
+      const auto with = [&filter](const std::string& point) {
+        auto query = "SELECT COUNT(*) FROM geo_compressed_box_test WHERE " + filter + ";";
+        return query.replace(query.find('$'), 1, point);
+      };
+      const auto expected =
+          v<int64_t>(run_simple_agg(with(uncompressed), ExecutorDeviceType::CPU));
+      EXPECT_LT(int64_t(0), expected) << filter;
+      EXPECT_EQ(expected, v<int64_t>(run_simple_agg(with("gp"), dt))) << filter;
+    }
+  }
+}
+
 TEST(Select, GeoSpatial_Geos) {
   // SKIP_ALL_ON_AGGREGATOR();
 
@@ -18033,6 +19722,24 @@ TEST(Select, GeoSpatial_Geos) {
                     "FROM geospatial_test WHERE id = 3;",
                     dt)),
                 static_cast<double>(0.03));
+    // ST_Simplify drops the vertex 0.5 off the bottom edge with a tolerance of 1, not
+    // with 0.1
+    ASSERT_NEAR(static_cast<double>(100.0),
+                v<double>(run_simple_agg(
+                    "SELECT ST_Area(ST_Simplify('POLYGON((0 0, 5 0.5, 10 0, 10 10, 0 "
+                    "10, 0 0))', 1.0)) FROM geospatial_test WHERE id = 3;",
+                    dt)),
+                static_cast<double>(0.001));
+    ASSERT_NEAR(static_cast<double>(97.5),
+                v<double>(run_simple_agg(
+                    "SELECT ST_Area(ST_Simplify('POLYGON((0 0, 5 0.5, 10 0, 10 10, 0 "
+                    "10, 0 0))', 0.1)) FROM geospatial_test WHERE id = 3;",
+                    dt)),
+                static_cast<double>(0.001));
+    EXPECT_THROW(run_simple_agg("SELECT ST_Area(ST_Simplify('LINESTRING(0 0, 5 0.5, 10 "
+                                "0)', 1.0)) FROM geospatial_test WHERE id = 3;",
+                                dt),
+                 std::runtime_error);
     // ST_IsValid
     ASSERT_EQ(static_cast<int64_t>(1),
               v<int64_t>(run_simple_agg(
@@ -18778,6 +20485,121 @@ TEST(Select, DatesDaysEncodingTest) {
   }
 }
 
+TEST(Select, DiffEncoding) {
+  const std::string drop_diff_test{"DROP TABLE IF EXISTS diff_encoding_test;"};
+  run_ddl_statement(drop_diff_test);
+  g_sqlite_comparator.query(drop_diff_test);
+  run_ddl_statement(
+      "CREATE TABLE diff_encoding_test(id INT, x SMALLINT ENCODING DIFF(8), y INT "
+      "ENCODING DIFF(8), z BIGINT ENCODING DIFF(16), d DECIMAL(12, 2) ENCODING DIFF(16)) "
+      "WITH (fragment_size=4);");
+  g_sqlite_comparator.query(
+      "CREATE TABLE diff_encoding_test(id INT, x SMALLINT, y INT, z BIGINT, d "
+      "DECIMAL(12, 2));");
+  // values far apart do not fit the reference of a chunk and start a new fragment
+  const std::vector<std::string> rows{"1, 1000, 100000, 10000000000, 12.34",
+                                      "2, 1010, 100090, 10000020000, 12.35",
+                                      "3, NULL, NULL, NULL, NULL",
+                                      "4, 2000, 100100, 10000000001, 500.00",
+                                      "5, 1001, -100000, -10000000000, 12.34",
+                                      "6, -30000, 0, 0, -300.00",
+                                      "7, NULL, 5, 1, 0.01",
+                                      "8, 32000, 100000, 10000000000, 12.34"};
+  for (const auto& row : rows) {
+    const std::string insert_query{"INSERT INTO diff_encoding_test VALUES(" + row + ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT id, x, y, z, d FROM diff_encoding_test ORDER BY id;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE x = 1001;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE y > 100000 AND z < 10000020000;",
+      dt);
+    c("SELECT MIN(x), MAX(x), SUM(y), AVG(z), MAX(d) FROM diff_encoding_test;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE x IS NULL;", dt);
+    c("SELECT y, COUNT(*) AS n FROM diff_encoding_test GROUP BY y ORDER BY y;", dt);
+    c("SELECT a.id, b.id FROM diff_encoding_test a, diff_encoding_test b WHERE a.z = b.z "
+      "AND a.id < b.id ORDER BY a.id, b.id;",
+      dt);
+    c("SELECT id FROM diff_encoding_test WHERE x IN (SELECT x FROM diff_encoding_test "
+      "WHERE d = 12.34) ORDER BY id;",
+      dt);
+    // comparisons against a constant are evaluated on the offsets of the chunks
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE 1005 >= x;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE x <> 1010 AND d <= 12.34;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE z > -9223372036854775807;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE z < 9223372036854775807;", dt);
+    c("SELECT COUNT(*) FROM diff_encoding_test WHERE x > -32767 AND y < 2147483647;",
+      dt);
+  }
+
+  EXPECT_THROW(run_multiple_agg("UPDATE diff_encoding_test SET x = 1 WHERE id = 1;",
+                                ExecutorDeviceType::CPU),
+               std::runtime_error);
+  EXPECT_THROW(
+      run_ddl_statement("CREATE TABLE diff_encoding_bad(x TINYINT ENCODING DIFF(8));"),
+      std::runtime_error);
+  EXPECT_THROW(
+      run_ddl_statement("CREATE TABLE diff_encoding_bad(x INT ENCODING DIFF(32));"),
+      std::runtime_error);
+  EXPECT_THROW(
+      run_ddl_statement("CREATE TABLE diff_encoding_bad(x DATE ENCODING DIFF(16));"),
+      std::runtime_error);
+  EXPECT_THROW(
+      run_ddl_statement("CREATE TABLE diff_encoding_bad(x DOUBLE ENCODING DIFF(16));"),
+      std::runtime_error);
+  run_ddl_statement(drop_diff_test);
+  g_sqlite_comparator.query(drop_diff_test);
+}
+
+TEST(Select, SharedColumnarFetches) {
+  ScopeGuard reset_shared_fetches_state =
+      [orig_enable = g_enable_shared_columnar_fetches] {
+        g_enable_shared_columnar_fetches = orig_enable;
+      };
+  const std::string drop_shared_test{"DROP TABLE IF EXISTS shared_fetches_test;"};
+  run_ddl_statement(drop_shared_test);
+  g_sqlite_comparator.query(drop_shared_test);
+  run_ddl_statement(
+      "CREATE TABLE shared_fetches_test(id INT, z BIGINT ENCODING DIFF(16)) WITH "
+      "(fragment_size=4);");
+  g_sqlite_comparator.query("CREATE TABLE shared_fetches_test(id INT, z BIGINT);");
+  auto insert_row = [](const std::string& row) {
+    const std::string insert_query{"INSERT INTO shared_fetches_test VALUES(" + row +
+                                   ");"};
+    run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    g_sqlite_comparator.query(insert_query);
+  };
+  for (const auto& row : {"1, 10000000000", "2, 10000000001", "3, NULL", "4, 5"}) {
+    insert_row(row);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool enable_shared_fetches : {true, false}) {
+      g_enable_shared_columnar_fetches = enable_shared_fetches;
+      c("SELECT SUM(z), COUNT(*) FROM shared_fetches_test;", dt);
+      c("SELECT a.id, b.id FROM shared_fetches_test a, shared_fetches_test b WHERE "
+        "a.z = b.z ORDER BY a.id, b.id;",
+        dt);
+    }
+  }
+  // the appended rows change the row counts, so the decoded fragments aren't reused
+  insert_row("5, 10000000002");
+  insert_row("6, 5");
+  g_enable_shared_columnar_fetches = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT SUM(z), COUNT(*) FROM shared_fetches_test;", dt);
+    c("SELECT a.id, b.id FROM shared_fetches_test a, shared_fetches_test b WHERE a.z = "
+      "b.z ORDER BY a.id, b.id;",
+      dt);
+  }
+  run_ddl_statement(drop_shared_test);
+  g_sqlite_comparator.query(drop_shared_test);
+}
+
 TEST(Select, WindowFunctionRank) {
   const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
   std::string part1 =
@@ -18830,6 +20652,87 @@ TEST(Select, WindowFunctionCumeDist) {
   c(part1 + " NULLS FIRST" + part2, part1 + part2, dt);
 }
 
+TEST(Select, WindowFunctionLargePartitions) {
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  run_ddl_statement("DROP TABLE IF EXISTS window_large_test;");
+  run_ddl_statement("CREATE TABLE window_large_test (a INT, b INT);");
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS window_large_test;");
+  };
+  for (int i = 0; i < 10; ++i) {
+    run_multiple_agg("INSERT INTO window_large_test VALUES(" + std::to_string(i) + ", " +
+                         std::to_string(i % 2) + ");",
+                     dt);
+  }
+  // 327680 rows, enough for the partitions to be computed by several threads
+  for (int i = 0; i < 15; ++i) {
+    run_ddl_statement("INSERT INTO window_large_test SELECT * FROM window_large_test;");
+  }
+  // ten partitions of 32768 rows, computed in batches
+  EXPECT_EQ(int64_t(10) * 32768 * 32769 / 2,
+            v<int64_t>(run_simple_agg(
+                "SELECT SUM(r) FROM (SELECT ROW_NUMBER() OVER (PARTITION BY a ORDER BY "
+                "b) r FROM window_large_test);",
+                dt)));
+  // two partitions of 163840 rows, each sorted by all the threads
+  EXPECT_EQ(int64_t(4 * 32768 + 1),
+            v<int64_t>(run_simple_agg(
+                "SELECT MAX(r) FROM (SELECT RANK() OVER (PARTITION BY b ORDER BY a) r "
+                "FROM window_large_test);",
+                dt)));
+  EXPECT_EQ(int64_t(2 * 32768),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM (SELECT a, b, RANK() OVER (PARTITION BY b ORDER "
+                "BY a) r FROM window_large_test) WHERE r = a / 2 * 32768 + 1 AND a < 2;",
+                dt)));
+}
+
+TEST(Select, WindowFunctionGpuSort) {
+  const auto enable_window_function_gpu_sort = g_enable_window_function_gpu_sort;
+  ScopeGuard reset_flag = [enable_window_function_gpu_sort] {
+    g_enable_window_function_gpu_sort = enable_window_function_gpu_sort;
+  };
+  g_enable_window_function_gpu_sort = true;
+  run_ddl_statement("DROP TABLE IF EXISTS window_gpu_sort_test;");
+  run_ddl_statement(
+      "CREATE TABLE window_gpu_sort_test (a INT, b BIGINT, c DOUBLE, d DATE);");
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS window_gpu_sort_test;");
+  };
+  for (int i = 0; i < 10; ++i) {
+    const auto i_str = std::to_string(i);
+    run_multiple_agg("INSERT INTO window_gpu_sort_test VALUES(" +
+                         std::to_string(i % 3) + ", " +
+                         (i == 4 ? std::string("NULL") : std::to_string(5 - i)) + ", " +
+                         std::to_string(i * 0.5 - 2) + ", '2020-01-0" +
+                         std::to_string(i % 4 + 1) + "');",
+                     ExecutorDeviceType::CPU);
+  }
+  // 327680 rows, enough for the partitions to be sorted on the GPU
+  for (int i = 0; i < 15; ++i) {
+    run_ddl_statement(
+        "INSERT INTO window_gpu_sort_test SELECT * FROM window_gpu_sort_test;");
+  }
+  const std::vector<std::string> queries{
+      "SELECT SUM(r * b) FROM (SELECT b, ROW_NUMBER() OVER (PARTITION BY a ORDER BY b "
+      "DESC NULLS FIRST, c) r FROM window_gpu_sort_test);",
+      "SELECT SUM(r * a) FROM (SELECT a, RANK() OVER (PARTITION BY a ORDER BY c DESC, "
+      "d) r FROM window_gpu_sort_test);",
+      "SELECT SUM(r * a) FROM (SELECT a, DENSE_RANK() OVER (PARTITION BY a ORDER BY d, "
+      "b NULLS LAST) r FROM window_gpu_sort_test);",
+      "SELECT SUM(CAST(l * 2 AS BIGINT)) FROM (SELECT LAG(c) OVER (PARTITION BY a "
+      "ORDER BY c, b) l FROM window_gpu_sort_test);"};
+  for (const auto& query : queries) {
+    g_enable_window_function_gpu_sort = false;
+    const auto expected = v<int64_t>(run_simple_agg(query, ExecutorDeviceType::CPU));
+    g_enable_window_function_gpu_sort = true;
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      ASSERT_EQ(expected, v<int64_t>(run_simple_agg(query, dt)));
+    }
+  }
+}
+
 TEST(Select, WindowFunctionLag) {
   const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
   // First test default lag (1)
@@ -19181,6 +21084,40 @@ TEST(Select, WindowFunctionSum) {
   c(query + " NULLS FIRST;", query + ";", dt);
 }
 
+TEST(Select, WindowFunctionRowsFrame) {
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  for (const std::string col : {"x", "f"}) {
+    const std::string window = "OVER (PARTITION BY y ORDER BY t ASC ROWS BETWEEN ";
+    std::string query = "SELECT t, y, SUM(" + col + ") " + window +
+                        "2 PRECEDING AND CURRENT ROW) s, AVG(" + col + ") " + window +
+                        "1 PRECEDING AND 1 FOLLOWING) a, MIN(" + col + ") " + window +
+                        "CURRENT ROW AND 2 FOLLOWING) m1, MAX(" + col + ") " + window +
+                        "UNBOUNDED PRECEDING AND 1 PRECEDING) m2, COUNT(" + col + ") " +
+                        window +
+                        "1 FOLLOWING AND UNBOUNDED FOLLOWING) c, COUNT(*) " + window +
+                        "3 PRECEDING AND 1 PRECEDING) n FROM test_window_func ORDER BY "
+                        "t ASC;";
+    c(query, dt);
+  }
+  EXPECT_THROW(run_multiple_agg("SELECT SUM(x + 1) OVER (PARTITION BY y ORDER BY t ROWS "
+                                "BETWEEN 1 PRECEDING AND CURRENT ROW) FROM "
+                                "test_window_func;",
+                                dt),
+               std::runtime_error);
+}
+
+TEST(Select, WindowFunctionSharedSort) {
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  // the first four share the sort of the partitions, the last two the partitions only
+  const std::string window = "OVER (PARTITION BY y ORDER BY t ASC";
+  c("SELECT t, ROW_NUMBER() " + window + ") r, LAG(x) " + window + ") l1, LEAD(x, 2) " +
+        window + ") l2, SUM(x) " + window +
+        " ROWS BETWEEN 1 PRECEDING AND CURRENT ROW) s, ROW_NUMBER() OVER (PARTITION BY "
+        "y ORDER BY t DESC) r_desc, RANK() OVER (PARTITION BY y ORDER BY d ASC, t ASC) "
+        "r_d FROM test_window_func ORDER BY t ASC;",
+    dt);
+}
+
 TEST(Select, WindowFunctionComplexExpressions) {
   const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
   {
@@ -19599,6 +21536,37 @@ TEST(Select, UnionAll) {
       " WHERE a0 < 116"
       " ORDER BY max0;",
       dt);
+    {
+      ScopeGuard reset_parallel_union_branches =
+          [orig = g_enable_parallel_union_branches] {
+            g_enable_parallel_union_branches = orig;
+          };
+      g_enable_parallel_union_branches = true;
+      c("SELECT a0, a1, a2, a3 FROM union_all_a"
+        " WHERE a0 < 116"
+        " UNION ALL"
+        " SELECT b0, b1, b2, b3 FROM union_all_b"
+        " WHERE b0 < 215"
+        " ORDER BY a0;",
+        dt);
+      c("SELECT MAX(a0) max0, a1 % 3, MAX(a2), MAX(a3) FROM union_all_a"
+        " GROUP BY a1 % 3"
+        " UNION ALL"
+        " SELECT MAX(b0), b1 % 2, MAX(b2), MAX(b3) FROM union_all_b"
+        " GROUP BY b1 % 2"
+        " UNION ALL"
+        " SELECT a0, a1, a2, a3 FROM union_all_a"
+        " WHERE a0 < 116"
+        " ORDER BY max0;",
+        dt);
+      c("SELECT * FROM ("
+        " SELECT a0, a1, a2, a3 FROM union_all_a"
+        " UNION ALL"
+        " SELECT b0, b1, b2, b3 FROM union_all_b"
+        ") GROUP BY a0, a1, a2, a3"
+        " ORDER BY a0, a1, a2, a3;",
+        dt);
+    }
     c("SELECT MAX(a0) max0, a1 % 2, MAX(a2), MAX(a3) FROM union_all_a"
       " GROUP BY a1 % 2"
       " UNION ALL"
@@ -19798,10 +21766,9 @@ TEST(TemporaryTables, Unsupported) {
                         "DICTIONARY(str) REFERENCES test(null_str));"));
 }
 
-TEST(Select, Interop) {
-  SKIP_ALL_ON_AGGREGATOR();
-  g_enable_interop = true;
-  ScopeGuard interop_guard = [] { g_enable_interop = false; };
+namespace {
+
+void check_interop_queries() {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
     c("SELECT 'dict_' || str c1, 'fake_' || substring(real_str, 6) c2, x + 56 c3, f c4, "
@@ -19837,9 +21804,29 @@ TEST(Select, Interop) {
       "SELECT ('fake_' || SUBSTR(real_str, 6)) LIKE '%_ba%' b from test ORDER BY b;",
       dt);
   }
+}
+
+}  // namespace
+
+TEST(Select, Interop) {
+  SKIP_ALL_ON_AGGREGATOR();
+  g_enable_interop = true;
+  ScopeGuard interop_guard = [] { g_enable_interop = false; };
+  check_interop_queries();
   g_enable_interop = false;
 }
 
+TEST(Select, InteropThroughSqlite) {
+  SKIP_ALL_ON_AGGREGATOR();
+  g_enable_interop = true;
+  g_enable_interpreted_interop = false;
+  ScopeGuard interop_guard = [] {
+    g_enable_interop = false;
+    g_enable_interpreted_interop = true;
+  };
+  check_interop_queries();
+}
+
 // Test https://github.com/omnisci/omniscidb/issues/463
 TEST(Select, LeftJoinDictionaryGenerationIssue463) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
@@ -20037,6 +22024,66 @@ TEST(Select, SampleRatio) {
   }
 }
 
+TEST(Select, TableSample) {
+  run_ddl_statement("DROP TABLE IF EXISTS table_sample_test;");
+  run_ddl_statement(
+      "CREATE TABLE table_sample_test (x INT, y BIGINT) WITH (fragment_size=2);");
+  ScopeGuard drop_table = [] {
+    run_ddl_statement("DROP TABLE IF EXISTS table_sample_test;");
+  };
+  for (int i = 0; i < 20; ++i) {
+    run_multiple_agg("INSERT INTO table_sample_test VALUES(" + std::to_string(i) + ", " +
+                         std::to_string(i % 3) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // all the rows, nothing to rescale
+    EXPECT_EQ(v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM test;", dt)),
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM test TABLESAMPLE BERNOULLI(100);", dt)));
+    EXPECT_EQ(v<int64_t>(run_simple_agg("SELECT SUM(x) FROM test;", dt)),
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(x) FROM test TABLESAMPLE SYSTEM(100);", dt)));
+
+    // BERNOULLI keeps the rows SAMPLE_RATIO does, the additive aggregates are rescaled
+    EXPECT_EQ(
+        2 * v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM test WHERE SAMPLE_RATIO(0.5);", dt)),
+        v<int64_t>(run_simple_agg(
+            "SELECT COUNT(*) FROM test TABLESAMPLE BERNOULLI(50);", dt)));
+    EXPECT_EQ(
+        2 * v<int64_t>(run_simple_agg(
+                "SELECT SUM(x) FROM test WHERE SAMPLE_RATIO(0.5);", dt)),
+        v<int64_t>(run_simple_agg(
+            "SELECT SUM(x) FROM test TABLESAMPLE BERNOULLI(50);", dt)));
+    EXPECT_EQ(
+        v<int64_t>(run_simple_agg(
+            "SELECT MAX(x) FROM test WHERE SAMPLE_RATIO(0.5);", dt)),
+        v<int64_t>(run_simple_agg(
+            "SELECT MAX(x) FROM test TABLESAMPLE BERNOULLI(50);", dt)));
+
+    // SYSTEM keeps whole fragments of two rows, the same ones every time
+    const auto system_count = v<int64_t>(run_simple_agg(
+        "SELECT COUNT(*) FROM table_sample_test TABLESAMPLE SYSTEM(50) REPEATABLE(7);",
+        dt));
+    EXPECT_EQ(int64_t(0), system_count % 4);
+    EXPECT_LE(system_count, int64_t(40));
+    EXPECT_EQ(system_count,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM table_sample_test "
+                                        "TABLESAMPLE SYSTEM(50) REPEATABLE(7);",
+                                        dt)));
+    EXPECT_NO_THROW(run_multiple_agg(
+        "SELECT y, COUNT(*), SUM(x), AVG(x) FROM table_sample_test TABLESAMPLE "
+        "SYSTEM(50) GROUP BY y ORDER BY y;",
+        dt));
+    EXPECT_THROW(run_multiple_agg("SELECT COUNT(*) FROM test a JOIN table_sample_test "
+                                  "TABLESAMPLE SYSTEM(50) b ON a.x = b.x;",
+                                  dt),
+                 std::exception);
+  }
+}
+
 namespace {
 
 int create_sharded_join_table(const std::string& table_name,
@@ -21565,6 +23612,11 @@ int main(int argc, char** argv) {
                          ->default_value(g_use_tbb_pool)
                          ->implicit_value(true),
                      "Use TBB thread pool implementation for query dispatch.");
+  desc.add_options()("use-work-stealing-pool",
+                     po::value<bool>(&g_use_work_stealing_pool)
+                         ->default_value(g_use_work_stealing_pool)
+                         ->implicit_value(true),
+                     "Use the work stealing thread pool for query dispatch.");
 
   desc.add_options()(
       "test-help",
@@ -20,11 +20,18 @@
  */
 
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
 #include "DBHandlerTestHelpers.h"
+#include "DataMgr/FileMgr/ColdStorage.h"
 #include "DataMgr/FileMgr/FileMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
+#include "Shared/File.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
+extern bool g_enable_chunk_index_snapshot;
+extern bool g_enable_direct_io_reads;
+
 class FileMgrTest : public DBHandlerTestFixture {
  protected:
   std::string table_name;
@@ -140,6 +147,352 @@ TEST_F(FileMgrTest, putBuffer_append) {
   compareBuffersAndMetadata(source_buffer, file_buffer, 8);
 }
 
+TEST_F(FileMgrTest, checkpoint_visitsDirtyChunks) {
+  AbstractBuffer* source_buffer =
+      dm->getChunkBuffer(chunk_key, Data_Namespace::MemoryLevel::CPU_LEVEL);
+  int8_t temp_array[4] = {1, 2, 3, 4};
+  source_buffer->append(temp_array, 4);
+  auto file_mgr =
+      File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, 0, gfm->getDefaultPageSize());
+  ASSERT_EQ(file_mgr.getNumDirtyChunks(), size_t(0));
+  AbstractBuffer* file_buffer = file_mgr.putBuffer(chunk_key, source_buffer, 8);
+  ASSERT_EQ(file_mgr.getNumDirtyChunks(), size_t(1));
+  ASSERT_TRUE(file_buffer->isDirty());
+  file_mgr.checkpoint();
+  ASSERT_EQ(file_mgr.getNumDirtyChunks(), size_t(0));
+  ASSERT_FALSE(file_buffer->isDirty());
+}
+
+TEST_F(FileMgrTest, checkpoint_chunkIndexSnapshot) {
+  g_enable_chunk_index_snapshot = true;
+  ScopeGuard reset_snapshot_flag = [] { g_enable_chunk_index_snapshot = false; };
+  AbstractBuffer* source_buffer =
+      dm->getChunkBuffer(chunk_key, Data_Namespace::MemoryLevel::CPU_LEVEL);
+  int8_t temp_array[4] = {1, 2, 3, 4};
+  source_buffer->append(temp_array, 4);
+  {
+    auto file_mgr =
+        File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, gfm->getDefaultPageSize());
+    file_mgr.putBuffer(chunk_key, source_buffer, 8);
+    file_mgr.checkpoint();
+    ASSERT_TRUE(file_mgr.hasValidChunkIndexSnapshot());
+  }
+  auto file_mgr =
+      File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, gfm->getDefaultPageSize());
+  ASSERT_TRUE(file_mgr.hasValidChunkIndexSnapshot());
+  compareBuffersAndMetadata(source_buffer, file_mgr.getBuffer(chunk_key), 8);
+
+  // rewriting the chunk allocates new page versions, which makes the snapshot stale
+  source_buffer->setUpdated();
+  file_mgr.putBuffer(chunk_key, source_buffer, 8);
+  ASSERT_FALSE(file_mgr.hasValidChunkIndexSnapshot());
+}
+
+TEST_F(FileMgrTest, read_directIo) {
+  g_enable_direct_io_reads = true;
+  ScopeGuard reset_direct_io_flag = [] { g_enable_direct_io_reads = false; };
+  AbstractBuffer* source_buffer =
+      dm->getChunkBuffer(chunk_key, Data_Namespace::MemoryLevel::CPU_LEVEL);
+  int8_t temp_array[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  source_buffer->append(temp_array, 8);
+  auto file_mgr =
+      File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, 0, gfm->getDefaultPageSize());
+  AbstractBuffer* file_buffer = file_mgr.putBuffer(chunk_key, source_buffer, 12);
+  compareBuffersAndMetadata(source_buffer, file_buffer, 12);
+}
+
+TEST_F(FileMgrTest, getMappedChunkData) {
+  AbstractBuffer* source_buffer =
+      dm->getChunkBuffer(chunk_key, Data_Namespace::MemoryLevel::CPU_LEVEL);
+  int8_t temp_array[4] = {1, 2, 3, 4};
+  source_buffer->append(temp_array, 4);
+  auto file_mgr =
+      File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, gfm->getDefaultPageSize());
+  file_mgr.putBuffer(chunk_key, source_buffer, 8);
+  // unflushed changes are not visible through the mapping
+  ASSERT_EQ(file_mgr.getMappedChunkData(chunk_key, 8), nullptr);
+  file_mgr.checkpoint();
+  const auto mapped_data = file_mgr.getMappedChunkData(chunk_key, 8);
+  ASSERT_NE(mapped_data, nullptr);
+  ASSERT_EQ(std::memcmp(mapped_data, source_buffer->getMemoryPtr(), 8), 0);
+  ASSERT_EQ(file_mgr.getMappedChunkData(chunk_key, gfm->getDefaultPageSize()), nullptr);
+}
+
+TEST_F(FileMgrTest, append_extentAllocation) {
+  constexpr size_t page_size{8192};
+  constexpr size_t pages_per_extent{4};
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+  file_mgr.setExtentSize(pages_per_extent * page_size);
+  ASSERT_EQ(file_mgr.getNumPagesPerExtent(page_size), pages_per_extent);
+
+  ChunkKey extent_chunk_key = chunk_key;
+  extent_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 1;
+  auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+      file_mgr.createBuffer(extent_chunk_key, page_size));
+  ASSERT_NE(file_buffer, nullptr);
+  std::vector<int8_t> data(3 * file_buffer->pageDataSize());
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int8_t>(i);
+  }
+  // appending one page at a time still places the pages side by side
+  const auto page_data_size = file_buffer->pageDataSize();
+  for (size_t offset = 0; offset < data.size(); offset += page_data_size) {
+    file_buffer->append(data.data() + offset, page_data_size);
+  }
+  const auto multi_pages = file_buffer->getMultiPage();
+  ASSERT_EQ(multi_pages.size(), size_t(3));
+  const auto first_page = multi_pages[0].current();
+  for (size_t i = 1; i < multi_pages.size(); ++i) {
+    ASSERT_EQ(multi_pages[i].current().fileId, first_page.fileId);
+    ASSERT_EQ(multi_pages[i].current().pageNum, first_page.pageNum + i);
+  }
+
+  std::vector<int8_t> read_back(data.size());
+  file_buffer->read(read_back.data(), read_back.size());
+  ASSERT_EQ(read_back, data);
+  file_mgr.deleteBuffer(extent_chunk_key);
+}
+
+TEST_F(FileMgrTest, compactDataFiles) {
+  constexpr size_t page_size{8192};
+  ChunkKey dropped_chunk_key = chunk_key;
+  dropped_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 1;
+  ChunkKey kept_chunk_key = chunk_key;
+  kept_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 2;
+  std::vector<int8_t> kept_data;
+  {
+    auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+    // 200 + 100 pages spill into a second data file of MAX_FILE_N_PAGES pages
+    auto dropped_buffer = file_mgr.createBuffer(dropped_chunk_key, page_size);
+    const auto page_data_size =
+        dynamic_cast<File_Namespace::FileBuffer*>(dropped_buffer)->pageDataSize();
+    std::vector<int8_t> dropped_data(200 * page_data_size, 1);
+    dropped_buffer->append(dropped_data.data(), dropped_data.size());
+    auto kept_buffer = file_mgr.createBuffer(kept_chunk_key, page_size);
+    kept_data.resize(100 * page_data_size);
+    for (size_t i = 0; i < kept_data.size(); ++i) {
+      kept_data[i] = static_cast<int8_t>(i);
+    }
+    kept_buffer->append(kept_data.data(), kept_data.size());
+    file_mgr.checkpoint();
+
+    // freed pages can only be reused once the delete is checkpointed
+    file_mgr.deleteBuffer(dropped_chunk_key);
+    ASSERT_EQ(file_mgr.compactDataFiles(0.3), size_t(0));
+    file_mgr.checkpoint();
+    ASSERT_EQ(file_mgr.compactDataFiles(0.3), MAX_FILE_N_PAGES * page_size);
+    ASSERT_EQ(file_mgr.compactDataFiles(0.3), size_t(0));
+
+    std::vector<int8_t> read_back(kept_data.size());
+    file_mgr.getBuffer(kept_chunk_key)->read(read_back.data(), read_back.size());
+    ASSERT_EQ(read_back, kept_data);
+  }
+  // the moved pages are found again when the data files are reopened
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+  std::vector<int8_t> read_back(kept_data.size());
+  file_mgr.getBuffer(kept_chunk_key)->read(read_back.data(), read_back.size());
+  ASSERT_EQ(read_back, kept_data);
+  file_mgr.deleteBuffer(kept_chunk_key);
+}
+
+TEST_F(FileMgrTest, spillColdChunks) {
+  constexpr size_t page_size{8192};
+  const auto cold_storage_path =
+      boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  gfm->setColdStorage(
+      std::make_unique<File_Namespace::LocalColdStorage>(cold_storage_path.string()));
+  ScopeGuard reset_cold_storage = [this, &cold_storage_path] {
+    gfm->setColdStorage(nullptr);
+    boost::filesystem::remove_all(cold_storage_path);
+  };
+
+  ChunkKey cold_chunk_key = chunk_key;
+  cold_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 1;
+  std::vector<int8_t> data;
+  {
+    auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+    auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+        file_mgr.createBuffer(cold_chunk_key, page_size));
+    data.resize(3 * file_buffer->pageDataSize());
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<int8_t>(i);
+    }
+    file_buffer->append(data.data(), data.size());
+    ASSERT_EQ(file_mgr.spillColdChunks(0), size_t(0));  // not checkpointed yet
+    file_mgr.checkpoint();
+    ASSERT_EQ(file_mgr.spillColdChunks(file_mgr.epoch()), size_t(0));  // too recent
+    // the chunk inserted by SetUp() is just as cold
+    const auto inserted_chunk_size = file_mgr.getBuffer(chunk_key)->size();
+    ASSERT_EQ(file_mgr.spillColdChunks(1), data.size() + inserted_chunk_size);
+    ASSERT_TRUE(file_buffer->isCold());
+    ASSERT_EQ(file_buffer->pageCount(), size_t(0));
+    ASSERT_EQ(file_buffer->size(), data.size());
+    file_mgr.checkpoint();
+
+    std::vector<int8_t> read_back(data.size());
+    file_buffer->read(read_back.data(), read_back.size());
+    ASSERT_EQ(read_back, data);
+  }
+  // only the metadata page is left locally, the data is read from cold storage
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+  auto file_buffer =
+      dynamic_cast<File_Namespace::FileBuffer*>(file_mgr.getBuffer(cold_chunk_key));
+  ASSERT_TRUE(file_buffer->isCold());
+  ASSERT_EQ(file_buffer->size(), data.size());
+  const size_t offset = file_buffer->pageDataSize() + 10;
+  std::vector<int8_t> read_back(100);
+  file_buffer->read(read_back.data(), read_back.size(), offset);
+  ASSERT_TRUE(std::equal(read_back.begin(), read_back.end(), data.begin() + offset));
+
+  // writes bring the data back into local pages first
+  std::vector<int8_t> appended_data(100, 42);
+  file_buffer->append(appended_data.data(), appended_data.size());
+  ASSERT_FALSE(file_buffer->isCold());
+  data.insert(data.end(), appended_data.begin(), appended_data.end());
+  read_back.resize(data.size());
+  file_buffer->read(read_back.data(), read_back.size());
+  ASSERT_EQ(read_back, data);
+  file_mgr.deleteBuffer(cold_chunk_key);
+}
+
+TEST_F(FileMgrTest, compressChunks) {
+  constexpr size_t page_size{8192};
+  ChunkKey compressed_chunk_key = chunk_key;
+  compressed_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 1;
+  std::vector<int8_t> data;
+  {
+    auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+    auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+        file_mgr.createBuffer(compressed_chunk_key, page_size));
+    data.resize(4 * file_buffer->pageDataSize());
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<int8_t>(i % 16);
+    }
+    file_buffer->append(data.data(), data.size());
+    ASSERT_EQ(file_mgr.compressChunks(0), size_t(0));  // not checkpointed yet
+    file_mgr.checkpoint();
+    ASSERT_EQ(file_mgr.compressChunks(file_mgr.epoch()), size_t(0));  // too recent
+    ASSERT_EQ(file_mgr.compressChunks(1), 3 * page_size);
+    ASSERT_TRUE(file_buffer->isCompressed());
+    ASSERT_EQ(file_buffer->pageCount(), size_t(1));
+    ASSERT_EQ(file_buffer->size(), data.size());
+    file_mgr.checkpoint();
+
+    std::vector<int8_t> read_back(data.size());
+    file_buffer->read(read_back.data(), read_back.size());
+    ASSERT_EQ(read_back, data);
+  }
+  // the compressed size is part of the chunk metadata
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+  auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+      file_mgr.getBuffer(compressed_chunk_key));
+  ASSERT_TRUE(file_buffer->isCompressed());
+  ASSERT_EQ(file_buffer->size(), data.size());
+  const size_t offset = file_buffer->pageDataSize() + 10;
+  std::vector<int8_t> read_back(100);
+  file_buffer->read(read_back.data(), read_back.size(), offset);
+  ASSERT_TRUE(std::equal(read_back.begin(), read_back.end(), data.begin() + offset));
+
+  // writes decompress the pages first
+  std::vector<int8_t> appended_data(100, 42);
+  file_buffer->append(appended_data.data(), appended_data.size());
+  ASSERT_FALSE(file_buffer->isCompressed());
+  ASSERT_EQ(file_buffer->pageCount(), size_t(5));
+  data.insert(data.end(), appended_data.begin(), appended_data.end());
+  read_back.resize(data.size());
+  file_buffer->read(read_back.data(), read_back.size());
+  ASSERT_EQ(read_back, data);
+  file_mgr.deleteBuffer(compressed_chunk_key);
+}
+
+TEST_F(FileMgrTest, compressVarLenIndexChunks) {
+  constexpr size_t page_size{8192};
+  ChunkKey index_chunk_key = chunk_key;
+  index_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 2;
+  index_chunk_key.push_back(2);
+  // the offsets of short strings, and a null array as its negated offset
+  std::vector<StringOffsetT> offsets{0};
+  for (size_t i = 1; i < 8 * page_size / sizeof(StringOffsetT); ++i) {
+    offsets.push_back(offsets.back() + static_cast<StringOffsetT>(i % 7));
+  }
+  offsets[100] = -offsets[100];
+  const size_t num_bytes = offsets.size() * sizeof(StringOffsetT);
+  {
+    auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+    auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+        file_mgr.createBuffer(index_chunk_key, page_size));
+    file_buffer->append(reinterpret_cast<int8_t*>(offsets.data()), num_bytes);
+    file_mgr.checkpoint();
+    ASSERT_GT(file_mgr.compressChunks(1), size_t(0));
+    ASSERT_TRUE(file_buffer->isCompressed());
+    ASSERT_EQ(file_buffer->pageCount(), size_t(1));
+    file_mgr.checkpoint();
+  }
+  // the offsets are restored from their deltas, including the ones before a range
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+  auto file_buffer =
+      dynamic_cast<File_Namespace::FileBuffer*>(file_mgr.getBuffer(index_chunk_key));
+  ASSERT_TRUE(file_buffer->isCompressed());
+  ASSERT_EQ(file_buffer->size(), num_bytes);
+  std::vector<StringOffsetT> read_back(offsets.size());
+  file_buffer->read(reinterpret_cast<int8_t*>(read_back.data()), num_bytes);
+  ASSERT_EQ(read_back, offsets);
+  const size_t first_offset = 1000;
+  read_back.resize(10);
+  file_buffer->read(reinterpret_cast<int8_t*>(read_back.data()),
+                    read_back.size() * sizeof(StringOffsetT),
+                    first_offset * sizeof(StringOffsetT));
+  ASSERT_TRUE(
+      std::equal(read_back.begin(), read_back.end(), offsets.begin() + first_offset));
+  file_mgr.deleteBuffer(index_chunk_key);
+}
+
+TEST_F(FileMgrTest, pageChecksums) {
+  constexpr size_t page_size{8192};
+  ChunkKey checked_chunk_key = chunk_key;
+  checked_chunk_key[CHUNK_KEY_FRAGMENT_IDX] = 1;
+  std::vector<int8_t> data;
+  {
+    auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+    auto file_buffer = dynamic_cast<File_Namespace::FileBuffer*>(
+        file_mgr.createBuffer(checked_chunk_key, page_size));
+    data.resize(file_buffer->pageDataSize() * 5 / 2);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<int8_t>(i);
+    }
+    file_buffer->append(data.data(), data.size());
+    file_mgr.checkpoint();
+    // continues the checksum of the half written last page
+    std::vector<int8_t> appended_data(file_buffer->pageDataSize(), 42);
+    file_buffer->append(appended_data.data(), appended_data.size());
+    data.insert(data.end(), appended_data.begin(), appended_data.end());
+    file_mgr.checkpoint();
+    ASSERT_GT(file_mgr.getIoStats().numSyncs, size_t(0));
+  }
+  // checksums are read back from disk along with the data files
+  auto file_mgr = File_Namespace::FileMgr(0, gfm, file_mgr_key, 0, -1, page_size);
+  auto file_buffer = file_mgr.getBuffer(checked_chunk_key);
+  std::vector<int8_t> read_back(data.size());
+  file_buffer->read(read_back.data(), read_back.size());
+  ASSERT_EQ(read_back, data);
+  auto stats = file_mgr.getIoStats();
+  ASSERT_GE(stats.bytesRead, data.size());
+  ASSERT_GE(stats.pagesRead, size_t(4));
+  ASSERT_EQ(stats.checksumFailures, size_t(0));
+
+  // flip a byte of the second page behind the FileInfo's back
+  const auto page =
+      dynamic_cast<File_Namespace::FileBuffer*>(file_buffer)->getMultiPage()[1].current();
+  auto file_info = file_mgr.getFileInfoForFileId(page.fileId);
+  int8_t corrupt_byte = ~data[file_buffer->pageDataSize() * 2 - 1];
+  File_Namespace::write(
+      file_info->f, (page.pageNum + 1) * page_size - 1, 1, &corrupt_byte);
+  EXPECT_THROW(file_buffer->read(read_back.data(), read_back.size()),
+               std::runtime_error);
+  ASSERT_EQ(file_mgr.getIoStats().checksumFailures, size_t(1));
+  file_mgr.deleteBuffer(checked_chunk_key);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
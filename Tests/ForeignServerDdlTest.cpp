@@ -128,7 +128,7 @@ TEST_F(CreateForeignServerTest, InvalidOption) {
       "(invalid_key = 'value', storage_type = 'LOCAL_FILE', base_path = '/test_path/');"};
   std::string error_message{
       "Exception: Invalid option \"INVALID_KEY\". "
-      "Option must be one of the following: STORAGE_TYPE, BASE_PATH."};
+      "Option must be one of the following: STORAGE_TYPE, BASE_PATH, CACHE_WARM_UP."};
   queryAndAssertException(query, error_message);
 }
 
@@ -1075,7 +1075,7 @@ TEST_F(AlterForeignServerTest, InvalidOption) {
   std::string query{"ALTER SERVER test_server WITH (invalid_key = 'value');"};
   std::string error_message{
       "Exception: Invalid option \"INVALID_KEY\". "
-      "Option must be one of the following: STORAGE_TYPE, BASE_PATH."};
+      "Option must be one of the following: STORAGE_TYPE, BASE_PATH, CACHE_WARM_UP."};
   queryAndAssertException(query, error_message);
   assertExpectedForeignServer(
       createExpectedForeignServer("test_server", "omnisci_csv", DEFAULT_OPTIONS));
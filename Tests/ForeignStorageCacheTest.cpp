@@ -116,6 +116,15 @@ class ForeignStorageCacheUnitTest : public testing::Test {
     ~CacheLimitScope() { cache_->setLimit(old_limit); }
   };
 
+  struct CacheSizeLimitScope {
+    size_t old_size_limit;
+    CacheSizeLimitScope(const size_t size_limit) {
+      old_size_limit = cache_->getSizeLimit();
+      cache_->setSizeLimit(size_limit);
+    }
+    ~CacheSizeLimitScope() { cache_->setSizeLimit(old_size_limit); }
+  };
+
   std::shared_ptr<ChunkMetadata> createMetadata(const size_t num_bytes,
                                                 const size_t num_elements,
                                                 const int32_t in_min,
@@ -144,6 +153,8 @@ class ForeignStorageCacheUnitTest : public testing::Test {
                                 GlobalFileMgr*& gfm,
                                 const std::string cache_path = cache_path_,
                                 const size_t cel = cache_entry_limit) {
+    // The previous cache saves its access counts when destroyed.
+    cache.reset();
     cache = std::make_unique<ForeignStorageCache>(cache_path_, 0, cel);
     gfm = cache->getGlobalFileMgr();
   }
@@ -350,6 +361,56 @@ TEST_F(ForeignStorageCacheUnitTest, SetLimit) {
   ASSERT_EQ(cache_->getNumCachedChunks(), new_limit);
 }
 
+TEST_F(ForeignStorageCacheUnitTest, SetSizeLimit) {
+  ChunkWrapper<int32_t> chunk_wrapper1{kINT, {1, 2, 3, 4}};
+  ChunkWrapper<int32_t> chunk_wrapper2{kINT, {5, 6}};
+  chunk_wrapper1.cacheMetadataThenChunk(chunk_key1);
+  chunk_wrapper2.cacheMetadataThenChunk(chunk_key2);
+  ASSERT_EQ(cache_->getNumCachedChunks(), 2U);
+  ASSERT_EQ(cache_->getNumCachedBytes(), 24U);
+  CacheSizeLimitScope scope{20};
+  ASSERT_EQ(cache_->getNumCachedChunks(), 1U);
+  ASSERT_EQ(cache_->getNumCachedBytes(), 8U);
+  ASSERT_NE(cache_->getCachedChunkIfExists(chunk_key2), nullptr);
+}
+
+TEST_F(ForeignStorageCacheUnitTest, CacheChunk_LargerThanSizeLimit) {
+  CacheSizeLimitScope scope{8};
+  ChunkWrapper<int32_t> chunk_wrapper{kINT, {1, 2, 3, 4}};
+  chunk_wrapper.cacheMetadataThenChunk(chunk_key1);
+  ASSERT_EQ(cache_->getNumCachedChunks(), 0U);
+  ASSERT_EQ(cache_->getNumCachedMetadata(), 1U);
+  ASSERT_EQ(cache_->getCachedChunkIfExists(chunk_key1), nullptr);
+}
+
+TEST_F(ForeignStorageCacheUnitTest, CacheChunk_AdmissionFilter) {
+  // A new cache, so that the accesses of the other tests are not counted.
+  reinitializeCache(cache_, gfm_);
+  CacheLimitScope scope{1};
+  ChunkWrapper<int32_t> chunk_wrapper1{kINT, {1}};
+  ChunkWrapper<int32_t> chunk_wrapper2{kINT, {2}};
+  chunk_wrapper1.cacheMetadataThenChunk(chunk_key1);
+  ASSERT_NE(cache_->getCachedChunkIfExists(chunk_key1), nullptr);
+  ASSERT_NE(cache_->getCachedChunkIfExists(chunk_key1), nullptr);
+
+  // Accessed less often than the chunk it would evict.
+  ASSERT_EQ(cache_->getCachedChunkIfExists(chunk_key2), nullptr);
+  chunk_wrapper2.cacheMetadataThenChunk(chunk_key2);
+  ASSERT_EQ(cache_->getNumCachedChunks(), 1U);
+  ASSERT_EQ(cache_->getStats().num_rejections, 1U);
+  ASSERT_EQ(cache_->getCachedChunkIfExists(chunk_key2), nullptr);
+
+  // Now accessed as often.
+  chunk_wrapper2.cacheChunk(chunk_key2);
+  ASSERT_EQ(cache_->getNumCachedChunks(), 1U);
+  ASSERT_NE(cache_->getCachedChunkIfExists(chunk_key2), nullptr);
+
+  const auto stats = cache_->getStats();
+  ASSERT_EQ(stats.num_hits, 3U);
+  ASSERT_EQ(stats.num_misses, 2U);
+  ASSERT_EQ(stats.num_evictions, 1U);
+}
+
 class CacheDiskStorageTest : public ForeignStorageCacheUnitTest {
  protected:
   static void SetUpTestSuite() {
@@ -435,6 +496,31 @@ TEST_F(CacheDiskStorageTest, RecoverCache_SingleChunkAfterEvict) {
   ASSERT_TRUE(chunk_wrapper2.test_buf->compare(cached_buf, 8));
 }
 
+TEST_F(CacheDiskStorageTest, RecoverCache_AccessCountsForWarmUp) {
+  ChunkWrapper<int32_t> chunk_wrapper1{kINT, {1, 2, 3, 4}};
+  chunk_wrapper1.cacheMetadata(chunk_key1);
+  ChunkWrapper<int32_t> chunk_wrapper2{kINT, {5, 6}};
+  chunk_wrapper2.cacheMetadata(chunk_key2);
+  ChunkWrapper<int32_t> chunk_wrapper3{kINT, {7, 8}};
+  chunk_wrapper3.cacheMetadataThenChunk(chunk_key3);
+  cache_->getCachedChunkIfExists(chunk_key1);
+  cache_->getCachedChunkIfExists(chunk_key2);
+  cache_->getCachedChunkIfExists(chunk_key2);
+  cache_->getCachedChunkIfExists(chunk_key3);
+  reinitializeCache(cache_, gfm_);
+  ChunkMetadataVector metadata_vec_cached{};
+  cache_->recoverCacheForTable(metadata_vec_cached, table_prefix1);
+  // Cached chunks need no warm-up.
+  ASSERT_EQ(cache_->getChunksToWarmUp(table_prefix1),
+            (std::vector<ChunkKey>{chunk_key2, chunk_key1}));
+  {
+    CacheLimitScope scope{2};
+    ASSERT_EQ(cache_->getChunksToWarmUp(table_prefix1),
+              (std::vector<ChunkKey>{chunk_key2}));
+  }
+  ASSERT_TRUE(cache_->getChunksToWarmUp(table_prefix2).empty());
+}
+
 class ForeignStorageCacheLRUTest : public testing::Test {};
 TEST_F(ForeignStorageCacheLRUTest, Basic) {
   LRUEvictionAlgorithm lru_alg{};
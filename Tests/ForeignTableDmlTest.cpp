@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
+#include <fstream>
 
 #include "Archive/S3Archive.h"
 #include "DBHandlerTestHelpers.h"
@@ -526,6 +527,27 @@ TEST_F(SelectQueryTest, ParquetNumericAndBooleanTypes) {
   // clang-format on
 }
 
+TEST_F(SelectQueryTest, ParquetIntegerEqualityFilters) {
+  const auto& query = getCreateForeignTableQuery(
+      "( bool BOOLEAN, i8 TINYINT, u8 SMALLINT, i16 SMALLINT, "
+      "u16 INT, i32 INT, u32 BIGINT, i64 BIGINT, f32 FLOAT, "
+      "f64 DOUBLE, fixedpoint DECIMAL(10,5) )",
+      "numeric_and_boolean_types",
+      "parquet");
+  sql(query);
+
+  // the fragments may be skipped on the Bloom filters of the dictionary pages
+  TQueryResult result;
+  sql(result,
+      "SELECT count(*) FROM test_foreign_table WHERE i32 = 2147483647 AND u32 = "
+      "4294967295 AND u8 = 255;");
+  assertResultSetEqual({{i(1)}}, result);
+  sql(result, "SELECT count(*) FROM test_foreign_table WHERE i64 = 5;");
+  assertResultSetEqual({{i(0)}}, result);
+  sql(result, "SELECT count(*) FROM test_foreign_table WHERE i16 IN (-32767, 23000);");
+  assertResultSetEqual({{i(2)}}, result);
+}
+
 TEST_F(SelectQueryTest, ParquetFixedEncodedTypes) {
   const auto& query = getCreateForeignTableQuery(
       "( i8 BIGINT ENCODING FIXED(8), u8 BIGINT ENCODING FIXED(16),"
@@ -1745,6 +1767,30 @@ TEST_P(CsvAppendTest, AppendNothing) {
   sqlAndCompareResult(select, {{i(1)}, {i(2)}});
 }
 
+TEST_F(CsvAppendTest, AppendKeepsCachedFragments) {
+  auto cache = getCatalog().getDataMgr().getForeignStorageMgr()->getForeignStorageCache();
+  ASSERT_NE(cache, nullptr);
+  const std::string dir_path = getDataFilesPath() + "append_tmp";
+  const std::string file_path = dir_path + "/single_file.csv";
+  bf::remove_all(dir_path);
+  bf::create_directory(dir_path);
+  std::ofstream(file_path) << "i\n1\n2\n";
+
+  sql("CREATE FOREIGN TABLE " + default_name + " (i INTEGER) "s +
+      "SERVER omnisci_local_csv WITH (file_path = '" + file_path +
+      "', fragment_size = '1', UPDATE_MODE = 'APPEND');");
+  std::string select = "SELECT * FROM "s + default_name + " ORDER BY i;";
+  sqlAndCompareResult(select, {{i(1)}, {i(2)}});
+
+  // The rows read before are rewritten, which an APPEND mode refresh assumes they are
+  // not, so that the results show that their cached chunks are not read again.
+  std::ofstream(file_path) << "i\n7\n8\n3\n4\n5\n";
+  sql("REFRESH FOREIGN TABLES " + default_name + ";");
+  sqlAndCompareResult(select, {{i(1)}, {i(2)}, {i(3)}, {i(4)}, {i(5)}});
+
+  bf::remove_all(dir_path);
+}
+
 TEST_F(CsvAppendTest, MissingRows) {
   int fragment_size = 1;
   std::string filename = "single_file_delete_rows.csv";
@@ -362,6 +362,35 @@ TEST(Ordering, Triple) {
   }
 }
 
+TEST(Ordering, FilteredTableSizes) {
+  // The filtered row counts of the tables replace their sizes.
+  auto a1 = std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 0, 0, 0);
+  auto a2 = std::make_shared<Analyzer::ColumnVar>(SQLTypeInfo{kINT, true}, 1, 1, 1);
+  auto op = std::make_shared<Analyzer::BinOper>(kINT, kEQ, kONE, a1, a2);
+
+  JoinCondition jc{{op}, JoinType::INNER};
+  JoinQualsPerNestingLevel nesting_levels;
+  nesting_levels.push_back(jc);
+
+  size_t number_of_join_tables{2};
+  std::vector<InputTableInfo> viti(number_of_join_tables);
+  viti[0].info.setPhysicalNumTuples(2);
+  viti[1].info.setPhysicalNumTuples(1);
+
+  {
+    auto input_permutation = get_node_input_permutation(nesting_levels, viti, nullptr);
+    decltype(input_permutation) expected_input_permutation{0, 1};
+    ASSERT_EQ(expected_input_permutation, input_permutation);
+  }
+
+  {
+    auto input_permutation =
+        get_node_input_permutation(nesting_levels, viti, nullptr, {1, 2});
+    decltype(input_permutation) expected_input_permutation{1, 0};
+    ASSERT_EQ(expected_input_permutation, input_permutation);
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
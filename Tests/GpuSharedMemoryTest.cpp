@@ -128,8 +128,11 @@ void GpuReductionTester::codegenWrapperKernel() {
                                    "output_buffer_ptr");
   // call the reduction function
   CHECK(reduction_func_);
+  // perfect hash reductions don't record errors
+  const auto null_error_codes_ptr =
+      llvm::ConstantPointerNull::get(llvm::Type::getInt32PtrTy(context_));
   std::vector<llvm::Value*> reduction_args{
-      output_buffer_ptr, smem_input_buffer_ptr, buffer_size};
+      output_buffer_ptr, smem_input_buffer_ptr, buffer_size, null_error_codes_ptr};
   ir_builder.CreateCall(reduction_func_, reduction_args);
   ir_builder.CreateBr(bb_exit);
 
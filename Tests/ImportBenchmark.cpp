@@ -0,0 +1,116 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../Catalog/ColumnDescriptor.h"
+#include "../ImportExport/DelimitedParserUtils.h"
+#include "../ImportExport/Importer.h"
+
+namespace {
+
+// num_rows rows of an int, a double, a string and a timestamp, as a delimited file
+std::string make_delimited_rows(const size_t num_rows) {
+  std::string rows;
+  for (size_t i = 0; i < num_rows; ++i) {
+    const auto key = (i * 2654435761ULL) % 1000000;
+    rows += std::to_string(key) + "," + std::to_string(key * 0.25) + ",\"string " +
+            std::to_string(key % 1000) + "\",2020-0" + std::to_string(1 + key % 9) +
+            "-1" + std::to_string(key % 10) + " 12:34:56\n";
+  }
+  return rows;
+}
+
+std::vector<ColumnDescriptor> make_column_descs() {
+  return {ColumnDescriptor(1, 1, "i", SQLTypeInfo(kINT, false)),
+          ColumnDescriptor(1, 2, "d", SQLTypeInfo(kDOUBLE, false)),
+          ColumnDescriptor(1, 3, "s", SQLTypeInfo(kTEXT, false)),
+          ColumnDescriptor(1, 4, "t", SQLTypeInfo(kTIMESTAMP, false))};
+}
+
+// Calls f with each row of the delimited rows, like the threads of the delimited
+// imports do on their part of the file
+template <typename F>
+void for_each_row(const std::string& rows,
+                  const import_export::CopyParams& copy_params,
+                  const bool* is_array,
+                  F f) {
+  const auto buf_end = rows.data() + rows.size();
+  std::vector<std::string_view> row;
+  bool try_single_thread{false};
+  for (const char* p = rows.data(); p < buf_end; p++) {
+    row.clear();
+    std::vector<std::unique_ptr<char[]>> tmp_buffers;
+    p = import_export::delimited_parser::get_row(
+        p, buf_end, buf_end, copy_params, is_array, row, tmp_buffers, try_single_thread);
+    f(row);
+  }
+}
+
+//! Split state.range(0) delimited rows into their fields
+void getRow(benchmark::State& state) {
+  const auto rows = make_delimited_rows(state.range(0));
+  const import_export::CopyParams copy_params;
+  const bool is_array[]{false, false, false, false};
+  for (auto _ : state) {
+    size_t field_count{0};
+    for_each_row(rows, copy_params, is_array, [&field_count](const auto& row) {
+      field_count += row.size();
+    });
+    benchmark::DoNotOptimize(field_count);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * rows.size());
+}
+
+//! Split state.range(0) delimited rows into their fields and convert the fields into
+//! the import buffers of their columns, which import_thread_delimited does for each row
+void parseDelimited(benchmark::State& state) {
+  const auto rows = make_delimited_rows(state.range(0));
+  const import_export::CopyParams copy_params;
+  const bool is_array[]{false, false, false, false};
+  const auto column_descs = make_column_descs();
+  std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+  for (const auto& column_desc : column_descs) {
+    import_buffers.push_back(
+        std::make_unique<import_export::TypedImportBuffer>(&column_desc, nullptr));
+  }
+  for (auto _ : state) {
+    for (const auto& import_buffer : import_buffers) {
+      import_buffer->clear();
+    }
+    for_each_row(rows, copy_params, is_array, [&](const auto& row) {
+      for (size_t i = 0; i < column_descs.size(); ++i) {
+        import_buffers[i]->add_value(&column_descs[i], row[i], false, copy_params);
+      }
+    });
+    benchmark::DoNotOptimize(import_buffers.front().get());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * rows.size());
+}
+
+}  // namespace
+
+BENCHMARK(getRow)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(parseDelimited)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -17,6 +17,7 @@
 #include <Tests/TestHelpers.h>
 
 #include <algorithm>
+#include <fstream>
 #include <limits>
 #include <string>
 
@@ -36,12 +37,14 @@
 #include "ImportExport/DelimitedParserUtils.h"
 #include "ImportExport/GDAL.h"
 #include "ImportExport/Importer.h"
+#include "ImportExport/StreamIngestor.h"
 #include "Parser/parser.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Shared/geo_types.h"
 #include "Shared/misc.h"
 #include "Shared/scope.h"
+#include "gen-cpp/omnisci_types.h"
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -53,6 +56,9 @@ using namespace TestHelpers;
 extern bool g_use_date_in_days_default_encoding;
 extern size_t g_leaf_count;
 extern bool g_is_test_env;
+extern size_t g_import_read_ahead_buffers;
+extern size_t g_import_dict_encoder_threads;
+extern size_t g_detect_sample_blocks;
 
 namespace {
 
@@ -363,6 +369,137 @@ TEST(Detect, Numeric) {
   d(kTEXT, "1.22.22");
 }
 
+TEST(Detect, SampleBlocks) {
+  // integers in the first 2MB of the file and floats past them
+  const std::string file_path = BASE_PATH "/detect_sample_blocks.csv";
+  ScopeGuard remove_file = [&file_path] { boost::filesystem::remove(file_path); };
+  {
+    std::ofstream file(file_path);
+    file << "id,val\n";
+    const size_t file_size = (g_detect_sample_blocks + 2) << 20;
+    for (size_t id = 0; file.tellp() < static_cast<std::streamoff>(file_size); ++id) {
+      file << id << ',' << (file.tellp() < (2 << 20) ? "7" : "7.5") << '\n';
+    }
+  }
+  import_export::CopyParams copy_params;
+  import_export::Detector detector(file_path, copy_params);
+  EXPECT_TRUE(detector.has_headers);
+  ASSERT_EQ(size_t(2), detector.best_sqltypes.size());
+  EXPECT_EQ(TypeToString(kFLOAT), TypeToString(detector.best_sqltypes[1]));
+}
+
+TEST(DelimitedParser, GetRowAcrossBlocks) {
+  // fields, quotes and escapes on both sides of the 32 byte block boundaries
+  const std::string row =
+      "a_first_field_of_thirty_bytes_,\"quoted, \"\"field\"\" across blocks\","
+      "{1,2,3},,\"\",last_field_which_ends_the_row_in_another_block\n";
+  import_export::CopyParams copy_params;
+  const bool is_array[] = {false, false, true, false, false, false};
+  std::vector<std::string_view> fields;
+  std::vector<std::unique_ptr<char[]>> tmp_buffers;
+  bool try_single_thread{false};
+  const auto row_end =
+      import_export::delimited_parser::get_row(row.data(),
+                                               row.data() + row.size(),
+                                               row.data() + row.size(),
+                                               copy_params,
+                                               is_array,
+                                               fields,
+                                               tmp_buffers,
+                                               try_single_thread);
+  EXPECT_EQ(row.data() + row.size() - 1, row_end);
+  const std::vector<std::string_view> expected_fields{
+      "a_first_field_of_thirty_bytes_",
+      "quoted, \"field\" across blocks",
+      "{1,2,3}",
+      "",
+      "",
+      "last_field_which_ends_the_row_in_another_block"};
+  EXPECT_EQ(expected_fields, fields);
+  EXPECT_FALSE(try_single_thread);
+}
+
+TEST(StreamIngestor, ParseKafkaUrl) {
+  using import_export::StreamIngestor;
+  EXPECT_TRUE(StreamIngestor::isKafkaUrl(" KAFKA://broker/topic"));
+  EXPECT_FALSE(StreamIngestor::isKafkaUrl("s3://bucket/kafka://"));
+  const auto [brokers, topics] =
+      StreamIngestor::parseKafkaUrl("kafka://b1:9092,b2:9092/trips, fares");
+  EXPECT_EQ("b1:9092,b2:9092", brokers);
+  EXPECT_EQ(std::vector<std::string>({"trips", "fares"}), topics);
+  EXPECT_THROW(StreamIngestor::parseKafkaUrl("kafka://broker"), std::runtime_error);
+  EXPECT_THROW(StreamIngestor::parseKafkaUrl("kafka://broker/a,,b"), std::runtime_error);
+}
+
+TEST(StreamIngestor, SerializeCopyParams) {
+  using import_export::StreamIngestor;
+  import_export::CopyParams copy_params;
+  copy_params.delimiter = '|';
+  copy_params.null_str = "\\N";
+  copy_params.quoted = false;
+  copy_params.array_begin = '[';
+  copy_params.array_end = ']';
+  copy_params.kafka_group_id = "trips_group";
+  copy_params.kafka_from_latest = true;
+  copy_params.kafka_consumers = 3;
+  copy_params.kafka_batch_ms = 250;
+  copy_params.kafka_batch_rows = 1000;
+  const auto deserialized = StreamIngestor::deserializeCopyParams(
+      StreamIngestor::serializeCopyParams(copy_params));
+  EXPECT_EQ(copy_params.delimiter, deserialized.delimiter);
+  EXPECT_EQ(copy_params.null_str, deserialized.null_str);
+  EXPECT_EQ(copy_params.quoted, deserialized.quoted);
+  EXPECT_EQ(copy_params.quote, deserialized.quote);
+  EXPECT_EQ(copy_params.escape, deserialized.escape);
+  EXPECT_EQ(copy_params.line_delim, deserialized.line_delim);
+  EXPECT_EQ(copy_params.array_delim, deserialized.array_delim);
+  EXPECT_EQ(copy_params.array_begin, deserialized.array_begin);
+  EXPECT_EQ(copy_params.array_end, deserialized.array_end);
+  EXPECT_EQ(copy_params.kafka_group_id, deserialized.kafka_group_id);
+  EXPECT_EQ(copy_params.kafka_from_latest, deserialized.kafka_from_latest);
+  EXPECT_EQ(copy_params.kafka_consumers, deserialized.kafka_consumers);
+  EXPECT_EQ(copy_params.kafka_batch_ms, deserialized.kafka_batch_ms);
+  EXPECT_EQ(copy_params.kafka_batch_rows, deserialized.kafka_batch_rows);
+  EXPECT_THROW(StreamIngestor::deserializeCopyParams("{}"), std::runtime_error);
+}
+
+TEST(TypedImportBuffer, AddColumnarValues) {
+  ColumnDescriptor cd;
+  cd.columnName = "x";
+  TColumn col;
+  col.data.int_col = {1, -2, 3, 300};
+  col.nulls = {false, true, false, false};
+
+  cd.columnType = SQLTypeInfo(kSMALLINT, false);
+  import_export::TypedImportBuffer smallint_buffer(&cd, nullptr);
+  ASSERT_EQ(size_t(4), smallint_buffer.add_values(&cd, col));
+  ASSERT_EQ(size_t(4), smallint_buffer.add_values(&cd, col));
+  const auto smallints = reinterpret_cast<const int16_t*>(smallint_buffer.getAsBytes());
+  const std::vector<int16_t> expected_smallints{
+      1, NULL_SMALLINT, 3, 300, 1, NULL_SMALLINT, 3, 300};
+  EXPECT_EQ(expected_smallints, std::vector<int16_t>(smallints, smallints + 8));
+
+  cd.columnType = SQLTypeInfo(kBIGINT, false);
+  import_export::TypedImportBuffer bigint_buffer(&cd, nullptr);
+  ASSERT_EQ(size_t(4), bigint_buffer.add_values(&cd, col));
+  const auto bigints = reinterpret_cast<const int64_t*>(bigint_buffer.getAsBytes());
+  const std::vector<int64_t> expected_bigints{1, NULL_BIGINT, 3, 300};
+  EXPECT_EQ(expected_bigints, std::vector<int64_t>(bigints, bigints + 4));
+
+  col.data.int_col.clear();
+  col.data.real_col = {0.5, 1.5, -2.5, 0};
+  cd.columnType = SQLTypeInfo(kFLOAT, false);
+  import_export::TypedImportBuffer float_buffer(&cd, nullptr);
+  ASSERT_EQ(size_t(4), float_buffer.add_values(&cd, col));
+  const auto floats = reinterpret_cast<const float*>(float_buffer.getAsBytes());
+  const std::vector<float> expected_floats{0.5, NULL_FLOAT, -2.5, 0};
+  EXPECT_EQ(expected_floats, std::vector<float>(floats, floats + 4));
+
+  cd.columnType = SQLTypeInfo(kDOUBLE, true);
+  import_export::TypedImportBuffer double_buffer(&cd, nullptr);
+  EXPECT_THROW(double_buffer.add_values(&cd, col), std::runtime_error);
+}
+
 const char* create_table_trips_to_skip_header = R"(
     CREATE TABLE trips (
       trip_distance DECIMAL(14,2),
@@ -1081,6 +1218,22 @@ TEST_F(ImportTest, One_csv_file) {
   EXPECT_TRUE(import_test_local("trip_data_9.csv", 100, 1.0));
 }
 
+TEST_F(ImportTest, One_csv_file_small_buffers_through_short_queues) {
+  // many buffers of rows queue up between the reader, parsers, encoder and writer
+  ScopeGuard reset_queues = [read_ahead_buffers = g_import_read_ahead_buffers,
+                             encoder_threads = g_import_dict_encoder_threads] {
+    g_import_read_ahead_buffers = read_ahead_buffers;
+    g_import_dict_encoder_threads = encoder_threads;
+  };
+  g_import_read_ahead_buffers = 1;
+  g_import_dict_encoder_threads = 1;
+  EXPECT_TRUE(import_test_common(
+      "COPY trips FROM '../../Tests/Import/datafiles/trip_data_9.csv' WITH "
+      "(header='true', buffer_size=1024, threads=2);",
+      100,
+      1.0));
+}
+
 TEST_F(ImportTest, array_including_quoted_fields) {
   EXPECT_TRUE(import_test_array_including_quoted_fields_local(
       "array_including_quoted_fields.csv", 2, "array_delimiter=','"));
@@ -2236,13 +2389,16 @@ TEST_F(ExportTest, CSV_Zip_Unimplemented) {
   RUN_TEST_ON_ALL_GEO_TYPES();
 }
 
-TEST_F(ExportTest, CSV_GZip_Unimplemented) {
+TEST_F(ExportTest, CSV_GZip) {
   SKIP_ALL_ON_AGGREGATOR();
   doCreateAndImport();
   auto run_test = [&](const std::string& geo_type) {
-    std::string exp_file = "query_export_test_geojson_" + geo_type + ".geojson";
-    EXPECT_THROW(doExport(exp_file, "CSV", "GZip", geo_type, WITH_ARRAYS, DEFAULT_SRID),
-                 std::runtime_error);
+    std::string req_file = "query_export_test_csv_" + geo_type + ".csv";
+    std::string exp_file = req_file + ".gz";
+    ASSERT_NO_THROW(doExport(req_file, "CSV", "GZip", geo_type, WITH_ARRAYS, DEFAULT_SRID));
+    ASSERT_NO_THROW(doCompareText(exp_file, GZIPPED));
+    doImportAgainAndCompare(exp_file, "CSV", geo_type, WITH_ARRAYS);
+    removeExportedFile(exp_file);
   };
   RUN_TEST_ON_ALL_GEO_TYPES();
 }
@@ -2490,6 +2646,47 @@ TEST_F(ExportTest, Shapefile_InvalidName) {
                std::runtime_error);
 }
 
+TEST_F(ExportTest, Shapefile_Reimport_Chunks) {
+  SKIP_ALL_ON_AGGREGATOR();
+  // more features than a chunk of the import, the threads read theirs from the file
+  const int num_rows = 3500;
+  const std::string csv_file = BASE_PATH "/mapd_export/query_export_test_chunks.csv";
+  {
+    std::ofstream csv(csv_file);
+    csv << "id,p\n";
+    for (int id = 0; id < num_rows; ++id) {
+      csv << id << ",\"POINT(" << id % 97 << " " << id / 97 << ")\"\n";
+    }
+  }
+  ASSERT_NO_THROW(run_ddl_statement(
+      "CREATE TABLE query_export_test (id INTEGER, p GEOMETRY(POINT, 4326));"));
+  ASSERT_NO_THROW(run_ddl_statement("COPY query_export_test FROM '" + csv_file +
+                                    "' WITH (header='true');"));
+  const std::string shp_file = "query_export_test_chunks.shp";
+  ASSERT_NO_THROW(run_ddl_statement(
+      "COPY (SELECT id, p FROM query_export_test) TO '" + shp_file +
+      "' WITH (file_type='Shapefile');"));
+  QueryRunner::ImportDriver import_driver(QR::get()->getCatalog(),
+                                          QR::get()->getSession()->get_currentUser(),
+                                          ExecutorDeviceType::CPU);
+  ASSERT_NO_THROW(import_driver.importGeoTable(BASE_PATH "/mapd_export/" + shp_file,
+                                               "query_export_test_reimport",
+                                               false,
+                                               true,
+                                               false));
+  {
+    auto rows = run_query(
+        "SELECT COUNT(*), COUNT(DISTINCT id), SUM(CASE WHEN ST_X(omnisci_geo) = MOD(id, "
+        "97) AND ST_Y(omnisci_geo) = id / 97 THEN 1 ELSE 0 END) FROM "
+        "query_export_test_reimport;");
+    auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(size_t(3), crt_row.size());
+    ASSERT_EQ(int64_t(num_rows), v<int64_t>(crt_row[0]));
+    ASSERT_EQ(int64_t(num_rows), v<int64_t>(crt_row[1]));
+    ASSERT_EQ(int64_t(num_rows), v<int64_t>(crt_row[2]));
+  }
+}
+
 TEST_F(ExportTest, Shapefile_Invalid_SRID) {
   SKIP_ALL_ON_AGGREGATOR();
   doCreateAndImport();
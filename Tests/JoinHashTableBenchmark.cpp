@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <future>
+#include <limits>
+#include <vector>
+
+#include "../QueryEngine/JoinHashTable/HashJoinKeyHandlers.h"
+#include "../QueryEngine/JoinHashTable/HashJoinRuntime.h"
+#include "../Shared/thread_count.h"
+
+namespace {
+
+constexpr int32_t kInvalidSlot{-1};
+
+// num_rows keys in [0, num_distinct), in a shuffled order
+std::vector<int64_t> make_keys(const size_t num_rows, const size_t num_distinct) {
+  std::vector<int64_t> keys(num_rows);
+  for (size_t i = 0; i < num_rows; ++i) {
+    keys[i] = (i * 2654435761ULL) % num_distinct;
+  }
+  return keys;
+}
+
+// A single chunk join column over keys, which the column keeps pointing to
+struct KeyColumn {
+  explicit KeyColumn(const std::vector<int64_t>& keys)
+      : chunk{reinterpret_cast<const int8_t*>(keys.data()), keys.size()}
+      , column{reinterpret_cast<const int8_t*>(&chunk),
+               sizeof(JoinChunk),
+               1,
+               keys.size(),
+               sizeof(int64_t)}
+      , type_info{sizeof(int64_t),
+                  0,
+                  std::numeric_limits<int64_t>::max() - 1,
+                  std::numeric_limits<int64_t>::min(),
+                  false,
+                  std::numeric_limits<int64_t>::max(),
+                  Signed} {}
+
+  JoinChunk chunk;
+  JoinColumn column;
+  JoinColumnTypeInfo type_info;
+};
+
+//! Build a one-to-many perfect hash table of state.range(0) rows with state.range(1)
+//! distinct keys
+void perfectOneToMany(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0), state.range(1));
+  const KeyColumn key_column(keys);
+  const size_t entry_count = state.range(1);
+  const auto type_info = JoinColumnTypeInfo{sizeof(int64_t),
+                                            0,
+                                            static_cast<int64_t>(entry_count - 1),
+                                            std::numeric_limits<int64_t>::min(),
+                                            false,
+                                            static_cast<int64_t>(entry_count),
+                                            Signed};
+  const auto thread_count = cpu_threads();
+  std::vector<int32_t> buff(2 * entry_count + keys.size());
+  for (auto _ : state) {
+    init_hash_join_buff(buff.data(), entry_count, kInvalidSlot, 0, 1);
+    fill_one_to_many_hash_table(buff.data(),
+                                {entry_count, 1},
+                                kInvalidSlot,
+                                key_column.column,
+                                type_info,
+                                nullptr,
+                                nullptr,
+                                thread_count);
+    benchmark::DoNotOptimize(buff.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// Fills buff, of entry_count entries, with the keys of key_column and their row ids if
+// with_val_slot, by partition_count partitions of slots if not 0
+void fill_baseline(int8_t* buff,
+                   const size_t entry_count,
+                   const bool with_val_slot,
+                   const KeyColumn& key_column,
+                   const size_t partition_count) {
+  const auto thread_count = cpu_threads();
+  const void* sd_proxy{nullptr};
+  const auto key_handler = GenericKeyHandler(
+      1, true, &key_column.column, &key_column.type_info, &sd_proxy, &sd_proxy);
+  init_baseline_hash_join_buff_64(
+      buff, entry_count, 1, with_val_slot, kInvalidSlot, 0, 1);
+  if (partition_count) {
+    fill_baseline_hash_join_buff_partitioned_64(buff,
+                                                entry_count,
+                                                kInvalidSlot,
+                                                1,
+                                                with_val_slot,
+                                                &key_handler,
+                                                partition_count,
+                                                thread_count);
+    return;
+  }
+  std::vector<std::future<int>> fill_threads;
+  for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    fill_threads.push_back(std::async(std::launch::async,
+                                      fill_baseline_hash_join_buff_64,
+                                      buff,
+                                      entry_count,
+                                      kInvalidSlot,
+                                      1,
+                                      with_val_slot,
+                                      &key_handler,
+                                      key_column.column.num_elems,
+                                      thread_idx,
+                                      thread_count));
+  }
+  for (auto& child : fill_threads) {
+    child.get();
+  }
+}
+
+//! Build a one-to-one baseline hash table of state.range(0) distinct keys, by
+//! state.range(1) partitions or directly if 0
+void baselineOneToOne(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0), state.range(0));
+  const KeyColumn key_column(keys);
+  const size_t entry_count = 2 * keys.size();
+  std::vector<int8_t> buff(entry_count * 2 * sizeof(int64_t));
+  for (auto _ : state) {
+    fill_baseline(buff.data(), entry_count, true, key_column, state.range(1));
+    benchmark::DoNotOptimize(buff.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+//! Build a one-to-many baseline hash table of state.range(0) rows with state.range(1)
+//! distinct keys
+void baselineOneToMany(benchmark::State& state) {
+  const auto keys = make_keys(state.range(0), state.range(1));
+  const KeyColumn key_column(keys);
+  const size_t entry_count = 2 * state.range(1);
+  std::vector<int8_t> key_dict(entry_count * sizeof(int64_t));
+  std::vector<int32_t> buff(2 * entry_count + keys.size());
+  const std::vector<JoinColumn> join_column_per_key{key_column.column};
+  const std::vector<JoinColumnTypeInfo> type_info_per_key{key_column.type_info};
+  const std::vector<const void*> sd_proxy_per_key{nullptr};
+  const auto thread_count = cpu_threads();
+  for (auto _ : state) {
+    fill_baseline(key_dict.data(), entry_count, false, key_column, 0);
+    init_hash_join_buff(buff.data(), entry_count, kInvalidSlot, 0, 1);
+    fill_one_to_many_baseline_hash_table_64(
+        buff.data(),
+        reinterpret_cast<const int64_t*>(key_dict.data()),
+        entry_count,
+        kInvalidSlot,
+        1,
+        join_column_per_key,
+        type_info_per_key,
+        {},
+        sd_proxy_per_key,
+        sd_proxy_per_key,
+        thread_count);
+    benchmark::DoNotOptimize(buff.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+}  // namespace
+
+BENCHMARK(perfectOneToMany)
+    ->Args({1 << 24, 1 << 10})
+    ->Args({1 << 24, 1 << 22})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(baselineOneToOne)
+    ->Args({1 << 22, 0})
+    ->Args({1 << 22, 64})
+    ->Args({1 << 22, 256})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(baselineOneToMany)
+    ->Args({1 << 24, 1 << 10})
+    ->Args({1 << 24, 1 << 22})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
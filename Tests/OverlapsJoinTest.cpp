@@ -23,6 +23,7 @@
 
 #include "QueryEngine/ArrowResultSet.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/ExternalCacheInvalidators.h"
 #include "Shared/scope.h"
 #include "TestHelpers.h"
 
@@ -30,6 +31,9 @@
 #define BASE_PATH "./tmp"
 #endif
 
+extern size_t g_overlaps_max_table_size_bytes;
+extern size_t g_overlaps_auto_tuner_sample_rows;
+
 using QR = QueryRunner::QueryRunner;
 using namespace TestHelpers;
 
@@ -416,6 +420,26 @@ TEST_F(OverlapsTest, EmptyPolyPolyJoin) {
   });
 }
 
+TEST_F(OverlapsTest, AutoTunerSampledBudget) {
+  ScopeGuard reset_max_size = [orig = g_overlaps_max_table_size_bytes] {
+    g_overlaps_max_table_size_bytes = orig;
+  };
+  ScopeGuard reset_sample_rows = [orig = g_overlaps_auto_tuner_sample_rows] {
+    g_overlaps_auto_tuner_sample_rows = orig;
+  };
+  // the estimates from a single row are wrong, the budget too small for any threshold
+  g_overlaps_auto_tuner_sample_rows = 1;
+  g_overlaps_max_table_size_bytes = 1;
+  executeAllScenarios([](ExecutorDeviceType dt) -> void {
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    auto sql = R"(SELECT count(*) from does_intersect_a as a
+                  JOIN does_intersect_b as b
+                  ON ST_Intersects(a.poly, b.poly);)";
+    ASSERT_EQ(static_cast<int64_t>(4), v<int64_t>(execSQL(sql, dt)));
+  });
+  JoinHashTableCacheInvalidator::invalidateCaches();
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   TestHelpers::init_logger_stderr_only(argc, argv);
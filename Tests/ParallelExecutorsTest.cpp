@@ -20,9 +20,13 @@
 
 #include "../QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
 #include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ExecutorResourcePool.h"
 #include "../QueryRunner/QueryRunner.h"
+#include "../Shared/scope.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <future>
 #include <string>
 #include <vector>
@@ -35,6 +39,8 @@ bool g_keep_data{false};
 size_t g_max_num_executors{8};
 
 extern bool g_is_test_env;
+extern bool g_enable_concurrent_query_execution;
+extern bool g_enable_query_admission_control;
 
 using QR = QueryRunner::QueryRunner;
 using namespace TestHelpers;
@@ -235,6 +241,157 @@ TEST_F(SingleTableTestEnv, AllTables) {
   }
 }
 
+TEST_F(SingleTableTestEnv, ConcurrentQueryExecution) {
+  ScopeGuard reset_flag = [orig = g_enable_concurrent_query_execution] {
+    g_enable_concurrent_query_execution = orig;
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+
+    for (const bool concurrent : {false, true}) {
+      g_enable_concurrent_query_execution = concurrent;
+      QR::get()->resizeDispatchQueue(g_max_num_executors);
+      std::vector<std::future<void>> worker_threads;
+      std::vector<int64_t> latencies(g_max_num_executors);
+      auto execution_time = measure<>::execution([&]() {
+        for (size_t w = 0; w < g_max_num_executors; w++) {
+          worker_threads.push_back(std::async(std::launch::async, [&latencies, w, dt] {
+            latencies[w] = measure<>::execution(
+                [dt] { run_sql_execute_test("test_parallel", dt); });
+          }));
+        }
+        for (auto& t : worker_threads) {
+          t.get();
+        }
+      });
+      LOG(ERROR) << "Finished execution with " << g_max_num_executors
+                 << " executors, concurrent execution "
+                 << (concurrent ? "enabled" : "disabled") << ", " << execution_time
+                 << " ms total, "
+                 << *std::max_element(latencies.begin(), latencies.end())
+                 << " ms max worker latency.";
+    }
+  }
+}
+
+TEST(ExecutorResourcePool, AcquireRelease) {
+  ExecutorResourcePool pool(4);
+  EXPECT_EQ(pool.getTotalCpuSlots(), size_t(4));
+  {
+    auto cpu_handle = pool.acquire(3, {});
+    EXPECT_EQ(cpu_handle->getCpuSlots(), size_t(3));
+    EXPECT_EQ(pool.getAvailableCpuSlots(), size_t(1));
+    auto gpu_handle = pool.acquire(0, {0, 1});
+    EXPECT_TRUE(pool.isGpuBusy(0));
+    EXPECT_TRUE(pool.isGpuBusy(1));
+    EXPECT_FALSE(pool.isGpuBusy(2));
+  }
+  EXPECT_EQ(pool.getAvailableCpuSlots(), size_t(4));
+  EXPECT_FALSE(pool.isGpuBusy(0));
+
+  // requests larger than the pool are clamped rather than blocking forever
+  auto big_handle = pool.acquire(16, {});
+  EXPECT_EQ(big_handle->getCpuSlots(), size_t(4));
+}
+
+TEST(ExecutorResourcePool, BlocksUntilReleased) {
+  ExecutorResourcePool pool(2);
+  auto gpu_handle = pool.acquire(0, {0});
+  std::atomic<bool> acquired{false};
+  auto waiter = std::async(std::launch::async, [&pool, &acquired] {
+    auto handle = pool.acquire(1, {0});
+    acquired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(acquired);
+  gpu_handle.reset();
+  waiter.get();
+  EXPECT_TRUE(acquired);
+}
+
+TEST(ExecutorResourcePool, PriorityClasses) {
+  ExecutorResourcePool pool(1);
+  auto first_handle = pool.acquire(1, {});
+  std::mutex order_mutex;
+  std::vector<QueryPriority> order;
+  auto acquire = [&pool, &order_mutex, &order](const QueryPriority priority) {
+    ExecutorResourcePool::ResourceRequest request;
+    request.cpu_slots = 1;
+    request.priority = priority;
+    auto handle = pool.acquire(request);
+    std::lock_guard<std::mutex> lock(order_mutex);
+    order.push_back(priority);
+  };
+  auto low_waiter = std::async(std::launch::async, acquire, QueryPriority::LOW);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  auto high_waiter = std::async(std::launch::async, acquire, QueryPriority::HIGH);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // the high priority query goes ahead of the low priority one which waited longer
+  first_handle.reset();
+  low_waiter.get();
+  high_waiter.get();
+  ASSERT_EQ(order.size(), size_t(2));
+  EXPECT_EQ(order[0], QueryPriority::HIGH);
+  EXPECT_EQ(order[1], QueryPriority::LOW);
+}
+
+TEST(ExecutorResourcePool, MemoryBudgets) {
+  ExecutorResourcePool pool(8);
+  pool.setMemoryBudgets(1000, {{0, 500}});
+  ASSERT_TRUE(pool.hasMemoryBudgets());
+
+  ExecutorResourcePool::ResourceRequest too_big_for_gpu;
+  too_big_for_gpu.gpu_memory_bytes[0] = 501;
+  EXPECT_TRUE(pool.exceedsGpuBudget(too_big_for_gpu));
+
+  ExecutorResourcePool::ResourceRequest request;
+  request.cpu_slots = 1;
+  request.cpu_memory_bytes = 600;
+  auto first_handle = pool.acquire(request);
+  EXPECT_EQ(pool.getUsedCpuMemory(), size_t(600));
+
+  // the second query does not fit next to the first one and has to wait for it
+  std::atomic<bool> acquired{false};
+  auto waiter = std::async(std::launch::async, [&pool, &request, &acquired] {
+    auto handle = pool.acquire(request);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(acquired);
+  first_handle.reset();
+  waiter.get();
+  EXPECT_TRUE(acquired);
+  EXPECT_EQ(pool.getUsedCpuMemory(), size_t(0));
+
+  // requests larger than the whole budget are clamped so they can run alone
+  request.cpu_memory_bytes = 5000;
+  auto big_handle = pool.acquire(request);
+  EXPECT_EQ(big_handle->getCpuMemoryBytes(), size_t(1000));
+}
+
+TEST_F(SingleTableTestEnv, AdmissionControl) {
+  ScopeGuard reset_flags = [orig_concurrent = g_enable_concurrent_query_execution,
+                            orig_admission = g_enable_query_admission_control] {
+    g_enable_concurrent_query_execution = orig_concurrent;
+    g_enable_query_admission_control = orig_admission;
+  };
+  g_enable_concurrent_query_execution = true;
+  g_enable_query_admission_control = true;
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+
+    QR::get()->resizeDispatchQueue(g_max_num_executors);
+    std::vector<std::future<void>> worker_threads;
+    for (size_t w = 0; w < g_max_num_executors; w++) {
+      worker_threads.push_back(
+          std::async(std::launch::async, run_sql_execute_test, "test_parallel", dt));
+    }
+    for (auto& t : worker_threads) {
+      t.get();
+    }
+  }
+}
+
 size_t g_num_tables{50};
 
 class MultiTableTestEnv : public ::testing::Test {
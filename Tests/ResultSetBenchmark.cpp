@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "../Analyzer/Analyzer.h"
+#include "../QueryEngine/Descriptors/RowSetMemoryOwner.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ResultSet.h"
+#include "ResultSetTestUtils.h"
+
+namespace {
+
+std::vector<TargetInfo> make_target_infos() {
+  SQLTypeInfo bigint_ti(kBIGINT, false);
+  return {TargetInfo{true, kSUM, bigint_ti, bigint_ti, true, false},
+          TargetInfo{true, kCOUNT, bigint_ti, bigint_ti, true, false},
+          TargetInfo{true, kMIN, bigint_ti, bigint_ti, true, false},
+          TargetInfo{true, kMAX, bigint_ti, bigint_ti, true, false}};
+}
+
+// The group by buffer of entry_count entries of a group by of one key
+QueryMemoryDescriptor make_query_mem_desc(const QueryDescriptionType type,
+                                          const std::vector<TargetInfo>& target_infos,
+                                          const size_t entry_count) {
+  QueryMemoryDescriptor query_mem_desc(type, 0, entry_count - 1, false, {8});
+  for (size_t i = 0; i < target_infos.size(); ++i) {
+    query_mem_desc.addColSlotInfo({std::make_tuple<int8_t, int8_t>(8, 8)});
+  }
+  query_mem_desc.setEntryCount(entry_count);
+  return query_mem_desc;
+}
+
+// The result sets of a query, filled once and copied into new result sets for each
+// iteration, since the reductions and the sorts change them
+class ResultSetInputs {
+ public:
+  ResultSetInputs(const QueryDescriptionType type,
+                  const size_t entry_count,
+                  const size_t result_set_count,
+                  const size_t step)
+      : target_infos_(make_target_infos())
+      , query_mem_desc_(make_query_mem_desc(type, target_infos_, entry_count))
+      , buffer_size_(query_mem_desc_.getBufferSizeBytes(ExecutorDeviceType::CPU)) {
+    for (size_t i = 0; i < result_set_count; ++i) {
+      buffers_.emplace_back(buffer_size_);
+      EvenNumberGenerator generator;
+      fill_storage_buffer(
+          buffers_.back().data(), target_infos_, query_mem_desc_, generator, step);
+    }
+  }
+
+  std::vector<std::unique_ptr<ResultSet>> makeResultSets() const {
+    const auto row_set_mem_owner =
+        std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+    std::vector<std::unique_ptr<ResultSet>> result_sets;
+    for (const auto& buffer : buffers_) {
+      result_sets.push_back(std::make_unique<ResultSet>(target_infos_,
+                                                        ExecutorDeviceType::CPU,
+                                                        query_mem_desc_,
+                                                        row_set_mem_owner,
+                                                        nullptr));
+      const auto storage = result_sets.back()->allocateStorage();
+      std::memcpy(storage->getUnderlyingBuffer(), buffer.data(), buffer_size_);
+    }
+    return result_sets;
+  }
+
+ private:
+  const std::vector<TargetInfo> target_infos_;
+  const QueryMemoryDescriptor query_mem_desc_;
+  const size_t buffer_size_;
+  std::vector<std::vector<int8_t>> buffers_;
+};
+
+//! Reduce the state.range(1) result sets of the kernels of a group by with
+//! state.range(0) entries
+void reduceGroupBy(benchmark::State& state, const QueryDescriptionType type) {
+  // half of the entries of the baseline hash buffers are empty, like after a group by
+  // whose entry count guess was twice the group count
+  const size_t step = type == QueryDescriptionType::GroupByBaselineHash ? 2 : 1;
+  const ResultSetInputs inputs(type, state.range(0), state.range(1), step);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto result_sets = inputs.makeResultSets();
+    std::vector<ResultSet*> result_set_ptrs;
+    for (const auto& result_set : result_sets) {
+      result_set_ptrs.push_back(result_set.get());
+    }
+    state.ResumeTiming();
+    ResultSetManager result_set_manager;
+    benchmark::DoNotOptimize(result_set_manager.reduce(result_set_ptrs));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+//! Sort the state.range(0) entries of a group by on its SUM, the top state.range(1) of
+//! them or all of them if 0
+void sortGroupBy(benchmark::State& state) {
+  const ResultSetInputs inputs(
+      QueryDescriptionType::GroupByPerfectHash, state.range(0), 1, 1);
+  const std::list<Analyzer::OrderEntry> order_entries{{1, true, false}};
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto result_sets = inputs.makeResultSets();
+    state.ResumeTiming();
+    result_sets.front()->sort(order_entries, state.range(1));
+    benchmark::DoNotOptimize(result_sets.front().get());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(reduceGroupBy, PerfectHash, QueryDescriptionType::GroupByPerfectHash)
+    ->Args({1 << 16, 8})
+    ->Args({1 << 20, 8})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(reduceGroupBy, BaselineHash, QueryDescriptionType::GroupByBaselineHash)
+    ->Args({1 << 16, 8})
+    ->Args({1 << 20, 8})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(sortGroupBy)
+    ->Args({1 << 20, 0})
+    ->Args({1 << 20, 100})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
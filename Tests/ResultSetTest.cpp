@@ -30,6 +30,7 @@
 #include "QueryEngine/RuntimeFunctions.h"
 #include "StringDictionary/StringDictionary.h"
 #include "Tests/TestHelpers.h"
+#include "gen-cpp/serialized_result_set_types.h"
 
 #include <gtest/gtest.h>
 #include <algorithm>
@@ -1009,22 +1010,35 @@ void test_reduce(const std::vector<TargetInfo>& target_infos,
                  NumberGenerator& generator1,
                  NumberGenerator& generator2,
                  const int step,
-                 const bool sort) {
+                 const bool sort,
+                 const bool serialize_results = false) {
   const ResultSetStorage* storage1{nullptr};
   const ResultSetStorage* storage2{nullptr};
   const auto row_set_mem_owner =
       std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
   row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
-  const auto rs1 = std::make_unique<ResultSet>(
+  auto rs1 = std::make_unique<ResultSet>(
       target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
   storage1 = rs1->allocateStorage();
   fill_storage_buffer(
       storage1->getUnderlyingBuffer(), target_infos, query_mem_desc, generator1, step);
-  const auto rs2 = std::make_unique<ResultSet>(
+  auto rs2 = std::make_unique<ResultSet>(
       target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
   storage2 = rs2->allocateStorage();
   fill_storage_buffer(
       storage2->getUnderlyingBuffer(), target_infos, query_mem_desc, generator2, step);
+  const auto aggregator_row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  if (serialize_results) {
+    // reduce the results like the aggregator does with the results of two leaves
+    aggregator_row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+    for (auto rs : {&rs1, &rs2}) {
+      TSerializedRows serialized_rows;
+      (*rs)->serialize(serialized_rows);
+      *rs =
+          ResultSet::unserialize(serialized_rows, nullptr, aggregator_row_set_mem_owner);
+    }
+  }
   ResultSetManager rs_manager;
   std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
   auto result_rs = rs_manager.reduce(storage_set);
@@ -1568,6 +1582,14 @@ TEST(Reduce, PerfectHashOneCol) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 2, false);
 }
 
+TEST(Reduce, PerfectHashOneColSerialized) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  EvenNumberGenerator generator1;
+  EvenNumberGenerator generator2;
+  test_reduce(target_infos, query_mem_desc, generator1, generator2, 2, false, true);
+}
+
 TEST(Reduce, PerfectHashOneCol32) {
   const auto target_infos = generate_test_target_infos();
   const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 4, 0, 99);
@@ -1788,6 +1810,14 @@ TEST(Reduce, BaselineHash) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
 }
 
+TEST(Reduce, BaselineHashSerialized) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true, true);
+}
+
 TEST(Reduce, BaselineHashColumnar) {
   const auto target_infos = generate_test_target_infos();
   auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
@@ -1797,6 +1827,81 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
 }
 
+namespace {
+
+// Reduces result_set_count result sets with the same groups, every step entries, which
+// are reduced concurrently once there are more than two of them. Returns the entry count
+// of the reduced result set.
+size_t test_reduce_many(const std::vector<TargetInfo>& target_infos,
+                        const QueryMemoryDescriptor& query_mem_desc,
+                        const size_t result_set_count,
+                        const size_t step = 1) {
+  const auto row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  std::vector<std::unique_ptr<ResultSet>> result_sets;
+  std::vector<ResultSet*> storage_set;
+  for (size_t i = 0; i < result_set_count; ++i) {
+    result_sets.emplace_back(std::make_unique<ResultSet>(target_infos,
+                                                         ExecutorDeviceType::CPU,
+                                                         query_mem_desc,
+                                                         row_set_mem_owner,
+                                                         nullptr));
+    const auto storage = result_sets.back()->allocateStorage();
+    EvenNumberGenerator generator;
+    fill_storage_buffer(
+        storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, step);
+    storage_set.push_back(result_sets.back().get());
+  }
+  ResultSetManager rs_manager;
+  const auto result_rs = rs_manager.reduce(storage_set);
+  size_t group_count{0};
+  for (size_t row_idx = 0; row_idx < result_rs->entryCount(); ++row_idx) {
+    const auto row = result_rs->getRowAtNoTranslations(row_idx);
+    if (row.empty()) {
+      continue;
+    }
+    ++group_count;
+    EXPECT_EQ(target_infos.size(), row.size());
+    const auto min_val = v<int64_t>(row[0]);
+    EXPECT_DOUBLE_EQ(static_cast<double>(min_val), v<double>(row[1]));
+    EXPECT_EQ(static_cast<int64_t>(result_set_count) * min_val, v<int64_t>(row[2]));
+  }
+  EXPECT_EQ((query_mem_desc.getEntryCount() + step - 1) / step, group_count);
+  return result_rs->entryCount();
+}
+
+}  // namespace
+
+TEST(Reduce, PerfectHashTree) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  test_reduce_many(target_infos, query_mem_desc, 7);
+}
+
+TEST(Reduce, BaselineHashPartitioned) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(100000);
+  test_reduce_many(target_infos, query_mem_desc, 4);
+}
+
+TEST(Reduce, BaselineHashColumnarPartitioned) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(100000);
+  query_mem_desc.setOutputColumnar(true);
+  test_reduce_many(target_infos, query_mem_desc, 4);
+}
+
+TEST(Reduce, BaselineHashSparse) {
+  // the reduced buffer is sized by the groups of the results rather than their entries
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(100000);
+  ASSERT_EQ(size_t(200000), test_reduce_many(target_infos, query_mem_desc, 4, 4));
+}
+
 #ifndef HAVE_TSAN
 // The large buffers tests allocate too much memory to instrument under TSAN
 TEST(ReduceLargeBuffers, PerfectHashOne_Overflow32) {
@@ -457,6 +457,14 @@ void fill_storage_buffer(int8_t* buff,
       }
       break;
     }
+    case QueryDescriptionType::Projection: {
+      // the rows of the projections start with their index in the key slot, like the
+      // perfect hash entries with a single key column
+      CHECK(!query_mem_desc.didOutputColumnar());
+      fill_storage_buffer_perfect_hash_rowwise(
+          buff, target_infos, query_mem_desc, generator, step);
+      break;
+    }
     default:
       CHECK(false);
   }
@@ -487,6 +495,21 @@ QueryMemoryDescriptor perfect_hash_one_col_desc_small(
   return query_mem_desc;
 }
 
+QueryMemoryDescriptor projection_rowwise_desc(const std::vector<TargetInfo>& target_infos,
+                                              const int8_t num_bytes,
+                                              const size_t entry_count) {
+  QueryMemoryDescriptor query_mem_desc(
+      QueryDescriptionType::Projection, 0, 0, false, {8});
+  for (const auto& target_info : target_infos) {
+    CHECK(!target_info.is_agg);
+    const auto slot_bytes =
+        std::max(num_bytes, static_cast<int8_t>(target_info.sql_type.get_size()));
+    query_mem_desc.addColSlotInfo({std::make_tuple(slot_bytes, slot_bytes)});
+  }
+  query_mem_desc.setEntryCount(entry_count);
+  return query_mem_desc;
+}
+
 QueryMemoryDescriptor perfect_hash_one_col_desc(
     const std::vector<TargetInfo>& target_infos,
     const int8_t num_bytes,
@@ -143,6 +143,10 @@ QueryMemoryDescriptor perfect_hash_one_col_desc_small(
     const std::vector<TargetInfo>& target_infos,
     const int8_t num_bytes);
 
+QueryMemoryDescriptor projection_rowwise_desc(const std::vector<TargetInfo>& target_infos,
+                                              const int8_t num_bytes,
+                                              const size_t entry_count);
+
 QueryMemoryDescriptor perfect_hash_one_col_desc(
     const std::vector<TargetInfo>& target_infos,
     const int8_t num_bytes,
@@ -102,6 +102,47 @@ TEST(TIMESTAMPS, OverflowUnderflow) {
   }
 }
 
+TEST(TIMESTAMPS, ParseIsoDateTime) {
+  using namespace std::string_literals;
+  static const std::unordered_set<std::string> timestamps = {
+      "2020-02-29 23:59:59"s,
+      "2020-02-29T23:59:59"s,
+      "1969-12-31 00:00:00.5"s,
+      "1970-01-01 12:34:56.000123456"s,
+      "2016-12-31 23:59:60"s,
+      "2000-01-01 00:00:00"s};
+  for (const auto& str : timestamps) {
+    for (const int32_t dimen : {0, 3, 6, 9}) {
+      int64_t value;
+      ASSERT_TRUE(parse_iso_date_time<kTIMESTAMP>(str, dimen, value)) << str;
+      ASSERT_EQ(value, DateTimeStringValidate<kTIMESTAMP>()(str, dimen)) << str;
+    }
+  }
+  static const std::unordered_set<std::string> dates = {
+      "2020-02-29"s, "1969-12-31"s, "1900-01-01"s};
+  for (const auto& str : dates) {
+    int64_t value;
+    ASSERT_TRUE(parse_iso_date_time<kDATE>(str, 0, value)) << str;
+    ASSERT_EQ(value, DateTimeStringValidate<kDATE>()(str, 0)) << str;
+  }
+  // left to strptime()
+  static const std::unordered_set<std::string> others = {"2020-02-29 23:59"s,
+                                                         "2020-02-29 23:59:59."s,
+                                                         "2020-02-29 23:59:59 PM"s,
+                                                         "2020-02-29 23:59:59+05:00"s,
+                                                         "2020-02-29 24:00:00"s,
+                                                         "2020-13-01 00:00:00"s,
+                                                         "02/29/2020 23:59:59"s,
+                                                         "2020-2-29 23:59:59"s};
+  for (const auto& str : others) {
+    int64_t value;
+    ASSERT_FALSE(parse_iso_date_time<kTIMESTAMP>(str, 0, value)) << str;
+  }
+  int64_t value;
+  ASSERT_FALSE(parse_iso_date_time<kDATE>("2020-02-29 00:00:00"s, 0, value));
+  ASSERT_FALSE(parse_iso_date_time<kDATE>("29-Feb-20"s, 0, value));
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
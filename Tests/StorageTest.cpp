@@ -30,6 +30,7 @@
 #include "../Catalog/Catalog.h"
 #include "../DataMgr/DataMgr.h"
 #include "../Fragmenter/Fragmenter.h"
+#include "../Fragmenter/InsertWal.h"
 #include "../Parser/ParserNode.h"
 #include "../Parser/parser.h"
 #include "../QueryRunner/QueryRunner.h"
@@ -172,6 +173,78 @@ TEST(StorageSmallParallel, AllTypes) {
   ASSERT_NO_THROW(run_ddl_statement("drop table alltypes;"););
 }
 
+TEST(StorageSmall, FragmentsSnapshot) {
+  ASSERT_NO_THROW(run_ddl_statement("drop table if exists fragments_snapshot;"););
+  ASSERT_NO_THROW(run_ddl_statement(
+      "create table fragments_snapshot (a int) with (fragment_size = 2);"););
+  const auto td = QR::get()->getCatalog()->getMetadataForTable("fragments_snapshot");
+  ASSERT_TRUE(td);
+  for (size_t i = 1; i <= 5; ++i) {
+    QR::get()->runSQL("insert into fragments_snapshot values (1);",
+                      ExecutorDeviceType::CPU);
+    // the snapshot served to queries follows every insert
+    const auto table_info = td->fragmenter->getFragmentsForQuery();
+    EXPECT_EQ(table_info.getPhysicalNumTuples(), i);
+    EXPECT_EQ(table_info.fragments.size(), (i + 1) / 2);
+    EXPECT_EQ(td->fragmenter->getFragmentsForQuery().getPhysicalNumTuples(), i);
+  }
+  ASSERT_NO_THROW(run_ddl_statement("drop table fragments_snapshot;"););
+}
+
+TEST(InsertWal, ReplayAndReset) {
+  const std::string wal_path = std::string(BASE_PATH) + "/insert_wal_test";
+  boost::filesystem::remove_all(wal_path);
+  const std::vector<SQLTypeInfo> column_types{SQLTypeInfo(kINT, false),
+                                              SQLTypeInfo(kTEXT, false)};
+  const auto make_record = [&column_types](const int table_id, const int32_t value) {
+    std::vector<int32_t> ints{value, value + 1};
+    std::vector<std::string> strings{std::to_string(value), ""};
+    InsertData insert_data;
+    insert_data.tableId = table_id;
+    insert_data.columnIds = {1, 2};
+    insert_data.numRows = 2;
+    insert_data.data.resize(2);
+    insert_data.data[0].numbersPtr = reinterpret_cast<int8_t*>(ints.data());
+    insert_data.data[1].stringsPtr = &strings;
+    return InsertWal::serializeInsert(table_id, 1, insert_data, column_types);
+  };
+  {
+    InsertWal wal(wal_path);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([&wal, &make_record, i] {
+        wal.commit(make_record(1 + i % 2, i * 10));
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    wal.resetTable(2);
+    const auto tables_to_checkpoint =
+        wal.getTablesToCheckpoint([](const int table_id) { return 1; });
+    EXPECT_EQ(tables_to_checkpoint, std::vector<int>{1});
+  }
+
+  InsertWal wal(wal_path);
+  std::set<int32_t> replayed_values;
+  wal.replay([&replayed_values](const int table_id, const int epoch, InsertData& data) {
+    EXPECT_EQ(table_id, 1);
+    EXPECT_EQ(epoch, 1);
+    ASSERT_EQ(data.numRows, size_t(2));
+    const auto ints = reinterpret_cast<const int32_t*>(data.data[0].numbersPtr);
+    EXPECT_EQ(ints[1], ints[0] + 1);
+    EXPECT_EQ((*data.data[1].stringsPtr)[0], std::to_string(ints[0]));
+    EXPECT_EQ((*data.data[1].stringsPtr)[1], "");
+    replayed_values.insert(ints[0]);
+  });
+  EXPECT_EQ(replayed_values, (std::set<int32_t>{0, 20, 40, 60}));
+
+  // table 1 checkpointed past epoch 1, table 2 reset: no segment is needed anymore
+  wal.removeCheckpointedSegments([](const int table_id) { return 2; }, true);
+  EXPECT_EQ(wal.getNumSegments(), size_t(1));
+  boost::filesystem::remove_all(wal_path);
+}
+
 int main(int argc, char* argv[]) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "../StringDictionary/StringDictionary.h"
+
+namespace {
+
+// num_strings strings, num_distinct of them distinct, in a shuffled order
+std::vector<std::string> make_strings(const size_t num_strings,
+                                      const size_t num_distinct) {
+  std::vector<std::string> strings;
+  strings.reserve(num_strings);
+  for (size_t i = 0; i < num_strings; ++i) {
+    strings.push_back("string_dictionary_bench_" +
+                      std::to_string((i * 2654435761ULL) % num_distinct));
+  }
+  return strings;
+}
+
+//! Encode a batch of strings into a new temporary dictionary, state.range(0) strings
+//! with state.range(1) distinct ones, with and without the parallel bulk path
+void getOrAddBulk(benchmark::State& state, const bool parallel, const bool cache_hashes) {
+  const auto strings = make_strings(state.range(0), state.range(1));
+  std::vector<int32_t> ids(strings.size());
+  const bool enable_stringdict_parallel = g_enable_stringdict_parallel;
+  g_enable_stringdict_parallel = parallel;
+  for (auto _ : state) {
+    StringDictionary string_dict("", true, false, cache_hashes);
+    string_dict.getOrAddBulk(strings, ids.data());
+    benchmark::DoNotOptimize(ids.data());
+  }
+  g_enable_stringdict_parallel = enable_stringdict_parallel;
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+//! Encode a batch of strings which are all in the dictionary already
+void getOrAddBulkExisting(benchmark::State& state, const bool cache_hashes) {
+  const auto strings = make_strings(state.range(0), state.range(1));
+  std::vector<int32_t> ids(strings.size());
+  StringDictionary string_dict("", true, false, cache_hashes);
+  string_dict.getOrAddBulk(strings, ids.data());
+  for (auto _ : state) {
+    string_dict.getOrAddBulk(strings, ids.data());
+    benchmark::DoNotOptimize(ids.data());
+  }
+  state.SetItemsProcessed(state.iterations() * strings.size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(getOrAddBulk, Serial, false, false)
+    ->Args({1 << 20, 1 << 10})
+    ->Args({1 << 20, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(getOrAddBulk, SerialHashCache, false, true)
+    ->Args({1 << 20, 1 << 10})
+    ->Args({1 << 20, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(getOrAddBulk, Parallel, true, false)
+    ->Args({1 << 20, 1 << 10})
+    ->Args({1 << 20, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(getOrAddBulk, ParallelHashCache, true, true)
+    ->Args({1 << 20, 1 << 10})
+    ->Args({1 << 20, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(getOrAddBulkExisting, Serial, false)
+    ->Args({1 << 20, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(getOrAddBulkExisting, HashCache, true)
+    ->Args({1 << 20, 1 << 20})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -17,9 +17,17 @@
 #include "TestHelpers.h"
 
 #include "../StringDictionary/StringDictionary.h"
+#include "../StringDictionary/StringDictionaryProxy.h"
+#include "../StringDictionary/StringSymbolTable.h"
 
+#include <algorithm>
+#include <boost/filesystem.hpp>
 #include <cstdlib>
+#include <fstream>
 #include <limits>
+#include <set>
+#include <thread>
+#include <vector>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -101,6 +109,283 @@ TEST(StringDictionary, RecoverMany) {
   }
 }
 
+TEST(StringDictionary, ConcurrentBulkAdds) {
+  StringDictionary string_dict("", true, false, g_cache_string_hash);
+  const size_t num_threads{8};
+  const size_t num_strings{20000};
+  const size_t batch_size{1000};
+  // overlapping sets of strings, in a different order for each thread
+  std::vector<std::vector<std::string>> strings(num_threads);
+  std::set<std::string> distinct_strings;
+  for (size_t t = 0; t < num_threads; ++t) {
+    for (size_t i = 0; i < num_strings; ++i) {
+      strings[t].push_back(
+          std::to_string((i * (2 * t + 1) + t * num_strings / 2) % (2 * num_strings)));
+      distinct_strings.insert(strings[t].back());
+    }
+  }
+  std::vector<std::vector<int32_t>> ids(num_threads, std::vector<int32_t>(num_strings));
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&string_dict, &strings, &ids, t] {
+      for (size_t i = 0; i < num_strings; i += batch_size) {
+        const std::vector<std::string> batch(strings[t].begin() + i,
+                                             strings[t].begin() + i + batch_size);
+        string_dict.getOrAddBulkParallel(batch, ids[t].data() + i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(distinct_strings.size(), string_dict.storageEntryCount());
+  for (size_t t = 0; t < num_threads; ++t) {
+    for (size_t i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(strings[t][i], string_dict.getString(ids[t][i]));
+    }
+  }
+}
+
+TEST(StringDictionary, GetLikeAndRegexpLike) {
+  StringDictionary string_dict("", true, false, g_cache_string_hash);
+  const int32_t num_strings{100000};
+  std::vector<int32_t> expected_like_ids;
+  std::vector<int32_t> expected_ilike_ids;
+  for (int32_t i = 0; i < num_strings; ++i) {
+    const auto str = (i % 2 ? "Str" : "str") + std::to_string(i);
+    ASSERT_EQ(i, string_dict.getOrAdd(str));
+    if (str.back() == '7') {
+      expected_ilike_ids.push_back(i);
+      if (str[0] == 's') {
+        expected_like_ids.push_back(i);
+      }
+    }
+  }
+  ASSERT_EQ(expected_like_ids,
+            string_dict.getLike("str%7", false, false, '\\', num_strings));
+  ASSERT_EQ(expected_ilike_ids,
+            string_dict.getLike("str%7", true, false, '\\', num_strings));
+  ASSERT_EQ(expected_ilike_ids, string_dict.getRegexpLike(".*7", '\\', num_strings));
+  // only the strings below the generation are scanned
+  ASSERT_EQ(std::vector<int32_t>({7}), string_dict.getLike("%7", false, false, '\\', 10));
+}
+
+TEST(StringDictionary, LikeCacheAcrossAdds) {
+  StringDictionary string_dict("", true, false, g_cache_string_hash);
+  std::vector<int32_t> expected_ids;
+  for (int32_t i = 0; i < 3000; ++i) {
+    const auto str = "str" + std::to_string(i);
+    ASSERT_EQ(i, string_dict.getOrAdd(str));
+    if (str[3] == '4') {
+      expected_ids.push_back(i);
+    }
+    if (i % 1000 == 999) {
+      // the cached ids are extended over the strings added since the last lookup
+      const size_t generation = i + 1;
+      ASSERT_EQ(expected_ids,
+                string_dict.getLike("str4%", false, false, '\\', generation));
+      ASSERT_EQ(expected_ids, string_dict.getRegexpLike("str4.*", '\\', generation));
+    }
+  }
+  // an earlier generation only sees the ids below it
+  ASSERT_EQ(std::vector<int32_t>({4, 40, 41, 42}),
+            string_dict.getLike("str4%", false, false, '\\', 43));
+}
+
+namespace {
+
+std::vector<int32_t> get_sorted_compare(StringDictionary& string_dict,
+                                        const std::string& pattern,
+                                        const std::string& comp_operator) {
+  auto ids =
+      string_dict.getCompare(pattern, comp_operator, string_dict.storageEntryCount());
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+}  // namespace
+
+TEST(StringDictionary, PersistedSortedCache) {
+  const int32_t num_strings{1000};
+  std::vector<int32_t> expected_lt_ids;
+  {
+    StringDictionary string_dict(BASE_PATH, false, false, g_cache_string_hash);
+    for (int32_t i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+      if (std::to_string(i) < "5") {
+        expected_lt_ids.push_back(i);
+      }
+    }
+    ASSERT_EQ(expected_lt_ids, get_sorted_compare(string_dict, "5", "<"));
+    ASSERT_TRUE(string_dict.checkpoint());
+  }
+  ASSERT_TRUE(boost::filesystem::exists(std::string(BASE_PATH) + "/DictSortedIds"));
+  // the persisted cache is merged with the strings added after reopening
+  StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+  for (int32_t i = num_strings; i < 2 * num_strings; ++i) {
+    ASSERT_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+    if (std::to_string(i) < "5") {
+      expected_lt_ids.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected_lt_ids, get_sorted_compare(string_dict, "5", "<"));
+  std::vector<int32_t> expected_ge_ids;
+  for (int32_t i = 0; i < 2 * num_strings; ++i) {
+    if (std::to_string(i) >= "5") {
+      expected_ge_ids.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected_ge_ids, get_sorted_compare(string_dict, "5", ">="));
+}
+
+TEST(StringDictionary, PersistedHashTable) {
+  const int32_t num_strings{10000};
+  const auto hash_table_path = std::string(BASE_PATH) + "/DictHashTable";
+  {
+    StringDictionary string_dict(BASE_PATH, false, false, g_cache_string_hash);
+    for (int32_t i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+    }
+    ASSERT_TRUE(string_dict.checkpoint());
+    ASSERT_TRUE(boost::filesystem::exists(hash_table_path));
+    // stored after the table was persisted
+    for (int32_t i = num_strings; i < 2 * num_strings; ++i) {
+      ASSERT_EQ(i, string_dict.getOrAdd(std::to_string(i)));
+    }
+  }
+  {
+    StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+    ASSERT_EQ(static_cast<size_t>(2 * num_strings), string_dict.storageEntryCount());
+    for (int32_t i = 0; i < 2 * num_strings; ++i) {
+      ASSERT_EQ(i, string_dict.getIdOfString(std::to_string(i)));
+    }
+    ASSERT_EQ(2 * num_strings, string_dict.getOrAdd("new string"));
+  }
+  {
+    // a corrupt table is ignored
+    std::fstream hash_table(hash_table_path,
+                            std::ios::in | std::ios::out | std::ios::binary);
+    hash_table.seekp(-1, std::ios::end);
+    hash_table.put('x');
+  }
+  StringDictionary string_dict(BASE_PATH, false, true, g_cache_string_hash);
+  for (int32_t i = 0; i < 2 * num_strings; ++i) {
+    ASSERT_EQ(i, string_dict.getIdOfString(std::to_string(i)));
+  }
+  ASSERT_EQ(2 * num_strings, string_dict.getIdOfString("new string"));
+}
+
+TEST(StringDictionary, BuildTranslationMap) {
+  const int32_t num_strings{50000};
+  auto source_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  auto dest_dict =
+      std::make_shared<StringDictionary>("", true, false, g_cache_string_hash);
+  for (int32_t i = 0; i < num_strings; ++i) {
+    ASSERT_EQ(i, source_dict->getOrAdd(std::to_string(i)));
+  }
+  // the even strings, in reverse order
+  for (int32_t i = num_strings - 2; i >= 0; i -= 2) {
+    dest_dict->getOrAdd(std::to_string(i));
+  }
+  const size_t dest_generation = num_strings / 4;
+  const auto translation_map =
+      source_dict->buildTranslationMap(dest_dict.get(), num_strings, dest_generation);
+  ASSERT_EQ(static_cast<size_t>(num_strings), translation_map.size());
+  for (int32_t i = 0; i < num_strings; ++i) {
+    const auto dest_id = dest_dict->getIdOfString(std::to_string(i));
+    ASSERT_EQ(truncate_to_generation(dest_id, dest_generation), translation_map[i]);
+  }
+
+  StringDictionaryProxy source_proxy(source_dict, num_strings);
+  StringDictionaryProxy dest_proxy(dest_dict, dest_generation);
+  const auto transient_id = dest_proxy.getOrAddTransient("1");
+  ASSERT_LT(transient_id, StringDictionary::INVALID_STR_ID);
+  const auto& proxy_translation_map = source_proxy.getTranslationMap(&dest_proxy);
+  ASSERT_EQ(transient_id, proxy_translation_map[1]);
+  ASSERT_EQ(dest_proxy.getIdOfString("0"), proxy_translation_map[0]);
+  ASSERT_EQ(StringDictionary::INVALID_STR_ID, proxy_translation_map[3]);
+  ASSERT_EQ(&proxy_translation_map, &source_proxy.getTranslationMap(&dest_proxy));
+}
+
+TEST(StringSymbolTable, EncodeDecode) {
+  std::vector<std::string> strings;
+  for (int i = 0; i < 1000; ++i) {
+    strings.push_back("https://www.example.com/path/" + std::to_string(i * 7919));
+  }
+  const auto symbol_table = StringSymbolTable::train(
+      std::vector<std::string_view>(strings.begin(), strings.end()));
+  ASSERT_GT(symbol_table->numSymbols(), size_t(0));
+  const auto deserialized = StringSymbolTable::deserialize(symbol_table->serialize());
+  ASSERT_TRUE(deserialized);
+  ASSERT_FALSE(StringSymbolTable::deserialize("not a symbol table"));
+  // bytes the table has no symbols for are escaped
+  strings.push_back(std::string("\xff\x00\x01 unseen", 10));
+  size_t num_bytes{0};
+  size_t num_encoded_bytes{0};
+  for (const auto& str : strings) {
+    const auto encoded = symbol_table->encode(str);
+    ASSERT_LE(encoded.size(), StringSymbolTable::maxEncodedSize(str.size()));
+    ASSERT_EQ(encoded, deserialized->encode(str));
+    ASSERT_EQ(str, symbol_table->decode(encoded));
+    num_bytes += str.size();
+    num_encoded_bytes += encoded.size();
+  }
+  ASSERT_LT(num_encoded_bytes, num_bytes / 2);
+}
+
+TEST(StringDictionary, CompressedStorage) {
+  const int32_t num_strings{5000};
+  std::vector<std::string> strings;
+  for (int32_t i = 0; i < num_strings; ++i) {
+    strings.push_back("https://www.example.com/products/category_" +
+                      std::to_string(i % 50) + "/item?id=" + std::to_string(i));
+  }
+  const auto check_dict = [&strings](StringDictionary& string_dict) {
+    ASSERT_TRUE(string_dict.isCompressed());
+    for (size_t i = 0; i < strings.size(); ++i) {
+      ASSERT_EQ(strings[i], string_dict.getString(i));
+      ASSERT_EQ(static_cast<int32_t>(i), string_dict.getIdOfString(strings[i]));
+    }
+    std::vector<int32_t> expected_like_ids;
+    for (int32_t i = 7; i < num_strings; i += 50) {
+      expected_like_ids.push_back(i);
+    }
+    ASSERT_EQ(expected_like_ids,
+              string_dict.getLike("%category_7/%", false, false, '\\', num_strings));
+    std::vector<int32_t> expected_le_ids;
+    for (size_t i = 0; i < strings.size(); ++i) {
+      if (strings[i] <= strings[1]) {
+        expected_le_ids.push_back(i);
+      }
+    }
+    ASSERT_EQ(expected_le_ids, get_sorted_compare(string_dict, strings[1], "<="));
+  };
+  const bool enable_stringdict_compression = g_enable_stringdict_compression;
+  g_enable_stringdict_compression = true;
+  {
+    StringDictionary string_dict(BASE_PATH, false, false, g_cache_string_hash);
+    std::vector<int32_t> string_ids(num_strings);
+    string_dict.getOrAddBulk(strings, string_ids.data());
+    for (int32_t i = 0; i < num_strings; ++i) {
+      ASSERT_EQ(i, string_ids[i]);
+    }
+    check_dict(string_dict);
+    ASSERT_EQ(num_strings, string_dict.getOrAdd("https://www.example.com/new"));
+    strings.push_back("https://www.example.com/new");
+    ASSERT_TRUE(string_dict.checkpoint());
+  }
+  // a compressed dictionary stays compressed
+  g_enable_stringdict_compression = false;
+  auto string_dict =
+      std::make_shared<StringDictionary>(BASE_PATH, false, true, g_cache_string_hash);
+  check_dict(*string_dict);
+  StringDictionaryProxy string_dict_proxy(string_dict, string_dict->storageEntryCount());
+  const auto string_bytes = string_dict_proxy.getStringBytes(1);
+  ASSERT_EQ(strings[1], std::string(string_bytes.first, string_bytes.second));
+  g_enable_stringdict_compression = enable_stringdict_compression;
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
 
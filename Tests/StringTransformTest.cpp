@@ -19,6 +19,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
 TEST(StringTransform, CsvQuote) {
   std::vector<std::pair<std::string, std::string>> qa_pairs{
       {"", "\"\""},
@@ -167,6 +171,43 @@ TEST(StringTransform, Split) {
   }
 }
 
+TEST(StringTransform, ParseInt) {
+  ASSERT_EQ(parse_int64("-9223372036854775808"), std::numeric_limits<int64_t>::min());
+  ASSERT_EQ(parse_int("2147483647"), std::numeric_limits<int32_t>::max());
+  // the strings std::from_chars() does not take are parsed by std::stoi()/std::stoll()
+  ASSERT_EQ(parse_int(" +12"), 12);
+  ASSERT_EQ(parse_int64("12abc"), 12);
+  ASSERT_THROW(parse_int("2147483648"), std::out_of_range);
+  ASSERT_THROW(parse_int64("abc"), std::invalid_argument);
+}
+
+TEST(StringTransform, ParseDoubleFast) {
+  for (const std::string str : {"0",
+                                "-0",
+                                "1.5",
+                                "-12.5e3",
+                                ".25",
+                                "3.",
+                                "123456789012345",
+                                "0.1",
+                                "1e22",
+                                "1E-22",
+                                "-7e+2",
+                                "4.35"}) {
+    double value;
+    ASSERT_TRUE(parse_double_fast(str, value)) << str;
+    ASSERT_EQ(value, std::strtod(str.c_str(), nullptr)) << str;
+    ASSERT_EQ(std::signbit(value), str[0] == '-') << str;
+  }
+  // strtod() has to round these itself
+  for (const std::string str : {
+           "", "-", ".", "1e", "1e23", "1234567890123456", "1.5x", " 1", "+1", "nan"}) {
+    double value{42};
+    ASSERT_FALSE(parse_double_fast(str, value)) << str;
+    ASSERT_EQ(value, 42) << str;
+  }
+}
+
 int main(int argc, char* argv[]) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   ::testing::InitGoogleTest(&argc, argv);
@@ -20,6 +20,7 @@
 
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/scope.h"
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -28,6 +29,7 @@
 using QR = QueryRunner::QueryRunner;
 
 extern bool g_enable_table_functions;
+extern size_t g_table_function_partition_rows;
 namespace {
 
 inline void run_ddl_statement(const std::string& stmt) {
@@ -203,6 +205,30 @@ TEST_F(RowCopierTableFunction, CallFailure) {
   }
 }
 
+TEST_F(RowCopierTableFunction, PartitionedRowAdder) {
+  ScopeGuard reset = [orig = g_table_function_partition_rows] {
+    g_table_function_partition_rows = orig;
+  };
+  // the 5 rows run on slices of 2 rows, if there are enough CPU threads
+  for (size_t partition_rows : {size_t(0), size_t(2)}) {
+    g_table_function_partition_rows = partition_rows;
+    for (int multiplier = 1; multiplier <= 3; ++multiplier) {
+      const auto rows = run_multiple_agg(
+          "SELECT out0, COUNT(*) FROM TABLE(row_adder(cursor(SELECT d, CAST(x AS DOUBLE) "
+          "FROM tf_test), " +
+              std::to_string(multiplier) + ")) GROUP BY out0 ORDER BY out0;",
+          ExecutorDeviceType::CPU);
+      ASSERT_EQ(rows->rowCount(), size_t(5));
+      for (size_t i = 0; i < 5; i++) {
+        auto crt_row = rows->getNextRow(false, false);
+        ASSERT_EQ(crt_row.size(), size_t(2));
+        ASSERT_NEAR(TestHelpers::v<double>(crt_row[0]), i * 2.1, 1e-6);
+        ASSERT_EQ(TestHelpers::v<int64_t>(crt_row[1]), multiplier);
+      }
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
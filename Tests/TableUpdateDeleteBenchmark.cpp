@@ -32,6 +32,8 @@
 
 using QR = QueryRunner::QueryRunner;
 
+extern bool g_enable_columnar_update;
+
 std::once_flag setup_flag;
 void global_setup() {
   TestHelpers::init_logger_stderr_only();
@@ -175,6 +177,26 @@ BENCHMARK_REGISTER_F(UpdateFixture, DictEncodedStrUpdateTest)
     ->UseRealTime()
     ->Unit(benchmark::kMillisecond);
 
+//! Run a multi column update query of every row, with the columnar update path
+//! (state.range(1) = 1) and with the row by row conversion (state.range(1) = 0)
+BENCHMARK_DEFINE_F(UpdateFixture, WideUpdateTest)(benchmark::State& state) {
+  const bool enable_columnar_update = g_enable_columnar_update;
+  g_enable_columnar_update = state.range(1);
+  for (auto _ : state) {
+    run_multiple_agg(
+        "UPDATE update_bench_1 SET x = x + 1, y = y * 2, z = NOT z, str = str;",
+        ExecutorDeviceType::CPU);
+  }
+  g_enable_columnar_update = enable_columnar_update;
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(UpdateFixture, WideUpdateTest)
+    ->Ranges({{100, 1000000}, {0, 1}})
+    ->MeasureProcessCPUTime()
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
 
 class TempTableUpdateFixture : public benchmark::Fixture {
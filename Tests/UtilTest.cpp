@@ -15,6 +15,9 @@
  */
 
 #include "Shared/Intervals.h"
+#include "Shared/Metrics.h"
+#include "Shared/crc32c.h"
+#include "Shared/threadpool.h"
 #include "TestHelpers.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
@@ -25,6 +28,8 @@
 #include <array>
 #include <atomic>
 #include <future>
+#include <thread>
+#include <vector>
 
 // for (auto const interval : makeIntervals(0, M, n_workers)) {...}
 // iterates over interval={begin,end} pairs which satisfy:
@@ -147,6 +152,142 @@ TEST(Shared, IntervalsInvalidBounds) {
   EXPECT_TRUE(loop_body_executed);
 }
 
+TEST(Shared, WorkStealingThreadPool) {
+  constexpr int num_tasks = 1000;
+  std::atomic<int> counter{0};
+  threadpool::WorkStealingThreadPool<void> thread_pool;
+  for (int i = 0; i < num_tasks; ++i) {
+    thread_pool.spawn([&counter](const int increment) { counter += increment; }, 1);
+  }
+  thread_pool.join();
+  EXPECT_EQ(counter, num_tasks);
+
+  threadpool::WorkStealingThreadPool<int> result_pool;
+  for (int i = 0; i < 10; ++i) {
+    result_pool.spawn([](const int x) { return x * x; }, i);
+  }
+  const auto results = result_pool.join();
+  ASSERT_EQ(results.size(), size_t(10));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(results[i], i * i);
+  }
+}
+
+TEST(Shared, WorkStealingThreadPoolNested) {
+  // tasks spawning and joining their own pools must not deadlock, even with every
+  // worker blocked in join
+  std::atomic<int> counter{0};
+  threadpool::WorkStealingThreadPool<void> outer_pool;
+  const int num_outer_tasks =
+      2 * static_cast<int>(threadpool::WorkStealingScheduler::instance().workerCount());
+  for (int i = 0; i < num_outer_tasks; ++i) {
+    outer_pool.spawn(
+        [&counter](const int num_inner_tasks) {
+          threadpool::WorkStealingThreadPool<void> inner_pool;
+          for (int j = 0; j < num_inner_tasks; ++j) {
+            inner_pool.spawn([&counter](const int) { ++counter; }, j);
+          }
+          inner_pool.join();
+        },
+        10);
+  }
+  outer_pool.join();
+  EXPECT_EQ(counter, num_outer_tasks * 10);
+}
+
+TEST(Shared, WorkStealingThreadPoolException) {
+  threadpool::WorkStealingThreadPool<void> thread_pool;
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 10; ++i) {
+    thread_pool.spawn(
+        [&counter](const int idx) {
+          if (idx == 5) {
+            throw std::runtime_error("task failed");
+          }
+          ++counter;
+        },
+        i);
+  }
+  EXPECT_THROW(thread_pool.join(), std::runtime_error);
+  EXPECT_EQ(counter, 9);
+}
+
+TEST(Shared, Crc32c) {
+  const std::string check_input{"123456789"};
+  ASSERT_EQ(crc32c::value(reinterpret_cast<const int8_t*>(check_input.data()),
+                          check_input.size()),
+            0xe3069283u);
+  ASSERT_EQ(crc32c::value(nullptr, 0), 0u);
+
+  // extending in pieces, across unaligned boundaries, gives the same checksum
+  std::vector<int8_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int8_t>(i * 31);
+  }
+  const auto crc = crc32c::value(data.data(), data.size());
+  for (const size_t split : {1, 7, 8, 333, 999}) {
+    ASSERT_EQ(crc32c::extend(crc32c::value(data.data(), split),
+                             data.data() + split,
+                             data.size() - split),
+              crc);
+  }
+}
+
+TEST(Shared, MetricsCounter) {
+  auto& registry = metrics::Registry::instance();
+  auto& counter = registry.counter("test_counter_total", "A counter", {{"kind", "a"}});
+  ASSERT_EQ(&counter,
+            &registry.counter("test_counter_total", "A counter", {{"kind", "a"}}));
+  ASSERT_NE(&counter,
+            &registry.counter("test_counter_total", "A counter", {{"kind", "b"}}));
+
+  // the additions of the threads all land, whichever slots they go to
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 32; ++i) {
+    threads.emplace_back([&counter] {
+      for (size_t j = 0; j < 1000; ++j) {
+        counter.add();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(counter.value(), 32000u);
+
+  const auto text = registry.toText();
+  ASSERT_NE(text.find("# TYPE test_counter_total counter\n"), std::string::npos);
+  ASSERT_NE(text.find("test_counter_total{kind=\"a\"} 32000\n"), std::string::npos);
+  ASSERT_NE(text.find("test_counter_total{kind=\"b\"} 0\n"), std::string::npos);
+}
+
+TEST(Shared, MetricsHistogramAndCollector) {
+  auto& registry = metrics::Registry::instance();
+  auto& histogram = registry.histogram("test_seconds", "A histogram", {0.1, 1});
+  histogram.observe(0.05);
+  histogram.observe(0.1);
+  histogram.observe(0.5);
+  histogram.observe(2);
+  const auto snapshot = histogram.snapshot();
+  ASSERT_EQ(snapshot.cumulative_counts, (std::vector<uint64_t>{2, 3, 4}));
+  ASSERT_DOUBLE_EQ(snapshot.sum, 2.65);
+
+  const auto collector_id = registry.addCollector([](auto& samples) {
+    samples.push_back({"test_gauge", "A gauge", "gauge", {{"path", "a\"b"}}, 3});
+  });
+  auto text = registry.toText();
+  ASSERT_NE(text.find("test_seconds_bucket{le=\"0.1\"} 2\n"),
+            std::string::npos);
+  ASSERT_NE(text.find("test_seconds_bucket{le=\"+Inf\"} 4\n"), std::string::npos);
+  ASSERT_NE(text.find("test_seconds_count 4\n"), std::string::npos);
+  ASSERT_NE(text.find("# TYPE test_gauge gauge\n"), std::string::npos);
+  ASSERT_NE(text.find("test_gauge{path=\"a\\\"b\"} 3\n"), std::string::npos);
+
+  registry.removeCollector(collector_id);
+  text = registry.toText();
+  ASSERT_EQ(text.find("test_gauge"), std::string::npos);
+}
+
 TEST(Utils, StringLike) {
   ASSERT_TRUE(string_like("abc", 3, "abc", 3, '\\'));
   ASSERT_FALSE(string_like("abc", 3, "ABC", 3, '\\'));
@@ -207,6 +207,13 @@ void CommandLineOptions::fillOptions() {
                               ->default_value(g_from_table_reordering)
                               ->implicit_value(true),
                           "Enable automatic table reordering in FROM clause.");
+  help_desc.add_options()(
+      "from-table-reordering-filtered-counts",
+      po::value<bool>(&g_from_table_reordering_filtered_counts)
+          ->default_value(g_from_table_reordering_filtered_counts)
+          ->implicit_value(true),
+      "Count the rows of the joined tables which pass their filters to reorder the "
+      "FROM clause, instead of using the sizes of the tables.");
   help_desc.add_options()("gpu-buffer-mem-bytes",
                           po::value<size_t>(&system_parameters.gpu_buffer_mem_bytes)
                               ->default_value(system_parameters.gpu_buffer_mem_bytes),
@@ -222,11 +229,47 @@ void CommandLineOptions::fillOptions() {
           ->default_value(g_hll_precision_bits)
           ->implicit_value(g_hll_precision_bits),
       "Number of bits used from the hash value used to specify the bucket number.");
+  help_desc.add_options()(
+      "enable-sparse-hll",
+      po::value<bool>(&g_enable_sparse_hll)
+          ->default_value(g_enable_sparse_hll)
+          ->implicit_value(true),
+      "Keep the APPROX_COUNT_DISTINCT registers of the group by queries sparse on CPU "
+      "when the groups are expected to see few distinct values.");
   if (!dist_v5_) {
     help_desc.add_options()("http-port",
                             po::value<int>(&http_port)->default_value(http_port),
                             "HTTP port number.");
   }
+#ifdef ENABLE_ARROW_FLIGHT
+  help_desc.add_options()(
+      "flight-port",
+      po::value<int>(&flight_port)->default_value(flight_port),
+      "Arrow Flight port number for bulk loads and query results, 0 to disable.");
+#endif
+  help_desc.add_options()(
+      "metrics-port",
+      po::value<int>(&metrics_port)->default_value(metrics_port),
+      "Port of the HTTP endpoint the Prometheus metrics are scraped from, 0 to disable.");
+#ifdef ENABLE_THRIFT_NONBLOCKING_SERVER
+  help_desc.add_options()(
+      "nonblocking-thrift-server",
+      po::value<bool>(&nonblocking_thrift_server)
+          ->default_value(nonblocking_thrift_server)
+          ->implicit_value(true),
+      "Serve the binary Thrift port from a few event driven I/O threads, which hand the "
+      "calls to a bounded pool of worker threads, instead of from a thread per "
+      "connection. The clients of the port must use the framed transport.");
+  help_desc.add_options()(
+      "num-thrift-io-threads",
+      po::value<size_t>(&num_thrift_io_threads)->default_value(num_thrift_io_threads),
+      "Number of I/O threads of the nonblocking Thrift server.");
+  help_desc.add_options()("num-thrift-worker-threads",
+                          po::value<size_t>(&num_thrift_worker_threads)
+                              ->default_value(num_thrift_worker_threads),
+                          "Number of threads the nonblocking Thrift server runs the "
+                          "calls on, 0 for one per hardware thread and 16 at least.");
+#endif
   help_desc.add_options()(
       "idle-session-duration",
       po::value<int>(&idle_session_duration)->default_value(idle_session_duration),
@@ -257,6 +300,45 @@ void CommandLineOptions::fillOptions() {
       po::value<size_t>(&g_overlaps_max_table_size_bytes)
           ->default_value(g_overlaps_max_table_size_bytes),
       "The maximum size in bytes of the hash table for an overlaps hash join.");
+  developer_desc.add_options()(
+      "overlaps-auto-tuner-sample-rows",
+      po::value<size_t>(&g_overlaps_auto_tuner_sample_rows)
+          ->default_value(g_overlaps_auto_tuner_sample_rows),
+      "Rows of the inner table the overlaps join auto-tuner estimates the sizes of the "
+      "CPU hash tables from, 0 to use all of them.");
+  help_desc.add_options()(
+      "join-hash-table-cache-bytes",
+      po::value<size_t>(&g_join_hash_table_cache_bytes)
+          ->default_value(g_join_hash_table_cache_bytes),
+      "The size in bytes of the CPU join hash tables kept for later queries, each kind "
+      "of hash table evicting its least recently used ones beyond it.");
+  developer_desc.add_options()(
+      "enable-parallel-join-hash-table-build",
+      po::value<bool>(&g_enable_parallel_join_hash_table_build)
+          ->default_value(g_enable_parallel_join_hash_table_build)
+          ->implicit_value(true),
+      "Build the hash tables of the inner join levels of a query concurrently.");
+  developer_desc.add_options()(
+      "enable-join-hash-table-peer-copy",
+      po::value<bool>(&g_enable_join_hash_table_peer_copy)
+          ->default_value(g_enable_join_hash_table_peer_copy)
+          ->implicit_value(true),
+      "Build the replicated perfect join hash tables on the first GPU only and copy "
+      "them to the other GPUs device to device.");
+  developer_desc.add_options()(
+      "enable-partitioned-sharded-joins",
+      po::value<bool>(&g_enable_partitioned_sharded_joins)
+          ->default_value(g_enable_partitioned_sharded_joins)
+          ->implicit_value(true),
+      "Join the tables sharded on the join key shard by shard across the GPUs also when "
+      "a GPU holds several fragments of the inner table, instead of copying the whole "
+      "inner table to every GPU.");
+  developer_desc.add_options()(
+      "baseline-hash-join-partition-bytes",
+      po::value<size_t>(&g_baseline_hash_join_partition_bytes)
+          ->default_value(g_baseline_hash_join_partition_bytes),
+      "The size of the partitions of the slots which large CPU baseline hash join tables "
+      "are filled by, 0 to fill them directly.");
   if (!dist_v5_) {
     help_desc.add_options()("port,p",
                             po::value<int>(&system_parameters.omnisci_server_port)
@@ -326,6 +408,11 @@ void CommandLineOptions::fillOptions() {
       "disk-cache-entry-limit",
       po::value<std::size_t>(&(disk_cache_config.entry_limit))->default_value(1024),
       "Specify the size of the the disk cache.");
+  help_desc.add_options()(
+      "disk-cache-size-limit",
+      po::value<std::size_t>(&(disk_cache_config.size_limit))
+          ->default_value(disk_cache_config.size_limit),
+      "Specify the maximum number of bytes of chunks in the disk cache, 0 for no limit.");
 #endif  // ENABLE_FSI
   help_desc.add_options()(
       "enable-interoperability",
@@ -338,6 +425,14 @@ void CommandLineOptions::fillOptions() {
                               ->default_value(g_enable_union)
                               ->implicit_value(true),
                           "Enable UNION ALL SQL clause.");
+  help_desc.add_options()(
+      "enable-parallel-union-branches",
+      po::value<bool>(&g_enable_parallel_union_branches)
+          ->default_value(g_enable_parallel_union_branches)
+          ->implicit_value(true),
+      "Execute the UNION ALL branches which only read tables concurrently, each on an "
+      "executor of its own. Their kernels only overlap with "
+      "enable-concurrent-query-execution.");
   help_desc.add_options()(
       "calcite-service-timeout",
       po::value<size_t>(&system_parameters.calcite_timeout)
@@ -355,6 +450,13 @@ void CommandLineOptions::fillOptions() {
           ->default_value(g_enable_stringdict_parallel)
           ->implicit_value(true),
       "Allow StringDictionary to parallelize loads using multiple threads");
+  help_desc.add_options()(
+      "enable-stringdict-compression",
+      po::value<bool>(&g_enable_stringdict_compression)
+          ->default_value(g_enable_stringdict_compression)
+          ->implicit_value(true),
+      "Store the strings of new dictionaries compressed with a symbol table learned from "
+      "their first strings.");
   help_desc.add_options()("log-user-origin",
                           po::value<bool>(&log_user_origin)
                               ->default_value(log_user_origin)
@@ -379,6 +481,122 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_enable_columnar_output)
           ->implicit_value(true),
       "Enable columnar output for intermediate/final query steps.");
+  developer_desc.add_options()(
+      "enable-jit-host-cpu-features",
+      po::value<bool>(&g_enable_jit_host_cpu_features)
+          ->default_value(g_enable_jit_host_cpu_features)
+          ->implicit_value(true),
+      "Generate CPU code for the instruction set extensions of the host, e.g. AVX2 or "
+      "AVX-512, instead of the baseline x86-64 ISA.");
+  developer_desc.add_options()(
+      "enable-cpu-loop-vectorization",
+      po::value<bool>(&g_enable_cpu_loop_vectorization)
+          ->default_value(g_enable_cpu_loop_vectorization)
+          ->implicit_value(true),
+      "Run the LLVM loop and SLP vectorizers on the row loop of CPU queries, which "
+      "processes a vector of rows per iteration when the filters and aggregates allow.");
+  developer_desc.add_options()(
+      "enable-calcite-plan-cache",
+      po::value<bool>(&g_enable_calcite_plan_cache)
+          ->default_value(g_enable_calcite_plan_cache)
+          ->implicit_value(true),
+      "Reuse the Calcite plan of the queries which differ only in their literals, with "
+      "the literals of each query rebound into the plan.");
+  developer_desc.add_options()(
+      "calcite-plan-cache-size",
+      po::value<size_t>(&g_calcite_plan_cache_size)
+          ->default_value(g_calcite_plan_cache_size),
+      "Maximum number of query shapes in the Calcite plan cache.");
+  developer_desc.add_options()(
+      "enable-parallel-cpu-code-generation",
+      po::value<bool>(&g_enable_parallel_cpu_code_generation)
+          ->default_value(g_enable_parallel_cpu_code_generation)
+          ->implicit_value(true),
+      "Generate the machine code of CPU queries outside of the compilation lock, in an "
+      "LLVM context of each query, so that it overlaps with the compilation of the "
+      "next queries and the fetching of the chunks.");
+  developer_desc.add_options()(
+      "enable-tiered-cpu-compilation",
+      po::value<bool>(&g_enable_tiered_cpu_compilation)
+          ->default_value(g_enable_tiered_cpu_compilation)
+          ->implicit_value(true),
+      "Run the new CPU queries on small inputs with quickly compiled code, while their "
+      "optimized code is generated in the background for the following runs.");
+  developer_desc.add_options()(
+      "tiered-cpu-compilation-max-rows",
+      po::value<size_t>(&g_tiered_cpu_compilation_max_rows)
+          ->default_value(g_tiered_cpu_compilation_max_rows),
+      "Maximum number of input rows of the queries compiled in tiers.");
+  developer_desc.add_options()(
+      "enable-jit-object-cache",
+      po::value<bool>(&g_enable_jit_object_cache)
+          ->default_value(g_enable_jit_object_cache)
+          ->implicit_value(true),
+      "Keep the compiled CPU objects and GPU PTX of the queries on disk, so that a "
+      "restarted server doesn't generate the code of the queries it has seen again.");
+  developer_desc.add_options()(
+      "jit-object-cache-path",
+      po::value<std::string>(&g_jit_object_cache_path),
+      "Directory of the JIT object cache, <data directory>/omnisci_jit_cache by "
+      "default.");
+  developer_desc.add_options()(
+      "jit-object-cache-entry-limit",
+      po::value<size_t>(&g_jit_object_cache_entry_limit)
+          ->default_value(g_jit_object_cache_entry_limit),
+      "Maximum number of files in the JIT object cache, past which the least recently "
+      "used ones are removed.");
+  developer_desc.add_options()(
+      "enable-result-set-cache",
+      po::value<bool>(&g_enable_result_set_cache)
+          ->default_value(g_enable_result_set_cache)
+          ->implicit_value(true),
+      "Keep the results of the queries, which are returned for the same plan while the "
+      "tables it reads have not changed.");
+  developer_desc.add_options()(
+      "result-set-cache-bytes",
+      po::value<size_t>(&g_result_set_cache_bytes)
+          ->default_value(g_result_set_cache_bytes),
+      "The size in bytes of the query results kept, the least recently used ones being "
+      "evicted beyond it.");
+  developer_desc.add_options()(
+      "enable-fragment-result-cache",
+      po::value<bool>(&g_enable_fragment_result_cache)
+          ->default_value(g_enable_fragment_result_cache)
+          ->implicit_value(true),
+      "Keep the results of the CPU kernels of the aggregates over a single table, so "
+      "that a query run again only aggregates the fragments which changed since.");
+  developer_desc.add_options()(
+      "fragment-result-cache-bytes",
+      po::value<size_t>(&g_fragment_result_cache_bytes)
+          ->default_value(g_fragment_result_cache_bytes),
+      "The size in bytes of the fragment results kept, the least recently used ones "
+      "being evicted beyond it.");
+  developer_desc.add_options()(
+      "enable-host-buffer-pool",
+      po::value<bool>(&g_enable_host_buffer_pool)
+          ->default_value(g_enable_host_buffer_pool)
+          ->implicit_value(true),
+      "Keep the host blocks of the output and scratch buffers of the queries once they "
+      "are done, for the next queries to reuse instead of mapping new pages.");
+  developer_desc.add_options()(
+      "host-buffer-pool-bytes",
+      po::value<size_t>(&g_host_buffer_pool_bytes)
+          ->default_value(g_host_buffer_pool_bytes),
+      "The size in bytes of the free host blocks kept, the blocks given back beyond it "
+      "being freed.");
+  developer_desc.add_options()(
+      "enable-gpu-scratch-pool",
+      po::value<bool>(&g_enable_gpu_scratch_pool)
+          ->default_value(g_enable_gpu_scratch_pool)
+          ->implicit_value(true),
+      "Keep the GPU scratch buffers of the sorts and the kernels once they are done, for "
+      "the next ones to reuse instead of allocating from the GPU buffer pool.");
+  developer_desc.add_options()(
+      "gpu-scratch-pool-bytes",
+      po::value<size_t>(&g_gpu_scratch_pool_bytes)
+          ->default_value(g_gpu_scratch_pool_bytes),
+      "The size in bytes of the free GPU scratch buffers kept per device, at most a "
+      "quarter of its GPU buffer pool.");
   developer_desc.add_options()("enable-legacy-syntax",
                                po::value<bool>(&enable_legacy_syntax)
                                    ->default_value(enable_legacy_syntax)
@@ -400,6 +618,165 @@ void CommandLineOptions::fillAdvancedOptions() {
                                po::value<int>(&system_parameters.num_executors)
                                    ->default_value(system_parameters.num_executors),
                                "Number of executors to run in parallel.");
+  developer_desc.add_options()(
+      "enable-concurrent-query-execution",
+      po::value<bool>(&g_enable_concurrent_query_execution)
+          ->default_value(g_enable_concurrent_query_execution)
+          ->implicit_value(true),
+      "Allow kernels from queries running on different executors to execute "
+      "concurrently. CPU threads and GPU devices are handed out by a shared resource "
+      "pool instead of a single exclusive kernel lock. Requires num-executors > 1.");
+  developer_desc.add_options()(
+      "enable-chunk-prefetch",
+      po::value<bool>(&g_enable_chunk_prefetch)
+          ->default_value(g_enable_chunk_prefetch)
+          ->implicit_value(true),
+      "Load the input chunks of GPU kernels from disk into the CPU buffer pool in the "
+      "background, overlapping disk reads with the execution of preceding kernels.");
+  developer_desc.add_options()(
+      "enable-deferred-lazy-fetch",
+      po::value<bool>(&g_enable_deferred_lazy_fetch)
+          ->default_value(g_enable_deferred_lazy_fetch)
+          ->implicit_value(true),
+      "Leave the chunks of the projected columns the kernels don't read to the results, "
+      "which only fetch them for the fragments of the rows past the filters and limits.");
+  developer_desc.add_options()(
+      "enable-query-admission-control",
+      po::value<bool>(&g_enable_query_admission_control)
+          ->default_value(g_enable_query_admission_control)
+          ->implicit_value(true),
+      "Estimate the buffer pool footprint of a query step from its output buffers and "
+      "fragment metadata before launching kernels. Queries are queued until their "
+      "footprint fits next to running queries, and moved to CPU (if allow-cpu-retry is "
+      "enabled) when they can never fit on the GPU.");
+  developer_desc.add_options()(
+      "high-priority-users",
+      po::value<std::string>(&g_high_priority_users)
+          ->default_value(g_high_priority_users),
+      "Comma separated users whose queries get twice the share of the executors and of "
+      "the kernel resources of the normal queries, and 8 times the share of the low "
+      "priority ones, when they wait for them.");
+  developer_desc.add_options()(
+      "low-priority-users",
+      po::value<std::string>(&g_low_priority_users)->default_value(g_low_priority_users),
+      "Comma separated users whose queries, e.g. ETL jobs, get a quarter of the share of "
+      "the executors and of the kernel resources of the normal queries when they wait "
+      "for them.");
+  developer_desc.add_options()(
+      "enable-cpu-sub-fragment-kernels",
+      po::value<bool>(&g_enable_cpu_sub_fragment_kernels)
+          ->default_value(g_enable_cpu_sub_fragment_kernels)
+          ->implicit_value(true),
+      "Split large fragments into several kernels for aggregate and group by queries "
+      "running on CPU, so tables with few fragments can use all available threads.");
+  developer_desc.add_options()(
+      "cpu-sub-fragment-size",
+      po::value<size_t>(&g_cpu_sub_fragment_size)->default_value(g_cpu_sub_fragment_size),
+      "Maximum number of rows processed by a single CPU sub-fragment kernel. Requires "
+      "enable-cpu-sub-fragment-kernels.");
+  developer_desc.add_options()(
+      "enable-hybrid-execution",
+      po::value<bool>(&g_enable_hybrid_execution)
+          ->default_value(g_enable_hybrid_execution)
+          ->implicit_value(true),
+      "Run part of the fragments of single table GPU queries in CPU kernels, so the "
+      "cores don't sit idle during GPU queries. The share of the CPU kernels follows "
+      "the throughput measured for the former hybrid queries.");
+  developer_desc.add_options()(
+      "enable-gpu-streaming",
+      po::value<bool>(&g_enable_gpu_streaming)
+          ->default_value(g_enable_gpu_streaming)
+          ->implicit_value(true),
+      "Run the fragments of GPU queries whose inputs exceed the device memory in waves "
+      "of kernels which fit it, instead of retrying the queries on CPU. Each wave "
+      "releases its input chunks when it finishes, and the chunks of the next one are "
+      "loaded into the CPU buffer pool meanwhile.");
+  developer_desc.add_options()(
+      "gpu-streams-per-device",
+      po::value<size_t>(&g_gpu_streams_per_device)
+          ->default_value(g_gpu_streams_per_device),
+      "Number of the kernels of an executor which may run at the same time on a GPU, "
+      "each on a CUDA stream of its own (at most 32). Light queries then share the "
+      "device instead of waiting for each other. The kernels run one at a time when the "
+      "dynamic watchdog or the runtime query interrupt is enabled.");
+  developer_desc.add_options()(
+      "enable-group-by-buffer-spill",
+      po::value<bool>(&g_enable_group_by_buffer_spill)
+          ->default_value(g_enable_group_by_buffer_spill)
+          ->implicit_value(true),
+      "Let the CPU kernels of the baseline hash group by queries go on with a fresh "
+      "buffer when theirs is full, the buffers being reduced together, instead of "
+      "running the query again with a larger buffer.");
+  developer_desc.add_options()(
+      "enable-semi-join",
+      po::value<bool>(&g_enable_semi_join)
+          ->default_value(g_enable_semi_join)
+          ->implicit_value(true),
+      "Execute the 'column IN (subquery)' filters on integer columns as semi joins on a "
+      "hash table of the subquery results instead of as IN value lists.");
+  developer_desc.add_options()(
+      "statistics-sample-rows",
+      po::value<size_t>(&g_statistics_sample_rows)
+          ->default_value(g_statistics_sample_rows),
+      "Number of the values of a column ANALYZE TABLE samples uniformly for its "
+      "histogram and its most common values. The number of distinct values is estimated "
+      "from all the values.");
+  developer_desc.add_options()(
+      "enable-device-cost-model",
+      po::value<bool>(&g_enable_device_cost_model)
+          ->default_value(g_enable_device_cost_model)
+          ->implicit_value(true),
+      "Run the steps of GPU mode queries on CPU when the cost model calibrated at "
+      "startup estimates them to be faster there, from the PCIe bandwidth, the kernel "
+      "launch latency, the scan rates and the chunks already in the GPU buffer pool.");
+  developer_desc.add_options()(
+      "enable-predictive-watchdog",
+      po::value<bool>(&g_enable_predictive_watchdog)
+          ->default_value(g_enable_predictive_watchdog)
+          ->implicit_value(true),
+      "Reject the query steps estimated to run over the dynamic watchdog time limit from "
+      "the bytes of their input and the scan rates of the former steps, before they "
+      "run. The GPU steps estimated over it, or which don't fit in the GPU buffer pool, "
+      "run on CPU instead when they are not estimated over it there.");
+  developer_desc.add_options()(
+      "enable-block-zone-maps",
+      po::value<bool>(&g_enable_block_zone_maps)
+          ->default_value(g_enable_block_zone_maps)
+          ->implicit_value(true),
+      "Keep min/max statistics per block of rows of integer and time chunks, and skip "
+      "the blocks ruled out by range filters when scanning a fragment on CPU.");
+  developer_desc.add_options()(
+      "enable-top-n-fragment-skipping",
+      po::value<bool>(&g_enable_top_n_fragment_skipping)
+          ->default_value(g_enable_top_n_fragment_skipping)
+          ->implicit_value(true),
+      "Skip the fragments of a CPU ORDER BY ... LIMIT projection whose metadata shows "
+      "they can't reach the top rows of the fragments already scanned.");
+  developer_desc.add_options()(
+      "block-zone-map-rows",
+      po::value<size_t>(&g_block_zone_map_rows)->default_value(g_block_zone_map_rows),
+      "Number of rows per block of the block zone maps. Requires "
+      "enable-block-zone-maps.");
+  developer_desc.add_options()(
+      "bloom-filter-bits-per-value",
+      po::value<size_t>(&g_bloom_filter_bits_per_value)
+          ->default_value(g_bloom_filter_bits_per_value),
+      "Size of the Bloom filters of the chunks of the columns of a table's BLOOM_FILTER "
+      "option, in bits per row. 10 bits give a few percent false positives, 0 disables "
+      "building new filters.");
+  developer_desc.add_options()(
+      "enable-parallel-column-appends",
+      po::value<bool>(&g_enable_parallel_column_appends)
+          ->default_value(g_enable_parallel_column_appends)
+          ->implicit_value(true),
+      "Append the columns of large inserts to the chunks of a fragment in parallel.");
+  developer_desc.add_options()(
+      "enable-parquet-dictionary-bloom-filters",
+      po::value<bool>(&g_enable_parquet_dictionary_bloom_filters)
+          ->default_value(g_enable_parquet_dictionary_bloom_filters)
+          ->implicit_value(true),
+      "Build Bloom filters of the integer columns of Parquet foreign tables from the "
+      "dictionary pages of the files, when fetching the chunk metadata.");
   developer_desc.add_options()(
       "gpu-shared-mem-threshold",
       po::value<size_t>(&g_gpu_smem_threshold)->default_value(g_gpu_smem_threshold),
@@ -417,12 +794,33 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_enable_smem_non_grouped_agg)
           ->implicit_value(true),
       "Enable using GPU shared memory for non-grouped aggregate queries.");
+  developer_desc.add_options()(
+      "enable-shared-mem-baseline-group-by",
+      po::value<bool>(&g_enable_smem_baseline_group_by)
+          ->default_value(g_enable_smem_baseline_group_by)
+          ->implicit_value(true),
+      "Enable aggregating the baseline hash GROUP BY queries in a hash table in the GPU "
+      "shared memory of each block first, spilling to the global memory once it fills "
+      "up.");
+  developer_desc.add_options()(
+      "enable-shared-mem-join-hash-table",
+      po::value<bool>(&g_enable_smem_join_hash_table)
+          ->default_value(g_enable_smem_join_hash_table)
+          ->implicit_value(true),
+      "Enable probing a perfect join hash table small enough for the GPU shared memory "
+      "of the blocks from it.");
   developer_desc.add_options()("enable-direct-columnarization",
                                po::value<bool>(&g_enable_direct_columnarization)
                                    ->default_value(g_enable_direct_columnarization)
                                    ->implicit_value(true),
                                "Enables/disables a more optimized columnarization method "
                                "for intermediate steps in multi-step queries.");
+  developer_desc.add_options()("enable-columnar-ctas",
+                               po::value<bool>(&g_enable_columnar_ctas)
+                                   ->default_value(g_enable_columnar_ctas)
+                                   ->implicit_value(true),
+                               "Copy the results of CTAS and INSERT INTO ... SELECT "
+                               "column by column when their types match the table.");
   developer_desc.add_options()(
       "offset-device-by-table-id",
       po::value<bool>(&g_use_table_device_offset)
@@ -435,11 +833,38 @@ void CommandLineOptions::fillAdvancedOptions() {
                                    ->default_value(g_enable_window_functions)
                                    ->implicit_value(true),
                                "Enable experimental window function support.");
+  developer_desc.add_options()(
+      "enable-window-function-gpu-sort",
+      po::value<bool>(&g_enable_window_function_gpu_sort)
+          ->default_value(g_enable_window_function_gpu_sort)
+          ->implicit_value(true),
+      "Sort the partitions of the window functions on the GPU for the queries which "
+      "run on it.");
   developer_desc.add_options()("enable-table-functions",
                                po::value<bool>(&g_enable_table_functions)
                                    ->default_value(g_enable_table_functions)
                                    ->implicit_value(true),
                                "Enable experimental table functions support.");
+  developer_desc.add_options()(
+      "table-function-partition-rows",
+      po::value<size_t>(&g_table_function_partition_rows)
+          ->default_value(g_table_function_partition_rows),
+      "The minimum number of input rows of each slice the CPU runs a partitionable "
+      "table function on concurrently, 0 to run all of them on a single thread.");
+  developer_desc.add_options()(
+      "enable-interpreted-interop",
+      po::value<bool>(&g_enable_interpreted_interop)
+          ->default_value(g_enable_interpreted_interop)
+          ->implicit_value(true),
+      "Interpret the query steps the code generator can't compile on all the CPU "
+      "threads, and offload to SQLite only the steps the interpreter doesn't handle.");
+  developer_desc.add_options()(
+      "enable-datetrunc-bucket-tables",
+      po::value<bool>(&g_enable_datetrunc_bucket_tables)
+          ->default_value(g_enable_datetrunc_bucket_tables)
+          ->implicit_value(true),
+      "Truncate the timestamps to months and longer units with a search of the buckets "
+      "of the range of their column instead of the calendar math.");
   developer_desc.add_options()(
       "jit-debug-ir",
       po::value<bool>(&jit_debug)->default_value(jit_debug)->implicit_value(true),
@@ -453,12 +878,34 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(intel_jit_profile)
           ->implicit_value(true),
       "Enable runtime support for the JIT code profiling using Intel VTune.");
+  developer_desc.add_options()(
+      "enable-jit-perf-map",
+      po::value<bool>(&g_enable_jit_perf_map)
+          ->default_value(g_enable_jit_perf_map)
+          ->implicit_value(true),
+      "Write the addresses of the generated CPU functions to /tmp/perf-<pid>.map, "
+      "labeled by the fingerprint of their query, for perf to resolve them.");
+  developer_desc.add_options()(
+      "enable-jit-gdb-registration",
+      po::value<bool>(&g_enable_jit_gdb_registration)
+          ->default_value(g_enable_jit_gdb_registration)
+          ->implicit_value(true),
+      "Register the generated CPU code with the JIT interface of GDB, for the "
+      "debuggers and profilers to see its symbols.");
   developer_desc.add_options()(
       "enable-modern-thread-pool",
       po::value<bool>(&g_use_tbb_pool)
           ->default_value(g_use_tbb_pool)
           ->implicit_value(true),
       "Enable a new thread pool implementation for queuing kernels for execution.");
+  developer_desc.add_options()(
+      "enable-work-stealing-thread-pool",
+      po::value<bool>(&g_use_work_stealing_pool)
+          ->default_value(g_use_work_stealing_pool)
+          ->implicit_value(true),
+      "Dispatch kernels to a persistent work stealing thread pool. Idle workers steal "
+      "queued kernels from busy ones, which evens out fragments of uneven size. Takes "
+      "precedence over enable-modern-thread-pool.");
   developer_desc.add_options()(
       "skip-intermediate-count",
       po::value<bool>(&g_skip_intermediate_count)
@@ -486,6 +933,254 @@ void CommandLineOptions::fillAdvancedOptions() {
       "there is not enough free memory to accomodate the target slab size, smaller "
       "slabs will be allocated, down to the minimum size specified by "
       "min-cpu-slab-size.");
+  developer_desc.add_options()(
+      "pinned-cpu-buffer-pool",
+      po::value<bool>(&system_parameters.pinned_cpu_buffer_pool)
+          ->default_value(system_parameters.pinned_cpu_buffer_pool)
+          ->implicit_value(true),
+      "Allocate CPU buffer pool slabs as CUDA pinned host memory to speed up CPU to GPU "
+      "chunk transfers. Ignored when running without GPUs.");
+  developer_desc.add_options()(
+      "numa-aware-cpu-buffer-pool",
+      po::value<bool>(&system_parameters.numa_aware_cpu_buffer_pool)
+          ->default_value(system_parameters.numa_aware_cpu_buffer_pool)
+          ->implicit_value(true),
+      "Bind CPU buffer pool slabs to NUMA nodes, place each fragment's chunks on node "
+      "(fragment id % number of nodes) and run CPU kernels on threads pinned to the node "
+      "holding their fragment. No effect on single node systems.");
+  developer_desc.add_options()(
+      "cpu-buffer-eviction-policy",
+      po::value<std::string>(&system_parameters.cpu_buffer_eviction_policy)
+          ->default_value(system_parameters.cpu_buffer_eviction_policy),
+      "Eviction policy for the CPU buffer pool: lru, or lru2 which keeps chunks touched "
+      "more than once resident ahead of chunks loaded by a single scan.");
+  developer_desc.add_options()(
+      "gpu-buffer-eviction-policy",
+      po::value<std::string>(&system_parameters.gpu_buffer_eviction_policy)
+          ->default_value(system_parameters.gpu_buffer_eviction_policy),
+      "Eviction policy for the GPU buffer pools: lru or lru2.");
+  developer_desc.add_options()(
+      "max-resident-buffer-pool-fraction",
+      po::value<double>(&system_parameters.max_resident_buffer_pool_fraction)
+          ->default_value(system_parameters.max_resident_buffer_pool_fraction),
+      "Max fraction of the CPU, and of the GPU, buffer pool memory the chunks of the "
+      "columns pinned with ALTER TABLE ... SET (PIN_CPU=..., PIN_GPU=...) may take.");
+  developer_desc.add_options()(
+      "enable-chunk-index-snapshot",
+      po::value<bool>(&g_enable_chunk_index_snapshot)
+          ->default_value(g_enable_chunk_index_snapshot)
+          ->implicit_value(true),
+      "Persist a checksummed snapshot of each table's chunk index at checkpoint and load "
+      "it at startup instead of scanning every page header of the table's data files. "
+      "Falls back to the header scan when the snapshot is missing or stale.");
+  developer_desc.add_options()(
+      "enable-direct-io-reads",
+      po::value<bool>(&g_enable_direct_io_reads)
+          ->default_value(g_enable_direct_io_reads)
+          ->implicit_value(true),
+      "Load chunks from data files with O_DIRECT reads that bypass the OS page cache, "
+      "coalescing each chunk's adjacent pages into large reads. Falls back to buffered "
+      "reads on file systems without direct I/O support.");
+  developer_desc.add_options()(
+      "direct-io-queue-depth",
+      po::value<size_t>(&g_direct_io_queue_depth)
+          ->default_value(g_direct_io_queue_depth),
+      "Maximum number of coalesced direct reads in flight per chunk load.");
+  developer_desc.add_options()(
+      "import-read-ahead-buffers",
+      po::value<size_t>(&g_import_read_ahead_buffers)
+          ->default_value(g_import_read_ahead_buffers),
+      "Number of buffers of a delimited file COPY FROM reads ahead of its parser "
+      "threads.");
+  developer_desc.add_options()(
+      "import-dict-encoder-threads",
+      po::value<size_t>(&g_import_dict_encoder_threads)
+          ->default_value(g_import_dict_encoder_threads),
+      "Number of threads dictionary encoding the parsed strings of a delimited file "
+      "COPY FROM, between its parser threads and its fragment writer.");
+  developer_desc.add_options()(
+      "detect-sample-blocks",
+      po::value<size_t>(&g_detect_sample_blocks)->default_value(g_detect_sample_blocks),
+      "Number of 1MB blocks spread over a large uncompressed local file the column type "
+      "detection of COPY FROM samples besides its head, 0 to only read the head.");
+  developer_desc.add_options()(
+      "enable-mmap-cpu-chunks",
+      po::value<bool>(&g_enable_mmap_cpu_chunks)
+          ->default_value(g_enable_mmap_cpu_chunks)
+          ->implicit_value(true),
+      "Serve CPU scans of cold fixed width chunks directly from memory mapped data files "
+      "instead of copying them into the CPU buffer pool. Only chunks of full fragments "
+      "that fit in a single page are mapped.");
+  developer_desc.add_options()(
+      "enable-shared-columnar-fetches",
+      po::value<bool>(&g_enable_shared_columnar_fetches)
+          ->default_value(g_enable_shared_columnar_fetches)
+          ->implicit_value(true),
+      "Share the decoded and the merged table columns of the queries in flight with the "
+      "concurrent queries which read the same columns.");
+  developer_desc.add_options()(
+      "file-compaction-interval-seconds",
+      po::value<size_t>(&g_file_compaction_interval_seconds)
+          ->default_value(g_file_compaction_interval_seconds),
+      "Interval between background passes that move the pages of sparse table data "
+      "files into fuller files and remove the emptied files. 0 disables compaction.");
+  developer_desc.add_options()(
+      "file-compaction-min-free-fraction",
+      po::value<double>(&g_file_compaction_min_free_fraction)
+          ->default_value(g_file_compaction_min_free_fraction),
+      "Fraction of free pages a table's data files of one page size need before they "
+      "are compacted.");
+  developer_desc.add_options()(
+      "file-compaction-io-priority",
+      po::value<int>(&g_file_compaction_io_priority)
+          ->default_value(g_file_compaction_io_priority),
+      "I/O priority of the background compaction and cold storage thread, 0 (highest) "
+      "to 7 (lowest) in the best-effort class. A negative value runs it in the idle "
+      "class.");
+  developer_desc.add_options()(
+      "chunk-compression-min-epoch-age",
+      po::value<size_t>(&g_chunk_compression_min_epoch_age)
+          ->default_value(g_chunk_compression_min_epoch_age),
+      "Number of checkpoints of its table after which an unmodified chunk of a table "
+      "with COMPRESSION='BLOSC' is compressed on disk.");
+  developer_desc.add_options()(
+      "chunk-compression-interval-seconds",
+      po::value<size_t>(&g_chunk_compression_interval_seconds)
+          ->default_value(g_chunk_compression_interval_seconds),
+      "Interval between background passes that compress the chunks of tables with "
+      "COMPRESSION='BLOSC'. 0 disables chunk compression.");
+  developer_desc.add_options()(
+      "sort-column-interval-seconds",
+      po::value<size_t>(&g_sort_column_interval_seconds)
+          ->default_value(g_sort_column_interval_seconds),
+      "Interval between background passes that reorder the rows of each fragment of "
+      "tables with an integer or time SORT_COLUMN by its values. 0 disables them.");
+  developer_desc.add_options()(
+      "vacuum-interval-seconds",
+      po::value<size_t>(&g_vacuum_interval_seconds)
+          ->default_value(g_vacuum_interval_seconds),
+      "Interval between background passes that remove the deleted rows of tables with "
+      "VACUUM='DELAYED', one fragment and checkpoint at a time. 0 disables them.");
+  developer_desc.add_options()(
+      "vacuum-min-deleted-fraction",
+      po::value<double>(&g_vacuum_min_deleted_fraction)
+          ->default_value(g_vacuum_min_deleted_fraction),
+      "Fraction of the rows of a fragment that have to be deleted before the background "
+      "vacuum removes them. OPTIMIZE TABLE WITH (VACUUM='true') removes any.");
+  developer_desc.add_options()(
+      "fragment-merge-interval-seconds",
+      po::value<size_t>(&g_fragment_merge_interval_seconds)
+          ->default_value(g_fragment_merge_interval_seconds),
+      "Interval between background passes that merge the undersized fragments of tables "
+      "with VACUUM='DELAYED' by moving their rows to the end of the table. 0 disables "
+      "them.");
+  developer_desc.add_options()(
+      "fragment-merge-max-fill-fraction",
+      po::value<double>(&g_fragment_merge_max_fill_fraction)
+          ->default_value(g_fragment_merge_max_fill_fraction),
+      "Fraction of its fragment size below which the rows of a fragment, other than the "
+      "last one, are merged into the end of the table.");
+  developer_desc.add_options()(
+      "cold-storage-url",
+      po::value<std::string>(&g_cold_storage_url)->default_value(g_cold_storage_url),
+      "Local directory or s3://bucket/prefix url that the data of cold table chunks is "
+      "moved to. Their metadata stays local and their data is fetched back on access. "
+      "S3 credentials are taken from the AWS_* environment variables.");
+  developer_desc.add_options()(
+      "cold-storage-min-epoch-age",
+      po::value<size_t>(&g_cold_storage_min_epoch_age)
+          ->default_value(g_cold_storage_min_epoch_age),
+      "Number of checkpoints of its table after which an unmodified chunk is moved to "
+      "cold storage.");
+  developer_desc.add_options()(
+      "cold-storage-interval-seconds",
+      po::value<size_t>(&g_cold_storage_interval_seconds)
+          ->default_value(g_cold_storage_interval_seconds),
+      "Interval between background passes that move cold chunks to cold storage.");
+  developer_desc.add_options()(
+      "enable-page-checksums",
+      po::value<bool>(&g_enable_page_checksums)
+          ->default_value(g_enable_page_checksums)
+          ->implicit_value(true),
+      "Keep CRC32C checksums of the data file pages next to the data files and verify "
+      "pages as they are read from disk. Reads of corrupt pages fail.");
+  developer_desc.add_options()(
+      "enable-insert-wal",
+      po::value<bool>(&g_enable_insert_wal)
+          ->default_value(g_enable_insert_wal)
+          ->implicit_value(true),
+      "Make inserts into disk tables durable through a write-ahead log shared by the "
+      "tables of a database instead of a checkpoint per insert. Concurrent inserts share "
+      "a single sync of the log, which is replayed on startup.");
+  developer_desc.add_options()(
+      "insert-wal-checkpoint-bytes",
+      po::value<size_t>(&g_insert_wal_checkpoint_bytes)
+          ->default_value(g_insert_wal_checkpoint_bytes),
+      "Checkpoint a table once this many bytes of inserts were logged for it since its "
+      "last checkpoint.");
+  developer_desc.add_options()(
+      "resume-table-streams",
+      po::value<bool>(&g_resume_table_streams)
+          ->default_value(g_resume_table_streams)
+          ->implicit_value(true),
+      "Resume on startup the Kafka streams started by COPY FROM kafka:// and not "
+      "stopped.");
+  developer_desc.add_options()(
+      "prewarm-pinned-tables",
+      po::value<bool>(&g_prewarm_pinned_tables)
+          ->default_value(g_prewarm_pinned_tables)
+          ->implicit_value(true),
+      "Load the columns pinned with ALTER TABLE ... SET (PIN_CPU=..., PIN_GPU=...) into "
+      "their buffer pools in the background on startup.");
+  developer_desc.add_options()(
+      "preload-catalogs",
+      po::value<bool>(&g_preload_catalogs)
+          ->default_value(g_preload_catalogs)
+          ->implicit_value(true),
+      "Load the catalogs of all the databases in parallel in the background on startup "
+      "instead of on the first connection to each of them. get_server_status reports "
+      "catalogs_loaded once they are all loaded. The string dictionaries still open on "
+      "first use.");
+  developer_desc.add_options()(
+      "insert-wal-checkpoint-interval-seconds",
+      po::value<size_t>(&g_insert_wal_checkpoint_interval_seconds)
+          ->default_value(g_insert_wal_checkpoint_interval_seconds),
+      "Interval between background checkpoints of the tables with logged inserts, after "
+      "which the log files no longer needed are removed.");
+  developer_desc.add_options()(
+      "dictionary-compaction-min-dead-fraction",
+      po::value<float>(&g_dictionary_compaction_min_dead_fraction)
+          ->default_value(g_dictionary_compaction_min_dead_fraction),
+      "Fraction of the strings of a dictionary no row references any more above which "
+      "OPTIMIZE TABLE with the COMPACT_DICTIONARIES option compacts it.");
+  developer_desc.add_options()(
+      "enable-delete-fragment-drop",
+      po::value<bool>(&g_enable_delete_fragment_drop)
+          ->default_value(g_enable_delete_fragment_drop)
+          ->implicit_value(true),
+      "Drop the fragments all of whose rows a DELETE removes, as told by the chunk "
+      "stats, instead of marking each of their rows as deleted.");
+  developer_desc.add_options()(
+      "enable-count-from-chunk-metadata",
+      po::value<bool>(&g_enable_count_from_chunk_metadata)
+          ->default_value(g_enable_count_from_chunk_metadata)
+          ->implicit_value(true),
+      "Take the COUNTs of a table from the chunk metadata of the fragments all of whose "
+      "rows qualify, instead of scanning them.");
+  developer_desc.add_options()(
+      "enable-columnar-update",
+      po::value<bool>(&g_enable_columnar_update)
+          ->default_value(g_enable_columnar_update)
+          ->implicit_value(true),
+      "Copy the values of an UPDATE into the chunks column by column when they need no "
+      "conversion, instead of converting them row by row.");
+  developer_desc.add_options()(
+      "buffer-pool-compaction-threshold",
+      po::value<double>(&g_buffer_pool_compaction_threshold)
+          ->default_value(g_buffer_pool_compaction_threshold),
+      "Compact a buffer pool slab before evicting chunks when the pool's free space "
+      "fragmentation (1 - largest free segment / total free space) exceeds this ratio. "
+      "0 disables automatic compaction.");
   developer_desc.add_options()(
       "min-gpu-slab-size",
       po::value<size_t>(&system_parameters.min_gpu_slab_size)
@@ -742,6 +1437,13 @@ void CommandLineOptions::validate() {
   ddl_utils::FilePathBlacklist::addToBlacklist(base_path + "/mapd_data");
   ddl_utils::FilePathBlacklist::addToBlacklist(base_path + "/mapd_log");
 
+  if (g_enable_jit_object_cache) {
+    if (g_jit_object_cache_path.empty()) {
+      g_jit_object_cache_path = base_path + "/omnisci_jit_cache";
+    }
+    ddl_utils::FilePathBlacklist::addToBlacklist(g_jit_object_cache_path);
+  }
+
   if (g_enable_fsi) {
     if (disk_cache_config.path.empty()) {
       disk_cache_config.path = base_path + "/omnisci_disk_cache";
@@ -44,6 +44,11 @@ class CommandLineOptions {
     fillAdvancedOptions();
   }
   int http_port = 6278;
+  int flight_port = 0;  // 0 for no Arrow Flight server
+  int metrics_port = 0;  // 0 for no metrics endpoint
+  bool nonblocking_thrift_server = false;
+  size_t num_thrift_io_threads = 4;
+  size_t num_thrift_worker_threads = 0;  // 0 for one per hardware thread, 16 at least
   size_t reserved_gpu_mem = 384 * 1024 * 1024;
   std::string base_path;
   DiskCacheConfig disk_cache_config;
@@ -148,11 +153,60 @@ extern bool g_enable_dynamic_watchdog;
 extern unsigned g_dynamic_watchdog_time_limit;
 extern unsigned g_trivial_loop_join_threshold;
 extern bool g_from_table_reordering;
+extern bool g_from_table_reordering_filtered_counts;
 extern bool g_enable_filter_push_down;
 extern bool g_allow_cpu_retry;
 extern bool g_null_div_by_zero;
 extern bool g_bigint_count;
 extern bool g_inner_join_fragment_skipping;
+extern bool g_enable_concurrent_query_execution;
+extern bool g_enable_cpu_sub_fragment_kernels;
+extern bool g_enable_hybrid_execution;
+extern bool g_enable_gpu_streaming;
+extern size_t g_gpu_streams_per_device;
+extern bool g_enable_group_by_buffer_spill;
+extern size_t g_statistics_sample_rows;
+extern bool g_enable_device_cost_model;
+extern bool g_enable_predictive_watchdog;
+extern bool g_enable_block_zone_maps;
+extern bool g_enable_top_n_fragment_skipping;
+extern size_t g_block_zone_map_rows;
+extern size_t g_bloom_filter_bits_per_value;
+extern bool g_enable_parallel_column_appends;
+extern bool g_enable_parquet_dictionary_bloom_filters;
+extern bool g_enable_query_admission_control;
+extern std::string g_high_priority_users;
+extern std::string g_low_priority_users;
+extern bool g_enable_chunk_prefetch;
+extern bool g_enable_deferred_lazy_fetch;
+extern double g_buffer_pool_compaction_threshold;
+extern bool g_enable_chunk_index_snapshot;
+extern bool g_enable_direct_io_reads;
+extern size_t g_direct_io_queue_depth;
+extern bool g_enable_mmap_cpu_chunks;
+extern bool g_enable_shared_columnar_fetches;
+extern size_t g_file_compaction_interval_seconds;
+extern double g_file_compaction_min_free_fraction;
+extern int g_file_compaction_io_priority;
+extern size_t g_chunk_compression_min_epoch_age;
+extern size_t g_chunk_compression_interval_seconds;
+extern size_t g_sort_column_interval_seconds;
+extern size_t g_vacuum_interval_seconds;
+extern double g_vacuum_min_deleted_fraction;
+extern size_t g_fragment_merge_interval_seconds;
+extern double g_fragment_merge_max_fill_fraction;
+extern std::string g_cold_storage_url;
+extern size_t g_cold_storage_min_epoch_age;
+extern size_t g_cold_storage_interval_seconds;
+extern bool g_enable_page_checksums;
+extern bool g_enable_insert_wal;
+extern size_t g_insert_wal_checkpoint_bytes;
+extern size_t g_insert_wal_checkpoint_interval_seconds;
+extern bool g_resume_table_streams;
+extern bool g_prewarm_pinned_tables;
+extern bool g_preload_catalogs;
+extern float g_dictionary_compaction_min_dead_fraction;
+extern size_t g_cpu_sub_fragment_size;
 extern float g_filter_push_down_low_frac;
 extern float g_filter_push_down_high_frac;
 extern size_t g_filter_push_down_passing_row_ubound;
@@ -160,23 +214,57 @@ extern bool g_enable_columnar_output;
 extern bool g_enable_overlaps_hashjoin;
 extern bool g_enable_hashjoin_many_to_many;
 extern size_t g_overlaps_max_table_size_bytes;
+extern size_t g_overlaps_auto_tuner_sample_rows;
+extern size_t g_baseline_hash_join_partition_bytes;
+extern size_t g_join_hash_table_cache_bytes;
+extern bool g_enable_parallel_join_hash_table_build;
+extern bool g_enable_join_hash_table_peer_copy;
+extern bool g_enable_partitioned_sharded_joins;
 extern bool g_strip_join_covered_quals;
 extern size_t g_constrained_by_in_threshold;
 extern size_t g_big_group_threshold;
 extern bool g_enable_window_functions;
+extern bool g_enable_window_function_gpu_sort;
 extern bool g_enable_table_functions;
+extern size_t g_table_function_partition_rows;
 extern size_t g_max_memory_allocation_size;
 extern double g_bump_allocator_step_reduction;
 extern bool g_enable_direct_columnarization;
+extern bool g_enable_columnar_ctas;
 extern bool g_enable_runtime_query_interrupt;
+extern bool g_enable_jit_host_cpu_features;
+extern bool g_enable_jit_perf_map;
+extern bool g_enable_jit_gdb_registration;
+extern bool g_enable_cpu_loop_vectorization;
+extern bool g_enable_calcite_plan_cache;
+extern size_t g_calcite_plan_cache_size;
+extern bool g_enable_tiered_cpu_compilation;
+extern bool g_enable_parallel_cpu_code_generation;
+extern size_t g_tiered_cpu_compilation_max_rows;
+extern bool g_enable_jit_object_cache;
+extern std::string g_jit_object_cache_path;
+extern size_t g_jit_object_cache_entry_limit;
+extern bool g_enable_result_set_cache;
+extern size_t g_result_set_cache_bytes;
+extern bool g_enable_fragment_result_cache;
+extern size_t g_fragment_result_cache_bytes;
+extern bool g_enable_host_buffer_pool;
+extern size_t g_host_buffer_pool_bytes;
+extern bool g_enable_gpu_scratch_pool;
+extern size_t g_gpu_scratch_pool_bytes;
 extern unsigned g_runtime_query_interrupt_frequency;
 extern size_t g_gpu_smem_threshold;
 extern bool g_enable_smem_non_grouped_agg;
+extern bool g_enable_smem_join_hash_table;
 extern bool g_enable_smem_grouped_non_count_agg;
+extern bool g_enable_smem_baseline_group_by;
 extern bool g_use_estimator_result_cache;
 
 extern int64_t g_omni_kafka_seek;
 extern bool g_cache_string_hash;
+extern size_t g_import_read_ahead_buffers;
+extern size_t g_import_dict_encoder_threads;
+extern size_t g_detect_sample_blocks;
 extern size_t g_leaf_count;
 extern size_t g_compression_limit_bytes;
 extern bool g_skip_intermediate_count;
@@ -187,5 +275,13 @@ extern bool g_enable_experimental_string_functions;
 extern bool g_enable_table_functions;
 extern bool g_enable_fsi;
 extern bool g_enable_interop;
+extern bool g_enable_interpreted_interop;
+extern bool g_enable_datetrunc_bucket_tables;
 extern bool g_enable_union;
+extern bool g_enable_parallel_union_branches;
+extern bool g_enable_semi_join;
+extern bool g_enable_delete_fragment_drop;
+extern bool g_enable_count_from_chunk_metadata;
+extern bool g_enable_columnar_update;
 extern bool g_use_tbb_pool;
+extern bool g_use_work_stealing_pool;
@@ -40,28 +40,37 @@
 
 #include "Catalog/Catalog.h"
 #include "Catalog/DdlCommandExecutor.h"
+#include "DataMgr/FileMgr/FileInfo.h"
 #include "DataMgr/ForeignStorage/ArrowCsvForeignStorage.h"
 #include "DataMgr/ForeignStorage/DummyForeignStorage.h"
 #include "DataMgr/ForeignStorage/ForeignStorageInterface.h"
 #include "DistributedHandler.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
+#include "Fragmenter/InsertWal.h"
 #include "ImportExport/GDAL.h"
 #include "ImportExport/Importer.h"
+#include "ImportExport/StreamIngestor.h"
 #include "LockMgr/LockMgr.h"
 #include "Parser/ParserWrapper.h"
 #include "Parser/ReservedKeywords.h"
 #include "Parser/parser.h"
 #include "QueryEngine/ArrowResultSet.h"
 #include "QueryEngine/CalciteAdapter.h"
+#include "QueryEngine/DeviceCostModel.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/ExtensionFunctionsWhitelist.h"
+#include "QueryEngine/ExternalCacheInvalidators.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/JoinFilterPushDown.h"
 #include "QueryEngine/JsonAccessors.h"
 #include "QueryEngine/QueryDispatchQueue.h"
+#include "QueryEngine/QueryProfile.h"
 #include "QueryEngine/TableFunctions/TableFunctionsFactory.h"
 #include "QueryEngine/TableOptimizer.h"
 #include "QueryEngine/ThriftSerializers.h"
+#include "Shared/Compressor.h"
+#include "Shared/File.h"
+#include "Shared/Metrics.h"
 #include "Shared/StringTransform.h"
 #include "Shared/SysInfo.h"
 #include "Shared/geo_types.h"
@@ -70,6 +79,7 @@
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/measure.h"
 #include "Shared/scope.h"
+#include "Shared/thread_count.h"
 
 #include <fcntl.h>
 #include <picosha2.h>
@@ -93,6 +103,7 @@
 #include <memory>
 #include <random>
 #include <regex>
+#include <set>
 #include <string>
 #include <thread>
 #include <typeinfo>
@@ -136,19 +147,27 @@ struct ForceDisconnect : public std::runtime_error {
   ForceDisconnect(const std::string& cause) : std::runtime_error(cause) {}
 };
 
+metrics::Histogram& request_phase_histogram(const std::string& phase) {
+  return metrics::Registry::instance().histogram("omnisci_request_phase_seconds",
+                                                 "The phases of the SQL requests",
+                                                 metrics::latency_buckets(),
+                                                 {{"phase", phase}});
+}
+
 }  // namespace
 
 template <>
 SessionMap::iterator DBHandler::get_session_it_unsafe(
     const TSessionId& session,
     mapd_shared_lock<mapd_shared_mutex>& read_lock) {
-  auto session_it = get_session_from_map(session, sessions_);
+  auto& shard = get_session_shard(session);
+  auto session_it = get_session_from_map(session, shard.sessions);
   try {
     check_session_exp_unsafe(session_it);
   } catch (const ForceDisconnect& e) {
     read_lock.unlock();
-    mapd_unique_lock<mapd_shared_mutex> write_lock(sessions_mutex_);
-    auto session_it2 = get_session_from_map(session, sessions_);
+    mapd_unique_lock<mapd_shared_mutex> write_lock(shard.mutex);
+    auto session_it2 = get_session_from_map(session, shard.sessions);
     disconnect_impl(session_it2, write_lock);
     THROW_MAPD_EXCEPTION(e.what());
   }
@@ -159,7 +178,7 @@ template <>
 SessionMap::iterator DBHandler::get_session_it_unsafe(
     const TSessionId& session,
     mapd_unique_lock<mapd_shared_mutex>& write_lock) {
-  auto session_it = get_session_from_map(session, sessions_);
+  auto session_it = get_session_from_map(session, get_session_shard(session).sessions);
   try {
     check_session_exp_unsafe(session_it);
   } catch (const ForceDisconnect& e) {
@@ -173,6 +192,17 @@ SessionMap::iterator DBHandler::get_session_it_unsafe(
 extern std::unique_ptr<std::string> g_libgeos_so_filename;
 #endif
 
+extern size_t g_file_compaction_interval_seconds;
+extern double g_file_compaction_min_free_fraction;
+extern int g_file_compaction_io_priority;
+extern std::string g_cold_storage_url;
+extern size_t g_cold_storage_min_epoch_age;
+extern size_t g_cold_storage_interval_seconds;
+extern bool g_enable_insert_wal;
+extern size_t g_insert_wal_checkpoint_interval_seconds;
+extern bool g_prewarm_pinned_tables;
+extern bool g_preload_catalogs;
+
 DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
                      const std::vector<LeafHostInfo>& string_leaves,
                      const std::string& base_data_path,
@@ -227,6 +257,7 @@ DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
   LOG(INFO) << "OmniSci Server " << MAPD_RELEASE;
   // Register foreign storage interfaces here
   registerArrowCsvForeignStorage();
+  registerArrowFileForeignStorage();
   bool is_rendering_enabled = enable_rendering;
 
   try {
@@ -326,6 +357,16 @@ DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
       break;
   }
 
+  if (g_enable_device_cost_model && !cpu_mode_only_) {
+    try {
+      DeviceCostModel::instance().calibrate(*data_mgr_);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to calibrate the device cost model, the steps of the GPU "
+                      "queries stay on GPU: "
+                   << e.what();
+    }
+  }
+
   try {
     SysCatalog::instance().init(base_data_path_,
                                 data_mgr_,
@@ -375,9 +416,407 @@ DBHandler::DBHandler(const std::vector<LeafHostInfo>& db_leaves,
     LOG(INFO) << "Overriding default geos library with '" + *g_libgeos_so_filename + "'";
   }
 #endif
+
+  const bool cold_storage_enabled =
+      !g_cold_storage_url.empty() && g_cold_storage_interval_seconds > 0;
+  const bool insert_wal_enabled =
+      g_enable_insert_wal && g_insert_wal_checkpoint_interval_seconds > 0;
+  if ((g_file_compaction_interval_seconds > 0 || cold_storage_enabled ||
+       insert_wal_enabled || g_chunk_compression_interval_seconds > 0 ||
+       g_sort_column_interval_seconds > 0 || g_vacuum_interval_seconds > 0 ||
+       g_fragment_merge_interval_seconds > 0) &&
+      !read_only_) {
+    storage_maintenance_thread_ = std::thread(&DBHandler::run_storage_maintenance, this);
+  }
+
+  if (g_preload_catalogs) {
+    catalogs_loaded_ = false;
+    catalog_load_thread_ = std::thread(&DBHandler::load_catalogs, this);
+  }
+
+  if (g_resume_table_streams && !read_only_ && !g_cluster) {
+    resume_table_streams();
+  }
+
+  if (g_prewarm_pinned_tables && !g_cluster) {
+    prewarm_thread_ = std::thread(&DBHandler::prewarm_pinned_tables, this);
+  }
+}
+
+DBHandler::~DBHandler() {
+  import_export::StreamIngestMgr::instance().stopAll();
+  {
+    std::lock_guard<std::mutex> lock(storage_maintenance_mutex_);
+    stop_storage_maintenance_ = true;
+  }
+  storage_maintenance_cv_.notify_all();
+  if (storage_maintenance_thread_.joinable()) {
+    storage_maintenance_thread_.join();
+  }
+  if (prewarm_thread_.joinable()) {
+    prewarm_thread_.join();
+  }
+  if (catalog_load_thread_.joinable()) {
+    catalog_load_thread_.join();
+  }
+}
+
+void DBHandler::load_catalogs() {
+  const auto db_list = SysCatalog::instance().getAllDBMetadata();
+  const std::vector<Catalog_Namespace::DBMetadata> dbs(db_list.begin(), db_list.end());
+  const auto load_begin = timer_start();
+  // the catalogs are independent, each one is built by a single thread anyway
+  std::atomic<size_t> next_db_idx{0};
+  std::vector<std::future<void>> loaders;
+  const auto loader_count = std::min(dbs.size(), static_cast<size_t>(cpu_threads()));
+  for (size_t i = 0; i < loader_count; ++i) {
+    loaders.push_back(std::async(std::launch::async, [this, &dbs, &next_db_idx] {
+      for (size_t db_idx = next_db_idx++;
+           db_idx < dbs.size() && !storage_maintenance_stopped();
+           db_idx = next_db_idx++) {
+        const auto& db = dbs[db_idx];
+        try {
+          const auto time_ms = measure<>::execution([&] {
+            Catalog_Namespace::Catalog::get(
+                base_data_path_, db, data_mgr_, string_leaves_, calcite_, false);
+          });
+          LOG(INFO) << "Loaded the catalog of database " << db.dbName << " in " << time_ms
+                    << "ms";
+        } catch (const std::exception& e) {
+          // left to the first session connecting to the database
+          LOG(ERROR) << "Could not load the catalog of database " << db.dbName << ": "
+                     << e.what();
+        }
+      }
+    }));
+  }
+  for (auto& loader : loaders) {
+    loader.get();
+  }
+  catalogs_loaded_ = true;
+  LOG(INFO) << "Loaded the catalogs of " << dbs.size() << " databases in "
+            << timer_stop(load_begin) << "ms";
+}
+
+void DBHandler::prewarm_pinned_tables() {
+  for (const auto& db : SysCatalog::instance().getAllDBMetadata()) {
+    try {
+      // only the catalogs of databases with pinned tables are loaded now
+      SqliteConnector sqlite_connector(db.dbName, base_data_path_ + "/mapd_catalogs/");
+      sqlite_connector.query("PRAGMA TABLE_INFO(mapd_tables)");
+      bool has_pinned_columns{false};
+      for (size_t i = 0; i < sqlite_connector.getNumRows(); ++i) {
+        if (sqlite_connector.getData<std::string>(i, 1) == "pinned_cpu_columns") {
+          has_pinned_columns = true;
+        }
+      }
+      if (!has_pinned_columns) {
+        continue;
+      }
+      sqlite_connector.query(
+          "SELECT COUNT(*) FROM mapd_tables WHERE pinned_cpu_columns <> '' OR "
+          "pinned_gpu_columns <> ''");
+      if (sqlite_connector.getData<int>(0, 0) == 0) {
+        continue;
+      }
+      auto cat = Catalog_Namespace::Catalog::get(
+          base_data_path_, db, data_mgr_, string_leaves_, calcite_, false);
+      std::vector<std::string> table_names;
+      for (const auto td : cat->getAllTableMetadata()) {
+        if (!td->pinnedCpuColumnIds.empty() || !td->pinnedGpuColumnIds.empty()) {
+          table_names.push_back(td->tableName);
+        }
+      }
+      for (const auto& table_name : table_names) {
+        if (storage_maintenance_stopped()) {
+          return;
+        }
+        const auto td_with_lock =
+            lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+                *cat, table_name, true);
+        const auto td = td_with_lock();
+        const auto data_lock =
+            lockmgr::TableDataLockContainer<lockmgr::ReadLock>::acquire(db.dbId, td);
+        size_t chunk_count{0};
+        if (!td->pinnedCpuColumnIds.empty()) {
+          chunk_count += cat->prewarmTable(
+              td, td->pinnedCpuColumnIds, Data_Namespace::MemoryLevel::CPU_LEVEL);
+        }
+        if (!td->pinnedGpuColumnIds.empty() && data_mgr_->gpusPresent()) {
+          chunk_count += cat->prewarmTable(
+              td, td->pinnedGpuColumnIds, Data_Namespace::MemoryLevel::GPU_LEVEL);
+        }
+        LOG(INFO) << "Prewarmed " << chunk_count << " chunks of the pinned columns of "
+                  << "table " << table_name << " of database " << db.dbName;
+      }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Could not prewarm the pinned tables of database " << db.dbName
+                 << ": " << e.what();
+    }
+  }
+}
+
+void DBHandler::resume_table_streams() {
+  for (const auto& db : SysCatalog::instance().getAllDBMetadata()) {
+    try {
+      // only the catalogs of databases with streams are loaded now
+      SqliteConnector sqlite_connector(db.dbName, base_data_path_ + "/mapd_catalogs/");
+      sqlite_connector.query(
+          "SELECT name FROM sqlite_master WHERE type='table' AND "
+          "name='omnisci_table_streams'");
+      if (sqlite_connector.getNumRows() == 0) {
+        continue;
+      }
+      sqlite_connector.query("SELECT COUNT(*) FROM omnisci_table_streams");
+      if (sqlite_connector.getData<int>(0, 0) == 0) {
+        continue;
+      }
+      auto cat = Catalog_Namespace::Catalog::get(
+          base_data_path_, db, data_mgr_, string_leaves_, calcite_, false);
+      import_export::StreamIngestMgr::instance().resumeStreams(*cat);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Could not resume the streams of database " << db.dbName << ": "
+                 << e.what();
+    }
+  }
+}
+
+void DBHandler::run_storage_maintenance() {
+  File_Namespace::setThreadIoPriority(g_file_compaction_io_priority);
+  struct MaintenanceTask {
+    size_t interval_seconds;
+    void (DBHandler::*run)();
+    std::chrono::steady_clock::time_point next_run;
+  };
+  std::vector<MaintenanceTask> tasks;
+  const auto now = std::chrono::steady_clock::now();
+  if (g_enable_insert_wal && g_insert_wal_checkpoint_interval_seconds > 0) {
+    const auto interval = std::chrono::seconds(g_insert_wal_checkpoint_interval_seconds);
+    tasks.push_back({g_insert_wal_checkpoint_interval_seconds,
+                     &DBHandler::checkpoint_insert_wal,
+                     now + interval});
+  }
+  // vacuum, merge and sort first, compression then takes the chunks once they stay
+  // unmodified
+  if (g_vacuum_interval_seconds > 0) {
+    tasks.push_back({g_vacuum_interval_seconds,
+                     &DBHandler::vacuum_deleted_rows,
+                     now + std::chrono::seconds(g_vacuum_interval_seconds)});
+  }
+  if (g_fragment_merge_interval_seconds > 0) {
+    tasks.push_back({g_fragment_merge_interval_seconds,
+                     &DBHandler::merge_table_fragments,
+                     now + std::chrono::seconds(g_fragment_merge_interval_seconds)});
+  }
+  if (g_sort_column_interval_seconds > 0) {
+    tasks.push_back({g_sort_column_interval_seconds,
+                     &DBHandler::sort_table_fragments,
+                     now + std::chrono::seconds(g_sort_column_interval_seconds)});
+  }
+  if (g_chunk_compression_interval_seconds > 0) {
+    tasks.push_back({g_chunk_compression_interval_seconds,
+                     &DBHandler::compress_table_chunks,
+                     now + std::chrono::seconds(g_chunk_compression_interval_seconds)});
+  }
+  // spill first, compaction then reclaims the pages freed by the spill
+  if (!g_cold_storage_url.empty() && g_cold_storage_interval_seconds > 0) {
+    tasks.push_back({g_cold_storage_interval_seconds,
+                     &DBHandler::spill_cold_chunks,
+                     now + std::chrono::seconds(g_cold_storage_interval_seconds)});
+  }
+  if (g_file_compaction_interval_seconds > 0) {
+    tasks.push_back({g_file_compaction_interval_seconds,
+                     &DBHandler::compact_table_files,
+                     now + std::chrono::seconds(g_file_compaction_interval_seconds)});
+  }
+  CHECK(!tasks.empty());
+  std::unique_lock<std::mutex> lock(storage_maintenance_mutex_);
+  while (true) {
+    auto next_run = tasks.front().next_run;
+    for (const auto& task : tasks) {
+      next_run = std::min(next_run, task.next_run);
+    }
+    if (storage_maintenance_cv_.wait_until(
+            lock, next_run, [this] { return stop_storage_maintenance_; })) {
+      return;
+    }
+    lock.unlock();
+    for (auto& task : tasks) {
+      if (task.next_run > std::chrono::steady_clock::now()) {
+        continue;
+      }
+      try {
+        (this->*task.run)();
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Storage maintenance failed: " << e.what();
+      }
+      task.next_run =
+          std::chrono::steady_clock::now() + std::chrono::seconds(task.interval_seconds);
+    }
+    lock.lock();
+  }
+}
+
+bool DBHandler::storage_maintenance_stopped() {
+  std::lock_guard<std::mutex> lock(storage_maintenance_mutex_);
+  return stop_storage_maintenance_;
+}
+
+void DBHandler::for_each_disk_table(
+    const std::function<void(const Catalog_Namespace::Catalog&, const TableDescriptor*)>&
+        func,
+    const std::function<bool(const TableDescriptor*)>& filter,
+    const bool lock_table_data) {
+  for (const auto& db : SysCatalog::instance().getAllDBMetadata()) {
+    // tables of databases nobody connected to yet have no open data files
+    auto cat = Catalog_Namespace::Catalog::get(db.dbName);
+    if (!cat) {
+      continue;
+    }
+    std::vector<std::string> table_names;
+    for (const auto td : cat->getAllTableMetadata()) {
+      if (!td->isView && td->shard < 0 && td->storageType.empty() &&
+          td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL &&
+          (!filter || filter(td))) {
+        table_names.push_back(td->tableName);
+      }
+    }
+    for (const auto& table_name : table_names) {
+      if (storage_maintenance_stopped()) {
+        return;
+      }
+      // same locks as UPDATE and DELETE: queries on the table wait for the maintenance
+      const auto td_with_lock =
+          lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::acquireTableDescriptor(
+              *cat, table_name, false);
+      const auto td = td_with_lock();
+      if (!td) {
+        continue;  // dropped in the meantime
+      }
+      if (!lock_table_data) {
+        func(*cat, td);
+        continue;
+      }
+      const auto data_lock = lockmgr::TableDataLockContainer<lockmgr::WriteLock>::acquire(
+          cat->getCurrentDB().dbId, td);
+      func(*cat, td);
+    }
+  }
+}
+
+void DBHandler::compact_table_files() {
+  for_each_disk_table([this](const auto& cat, const auto td) {
+    for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+      data_mgr_->compactTableFiles(cat.getCurrentDB().dbId,
+                                   physical_td->tableId,
+                                   g_file_compaction_min_free_fraction);
+    }
+  });
+}
+
+void DBHandler::spill_cold_chunks() {
+  for_each_disk_table([this](const auto& cat, const auto td) {
+    size_t num_bytes_spilled = 0;
+    for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+      num_bytes_spilled += data_mgr_->spillTableColdChunks(
+          cat.getCurrentDB().dbId, physical_td->tableId, g_cold_storage_min_epoch_age);
+    }
+    if (num_bytes_spilled > 0) {
+      // makes the freed pages reusable, every shard moves to the next epoch
+      cat.checkpoint(td->tableId);
+    }
+  });
+}
+
+void DBHandler::compress_table_chunks() {
+  for_each_disk_table(
+      [this](const auto& cat, const auto td) {
+        size_t num_bytes_freed = 0;
+        for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+          num_bytes_freed += data_mgr_->compressTableChunks(
+              cat.getCurrentDB().dbId,
+              physical_td->tableId,
+              g_chunk_compression_min_epoch_age);
+        }
+        if (num_bytes_freed > 0) {
+          // makes the compressed pages durable and the freed ones reusable
+          cat.checkpoint(td->tableId);
+        }
+      },
+      [](const auto td) { return !td->chunkCompression.empty(); });
+}
+
+void DBHandler::sort_table_fragments() {
+  for_each_disk_table(
+      [](const auto& cat, const auto td) { cat.sortFragmentRows(td->tableId); },
+      [](const auto td) { return td->sortedColumnId > 0; });
+}
+
+void DBHandler::vacuum_deleted_rows() {
+  for_each_disk_table(
+      [this](const auto& cat, const auto td) {
+        const auto db_id = cat.getCurrentDB().dbId;
+        for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+          std::vector<int> fragment_ids;
+          {
+            const auto data_lock =
+                lockmgr::TableDataLockContainer<lockmgr::ReadLock>::acquire(db_id, td);
+            fragment_ids =
+                cat.getFragmentsToVacuum(physical_td, g_vacuum_min_deleted_fraction);
+          }
+          // queries on the table only wait for the fragment being vacuumed
+          for (const auto fragment_id : fragment_ids) {
+            if (storage_maintenance_stopped()) {
+              return;
+            }
+            const auto data_lock =
+                lockmgr::TableDataLockContainer<lockmgr::WriteLock>::acquire(db_id, td);
+            if (cat.vacuumFragment(physical_td, fragment_id)) {
+              VLOG(1) << "Vacuumed fragment " << fragment_id << " of table "
+                      << physical_td->tableName;
+            }
+          }
+        }
+      },
+      [](const auto td) { return td->hasDeletedCol; },
+      /*lock_table_data=*/false);
 }
 
-DBHandler::~DBHandler() {}
+void DBHandler::merge_table_fragments() {
+  for_each_disk_table(
+      [](const auto& cat, const auto td) { cat.mergeSmallFragments(td->tableId); },
+      [](const auto td) { return td->hasDeletedCol; });
+}
+
+void DBHandler::checkpoint_insert_wal() {
+  // physical tables with inserts logged since their last checkpoint, per database
+  std::map<const Catalog_Namespace::Catalog*, std::set<int>> tables_to_checkpoint;
+  for_each_disk_table([this, &tables_to_checkpoint](const auto& cat, const auto td) {
+    const auto insert_wal = cat.getInsertWal();
+    if (!insert_wal) {
+      return;
+    }
+    auto it = tables_to_checkpoint.find(&cat);
+    if (it == tables_to_checkpoint.end()) {
+      const auto table_ids =
+          insert_wal->getTablesToCheckpoint(cat.getInsertWalTableEpochs());
+      it = tables_to_checkpoint
+               .emplace(&cat, std::set<int>(table_ids.begin(), table_ids.end()))
+               .first;
+    }
+    for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+      if (it->second.count(physical_td->tableId)) {
+        data_mgr_->checkpoint(cat.getCurrentDB().dbId, physical_td->tableId);
+      }
+    }
+  });
+  for (const auto& db : SysCatalog::instance().getAllDBMetadata()) {
+    const auto cat = Catalog_Namespace::Catalog::get(db.dbName);
+    if (cat && cat->getInsertWal()) {
+      cat->getInsertWal()->removeCheckpointedSegments(cat->getInsertWalTableEpochs());
+    }
+  }
+}
 
 void DBHandler::parser_with_error_handler(
     const std::string& query_str,
@@ -408,23 +847,26 @@ std::string const DBHandler::createInMemoryCalciteSession(
   // session would be under the name of a proxy user/password which would only persist
   // till server's lifetime or execution of calcite query(in memory) whichever is the
   // earliest.
-  mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
-  std::string session_id;
-  do {
-    session_id = generate_random_string(64);
-  } while (sessions_.find(session_id) != sessions_.end());
   Catalog_Namespace::UserMetadata user_meta(-1,
                                             calcite_->getInternalSessionProxyUserName(),
                                             calcite_->getInternalSessionProxyPassword(),
                                             true,
                                             -1,
                                             true);
-  const auto emplace_ret =
-      sessions_.emplace(session_id,
-                        std::make_shared<Catalog_Namespace::SessionInfo>(
-                            catalog_ptr, user_meta, executor_device_type_, session_id));
-  CHECK(emplace_ret.second);
-  return session_id;
+  while (true) {
+    const auto session_id = generate_random_string(64);
+    auto& shard = get_session_shard(session_id);
+    mapd_lock_guard<mapd_shared_mutex> write_lock(shard.mutex);
+    if (shard.sessions.find(session_id) != shard.sessions.end()) {
+      continue;
+    }
+    const auto emplace_ret = shard.sessions.emplace(
+        session_id,
+        std::make_shared<Catalog_Namespace::SessionInfo>(
+            catalog_ptr, user_meta, executor_device_type_, session_id));
+    CHECK(emplace_ret.second);
+    return session_id;
+  }
 }
 
 bool DBHandler::isInMemoryCalciteSession(
@@ -436,10 +878,11 @@ bool DBHandler::isInMemoryCalciteSession(
 
 void DBHandler::removeInMemoryCalciteSession(const std::string& session_id) {
   // Remove InMemory calcite Session.
-  mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
-  const auto it = sessions_.find(session_id);
-  CHECK(it != sessions_.end());
-  sessions_.erase(it);
+  auto& shard = get_session_shard(session_id);
+  mapd_lock_guard<mapd_shared_mutex> write_lock(shard.mutex);
+  const auto it = shard.sessions.find(session_id);
+  CHECK(it != shard.sessions.end());
+  shard.sessions.erase(it);
 }
 
 // internal connection for connections with no password
@@ -515,15 +958,21 @@ std::shared_ptr<Catalog_Namespace::SessionInfo> DBHandler::create_new_session(
     const std::string& dbname,
     const Catalog_Namespace::UserMetadata& user_meta,
     std::shared_ptr<Catalog> cat) {
-  do {
+  std::shared_ptr<Catalog_Namespace::SessionInfo> session_ptr;
+  while (!session_ptr) {
     session = generate_random_string(32);
-  } while (sessions_.find(session) != sessions_.end());
-  std::pair<SessionMap::iterator, bool> emplace_retval =
-      sessions_.emplace(session,
-                        std::make_shared<Catalog_Namespace::SessionInfo>(
-                            cat, user_meta, executor_device_type_, session));
-  CHECK(emplace_retval.second);
-  auto& session_ptr = emplace_retval.first->second;
+    auto& shard = get_session_shard(session);
+    mapd_lock_guard<mapd_shared_mutex> write_lock(shard.mutex);
+    if (shard.sessions.find(session) != shard.sessions.end()) {
+      continue;
+    }
+    std::pair<SessionMap::iterator, bool> emplace_retval =
+        shard.sessions.emplace(session,
+                               std::make_shared<Catalog_Namespace::SessionInfo>(
+                                   cat, user_meta, executor_device_type_, session));
+    CHECK(emplace_retval.second);
+    session_ptr = emplace_retval.first->second;
+  }
   LOG(INFO) << "User " << user_meta.userName << " connected to database " << dbname;
   return session_ptr;
 }
@@ -538,7 +987,6 @@ void DBHandler::connect_impl(TSessionId& session,
   // here when the cat parameter already provides cat->name()?
   // Should dbname and cat->name() ever differ?
   {
-    mapd_lock_guard<mapd_shared_mutex> write_lock(sessions_mutex_);
     auto session_ptr = create_new_session(session, dbname, user_meta, cat);
     stdlog.setSessionInfo(session_ptr);
     session_ptr->set_connection_info(getConnectionInfo().toString());
@@ -562,7 +1010,7 @@ void DBHandler::disconnect(const TSessionId& session) {
   auto stdlog = STDLOG();
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
 
-  mapd_unique_lock<mapd_shared_mutex> write_lock(sessions_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> write_lock(get_session_shard(session).mutex);
   auto session_it = get_session_it_unsafe(session, write_lock);
   stdlog.setSessionInfo(session_it->second);
   const auto dbname = session_it->second->getCatalog().getCurrentDB().dbName;
@@ -581,7 +1029,7 @@ void DBHandler::disconnect_impl(const SessionMap::iterator& session_it,
   if (leaf_aggregator_.leafCount() > 0) {
     leaf_aggregator_.disconnect(session_id);
   }
-  sessions_.erase(session_it);
+  get_session_shard(session_it->first).sessions.erase(session_it);
   write_lock.unlock();
 
   if (render_handler_) {
@@ -592,7 +1040,7 @@ void DBHandler::disconnect_impl(const SessionMap::iterator& session_it,
 void DBHandler::switch_database(const TSessionId& session, const std::string& dbname) {
   auto stdlog = STDLOG(get_session_ptr(session));
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
-  mapd_unique_lock<mapd_shared_mutex> write_lock(sessions_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> write_lock(get_session_shard(session).mutex);
   auto session_it = get_session_it_unsafe(session, write_lock);
 
   std::string dbname2 = dbname;  // switchDatabase() may reset dbname given as argument
@@ -613,13 +1061,16 @@ void DBHandler::switch_database(const TSessionId& session, const std::string& db
 void DBHandler::clone_session(TSessionId& session2, const TSessionId& session1) {
   auto stdlog = STDLOG(get_session_ptr(session1));
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
-  mapd_unique_lock<mapd_shared_mutex> write_lock(sessions_mutex_);
-  auto session_it = get_session_it_unsafe(session1, write_lock);
+  std::shared_ptr<Catalog_Namespace::SessionInfo> session1_ptr;
+  {
+    // session2 may fall in the shard of session1, which create_new_session() locks
+    mapd_shared_lock<mapd_shared_mutex> read_lock(get_session_shard(session1).mutex);
+    session1_ptr = get_session_it_unsafe(session1, read_lock)->second;
+  }
 
   try {
-    const Catalog_Namespace::UserMetadata& user_meta =
-        session_it->second->get_currentUser();
-    std::shared_ptr<Catalog> cat = session_it->second->get_catalog_ptr();
+    const Catalog_Namespace::UserMetadata& user_meta = session1_ptr->get_currentUser();
+    std::shared_ptr<Catalog> cat = session1_ptr->get_catalog_ptr();
     auto session2_ptr = create_new_session(session2, cat->name(), user_meta, cat);
     if (leaf_aggregator_.leafCount() > 0) {
       leaf_aggregator_.clone_session(session1, session2);
@@ -640,7 +1091,8 @@ void DBHandler::interrupt(const TSessionId& query_session,
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
   if (g_enable_dynamic_watchdog || g_enable_runtime_query_interrupt) {
     // Shared lock to allow simultaneous interrupts of multiple sessions
-    mapd_shared_lock<mapd_shared_mutex> read_lock(sessions_mutex_);
+    mapd_shared_lock<mapd_shared_mutex> read_lock(
+        get_session_shard(interrupt_session).mutex);
 
     auto session_it = get_session_it_unsafe(interrupt_session, read_lock);
     auto& cat = session_it->second.get()->getCatalog();
@@ -678,6 +1130,7 @@ void DBHandler::get_server_status(TServerStatus& _return, const TSessionId& sess
   _return.start_time = start_time_;
   _return.edition = MAPD_EDITION;
   _return.host_name = get_hostname();
+  _return.catalogs_loaded = catalogs_loaded_;
 }
 
 void DBHandler::get_status(std::vector<TServerStatus>& _return,
@@ -693,6 +1146,7 @@ void DBHandler::get_status(std::vector<TServerStatus>& _return,
   ret.start_time = start_time_;
   ret.edition = MAPD_EDITION;
   ret.host_name = get_hostname();
+  ret.catalogs_loaded = catalogs_loaded_;
 
   // TSercivePort tcp_port{}
 
@@ -886,6 +1340,117 @@ void DBHandler::value_to_thrift_column(const TargetValue& tv,
   }
 }
 
+namespace {
+
+template <typename T, typename V>
+std::string pack_values(const std::vector<V>& values) {
+  std::string buffer(values.size() * sizeof(T), '\0');
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto value = static_cast<T>(values[i]);
+    std::memcpy(&buffer[i * sizeof(T)], &value, sizeof(T));
+  }
+  return buffer;
+}
+
+// Compresses buffer with blosc if that makes it smaller
+void compress_binary(std::string& buffer) {
+  if (buffer.empty()) {
+    return;
+  }
+  auto compressor = BloscCompressor::getCompressor();
+  std::string compressed(compressor->getScratchSpaceSize(buffer.size()), '\0');
+  int64_t compressed_size{0};
+  try {
+    compressed_size =
+        compressor->compress(reinterpret_cast<const uint8_t*>(buffer.data()),
+                             buffer.size(),
+                             reinterpret_cast<uint8_t*>(&compressed[0]),
+                             compressed.size(),
+                             0);
+  } catch (const CompressionFailedError&) {
+    // incompressible buffers do not fit the scratch space
+    return;
+  }
+  if (compressed_size > 0 && static_cast<size_t>(compressed_size) < buffer.size()) {
+    compressed.resize(compressed_size);
+    buffer.swap(compressed);
+  }
+}
+
+}  // namespace
+
+TBinaryColumn DBHandler::thrift_column_to_binary(const TColumn& column,
+                                                 const TTypeInfo& type,
+                                                 const bool compress) {
+  TBinaryColumn binary_column;
+  if (type.is_array || !column.data.arr_col.empty()) {
+    binary_column.is_packed = false;
+    return binary_column;
+  }
+  binary_column.is_packed = true;
+  switch (type.type) {
+    case TDatumType::BOOL:
+    case TDatumType::TINYINT:
+      binary_column.data = pack_values<int8_t>(column.data.int_col);
+      binary_column.value_size = sizeof(int8_t);
+      break;
+    case TDatumType::SMALLINT:
+      binary_column.data = pack_values<int16_t>(column.data.int_col);
+      binary_column.value_size = sizeof(int16_t);
+      break;
+    case TDatumType::INT:
+      binary_column.data = pack_values<int32_t>(column.data.int_col);
+      binary_column.value_size = sizeof(int32_t);
+      break;
+    case TDatumType::FLOAT:
+      binary_column.data = pack_values<float>(column.data.real_col);
+      binary_column.value_size = sizeof(float);
+      break;
+    case TDatumType::DECIMAL:
+    case TDatumType::DOUBLE:
+      binary_column.data = pack_values<double>(column.data.real_col);
+      binary_column.value_size = sizeof(double);
+      break;
+    case TDatumType::STR:
+    case TDatumType::POINT:
+    case TDatumType::LINESTRING:
+    case TDatumType::POLYGON:
+    case TDatumType::MULTIPOLYGON:
+    case TDatumType::GEOMETRY:
+    case TDatumType::GEOGRAPHY: {
+      std::vector<int32_t> offsets;
+      offsets.reserve(column.data.str_col.size());
+      for (const auto& str : column.data.str_col) {
+        binary_column.data += str;
+        offsets.push_back(binary_column.data.size());
+      }
+      binary_column.offsets = pack_values<int32_t>(offsets);
+      binary_column.value_size = 0;
+      break;
+    }
+    default:
+      // BIGINT, and the times and intervals in their units
+      binary_column.data = pack_values<int64_t>(column.data.int_col);
+      binary_column.value_size = sizeof(int64_t);
+  }
+  const auto null_it = std::find(column.nulls.begin(), column.nulls.end(), true);
+  if (null_it != column.nulls.end()) {
+    binary_column.nulls.assign((column.nulls.size() + 7) / 8, '\0');
+    for (size_t i = null_it - column.nulls.begin(); i < column.nulls.size(); ++i) {
+      if (column.nulls[i]) {
+        binary_column.nulls[i / 8] |= 1 << (i % 8);
+      }
+    }
+  }
+  binary_column.data_size = binary_column.data.size();
+  binary_column.offsets_size = binary_column.offsets.size();
+  if (compress) {
+    compress_binary(binary_column.data);
+    compress_binary(binary_column.offsets);
+  }
+  return binary_column;
+}
+
 TDatum DBHandler::value_to_thrift(const TargetValue& tv, const SQLTypeInfo& ti) {
   TDatum datum;
   const auto scalar_tv = boost::get<ScalarTargetValue>(&tv);
@@ -1062,6 +1627,18 @@ void DBHandler::sql_execute(TQueryResult& _return,
         _return.execution_time_ms,
         "total_time_ms",  // BE-3420 - Redundant with duration field
         stdlog.duration<std::chrono::milliseconds>());
+    if (_return.gpu_memory_peak_bytes) {
+      stdlog.appendNameValuePairs("gpu_memory_peak_bytes",
+                                  _return.gpu_memory_peak_bytes,
+                                  "gpu_input_chunk_peak_bytes",
+                                  _return.gpu_input_chunk_peak_bytes,
+                                  "gpu_output_buffer_peak_bytes",
+                                  _return.gpu_output_buffer_peak_bytes,
+                                  "gpu_hash_table_peak_bytes",
+                                  _return.gpu_hash_table_peak_bytes,
+                                  "gpu_scratch_peak_bytes",
+                                  _return.gpu_scratch_peak_bytes);
+    }
     VLOG(1) << "Table Schema Locks:\n" << lockmgr::TableSchemaLockMgr::instance();
     VLOG(1) << "Table Data Locks:\n" << lockmgr::TableDataLockMgr::instance();
   } catch (const std::exception& e) {
@@ -1079,6 +1656,92 @@ void DBHandler::sql_execute(TQueryResult& _return,
   }
 }
 
+void DBHandler::sql_execute_binary(TQueryResult& _return,
+                                   const TSessionId& session,
+                                   const std::string& query_str,
+                                   const std::string& nonce,
+                                   const int32_t first_n,
+                                   const int32_t at_most_n,
+                                   const bool compress) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  sql_execute(_return, session, query_str, true, nonce, first_n, at_most_n);
+  auto& row_set = _return.row_set;
+  if (!row_set.is_columnar || row_set.columns.size() != row_set.row_desc.size()) {
+    return;
+  }
+  size_t data_size{0};
+  size_t binary_size{0};
+  const auto packing_time_ms = measure<>::execution([&]() {
+    for (size_t i = 0; i < row_set.columns.size(); ++i) {
+      auto binary_column = thrift_column_to_binary(
+          row_set.columns[i], row_set.row_desc[i].col_type, compress);
+      if (binary_column.is_packed) {
+        row_set.columns[i] = TColumn();
+        data_size += binary_column.data_size + binary_column.offsets_size;
+        binary_size += binary_column.data.size() + binary_column.offsets.size();
+      }
+      row_set.binary_columns.push_back(std::move(binary_column));
+    }
+  });
+  stdlog.appendNameValuePairs("packing_time_ms",
+                              packing_time_ms,
+                              "packed_bytes",
+                              data_size,
+                              "sent_bytes",
+                              binary_size);
+}
+
+void DBHandler::sql_execute_batch(std::vector<TBatchQueryResult>& _return,
+                                  const TSessionId& session,
+                                  const std::vector<std::string>& queries,
+                                  const bool column_format,
+                                  const std::string& nonce,
+                                  const int32_t first_n,
+                                  const int32_t at_most_n) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  stdlog.appendNameValuePairs("query_count", queries.size());
+  _return.clear();
+  _return.resize(queries.size());
+  // the parsing and the result conversion of the queries overlap, their execution is
+  // still bounded by the dispatch queue
+  const size_t worker_count = std::min(
+      queries.size(), static_cast<size_t>(std::max(system_parameters_.num_executors, 1)));
+  const auto client_address = TrackingProcessor::client_address;
+  const auto client_protocol = TrackingProcessor::client_protocol;
+  std::atomic<size_t> next_query{0};
+  auto execute_queries = [&] {
+    TrackingProcessor::client_address = client_address;
+    TrackingProcessor::client_protocol = client_protocol;
+    for (size_t i = next_query++; i < queries.size(); i = next_query++) {
+      auto& batch_result = _return[i];
+      try {
+        sql_execute(batch_result.result,
+                    session,
+                    queries[i],
+                    column_format,
+                    nonce,
+                    first_n,
+                    at_most_n);
+        batch_result.success = true;
+      } catch (const TOmniSciException& e) {
+        batch_result.success = false;
+        batch_result.error_msg = e.error_msg;
+      } catch (const std::exception& e) {
+        batch_result.success = false;
+        batch_result.error_msg = e.what();
+      }
+    }
+  };
+  std::vector<std::future<void>> workers;
+  for (size_t i = 1; i < worker_count; ++i) {
+    workers.push_back(std::async(std::launch::async, execute_queries));
+  }
+  execute_queries();
+  for (auto& worker : workers) {
+    worker.get();
+  }
+}
+
 void DBHandler::sql_execute_df(TDataFrame& _return,
                                const TSessionId& session,
                                const std::string& query_str,
@@ -1154,6 +1817,55 @@ void DBHandler::sql_execute_gdf(TDataFrame& _return,
   sql_execute_df(_return, session, query_str, TDeviceType::GPU, device_id, first_n);
 }
 
+std::shared_ptr<arrow::RecordBatch> DBHandler::sql_execute_arrow(
+    const TSessionId& session,
+    const std::string& query_str) {
+  auto session_ptr = get_session_ptr(session);
+  auto query_state = create_query_state(session_ptr, query_str);
+  auto stdlog = STDLOG(session_ptr, query_state);
+
+  mapd_shared_lock<mapd_shared_mutex> executeReadLock(
+      *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
+          legacylockmgr::ExecutorOuterLock, true));
+
+  try {
+    ParserWrapper pw{query_str};
+    if (!pw.is_ddl && !pw.is_update_dml &&
+        !(pw.getExplainType() == ParserWrapper::ExplainType::Other)) {
+      if (pw.isCalciteExplain()) {
+        throw std::runtime_error("explain is not unsupported by Arrow Flight");
+      }
+      TPlanResult result;
+      lockmgr::LockedTableDescriptors locks;
+      std::tie(result, locks) = parse_to_ra(query_state->createQueryStateProxy(),
+                                            query_str,
+                                            {},
+                                            true,
+                                            system_parameters_);
+      int64_t execution_time_ms{0};
+      const auto converter = execute_rel_alg_arrow(execution_time_ms,
+                                                   result.plan_result,
+                                                   query_state->createQueryStateProxy(),
+                                                   *session_ptr,
+                                                   ExecutorDeviceType::CPU,
+                                                   0,
+                                                   -1);
+      std::shared_ptr<arrow::RecordBatch> record_batch;
+      const auto conversion_time_ms =
+          measure<>::execution([&] { record_batch = converter->convertToArrow(); });
+      stdlog.appendNameValuePairs("execution_time_ms",
+                                  execution_time_ms,
+                                  "arrow_conversion_time_ms",
+                                  conversion_time_ms);
+      return record_batch;
+    }
+  } catch (std::exception& e) {
+    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+  }
+  THROW_MAPD_EXCEPTION(
+      "Exception: DDL or update DML are not unsupported by Arrow Flight");
+}
+
 // For now we have only one user of a data frame in all cases.
 void DBHandler::deallocate_df(const TSessionId& session,
                               const TDataFrame& df,
@@ -2024,6 +2736,17 @@ void DBHandler::get_table_details_impl(TTableDetails& _return,
     _return.shard_count = td->nShards;
     _return.key_metainfo = td->keyMetainfo;
     _return.is_temporary = td->persistenceLevel == Data_Namespace::MemoryLevel::CPU_LEVEL;
+    if (!td->isView) {
+      const auto physical_cds =
+          cat.getAllColumnMetadataForTable(td->tableId, false, false, true);
+      for (const auto cd : physical_cds) {
+        const auto column_statistics = cat.getColumnStatistics(td->tableId, cd->columnId);
+        if (column_statistics) {
+          _return.analyzed_row_count = column_statistics->rowCount;
+          break;
+        }
+      }
+    }
     _return.partition_detail =
         td->partitions.empty()
             ? TPartitionDetail::DEFAULT
@@ -2251,6 +2974,23 @@ void DBHandler::clear_gpu_memory(const TSessionId& session) {
   }
 }
 
+void DBHandler::compact_memory(const TSessionId& session,
+                               const std::string& memory_level) {
+  auto stdlog = STDLOG(get_session_ptr(session));
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  auto session_ptr = stdlog.getConstSessionInfo();
+  if (!session_ptr->get_currentUser().isSuper) {
+    THROW_MAPD_EXCEPTION("Superuser privilege is required to run compact_memory");
+  }
+  try {
+    Executor::compactMemory(!memory_level.compare("gpu")
+                                ? Data_Namespace::MemoryLevel::GPU_LEVEL
+                                : Data_Namespace::MemoryLevel::CPU_LEVEL);
+  } catch (const std::exception& e) {
+    THROW_MAPD_EXCEPTION(e.what());
+  }
+}
+
 void DBHandler::clear_cpu_memory(const TSessionId& session) {
   auto stdlog = STDLOG(get_session_ptr(session));
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
@@ -2302,6 +3042,16 @@ void DBHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
     nodeInfo.max_num_pages = memInfo.maxNumPages;
     nodeInfo.num_pages_allocated = memInfo.numPageAllocated;
     nodeInfo.is_allocation_capped = memInfo.isAllocationCapped;
+    nodeInfo.is_pinned = memInfo.isPinned;
+    nodeInfo.host_to_device_bytes = memInfo.hostToDeviceBytes;
+    nodeInfo.host_to_device_bandwidth_gbs = memInfo.hostToDeviceBandwidthGBs;
+    nodeInfo.device_to_host_bytes = memInfo.deviceToHostBytes;
+    nodeInfo.device_to_host_bandwidth_gbs = memInfo.deviceToHostBandwidthGBs;
+    nodeInfo.eviction_policy = memInfo.evictionPolicy;
+    nodeInfo.num_hits = memInfo.numHits;
+    nodeInfo.num_misses = memInfo.numMisses;
+    nodeInfo.num_evictions = memInfo.numEvictions;
+    nodeInfo.fragmentation_ratio = memInfo.fragmentationRatio;
     for (auto gpu : memInfo.nodeMemoryData) {
       TMemoryData md;
       md.slab = gpu.slabNum;
@@ -2340,7 +3090,7 @@ void DBHandler::set_execution_mode(const TSessionId& session,
                                    const TExecuteMode::type mode) {
   auto stdlog = STDLOG(get_session_ptr(session));
   stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
-  mapd_unique_lock<mapd_shared_mutex> write_lock(sessions_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> write_lock(get_session_shard(session).mutex);
   auto session_it = get_session_it_unsafe(session, write_lock);
   if (leaf_aggregator_.leafCount() > 0) {
     leaf_aggregator_.set_execution_mode(session, mode);
@@ -2488,9 +3238,10 @@ void DBHandler::load_table_binary_columnar(const TSessionId& session,
   auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
       session_ptr->getCatalog(), table_name);
 
-  size_t numRows = 0;
-  size_t import_idx = 0;  // index into the TColumn vector being loaded
-  size_t col_idx = 0;     // index into column description vector
+  // the column descriptor and the import buffer of each TColumn, the physical columns of
+  // the geo columns are filled from their WKT after
+  std::vector<std::pair<const ColumnDescriptor*, size_t>> columns;
+  size_t col_idx = 0;  // index into column description vector
   try {
     size_t skip_physical_cols = 0;
     for (auto cd : loader->get_column_descs()) {
@@ -2499,10 +3250,62 @@ void DBHandler::load_table_binary_columnar(const TSessionId& session,
           throw std::runtime_error("Unexpected physical column");
         }
         skip_physical_cols--;
-        continue;
+      } else {
+        columns.emplace_back(cd, col_idx);
+        if (cd->columnType.is_geometry()) {
+          skip_physical_cols = cd->columnType.get_physical_cols();
+        }
+      }
+      col_idx++;
+    }
+  } catch (const std::exception& e) {
+    std::ostringstream oss;
+    oss << "load_table_binary_columnar: Input exception thrown: " << e.what()
+        << ". Issue at column : " << (col_idx + 1) << ". Import aborted";
+    THROW_MAPD_EXCEPTION(oss.str());
+  }
+  CHECK_EQ(columns.size(), cols.size());
+
+  // the columns are converted and dictionary encoded concurrently, the strings of the
+  // sharded tables are only encoded shard by shard when they're loaded
+  const bool encode_dict_strings = !loader->getTableDesc()->nShards;
+  std::vector<size_t> col_row_counts(columns.size());
+  std::vector<std::exception_ptr> col_errors(columns.size());
+  std::atomic<size_t> next_import_idx{0};
+  std::vector<std::future<void>> converters;
+  const auto converter_count =
+      std::min(columns.size(), static_cast<size_t>(cpu_threads()));
+  for (size_t i = 0; i < converter_count; ++i) {
+    converters.push_back(std::async(std::launch::async, [&] {
+      for (size_t import_idx = next_import_idx++; import_idx < columns.size();
+           import_idx = next_import_idx++) {
+        const auto [cd, buffer_idx] = columns[import_idx];
+        try {
+          auto& import_buffer = import_buffers[buffer_idx];
+          col_row_counts[import_idx] = import_buffer->add_values(cd, cols[import_idx]);
+          if (encode_dict_strings) {
+            import_buffer->encodeDictStrings();
+          }
+        } catch (...) {
+          col_errors[import_idx] = std::current_exception();
+        }
+      }
+    }));
+  }
+  for (auto& converter : converters) {
+    converter.get();
+  }
+
+  size_t numRows = 0;
+  try {
+    for (size_t import_idx = 0; import_idx < columns.size(); ++import_idx) {
+      const auto [cd, buffer_idx] = columns[import_idx];
+      col_idx = buffer_idx;
+      if (col_errors[import_idx]) {
+        std::rethrow_exception(col_errors[import_idx]);
       }
-      size_t colRows = import_buffers[col_idx]->add_values(cd, cols[import_idx]);
-      if (col_idx == 0) {
+      const auto colRows = col_row_counts[import_idx];
+      if (import_idx == 0) {
         numRows = colRows;
       } else if (colRows != numRows) {
         std::ostringstream oss;
@@ -2511,14 +3314,11 @@ void DBHandler::load_table_binary_columnar(const TSessionId& session,
             << col_idx << " has " << colRows << " rows";
         THROW_MAPD_EXCEPTION(oss.str());
       }
-      // Advance to the next column in the table
-      col_idx++;
 
       // For geometry columns: process WKT strings and fill physical columns
       if (cd->columnType.is_geometry()) {
-        auto geo_col_idx = col_idx - 1;
         const auto wkt_or_wkb_hex_column =
-            import_buffers[geo_col_idx]->getGeoStringBuffer();
+            import_buffers[buffer_idx]->getGeoStringBuffer();
         std::vector<std::vector<double>> coords_column, bounds_column;
         std::vector<std::vector<int>> ring_sizes_column, poly_rings_column;
         int render_group = 0;
@@ -2536,21 +3336,19 @@ void DBHandler::load_table_binary_columnar(const TSessionId& session,
               << cd->columnName;
           THROW_MAPD_EXCEPTION(oss.str());
         }
-        // Populate physical columns, advance col_idx
+        // Populate physical columns, which follow the geo column
+        size_t physical_col_idx = buffer_idx + 1;
         import_export::Importer::set_geo_physical_import_buffer_columnar(
             cat,
             cd,
             import_buffers,
-            col_idx,
+            physical_col_idx,
             coords_column,
             bounds_column,
             ring_sizes_column,
             poly_rings_column,
             render_group);
-        skip_physical_cols = cd->columnType.get_physical_cols();
       }
-      // Advance to the next column of values being loaded
-      import_idx++;
     }
   } catch (const std::exception& e) {
     std::ostringstream oss;
@@ -2652,6 +3450,71 @@ void DBHandler::load_table_binary_arrow(const TSessionId& session,
   loader->load(import_buffers, numRows);
 }
 
+void DBHandler::load_table_arrow(
+    const TSessionId& session,
+    const std::string& table_name,
+    const std::function<std::shared_ptr<arrow::RecordBatch>()>& next_batch) {
+  auto stdlog = STDLOG(get_session_ptr(session), "table_name", table_name);
+  auto session_ptr = stdlog.getConstSessionInfo();
+  check_read_only("load_table_arrow");
+
+  auto batch = next_batch();
+  if (!batch) {
+    return;
+  }
+  std::unique_ptr<import_export::Loader> loader;
+  std::vector<std::unique_ptr<import_export::TypedImportBuffer>> import_buffers;
+  auto read_lock = prepare_columnar_loader(*session_ptr,
+                                           table_name,
+                                           static_cast<size_t>(batch->num_columns()),
+                                           &loader,
+                                           &import_buffers);
+  auto insert_data_lock = lockmgr::InsertDataLockMgr::getWriteLockForTable(
+      session_ptr->getCatalog(), table_name);
+
+  // the batches of a put are checkpointed at once, and rolled back together on errors
+  const bool checkpoint_once = leaf_aggregator_.leafCount() == 0;
+  const auto start_epoch = checkpoint_once ? loader->getTableEpoch() : 0;
+  size_t num_rows_loaded = 0;
+  try {
+    for (; batch; batch = next_batch()) {
+      if (static_cast<size_t>(batch->num_columns()) != import_buffers.size()) {
+        throw std::runtime_error("Record batches with different numbers of columns");
+      }
+      size_t num_rows = 0;
+      size_t col_idx = 0;
+      for (auto cd : loader->get_column_descs()) {
+        auto& array = *batch->column(col_idx);
+        import_export::ArraySliceRange row_slice(0, array.length());
+        num_rows = import_buffers[col_idx]->add_arrow_values(
+            cd, array, true, row_slice, nullptr);
+        col_idx++;
+      }
+      const bool loaded = checkpoint_once
+                              ? loader->loadNoCheckpoint(import_buffers, num_rows)
+                              : loader->load(import_buffers, num_rows);
+      if (!loaded) {
+        throw std::runtime_error("Could not load the record batch into " + table_name);
+      }
+      num_rows_loaded += num_rows;
+      for (auto& import_buffer : import_buffers) {
+        import_buffer->clear();
+      }
+    }
+    if (checkpoint_once) {
+      loader->checkpoint();
+    }
+  } catch (const std::exception& e) {
+    if (checkpoint_once) {
+      loader->setTableEpoch(start_epoch);
+    }
+    LOG(ERROR) << "Arrow Flight put into " << table_name << " failed: " << e.what()
+               << ". Import aborted";
+    THROW_MAPD_EXCEPTION(std::string("Exception: ") + e.what());
+  }
+  stdlog.appendNameValuePairs("rows", num_rows_loaded);
+}
+
 void DBHandler::load_table(const TSessionId& session,
                            const std::string& table_name,
                            const std::vector<TStringRow>& rows) {
@@ -3799,6 +4662,7 @@ void DBHandler::create_table(const TSessionId& session,
       col_stmt.append(" ENCODING " + thrift_to_encoding_name(col.col_type));
       if (thrift_to_encoding(col.col_type.encoding) == kENCODING_DICT ||
           thrift_to_encoding(col.col_type.encoding) == kENCODING_FIXED ||
+          thrift_to_encoding(col.col_type.encoding) == kENCODING_DIFF ||
           thrift_to_encoding(col.col_type.encoding) == kENCODING_GEOINT) {
         col_stmt.append("(" + std::to_string(col.col_type.comp_param) + ")");
       }
@@ -4595,7 +5459,8 @@ void DBHandler::get_heap_profile(std::string& profile, const TSessionId& session
 #endif  // HAVE_PROFILER
 }
 
-// NOTE: Only call check_session_exp_unsafe() when you hold a lock on sessions_mutex_.
+// NOTE: Only call check_session_exp_unsafe() when you hold the lock of the shard of the
+// session.
 void DBHandler::check_session_exp_unsafe(const SessionMap::iterator& session_it) {
   if (session_it->second.use_count() > 2 ||
       isInMemoryCalciteSession(session_it->second->get_currentUser())) {
@@ -4629,7 +5494,7 @@ std::shared_ptr<const Catalog_Namespace::SessionInfo> DBHandler::get_const_sessi
 }
 
 Catalog_Namespace::SessionInfo DBHandler::get_session_copy(const TSessionId& session) {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(sessions_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(get_session_shard(session).mutex);
   return *get_session_it_unsafe(session, read_lock)->second;
 }
 
@@ -4641,7 +5506,7 @@ std::shared_ptr<Catalog_Namespace::SessionInfo> DBHandler::get_session_copy_ptr(
   // care about the changes then use `get_const_session_ptr` if you do then use this
   // function to get a copy. We should eventually aim to merge both
   // `get_const_session_ptr` and `get_session_copy_ptr`.
-  mapd_shared_lock<mapd_shared_mutex> read_lock(sessions_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(get_session_shard(session).mutex);
   auto& session_info_ref = *get_session_it_unsafe(session, read_lock)->second;
   return std::make_shared<Catalog_Namespace::SessionInfo>(session_info_ref);
 }
@@ -4659,7 +5524,7 @@ std::shared_ptr<Catalog_Namespace::SessionInfo> DBHandler::get_session_ptr(
   if (session_id.empty()) {
     return {};
   }
-  mapd_shared_lock<mapd_shared_mutex> read_lock(sessions_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(get_session_shard(session_id).mutex);
   return get_session_it_unsafe(session_id, read_lock)->second;
 }
 
@@ -4765,11 +5630,28 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
                                                      nullptr,
                                                      nullptr),
                          {}};
-  _return.execution_time_ms += measure<>::execution([&]() {
+  QueryProfile query_profile;
+  if (explain_info.explain_analyze) {
+    ra_executor.setQueryProfile(&query_profile);
+  }
+  static auto& execution_histogram = request_phase_histogram("execution");
+  const auto execution_time_ms = measure<>::execution([&]() {
+    metrics::ScopedTimer execution_timer(execution_histogram);
     result = ra_executor.executeRelAlgQuery(co, eo, explain_info.explain_plan, nullptr);
   });
+  _return.execution_time_ms += execution_time_ms;
   // reduce execution time by the time spent during queue waiting
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  const auto& gpu_memory_usage = result.getRows()->getGpuMemoryUsage();
+  _return.gpu_memory_peak_bytes = gpu_memory_usage.peak_total_bytes;
+  _return.gpu_input_chunk_peak_bytes =
+      gpu_memory_usage.getPeakBytes(DeviceMemoryCategory::InputChunks);
+  _return.gpu_output_buffer_peak_bytes =
+      gpu_memory_usage.getPeakBytes(DeviceMemoryCategory::OutputBuffers);
+  _return.gpu_hash_table_peak_bytes =
+      gpu_memory_usage.getPeakBytes(DeviceMemoryCategory::HashTables);
+  _return.gpu_scratch_peak_bytes =
+      gpu_memory_usage.getPeakBytes(DeviceMemoryCategory::Scratch);
   VLOG(1) << cat.getDataMgr().getSystemMemoryUsage();
   const auto& filter_push_down_info = result.getPushedDownFilterInfo();
   if (!filter_push_down_info.empty()) {
@@ -4777,6 +5659,9 @@ std::vector<PushedDownFilterInfo> DBHandler::execute_rel_alg(
   }
   if (explain_info.justExplain()) {
     convert_explain(_return, *result.getRows(), column_format);
+  } else if (explain_info.explain_analyze) {
+    query_profile.setTotalTime(execution_time_ms);
+    convert_explain(_return, ResultSet(query_profile.toJson()), column_format);
   } else if (!explain_info.justCalciteExplain()) {
     convert_rows(_return,
                  timer.createQueryStateProxy(),
@@ -4796,6 +5681,38 @@ void DBHandler::execute_rel_alg_df(TDataFrame& _return,
                                    const ExecutorDeviceType device_type,
                                    const size_t device_id,
                                    const int32_t first_n) const {
+  const auto converter = execute_rel_alg_arrow(_return.execution_time_ms,
+                                               query_ra,
+                                               query_state_proxy,
+                                               session_info,
+                                               device_type,
+                                               device_id,
+                                               first_n);
+  ArrowResult arrow_result;
+  _return.arrow_conversion_time_ms +=
+      measure<>::execution([&] { arrow_result = converter->getArrowResult(); });
+  _return.sm_handle =
+      std::string(arrow_result.sm_handle.begin(), arrow_result.sm_handle.end());
+  _return.sm_size = arrow_result.sm_size;
+  _return.df_handle =
+      std::string(arrow_result.df_handle.begin(), arrow_result.df_handle.end());
+  if (device_type == ExecutorDeviceType::GPU) {
+    std::lock_guard<std::mutex> map_lock(handle_to_dev_ptr_mutex_);
+    CHECK(!ipc_handle_to_dev_ptr_.count(_return.df_handle));
+    ipc_handle_to_dev_ptr_.insert(
+        std::make_pair(_return.df_handle, arrow_result.serialized_cuda_handle));
+  }
+  _return.df_size = arrow_result.df_size;
+}
+
+std::unique_ptr<ArrowResultSetConverter> DBHandler::execute_rel_alg_arrow(
+    int64_t& execution_time_ms,
+    const std::string& query_ra,
+    QueryStateProxy query_state_proxy,
+    const Catalog_Namespace::SessionInfo& session_info,
+    const ExecutorDeviceType device_type,
+    const size_t device_id,
+    const int32_t first_n) const {
   const auto& cat = session_info.getCatalog();
   CHECK(device_type == ExecutorDeviceType::CPU ||
         session_info.get_executor_device_type() == ExecutorDeviceType::GPU);
@@ -4836,32 +5753,16 @@ void DBHandler::execute_rel_alg_df(TDataFrame& _return,
                                                      nullptr,
                                                      nullptr),
                          {}};
-  _return.execution_time_ms += measure<>::execution(
+  execution_time_ms += measure<>::execution(
       [&]() { result = ra_executor.executeRelAlgQuery(co, eo, false, nullptr); });
-  _return.execution_time_ms -= result.getRows()->getQueueTime();
-  const auto rs = result.getRows();
-  const auto converter =
-      std::make_unique<ArrowResultSetConverter>(rs,
-                                                data_mgr_,
-                                                device_type,
-                                                device_id,
-                                                getTargetNames(result.getTargetsMeta()),
-                                                first_n);
-  ArrowResult arrow_result;
-  _return.arrow_conversion_time_ms +=
-      measure<>::execution([&] { arrow_result = converter->getArrowResult(); });
-  _return.sm_handle =
-      std::string(arrow_result.sm_handle.begin(), arrow_result.sm_handle.end());
-  _return.sm_size = arrow_result.sm_size;
-  _return.df_handle =
-      std::string(arrow_result.df_handle.begin(), arrow_result.df_handle.end());
-  if (device_type == ExecutorDeviceType::GPU) {
-    std::lock_guard<std::mutex> map_lock(handle_to_dev_ptr_mutex_);
-    CHECK(!ipc_handle_to_dev_ptr_.count(_return.df_handle));
-    ipc_handle_to_dev_ptr_.insert(
-        std::make_pair(_return.df_handle, arrow_result.serialized_cuda_handle));
-  }
-  _return.df_size = arrow_result.df_size;
+  execution_time_ms -= result.getRows()->getQueueTime();
+  return std::make_unique<ArrowResultSetConverter>(
+      result.getRows(),
+      data_mgr_,
+      device_type,
+      device_id,
+      getTargetNames(result.getTargetsMeta()),
+      first_n);
 }
 
 std::vector<TargetMetaInfo> DBHandler::getTargetMetaInfo(
@@ -4935,6 +5836,58 @@ TRowDescriptor DBHandler::convert_target_metainfo(
   return row_desc;
 }
 
+bool DBHandler::columns_to_thrift(std::vector<TColumn>& tcolumns,
+                                  const std::vector<TargetMetaInfo>& targets,
+                                  const ResultSet& results,
+                                  const int32_t first_n,
+                                  const int32_t at_most_n) {
+  for (size_t i = 0; i < results.colCount(); ++i) {
+    // the strings come translated in the rows
+    if (results.getColType(i).is_string() || !results.isTypedColumnAccessPossible(i)) {
+      return false;
+    }
+  }
+  const auto entry_count = results.entryCount();
+  // the values of each column are read straight from the storage of the results, one
+  // column at a time, instead of from the TargetValues of their rows
+  const auto to_thrift_column = [&](const size_t col_idx, const auto& values) {
+    size_t row_count = values.size();
+    if (first_n >= 0) {
+      row_count = std::min(row_count, static_cast<size_t>(first_n));
+    }
+    if (at_most_n >= 0 && row_count > static_cast<size_t>(at_most_n)) {
+      THROW_MAPD_EXCEPTION("The result contains more rows than the specified cap of " +
+                           std::to_string(at_most_n));
+    }
+    const auto& ti = targets[col_idx].get_type_info();
+    for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+      value_to_thrift_column(ScalarTargetValue(values[row_idx]), ti, tcolumns[col_idx]);
+    }
+  };
+  for (size_t i = 0; i < results.colCount(); ++i) {
+    switch (results.getColType(i).get_type()) {
+      case kFLOAT: {
+        std::vector<float> values;
+        results.getColumnValues(i, 0, entry_count, values);
+        to_thrift_column(i, values);
+        break;
+      }
+      case kDOUBLE: {
+        std::vector<double> values;
+        results.getColumnValues(i, 0, entry_count, values);
+        to_thrift_column(i, values);
+        break;
+      }
+      default: {
+        std::vector<int64_t> values;
+        results.getColumnValues(i, 0, entry_count, values);
+        to_thrift_column(i, values);
+      }
+    }
+  }
+  return true;
+}
+
 template <class R>
 void DBHandler::convert_rows(TQueryResult& _return,
                              QueryStateProxy query_state_proxy,
@@ -4944,11 +5897,17 @@ void DBHandler::convert_rows(TQueryResult& _return,
                              const int32_t first_n,
                              const int32_t at_most_n) const {
   query_state::Timer timer = query_state_proxy.createTimer(__func__);
+  static auto& result_conversion_histogram = request_phase_histogram("result_conversion");
+  metrics::ScopedTimer result_conversion_timer(result_conversion_histogram);
   _return.row_set.row_desc = convert_target_metainfo(targets);
   int32_t fetched{0};
   if (column_format) {
     _return.row_set.is_columnar = true;
     std::vector<TColumn> tcolumns(results.colCount());
+    if (columns_to_thrift(tcolumns, targets, results, first_n, at_most_n)) {
+      _return.row_set.columns = std::move(tcolumns);
+      return;
+    }
     while (first_n == -1 || fetched < first_n) {
       const auto crt_row = results.getNextRow(true, true);
       if (crt_row.empty()) {
@@ -5235,7 +6194,8 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
           }
         });
     CHECK(dispatch_queue_);
-    dispatch_queue_->submit(execute_rel_alg_task);
+    dispatch_queue_->submit(execute_rel_alg_task,
+                            get_query_priority(session_ptr->get_currentUser().userName));
     auto result_future = execute_rel_alg_task->get_future();
     result_future.get();
     return;
@@ -5273,7 +6233,24 @@ void DBHandler::sql_execute_impl(TQueryResult& _return,
         if (optimize_stmt->shouldVacuumDeletedRows()) {
           optimizer.vacuumDeletedRows();
         }
+        optimizer.sortFragmentRows();
         optimizer.recomputeMetadata();
+        if (optimize_stmt->shouldReencodeColumns()) {
+          // after the metadata was narrowed to the values
+          for (const auto& [cd, new_type] : optimizer.getNarrowerColumnTypes()) {
+            cat.reencodeColumn(td, cd, new_type);
+          }
+        }
+        if (optimize_stmt->shouldCompactDictionaries()) {
+          bool compacted{false};
+          for (const auto dict_id : optimizer.getCompactableDictionaryIds()) {
+            compacted = cat.compactDictionary(td, dict_id) > 0 || compacted;
+          }
+          if (compacted) {
+            // cached results and hash tables hold the old string ids
+            UpdateTriggeredCacheInvalidator::invalidateCaches();
+          }
+        }
       });
 
       return;
@@ -5470,6 +6447,8 @@ std::pair<TPlanResult, lockmgr::LockedTableDescriptors> DBHandler::parse_to_ra(
     const SystemParameters system_parameters,
     bool check_privileges) {
   query_state::Timer timer = query_state_proxy.createTimer(__func__);
+  static auto& parse_histogram = request_phase_histogram("parse");
+  metrics::ScopedTimer parse_timer(parse_histogram);
   ParserWrapper pw{query_str};
   const std::string actual_query{pw.isSelectExplain() ? pw.actual_query : query_str};
   TPlanResult result;
@@ -5848,6 +6827,29 @@ int32_t DBHandler::get_table_epoch_by_name(const TSessionId& session,
   return cat.getTableEpoch(db_id, td->tableId);
 }
 
+void DBHandler::get_table_io_stats(TTableIoStats& _return,
+                                   const TSessionId& session,
+                                   const std::string& table_name) {
+  auto stdlog = STDLOG(get_session_ptr(session), "table_name", table_name);
+  stdlog.appendNameValuePairs("client", getConnectionInfo().toString());
+  auto session_ptr = stdlog.getConstSessionInfo();
+  auto const& cat = session_ptr->getCatalog();
+  auto td = cat.getMetadataForTable(table_name, false);
+  if (!td) {
+    THROW_MAPD_EXCEPTION("Table " + table_name + " does not exist.");
+  }
+  File_Namespace::FileIoStats stats;
+  for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+    stats += data_mgr_->getTableIoStats(cat.getCurrentDB().dbId, physical_td->tableId);
+  }
+  _return.bytes_read = stats.bytesRead;
+  _return.pages_read = stats.pagesRead;
+  _return.read_ahead_hits = stats.readAheadHits;
+  _return.num_syncs = stats.numSyncs;
+  _return.sync_time_us = stats.syncMicros;
+  _return.checksum_failures = stats.checksumFailures;
+}
+
 void DBHandler::set_license_key(TLicenseInfo& _return,
                                 const TSessionId& session,
                                 const std::string& key,
@@ -6068,7 +7070,6 @@ void DBHandler::getUserSessions(const Catalog_Namespace::SessionInfo& session_in
     throw std::runtime_error(
         "SHOW USER SESSIONS failed, because it can only be executed by super user.");
   } else {
-    mapd_lock_guard<mapd_shared_mutex> read_lock(sessions_mutex_);
     const std::vector<std::string> col_names{
         "session_id", "login_name", "client_address", "db_name"};
 
@@ -6084,8 +7085,10 @@ void DBHandler::getUserSessions(const Catalog_Namespace::SessionInfo& session_in
     _return.row_set.row_desc = row_desc;
     _return.row_set.is_columnar = true;
 
-    if (!sessions_.empty()) {
-      for (auto sessions = sessions_.begin(); sessions_.end() != sessions; sessions++) {
+    for (auto& shard : session_shards_) {
+      mapd_shared_lock<mapd_shared_mutex> read_lock(shard.mutex);
+      for (auto sessions = shard.sessions.begin(); shard.sessions.end() != sessions;
+           sessions++) {
         const auto id = sessions->first;
         const auto show_session_ptr = sessions->second;
         int col_num = 0;
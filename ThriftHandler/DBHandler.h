@@ -46,6 +46,7 @@
 #include "QueryEngine/JsonAccessors.h"
 #include "QueryEngine/QueryDispatchQueue.h"
 #include "QueryEngine/TableGenerations.h"
+#include "Shared/Metrics.h"
 #include "Shared/StringTransform.h"
 #include "Shared/SystemParameters.h"
 #include "Shared/geosupport.h"
@@ -66,7 +67,9 @@
 #include <thrift/transport/THttpTransport.h>
 #include <thrift/transport/TSocket.h>
 #include <thrift/transport/TTransport.h>
+#include <array>
 #include <atomic>
+#include <condition_variable>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -99,6 +102,11 @@ using namespace std::string_literals;
 
 class MapDAggHandler;
 class MapDLeafHandler;
+class ArrowResultSetConverter;
+
+namespace arrow {
+class RecordBatch;
+}  // namespace arrow
 
 // Multiple concurrent requests for the same session can occur.  For that reason, each
 // request briefly takes a lock to make a copy of the appropriate SessionInfo object. Then
@@ -150,6 +158,20 @@ class TrackingProcessor : public OmniSciProcessor {
   static thread_local std::string client_address;
   static thread_local ClientProtocol client_protocol;
 
+ protected:
+  bool dispatchCall(::apache::thrift::protocol::TProtocol* iprot,
+                    ::apache::thrift::protocol::TProtocol* oprot,
+                    const std::string& fname,
+                    int32_t seqid,
+                    void* callContext) override {
+    metrics::Registry::instance()
+        .counter("omnisci_thrift_requests_total",
+                 "The Thrift requests, by method",
+                 {{"method", fname}})
+        .add();
+    return OmniSciProcessor::dispatchCall(iprot, oprot, fname, seqid, callContext);
+  }
+
  private:
   const bool check_origin_;
 };
@@ -246,6 +268,8 @@ class DBHandler : public OmniSciIf {
                   const std::string& memory_level) override;
   void clear_cpu_memory(const TSessionId& session) override;
   void clear_gpu_memory(const TSessionId& session) override;
+  void compact_memory(const TSessionId& session,
+                      const std::string& memory_level) override;
   void set_table_epoch(const TSessionId& session,
                        const int db_id,
                        const int table_id,
@@ -258,6 +282,9 @@ class DBHandler : public OmniSciIf {
                           const int32_t table_id) override;
   int32_t get_table_epoch_by_name(const TSessionId& session,
                                   const std::string& table_name) override;
+  void get_table_io_stats(TTableIoStats& _return,
+                          const TSessionId& session,
+                          const std::string& table_name) override;
   void get_session_info(TSessionInfo& _return, const TSessionId& session) override;
   // query, render
   void sql_execute(TQueryResult& _return,
@@ -267,6 +294,23 @@ class DBHandler : public OmniSciIf {
                    const std::string& nonce,
                    const int32_t first_n,
                    const int32_t at_most_n) override;
+  // sql_execute in the columnar format, with the columns packed into TBinaryColumn
+  void sql_execute_binary(TQueryResult& _return,
+                          const TSessionId& session,
+                          const std::string& query,
+                          const std::string& nonce,
+                          const int32_t first_n,
+                          const int32_t at_most_n,
+                          const bool compress) override;
+  // sql_execute of each of the queries, which run concurrently on up to num_executors
+  // threads; a failed query doesn't fail the others
+  void sql_execute_batch(std::vector<TBatchQueryResult>& _return,
+                         const TSessionId& session,
+                         const std::vector<std::string>& queries,
+                         const bool column_format,
+                         const std::string& nonce,
+                         const int32_t first_n,
+                         const int32_t at_most_n) override;
   void get_completion_hints(std::vector<TCompletionHint>& hints,
                             const TSessionId& session,
                             const std::string& sql,
@@ -278,6 +322,9 @@ class DBHandler : public OmniSciIf {
                       const TDeviceType::type device_type,
                       const int32_t device_id,
                       const int32_t first_n) override;
+  // Executes query_str on the CPU into a record batch, for Arrow Flight gets
+  std::shared_ptr<arrow::RecordBatch> sql_execute_arrow(const TSessionId& session,
+                                                        const std::string& query_str);
   void sql_execute_gdf(TDataFrame& _return,
                        const TSessionId& session,
                        const std::string& query,
@@ -381,6 +428,12 @@ class DBHandler : public OmniSciIf {
   void load_table_binary_arrow(const TSessionId& session,
                                const std::string& table_name,
                                const std::string& arrow_stream) override;
+  // Loads the record batches next_batch returns until it returns null, for Arrow
+  // Flight puts. The batches are checkpointed together once all are loaded.
+  void load_table_arrow(
+      const TSessionId& session,
+      const std::string& table_name,
+      const std::function<std::shared_ptr<arrow::RecordBatch>()>& next_batch);
 
   void load_table(const TSessionId& session,
                   const std::string& table_name,
@@ -528,7 +581,6 @@ class DBHandler : public OmniSciIf {
   const bool read_only_;
   const bool allow_loop_joins_;
   bool cpu_mode_only_;
-  mapd_shared_mutex sessions_mutex_;
   std::mutex render_mutex_;
   int64_t start_time_;
   const AuthMetadata& authMetadata_;
@@ -541,6 +593,18 @@ class DBHandler : public OmniSciIf {
 
   std::unique_ptr<QueryDispatchQueue> dispatch_queue_;
 
+  // background compaction of table data files and spilling of cold chunks, see
+  // --file-compaction-interval-seconds and --cold-storage-interval-seconds
+  std::thread storage_maintenance_thread_;
+  std::mutex storage_maintenance_mutex_;
+  std::condition_variable storage_maintenance_cv_;
+  bool stop_storage_maintenance_{false};
+  // loads the columns pinned with ALTER TABLE ... SET (PIN_CPU, PIN_GPU) after a restart
+  std::thread prewarm_thread_;
+  // loads the catalogs of all the databases on startup, see --preload-catalogs
+  std::thread catalog_load_thread_;
+  std::atomic<bool> catalogs_loaded_{true};
+
   template <typename... ARGS>
   std::shared_ptr<query_state::QueryState> create_query_state(ARGS&&... args) {
     return query_states_.create(std::forward<ARGS>(args)...);
@@ -583,6 +647,26 @@ class DBHandler : public OmniSciIf {
                               const bool get_system,
                               const bool get_physical);
   void check_read_only(const std::string& str);
+  void run_storage_maintenance();
+  bool storage_maintenance_stopped();
+  // starts the streams ingested into tables, as COPY FROM kafka:// left them
+  void resume_table_streams();
+  void prewarm_pinned_tables();
+  void load_catalogs();
+  // runs func for each local disk table, or those accepted by filter, under the table's
+  // data write lock unless func takes the data locks itself
+  void for_each_disk_table(
+      const std::function<void(const Catalog_Namespace::Catalog&,
+                               const TableDescriptor*)>& func,
+      const std::function<bool(const TableDescriptor*)>& filter = nullptr,
+      const bool lock_table_data = true);
+  void compact_table_files();
+  void spill_cold_chunks();
+  void compress_table_chunks();
+  void sort_table_fragments();
+  void vacuum_deleted_rows();
+  void merge_table_fragments();
+  void checkpoint_insert_wal();
   void check_session_exp_unsafe(const SessionMap::iterator& session_it);
   void validateGroups(const std::vector<std::string>& groups);
   void validateDashboardIdsForSharing(const Catalog_Namespace::SessionInfo& session_info,
@@ -608,6 +692,9 @@ class DBHandler : public OmniSciIf {
   static void value_to_thrift_column(const TargetValue& tv,
                                      const SQLTypeInfo& ti,
                                      TColumn& column);
+  static TBinaryColumn thrift_column_to_binary(const TColumn& column,
+                                               const TTypeInfo& type,
+                                               const bool compress);
   static TDatum value_to_thrift(const TargetValue& tv, const SQLTypeInfo& ti);
   static std::string apply_copy_to_shim(const std::string& query_str);
 
@@ -668,6 +755,14 @@ class DBHandler : public OmniSciIf {
                           const ExecutorDeviceType device_type,
                           const size_t device_id,
                           const int32_t first_n) const;
+  std::unique_ptr<ArrowResultSetConverter> execute_rel_alg_arrow(
+      int64_t& execution_time_ms,
+      const std::string& query_ra,
+      QueryStateProxy query_state_proxy,
+      const Catalog_Namespace::SessionInfo& session_info,
+      const ExecutorDeviceType device_type,
+      const size_t device_id,
+      const int32_t first_n) const;
 
   void executeDdl(TQueryResult& _return,
                   const std::string& query_ra,
@@ -702,6 +797,14 @@ class DBHandler : public OmniSciIf {
                       const ResultSet& results,
                       const bool column_format) const;
 
+  // Fills the columns of a columnar TQueryResult from the storage of results instead of
+  // its rows, when all of its columns can be read that way
+  static bool columns_to_thrift(std::vector<TColumn>& tcolumns,
+                                const std::vector<TargetMetaInfo>& targets,
+                                const ResultSet& results,
+                                const int32_t first_n,
+                                const int32_t at_most_n);
+
   template <class R>
   void convert_rows(TQueryResult& _return,
                     QueryStateProxy query_state_proxy,
@@ -767,7 +870,19 @@ class DBHandler : public OmniSciIf {
       query_state::StdLog& stdlog);
 
   query_state::QueryStates query_states_;
-  SessionMap sessions_;
+
+  // The sessions, sharded by the hash of their ids with a lock per shard, so that the
+  // session lookups of the concurrent calls don't all contend on a single lock
+  struct alignas(64) SessionShard {
+    mapd_shared_mutex mutex;
+    SessionMap sessions;
+  };
+  static constexpr size_t kSessionShardCount{32};
+  std::array<SessionShard, kSessionShardCount> session_shards_;
+
+  SessionShard& get_session_shard(const TSessionId& session) {
+    return session_shards_[std::hash<TSessionId>{}(session) % kSessionShardCount];
+  }
 
   bool super_user_rights_;           // default is "false"; setting to "true"
                                      // ignores passwd checks in "connect(..)"
@@ -843,11 +958,14 @@ class DBHandler : public OmniSciIf {
       return false;
     };
     auto check_and_remove_sessions = [&]() {
-      for (auto it = sessions_.begin(); it != sessions_.end();) {
-        if (is_match(it)) {
-          it = sessions_.erase(it);
-        } else {
-          ++it;
+      for (auto& shard : session_shards_) {
+        mapd_lock_guard<mapd_shared_mutex> write_lock(shard.mutex);
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end();) {
+          if (is_match(it)) {
+            it = shard.sessions.erase(it);
+          } else {
+            ++it;
+          }
         }
       }
     };
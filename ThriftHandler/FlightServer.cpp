@@ -0,0 +1,208 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ThriftHandler/FlightServer.h"
+
+#include <rapidjson/document.h>
+
+#include "Logger/Logger.h"
+#include "Shared/StringTransform.h"
+#include "ThriftHandler/DBHandler.h"
+
+constexpr std::chrono::minutes DBFlightServer::kResultTimeout;
+constexpr int64_t DBFlightServer::kRowsPerBatch;
+
+namespace {
+
+// the ids of the results in the tickets are what authorizes fetching them
+constexpr size_t kResultIdLength{32};
+
+rapidjson::Document parse_command(const arrow::flight::FlightDescriptor& descriptor) {
+  rapidjson::Document command;
+  if (descriptor.type != arrow::flight::FlightDescriptor::CMD ||
+      command.Parse(descriptor.cmd.c_str()).HasParseError() || !command.IsObject() ||
+      !command.HasMember("session") || !command["session"].IsString()) {
+    throw std::runtime_error(
+        "Expected a JSON object with the session as the command of the descriptor");
+  }
+  return command;
+}
+
+std::string get_string(const rapidjson::Document& command, const char* name) {
+  if (!command.HasMember(name) || !command[name].IsString()) {
+    throw std::runtime_error(std::string("Expected the string ") + name +
+                             " in the command of the descriptor");
+  }
+  return command[name].GetString();
+}
+
+// Splits a slice of a record batch into batches of up to rows_per_batch rows, without
+// copying them
+class RecordBatchSliceReader : public arrow::RecordBatchReader {
+ public:
+  RecordBatchSliceReader(std::shared_ptr<arrow::RecordBatch> batch,
+                         const int64_t offset,
+                         const int64_t length,
+                         const int64_t rows_per_batch)
+      : batch_(std::move(batch))
+      , offset_(offset)
+      , end_(offset + length)
+      , rows_per_batch_(rows_per_batch) {}
+
+  std::shared_ptr<arrow::Schema> schema() const override { return batch_->schema(); }
+
+  arrow::Status ReadNext(std::shared_ptr<arrow::RecordBatch>* batch) override {
+    if (offset_ >= end_) {
+      batch->reset();
+      return arrow::Status::OK();
+    }
+    const auto length = std::min(rows_per_batch_, end_ - offset_);
+    *batch = batch_->Slice(offset_, length);
+    offset_ += length;
+    return arrow::Status::OK();
+  }
+
+ private:
+  std::shared_ptr<arrow::RecordBatch> batch_;
+  int64_t offset_;
+  const int64_t end_;
+  const int64_t rows_per_batch_;
+};
+
+// runs func, which throws the exceptions of DBHandler, for a Flight call
+template <typename F>
+arrow::Status to_status(const F& func) {
+  try {
+    func();
+  } catch (const TOmniSciException& e) {
+    return arrow::Status::Invalid(e.error_msg);
+  } catch (const std::exception& e) {
+    return arrow::Status::Invalid(e.what());
+  }
+  return arrow::Status::OK();
+}
+
+}  // namespace
+
+arrow::Status DBFlightServer::GetFlightInfo(
+    const arrow::flight::ServerCallContext& context,
+    const arrow::flight::FlightDescriptor& request,
+    std::unique_ptr<arrow::flight::FlightInfo>* info) {
+  return to_status([&] {
+    const auto command = parse_command(request);
+    const auto session = get_string(command, "session");
+    const auto query = get_string(command, "query");
+    int64_t num_streams{1};
+    if (command.HasMember("streams")) {
+      if (!command["streams"].IsInt64() || command["streams"].GetInt64() <= 0) {
+        throw std::runtime_error("Expected a positive number of streams");
+      }
+      num_streams = command["streams"].GetInt64();
+    }
+
+    Result result;
+    result.batch = db_handler_->sql_execute_arrow(session, query);
+    CHECK(result.batch);
+    const auto num_rows = result.batch->num_rows();
+    // streams of at least kRowsPerBatch rows, unless there are fewer rows
+    num_streams = std::max(int64_t(1),
+                           std::min(num_streams, num_rows / kRowsPerBatch));
+    const auto rows_per_stream = (num_rows + num_streams - 1) / num_streams;
+    for (int64_t offset = 0; offset < num_rows || result.slices.empty();
+         offset += rows_per_stream) {
+      result.slices.emplace_back(offset, std::min(rows_per_stream, num_rows - offset));
+    }
+    result.fetched.resize(result.slices.size(), false);
+    result.expiry = std::chrono::steady_clock::now() + kResultTimeout;
+
+    const auto result_id = generate_random_string(kResultIdLength);
+    std::vector<arrow::flight::FlightEndpoint> endpoints;
+    for (size_t i = 0; i < result.slices.size(); ++i) {
+      // no locations, the endpoints are fetched from this server
+      endpoints.push_back({{result_id + ":" + std::to_string(i)}, {}});
+    }
+    auto flight_info = arrow::flight::FlightInfo::Make(
+        *result.batch->schema(), request, endpoints, num_rows, -1);
+    if (!flight_info.ok()) {
+      throw std::runtime_error(flight_info.status().ToString());
+    }
+    *info = std::make_unique<arrow::flight::FlightInfo>(std::move(*flight_info));
+
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = results_.begin(); it != results_.end();) {
+      it = it->second.expiry < now ? results_.erase(it) : std::next(it);
+    }
+    results_.emplace(result_id, std::move(result));
+  });
+}
+
+arrow::Status DBFlightServer::DoGet(
+    const arrow::flight::ServerCallContext& context,
+    const arrow::flight::Ticket& request,
+    std::unique_ptr<arrow::flight::FlightDataStream>* stream) {
+  return to_status([&] {
+    const auto separator = request.ticket.rfind(':');
+    if (separator == std::string::npos) {
+      throw std::runtime_error("Invalid ticket");
+    }
+    const auto result_id = request.ticket.substr(0, separator);
+    const auto endpoint = std::stoul(request.ticket.substr(separator + 1));
+
+    std::shared_ptr<arrow::RecordBatchReader> reader;
+    {
+      std::lock_guard<std::mutex> lock(results_mutex_);
+      const auto it = results_.find(result_id);
+      if (it == results_.end() || endpoint >= it->second.slices.size()) {
+        throw std::runtime_error("Unknown or expired ticket");
+      }
+      auto& result = it->second;
+      const auto [offset, length] = result.slices[endpoint];
+      reader = std::make_shared<RecordBatchSliceReader>(
+          result.batch, offset, length, kRowsPerBatch);
+      if (!result.fetched[endpoint]) {
+        result.fetched[endpoint] = true;
+        ++result.num_fetched;
+      }
+      // the stream keeps the batch until it is sent
+      if (result.num_fetched == result.slices.size()) {
+        results_.erase(it);
+      }
+    }
+    *stream = std::make_unique<arrow::flight::RecordBatchStream>(reader);
+  });
+}
+
+arrow::Status DBFlightServer::DoPut(
+    const arrow::flight::ServerCallContext& context,
+    std::unique_ptr<arrow::flight::FlightMessageReader> reader,
+    std::unique_ptr<arrow::flight::FlightMetadataWriter> writer) {
+  return to_status([&] {
+    const auto command = parse_command(reader->descriptor());
+    const auto session = get_string(command, "session");
+    const auto table = get_string(command, "table");
+    db_handler_->load_table_arrow(
+        session, table, [&reader]() -> std::shared_ptr<arrow::RecordBatch> {
+          arrow::flight::FlightStreamChunk chunk;
+          const auto status = reader->Next(&chunk);
+          if (!status.ok()) {
+            throw std::runtime_error("Could not read the record batches: " +
+                                     status.ToString());
+          }
+          return chunk.data;
+        });
+  });
+}
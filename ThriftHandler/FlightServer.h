@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    FlightServer.h
+ * @brief   Arrow Flight endpoint for bulk loads and query results
+ */
+
+#pragma once
+
+#include <arrow/flight/api.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Shared/mapd_shared_ptr.h"
+
+class DBHandler;
+
+/**
+ * Serves the record batches of queries and loads record batches into tables over Arrow
+ * Flight, next to the Thrift server. Clients connect through Thrift and pass the session
+ * in the JSON commands of the flight descriptors:
+ *
+ * - GetFlightInfo({"session": ..., "query": ..., "streams": n}) executes the query and
+ *   splits its rows between up to n endpoints, which DoGet streams in parallel. The
+ *   results are kept until every endpoint was fetched, or kResultTimeout.
+ * - DoPut({"session": ..., "table": ...}) loads the record batches streamed into table,
+ *   which are checkpointed once the stream ends.
+ */
+class DBFlightServer : public arrow::flight::FlightServerBase {
+ public:
+  explicit DBFlightServer(mapd::shared_ptr<DBHandler> db_handler)
+      : db_handler_(db_handler) {}
+
+  arrow::Status GetFlightInfo(const arrow::flight::ServerCallContext& context,
+                              const arrow::flight::FlightDescriptor& request,
+                              std::unique_ptr<arrow::flight::FlightInfo>* info) override;
+
+  arrow::Status DoGet(const arrow::flight::ServerCallContext& context,
+                      const arrow::flight::Ticket& request,
+                      std::unique_ptr<arrow::flight::FlightDataStream>* stream) override;
+
+  arrow::Status DoPut(
+      const arrow::flight::ServerCallContext& context,
+      std::unique_ptr<arrow::flight::FlightMessageReader> reader,
+      std::unique_ptr<arrow::flight::FlightMetadataWriter> writer) override;
+
+  static constexpr std::chrono::minutes kResultTimeout{10};
+  // rows of the record batches DoGet streams
+  static constexpr int64_t kRowsPerBatch{64 * 1024};
+
+ private:
+  struct Result {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    std::vector<std::pair<int64_t, int64_t>> slices;  // offset and length by endpoint
+    std::vector<bool> fetched;
+    size_t num_fetched{0};
+    std::chrono::steady_clock::time_point expiry;
+  };
+
+  mapd::shared_ptr<DBHandler> db_handler_;
+  std::mutex results_mutex_;
+  std::map<std::string, Result> results_;  // by the id in the tickets
+};
@@ -409,6 +409,49 @@ void validate_and_set_date_encoding(ColumnDescriptor& cd, int encoding_size) {
   cd.columnType.set_comp_param((encoding_size == 16) ? 16 : 0);
 }
 
+void validate_and_set_diff_encoding(ColumnDescriptor& cd,
+                                    int encoding_size,
+                                    const SqlType* column_type) {
+  const auto type = cd.columnType.get_type();
+  if (type == kDATE) {
+    throw std::runtime_error(cd.columnName +
+                             ": Diff encoding is not supported for DATE columns, use "
+                             "Days encoding instead.");
+  }
+  if ((!cd.columnType.is_integer() && !cd.columnType.is_time() &&
+       !cd.columnType.is_decimal()) ||
+      type == kTINYINT) {
+    throw std::runtime_error(cd.columnName + ": Cannot apply DIFF encoding to " +
+                             column_type->to_string());
+  }
+  switch (type) {
+    case kSMALLINT:
+      if (encoding_size != 8) {
+        throw std::runtime_error(
+            cd.columnName +
+            ": Compression parameter for Diff encoding on SMALLINT must be 8.");
+      }
+      break;
+    case kINT:
+      if (encoding_size != 8 && encoding_size != 16) {
+        throw std::runtime_error(
+            cd.columnName +
+            ": Compression parameter for Diff encoding on INTEGER must be 8 or 16.");
+      }
+      break;
+    default:
+      if (encoding_size != 8 && encoding_size != 16 && encoding_size != 32) {
+        throw std::runtime_error(cd.columnName +
+                                 ": Compression parameter for Diff encoding on "
+                                 "BIGINT, DECIMAL, TIME or TIMESTAMP must be 8 or 16 "
+                                 "or 32.");
+      }
+      break;
+  }
+  cd.columnType.set_compression(kENCODING_DIFF);
+  cd.columnType.set_comp_param(encoding_size);
+}
+
 void validate_and_set_encoding(ColumnDescriptor& cd,
                                const Encoding* encoding,
                                const SqlType* column_type) {
@@ -419,15 +462,9 @@ void validate_and_set_encoding(ColumnDescriptor& cd,
     if (boost::iequals(comp, "fixed")) {
       validate_and_set_fixed_encoding(cd, encoding->get_encoding_param(), column_type);
     } else if (boost::iequals(comp, "rl")) {
-      // run length encoding
-      cd.columnType.set_compression(kENCODING_RL);
-      cd.columnType.set_comp_param(0);
-      // throw std::runtime_error("RL(Run Length) encoding not supported yet.");
+      throw std::runtime_error("RL(Run Length) encoding not supported yet.");
     } else if (boost::iequals(comp, "diff")) {
-      // differential encoding
-      cd.columnType.set_compression(kENCODING_DIFF);
-      cd.columnType.set_comp_param(0);
-      // throw std::runtime_error("DIFF(differential) encoding not supported yet.");
+      validate_and_set_diff_encoding(cd, encoding->get_encoding_param(), column_type);
     } else if (boost::iequals(comp, "dict")) {
       validate_and_set_dictionary_encoding(cd, encoding->get_encoding_param());
     } else if (boost::iequals(comp, "NONE")) {
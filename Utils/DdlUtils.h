@@ -120,6 +120,10 @@ void validate_and_set_compressed_encoding(ColumnDescriptor& cd, int encoding_siz
 
 void validate_and_set_date_encoding(ColumnDescriptor& cd, int encoding_size);
 
+void validate_and_set_diff_encoding(ColumnDescriptor& cd,
+                                    int encoding_size,
+                                    const SqlType* column_type);
+
 void validate_and_set_encoding(ColumnDescriptor& cd,
                                const Encoding* encoding,
                                const SqlType* column_type);
@@ -72,6 +72,75 @@ extern "C" DEVICE bool string_ilike_simple(const char* str,
   return false;
 }
 
+// LIKE 'prefix%', the prefix without wildcards or escapes
+extern "C" DEVICE bool string_like_prefix(const char* str,
+                                          const int32_t str_len,
+                                          const char* prefix,
+                                          const int32_t prefix_len) {
+  if (str_len < prefix_len) {
+    return false;
+  }
+  for (int i = 0; i < prefix_len; ++i) {
+    if (str[i] != prefix[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+extern "C" DEVICE bool string_ilike_prefix(const char* str,
+                                           const int32_t str_len,
+                                           const char* prefix,
+                                           const int32_t prefix_len) {
+  if (str_len < prefix_len) {
+    return false;
+  }
+  for (int i = 0; i < prefix_len; ++i) {
+    if (lowercase(str[i]) != prefix[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// LIKE '%suffix', the suffix without wildcards or escapes
+extern "C" DEVICE bool string_like_suffix(const char* str,
+                                          const int32_t str_len,
+                                          const char* suffix,
+                                          const int32_t suffix_len) {
+  if (str_len < suffix_len) {
+    return false;
+  }
+  return string_like_prefix(
+      str + str_len - suffix_len, suffix_len, suffix, suffix_len);
+}
+
+extern "C" DEVICE bool string_ilike_suffix(const char* str,
+                                           const int32_t str_len,
+                                           const char* suffix,
+                                           const int32_t suffix_len) {
+  if (str_len < suffix_len) {
+    return false;
+  }
+  return string_ilike_prefix(
+      str + str_len - suffix_len, suffix_len, suffix, suffix_len);
+}
+
+// LIKE 'exact', without wildcards or escapes
+extern "C" DEVICE bool string_like_exact(const char* str,
+                                         const int32_t str_len,
+                                         const char* pattern,
+                                         const int32_t pat_len) {
+  return str_len == pat_len && string_like_prefix(str, str_len, pattern, pat_len);
+}
+
+extern "C" DEVICE bool string_ilike_exact(const char* str,
+                                          const int32_t str_len,
+                                          const char* pattern,
+                                          const int32_t pat_len) {
+  return str_len == pat_len && string_ilike_prefix(str, str_len, pattern, pat_len);
+}
+
 #define STR_LIKE_SIMPLE_NULLABLE(base_func)                               \
   extern "C" DEVICE int8_t base_func##_nullable(const char* lhs,          \
                                                 const int32_t lhs_len,    \
@@ -86,6 +155,12 @@ extern "C" DEVICE bool string_ilike_simple(const char* str,
 
 STR_LIKE_SIMPLE_NULLABLE(string_like_simple)
 STR_LIKE_SIMPLE_NULLABLE(string_ilike_simple)
+STR_LIKE_SIMPLE_NULLABLE(string_like_prefix)
+STR_LIKE_SIMPLE_NULLABLE(string_ilike_prefix)
+STR_LIKE_SIMPLE_NULLABLE(string_like_suffix)
+STR_LIKE_SIMPLE_NULLABLE(string_ilike_suffix)
+STR_LIKE_SIMPLE_NULLABLE(string_like_exact)
+STR_LIKE_SIMPLE_NULLABLE(string_ilike_exact)
 
 #undef STR_LIKE_SIMPLE_NULLABLE
 
@@ -64,6 +64,41 @@ extern "C" DEVICE bool string_ilike_simple(const char* str,
                                            const char* pattern,
                                            const int32_t pat_len);
 
+/*
+ * @brief string_like_prefix, string_like_suffix and string_like_exact match the LIKE
+ * patterns 'prefix%', '%suffix' and 'exact' without any other wildcard or escape, given
+ * the pattern without its '%'. The ILIKE ones take a lowercase pattern.
+ */
+extern "C" DEVICE bool string_like_prefix(const char* str,
+                                          const int32_t str_len,
+                                          const char* prefix,
+                                          const int32_t prefix_len);
+
+extern "C" DEVICE bool string_ilike_prefix(const char* str,
+                                           const int32_t str_len,
+                                           const char* prefix,
+                                           const int32_t prefix_len);
+
+extern "C" DEVICE bool string_like_suffix(const char* str,
+                                          const int32_t str_len,
+                                          const char* suffix,
+                                          const int32_t suffix_len);
+
+extern "C" DEVICE bool string_ilike_suffix(const char* str,
+                                           const int32_t str_len,
+                                           const char* suffix,
+                                           const int32_t suffix_len);
+
+extern "C" DEVICE bool string_like_exact(const char* str,
+                                         const int32_t str_len,
+                                         const char* pattern,
+                                         const int32_t pat_len);
+
+extern "C" DEVICE bool string_ilike_exact(const char* str,
+                                          const int32_t str_len,
+                                          const char* pattern,
+                                          const int32_t pat_len);
+
 extern "C" DEVICE bool string_lt(const char* lhs,
                                  const int32_t lhs_len,
                                  const char* rhs,
@@ -0,0 +1,66 @@
+#.rst:
+# FindArrowFlight.cmake
+# -------------
+#
+# Find the Flight RPC library of an Arrow installation.
+#
+# This module finds if Arrow was built with Flight and selects a default
+# configuration to use.
+#
+# find_package(ArrowFlight ...)
+#
+#
+# The following variables control which libraries are found::
+#
+#   ArrowFlight_USE_STATIC_LIBS  - Set to ON to force use of static libraries.
+#
+# The following are set after the configuration is done:
+#
+# ::
+#
+#   ArrowFlight_FOUND            - Set to TRUE if Arrow Flight was found.
+#   ArrowFlight_LIBRARIES        - Path to the Arrow Flight libraries.
+#   ArrowFlight_LIBRARY_DIRS     - compile time link directories
+#   ArrowFlight_INCLUDE_DIRS     - compile time include directories
+#
+#
+# Sample usage:
+#
+# ::
+#
+#    find_package(ArrowFlight)
+#    if(ArrowFlight_FOUND)
+#      target_link_libraries(<YourTarget> ${ArrowFlight_LIBRARIES})
+#    endif()
+
+if(ArrowFlight_USE_STATIC_LIBS)
+  set(_CMAKE_FIND_LIBRARY_SUFFIXES ${CMAKE_FIND_LIBRARY_SUFFIXES})
+  set(CMAKE_FIND_LIBRARY_SUFFIXES .lib .a ${CMAKE_FIND_LIBRARY_SUFFIXES})
+endif()
+
+
+find_library(ArrowFlight_LIBRARY
+  NAMES arrow_flight
+  HINTS
+  ENV LD_LIBRARY_PATH
+  ENV DYLD_LIBRARY_PATH
+  PATHS
+  /usr/lib
+  /usr/local/lib
+  /usr/local/homebrew/lib
+  /opt/local/lib)
+
+if(ArrowFlight_USE_STATIC_LIBS)
+  set(CMAKE_FIND_LIBRARY_SUFFIXES ${_CMAKE_FIND_LIBRARY_SUFFIXES})
+endif()
+
+get_filename_component(ArrowFlight_LIBRARY_DIR ${ArrowFlight_LIBRARY} DIRECTORY)
+
+# Set standard CMake FindPackage variables if found. The gRPC and protobuf libraries
+# Flight depends on are in the bundled dependencies of a static Arrow.
+set(ArrowFlight_LIBRARIES ${ArrowFlight_LIBRARY})
+set(ArrowFlight_LIBRARY_DIRS ${ArrowFlight_LIBRARY_DIR})
+set(ArrowFlight_INCLUDE_DIRS ${ArrowFlight_LIBRARY_DIR}/../include)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ArrowFlight REQUIRED_VARS ArrowFlight_LIBRARY)
@@ -20,6 +20,8 @@
 #
 #   Thrift_FOUND            - Set to TRUE if Thrift was found.
 #   Thrift_LIBRARIES        - Path to the Thrift libraries.
+#   Thrift_NB_LIBRARIES     - Path to the Thrift nonblocking server library and the
+#                             libevent it runs on, if both were found.
 #   Thrift_EXECUTABLE       - Path to the Thrift executable.
 #   Thrift_LIBRARY_DIRS     - compile time link directories
 #   Thrift_INCLUDE_DIRS     - compile time include directories
@@ -89,6 +91,25 @@ if(Thrift_USE_STATIC_LIBS)
   set(Thrift_LIBRARIES ${Thrift_LIBRARIES} ${OPENSSL_LIBRARIES})
 endif()
 
+find_library(Thrift_NB_LIBRARY
+  NAMES thriftnb
+  HINTS
+  ${Thrift_LIBRARY_DIR})
+find_library(Libevent_LIBRARY
+  NAMES event
+  HINTS
+  ENV LD_LIBRARY_PATH
+  ENV DYLD_LIBRARY_PATH
+  ${Thrift_LIBRARY_DIR}
+  PATHS
+  /usr/lib
+  /usr/local/lib
+  /usr/local/homebrew/lib
+  /opt/local/lib)
+if(Thrift_NB_LIBRARY AND Libevent_LIBRARY)
+  set(Thrift_NB_LIBRARIES ${Thrift_NB_LIBRARY} ${Libevent_LIBRARY})
+endif()
+
 set(Thrift_LIBRARY_DIRS ${Thrift_LIBRARY_DIR})
 set(Thrift_INCLUDE_DIRS ${Thrift_LIBRARY_DIR}/../include)
 
@@ -163,6 +163,7 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     // opTab.addOperator(new RampFunction());
     // opTab.addOperator(new DedupFunction());
     opTab.addOperator(new RowCopier()); // UDTF prototype
+    opTab.addOperator(new RowAdder());
     opTab.addOperator(new MyUDFFunction());
     opTab.addOperator(new PgUnnest());
     opTab.addOperator(new Any());
@@ -218,12 +219,15 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     opTab.addOperator(new ST_Point());
     opTab.addOperator(new ST_Centroid());
     opTab.addOperator(new ST_Buffer());
+    opTab.addOperator(new ST_Simplify());
     opTab.addOperator(new ST_Intersection());
     opTab.addOperator(new ST_Union());
     opTab.addOperator(new ST_Difference());
     opTab.addOperator(new CastToGeography());
     opTab.addOperator(new OffsetInFragment());
     opTab.addOperator(new ApproxCountDistinct());
+    opTab.addOperator(new ApproxMedian());
+    opTab.addOperator(new ApproxPercentile());
     opTab.addOperator(new MapDAvg());
     opTab.addOperator(new Sample());
     opTab.addOperator(new LastSample());
@@ -369,6 +373,31 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     }
   }
 
+  public static class RowAdder extends SqlFunction {
+    public RowAdder() {
+      super("ROW_ADDER",
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(signature()),
+              SqlFunctionCategory.USER_DEFINED_TABLE_FUNCTION);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      assert opBinding.getOperandCount() == 2;
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.builder().add("out0", SqlTypeName.DOUBLE).build();
+    }
+
+    private static java.util.List<SqlTypeFamily> signature() {
+      java.util.List<SqlTypeFamily> sig_family = new java.util.ArrayList<SqlTypeFamily>();
+      sig_family.add(SqlTypeFamily.CURSOR);
+      sig_family.add(SqlTypeFamily.ANY);
+      return sig_family;
+    }
+  }
+
   /* Postgres-style UNNEST */
   public static class PgUnnest extends SqlFunction {
     public PgUnnest() {
@@ -1575,6 +1604,32 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     }
   }
 
+  static class ST_Simplify extends SqlFunction {
+    ST_Simplify() {
+      super("ST_Simplify",
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(signature()),
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      assert opBinding.getOperandCount() == 2;
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createSqlType(SqlTypeName.INTEGER);
+    }
+
+    private static java.util.List<SqlTypeFamily> signature() {
+      java.util.List<SqlTypeFamily> st_simplify_sig =
+              new java.util.ArrayList<SqlTypeFamily>();
+      st_simplify_sig.add(SqlTypeFamily.ANY);
+      st_simplify_sig.add(SqlTypeFamily.NUMERIC);
+      return st_simplify_sig;
+    }
+  }
+
   static class ST_Intersection extends SqlFunction {
     ST_Intersection() {
       super("ST_Intersection",
@@ -1709,6 +1764,42 @@ public class MapDSqlOperatorTable extends ChainedSqlOperatorTable {
     }
   }
 
+  static class ApproxMedian extends SqlAggFunction {
+    ApproxMedian() {
+      super("APPROX_MEDIAN",
+              null,
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(SqlTypeFamily.NUMERIC),
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createSqlType(SqlTypeName.DOUBLE);
+    }
+  }
+
+  static class ApproxPercentile extends SqlAggFunction {
+    ApproxPercentile() {
+      super("APPROX_PERCENTILE",
+              null,
+              SqlKind.OTHER_FUNCTION,
+              null,
+              null,
+              OperandTypes.family(SqlTypeFamily.NUMERIC, SqlTypeFamily.NUMERIC),
+              SqlFunctionCategory.SYSTEM);
+    }
+
+    @Override
+    public RelDataType inferReturnType(SqlOperatorBinding opBinding) {
+      final RelDataTypeFactory typeFactory = opBinding.getTypeFactory();
+      return typeFactory.createSqlType(SqlTypeName.DOUBLE);
+    }
+  }
+
   static class MapDAvg extends SqlAggFunction {
     MapDAvg() {
       super("AVG",
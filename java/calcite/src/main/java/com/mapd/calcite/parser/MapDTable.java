@@ -5,6 +5,7 @@
  */
 package com.mapd.calcite.parser;
 
+import com.google.common.collect.ImmutableList;
 import com.mapd.metadata.LinestringSqlType;
 import com.mapd.metadata.PointSqlType;
 import com.mapd.metadata.PolygonSqlType;
@@ -70,6 +71,10 @@ public class MapDTable implements Table {
 
   @Override
   public Statistic getStatistic() {
+    // the row count of the last ANALYZE TABLE, if any
+    if (rowInfo.analyzed_row_count >= 0) {
+      return Statistics.of(rowInfo.analyzed_row_count, ImmutableList.of());
+    }
     return Statistics.UNKNOWN;
   }
 
@@ -32,11 +32,36 @@ import org.apache.commons.text.StringEscapeUtils;
 import java.util.*;
 import java.util.stream.Collectors;
 
+/**
+ * Writes the plans without the indentation and line breaks of JsonBuilder, which
+ * double the size of the plans of complex queries the server parses.
+ */
 final class EscapedStringJsonBuilder extends JsonBuilder {
   @Override
+  @SuppressWarnings("unchecked")
   public void append(StringBuilder buf, int indent, Object o) {
     if (o instanceof String) {
       buf.append('"').append(StringEscapeUtils.escapeJson((String) o)).append('"');
+    } else if (o instanceof Map) {
+      buf.append('{');
+      String separator = "";
+      for (Map.Entry<String, Object> entry : ((Map<String, Object>) o).entrySet()) {
+        buf.append(separator);
+        append(buf, indent, entry.getKey());
+        buf.append(':');
+        append(buf, indent, entry.getValue());
+        separator = ",";
+      }
+      buf.append('}');
+    } else if (o instanceof List) {
+      buf.append('[');
+      String separator = "";
+      for (Object element : (List<Object>) o) {
+        buf.append(separator);
+        append(buf, indent, element);
+        separator = ",";
+      }
+      buf.append(']');
     } else {
       super.append(buf, indent, o);
     }
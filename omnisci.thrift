@@ -115,11 +115,34 @@ struct TStepResult {
   6: i32 node_id
 }
 
+/* a column of sql_execute_binary: the values of fixed width types are packed in data,
+   strings are concatenated in data and end at the int32 offsets. Bit i of nulls, which
+   is empty if there are no nulls, is set if row i is null. data and offsets are blosc
+   compressed if their sizes differ from data_size and offsets_size. Columns of arrays
+   are not packed and stay in the columns of the row set. */
+struct TBinaryColumn {
+  1: bool is_packed
+  2: binary data
+  3: binary offsets
+  4: binary nulls
+  5: i32 value_size
+  6: i64 data_size
+  7: i64 offsets_size
+}
+
+/* the result of a statement of sql_execute_batch, error_msg is set if it failed */
+struct TBatchQueryResult {
+  1: bool success
+  2: TQueryResult result
+  3: string error_msg
+}
+
 struct TRowSet {
   1: TRowDescriptor row_desc
   2: list<TRow> rows
   3: list<TColumn> columns
   4: bool is_columnar
+  5: list<TBinaryColumn> binary_columns
 }
 
 enum TQueryType {
@@ -138,6 +161,11 @@ struct TQueryResult {
   5: string debug
   6: bool success=true
   7: TQueryType query_type=TQueryType.UNKNOWN
+  8: i64 gpu_memory_peak_bytes
+  9: i64 gpu_input_chunk_peak_bytes
+  10: i64 gpu_output_buffer_peak_bytes
+  11: i64 gpu_hash_table_peak_bytes
+  12: i64 gpu_scratch_peak_bytes
 }
 
 struct TDataFrame {
@@ -229,6 +257,7 @@ struct TServerStatus {
   6: string host_name
   7: bool poly_rendering_enabled
   8: TRole role
+  9: bool catalogs_loaded
 }
 
 struct TPixel {
@@ -292,6 +321,16 @@ struct TNodeMemoryInfo {
   4: i64 num_pages_allocated
   5: bool is_allocation_capped
   6: list<TMemoryData> node_memory_data
+  7: bool is_pinned
+  8: i64 host_to_device_bytes
+  9: double host_to_device_bandwidth_gbs
+  10: i64 device_to_host_bytes
+  11: double device_to_host_bandwidth_gbs
+  12: string eviction_policy
+  13: i64 num_hits
+  14: i64 num_misses
+  15: i64 num_evictions
+  16: double fragmentation_ratio
 }
 
 struct TTableMeta {
@@ -317,6 +356,16 @@ struct TTableDetails {
   7: string key_metainfo
   8: bool is_temporary
   9: TPartitionDetail partition_detail
+  10: i64 analyzed_row_count = -1
+}
+
+struct TTableIoStats {
+  1: i64 bytes_read
+  2: i64 pages_read
+  3: i64 read_ahead_hits
+  4: i64 num_syncs
+  5: i64 sync_time_us
+  6: i64 checksum_failures
 }
 
 enum TExpressionRangeType {
@@ -525,13 +574,17 @@ service OmniSci {
   list<TNodeMemoryInfo> get_memory(1: TSessionId session, 2: string memory_level) throws (1: TOmniSciException e)
   void clear_cpu_memory(1: TSessionId session) throws (1: TOmniSciException e)
   void clear_gpu_memory(1: TSessionId session) throws (1: TOmniSciException e)
+  void compact_memory(1: TSessionId session, 2: string memory_level) throws (1: TOmniSciException e)
   void set_table_epoch (1: TSessionId session 2: i32 db_id 3: i32 table_id 4: i32 new_epoch) throws (1: TOmniSciException e)
   void set_table_epoch_by_name (1: TSessionId session 2: string table_name 3: i32 new_epoch) throws (1: TOmniSciException e)
   i32 get_table_epoch (1: TSessionId session 2: i32 db_id 3: i32 table_id);
   i32 get_table_epoch_by_name (1: TSessionId session 2: string table_name);
+  TTableIoStats get_table_io_stats(1: TSessionId session, 2: string table_name) throws (1: TOmniSciException e)
   TSessionInfo get_session_info(1: TSessionId session) throws (1: TOmniSciException e)
   # query, render
   TQueryResult sql_execute(1: TSessionId session, 2: string query 3: bool column_format, 4: string nonce, 5: i32 first_n = -1, 6: i32 at_most_n = -1) throws (1: TOmniSciException e)
+  TQueryResult sql_execute_binary(1: TSessionId session, 2: string query, 3: string nonce, 4: i32 first_n = -1, 5: i32 at_most_n = -1, 6: bool compress = false) throws (1: TOmniSciException e)
+  list<TBatchQueryResult> sql_execute_batch(1: TSessionId session, 2: list<string> queries 3: bool column_format, 4: string nonce, 5: i32 first_n = -1, 6: i32 at_most_n = -1) throws (1: TOmniSciException e)
   TDataFrame sql_execute_df(1: TSessionId session, 2: string query 3: common.TDeviceType device_type 4: i32 device_id = 0 5: i32 first_n = -1) throws (1: TOmniSciException e)
   TDataFrame sql_execute_gdf(1: TSessionId session, 2: string query 3: i32 device_id = 0, 4: i32 first_n = -1) throws (1: TOmniSciException e)
   void deallocate_df(1: TSessionId session, 2: TDataFrame df, 3: common.TDeviceType device_type, 4: i32 device_id = 0) throws (1: TOmniSciException e)